@@ -197,7 +197,17 @@ struct CollectBucketStrategyHostFunctionVisitor
         ir::Argument(kernel_args_num_, ir::Argument::IO::kInput),
         ir::Argument(kernel_stream_, ir::Argument::IO::kOutput)};
     std::vector<ir::Expr> body_stmts(arg_defs_);
-    body_stmts.insert(body_stmts.end(), buckets_.begin(), buckets_.end());
+    // Only the first bucket whose predicate holds is launched, so that the
+    // kernels specialized for aligned dims can overlap the generic ones.
+    ir::Expr dispatch;
+    for (auto it = buckets_.rbegin(); it != buckets_.rend(); ++it) {
+      const ir::IfThenElse* bucket = it->As<ir::IfThenElse>();
+      dispatch = ir::IfThenElse::Make(
+          bucket->condition, bucket->true_case, dispatch);
+    }
+    if (dispatch.defined()) {
+      body_stmts.push_back(dispatch);
+    }
     ir::Expr host_func =
         ir::_LoweredFunc_::Make(op->functions[0].as_lowered_func()->name,
                                 arguments,
@@ -305,6 +305,7 @@ void Compiler::CompileCudaModule(const Module& module,
     CHECK(fn_kernel);
 
     fn_ptr_.push_back(reinterpret_cast<void*>(fn_kernel));
+    kernel_names_.push_back(kernel_fn_name);
 
     symbols.RegisterVar(kernel_fn_name + "_ptr_",
                         reinterpret_cast<void*>(fn_kernel));
@@ -322,6 +323,50 @@ void Compiler::CompileX86Module(const Module& module) {
   engine_->Link<CodeGenX86>(module);
 }
 
+Compiler::CompiledModule Compiler::ExportCompiled() const {
+  CompiledModule compiled;
+  compiled.host_object = engine_->GetObject();
+#ifdef CINN_WITH_CUDA
+  if (cuda_module_) {
+    compiled.device_code = cuda_module_->data();
+    compiled.device_code_is_cubin =
+        cuda_module_->kind() == runtime::cuda::CUDAModule::Kind::CUBIN;
+    compiled.kernel_names = kernel_names_;
+  }
+#endif
+  return compiled;
+}
+
+bool Compiler::LoadCompiled(const CompiledModule& compiled) {
+  if (target_.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    using runtime::cuda::CUDAModule;
+    cuda_module_.reset(new CUDAModule(compiled.device_code,
+                                      compiled.device_code_is_cubin
+                                          ? CUDAModule::Kind::CUBIN
+                                          : CUDAModule::Kind::PTX));
+    fn_ptr_.clear();
+    kernel_names_ = compiled.kernel_names;
+    RuntimeSymbols symbols;
+    for (const std::string& kernel_fn_name : kernel_names_) {
+      auto fn_kernel = cuda_module_->GetFunction(0, kernel_fn_name);
+      CHECK(fn_kernel);
+
+      fn_ptr_.push_back(reinterpret_cast<void*>(fn_kernel));
+
+      symbols.RegisterVar(kernel_fn_name + "_ptr_",
+                          reinterpret_cast<void*>(fn_kernel));
+    }
+    engine_ = ExecutionEngine::Create(ExecutionOptions(), std::move(symbols));
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  } else if (target_.arch != Target::Arch::X86) {
+    CINN_NOT_IMPLEMENTED
+  }
+  return engine_->AddObject(compiled.host_object);
+}
+
 void Compiler::ExportObject(const std::string& path) {
   engine_->ExportObject(path);
 }
@@ -20,6 +20,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "paddle/cinn/backends/llvm/codegen_llvm.h"
 #include "paddle/cinn/backends/llvm/execution_engine.h"
@@ -100,6 +101,18 @@ class SourceCodePrint {
 
 class Compiler final {
  public:
+  /**
+   * The binaries built for a CINN module: the host object file, and for
+   * NVGPU the PTX or CUBIN with the names of its kernels. LoadCompiled links
+   * them again without going through codegen.
+   */
+  struct CompiledModule {
+    std::string host_object;
+    std::string device_code;
+    bool device_code_is_cubin{false};
+    std::vector<std::string> kernel_names;
+  };
+
   static std::unique_ptr<Compiler> Create(const Target& target) {
     return std::unique_ptr<Compiler>(new Compiler(target));
   }
@@ -123,6 +136,18 @@ class Compiler final {
 
   std::vector<void*> GetFnPtr() const { return fn_ptr_; }
 
+  /**
+   * The binaries of the module built by the last Build.
+   */
+  CompiledModule ExportCompiled() const;
+
+  /**
+   * Links the binaries returned by ExportCompiled, possibly in another
+   * process, instead of building a module.
+   * @return false if the host object can not be linked.
+   */
+  bool LoadCompiled(const CompiledModule& compiled);
+
  private:
   void CompileCudaModule(const ir::Module& module,
                          const std::string& code = "");
@@ -141,6 +166,7 @@ class Compiler final {
   std::vector<void*> fn_ptr_;
 #ifdef CINN_WITH_CUDA
   std::unique_ptr<runtime::cuda::CUDAModule> cuda_module_;
+  std::vector<std::string> kernel_names_;
 #endif
 };
 
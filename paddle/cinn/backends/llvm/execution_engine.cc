@@ -238,6 +238,23 @@ void ExecutionEngine::ExportObject(const std::string &path) {
   fclose(of);
 }
 
+std::string ExecutionEngine::GetObject() const {
+  return std::string(buffer_.data(), buffer_.size());
+}
+
+bool ExecutionEngine::AddObject(const std::string &object) {
+  utils::RecordEvent("ExecutionEngine AddObject", utils::EventType::kOrdinary);
+  std::lock_guard<std::mutex> lock(mu_);
+  buffer_.assign(object.begin(), object.end());
+  if (auto error = jit_->addObjectFile(
+          llvm::MemoryBuffer::getMemBufferCopy(AsStringRef(object)))) {
+    LOG(WARNING) << "Failed to add object file to the jit: "
+                 << llvm::toString(std::move(error));
+    return false;
+  }
+  return true;
+}
+
 void *ExecutionEngine::Lookup(absl::string_view name) {
   utils::RecordEvent("ExecutionEngine Lookup", utils::EventType::kOrdinary);
   std::lock_guard<std::mutex> lock(mu_);
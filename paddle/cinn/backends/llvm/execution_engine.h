@@ -83,6 +83,12 @@ class ExecutionEngine {
 
   void ExportObject(const std::string &path);
 
+  // The object file emitted by Link.
+  std::string GetObject() const;
+
+  // Links an object file returned by GetObject, without codegen.
+  bool AddObject(const std::string &object);
+
   bool AddModule(std::unique_ptr<llvm::Module> module,
                  std::unique_ptr<llvm::LLVMContext> context);
 
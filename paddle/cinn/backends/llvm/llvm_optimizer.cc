@@ -60,6 +60,7 @@
 #include <utility>
 
 #include "llvm/Support/CodeGen.h"
+#include "paddle/cinn/common/target.h"
 
 namespace cinn::backends {
 
@@ -164,6 +165,17 @@ void LLVMModuleOptimizer::operator()(llvm::Module *m) {
   builder->populateFunctionPassManager(*fpm);
   builder->populateModulePassManager(*mpm);
 
+  // LLVM prefers 256 bits vectors on the AVX-512 cpus, let the vectorizer
+  // use the full registers the schedules were tiled for
+  int vector_bits = cinn::common::DefaultHostTarget().get_native_vector_bits();
+  if (vector_bits == 512) {
+    for (auto &fn : *m) {
+      if (!fn.isDeclaration()) {
+        fn.addFnAttr("prefer-vector-width", std::to_string(vector_bits));
+      }
+    }
+  }
+
   fpm->doInitialization();
   std::for_each(m->begin(), m->end(), [&fpm](auto &fn) { fpm->run(fn); });
   fpm->doFinalization();
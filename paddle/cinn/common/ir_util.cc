@@ -15,6 +15,7 @@
 #include "paddle/cinn/common/ir_util.h"
 
 #include <algorithm>
+#include <numeric>
 #include <unordered_set>
 
 #include "paddle/cinn/common/cas.h"
@@ -219,6 +220,54 @@ bool is_zero(Expr v) {
   return false;
 }
 
+int64_t KnownConstantFactor(const Expr &expr) {
+  if (expr.As<ir::IntImm>()) {
+    return std::abs(expr.As<ir::IntImm>()->value);
+  }
+  if (expr.As<ir::Cast>()) {
+    return KnownConstantFactor(expr.As<ir::Cast>()->v());
+  }
+  if (expr.As<ir::Mul>()) {
+    return KnownConstantFactor(expr.As<ir::Mul>()->a()) *
+           KnownConstantFactor(expr.As<ir::Mul>()->b());
+  }
+  if (expr.As<ir::Add>()) {
+    return std::gcd(KnownConstantFactor(expr.As<ir::Add>()->a()),
+                    KnownConstantFactor(expr.As<ir::Add>()->b()));
+  }
+  if (expr.As<ir::Sub>()) {
+    return std::gcd(KnownConstantFactor(expr.As<ir::Sub>()->a()),
+                    KnownConstantFactor(expr.As<ir::Sub>()->b()));
+  }
+  if (expr.As<ir::Mod>()) {
+    return std::gcd(KnownConstantFactor(expr.As<ir::Mod>()->a()),
+                    KnownConstantFactor(expr.As<ir::Mod>()->b()));
+  }
+  if (expr.As<ir::Min>()) {
+    return std::gcd(KnownConstantFactor(expr.As<ir::Min>()->a()),
+                    KnownConstantFactor(expr.As<ir::Min>()->b()));
+  }
+  if (expr.As<ir::Max>()) {
+    return std::gcd(KnownConstantFactor(expr.As<ir::Max>()->a()),
+                    KnownConstantFactor(expr.As<ir::Max>()->b()));
+  }
+  if (expr.As<ir::Product>()) {
+    int64_t factor = 1;
+    for (const Expr &operand : expr.As<ir::Product>()->operands()) {
+      factor *= KnownConstantFactor(operand);
+    }
+    return factor;
+  }
+  if (expr.As<ir::Sum>()) {
+    int64_t factor = 0;
+    for (const Expr &operand : expr.As<ir::Sum>()->operands()) {
+      factor = std::gcd(factor, KnownConstantFactor(operand));
+    }
+    return factor;
+  }
+  return 1;
+}
+
 Expr CastIfNeeded(Expr body, Type type) {
   if (body.type() == type) return body;
   return ir::Cast::Make(type, body);
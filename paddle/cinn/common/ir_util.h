@@ -93,6 +93,10 @@ bool is_zero(Expr v);
 
 bool MathEqual(const Expr &a, const Expr &b);
 
+//! Returns a constant that the value of \p expr is always a multiple of, such
+//! as 8 for `S * 8 + 16`, or 0 if the value is always 0.
+int64_t KnownConstantFactor(const Expr &expr);
+
 //! helper function to get a ir::Select node.
 Expr select(Expr cond, Expr true_value, Expr false_value);
 
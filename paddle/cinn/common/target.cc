@@ -112,6 +112,22 @@ int Target::get_target_bits() const {
   return -1;
 }
 
+int Target::get_native_vector_bits() const {
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+  if (arch == Arch::X86) {
+    static const int host_vector_bits = [] {
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f")) return 512;
+      if (__builtin_cpu_supports("avx")) return 256;
+      return 128;
+    }();
+    return host_vector_bits;
+  }
+#endif
+  return get_target_bits() * 8;
+}
+
 std::string Target::arch_str() const {
   std::ostringstream oss;
   oss << arch;
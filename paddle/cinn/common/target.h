@@ -92,6 +92,11 @@ struct Target {
 
   int get_target_bits() const;
 
+  //! The bits of the widest vector register the kernels can use, which is
+  //! read from the features of the host cpu on X86 since the kernels are
+  //! jitted for it: 512 with AVX-512, 256 with AVX/AVX2 and 128 otherwise.
+  int get_native_vector_bits() const;
+
   std::vector<Lib> get_target_libs() const;
 
   std::string arch_str() const;
@@ -108,12 +108,14 @@ struct CINNKernelInfoAttributeStorage : public pir::AttributeStorage {
     return new CINNKernelInfoAttributeStorage(key);
   }
 
+  // fn_ptr is null while the kernel is compiled in the background, so the
+  // function name, which is unique for each group, is hashed instead.
   static std::size_t HashValue(const ParamKey& key) {
-    return std::hash<int64_t>()(*(reinterpret_cast<int64_t*>(key.fn_ptr)));
+    return std::hash<std::string>()(key.fn_name);
   }
 
   bool operator==(const ParamKey& key) const {
-    return data_.fn_ptr == key.fn_ptr;
+    return data_.fn_name == key.fn_name && data_.fn_ptr == key.fn_ptr;
   }
 
   const ParamKey& GetAsKey() const { return data_; }
@@ -15,6 +15,8 @@
 #include "paddle/cinn/hlir/framework/pir/compilation_cache.h"
 #include "paddle/cinn/hlir/framework/pir/op_lowering_group.h"
 
+#include <chrono>  // NOLINT
+
 #include "paddle/common/enforce.h"
 
 namespace cinn::hlir::framework {
@@ -65,9 +67,29 @@ pir::CINNKernelInfo BackendResource::GernerateKernelInfo(
   kernel_info.int_args_map = group->int_args_map();
   return kernel_info;
 }
+
+pir::CINNKernelInfo CompilationResult::GetKernelInfo(
+    const std::shared_ptr<pir::OpLoweringGroup>& group) {
+  if (async_fn_ptrs_.valid()) {
+    if (async_fn_ptrs_.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      pir::CINNKernelInfo kernel_info;
+      kernel_info.fn_name = backend_resource_.GetHostFnName();
+      kernel_info.fn_ptr = nullptr;
+      kernel_info.infer_shape_fn_ptr = nullptr;
+      kernel_info.int_args_map = group->int_args_map();
+      kernel_info.async_fn_ptrs = async_fn_ptrs_;
+      return kernel_info;
+    }
+    // Rethrows the error of the background compilation, if any.
+    async_fn_ptrs_.get();
+  }
+  return backend_resource_.GernerateKernelInfo(group);
+}
 }  // namespace pir
 
 bool CompilationCache::Has(const CacheKey& key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
   const bool has_existed = cache_.find(KeyHash(key)) != cache_.end();
   VLOG(6) << "Check IsExisted in CompilationCache: " << key->FuncName() << " "
           << has_existed;
@@ -80,6 +102,7 @@ const CompilationCache::CacheValue& CompilationCache::Get(
       Has(key),
       true,
       phi::errors::NotFound("%s is not in CompliatonCache.", key->FuncName()));
+  std::lock_guard<std::mutex> lock(mutex_);
   return cache_.at(KeyHash(key));
 }
 
@@ -89,10 +112,14 @@ pir::CINNKernelInfo CompilationCache::GetKernelInfo(const CacheKey& key) const {
 
 void CompilationCache::Insert(const CacheKey& key, const CacheValue& value) {
   VLOG(6) << "Insert CompilationCache for: " << key->FuncName();
+  std::lock_guard<std::mutex> lock(mutex_);
   cache_.insert({KeyHash(key), value});
 }
 
-void CompilationCache::Clear() { cache_.clear(); }
+void CompilationCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cache_.clear();
+}
 
 size_t CompilationCache::KeyHash(const CacheKey& key) const {
   // TODO(Aurelius84): use a better hash function in next pr.
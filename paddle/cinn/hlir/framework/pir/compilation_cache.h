@@ -14,8 +14,11 @@
 
 #pragma once
 
+#include <future>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <unordered_map>
+#include <utility>
 #include "paddle/cinn/backends/compiler.h"
 #include "paddle/cinn/common/macros.h"
 #include "paddle/cinn/common/target.h"
@@ -46,6 +49,7 @@ class BackendResource final {
   const std::shared_ptr<backends::Compiler>& GetBackendCompiler() const;
   void SetHostFnName(const std::string& name);
   void SetInferFnName(const std::string& name);
+  const std::string& GetHostFnName() const { return host_fn_name_; }
 
  private:
   std::string host_fn_name_;
@@ -65,13 +69,19 @@ class CompilationResult final {
     return backend_resource_;
   }
   pir::CINNKernelInfo GetKernelInfo(
-      const std::shared_ptr<pir::OpLoweringGroup>& group) {
-    return backend_resource_.GernerateKernelInfo(group);
+      const std::shared_ptr<pir::OpLoweringGroup>& group);
+
+  // Marks the result as compiled in the background. Until the future is
+  // ready, GetKernelInfo returns kernel infos with async_fn_ptrs set.
+  void SetAsyncFnPtrs(
+      const std::shared_future<std::pair<void*, void*>>& async_fn_ptrs) {
+    async_fn_ptrs_ = async_fn_ptrs;
   }
 
  private:
   Target target_;
   BackendResource backend_resource_;
+  std::shared_future<std::pair<void*, void*>> async_fn_ptrs_;
 };
 }  // namespace pir
 
@@ -96,6 +106,8 @@ class CompilationCache {
   CompilationCache() = default;
   CINN_DISALLOW_COPY_AND_ASSIGN(CompilationCache);
 
+  // Groups are compiled by several threads, see PirCompiler::Build.
+  mutable std::mutex mutex_;
   std::unordered_map<size_t, CacheValue> cache_;
 };
 
@@ -0,0 +1,372 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/hlir/framework/pir/compilation_disk_cache.h"
+
+#include <llvm/Config/llvm-config.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/cinn/hlir/framework/pir/op_lowering_group.h"
+#include "paddle/cinn/hlir/framework/visualize_helper.h"
+#include "paddle/cinn/runtime/flags.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/commit.h"
+#ifdef CINN_WITH_CUDA
+#include <cuda.h>
+#include <cuda_runtime.h>
+#endif
+
+PD_DECLARE_string(cinn_compilation_cache_dir);
+PD_DECLARE_bool(nvrtc_compile_to_cubin);
+PD_DECLARE_bool(cinn_nvrtc_cubin_with_fmad);
+PD_DECLARE_bool(cinn_compile_with_nvrtc);
+PD_DECLARE_bool(cinn_bucket_compile);
+PD_DECLARE_bool(cinn_new_group_scheduler);
+PD_DECLARE_bool(cinn_enable_map_expr);
+PD_DECLARE_bool(cinn_enable_map_expr_schedule);
+PD_DECLARE_bool(cinn_enable_map_expr_inline);
+PD_DECLARE_bool(cinn_enable_map_expr_dynamic_shape);
+PD_DECLARE_bool(cinn_use_cuda_vectorize);
+
+namespace cinn::hlir::framework {
+
+namespace {
+
+// Bump it whenever the key or the entry layout changes.
+constexpr char kFormatVersion[] = "cinn_compilation_cache_v2";
+
+// Bump it whenever lowering or codegen changes the code generated for the
+// same group. The commit id covers the builds from git, this covers the
+// ones from source archives, which have none.
+constexpr int kCodeGenVersion = 1;
+
+// Renames the symbols of the dim exprs in order of first appearance, so
+// that groups which only differ in symbol numbering share an entry.
+std::string CanonicalizeSymbols(const std::string& text) {
+  std::unordered_map<std::string, std::string> renamed;
+  std::string result;
+  size_t i = 0;
+  while (i < text.size()) {
+    if (std::isalpha(text[i]) || text[i] == '_') {
+      size_t j = i;
+      while (j < text.size() && (std::isalnum(text[j]) || text[j] == '_')) {
+        ++j;
+      }
+      std::string token = text.substr(i, j - i);
+      bool is_symbol = token.size() > 1 && token[0] == 'S';
+      for (size_t k = 1; is_symbol && k < token.size(); ++k) {
+        is_symbol = std::isdigit(token[k]);
+      }
+      if (is_symbol) {
+        auto iter = renamed.find(token);
+        if (iter == renamed.end()) {
+          iter =
+              renamed.emplace(token, "S" + std::to_string(renamed.size()))
+                  .first;
+        }
+        result += iter->second;
+      } else {
+        result += token;
+      }
+      i = j;
+    } else {
+      result.push_back(text[i++]);
+    }
+  }
+  return result;
+}
+
+// FNV-1a, which unlike std::hash is the same in every build.
+uint64_t StableHash(const std::string& text) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+void WriteString(std::ostream& os, const std::string& value) {
+  uint64_t size = value.size();
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  os.write(value.data(), value.size());
+}
+
+template <typename T>
+void WritePod(std::ostream& os, T value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool ReadString(std::istream& is, std::string* value) {
+  uint64_t size = 0;
+  if (!is.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+    return false;
+  }
+  value->resize(size);
+  return static_cast<bool>(is.read(&(*value)[0], size));
+}
+
+template <typename T>
+bool ReadPod(std::istream& is, T* value) {
+  return static_cast<bool>(is.read(reinterpret_cast<char*>(value), sizeof(T)));
+}
+
+std::string ToolchainKey(const Target& target) {
+  std::stringstream ss;
+  ss << kFormatVersion << ";codegen=" << kCodeGenVersion
+     << ";paddle=" << paddle::framework::paddle_version()
+     << ";commit=" << paddle::framework::paddle_commit()
+     << ";cxx=" << __VERSION__ << ";llvm=" << LLVM_VERSION_STRING
+     << ";target=" << target;
+#ifdef CINN_WITH_CUDA
+  ss << ";cuda=" << CUDA_VERSION;
+  if (target.arch == Target::Arch::NVGPU) {
+    int device_id = 0;
+    int major = 0;
+    int minor = 0;
+    cudaGetDevice(&device_id);
+    cudaDeviceGetAttribute(
+        &major, cudaDevAttrComputeCapabilityMajor, device_id);
+    cudaDeviceGetAttribute(
+        &minor, cudaDevAttrComputeCapabilityMinor, device_id);
+    ss << ";sm=" << major << minor;
+  }
+#endif
+  ss << ";flags=" << FLAGS_nvrtc_compile_to_cubin
+     << FLAGS_cinn_nvrtc_cubin_with_fmad << FLAGS_cinn_compile_with_nvrtc
+     << FLAGS_cinn_bucket_compile << FLAGS_cinn_new_group_scheduler
+     << FLAGS_cinn_enable_map_expr << FLAGS_cinn_enable_map_expr_schedule
+     << FLAGS_cinn_enable_map_expr_inline
+     << FLAGS_cinn_enable_map_expr_dynamic_shape
+     << FLAGS_cinn_use_cuda_vectorize;
+  return ss.str();
+}
+
+}  // namespace
+
+bool CompilationDiskCache::Enabled() const {
+  return !FLAGS_cinn_compilation_cache_dir.empty();
+}
+
+std::string GroupStructureKey(
+    const std::shared_ptr<pir::OpLoweringGroup>& group,
+    bool with_symbolic_shapes) {
+  std::unordered_map<const ::pir::Operation*, size_t> op_index;
+  for (size_t i = 0; i < group->ops().size(); ++i) {
+    op_index[group->ops()[i]] = i;
+  }
+  std::unordered_map<::pir::Value, size_t> input_index;
+  std::stringstream ops;
+  std::stringstream shapes;
+  const auto& ValueKey = [&](const ::pir::Value& value) -> std::string {
+    if (value && op_index.count(value.defining_op())) {
+      return "op#" + std::to_string(op_index.at(value.defining_op())) + ":" +
+             std::to_string(value.dyn_cast<::pir::OpResult>().index());
+    }
+    auto iter = input_index.find(value);
+    if (iter == input_index.end()) {
+      iter = input_index.emplace(value, input_index.size()).first;
+    }
+    return "in#" + std::to_string(iter->second);
+  };
+  const auto& ShapeKey = [&](const ::pir::Value& value) {
+    if (with_symbolic_shapes && group->HasShapeOrDataExprs(value)) {
+      shapes << ValueKey(value) << "=" << group->GetShapeOrDataExprs(value)
+             << ";";
+    }
+  };
+
+  for (::pir::Operation* op : group->ops()) {
+    ops << op->name() << "(";
+    for (const ::pir::Value& operand : op->operands_source()) {
+      const bool is_new_input =
+          operand && !op_index.count(operand.defining_op()) &&
+          !input_index.count(operand);
+      ops << ValueKey(operand);
+      if (is_new_input && operand.type()) {
+        ops << ":" << operand.type();
+      }
+      ops << ",";
+      ShapeKey(operand);
+    }
+    ops << ")->(";
+    for (const ::pir::Value& result : op->results()) {
+      if (result && result.type()) {
+        ops << result.type();
+      }
+      ops << ",";
+      ShapeKey(result);
+    }
+    ops << "){";
+    std::map<std::string, ::pir::Attribute> attributes(
+        op->attributes().begin(), op->attributes().end());
+    for (const auto& [name, attr] : attributes) {
+      if (name == "op_callstack") {
+        continue;
+      }
+      ops << name << ":" << attr << ",";
+    }
+    ops << "};";
+  }
+  ops << "kind=" << group->op_pattern_kind() << ";loop_ranges=";
+  for (int64_t range : group->loop_ranges()) {
+    ops << range << ",";
+  }
+  ops << ";reduce_axis=";
+  for (int64_t axis : group->reduce_axis()) {
+    ops << axis << ",";
+  }
+  if (!with_symbolic_shapes) {
+    return ops.str();
+  }
+  shapes << "loop_ranges_expr=";
+  for (const symbol::DimExpr& expr : group->loop_ranges_expr()) {
+    shapes << expr << ",";
+  }
+  return ops.str() + "\n" + CanonicalizeSymbols(shapes.str());
+}
+
+std::string CompilationDiskCache::Key(const GroupPtr& group,
+                                      const Target& target) const {
+  return ToolchainKey(target) + "\n" +
+         GroupStructureKey(group, /*with_symbolic_shapes=*/true);
+}
+
+std::string CompilationDiskCache::EntryPath(const std::string& key) const {
+  char name[32];
+  snprintf(name,
+           sizeof(name),
+           "%016llx.bin",
+           static_cast<unsigned long long>(StableHash(key)));  // NOLINT
+  return FLAGS_cinn_compilation_cache_dir + "/" + name;
+}
+
+CompilationCache::CacheValue CompilationDiskCache::Load(
+    const std::string& key, const GroupPtr& group, const Target& target) const {
+  std::ifstream is(EntryPath(key), std::ios::in | std::ios::binary);
+  if (!is) {
+    return nullptr;
+  }
+  std::string stored_key;
+  std::string host_fn_name;
+  std::string infer_fn_name;
+  uint64_t num_int_args = 0;
+  std::map<int, pir::CINNKernelInfo::ArgDimIdx> int_args_map;
+  backends::Compiler::CompiledModule compiled;
+  uint64_t num_kernels = 0;
+  bool ok = ReadString(is, &stored_key) && stored_key == key &&
+            ReadString(is, &host_fn_name) && ReadString(is, &infer_fn_name) &&
+            ReadPod(is, &num_int_args);
+  for (uint64_t i = 0; ok && i < num_int_args; ++i) {
+    int arg = 0;
+    pir::CINNKernelInfo::ArgDimIdx idx;
+    ok = ReadPod(is, &arg) && ReadPod(is, &idx.arg_idx) &&
+         ReadPod(is, &idx.dim_idx);
+    int_args_map[arg] = idx;
+  }
+  ok = ok && ReadString(is, &compiled.host_object) &&
+       ReadString(is, &compiled.device_code) &&
+       ReadPod(is, &compiled.device_code_is_cubin) &&
+       ReadPod(is, &num_kernels);
+  for (uint64_t i = 0; ok && i < num_kernels; ++i) {
+    std::string kernel_name;
+    ok = ReadString(is, &kernel_name);
+    compiled.kernel_names.push_back(kernel_name);
+  }
+  if (!ok) {
+    VLOG(4) << "Skip the mismatched or broken compilation cache entry "
+            << EntryPath(key);
+    return nullptr;
+  }
+
+  auto compilation_result = std::make_shared<pir::CompilationResult>(target);
+  pir::BackendResource& backend_resource =
+      compilation_result->MutableBackendResource();
+  if (!backend_resource.GetBackendCompiler()->LoadCompiled(compiled)) {
+    return nullptr;
+  }
+  backend_resource.SetHostFnName(host_fn_name);
+  backend_resource.SetInferFnName(infer_fn_name);
+  group->mut_int_args_map() = int_args_map;
+  VLOG(4) << "Load compiled kernel of group " << group->FuncName() << " from "
+          << EntryPath(key);
+  return compilation_result;
+}
+
+void CompilationDiskCache::Save(
+    const std::string& key,
+    const GroupPtr& group,
+    const CompilationCache::CacheValue& value) const {
+  static const bool has_directory = [] {
+    if (MakeDirectory(FLAGS_cinn_compilation_cache_dir,
+                      S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH)) {
+      return true;
+    }
+    LOG(WARNING) << "Failed to make directory: \""
+                 << FLAGS_cinn_compilation_cache_dir
+                 << "\", the compiled kernels will not be cached on disk.";
+    return false;
+  }();
+  if (!has_directory) {
+    return;
+  }
+
+  backends::Compiler::CompiledModule compiled =
+      value->GetBackendResource().GetBackendCompiler()->ExportCompiled();
+  const std::string path = EntryPath(key);
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid() << "." << std::this_thread::get_id();
+  {
+    std::ofstream os(tmp_path.str(),
+                     std::ios::out | std::ios::binary | std::ios::trunc);
+    WriteString(os, key);
+    WriteString(os, group->FuncName());
+    WriteString(os, group->FuncName() + "_infer_shape");
+    WritePod<uint64_t>(os, group->int_args_map().size());
+    for (const auto& [arg, idx] : group->int_args_map()) {
+      WritePod(os, arg);
+      WritePod(os, idx.arg_idx);
+      WritePod(os, idx.dim_idx);
+    }
+    WriteString(os, compiled.host_object);
+    WriteString(os, compiled.device_code);
+    WritePod(os, compiled.device_code_is_cubin);
+    WritePod<uint64_t>(os, compiled.kernel_names.size());
+    for (const std::string& kernel_name : compiled.kernel_names) {
+      WriteString(os, kernel_name);
+    }
+    if (!os) {
+      LOG(WARNING) << "Failed to write the compilation cache entry " << path;
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.str().c_str());
+    return;
+  }
+  VLOG(4) << "Save compiled kernel of group " << group->FuncName() << " to "
+          << path;
+}
+
+}  // namespace cinn::hlir::framework
@@ -0,0 +1,84 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "paddle/cinn/common/macros.h"
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/hlir/framework/pir/compilation_cache.h"
+
+namespace cinn::hlir::framework {
+
+namespace pir {
+class OpLoweringGroup;
+}  // namespace pir
+
+/**
+ * Serializes the ops of the group with their attributes, types and operand
+ * wiring, independently of the names and addresses of this process. Symbols
+ * of the symbolic shapes are renamed in order of appearance.
+ */
+std::string GroupStructureKey(
+    const std::shared_ptr<pir::OpLoweringGroup>& group,
+    bool with_symbolic_shapes);
+
+/**
+ * The on-disk tier of CompilationCache, enabled by
+ * FLAGS_cinn_compilation_cache_dir.
+ *
+ * CompilationCache is keyed by the function name of a group, which is unique
+ * in a process, so every new process lowers and compiles all its groups again.
+ * This cache keys the compiled binaries of a group by its structure instead:
+ * the ops with their attributes and types, the symbolic shapes, the target,
+ * the toolchain and the flags that change the generated code. A new process
+ * that meets the same group links the cached binaries and skips lowering and
+ * codegen.
+ *
+ * Entries are written to a temporary file and renamed, so several processes
+ * may share the same directory.
+ */
+class CompilationDiskCache {
+ public:
+  using GroupPtr = std::shared_ptr<pir::OpLoweringGroup>;
+
+  static CompilationDiskCache& Instance() {
+    static CompilationDiskCache instance;
+    return instance;
+  }
+
+  bool Enabled() const;
+
+  // Must be called before the group is lowered, which changes the group.
+  std::string Key(const GroupPtr& group, const Target& target) const;
+
+  // Returns nullptr on a miss. On a hit, the int args of the group are
+  // restored as well.
+  CompilationCache::CacheValue Load(const std::string& key,
+                                    const GroupPtr& group,
+                                    const Target& target) const;
+
+  void Save(const std::string& key,
+            const GroupPtr& group,
+            const CompilationCache::CacheValue& value) const;
+
+ private:
+  CompilationDiskCache() = default;
+  CINN_DISALLOW_COPY_AND_ASSIGN(CompilationDiskCache);
+
+  std::string EntryPath(const std::string& key) const;
+};
+
+}  // namespace cinn::hlir::framework
@@ -17,6 +17,7 @@
 #include "paddle/cinn/hlir/framework/pir/compilation_task.h"
 #include "paddle/cinn/common/target.h"
 #include "paddle/cinn/hlir/framework/op_lowering.h"
+#include "paddle/cinn/hlir/framework/pir/compilation_disk_cache.h"
 #include "paddle/common/enforce.h"
 
 namespace cinn {
@@ -44,13 +45,30 @@ std::string GroupCompilationContext::PrintPredicate2Funcs() const {
 
 void CompilationTask::operator()() {
   VLOG(4) << "Run Compilation Task for : " << context_->group_.get();
+  if (NeedCompile()) {
+    Lowering();
+    CodegenAndJit();
+  }
+}
+
+bool CompilationTask::NeedCompile() {
   if (CompilationCache::Instance().Has(context_->group_)) {
     VLOG(4) << "Found cached kernel info for group: "
             << context_->group_->FuncName();
-    return;
+    return false;
+  }
+  if (CompilationDiskCache::Instance().Enabled()) {
+    disk_cache_key_ = CompilationDiskCache::Instance().Key(context_->group_,
+                                                           context_->target_);
+    auto compilation_result = CompilationDiskCache::Instance().Load(
+        disk_cache_key_, context_->group_, context_->target_);
+    if (compilation_result) {
+      CompilationCache::Instance().Insert(context_->group_,
+                                          compilation_result);
+      return false;
+    }
   }
-  Lowering();
-  CodegenAndJit();
+  return true;
 }
 
 void CompilationTask::Lowering() {
@@ -63,6 +81,25 @@ void CompilationTask::Lowering() {
 }
 
 void CompilationTask::CodegenAndJit() {
+  auto compilation_result = CreateCompilationResult();
+  CodegenAndJit(compilation_result);
+  CompilationCache::Instance().Insert(context_->group_, compilation_result);
+}
+
+std::shared_ptr<pir::CompilationResult>
+CompilationTask::CreateCompilationResult() const {
+  auto compilation_result =
+      std::make_shared<pir::CompilationResult>(context_->target_);
+  pir::BackendResource& backend_resource =
+      compilation_result->MutableBackendResource();
+  backend_resource.SetHostFnName(context_->group_->FuncName());
+  backend_resource.SetInferFnName(context_->group_->FuncName() +
+                                  "_infer_shape");
+  return compilation_result;
+}
+
+void CompilationTask::CodegenAndJit(
+    const std::shared_ptr<pir::CompilationResult>& compilation_result) {
   ir::Module::Builder builder(cinn::common::UniqName("module"),
                               context_->target_);
   CHECK_EQ(context_->predicates_.size(), context_->lowered_funcs_.size());
@@ -74,7 +111,7 @@ void CompilationTask::CodegenAndJit() {
   }
   builder.SetInferShapeFunc(context_->infer_shape_lowered_func_);
   ir::Module ir_module = builder.Build();
-  BuildPirCINNKernelInfo(ir_module);
+  BuildPirCINNKernelInfo(ir_module, compilation_result);
 }
 
 pir::CINNKernelInfo CompilationTask::GetCINNKernelInfo() {
@@ -85,16 +122,15 @@ pir::CINNKernelInfo CompilationTask::GetCINNKernelInfo() {
   return CompilationCache::Instance().GetKernelInfo(context_->group_);
 }
 
-void CompilationTask::BuildPirCINNKernelInfo(const ir::Module& module) {
-  auto compilation_result =
-      std::make_shared<pir::CompilationResult>(context_->target_);
-  pir::BackendResource& backend_resource =
-      compilation_result->MutableBackendResource();
-  backend_resource.GetBackendCompiler()->Build(module, "");
-  backend_resource.SetHostFnName(context_->group_->FuncName());
-  backend_resource.SetInferFnName(context_->group_->FuncName() +
-                                  "_infer_shape");
-  CompilationCache::Instance().Insert(context_->group_, compilation_result);
+void CompilationTask::BuildPirCINNKernelInfo(
+    const ir::Module& module,
+    const std::shared_ptr<pir::CompilationResult>& compilation_result) {
+  compilation_result->MutableBackendResource().GetBackendCompiler()->Build(
+      module, "");
+  if (!disk_cache_key_.empty()) {
+    CompilationDiskCache::Instance().Save(
+        disk_cache_key_, context_->group_, compilation_result);
+  }
 }
 
 }  // namespace framework
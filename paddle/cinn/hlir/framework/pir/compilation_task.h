@@ -38,8 +38,10 @@ class GroupCompilationContext {
 
  private:
   friend class CompilationTask;
-  const Target& target_;
-  const pir::OpLoweringGroupPtr& group_;
+  // Held by value, since the codegen may outlive PirCompiler::Build, see
+  // FLAGS_cinn_async_compile.
+  const Target target_;
+  const pir::OpLoweringGroupPtr group_;
   std::vector<ir::SymbolicPredicate> predicates_;
   std::vector<ir::LoweredFunc> lowered_funcs_;
   ir::LoweredFunc infer_shape_lowered_func_;
@@ -53,13 +55,27 @@ class CompilationTask {
   void operator()();
   pir::CINNKernelInfo GetCINNKernelInfo();
 
- private:
+  // The stages of operator(), which PirCompiler runs on different threads.
+  // Returns false if the kernel of the group is found in the caches.
+  bool NeedCompile();
   void Lowering();
   void CodegenAndJit();
+
+  // Splits CodegenAndJit, so that the result can be inserted into
+  // CompilationCache before the group is compiled in the background.
+  std::shared_ptr<pir::CompilationResult> CreateCompilationResult() const;
+  void CodegenAndJit(
+      const std::shared_ptr<pir::CompilationResult>& compilation_result);
+
+ private:
   std::unique_ptr<Instruction> BuildInstruction();
-  void BuildPirCINNKernelInfo(const ir::Module& module);
+  void BuildPirCINNKernelInfo(
+      const ir::Module& module,
+      const std::shared_ptr<pir::CompilationResult>& compilation_result);
 
   GroupCompilationContext* context_;
+  // Key of the group in CompilationDiskCache, empty if it is disabled.
+  std::string disk_cache_key_;
 };
 
 }  // namespace framework
@@ -23,6 +23,7 @@
 #include "paddle/cinn/hlir/framework/compile_error.h"
 #include "paddle/cinn/hlir/framework/pir/op_lowering_util.h"
 #include "paddle/cinn/hlir/framework/pir/trivial_op_impl.h"
+#include "paddle/cinn/hlir/framework/pir/tuned_schedule.h"
 #include "paddle/cinn/hlir/framework/pir/utils.h"
 #include "paddle/cinn/hlir/op/external_api_registry.h"
 #include "paddle/cinn/hlir/pe/map_expr_to_ir.h"
@@ -242,7 +243,11 @@ BucketLoweredFuncsWrapper OpLowererImpl::BucketLower(
     }
   }
 
-  if (apply_group_schedule) {
+  if (apply_group_schedule && TunedScheduleDatabase::Instance().Enabled() &&
+      TunedScheduleDatabase::Instance().Apply(group, target_, &ir_sch)) {
+    cond2func_bodies.emplace_back(ir::Expr(true),
+                                  ir_sch.GetModule().GetExprs()[0]);
+  } else if (apply_group_schedule) {
     std::unordered_set<std::string> output_tensor_names;
     for (auto value : group->GetGroupOutputValues()) {
       output_tensor_names.insert(ValueName(value));
@@ -263,6 +268,10 @@ BucketLoweredFuncsWrapper OpLowererImpl::BucketLower(
 
     cond2func_bodies = group_scheduler->GetIRs();
     VLOG(4) << "End   group_scheduler->GetIRs";
+    if (TunedScheduleDatabase::Instance().Recording()) {
+      TunedScheduleDatabase::Instance().AddBaselineRecord(
+          group, target_, group_scheduler->GetTraces());
+    }
   } else {
     cond2func_bodies.emplace_back(ir::Expr(true),
                                   ir_sch.GetModule().GetExprs()[0]);
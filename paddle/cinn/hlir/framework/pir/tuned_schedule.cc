@@ -0,0 +1,240 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/hlir/framework/pir/tuned_schedule.h"
+
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include "paddle/cinn/hlir/framework/pir/compilation_disk_cache.h"
+#include "paddle/cinn/hlir/framework/pir/op_lowering_group.h"
+#include "paddle/cinn/hlir/framework/pir/utils.h"
+#include "paddle/cinn/ir/schedule/schedule_desc.h"
+#include "paddle/cinn/ir/utils/ir_copy.h"
+#include "paddle/cinn/runtime/flags.h"
+#include "paddle/common/ddim.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+
+PD_DECLARE_string(cinn_tuning_record_file);
+PD_DECLARE_bool(cinn_tuning_record_schedules);
+
+namespace cinn::hlir::framework::pir {
+
+namespace {
+
+using NameMap = std::unordered_map<std::string, std::string>;
+
+bool HasStaticShape(const ::pir::Value& value) {
+  auto tensor_type = value.type().dyn_cast<paddle::dialect::DenseTensorType>();
+  return tensor_type && !::common::contain_unknown_dim(tensor_type.dims());
+}
+
+// Maps the names of the values of the group in this process to their
+// positions in the group, in order of appearance.
+NameMap CanonicalNames(const std::shared_ptr<OpLoweringGroup>& group) {
+  NameMap names;
+  const auto& AddName = [&](const ::pir::Value& value) {
+    std::string name = CompatibleInfo::ValueName(value);
+    if (!names.count(name)) {
+      names.emplace(name, "t" + std::to_string(names.size()));
+    }
+  };
+  for (::pir::Operation* op : group->ops()) {
+    for (const ::pir::Value& operand : op->operands_source()) {
+      if (operand) {
+        AddName(operand);
+      }
+    }
+    for (const ::pir::Value& result : op->results()) {
+      if (result) {
+        AddName(result);
+      }
+    }
+  }
+  return names;
+}
+
+NameMap Inverse(const NameMap& names) {
+  NameMap inverse;
+  for (const auto& [from, to] : names) {
+    inverse.emplace(to, from);
+  }
+  return inverse;
+}
+
+// Renames a tensor name, or a name derived from one, such as "var_1_0" or
+// "var_1_reduce_tmp", by the longest name it starts with.
+std::string Rename(const std::string& name, const NameMap& names) {
+  const std::string* longest = nullptr;
+  for (const auto& [from, to] : names) {
+    bool matched = name == from || (name.size() > from.size() &&
+                                    name.compare(0, from.size(), from) == 0 &&
+                                    name[from.size()] == '_');
+    if (matched && (!longest || from.size() > longest->size())) {
+      longest = &from;
+    }
+  }
+  if (!longest) {
+    return name;
+  }
+  return names.at(*longest) + name.substr(longest->size());
+}
+
+void RenameTrace(const NameMap& names, ir::proto::ScheduleDesc* trace) {
+  for (auto& step : *trace->mutable_steps()) {
+    for (auto& attr : *step.mutable_attrs()) {
+      if (attr.dtype() == ir::proto::ScheduleDesc_Attr_DataType_STRING) {
+        attr.set_s(Rename(attr.s(), names));
+      } else if (attr.dtype() ==
+                 ir::proto::ScheduleDesc_Attr_DataType_STRINGS) {
+        for (auto& s : *attr.mutable_strings()) {
+          s = Rename(s, names);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+bool TunedScheduleDatabase::Enabled() const {
+  return !FLAGS_cinn_tuning_record_file.empty();
+}
+
+bool TunedScheduleDatabase::Recording() const {
+  return Enabled() && FLAGS_cinn_tuning_record_schedules;
+}
+
+std::string TunedScheduleDatabase::TaskKey(const GroupPtr& group,
+                                           const Target& target) const {
+  for (::pir::Operation* op : group->ops()) {
+    for (const ::pir::Value& value : op->operands_source()) {
+      if (value && !HasStaticShape(value)) {
+        return "";
+      }
+    }
+    for (const ::pir::Value& value : op->results()) {
+      if (value && !HasStaticShape(value)) {
+        return "";
+      }
+    }
+  }
+  std::stringstream ss;
+  ss << target << "\n"
+     << GroupStructureKey(group, /*with_symbolic_shapes=*/false);
+  return ss.str();
+}
+
+auto_schedule::Database* TunedScheduleDatabase::GetDatabase() {
+  if (!database_) {
+    auto_schedule::DatabaseConfig config;
+    config.type = auto_schedule::DatabaseType::kJSONFile;
+    config.capacity_per_task = 1;
+    config.record_file_path = FLAGS_cinn_tuning_record_file;
+    database_ = auto_schedule::Database::Make(config);
+  }
+  return database_.get();
+}
+
+bool TunedScheduleDatabase::Apply(const GroupPtr& group,
+                                  const Target& target,
+                                  ir::IRSchedule* ir_sch) {
+  const std::string task_key = TaskKey(group, target);
+  if (task_key.empty()) {
+    return false;
+  }
+  std::vector<auto_schedule::TuningRecord> records;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    records = GetDatabase()->GetTopK(task_key, 1);
+  }
+  if (records.empty()) {
+    VLOG(4) << "No tuned schedule of group " << group->FuncName();
+    return false;
+  }
+
+  ir::proto::ScheduleDesc trace = records[0].trace;
+  RenameTrace(Inverse(CanonicalNames(group)), &trace);
+  ir::IRSchedule tuned_sch(ir::ir_utils::IRCopy(ir_sch->GetModule()),
+                           /*rand_seed=*/-1,
+                           /*debug_flag=*/false,
+                           utils::ErrorMessageLevel::kGeneral,
+                           ir_sch->IsDynamicShape());
+  try {
+    ir::ScheduleDesc::ReplayWithProto(trace, &tuned_sch);
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to replay the tuned schedule of group "
+                 << group->FuncName() << ", use the group scheduler instead: "
+                 << e.what();
+    return false;
+  }
+  VLOG(4) << "Apply the tuned schedule of group " << group->FuncName()
+          << ", whose execution cost is " << records[0].execution_cost
+          << " us";
+  *ir_sch = std::move(tuned_sch);
+  return true;
+}
+
+void TunedScheduleDatabase::AddRecord(const GroupPtr& group,
+                                      const Target& target,
+                                      const ir::IRSchedule& tuned_sch,
+                                      double execution_cost) {
+  AddTrace(group, target, tuned_sch.GetTraceDesc(), execution_cost);
+}
+
+void TunedScheduleDatabase::AddBaselineRecord(
+    const GroupPtr& group,
+    const Target& target,
+    const std::vector<ir::ScheduleDesc>& traces) {
+  // A group with static shapes falls in exactly one bucket.
+  if (traces.size() != 1) {
+    return;
+  }
+  const std::string task_key = TaskKey(group, target);
+  if (task_key.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!GetDatabase()->GetTopK(task_key, 1).empty()) {
+      return;
+    }
+  }
+  VLOG(4) << "Record the schedule of group " << group->FuncName()
+          << " given by the group scheduler";
+  AddTrace(group, target, traces[0], std::numeric_limits<double>::max());
+}
+
+void TunedScheduleDatabase::AddTrace(const GroupPtr& group,
+                                     const Target& target,
+                                     const ir::ScheduleDesc& trace,
+                                     double execution_cost) {
+  auto_schedule::TuningRecord record;
+  record.task_key = TaskKey(group, target);
+  if (record.task_key.empty()) {
+    LOG(WARNING) << "Can not record the schedule of group "
+                 << group->FuncName() << ", which has dynamic shapes.";
+    return;
+  }
+  record.predicted_cost = 0;
+  record.trace = trace.ToProto();
+  RenameTrace(CanonicalNames(group), &record.trace);
+  record.execution_cost = execution_cost;
+  std::lock_guard<std::mutex> lock(mutex_);
+  GetDatabase()->AddRecord(record);
+}
+
+}  // namespace cinn::hlir::framework::pir
@@ -0,0 +1,96 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/cinn/auto_schedule/database/database.h"
+#include "paddle/cinn/common/macros.h"
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/ir/schedule/ir_schedule.h"
+
+namespace cinn::hlir::framework::pir {
+class OpLoweringGroup;
+
+/**
+ * The schedules of PIR groups tuned offline, kept in the JSON file of
+ * auto_schedule::JSONFileDatabase given by FLAGS_cinn_tuning_record_file.
+ *
+ * Records are keyed by the target and the structure of a group with its
+ * static shapes, so that groups with dynamic shapes are never looked up.
+ * The tensor names in the traces are replaced by the positions of the
+ * values in the group, since lowering names the tensors differently in
+ * every process.
+ */
+class TunedScheduleDatabase {
+ public:
+  using GroupPtr = std::shared_ptr<OpLoweringGroup>;
+
+  static TunedScheduleDatabase& Instance() {
+    static TunedScheduleDatabase instance;
+    return instance;
+  }
+
+  bool Enabled() const;
+
+  // Whether the schedules of the group scheduler are recorded, see
+  // FLAGS_cinn_tuning_record_schedules.
+  bool Recording() const;
+
+  // Returns the task key of the group, or an empty string if the group has
+  // dynamic shapes.
+  std::string TaskKey(const GroupPtr& group, const Target& target) const;
+
+  // Replays the best record of the group on `ir_sch`, which holds the merged
+  // and not yet scheduled function body of the group. Returns false and
+  // leaves `ir_sch` unchanged if there is no record or the replay fails.
+  bool Apply(const GroupPtr& group,
+             const Target& target,
+             ir::IRSchedule* ir_sch);
+
+  // Records the trace of `tuned_sch`, scheduled from the function body given
+  // to Apply, with its measured execution time in microseconds.
+  void AddRecord(const GroupPtr& group,
+                 const Target& target,
+                 const ir::IRSchedule& tuned_sch,
+                 double execution_cost);
+
+  // Records the trace of the group scheduler for a group with static shapes
+  // and no record yet, given the traces of its buckets. The record has the
+  // largest execution cost, so that any measured record replaces it.
+  void AddBaselineRecord(const GroupPtr& group,
+                         const Target& target,
+                         const std::vector<ir::ScheduleDesc>& traces);
+
+ private:
+  TunedScheduleDatabase() = default;
+  CINN_DISALLOW_COPY_AND_ASSIGN(TunedScheduleDatabase);
+
+  auto_schedule::Database* GetDatabase();
+
+  void AddTrace(const GroupPtr& group,
+                const Target& target,
+                const ir::ScheduleDesc& trace,
+                double execution_cost);
+
+  std::mutex mutex_;
+  std::unique_ptr<auto_schedule::Database> database_;
+};
+
+}  // namespace cinn::hlir::framework::pir
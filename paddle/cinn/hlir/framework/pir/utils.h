@@ -13,9 +13,11 @@
 // limitations under the License.
 
 #pragma once
+#include <future>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include "paddle/cinn/common/context.h"
 #include "paddle/cinn/common/type.h"
 #include "paddle/cinn/hlir/framework/op.h"
@@ -51,6 +53,11 @@ struct CINNKernelInfo {
   //     3: {1, 2}
   //   }
   std::map<int, ArgDimIdx> int_args_map;
+
+  // Set instead of fn_ptr and infer_shape_fn_ptr while the kernel is being
+  // compiled in the background, see FLAGS_cinn_async_compile. It provides
+  // {fn_ptr, infer_shape_fn_ptr} once the kernel is ready.
+  std::shared_future<std::pair<void*, void*>> async_fn_ptrs;
 };
 
 struct CompatibleInfo {
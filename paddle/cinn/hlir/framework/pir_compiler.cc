@@ -14,24 +14,253 @@
 
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <future>
+#include <limits>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+
 #include "paddle/cinn/hlir/framework/pir/utils.h"
+#include "paddle/cinn/runtime/flags.h"
 #include "paddle/cinn/utils/multi_threading.h"
+#include "paddle/phi/core/threadpool.h"
+#ifdef CINN_WITH_CUDA
+#include "paddle/cinn/backends/cuda_util.h"
+#endif
+
+PD_DECLARE_int32(cinn_parallel_compile_thread);
+PD_DECLARE_int32(cinn_parallel_codegen_thread);
+PD_DECLARE_bool(cinn_async_compile);
 
 namespace cinn::hlir::framework {
 
+namespace {
+
+// Indexes of the lowered groups, waiting for codegen. Push blocks while the
+// queue is full, so that lowering can not run far ahead of codegen and hold
+// the lowered functions of all the groups at once.
+class LoweredGroupQueue {
+ public:
+  explicit LoweredGroupQueue(size_t capacity) : capacity_(capacity) {}
+
+  void Push(int index) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [&] { return queue_.size() < capacity_ || closed_; });
+    queue_.push_back(index);
+    not_empty_.notify_one();
+  }
+
+  // Returns false once the queue is closed and empty.
+  bool Pop(int* index) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [&] { return !queue_.empty() || closed_; });
+    if (queue_.empty()) {
+      return false;
+    }
+    *index = queue_.front();
+    queue_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+ private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<int> queue_;
+  bool closed_{false};
+};
+
+int NumThreads(int num_threads, int num_groups) {
+  if (num_threads <= 0 || num_threads > std::thread::hardware_concurrency()) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  return std::max(1, std::min(num_threads, num_groups));
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void SetDevice(int device_id) {
+#ifdef CINN_WITH_CUDA
+  CUDA_CALL(cudaSetDevice(device_id));
+#endif
+}
+
+// The pool that runs the codegen of FLAGS_cinn_async_compile, shared by all
+// the PirCompilers of the process.
+phi::ThreadPool* AsyncCodegenPool() {
+  static std::once_flag init_flag;
+  static std::unique_ptr<phi::ThreadPool> pool;
+  std::call_once(init_flag, [] {
+    int num_threads = NumThreads(FLAGS_cinn_parallel_codegen_thread > 0
+                                     ? FLAGS_cinn_parallel_codegen_thread
+                                     : FLAGS_cinn_parallel_compile_thread,
+                                 std::numeric_limits<int>::max());
+    VLOG(4) << "Create the async codegen pool with " << num_threads
+            << " threads";
+    pool = std::make_unique<phi::ThreadPool>(num_threads);
+  });
+  return pool.get();
+}
+
+// Inserts the result of the lowered group into CompilationCache, and runs
+// its codegen and jit in the background.
+void CodegenAndJitAsync(const pir::OpLoweringGroupPtr& group,
+                        const std::shared_ptr<GroupCompilationContext>& context,
+                        const std::shared_ptr<CompilationTask>& task,
+                        int device_id) {
+  auto compilation_result = task->CreateCompilationResult();
+  auto fn_ptrs = std::make_shared<std::promise<std::pair<void*, void*>>>();
+  compilation_result->SetAsyncFnPtrs(fn_ptrs->get_future().share());
+  CompilationCache::Instance().Insert(group, compilation_result);
+  AsyncCodegenPool()->RunAndGetException(
+      [context, task, compilation_result, fn_ptrs, device_id]() {
+        try {
+          SetDevice(device_id);
+          task->CodegenAndJit(compilation_result);
+          const auto& backend_resource =
+              compilation_result->GetBackendResource();
+          fn_ptrs->set_value({backend_resource.GetHostFuncPtr(),
+                              backend_resource.GetInferFuncPtr()});
+        } catch (...) {
+          fn_ptrs->set_exception(std::current_exception());
+        }
+      });
+}
+
+}  // namespace
+
 std::vector<pir::CINNKernelInfo> PirCompiler::Build(
     const std::vector<pir::OpLoweringGroupPtr>& groups) {
+  const auto build_start = std::chrono::steady_clock::now();
   std::vector<pir::CINNKernelInfo> kernel_infos(groups.size());
+  stats_ = Stats();
+  stats_.num_groups = groups.size();
+  if (groups.empty()) {
+    return kernel_infos;
+  }
+  group_compilation_contexts_.clear();
+  std::vector<std::shared_ptr<CompilationTask>> tasks;
   for (int i = 0; i < groups.size(); ++i) {
-    group_compilation_contexts_.emplace_back(target_, groups[i]);
+    group_compilation_contexts_.push_back(
+        std::make_shared<GroupCompilationContext>(target_, groups[i]));
+    tasks.push_back(std::make_shared<CompilationTask>(
+        group_compilation_contexts_.back().get()));
   }
-  auto worker_fn = [&](int index) {
-    CompilationTask task(&group_compilation_contexts_[index]);
-    task();
-    kernel_infos[index] = task.GetCINNKernelInfo();
+
+  int device_id = 0;
+#ifdef CINN_WITH_CUDA
+  CUDA_CALL(cudaGetDevice(&device_id));
+#endif
+
+  const bool async_compile = FLAGS_cinn_async_compile;
+  int num_lowering_threads =
+      NumThreads(FLAGS_cinn_parallel_compile_thread, groups.size());
+  int num_codegen_threads =
+      async_compile ? 0
+                    : NumThreads(FLAGS_cinn_parallel_codegen_thread > 0
+                                     ? FLAGS_cinn_parallel_codegen_thread
+                                     : num_lowering_threads,
+                                 groups.size());
+  VLOG(4) << "Compile " << groups.size() << " groups with "
+          << num_lowering_threads << " lowering threads and "
+          << num_codegen_threads << " codegen threads, async compile: "
+          << async_compile;
+
+  LoweredGroupQueue lowered_groups(2 * std::max(num_codegen_threads, 1));
+  std::atomic<int> num_cached_groups{0};
+  std::atomic<int64_t> lowering_us{0};
+  std::atomic<int64_t> codegen_us{0};
+
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  const auto& SaveError = [&]() {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (!error) {
+      error = std::current_exception();
+    }
   };
-  utils::parallel_run(
-      worker_fn, utils::SequenceDispatcher(0, groups.size()), 1);
+
+  std::vector<std::thread> codegen_threads;
+  for (int i = 0; i < num_codegen_threads; ++i) {
+    codegen_threads.emplace_back([&]() {
+      SetDevice(device_id);
+      int index = -1;
+      while (lowered_groups.Pop(&index)) {
+        try {
+          const auto start = std::chrono::steady_clock::now();
+          tasks[index]->CodegenAndJit();
+          codegen_us += static_cast<int64_t>(ElapsedMs(start) * 1000);
+        } catch (...) {
+          SaveError();
+        }
+      }
+    });
+  }
+
+  auto lowering_fn = [&](int index) {
+    SetDevice(device_id);
+    if (!tasks[index]->NeedCompile()) {
+      ++num_cached_groups;
+      return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    tasks[index]->Lowering();
+    lowering_us += static_cast<int64_t>(ElapsedMs(start) * 1000);
+    if (async_compile) {
+      CodegenAndJitAsync(groups[index],
+                         group_compilation_contexts_[index],
+                         tasks[index],
+                         device_id);
+    } else {
+      lowered_groups.Push(index);
+    }
+  };
+  try {
+    utils::parallel_run(lowering_fn,
+                        utils::SequenceDispatcher(0, groups.size()),
+                        num_lowering_threads);
+  } catch (...) {
+    SaveError();
+  }
+  lowered_groups.Close();
+  for (auto& thread : codegen_threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  for (int i = 0; i < groups.size(); ++i) {
+    kernel_infos[i] = tasks[i]->GetCINNKernelInfo();
+  }
+
+  stats_.num_cached_groups = num_cached_groups;
+  stats_.lowering_ms = lowering_us / 1000.0;
+  stats_.codegen_and_jit_ms = codegen_us / 1000.0;
+  stats_.total_ms = ElapsedMs(build_start);
+  VLOG(1) << "PirCompiler built " << stats_.num_groups << " groups ("
+          << stats_.num_cached_groups << " cached) in " << stats_.total_ms
+          << " ms, lowering " << stats_.lowering_ms << " ms, codegen and jit "
+          << stats_.codegen_and_jit_ms << " ms";
   return kernel_infos;
 }
 
@@ -15,23 +15,49 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "paddle/cinn/common/macros.h"
 #include "paddle/cinn/hlir/framework/pir/compilation_task.h"
 
 namespace cinn::hlir::framework {
 
+/**
+ * Compiles the groups of a program in a pipeline: groups are lowered by
+ * FLAGS_cinn_parallel_compile_thread threads, and each lowered group is
+ * handed to a bounded pool of FLAGS_cinn_parallel_codegen_thread threads
+ * for codegen, NVRTC and jit, which runs while other groups are lowered.
+ *
+ * With FLAGS_cinn_async_compile, Build returns once the groups are lowered,
+ * and the codegen keeps running in the background. The kernel infos of the
+ * groups still being compiled carry CINNKernelInfo::async_fn_ptrs.
+ */
 class PirCompiler final {
  public:
+  // The compile time of the last Build. The stage times are summed over the
+  // threads of the stage, and codegen_and_jit_ms does not count the groups
+  // compiled in the background.
+  struct Stats {
+    int num_groups{0};
+    int num_cached_groups{0};
+    double lowering_ms{0};
+    double codegen_and_jit_ms{0};
+    double total_ms{0};
+  };
+
   PirCompiler(const Target& target) : target_(target) {}
 
   std::vector<pir::CINNKernelInfo> Build(
       const std::vector<pir::OpLoweringGroupPtr>& groups);
 
+  const Stats& stats() const { return stats_; }
+
  private:
   CINN_DISALLOW_COPY_AND_ASSIGN(PirCompiler);
 
   Target target_;
-  std::vector<GroupCompilationContext> group_compilation_contexts_;
+  std::vector<std::shared_ptr<GroupCompilationContext>>
+      group_compilation_contexts_;
+  Stats stats_;
 };
 
 }  // namespace cinn::hlir::framework
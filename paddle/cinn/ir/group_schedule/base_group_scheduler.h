@@ -65,6 +65,10 @@ class GroupScheduler {
 
   virtual std::vector<std::pair<SymbolicPredicate, ir::Expr>> GetIRs() = 0;
 
+  // Returns the scheduling traces of the IRs in the order of GetIRs, or
+  // nothing if the scheduler doesn't trace them.
+  virtual std::vector<ir::ScheduleDesc> GetTraces() { return {}; }
+
   std::unordered_set<std::string> OutputTensorNames() const;
 
  protected:
@@ -23,13 +23,87 @@
 #include "paddle/cinn/ir/group_schedule/tactic/tile_first_general_tactic.h"
 #include "paddle/cinn/ir/group_schedule/tactic/tile_tactic.h"
 #include "paddle/cinn/ir/ir_analyzer/ir_analyzer.h"
+#include "paddle/cinn/ir/ir_mutator.h"
 #include "paddle/cinn/ir/op/ir_operators.h"
+#include "paddle/cinn/ir/schedule/ir_schedule_util.h"
+#include "paddle/cinn/ir/utils/ir_copy.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
+#include "paddle/cinn/utils/string.h"
 
 PD_DECLARE_bool(cinn_bucket_compile);
+PD_DECLARE_string(cinn_bucket_dim_divisors);
 
 namespace cinn {
 namespace ir {
 
+namespace {
+
+// The divisors of FLAGS_cinn_bucket_dim_divisors, largest first.
+std::vector<int64_t> BucketDimDivisors() {
+  std::vector<int64_t> divisors;
+  for (const std::string& item :
+       utils::Split(FLAGS_cinn_bucket_dim_divisors, ",")) {
+    std::string divisor = utils::Trim(item);
+    if (divisor.empty()) continue;
+    int64_t value = std::stoll(divisor);
+    CHECK_GT(value, 1) << "Invalid divisor in FLAGS_cinn_bucket_dim_divisors: "
+                       << divisor;
+    divisors.push_back(value);
+  }
+  std::sort(divisors.begin(), divisors.end(), std::greater<int64_t>());
+  divisors.erase(std::unique(divisors.begin(), divisors.end()),
+                 divisors.end());
+  return divisors;
+}
+
+std::vector<ir::Var> SymbolsOf(const ir::Expr& extent) {
+  std::vector<ir::Var> symbols;
+  for (const ir::Expr& var : ir::ir_utils::CollectIRNodesWithoutTensor(
+           extent, [](const ir::Expr* x) { return x->as_var(); })) {
+    symbols.push_back(var.as_var_ref());
+  }
+  const auto& NameLess = [](const ir::Var& a, const ir::Var& b) {
+    return a->name < b->name;
+  };
+  const auto& NameEqual = [](const ir::Var& a, const ir::Var& b) {
+    return a->name == b->name;
+  };
+  std::sort(symbols.begin(), symbols.end(), NameLess);
+  symbols.erase(std::unique(symbols.begin(), symbols.end(), NameEqual),
+                symbols.end());
+  return symbols;
+}
+
+// Rewrites the symbols in the extents of the loops to `symbol / divisor *
+// divisor`, which keeps their values when the symbols are multiples of
+// `divisor`, and lets Split see that the fused extents are aligned.
+class AlignLoopExtentsMutator : public ir::IRMutator<> {
+ public:
+  AlignLoopExtentsMutator(const std::vector<ir::Var>& symbols, int64_t divisor)
+      : symbols_(symbols) {
+    for (const ir::Var& symbol : symbols) {
+      aligned_symbols_.push_back(ir::Mul::Make(
+          ir::Div::Make(symbol, ir::Expr(divisor)), ir::Expr(divisor)));
+    }
+  }
+
+  void operator()(ir::Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::For* op, ir::Expr* expr) override {
+    ir::For* node = expr->As<ir::For>();
+    node->extent = ir::ir_utils::IRCopy(node->extent);
+    ReplaceExpr(&node->extent, symbols_, aligned_symbols_);
+    node->extent = ir::ir_utils::IRCopy(node->extent);
+    ir::IRMutator<>::Visit(&node->body, &node->body);
+  }
+
+  std::vector<ir::Var> symbols_;
+  std::vector<ir::Expr> aligned_symbols_;
+};
+
+}  // namespace
+
 void DynamicShapeGroupScheduler::Init() {
   VLOG(4) << "=============================Start group "
              "schedule==============================";
@@ -96,6 +170,43 @@ void DynamicShapeGroupScheduler::InitBuckets() {
     SymbolicPredicate rb_predicate =
         ir::And::Make(rb_lower_bound_predicate, rb_upper_bound_predicate);
     SymbolicPredicate predicate = ir::And::Make(sp_predicate, rb_predicate);
+    // Kernels specialized for the dynamic spatial dims being multiples of
+    // the divisors, dispatched to in order before the generic kernel.
+    std::vector<ir::Var> symbols = SymbolsOf(iter_space_info.total_sp_extent);
+    for (int64_t divisor : symbols.empty() ? std::vector<int64_t>{}
+                                           : BucketDimDivisors()) {
+      SymbolicPredicate aligned_predicate = predicate;
+      for (const ir::Var& symbol : symbols) {
+        aligned_predicate = ir::And::Make(
+            aligned_predicate,
+            ir::EQ::Make(ir::Mod::Make(symbol, ir::Expr(divisor)),
+                         ir::Expr(0)));
+      }
+      std::unique_ptr<ir::IRSchedule> aligned_ir_sch =
+          std::make_unique<ir::IRSchedule>(*ir_sch_);
+      std::vector<ir::Expr> exprs = aligned_ir_sch->GetModule().GetExprs();
+      for (ir::Expr& expr : exprs) {
+        AlignLoopExtentsMutator(symbols, divisor)(&expr);
+      }
+      aligned_ir_sch->SetExprs(exprs);
+      std::unique_ptr<ir::ScheduleBlockGraph> aligned_schedule_block_graph =
+          std::make_unique<ir::ScheduleBlockGraph>(*aligned_ir_sch);
+      IterativeSpaceInfo aligned_iter_space_info = ConstructIterSpaceInfo(
+          FindGlobalMasterNode(aligned_schedule_block_graph));
+      VLOG(4) << "Add the bucket specialized for " << divisor
+              << " aligned dims: " << aligned_predicate;
+      ScheduleContext aligned_schedule_context{output_names,
+                                               target_,
+                                               aligned_iter_space_info,
+                                               bucket_info,
+                                               config};
+      BucketContext aligned_bucket_context{
+          std::move(aligned_predicate),
+          std::move(aligned_ir_sch),
+          std::move(aligned_schedule_block_graph),
+          std::move(aligned_schedule_context)};
+      bucket_contexts_.emplace_back(std::move(aligned_bucket_context));
+    }
     ScheduleContext schedule_context{output_names,
                                      target_,
                                      std::move(iter_space_info),
@@ -156,6 +267,14 @@ DynamicShapeGroupScheduler::GetIRs() {
   return irs;
 }
 
+std::vector<ir::ScheduleDesc> DynamicShapeGroupScheduler::GetTraces() {
+  std::vector<ir::ScheduleDesc> traces;
+  for (BucketContext& context : bucket_contexts_) {
+    traces.push_back(context.ir_sch->GetTraceDesc());
+  }
+  return traces;
+}
+
 IterativeSpaceInfo DynamicShapeGroupScheduler::ConstructIterSpaceInfo(
     ScheduleBlockNode* node) {
   VLOG(5) << "global master: " << node->id();
@@ -38,6 +38,8 @@ class DynamicShapeGroupScheduler : public GroupScheduler {
 
   std::vector<std::pair<SymbolicPredicate, ir::Expr>> GetIRs() override;
 
+  std::vector<ir::ScheduleDesc> GetTraces() override;
+
   struct BucketContext {
     SymbolicPredicate predicate;
     std::unique_ptr<ir::IRSchedule> ir_sch;
@@ -15,6 +15,7 @@
 #include "paddle/cinn/ir/group_schedule/tactic/tile_first_general_tactic.h"
 #include "paddle/cinn/adt/adt.h"
 #include "paddle/cinn/common/integer_set.h"
+#include "paddle/cinn/common/ir_util.h"
 #include "paddle/cinn/common/target.h"
 #include "paddle/cinn/ir/ir.h"
 #include "paddle/cinn/ir/schedule/ir_schedule_util.h"
@@ -62,6 +63,7 @@ class TileFirstGeneralTactic final : public ScheduleTactic {
                                          const std::string& block_id);
   void SplitWarpNumber(ir::IRSchedule* sch, const std::string& block_id);
   void Unroll(ir::IRSchedule* sch, const std::string& block_id);
+  void VectorizeSpatialInner(ir::IRSchedule* sch, const std::string& block_id);
   void VariableTypeAssignment(ir::IRSchedule* sch, const std::string& block_id);
   void SetReduceType(ir::IRSchedule* sch, const std::string& block_id);
   void BindCudaInfo(ir::IRSchedule* sch, const std::string& block_id);
@@ -71,6 +73,9 @@ class TileFirstGeneralTactic final : public ScheduleTactic {
   std::vector<int32_t> vec_flatten_axis_;
   std::vector<int32_t> vec_reduce_axis_;
   int reduce_current_axis_{0};
+  // Whether the spatial inner loop splits without the bound check, so that
+  // its global loads and stores can be vectorized.
+  bool spatial_inner_aligned_{false};
 };
 
 void TileFirstGeneralTactic::Init(ScheduleContext* context) {
@@ -125,6 +130,7 @@ void TileFirstGeneralTactic::Apply(ir::IRSchedule* sch,
   VLOG(6) << "After BindCudaInfo on block: [" << block_id << "], loop nest:\n"
           << sch->GetLoops(block_id)[0];
   VariableTypeAssignment(sch, block_id);
+  VectorizeSpatialInner(sch, block_id);
   Unroll(sch, block_id);
   VLOG(6) << "After Unroll on block: [" << block_id << "], loop nest:\n"
           << sch->GetLoops(block_id)[0];
@@ -147,8 +153,13 @@ void TileFirstGeneralTactic::MergeReduceAxis(ir::IRSchedule* sch,
 
 void TileFirstGeneralTactic::SplitSptialInner(ir::IRSchedule* sch,
                                               const std::string& block_id) {
+  spatial_inner_aligned_ = false;
   if (IsInnerThreadSpatialLoopGT(context_->config, 1)) {
     auto loops = sch->GetLoops(block_id);
+    spatial_inner_aligned_ =
+        common::KnownConstantFactor(loops[0].As<ir::For>()->extent) %
+            context_->config.tile_config.spatial_inner_num ==
+        0;
     auto split_loops =
         sch->Split(loops[0],
                    std::vector<int>(
@@ -276,7 +287,8 @@ void TileFirstGeneralTactic::Unroll(ir::IRSchedule* sch,
   const auto DoUnroll = [&](const std::vector<ir::Expr>& loops) {
     for (size_t loop_idx : unroll_loops_idx) {
       if (loops.size() > loop_idx &&
-          loops[loop_idx].As<ir::For>()->extent.is_constant()) {
+          loops[loop_idx].As<ir::For>()->extent.is_constant() &&
+          !loops[loop_idx].As<ir::For>()->is_vectorized()) {
         sch->Unroll(loops[loop_idx]);
       }
     }
@@ -289,6 +301,24 @@ void TileFirstGeneralTactic::Unroll(ir::IRSchedule* sch,
   }
 }
 
+void TileFirstGeneralTactic::VectorizeSpatialInner(
+    ir::IRSchedule* sch, const std::string& block_id) {
+  // Only elementwise and broadcast blocks, whose spatial inner loop is the
+  // innermost one, are vectorized. VectorizeLoops keeps the accesses that
+  // can't be proved aligned scalar.
+  const int64_t factor = context_->config.tile_config.spatial_inner_num;
+  if (!spatial_inner_aligned_ || HasReduceAxis(context_->config) ||
+      (factor != 2 && factor != 4 && factor != 8)) {
+    return;
+  }
+  auto loops = sch->GetLoops(block_id);
+  const ir::Expr& extent = loops.back().As<ir::For>()->extent;
+  if (!extent.is_constant() || extent.get_constant() != factor) {
+    return;
+  }
+  sch->Vectorize(loops.back(), factor);
+}
+
 void TileFirstGeneralTactic::VariableTypeAssignment(
     ir::IRSchedule* sch, const std::string& block_id) {
   const auto IsOutputTensor = [&](const std::string& tensor_name) {
@@ -16,7 +16,9 @@
 
 #include "paddle/cinn/common/cas.h"
 #include "paddle/cinn/common/integer_set.h"
+#include "paddle/cinn/common/ir_util.h"
 #include "paddle/cinn/common/macros.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
 
 /** \brief A macro that guards the beginning of each implementation of schedule
  */
@@ -38,6 +40,30 @@
 namespace cinn {
 namespace ir {
 
+namespace {
+
+// Whether `extent` has a symbol aligned as `s / d * d`, which the kernels
+// specialized for aligned dims put in their loop extents.
+bool HasAlignedSymbol(const Expr& extent) {
+  return !ir::ir_utils::CollectIRNodesWithoutTensor(
+              extent,
+              [](const Expr* x) {
+                const ir::Mul* mul = x->As<ir::Mul>();
+                if (!mul || !mul->a().As<ir::Div>() ||
+                    !mul->b().As<ir::IntImm>()) {
+                  return false;
+                }
+                const ir::Div* div = mul->a().As<ir::Div>();
+                return div->a().as_var() && div->b().As<ir::IntImm>() &&
+                       div->b().As<ir::IntImm>()->value ==
+                           mul->b().As<ir::IntImm>()->value;
+              },
+              /* uniq_target = */ true)
+              .empty();
+}
+
+}  // namespace
+
 std::vector<Expr> DyScheduleImpl::Split(const Expr& loop,
                                         const std::vector<int>& factors) {
   CINN_IR_SCHEDULE_BEGIN();
@@ -118,10 +144,23 @@ std::vector<Expr> DyScheduleImpl::Split(const Expr& loop,
   std::vector<Expr> process_factors;
   Expr prod_size(-1);
   for (auto factor : factors) prod_size = prod_size * Expr(factor);
+  // In the kernels specialized for aligned dims, the extent is known to be a
+  // multiple of the other factors, so the loop splits exactly and needs no
+  // bound check. Other kernels keep the generic split.
+  int64_t known_prod = 1;
+  for (auto factor : factors) {
+    if (factor != -1) known_prod *= factor;
+  }
+  const bool is_exact =
+      std::count(factors.begin(), factors.end(), -1) == 1 && known_prod > 0 &&
+      HasAlignedSymbol(tot_extent) &&
+      cinn::common::KnownConstantFactor(tot_extent) % known_prod == 0;
   std::for_each(factors.begin(), factors.end(), [&](int factor) {
     if (factor == -1) {
       process_factors.push_back(
-          cinn::common::AutoSimplify(tot_extent / prod_size + Expr(1)));
+          is_exact
+              ? cinn::common::AutoSimplify(tot_extent / prod_size)
+              : cinn::common::AutoSimplify(tot_extent / prod_size + Expr(1)));
     } else {
       process_factors.push_back(Expr(factor));
     }
@@ -148,7 +187,10 @@ std::vector<Expr> DyScheduleImpl::Split(const Expr& loop,
   std::vector<Expr> splited_loops;
   splited_loops.resize(process_factors.size());
 
-  new_node = IfThenElse::Make(LT::Make(substitute_value, tot_extent), new_node);
+  if (!is_exact) {
+    new_node =
+        IfThenElse::Make(LT::Make(substitute_value, tot_extent), new_node);
+  }
 
   for (int i = process_factors.size() - 1; i >= 0; i--) {
     if (!new_node.As<ir::Block>()) new_node = Block::Make({new_node});
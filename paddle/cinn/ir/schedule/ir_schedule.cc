@@ -383,7 +383,9 @@ Expr IRSchedule::GetBlock(const std::string& block_name) const {
 
 std::vector<Expr> IRSchedule::Split(const Expr& loop,
                                     const std::vector<int>& factors) {
-  if (IsDynamicShape()) return impl_->Split(loop, factors);
+  if (IsDynamicShape()) {
+    return Split(loop, std::vector<Expr>(factors.begin(), factors.end()));
+  }
   std::vector<Expr> decision = SamplePerfectTile(
       loop, factors.size(), loop.As<ir::For>()->extent.as_int64(), factors);
   auto results = Split(loop, decision);
@@ -0,0 +1,80 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "paddle/cinn/ir/ir.h"
+#include "paddle/cinn/ir/schedule/ir_schedule.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
+#include "paddle/cinn/lang/placeholder.h"
+
+namespace cinn {
+namespace ir {
+
+// Splits the loop `for (i, 0, extent) A[i] = 1` of a dynamic shape schedule
+// by {-1, 64} and returns the scheduled function body.
+Expr SplitByConstantFactor(const Expr& extent) {
+  Var i("i");
+  lang::Placeholder<float> A("A", std::vector<Expr>{extent});
+  Expr body = Block::Make({Store::Make(A.tensor(), Expr(1.f), {Expr(i)})});
+  Expr loop = For::Make(i,
+                        Expr(0),
+                        extent,
+                        ForType::Serial,
+                        DeviceAPI::UNK,
+                        body);
+  IRSchedule ir_sch(ModuleExpr({Block::Make({loop})}),
+                    /*rand_seed=*/-1,
+                    /*debug_flag=*/false,
+                    utils::ErrorMessageLevel::kGeneral,
+                    /*is_dynamic_shape=*/true);
+  Expr target_loop = ir_sch.GetModule().GetExprs()[0].As<Block>()->stmts[0];
+  std::vector<Expr> loops = ir_sch.Split(target_loop, {-1, 64});
+  EXPECT_EQ(loops.size(), 2);
+  return ir_sch.GetModule().GetExprs()[0];
+}
+
+bool HasBoundCheck(const Expr& expr) {
+  return !ir_utils::CollectIRNodesWithoutTensor(
+              expr, [](const Expr* x) { return x->As<IfThenElse>(); })
+              .empty();
+}
+
+TEST(DyScheduleSplit, generic_extent) {
+  // A constant factor of the extent doesn't make the generic split exact.
+  Var s0("S0", Int(64));
+  Expr func_body = SplitByConstantFactor(Mul::Make(s0, Expr(int64_t(128))));
+  EXPECT_TRUE(HasBoundCheck(func_body));
+}
+
+TEST(DyScheduleSplit, aligned_extent) {
+  // The extent of the kernels specialized for S0 % 64 == 0.
+  Var s0("S0", Int(64));
+  Expr aligned_s0 = Mul::Make(Div::Make(s0, Expr(int64_t(64))),
+                              Expr(int64_t(64)));
+  Expr func_body = SplitByConstantFactor(aligned_s0);
+  EXPECT_FALSE(HasBoundCheck(func_body));
+}
+
+TEST(DyScheduleSplit, unaligned_factor) {
+  // S0 / 32 * 32 is not a multiple of 64.
+  Var s0("S0", Int(64));
+  Expr aligned_s0 = Mul::Make(Div::Make(s0, Expr(int64_t(32))),
+                              Expr(int64_t(32)));
+  Expr func_body = SplitByConstantFactor(aligned_s0);
+  EXPECT_TRUE(HasBoundCheck(func_body));
+}
+
+}  // namespace ir
+}  // namespace cinn
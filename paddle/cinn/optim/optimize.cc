@@ -28,6 +28,7 @@
 #include "paddle/cinn/optim/lower_function_call_bind_vars.h"
 #include "paddle/cinn/optim/lower_intrin.h"
 #include "paddle/cinn/optim/map_extern_call.h"
+#include "paddle/cinn/optim/parallelize_loops.h"
 #include "paddle/cinn/optim/remove_schedule_block.h"
 #include "paddle/cinn/optim/replace_const_param_to_integer.h"
 #include "paddle/cinn/optim/replace_cross_thread_reduction.h"
@@ -99,6 +100,8 @@ ir::Module Optimize(const ir::Module& module, const Target& target) {
   VLOG(10) << "After VectorizeLoops:" << copied.as_module_ref();
   RemoveScheduleBlock(&copied);
   VLOG(10) << "After RemoveScheduleBlock:" << copied.as_module_ref();
+  ParallelizeLoops(&copied, target);
+  VLOG(10) << "After ParallelizeLoops:" << copied.as_module_ref();
   LowerFunctionCallBindVars(&copied);
   VLOG(10) << "After LowerFunctionCallBindVars:" << copied.as_module_ref();
   CallArgListToPodValue(&copied);
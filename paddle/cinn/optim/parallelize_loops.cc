@@ -0,0 +1,248 @@
+// Copyright (c) 2024 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/optim/parallelize_loops.h"
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "paddle/cinn/ir/ir_mutator.h"
+#include "paddle/cinn/ir/ir_printer.h"
+#include "paddle/cinn/ir/utils/ir_compare.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
+#include "paddle/common/flags.h"
+
+PD_DECLARE_bool(cinn_cpu_auto_parallel);
+PD_DECLARE_int64(cinn_cpu_parallel_min_work);
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+// Count the iterations of the Stores in a loop nest, a loop of dynamic extent
+// makes the work unknown.
+struct WorkEstimator : public ir::IRMutator<const Expr*> {
+  void operator()(const Expr* expr) {
+    ir::IRMutator<const Expr*>::Visit(expr, expr);
+  }
+
+  int64_t work{0};
+  bool dynamic{false};
+
+ private:
+  void Visit(const ir::For* op, const Expr* expr) override {
+    if (!op->extent.is_constant()) {
+      dynamic = true;
+      return;
+    }
+    int64_t multiplier = multiplier_;
+    multiplier_ *= static_cast<int64_t>(op->extent.get_constant());
+    ir::IRMutator<const Expr*>::Visit(op, expr);
+    multiplier_ = multiplier;
+  }
+
+  void Visit(const ir::Store* op, const Expr* expr) override {
+    work += multiplier_;
+  }
+
+  int64_t multiplier_{1};
+};
+
+// Adds scale * index to the affine form of sum of coeffs[var] * var plus
+// constant. Returns false if index is not affine in its vars, e.g. with a div
+// or a mod.
+bool AddAffineForm(const Expr& index,
+                   int64_t scale,
+                   std::map<std::string, int64_t>* coeffs,
+                   int64_t* constant) {
+  if (const ir::IntImm* imm = index.As<ir::IntImm>()) {
+    *constant += scale * imm->value;
+    return true;
+  }
+  if (const ir::_Var_* var = index.As<ir::_Var_>()) {
+    (*coeffs)[var->name] += scale;
+    return true;
+  }
+  if (const ir::Cast* cast = index.As<ir::Cast>()) {
+    return cast->type().is_int() && cast->v().type().is_int() &&
+           AddAffineForm(cast->v(), scale, coeffs, constant);
+  }
+  if (const ir::Add* add = index.As<ir::Add>()) {
+    return AddAffineForm(add->a(), scale, coeffs, constant) &&
+           AddAffineForm(add->b(), scale, coeffs, constant);
+  }
+  if (const ir::Sub* sub = index.As<ir::Sub>()) {
+    return AddAffineForm(sub->a(), scale, coeffs, constant) &&
+           AddAffineForm(sub->b(), -scale, coeffs, constant);
+  }
+  if (const ir::Mul* mul = index.As<ir::Mul>()) {
+    if (const ir::IntImm* imm = mul->b().As<ir::IntImm>()) {
+      return AddAffineForm(mul->a(), scale * imm->value, coeffs, constant);
+    }
+    if (const ir::IntImm* imm = mul->a().As<ir::IntImm>()) {
+      return AddAffineForm(mul->b(), scale * imm->value, coeffs, constant);
+    }
+  }
+  return false;
+}
+
+// Whether index takes a different value in every iteration of the loop over
+// loop_var: it is affine, the coefficient c of loop_var is non-zero, and the
+// vars of the inner loops move it by less than |c| within an iteration. The
+// vars defined outside the loop are invariant. inner_extents holds the
+// extents of the vars defined in the loop, -1 for the unknown ones.
+bool IsInjectiveIndex(const Expr& index,
+                      const std::string& loop_var,
+                      const std::map<std::string, int64_t>& inner_extents) {
+  std::map<std::string, int64_t> coeffs;
+  int64_t constant = 0;
+  if (!AddAffineForm(index, 1, &coeffs, &constant)) return false;
+  auto it = coeffs.find(loop_var);
+  if (it == coeffs.end() || it->second == 0) return false;
+  int64_t stride = std::abs(it->second);
+  int64_t span = 0;
+  for (const auto& [var, coeff] : coeffs) {
+    if (var == loop_var || coeff == 0) continue;
+    auto extent = inner_extents.find(var);
+    if (extent == inner_extents.end()) continue;
+    if (extent->second < 0) return false;
+    span += std::abs(coeff) * (extent->second - 1);
+  }
+  return span < stride;
+}
+
+// Whether the iterations of the loop are independent: each Store indexes its
+// tensor with an index injective in the loop var, see IsInjectiveIndex, and
+// the tensors stored in the loop are only loaded at the indices they are
+// stored at, so no iteration reads or writes what another one writes.
+bool HasIndependentIterations(const ir::For* op) {
+  const std::string& loop_var = op->loop_var->name;
+  std::map<std::string, int64_t> inner_extents;
+  ir::ir_utils::CollectIRNodesWithoutTensor(op->body, [&](const Expr* x) {
+    if (const ir::For* loop = x->As<ir::For>()) {
+      bool known = loop->min.is_constant() && loop->extent.is_constant() &&
+                   loop->min.get_constant() == 0;
+      inner_extents[loop->loop_var->name] =
+          known ? static_cast<int64_t>(loop->extent.get_constant()) : -1;
+    } else if (const ir::Let* let = x->As<ir::Let>()) {
+      if (let->symbol.As<ir::_Var_>()) {
+        inner_extents[let->symbol.As<ir::_Var_>()->name] = -1;
+      }
+    }
+    return false;
+  });
+
+  std::map<std::string, std::vector<const ir::Store*>> stores;
+  bool independent = true;
+  ir::ir_utils::CollectIRNodesWithoutTensor(op->body, [&](const Expr* x) {
+    const ir::Store* store = x->As<ir::Store>();
+    if (store == nullptr) return false;
+    bool injective = false;
+    for (const Expr& index : store->indices) {
+      injective =
+          injective || IsInjectiveIndex(index, loop_var, inner_extents);
+    }
+    independent = independent && injective;
+    stores[store->name()].push_back(store);
+    return false;
+  });
+  if (!independent) return false;
+
+  ir::ir_utils::CollectIRNodesWithoutTensor(op->body, [&](const Expr* x) {
+    const ir::Load* load = x->As<ir::Load>();
+    if (load == nullptr || !independent) return false;
+    auto it = stores.find(load->name());
+    if (it == stores.end()) return false;
+    bool same_index = false;
+    for (const ir::Store* store : it->second) {
+      if (store->indices.size() != load->indices.size()) continue;
+      bool equal = true;
+      for (size_t i = 0; i < load->indices.size(); ++i) {
+        equal = equal &&
+                ir::ir_utils::IRCompare(load->indices[i], store->indices[i]);
+      }
+      same_index = same_index || equal;
+    }
+    independent = same_index;
+    return false;
+  });
+  return independent;
+}
+
+bool CanParallelize(const ir::For* op) {
+  if (!op->is_serial() || !op->min.is_constant() ||
+      op->min.get_constant() != 0) {
+    return false;
+  }
+  if (op->extent.is_constant() && op->extent.get_constant() < 2) {
+    return false;
+  }
+  // the extern calls without return value write their arguments, e.g. the
+  // gemm of MKL, which the Store check does not see
+  auto side_effect_calls =
+      ir::ir_utils::CollectIRNodesWithoutTensor(op->body, [](const Expr* x) {
+        const ir::Call* call = x->As<ir::Call>();
+        return call != nullptr && call->type().is_void();
+      });
+  if (!side_effect_calls.empty()) return false;
+  if (!HasIndependentIterations(op)) return false;
+
+  // the dynamic loops are split anyway, the shape is unknown until runtime
+  if (!op->extent.is_constant()) return true;
+  WorkEstimator estimator;
+  estimator(&op->body);
+  return estimator.dynamic ||
+         estimator.work * static_cast<int64_t>(op->extent.get_constant()) >=
+             FLAGS_cinn_cpu_parallel_min_work;
+}
+
+struct ParallelizeLoopsMutator : public ir::IRMutator<Expr*> {
+  void operator()(Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+ private:
+  void Visit(const ir::_LoweredFunc_* op, Expr* expr) override {
+    // keep the parallel loops scheduled explicitly
+    auto parallel_loops =
+        ir::ir_utils::CollectIRNodesWithoutTensor(op->body, [](const Expr* x) {
+          return x->As<ir::For>() && x->As<ir::For>()->is_parallel();
+        });
+    if (!parallel_loops.empty()) return;
+    ir::IRMutator<>::Visit(op, expr);
+  }
+
+  void Visit(const ir::For* op, Expr* expr) override {
+    if (CanParallelize(op)) {
+      VLOG(4) << "Parallelize the loop over " << op->loop_var->name;
+      expr->As<ir::For>()->set_parallel();
+      // CodeGenX86 does not support nested parallel loops
+      return;
+    }
+    ir::IRMutator<>::Visit(op, expr);
+  }
+};
+
+}  // namespace
+
+void ParallelizeLoops(Expr* expr, const Target& target) {
+  if (target.arch != Target::Arch::X86 || !FLAGS_cinn_cpu_auto_parallel) {
+    return;
+  }
+  ParallelizeLoopsMutator()(expr);
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,39 @@
+// Copyright (c) 2024 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Mark the outermost serial forloops of the X86 functions as parallel, so
+ * CodeGenX86 splits them across the threads of the parallel launch.
+ *
+ * A forloop is marked only if its min is 0, it holds no parallel loop, each
+ * Store in its body has an index which is affine in the loop var, without
+ * div or mod, and which the inner loops do not move across the iterations
+ * (so the iterations write disjoint elements), it calls no function without
+ * return value, and it runs at least FLAGS_cinn_cpu_parallel_min_work
+ * iterations of its stores. It runs after RemoveScheduleBlock, when the
+ * Store indices are expressed by the loop vars. The functions which already
+ * have a parallel loop are left untouched, and so are other targets.
+ */
+void ParallelizeLoops(Expr* expr, const Target& target);
+
+}  // namespace optim
+}  // namespace cinn
@@ -0,0 +1,134 @@
+// Copyright (c) 2024 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/optim/parallelize_loops.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "paddle/cinn/cinn.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
+#include "paddle/cinn/lang/lower.h"
+#include "paddle/cinn/optim/remove_schedule_block.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+// Lower C = A * B of shape [M, N] and return the loops of C from the outer
+// to the inner one after ParallelizeLoops.
+std::vector<ir::For*> LowerAndParallelize(int M, int N) {
+  Placeholder<float> A("A", {Expr(M), Expr(N)});
+  Placeholder<float> B("B", {Expr(M), Expr(N)});
+  Tensor C = Compute(
+      {Expr(M), Expr(N)},
+      [&](Var i, Var j) { return A(i, j) * B(i, j); },
+      "C");
+  auto stages = CreateStages({C});
+
+  Target target = cinn::common::DefaultHostTarget();
+  auto funcs = cinn::lang::LowerVec(
+      "test_parallelize", stages, {A, B, C}, {}, {}, nullptr, target, true);
+  Expr body = funcs[0]->body;
+  RemoveScheduleBlock(&body);
+  ParallelizeLoops(&body, target);
+
+  std::vector<ir::For*> loops;
+  auto nodes = ir::ir_utils::CollectIRNodesInOrder(
+      body, [](const Expr* x) { return x->As<ir::For>() != nullptr; });
+  for (auto& node : nodes) {
+    loops.push_back(node.As<ir::For>());
+  }
+  return loops;
+}
+
+// The extent of the outer loop of ParallelizeStoreLoop, which is enough
+// work to parallelize even with an inner loop of 1 iteration.
+constexpr int kOuterExtent = 65536;
+
+// for (i, 0, kOuterExtent) { for (j, 0, inner_extent) { Out[index(i, j)] =
+// Out[index(i, j)] + X[i, j] } }, return whether the outer loop is parallel.
+bool ParallelizeStoreLoop(const std::function<Expr(Var, Var)>& index,
+                          int inner_extent,
+                          int out_size) {
+  Placeholder<float> X("X", std::vector<int>{kOuterExtent, inner_extent});
+  Placeholder<float> Out("Out", std::vector<int>{out_size});
+  Var i("i");
+  Var j("j");
+  Expr store = ir::Store::Make(
+      ir::Tensor(Out),
+      ir::Add::Make(ir::Load::Make(ir::Tensor(Out), {index(i, j)}),
+                    ir::Load::Make(ir::Tensor(X), {Expr(i), Expr(j)})),
+      {index(i, j)});
+  Expr inner = ir::For::Make(j,
+                             cinn::common::make_const(0),
+                             cinn::common::make_const(inner_extent),
+                             ir::ForType::Serial,
+                             ir::DeviceAPI::Host,
+                             ir::Block::Make({store}));
+  Expr outer = ir::For::Make(i,
+                             cinn::common::make_const(0),
+                             cinn::common::make_const(kOuterExtent),
+                             ir::ForType::Serial,
+                             ir::DeviceAPI::Host,
+                             ir::Block::Make({inner}));
+  ParallelizeLoops(&outer, cinn::common::DefaultHostTarget());
+  return outer.As<ir::For>()->is_parallel();
+}
+
+}  // namespace
+
+TEST(ParallelizeLoops, outer_loop) {
+  auto loops = LowerAndParallelize(512, 128);
+  ASSERT_EQ(loops.size(), 2U);
+  EXPECT_TRUE(loops[0]->is_parallel());
+  EXPECT_FALSE(loops[1]->is_parallel());
+}
+
+TEST(ParallelizeLoops, small_loop) {
+  auto loops = LowerAndParallelize(16, 4);
+  ASSERT_EQ(loops.size(), 2U);
+  EXPECT_FALSE(loops[0]->is_parallel());
+  EXPECT_FALSE(loops[1]->is_parallel());
+}
+
+TEST(ParallelizeLoops, disjoint_stores) {
+  // Out[i * 8 + j], the inner loop stays within the 8 elements of i
+  EXPECT_TRUE(ParallelizeStoreLoop(
+      [](Var i, Var j) { return Expr(i) * 8 + Expr(j); }, 8, kOuterExtent * 8));
+}
+
+TEST(ParallelizeLoops, racing_stores) {
+  // Out[i / 4], 4 iterations add into the same element
+  EXPECT_FALSE(ParallelizeStoreLoop(
+      [](Var i, Var j) { return Expr(i) / 4; }, 1, kOuterExtent / 4));
+  // Out[i % 16]
+  EXPECT_FALSE(ParallelizeStoreLoop(
+      [](Var i, Var j) { return Expr(i) % 16; }, 1, 16));
+  // Out[i * 4 + j], the inner loop reaches into the elements of i + 1
+  EXPECT_FALSE(ParallelizeStoreLoop(
+      [](Var i, Var j) { return Expr(i) * 4 + Expr(j); },
+      8,
+      kOuterExtent * 4 + 4));
+  // Out[j], every iteration of i writes the same elements
+  EXPECT_FALSE(ParallelizeStoreLoop(
+      [](Var i, Var j) { return Expr(j); }, 8, 8));
+}
+
+}  // namespace optim
+}  // namespace cinn
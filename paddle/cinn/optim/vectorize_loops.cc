@@ -121,10 +121,18 @@ class TensorVectorizeTeller : public ir::IRMutator<const Expr *> {
       return x->As<_Var_>() && x->As<_Var_>()->name == iter_var_->name;
     };
 
-    // the size of the last dim should be divisible by factor
-    Expr last_size = tensor->shape.back();
-    if (tensor->shape.empty() || !tensor->shape.back().As<IntImm>() ||
-        tensor->shape.back().as_int32() % factor_ != 0) {
+    // only the accesses to global memory are vectorized, the local and shared
+    // buffers may be shrunk to fewer elements than the vector type
+    if (tensor->buffer.defined() && tensor->buffer->is_on_gpu()) {
+      VLOG(5) << "Tensor:" << tensor->name << " is not in global memory";
+      return false;
+    }
+
+    // the size of the last dim should be divisible by factor, which may be
+    // a dynamic dim known to be a multiple of it
+    if (tensor->shape.empty() ||
+        cinn::common::KnownConstantFactor(tensor->shape.back()) % factor_ !=
+            0) {
       VLOG(5) << "Size of the last dim of tensor:" << tensor->name
               << " can't be divisible by factor:" << factor_
               << ", shape:" << utils::Join(tensor->shape, ",");
@@ -155,6 +163,17 @@ class TensorVectorizeTeller : public ir::IRMutator<const Expr *> {
     Expr first_idx = ir::ir_utils::IRCopy(indices.back());
     cinn::ir::ir_utils::IrReplaceVarBroadcast(
         &first_idx, Expr(iter_var_), Expr(0));
+    // the first element should be aligned to the vector type, otherwise the
+    // vectorized access is misaligned
+    if (cinn::common::KnownConstantFactor(
+            cinn::common::AutoSimplify(first_idx)) %
+            factor_ !=
+        0) {
+      VLOG(5) << "Tensor:" << tensor->name
+              << " can't be proved aligned to factor:" << factor_
+              << ", first:" << first_idx;
+      return false;
+    }
     const auto &interval = var_intervals_->at(iter_var_->name);
     for (int i = 1; i < interval.r; ++i) {
       Expr next_idx = ir::ir_utils::IRCopy(indices.back());
@@ -285,5 +285,24 @@ TEST(Vectorize, cuda_vectorize_with_constant) {
   auto func = Lower("mul_const", stages, {A, C}, {}, {}, nullptr, target);
 }
 
+TEST(Vectorize, cuda_vectorize_unaligned) {
+  Expr M(100);
+  Expr N(500);
+  Placeholder<float> A("A", {M, Expr(504)});
+
+  Tensor C = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j + 1); }, "C");
+
+  auto stages = CreateStages({C});
+  stages[C]->Vectorize(1, 4);
+  Target target = cinn::common::DefaultNVGPUTarget();
+  auto func = Lower("shift", stages, {A, C}, {}, {}, nullptr, target);
+
+  // A is read from an offset not aligned to float4, so only C is vectorized
+  std::string code = GetStreamCnt(func);
+  EXPECT_NE(code.find("vectorized_C"), std::string::npos);
+  EXPECT_EQ(code.find("vectorized_A"), std::string::npos);
+}
+
 }  // namespace optim
 }  // namespace cinn
@@ -19,13 +19,114 @@
 
 #ifdef CINN_USE_OPENMP
 #include <omp.h>
+#else
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #endif  // CINN_USE_OPENMP
 
 #include "paddle/cinn/backends/extern_func_jit_register.h"
 #include "paddle/cinn/backends/llvm/runtime_symbol_registry.h"
 #include "paddle/cinn/common/cas.h"
 #include "paddle/cinn/runtime/intrinsic.h"
-#include "paddle/common/enforce.h"
+
+#ifndef CINN_USE_OPENMP
+namespace {
+
+/**
+ * The thread pool running the parallel lambdas of the builds without OpenMP.
+ *
+ * The workers are created on demand and kept for the next launches. The
+ * caller runs tasks too, each task id is claimed once by whoever is free, and
+ * Launch returns when all the tasks of the job are done. Launches from
+ * different threads are serialized.
+ */
+class ParallelLauncher {
+ public:
+  static ParallelLauncher& Global() {
+    static ParallelLauncher launcher;
+    return launcher;
+  }
+
+  void Launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+    auto job = std::make_shared<Job>(flambda, datas, num_task);
+    std::lock_guard<std::mutex> launch_guard(launch_mutex_);
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      while (static_cast<int>(workers_.size()) < num_task - 1) {
+        workers_.emplace_back([this] { WorkerLoop(); });
+      }
+      job_ = job;
+    }
+    cv_.notify_all();
+    RunTasks(job.get());
+    std::unique_lock<std::mutex> done_lock(job->mutex);
+    job->done_cv.wait(done_lock, [&] { return job->num_done == num_task; });
+  }
+
+  ~ParallelLauncher() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+ private:
+  struct Job {
+    Job(FCINNParallelLambda flambda, void* datas, int num_task)
+        : flambda(flambda), datas(datas), num_task(num_task) {}
+
+    FCINNParallelLambda flambda;
+    void* datas;
+    int num_task;
+    std::atomic<int> next_task{0};
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    int num_done{0};
+  };
+
+  static void RunTasks(Job* job) {
+    for (int task_id = job->next_task++; task_id < job->num_task;
+         task_id = job->next_task++) {
+      (*job->flambda)(task_id, job->num_task, job->datas);
+      std::lock_guard<std::mutex> guard(job->mutex);
+      if (++job->num_done == job->num_task) {
+        job->done_cv.notify_all();
+      }
+    }
+  }
+
+  void WorkerLoop() {
+    std::shared_ptr<Job> last_job;
+    while (true) {
+      std::shared_ptr<Job> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return stop_ || job_ != last_job; });
+        if (stop_) return;
+        job = job_;
+      }
+      // a finished job has no task left to claim
+      RunTasks(job.get());
+      last_job = std::move(job);
+    }
+  }
+
+  std::mutex launch_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::shared_ptr<Job> job_;
+  std::vector<std::thread> workers_;
+  bool stop_{false};
+};
+
+}  // namespace
+#endif  // CINN_USE_OPENMP
 
 int max_concurrency() {
   int max_concurrency = 1;
@@ -57,8 +158,11 @@ int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
     (*flambda)(thread_num, num_task, datas);
   }
 #else
-  PADDLE_THROW(phi::errors::Fatal(
-      "CINN host parallel launch need OpenMP! Please check."));
+  if (num_task == 1) {
+    (*flambda)(0, 1, datas);
+  } else {
+    ParallelLauncher::Global().Launch(flambda, datas, num_task);
+  }
 #endif  // CINN_USE_OPENMP
   return 0;
 }
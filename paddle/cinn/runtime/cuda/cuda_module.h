@@ -56,6 +56,11 @@ class CUDAModule {
   //! Get a global variable.
   CUdeviceptr GetGlobal(int device_id, const std::string& name, size_t nbytes);
 
+  //! The PTX or CUBIN the module is loaded from.
+  const std::string& data() const { return data_; }
+
+  Kind kind() const { return kind_; }
+
   ~CUDAModule();
 
  private:
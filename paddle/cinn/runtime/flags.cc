@@ -54,6 +54,31 @@ PD_DEFINE_int32(cinn_parallel_compile_thread,
                              (std::thread::hardware_concurrency() >> 1)),
                 "How much thread the parallel compile used.");
 
+PD_DEFINE_int32(cinn_parallel_codegen_thread,
+                Int32FromEnv("FLAGS_cinn_parallel_codegen_thread", 0),
+                "How much thread the codegen and jit of the PIR compiler "
+                "used, which run while other groups are being lowered. 0 "
+                "means the same as FLAGS_cinn_parallel_compile_thread.");
+
+PD_DEFINE_bool(cinn_async_compile,
+               BoolFromEnv("FLAGS_cinn_async_compile", false),
+               "Whether the PIR compiler returns after lowering the groups, "
+               "while their codegen and jit run in the background. Under "
+               "to_static, the program runs without CINN until all its "
+               "kernels are ready. Elsewhere a CINN kernel waits for its own "
+               "compilation when it first runs.");
+
+PD_DEFINE_bool(cinn_cpu_auto_parallel,
+               BoolFromEnv("FLAGS_cinn_cpu_auto_parallel", true),
+               "Whether to split the outermost independent loops of the X86 "
+               "kernels across the threads of cinn_backend_parallel_launch.");
+
+PD_DEFINE_int64(cinn_cpu_parallel_min_work,
+                Int64FromEnv("FLAGS_cinn_cpu_parallel_min_work", 32768),
+                "The iterations a X86 loop nest needs at least to be "
+                "parallelized, the smaller loops are not worth waking "
+                "the threads.");
+
 PD_DEFINE_bool(cinn_use_op_fusion,
                BoolFromEnv("FLAGS_cinn_use_op_fusion", true),
                "Whether to use op fusion pass.");
@@ -70,6 +95,15 @@ PD_DEFINE_bool(cinn_bucket_compile,
                BoolFromEnv("FLAGS_cinn_bucket_compile", false),
                "Whether to enable bucket compile for dynamic shape.");
 
+PD_DEFINE_string(
+    cinn_bucket_dim_divisors,
+    StringFromEnv("FLAGS_cinn_bucket_dim_divisors", ""),
+    "Comma separated divisors, such as \"64,8\". With bucket compile, every "
+    "bucket of a group with dynamic spatial dims gets one more kernel per "
+    "divisor, specialized for the dims being multiples of it, which the host "
+    "function dispatches to before the generic kernel. Empty means no "
+    "specialization.");
+
 PD_DEFINE_bool(group_schedule_tiling_first,
                BoolFromEnv("FLAGS_group_schedule_tiling_first", false),
                "Whether to enable new group scheduler tiling first strategy.");
@@ -208,6 +242,25 @@ PD_DEFINE_string(
     StringFromEnv("FLAGS_cinn_dump_group_instruction", ""),
     "Specify the path for dump instruction by group, which is used for debug.");
 
+PD_DEFINE_string(
+    cinn_compilation_cache_dir,
+    StringFromEnv("FLAGS_cinn_compilation_cache_dir", ""),
+    "Specify the directory where the kernels compiled by CINN are cached "
+    "across processes. Empty means the kernels are only cached in memory.");
+
+PD_DEFINE_string(
+    cinn_tuning_record_file,
+    StringFromEnv("FLAGS_cinn_tuning_record_file", ""),
+    "Specify the JSON file of the schedules tuned offline for the PIR "
+    "groups with static shapes, which replace the group scheduler when "
+    "lowering the groups. Empty means no tuned schedule is used.");
+
+PD_DEFINE_bool(cinn_tuning_record_schedules,
+               BoolFromEnv("FLAGS_cinn_tuning_record_schedules", false),
+               "Whether to record the schedules given by the group scheduler "
+               "to FLAGS_cinn_tuning_record_file for the groups with static "
+               "shapes and no tuned schedule, as the baselines of tuning.");
+
 PD_DEFINE_string(cinn_pass_visualize_dir,
                  StringFromEnv("FLAGS_cinn_pass_visualize_dir", ""),
                  "Specify the directory path of pass visualize file of graph, "
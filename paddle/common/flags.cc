@@ -102,6 +102,27 @@ PHI_DEFINE_EXPORTED_int32(
     0,
     "Setting the check and print level when FLAGS_check_nan_inf is set.");
 
+/**
+ * Operator related FLAG
+ * Name: FLAGS_check_nan_inf_deferred
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Used to debug. When FLAGS_check_nan_inf is set, the checks of the
+ * GPU tensors only accumulate the nan/inf counts of each op output on the
+ * device without any synchronization, and the host checks them once at the
+ * end of each run of an executor, at the end of each dygraph backward, and
+ * in paddle.amp.debugging.disable_tensor_checker. The dygraph ops run
+ * without backward are checked by the latter. The op and the variable
+ * holding NAN/INF are recovered from the accumulated slots. Level 0 aborts
+ * at the check instead of at the failing op.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    check_nan_inf_deferred,
+    false,
+    "Whether to accumulate the nan/inf checks of GPU tensors on the device "
+    "and check them once per run when FLAGS_check_nan_inf is set.");
+
 /**
  * Operator related FLAG
  * Name: FLAGS_check_nan_inf
@@ -239,7 +260,8 @@ PHI_DEFINE_EXPORTED_bool(
  * Note: whether to use deterministic algorithm in embedding op.
  *       If it is 1, it will use the optimized deterministic CUDA kernel in
  *       embedding op. If it is 2, it will use the legacy deterministic
- *       CUDA kernel in embedding op.
+ *       CUDA kernel in embedding op. If it is not 0, the sparse gradient
+ *       has one row per unique id, summed in a fixed order after sorting.
  */
 PHI_DEFINE_EXPORTED_int64(
     embedding_deterministic,
@@ -248,6 +270,24 @@ PHI_DEFINE_EXPORTED_int64(
     "operator. The deterministic algorithm may be slower. If "
     "it is larger than 0, the algorithm is deterministic.");
 
+/**
+ * CUDA related FLAG
+ * Name: FLAGS_deterministic_scatter_min_keys_per_row
+ * Since Version: 2.6.0
+ * Value Range: int64, default=32
+ * Example:
+ * Note: scatter, scatter_nd_add, index_add and index_put reduce the values
+ *       of duplicate indices by sorting the indices instead of atomics when
+ *       the indices outnumber the destination rows by this ratio, where the
+ *       atomics contend heavily. They always do so if
+ *       FLAGS_cudnn_deterministic is true. 0 means only in that case.
+ */
+PHI_DEFINE_EXPORTED_int64(
+    deterministic_scatter_min_keys_per_row,
+    32,
+    "The min ratio of the indices to the destination rows from which the "
+    "scatter like operators reduce by sorting instead of atomics.");
+
 /**
  * CUDNN related FLAG
  * Name: FLAGS_cudnn_exhaustive_search
@@ -361,6 +401,46 @@ PHI_DEFINE_EXPORTED_int32(communicator_send_queue_size,
                           "queue size to recv gradient before send");
 #endif
 
+#ifdef PADDLE_WITH_RPC
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_rpc_max_batch_size
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_rpc_max_batch_size=64 sends up to 64 RPCs to the same
+ * worker in one brpc call.
+ * Note: The RPCs of paddle.distributed.rpc smaller than
+ *       FLAGS_rpc_max_batch_bytes are batched by destination worker when it
+ *       is larger than 1. A batch is sent when it is full, or
+ *       FLAGS_rpc_max_batch_delay_us after its first RPC.
+ */
+PHI_DEFINE_EXPORTED_int32(rpc_max_batch_size,
+                          1,
+                          "The maximum number of RPCs sent in one batch.");
+PHI_DEFINE_EXPORTED_int64(rpc_max_batch_bytes,
+                          64 << 10,
+                          "The maximum bytes of the RPCs sent in one batch.");
+PHI_DEFINE_EXPORTED_int32(rpc_max_batch_delay_us,
+                          100,
+                          "The maximum microseconds an RPC waits for the "
+                          "others of its batch.");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_rpc_handler_threads
+ * Since Version: 2.6.0
+ * Value Range: int32, default=1
+ * Example:
+ * Note: The number of threads kept to run the received batches of RPCs,
+ *       each takes the GIL once per batch. More threads are started while
+ *       all of them are busy, e.g. waiting for nested RPCs. The RPCs sent
+ *       without batching run on the brpc workers.
+ */
+PHI_DEFINE_EXPORTED_int32(rpc_handler_threads,
+                          1,
+                          "The number of threads kept to run the received "
+                          "batches of RPCs.");
+#endif
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_dist_threadpool_size
@@ -447,10 +527,13 @@ PHI_DEFINE_EXPORTED_double(
  * Allocator related FLAG
  * Name: FLAGS_allocator_strategy
  * Since Version: 1.2
- * Value Range: string, {naive_best_fit, auto_growth, thread_local},
- * default=auto_growth
+ * Value Range: string, {naive_best_fit, auto_growth, thread_local,
+ * size_class}, default=auto_growth
  * Example:
- * Note: For selecting allocator policy of PaddlePaddle.
+ * Note: For selecting allocator policy of PaddlePaddle. size_class is
+ *       auto_growth on devices, but serves small CPU allocations from
+ *       per-thread caches of size class blocks, for many threads allocating
+ *       at once, e.g. multi-threaded CPU inference.
  */
 static constexpr char kDefaultAllocatorStrategy[] = "auto_growth";  // NOLINT
 PHI_DEFINE_EXPORTED_string(
@@ -466,7 +549,25 @@ PHI_DEFINE_EXPORTED_string(
     "size of models may be larger). auto_growth strategy would allocate "
     "GPU memory on demand, which allows users to start several Paddle jobs "
     "on the same GPU card but may lead to more memory fragmentation "
-    "(i.e., maximum batch size of models may be smaller).");
+    "(i.e., maximum batch size of models may be smaller). size_class is "
+    "auto_growth for devices, and serves small CPU allocations from "
+    "per-thread caches of size class blocks.");
+
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_allocation_trace_capacity
+ * Since Version: 3.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_allocation_trace_capacity=1048576 keeps the last 1M
+ *          allocation events.
+ * Note: The number of allocation and free events the allocation tracer keeps
+ *       in its ring buffer, 0 disables it. A dumped trace can be replayed
+ *       against each allocator strategy by tools/replay_allocation_trace.py.
+ */
+PHI_DEFINE_EXPORTED_int64(allocation_trace_capacity,
+                          0,
+                          "The allocation events the allocation tracer keeps, "
+                          "0 disables it.");
 
 /**
  * Memory related FLAG
@@ -633,6 +734,21 @@ PHI_DEFINE_EXPORTED_bool(custom_device_mem_record,
                          false,
                          "Enable mem record event on custom device");
 
+/**
+ * Memory related FLAG
+ * Name: FLAGS_custom_device_stream_ordered_allocator
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_custom_device_stream_ordered_allocator=true would allocate
+ * the memory of the custom devices whose plugin implements
+ * async_device_memory_allocate in the order of their streams, instead of the
+ * auto growth allocator, and let the new executor free it without events.
+ */
+PHI_DEFINE_EXPORTED_bool(custom_device_stream_ordered_allocator,
+                         false,
+                         "Use the stream-ordered allocator of the custom "
+                         "device plugins");
+
 #endif
 
 /**
@@ -667,6 +783,21 @@ PHI_DEFINE_EXPORTED_bool(
  */
 PHI_DEFINE_EXPORTED_bool(use_mkldnn, false, "Use MKLDNN to run");
 
+/**
+ * MKLDNN related FLAG
+ * Name: FLAGS_onednn_primitive_cache_capacity
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_onednn_primitive_cache_capacity=4096
+ * Note: Capacity of the process-wide cache of oneDNN primitives and
+ * primitive descriptors that a predictor and its clones share across their
+ * threads. 0 disables the cache.
+ */
+PHI_DEFINE_EXPORTED_int32(onednn_primitive_cache_capacity,
+                          0,
+                          "Capacity of the oneDNN primitive cache shared by "
+                          "predictors of the same model, 0 disables it.");
+
 /**
  * Debug related FLAG
  * Name: FLAGS_call_stack_level
@@ -864,6 +995,38 @@ PHI_DEFINE_EXPORTED_bool(graph_load_in_parallel,
                          "It controls whether load graph node and edge with "
                          "multi threads parallelly.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_gloo_shm_allreduce
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_gloo_shm_allreduce=true would reduce the ranks of one host
+ *          in shared memory
+ * Note: If some host runs two ranks or more of a gloo group, the CPU
+ *       all-reduce of the group reduces the ranks of each host in shared
+ *       memory, and only one rank per host communicates over gloo. The ranks
+ *       keep the gloo transport if any of them fails to set up the shared
+ *       memory, e.g. when /dev/shm is too small.
+ */
+PHI_DEFINE_EXPORTED_bool(gloo_shm_allreduce,
+                         false,
+                         "Whether the gloo all-reduce of the ranks on one "
+                         "host goes through shared memory.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_gloo_shm_buffer_size
+ * Since Version: 3.0.0
+ * Value Range: int64, default=4194304
+ * Example:
+ * Note: The bytes of the shared memory slot of each rank in the gloo shared
+ *       memory all-reduce, larger tensors are reduced chunk by chunk.
+ */
+PHI_DEFINE_EXPORTED_int64(gloo_shm_buffer_size,
+                          4 << 20,
+                          "The bytes of the shared memory slot of each rank "
+                          "in the gloo shared memory all-reduce.");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_enable_neighbor_list_use_uva
@@ -876,6 +1039,22 @@ PHI_DEFINE_EXPORTED_bool(enable_neighbor_list_use_uva,
                          false,
                          "It controls whether store neighbor_list with UVA");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_gpugraph_neighbor_hbm_ratio
+ * Since Version: 2.6.0
+ * Value Range: double, [0.0, 1.0], default=1.0
+ * Example:
+ * Note: Out-of-core mode of the gpu graph. Only this ratio of the edges of
+ *       every edge table on a card is kept in hbm, for the nodes of the
+ *       largest degree; the rest stays in mapped pinned host memory that the
+ *       sample kernels read directly. 1.0 keeps all edges in hbm.
+ */
+PHI_DEFINE_EXPORTED_double(gpugraph_neighbor_hbm_ratio,
+                           1.0,
+                           "The ratio of graph edges kept in hbm, the rest "
+                           "is read from pinned host memory by the kernels.");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_graph_neighbor_size_percent
@@ -1025,6 +1204,21 @@ PHI_DEFINE_EXPORTED_string(deny_cinn_ops,
                            "",
                            "It controls the cinn op subset to be not used.");
 
+/*
+ * CINN related FLAG
+ * Name: FLAGS_deny_cinn_groups
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_deny_cinn_groups="3f2a09c1d4b7e865;..." would leave the
+ * groups of these fingerprints to the phi kernels in build_cinn_pass
+ * Note: The fingerprints are printed by the check_group_speed of
+ * SubGraphChecker, which times each group with and without CINN.
+ */
+PHI_DEFINE_EXPORTED_string(deny_cinn_groups,
+                           "",
+                           "The fingerprints of the CINN groups to be run "
+                           "by the phi kernels, separated by `;`.");
+
 /*
  * CINN related FLAG
  * Name: FLAGS_enable_pe_launch_cinn
@@ -1094,6 +1288,147 @@ PHI_DEFINE_EXPORTED_bool(new_executor_use_cuda_graph,
                          false,
                          "Use CUDA Graph in new executor");
 
+/*
+ * CUDA Graph related FLAG
+ * Name: FLAGS_new_executor_auto_cuda_graph
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_auto_cuda_graph=true would let the pir
+ * interpreter capture the steady-state step of each feed shape into a CUDA
+ * Graph and replay it, the steps it cannot capture run as usual.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_auto_cuda_graph,
+                         false,
+                         "Capture and replay the steady-state step of the pir "
+                         "interpreter with CUDA Graph");
+
+/*
+ * CUDA Graph related FLAG
+ * Name: FLAGS_new_executor_auto_cuda_graph_warmup_steps
+ * Since Version: 3.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_new_executor_auto_cuda_graph_warmup_steps=2 would run each
+ * feed shape eagerly twice before capturing it.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_auto_cuda_graph_warmup_steps,
+                          1,
+                          "Eager steps of a feed shape before it is captured "
+                          "by FLAGS_new_executor_auto_cuda_graph");
+
+/*
+ * CUDA Graph related FLAG
+ * Name: FLAGS_new_executor_auto_cuda_graph_max_buckets
+ * Since Version: 3.0
+ * Value Range: int32, default=8
+ * Example: FLAGS_new_executor_auto_cuda_graph_max_buckets=8 would keep at
+ * most 8 captured feed shapes per interpreter, other shapes run eagerly.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_auto_cuda_graph_max_buckets,
+                          8,
+                          "Max feed shapes captured by "
+                          "FLAGS_new_executor_auto_cuda_graph");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_static_memory_plan
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_static_memory_plan=true would let the pir
+ * interpreter place the intermediates of static shape in one preallocated
+ * arena by their lifetimes, instead of allocating and freeing them by gc.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_static_memory_plan,
+                         false,
+                         "Plan the static shape intermediates of the pir "
+                         "interpreter into one arena ahead of time");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_xpu_l3_plan_size
+ * Since Version: 3.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_new_executor_xpu_l3_plan_size=16777216 would reserve 16MB of
+ * XPU L3 for each pir interpreter with FLAGS_new_executor_static_memory_plan,
+ * and place the planned intermediates accessed most per op of lifetime there.
+ * 0 means all of them stay in global memory.
+ */
+PHI_DEFINE_EXPORTED_int64(new_executor_xpu_l3_plan_size,
+                          0,
+                          "Bytes of XPU L3 for the intermediates of the "
+                          "static memory plan of the pir interpreter");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_critical_path_schedule
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_critical_path_schedule=true would let the pir
+ * interpreter run the ready instruction with the longest path to the end of
+ * the program first, among those of the same scheduling priority.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_critical_path_schedule,
+                         false,
+                         "Schedule the ready instructions of the pir "
+                         "interpreter by their critical path");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_auto_stream_num
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_new_executor_auto_stream_num=4 would let the pir interpreter
+ * spread the independent branches of a GPU program over 4 compute streams,
+ * 0 or 1 keeps every kernel on the default stream.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_auto_stream_num,
+                          0,
+                          "Compute streams the pir interpreter spreads the "
+                          "independent branches of a program over");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_gc_batch_groups
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_new_executor_gc_batch_groups=8 would let the pir interpreter
+ * on GPU group the vars freed after the same instruction under one event, and
+ * hand 8 of these groups to the gc thread at once, 0 keeps the event gc.
+ * Note: It takes no effect when the fast gc is enabled.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_gc_batch_groups,
+                          0,
+                          "Groups of vars the gc of the pir interpreter frees "
+                          "in one batch, 0 disables the grouped gc");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_adaptive_spinning
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_adaptive_spinning=true would let the worker
+ * threads of the interpreters spin only while the instructions arrive often
+ * enough, instead of a fixed spin before blocking. It suits several
+ * interpreters or predictors sharing the cores of a process.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_adaptive_spinning,
+                         false,
+                         "Spin the interpreter worker threads by the recent "
+                         "arrival rate of the instructions");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_workqueue_cpus
+ * Since Version: 3.0
+ * Value Range: string, default=""
+ * Example: FLAGS_new_executor_workqueue_cpus="0-3,8" would pin the worker
+ * threads of the interpreters to the cpus 0, 1, 2, 3 and 8. They are not
+ * pinned by default.
+ */
+PHI_DEFINE_EXPORTED_string(new_executor_workqueue_cpus,
+                           "",
+                           "The cpus the interpreter worker threads are "
+                           "pinned to, e.g. 0-3,8");
+
 /*
  * CUDA Graph / Allocator related FLAG
  * Name: FLAGS_use_cuda_malloc_async_allocator
@@ -1106,6 +1441,22 @@ PHI_DEFINE_EXPORTED_bool(use_cuda_malloc_async_allocator,
                          false,
                          "Enable CUDAMallocAsyncAllocator");
 
+/*
+ * Allocator related FLAG
+ * Name: FLAGS_stream_ordered_cuda_free
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_stream_ordered_cuda_free=true would let
+ * StreamSafeCUDAAllocator hand an allocation used by other streams back to
+ * the pool of its stream at the next allocation, ordered after the other
+ * streams by one event per stream and batch of frees, instead of polling an
+ * event per allocation and stream until they finish.
+ */
+PHI_DEFINE_EXPORTED_bool(stream_ordered_cuda_free,
+                         false,
+                         "Stream ordered frees of allocations used by other "
+                         "streams in StreamSafeCUDAAllocator");
+
 /*
  * CUDA Graph / Allocator related FLAG
  * Name: FLAGS_auto_free_cudagraph_allocations_on_launch
@@ -1149,6 +1500,57 @@ PD_DEFINE_bool(enable_slotrecord_reset_shrink,  // NOLINT
 PD_DEFINE_bool(enable_ins_parser_file,  // NOLINT
                false,
                "enable parser ins file, default false");
+/**
+ * Dataset related FLAG
+ * Name: FLAGS_enable_reader_work_stealing
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_enable_reader_work_stealing=true lets an in-memory reader
+ * whose output channel ran dry take the rest of its batch from the channels
+ * of the other readers.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_reader_work_stealing,
+                         false,
+                         "let idle dataset readers steal instances");
+
+/**
+ * Dataset related FLAG
+ * Name: FLAGS_global_shuffle_max_inflight_batches
+ * Since Version: 3.0
+ * Value Range: int32, default=4
+ * Example: FLAGS_global_shuffle_max_inflight_batches=1 waits for every
+ * GlobalShuffle batch to be acked before serializing the next one.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    global_shuffle_max_inflight_batches,
+    4,
+    "batches one GlobalShuffle thread keeps in flight, default 4");
+
+/**
+ * Dataset related FLAG
+ * Name: FLAGS_enable_async_file_reader
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_enable_async_file_reader=true reads the dataset files of
+ * LoadIntoMemory ahead on a pool of threads, local and .gz files without
+ * spawning a shell.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_async_file_reader,
+                         false,
+                         "prefetch dataset files on a pool of reader threads");
+PHI_DEFINE_EXPORTED_int32(async_file_reader_thread_num,
+                          4,
+                          "number of files the async file reader reads ahead");
+PHI_DEFINE_EXPORTED_int64(async_file_reader_block_size,
+                          4 * 1024 * 1024,
+                          "read block size of the async file reader in bytes");
+PHI_DEFINE_EXPORTED_int32(async_file_reader_buffered_blocks,
+                          8,
+                          "blocks the async file reader buffers per file");
+PD_DEFINE_bool(enable_slotrecord_line_view,  // NOLINT
+               false,
+               "parse slotrecord lines in place in the read buffer instead of "
+               "copying every line into a string, default false");
 PHI_DEFINE_EXPORTED_bool(
     gpugraph_enable_hbm_table_collision_stat,
     false,
@@ -1173,6 +1575,11 @@ PHI_DEFINE_EXPORTED_uint64(
     gpugraph_merge_grads_segment_size,
     128,
     "segment size with segment gradient merge, default 128");
+PHI_DEFINE_EXPORTED_bool(
+    gpugraph_enable_fused_push_update,
+    false,
+    "merge the gradients of each key and apply the sparse optimizer in one "
+    "kernel while push sparse to a local table, default false");
 PHI_DEFINE_EXPORTED_uint64(gpugraph_slot_feasign_max_num,
                            5,
                            "max feasign number in one slot, default 5");
@@ -1180,6 +1587,28 @@ PHI_DEFINE_EXPORTED_int32(
     gpugraph_dedup_pull_push_mode,
     0,
     "enable dedup keys while pull push sparse, default 0");
+PHI_DEFINE_EXPORTED_bool(
+    gpugraph_enable_pass_overlap,
+    false,
+    "prepare the next pass's device keys while the current pass trains and "
+    "write back EndPass asynchronously, call wait_end_pass before reading "
+    "the cpu sparse table, default false");
+PHI_DEFINE_EXPORTED_bool(
+    gpugraph_enable_hbm_table_overflow,
+    false,
+    "keep the feature values of a pass that do not fit in hbm in host "
+    "memory the gpu reads in place, instead of failing the build, "
+    "default false");
+PHI_DEFINE_EXPORTED_int64(
+    gpugraph_hbm_table_reserve_mb,
+    4096,
+    "hbm in MB per card the feature value pool leaves free for training "
+    "when gpugraph_enable_hbm_table_overflow is set, default 4096");
+PHI_DEFINE_EXPORTED_double(
+    gpugraph_hbm_pool_shrink_ratio,
+    0.0,
+    "at EndPass an mf dim's hbm value pool is freed when the pass used less "
+    "than 1 / ratio of it, e.g. 2.0, 0 keeps every pool, default 0");
 PHI_DEFINE_EXPORTED_bool(gpugraph_load_node_list_into_hbm,
                          true,
                          "enable load_node_list_into_hbm, default true");
@@ -1248,6 +1677,22 @@ PHI_DEFINE_EXPORTED_bool(benchmark_nccl,
  */
 PHI_DEFINE_EXPORTED_bool(use_autotune, false, "Whether enable autotune.");
 
+/**
+ * Autotune related FLAG
+ * Name: FLAGS_autotune_cache_file
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_autotune_cache_file=/path/to/autotune_cache
+ * Note: The algorithms of conv, matmul, transpose and gather-gemm-scatter
+ * tuned by former processes are loaded from this file at startup, and the
+ * ones tuned by this process are merged into it on exit. The entries saved
+ * on a device of another model, driver or dnn version are ignored. Empty
+ * means not to persist the autotune cache.
+ */
+PHI_DEFINE_EXPORTED_string(autotune_cache_file,
+                           "",
+                           "The file to persist the autotune cache in.");
+
 /**
  * Conv Search cache max number related FLAG
  * Name: FLAGS_search_cache_max_number
@@ -1273,6 +1718,21 @@ PHI_DEFINE_EXPORTED_bool(
     false,
     "EinsumOp backward will be speedup at the expense of more gpu memory.");
 
+/**
+ * FFT related FLAG
+ * Name: FLAGS_fft_plan_cache_workspace_mb
+ * Since Version: 3.0
+ * Value Range: int64, default=1024
+ * Example: FLAGS_fft_plan_cache_workspace_mb=256 would evict the least
+ * recently used cuFFT/hipFFT plans of a device once the workspace the cached
+ * plans ask for exceeds 256 MB.
+ * Note: 0 bounds the plan cache by the number of plans only.
+ */
+PHI_DEFINE_EXPORTED_int64(fft_plan_cache_workspace_mb,
+                          1024,
+                          "Workspace budget in MB of the FFT plans cached "
+                          "per device.");
+
 /**
  * JitLayer related FLAG
  * Name: FLAGS_jit_engine_type
@@ -1288,6 +1748,32 @@ PHI_DEFINE_EXPORTED_string(jit_engine_type,
                            "Predictor",
                            "Choose default function type in JitLayer.");
 
+/**
+ * JitLayer related FLAG
+ * Name: FLAGS_jit_lazy_engine
+ * Since Version: 3.0
+ * Value Range: bool, default=true
+ * Example:
+ * Note: If True, jit::Load builds the engine of each function on its first
+ * call instead of building all of them at load.
+ */
+PHI_DEFINE_EXPORTED_bool(jit_lazy_engine,
+                         true,
+                         "Build the engines of a JitLayer on first call.");
+
+/**
+ * JitLayer related FLAG
+ * Name: FLAGS_jit_engine_warmup
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, together with FLAGS_jit_lazy_engine, the engines of a loaded
+ * JitLayer are built on background threads right after jit::Load returns.
+ */
+PHI_DEFINE_EXPORTED_bool(jit_engine_warmup,
+                         false,
+                         "Build the lazy engines of a JitLayer in background.");
+
 /**
  * Custom Device NPU related FLAG
  * Name: FLAGS_npu_storage_format
@@ -1321,6 +1807,22 @@ PHI_DEFINE_EXPORTED_bool(enable_cudnn_frontend, false, "");
  * the result of exhaustive search is unstable.
  */
 PHI_DEFINE_EXPORTED_int32(cudnn_cache_saturation_count, 1, "");
+
+/**
+ * CUDNNv8 related FLAG
+ * Name: auto_fuse_resunit
+ * Since Version: 2.6.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Apply fuse_resunit_pass to the static programs on GPUs of compute
+ * capability >= 8.0 with cuDNN >= 8.8 without setting
+ * BuildStrategy.fuse_resunit, which fuses the float16 NHWC conv, batch_norm
+ * and relu chains of training and evaluation into cudnn-frontend graphs.
+ */
+PHI_DEFINE_EXPORTED_bool(auto_fuse_resunit,
+                         false,
+                         "Whether to apply fuse_resunit_pass on the GPUs "
+                         "supporting it without setting BuildStrategy.");
 #endif  // PADDLE_WITH_CUDNN_FRONTEND
 
 /**
@@ -1336,6 +1838,51 @@ PHI_DEFINE_EXPORTED_bool(trt_ibuilder_cache,
                          false,
                          "Add a persistent ibuilder.");
 
+/**
+ * TensorRT related FLAG
+ * Name: trt_int8_calib_queue_size
+ * Since Version: 3.0
+ * Value Range: int32, default=2
+ * Example: FLAGS_trt_int8_calib_queue_size=4
+ * Note: The number of batches an int8 calibrator keeps. The predictor runs
+ * the next batches while the calibration engine consumes the former ones,
+ * 1 runs them in turn. Each batch takes a copy of the engine inputs.
+ */
+PHI_DEFINE_EXPORTED_int32(trt_int8_calib_queue_size,
+                          2,
+                          "The number of batches of an int8 calibrator.");
+
+/**
+ * TensorRT related FLAG
+ * Name: trt_int8_calib_merge_table
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_trt_int8_calib_merge_table=true
+ * Note: If True, a calibration table is merged into the table of the same
+ * engine already saved in the model cache dir, instead of overwriting it,
+ * so that the calibration set can be run in shards, one after another or
+ * by the predictors of several GPUs saving in turn.
+ */
+PHI_DEFINE_EXPORTED_bool(trt_int8_calib_merge_table,
+                         false,
+                         "Merge the int8 calibration table with the saved.");
+
+/**
+ * TensorRT related FLAG
+ * Name: trt_bridge_ops_between_engines
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_trt_bridge_ops_between_engines=true
+ * Note: If True, tensorrt_subgraph_pass takes the ops TensorRT does not
+ * support into the engines as generic plugins of their phi kernels, if they
+ * are between the ops of the engines and keep the dims and the dtype of their
+ * only input, so that the engines around them are merged. It only works with
+ * dynamic shape and the pass logs the engine boundaries removed.
+ */
+PHI_DEFINE_EXPORTED_bool(trt_bridge_ops_between_engines,
+                         false,
+                         "Merge the TensorRT engines across unsupported ops.");
+
 /**
  * mmap_allocator related FLAG
  * Name: use_shm_cache
@@ -1404,6 +1951,36 @@ PHI_DEFINE_EXPORTED_bool(enable_pir_with_pt_in_dy2st,
                          true,
                          "Enable new IR in executor");
 
+/**
+ * Dy2static interpreter cache FLAG
+ * Name: dy2st_interpreter_cache_capacity
+ * Since Version: 2.6.0
+ * Value Range: int32, default=64
+ * Example:
+ * Note: The max number of the (program, scope, place) entries kept in the
+ * interpreter cache of dy2static, the least recently used entries are
+ * evicted beyond it. 0 means unbounded.
+ */
+PHI_DEFINE_EXPORTED_int32(dy2st_interpreter_cache_capacity,
+                          64,
+                          "The max number of entries in the interpreter cache "
+                          "of dy2static, 0 means unbounded.");
+
+/**
+ * Dy2static interpreter cache FLAG
+ * Name: dy2st_interpreter_cache_max_ops
+ * Since Version: 2.6.0
+ * Value Range: int64, default=0
+ * Example:
+ * Note: The max number of the ops of all the programs held by the
+ * interpreter cache of dy2static, which approximates the memory of the
+ * cached interpreters and programs. 0 means unbounded.
+ */
+PHI_DEFINE_EXPORTED_int64(dy2st_interpreter_cache_max_ops,
+                          0,
+                          "The max number of ops held by the interpreter cache "
+                          "of dy2static, 0 means unbounded.");
+
 /**
  * Using PIR API in Python
  * Name: enable_pir_api
@@ -1440,6 +2017,36 @@ PHI_DEFINE_EXPORTED_bool(pir_apply_inplace_pass,
                          "Whether to apply inplace pass on lowering "
                          "::pir::Program to Kernel Dialect");
 
+/**
+ * Plan the order of the PIR GPU fusion passes of inference FLAG
+ * Name: pir_fusion_planner
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, the fusion passes of the GPU pass list are applied in the
+ * order that saves the most estimated memory traffic and kernel launches,
+ * instead of the fixed order of the list.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_fusion_planner,
+                         false,
+                         "Whether to plan the order of the PIR GPU fusion "
+                         "passes with a cost model in inference");
+
+/**
+ * Group the DRR passes of the PIR GPU pass list of inference FLAG
+ * Name: pir_group_drr_passes
+ * Since Version: 3.0.0
+ * Value Range: bool, default=true
+ * Example:
+ * Note: If True, the consecutive passes made of DRR patterns which do not
+ * match the ops of each other are applied in one traversal of the program
+ * instead of one traversal per pass.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_group_drr_passes,
+                         true,
+                         "Whether to apply the independent DRR passes of "
+                         "the PIR GPU pass list in one traversal in inference");
+
 PHI_DEFINE_EXPORTED_string(
     ir_inplace_kernel_blacklist,
     "",
@@ -1478,6 +2085,55 @@ PHI_DEFINE_EXPORTED_int32(
     "Multiple of the CUPTI device buffer size. If the timestamps have "
     "been dropped when you are profiling, try increasing this value.");
 
+/**
+ * Profiler related FLAG
+ * Name: FLAGS_op_stats_sample_interval
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_op_stats_sample_interval=100 times 1 in every 100 operators
+ * of every thread.
+ * Note: If positive, the host time of the sampled operators is aggregated
+ * into per-op statistics, which are appended to FLAGS_op_stats_output_path
+ * periodically. It works without the profiler and is cheap enough to be left
+ * on in production jobs.
+ */
+PHI_DEFINE_EXPORTED_int32(op_stats_sample_interval,
+                          0,
+                          "If positive, time 1 in every N operator events of "
+                          "every thread and write the per-op statistics to "
+                          "FLAGS_op_stats_output_path periodically.");
+
+PHI_DEFINE_EXPORTED_string(op_stats_output_path,
+                           "",
+                           "The file the sampled operator statistics are "
+                           "appended to, op_stats.<pid>.jsonl if empty.");
+
+PHI_DEFINE_EXPORTED_int32(op_stats_flush_interval_s,
+                          60,
+                          "The interval in seconds to write the sampled "
+                          "operator statistics.");
+
+/**
+ * Metrics related FLAG
+ * Name: FLAGS_metrics_dump_path
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_metrics_dump_path=/var/lib/node_exporter/paddle.prom
+ * Note: If not empty, the metrics of the process, e.g. the executor step time
+ * and the allocations, are written to the file in the Prometheus text format
+ * every FLAGS_metrics_dump_interval_s seconds, for the textfile collector of
+ * node_exporter or another scraper to pick up.
+ */
+PHI_DEFINE_EXPORTED_string(metrics_dump_path,
+                           "",
+                           "If not empty, write the metrics in the Prometheus "
+                           "text format to the file periodically.");
+
+PHI_DEFINE_EXPORTED_int32(metrics_dump_interval_s,
+                          15,
+                          "The interval in seconds to write the metrics to "
+                          "FLAGS_metrics_dump_path.");
+
 PHI_DEFINE_EXPORTED_bool(print_ir, false, "Whether print ir debug str.");
 PHI_DEFINE_EXPORTED_bool(prim_skip_dynamic,
                          false,
@@ -1527,11 +2183,387 @@ PHI_DEFINE_EXPORTED_bool(enable_async_trace,
 
 PHI_DEFINE_EXPORTED_int32(async_trace_count, 5, "collective async trace count");
 
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: enable_comm_telemetry
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_enable_comm_telemetry=true with FLAGS_enable_async_trace=true
+ *          would time the traced collectives with CUDA events, and log their
+ *          bytes, time and bus bandwidth by group and collective type.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_comm_telemetry,
+                         false,
+                         "Whether to time the collectives traced by "
+                         "FLAGS_enable_async_trace.");
+
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: comm_telemetry_export_interval_s
+ * Since Version: 3.0
+ * Value Range: int32, default=60
+ * Example: FLAGS_comm_telemetry_export_interval_s=30 would log the summary of
+ *          the comm telemetry, and export the start times of the latest
+ *          collectives to the store for computing the skew of the ranks,
+ *          every 30 seconds.
+ */
+PHI_DEFINE_EXPORTED_int32(comm_telemetry_export_interval_s,
+                          60,
+                          "The interval in seconds the comm telemetry is "
+                          "exported at.");
+
+/**
+ * Distributed related FLAG
+ * Name: auto_parallel_reshard_chunk_size_mb
+ * Since Version: 3.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_auto_parallel_reshard_chunk_size_mb=64 would let the reshard
+ *          from shard to replicated and from partial to shard of tensors
+ *          larger than 64MB run in chunks of about 64MB along axis 0, the
+ *          collective of a chunk overlapping the concat or transpose of the
+ *          previous one, with temporaries of two chunks. 0 means not chunked.
+ */
+PHI_DEFINE_EXPORTED_int64(auto_parallel_reshard_chunk_size_mb,
+                          0,
+                          "The size in MB of the chunks reshards are "
+                          "pipelined in, 0 means not chunked.");
+
+/**
+ * Distributed related FLAG
+ * Name: auto_parallel_reshard_planner
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_auto_parallel_reshard_planner=true would let the reshards on
+ *          the same nd mesh run the cheapest sequence of 1-D reshards by a
+ *          latency and bandwidth cost model of the mesh axes, instead of
+ *          all gathering the diverging dims first, e.g. an all gather and
+ *          an all to all instead of two all gathers for [S0, S1] to
+ *          [S1, S0]. The plans are cached by dist attrs and shape.
+ */
+PHI_DEFINE_EXPORTED_bool(auto_parallel_reshard_planner,
+                         false,
+                         "Whether to plan the nd mesh reshards by a cost "
+                         "model.");
+
+/**
+ * Distributed related FLAG
+ * Name: auto_parallel_spmd_rule_cache
+ * Since Version: 3.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_auto_parallel_spmd_rule_cache=false would let the dygraph
+ *          apis call their spmd rules on every call, instead of reusing the
+ *          dist attrs inferred for the same api, input shapes, dtypes and
+ *          dist attrs, and attributes.
+ */
+PHI_DEFINE_EXPORTED_bool(auto_parallel_spmd_rule_cache,
+                         true,
+                         "Whether to cache the results of the spmd rules of "
+                         "the dygraph apis.");
+
 PHI_DEFINE_EXPORTED_bool(
     use_auto_growth_pinned_allocator,
     false,
     "Whether to use the auto_growth CUDA pinned allocator.");
 
+/**
+ * Memory related FLAG
+ * Name: FLAGS_load_combined_params_with_mmap
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_load_combined_params_with_mmap=true would let load_combine
+ *          map the combined params file copy-on-write: the CPU parameters
+ *          share the pages of the mapping instead of being read into fresh
+ *          tensors, the GPU ones are streamed through pinned staging buffers.
+ * Note: Not supported on Windows.
+ */
+PHI_DEFINE_EXPORTED_bool(load_combined_params_with_mmap,
+                         false,
+                         "Map the combined params file in load_combine "
+                         "instead of reading it.");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_shared_params_name
+ * Since Version: 3.0
+ * Value Range: string, default=""
+ * Example: FLAGS_shared_params_name=bert would let the processes loading the
+ *          same combined params with FLAGS_load_combined_params_with_mmap
+ *          share one read-only copy of the GPU parameters through CUDA IPC:
+ *          the first process fills the region, the others map it.
+ * Note: Linux and CUDA only, the first process has to outlive the others.
+ */
+PHI_DEFINE_EXPORTED_string(shared_params_name,
+                           "",
+                           "Name of the GPU memory region the processes "
+                           "loading the same params share.");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_save_combine_with_tensor_checkpoint
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_save_combine_with_tensor_checkpoint=true would let
+ *          save_combine write the indexed, chunked and checksummed tensor
+ *          checkpoint format on a pool of threads. load_combine reads both
+ *          formats.
+ */
+PHI_DEFINE_EXPORTED_bool(save_combine_with_tensor_checkpoint,
+                         false,
+                         "Save the tensors of save_combine as a tensor "
+                         "checkpoint.");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_tensor_checkpoint_thread_num
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_tensor_checkpoint_thread_num=8 would write and read tensor
+ *          checkpoints with 8 threads, 0 uses up to 16 hardware threads.
+ */
+PHI_DEFINE_EXPORTED_int32(tensor_checkpoint_thread_num,
+                          0,
+                          "The number of threads saving or loading a tensor "
+                          "checkpoint.");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_save_combine_async
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_save_combine_async=true would let save_combine snapshot the
+ *          tensors and return, a background thread writes them as a tensor
+ *          checkpoint. paddle.base.core.wait_all_async_checkpoints() waits
+ *          for the saves and raises their errors.
+ */
+PHI_DEFINE_EXPORTED_bool(save_combine_async,
+                         false,
+                         "Save the tensors of save_combine asynchronously.");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_async_checkpoint_max_pending
+ * Since Version: 3.0
+ * Value Range: int32, default=2
+ * Example: FLAGS_async_checkpoint_max_pending=1 would make an async checkpoint
+ *          wait for the previous one to be written before taking its
+ *          snapshot, which bounds the host memory the snapshots take.
+ */
+PHI_DEFINE_EXPORTED_int32(async_checkpoint_max_pending,
+                          2,
+                          "The maximum number of async checkpoints in "
+                          "flight.");
+
+/**
+ * Eager related FLAG
+ * Name: FLAGS_eager_activation_offload_prefetch_depth
+ * Since Version: 3.0
+ * Value Range: int32, default=2
+ * Example: FLAGS_eager_activation_offload_prefetch_depth=4 would let the
+ *          backward start copying back the offloaded activations of the
+ *          GradNodes up to 4 edges ahead of the one it runs, see
+ *          paddle.autograd.offload_activations.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_activation_offload_prefetch_depth,
+                          2,
+                          "How many GradNodes ahead the offloaded activations "
+                          "are prefetched.");
+
+/**
+ * Eager related FLAG
+ * Name: FLAGS_eager_backward_num_threads
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_eager_backward_num_threads=4 would run the GradNodes of
+ *          backward on 4 threads per place once their grads are ready, so
+ *          independent branches of the backward graph overlap. The grads of
+ *          a GradNode are summed in an order fixed by the graph. 0 or 1
+ *          keeps the backward on the calling thread. paddle.grad and
+ *          backward with create_graph=True always run on the calling thread.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_backward_num_threads,
+                          0,
+                          "The number of threads per place that run the "
+                          "GradNodes of backward, 0 or 1 to run them on the "
+                          "calling thread.");
+
+/**
+ * Optimizer related FLAG
+ * Name: FLAGS_optimizer_fused_multi_tensor
+ * Since Version: 3.0
+ * Value Range: bool, default=true
+ * Example: FLAGS_optimizer_fused_multi_tensor=false would let the dygraph
+ *          AdamW launch one adamw kernel per parameter again, instead of
+ *          one fused_adam launch per group of dense GPU parameters sharing
+ *          the dtype and the optimizer options. It is read when the
+ *          optimizer is created.
+ */
+PHI_DEFINE_EXPORTED_bool(optimizer_fused_multi_tensor,
+                         true,
+                         "Whether the dygraph optimizers update the "
+                         "parameters in groups with fused multi-tensor "
+                         "kernels.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_eager_reducer_rebuild_group_steps
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_eager_reducer_rebuild_group_steps=3 would let the
+ *          EagerReducer of DataParallel record the order the grads are ready
+ *          in during the first 3 synchronized steps, then rebuild its
+ *          all-reduce groups in that order so each one is launched as soon
+ *          as its grads are ready. 0 keeps the groups built from the
+ *          parameter order. It is not applied with
+ *          find_unused_parameters=True.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_reducer_rebuild_group_steps,
+                          0,
+                          "The number of steps to record the ready order of "
+                          "grads in before rebuilding the EagerReducer "
+                          "groups, 0 to never rebuild them.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_eager_reducer_grad_as_bucket_view
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_eager_reducer_grad_as_bucket_view=true would let the dense
+ *          grads of the parameters synchronized by the EagerReducer of
+ *          DataParallel be views into the persistent buffer of their
+ *          all-reduce group, which is all-reduced in place instead of being
+ *          concatenated from and split back to the grads every step.
+ */
+PHI_DEFINE_EXPORTED_bool(eager_reducer_grad_as_bucket_view,
+                         false,
+                         "Whether the dense grads synchronized by the "
+                         "EagerReducer are views into the buffers of their "
+                         "groups.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_eager_reducer_sparse_allreduce
+ * Since Version: 3.0
+ * Value Range: string, default=allgather
+ * Example: FLAGS_eager_reducer_sparse_allreduce=partition would let the
+ *          EagerReducer of DataParallel merge the duplicate rows of a sparse
+ *          grad, send each row to the rank owning its range of the height
+ *          by an all-to-all, merge the received rows there and all-gather
+ *          the merged rows, instead of all-gathering the rows of every rank
+ *          as they are. The gloo backend always all-gathers.
+ */
+PHI_DEFINE_EXPORTED_string(eager_reducer_sparse_allreduce,
+                           "allgather",
+                           "The algorithm the EagerReducer all-reduces the "
+                           "sparse grads with, allgather or partition.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_eager_reducer_sparse_dense_ratio
+ * Since Version: 3.0
+ * Value Range: double, default=0.0
+ * Example: FLAGS_eager_reducer_sparse_dense_ratio=0.3 would let the
+ *          EagerReducer of DataParallel all-reduce a sparse grad as a dense
+ *          tensor of its full height once the rows of all the ranks add up
+ *          to 30% of the height. 0 never densifies the sparse grads.
+ */
+PHI_DEFINE_EXPORTED_double(eager_reducer_sparse_dense_ratio,
+                           0.0,
+                           "The ratio of the gathered rows to the height of a "
+                           "sparse grad above which the EagerReducer "
+                           "all-reduces it as a dense tensor, 0 to disable.");
+
+/**
+ * Memory related FLAG
+ * Name: FLAGS_use_pinned_staging_pool
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_use_pinned_staging_pool=true would stage the asynchronous
+ *          copies from pageable host memory to a GPU through pooled pinned
+ *          buffers, which are reused once their copies complete, instead of
+ *          page-locking on the copy path.
+ */
+PHI_DEFINE_EXPORTED_bool(use_pinned_staging_pool,
+                         false,
+                         "Stage host to device copies through the pinned "
+                         "staging pool.");
+
+/**
+ * Data read related FLAG
+ * Name: FLAGS_reader_packed_copy
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_reader_packed_copy=true would make the buffered reader copy
+ *          each batch to the GPU with one memcpy from a pinned staging
+ *          buffer, into one device block, and make the compute stream wait
+ *          for the copy instead of synchronizing the host with it.
+ */
+PHI_DEFINE_EXPORTED_bool(reader_packed_copy,
+                         false,
+                         "Copy each batch of the buffered reader to the GPU "
+                         "with one packed memcpy.");
+
+/**
+ * Data read related FLAG
+ * Name: FLAGS_reader_copy_streams
+ * Since Version: 3.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_reader_copy_streams=2 would make the buffered reader issue
+ *          the packed copies of the batches on 2 streams in turn, so the copy
+ *          of a batch may overlap the copy of the previous one. It works with
+ *          FLAGS_reader_packed_copy only.
+ */
+PHI_DEFINE_EXPORTED_int32(reader_copy_streams,
+                          1,
+                          "Number of the streams of the packed copies of the "
+                          "buffered reader.");
+
+/**
+ * Data read related FLAG
+ * Name: FLAGS_reader_queue_spin_iterations
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_reader_queue_spin_iterations=1000 would make the senders and
+ *          receivers of the reader queues between the DataLoader and the
+ *          readers spin for up to 1000 checks of the queue before blocking,
+ *          which saves the wake-ups when both sides keep up with each other.
+ */
+PHI_DEFINE_EXPORTED_int32(reader_queue_spin_iterations,
+                          0,
+                          "Number of the spins of the reader queues before "
+                          "blocking.");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_worker_variable_slots
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_worker_variable_slots=true would make the hogwild and
+ *          downpour workers resolve the variables of their ops to slots once
+ *          per thread scope, so the ops and the garbage collection index them
+ *          at each step instead of looking up their names in the scope.
+ */
+PHI_DEFINE_EXPORTED_bool(worker_variable_slots,
+                         false,
+                         "Whether the device workers resolve the variables of "
+                         "their ops by slots instead of by names.");
+
+/**
+ * Executor related FLAG
+ * Name: FLAGS_downpour_max_inflight_push_batches
+ * Since Version: 3.0
+ * Value Range: int32, default=-1
+ * Example: FLAGS_downpour_max_inflight_push_batches=1 lets a downpour worker
+ *          pull the sparse values of a batch while the pushes of the previous
+ *          batch are still in flight, so the values may miss one batch of
+ *          updates. 0 waits all the pushes before the pull, and -1 never
+ *          waits them.
+ */
+PHI_DEFINE_EXPORTED_int32(downpour_max_inflight_push_batches,
+                          -1,
+                          "The number of batches whose pushes may be in "
+                          "flight when a downpour worker pulls, -1 for no "
+                          "bound.");
+
 PHI_DEFINE_EXPORTED_bool(
     sync_after_alloc,
     false,
@@ -0,0 +1,179 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/collective/comm_hook.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "paddle/fluid/distributed/collective/reducer.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/api/include/api.h"
+
+namespace paddle {
+namespace distributed {
+
+// the same on all the ranks, so are the initial Q of PowerSGD
+constexpr int kPowerSGDSeed = 20190623;
+
+static std::shared_ptr<ProcessGroup::Task> AllReduceTensor(
+    ProcessGroup *process_group, const Tensor &tensor) {
+  distributed::AllreduceOptions opts;
+  opts.reduce_op = ReduceOp::SUM;
+  std::vector<phi::DenseTensor> in_out = {
+      *std::dynamic_pointer_cast<phi::DenseTensor>(tensor.impl())};
+  return process_group->AllReduce(in_out, in_out, opts);
+}
+
+CastCommHook::CastCommHook(phi::DataType comm_dtype) : comm_dtype_(comm_dtype) {
+  PADDLE_ENFORCE_EQ(
+      comm_dtype == phi::DataType::FLOAT16 ||
+          comm_dtype == phi::DataType::BFLOAT16,
+      true,
+      platform::errors::InvalidArgument(
+          "The cast comm hook only supports float16 and bfloat16, but got %s.",
+          comm_dtype));
+}
+
+std::shared_ptr<ProcessGroup::Task> CastCommHook::AllReduce(
+    ProcessGroup *process_group, EagerGroup *group, size_t group_index) {
+  if (group->dtype_ == comm_dtype_) {
+    return AllReduceTensor(process_group, group->dense_contents_);
+  }
+  auto &buffer = buffers_[group_index];
+  buffer = paddle::experimental::cast(group->dense_contents_, comm_dtype_);
+  return AllReduceTensor(process_group, buffer);
+}
+
+void CastCommHook::Finalize(ProcessGroup *process_group,
+                            EagerGroup *group,
+                            size_t group_index) {
+  auto iter = buffers_.find(group_index);
+  if (iter == buffers_.end()) {
+    return;
+  }
+  group->dense_contents_ =
+      paddle::experimental::cast(iter->second, group->dtype_);
+  buffers_.erase(iter);
+}
+
+PowerSGDCommHook::PowerSGDCommHook(int64_t matrix_approximation_rank,
+                                   int64_t start_step)
+    : matrix_approximation_rank_(matrix_approximation_rank),
+      start_step_(start_step) {
+  PADDLE_ENFORCE_GT(matrix_approximation_rank,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The matrix_approximation_rank of PowerSGD should be "
+                        "positive, but got %d.",
+                        matrix_approximation_rank));
+}
+
+std::shared_ptr<ProcessGroup::Task> PowerSGDCommHook::AllReduce(
+    ProcessGroup *process_group, EagerGroup *group, size_t group_index) {
+  auto &state = states_[group_index];
+  const auto place = group->dense_contents_.place();
+  if (state.length != group->all_length_) {
+    // a new group, or the groups were rebuilt
+    state = State();
+    state.length = group->all_length_;
+    state.side = static_cast<int64_t>(
+        std::ceil(std::sqrt(static_cast<double>(state.length))));
+    int64_t rank = std::min(matrix_approximation_rank_, state.side);
+    state.q = paddle::experimental::gaussian(
+        IntArray({state.side, rank}),
+        0.0f,
+        1.0f,
+        kPowerSGDSeed + static_cast<int>(group_index),
+        phi::DataType::FLOAT32,
+        place);
+    state.error = paddle::experimental::full(
+        IntArray({state.side * state.side}), 0, phi::DataType::FLOAT32, place);
+  }
+  state.compressed = state.steps++ >= start_step_;
+  if (!state.compressed) {
+    return AllReduceTensor(process_group, group->dense_contents_);
+  }
+
+  Tensor m = group->dense_contents_;
+  if (group->dtype_ != phi::DataType::FLOAT32) {
+    m = paddle::experimental::cast(m, phi::DataType::FLOAT32);
+  }
+  int64_t padding = state.side * state.side - state.length;
+  if (padding > 0) {
+    m = paddle::experimental::concat(
+        {m,
+         paddle::experimental::full(
+             IntArray({padding}), 0, phi::DataType::FLOAT32, place)},
+        0);
+  }
+  // error feedback
+  m = paddle::experimental::add(m, state.error);
+  state.m =
+      paddle::experimental::reshape(m, IntArray({state.side, state.side}));
+  state.p = paddle::experimental::matmul(state.m, state.q);
+  return AllReduceTensor(process_group, state.p);
+}
+
+void PowerSGDCommHook::Finalize(ProcessGroup *process_group,
+                                EagerGroup *group,
+                                size_t group_index) {
+  auto &state = states_[group_index];
+  if (!state.compressed) {
+    return;
+  }
+  Tensor p = std::get<0>(paddle::experimental::qr(state.p, "reduced"));
+  Tensor q = paddle::experimental::matmul(state.m, p, true, false);
+  // queued after the all-reduce on the compute stream
+  AllReduceTensor(process_group, q)->Wait();
+  Tensor approximation = paddle::experimental::matmul(p, q, false, true);
+  state.error = paddle::experimental::reshape(
+      paddle::experimental::subtract(state.m, approximation),
+      IntArray({state.side * state.side}));
+  state.q = q;
+  state.m = Tensor();
+  state.p = Tensor();
+
+  Tensor result = paddle::experimental::reshape(
+      approximation, IntArray({state.side * state.side}));
+  if (state.side * state.side != state.length) {
+    result = paddle::experimental::slice(
+        result, {0}, IntArray({0}), IntArray({state.length}), {1}, {});
+  }
+  if (group->dtype_ != phi::DataType::FLOAT32) {
+    result = paddle::experimental::cast(result, group->dtype_);
+  }
+  group->dense_contents_ = result;
+}
+
+std::shared_ptr<EagerCommHook> CreateEagerCommHook(
+    const std::string &type,
+    int64_t matrix_approximation_rank,
+    int64_t start_step) {
+  if (type == "fp16") {
+    return std::make_shared<CastCommHook>(phi::DataType::FLOAT16);
+  } else if (type == "bf16") {
+    return std::make_shared<CastCommHook>(phi::DataType::BFLOAT16);
+  } else if (type == "powersgd") {
+    return std::make_shared<PowerSGDCommHook>(matrix_approximation_rank,
+                                              start_step);
+  }
+  PADDLE_THROW(platform::errors::InvalidArgument(
+      "Unknown comm hook %s, it should be fp16, bf16 or powersgd.", type));
+}
+
+}  //  namespace distributed
+}  //  namespace paddle
@@ -0,0 +1,111 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "paddle/fluid/distributed/collective/process_group.h"
+#include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/common/data_type.h"
+
+namespace paddle {
+namespace distributed {
+
+class EagerGroup;
+
+// Communication hook of the dense groups of EagerReducer, which encodes the
+// fused buffer of a group before its all-reduce and decodes it after, e.g.
+// to send fewer bytes.
+class EagerCommHook {
+ public:
+  virtual ~EagerCommHook() = default;
+
+  // Starts all-reducing group->dense_contents_, already divided by the number
+  // of ranks, as soon as the group is ready.
+  virtual std::shared_ptr<ProcessGroup::Task> AllReduce(
+      ProcessGroup *process_group, EagerGroup *group, size_t group_index) = 0;
+
+  // Called at the end of backward once the task of AllReduce is waited for,
+  // leaves the mean of the group over the ranks in group->dense_contents_.
+  virtual void Finalize(ProcessGroup *process_group,
+                        EagerGroup *group,
+                        size_t group_index) {}
+};
+
+// All-reduces the groups cast to FLOAT16 or BFLOAT16, and casts the result
+// back to the dtype of the grads, which accumulate it in full precision.
+class CastCommHook : public EagerCommHook {
+ public:
+  explicit CastCommHook(phi::DataType comm_dtype);
+
+  std::shared_ptr<ProcessGroup::Task> AllReduce(ProcessGroup *process_group,
+                                                EagerGroup *group,
+                                                size_t group_index) override;
+  void Finalize(ProcessGroup *process_group,
+                EagerGroup *group,
+                size_t group_index) override;
+
+ private:
+  phi::DataType comm_dtype_;
+  // the cast buffers in flight by group
+  std::unordered_map<size_t, Tensor> buffers_;
+};
+
+// PowerSGD, Vogels et al. 2019: the buffer M of a group, padded to a
+// square matrix, is all-reduced as the rank r factors P = M Q and
+// Q = M^T orth(P) and approximated by orth(P) Q^T. The approximation error
+// is added to M of the next step (error feedback), and Q is reused as the
+// warm start of the next step. The first start_step steps of every group
+// are all-reduced uncompressed.
+class PowerSGDCommHook : public EagerCommHook {
+ public:
+  PowerSGDCommHook(int64_t matrix_approximation_rank, int64_t start_step);
+
+  std::shared_ptr<ProcessGroup::Task> AllReduce(ProcessGroup *process_group,
+                                                EagerGroup *group,
+                                                size_t group_index) override;
+  void Finalize(ProcessGroup *process_group,
+                EagerGroup *group,
+                size_t group_index) override;
+
+ private:
+  struct State {
+    int64_t length = 0;
+    int64_t side = 0;
+    int64_t steps = 0;
+    bool compressed = false;
+    Tensor q;
+    Tensor error;
+    // of the step in flight, in FLOAT32
+    Tensor m;
+    Tensor p;
+  };
+
+  int64_t matrix_approximation_rank_;
+  int64_t start_step_;
+  std::unordered_map<size_t, State> states_;
+};
+
+// type is "fp16", "bf16" or "powersgd", the last two arguments are only
+// used by "powersgd"
+std::shared_ptr<EagerCommHook> CreateEagerCommHook(
+    const std::string &type,
+    int64_t matrix_approximation_rank,
+    int64_t start_step);
+
+}  //  namespace distributed
+}  //  namespace paddle
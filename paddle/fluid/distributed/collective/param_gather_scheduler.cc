@@ -0,0 +1,109 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/collective/param_gather_scheduler.h"
+
+#include "glog/logging.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace distributed {
+
+ParamGatherScheduler::ParamGatherScheduler(int64_t prefetch_layers,
+                                           int64_t memory_budget)
+    : prefetch_layers_(prefetch_layers), memory_budget_(memory_budget) {
+  PADDLE_ENFORCE_GE(prefetch_layers,
+                    0,
+                    phi::errors::InvalidArgument(
+                        "The number of prefetched layers should be "
+                        "non-negative, but got %d.",
+                        prefetch_layers));
+  PADDLE_ENFORCE_GE(
+      memory_budget,
+      0,
+      phi::errors::InvalidArgument(
+          "The memory budget should be non-negative, but got %d.",
+          memory_budget));
+}
+
+void ParamGatherScheduler::RecordLayer(int64_t layer_id,
+                                       int64_t gather_bytes) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (position_.count(layer_id)) return;
+  position_[layer_id] = order_.size();
+  order_.push_back(layer_id);
+  gather_bytes_[layer_id] = gather_bytes;
+  VLOG(4) << "Record layer " << layer_id << " at " << order_.size() - 1
+          << ", gathers " << gather_bytes << " bytes";
+}
+
+bool ParamGatherScheduler::HasLayer(int64_t layer_id) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return position_.count(layer_id) > 0;
+}
+
+void ParamGatherScheduler::MarkGathered(int64_t layer_id) {
+  if (gathered_.insert(layer_id).second) {
+    gathered_bytes_ += gather_bytes_[layer_id];
+  }
+}
+
+std::vector<int64_t> ParamGatherScheduler::Schedule(int64_t layer_id,
+                                                    bool forward) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::vector<int64_t> prefetch;
+  auto it = position_.find(layer_id);
+  if (it == position_.end()) return prefetch;
+  // the running layer is gathered whatever the budget
+  MarkGathered(layer_id);
+
+  int64_t pos = static_cast<int64_t>(it->second);
+  for (int64_t k = 1; k <= prefetch_layers_; ++k) {
+    int64_t next = forward ? pos + k : pos - k;
+    if (next < 0 || next >= static_cast<int64_t>(order_.size())) break;
+    int64_t next_id = order_[next];
+    if (gathered_.count(next_id)) continue;
+    // keep the order, a later layer never overtakes a closer one
+    if (memory_budget_ > 0 &&
+        gathered_bytes_ + gather_bytes_[next_id] > memory_budget_) {
+      break;
+    }
+    MarkGathered(next_id);
+    prefetch.push_back(next_id);
+  }
+  VLOG(6) << "Layer " << layer_id << " prefetches " << prefetch.size()
+          << " layers, " << gathered_bytes_ << " bytes gathered";
+  return prefetch;
+}
+
+void ParamGatherScheduler::Release(int64_t layer_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (gathered_.erase(layer_id)) {
+    gathered_bytes_ -= gather_bytes_[layer_id];
+  }
+}
+
+void ParamGatherScheduler::Reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  gathered_.clear();
+  gathered_bytes_ = 0;
+}
+
+int64_t ParamGatherScheduler::GatheredBytes() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return gathered_bytes_;
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,68 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+// ParamGatherScheduler plans the parameter all-gathers of group sharded
+// stage 3.
+//
+// The layers are recorded in the order of the forward of the first step.
+// From then on, Schedule marks the running layer gathered and returns the
+// next layers whose all-gathers to start now: up to prefetch_layers layers
+// ahead, forward in the forward pass and backward in the backward pass, as
+// long as the gathered params stay in memory_budget bytes (0 for no limit).
+// The caller issues these all-gathers on the comm stream and calls Release
+// once the full params of a layer are freed again.
+class ParamGatherScheduler {
+ public:
+  ParamGatherScheduler(int64_t prefetch_layers, int64_t memory_budget);
+
+  // Append the layer to the execution order, if it is not in it yet.
+  void RecordLayer(int64_t layer_id, int64_t gather_bytes);
+
+  bool HasLayer(int64_t layer_id) const;
+
+  std::vector<int64_t> Schedule(int64_t layer_id, bool forward);
+
+  void Release(int64_t layer_id);
+
+  // Forget the gathered layers, at the beginning of a step.
+  void Reset();
+
+  int64_t GatheredBytes() const;
+
+ private:
+  void MarkGathered(int64_t layer_id);
+
+  int64_t prefetch_layers_;
+  int64_t memory_budget_;
+  std::vector<int64_t> order_;
+  std::unordered_map<int64_t, size_t> position_;
+  std::unordered_map<int64_t, int64_t> gather_bytes_;
+  std::unordered_set<int64_t> gathered_;
+  int64_t gathered_bytes_{0};
+  mutable std::mutex mutex_;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -13,6 +13,12 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/collective/process_group_nccl.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/collective/common.h"
 #include "paddle/fluid/platform/cuda_device_guard.h"
@@ -54,6 +60,68 @@ using phi::distributed::ToNCCLRedType;
 
 uint64_t ProcessGroupNCCL::s_group_call_counter = 0;
 
+namespace {
+
+constexpr size_t kMaxHierarchicalTimersInFlight = 64;
+
+std::array<gpuEvent_t, 4> CreateTimer() {
+  std::array<gpuEvent_t, 4> timer;
+  for (auto& event : timer) {
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventCreate(&event));
+#else  // PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventCreate(&event));
+#endif
+  }
+  return timer;
+}
+
+void DestroyTimer(const std::array<gpuEvent_t, 4>& timer) {
+  for (auto event : timer) {
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(event));
+#else  // PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventDestroy(event));
+#endif
+  }
+}
+
+void RecordEvent(gpuEvent_t event, gpuStream_t stream) {
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+#else  // PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, stream));
+#endif
+}
+
+bool EventCompleted(gpuEvent_t event, bool wait) {
+#ifdef PADDLE_WITH_CUDA
+  if (wait) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event));
+    return true;
+  }
+  return cudaEventQuery(event) == cudaSuccess;
+#else  // PADDLE_WITH_HIP
+  if (wait) {
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event));
+    return true;
+  }
+  return hipEventQuery(event) == hipSuccess;
+#endif
+}
+
+double ElapsedMs(gpuEvent_t start, gpuEvent_t end) {
+  float ms = 0;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventElapsedTime(&ms, start, end));
+#else  // PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventElapsedTime(&ms, start, end));
+#endif
+  return ms;
+}
+
+}  // namespace
+
 ProcessGroupNCCL::NCCLTask::NCCLTask(const Place& place,
                                      int rank,
                                      CommType comm_type,
@@ -135,6 +203,10 @@ ProcessGroupNCCL::ProcessGroupNCCL(
 }
 ProcessGroupNCCL::~ProcessGroupNCCL() {
   LOG(INFO) << "ProcessGroupNCCL destruct ";
+  CollectHierarchicalTimers(/*wait*/ true);
+  for (const auto& timer : free_hierarchical_timers_) {
+    DestroyTimer(timer);
+  }
   if (FLAGS_enable_async_trace) {
     auto& comm_task_manager = phi::distributed::CommTaskManager::GetInstance();
     comm_task_manager.Stop();
@@ -160,6 +232,47 @@ void ProcessGroupNCCL::GroupEnd() {
   }
 }
 
+void ProcessGroupNCCL::StartCoalescing() {
+  PADDLE_ENFORCE_EQ(is_coalescing_,
+                    false,
+                    phi::errors::PreconditionNotMet(
+                        "ProcessGroupNCCL is already coalescing collectives, "
+                        "EndCoalescing should be called first."));
+  is_coalescing_ = true;
+  GroupStart();
+}
+
+std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::EndCoalescing() {
+  PADDLE_ENFORCE_EQ(is_coalescing_,
+                    true,
+                    phi::errors::PreconditionNotMet(
+                        "ProcessGroupNCCL is not coalescing collectives, "
+                        "StartCoalescing should be called first."));
+  is_coalescing_ = false;
+  auto task = std::move(coalesced_task_);
+  coalesced_task_ = nullptr;
+  if (task == nullptr) {
+    GroupEnd();
+    return nullptr;
+  }
+
+  platform::CUDADeviceGuard cuda_guard(coalescing_place_);
+  const auto& key = GetKeyFromPlace(coalescing_place_);
+  // NCCL enqueues the grouped collectives here, after the work the calc
+  // stream queued for their inputs during the window
+  if (!coalescing_use_calc_stream_) {
+    SyncCalcStream(coalescing_place_, key);
+  }
+  GroupEnd();
+  if (!coalescing_use_calc_stream_) {
+    task->UpdateWaitChain(*place_to_comm_ctx_.at(key));
+  }
+  VLOG(3) << "End coalescing " << coalesced_tensors_.size()
+          << " collective(s), " << GetGroupMessage();
+  coalesced_tensors_.clear();
+  return task;
+}
+
 phi::DeviceContext* ProcessGroupNCCL::GetDeviceContext(
     const Place& place) const {
   return GetDeviceContext(place, /*use_calc_stream*/ false);
@@ -238,6 +351,16 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllReduce(
     bool use_calc_stream) {
   auto tensor_tmp =
       paddle::experimental::CheckAndTrans2NewContiguousTensor(in_tensor);
+  // not within the groups of batch_isend_irecv or a coalescing window, which
+  // would launch the stages concurrently
+  const HierarchicalComms* hierarchical_comms = nullptr;
+  if (opts.hierarchical && s_group_call_counter == 0) {
+    hierarchical_comms = GetHierarchicalComms(tensor_tmp.place());
+    if (hierarchical_comms != nullptr &&
+        tensor_tmp.numel() % hierarchical_comms->local_size != 0) {
+      hierarchical_comms = nullptr;
+    }
+  }
   return Collective(
       [&](phi::distributed::NCCLCommContext* comm_context, gpuStream_t stream) {
         VLOG(3) << "[ncclAllReduce] "
@@ -251,8 +374,14 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllReduce(
                 << ", stream: " << stream << ", rank_in_group: " << rank_
                 << ", nranks: " << size_ << ", sync_op: " << sync_op
                 << ", use_calc_stream: " << use_calc_stream
+                << ", hierarchical: " << (hierarchical_comms != nullptr)
                 << GetGroupMessage();
 
+        if (hierarchical_comms != nullptr) {
+          HierarchicalAllReduce(
+              out_tensor, tensor_tmp, opts, *hierarchical_comms, stream);
+          return;
+        }
         comm_context->AllReduce(
             out_tensor, tensor_tmp, ToNCCLRedType(opts.reduce_op), stream);
       },
@@ -817,6 +946,17 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
 
   platform::CUDADeviceGuard cuda_guard(place);
 
+  if (is_coalescing_ && coalesced_task_ != nullptr) {
+    // creating another communicator would launch the grouped collectives
+    PADDLE_ENFORCE_EQ(place,
+                      coalescing_place_,
+                      phi::errors::InvalidArgument(
+                          "The collectives coalesced by ProcessGroupNCCL "
+                          "should be on the same place, %s, but got %s.",
+                          coalescing_place_,
+                          place));
+  }
+
   std::string store_key;
   GetStoreKey(key, comm_type, &store_key);
 
@@ -824,6 +964,11 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
     CreateNCCLEnvCache(place, key, store_key, comm_type);
   }
 
+  if (is_coalescing_) {
+    return CoalesceCollective(
+        fn, tensor_tmp, store_key, comm_type, sync_op, use_calc_stream);
+  }
+
   if (!use_calc_stream) {
     SyncCalcStream(place, key);
   }
@@ -856,6 +1001,8 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
                                                          nccl_stream,
                                                          comm_type,
                                                          pg_timeout_);
+    comm_task->SetBytes(tensor_tmp.numel() *
+                        phi::SizeOf(tensor_tmp.dtype()));
     comm_task->StartRecord();
     fn(nccl_comm_ctx, nccl_stream);
     comm_task->EndRecord();
@@ -894,6 +1041,51 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
   return task;
 }
 
+std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::CoalesceCollective(
+    std::function<void(phi::distributed::NCCLCommContext*, gpuStream_t)> fn,
+    const phi::DenseTensor& tensor,
+    const std::string& store_key,
+    CommType comm_type,
+    bool sync_op,
+    bool use_calc_stream) {
+  PADDLE_ENFORCE_EQ(sync_op,
+                    false,
+                    phi::errors::InvalidArgument(
+                        "The collectives coalesced by ProcessGroupNCCL should "
+                        "be asynchronous, sync_op should be false."));
+  const auto& place = tensor.place();
+  if (coalesced_task_ == nullptr) {
+    coalescing_place_ = place;
+    coalescing_use_calc_stream_ = use_calc_stream;
+    coalesced_task_ = CreateTask(
+        place, rank_, comm_type, /*sync_op*/ false, use_calc_stream, gid_);
+  } else {
+    PADDLE_ENFORCE_EQ(use_calc_stream,
+                      coalescing_use_calc_stream_,
+                      phi::errors::InvalidArgument(
+                          "The collectives coalesced by ProcessGroupNCCL "
+                          "should all use the calc stream or none of them."));
+  }
+
+  const auto& key = GetKeyFromPlace(place);
+  const auto* calc_ctx = place_to_calc_ctx_.at(key);
+  const auto& comm_ctx = place_to_comm_ctx_.at(key);
+  auto nccl_stream = use_calc_stream ? calc_ctx->stream() : comm_ctx->stream();
+  // not traced by FLAGS_enable_async_trace, the group is launched later
+  fn(this->GetCommContext(&store_key), nccl_stream);
+
+  if (!use_calc_stream) {
+    if (FLAGS_use_stream_safe_cuda_allocator ||
+        FLAGS_use_cuda_malloc_async_allocator) {
+      memory::RecordStream(tensor.Holder(), nccl_stream);
+    }
+    allocation_stream_pairs.emplace_back(tensor.Holder(), nccl_stream);
+  }
+  // kept alive until the group is launched
+  coalesced_tensors_.push_back(tensor);
+  return coalesced_task_;
+}
+
 std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Point2Point(
     std::function<void(phi::distributed::NCCLCommContext*, gpuStream_t, int)>
         fn,
@@ -972,6 +1164,8 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Point2Point(
   if (!FLAGS_enable_async_trace) {
     fn(nccl_comm_ctx, nccl_stream, p2p_target_rank);
   } else {
+    comm_task->SetBytes(tensor_tmp.numel() *
+                        phi::SizeOf(tensor_tmp.dtype()));
     comm_task->StartRecord();
     fn(nccl_comm_ctx, nccl_stream, p2p_target_rank);
     comm_task->EndRecord();
@@ -1023,6 +1217,157 @@ std::shared_ptr<ProcessGroupNCCL> ProcessGroupNCCL::CreateProcessGroupNCCL(
   return process_group;
 }
 
+const ProcessGroupNCCL::HierarchicalComms*
+ProcessGroupNCCL::GetHierarchicalComms(const Place& place) {
+  if (hierarchical_comms_initialized_) {
+    return hierarchical_comms_.get();
+  }
+  hierarchical_comms_initialized_ = true;
+
+  // the nodes are told apart by the host names, in the order of their first
+  // rank in the group
+  char hostname[256] = {0};
+  gethostname(hostname, sizeof(hostname) - 1);
+  const std::string prefix =
+      "hierarchical_allreduce/" + std::to_string(gid_) + "/";
+  store_->set(prefix + std::to_string(rank_),
+              std::vector<uint8_t>(hostname, hostname + strlen(hostname)));
+  std::vector<std::string> keys;
+  for (int rank = 0; rank < size_; ++rank) {
+    keys.push_back(prefix + std::to_string(rank));
+  }
+  const auto hosts = store_->multi_get(keys);
+  std::vector<std::string> nodes;
+  std::vector<std::vector<int>> node_ranks;
+  int node = -1;
+  for (int rank = 0; rank < size_; ++rank) {
+    std::string name(hosts[rank].begin(), hosts[rank].end());
+    auto iter = std::find(nodes.begin(), nodes.end(), name);
+    if (iter == nodes.end()) {
+      nodes.push_back(name);
+      node_ranks.emplace_back();
+      iter = nodes.end() - 1;
+    }
+    int index = static_cast<int>(iter - nodes.begin());
+    node_ranks[index].push_back(rank);
+    if (rank == rank_) {
+      node = index;
+    }
+  }
+
+  int local_size = static_cast<int>(node_ranks[0].size());
+  bool balanced = std::all_of(
+      node_ranks.begin(), node_ranks.end(), [&](const std::vector<int>& r) {
+        return static_cast<int>(r.size()) == local_size;
+      });
+  if (nodes.size() < 2 || local_size < 2 || !balanced) {
+    LOG(WARNING) << "The hierarchical all-reduce needs several nodes with the "
+                    "same number of ranks, but got "
+                 << nodes.size() << " node(s) for " << size_
+                 << " rank(s), fall back to the flat all-reduce, "
+                 << GetGroupMessage();
+    return nullptr;
+  }
+  const auto& ranks = node_ranks[node];
+  int local_rank =
+      static_cast<int>(std::find(ranks.begin(), ranks.end(), rank_) -
+                       ranks.begin());
+
+  auto comms = std::make_unique<HierarchicalComms>();
+  const std::string key_prefix = "nccl_ids/" + std::to_string(gid_) + "/";
+  comms->inner_key = key_prefix + "hierarchical_inner/" + std::to_string(node);
+  comms->outer_key =
+      key_prefix + "hierarchical_outer/" + std::to_string(local_rank);
+  comms->local_size = local_size;
+
+  platform::CUDADeviceGuard cuda_guard(place);
+  phi::distributed::CommContextManager::CreateNCCLCommContext(
+      store_,
+      comms->inner_key,
+      local_rank,
+      local_size,
+      "",
+      nullptr,
+      nccl_comm_init_option_);
+  phi::distributed::CommContextManager::CreateNCCLCommContext(
+      store_,
+      comms->outer_key,
+      node,
+      static_cast<int>(nodes.size()),
+      "",
+      nullptr,
+      nccl_comm_init_option_);
+  VLOG(3) << "Create the hierarchical all-reduce communicators of node "
+          << node << " and local rank " << local_rank << " of "
+          << nodes.size() << " node(s), " << GetGroupMessage();
+  hierarchical_comms_ = std::move(comms);
+  return hierarchical_comms_.get();
+}
+
+void ProcessGroupNCCL::HierarchicalAllReduce(phi::DenseTensor* out_tensor,
+                                             const phi::DenseTensor& in_tensor,
+                                             const AllreduceOptions& opts,
+                                             const HierarchicalComms& comms,
+                                             gpuStream_t stream) {
+  auto* inner_comm = GetCommContext(&comms.inner_key);
+  auto* outer_comm = GetCommContext(&comms.outer_key);
+  auto reduce_type = ToNCCLRedType(opts.reduce_op);
+
+  // the shard of the node reduced by this rank, allocated on the calc stream
+  // the comm stream waited for
+  phi::DenseTensor shard;
+  shard.Resize(common::make_ddim({in_tensor.numel() / comms.local_size}));
+  const auto* calc_ctx =
+      place_to_calc_ctx_.at(GetKeyFromPlace(in_tensor.place()));
+  calc_ctx->Alloc(&shard, in_tensor.dtype());
+
+  CollectHierarchicalTimers(
+      /*wait*/ hierarchical_timers_.size() >= kMaxHierarchicalTimersInFlight);
+  std::array<gpuEvent_t, 4> timer;
+  if (free_hierarchical_timers_.empty()) {
+    timer = CreateTimer();
+  } else {
+    timer = free_hierarchical_timers_.back();
+    free_hierarchical_timers_.pop_back();
+  }
+
+  RecordEvent(timer[0], stream);
+  inner_comm->ReduceScatter(&shard, in_tensor, reduce_type, stream);
+  RecordEvent(timer[1], stream);
+  outer_comm->AllReduce(&shard, shard, reduce_type, stream);
+  RecordEvent(timer[2], stream);
+  inner_comm->AllGather(out_tensor, shard, stream);
+  RecordEvent(timer[3], stream);
+  hierarchical_timers_.push_back(timer);
+
+  if (FLAGS_use_stream_safe_cuda_allocator ||
+      FLAGS_use_cuda_malloc_async_allocator) {
+    memory::RecordStream(shard.Holder(), stream);
+  }
+}
+
+void ProcessGroupNCCL::CollectHierarchicalTimers(bool wait) {
+  while (!hierarchical_timers_.empty()) {
+    const auto& timer = hierarchical_timers_.front();
+    // the stages run in order on one stream, and so are the timers
+    if (!EventCompleted(timer[3], wait)) {
+      break;
+    }
+    ++hierarchical_stats_.count;
+    hierarchical_stats_.reduce_scatter_ms += ElapsedMs(timer[0], timer[1]);
+    hierarchical_stats_.all_reduce_ms += ElapsedMs(timer[1], timer[2]);
+    hierarchical_stats_.all_gather_ms += ElapsedMs(timer[2], timer[3]);
+    free_hierarchical_timers_.push_back(timer);
+    hierarchical_timers_.pop_front();
+  }
+}
+
+ProcessGroupNCCL::HierarchicalAllReduceStats
+ProcessGroupNCCL::GetHierarchicalAllReduceStats() {
+  CollectHierarchicalTimers(/*wait*/ true);
+  return hierarchical_stats_;
+}
+
 phi::distributed::NCCLCommContext* ProcessGroupNCCL::GetCommContext(
     const std::string* key) {
   std::string store_key = std::to_string(this->gid_);
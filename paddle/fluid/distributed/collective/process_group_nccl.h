@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -24,6 +26,7 @@
 #include "paddle/fluid/distributed/collective/process_group_with_stream.h"
 #include "paddle/fluid/platform/device_event.h"
 #include "paddle/phi/backends/gpu/forwards.h"
+#include "paddle/phi/backends/gpu/gpu_decls.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/device_context.h"
 #include "paddle/phi/core/distributed/nccl_comm_context.h"
@@ -177,6 +180,29 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
 
   static void GroupEnd();
 
+  // The asynchronous collectives issued until EndCoalescing, on one place
+  // and one stream, are launched as a single NCCL group after a single wait
+  // for the calc stream. They return the same task, which only completes
+  // once EndCoalescing returns it, so callers wait once for all of them.
+  void StartCoalescing();
+
+  // nullptr if no collective was issued since StartCoalescing
+  std::shared_ptr<ProcessGroup::Task> EndCoalescing();
+
+  bool IsCoalescing() const { return is_coalescing_; }
+
+  // The time the stages of the hierarchical all-reduces took on the GPU, see
+  // AllreduceOptions::hierarchical, accumulated over the ones issued so far.
+  struct HierarchicalAllReduceStats {
+    int64_t count = 0;
+    double reduce_scatter_ms = 0;
+    double all_reduce_ms = 0;
+    double all_gather_ms = 0;
+  };
+
+  // waits for the hierarchical all-reduces in flight
+  HierarchicalAllReduceStats GetHierarchicalAllReduceStats();
+
   ncclComm_t NCCLComm(const Place& place) const;
 
   const bool GetNCCLCommInitOption() { return nccl_comm_init_option_; }
@@ -208,6 +234,35 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
       bool sync_op,
       bool use_calc_stream);
 
+  // the sub-communicators of the hierarchical all-reduce
+  struct HierarchicalComms {
+    // of the ranks on the same node
+    std::string inner_key;
+    // of the ranks with the same local rank on all the nodes
+    std::string outer_key;
+    int local_size = 0;
+  };
+
+  // nullptr if the group spans a single node, or the nodes do not have the
+  // same number of ranks
+  const HierarchicalComms* GetHierarchicalComms(const Place& place);
+
+  void HierarchicalAllReduce(phi::DenseTensor* out_tensor,
+                             const phi::DenseTensor& in_tensor,
+                             const AllreduceOptions& opts,
+                             const HierarchicalComms& comms,
+                             gpuStream_t stream);
+
+  void CollectHierarchicalTimers(bool wait);
+
+  std::shared_ptr<ProcessGroup::Task> CoalesceCollective(
+      std::function<void(phi::distributed::NCCLCommContext*, gpuStream_t)> fn,
+      const phi::DenseTensor& tensor,
+      const std::string& store_key,
+      CommType comm_type,
+      bool sync_op,
+      bool use_calc_stream);
+
   std::shared_ptr<ProcessGroup::Task> Point2Point(
       std::function<void(phi::distributed::NCCLCommContext*, gpuStream_t, int)>
           fn,
@@ -256,6 +311,20 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
   // optimize memory for process_group
   std::vector<std::pair<std::weak_ptr<phi::Allocation>, gpuStream_t>>
       allocation_stream_pairs;
+
+  // the collectives in flight between StartCoalescing and EndCoalescing
+  bool is_coalescing_{false};
+  Place coalescing_place_;
+  bool coalescing_use_calc_stream_{false};
+  std::shared_ptr<ProcessGroupNCCL::NCCLTask> coalesced_task_;
+  std::vector<phi::DenseTensor> coalesced_tensors_;
+
+  bool hierarchical_comms_initialized_{false};
+  std::unique_ptr<HierarchicalComms> hierarchical_comms_;
+  // the events around the stages of the hierarchical all-reduces in flight
+  std::deque<std::array<gpuEvent_t, 4>> hierarchical_timers_;
+  std::vector<std::array<gpuEvent_t, 4>> free_hierarchical_timers_;
+  HierarchicalAllReduceStats hierarchical_stats_;
 };
 
 }  //  namespace distributed
@@ -13,19 +13,29 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/collective/reducer.h"
+
+#include <algorithm>
+#include <numeric>
+
 #include "paddle/common/flags.h"
 #include "paddle/phi/api/lib/data_transform.h"
 #include "paddle/phi/backends/device_guard.h"
 #include "paddle/phi/backends/device_manager.h"
+#include "paddle/phi/core/tensor_utils.h"
 
 PD_DECLARE_bool(use_stream_safe_cuda_allocator);
 COMMON_DECLARE_string(allocator_strategy);
+COMMON_DECLARE_int32(eager_reducer_rebuild_group_steps);
+COMMON_DECLARE_bool(eager_reducer_grad_as_bucket_view);
+COMMON_DECLARE_string(eager_reducer_sparse_allreduce);
+COMMON_DECLARE_double(eager_reducer_sparse_dense_ratio);
 
 namespace paddle {
 namespace distributed {
 
 static bool IsStreamSafeAllocator() {
-  return (FLAGS_allocator_strategy == "auto_growth" &&
+  return ((FLAGS_allocator_strategy == "auto_growth" ||
+           FLAGS_allocator_strategy == "size_class") &&
           FLAGS_use_stream_safe_cuda_allocator);
 }
 
@@ -496,6 +506,7 @@ EagerReducer::EagerReducer(
   VLOG(3) << "Start construct the Reducer ...";
 
   nranks_ = process_group_->GetSize();
+  grad_as_bucket_view_ = FLAGS_eager_reducer_grad_as_bucket_view;
 
   // initialize groups
   InitializeGroups(group_indices);
@@ -522,6 +533,7 @@ EagerReducer::EagerReducer(
 
   vars_marked_ready_.resize(tensors_.size(), false);
   local_used_vars_.resize(tensors_.size(), 0);
+  ready_position_sums_.resize(tensors_.size(), 0);
 
   if (find_unused_vars_each_step_) {
     global_used_vars_ = paddle::experimental::empty(
@@ -571,6 +583,9 @@ void EagerReducer::InitializeGroups(
     } else {
       // process the dense gradient.
       InitializeDenseGroups(tensor_indices_, &group);
+      if (grad_as_bucket_view_) {
+        InitializeBucketView(&group);
+      }
     }
 
     // map tensors to this group by VariableLocator
@@ -637,6 +652,19 @@ void EagerReducer::InitializeDenseGroups(
   p_group->all_length_ = all_length;
 }
 
+void EagerReducer::InitializeBucketView(EagerGroup *p_group) {
+  p_group->bucket_ = paddle::experimental::empty(
+      IntArray({p_group->all_length_}), p_group->dtype_, inner_place_);
+  auto bucket =
+      std::dynamic_pointer_cast<phi::DenseTensor>(p_group->bucket_.impl());
+  int64_t offset = 0;
+  for (size_t index = 0; index < p_group->length_.size(); ++index) {
+    p_group->dense_tensors_[index] =
+        bucket->Slice(offset, offset + p_group->length_[index]);
+    offset += p_group->length_[index];
+  }
+}
+
 void EagerReducer::TraverseBackwardGraph(const std::vector<Tensor> &outputs) {
   std::queue<egr::GradNodeBase *> queue;
   std::set<egr::GradNodeBase *> visited;
@@ -699,6 +727,7 @@ void EagerReducer::PrepareForBackward(const std::vector<Tensor> &outputs) {
   // reinitialize vars_marked_ready_ for next iteration
   vars_marked_ready_.clear();
   vars_marked_ready_.resize(tensors_.size(), false);
+  ready_count_ = 0;
 
   PADDLE_ENFORCE_EQ(
       groups_need_finalize_,
@@ -757,6 +786,10 @@ void EagerReducer::AddDistHook(size_t var_index) {
                         var_index));
 
   // gradient synchronization is not required when grad_need_hooks_ is false.
+  // The grads that are bucket views keep accumulating in place.
+  if (!grad_need_hooks_ && grad_as_bucket_view_) {
+    return;
+  }
   if (!grad_need_hooks_) {
     const auto &var_locator = variable_locators_[var_index];
     const auto group_index = var_locator.group_index;
@@ -828,6 +861,9 @@ void EagerReducer::MarkVarReady(const size_t var_index,
                       platform::errors::PreconditionNotMet(error_info));
   } else {
     vars_marked_ready_[var_index] = true;
+    if (NeedRebuildGroups()) {
+      ready_position_sums_[var_index] += ready_count_++;
+    }
   }
   groups_need_finalize_ = true;
 
@@ -837,7 +873,9 @@ void EagerReducer::MarkVarReady(const size_t var_index,
 
   auto &group = groups_[group_index];
 
-  if (!group.is_sparse_) {
+  if (!group.is_sparse_ && grad_as_bucket_view_) {
+    CopyGradToBucketView(var_index, &group, inside_group_index, is_used_var);
+  } else if (!group.is_sparse_) {
     auto &group_tensor = group.dense_tensors_[inside_group_index];
     const auto length = group.length_[inside_group_index];
     if (is_used_var) {
@@ -949,6 +987,44 @@ void EagerReducer::MarkVarReady(const size_t var_index,
   }
 }
 
+void EagerReducer::CopyGradToBucketView(const size_t var_index,
+                                        EagerGroup *group,
+                                        const size_t inside_group_index,
+                                        const bool is_used_var) {
+  auto &view = group->dense_tensors_[inside_group_index];
+  auto *dev_ctx = platform::DeviceContextPool::Instance().Get(inner_place_);
+  if (!HasGrad(var_index)) {
+    VLOG(3) << "Tensor[" << tensors_[var_index].name()
+            << "] doesn't have grad";
+    phi::funcs::set_constant(*dev_ctx, &view, 0.0f);
+    return;
+  }
+  auto *grad_tensor = egr::EagerUtils::mutable_grad(tensors_[var_index]);
+  auto grad_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(grad_tensor->impl());
+  if (grad_dense->Holder() == view.Holder() &&
+      grad_dense->meta().offset == view.meta().offset) {
+    VLOG(3) << "Tensor[" << tensors_[var_index].name()
+            << "] is accumulated in its bucket";
+    return;
+  }
+
+  // The first grad after the grads are cleared, or a grad of unused var from
+  // the steps before.
+  phi::DenseTensor src =
+      grad_dense->meta().is_contiguous()
+          ? *grad_dense
+          : paddle::experimental::Trans2Contiguous(*grad_dense);
+  phi::DenseTensor dst = view;
+  phi::Copy(*dev_ctx, src, inner_place_, false, &dst);
+  if (is_used_var) {
+    // the next grads accumulate in the bucket
+    auto grad_view = std::make_shared<phi::DenseTensor>(view);
+    grad_view->Resize(grad_dense->dims());
+    grad_tensor->set_impl(grad_view);
+  }
+}
+
 void EagerReducer::MarkGroupReady(size_t group_index) {
   VLOG(3) << "Group[" << group_index << "] is ready";
 
@@ -1063,10 +1139,20 @@ void EagerReducer::ProcessUnusedDenseVars() {
 void EagerReducer::FinalizeBackward() {
   groups_need_finalize_ = false;
   grad_need_hooks_ = false;
-  for (auto &group : groups_) {
+  for (size_t group_index = 0; group_index < groups_.size(); ++group_index) {
+    auto &group = groups_[group_index];
     if (!group.is_sparse_) {
       group.task->Synchronize();
-      if (!IsStreamSafeAllocator()) {
+      if (comm_hook_) {
+        comm_hook_->Finalize(process_group_.get(), &group, group_index);
+      }
+      // the grads that are views of the bucket only need the result of a
+      // comm hook that is not in the bucket
+      bool need_split =
+          grad_as_bucket_view_
+              ? group.dense_contents_.impl() != group.bucket_.impl()
+              : comm_hook_ || !IsStreamSafeAllocator();
+      if (need_split) {
         auto *default_ctx =
             platform::DeviceContextPool::Instance().Get(inner_place_);
         group.SplitTensors(*default_ctx);
@@ -1081,9 +1167,71 @@ void EagerReducer::FinalizeBackward() {
     VLOG(3) << "ProcessUnusedDenseVars is finished.";
   }
 
+  if (NeedRebuildGroups() &&
+      ++recorded_steps_ >= FLAGS_eager_reducer_rebuild_group_steps) {
+    RebuildGroups();
+  }
+
   VLOG(3) << "In the batch, Reducer is finished.";
 }
 
+void EagerReducer::SetCommHook(std::shared_ptr<EagerCommHook> comm_hook) {
+  PADDLE_ENFORCE_EQ(groups_need_finalize_,
+                    false,
+                    platform::errors::PreconditionNotMet(
+                        "The comm hook can not be set during backward."));
+  comm_hook_ = std::move(comm_hook);
+}
+
+bool EagerReducer::NeedRebuildGroups() const {
+  // the ready order changes between the steps with unused vars
+  return !has_rebuilt_groups_ && !find_unused_vars_each_step_ &&
+         FLAGS_eager_reducer_rebuild_group_steps > 0;
+}
+
+void EagerReducer::RebuildGroups() {
+  has_rebuilt_groups_ = true;
+  std::vector<int64_t> ready_order(tensors_.size());
+  std::iota(ready_order.begin(), ready_order.end(), 0);
+  std::stable_sort(ready_order.begin(),
+                   ready_order.end(),
+                   [this](int64_t x, int64_t y) {
+                     return ready_position_sums_[x] < ready_position_sums_[y];
+                   });
+
+  // The groups are all-reduced one after the other in the same order on all
+  // the ranks, so they all take the ready order of rank 0.
+  const auto *dev_ctx =
+      platform::DeviceContextPool::Instance().Get(inner_place_);
+  phi::DenseTensor order_tensor;
+  framework::TensorFromVector<int64_t>(ready_order, *dev_ctx, &order_tensor);
+  std::vector<phi::DenseTensor> in_out = {order_tensor};
+  distributed::BroadcastOptions opts;
+  opts.source_rank = 0;
+  process_group_->Broadcast(in_out, in_out, opts)->Synchronize();
+  framework::TensorToVector<int64_t>(in_out[0], *dev_ctx, &ready_order);
+  dev_ctx->Wait();
+  VLOG(3) << "The order of grads ready: "
+          << string::join_strings(ready_order, ',');
+
+  // Packed from the last ready grads like the initial groups, which makes
+  // the group all-reduced last take the first group size limit.
+  std::reverse(ready_order.begin(), ready_order.end());
+  std::vector<Tensor> ordered_tensors;
+  ordered_tensors.reserve(tensors_.size());
+  for (auto index : ready_order) {
+    ordered_tensors.push_back(tensors_[index]);
+  }
+  auto group_indices = Eager_AssignGroupBySize(
+      ordered_tensors, is_sparse_gradient_, group_size_limits_, ready_order);
+  std::reverse(group_indices.begin(), group_indices.end());
+
+  group_indices_ = std::move(group_indices);
+  InitializeGroups(group_indices_);
+  ready_position_sums_.clear();
+  VLOG(3) << "The groups are rebuilt by the order of grads ready.";
+}
+
 void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
                                           const int curr_group_index) {
   // The overall timeline: concat > div_nranks > allreduce > split
@@ -1092,13 +1240,25 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
 
   VLOG(3) << "group [" << curr_group_index << "] start fused_allreduce.";
 
-  // concat tensors
-  group->ConcatTensors(inner_place_);
+  if (grad_as_bucket_view_) {
+    // the grads are already in place, and get the result in place
+    group->dense_contents_ = group->bucket_;
+  } else {
+    // concat tensors
+    group->ConcatTensors(inner_place_);
+  }
 
   // div nranks
   paddle::experimental::scale_(
       group->dense_contents_, 1.0 / nranks_, 0.0, false);  // NOLINT
 
+  if (comm_hook_) {
+    // decoded and split at the end of backward
+    group->task = comm_hook_->AllReduce(
+        process_group_.get(), group, static_cast<size_t>(curr_group_index));
+    return;
+  }
+
   // all_reduce
   std::vector<Tensor> reduce_tensors = {group->dense_contents_};
   std::vector<phi::DenseTensor> in_out;
@@ -1110,7 +1270,7 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
 
   auto *context = process_group_->GetDeviceContext(inner_place_);
 
-  if (IsStreamSafeAllocator()) {
+  if (IsStreamSafeAllocator() && !grad_as_bucket_view_) {
     // NOTE(shenliang03): The best_fit allocator strategy is multi-stream
     // insecure. In the Split operator, additional memory will be applied for
     // calculation, and if it is asynchronous, an illegal memory access may be
@@ -1208,6 +1368,22 @@ void EagerReducer::AllReduceSparse(EagerGroup *group,
 
   dev_ctx->Wait();
 
+  // the rows of all the ranks decide alike on every rank
+  if (FLAGS_eager_reducer_sparse_dense_ratio > 0 &&
+      rows_num >= FLAGS_eager_reducer_sparse_dense_ratio * src->height()) {
+    VLOG(3) << "sparse_group [" << curr_group_index
+            << "] is all-reduced as a dense tensor";
+    AllReduceSparseAsDense(src, *dev_ctx);
+    return;
+  }
+  if (FLAGS_eager_reducer_sparse_allreduce == "partition" &&
+      process_group_->GetBackendName() != "GLOO") {
+    VLOG(3) << "sparse_group [" << curr_group_index
+            << "] is all-reduced by the owners of its rows";
+    AllReduceSparseByPartition(src, *dev_ctx);
+    return;
+  }
+
   Tensor src_value_tensor(std::make_shared<phi::DenseTensor>(src->value()));
   std::vector<int64_t> dst_shape = src_value_tensor.shape();
 
@@ -1343,6 +1519,217 @@ void EagerReducer::AllReduceSparse(EagerGroup *group,
   }
 }
 
+void EagerReducer::AllReduceSparseAsDense(
+    const std::shared_ptr<phi::SelectedRows> &src,
+    const platform::DeviceContext &dev_ctx) {
+  Tensor src_value_tensor(std::make_shared<phi::DenseTensor>(src->value()));
+  std::vector<int64_t> dense_shape = src_value_tensor.shape();
+  dense_shape[0] = src->height();
+  Tensor dense_tensor = paddle::experimental::full(
+      IntArray(dense_shape), 0, src_value_tensor.dtype(), inner_place_);
+
+  Tensor rows_tensor = paddle::experimental::empty(
+      IntArray({static_cast<int64_t>(src->rows().size())}),
+      DataType::INT64,
+      inner_place_);
+  framework::TensorFromVector<int64_t>(
+      src->rows(),
+      dev_ctx,
+      std::dynamic_pointer_cast<phi::DenseTensor>(rows_tensor.impl()).get());
+  // the duplicate rows are accumulated
+  paddle::experimental::index_add_(
+      dense_tensor, rows_tensor, src_value_tensor, 0);
+
+  distributed::AllreduceOptions opts;
+  opts.reduce_op = ReduceOp::SUM;
+  std::vector<phi::DenseTensor> in_out = {
+      *std::dynamic_pointer_cast<phi::DenseTensor>(dense_tensor.impl())};
+  process_group_->AllReduce(in_out, in_out, opts)->Synchronize();
+
+  std::vector<int64_t> all_rows(src->height());
+  std::iota(all_rows.begin(), all_rows.end(), 0);
+  src->set_rows(all_rows);
+  *(src->mutable_value()) =
+      *(std::dynamic_pointer_cast<phi::DenseTensor>(dense_tensor.impl()));
+}
+
+void EagerReducer::AllReduceSparseByPartition(
+    const std::shared_ptr<phi::SelectedRows> &src,
+    const platform::DeviceContext &dev_ctx) {
+  const int size = process_group_->GetSize();
+  const int64_t height = src->height();
+
+  // merge_selected_rows sorts the rows, so the rows owned by each rank are
+  // contiguous
+  Tensor merged_tensor = paddle::experimental::merge_selected_rows(Tensor(src));
+  auto merged =
+      std::dynamic_pointer_cast<phi::SelectedRows>(merged_tensor.impl());
+  const auto &merged_rows = merged->rows();
+  const int64_t rows_per_rank = (height + size - 1) / size;
+  std::vector<int64_t> send_sizes(size);
+  for (int i = 0; i < size; ++i) {
+    auto begin = std::lower_bound(
+        merged_rows.begin(), merged_rows.end(), i * rows_per_rank);
+    auto end = std::lower_bound(
+        merged_rows.begin(), merged_rows.end(), (i + 1) * rows_per_rank);
+    send_sizes[i] = end - begin;
+  }
+
+  // exchange the numbers of rows each rank sends to each other
+  std::vector<int64_t> ones(size, 1);
+  Tensor send_sizes_tensor = paddle::experimental::empty(
+      IntArray({static_cast<int64_t>(size)}), DataType::INT64, inner_place_);
+  Tensor recv_sizes_tensor = paddle::experimental::empty(
+      IntArray({static_cast<int64_t>(size)}), DataType::INT64, inner_place_);
+  auto *send_sizes_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(send_sizes_tensor.impl())
+          .get();
+  auto *recv_sizes_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(recv_sizes_tensor.impl())
+          .get();
+  framework::TensorFromVector<int64_t>(send_sizes, dev_ctx, send_sizes_dense);
+  process_group_
+      ->AllToAll(recv_sizes_dense, *send_sizes_dense, ones, ones, false)
+      ->Synchronize();
+  std::vector<int64_t> recv_sizes;
+  framework::TensorToVector<int64_t>(*recv_sizes_dense, dev_ctx, &recv_sizes);
+  dev_ctx.Wait();
+  const int64_t recv_num =
+      std::accumulate(recv_sizes.begin(), recv_sizes.end(), int64_t(0));
+
+  // send the rows to their owners
+  Tensor send_rows_tensor = paddle::experimental::empty(
+      IntArray({static_cast<int64_t>(merged_rows.size())}),
+      DataType::INT64,
+      inner_place_);
+  auto *send_rows_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(send_rows_tensor.impl())
+          .get();
+  framework::TensorFromVector<int64_t>(merged_rows, dev_ctx, send_rows_dense);
+  Tensor recv_rows_tensor = paddle::experimental::empty(
+      IntArray({recv_num}), DataType::INT64, inner_place_);
+  auto *recv_rows_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(recv_rows_tensor.impl())
+          .get();
+  std::vector<int64_t> value_shape =
+      common::vectorize(merged->value().dims());
+  value_shape[0] = recv_num;
+  Tensor recv_values_tensor = paddle::experimental::empty(
+      IntArray(value_shape), merged->value().dtype(), inner_place_);
+  auto *recv_values_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(recv_values_tensor.impl())
+          .get();
+  process_group_->AllToAll(
+      recv_rows_dense, *send_rows_dense, recv_sizes, send_sizes, false);
+  process_group_
+      ->AllToAll(
+          recv_values_dense, merged->value(), recv_sizes, send_sizes, false)
+      ->Synchronize();
+
+  // merge the rows this rank owns
+  std::vector<int64_t> recv_rows;
+  framework::TensorToVector<int64_t>(*recv_rows_dense, dev_ctx, &recv_rows);
+  dev_ctx.Wait();
+  auto owned = std::make_shared<phi::SelectedRows>(recv_rows, height);
+  *(owned->mutable_value()) = *recv_values_dense;
+  Tensor owned_tensor =
+      paddle::experimental::merge_selected_rows(Tensor(owned));
+  owned = std::dynamic_pointer_cast<phi::SelectedRows>(owned_tensor.impl());
+  std::vector<int64_t> owned_rows(owned->rows().begin(), owned->rows().end());
+
+  // all-gather the merged rows, padded to the most rows a rank owns
+  Tensor owned_num_tensor = paddle::experimental::full(
+      IntArray({1}),
+      static_cast<int64_t>(owned_rows.size()),
+      DataType::INT64,
+      inner_place_);
+  Tensor owned_nums_tensor = paddle::experimental::empty(
+      IntArray({static_cast<int64_t>(size)}), DataType::INT64, inner_place_);
+  auto *owned_nums_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(owned_nums_tensor.impl())
+          .get();
+  process_group_
+      ->AllGather(
+          owned_nums_dense,
+          *std::dynamic_pointer_cast<phi::DenseTensor>(owned_num_tensor.impl()),
+          false)
+      ->Synchronize();
+  std::vector<int64_t> owned_nums;
+  framework::TensorToVector<int64_t>(*owned_nums_dense, dev_ctx, &owned_nums);
+  dev_ctx.Wait();
+  const int64_t max_num =
+      *std::max_element(owned_nums.begin(), owned_nums.end());
+
+  Tensor owned_values_tensor(
+      std::make_shared<phi::DenseTensor>(owned->value()));
+  const int64_t pad_num = max_num - static_cast<int64_t>(owned_rows.size());
+  if (pad_num > 0) {
+    owned_rows.resize(max_num, 0);
+    value_shape[0] = pad_num;
+    Tensor pad_tensor = paddle::experimental::full(
+        IntArray(value_shape), 0, owned->value().dtype(), inner_place_);
+    owned_values_tensor = paddle::experimental::concat(
+        {owned_values_tensor, pad_tensor}, phi::Scalar(0));
+  }
+  Tensor owned_rows_tensor = paddle::experimental::empty(
+      IntArray({max_num}), DataType::INT64, inner_place_);
+  auto *owned_rows_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(owned_rows_tensor.impl())
+          .get();
+  framework::TensorFromVector<int64_t>(owned_rows, dev_ctx, owned_rows_dense);
+
+  Tensor gathered_rows_tensor = paddle::experimental::empty(
+      IntArray({max_num * size}), DataType::INT64, inner_place_);
+  auto *gathered_rows_dense =
+      std::dynamic_pointer_cast<phi::DenseTensor>(gathered_rows_tensor.impl())
+          .get();
+  value_shape[0] = max_num * size;
+  Tensor gathered_values_tensor = paddle::experimental::empty(
+      IntArray(value_shape), owned->value().dtype(), inner_place_);
+  process_group_->AllGather(gathered_rows_dense, *owned_rows_dense, false);
+  process_group_
+      ->AllGather(
+          std::dynamic_pointer_cast<phi::DenseTensor>(
+              gathered_values_tensor.impl())
+              .get(),
+          *std::dynamic_pointer_cast<phi::DenseTensor>(
+              owned_values_tensor.impl()),
+          false)
+      ->Synchronize();
+
+  std::vector<int64_t> gathered_rows;
+  framework::TensorToVector<int64_t>(
+      *gathered_rows_dense, dev_ctx, &gathered_rows);
+  dev_ctx.Wait();
+
+  // drop the padding, the rows stay sorted since the owners are
+  std::vector<int64_t> dst_rows;
+  std::vector<int64_t> keep_index;
+  for (int i = 0; i < size; ++i) {
+    for (int64_t j = 0; j < owned_nums[i]; ++j) {
+      dst_rows.push_back(gathered_rows[i * max_num + j]);
+      keep_index.push_back(i * max_num + j);
+    }
+  }
+  if (static_cast<int64_t>(dst_rows.size()) != max_num * size) {
+    Tensor keep_index_tensor = paddle::experimental::empty(
+        IntArray({static_cast<int64_t>(keep_index.size())}),
+        DataType::INT64,
+        inner_place_);
+    framework::TensorFromVector<int64_t>(
+        keep_index,
+        dev_ctx,
+        std::dynamic_pointer_cast<phi::DenseTensor>(keep_index_tensor.impl())
+            .get());
+    gathered_values_tensor = paddle::experimental::index_select(
+        gathered_values_tensor, keep_index_tensor, 0);
+  }
+
+  src->set_rows(dst_rows);
+  *(src->mutable_value()) = *(std::dynamic_pointer_cast<phi::DenseTensor>(
+      gathered_values_tensor.impl()));
+}
+
 std::ostream &operator<<(std::ostream &out, const EagerGroup &group) {
   const auto &tensors_ = group.tensor_indices_;
   out << "numel: " << group.all_length_ << " ;var number: " << tensors_.size()
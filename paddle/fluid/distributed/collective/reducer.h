@@ -17,6 +17,7 @@
 #include <map>
 #include <vector>
 
+#include "paddle/fluid/distributed/collective/comm_hook.h"
 #include "paddle/fluid/distributed/collective/process_group.h"
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
 #include "paddle/fluid/eager/api/utils/hook_utils.h"
@@ -48,6 +49,9 @@ class EagerGroup {
  public:
   Tensor dense_contents_;
   Tensor sparse_contents_;
+  // the persistent buffer the grads of the group are views of, see
+  // FLAGS_eager_reducer_grad_as_bucket_view
+  Tensor bucket_;
   bool is_sparse_ = false;
 
   // for concat kernel
@@ -102,16 +106,34 @@ class EagerReducer {
   void InitializeGroups(const std::vector<std::vector<size_t>> &group_indices);
   void InitializeDenseGroups(const std::vector<size_t> &tensor_indices_,
                              EagerGroup *p_group);
+  void InitializeBucketView(EagerGroup *p_group);
   void PrepareForBackward(const std::vector<Tensor> &outputs);
   void AddDistHook(size_t var_index);
   void MarkVarReady(const size_t var_index, const bool is_used_var);
+  void CopyGradToBucketView(const size_t var_index,
+                            EagerGroup *group,
+                            const size_t inside_group_index,
+                            const bool is_used_var);
   void MarkGroupReady(const size_t group_index);
   void FusedAllReduceSchedule(EagerGroup *group, const int curr_group_index);
   void AllReduceSparse(EagerGroup *group, const int curr_group_index);
+  // all-reduce the rows of a sparse grad as a dense tensor of its height
+  void AllReduceSparseAsDense(const std::shared_ptr<phi::SelectedRows> &src,
+                              const platform::DeviceContext &dev_ctx);
+  // merge the rows of a sparse grad on the ranks owning their ranges of the
+  // height, then all-gather the merged rows
+  void AllReduceSparseByPartition(
+      const std::shared_ptr<phi::SelectedRows> &src,
+      const platform::DeviceContext &dev_ctx);
   void FinalizeBackward();
   void TraverseBackwardGraph(const std::vector<Tensor> &outputs);
   void ProcessUnusedDenseVars();
   bool HasGrad(size_t var_index);
+  bool NeedRebuildGroups() const;
+  void RebuildGroups();
+  // all-reduces the dense groups through comm_hook, nullptr to all-reduce
+  // them in the dtype of the grads
+  void SetCommHook(std::shared_ptr<EagerCommHook> comm_hook);
 
  private:
   std::vector<Tensor> tensors_;
@@ -139,6 +161,17 @@ class EagerReducer {
   bool find_unused_vars_once_{true};
   bool groups_need_finalize_{false};
   Tensor global_used_vars_;
+
+  // Following variables are to help rebuild the groups in the order the
+  // grads are ready in, see FLAGS_eager_reducer_rebuild_group_steps
+  bool has_rebuilt_groups_{false};
+  int64_t recorded_steps_{0};
+  int64_t ready_count_{0};
+  // the sum of the ready positions of each var over the recorded steps
+  std::vector<int64_t> ready_position_sums_;
+
+  std::shared_ptr<EagerCommHook> comm_hook_;
+  bool grad_as_bucket_view_{false};
 };
 
 }  //  namespace distributed
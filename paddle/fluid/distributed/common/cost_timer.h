@@ -19,12 +19,15 @@
 #include "butil/time.h"
 #include "bvar/latency_recorder.h"
 #include "glog/logging.h"
+#include "paddle/phi/core/metrics.h"
 
 namespace paddle {
 namespace distributed {
 
 struct CostProfilerNode {
   std::shared_ptr<bvar::LatencyRecorder> recorder;
+  // the same latency, in the metrics of the process
+  phi::MetricHistogram* histogram = nullptr;
 };
 
 class CostProfiler {
@@ -42,6 +45,10 @@ class CostProfiler {
     auto profiler_node = std::make_shared<CostProfilerNode>();
     profiler_node->recorder.reset(
         new bvar::LatencyRecorder("cost_profiler", label));
+    profiler_node->histogram = phi::MetricsRegistry::Instance().GetHistogram(
+        "paddle_ps_cost_seconds",
+        "Latency of the parameter server calls.",
+        "label=\"" + label + "\"");
     _cost_profiler_map[label] = profiler_node;
   }
 
@@ -79,7 +86,12 @@ class CostTimer {
       VLOG(3) << "CostTimer label:" << _label
               << ", cost:" << butil::gettimeofday_ms() - _start_time_ms << "ms";
     } else {
-      *(_profiler_node->recorder) << butil::gettimeofday_ms() - _start_time_ms;
+      uint64_t cost_ms = butil::gettimeofday_ms() - _start_time_ms;
+      *(_profiler_node->recorder) << cost_ms;
+      if (_profiler_node->histogram != nullptr) {
+        _profiler_node->histogram->Observe(static_cast<double>(cost_ms) /
+                                           1000);
+      }
     }
   }
 
@@ -0,0 +1,123 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace paddle {
+namespace distributed {
+
+// NUMA topology read from sysfs, so no libnuma is needed. Memory placement
+// relies on the first touch policy of the kernel: a thread bound to the cpus
+// of a node gets the pages it touches first from that node.
+class NumaTopology {
+ public:
+  static const NumaTopology& Instance() {
+    static NumaTopology topology;
+    return topology;
+  }
+
+  int NodeNum() const { return static_cast<int>(_node_cpus.size()); }
+  const std::vector<int>& NodeCpus(int node) const { return _node_cpus[node]; }
+
+ private:
+  NumaTopology() {
+    for (int node = 0;; ++node) {
+      std::ifstream fin("/sys/devices/system/node/node" +
+                        std::to_string(node) + "/cpulist");
+      if (!fin.good()) {
+        break;
+      }
+      std::string cpulist;
+      std::getline(fin, cpulist);
+      _node_cpus.push_back(ParseCpuList(cpulist));
+    }
+  }
+
+  // "0-15,32-47" => {0, ..., 15, 32, ..., 47}
+  static std::vector<int> ParseCpuList(const std::string& cpulist) {
+    std::vector<int> cpus;
+    std::stringstream ss(cpulist);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+      if (range.empty()) {
+        continue;
+      }
+      auto pos = range.find('-');
+      int begin = std::stoi(range.substr(0, pos));
+      int end =
+          pos == std::string::npos ? begin : std::stoi(range.substr(pos + 1));
+      for (int cpu = begin; cpu <= end; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+
+  std::vector<std::vector<int>> _node_cpus;
+};
+
+inline bool BindCurrentThreadToNumaNode(int node) {
+  auto& topology = NumaTopology::Instance();
+  if (node < 0 || node >= topology.NodeNum()) {
+    return false;
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : topology.NodeCpus(node)) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (ret != 0) {
+    LOG(WARNING) << "bind thread to numa node " << node
+                 << " failed, error code:" << ret;
+    return false;
+  }
+  return true;
+}
+
+// Binds the current thread to a node until the object goes out of scope,
+// for the omp threads that fill shards on load and serve others afterwards.
+class ScopedNumaBind {
+ public:
+  explicit ScopedNumaBind(int node) {
+    if (node >= 0 && pthread_getaffinity_np(
+                         pthread_self(), sizeof(_cpu_set), &_cpu_set) == 0) {
+      _restore = BindCurrentThreadToNumaNode(node);
+    }
+  }
+  ~ScopedNumaBind() {
+    if (_restore) {
+      pthread_setaffinity_np(pthread_self(), sizeof(_cpu_set), &_cpu_set);
+    }
+  }
+  ScopedNumaBind(const ScopedNumaBind&) = delete;
+  ScopedNumaBind& operator=(const ScopedNumaBind&) = delete;
+
+ private:
+  cpu_set_t _cpu_set;
+  bool _restore = false;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -43,6 +43,7 @@ namespace distributed {
 USE_INTERCEPTOR(Source);
 USE_INTERCEPTOR(Compute);
 USE_INTERCEPTOR(Amplifier);
+USE_INTERCEPTOR(WeightGrad);
 USE_INTERCEPTOR(Sink);
 USE_INTERCEPTOR(Cond);
 USE_INTERCEPTOR(Start);
@@ -320,41 +320,45 @@ void ComputeInterceptor::RunOps() {
 
 void ComputeInterceptor::Run() {
   while (IsInputReady() && CanWriteOutput()) {
-    VLOG(3) << "id=" << GetInterceptorId()
-            << " ComputeInterceptor running in scope " << cur_scope_id_;
+    RunStep();
+  }
+}
 
-    RunOps();
+void ComputeInterceptor::RunStep() {
+  VLOG(3) << "id=" << GetInterceptorId()
+          << " ComputeInterceptor running in scope " << cur_scope_id_;
 
-    if (!gen_step_to_scope_id_to_finish_flag_.empty()) {
-      auto iter = gen_step_to_scope_id_to_finish_flag_.begin();
-      VLOG(3) << "id=" << GetInterceptorId()
-              << " ComputeInterceptor running in scope " << cur_scope_id_
-              << " with gen_step " << iter->first;
-      auto& scope_id_to_finish_flag = iter->second;
-      PADDLE_ENFORCE_NE(
-          scope_id_to_finish_flag.find(cur_scope_id_),
-          scope_id_to_finish_flag.end(),
-          platform::errors::NotFound(
-              "Can not find scope %ld in scope_id_to_finish", cur_scope_id_));
-      scope_id_to_finish_flag.erase(cur_scope_id_);
-      if (scope_id_to_finish_flag.empty()) {
-        gen_step_to_scope_id_to_finish_flag_.erase(iter);
-      }
+  RunOps();
+
+  if (!gen_step_to_scope_id_to_finish_flag_.empty()) {
+    auto iter = gen_step_to_scope_id_to_finish_flag_.begin();
+    VLOG(3) << "id=" << GetInterceptorId()
+            << " ComputeInterceptor running in scope " << cur_scope_id_
+            << " with gen_step " << iter->first;
+    auto& scope_id_to_finish_flag = iter->second;
+    PADDLE_ENFORCE_NE(
+        scope_id_to_finish_flag.find(cur_scope_id_),
+        scope_id_to_finish_flag.end(),
+        platform::errors::NotFound(
+            "Can not find scope %ld in scope_id_to_finish", cur_scope_id_));
+    scope_id_to_finish_flag.erase(cur_scope_id_);
+    if (scope_id_to_finish_flag.empty()) {
+      gen_step_to_scope_id_to_finish_flag_.erase(iter);
     }
+  }
 
-    // send to downstream and increase buff used
-    SendDataReadyToDownStream();
-    // reply to upstream and decrease ready data
-    ReplyCompletedToUpStream();
-    // clear TensorArray
-    auto vars_names = microbatch_scopes_[cur_scope_id_]->LocalVarNames();
-    for (auto var_name : vars_names) {
-      if (var_name == "feed" || var_name == "fetch") continue;
-      auto* var = microbatch_scopes_[cur_scope_id_]->Var(var_name);
-      if (var != nullptr && var->IsType<framework::LoDTensorArray>()) {
-        auto* lod_tensor_arr = var->GetMutable<framework::LoDTensorArray>();
-        lod_tensor_arr->clear();
-      }
+  // send to downstream and increase buff used
+  SendDataReadyToDownStream();
+  // reply to upstream and decrease ready data
+  ReplyCompletedToUpStream();
+  // clear TensorArray
+  auto vars_names = microbatch_scopes_[cur_scope_id_]->LocalVarNames();
+  for (auto var_name : vars_names) {
+    if (var_name == "feed" || var_name == "fetch") continue;
+    auto* var = microbatch_scopes_[cur_scope_id_]->Var(var_name);
+    if (var != nullptr && var->IsType<framework::LoDTensorArray>()) {
+      auto* lod_tensor_arr = var->GetMutable<framework::LoDTensorArray>();
+      lod_tensor_arr->clear();
     }
   }
 }
@@ -33,9 +33,14 @@ class ComputeInterceptor : public Interceptor {
   virtual void SendDataReadyToDownStream();
   virtual void ReplyCompletedToUpStream();
   virtual void Compute(const InterceptorMessage& msg);
-  void Run();
+  // run the ready micro steps, called after each message
+  virtual void Run();
+  // run one micro step, cur_scope_id_ is set by IsInputReady
+  void RunStep();
   void IncreaseReady(int64_t up_id, int64_t scope_id);
   void DecreaseBuff(int64_t down_id);
+  bool IsInputReady();
+  bool CanWriteOutput();
 
   int64_t cur_scope_id_;
 
@@ -50,8 +55,6 @@ class ComputeInterceptor : public Interceptor {
   InterceptorMessage PrepareVarsMsg();
   void DecodeMsgVars(const InterceptorMessage& msg);
 
-  bool IsInputReady();
-  bool CanWriteOutput();
   std::map<int64_t, std::map<int64_t, bool>>
       gen_step_to_scope_id_to_finish_flag_;
   int64_t start_micro_step_{-1};
@@ -16,6 +16,7 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <chrono>  // NOLINT
 
 #include "paddle/fluid/distributed/fleet_executor/fleet_executor.h"
@@ -481,6 +482,23 @@ bool DistModel::PrepareFleetExe() {
   // With auto cut, there is no concept of pp, no need to add dependency.
   task_node_->SetType("Compute");
   task_node_->Init();
+  PADDLE_ENFORCE_GE(config_.num_micro_batches,
+                    1,
+                    platform::errors::InvalidArgument(
+                        "num_micro_batches must >= 1, but received %ld",
+                        config_.num_micro_batches));
+  if (config_.num_micro_batches > 1) {
+    // each request gets a micro scope with its own feed and fetch vars,
+    // which shadow the ones of the root scope
+    task_node_->SetMaxRunTimes(config_.num_micro_batches);
+    auto *minibatch_scope = &scope_->NewScope();
+    for (int64_t i = 0; i < config_.num_micro_batches; ++i) {
+      auto *micro_scope = &minibatch_scope->NewScope();
+      micro_scope->Var("fetch")->GetMutable<framework::FetchList>();
+      micro_scopes_.emplace_back(micro_scope);
+    }
+    micro_feed_tensors_.resize(config_.num_micro_batches);
+  }
   executor_desc_ = FleetExecutorDesc();
   executor_desc_.set_cur_rank(config_.local_rank);
   std::unordered_map<int64_t, int64_t> id_to_rank;
@@ -500,9 +518,11 @@ bool DistModel::PrepareFleetExe() {
                   *(program_.get()),
                   scope_.get(),
                   place_,
-                  1,
+                  config_.num_micro_batches,
                   {task_node_.get()},
-                  id_to_rank);
+                  id_to_rank,
+                  {},
+                  micro_scopes_);
   return true;
 }
 
@@ -561,17 +581,18 @@ bool DistModel::PrepareFeedAndFetch() {
 }
 
 bool DistModel::FeedData(const std::vector<DistModelTensor> &input_data,
-                         framework::Scope *scope) {
+                         framework::Scope *scope,
+                         std::vector<phi::DenseTensor> *feed_tensors) {
   VLOG(3) << "DistModel is feeding data.";
   if (input_data.size() != feeds_.size()) {
     LOG(ERROR) << "Should provide " << feeds_.size() << " feeds, but got "
                << input_data.size() << " data.";
     return false;
   }
-  feed_tensors_.resize(feeds_.size());
+  feed_tensors->resize(feeds_.size());
   for (size_t i = 0; i < input_data.size(); ++i) {
     // feed each data separately
-    phi::DenseTensor *input_tensor = &(feed_tensors_[i]);
+    phi::DenseTensor *input_tensor = &((*feed_tensors)[i]);
     if (!LoadDataFromDistModelTensor(input_data[i], input_tensor, place_)) {
       LOG(ERROR) << "Fail to load data from tensor " << input_data[i].name;
       return false;
@@ -663,13 +684,22 @@ bool DistModel::Run(const std::vector<DistModelTensor> &input_data,
                     std::vector<DistModelTensor> *output_data) {
   VLOG(3) << "DistModel run for once.";
 
+  if (config_.num_micro_batches > 1) {
+    std::vector<std::vector<DistModelTensor>> outputs;
+    if (!Run({input_data}, &outputs)) {
+      return false;
+    }
+    *output_data = std::move(outputs[0]);
+    return true;
+  }
+
   DistModelTimer timer;
   timer.tic();
   double feed_elapse = 0;
   double fleet_exe_elapse = 0;
   double fetch_elapse = 0;
 
-  if (!FeedData(input_data, scope_.get())) {
+  if (!FeedData(input_data, scope_.get(), &feed_tensors_)) {
     LOG(ERROR) << "DistModel failed at feeding data.";
     return false;
   }
@@ -705,5 +735,47 @@ bool DistModel::Run(const std::vector<DistModelTensor> &input_data,
   return true;
 }
 
+bool DistModel::Run(const std::vector<std::vector<DistModelTensor>> &input_data,
+                    std::vector<std::vector<DistModelTensor>> *output_data) {
+  size_t num_requests = input_data.size();
+  VLOG(3) << "DistModel run for " << num_requests << " requests.";
+  output_data->resize(num_requests);
+  if (config_.num_micro_batches == 1) {
+    for (size_t i = 0; i < num_requests; ++i) {
+      if (!Run(input_data[i], &(output_data->at(i)))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t num_micro = static_cast<size_t>(config_.num_micro_batches);
+  for (size_t begin = 0; begin < num_requests; begin += num_micro) {
+    size_t end = std::min(begin + num_micro, num_requests);
+    // the carrier always runs all the micro scopes, the ones left over by
+    // the last requests rerun the last request and are not fetched
+    for (size_t i = 0; i < num_micro; ++i) {
+      size_t request = std::min(begin + i, end - 1);
+      if (!FeedData(
+              input_data[request], micro_scopes_[i], &micro_feed_tensors_[i])) {
+        LOG(ERROR) << "DistModel failed at feeding data of request "
+                   << request << ".";
+        return false;
+      }
+    }
+    fleet_exe->Run(carrier_id_);
+    for (size_t request = begin; request < end; ++request) {
+      if (!FetchResults(&(output_data->at(request)),
+                        micro_scopes_[request - begin])) {
+        LOG(ERROR) << "DistModel failed at fetching result of request "
+                   << request << ".";
+        return false;
+      }
+    }
+  }
+  VLOG(3) << "DistModel finish inf of " << num_requests << " requests.";
+  return true;
+}
+
 }  // namespace distributed
 }  // namespace paddle
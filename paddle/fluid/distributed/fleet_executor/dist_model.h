@@ -50,6 +50,9 @@ struct DistModelConfig {
   int64_t nranks{1};
   int64_t local_rank{0};
   bool enable_timer{false};
+  // the number of requests in flight through the pipeline stages in one run
+  // of a batch of requests, each of them in its own micro scope
+  int64_t num_micro_batches{1};
   std::map<int64_t, std::vector<int64_t>> ring_id_to_ranks_{};
   std::map<int64_t, std::vector<int64_t>> rank_to_ring_ids_{};
 };
@@ -60,6 +63,10 @@ class DistModel {
   bool Init();
   bool Run(const std::vector<DistModelTensor>& input_data,
            std::vector<DistModelTensor>* output_data);
+  // Run a batch of requests, num_micro_batches of them at a time, so that
+  // the pipeline stages work on different requests at once.
+  bool Run(const std::vector<std::vector<DistModelTensor>>& input_data,
+           std::vector<std::vector<DistModelTensor>>* output_data);
   ~DistModel() = default;
 
  private:
@@ -80,7 +87,8 @@ class DistModel {
                     framework::BlockDesc* block,
                     int ring_id);
   bool FeedData(const std::vector<DistModelTensor>& input_data,
-                framework::Scope* scope);
+                framework::Scope* scope,
+                std::vector<phi::DenseTensor>* feed_tensors);
   bool FetchResults(std::vector<DistModelTensor>* output_data,
                     framework::Scope* scope);
   template <typename T>
@@ -99,6 +107,9 @@ class DistModel {
   std::shared_ptr<FleetExecutor> fleet_exe;
   std::shared_ptr<TaskNode> task_node_;
   std::shared_ptr<framework::Scope> scope_;
+  // the micro scopes of the requests run at once, and their feed tensors
+  std::vector<framework::Scope*> micro_scopes_;
+  std::vector<std::vector<phi::DenseTensor>> micro_feed_tensors_;
   paddle::platform::Place place_;
   std::shared_ptr<framework::ProgramDesc> program_;
 };
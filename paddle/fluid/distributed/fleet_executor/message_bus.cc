@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/distributed/fleet_executor/message_bus.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <set>
@@ -36,6 +37,7 @@ void MessageBus::Init(
       platform::errors::AlreadyExists("MessageBus is already init."));
   rank_ = rank;
   is_init_ = true;
+  init_time_ = std::chrono::steady_clock::now();
   rank_to_addr_ = rank_to_addr;
   addr_ = addr;
 
@@ -73,6 +75,16 @@ bool MessageBus::IsInit() const { return is_init_; }
 
 MessageBus::~MessageBus() {
   VLOG(3) << "Message bus releases resource.";
+  if (is_init_) {
+    auto stats = GetStats();
+    VLOG(1) << "Message bus of rank " << rank_ << " sent "
+            << stats.local_count << " local and " << stats.remote_count
+            << " remote messages (" << stats.remote_bytes << " bytes, "
+            << stats.failed_count << " failed), latency avg "
+            << stats.total_latency_us /
+                   std::max<int64_t>(stats.local_count + stats.remote_count, 1)
+            << "us max " << stats.max_latency_us << "us.";
+  }
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
   server_.Stop(1000);
   server_.Join();
@@ -94,6 +106,23 @@ bool MessageBus::Send(int64_t dst_rank,
       true,
       platform::errors::PreconditionNotMet(
           "Using message bus since it has not been initialized."));
+  auto start = std::chrono::steady_clock::now();
+  auto latency_us = [&start]() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+  if (dst_rank == rank_) {
+    // in process, without serializing the message
+    bool rst = true;
+    if (interceptor_message.ctrl_message()) {
+      IncreaseBarrierCount();
+    } else {
+      rst = DispatchMsgToCarrier(interceptor_message);
+    }
+    RecordSend(/*local=*/true, 0, latency_us());
+    return rst;
+  }
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
   int retry_time = 0;  // message bus will retry sending for 10 times
   while (retry_time < 10) {
@@ -101,12 +130,16 @@ bool MessageBus::Send(int64_t dst_rank,
     if (SendInterRank(dst_rank, interceptor_message)) {
       VLOG(3) << "Message bus sends inter rank successfully with " << retry_time
               << " times retries.";
+      RecordSend(/*local=*/false,
+                 static_cast<int64_t>(interceptor_message.ByteSizeLong()),
+                 latency_us());
       return true;
     }
     VLOG(3) << "Message bus sends failed, retry after 1 seconds.";
     std::this_thread::sleep_for(std::chrono::milliseconds(1000));
   }
   VLOG(3) << "Message bus sends inter rank fail after 10 times retries.";
+  ++failed_count_;
   return false;
 #else
   PADDLE_THROW(platform::errors::Unavailable(
@@ -166,6 +199,36 @@ void MessageBus::Barrier() {
   }
 }
 
+MessageBusStats MessageBus::GetStats() const {
+  MessageBusStats stats;
+  stats.local_count = local_count_;
+  stats.remote_count = remote_count_;
+  stats.remote_bytes = remote_bytes_;
+  stats.failed_count = failed_count_;
+  stats.total_latency_us = total_latency_us_;
+  stats.max_latency_us = max_latency_us_;
+  if (is_init_) {
+    stats.elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - init_time_)
+                           .count();
+  }
+  return stats;
+}
+
+void MessageBus::RecordSend(bool local, int64_t bytes, int64_t latency_us) {
+  if (local) {
+    ++local_count_;
+  } else {
+    ++remote_count_;
+    remote_bytes_ += bytes;
+  }
+  total_latency_us_ += latency_us;
+  int64_t max_latency_us = max_latency_us_.load();
+  while (latency_us > max_latency_us &&
+         !max_latency_us_.compare_exchange_weak(max_latency_us, latency_us)) {
+  }
+}
+
 bool MessageBus::DispatchMsgToCarrier(
     const InterceptorMessage& interceptor_message) {
   const std::string& carrier_id = *GlobalVal<std::string>::Get();
@@ -210,20 +273,9 @@ void MessageBus::ListenPort() {
 #if defined(PADDLE_WITH_DISTRIBUTE) && !defined(PADDLE_WITH_PSLIB)
 bool MessageBus::SendInterRank(int64_t dst_rank,
                                const InterceptorMessage& interceptor_message) {
-  const auto& dst_addr = GetAddr(dst_rank);
-  VLOG(3) << "Message bus sending to addr: " << dst_addr;
-  const char* dst_addr_for_brpc = dst_addr.c_str();
-  brpc::Channel channel;
-  brpc::ChannelOptions options;
-  options.protocol = "baidu_std";
-  options.connect_timeout_ms = 100000;
-  options.timeout_ms = 100000;
-  options.max_retry = 5;
-  PADDLE_ENFORCE_EQ(
-      channel.Init(dst_addr_for_brpc, &options),
-      0,
-      platform::errors::Unavailable("Message bus: init brpc channel error."));
-  MessageService_Stub stub(&channel);
+  // kept alive by the send, even if reset by a failed one meanwhile
+  auto channel = GetChannel(dst_rank);
+  MessageService_Stub stub(channel.get());
   InterceptorResponse response;
   brpc::Controller ctrl;
   ctrl.set_log_id(0);
@@ -244,10 +296,40 @@ bool MessageBus::SendInterRank(int64_t dst_rank,
   } else {
     VLOG(4) << "Message bus: brpc sends failed with error text: "
             << ctrl.ErrorText();
+    // reconnects on the retry
+    ResetChannel(dst_rank);
     return false;
   }
 }
 
+std::shared_ptr<brpc::Channel> MessageBus::GetChannel(int64_t dst_rank) {
+  std::lock_guard<std::mutex> lock(channels_mutex_);
+  auto& channel = channels_[dst_rank];
+  if (channel == nullptr) {
+    const auto& dst_addr = GetAddr(dst_rank);
+    VLOG(3) << "Message bus connecting to addr: " << dst_addr;
+    const char* dst_addr_for_brpc = dst_addr.c_str();
+    brpc::ChannelOptions options;
+    options.protocol = "baidu_std";
+    options.connect_timeout_ms = 100000;
+    options.timeout_ms = 100000;
+    options.max_retry = 5;
+    auto new_channel = std::make_shared<brpc::Channel>();
+    PADDLE_ENFORCE_EQ(
+        new_channel->Init(dst_addr_for_brpc, &options),
+        0,
+        platform::errors::Unavailable("Message bus: init brpc channel error."));
+    channel = std::move(new_channel);
+  }
+  // brpc channels are thread safe
+  return channel;
+}
+
+void MessageBus::ResetChannel(int64_t dst_rank) {
+  std::lock_guard<std::mutex> lock(channels_mutex_);
+  channels_.erase(dst_rank);
+}
+
 #endif
 
 }  // namespace distributed
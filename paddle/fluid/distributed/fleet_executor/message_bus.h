@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -36,6 +39,20 @@ namespace distributed {
 
 class Carrier;
 
+// Counters of the messages sent by the MessageBus since its Init.
+struct MessageBusStats {
+  // dispatched to the carrier of this process
+  int64_t local_count = 0;
+  // sent to other ranks, and their serialized bytes
+  int64_t remote_count = 0;
+  int64_t remote_bytes = 0;
+  int64_t failed_count = 0;
+  // of the successful sends, in microseconds
+  int64_t total_latency_us = 0;
+  int64_t max_latency_us = 0;
+  int64_t elapsed_us = 0;
+};
+
 // A singleton MessageBus
 class MessageBus final {
  public:
@@ -55,6 +72,8 @@ class MessageBus final {
   void Barrier();
   bool DispatchMsgToCarrier(const InterceptorMessage& interceptor_message);
 
+  MessageBusStats GetStats() const;
+
  private:
   DISABLE_COPY_AND_ASSIGN(MessageBus);
 
@@ -67,8 +86,15 @@ class MessageBus final {
   // send the message inter rank (dst is different rank with src)
   bool SendInterRank(int64_t dst_rank,
                      const InterceptorMessage& interceptor_message);
+
+  // the channel to dst_rank, created on the first send and reused, as
+  // connecting for each message dominates the latency of the small messages
+  std::shared_ptr<brpc::Channel> GetChannel(int64_t dst_rank);
+  void ResetChannel(int64_t dst_rank);
 #endif
 
+  void RecordSend(bool local, int64_t bytes, int64_t latency_us);
+
   bool is_init_{false};
 
   int64_t rank_;
@@ -83,8 +109,19 @@ class MessageBus final {
   MessageServiceImpl message_service_;
   // brpc server
   brpc::Server server_;
+
+  std::mutex channels_mutex_;
+  std::unordered_map<int64_t, std::shared_ptr<brpc::Channel>> channels_;
 #endif
 
+  std::chrono::steady_clock::time_point init_time_;
+  std::atomic<int64_t> local_count_{0};
+  std::atomic<int64_t> remote_count_{0};
+  std::atomic<int64_t> remote_bytes_{0};
+  std::atomic<int64_t> failed_count_{0};
+  std::atomic<int64_t> total_latency_us_{0};
+  std::atomic<int64_t> max_latency_us_{0};
+
   // for barrier
   std::mutex mutex_;
   std::condition_variable cv_;
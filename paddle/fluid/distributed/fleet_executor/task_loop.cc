@@ -46,11 +46,19 @@ void TaskLoop::Loop() {
   quit_ = false;
 
   while (!quit_) {
+    // one idle task at a time, the tasks queued by it come first
+    if (!idle_tasks_.empty() && tasks_.Size() == 0) {
+      auto task = std::move(idle_tasks_.front());
+      idle_tasks_.pop_front();
+      task();
+      continue;
+    }
     auto tasks = tasks_.PopAll();
     for (auto& task : tasks) {
       task();
     }
   }
+  idle_tasks_.clear();
   looping_ = false;
 }
 
@@ -69,6 +77,11 @@ void TaskLoop::RunInLoop(Functor cb) {
 
 void TaskLoop::QueueInLoop(Functor cb) { tasks_.Push(cb); }
 
+void TaskLoop::QueueWhenIdle(Functor cb) {
+  AssertInLoopThread();
+  idle_tasks_.emplace_back(std::move(cb));
+}
+
 void TaskLoop::WakeUp() {
   Functor task([] {});
   QueueInLoop(task);
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <deque>
 #include <functional>
 #include <future>
 #include <map>
@@ -40,6 +41,9 @@ class TaskLoop {
 
   void RunInLoop(Functor cb);
   void QueueInLoop(Functor cb);
+  // Run cb in the loop once no other task is queued, e.g. the work which
+  // fills the bubbles of a pipeline. Only called in the loop thread.
+  void QueueWhenIdle(Functor cb);
 
   template <class F, class... Args>
   auto Enqueue(F&& f, Args&&... args)
@@ -78,6 +82,8 @@ class TaskLoop {
   std::thread::id thread_id_;
 
   framework::BlockingQueue<Functor> tasks_;
+  // only touched in the loop thread
+  std::deque<Functor> idle_tasks_;
 };
 
 }  // namespace distributed
@@ -151,6 +151,14 @@ std::string TaskNode::DebugString() const {
   return os.str();
 }
 
+void TaskNode::SetMaxRunTimes(int64_t value) {
+  PADDLE_ENFORCE_GE(value,
+                    1,
+                    platform::errors::InvalidArgument(
+                        "max_run_times must >= 1, but received %ld", value));
+  max_run_times_ = value;
+}
+
 void TaskNode::SetRunPerSteps(int64_t value) {
   PADDLE_ENFORCE_GE(value,
                     1,
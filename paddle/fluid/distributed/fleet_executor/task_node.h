@@ -94,6 +94,7 @@ class TaskNode final {
   void SetCondVarName(const std::string& cond_var_name) {
     cond_var_ = cond_var_name;
   }
+  void SetMaxRunTimes(int64_t value);
   void SetRunPerSteps(int64_t value);
   void SetRunAtOffset(int64_t value);
   void SetReplyUpPerSteps(int64_t value);
@@ -0,0 +1,47 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/fleet_executor/weight_grad_interceptor.h"
+
+#include "paddle/fluid/distributed/fleet_executor/task_loop.h"
+#include "paddle/fluid/distributed/fleet_executor/task_node.h"
+
+namespace paddle {
+namespace distributed {
+
+WeightGradInterceptor::WeightGradInterceptor(int64_t interceptor_id,
+                                             TaskNode* node)
+    : ComputeInterceptor(interceptor_id, node) {}
+
+void WeightGradInterceptor::Run() {
+  if (queued_) return;
+  queued_ = true;
+  loop_->QueueWhenIdle([this]() { RunWhenIdle(); });
+}
+
+void WeightGradInterceptor::RunWhenIdle() {
+  queued_ = false;
+  if (IsInputReady() && CanWriteOutput()) {
+    VLOG(3) << "WeightGradInterceptor " << interceptor_id_
+            << " fills the bubble with scope " << cur_scope_id_;
+    RunStep();
+    // the next micro step waits for the next bubble
+    Run();
+  }
+}
+
+REGISTER_INTERCEPTOR(WeightGrad, WeightGradInterceptor);
+
+}  // namespace distributed
+}  // namespace paddle
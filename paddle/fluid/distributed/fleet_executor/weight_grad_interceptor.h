@@ -0,0 +1,40 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/fluid/distributed/fleet_executor/compute_interceptor.h"
+
+namespace paddle {
+namespace distributed {
+
+// WeightGradInterceptor runs the weight grad part of the backward of a
+// zero bubble pipeline, split from the input grad part that the previous
+// stage waits for. It has no downstream on the other stages, so instead of
+// running once its inputs are ready it waits until the task loop of the rank
+// has nothing else to do, i.e. the bubbles of the pipeline, and runs one
+// micro step at a time so the forward and the input grad still go first.
+class WeightGradInterceptor final : public ComputeInterceptor {
+ public:
+  WeightGradInterceptor(int64_t interceptor_id, TaskNode* node);
+
+ private:
+  void Run() override;
+  void RunWhenIdle();
+
+  bool queued_{false};
+};
+
+}  // namespace distributed
+}  // namespace paddle
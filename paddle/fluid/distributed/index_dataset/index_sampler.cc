@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/distributed/index_dataset/index_sampler.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
 #include "paddle/fluid/framework/data_feed.h"
 
 namespace paddle {
@@ -128,6 +132,189 @@ void LayerWiseSampler::sample_from_dataset(
   return;
 }
 
+void LayerWiseSampler::InitLayerArrays() {
+  layer_node_ids_.clear();
+  layer_code_ids_.clear();
+  layer_offsets_.clear();
+  auto max_layer = tree_->Height();
+  for (size_t j = 0; j < layer_ids_.size(); j++) {
+    std::vector<uint64_t> node_ids;
+    node_ids.reserve(layer_ids_[j].size());
+    for (auto& node : layer_ids_[j]) {
+      node_ids.push_back(node.id());
+    }
+    layer_node_ids_.push_back(std::move(node_ids));
+
+    int level = max_layer - 1 - static_cast<int>(j);
+    auto level_num = static_cast<uint64_t>(std::pow(tree_->Branch(), level));
+    uint64_t level_offset = level_num - 1;
+    std::vector<uint64_t> code_ids(level_num, tree_->fake_node_.id());
+    for (uint64_t i = 0; i < level_num; i++) {
+      auto iter = tree_->data_.find(level_offset + i);
+      if (iter != tree_->data_.end()) {
+        code_ids[i] = iter->second.id();
+      }
+    }
+    layer_code_ids_.push_back(std::move(code_ids));
+    layer_offsets_.push_back(level_offset);
+  }
+}
+
+uint64_t LayerWiseSampler::LayerNodeId(size_t j, uint64_t code) const {
+  const auto& code_ids = layer_code_ids_[j];
+  if (code < layer_offsets_[j] || code - layer_offsets_[j] >= code_ids.size()) {
+    return tree_->fake_node_.id();
+  }
+  return code_ids[code - layer_offsets_[j]];
+}
+
+void LayerWiseSampler::set_thread_num(int thread_num) {
+  PADDLE_ENFORCE_GT(thread_num,
+                    0,
+                    paddle::platform::errors::InvalidArgument(
+                        "thread num = [%d], it should greater than 0.",
+                        thread_num));
+  thread_num_ = thread_num;
+  thread_pool_.reset(thread_num_ > 1 ? new ::ThreadPool(thread_num_)
+                                     : nullptr);
+}
+
+void LayerWiseSampler::SampleRange(const int64_t* user_inputs,
+                                   const int64_t* target_ids,
+                                   int64_t user_feature_num,
+                                   bool with_hierarchy,
+                                   int64_t begin,
+                                   int64_t end,
+                                   uint64_t seed,
+                                   int64_t* outputs) const {
+  std::mt19937_64 engine(seed);
+  int64_t width = user_feature_num + 2;
+  int64_t branch = tree_->Branch();
+  // the users not in the tree are at max_code_, like GetAncestorCodes does
+  uint64_t unknown_user_id = tree_->CheckIsValid(tree_->max_code_)
+                                 ? tree_->data_.at(tree_->max_code_).id()
+                                 : tree_->fake_node_.id();
+  std::vector<uint64_t> user_codes(user_feature_num);
+  std::vector<bool> user_in_tree(user_feature_num);
+  std::vector<int64_t> user_ids(user_feature_num);
+  for (int64_t i = begin; i < end; i++) {
+    const int64_t* users = user_inputs + i * user_feature_num;
+    int64_t* row = outputs + i * layer_counts_sum_ * width;
+    auto target_iter =
+        tree_->id_codes_map_.find(static_cast<uint64_t>(target_ids[i]));
+    PADDLE_ENFORCE_NE(target_iter,
+                      tree_->id_codes_map_.end(),
+                      paddle::platform::errors::InvalidArgument(
+                          "id = %d doesn't exist in Tree.", target_ids[i]));
+    uint64_t code = target_iter->second;
+    for (int64_t k = 0; k < user_feature_num; k++) {
+      user_ids[k] = users[k];
+      if (with_hierarchy) {
+        auto iter = tree_->id_codes_map_.find(static_cast<uint64_t>(users[k]));
+        user_in_tree[k] = iter != tree_->id_codes_map_.end();
+        user_codes[k] = user_in_tree[k] ? iter->second : tree_->max_code_;
+      }
+    }
+
+    for (size_t j = 0; j < layer_counts_.size(); j++) {
+      uint64_t positive = LayerNodeId(j, code);
+      // the ancestors of the users at the layer, one layer up per j
+      if (j > 0 && with_hierarchy) {
+        for (int64_t k = 0; k < user_feature_num; k++) {
+          if (!user_in_tree[k]) {
+            user_ids[k] = static_cast<int64_t>(unknown_user_id);
+          } else {
+            user_codes[k] = (user_codes[k] - 1) / branch;
+            user_ids[k] = static_cast<int64_t>(LayerNodeId(j, user_codes[k]));
+          }
+        }
+      }
+      for (int idx_offset = 0; idx_offset <= layer_counts_[j]; idx_offset++) {
+        std::copy(user_ids.begin(), user_ids.end(), row + idx_offset * width);
+      }
+
+      row[user_feature_num] = static_cast<int64_t>(positive);
+      row[user_feature_num + 1] = 1;
+      row += width;
+      const auto& node_ids = layer_node_ids_[j];
+      std::uniform_int_distribution<size_t> dist(0, node_ids.size() - 1);
+      for (int idx_offset = 0; idx_offset < layer_counts_[j]; idx_offset++) {
+        uint64_t negative = 0;
+        do {
+          negative = node_ids[dist(engine)];
+        } while (negative == positive);
+        row[user_feature_num] = static_cast<int64_t>(negative);
+        row[user_feature_num + 1] = 0;
+        row += width;
+      }
+      code = (code - 1) / branch;
+    }
+  }
+}
+
+void LayerWiseSampler::sample_batch(const phi::DenseTensor& user_inputs,
+                                    const phi::DenseTensor& target_ids,
+                                    bool with_hierarchy,
+                                    phi::DenseTensor* outputs) {
+  PADDLE_ENFORCE_EQ(user_inputs.dims().size(),
+                    2,
+                    paddle::platform::errors::InvalidArgument(
+                        "user inputs should be 2-D, but got %d-D.",
+                        user_inputs.dims().size()));
+  int64_t input_num = target_ids.numel();
+  int64_t user_feature_num = user_inputs.dims()[1];
+  PADDLE_ENFORCE_EQ(user_inputs.dims()[0],
+                    input_num,
+                    paddle::platform::errors::InvalidArgument(
+                        "user inputs have [%d] rows, but there are [%d] "
+                        "target ids.",
+                        user_inputs.dims()[0],
+                        input_num));
+  outputs->Resize(
+      common::make_ddim({input_num * layer_counts_sum_, user_feature_num + 2}));
+  auto* output_data = outputs->mutable_data<int64_t>(platform::CPUPlace());
+  const auto* user_data = user_inputs.data<int64_t>();
+  const auto* target_data = target_ids.data<int64_t>();
+  uint64_t batch_seed = (static_cast<uint64_t>(seed_) << 32) + batch_seq_++;
+
+  if (thread_pool_ == nullptr || input_num < thread_num_) {
+    SampleRange(user_data,
+                target_data,
+                user_feature_num,
+                with_hierarchy,
+                0,
+                input_num,
+                batch_seed,
+                output_data);
+    return;
+  }
+  std::vector<std::future<void>> tasks;
+  int64_t chunk = (input_num + thread_num_ - 1) / thread_num_;
+  for (int t = 0; t < thread_num_; t++) {
+    int64_t begin = t * chunk;
+    int64_t end = std::min(begin + chunk, input_num);
+    if (begin >= end) {
+      break;
+    }
+    // each chunk has its own engine, the batch is sampled the same for the
+    // same seed and thread num
+    uint64_t chunk_seed = batch_seed * thread_num_ + t;
+    tasks.push_back(thread_pool_->enqueue([=] {
+      SampleRange(user_data,
+                  target_data,
+                  user_feature_num,
+                  with_hierarchy,
+                  begin,
+                  end,
+                  chunk_seed,
+                  output_data);
+    }));
+  }
+  for (auto& task : tasks) {
+    task.get();
+  }
+}
+
 std::vector<uint64_t> float2int(std::vector<double> tmp) {
   std::vector<uint64_t> tmp_int;
   for (auto i : tmp) tmp_int.push_back(uint64_t(i));
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <ThreadPool.h>
+
+#include <memory>
 #include <vector>
 
 #include "paddle/fluid/distributed/index_dataset/index_wrapper.h"
@@ -50,6 +53,18 @@ class IndexSampler {
       const uint16_t sample_slot,
       std::vector<paddle::framework::Record>* src_datas,
       std::vector<paddle::framework::Record>* sample_results) = 0;
+
+  // the number of the threads sample_batch splits a batch over
+  virtual void set_thread_num(int thread_num UNUSED) {}
+  // Like sample, of the int64 user_inputs [N, F] and target_ids [N], into the
+  // int64 outputs [N * samples per target, F + 2] on the CPU.
+  virtual void sample_batch(const phi::DenseTensor& user_inputs UNUSED,
+                            const phi::DenseTensor& target_ids UNUSED,
+                            bool with_hierarchy UNUSED,
+                            phi::DenseTensor* outputs UNUSED) {
+    PADDLE_THROW(paddle::platform::errors::Unimplemented(
+        "sample_batch is not implemented by this IndexSampler."));
+  }
 };
 
 class LayerWiseSampler : public IndexSampler {
@@ -114,6 +129,7 @@ class LayerWiseSampler : public IndexSampler {
       layer_index--;
       idx++;
     }
+    InitLayerArrays();
   }
   std::vector<std::vector<uint64_t>> sample(
       const std::vector<std::vector<uint64_t>>& user_inputs,
@@ -125,7 +141,28 @@ class LayerWiseSampler : public IndexSampler {
       std::vector<paddle::framework::Record>* src_datas,
       std::vector<paddle::framework::Record>* sample_results) override;
 
+  void set_thread_num(int thread_num) override;
+
+  void sample_batch(const phi::DenseTensor& user_inputs,
+                    const phi::DenseTensor& target_ids,
+                    bool with_hierarchy,
+                    phi::DenseTensor* outputs) override;
+
  private:
+  // the node ids of the sampled layers, for sample_batch
+  void InitLayerArrays();
+  // the id of the node of code in the j-th sampled layer
+  uint64_t LayerNodeId(size_t j, uint64_t code) const;
+  // samples the targets [begin, end) of a batch into their rows of outputs
+  void SampleRange(const int64_t* user_inputs,
+                   const int64_t* target_ids,
+                   int64_t user_feature_num,
+                   bool with_hierarchy,
+                   int64_t begin,
+                   int64_t end,
+                   uint64_t seed,
+                   int64_t* outputs) const;
+
   std::vector<int> layer_counts_;
   int64_t layer_counts_sum_{0};
   std::shared_ptr<TreeIndex> tree_{nullptr};
@@ -133,6 +170,17 @@ class LayerWiseSampler : public IndexSampler {
   int start_sample_layer_{1};
   std::vector<std::shared_ptr<paddle::operators::math::Sampler>> sampler_vec_;
   std::vector<std::vector<IndexNode>> layer_ids_;
+
+  // per sampled layer, from the leaf one up like layer_ids_, the ids of its
+  // nodes to sample the negatives from, and the ids of its codes from the
+  // first code of the layer, the fake node id for the invalid codes
+  std::vector<std::vector<uint64_t>> layer_node_ids_;
+  std::vector<std::vector<uint64_t>> layer_code_ids_;
+  std::vector<uint64_t> layer_offsets_;
+  int thread_num_{1};
+  std::unique_ptr<::ThreadPool> thread_pool_;
+  // the number of the sampled batches, to vary the seeds of sample_batch
+  uint64_t batch_seq_{0};
 };
 
 }  // end namespace distributed
@@ -82,6 +82,21 @@ PD_DEFINE_int32(pserver_sparse_table_shard_num,
                 1000,
                 "sparse table shard for save & load");
 
+PD_DEFINE_int32(pserver_pull_sparse_coalesce_window_us,
+                0,
+                "merge pull_sparse of all threads issued within the window "
+                "into one request per server, 0 to disable");
+
+PD_DEFINE_int32(pserver_pull_sparse_coalesce_max_keys,
+                1 << 20,
+                "send a merged pull_sparse early once it holds so many keys");
+
+PD_DEFINE_int32(pserver_pull_sparse_wire_format,
+                0,
+                "wire format of pull_sparse, 0: raw keys and values, "
+                "1: delta varint keys, 2: delta varint keys and bfloat16 "
+                "values, 3: delta varint keys and float16 values");
+
 inline size_t get_sparse_shard(uint32_t shard_num,
                                uint32_t server_num,
                                uint64_t key) {
@@ -308,19 +323,19 @@ int32_t BrpcPsClient::Initialize() {
   std::vector<PSHost> server_list = _env->GetPsServers();
   _server_channels.resize(server_list.size());
   for (size_t i = 0; i < server_list.size(); ++i) {
-    server_ip_port.assign(server_list[i].ip.c_str());
-    server_ip_port.append(":");
-    server_ip_port.append(std::to_string(server_list[i].port));
+    brpc::ChannelOptions server_options = options;
+    server_ip_port = SetupChannelTransport(
+        server_list[i].ip, server_list[i].port, &server_options);
     for (size_t j = 0; j < _server_channels[i].size(); ++j) {
       _server_channels[i][j].reset(new brpc::Channel());
-      if (_server_channels[i][j]->Init(server_ip_port.c_str(), "", &options) !=
-          0) {
+      if (_server_channels[i][j]->Init(
+              server_ip_port.c_str(), "", &server_options) != 0) {
         VLOG(0) << "BrpcPSclient connect to Server:" << server_ip_port
                 << " Failed! Try again.";
         std::string int_ip_port =
             GetIntTypeEndpoint(server_list[i].ip, server_list[i].port);
-        if (_server_channels[i][j]->Init(int_ip_port.c_str(), "", &options) !=
-            0) {
+        if (_server_channels[i][j]->Init(
+                int_ip_port.c_str(), "", &server_options) != 0) {
           LOG(ERROR) << "BrpcPSclient connect to Server:" << int_ip_port
                      << " Failed!";
           return -1;
@@ -374,6 +389,10 @@ int32_t BrpcPsClient::Initialize() {
   // _async_push_sparse_thread.detach();
   _async_push_dense_thread =
       std::thread(std::bind(&BrpcPsClient::PushDenseTaskConsume, this));
+  if (FLAGS_pserver_pull_sparse_coalesce_window_us > 0) {
+    _pull_sparse_coalesce_thread = std::thread(
+        std::bind(&BrpcPsClient::PullSparseCoalesceConsume, this));
+  }
   // for debug
   // _print_thread =
   //    std::thread(std::bind(&BrpcPsClient::PrintQueueSizeThread, this));
@@ -726,6 +745,7 @@ void BrpcPsClient::FinalizeWorker() {
   _running = false;
   _async_push_dense_thread.join();
   _async_push_sparse_thread.join();
+  StopPullSparseCoalesce();
   // _print_thread.join();
   VLOG(0) << "BrpcPsClient::FinalizeWorker begin join server";
   _server.Stop(1000);
@@ -1145,8 +1165,7 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       std::make_shared<CostTimer>("pserver_client_pull_sparse_local");
   size_t request_call_num = _server_channels.size();
 
-  auto shard_sorted_kvs = std::make_shared<
-      std::vector<std::vector<std::pair<uint64_t, float *>>>>();
+  auto shard_sorted_kvs = std::make_shared<ShardSortedKvs>();
   shard_sorted_kvs->resize(request_call_num);
 
   const auto &server_param = _config.server_param().downpour_server_param();
@@ -1164,14 +1183,67 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
     shard_sorted_kvs->at(shard_id).push_back({keys[i], select_values[i]});
   }
 
+  auto promise = std::make_shared<std::promise<int32_t>>();
+  std::future<int> fut = promise->get_future();
+  PullSparseBatch batch;
+  batch.shard_sorted_kvs = shard_sorted_kvs;
+  batch.promises.push_back(promise);
+  batch.timers.push_back(timer);
+  batch.key_num = num;
+
+  if (FLAGS_pserver_pull_sparse_coalesce_window_us > 0) {
+    std::unique_lock<std::mutex> lock(_pull_sparse_batch_mutex);
+    if (_running) {
+      auto batch_key = std::make_pair(table_id, is_training);
+      auto itr = _pull_sparse_batches.find(batch_key);
+      if (itr == _pull_sparse_batches.end()) {
+        batch.open_time = std::chrono::steady_clock::now();
+        _pull_sparse_batches.emplace(batch_key, std::move(batch));
+        _pull_sparse_batch_cond.notify_one();
+        return fut;
+      }
+      auto &pending = itr->second;
+      for (size_t i = 0; i < request_call_num; ++i) {
+        auto &kvs = shard_sorted_kvs->at(i);
+        pending.shard_sorted_kvs->at(i).insert(
+            pending.shard_sorted_kvs->at(i).end(), kvs.begin(), kvs.end());
+      }
+      pending.promises.push_back(promise);
+      pending.timers.push_back(timer);
+      pending.key_num += num;
+      if (pending.key_num <
+          static_cast<size_t>(FLAGS_pserver_pull_sparse_coalesce_max_keys)) {
+        return fut;
+      }
+      // the batch is full, send it from this thread without waiting
+      batch = std::move(pending);
+      _pull_sparse_batches.erase(itr);
+    }
+  }
+  SendPullSparse(table_id, is_training, &batch);
+  return fut;
+}
+
+void BrpcPsClient::SendPullSparse(size_t table_id,
+                                  bool is_training,
+                                  PullSparseBatch *batch) {
+  size_t request_call_num = _server_channels.size();
+  auto shard_sorted_kvs = batch->shard_sorted_kvs;
   auto *accessor = GetTableAccessor(table_id);
 
   size_t value_size = accessor->GetAccessorInfo().select_size;
+  int32_t format = FLAGS_pserver_pull_sparse_wire_format;
+  size_t value_dim = value_size / sizeof(float);
+  // bytes of one value on the wire
+  size_t wire_size = value_dim * PullSparseValueBytes(format);
 
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
-      request_call_num, [shard_sorted_kvs, value_size](void *done) {
+      request_call_num,
+      [shard_sorted_kvs, value_size, value_dim, wire_size, format](
+          void *done) {
         int ret = 0;
         auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+        std::vector<char> wire_value(wire_size);
         for (size_t i = 0; i < shard_sorted_kvs->size(); ++i) {
           if (closure->check_response(i, PS_PULL_SPARSE_TABLE) != 0) {
             ret = -1;
@@ -1189,25 +1261,32 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
               memcpy(reinterpret_cast<void *>(kv_pair.second),
                      reinterpret_cast<void *>(last_value_data),
                      value_size);
-            } else {
-              last_key = kv_pair.first;
-              last_value_data = kv_pair.second;
-              if (value_size !=
-                  io_buffer_itr.copy_and_forward(
-                      reinterpret_cast<void *>(last_value_data), value_size)) {
-                LOG(WARNING) << "res data is lack or not in format";
-                ret = -1;
-                break;
-              }
+              continue;
+            }
+            last_key = kv_pair.first;
+            last_value_data = kv_pair.second;
+            bool half = wire_size != value_size;
+            void *dst = half ? wire_value.data()
+                             : reinterpret_cast<void *>(last_value_data);
+            if (wire_size != io_buffer_itr.copy_and_forward(dst, wire_size)) {
+              LOG(WARNING) << "res data is lack or not in format";
+              ret = -1;
+              break;
+            }
+            if (half) {
+              DecodePullSparseValues(
+                  wire_value.data(), value_dim, format, last_value_data);
             }
           }
         }
         closure->set_promise_value(ret);
       });
-  closure->add_timer(timer);
-  auto promise = std::make_shared<std::promise<int32_t>>();
-  closure->add_promise(promise);
-  std::future<int> fut = promise->get_future();
+  for (auto &timer : batch->timers) {
+    closure->add_timer(timer);
+  }
+  for (auto &promise : batch->promises) {
+    closure->add_promise(promise);
+  }
 
   for (size_t i = 0; i < request_call_num; ++i) {
     auto &sorted_kvs = shard_sorted_kvs->at(i);
@@ -1224,15 +1303,16 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
     auto &request_buffer = closure->cntl(i)->request_attachment();
 
     request_buffer.append(reinterpret_cast<void *>(&is_training), sizeof(bool));
+    std::vector<uint64_t> unique_keys;
     std::vector<uint32_t> keys_counter;
+    unique_keys.reserve(sorted_kv_size);
     keys_counter.reserve(sorted_kv_size);
 
     for (size_t kv_idx = 0; kv_idx < sorted_kv_size; ++kv_idx) {
       ++kv_request_count;
       uint32_t keys = 1;
       last_key = sorted_kvs[kv_idx].first;
-      request_buffer.append(reinterpret_cast<void *>(&last_key),
-                            sizeof(uint64_t));
+      unique_keys.push_back(last_key);
       while (kv_idx < sorted_kv_size - 1 &&
              last_key == sorted_kvs[kv_idx + 1].first) {
         ++kv_idx;
@@ -1241,8 +1321,19 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       keys_counter.push_back(keys);
     }
 
-    request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
-                          sizeof(uint32_t) * keys_counter.size());
+    if (format == kPullSparseRaw) {
+      request_buffer.append(reinterpret_cast<void *>(unique_keys.data()),
+                            sizeof(uint64_t) * unique_keys.size());
+      request_buffer.append(reinterpret_cast<void *>(keys_counter.data()),
+                            sizeof(uint32_t) * keys_counter.size());
+    } else {
+      std::string encoded;
+      EncodePullSparseKeys(unique_keys.data(),
+                           keys_counter.data(),
+                           unique_keys.size(),
+                           &encoded);
+      request_buffer.append(encoded);
+    }
 
     if (kv_request_count == 0) {
       closure->Run();
@@ -1252,13 +1343,61 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       closure->request(i)->set_client_id(_client_id);
       closure->request(i)->add_params((char *)&kv_request_count,  // NOLINT
                                       sizeof(uint32_t));
+      if (format != kPullSparseRaw) {
+        closure->request(i)->add_params((char *)&format,  // NOLINT
+                                        sizeof(int32_t));
+      }
       PsService_Stub rpc_stub(GetCmdChannel(i));
       closure->cntl(i)->set_log_id(butil::gettimeofday_ms());
       rpc_stub.service(
           closure->cntl(i), closure->request(i), closure->response(i), closure);
     }
   }
-  return fut;
+}
+
+void BrpcPsClient::PullSparseCoalesceConsume() {
+  auto window =
+      std::chrono::microseconds(FLAGS_pserver_pull_sparse_coalesce_window_us);
+  std::unique_lock<std::mutex> lock(_pull_sparse_batch_mutex);
+  while (_running || !_pull_sparse_batches.empty()) {
+    if (_pull_sparse_batches.empty()) {
+      _pull_sparse_batch_cond.wait_for(lock, std::chrono::milliseconds(100));
+      continue;
+    }
+    auto now = std::chrono::steady_clock::now();
+    auto deadline = now + window;
+    std::vector<std::pair<std::pair<size_t, bool>, PullSparseBatch>> ready;
+    for (auto itr = _pull_sparse_batches.begin();
+         itr != _pull_sparse_batches.end();) {
+      auto close_time = itr->second.open_time + window;
+      if (!_running || close_time <= now) {
+        ready.emplace_back(itr->first, std::move(itr->second));
+        itr = _pull_sparse_batches.erase(itr);
+      } else {
+        deadline = std::min(deadline, close_time);
+        ++itr;
+      }
+    }
+    if (ready.empty()) {
+      _pull_sparse_batch_cond.wait_until(lock, deadline);
+      continue;
+    }
+    lock.unlock();
+    for (auto &item : ready) {
+      SendPullSparse(item.first.first, item.first.second, &item.second);
+    }
+    lock.lock();
+  }
+}
+
+void BrpcPsClient::StopPullSparseCoalesce() {
+  {
+    std::lock_guard<std::mutex> lock(_pull_sparse_batch_mutex);
+    _pull_sparse_batch_cond.notify_all();
+  }
+  if (_pull_sparse_coalesce_thread.joinable()) {
+    _pull_sparse_coalesce_thread.join();
+  }
 }
 
 // for GEO
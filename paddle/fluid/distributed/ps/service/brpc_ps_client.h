@@ -16,8 +16,13 @@
 
 #include <ThreadPool.h>
 
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "brpc/channel.h"
@@ -206,6 +211,7 @@ class BrpcPsClient : public PSClient {
     if (_async_push_sparse_thread.joinable()) {
       _async_push_sparse_thread.join();
     }
+    StopPullSparseCoalesce();
     if (_server_started) {
       _server.Stop(1000);
       _server.Join();
@@ -363,6 +369,28 @@ class BrpcPsClient : public PSClient {
 
   std::thread _print_thread;
 
+  // pull_sparse of all worker threads is merged per (table_id, is_training)
+  // for FLAGS_pserver_pull_sparse_coalesce_window_us, so that duplicated keys
+  // are requested once and every server gets one request per window
+  typedef std::vector<std::vector<std::pair<uint64_t, float *>>>
+      ShardSortedKvs;
+  struct PullSparseBatch {
+    std::shared_ptr<ShardSortedKvs> shard_sorted_kvs;
+    std::vector<std::shared_ptr<std::promise<int32_t>>> promises;
+    std::vector<std::shared_ptr<CostTimer>> timers;
+    size_t key_num = 0;
+    std::chrono::steady_clock::time_point open_time;
+  };
+  void SendPullSparse(size_t table_id,
+                      bool is_training,
+                      PullSparseBatch *batch);
+  void PullSparseCoalesceConsume();
+  void StopPullSparseCoalesce();
+  std::thread _pull_sparse_coalesce_thread;
+  std::mutex _pull_sparse_batch_mutex;
+  std::condition_variable _pull_sparse_batch_cond;
+  std::map<std::pair<size_t, bool>, PullSparseBatch> _pull_sparse_batches;
+
   int PushSparseAsyncShardMerge(
       std::vector<std::shared_ptr<SparseAsyncTask>> &task_list,  // NOLINT
       std::vector<int> &request_kv_num,                          // NOLINT
@@ -82,6 +82,7 @@ uint64_t BrpcPsServer::Start(const std::string &ip, uint32_t port) {
   int num_threads = std::thread::hardware_concurrency();
   auto trainers = _environment->GetTrainers();
   options.num_threads = trainers > num_threads ? trainers : num_threads;
+  SetupServerTransport(&options);
 
   if (_server.Start(ip_port.c_str(), &options) != 0) {
     VLOG(0) << "BrpcPsServer start failed, ip_port= " << ip_port
@@ -94,6 +95,9 @@ uint64_t BrpcPsServer::Start(const std::string &ip, uint32_t port) {
       return 0;
     }
   }
+  if (FLAGS_pserver_transport == "local") {
+    StartLocalServer(port, options);
+  }
 
   _environment->RegistePsServer(ip, port, _rank);
   cv_.wait(lock, [&] { return stoped_; });
@@ -105,6 +109,23 @@ uint64_t BrpcPsServer::Start(const std::string &ip, uint32_t port) {
   return host.rank;
 }
 
+void BrpcPsServer::StartLocalServer(uint32_t port,
+                                    const brpc::ServerOptions &options) {
+  // co-located workers reach the service through a unix domain socket,
+  // workers on other hosts keep using tcp, see SetupChannelTransport
+  std::string socket_path = GetLocalSocketPath(port);
+  unlink(socket_path.c_str());
+  if (_local_server.AddService(_service.get(),
+                               brpc::SERVER_DOESNT_OWN_SERVICE) != 0 ||
+      _local_server.Start(("unix:" + socket_path).c_str(), &options) != 0) {
+    LOG(WARNING) << "BrpcPsServer start local transport failed, path= "
+                 << socket_path << ", local workers fall back to tcp";
+    return;
+  }
+  _local_socket_path = socket_path;
+  VLOG(0) << "BrpcPsServer local transport listens on " << socket_path;
+}
+
 int32_t BrpcPsServer::StartS2S() {
   brpc::ChannelOptions options;
   options.protocol = "baidu_std";
@@ -533,9 +554,32 @@ int32_t BrpcPsService::PullSparse(Table *table,
   const void *data = cntl->request_attachment().fetch(
       const_cast<char *>(req_buffer.data()), req_buffer_size);
 
+  int format = kPullSparseRaw;
+  if (request.params_size() > 1) {
+    format = *(reinterpret_cast<const int32_t *>(request.params(1).c_str()));
+  }
+
   auto value = PullSparseValue(num, dim);
 
-  value.DeserializeFromBytes(const_cast<void *>(data));
+  thread_local std::vector<uint64_t> keys;
+  thread_local std::vector<uint32_t> frequencies;
+  if (format == kPullSparseRaw) {
+    value.DeserializeFromBytes(const_cast<void *>(data));
+  } else {
+    // |---isTraining---|---delta varint keys---|---varint frequencies---|
+    const char *begin = reinterpret_cast<const char *>(data);
+    if (!DecodePullSparseKeys(begin + sizeof(bool),
+                              req_buffer_size - sizeof(bool),
+                              num,
+                              &keys,
+                              &frequencies)) {
+      set_response_code(response, -1, "pull_sparse keys are not in format");
+      return 0;
+    }
+    value.is_training_ = *reinterpret_cast<const bool *>(begin);
+    value.feasigns_ = keys.data();
+    value.frequencies_ = frequencies.data();
+  }
 
   auto res_data = butil::get_object<std::vector<float>>();
   res_data->resize(num * dim);
@@ -546,8 +590,10 @@ int32_t BrpcPsService::PullSparse(Table *table,
   table->Pull(table_context);
   // table->PullSparse(res_data->data(), value);
 
-  cntl->response_attachment().append(reinterpret_cast<char *>(res_data->data()),
-                                     res_data->size() * sizeof(float));
+  EncodePullSparseValues(res_data->data(),
+                         res_data->size(),
+                         format,
+                         &cntl->response_attachment());
   butil::return_object(res_data);
   return 0;
 }
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <unistd.h>
+
+#include <string>
+
 #include "brpc/channel.h"
 #include "brpc/controller.h"
 #include "brpc/server.h"
@@ -49,6 +53,12 @@ class BrpcPsServer : public PSServer {
 
     _server.Stop(1000);
     _server.Join();
+    if (!_local_socket_path.empty()) {
+      _local_server.Stop(1000);
+      _local_server.Join();
+      unlink(_local_socket_path.c_str());
+      _local_socket_path.clear();
+    }
     return 0;
   }
   int32_t Port();
@@ -62,10 +72,14 @@ class BrpcPsServer : public PSServer {
 
  private:
   virtual int32_t Initialize();
+  void StartLocalServer(uint32_t port, const brpc::ServerOptions &options);
   mutable std::mutex mutex_;
   std::condition_variable cv_;
   bool stoped_ = false;
   brpc::Server _server;
+  // serves co-located workers when FLAGS_pserver_transport is local
+  brpc::Server _local_server;
+  std::string _local_socket_path;
   std::shared_ptr<PsBaseService> _service;
   std::vector<std::shared_ptr<brpc::Channel>> _pserver_channels;
 };
@@ -16,9 +16,13 @@ limitations under the License. */
 
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <unistd.h>
 
+#include "butil/endpoint.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
 
 namespace paddle {
 namespace framework {
@@ -30,6 +34,13 @@ namespace phi {
 class DenseTensor;
 }  // namespace phi
 
+PD_DEFINE_string(pserver_transport,
+                 "tcp",
+                 "transport between worker and server[tcp:local:rdma]");
+PD_DEFINE_string(pserver_local_socket_dir,
+                 "/dev/shm",
+                 "directory of the unix sockets used by local transport");
+
 namespace paddle {
 namespace distributed {
 
@@ -88,6 +99,36 @@ void SerializeToMultiVarMsgAndIOBuf(
   }
 }
 
+#ifdef PADDLE_WITH_CUDA
+namespace {
+
+void DeleteHostBuffer(void* data) { delete[] static_cast<char*>(data); }
+
+// Copies the tensor to a host buffer which is handed over to the iobuf and
+// released after the message is sent, saving a copy of large activations.
+void AppendDeviceTensor(const phi::DenseTensor& tensor,
+                        const platform::DeviceContext& ctx,
+                        butil::IOBuf* iobuf) {
+  auto data_len = tensor.numel() * phi::SizeOf(tensor.dtype());
+  iobuf->append(reinterpret_cast<const char*>(&data_len), 8);
+  if (data_len == 0) {
+    return;
+  }
+  char* temp_ptr = new char[data_len];  // NOLINT
+  auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
+  // the copy to pageable memory returns after it is done
+  memory::Copy(platform::CPUPlace(),
+               temp_ptr,
+               tensor.place(),
+               tensor.data(),
+               data_len,
+               stream);
+  iobuf->append_user_data(temp_ptr, data_len, DeleteHostBuffer);
+}
+
+}  // namespace
+#endif
+
 void SerializeLodTensor(framework::Variable* var,
                         const platform::DeviceContext& ctx,
                         VarMsg* var_msg,
@@ -116,21 +157,7 @@ void SerializeLodTensor(framework::Variable* var,
     iobuf->append(reinterpret_cast<const char*>(tensor->data()), data_len);
   } else {
 #ifdef PADDLE_WITH_CUDA
-    char* temp_ptr =
-        new char[tensor->numel() * phi::SizeOf(tensor->dtype())];  // NOLINT
-    auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
-    memory::Copy(
-        platform::CPUPlace(),
-        temp_ptr,
-        tensor->place(),
-        tensor->data(),
-        tensor->numel() * framework::SizeOfType(
-                              framework::TransToProtoVarType(tensor->dtype())),
-        stream);
-    auto data_len = tensor->numel() * phi::SizeOf(tensor->dtype());
-    iobuf->append(reinterpret_cast<const char*>(&data_len), 8);
-    iobuf->append(reinterpret_cast<const char*>(temp_ptr), data_len);
-    delete[] temp_ptr;
+    AppendDeviceTensor(*tensor, ctx, iobuf);
 #endif
   }
 }
@@ -163,21 +190,7 @@ void SerializeSelectedRows(framework::Variable* var,
     iobuf->append(reinterpret_cast<const char*>(tensor->data()), data_len);
   } else {
 #ifdef PADDLE_WITH_CUDA
-    char* temp_ptr =
-        new char[tensor->numel() * phi::SizeOf(tensor->dtype())];  // NOLINT
-    auto stream = reinterpret_cast<const phi::GPUContext&>(ctx).stream();
-    memory::Copy(
-        platform::CPUPlace(),
-        temp_ptr,
-        tensor->place(),
-        tensor->data(),
-        tensor->numel() * framework::SizeOfType(
-                              framework::TransToProtoVarType(tensor->dtype())),
-        stream);
-    auto data_len = tensor->numel() * phi::SizeOf(tensor->dtype());
-    iobuf->append(reinterpret_cast<const char*>(&data_len), 8);
-    iobuf->append(reinterpret_cast<const char*>(temp_ptr), data_len);
-    delete[] temp_ptr;
+    AppendDeviceTensor(*tensor, ctx, iobuf);
 #endif
   }
 }
@@ -222,6 +235,30 @@ void DeserializeFromMultiVarMsgAndIOBuf(const MultiVarMsg& multi_msg,
   }
 }
 
+bool PeekFloatFromMultiVarMsgAndIOBuf(const MultiVarMsg& multi_msg,
+                                      const butil::IOBuf* iobuf,
+                                      const std::string& var_name,
+                                      float* value) {
+  butil::IOBufBytesIterator io_buffer_itr(*iobuf);
+  for (int var_index = 0; var_index < multi_msg.send_var_names_size();
+       ++var_index) {
+    // each var is the data length in 8 bytes followed by the data
+    uint64_t data_len = 0;
+    if (io_buffer_itr.copy_and_forward(&data_len, 8) != 8) {
+      return false;
+    }
+    if (multi_msg.var_messages(var_index).varname() == var_name) {
+      return data_len >= sizeof(float) &&
+             io_buffer_itr.copy_and_forward(value, sizeof(float)) ==
+                 sizeof(float);
+    }
+    if (io_buffer_itr.forward(data_len) != data_len) {
+      return false;
+    }
+  }
+  return false;
+}
+
 void DeserializeLodTensor(framework::Variable* var,
                           const VarMsg& msg,
                           butil::IOBufBytesIterator& io_buffer_itr,  // NOLINT
@@ -343,5 +380,162 @@ std::string GetIntTypeEndpoint(const std::string& ip, const uint32_t& port) {
   return int_ip_port;
 }
 
+bool IsLocalHost(const std::string& ip) {
+  butil::ip_t host_ip;
+  if (butil::hostname2ip(ip.c_str(), &host_ip) != 0 &&
+      butil::str2ip(ip.c_str(), &host_ip) != 0) {
+    return false;
+  }
+  return host_ip == butil::my_ip() ||
+         butil::ip2int(host_ip) == htonl(INADDR_LOOPBACK);
+}
+
+std::string GetLocalSocketPath(uint32_t port) {
+  return FLAGS_pserver_local_socket_dir + "/paddle_pserver_" +
+         std::to_string(port) + ".sock";
+}
+
+std::string SetupChannelTransport(const std::string& ip,
+                                  uint32_t port,
+                                  brpc::ChannelOptions* options) {
+  std::string ip_port = ip + ":" + std::to_string(port);
+  if (FLAGS_pserver_transport == "local") {
+    std::string socket_path = GetLocalSocketPath(port);
+    // the socket only exists when the server runs on this host
+    if (IsLocalHost(ip) && access(socket_path.c_str(), F_OK) == 0) {
+      VLOG(1) << "use local transport for " << ip_port << " : "
+              << socket_path;
+      return "unix:" + socket_path;
+    }
+  } else if (FLAGS_pserver_transport == "rdma") {
+#ifdef PADDLE_WITH_BRPC_RDMA
+    options->use_rdma = true;
+#else
+    LOG(WARNING) << "paddle is not built WITH_BRPC_RDMA, use tcp for "
+                 << ip_port;
+#endif
+  }
+  return ip_port;
+}
+
+void SetupServerTransport(brpc::ServerOptions* options) {
+  if (FLAGS_pserver_transport == "rdma") {
+#ifdef PADDLE_WITH_BRPC_RDMA
+    options->use_rdma = true;
+#else
+    LOG(WARNING) << "paddle is not built WITH_BRPC_RDMA, server uses tcp";
+#endif
+  }
+}
+
+namespace {
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(const char** data, const char* end, uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && *data < end; shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(*(*data)++);
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+size_t PullSparseValueBytes(int format) {
+  if (format == kPullSparseBFloat16 || format == kPullSparseFloat16) {
+    return sizeof(uint16_t);
+  }
+  return sizeof(float);
+}
+
+void EncodePullSparseKeys(const uint64_t* keys,
+                          const uint32_t* counts,
+                          size_t num,
+                          std::string* out) {
+  // most deltas and counts take one or two bytes
+  out->reserve(out->size() + num * 4);
+  uint64_t last_key = 0;
+  for (size_t i = 0; i < num; ++i) {
+    AppendVarint(keys[i] - last_key, out);
+    last_key = keys[i];
+  }
+  for (size_t i = 0; i < num; ++i) {
+    AppendVarint(counts[i], out);
+  }
+}
+
+bool DecodePullSparseKeys(const char* data,
+                          size_t size,
+                          size_t num,
+                          std::vector<uint64_t>* keys,
+                          std::vector<uint32_t>* counts) {
+  const char* end = data + size;
+  keys->resize(num);
+  counts->resize(num);
+  uint64_t key = 0;
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t delta = 0;
+    if (!ReadVarint(&data, end, &delta)) {
+      return false;
+    }
+    key += delta;
+    (*keys)[i] = key;
+  }
+  for (size_t i = 0; i < num; ++i) {
+    uint64_t count = 0;
+    if (!ReadVarint(&data, end, &count)) {
+      return false;
+    }
+    (*counts)[i] = static_cast<uint32_t>(count);
+  }
+  return true;
+}
+
+void EncodePullSparseValues(const float* values,
+                            size_t num,
+                            int format,
+                            butil::IOBuf* out) {
+  if (format == kPullSparseBFloat16) {
+    std::vector<phi::dtype::bfloat16> half(values, values + num);
+    out->append(half.data(), num * sizeof(uint16_t));
+  } else if (format == kPullSparseFloat16) {
+    std::vector<phi::dtype::float16> half(values, values + num);
+    out->append(half.data(), num * sizeof(uint16_t));
+  } else {
+    out->append(values, num * sizeof(float));
+  }
+}
+
+void DecodePullSparseValues(const void* data,
+                            size_t num,
+                            int format,
+                            float* values) {
+  if (format == kPullSparseBFloat16) {
+    auto* half = reinterpret_cast<const phi::dtype::bfloat16*>(data);
+    for (size_t i = 0; i < num; ++i) {
+      values[i] = static_cast<float>(half[i]);
+    }
+  } else if (format == kPullSparseFloat16) {
+    auto* half = reinterpret_cast<const phi::dtype::float16*>(data);
+    for (size_t i = 0; i < num; ++i) {
+      values[i] = static_cast<float>(half[i]);
+    }
+  } else {
+    memcpy(values, data, num * sizeof(float));
+  }
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -21,6 +21,8 @@ limitations under the License. */
 #include <vector>
 
 #include "brpc/channel.h"
+#include "brpc/server.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/lod_tensor.h"
@@ -45,6 +47,8 @@ class Variable;
 }  // namespace framework
 }  // namespace paddle
 
+PD_DECLARE_string(pserver_transport);
+
 namespace paddle {
 namespace distributed {
 
@@ -82,6 +86,13 @@ void DeserializeFromMultiVarMsgAndIOBuf(const MultiVarMsg& multi_msg,
                                         const platform::DeviceContext& ctx,
                                         const framework::Scope* scope);
 
+// Read the first float of the tensor var_name without deserializing the
+// message, returns false if the message does not hold it
+bool PeekFloatFromMultiVarMsgAndIOBuf(const MultiVarMsg& multi_msg,
+                                      const butil::IOBuf* iobuf,
+                                      const std::string& var_name,
+                                      float* value);
+
 void DeserializeLodTensor(framework::Variable* var,
                           const VarMsg& msg,
                           butil::IOBufBytesIterator& iobuf,  // NOLINT
@@ -94,5 +105,58 @@ void DeserializeSelectedRows(framework::Variable* var,
 
 std::string GetIntTypeEndpoint(const std::string& ip, const uint32_t& port);
 
+// Transport between worker and server, selected by FLAGS_pserver_transport:
+//   tcp:   brpc over TCP
+//   local: a server also listens on a unix domain socket, and a client uses
+//          it for the servers on its own host, skipping the TCP/IP stack
+//   rdma:  brpc RDMA endpoints, needs paddle built WITH_BRPC_RDMA
+bool IsLocalHost(const std::string& ip);
+std::string GetLocalSocketPath(uint32_t port);
+// returns the endpoint to connect for ip:port and fills the transport options
+std::string SetupChannelTransport(const std::string& ip,
+                                  uint32_t port,
+                                  brpc::ChannelOptions* options);
+void SetupServerTransport(brpc::ServerOptions* options);
+
+// Wire formats of the pull_sparse requests and responses, selected by the
+// client with FLAGS_pserver_pull_sparse_wire_format and sent in the request
+// params, so that the server answers in the same format:
+//   raw:       uint64 keys and uint32 key counts, float values
+//   key_delta: the sorted keys as varint deltas and the counts as varints
+//   bfloat16:  key_delta, and the values in bfloat16
+//   float16:   key_delta, and the values in float16
+enum PullSparseWireFormat {
+  kPullSparseRaw = 0,
+  kPullSparseKeyDelta = 1,
+  kPullSparseBFloat16 = 2,
+  kPullSparseFloat16 = 3,
+};
+
+// bytes of one value on the wire
+size_t PullSparseValueBytes(int format);
+
+// keys are unique and ascending, counts[i] is the number of pulls of keys[i]
+void EncodePullSparseKeys(const uint64_t* keys,
+                          const uint32_t* counts,
+                          size_t num,
+                          std::string* out);
+// returns false if data does not hold num keys and counts
+bool DecodePullSparseKeys(const char* data,
+                          size_t size,
+                          size_t num,
+                          std::vector<uint64_t>* keys,
+                          std::vector<uint32_t>* counts);
+
+// appends num values in format to out
+void EncodePullSparseValues(const float* values,
+                            size_t num,
+                            int format,
+                            butil::IOBuf* out);
+// decodes num values of format, PullSparseValueBytes(format) * num bytes
+void DecodePullSparseValues(const void* data,
+                            size_t num,
+                            int format,
+                            float* values);
+
 }  // namespace distributed
 }  // namespace paddle
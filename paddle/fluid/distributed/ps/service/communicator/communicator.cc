@@ -16,6 +16,10 @@ limitations under the License. */
 
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
 #include "paddle/fluid/distributed/ps/wrapper/fleet.h"
@@ -505,7 +509,11 @@ void AsyncCommunicator::SendByCommunicator() {
       int merged_var_num = 0;
       int wait_times = 0;
       while (merged_var_num < max_merge_var_num_) {
-        if (check_queue->Size() == 0) {
+        // drain every grad ready in the first queue at once, the other vars
+        // of the ctx are pushed along with it by Send
+        size_t ready_num = check_queue->PopBatch(
+            &vars[0], static_cast<size_t>(max_merge_var_num_ - merged_var_num));
+        if (ready_num == 0) {
           VLOG(4) << "wait_times -> " << wait_times;
           if (wait_times >= send_wait_times_) {
             break;
@@ -515,12 +523,12 @@ void AsyncCommunicator::SendByCommunicator() {
           continue;
         } else {
           wait_times = 0;
-          for (size_t i = 0; i < var_nums; i++) {
+          for (size_t i = 1; i < var_nums; i++) {
             auto &var_name = varnames[i];
             auto &var_queue = send_varname_to_queue_[var_name];
-            vars[i].push_back(var_queue->Pop());
+            var_queue->PopN(&vars[i], ready_num);
           }
-          merged_var_num++;
+          merged_var_num += static_cast<int>(ready_num);
         }
       }
       if (merged_var_num == 0) return;
@@ -972,7 +980,7 @@ void HalfAsyncCommunicator::SendByCommunicator() {
       for (size_t i = 0; i < var_nums; i++) {
         auto &var_name = varnames[i];
         auto &var_queue = send_varname_to_queue_[var_name];
-        for (int j = 0; j < batches; j++) vars[i].push_back(var_queue->Pop());
+        var_queue->PopN(&vars[i], batches);
         MergeVars<float>(var_name, vars[i], send_scope_.get(), 1);
       }
 
@@ -1056,7 +1064,7 @@ void GeoCommunicator::Send(
     auto &sparse_ids_set = iter.second;
     auto sparse_ids_vec = std::make_shared<std::vector<int64_t>>();
     sparse_ids_vec->assign(sparse_ids_set.begin(), sparse_ids_set.end());
-    sparse_id_queues_.at(key)->Put(sparse_ids_vec);
+    sparse_id_queues_.at(key)->Push(sparse_ids_vec);
     VLOG(3) << "push " << sparse_ids_vec->size() << " ids to " << key
             << "'s queue";
   }
@@ -1094,13 +1102,12 @@ void GeoCommunicator::InitImpl(const RpcCtxMap &send_varname_to_ctx,
     }
     for (auto &splited_var : ctx.splited_varnames) {  // embedding_0.w_0.block0
       parallel_task_nums_ += 1;
-      sparse_id_queues_.insert(
-          std::pair<std::string,
-                    ::paddle::framework::Channel<
-                        std::shared_ptr<std::vector<int64_t>>>>(
-              splited_var,
-              ::paddle::framework::MakeChannel<
-                  std::shared_ptr<std::vector<int64_t>>>(send_queue_size_)));
+      sparse_id_queues_.insert(std::make_pair(
+          splited_var,
+          std::make_shared<
+              BlockingQueue<std::shared_ptr<std::vector<int64_t>>>>(
+              send_queue_size_)));
+      geo_sparse_residual_ids_[splited_var];
     }
   }
   send_threadpool_ = std::make_unique<ThreadPool>(thread_pool_size_);
@@ -1294,16 +1301,20 @@ std::vector<int64_t> GeoCommunicator::MergeSparseIds(
   while (merge_num <
          static_cast<size_t>(max_merge_var_num_)) {  // -> geo_step: 100
     VLOG(3) << "Merge Number of " << send_varname << " = " << merge_num;
-    if (sparse_id_queues_.at(send_varname)->Size() > 0) {
+    std::vector<std::shared_ptr<std::vector<int64_t>>> pop_ids_list;
+    sparse_id_queues_.at(send_varname)
+        ->PopBatch(&pop_ids_list,
+                   static_cast<size_t>(max_merge_var_num_) - merge_num);
+    if (!pop_ids_list.empty()) {
       wait_times = 0;
-      std::shared_ptr<std::vector<int64_t>> pop_ids = nullptr;
-      sparse_id_queues_.at(send_varname)->Get(pop_ids);
-      for (auto &pop_id : *pop_ids) {
-        sparse_ids.insert(pop_id);
+      for (auto &pop_ids : pop_ids_list) {
+        for (auto &pop_id : *pop_ids) {
+          sparse_ids.insert(pop_id);
+        }
       }
-      merge_num += 1;
+      merge_num += pop_ids_list.size();
       VLOG(3) << "sparse_id_queues_(" << send_varname << ") pushed";
-    } else if (sparse_id_queues_.at(send_varname)->Size() == 0) {
+    } else {
       VLOG(3) << "wait_times -> " << wait_times;
       if (wait_times >= static_cast<size_t>(send_wait_times_)) {
         break;
@@ -1325,6 +1336,10 @@ void GeoCommunicator::SendSparse(const std::string &varname,
   platform::RecordEvent record_event("GeoCommunicator->SendSparse",
                                      platform::TracerEventType::Communication,
                                      1);
+  float topk_ratio = GeoSparseTopkRatio(table_id);
+  if (topk_ratio < 1.0f) {
+    SelectTopkSparseIds(varname, topk_ratio, &sparse_ids);
+  }
   if (sparse_ids.empty()) {
     return;
   }
@@ -1405,6 +1420,83 @@ void GeoCommunicator::SendSparse(const std::string &varname,
   return;
 }
 
+void GeoCommunicator::ParseGeoSparseTopkRatio(const std::string &config) {
+  for (auto &item : ::paddle::string::split_string(config, ",")) {
+    auto pos = item.find(':');
+    float ratio =
+        std::stof(pos == std::string::npos ? item : item.substr(pos + 1));
+    PADDLE_ENFORCE_EQ(
+        ratio > 0.0f && ratio <= 1.0f,
+        true,
+        platform::errors::InvalidArgument(
+            "communicator_geo_sparse_topk_ratio should be in (0, 1], "
+            "but got %s.",
+            item));
+    if (pos == std::string::npos) {
+      geo_sparse_topk_ratio_ = ratio;
+    } else {
+      geo_table_topk_ratio_[std::stoi(item.substr(0, pos))] = ratio;
+    }
+  }
+  VLOG(0) << "GeoCommunicator sparse topk ratio: " << config;
+}
+
+float GeoCommunicator::GeoSparseTopkRatio(int table_id) const {
+  auto iter = geo_table_topk_ratio_.find(table_id);
+  return iter == geo_table_topk_ratio_.end() ? geo_sparse_topk_ratio_
+                                             : iter->second;
+}
+
+void GeoCommunicator::SelectTopkSparseIds(const std::string &varname,
+                                          float topk_ratio,
+                                          std::vector<int64_t> *sparse_ids) {
+  auto &residual_ids = geo_sparse_residual_ids_.at(varname);
+  residual_ids.insert(sparse_ids->begin(), sparse_ids->end());
+  sparse_ids->clear();
+  if (residual_ids.empty()) {
+    return;
+  }
+
+  std::string param_name = SplitedGradToParam(varname);
+  auto &t_latest = recv_scope_->FindVar(param_name)->Get<phi::DenseTensor>();
+  auto &t_old = old_scope_->FindVar(param_name)->Get<phi::DenseTensor>();
+  auto dims1 = t_latest.dims()[1];
+
+  // squared l2 norm of latest - old of every candidate row
+  std::vector<std::pair<float, int64_t>> scored_ids;
+  scored_ids.reserve(residual_ids.size());
+  for (auto id : residual_ids) {
+    const float *latest_data = t_latest.data<float>() + id * dims1;
+    const float *old_data = t_old.data<float>() + id * dims1;
+    float norm = 0.0f;
+    for (int64_t d = 0; d < dims1; ++d) {
+      float diff = latest_data[d] - old_data[d];
+      norm += diff * diff;
+    }
+    scored_ids.emplace_back(norm, id);
+  }
+
+  size_t topk = static_cast<size_t>(std::ceil(topk_ratio * scored_ids.size()));
+  topk = std::min(std::max(topk, static_cast<size_t>(1)), scored_ids.size());
+  std::nth_element(scored_ids.begin(),
+                   scored_ids.begin() + topk - 1,
+                   scored_ids.end(),
+                   std::greater<std::pair<float, int64_t>>());
+  sparse_ids->reserve(topk);
+  for (size_t i = 0; i < scored_ids.size(); ++i) {
+    // rows already in sync carry no residual
+    if (i < topk || scored_ids[i].first == 0.0f) {
+      residual_ids.erase(scored_ids[i].second);
+    }
+    if (i < topk && scored_ids[i].first > 0.0f) {
+      sparse_ids->push_back(scored_ids[i].second);
+    }
+  }
+  VLOG(1) << "GeoCommunicator::SelectTopkSparseIds " << varname << " send "
+          << sparse_ids->size() << " of " << scored_ids.size()
+          << " rows, residual " << residual_ids.size();
+}
+
 void GeoCommunicator::RecvSparse(const std::string &varname,
                                  int table_id,
                                  int ep_idx) {
@@ -18,12 +18,13 @@ limitations under the License. */
 #include <stdint.h>
 
 #include <atomic>
-#include <deque>
+#include <chrono>  // NOLINT
 #include <map>
 #include <memory>
 #include <numeric>
 #include <set>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -60,6 +61,10 @@ namespace distributed {
 using Scope = framework::Scope;
 using Variable = framework::Variable;
 
+// Bounded multi-producer multi-consumer queue of the send path. Every slot
+// of the ring carries a sequence number, so producers and consumers only
+// contend on one CAS of their own cursor instead of a shared mutex. Blocking
+// Push/Pop spin, then yield, then sleep while the queue is full/empty.
 template <typename T>
 class BlockingQueue {
  public:
@@ -68,87 +73,144 @@ class BlockingQueue {
                       0,
                       platform::errors::InvalidArgument(
                           "The capacity must be greater than 0."));
+    size_t ring_size = 1;
+    while (ring_size < capacity_) {
+      ring_size <<= 1;
+    }
+    mask_ = ring_size - 1;
+    cells_.reset(new Cell[ring_size]);
+    for (size_t i = 0; i < ring_size; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
   }
 
-  bool Push(const T &elem) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    WaitForWrite(lock);
-
-    queue_.push_back(elem);
-
-    Notify();
-    return true;
+  bool TryPush(const T &elem) {
+    T copy(elem);
+    return TryPush(std::move(copy));
   }
-  bool WaitForWrite(std::unique_lock<std::mutex> &lock) {  // NOLINT
-    while (FullUnlocked()) {
-      if (empty_waiters_ != 0) {
-        empty_cond_.notify_one();
+  // elem is only moved from when the push succeeds
+  bool TryPush(T &&elem) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      size_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+      if (pos >= dequeue_pos && pos - dequeue_pos >= capacity_) {
+        return false;
+      }
+      Cell &cell = cells_[pos & mask_];
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          cell.data = std::move(elem);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
       }
-      full_waiters_++;
-      full_cond_.wait(lock);
-      full_waiters_--;
     }
-    return true;
   }
-  bool WaitForRead(std::unique_lock<std::mutex> &lock) {  // NOLINT
-    while (EmptyUnlocked()) {
-      if (full_waiters_ != 0) {
-        full_cond_.notify_one();
+
+  bool TryPop(T *elem) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells_[pos & mask_];
+      size_t seq = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          *elem = std::move(cell.data);
+          cell.data = T();
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
       }
-      empty_waiters_++;
-      empty_cond_.wait(lock);
-      empty_waiters_--;
     }
-    return true;
   }
-  bool EmptyUnlocked() { return queue_.empty(); }
 
-  bool FullUnlocked() { return queue_.size() >= capacity_; }
-  void Notify() {
-    if (empty_waiters_ != 0 && (!EmptyUnlocked())) {
-      empty_cond_.notify_one();
-    }
-    if (full_waiters_ != 0 && (!FullUnlocked())) {
-      full_cond_.notify_one();
-    }
+  bool Push(const T &elem) {
+    T copy(elem);
+    return Push(std::move(copy));
   }
 
   bool Push(T &&elem) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    WaitForWrite(lock);
-    queue_.emplace_back(std::move(elem));
-
-    Notify();
+    for (int spin = 0; !TryPush(std::move(elem)); ++spin) {
+      Backoff(spin);
+    }
     return true;
   }
+
   T Pop() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    WaitForRead(lock);
-    T rc(std::move(queue_.front()));
-    queue_.pop_front();
-    Notify();
+    T rc;
+    for (int spin = 0; !TryPop(&rc); ++spin) {
+      Backoff(spin);
+    }
     return rc;
   }
 
-  size_t Cap() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return capacity_;
+  // Moves up to max_num ready elements to the back of elems without
+  // blocking, returns how many were moved.
+  size_t PopBatch(std::vector<T> *elems, size_t max_num) {
+    size_t num = 0;
+    T elem;
+    while (num < max_num && TryPop(&elem)) {
+      elems->push_back(std::move(elem));
+      ++num;
+    }
+    return num;
+  }
+
+  // Blocks until num elements are moved to the back of elems.
+  void PopN(std::vector<T> *elems, size_t num) {
+    size_t got = PopBatch(elems, num);
+    for (int spin = 0; got < num; ++spin) {
+      size_t ret = PopBatch(elems, num - got);
+      if (ret == 0) {
+        Backoff(spin);
+      } else {
+        got += ret;
+        spin = 0;
+      }
+    }
   }
 
+  size_t Cap() const { return capacity_; }
+
+  // exact when no push or pop is in flight
   size_t Size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
+    size_t dequeue_pos = dequeue_pos_.load(std::memory_order_acquire);
+    size_t enqueue_pos = enqueue_pos_.load(std::memory_order_acquire);
+    return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
   }
 
  private:
-  int empty_waiters_ = 0;
-  int full_waiters_ = 0;
-  std::condition_variable empty_cond_;
-  std::condition_variable full_cond_;
-  const size_t capacity_;
-  std::deque<T> queue_;
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  static void Backoff(int spin) {
+    if (spin < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
 
-  mutable std::mutex mutex_;
+  const size_t capacity_;
+  size_t mask_ = 0;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
 };
 
 template <typename T,
@@ -624,9 +686,25 @@ class GeoCommunicator : public AsyncCommunicator {
     // id_queue's size
     max_merge_var_num_ = std::stoi(envs.at("communicator_max_merge_var_num"));
     send_queue_size_ = max_merge_var_num_;
+    auto topk_iter = envs.find("communicator_geo_sparse_topk_ratio");
+    if (topk_iter != envs.end()) {
+      ParseGeoSparseTopkRatio(topk_iter->second);
+    }
     VLOG(1) << "GeoCommunicator Initialized";
   }
 
+  // "ratio" for every sparse table, or "ratio,table_id:ratio,..." to
+  // override it per table; 1.0 sends every touched row
+  void ParseGeoSparseTopkRatio(const std::string &config);
+  float GeoSparseTopkRatio(int table_id) const;
+  // Keeps the rows of the largest delta among sparse_ids and the rows left
+  // unsent before, the others stay in the residual of varname for the next
+  // round. Their delta is kept locally as error feedback, since old_scope_
+  // is only moved for the rows that are sent.
+  void SelectTopkSparseIds(const std::string &varname,
+                           float topk_ratio,
+                           std::vector<int64_t> *sparse_ids);
+
   void InitImpl(const RpcCtxMap &send_varname_to_ctx,
                 const RecvCtxMap &recv_varname_to_ctx,
                 Scope *recv_scope) override;
@@ -660,8 +738,15 @@ class GeoCommunicator : public AsyncCommunicator {
 
   std::unordered_map<
       std::string,
-      ::paddle::framework::Channel<std::shared_ptr<std::vector<int64_t>>>>
+      std::shared_ptr<BlockingQueue<std::shared_ptr<std::vector<int64_t>>>>>
       sparse_id_queues_;
+
+  // top-k sparsification of the sparse delta, see SelectTopkSparseIds
+  float geo_sparse_topk_ratio_ = 1.0f;
+  std::unordered_map<int, float> geo_table_topk_ratio_;
+  // ids touched but not sent yet, per splited var, filled in InitImpl
+  std::unordered_map<std::string, std::unordered_set<int64_t>>
+      geo_sparse_residual_ids_;
 };
 
 class FLCommunicator : public GeoCommunicator {
@@ -190,6 +190,54 @@ std::future<int32_t> GraphBrpcClient::clear_nodes(uint32_t table_id,
   }
   return fut;
 }
+
+std::future<int32_t> GraphBrpcClient::send_pass_cmd(
+    uint32_t table_id, int cmd_id, const std::vector<std::string> &params) {
+  DownpourBrpcClosure *closure = new DownpourBrpcClosure(
+      server_size, [server_size = this->server_size, cmd_id](void *done) {
+        int ret = 0;
+        auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+        for (size_t request_idx = 0; request_idx < server_size; ++request_idx) {
+          if (closure->check_response(request_idx, cmd_id) != 0) {
+            ret = -1;
+            break;
+          }
+        }
+        closure->set_promise_value(ret);
+      });
+  auto promise = std::make_shared<std::promise<int32_t>>();
+  closure->add_promise(promise);
+  std::future<int> fut = promise->get_future();
+  for (size_t i = 0; i < server_size; i++) {
+    int server_index = i;
+    closure->request(server_index)->set_cmd_id(cmd_id);
+    closure->request(server_index)->set_table_id(table_id);
+    closure->request(server_index)->set_client_id(_client_id);
+    for (const auto &param : params) {
+      closure->request(server_index)->add_params(param);
+    }
+    GraphPsService_Stub rpc_stub = getServiceStub(GetCmdChannel(server_index));
+    closure->cntl(server_index)->set_log_id(butil::gettimeofday_ms());
+    rpc_stub.service(closure->cntl(server_index),
+                     closure->request(server_index),
+                     closure->response(server_index),
+                     closure);
+  }
+  return fut;
+}
+
+std::future<int32_t> GraphBrpcClient::begin_pass(uint32_t table_id,
+                                                 uint32_t pass_id) {
+  return send_pass_cmd(
+      table_id,
+      PS_GRAPH_BEGIN_PASS,
+      {std::string(reinterpret_cast<char *>(&pass_id), sizeof(uint32_t))});
+}
+
+std::future<int32_t> GraphBrpcClient::end_pass(uint32_t table_id) {
+  return send_pass_cmd(table_id, PS_GRAPH_END_PASS, {});
+}
+
 std::future<int32_t> GraphBrpcClient::add_graph_node(
     uint32_t table_id,
     int idx_,
@@ -118,6 +118,9 @@ class GraphBrpcClient : public BrpcPsClient {
       uint32_t table_id,
       int idx_,
       std::vector<int64_t>& node_id_list);  // NOLINT
+  // tells every server that a pass begins or ends
+  virtual std::future<int32_t> begin_pass(uint32_t table_id, uint32_t pass_id);
+  virtual std::future<int32_t> end_pass(uint32_t table_id);
   virtual int32_t Initialize();
   int get_shard_num() { return shard_num; }
   void set_shard_num(int shard_num) { this->shard_num = shard_num; }
@@ -135,6 +138,10 @@ class GraphBrpcClient : public BrpcPsClient {
   }
 
  private:
+  std::future<int32_t> send_pass_cmd(uint32_t table_id,
+                                     int cmd_id,
+                                     const std::vector<std::string>& params);
+
   int shard_num;
   size_t server_size;
   ::google::protobuf::RpcChannel* local_channel;
@@ -133,6 +133,31 @@ int32_t GraphBrpcService::clear_nodes(Table *table,
   return 0;
 }
 
+int32_t GraphBrpcService::begin_pass(Table *table,
+                                     const PsRequestMessage &request,
+                                     PsResponseMessage &response,
+                                     brpc::Controller *cntl) {
+  CHECK_TABLE_EXIST(table, request, response)
+  if (request.params_size() < 1) {
+    set_response_code(
+        response, -1, "begin_pass request requires at least 1 argument");
+    return 0;
+  }
+  uint32_t pass_id =
+      *(reinterpret_cast<const uint32_t *>(request.params(0).c_str()));
+  (reinterpret_cast<GraphTable *>(table))->begin_pass(pass_id);
+  return 0;
+}
+
+int32_t GraphBrpcService::end_pass(Table *table,
+                                   const PsRequestMessage &request,
+                                   PsResponseMessage &response,
+                                   brpc::Controller *cntl) {
+  CHECK_TABLE_EXIST(table, request, response)
+  (reinterpret_cast<GraphTable *>(table))->end_pass();
+  return 0;
+}
+
 int32_t GraphBrpcService::add_graph_node(Table *table,
                                          const PsRequestMessage &request,
                                          PsResponseMessage &response,
@@ -211,6 +236,8 @@ int32_t GraphBrpcService::Initialize() {
   _service_handler_map[PS_GRAPH_GET_NODE_FEAT] =
       &GraphBrpcService::graph_get_node_feat;
   _service_handler_map[PS_GRAPH_CLEAR] = &GraphBrpcService::clear_nodes;
+  _service_handler_map[PS_GRAPH_BEGIN_PASS] = &GraphBrpcService::begin_pass;
+  _service_handler_map[PS_GRAPH_END_PASS] = &GraphBrpcService::end_pass;
   _service_handler_map[PS_GRAPH_ADD_GRAPH_NODE] =
       &GraphBrpcService::add_graph_node;
   _service_handler_map[PS_GRAPH_REMOVE_GRAPH_NODE] =
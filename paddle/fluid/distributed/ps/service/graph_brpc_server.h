@@ -103,6 +103,14 @@ class GraphBrpcService : public PsBaseService {
                       const PsRequestMessage &request,
                       PsResponseMessage &response,  // NOLINT
                       brpc::Controller *cntl);
+  int32_t begin_pass(Table *table,
+                     const PsRequestMessage &request,
+                     PsResponseMessage &response,  // NOLINT
+                     brpc::Controller *cntl);
+  int32_t end_pass(Table *table,
+                   const PsRequestMessage &request,
+                   PsResponseMessage &response,  // NOLINT
+                   brpc::Controller *cntl);
   int32_t add_graph_node(Table *table,
                          const PsRequestMessage &request,
                          PsResponseMessage &response,  // NOLINT
@@ -21,6 +21,11 @@ namespace paddle {
 namespace distributed {
 PD_DEFINE_int32(heter_world_size, 100, "group size");  // group max size
 PD_DEFINE_int32(switch_send_recv_timeout_s, 600, "switch_send_recv_timeout_s");
+PD_DEFINE_int32(heter_max_inflight_sends,
+                0,
+                "max in-flight SendAndRecvAsync calls of a client, the oldest "
+                "is waited for beyond it and its error raised to the caller, "
+                "0 for no limit");
 
 std::shared_ptr<HeterClient> HeterClient::s_instance_ = nullptr;
 std::mutex HeterClient::mtx_;
@@ -131,12 +136,22 @@ void HeterClient::SendAndRecvAsync(
   distributed::MultiVarMsg request;
   OnHeterRpcDone* closure = new OnHeterRpcDone([](void* done) {
     auto* closure = reinterpret_cast<OnHeterRpcDone*>(done);
-    PADDLE_ENFORCE_NE(
-        closure->cntl.Failed(),
-        true,
-        platform::errors::Unimplemented(
-            "HeterClient::SendAndRecv meets brpc error, error message is %s",
-            closure->cntl.ErrorText()));
+    std::unique_ptr<OnHeterRpcDone> closure_guard(closure);
+    if (closure->_promises.empty()) {
+      PADDLE_ENFORCE_NE(
+          closure->cntl.Failed(),
+          true,
+          platform::errors::Unimplemented(
+              "HeterClient::SendAndRecv meets brpc error, error message is %s",
+              closure->cntl.ErrorText()));
+    } else if (closure->cntl.Failed()) {
+      LOG(ERROR) << "HeterClient::SendAndRecv meets brpc error, error "
+                    "message is "
+                 << closure->cntl.ErrorText();
+      closure->set_promise_value(-1);
+      return;
+    }
+    closure->set_promise_value(0);
     VLOG(4) << "call heter_worker success";
   });
   closure->cntl.set_timeout_ms(FLAGS_pserver_timeout_ms);
@@ -171,13 +186,41 @@ void HeterClient::SendAndRecvAsync(
     // stub.SendToSwitch(&closure->cntl, &request, &closure->response,
     // closure); fut.wait();
     VLOG(4) << "calling switch service done";
+    delete closure;
     return;
   }
+  if (FLAGS_heter_max_inflight_sends > 0) {
+    auto promise = std::make_shared<std::promise<int32_t>>();
+    closure->add_promise(promise);
+    WaitInflightSends(FLAGS_heter_max_inflight_sends - 1);
+    std::lock_guard<std::mutex> lock(inflight_mutex_);
+    inflight_sends_.push_back(promise->get_future());
+  }
   paddle::distributed::PsService_Stub stub(channel);
   stub.SendAndRecvVariable(
       &closure->cntl, &request, &closure->response, closure);
 }
 
+void HeterClient::WaitInflightSends(size_t max_inflight) {
+  while (true) {
+    std::future<int32_t> oldest;
+    {
+      std::lock_guard<std::mutex> lock(inflight_mutex_);
+      if (inflight_sends_.size() <= max_inflight) {
+        return;
+      }
+      oldest = std::move(inflight_sends_.front());
+      inflight_sends_.pop_front();
+    }
+    PADDLE_ENFORCE_EQ(
+        oldest.get(),
+        0,
+        platform::errors::Unavailable(
+            "HeterClient::SendAndRecvAsync failed, see the brpc error in the "
+            "log."));
+  }
+}
+
 std::future<int32_t> HeterClient::SendCmd(
     uint32_t table_id, int cmd_id, const std::vector<std::string>& params) {
   size_t request_call_num = xpu_channels_.size();
@@ -15,8 +15,11 @@ limitations under the License. */
 #pragma once
 #include <atomic>
 #include <ctime>
+#include <deque>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <random>
 #include <string>
 #include <unordered_map>
@@ -139,6 +142,10 @@ class HeterClient {
                         const std::vector<std::string>& recv_var_name,
                         const std::string& mode = "forward");
 
+  // Wait for the oldest SendAndRecvAsync calls until at most max_inflight of
+  // them are in flight, only the calls sent with a bounded window are tracked
+  void WaitInflightSends(size_t max_inflight = 0);
+
   int Send(int group_id,
            const std::vector<std::string>& var_names,
            const std::vector<int64_t>& vars_len,
@@ -251,6 +258,9 @@ class HeterClient {
   std::vector<std::string> previous_xpu_list_;
 
   int trainer_id_;
+
+  std::mutex inflight_mutex_;
+  std::deque<std::future<int32_t>> inflight_sends_;
 };
 
 }  // end namespace distributed
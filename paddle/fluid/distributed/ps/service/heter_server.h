@@ -216,27 +216,19 @@ class SendAndRecvVariableHandler final : public ServiceHandlerBase {
     // get microID from request
     // deserialize variable to micro scope
     // Push to heter worker's task_queue
-    std::unique_ptr<::paddle::framework::Scope> local_scope_ptr(
-        new ::paddle::framework::Scope());
-    auto& local_scope = *(local_scope_ptr.get());
-    platform::DeviceContextPool& pool = platform::DeviceContextPool::Instance();
-    platform::CPUPlace cpu_place;
-    auto& cpu_dev_ctx = *pool.Get(cpu_place);
-
     auto message_name = request->message_name();
     auto& request_io_buffer = cntl->request_attachment();
 
-    distributed::DeserializeFromMultiVarMsgAndIOBuf(
-        *request, &request_io_buffer, cpu_dev_ctx, &local_scope);
-
-    auto* var = local_scope.FindVar("microbatch_id");
-    PADDLE_ENFORCE_NE(var,
-                      nullptr,
-                      platform::errors::InvalidArgument(
-                          "Not find variable microbatch_id in scope."));
-    auto* tensor = var->GetMutable<phi::DenseTensor>();
-    auto data = reinterpret_cast<const float*>(tensor->data());
-    auto micro_id = static_cast<int>(data[0]);
+    // only the micro id is read before the micro scope is known, so that
+    // the activations are deserialized once, into the micro scope
+    float micro_id_value = 0;
+    PADDLE_ENFORCE_EQ(
+        distributed::PeekFloatFromMultiVarMsgAndIOBuf(
+            *request, &request_io_buffer, "microbatch_id", &micro_id_value),
+        true,
+        platform::errors::InvalidArgument(
+            "Not find variable microbatch_id in request."));
+    auto micro_id = static_cast<int>(micro_id_value);
     VLOG(4) << "micro_id in heter server: " << micro_id;
     int minibatch_index = micro_id / 10;
     int microbatch_index = micro_id % 10;
@@ -291,7 +283,7 @@ class SendAndRecvVariableHandler final : public ServiceHandlerBase {
                                                 response_var_names,
                                                 empty_var_names,
                                                 *dev_ctx_,
-                                                &local_scope,
+                                                micro_scope,
                                                 response,
                                                 &response_io_buffer);
     VLOG(4) << "Handle over";
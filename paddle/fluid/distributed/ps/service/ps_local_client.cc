@@ -26,7 +26,12 @@ int32_t PsLocalClient::Initialize() {
     table->SetShard(0, 1);
     table->Initialize(downpour_param.downpour_table_param(i),
                       _config.fs_client_param());
-    _table_map[downpour_param.downpour_table_param(i).table_id()].reset(table);
+    uint32_t table_id = downpour_param.downpour_table_param(i).table_id();
+    _table_map[table_id].reset(table);
+    if (table_id >= _tables.size()) {
+      _tables.resize(table_id + 1, nullptr);
+    }
+    _tables[table_id] = table;
   }
   return 0;
 }
@@ -261,6 +266,52 @@ int32_t PsLocalClient::Initialize() {
   return done();
 }
 
+::std::future<int32_t> PsLocalClient::PullSparse(float** select_values,
+                                                 size_t table_id,
+                                                 const uint64_t* keys,
+                                                 size_t num,
+                                                 bool is_training) {
+  auto* accessor = GetTableAccessor(table_id);
+  auto* table_ptr = GetTable(table_id);
+  size_t select_dim = accessor->GetAccessorInfo().select_size / sizeof(float);
+
+  // the values of the tensors are usually one buffer, the table writes them
+  // in place then
+  bool contiguous = true;
+  for (size_t i = 1; i < num && contiguous; ++i) {
+    contiguous = select_values[i] == select_values[0] + i * select_dim;
+  }
+  std::vector<float> select_buffer;
+  float* pull_values = num > 0 ? select_values[0] : nullptr;
+  if (!contiguous) {
+    select_buffer.resize(num * select_dim);
+    pull_values = select_buffer.data();
+  }
+
+  std::vector<uint32_t> frequencies(num, 1);
+  PullSparseValue pull_value(static_cast<int>(num),
+                             static_cast<int>(select_dim));
+  pull_value.is_training_ = is_training;
+  pull_value.feasigns_ = const_cast<uint64_t*>(keys);
+  pull_value.frequencies_ = frequencies.data();
+
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = pull_value;
+  table_context.pull_context.values = pull_values;
+  table_context.num = num;
+  table_ptr->Pull(table_context);
+
+  if (!contiguous) {
+    for (size_t i = 0; i < num; ++i) {
+      memcpy(select_values[i],
+             select_buffer.data() + i * select_dim,
+             select_dim * sizeof(float));
+    }
+  }
+  return done();
+}
+
 ::std::future<int32_t> PsLocalClient::PrintTableStat(uint32_t table_id) {
   auto* table_ptr = GetTable(table_id);
   std::pair<int64_t, int64_t> ret = table_ptr->PrintTableStat();
@@ -65,17 +65,13 @@ class PsLocalClient : public PSClient {
                                                 size_t region_num,
                                                 size_t table_id);
 
-  virtual ::std::future<int32_t> PullSparse(float** select_values UNUSED,
-                                            size_t table_id UNUSED,
-                                            const uint64_t* keys UNUSED,
-                                            size_t num UNUSED,
-                                            bool is_training UNUSED) {
-    std::promise<int32_t> prom;
-    std::future<int32_t> fut = prom.get_future();
-    prom.set_value(0);
-
-    return fut;
-  }
+  // select the values in the table of this process, into select_values
+  // directly when they are one contiguous buffer
+  virtual ::std::future<int32_t> PullSparse(float** select_values,
+                                            size_t table_id,
+                                            const uint64_t* keys,
+                                            size_t num,
+                                            bool is_training);
 
   virtual ::std::future<int32_t> PullSparsePtr(
       const int shard_id,
@@ -206,11 +202,11 @@ class PsLocalClient : public PSClient {
  protected:
   virtual int32_t Initialize();
 
+  // the calls run in the caller thread, their futures are always ready
   std::future<int32_t> done() {
-    std::shared_ptr<std::promise<int32_t>> prom =
-        std::make_shared<std::promise<int32_t>>();
-    std::future<int32_t> fut = prom->get_future();
-    prom->set_value(0);
+    std::promise<int32_t> prom;
+    std::future<int32_t> fut = prom.get_future();
+    prom.set_value(0);
     return fut;
   }
 
@@ -224,15 +220,17 @@ class PsLocalClient : public PSClient {
   }
 
   inline Table* GetTable(size_t table_id) {
-    auto itr = _table_map.find(table_id);
-    if (itr != _table_map.end()) {
-      return itr->second.get();
+    if (table_id < _tables.size() && _tables[table_id] != nullptr) {
+      return _tables[table_id];
     }
     LOG(ERROR) << "table not found " << table_id;
     return NULL;
   }
 
   std::unordered_map<uint32_t, std::shared_ptr<Table>> _table_map;
+  // the tables of _table_map indexed by table id, to look them up on every
+  // pull and push without hashing
+  std::vector<Table*> _tables;
 
   bool _running = false;
   bool _flushing = false;
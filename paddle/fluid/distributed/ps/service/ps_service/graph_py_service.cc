@@ -342,6 +342,16 @@ void GraphPyClient::remove_graph_node(std::string name,
   // }
 }
 
+void GraphPyClient::begin_pass(uint32_t pass_id) {
+  auto status = get_ps_client()->begin_pass(0, pass_id);
+  status.wait();
+}
+
+void GraphPyClient::end_pass() {
+  auto status = get_ps_client()->end_pass(0);
+  status.wait();
+}
+
 void GraphPyClient::load_node_file(std::string name, std::string filepath) {
   // 'n' means load nodes and 'node_type' follows
 
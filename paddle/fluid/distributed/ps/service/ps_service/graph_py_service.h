@@ -182,6 +182,9 @@ class GraphPyClient : public GraphPyService {
                       std::vector<bool>& weight_list);  // NOLINT
   void remove_graph_node(std::string name,
                          std::vector<int64_t>& node_ids);  // NOLINT
+  // the cached neighbor samples expire cache_ttl passes later
+  void begin_pass(uint32_t pass_id);
+  void end_pass();
   int get_client_id() { return client_id; }
   void set_client_id(int client_id) { this->client_id = client_id; }
   void start_client();
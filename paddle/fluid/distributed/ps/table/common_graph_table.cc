@@ -47,7 +47,11 @@ PHI_DEFINE_EXPORTED_bool(graph_edges_split_only_by_src_id,
 PHI_DEFINE_EXPORTED_string(
     graph_edges_split_mode,
     "hard",
-    "graph split split, optional: [dbh,hard,fennel,none], default:hard");
+    "graph split split, optional: [dbh,hard,fennel,hdrf,none], "
+    "default:hard");
+PHI_DEFINE_EXPORTED_double(graph_edges_split_hdrf_lambda,
+                           1.0,
+                           "balance weight of the hdrf streaming split");
 PHI_DEFINE_EXPORTED_bool(graph_edges_split_debug,
                          false,
                          "graph split by debug");
@@ -923,6 +927,14 @@ void GraphTable::graph_partition(bool is_edge) {
     } else {
       fennel_graph_feature_partition();
     }
+  } else if (mode == "hdrf" || mode == "HDRF") {
+    // edges are already split while parsing, see parse_edge_file
+    if (is_edge) {
+      print_stream_partition_stat();
+      collect_unique_all_edge_keys();
+    } else {
+      dbh_graph_feature_partition();
+    }
   } else {
     // TODO(danleifeng): Graph partitioning other method.
     VLOG(0) << "Unknown graph partitioning mode " << mode;
@@ -1055,6 +1067,11 @@ void GraphTable::dbh_graph_edge_partition() {
   // 替换原来的shards
   clear_edge_shard();
   edge_shards = std::move(tmp_edge_shards);
+  collect_unique_all_edge_keys();
+  VLOG(0) << "end to process dbh edge shard";
+}
+
+void GraphTable::collect_unique_all_edge_keys() {
   std::vector<std::vector<uint64_t>> all_edge_keys;
   unique_all_edge_keys_.clear();
   VLOG(1) << "begin to get all_edge_keys";
@@ -1064,7 +1081,30 @@ void GraphTable::dbh_graph_edge_partition() {
                                all_edge_keys[0].end());
   VLOG(1) << "insert unique_all_edge_keys_ done, size:"
           << unique_all_edge_keys_.size();
-  VLOG(0) << "end to process dbh edge shard";
+}
+
+void GraphTable::print_stream_partition_stat() {
+  std::lock_guard<std::mutex> lock(stream_partition_mutex_);
+  for (auto &it : stream_partition_stats_) {
+    auto &stat = it.second;
+    const std::string &edge_type = id_to_edge[it.first];
+    uint64_t total_edges = 0;
+    for (auto edges : stat.edges) total_edges += edges;
+    for (size_t rank = 0; rank < stat.edges.size(); ++rank) {
+      VLOG(0) << "hdrf partition edge_type[" << edge_type << "] rank[" << rank
+              << "] edges:" << stat.edges[rank]
+              << " vertices:" << stat.replicas[rank]
+              << " cut_edges:" << stat.cut_edges[rank] << " edge_cut:"
+              << (stat.edges[rank] == 0
+                      ? 0.0
+                      : 1.0 * stat.cut_edges[rank] / stat.edges[rank])
+              << (static_cast<int>(rank) == node_id_ ? " (self)" : "");
+    }
+    VLOG(0) << "hdrf partition edge_type[" << edge_type
+            << "] total edges:" << total_edges
+            << " vertices:" << stat.vertex_num
+            << " replication_factor:" << stat.ReplicationFactor();
+  }
 }
 
 void GraphTable::dbh_graph_feature_partition() {
@@ -1858,9 +1898,94 @@ int32_t GraphTable::Load(const std::string &path, const std::string &param) {
       return -1;
     }
   }
+  if (param[0] == 'c') {
+    std::string edge_type = param.substr(1);
+    int ret = this->load_edges_csr(path, edge_type);
+    if (ret != 0) {
+      VLOG(0) << "Fail to load csr edges, path[" << path << "] edge_type["
+              << edge_type << "]";
+      return -1;
+    }
+  }
   return 0;
 }
 
+int32_t GraphTable::dump_edges_to_csr(int idx,
+                                      const std::string &dir,
+                                      bool with_weight) {
+  std::vector<std::future<int32_t>> tasks;
+  for (size_t i = 0; i < edge_shards[idx].size(); ++i) {
+    tasks.push_back(load_node_edge_task_pool->enqueue(
+        [this, idx, i, &dir, with_weight]() -> int32_t {
+          std::string path = ::paddle::string::format_string(
+              "%s/part-%05d.csr", dir.c_str(), shard_start + i);
+          return GraphCsrShard::Build(
+              edge_shards[idx][i]->get_bucket(), with_weight, path);
+        }));
+  }
+  int32_t ret = 0;
+  for (auto &task : tasks) {
+    ret = task.get() != 0 ? -1 : ret;
+  }
+  VLOG(0) << "dump_edges_to_csr " << id_to_edge[idx] << " to " << dir
+          << " ret:" << ret;
+  return ret;
+}
+
+int32_t GraphTable::load_edges_csr(const std::string &dir,
+                                   const std::string &edge_type) {
+  int idx = 0;
+  if (!edge_type.empty()) {
+    if (edge_to_id.find(edge_type) == edge_to_id.end()) {
+      VLOG(0) << "edge_type " << edge_type
+              << " is not defined, nothing will be loaded";
+      return 0;
+    }
+    idx = edge_to_id[edge_type];
+  }
+  std::vector<std::shared_ptr<GraphCsrShard>> shards(shard_num_per_server);
+  std::vector<std::future<int32_t>> tasks;
+  for (size_t i = 0; i < shard_num_per_server; ++i) {
+    tasks.push_back(load_node_edge_task_pool->enqueue(
+        [this, i, &dir, &shards]() -> int32_t {
+          std::string path = ::paddle::string::format_string(
+              "%s/part-%05d.csr", dir.c_str(), shard_start + i);
+          auto shard = std::make_shared<GraphCsrShard>();
+          if (shard->Load(path) != 0) {
+            return -1;
+          }
+          shards[i] = shard;
+          return 0;
+        }));
+  }
+  int32_t ret = 0;
+  for (auto &task : tasks) {
+    ret = task.get() != 0 ? -1 : ret;
+  }
+  if (ret != 0) {
+    return ret;
+  }
+  uint64_t edge_num = 0;
+  for (auto &shard : shards) {
+    edge_num += shard->EdgeNum();
+  }
+  csr_edge_shards[idx].swap(shards);
+  VLOG(0) << "load_edges_csr " << edge_type << " from " << dir
+          << " edge_num:" << edge_num;
+  return 0;
+}
+
+GraphCsrShard *GraphTable::find_csr_shard(int idx, uint64_t id) {
+  if (csr_edge_shards[idx].empty()) {
+    return nullptr;
+  }
+  size_t shard_id = id % shard_num;
+  if (shard_id >= shard_end || shard_id < shard_start) {
+    return nullptr;
+  }
+  return csr_edge_shards[idx][shard_id - shard_start].get();
+}
+
 std::string GraphTable::get_inverse_etype(std::string &etype) {
   auto etype_split = ::paddle::string::split_string<std::string>(etype, "2");
   std::string res;
@@ -2477,6 +2602,19 @@ std::pair<uint64_t, uint64_t> GraphTable::parse_edge_file(
   uint64_t local_count = 0;
   uint64_t local_valid_count = 0;
   uint64_t part_num = 0;
+  // hdrf state is per file, so every rank replays the same decisions
+  std::unique_ptr<HdrfPartitioner> partitioner;
+  if (node_num_ > 1 && (FLAGS_graph_edges_split_mode == "hdrf" ||
+                        FLAGS_graph_edges_split_mode == "HDRF")) {
+    PADDLE_ENFORCE_LE(node_num_,
+                      HdrfPartitioner::kMaxPartNum,
+                      ::paddle::platform::errors::InvalidArgument(
+                          "hdrf split supports at most %d ranks, got %d",
+                          HdrfPartitioner::kMaxPartNum,
+                          node_num_));
+    partitioner.reset(new HdrfPartitioner(
+        node_num_, FLAGS_graph_edges_split_hdrf_lambda));
+  }
   if (FLAGS_graph_load_in_parallel) {
     auto path_split = ::paddle::string::split_string<std::string>(path, "/");
     auto part_name_split = ::paddle::string::split_string<std::string>(
@@ -2525,6 +2663,11 @@ std::pair<uint64_t, uint64_t> GraphTable::parse_edge_file(
       }
     }
 
+    if (partitioner != nullptr &&
+        partitioner->Assign(src_id, dst_id) != node_id_) {
+      continue;
+    }
+
     float weight = 1;
     size_t last = line.find_last_of('\t');
     if (start != last) {
@@ -2545,6 +2688,10 @@ std::pair<uint64_t, uint64_t> GraphTable::parse_edge_file(
 
     local_valid_count++;
   }
+  if (partitioner != nullptr) {
+    std::lock_guard<std::mutex> lock(stream_partition_mutex_);
+    stream_partition_stats_[idx].Merge(partitioner->GetStat());
+  }
   VLOG(2) << local_valid_count << "/" << local_count
           << " edges are loaded from filepath->" << path;
   return {local_count, local_valid_count};
@@ -2573,6 +2720,11 @@ int32_t GraphTable::load_edges(const std::string &path,
   auto paths = ::paddle::string::split_string<std::string>(path, ";");
   uint64_t count = 0;
   uint64_t valid_count = 0;
+  {
+    // a reload replaces the edges, so it replaces their hdrf stat as well
+    std::lock_guard<std::mutex> lock(stream_partition_mutex_);
+    stream_partition_stats_.erase(idx);
+  }
 
   VLOG(0) << "Begin GraphTable::load_edges() edge_type[" << edge_type << "]";
   if (FLAGS_graph_load_in_parallel) {
@@ -2786,13 +2938,14 @@ int32_t GraphTable::random_sample_neighbors(
       std::vector<std::pair<SampleKey, SampleResult>> r;
       LRUResponse response = LRUResponse::blocked;
       if (use_cache) {
-        response =
-            scaled_lru->query(i, id_list[i].data(), id_list[i].size(), r);
+        sample_cache->Query(id_list[i].data(), id_list[i].size(), &r);
+        response = LRUResponse::ok;
       }
       size_t index = 0;
       std::vector<SampleResult> sample_res;
       std::vector<SampleKey> sample_keys;
       auto &rng = _shards_task_rng_pool[i];
+      std::vector<int> res;
       for (size_t k = 0; k < id_list[i].size(); k++) {
         if (index < r.size() &&
             r[index].first.node_key == id_list[i][k].node_key) {
@@ -2802,9 +2955,40 @@ int32_t GraphTable::random_sample_neighbors(
           index++;
         } else {
           node_id = id_list[i][k].node_key;
-          Node *node = find_node(GraphTableType::EDGE_TABLE, idx, node_id);
           int idy = seq_id[i][k];
           int &actual_size = actual_sizes[idy];
+          GraphCsrShard *csr_shard = find_csr_shard(idx, node_id);
+          int64_t csr_pos =
+              csr_shard == nullptr ? -1 : csr_shard->Find(node_id);
+          if (csr_pos >= 0) {
+            // read straight from the mapped csr arrays
+            res = csr_shard->SampleK(
+                csr_pos, sample_size, csr_shard->HasWeight(), rng);
+            actual_size =
+                res.size() * (need_weight ? (Node::id_size + Node::weight_size)
+                                          : Node::id_size);
+            char *buffer_addr = new char[actual_size];
+            if (response == LRUResponse::ok) {
+              sample_keys.emplace_back(idx, node_id, sample_size, need_weight);
+              sample_res.emplace_back(actual_size, buffer_addr);
+              buffers[idy] = sample_res.back().buffer;
+            } else {
+              buffers[idy].reset(buffer_addr, char_del);
+            }
+            int offset = 0;
+            for (int &x : res) {
+              uint64_t id = csr_shard->NeighborId(csr_pos, x);
+              memcpy(buffer_addr + offset, &id, Node::id_size);
+              offset += Node::id_size;
+              if (need_weight) {
+                float weight = csr_shard->NeighborWeight(csr_pos, x);
+                memcpy(buffer_addr + offset, &weight, Node::weight_size);
+                offset += Node::weight_size;
+              }
+            }
+            continue;
+          }
+          Node *node = find_node(GraphTableType::EDGE_TABLE, idx, node_id);
           if (node == nullptr) {
 #ifdef PADDLE_WITH_GPU_GRAPH
             if (search_level == 2) {
@@ -2823,7 +3007,8 @@ int32_t GraphTable::random_sample_neighbors(
             continue;
           }
           std::shared_ptr<char> &buffer = buffers[idy];
-          std::vector<int> res = node->sample_k(sample_size, rng);
+          res.resize(std::max(sample_size, 0));
+          res.resize(node->sample_k(sample_size, rng, res.data()));
           actual_size =
               res.size() * (need_weight ? (Node::id_size + Node::weight_size)
                                         : Node::id_size);
@@ -2855,8 +3040,8 @@ int32_t GraphTable::random_sample_neighbors(
         }
       }
       if (!sample_res.empty()) {
-        scaled_lru->insert(
-            i, sample_keys.data(), sample_res.data(), sample_keys.size());
+        sample_cache->Insert(
+            sample_keys.data(), sample_res.data(), sample_keys.size());
       }
       return 0;
     }));
@@ -2867,6 +3052,20 @@ int32_t GraphTable::random_sample_neighbors(
   return 0;
 }
 
+void GraphTable::print_sample_cache_stats() {
+  if (!use_cache) {
+    return;
+  }
+  auto stats = sample_cache->GetStats();
+  uint64_t total = stats.hit + stats.miss;
+  VLOG(0) << "sample cache pass:" << sample_cache->GetPass()
+          << " size:" << sample_cache->Size() << " hit:" << stats.hit
+          << " miss:" << stats.miss << " hit_rate:"
+          << (total == 0 ? 0.0 : 1.0 * stats.hit / total)
+          << " insert:" << stats.insert << " evict:" << stats.evict
+          << " expire:" << stats.expire;
+}
+
 int32_t GraphTable::get_nodes_ids_by_ranges(
     GraphTableType table_type,
     int idx,
@@ -3432,8 +3631,9 @@ int32_t GraphTable::Initialize(const GraphParameter &graph) {
     _shard_idx = 0;
     shard_num = graph.shard_num();
   }
-  use_cache = graph.use_cache();
-  if (use_cache) {
+  // make_neighbor_sample_cache sets use_cache once the cache is built
+  use_cache = false;
+  if (graph.use_cache()) {
     cache_size_limit = graph.cache_size_limit();
     cache_ttl = graph.cache_ttl();
     make_neighbor_sample_cache(cache_size_limit, cache_ttl);
@@ -3537,6 +3737,7 @@ int32_t GraphTable::Initialize(const GraphParameter &graph) {
   VLOG(0) << "in init graph table shard idx = " << _shard_idx << " shard_start "
           << shard_start << " shard_end " << shard_end;
   edge_shards.resize(id_to_edge.size());
+  csr_edge_shards.resize(id_to_edge.size());
   node_weight.resize(2);
   node_weight[0].resize(id_to_edge.size());
 #ifdef PADDLE_WITH_GPU_GRAPH
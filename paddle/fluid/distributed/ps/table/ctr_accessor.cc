@@ -34,6 +34,14 @@ int CtrCommonAccessor::Initialize() {
   common_feature_value.embed_sgd_dim = _embed_sgd_rule->Dim();
   common_feature_value.embedx_dim = _config.embedx_dim();
   common_feature_value.embedx_sgd_dim = _embedx_sgd_rule->Dim();
+  auto storage_type = _config.ctr_accessor_param().embedx_storage_type();
+  _embedx_codec.Init(storage_type, common_feature_value.embedx_dim);
+  _embedx_sgd_codec.Init(
+      _config.ctr_accessor_param().compress_embedx_g2sum() ? storage_type
+                                                           : STORE_FP32,
+      common_feature_value.embedx_sgd_dim);
+  common_feature_value.embedx_storage_dim = _embedx_codec.StorageDim();
+  common_feature_value.embedx_sgd_storage_dim = _embedx_sgd_codec.StorageDim();
   _show_click_decay_rate = _config.ctr_accessor_param().show_click_decay_rate();
   _ssd_unseenday_threshold =
       _config.ctr_accessor_param().ssd_unseenday_threshold();
@@ -55,8 +63,9 @@ void CtrCommonAccessor::InitAccessorInfo() {
   _accessor_info.select_size = _accessor_info.select_dim * sizeof(float);
   _accessor_info.update_dim = 4 + embedx_dim;
   _accessor_info.update_size = _accessor_info.update_dim * sizeof(float);
-  _accessor_info.mf_size =
-      (embedx_dim + common_feature_value.embedx_sgd_dim) * sizeof(float);
+  _accessor_info.mf_size = (common_feature_value.embedx_storage_dim +
+                            common_feature_value.embedx_sgd_storage_dim) *
+                           sizeof(float);
 }
 
 bool CtrCommonAccessor::Shrink(float* value) {
@@ -180,13 +189,37 @@ int32_t CtrCommonAccessor::Create(float** values, size_t num) {
     _embed_sgd_rule->InitValue(value + common_feature_value.EmbedWIndex(),
                                value + common_feature_value.EmbedG2SumIndex(),
                                zero_init);
-    _embedx_sgd_rule->InitValue(value + common_feature_value.EmbedxWIndex(),
-                                value + common_feature_value.EmbedxG2SumIndex(),
-                                false);
+    if (!_embedx_codec.IsCompressed() && !_embedx_sgd_codec.IsCompressed()) {
+      _embedx_sgd_rule->InitValue(
+          value + common_feature_value.EmbedxWIndex(),
+          value + common_feature_value.EmbedxG2SumIndex(),
+          false);
+      continue;
+    }
+    float embedx_w[common_feature_value.embedx_dim];          // NOLINT
+    float embedx_g2sum[common_feature_value.embedx_sgd_dim];  // NOLINT
+    _embedx_sgd_rule->InitValue(embedx_w, embedx_g2sum, false);
+    EncodeEmbedx(embedx_w, embedx_g2sum, value);
   }
   return 0;
 }
 
+void CtrCommonAccessor::EncodeEmbedx(const float* embedx_w,
+                                     const float* embedx_g2sum,
+                                     float* value) {
+  _embedx_codec.Encode(embedx_w, value + common_feature_value.EmbedxWIndex());
+  _embedx_sgd_codec.Encode(embedx_g2sum,
+                           value + common_feature_value.EmbedxG2SumIndex());
+}
+
+void CtrCommonAccessor::DecodeEmbedx(const float* value,
+                                     float* embedx_w,
+                                     float* embedx_g2sum) {
+  _embedx_codec.Decode(value + common_feature_value.EmbedxWIndex(), embedx_w);
+  _embedx_sgd_codec.Decode(value + common_feature_value.EmbedxG2SumIndex(),
+                           embedx_g2sum);
+}
+
 bool CtrCommonAccessor::NeedExtendMF(float* value) {
   float show = value[common_feature_value.ShowIndex()];
   float click = value[common_feature_value.ClickIndex()];
@@ -213,6 +246,11 @@ int32_t CtrCommonAccessor::Select(float** select_values,
         value[common_feature_value.ClickIndex()];
     select_value[CtrCommonPullValue::EmbedWIndex()] =
         value[common_feature_value.EmbedWIndex()];
+    if (_embedx_codec.IsCompressed()) {
+      _embedx_codec.Decode(value + common_feature_value.EmbedxWIndex(),
+                           select_value + CtrCommonPullValue::EmbedxWIndex());
+      continue;
+    }
     memcpy(select_value + CtrCommonPullValue::EmbedxWIndex(),
            value + common_feature_value.EmbedxWIndex(),
            embedx_dim * sizeof(float));
@@ -246,6 +284,16 @@ int32_t CtrCommonAccessor::Merge(float** update_values,
 int32_t CtrCommonAccessor::Update(float** update_values,
                                   const float** push_values,
                                   size_t num) {
+  // the sgd rules update all the keys with one batched call
+  bool embedx_compressed =
+      _embedx_codec.IsCompressed() || _embedx_sgd_codec.IsCompressed();
+  std::vector<float*> embed_w(num);
+  std::vector<float*> embed_g2sum(num);
+  std::vector<const float*> embed_g(num);
+  std::vector<float*> embedx_w(embedx_compressed ? 0 : num);
+  std::vector<float*> embedx_g2sum(embedx_compressed ? 0 : num);
+  std::vector<const float*> embedx_g(embedx_compressed ? 0 : num);
+  std::vector<float> show_scale(num);
   for (size_t value_item = 0; value_item < num; ++value_item) {
     float* update_value = update_values[value_item];
     const float* push_value = push_values[value_item];
@@ -265,16 +313,44 @@ int32_t CtrCommonAccessor::Update(float** update_values,
     }
     VLOG(3) << "accessor show scale:" << _show_scale
             << ", push_show:" << push_show;
-    _embed_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedWIndex(),
-        update_value + common_feature_value.EmbedG2SumIndex(),
-        push_value + CtrCommonPushValue::EmbedGIndex(),
-        push_show);
+    show_scale[value_item] = push_show;
+    embed_w[value_item] = update_value + common_feature_value.EmbedWIndex();
+    embed_g2sum[value_item] =
+        update_value + common_feature_value.EmbedG2SumIndex();
+    embed_g[value_item] = push_value + CtrCommonPushValue::EmbedGIndex();
+    if (!embedx_compressed) {
+      embedx_w[value_item] = update_value + common_feature_value.EmbedxWIndex();
+      embedx_g2sum[value_item] =
+          update_value + common_feature_value.EmbedxG2SumIndex();
+      embedx_g[value_item] = push_value + CtrCommonPushValue::EmbedxGIndex();
+    }
+  }
+  _embed_sgd_rule->UpdateValueBatch(embed_w.data(),
+                                    embed_g2sum.data(),
+                                    embed_g.data(),
+                                    show_scale.data(),
+                                    num);
+  if (!embedx_compressed) {
+    _embedx_sgd_rule->UpdateValueBatch(embedx_w.data(),
+                                       embedx_g2sum.data(),
+                                       embedx_g.data(),
+                                       show_scale.data(),
+                                       num);
+    return 0;
+  }
+  for (size_t value_item = 0; value_item < num; ++value_item) {
+    float* update_value = update_values[value_item];
+    const float* push_value = push_values[value_item];
+    // expand to fp32, apply the sgd rule and compress back
+    float decoded_w[common_feature_value.embedx_dim];          // NOLINT
+    float decoded_g2sum[common_feature_value.embedx_sgd_dim];  // NOLINT
+    DecodeEmbedx(update_value, decoded_w, decoded_g2sum);
     _embedx_sgd_rule->UpdateValue(
-        update_value + common_feature_value.EmbedxWIndex(),
-        update_value + common_feature_value.EmbedxG2SumIndex(),
+        decoded_w,
+        decoded_g2sum,
         push_value + CtrCommonPushValue::EmbedxGIndex(),
-        push_show);
+        show_scale[value_item]);
+    EncodeEmbedx(decoded_w, decoded_g2sum, update_value);
   }
   return 0;
 }
@@ -324,6 +400,19 @@ std::string CtrCommonAccessor::ParseToString(const float* v, int param) {
   auto score = ShowClickScore(show, click);
   if (score >= _config.embedx_threshold() &&
       param > common_feature_value.EmbedxWIndex()) {
+    if (_embedx_codec.IsCompressed() || _embedx_sgd_codec.IsCompressed()) {
+      // saved as fp32 text, loadable whatever the storage type
+      float embedx_w[common_feature_value.embedx_dim];          // NOLINT
+      float embedx_g2sum[common_feature_value.embedx_sgd_dim];  // NOLINT
+      DecodeEmbedx(v, embedx_w, embedx_g2sum);
+      for (int i = 0; i < common_feature_value.embedx_dim; ++i) {
+        os << " " << embedx_w[i];
+      }
+      for (int i = 0; i < common_feature_value.embedx_sgd_dim; ++i) {
+        os << " " << embedx_g2sum[i];
+      }
+      return os.str();
+    }
     for (auto i = common_feature_value.EmbedxWIndex();
          i < common_feature_value.Dim();
          ++i) {
@@ -334,11 +423,33 @@ std::string CtrCommonAccessor::ParseToString(const float* v, int param) {
 }
 
 int CtrCommonAccessor::ParseFromString(const std::string& str, float* value) {
-  _embedx_sgd_rule->InitValue(value + common_feature_value.EmbedxWIndex(),
-                              value + common_feature_value.EmbedxG2SumIndex());
-  auto ret = paddle::string::str_to_float(str.data(), value);
+  if (!_embedx_codec.IsCompressed() && !_embedx_sgd_codec.IsCompressed()) {
+    _embedx_sgd_rule->InitValue(
+        value + common_feature_value.EmbedxWIndex(),
+        value + common_feature_value.EmbedxG2SumIndex());
+    auto ret = paddle::string::str_to_float(str.data(), value);
+    CHECK(ret >= 6) << "expect more than 6 real:" << ret;
+    return ret;
+  }
+  // the saved value is fp32, parse it in the uncompressed layout first
+  int embedx_w_index = common_feature_value.EmbedxWIndex();
+  int embedx_dim = common_feature_value.embedx_dim;
+  thread_local std::vector<float> buffer;
+  buffer.resize(embedx_w_index + embedx_dim +
+                common_feature_value.embedx_sgd_dim);
+  float* fp32_value = buffer.data();
+  _embedx_sgd_rule->InitValue(fp32_value + embedx_w_index,
+                              fp32_value + embedx_w_index + embedx_dim);
+  auto ret = paddle::string::str_to_float(str.data(), fp32_value);
   CHECK(ret >= 6) << "expect more than 6 real:" << ret;
-  return ret;
+  memcpy(value, fp32_value, std::min(ret, embedx_w_index) * sizeof(float));
+  if (ret <= embedx_w_index) {
+    return ret;
+  }
+  EncodeEmbedx(fp32_value + embedx_w_index,
+               fp32_value + embedx_w_index + embedx_dim,
+               value);
+  return common_feature_value.Dim();
 }
 
 }  // namespace distributed
@@ -20,6 +20,7 @@
 
 #include "paddle/fluid/distributed/common/registerer.h"
 #include "paddle/fluid/distributed/ps/table/accessor.h"
+#include "paddle/fluid/distributed/ps/table/depends/value_codec.h"
 #include "paddle/fluid/distributed/ps/table/sparse_sgd_rule.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
 
@@ -41,8 +42,13 @@ class CtrCommonAccessor : public ValueAccessor {
        std::vector<float> embedx_w;
        std::<vector>float embedx_g2sum;
        */
+    // embedx_w and embedx_g2sum take embedx_storage_dim and
+    // embedx_sgd_storage_dim slots, which are smaller than embedx_dim and
+    // embedx_sgd_dim when embedx_storage_type compresses them.
 
-    int Dim() { return 6 + embed_sgd_dim + embedx_sgd_dim + embedx_dim; }
+    int Dim() {
+      return 6 + embed_sgd_dim + embedx_sgd_storage_dim + embedx_storage_dim;
+    }
     int DimSize(size_t dim, int embedx_dim) { return sizeof(float); }
     int Size() { return Dim() * sizeof(float); }
     int SlotIndex() { return 0; }
@@ -53,7 +59,7 @@ class CtrCommonAccessor : public ValueAccessor {
     int EmbedWIndex() { return ClickIndex() + 1; }
     int EmbedG2SumIndex() { return EmbedWIndex() + 1; }
     int EmbedxWIndex() { return EmbedG2SumIndex() + embed_sgd_dim; }
-    int EmbedxG2SumIndex() { return EmbedxWIndex() + embedx_dim; }
+    int EmbedxG2SumIndex() { return EmbedxWIndex() + embedx_storage_dim; }
 
     float& UnseenDays(float* val) { return val[UnseenDaysIndex()]; }
     float& DeltaScore(float* val) { return val[DeltaScoreIndex()]; }
@@ -68,6 +74,8 @@ class CtrCommonAccessor : public ValueAccessor {
     int embed_sgd_dim;
     int embedx_dim;
     int embedx_sgd_dim;
+    int embedx_storage_dim;
+    int embedx_sgd_storage_dim;
   };
 
   struct CtrCommonPushValue {
@@ -184,6 +192,10 @@ class CtrCommonAccessor : public ValueAccessor {
     if (name == "show") {
       return common_feature_value.Show(value);
     }
+    if (name == "show_click_score") {
+      return ShowClickScore(common_feature_value.Show(value),
+                            common_feature_value.Click(value));
+    }
     return 0.0;
   }
 
@@ -193,9 +205,18 @@ class CtrCommonAccessor : public ValueAccessor {
   // SparseValueSGDRule* _embed_sgd_rule;
   // SparseValueSGDRule* _embedx_sgd_rule;
   // CtrCommonFeatureValue common_feature_value;
+  // pack fp32 embedx_w and embedx_g2sum into the storage slots of value
+  void EncodeEmbedx(const float* embedx_w,
+                    const float* embedx_g2sum,
+                    float* value);
+  void DecodeEmbedx(const float* value, float* embedx_w, float* embedx_g2sum);
+
   float _show_click_decay_rate;
   int32_t _ssd_unseenday_threshold;
   bool _show_scale = false;
+  // codecs of embedx_w and embedx_g2sum, STORE_FP32 keeps them as is
+  ValueCodec _embedx_codec;
+  ValueCodec _embedx_sgd_codec;
 
  public:  // TODO(zhaocaibei123): it should be private, but we make it public
           // for unit test
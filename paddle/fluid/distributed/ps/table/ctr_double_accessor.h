@@ -202,10 +202,15 @@ class CtrDoubleAccessor : public ValueAccessor {
   virtual bool CreateValue(int type, const float* value);
   // 这个接口目前只用来取show
   float GetField(float* value, const std::string& name) override {
-    CHECK_EQ(name, "show");
     if (name == "show") {
       return static_cast<float>(CtrDoubleFeatureValue::Show(value));
     }
+    if (name == "show_click_score") {
+      return static_cast<float>(
+          ShowClickScore(CtrDoubleFeatureValue::Show(value),
+                         CtrDoubleFeatureValue::Click(value)));
+    }
+    CHECK_EQ(name, "show");
     return 0.0;
   }
   // DEFINE_GET_INDEX(CtrDoubleFeatureValue, show)
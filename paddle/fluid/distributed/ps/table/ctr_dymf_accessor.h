@@ -241,6 +241,10 @@ class CtrDymfAccessor : public ValueAccessor {
     if (name == "show") {
       return common_feature_value.Show(value);
     }
+    if (name == "show_click_score") {
+      return ShowClickScore(common_feature_value.Show(value),
+                            common_feature_value.Click(value));
+    }
     return 0.0;
   }
 
@@ -90,15 +90,11 @@ class DSGD : public DenseOptimizer {
               size_t num,
               int begin,
               int end) override {
-    auto update_numel = end - begin;
-    std::vector<float> grads;
-    grads.resize(update_numel);
-
-    auto blas = GetBlas<float>();
+    // one pass without a temporary copy of the gradients
     float lr = *(global_learning_rate_) * (*learning_rate);
-    blas.VCOPY(update_numel, update_values + begin, grads.data());
-    blas.SCAL(update_numel, lr, grads.data());
-    blas.VSUB(update_numel, param + begin, grads.data(), param + begin);
+    for (int i = begin; i < end; ++i) {
+      param[i] -= lr * update_values[i];
+    }
   }
 
   float* learning_rate;
@@ -145,40 +141,21 @@ class DAdam : public DenseOptimizer {
               size_t num,
               int begin,
               int end) override {
-    auto update_numel = end - begin;
-    std::vector<float> grad, grad2, tmp;
-    grad.resize(update_numel);
-    grad2.resize(update_numel);
-    tmp.resize(update_numel);
-
-    auto blas = GetBlas<float>();
-    blas.VCOPY(update_numel, update_values + begin, grad.data());
-    blas.VCOPY(update_numel, update_values + begin, grad2.data());
-
-    blas.SCAL(update_numel, 1 - beta1, grad.data());
-    blas.VSQUARE(update_numel, grad2.data(), grad2.data());
-    blas.SCAL(update_numel, 1 - beta2, grad2.data());
-
-    blas.SCAL(update_numel, beta1, moment1 + begin);
-    blas.VADD(update_numel, moment1 + begin, grad.data(), moment1 + begin);
-    blas.SCAL(update_numel, beta2, moment2 + begin);
-    blas.VADD(update_numel, moment2 + begin, grad2.data(), moment2 + begin);
-
     beta1_pow[0] = beta1_pow[0] * beta1;
     beta2_pow[0] = beta2_pow[0] * beta2;
 
     float lr_ = *(global_learning_rate_)*learning_rate[0];
     lr_ *= sqrt(1 - beta2_pow[0]) / (1 - beta1_pow[0]);
-
-    float* tmp_ = tmp.data();
     float eps_ = epsilon * sqrt(1 - beta2_pow[0]);
 
-    SQRT<float>(update_numel, moment2 + begin, tmp_);
-    ADD<float>(update_numel, tmp_, eps_, tmp_);
-
-    blas.VDIV(update_numel, moment1 + begin, tmp_, tmp_);
-    blas.SCAL(update_numel, lr_, tmp_);
-    blas.VSUB(update_numel, param + begin, tmp_, param + begin);
+    // the moments and the param in one pass over the block, instead of a
+    // blas call and a temporary for each step
+    for (int i = begin; i < end; ++i) {
+      float g = update_values[i];
+      moment1[i] = moment1[i] * beta1 + g * (1 - beta1);
+      moment2[i] = moment2[i] * beta2 + (g * g) * (1 - beta2);
+      param[i] -= lr_ * (moment1[i] / (sqrt(moment2[i]) + eps_));
+    }
   }
 
   float* learning_rate;
@@ -20,6 +20,7 @@
 
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/common/chunk_allocator.h"
+#include "paddle/fluid/distributed/ps/table/depends/flat_hash_map.h"
 
 namespace paddle {
 namespace distributed {
@@ -41,25 +42,41 @@ class FixedFeatureValue {
   std::vector<float> _data;
 };
 
+// A shard keeps its keys either in CTR_SPARSE_SHARD_BUCKET_NUM mct closed
+// hash maps (default), or in a single FlatHashMap probed with SIMD control
+// bytes, see set_flat_map. The map layout must be chosen while the shard is
+// empty; the values are acquired from the same chunk allocator in both cases.
 template <class KEY, class VALUE>
 struct alignas(64) SparseTableShard {
  public:
   typedef typename mct::closed_hash_map<KEY, mct::Pointer, std::hash<KEY>>
       map_type;
+  typedef FlatHashMap<KEY, std::hash<KEY>> flat_map_type;
   struct iterator {
     typename map_type::iterator it;
     size_t bucket;
     map_type* buckets;
+    typename flat_map_type::iterator flat_it;
+    bool flat;
     friend bool operator==(const iterator& a, const iterator& b) {
-      return a.it == b.it;
+      return a.flat ? a.flat_it == b.flat_it : a.it == b.it;
     }
     friend bool operator!=(const iterator& a, const iterator& b) {
-      return a.it != b.it;
+      return !(a == b);
+    }
+    const KEY& key() const { return flat ? flat_it->first : it->first; }
+    VALUE& value() const { return *value_ptr(); }
+    VALUE* value_ptr() const {
+      if (flat) {
+        return (VALUE*)flat_it->second;  // NOLINT
+      }
+      return (VALUE*)(void*)it->second;  // NOLINT
     }
-    const KEY& key() const { return it->first; }
-    VALUE& value() const { return *(VALUE*)(void*)it->second; }     // NOLINT
-    VALUE* value_ptr() const { return (VALUE*)(void*)it->second; }  // NOLINT
     iterator& operator++() {
+      if (flat) {
+        ++flat_it;
+        return *this;
+      }
       ++it;
 
       while (it == buckets[bucket].end() &&
@@ -95,14 +112,37 @@ struct alignas(64) SparseTableShard {
   ~SparseTableShard() { clear(); }
   bool empty() { return _alloc.size() == 0; }
   size_t size() { return _alloc.size(); }
+  // Switch the key index between the bucketed mct maps and the FlatHashMap.
+  // Only allowed on an empty shard.
+  void set_flat_map(bool flat) {
+    PADDLE_ENFORCE_EQ(empty(),
+                      true,
+                      paddle::platform::errors::PreconditionNotMet(
+                          "The map type of SparseTableShard can only be "
+                          "changed when the shard is empty."));
+    _use_flat_map = flat;
+  }
+  bool use_flat_map() const { return _use_flat_map; }
   void set_max_load_factor(float x) {
+    if (_use_flat_map) {
+      _flat_map.max_load_factor(x);
+      return;
+    }
     for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; bucket++) {
       _buckets[bucket].max_load_factor(x);
     }
   }
+  // bucket and local_iterator only cover the mct buckets
   size_t bucket_count() { return CTR_SPARSE_SHARD_BUCKET_NUM; }
   size_t bucket_size(size_t bucket) { return _buckets[bucket].size(); }
   void clear() {
+    if (_use_flat_map) {
+      for (auto it = _flat_map.begin(); it != _flat_map.end(); ++it) {
+        _alloc.release((VALUE*)it->second);  // NOLINT
+      }
+      _flat_map.clear();
+      return;
+    }
     for (size_t bucket = 0; bucket < CTR_SPARSE_SHARD_BUCKET_NUM; bucket++) {
       map_type& data = _buckets[bucket];
       for (auto it = data.begin(); it != data.end(); ++it) {
@@ -112,6 +152,9 @@ struct alignas(64) SparseTableShard {
     }
   }
   iterator begin() {
+    if (_use_flat_map) {
+      return flat_iterator(_flat_map.begin());
+    }
     auto it = _buckets[0].begin();
     size_t bucket = 0;
     while (it == _buckets[bucket].end() &&
@@ -121,6 +164,9 @@ struct alignas(64) SparseTableShard {
     return {it, bucket, _buckets};
   }
   iterator end() {
+    if (_use_flat_map) {
+      return flat_iterator(_flat_map.end());
+    }
     return {_buckets[CTR_SPARSE_SHARD_BUCKET_NUM - 1].end(),
             CTR_SPARSE_SHARD_BUCKET_NUM - 1,
             _buckets};
@@ -129,6 +175,9 @@ struct alignas(64) SparseTableShard {
   local_iterator end(size_t bucket) { return {_buckets[bucket].end()}; }
   iterator find(const KEY& key) {
     size_t hash = _hasher(key);
+    if (_use_flat_map) {
+      return flat_iterator(_flat_map.find_with_hash(key, hash));
+    }
     size_t bucket = compute_bucket(hash);
     auto it = _buckets[bucket].find_with_hash(key, hash);
     if (it == _buckets[bucket].end()) {
@@ -146,6 +195,13 @@ struct alignas(64) SparseTableShard {
   template <class... ARGS>
   std::pair<iterator, bool> emplace(const KEY& key, ARGS&&... args) {
     size_t hash = _hasher(key);
+    if (_use_flat_map) {
+      auto res = _flat_map.insert_with_hash({key, NULL}, hash);
+      if (res.second) {
+        res.first->second = _alloc.acquire(std::forward<ARGS>(args)...);
+      }
+      return {flat_iterator(res.first), res.second};
+    }
     size_t bucket = compute_bucket(hash);
     auto res = _buckets[bucket].insert_with_hash({key, NULL}, hash);
 
@@ -156,7 +212,10 @@ struct alignas(64) SparseTableShard {
     return {{res.first, bucket, _buckets}, res.second};
   }
   iterator erase(iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    _alloc.release(it.value_ptr());
+    if (_use_flat_map) {
+      return flat_iterator(_flat_map.erase(it.flat_it));
+    }
     size_t bucket = it.bucket;
     auto it2 = _buckets[bucket].erase(it.it);
     while (it2 == _buckets[bucket].end() &&
@@ -166,7 +225,11 @@ struct alignas(64) SparseTableShard {
     return {it2, bucket, _buckets};
   }
   void quick_erase(iterator it) {
-    _alloc.release((VALUE*)(void*)it.it->second);  // NOLINT
+    _alloc.release(it.value_ptr());
+    if (_use_flat_map) {
+      _flat_map.quick_erase(it.flat_it);
+      return;
+    }
     _buckets[it.bucket].quick_erase(it.it);
   }
   local_iterator erase(size_t bucket, local_iterator it) {
@@ -194,7 +257,18 @@ struct alignas(64) SparseTableShard {
   }
 
  private:
+  iterator flat_iterator(typename flat_map_type::iterator it) {
+    iterator ret;
+    ret.bucket = 0;
+    ret.buckets = _buckets;
+    ret.flat_it = it;
+    ret.flat = true;
+    return ret;
+  }
+
   map_type _buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
+  flat_map_type _flat_map;
+  bool _use_flat_map = false;
   ChunkAllocator<VALUE> _alloc;
   std::hash<KEY> _hasher;
 };
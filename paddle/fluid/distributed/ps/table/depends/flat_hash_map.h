@@ -0,0 +1,345 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace distributed {
+
+// Open addressing hash map from KEY to an opaque pointer, used as the bucket
+// container of SparseTableShard when FLAT_HASH_MAP is selected.
+//
+// Slots are organized in groups of 16. Every slot owns one control byte that
+// is either kEmpty, kDeleted or the low 7 bits of the hash (h2), and the 16
+// control bytes of a group are compared against h2 with one SSE2 instruction,
+// so a lookup usually touches one control cache line plus the matched slot.
+// Both arrays are cache line aligned, and a group never straddles a line.
+// Payloads are not stored inline: the mapped pointer refers to an object kept
+// in a slab allocator, so returned value addresses stay stable on rehash.
+template <class KEY, class HASH = std::hash<KEY>>
+class FlatHashMap {
+ public:
+  typedef std::pair<KEY, void*> value_type;
+  static constexpr size_t kGroupWidth = 16;
+
+ private:
+  static constexpr int8_t kEmpty = -128;   // 0b10000000
+  static constexpr int8_t kDeleted = -2;   // 0b11111110
+  static constexpr size_t kCacheLine = 64;
+
+ public:
+  class iterator {
+   public:
+    iterator() : _map(nullptr), _index(0) {}
+    iterator(const FlatHashMap* map, size_t index)
+        : _map(map), _index(index) {}
+    value_type& operator*() const { return _map->_slots[_index]; }
+    value_type* operator->() const { return &_map->_slots[_index]; }
+    iterator& operator++() {
+      _index = _map->next_full(_index + 1);
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator ret = *this;
+      ++*this;
+      return ret;
+    }
+    friend bool operator==(const iterator& a, const iterator& b) {
+      return a._index == b._index;
+    }
+    friend bool operator!=(const iterator& a, const iterator& b) {
+      return a._index != b._index;
+    }
+
+   private:
+    friend class FlatHashMap;
+    const FlatHashMap* _map;
+    size_t _index;
+  };
+
+  FlatHashMap() = default;
+  FlatHashMap(const FlatHashMap&) = delete;
+  FlatHashMap& operator=(const FlatHashMap&) = delete;
+  ~FlatHashMap() { free_storage(); }
+
+  size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  size_t capacity() const { return _capacity; }
+  void max_load_factor(float x) {
+    PADDLE_ENFORCE_EQ(x > 0.0f && x < 1.0f,
+                      true,
+                      paddle::platform::errors::InvalidArgument(
+                          "max_load_factor of FlatHashMap should be in (0, 1), "
+                          "but got %f.",
+                          x));
+    _max_load_factor = x;
+    size_t used = _size + _deleted;
+    _growth_left = growth_limit() > used ? growth_limit() - used : 0;
+  }
+
+  iterator begin() const { return iterator(this, next_full(0)); }
+  iterator end() const { return iterator(this, _capacity); }
+
+  void clear() {
+    if (_capacity != 0) {
+      memset(_ctrl, kEmpty, _capacity);
+    }
+    _size = 0;
+    _deleted = 0;
+    _growth_left = growth_limit();
+  }
+
+  void reserve(size_t n) {
+    size_t need = kGroupWidth;
+    while (static_cast<size_t>(need * _max_load_factor) < n) {
+      need <<= 1;
+    }
+    if (need > _capacity) {
+      rehash(need);
+    }
+  }
+
+  iterator find(const KEY& key) const {
+    return find_with_hash(key, _hasher(key));
+  }
+
+  iterator find_with_hash(const KEY& key, size_t hash) const {
+    if (_capacity == 0) {
+      return end();
+    }
+    size_t h = mix(hash);
+    int8_t h2 = static_cast<int8_t>(h & 0x7F);
+    size_t group = (h >> 7) & _group_mask;
+    for (size_t probe = 1;; ++probe) {
+      const int8_t* ctrl = _ctrl + group * kGroupWidth;
+      for (uint32_t mask = match(ctrl, h2); mask != 0; mask &= mask - 1) {
+        size_t idx = group * kGroupWidth + __builtin_ctz(mask);
+        if (_slots[idx].first == key) {
+          return iterator(this, idx);
+        }
+      }
+      if (match(ctrl, kEmpty) != 0) {
+        return end();
+      }
+      // triangular probing visits every group once when the count is 2^n
+      group = (group + probe) & _group_mask;
+    }
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return insert_with_hash(value, _hasher(value.first));
+  }
+
+  std::pair<iterator, bool> insert_with_hash(const value_type& value,
+                                             size_t hash) {
+    auto it = find_with_hash(value.first, hash);
+    if (it != end()) {
+      return {it, false};
+    }
+    if (_growth_left == 0) {
+      // drop tombstones in place when they make up most of the occupancy
+      rehash(_size * 2 < growth_limit() ? _capacity : _capacity * 2);
+    }
+    size_t h = mix(hash);
+    size_t idx = find_insert_slot(h);
+    if (_ctrl[idx] == kDeleted) {
+      --_deleted;
+    } else {
+      --_growth_left;
+    }
+    _ctrl[idx] = static_cast<int8_t>(h & 0x7F);
+    new (&_slots[idx]) value_type(value);
+    ++_size;
+    return {iterator(this, idx), true};
+  }
+
+  iterator erase(iterator it) {
+    size_t next = next_full(it._index + 1);
+    quick_erase(it);
+    return iterator(this, next);
+  }
+
+  void quick_erase(iterator it) {
+    size_t idx = it._index;
+    size_t group = idx / kGroupWidth;
+    // A probe only continues past a group that has no empty slot, so when
+    // the group still has one no probe sequence depends on this entry.
+    if (match(_ctrl + group * kGroupWidth, kEmpty) != 0) {
+      _ctrl[idx] = kEmpty;
+      ++_growth_left;
+    } else {
+      _ctrl[idx] = kDeleted;
+      ++_deleted;
+    }
+    _slots[idx].~value_type();
+    --_size;
+  }
+
+  size_t erase(const KEY& key) {
+    auto it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    quick_erase(it);
+    return 1;
+  }
+
+ private:
+  // std::hash of integers is the identity and the keys of one shard share
+  // their residue modulo the shard number, so scramble all bits first.
+  static size_t mix(size_t h) {
+    uint64_t x = static_cast<uint64_t>(h);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x);
+  }
+
+  static uint32_t match(const int8_t* ctrl, int8_t h) {
+#if defined(__SSE2__)
+    __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), group)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupWidth; ++i) {
+      mask |= static_cast<uint32_t>(ctrl[i] == h) << i;
+    }
+    return mask;
+#endif
+  }
+
+  // empty or deleted slots, i.e. every control byte with the sign bit set
+  static uint32_t match_free(const int8_t* ctrl) {
+#if defined(__SSE2__)
+    __m128i group = _mm_load_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return static_cast<uint32_t>(_mm_movemask_epi8(group));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupWidth; ++i) {
+      mask |= static_cast<uint32_t>(ctrl[i] < 0) << i;
+    }
+    return mask;
+#endif
+  }
+
+  size_t find_insert_slot(size_t h) const {
+    size_t group = (h >> 7) & _group_mask;
+    for (size_t probe = 1;; ++probe) {
+      uint32_t mask = match_free(_ctrl + group * kGroupWidth);
+      if (mask != 0) {
+        return group * kGroupWidth + __builtin_ctz(mask);
+      }
+      group = (group + probe) & _group_mask;
+    }
+  }
+
+  size_t next_full(size_t idx) const {
+    while (idx < _capacity && _ctrl[idx] < 0) {
+      ++idx;
+    }
+    return idx;
+  }
+
+  size_t growth_limit() const {
+    return static_cast<size_t>(_capacity * _max_load_factor);
+  }
+
+  template <class T>
+  static T* aligned_alloc_array(size_t num) {
+    void* ptr = nullptr;
+    int error = posix_memalign(&ptr, kCacheLine, num * sizeof(T));
+    PADDLE_ENFORCE_EQ(error,
+                      0,
+                      paddle::platform::errors::ResourceExhausted(
+                          "Fail to alloc memory of %ld size, error code is %d.",
+                          num * sizeof(T),
+                          error));
+    return reinterpret_cast<T*>(ptr);
+  }
+
+  void free_storage() {
+    if (_capacity != 0) {
+      for (size_t i = 0; i < _capacity; ++i) {
+        if (_ctrl[i] >= 0) {
+          _slots[i].~value_type();
+        }
+      }
+      free(_ctrl);
+      free(_slots);
+    }
+    _ctrl = nullptr;
+    _slots = nullptr;
+    _capacity = 0;
+  }
+
+  void rehash(size_t new_capacity) {
+    new_capacity = std::max(new_capacity, kGroupWidth);
+    int8_t* old_ctrl = _ctrl;
+    value_type* old_slots = _slots;
+    size_t old_capacity = _capacity;
+
+    _ctrl = aligned_alloc_array<int8_t>(new_capacity);
+    _slots = aligned_alloc_array<value_type>(new_capacity);
+    memset(_ctrl, kEmpty, new_capacity);
+    _capacity = new_capacity;
+    _group_mask = new_capacity / kGroupWidth - 1;
+    _deleted = 0;
+    _growth_left = growth_limit() - _size;
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (old_ctrl[i] < 0) {
+        continue;
+      }
+      size_t h = mix(_hasher(old_slots[i].first));
+      size_t idx = find_insert_slot(h);
+      _ctrl[idx] = static_cast<int8_t>(h & 0x7F);
+      new (&_slots[idx]) value_type(std::move(old_slots[i]));
+      old_slots[i].~value_type();
+    }
+    if (old_capacity != 0) {
+      free(old_ctrl);
+      free(old_slots);
+    }
+  }
+
+  int8_t* _ctrl = nullptr;
+  value_type* _slots = nullptr;
+  size_t _capacity = 0;
+  size_t _group_mask = 0;
+  size_t _size = 0;
+  size_t _deleted = 0;
+  size_t _growth_left = 0;
+  float _max_load_factor = 0.875f;
+  HASH _hasher;
+};
+
+}  // namespace distributed
+}  // namespace paddle
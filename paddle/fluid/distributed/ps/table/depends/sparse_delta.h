@@ -0,0 +1,168 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/io/fs.h"
+
+namespace paddle {
+namespace distributed {
+
+// Binary delta checkpoint of a sparse table shard, written by
+// MemorySparseTable::Save with param 6. A file is a sequence of records
+//   uint32 record_len | uint64 key | float value[dim]
+// where record_len counts every byte of the record. The floats are the raw
+// accessor value, so a delta only loads into a table with the same accessor
+// config. dim == 0 marks a key erased since the previous save.
+class SparseDeltaWriter {
+ public:
+  static constexpr size_t kRecordHeadSize = sizeof(uint32_t) + sizeof(uint64_t);
+
+  void Append(uint64_t key, const float* value, size_t dim) {
+    uint32_t len =
+        static_cast<uint32_t>(kRecordHeadSize + dim * sizeof(float));
+    size_t offset = _buffer.size();
+    _buffer.resize(offset + len);
+    char* cursor = &_buffer[offset];
+    memcpy(cursor, &len, sizeof(uint32_t));
+    memcpy(cursor + sizeof(uint32_t), &key, sizeof(uint64_t));
+    if (dim != 0) {
+      memcpy(cursor + kRecordHeadSize, value, dim * sizeof(float));
+    }
+    ++_record_num;
+  }
+  void AppendErased(uint64_t key) { Append(key, nullptr, 0); }
+
+  const char* Data() const { return _buffer.data(); }
+  size_t Size() const { return _buffer.size(); }
+  size_t RecordNum() const { return _record_num; }
+  void Clear() {
+    _buffer.clear();
+    _record_num = 0;
+  }
+
+ private:
+  std::string _buffer;
+  size_t _record_num = 0;
+};
+
+// Calls fn(key, value, dim) for every record of data, returns the number of
+// records or -1 when the buffer ends inside a record.
+inline int64_t ParseSparseDelta(
+    const char* data,
+    size_t size,
+    const std::function<void(uint64_t, const float*, size_t)>& fn) {
+  int64_t record_num = 0;
+  size_t offset = 0;
+  while (offset < size) {
+    if (size - offset < SparseDeltaWriter::kRecordHeadSize) {
+      return -1;
+    }
+    uint32_t len = 0;
+    uint64_t key = 0;
+    memcpy(&len, data + offset, sizeof(uint32_t));
+    memcpy(&key, data + offset + sizeof(uint32_t), sizeof(uint64_t));
+    if (len < SparseDeltaWriter::kRecordHeadSize || len > size - offset ||
+        (len - SparseDeltaWriter::kRecordHeadSize) % sizeof(float) != 0) {
+      return -1;
+    }
+    size_t dim = (len - SparseDeltaWriter::kRecordHeadSize) / sizeof(float);
+    fn(key,
+       reinterpret_cast<const float*>(data + offset +
+                                      SparseDeltaWriter::kRecordHeadSize),
+       dim);
+    offset += len;
+    ++record_num;
+  }
+  return record_num;
+}
+
+inline bool ReadSparseDeltaFile(const std::string& path,
+                                std::string* content) {
+  int err_no = 0;
+  std::shared_ptr<FILE> fp = paddle::framework::fs_open_read(path, &err_no, "");
+  if (fp == nullptr || err_no != 0) {
+    return false;
+  }
+  content->clear();
+  char buffer[1 << 16];
+  size_t read_size = 0;
+  while ((read_size = fread(buffer, 1, sizeof(buffer), fp.get())) > 0) {
+    content->append(buffer, read_size);
+  }
+  return true;
+}
+
+// Compacts a chain of delta files of one shard, oldest first, into a single
+// delta holding the latest state of every key. Erase records are kept, so
+// the output still applies on top of the base the chain started from.
+// Returns the number of records written, or -1 on read/write failure.
+inline int64_t MergeSparseDeltaFiles(const std::vector<std::string>& inputs,
+                                     const std::string& output) {
+  std::unordered_map<uint64_t, std::vector<float>> merged;
+  std::string content;
+  for (auto& input : inputs) {
+    if (!ReadSparseDeltaFile(input, &content)) {
+      LOG(ERROR) << "MergeSparseDeltaFiles read failed, path:" << input;
+      return -1;
+    }
+    int64_t ret = ParseSparseDelta(
+        content.data(),
+        content.size(),
+        [&merged](uint64_t key, const float* value, size_t dim) {
+          merged[key].assign(value, value + dim);
+        });
+    if (ret < 0) {
+      LOG(ERROR) << "MergeSparseDeltaFiles corrupted delta, path:" << input;
+      return -1;
+    }
+  }
+
+  std::vector<uint64_t> keys;
+  keys.reserve(merged.size());
+  for (auto& item : merged) {
+    keys.push_back(item.first);
+  }
+  std::sort(keys.begin(), keys.end());
+  SparseDeltaWriter writer;
+  for (auto key : keys) {
+    auto& value = merged[key];
+    writer.Append(key, value.data(), value.size());
+  }
+
+  int err_no = 0;
+  std::shared_ptr<FILE> fp =
+      paddle::framework::fs_open_write(output, &err_no, "");
+  if (fp == nullptr || err_no != 0 ||
+      fwrite(writer.Data(), 1, writer.Size(), fp.get()) != writer.Size()) {
+    LOG(ERROR) << "MergeSparseDeltaFiles write failed, path:" << output;
+    return -1;
+  }
+  return static_cast<int64_t>(writer.RecordNum());
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,126 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle {
+namespace distributed {
+
+// Packs a row of `dim` floats of a sparse value into fewer float slots, so
+// that the compressed row can live in FixedFeatureValue next to the fp32
+// fields. STORE_FP16 keeps two halves per slot, STORE_INT8 keeps one fp32
+// scale slot followed by four symmetric int8 per slot.
+class ValueCodec {
+ public:
+  ValueCodec() {}
+  ValueCodec(ValueStorageType type, int dim) { Init(type, dim); }
+
+  void Init(ValueStorageType type, int dim) {
+    _type = type;
+    _dim = dim;
+  }
+  ValueStorageType Type() const { return _type; }
+  bool IsCompressed() const { return _type != STORE_FP32; }
+  int Dim() const { return _dim; }
+  // number of float slots taken by one encoded row
+  int StorageDim() const {
+    switch (_type) {
+      case STORE_FP16:
+        return (_dim + 1) / 2;
+      case STORE_INT8:
+        return _dim == 0 ? 0 : 1 + (_dim + 3) / 4;
+      default:
+        return _dim;
+    }
+  }
+
+  void Encode(const float* src, float* dst) const {
+    switch (_type) {
+      case STORE_FP16: {
+        uint16_t* out = reinterpret_cast<uint16_t*>(dst);
+        for (int i = 0; i < _dim; ++i) {
+          out[i] = phi::dtype::float16(src[i]).x;
+        }
+        if (_dim % 2 != 0) {
+          out[_dim] = 0;
+        }
+        break;
+      }
+      case STORE_INT8: {
+        if (_dim == 0) {
+          break;
+        }
+        float max_abs = 0.0f;
+        for (int i = 0; i < _dim; ++i) {
+          max_abs = std::max(max_abs, std::fabs(src[i]));
+        }
+        float scale = max_abs / 127.0f;
+        float inv_scale = scale > 0.0f ? 1.0f / scale : 0.0f;
+        dst[0] = scale;
+        int8_t* out = reinterpret_cast<int8_t*>(dst + 1);
+        for (int i = 0; i < _dim; ++i) {
+          float q = std::round(src[i] * inv_scale);
+          out[i] = static_cast<int8_t>(std::min(std::max(q, -127.0f), 127.0f));
+        }
+        for (int i = _dim; i < (StorageDim() - 1) * 4; ++i) {
+          out[i] = 0;
+        }
+        break;
+      }
+      default:
+        memcpy(dst, src, _dim * sizeof(float));
+    }
+  }
+
+  void Decode(const float* src, float* dst) const {
+    switch (_type) {
+      case STORE_FP16: {
+        const uint16_t* in = reinterpret_cast<const uint16_t*>(src);
+        for (int i = 0; i < _dim; ++i) {
+          dst[i] = static_cast<float>(phi::dtype::raw_uint16_to_float16(in[i]));
+        }
+        break;
+      }
+      case STORE_INT8: {
+        if (_dim == 0) {
+          break;
+        }
+        float scale = src[0];
+        const int8_t* in = reinterpret_cast<const int8_t*>(src + 1);
+        for (int i = 0; i < _dim; ++i) {
+          dst[i] = static_cast<float>(in[i]) * scale;
+        }
+        break;
+      }
+      default:
+        memcpy(dst, src, _dim * sizeof(float));
+    }
+  }
+
+ private:
+  ValueStorageType _type = STORE_FP32;
+  int _dim = 0;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,223 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr_shard.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <unordered_set>
+
+#include "glog/logging.h"
+
+namespace paddle {
+namespace distributed {
+
+GraphCsrShard::~GraphCsrShard() {
+  if (_addr != nullptr) {
+    munmap(_addr, _length);
+    _addr = nullptr;
+  }
+}
+
+int32_t GraphCsrShard::Build(const std::vector<Node *> &nodes,
+                             bool with_weight,
+                             const std::string &path) {
+  std::vector<Node *> sorted_nodes;
+  sorted_nodes.reserve(nodes.size());
+  for (auto *node : nodes) {
+    if (node != nullptr && node->get_neighbor_size() > 0) {
+      sorted_nodes.push_back(node);
+    }
+  }
+  std::sort(sorted_nodes.begin(), sorted_nodes.end(), [](Node *a, Node *b) {
+    return a->get_id() < b->get_id();
+  });
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.has_weight = with_weight ? 1 : 0;
+  header.node_num = sorted_nodes.size();
+  std::vector<uint64_t> ids(sorted_nodes.size());
+  std::vector<uint64_t> offsets(sorted_nodes.size() + 1, 0);
+  for (size_t i = 0; i < sorted_nodes.size(); ++i) {
+    ids[i] = sorted_nodes[i]->get_id();
+    offsets[i + 1] = offsets[i] + sorted_nodes[i]->get_neighbor_size();
+  }
+  header.edge_num = offsets.back();
+
+  FILE *fp = fopen(path.c_str(), "wb");
+  if (fp == nullptr) {
+    LOG(ERROR) << "GraphCsrShard open " << path << " failed";
+    return -1;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  ok = ok && fwrite(ids.data(), sizeof(uint64_t), ids.size(), fp) ==
+                 ids.size();
+  ok = ok && fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), fp) ==
+                 offsets.size();
+  // neighbors and weights are streamed node by node to bound the memory
+  std::vector<uint64_t> neighbors;
+  for (size_t i = 0; ok && i < sorted_nodes.size(); ++i) {
+    size_t degree = sorted_nodes[i]->get_neighbor_size();
+    neighbors.resize(degree);
+    for (size_t j = 0; j < degree; ++j) {
+      neighbors[j] = sorted_nodes[i]->get_neighbor_id(j);
+    }
+    ok = fwrite(neighbors.data(), sizeof(uint64_t), degree, fp) == degree;
+  }
+  std::vector<float> weights;
+  for (size_t i = 0; ok && with_weight && i < sorted_nodes.size(); ++i) {
+    size_t degree = sorted_nodes[i]->get_neighbor_size();
+    weights.resize(degree);
+    for (size_t j = 0; j < degree; ++j) {
+#ifdef PADDLE_WITH_CUDA
+      weights[j] = static_cast<float>(sorted_nodes[i]->get_neighbor_weight(j));
+#else
+      // edge blobs keep no weight without cuda, same as the node sampler
+      weights[j] = 1.0f;
+#endif
+    }
+    ok = fwrite(weights.data(), sizeof(float), degree, fp) == degree;
+  }
+  ok = (fclose(fp) == 0) && ok;
+  if (!ok) {
+    LOG(ERROR) << "GraphCsrShard write " << path << " failed";
+    return -1;
+  }
+  VLOG(1) << "GraphCsrShard build " << path << " node_num:" << header.node_num
+          << " edge_num:" << header.edge_num;
+  return 0;
+}
+
+int32_t GraphCsrShard::Load(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(ERROR) << "GraphCsrShard open " << path << " failed";
+    return -1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    LOG(ERROR) << "GraphCsrShard bad file " << path;
+    close(fd);
+    return -1;
+  }
+  size_t length = static_cast<size_t>(st.st_size);
+  void *addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    LOG(ERROR) << "GraphCsrShard mmap " << path << " failed";
+    return -1;
+  }
+
+  const Header *header = reinterpret_cast<const Header *>(addr);
+  size_t expect_length =
+      sizeof(Header) + sizeof(uint64_t) * (2 * header->node_num + 1) +
+      (sizeof(uint64_t) + (header->has_weight ? sizeof(float) : 0)) *
+          header->edge_num;
+  if (header->magic != kMagic || header->version != kVersion ||
+      expect_length != length) {
+    LOG(ERROR) << "GraphCsrShard corrupted file " << path;
+    munmap(addr, length);
+    return -1;
+  }
+  if (_addr != nullptr) {
+    munmap(_addr, _length);
+  }
+  _addr = addr;
+  _length = length;
+  _node_num = header->node_num;
+  _edge_num = header->edge_num;
+  _ids = reinterpret_cast<const uint64_t *>(header + 1);
+  _offsets = _ids + _node_num;
+  _neighbors = _offsets + _node_num + 1;
+  _weights = header->has_weight
+                 ? reinterpret_cast<const float *>(_neighbors + _edge_num)
+                 : nullptr;
+  VLOG(0) << "GraphCsrShard load " << path << " node_num:" << _node_num
+          << " edge_num:" << _edge_num;
+  return 0;
+}
+
+int64_t GraphCsrShard::Find(uint64_t id) const {
+  const uint64_t *end = _ids + _node_num;
+  const uint64_t *pos = std::lower_bound(_ids, end, id);
+  if (pos == end || *pos != id) {
+    return -1;
+  }
+  return pos - _ids;
+}
+
+std::vector<int> GraphCsrShard::SampleK(
+    int64_t pos,
+    int k,
+    bool is_weighted,
+    const std::shared_ptr<std::mt19937_64> &rng) const {
+  int degree = static_cast<int>(Degree(pos));
+  std::vector<int> res;
+  if (k <= 0 || degree == 0) {
+    return res;
+  }
+  if (k >= degree) {
+    res.resize(degree);
+    for (int i = 0; i < degree; ++i) {
+      res[i] = i;
+    }
+    return res;
+  }
+  res.reserve(k);
+  if (is_weighted && _weights != nullptr) {
+    // A-Res: keep the k largest u^(1/w)
+    const float *weights = _weights + _offsets[pos];
+    std::uniform_real_distribution<double> distrib(0.0, 1.0);
+    std::vector<std::pair<double, int>> keys(degree);
+    for (int i = 0; i < degree; ++i) {
+      double w = std::max(static_cast<double>(weights[i]), 1e-12);
+      keys[i] = {std::log(distrib(*rng)) / w, i};
+    }
+    std::nth_element(keys.begin(),
+                     keys.begin() + k - 1,
+                     keys.end(),
+                     std::greater<std::pair<double, int>>());
+    for (int i = 0; i < k; ++i) {
+      res.push_back(keys[i].second);
+    }
+    return res;
+  }
+  // Floyd's algorithm, k distinct indexes without touching the others
+  std::unordered_set<int> picked;
+  for (int j = degree - k; j < degree; ++j) {
+    std::uniform_int_distribution<int> distrib(0, j);
+    int t = distrib(*rng);
+    if (!picked.insert(t).second) {
+      picked.insert(j);
+      t = j;
+    }
+    res.push_back(t);
+  }
+  return res;
+}
+
+}  // namespace distributed
+}  // namespace paddle
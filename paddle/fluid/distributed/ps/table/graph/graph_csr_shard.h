@@ -0,0 +1,93 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
+
+namespace paddle {
+namespace distributed {
+
+// Read-only edge storage of one graph shard packed in CSR arrays. The file
+// is laid out as
+//   Header | ids[node_num] | offsets[node_num + 1] | neighbors[edge_num]
+//          | weights[edge_num] (only when has_weight)
+// with ids sorted, so it is built once offline by Build and mapped as is by
+// Load, without any per node allocation.
+class GraphCsrShard {
+ public:
+  static const uint64_t kMagic = 0x5253435048504150ULL;  // "PAPHPCSR"
+  static const uint32_t kVersion = 1;
+  struct Header {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t has_weight;
+    uint64_t node_num;
+    uint64_t edge_num;
+    uint64_t reserved[4];
+  };
+
+  GraphCsrShard() {}
+  ~GraphCsrShard();
+  GraphCsrShard(const GraphCsrShard &) = delete;
+  GraphCsrShard &operator=(const GraphCsrShard &) = delete;
+
+  // writes the edges of nodes to path, returns 0 on success
+  static int32_t Build(const std::vector<Node *> &nodes,
+                       bool with_weight,
+                       const std::string &path);
+  // maps a file written by Build, returns 0 on success
+  int32_t Load(const std::string &path);
+
+  // position of id in the shard, -1 when it has no edge here
+  int64_t Find(uint64_t id) const;
+  size_t Degree(int64_t pos) const {
+    return static_cast<size_t>(_offsets[pos + 1] - _offsets[pos]);
+  }
+  uint64_t NeighborId(int64_t pos, int idx) const {
+    return _neighbors[_offsets[pos] + idx];
+  }
+  float NeighborWeight(int64_t pos, int idx) const {
+    return _weights == nullptr ? 1.0f : _weights[_offsets[pos] + idx];
+  }
+  // same contract as Node::sample_k: up to k distinct neighbor indexes,
+  // drawn uniformly or, when weighted and weights exist, by weight
+  std::vector<int> SampleK(int64_t pos,
+                           int k,
+                           bool is_weighted,
+                           const std::shared_ptr<std::mt19937_64> &rng) const;
+
+  uint64_t NodeNum() const { return _node_num; }
+  uint64_t EdgeNum() const { return _edge_num; }
+  bool HasWeight() const { return _weights != nullptr; }
+
+ private:
+  void *_addr = nullptr;
+  size_t _length = 0;
+  uint64_t _node_num = 0;
+  uint64_t _edge_num = 0;
+  const uint64_t *_ids = nullptr;
+  const uint64_t *_offsets = nullptr;
+  const uint64_t *_neighbors = nullptr;
+  const float *_weights = nullptr;
+};
+
+}  // namespace distributed
+}  // namespace paddle
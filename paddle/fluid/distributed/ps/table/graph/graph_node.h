@@ -48,6 +48,11 @@ class Node {
       int k UNUSED, const std::shared_ptr<std::mt19937_64> rng UNUSED) {
     return std::vector<int>();
   }
+  virtual int sample_k(int k UNUSED,
+                       const std::shared_ptr<std::mt19937_64> rng UNUSED,
+                       int *out UNUSED) {
+    return 0;
+  }
   virtual uint64_t get_neighbor_id(int idx UNUSED) { return 0; }
 #ifdef PADDLE_WITH_CUDA
   virtual half get_neighbor_weight(int idx UNUSED) { return 1.; }
@@ -104,6 +109,11 @@ class GraphNode : public Node {
       int k, const std::shared_ptr<std::mt19937_64> rng) {
     return sampler->sample_k(k, rng);
   }
+  virtual int sample_k(int k,
+                       const std::shared_ptr<std::mt19937_64> rng,
+                       int *out) {
+    return sampler->sample_k(k, rng, out);
+  }
   virtual uint64_t get_neighbor_id(int idx) { return edges->get_id(idx); }
 #ifdef PADDLE_WITH_CUDA
   virtual half get_neighbor_weight(int idx) { return edges->get_weight(idx); }
@@ -0,0 +1,217 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+// Cache of sample results striped by key hash. Every stripe has its own
+// lock, index and CLOCK ring, so sampling threads only meet when their keys
+// land in the same stripe, and there is no background shrink: a full stripe
+// evicts in place on insert. An entry is valid for ttl passes after the pass
+// it was inserted in, ttl 0 keeps it until evicted.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class ShardedClockCache {
+ public:
+  struct Stats {
+    uint64_t hit = 0;
+    uint64_t miss = 0;
+    uint64_t insert = 0;
+    uint64_t evict = 0;
+    uint64_t expire = 0;
+  };
+
+  ShardedClockCache(size_t stripe_num, size_t size_limit, uint32_t ttl)
+      : _stripe_num(std::max<size_t>(stripe_num, 1)),
+        _ttl(ttl),
+        _pass_id(0),
+        _stripes(new Stripe[_stripe_num]) {
+    size_t capacity = std::max<size_t>(size_limit / _stripe_num, 1);
+    for (size_t i = 0; i < _stripe_num; ++i) {
+      _stripes[i].capacity = capacity;
+      _stripes[i].index.reserve(capacity);
+      _stripes[i].slots.reserve(capacity);
+    }
+  }
+  ShardedClockCache(const ShardedClockCache &) = delete;
+  ShardedClockCache &operator=(const ShardedClockCache &) = delete;
+
+  // appends the hit (key, value) pairs to res in the order of keys
+  void Query(const K *keys,
+             size_t length,
+             std::vector<std::pair<K, V>> *res) {
+    uint32_t pass_id = _pass_id.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < length; ++i) {
+      Stripe &stripe = GetStripe(keys[i]);
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      auto iter = stripe.index.find(keys[i]);
+      if (iter == stripe.index.end()) {
+        ++stripe.stats.miss;
+        continue;
+      }
+      Entry &entry = stripe.slots[iter->second];
+      if (Expired(entry, pass_id)) {
+        entry.used = false;
+        stripe.index.erase(iter);
+        ++stripe.stats.expire;
+        ++stripe.stats.miss;
+        continue;
+      }
+      entry.referenced = true;
+      ++stripe.stats.hit;
+      res->emplace_back(keys[i], entry.value);
+    }
+  }
+
+  void Insert(const K *keys, const V *values, size_t length) {
+    uint32_t pass_id = _pass_id.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < length; ++i) {
+      Stripe &stripe = GetStripe(keys[i]);
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      ++stripe.stats.insert;
+      auto iter = stripe.index.find(keys[i]);
+      if (iter != stripe.index.end()) {
+        Entry &entry = stripe.slots[iter->second];
+        entry.value = values[i];
+        entry.pass_id = pass_id;
+        entry.referenced = true;
+        continue;
+      }
+      size_t pos = 0;
+      if (stripe.slots.size() < stripe.capacity) {
+        pos = stripe.slots.size();
+        stripe.slots.push_back({keys[i], values[i], pass_id, false, true});
+      } else {
+        pos = Evict(&stripe, pass_id);
+        Entry &entry = stripe.slots[pos];
+        entry.key = keys[i];
+        entry.value = values[i];
+        entry.pass_id = pass_id;
+        entry.referenced = false;
+        entry.used = true;
+      }
+      stripe.index.emplace(keys[i], pos);
+    }
+  }
+
+  // entries inserted before pass_id - ttl + 1 stop hitting from now on
+  void SetPass(uint32_t pass_id) {
+    _pass_id.store(pass_id, std::memory_order_relaxed);
+  }
+  uint32_t GetPass() const { return _pass_id.load(std::memory_order_relaxed); }
+  uint32_t GetTtl() const { return _ttl; }
+
+  Stats GetStats() const {
+    Stats total;
+    for (size_t i = 0; i < _stripe_num; ++i) {
+      std::lock_guard<std::mutex> lock(_stripes[i].mutex);
+      const Stats &stats = _stripes[i].stats;
+      total.hit += stats.hit;
+      total.miss += stats.miss;
+      total.insert += stats.insert;
+      total.evict += stats.evict;
+      total.expire += stats.expire;
+    }
+    return total;
+  }
+
+  size_t Size() const {
+    size_t size = 0;
+    for (size_t i = 0; i < _stripe_num; ++i) {
+      std::lock_guard<std::mutex> lock(_stripes[i].mutex);
+      size += _stripes[i].index.size();
+    }
+    return size;
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < _stripe_num; ++i) {
+      std::lock_guard<std::mutex> lock(_stripes[i].mutex);
+      _stripes[i].index.clear();
+      _stripes[i].slots.clear();
+      _stripes[i].hand = 0;
+    }
+  }
+
+ private:
+  struct Entry {
+    K key;
+    V value;
+    uint32_t pass_id;
+    bool referenced;
+    bool used;
+  };
+  struct alignas(64) Stripe {
+    mutable std::mutex mutex;
+    std::unordered_map<K, size_t, Hash> index;
+    std::vector<Entry> slots;
+    size_t capacity = 1;
+    size_t hand = 0;
+    Stats stats;
+  };
+
+  Stripe &GetStripe(const K &key) {
+    // the stripe hash is mixed again, K hashes are often plain xors of ids
+    uint64_t h = static_cast<uint64_t>(_hash(key)) * 0x9E3779B97F4A7C15ULL;
+    return _stripes[(h >> 32) % _stripe_num];
+  }
+
+  bool Expired(const Entry &entry, uint32_t pass_id) const {
+    return _ttl != 0 && pass_id - entry.pass_id >= _ttl;
+  }
+
+  // second chance sweep over a full ring, returns the slot to reuse
+  size_t Evict(Stripe *stripe, uint32_t pass_id) {
+    size_t size = stripe->slots.size();
+    while (true) {
+      size_t pos = stripe->hand;
+      stripe->hand = (stripe->hand + 1) % size;
+      Entry &entry = stripe->slots[pos];
+      if (!entry.used) {
+        return pos;
+      }
+      if (Expired(entry, pass_id)) {
+        ++stripe->stats.expire;
+      } else if (entry.referenced) {
+        entry.referenced = false;
+        continue;
+      } else {
+        ++stripe->stats.evict;
+      }
+      stripe->index.erase(entry.key);
+      entry.used = false;
+      return pos;
+    }
+  }
+
+  size_t _stripe_num;
+  uint32_t _ttl;
+  std::atomic<uint32_t> _pass_id;
+  std::unique_ptr<Stripe[]> _stripes;
+  Hash _hash;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,137 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "paddle/fluid/distributed/ps/thirdparty/round_robin.h"
+
+namespace paddle {
+namespace distributed {
+
+struct StreamPartitionStat {
+  explicit StreamPartitionStat(int part_num = 0)
+      : edges(part_num, 0), replicas(part_num, 0), cut_edges(part_num, 0) {}
+  void Merge(const StreamPartitionStat &other) {
+    if (edges.size() < other.edges.size()) {
+      edges.resize(other.edges.size(), 0);
+      replicas.resize(other.edges.size(), 0);
+      cut_edges.resize(other.edges.size(), 0);
+    }
+    for (size_t i = 0; i < other.edges.size(); ++i) {
+      edges[i] += other.edges[i];
+      replicas[i] += other.replicas[i];
+      cut_edges[i] += other.cut_edges[i];
+    }
+    vertex_num += other.vertex_num;
+  }
+  // vertex copies over distinct vertices
+  double ReplicationFactor() const {
+    uint64_t total = 0;
+    for (auto r : replicas) total += r;
+    return vertex_num == 0 ? 0.0 : 1.0 * total / vertex_num;
+  }
+
+  std::vector<uint64_t> edges;
+  // vertices with at least one edge on the partition
+  std::vector<uint64_t> replicas;
+  // edges whose source or destination also lives on another partition
+  std::vector<uint64_t> cut_edges;
+  uint64_t vertex_num = 0;
+};
+
+// HDRF streaming vertex-cut partitioner (Petroni et al., CIKM 2015). Every
+// edge goes to the partition that already holds the endpoint of the higher
+// partial degree, favouring the lighter partitions by lambda. Assignments
+// only depend on the order of the edges fed in, so ranks reading the same
+// file with their own partitioner agree on every edge without talking.
+class HdrfPartitioner {
+ public:
+  explicit HdrfPartitioner(int part_num,
+                           double lambda = 1.0,
+                           double epsilon = 1.0)
+      : _part_num(part_num),
+        _lambda(lambda),
+        _epsilon(epsilon),
+        _part_edges(part_num, 0),
+        _stat(part_num) {}
+
+  static constexpr int kMaxPartNum = 64;
+
+  int Assign(uint64_t src, uint64_t dst) {
+    VertexState &u = _vertices[src];
+    VertexState &v = _vertices[dst];
+    ++u.degree;
+    ++v.degree;
+    double theta_u = 1.0 * u.degree / (u.degree + v.degree);
+    double theta_v = 1.0 - theta_u;
+    uint64_t max_size = _max_edges;
+    uint64_t min_size = *std::min_element(_part_edges.begin(),
+                                          _part_edges.end());
+    int best = 0;
+    double best_score = std::numeric_limits<double>::lowest();
+    for (int p = 0; p < _part_num; ++p) {
+      uint64_t bit = 1ULL << p;
+      double rep = ((u.parts & bit) ? 2.0 - theta_u : 0.0) +
+                   ((v.parts & bit) ? 2.0 - theta_v : 0.0);
+      double bal = _lambda * (max_size - _part_edges[p]) /
+                   (_epsilon + max_size - min_size);
+      if (rep + bal > best_score) {
+        best_score = rep + bal;
+        best = p;
+      }
+    }
+    uint64_t bit = 1ULL << best;
+    if (!(u.parts & bit)) {
+      u.parts |= bit;
+      ++_stat.replicas[best];
+    }
+    if (!(v.parts & bit)) {
+      v.parts |= bit;
+      ++_stat.replicas[best];
+    }
+    if ((u.parts | v.parts) != bit) {
+      ++_stat.cut_edges[best];
+    }
+    ++_stat.edges[best];
+    _max_edges = std::max(_max_edges, ++_part_edges[best]);
+    return best;
+  }
+
+  StreamPartitionStat GetStat() const {
+    StreamPartitionStat stat = _stat;
+    stat.vertex_num = _vertices.size();
+    return stat;
+  }
+
+ private:
+  struct VertexState {
+    uint32_t degree = 0;
+    uint64_t parts = 0;
+  };
+
+  int _part_num;
+  double _lambda;
+  double _epsilon;
+  std::vector<uint64_t> _part_edges;
+  uint64_t _max_edges = 0;
+  robin_hood::unordered_node_map<uint64_t, VertexState> _vertices;
+  StreamPartitionStat _stat;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -14,6 +14,9 @@
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_weighted_sampler.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <unordered_map>
@@ -161,5 +164,117 @@ int WeightedSampler::sample(
   subtract_count_map[this]++;
   return return_idx;
 }
+
+void AliasSampler::build(GraphEdgeBlob *edges) {
+  int n = edges->size();
+  weights.resize(n);
+  prob.resize(n);
+  alias.resize(n);
+  if (n == 0) {
+    return;
+  }
+  auto *weighted_edges = reinterpret_cast<WeightedGraphEdgeBlob *>(edges);
+  double sum = 0;
+  for (int i = 0; i < n; i++) {
+#ifdef PADDLE_WITH_CUDA
+    weights[i] = static_cast<float>(weighted_edges->get_weight(i));
+#else
+    // edge blobs keep no weight without cuda
+    (void)weighted_edges;
+    weights[i] = 1.0f;
+#endif
+    weights[i] = std::max(weights[i], 0.0f);
+    sum += weights[i];
+  }
+  if (sum <= 0) {
+    std::fill(weights.begin(), weights.end(), 1.0f);
+    sum = n;
+  }
+  std::vector<double> scaled(n);
+  std::vector<int> small, large;
+  for (int i = 0; i < n; i++) {
+    scaled[i] = weights[i] * n / sum;
+    alias[i] = i;
+    if (scaled[i] < 1.0) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+  while (!small.empty() && !large.empty()) {
+    int s = small.back(), l = large.back();
+    small.pop_back();
+    prob[s] = static_cast<float>(scaled[s]);
+    alias[s] = l;
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // leftovers are 1 up to rounding
+  for (int i : small) prob[i] = 1.0f;
+  for (int i : large) prob[i] = 1.0f;
+}
+
+std::vector<int> AliasSampler::sample_k(
+    int k, const std::shared_ptr<std::mt19937_64> rng) {
+  std::vector<int> sample_result(std::min<size_t>(k, prob.size()));
+  sample_result.resize(sample_k(k, rng, sample_result.data()));
+  return sample_result;
+}
+
+int AliasSampler::sample_k(int k,
+                           const std::shared_ptr<std::mt19937_64> rng,
+                           int *out) {
+  int n = prob.size();
+  if (k >= n) {
+    for (int i = 0; i < n; i++) {
+      out[i] = i;
+    }
+    return n;
+  }
+  if (k <= 0) {
+    return 0;
+  }
+  // per thread scratch, reset through out before returning
+  thread_local std::vector<char> picked;
+  if (picked.size() < static_cast<size_t>(n)) {
+    picked.resize(n, 0);
+  }
+  int count = 0;
+  int max_tries = 4 * k + 16;
+  for (int tries = 0; count < k && tries < max_tries; tries++) {
+    int x = sample_one(rng.get());
+    if (!picked[x]) {
+      picked[x] = 1;
+      out[count++] = x;
+    }
+  }
+  if (count < k) {
+    // A-Res over the unpicked edges: keep the largest log(u) / w
+    thread_local std::vector<std::pair<float, int>> keys;
+    keys.clear();
+    std::uniform_real_distribution<float> distrib(0, 1.0);
+    for (int i = 0; i < n; i++) {
+      if (!picked[i]) {
+        float w = std::max(weights[i], 1e-12f);
+        keys.emplace_back(std::log(distrib(*rng)) / w, i);
+      }
+    }
+    int rest = k - count;
+    std::nth_element(keys.begin(),
+                     keys.begin() + rest - 1,
+                     keys.end(),
+                     std::greater<std::pair<float, int>>());
+    for (int i = 0; i < rest; i++) {
+      out[count++] = keys[i].second;
+    }
+  }
+  for (int i = 0; i < count; i++) {
+    picked[out[i]] = 0;
+  }
+  return count;
+}
 }  // namespace distributed
 }  // namespace paddle
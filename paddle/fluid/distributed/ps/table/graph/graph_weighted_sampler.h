@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
 #include <ctime>
 #include <memory>
 #include <random>
@@ -29,6 +30,15 @@ class Sampler {
   virtual void build(GraphEdgeBlob *edges) = 0;
   virtual std::vector<int> sample_k(
       int k, const std::shared_ptr<std::mt19937_64> rng) = 0;
+  // writes up to k distinct indexes to out, which holds at least k ints,
+  // and returns how many were written
+  virtual int sample_k(int k,
+                       const std::shared_ptr<std::mt19937_64> rng,
+                       int *out) {
+    std::vector<int> res = sample_k(k, rng);
+    std::copy(res.begin(), res.end(), out);
+    return static_cast<int>(res.size());
+  }
 };
 
 class RandomSampler : public Sampler {
@@ -62,5 +72,33 @@ class WeightedSampler : public Sampler {
       std::unordered_map<WeightedSampler *, int> &subtract_count_map,  // NOLINT
       float &subtract);                                                // NOLINT
 };
+
+// Walker/Vose alias table over the edge weights, built once per node into
+// two flat arrays. One draw costs O(1): a uniform slot and a coin against
+// its probability. Distinct samples are drawn by rejecting repeats, and the
+// rest is finished by weighted reservoir sampling over the unpicked edges
+// when the repeats pile up on heavy edges.
+class AliasSampler : public Sampler {
+ public:
+  virtual ~AliasSampler() {}
+  virtual void build(GraphEdgeBlob *edges);
+  virtual std::vector<int> sample_k(int k,
+                                    const std::shared_ptr<std::mt19937_64> rng);
+  virtual int sample_k(int k,
+                       const std::shared_ptr<std::mt19937_64> rng,
+                       int *out);
+
+ private:
+  int sample_one(std::mt19937_64 *rng) const {
+    uint64_t r = (*rng)();
+    int slot = static_cast<int>(((r >> 32) * prob.size()) >> 32);
+    float u = static_cast<float>(r & 0xFFFFFFFFULL) * (1.0f / 4294967296.0f);
+    return u < prob[slot] ? slot : alias[slot];
+  }
+
+  std::vector<float> weights;
+  std::vector<float> prob;
+  std::vector<int> alias;
+};
 }  // namespace distributed
 }  // namespace paddle
@@ -16,11 +16,23 @@
 
 #include "paddle/fluid/platform/enforce.h"
 
+PD_DEFINE_bool(pserver_merge_dense_push,
+               false,
+               "merge the async dense pushes that wait for the same block, and "
+               "update the block once with the sum of their gradients");
+
 namespace paddle {
 namespace distributed {
 
 int FLAGS_pslib_table_save_max_retry_dense = 3;
 
+namespace {
+
+// floats in a 64 bytes cache line
+constexpr int kDenseBlockAlign = 16;
+
+}  // namespace
+
 void MemoryDenseTable::CreateInitializer(const std::string &attr,
                                          const std::string &name) {
   auto slices = string::split_string<std::string>(attr, "&");
@@ -96,6 +108,17 @@ int32_t MemoryDenseTable::InitializeValue() {
           << " fixed_len_params_dim: " << fixed_len_params_dim_;
 
   pull_reservoir_ = ReservoirValue<float>(param_dim_);
+
+  // split the param evenly by cache lines, so that the tasks of two blocks
+  // never write the same line
+  int lines = (param_dim_ + kDenseBlockAlign - 1) / kDenseBlockAlign;
+  block_begins_ = bucket(lines, task_pool_size_);
+  for (auto &begin : block_begins_) {
+    begin = std::min(begin * kDenseBlockAlign, param_dim_);
+  }
+  blocks_.reset(new DenseBlock[task_pool_size_]);
+  merged_grads_.resize(param_dim_);
+  update_grads_.resize(param_dim_);
   return 0;
 }
 
@@ -192,14 +215,17 @@ int32_t MemoryDenseTable::_PushDense(const float *values, size_t num) {
       paddle::platform::errors::InvalidArgument(
           "update dense numel expected %d, but got %d", param_dim_, num));
 
-  std::vector<int> buckets = bucket(param_dim_, task_pool_size_);
+  if (FLAGS_pserver_merge_dense_push) {
+    return MergePushDense(values);
+  }
+
   std::vector<std::future<int>> tasks(task_pool_size_);
 
   for (int shard_id = 0; shard_id < task_pool_size_; ++shard_id) {
     tasks[shard_id] = _shards_task_pool[shard_id]->enqueue(
-        [this, shard_id, &buckets, &values]() -> int {
-          auto begin = buckets[shard_id];
-          auto end = buckets[shard_id + 1];
+        [this, shard_id, &values]() -> int {
+          auto begin = block_begins_[shard_id];
+          auto end = block_begins_[shard_id + 1];
           optimizer_->Update(values, param_dim_, begin, end);
           return 0;
         });
@@ -212,6 +238,54 @@ int32_t MemoryDenseTable::_PushDense(const float *values, size_t num) {
   return 0;
 }
 
+int32_t MemoryDenseTable::MergePushDense(const float *values) {
+  // A push either schedules the update of a block, or adds its gradients to
+  // the ones of an update not started yet. The update takes the sum, so the
+  // pushes arriving while a block is updated cost one update together.
+  std::vector<std::shared_future<int>> updates(task_pool_size_);
+  for (int shard_id = 0; shard_id < task_pool_size_; ++shard_id) {
+    auto begin = block_begins_[shard_id];
+    auto end = block_begins_[shard_id + 1];
+    auto &block = blocks_[shard_id];
+    std::lock_guard<std::mutex> lock(block.mutex);
+    if (block.merged_num == 0) {
+      std::copy(values + begin, values + end, merged_grads_.begin() + begin);
+      auto task = [this, shard_id]() -> int {
+        return UpdateMergedBlock(shard_id);
+      };
+      block.update = _shards_task_pool[shard_id]->enqueue(task).share();
+    } else {
+      for (int i = begin; i < end; ++i) {
+        merged_grads_[i] += values[i];
+      }
+    }
+    ++block.merged_num;
+    updates[shard_id] = block.update;
+  }
+
+  for (auto &update : updates) {
+    update.wait();
+  }
+  VLOG(2) << "debug MemoryDenseTable::MergePushDense done";
+  return 0;
+}
+
+int32_t MemoryDenseTable::UpdateMergedBlock(int shard_id) {
+  auto begin = block_begins_[shard_id];
+  auto end = block_begins_[shard_id + 1];
+  auto &block = blocks_[shard_id];
+  {
+    // take the merged gradients, the next pushes start a new sum
+    std::lock_guard<std::mutex> lock(block.mutex);
+    std::copy(merged_grads_.begin() + begin,
+              merged_grads_.begin() + end,
+              update_grads_.begin() + begin);
+    block.merged_num = 0;
+  }
+  optimizer_->Update(update_grads_.data(), param_dim_, begin, end);
+  return 0;
+}
+
 int32_t MemoryDenseTable::Load(const std::string &path,
                                const std::string &param) {
   if (param_dim_ <= 0) {
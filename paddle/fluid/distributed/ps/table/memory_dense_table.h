@@ -18,6 +18,9 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include "Eigen/Dense"
@@ -66,6 +69,10 @@ class MemoryDenseTable : public Table {
 
  protected:
   int32_t _PushDense(const float* values, size_t num);
+  // add the gradients to the ones waiting for the update of each block
+  int32_t MergePushDense(const float* values);
+  // run by the task pool of the block
+  int32_t UpdateMergedBlock(int shard_id);
 
  private:
   const int task_pool_size_ = 10;
@@ -81,6 +88,19 @@ class MemoryDenseTable : public Table {
   int total_dim_ = 0;
   int fixed_len_params_dim_ = 0;    // used for save/load
   std::vector<int> param_col_ids_;  // used for save/load
+
+  // The param is updated in task_pool_size_ blocks, each by its own task
+  // pool. The blocks start at cache line boundaries.
+  struct DenseBlock {
+    std::mutex mutex;
+    // number of the pushes merged into the gradients waiting for the update
+    int merged_num = 0;
+    std::shared_future<int> update;
+  };
+  std::vector<int> block_begins_;
+  std::unique_ptr<DenseBlock[]> blocks_;
+  std::vector<float> merged_grads_;
+  std::vector<float> update_grads_;
 };
 
 }  // namespace distributed
@@ -18,7 +18,9 @@
 #include "glog/logging.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
 #include "paddle/fluid/distributed/common/local_random.h"
+#include "paddle/fluid/distributed/common/numa_utils.h"
 #include "paddle/fluid/distributed/common/topk_calculator.h"
+#include "paddle/fluid/distributed/ps/table/depends/sparse_delta.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
 #include "paddle/fluid/framework/archive.h"
 #include "paddle/fluid/framework/io/fs.h"
@@ -39,6 +41,11 @@ PD_DEFINE_int32(pserver_table_save_max_retry,
                 3,
                 "pserver_table_save_max_retry");
 
+PD_DEFINE_bool(pserver_numa_bind,
+               false,
+               "bind the task thread of every shard to a numa node, the shard "
+               "memory follows it by first touch");
+
 namespace paddle {
 namespace distributed {
 
@@ -51,6 +58,21 @@ int32_t MemorySparseTable::Initialize() {
   for (auto &shards_task : _shards_task_pool) {
     shards_task.reset(new ::ThreadPool(1));
   }
+  if (FLAGS_pserver_numa_bind) {
+    std::vector<std::future<bool>> tasks;
+    for (int i = 0; i < _task_pool_size; ++i) {
+      int node = NumaNodeOfShard(i);
+      tasks.push_back(_shards_task_pool[i]->enqueue(
+          [node]() -> bool { return BindCurrentThreadToNumaNode(node); }));
+    }
+    int bound_num = 0;
+    for (auto &task : tasks) {
+      bound_num += task.get() ? 1 : 0;
+    }
+    LOG(INFO) << "MemorySparseTable bind " << bound_num << " of "
+              << _task_pool_size << " shard threads to "
+              << NumaTopology::Instance().NodeNum() << " numa nodes";
+  }
   VLOG(0) << "initalize MemorySparseTable succ";
   return 0;
 }
@@ -73,9 +95,13 @@ int32_t MemorySparseTable::InitializeValue() {
   VLOG(1) << "memory sparse table _avg_local_shard_num: "
           << _avg_local_shard_num
           << " _real_local_shard_num: " << _real_local_shard_num
-          << " _task_pool_size:" << _task_pool_size;
+          << " _task_pool_size:" << _task_pool_size
+          << " shard_map_type:"
+          << SparseShardMapType_Name(_config.shard_map_type());
 
-  _local_shards.reset(new shard_type[_real_local_shard_num]);
+  _local_shards.reset(CreateShards(_real_local_shard_num));
+  _dirty_keys.resize(_real_local_shard_num);
+  _delta_full_dump.reset(new bool[_real_local_shard_num]());
 
   if (_config.enable_revert()) {
     // calculate merged shard number based on config param;
@@ -99,11 +125,30 @@ int32_t MemorySparseTable::InitializeValue() {
     LOG(INFO) << "merged shard info: [" << _m_sparse_table_shard_num << "|"
               << _m_avg_local_shard_num << "|" << _m_real_local_shard_num
               << "]";
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);  // NOLINT
+    _local_shards_new.reset(CreateShards(_real_local_shard_num));
   }
   return 0;
 }
 
+int MemorySparseTable::NumaNodeOfShard(int shard_id) const {
+  int node_num = NumaTopology::Instance().NodeNum();
+  if (!FLAGS_pserver_numa_bind || node_num <= 1) {
+    return -1;
+  }
+  // requests are routed by shard_id % _task_pool_size to the shard threads
+  return (shard_id % _task_pool_size) % node_num;
+}
+
+MemorySparseTable::shard_type *MemorySparseTable::CreateShards(
+    int shard_num) {
+  shard_type *shards = new shard_type[shard_num];  // NOLINT
+  bool use_flat_map = _config.shard_map_type() == FLAT_HASH_MAP;
+  for (int i = 0; i < shard_num; ++i) {
+    shards[i].set_flat_map(use_flat_map);
+  }
+  return shards;
+}
+
 int32_t MemorySparseTable::Load(const std::string &path,
                                 const std::string &param) {
   std::string table_path = TableDir(path);
@@ -129,6 +174,9 @@ int32_t MemorySparseTable::Load(const std::string &path,
   if (load_param == 5) {
     return LoadPatch(file_list, load_param);
   }
+  if (load_param == 6) {
+    return LoadDelta(file_list);
+  }
 
   size_t file_start_idx = _shard_idx * _avg_local_shard_num;
 
@@ -148,6 +196,8 @@ int32_t MemorySparseTable::Load(const std::string &path,
   omp_set_num_threads(thread_num);
 #pragma omp parallel for schedule(dynamic)
   for (int i = 0; i < _real_local_shard_num; ++i) {
+    // values are first touched on the node of the thread serving the shard
+    ScopedNumaBind numa_bind(NumaNodeOfShard(i));
     FsChannelConfig channel_config;
     channel_config.path = file_list[file_start_idx + i];
     VLOG(1) << "MemorySparseTable::load begin load " << channel_config.path
@@ -326,12 +376,17 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   // patch model
   if (save_param == 5) {
     _local_shards_patch_model.reset(_local_shards_new.release());
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);  // NOLINT
+    _local_shards_new.reset(CreateShards(_real_local_shard_num));
     _save_patch_model_thread = std::thread(std::bind(
         &MemorySparseTable::SavePatch, this, std::string(dirname), save_param));
     return 0;
   }
 
+  // delta model
+  if (save_param == 6) {
+    return SaveDelta(dirname);
+  }
+
   // cache model
   int64_t tk_size = LocalSize() * _config.sparse_table_cache_rate();
   TopkCalculator tk(_real_local_shard_num, tk_size);
@@ -441,6 +496,13 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
               << channel_config.path << " feasign_size: " << feasign_size;
   }
   _local_show_threshold = tk.top();
+  if (save_param == 0 && _config.enable_delta_save()) {
+    // a full checkpoint is the new base of the delta chain
+    for (int i = 0; i < _real_local_shard_num; ++i) {
+      _dirty_keys[i].clear();
+      _delta_full_dump[i] = false;
+    }
+  }
   // int32 may overflow need to change return value
   return 0;
 }
@@ -465,12 +527,17 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
   // patch model
   if (save_param == 5) {
     _local_shards_patch_model.reset(_local_shards_new.release());
-    _local_shards_new.reset(new shard_type[_real_local_shard_num]);
+    _local_shards_new.reset(CreateShards(_real_local_shard_num));
     _save_patch_model_thread = std::thread(std::bind(
         &MemorySparseTable::SavePatch, this, std::string(dirname), save_param));
     return 0;
   }
 
+  // delta model
+  if (save_param == 6) {
+    return SaveDelta(dirname);
+  }
+
   // cache model
   int64_t tk_size = LocalSize() * _config.sparse_table_cache_rate();
   TopkCalculator tk(_real_local_shard_num, tk_size);
@@ -649,6 +716,13 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
               << ", feature feasign size:" << feasign_size_for_slot_feature;
   }
   _local_show_threshold = tk.top();
+  if (save_param == 0 && _config.enable_delta_save()) {
+    // a full checkpoint is the new base of the delta chain
+    for (int i = 0; i < _real_local_shard_num; ++i) {
+      _dirty_keys[i].clear();
+      _delta_full_dump[i] = false;
+    }
+  }
   // int32 may overflow need to change return value
   return 0;
 }
@@ -743,6 +817,158 @@ int32_t MemorySparseTable::SavePatch(const std::string &path, int save_param) {
   return 0;
 }
 
+int32_t MemorySparseTable::SaveDelta(const std::string &dirname) {
+  if (!_config.enable_delta_save()) {
+    LOG(WARNING) << "MemorySparseTable delta save needs enable_delta_save, "
+                 << "table_id:" << _config.table_id();
+    return -1;
+  }
+  std::string table_path = TableDir(dirname);
+  _afs_client.remove(::paddle::string::format_string(
+      "%s/part-%03d-*", table_path.c_str(), _shard_idx));
+  std::atomic<uint32_t> feasign_size_all{0};
+  size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+
+  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    FsChannelConfig channel_config;
+    channel_config.path = ::paddle::string::format_string("%s/part-%03d-%05d",
+                                                          table_path.c_str(),
+                                                          _shard_idx,
+                                                          file_start_idx + i);
+    auto &shard = _local_shards[i];
+    auto &dirty_keys = _dirty_keys[i];
+    // a delta only holds the keys touched since the previous save, so it is
+    // buffered and written in one shot unless Shrink touched the whole shard
+    SparseDeltaWriter writer;
+    if (_delta_full_dump[i]) {
+      for (auto it = shard.begin(); it != shard.end(); ++it) {
+        writer.Append(it.key(), it.value().data(), it.value().size());
+      }
+      for (auto key : dirty_keys) {
+        if (shard.find(key) == shard.end()) {
+          writer.AppendErased(key);
+        }
+      }
+    } else {
+      for (auto key : dirty_keys) {
+        auto itr = shard.find(key);
+        if (itr == shard.end()) {
+          writer.AppendErased(key);
+        } else {
+          writer.Append(key, itr.value().data(), itr.value().size());
+        }
+      }
+    }
+
+    bool is_write_failed = false;
+    int retry_num = 0;
+    int err_no = 0;
+    do {
+      err_no = 0;
+      is_write_failed = false;
+      auto write_channel =
+          _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
+      if (0 != write_channel->write(writer.Data(), writer.Size())) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "MemorySparseTable save delta failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
+      write_channel->close();
+      if (err_no == -1) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR)
+            << "MemorySparseTable save delta failed after write, retry it! "
+            << "path:" << channel_config.path << " , retry_num=" << retry_num;
+      }
+      if (is_write_failed) {
+        _afs_client.remove(channel_config.path);
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable save delta failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_write_failed);
+    feasign_size_all += writer.RecordNum();
+    dirty_keys.clear();
+    _delta_full_dump[i] = false;
+    LOG(INFO) << "MemorySparseTable save delta success, path: "
+              << channel_config.path
+              << " feasign_size: " << writer.RecordNum();
+  }
+  LOG(INFO) << "MemorySparseTable save delta success, table_id:"
+            << _config.table_id() << ", feasign size: " << feasign_size_all;
+  return 0;
+}
+
+int32_t MemorySparseTable::LoadDelta(
+    const std::vector<std::string> &file_list) {
+  size_t file_start_idx = _shard_idx * _avg_local_shard_num;
+  if (file_start_idx >= file_list.size()) {
+    return 0;
+  }
+  int thread_num = _real_local_shard_num < 15 ? _real_local_shard_num : 15;
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    FsChannelConfig channel_config;
+    channel_config.path = file_list[file_start_idx + i];
+    auto &shard = _local_shards[i];
+    bool is_read_failed = false;
+    int retry_num = 0;
+    int err_no = 0;
+    std::string content;
+    do {
+      is_read_failed = false;
+      err_no = 0;
+      content.clear();
+      auto read_channel = _afs_client.open_r(channel_config, 0, &err_no);
+      char buffer[1 << 16];
+      int read_size = 0;
+      while ((read_size = read_channel->read(buffer, sizeof(buffer))) > 0) {
+        content.append(buffer, read_size);
+      }
+      read_channel->close();
+      if (err_no == -1) {
+        ++retry_num;
+        is_read_failed = true;
+        LOG(ERROR) << "MemorySparseTable load delta failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable load delta failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_read_failed);
+
+    int64_t record_num = ParseSparseDelta(
+        content.data(),
+        content.size(),
+        [&shard](uint64_t key, const float *value, size_t dim) {
+          if (dim == 0) {
+            shard.erase(key);
+          } else {
+            auto &feature_value = shard[key];
+            feature_value.resize(dim);
+            memcpy(feature_value.data(), value, dim * sizeof(float));
+          }
+        });
+    PADDLE_ENFORCE_GE(record_num,
+                      0,
+                      paddle::platform::errors::InvalidArgument(
+                          "MemorySparseTable delta file %s is corrupted.",
+                          channel_config.path));
+  }
+  LOG(INFO) << "MemorySparseTable load delta success, path from "
+            << file_list[file_start_idx] << " to "
+            << file_list[file_start_idx + _real_local_shard_num - 1];
+  return 0;
+}
+
 int64_t MemorySparseTable::CacheShuffle(
     const std::string &path,
     const std::string &param,
@@ -1023,6 +1249,7 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
                     _value_accessor->Create(&data_buffer_ptr, 1);
                     memcpy(
                         data_ptr, data_buffer_ptr, data_size * sizeof(float));
+                    MarkDirty(shard_id, key);
                   }
                 } else {
                   data_size = itr.value().size();
@@ -1092,6 +1319,7 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
                   float *data_ptr = feature_value.data();
                   _value_accessor->Create(&data_buffer_ptr, 1);
                   memcpy(data_ptr, data_buffer_ptr, data_size * sizeof(float));
+                  MarkDirty(shard_id, key);
                   ret = &feature_value;
                 } else {
                   ret = itr.value_ptr();
@@ -1141,6 +1369,32 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
           auto &local_shard_new = _local_shards_new[shard_id];
           float data_buffer[value_col];  // NOLINT
           float *data_buffer_ptr = data_buffer;
+          // the keys updated in place are updated with one accessor call,
+          // before any insert, which could move the values of the shard
+          std::vector<uint64_t> batch_keys;
+          std::vector<float *> batch_values;
+          std::vector<const float *> batch_updates;
+          auto update_batch = [&]() {
+            if (batch_keys.empty()) {
+              return;
+            }
+            _value_accessor->Update(
+                batch_values.data(), batch_updates.data(), batch_keys.size());
+            for (size_t i = 0; i < batch_keys.size(); ++i) {
+              MarkDirty(shard_id, batch_keys[i]);
+              if (_config.enable_revert()) {
+                FixedFeatureValue *feature_value_new =
+                    &(local_shard_new[batch_keys[i]]);
+                feature_value_new->resize(value_col);
+                memcpy(feature_value_new->data(),
+                       batch_values[i],
+                       value_col * sizeof(float));
+              }
+            }
+            batch_keys.clear();
+            batch_values.clear();
+            batch_updates.clear();
+          };
           for (auto &item : keys) {
             uint64_t key = item.first;
             uint64_t push_data_idx = item.second;
@@ -1152,6 +1406,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                   !_value_accessor->CreateValue(1, update_data)) {
                 continue;
               }
+              update_batch();
               auto value_size = value_col - mf_value_col;
               auto &feature_value = local_shard[key];
               feature_value.resize(value_size);
@@ -1167,19 +1422,22 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
             size_t value_size = feature_value.size();
 
             if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accessor->Update(&value_data, &update_data, 1);
-            } else {
-              // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
-              memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
-              _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
-
-              if (_value_accessor->NeedExtendMF(data_buffer)) {
-                feature_value.resize(value_col);
-                value_data = feature_value.data();
-                _value_accessor->Create(&value_data, 1);
-              }
-              memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
+              batch_keys.push_back(key);
+              batch_values.push_back(value_data);
+              batch_updates.push_back(update_data);
+              continue;
+            }
+            // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
+            memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
+            _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
+
+            if (_value_accessor->NeedExtendMF(data_buffer)) {
+              feature_value.resize(value_col);
+              value_data = feature_value.data();
+              _value_accessor->Create(&value_data, 1);
             }
+            memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
+            MarkDirty(shard_id, key);
             if (_config.enable_revert()) {
               FixedFeatureValue *feature_value_new = &(local_shard_new[key]);
               auto new_size = feature_value.size();
@@ -1189,6 +1447,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                      new_size * sizeof(float));
             }
           }
+          update_batch();
           return 0;
         });
   }
@@ -1221,6 +1480,24 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
           auto &local_shard = _local_shards[shard_id];
           float data_buffer[value_col];  // NOLINT
           float *data_buffer_ptr = data_buffer;
+          // the keys updated in place are updated with one accessor call,
+          // before any insert, which could move the values of the shard
+          std::vector<uint64_t> batch_keys;
+          std::vector<float *> batch_values;
+          std::vector<const float *> batch_updates;
+          auto update_batch = [&]() {
+            if (batch_keys.empty()) {
+              return;
+            }
+            _value_accessor->Update(
+                batch_values.data(), batch_updates.data(), batch_keys.size());
+            for (auto batch_key : batch_keys) {
+              MarkDirty(shard_id, batch_key);
+            }
+            batch_keys.clear();
+            batch_values.clear();
+            batch_updates.clear();
+          };
           for (auto &item : keys) {
             uint64_t key = item.first;
             uint64_t push_data_idx = item.second;
@@ -1231,6 +1508,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                   !_value_accessor->CreateValue(1, update_data)) {
                 continue;
               }
+              update_batch();
               auto value_size = value_col - mf_value_col;
               auto &feature_value = local_shard[key];
               feature_value.resize(value_size);
@@ -1244,19 +1522,23 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
             float *value_data = feature_value.data();
             size_t value_size = feature_value.size();
             if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accessor->Update(&value_data, &update_data, 1);
-            } else {
-              // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
-              memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
-              _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
-              if (_value_accessor->NeedExtendMF(data_buffer)) {
-                feature_value.resize(value_col);
-                value_data = feature_value.data();
-                _value_accessor->Create(&value_data, 1);
-              }
-              memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
+              batch_keys.push_back(key);
+              batch_values.push_back(value_data);
+              batch_updates.push_back(update_data);
+              continue;
+            }
+            // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
+            memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
+            _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
+            if (_value_accessor->NeedExtendMF(data_buffer)) {
+              feature_value.resize(value_col);
+              value_data = feature_value.data();
+              _value_accessor->Create(&value_data, 1);
             }
+            memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
+            MarkDirty(shard_id, key);
           }
+          update_batch();
           return 0;
         });
   }
@@ -1281,6 +1563,7 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
     auto &shard = _local_shards[shard_id];
     for (auto it = shard.begin(); it != shard.end();) {
       if (_value_accessor->Shrink(it.value().data())) {
+        MarkDirty(shard_id, it.key());
         it = shard.erase(it);
         ++feasign_size;
       } else {
@@ -1288,6 +1571,10 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
       }
     }
     shrink_size_all += feasign_size;
+    if (_config.enable_delta_save()) {
+      // show and click of every remaining key are decayed by Shrink
+      _delta_full_dump[shard_id] = true;
+    }
   }
   VLOG(0) << "MemorySparseTable::Shrink success, shrink size:"
           << shrink_size_all;
@@ -22,6 +22,7 @@
 #include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -115,6 +116,20 @@ class MemorySparseTable : public Table {
   virtual void CheckSavePrePatchDone();
 
  protected:
+  // Binary delta checkpoint (save/load param 6): the keys of every shard
+  // created, pushed or erased since the previous save 0 or 6, see
+  // sparse_delta.h.
+  virtual int32_t SaveDelta(const std::string& path);
+  virtual int32_t LoadDelta(const std::vector<std::string>& file_list);
+  void MarkDirty(int shard_id, uint64_t key) {
+    if (_config.enable_delta_save()) {
+      _dirty_keys[shard_id].insert(key);
+    }
+  }
+  // numa node of the task thread of shard_id, -1 when not bound
+  int NumaNodeOfShard(int shard_id) const;
+  // allocate shards whose key index follows _config.shard_map_type()
+  shard_type* CreateShards(int shard_num);
   virtual int32_t SavePatch(const std::string& path, int save_param);
   virtual int32_t LoadPatch(const std::vector<std::string>& file_list,
                             int save_param);
@@ -126,6 +141,11 @@ class MemorySparseTable : public Table {
   std::vector<std::shared_ptr<::ThreadPool>> _shards_task_pool;
   std::unique_ptr<shard_type[]> _local_shards;
 
+  // for delta save, only touched by the task pool thread of the shard
+  std::vector<std::unordered_set<uint64_t>> _dirty_keys;
+  // the whole shard goes to the next delta, e.g. after Shrink decayed it
+  std::unique_ptr<bool[]> _delta_full_dump;
+
   // for patch model
   int _m_avg_local_shard_num;
   int _m_real_local_shard_num;
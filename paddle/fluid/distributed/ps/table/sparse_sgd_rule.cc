@@ -14,6 +14,10 @@
 
 #include "paddle/fluid/distributed/ps/table/sparse_sgd_rule.h"
 
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
 #include "glog/logging.h"
 
 #include "paddle/common/flags.h"
@@ -23,6 +27,40 @@ PD_DEFINE_bool(enable_show_scale_gradient, true, "enable show scale gradient");
 namespace paddle {
 namespace distributed {
 
+#ifdef __AVX__
+namespace {
+
+// The vectorized loops below compute in the same types and order as the
+// scalar ones, so they give the same values.
+
+// BoundValue of 4 floats, which maps NaN to the min bound too.
+inline __m128 BoundValue4(__m128 w, float min_bound, float max_bound) {
+  __m128 lo = _mm_set1_ps(min_bound);
+  __m128 hi = _mm_set1_ps(max_bound);
+  w = _mm_blendv_ps(w, lo, _mm_cmp_ps(w, lo, _CMP_NGE_UQ));
+  return _mm_blendv_ps(w, hi, _mm_cmp_ps(w, hi, _CMP_NLE_UQ));
+}
+
+// BoundValue of 8 floats.
+inline __m256 BoundValue8(__m256 w, float min_bound, float max_bound) {
+  __m256 lo = _mm256_set1_ps(min_bound);
+  __m256 hi = _mm256_set1_ps(max_bound);
+  w = _mm256_blendv_ps(w, lo, _mm256_cmp_ps(w, lo, _CMP_NGE_UQ));
+  return _mm256_blendv_ps(w, hi, _mm256_cmp_ps(w, hi, _CMP_NLE_UQ));
+}
+
+// Add the 4 lanes to sum one by one, as the scalar loop does.
+inline void AccumulateInOrder(__m256d v, double* sum) {
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, v);
+  for (double lane : lanes) {
+    *sum += lane;
+  }
+}
+
+}  // namespace
+#endif
+
 void SparseNaiveSGDRule::LoadConfig(const SparseCommonSGDRuleParameter &param,
                                     size_t emb_dim) {
   _embedding_dim = emb_dim;
@@ -94,11 +132,27 @@ void SparseAdaGradSGDRule::UpdateValueWork(float *w,
                                            float scale) {
   float &g2sum = sgd[G2SumIndex()];
   double add_g2sum = 0;
-
-  for (size_t i = 0; i < _embedding_dim; i++) {
+  // the same for all the dims
+  auto ratio = sqrt(_initial_g2sum / (_initial_g2sum + g2sum));
+
+  size_t i = 0;
+#ifdef __AVX__
+  const __m256d lr_v = _mm256_set1_pd(learning_rate_);
+  const __m256d ratio_v = _mm256_set1_pd(ratio);
+  const __m128 scale_v = _mm_set1_ps(scale);
+  for (; i + 4 <= _embedding_dim; i += 4) {
+    __m256d scaled_grad =
+        _mm256_cvtps_pd(_mm_div_ps(_mm_loadu_ps(grad + i), scale_v));
+    __m256d delta = _mm256_mul_pd(_mm256_mul_pd(lr_v, scaled_grad), ratio_v);
+    __m256d new_w = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(w + i)), delta);
+    _mm_storeu_ps(w + i,
+                  BoundValue4(_mm256_cvtpd_ps(new_w), _min_bound, _max_bound));
+    AccumulateInOrder(_mm256_mul_pd(scaled_grad, scaled_grad), &add_g2sum);
+  }
+#endif
+  for (; i < _embedding_dim; i++) {
     double scaled_grad = grad[i] / scale;
-    w[i] -= learning_rate_ * scaled_grad *
-            sqrt(_initial_g2sum / (_initial_g2sum + g2sum));
+    w[i] -= learning_rate_ * scaled_grad * ratio;
     BoundValue(w[i]);
     add_g2sum += scaled_grad * scaled_grad;
   }
@@ -106,6 +160,17 @@ void SparseAdaGradSGDRule::UpdateValueWork(float *w,
   g2sum += add_g2sum / _embedding_dim;
 }
 
+void SparseAdaGradSGDRule::UpdateValueBatchWork(float **w,
+                                                float **sgd,
+                                                const float **push_value,
+                                                const float *scale,
+                                                size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    SparseAdaGradSGDRule::UpdateValueWork(
+        w[k], sgd[k], push_value[k], scale[k]);
+  }
+}
+
 void SparseAdaGradSGDRule::InitValueWork(float *value,
                                          float *sgd,
                                          bool zero_init) {
@@ -214,7 +279,32 @@ void SparseAdamSGDRule::UpdateValueWork(float *w,
   float beta2_pow_ = *beta2_pow;
 
   lr *= sqrt(1 - beta2_pow_) / (1 - beta1_pow_);
-  for (size_t i = 0; i < _embedding_dim; i++) {
+  size_t i = 0;
+#ifdef __AVX__
+  const __m256 beta1 = _mm256_set1_ps(_beta1_decay_rate);
+  const __m256 one_minus_beta1 = _mm256_set1_ps(1 - _beta1_decay_rate);
+  const __m256 beta2 = _mm256_set1_ps(_beta2_decay_rate);
+  const __m256 one_minus_beta2 = _mm256_set1_ps(1 - _beta2_decay_rate);
+  const __m256 lr_v = _mm256_set1_ps(lr);
+  const __m256 epsilon = _mm256_set1_ps(_ada_epsilon);
+  for (; i + 8 <= _embedding_dim; i += 8) {
+    __m256 g_v = _mm256_loadu_ps(g + i);
+    __m256 gsum_v =
+        _mm256_add_ps(_mm256_mul_ps(beta1, _mm256_loadu_ps(gsum + i)),
+                      _mm256_mul_ps(one_minus_beta1, g_v));
+    __m256 g2sum_v = _mm256_add_ps(
+        _mm256_mul_ps(beta2, _mm256_loadu_ps(g2sum + i)),
+        _mm256_mul_ps(_mm256_mul_ps(one_minus_beta2, g_v), g_v));
+    __m256 delta = _mm256_mul_ps(
+        lr_v,
+        _mm256_div_ps(gsum_v, _mm256_add_ps(_mm256_sqrt_ps(g2sum_v), epsilon)));
+    __m256 w_v = _mm256_sub_ps(_mm256_loadu_ps(w + i), delta);
+    _mm256_storeu_ps(gsum + i, gsum_v);
+    _mm256_storeu_ps(g2sum + i, g2sum_v);
+    _mm256_storeu_ps(w + i, BoundValue8(w_v, _min_bound, _max_bound));
+  }
+#endif
+  for (; i < _embedding_dim; i++) {
     // Calculation
     gsum[i] = _beta1_decay_rate * gsum[i] + (1 - _beta1_decay_rate) * g[i];
     g2sum[i] =
@@ -227,6 +317,16 @@ void SparseAdamSGDRule::UpdateValueWork(float *w,
   (*beta2_pow) *= _beta2_decay_rate;
 }
 
+void SparseAdamSGDRule::UpdateValueBatchWork(float **w,
+                                             float **sgd,
+                                             const float **push_value,
+                                             const float *scale,
+                                             size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    SparseAdamSGDRule::UpdateValueWork(w[k], sgd[k], push_value[k], scale[k]);
+  }
+}
+
 void SparseAdamSGDRule::InitValueWork(float *value,
                                       float *sgd,
                                       bool zero_init) {
@@ -292,7 +392,32 @@ void SparseSharedAdamSGDRule::UpdateValueWork(float *w,
   lr *= sqrt(1 - beta2_pow_) / (1 - beta1_pow_);
   double sum_gsum = 0.0;
   double sum_g2sum = 0.0;
-  for (size_t i = 0; i < _embedding_dim; i++) {
+  size_t i = 0;
+#ifdef __AVX__
+  const __m128 beta1_gsum = _mm_set1_ps(_beta1_decay_rate * gsum_);
+  const __m128 one_minus_beta1 = _mm_set1_ps(1 - _beta1_decay_rate);
+  const __m128 beta2_g2sum = _mm_set1_ps(_beta2_decay_rate * g2sum_);
+  const __m128 one_minus_beta2 = _mm_set1_ps(1 - _beta2_decay_rate);
+  const __m256d lr_v = _mm256_set1_pd(lr);
+  const __m256d epsilon = _mm256_set1_pd(_ada_epsilon);
+  for (; i + 4 <= _embedding_dim; i += 4) {
+    __m128 g_v = _mm_loadu_ps(g + i);
+    __m256d new_gsum = _mm256_cvtps_pd(
+        _mm_add_ps(beta1_gsum, _mm_mul_ps(one_minus_beta1, g_v)));
+    __m256d new_g2sum = _mm256_cvtps_pd(_mm_add_ps(
+        beta2_g2sum, _mm_mul_ps(_mm_mul_ps(one_minus_beta2, g_v), g_v)));
+    __m256d delta = _mm256_mul_pd(
+        lr_v,
+        _mm256_div_pd(new_gsum,
+                      _mm256_add_pd(_mm256_sqrt_pd(new_g2sum), epsilon)));
+    __m256d new_w = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(w + i)), delta);
+    _mm_storeu_ps(w + i,
+                  BoundValue4(_mm256_cvtpd_ps(new_w), _min_bound, _max_bound));
+    AccumulateInOrder(new_gsum, &sum_gsum);
+    AccumulateInOrder(new_g2sum, &sum_g2sum);
+  }
+#endif
+  for (; i < _embedding_dim; i++) {
     // Calculation
     double new_gsum =
         _beta1_decay_rate * gsum_ + (1 - _beta1_decay_rate) * g[i];
@@ -310,6 +435,17 @@ void SparseSharedAdamSGDRule::UpdateValueWork(float *w,
   (*beta2_pow) *= _beta2_decay_rate;
 }
 
+void SparseSharedAdamSGDRule::UpdateValueBatchWork(float **w,
+                                                   float **sgd,
+                                                   const float **push_value,
+                                                   const float *scale,
+                                                   size_t num) {
+  for (size_t k = 0; k < num; ++k) {
+    SparseSharedAdamSGDRule::UpdateValueWork(
+        w[k], sgd[k], push_value[k], scale[k]);
+  }
+}
+
 void SparseSharedAdamSGDRule::InitValueWork(float *value,
                                             float *sgd,
                                             bool zero_init) {
@@ -51,6 +51,25 @@ class SparseValueSGDRule {
                    float scale = 1) {
     UpdateValueWork(w, sgd, push_value, scale);
   }
+  // Update the values of num keys with one call, the i-th key with w[i],
+  // sgd[i], push_value[i] and scale[i]. The rules with vectorized updates
+  // override it to run them back to back without the virtual calls.
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_value,
+                                    const float* scale,
+                                    size_t num) {
+    for (size_t i = 0; i < num; ++i) {
+      UpdateValueWork(w[i], sgd[i], push_value[i], scale[i]);
+    }
+  }
+  void UpdateValueBatch(float** w,
+                        float** sgd,
+                        const float** push_value,
+                        const float* scale,
+                        size_t num) {
+    UpdateValueBatchWork(w, sgd, push_value, scale, num);
+  }
   template <class T>
   void BoundValue(T& w) {  // NOLINT
     if (!(w >= _min_bound)) {
@@ -97,6 +116,11 @@ class SparseAdaGradSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_value,
+                                    const float* scale,
+                                    size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return 1; }
   size_t G2SumIndex() { return 0; }
@@ -151,6 +175,11 @@ class SparseAdamSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_value,
+                                    const float* scale,
+                                    size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return _embedding_dim * 2 + 2; }
   size_t GSumIndex() { return 0; }
@@ -173,6 +202,11 @@ class SparseSharedAdamSGDRule : public SparseValueSGDRule {
                                float* sgd,
                                const float* push_value,
                                float scale);
+  virtual void UpdateValueBatchWork(float** w,
+                                    float** sgd,
+                                    const float** push_value,
+                                    const float* scale,
+                                    size_t num);
   virtual void InitValueWork(float* value, float* sgd, bool zero_init);
   virtual size_t Dim() { return 4; }
   size_t GSumIndex() { return 0; }
@@ -28,14 +28,34 @@ PD_DEFINE_int32(pserver_load_batch_size, 5000, "load batch size for ssd");
 PADDLE_DEFINE_EXPORTED_string(rocksdb_path,
                               "database",
                               "path of sparse table rocksdb file");
+PD_DEFINE_int64(pserver_ssd_mem_max_keys_per_shard,
+                0,
+                "max keys kept in one memory shard of ssd table, keys over it "
+                "are migrated to rocksdb in background, 0 means unbounded");
+PD_DEFINE_double(pserver_ssd_mem_evict_ratio,
+                 0.1,
+                 "ratio of pserver_ssd_mem_max_keys_per_shard released by "
+                 "one background eviction of a memory shard");
+PD_DEFINE_int32(pserver_ssd_access_window_size,
+                1000000,
+                "distinct keys of one shard access window, keys touched in "
+                "the latest two windows are evicted last");
 
 namespace paddle {
 namespace distributed {
 
 int32_t SSDSparseTable::Initialize() {
+  // the rocksdb dump path sorts the raw mct bucket iterators of each shard
+  if (_config.shard_map_type() != CLOSED_HASH_MAP) {
+    LOG(WARNING) << "SSDSparseTable only supports CLOSED_HASH_MAP shards, "
+                 << "ignore shard_map_type of table " << _config.table_id();
+    _config.set_shard_map_type(CLOSED_HASH_MAP);
+  }
   MemorySparseTable::Initialize();
   _db = ::paddle::distributed::RocksDBHandler::GetInstance();
   _db->initialize(FLAGS_rocksdb_path, _real_local_shard_num);
+  _access_windows.resize(_real_local_shard_num);
+  _evict_scheduled.reset(new bool[_real_local_shard_num]());
   VLOG(0) << "initialize SSDSparseTable succ";
   VLOG(0) << "SSD FLAGS_pserver_print_missed_key_num_every_push:"
           << FLAGS_pserver_print_missed_key_num_every_push;
@@ -99,69 +119,30 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
                shard_id,
                &task_keys,
                value_size,
-               mf_value_size,
                select_value_size,
                pull_values,
                &missed_keys]() -> int {
                 auto& keys = task_keys[shard_id];
                 auto& local_shard = _local_shards[shard_id];
-                float data_buffer[value_size];  // NOLINT
-                float* data_buffer_ptr = data_buffer;
+                std::vector<std::pair<uint64_t, int>> ssd_keys;
                 for (size_t i = 0; i < keys.size(); ++i) {
-                  uint64_t key = keys[i].first;
-                  auto itr = local_shard.find(key);
-                  size_t data_size = value_size - mf_value_size;
+                  auto itr = local_shard.find(keys[i].first);
                   if (itr == local_shard.end()) {
-                    // pull rocksdb
-                    std::string tmp_string("");
-                    if (_db->get(shard_id,
-                                 reinterpret_cast<char*>(&key),
-                                 sizeof(uint64_t),
-                                 tmp_string) > 0) {
-                      ++missed_keys;
-                      if (FLAGS_pserver_create_value_when_push) {
-                        memset(data_buffer, 0, sizeof(float) * data_size);
-                      } else {
-                        auto& feature_value = local_shard[key];
-                        feature_value.resize(data_size);
-                        float* data_ptr =
-                            const_cast<float*>(feature_value.data());
-                        _value_accessor->Create(&data_buffer_ptr, 1);
-                        memcpy(data_ptr,
-                               data_buffer_ptr,
-                               data_size * sizeof(float));
-                      }
-                    } else {
-                      data_size = tmp_string.size() / sizeof(float);
-                      memcpy(data_buffer_ptr,
-                             ::paddle::string::str_to_float(tmp_string),
-                             data_size * sizeof(float));
-                      // from rocksdb to mem
-                      auto& feature_value = local_shard[key];
-                      feature_value.resize(data_size);
-                      memcpy(const_cast<float*>(feature_value.data()),
-                             data_buffer_ptr,
-                             data_size * sizeof(float));
-                      _db->del_data(shard_id,
-                                    reinterpret_cast<char*>(&key),
-                                    sizeof(uint64_t));
-                    }
-                  } else {
-                    data_size = itr.value().size();
-                    memcpy(data_buffer_ptr,
-                           itr.value().data(),
-                           data_size * sizeof(float));
+                    ssd_keys.push_back(keys[i]);
+                    continue;
                   }
-                  for (size_t mf_idx = data_size; mf_idx < value_size;
-                       ++mf_idx) {
-                    data_buffer[mf_idx] = 0.0;
-                  }
-                  int pull_data_idx = keys[i].second;
-                  float* select_data =
-                      pull_values + pull_data_idx * select_value_size;
-                  _value_accessor->Select(
-                      &select_data, (const float**)&data_buffer_ptr, 1);
+                  SelectValue(itr.value(),
+                              value_size,
+                              pull_values + keys[i].second * select_value_size);
+                }
+                if (!ssd_keys.empty()) {
+                  missed_keys += PullSparseFromSSD(shard_id,
+                                                   &ssd_keys,
+                                                   value_size,
+                                                   select_value_size,
+                                                   pull_values);
                 }
+                TouchAndMaybeEvict(shard_id, keys);
                 return 0;
               });
     }
@@ -176,12 +157,130 @@ int32_t SSDSparseTable::PullSparse(float* pull_values,
   return 0;
 }
 
+void SSDSparseTable::SelectValue(FixedFeatureValue& feature_value,  // NOLINT
+                                 size_t value_size,
+                                 float* select_data) {
+  const float* value_data = feature_value.data();
+  size_t data_size = feature_value.size();
+  float data_buffer[value_size];  // NOLINT
+  if (data_size < value_size) {
+    // mf part not created yet, select from a zero padded copy
+    memcpy(data_buffer, value_data, data_size * sizeof(float));
+    memset(data_buffer + data_size,
+           0,
+           (value_size - data_size) * sizeof(float));
+    value_data = data_buffer;
+  }
+  _value_accessor->Select(&select_data, &value_data, 1);
+}
+
+uint32_t SSDSparseTable::PullSparseFromSSD(
+    int shard_id,
+    std::vector<std::pair<uint64_t, int>>* keys,
+    size_t value_size,
+    size_t select_value_size,
+    float* pull_values) {
+  const size_t kBatchSize = 1024;
+  size_t mf_value_size =
+      _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
+  size_t init_size = value_size - mf_value_size;
+  auto& local_shard = _local_shards[shard_id];
+  uint32_t missed_keys = 0;
+  // the rocksdb comparator orders keys as uint64, let MultiGet skip sorting
+  std::sort(keys->begin(), keys->end());
+  // a key pulled at several positions is read or created once, then selected
+  // to all of them, the keys read are deleted from rocksdb
+  std::vector<size_t> key_offsets;
+  for (size_t i = 0; i < keys->size(); ++i) {
+    if (i == 0 || (*keys)[i].first != (*keys)[i - 1].first) {
+      key_offsets.push_back(i);
+    }
+  }
+  size_t unique_num = key_offsets.size();
+  key_offsets.push_back(keys->size());
+
+  std::vector<rocksdb::Slice> batch_keys;
+  std::vector<rocksdb::Slice> found_keys;
+  std::vector<rocksdb::PinnableSlice> batch_values(
+      std::min(kBatchSize, unique_num));
+  std::vector<rocksdb::Status> status(batch_values.size());
+  float data_buffer[value_size];  // NOLINT
+  float* data_buffer_ptr = data_buffer;
+  for (size_t begin = 0; begin < unique_num; begin += kBatchSize) {
+    size_t end = std::min(begin + kBatchSize, unique_num);
+    batch_keys.clear();
+    found_keys.clear();
+    for (size_t i = begin; i < end; ++i) {
+      batch_keys.emplace_back(
+          reinterpret_cast<const char*>(&(*keys)[key_offsets[i]].first),
+          sizeof(uint64_t));
+    }
+    _db->multi_get(shard_id,
+                   batch_keys.size(),
+                   batch_keys.data(),
+                   batch_values.data(),
+                   status.data());
+    for (size_t i = begin; i < end; ++i) {
+      uint64_t key = (*keys)[key_offsets[i]].first;
+      size_t idx = i - begin;
+      FixedFeatureValue* feature_value = nullptr;
+      if (status[idx].IsNotFound()) {
+        ++missed_keys;
+        if (FLAGS_pserver_create_value_when_push) {
+          memset(data_buffer, 0, sizeof(float) * value_size);
+        } else {
+          feature_value = &local_shard[key];
+          feature_value->resize(init_size);
+          _value_accessor->Create(&data_buffer_ptr, 1);
+          memcpy(const_cast<float*>(feature_value->data()),
+                 data_buffer_ptr,
+                 init_size * sizeof(float));
+        }
+      } else {
+        // an IO error or a corruption is not a miss, which would reset the
+        // value of the key
+        PADDLE_ENFORCE_EQ(
+            status[idx].ok(),
+            true,
+            phi::errors::Unavailable("Failed to read key %d from rocksdb of "
+                                     "shard %d: %s",
+                                     key,
+                                     shard_id,
+                                     status[idx].ToString()));
+        // from rocksdb to mem, decoded straight from the pinned block
+        auto& slice = batch_values[idx];
+        size_t data_size = slice.size() / sizeof(float);
+        feature_value = &local_shard[key];
+        feature_value->resize(data_size);
+        memcpy(const_cast<float*>(feature_value->data()),
+               slice.data(),
+               data_size * sizeof(float));
+        found_keys.push_back(batch_keys[idx]);
+      }
+      for (size_t k = key_offsets[i]; k < key_offsets[i + 1]; ++k) {
+        float* select_data =
+            pull_values + (*keys)[k].second * select_value_size;
+        if (feature_value == nullptr) {
+          _value_accessor->Select(
+              &select_data, (const float**)&data_buffer_ptr, 1);
+        } else {
+          SelectValue(*feature_value, value_size, select_data);
+        }
+      }
+      batch_values[idx].Reset();
+    }
+    _db->del_batch(shard_id, found_keys.data(), found_keys.size());
+  }
+  return missed_keys;
+}
+
 int32_t SSDSparseTable::PullSparsePtr(int shard_id,
                                       char** pull_values,
                                       const uint64_t* pull_keys,
                                       size_t num,
                                       uint16_t pass_id) {
   CostTimer timer("pserver_ssd_sparse_select_all");
+  _ptr_pulled.store(true, std::memory_order_relaxed);
   size_t value_size = _value_accessor->GetAccessorInfo().size / sizeof(float);
   size_t mf_value_size =
       _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
@@ -392,6 +491,7 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                            value_size * sizeof(float));
                   }
                 }
+                TouchAndMaybeEvict(shard_id, keys);
                 return 0;
               });
     }
@@ -492,6 +592,7 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
                            value_size * sizeof(float));
                   }
                 }
+                TouchAndMaybeEvict(shard_id, keys);
                 return 0;
               });
     }
@@ -503,6 +604,7 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
 }
 
 int32_t SSDSparseTable::Shrink(const std::string& param) {
+  WaitEviction();
   int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
   omp_set_num_threads(thread_num);
 #pragma omp parallel for schedule(dynamic)
@@ -543,6 +645,7 @@ int32_t SSDSparseTable::Shrink(const std::string& param) {
 }
 
 int32_t SSDSparseTable::UpdateTable() {
+  WaitEviction();
   int count = 0;
   for (int i = 0; i < _real_local_shard_num; ++i) {
     auto& shard = _local_shards[i];
@@ -566,6 +669,105 @@ int32_t SSDSparseTable::UpdateTable() {
   return 0;
 }
 
+bool SSDSparseTable::EvictionEnabled() const {
+  return FLAGS_pserver_ssd_mem_max_keys_per_shard > 0 &&
+         !_ptr_pulled.load(std::memory_order_relaxed);
+}
+
+void SSDSparseTable::TouchAndMaybeEvict(
+    int shard_id, const std::vector<std::pair<uint64_t, int>>& keys) {
+  if (!EvictionEnabled()) {
+    return;
+  }
+  auto& window = _access_windows[shard_id];
+  for (auto& key : keys) {
+    window.Touch(key.first, FLAGS_pserver_ssd_access_window_size);
+  }
+  if (_evict_scheduled[shard_id] ||
+      static_cast<int64_t>(_local_shards[shard_id].size()) <=
+          FLAGS_pserver_ssd_mem_max_keys_per_shard) {
+    return;
+  }
+  // queued behind the running pull/push tasks of the same shard, so the
+  // eviction never runs concurrently with other accesses to this shard
+  _evict_scheduled[shard_id] = true;
+  _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
+      [this, shard_id]() -> int {
+        int32_t ret = EvictShard(shard_id);
+        _evict_scheduled[shard_id] = false;
+        return ret;
+      });
+}
+
+int32_t SSDSparseTable::EvictShard(int shard_id) {
+  auto& shard = _local_shards[shard_id];
+  int64_t max_keys = FLAGS_pserver_ssd_mem_max_keys_per_shard;
+  double evict_ratio =
+      std::min(std::max(FLAGS_pserver_ssd_mem_evict_ratio, 0.0), 1.0);
+  int64_t target = static_cast<int64_t>(max_keys * (1.0 - evict_ratio));
+  int64_t evict_num = static_cast<int64_t>(shard.size()) - target;
+  if (evict_num <= 0) {
+    return 0;
+  }
+  uint64_t begin = butil::gettimeofday_ms();
+  // (recently touched, show/click score) orders the candidates, so cold keys
+  // go first and the hot set is only touched when it alone exceeds the bound
+  struct EvictCandidate {
+    bool recent;
+    float score;
+    uint64_t key;
+  };
+  auto& window = _access_windows[shard_id];
+  std::vector<EvictCandidate> candidates;
+  candidates.reserve(shard.size());
+  for (auto it = shard.begin(); it != shard.end(); ++it) {
+    candidates.push_back(
+        {window.IsRecent(it.key()),
+         _value_accessor->GetField(it.value().data(), "show_click_score"),
+         it.key()});
+  }
+  auto colder = [](const EvictCandidate& a, const EvictCandidate& b) {
+    if (a.recent != b.recent) {
+      return !a.recent;
+    }
+    return a.score < b.score;
+  };
+  if (evict_num < static_cast<int64_t>(candidates.size())) {
+    std::nth_element(candidates.begin(),
+                     candidates.begin() + evict_num,
+                     candidates.end(),
+                     colder);
+  }
+  for (int64_t i = 0; i < evict_num; ++i) {
+    uint64_t key = candidates[i].key;
+    auto itr = shard.find(key);
+    _db->put(shard_id,
+             reinterpret_cast<const char*>(&key),
+             sizeof(uint64_t),
+             reinterpret_cast<const char*>(itr.value().data()),
+             itr.value().size() * sizeof(float));
+    shard.quick_erase(itr);
+  }
+  _evicted_count.fetch_add(evict_num, std::memory_order_relaxed);
+  VLOG(1) << "SSDSparseTable evict shard:" << shard_id << " keys:" << evict_num
+          << " mem_size:" << shard.size() << " cost:"
+          << butil::gettimeofday_ms() - begin << " ms";
+  return 0;
+}
+
+void SSDSparseTable::WaitEviction() {
+  if (_evict_scheduled == nullptr) {
+    return;
+  }
+  std::vector<std::future<int>> tasks;
+  for (auto& pool : _shards_task_pool) {
+    tasks.push_back(pool->enqueue([]() -> int { return 0; }));
+  }
+  for (auto& task : tasks) {
+    task.wait();
+  }
+}
+
 int64_t SSDSparseTable::LocalSize() {
   int64_t local_size = 0;
   for (int i = 0; i < _real_local_shard_num; ++i) {
@@ -577,6 +779,7 @@ int64_t SSDSparseTable::LocalSize() {
 int32_t SSDSparseTable::Save(const std::string& path,
                              const std::string& param) {
   std::lock_guard<std::mutex> guard(_table_mutex);
+  WaitEviction();
 #ifdef PADDLE_WITH_HETERPS
   int save_param = atoi(param.c_str());
   int32_t ret = 0;
@@ -2918,11 +3121,16 @@ int32_t SSDSparseTable::LoadWithBinary(const std::string& path, int param) {
 }
 
 std::pair<int64_t, int64_t> SSDSparseTable::PrintTableStat() {
+  if (FLAGS_pserver_ssd_mem_max_keys_per_shard > 0) {
+    LOG(INFO) << "SSDSparseTable background evicted keys: "
+              << _evicted_count.load(std::memory_order_relaxed);
+  }
   int64_t feasign_size = LocalSize();
   return {feasign_size, -1};
 }
 
 int32_t SSDSparseTable::CacheTable(uint16_t pass_id) {
+  WaitEviction();
   std::lock_guard<std::mutex> guard(_table_mutex);
   VLOG(0) << "cache_table";
   std::atomic<uint32_t> count{0};
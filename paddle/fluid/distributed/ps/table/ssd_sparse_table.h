@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <unordered_set>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/table/depends/rocksdb_warpper.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
@@ -56,6 +60,30 @@ class MemRegion {
   char* _buf;
 };
 
+// Keys pulled or pushed in the two latest access windows of one shard. When
+// the memory shard grows over its bound, keys outside of both windows are
+// migrated to rocksdb first, the lowest show/click score going first.
+class ShardAccessWindow {
+ public:
+  void Touch(uint64_t key, size_t window_size) {
+    if (_current.insert(key).second && _current.size() >= window_size) {
+      _previous.swap(_current);
+      _current.clear();
+    }
+  }
+  bool IsRecent(uint64_t key) const {
+    return _current.count(key) != 0 || _previous.count(key) != 0;
+  }
+  void Clear() {
+    _current.clear();
+    _previous.clear();
+  }
+
+ private:
+  std::unordered_set<uint64_t> _current;
+  std::unordered_set<uint64_t> _previous;
+};
+
 class SSDSparseTable : public MemorySparseTable {
  public:
   typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
@@ -128,12 +156,42 @@ class SSDSparseTable : public MemorySparseTable {
 
   int32_t CacheTable(uint16_t pass_id) override;
 
+ protected:
+  // Touch the shard access window and schedule an eviction of the shard when
+  // it holds more than FLAGS_pserver_ssd_mem_max_keys_per_shard keys. Must be
+  // called from the task pool thread of the shard.
+  void TouchAndMaybeEvict(int shard_id,
+                          const std::vector<std::pair<uint64_t, int>>& keys);
+  // Pull the keys missing in the memory shard from rocksdb with batched
+  // MultiGet, found values are moved into the memory shard. Returns the
+  // number of keys found in neither of them.
+  uint32_t PullSparseFromSSD(int shard_id,
+                             std::vector<std::pair<uint64_t, int>>* keys,
+                             size_t value_size,
+                             size_t select_value_size,
+                             float* pull_values);
+  void SelectValue(FixedFeatureValue& feature_value,  // NOLINT
+                   size_t value_size,
+                   float* select_data);
+  // move the coldest keys of the shard to rocksdb, runs on the shard pool
+  int32_t EvictShard(int shard_id);
+  // wait for the evictions queued on every shard pool
+  void WaitEviction();
+  bool EvictionEnabled() const;
+
  private:
   RocksDBHandler* _db;
   int64_t _cache_tk_size;
   double _local_show_threshold{0.0};
   std::vector<paddle::framework::Channel<std::string>> _fs_channel;
   std::mutex _table_mutex;
+  // keyed by local shard, only accessed from the shard task pool thread
+  std::vector<ShardAccessWindow> _access_windows;
+  std::unique_ptr<bool[]> _evict_scheduled;
+  std::atomic<int64_t> _evicted_count{0};
+  // values handed out by PullSparsePtr must stay at their address, so the
+  // continuous eviction is turned off once the pointer pull path is used
+  std::atomic<bool> _ptr_pulled{false};
 };
 
 }  // namespace distributed
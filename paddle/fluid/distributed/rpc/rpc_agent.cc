@@ -14,13 +14,21 @@
 
 #include "paddle/fluid/distributed/rpc/rpc_agent.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/platform/enforce.h"
 
+COMMON_DECLARE_int32(rpc_max_batch_size);
+COMMON_DECLARE_int64(rpc_max_batch_bytes);
+COMMON_DECLARE_int32(rpc_max_batch_delay_us);
+COMMON_DECLARE_int32(rpc_handler_threads);
+
 namespace paddle {
 namespace distributed {
 
@@ -39,7 +47,7 @@ RpcAgent::RpcAgent(std::string name, std::vector<WorkerInfo> infos) {
   this->infos_ = std::move(infos);
   auto it = name_to_infos_.find(name_);
   this->rank_ = it->second.id_;
-  rpc_service_ = std::make_shared<RpcService>();
+  rpc_service_ = std::make_shared<RpcService>(FLAGS_rpc_handler_threads);
   PADDLE_ENFORCE_EQ(
       server_.AddService(rpc_service_.get(), brpc::SERVER_DOESNT_OWN_SERVICE),
       0,
@@ -80,14 +88,23 @@ int RpcAgent::StartClient() {
             info.ip_,
             info.port_));
   }
+  batches_.resize(channels_.size());
+  flush_thread_ = std::thread([this] { FlushLoop(); });
   VLOG(0) << "Init Channels: " << name_;
   return 0;
 }
 
+RpcAgent::~RpcAgent() {
+  StopFlush();
+  rpc_service_->Stop();
+}
+
 int RpcAgent::Stop() {
   VLOG(0) << "Worker: " << name_ << " is going to stop.";
+  StopFlush();
   server_.Stop(kCloseWaitMs);
   server_.Join();
+  rpc_service_->Stop();
   rpc_agent_instance_ = nullptr;
   VLOG(0) << "Worker: " << name_ << " has stopped";
   return 0;
@@ -95,8 +112,14 @@ int RpcAgent::Stop() {
 void OnRpcDone::Run() {
   // delete this after Run
   std::unique_ptr<OnRpcDone> self_guard(this);
-  PADDLE_ENFORCE_EQ(
-      cntl_.Failed(), false, platform::errors::Fatal(cntl_.ErrorText()));
+  if (cntl_.Failed()) {
+    // rethrown by the future in the caller, not in the brpc worker
+    promise_->set_exception(std::make_exception_ptr(platform::EnforceNotMet(
+        platform::errors::Fatal("%s", cntl_.ErrorText()),
+        __FILE__,
+        __LINE__)));
+    return;
+  }
   promise_->set_value(response_.message());
   VLOG(2) << "Received response from " << cntl_.remote_side() << " to "
           << cntl_.local_side() << " (attached=" << cntl_.response_attachment()
@@ -104,6 +127,52 @@ void OnRpcDone::Run() {
           << " latency=" << cntl_.latency_us() << "us";
 }
 
+std::future<std::string> OnBatchRpcDone::Add(const std::string &payload,
+                                             int timeout_ms) {
+  request_.add_sizes(payload.size());
+  cntl_.request_attachment().append(payload);
+  // the batch waits for its slowest request
+  cntl_.set_timeout_ms(std::max<int64_t>(cntl_.timeout_ms(), timeout_ms));
+  promises_.emplace_back();
+  return promises_.back().get_future();
+}
+
+void OnBatchRpcDone::Run() {
+  // delete this after Run
+  std::unique_ptr<OnBatchRpcDone> self_guard(this);
+  if (!cntl_.Failed() &&
+      (response_.sizes_size() != static_cast<int>(promises_.size()) ||
+       response_.failed_size() != static_cast<int>(promises_.size()))) {
+    cntl_.SetFailed("Received %d responses for %zu requests.",
+                    response_.sizes_size(),
+                    promises_.size());
+  }
+  if (cntl_.Failed()) {
+    auto error = std::make_exception_ptr(platform::EnforceNotMet(
+        platform::errors::Fatal("%s", cntl_.ErrorText()), __FILE__, __LINE__));
+    for (auto &promise : promises_) {
+      promise.set_exception(error);
+    }
+    return;
+  }
+  butil::IOBuf &attachment = cntl_.response_attachment();
+  for (size_t i = 0; i < promises_.size(); ++i) {
+    std::string result;
+    attachment.cutn(&result, response_.sizes(i));
+    if (response_.failed(i)) {
+      promises_[i].set_exception(std::make_exception_ptr(
+          platform::EnforceNotMet(platform::errors::External("%s", result),
+                                  __FILE__,
+                                  __LINE__)));
+    } else {
+      promises_[i].set_value(std::move(result));
+    }
+  }
+  VLOG(2) << "Received " << promises_.size() << " responses from "
+          << cntl_.remote_side() << " to " << cntl_.local_side()
+          << " latency=" << cntl_.latency_us() << "us";
+}
+
 std::future<std::string> RpcAgent::InvokeRpc(const std::string &py_func,
                                              const std::string &to,
                                              int timeout_ms = kTimeoutMs) {
@@ -113,6 +182,33 @@ std::future<std::string> RpcAgent::InvokeRpc(const std::string &py_func,
       name_to_infos_.end(),
       platform::errors::OutOfRange("Worker %s doesn't exist!", to));
   uint32_t id = it->second.id_;
+  if (FLAGS_rpc_max_batch_size > 1 &&
+      static_cast<int64_t>(py_func.size()) < FLAGS_rpc_max_batch_bytes) {
+    std::unique_ptr<OnBatchRpcDone> full_batch;
+    std::future<std::string> fut;
+    {
+      std::lock_guard<std::mutex> lock(batch_mutex_);
+      auto &batch = batches_[id];
+      if (batch == nullptr) {
+        batch = std::make_unique<OnBatchRpcDone>();
+        batch->cntl_.set_timeout_ms(0);
+        batch->deadline_ =
+            std::chrono::steady_clock::now() +
+            std::chrono::microseconds(FLAGS_rpc_max_batch_delay_us);
+        batch_cv_.notify_one();
+      }
+      fut = batch->Add(py_func, timeout_ms);
+      if (static_cast<int>(batch->Size()) >= FLAGS_rpc_max_batch_size ||
+          static_cast<int64_t>(batch->Bytes()) >= FLAGS_rpc_max_batch_bytes ||
+          stop_flush_) {
+        full_batch = std::move(batch);
+      }
+    }
+    if (full_batch != nullptr) {
+      SendBatch(id, std::move(full_batch));
+    }
+    return fut;
+  }
   auto channel = channels_[id];
   // `done` must be allocated on the heap because its life cycle is after
   // calling done.Run().
@@ -125,6 +221,60 @@ std::future<std::string> RpcAgent::InvokeRpc(const std::string &py_func,
   return fut;
 }
 
+void RpcAgent::SendBatch(uint32_t id, std::unique_ptr<OnBatchRpcDone> batch) {
+  // `batch` is deleted by itself after calling batch->Run().
+  OnBatchRpcDone *done = batch.release();
+  RpcBaseService_Stub stub(channels_[id].get());
+  stub.InvokeBatchRpc(&done->cntl_, &done->request_, &done->response_, done);
+}
+
+void RpcAgent::FlushLoop() {
+  std::unique_lock<std::mutex> lock(batch_mutex_);
+  while (true) {
+    auto now = std::chrono::steady_clock::now();
+    auto wakeup = std::chrono::steady_clock::time_point::max();
+    std::vector<std::pair<uint32_t, std::unique_ptr<OnBatchRpcDone>>> due;
+    for (uint32_t id = 0; id < batches_.size(); ++id) {
+      auto &batch = batches_[id];
+      if (batch == nullptr) {
+        continue;
+      }
+      if (stop_flush_ || batch->deadline_ <= now) {
+        due.emplace_back(id, std::move(batch));
+      } else {
+        wakeup = std::min(wakeup, batch->deadline_);
+      }
+    }
+    if (!due.empty()) {
+      lock.unlock();
+      for (auto &item : due) {
+        SendBatch(item.first, std::move(item.second));
+      }
+      lock.lock();
+      continue;
+    }
+    if (stop_flush_) {
+      return;
+    }
+    if (wakeup == std::chrono::steady_clock::time_point::max()) {
+      batch_cv_.wait(lock);
+    } else {
+      batch_cv_.wait_until(lock, wakeup);
+    }
+  }
+}
+
+void RpcAgent::StopFlush() {
+  {
+    std::lock_guard<std::mutex> lock(batch_mutex_);
+    stop_flush_ = true;
+  }
+  batch_cv_.notify_all();
+  if (flush_thread_.joinable()) {
+    flush_thread_.join();
+  }
+}
+
 std::shared_ptr<RpcAgent> RpcAgent::RpcAgentInstance() {
   PADDLE_ENFORCE_NE(rpc_agent_instance_,
                     nullptr,
@@ -14,9 +14,13 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -59,13 +63,30 @@ class OnRpcDone : public google::protobuf::Closure {
   std::shared_ptr<std::promise<std::string>> promise_;
 };
 
+// The requests to a worker sent in one InvokeBatchRpc, whose payloads are
+// appended to the attachment of cntl_ as they come.
+class OnBatchRpcDone : public google::protobuf::Closure {
+ public:
+  // process callback of response, resolving the futures in order
+  void Run();
+  std::future<std::string> Add(const std::string &payload, int timeout_ms);
+  size_t Size() const { return promises_.size(); }
+  size_t Bytes() const { return cntl_.request_attachment().size(); }
+  RpcBatchResponse response_;
+  RpcBatchRequest request_;
+  brpc::Controller cntl_;
+  std::vector<std::promise<std::string>> promises_;
+  // when the batch is sent at the latest
+  std::chrono::steady_clock::time_point deadline_;
+};
+
 class RpcAgent {
  public:
   static std::shared_ptr<RpcAgent> RpcAgentInstance();
   static void SetAgentInstance(std::shared_ptr<RpcAgent> agent);
   // init RpcAgent instance and get information of all services
   RpcAgent(std::string name, std::vector<WorkerInfo> infos);
-  ~RpcAgent() {}
+  ~RpcAgent();
 
   const WorkerInfo &GetWorkerInfo(const std::string &name) const {
     auto it = name_to_infos_.find(name);
@@ -91,12 +112,19 @@ class RpcAgent {
   int StartClient();
   int Stop();
 
+  // Sends msg to worker to. Under FLAGS_rpc_max_batch_size > 1, the small
+  // messages are batched with the others to the same worker, sent when the
+  // batch is full or FLAGS_rpc_max_batch_delay_us after its first message.
   std::future<std::string> InvokeRpc(const std::string &msg,
                                      const std::string &to,
                                      int timeout_ms);
 
  private:
   DISABLE_COPY_AND_ASSIGN(RpcAgent);
+  void SendBatch(uint32_t id, std::unique_ptr<OnBatchRpcDone> batch);
+  // sends the batches when their deadlines are due, and all at Stop
+  void FlushLoop();
+  void StopFlush();
   static std::shared_ptr<RpcAgent> rpc_agent_instance_;
   brpc::Server server_;
   std::shared_ptr<RpcService> rpc_service_;
@@ -106,6 +134,13 @@ class RpcAgent {
   std::unordered_map<std::string, WorkerInfo> name_to_infos_;
   std::unordered_map<uint32_t, WorkerInfo> id_to_infos_;
   std::vector<WorkerInfo> infos_;
+
+  // the batches being filled, indexed by the id of their workers
+  std::vector<std::unique_ptr<OnBatchRpcDone>> batches_;
+  std::mutex batch_mutex_;
+  std::condition_variable batch_cv_;
+  std::thread flush_thread_;
+  bool stop_flush_ = false;
 };
 }  // namespace distributed
 }  // namespace paddle
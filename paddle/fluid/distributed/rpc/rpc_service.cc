@@ -0,0 +1,191 @@
+// Copyright (c) 2022 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/rpc/rpc_service.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace distributed {
+
+RpcService::RpcService(int num_threads) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this] { HandlerLoop(); });
+  }
+}
+
+RpcService::~RpcService() { Stop(); }
+
+void RpcService::InvokeRpc(google::protobuf::RpcController *cntl_base,
+                           const RpcRequest *request,
+                           RpcResponse *response,
+                           google::protobuf::Closure *done) {
+  // This object helps you to call done->Run() in RAII style. If you need
+  // to process the request asynchronously, pass done_guard.release().
+  brpc::ClosureGuard done_guard(done);
+
+  brpc::Controller *cntl = static_cast<brpc::Controller *>(cntl_base);
+  VLOG(2) << "InvokeRpc API: Received request[log_id=" << cntl->log_id()
+          << "] from " << cntl->remote_side() << " to " << cntl->local_side()
+          << ": "
+          << " (attached=" << cntl->request_attachment() << ")";
+  RpcCall call;
+  call.cntl_ = cntl;
+  call.response_ = response;
+  call.payloads_.push_back(request->message());
+  call.done_ = done_guard.release();
+  RunAndFinish(&call);
+}
+
+void RpcService::InvokeBatchRpc(google::protobuf::RpcController *cntl_base,
+                                const RpcBatchRequest *request,
+                                RpcBatchResponse *response,
+                                google::protobuf::Closure *done) {
+  brpc::ClosureGuard done_guard(done);
+
+  brpc::Controller *cntl = static_cast<brpc::Controller *>(cntl_base);
+  VLOG(2) << "InvokeBatchRpc API: Received " << request->sizes_size()
+          << " requests[log_id=" << cntl->log_id() << "] from "
+          << cntl->remote_side() << " to " << cntl->local_side();
+  // the payloads are cut without the GIL, only running them takes it
+  butil::IOBuf &attachment = cntl->request_attachment();
+  size_t total_size = 0;
+  for (auto size : request->sizes()) {
+    total_size += size;
+  }
+  if (total_size != attachment.size()) {
+    cntl->SetFailed(brpc::EREQUEST,
+                    "The batch of %d requests has %zu bytes, but %zu bytes "
+                    "are attached.",
+                    request->sizes_size(),
+                    total_size,
+                    attachment.size());
+    return;
+  }
+  auto call = std::make_unique<RpcCall>();
+  call->cntl_ = cntl;
+  call->batch_response_ = response;
+  call->payloads_.resize(request->sizes_size());
+  for (int i = 0; i < request->sizes_size(); ++i) {
+    attachment.cutn(&call->payloads_[i], request->sizes(i));
+  }
+  call->done_ = done_guard.release();
+  Enqueue(std::move(call));
+}
+
+void RpcService::Stop() {
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    threads.swap(threads_);
+  }
+  cv_.notify_all();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+void RpcService::Enqueue(std::unique_ptr<RpcCall> call) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopped_) {
+      queue_.push_back(std::move(call));
+      // an idle thread may be woken for each queued batch, the threads busy
+      // may wait for a nested RPC
+      if (queue_.size() > static_cast<size_t>(idle_threads_)) {
+        threads_.emplace_back([this] { HandlerLoop(); });
+      }
+    }
+  }
+  if (call != nullptr) {
+    // stopped, no handler thread is left
+    RunAndFinish(call.get());
+    return;
+  }
+  cv_.notify_one();
+}
+
+void RpcService::HandlerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ++idle_threads_;
+    cv_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+    --idle_threads_;
+    if (queue_.empty()) {
+      return;
+    }
+    std::unique_ptr<RpcCall> call = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    RunAndFinish(call.get());
+    lock.lock();
+  }
+}
+
+void RpcService::RunAndFinish(RpcCall *call) {
+  std::shared_ptr<PythonRpcHandler> python_handler =
+      PythonRpcHandler::GetInstance();
+  {
+    // acquire gil, because native Python objects are used
+    py::gil_scoped_acquire ag;
+    Run(python_handler.get(), call);
+  }
+  Finish(call);
+}
+
+void RpcService::Run(PythonRpcHandler *python_handler, RpcCall *call) {
+  call->results_.resize(call->payloads_.size());
+  call->failed_.resize(call->payloads_.size(), false);
+  for (size_t i = 0; i < call->payloads_.size(); ++i) {
+    try {
+      py::object py_func_obj = python_handler->Deserialize(call->payloads_[i]);
+      py::object res = python_handler->RunPythonFunc(py_func_obj);
+      call->results_[i] = python_handler->Serialize(res);
+    } catch (std::exception &e) {
+      // py::error_already_set included, the other payloads still run
+      call->results_[i] = e.what();
+      call->failed_[i] = true;
+    }
+    std::string().swap(call->payloads_[i]);
+  }
+}
+
+void RpcService::Finish(RpcCall *call) {
+  // This object calls done->Run() after the response is written.
+  brpc::ClosureGuard done_guard(call->done_);
+  if (call->response_ != nullptr) {
+    if (call->failed_[0]) {
+      call->cntl_->SetFailed("%s", call->results_[0].c_str());
+    } else {
+      call->response_->set_message(std::move(call->results_[0]));
+    }
+    return;
+  }
+  butil::IOBuf &attachment = call->cntl_->response_attachment();
+  for (size_t i = 0; i < call->results_.size(); ++i) {
+    call->batch_response_->add_sizes(call->results_[i].size());
+    call->batch_response_->add_failed(call->failed_[i]);
+    attachment.append(call->results_[i]);
+  }
+}
+
+}  // namespace distributed
+}  // namespace paddle
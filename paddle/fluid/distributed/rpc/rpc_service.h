@@ -16,41 +16,71 @@
 
 #include <brpc/server.h>
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "paddle/fluid/distributed/rpc/python_rpc_handler.h"
 #include "paddle/fluid/distributed/rpc/rpc.pb.h"
 
 namespace paddle {
 namespace distributed {
+// A received call whose payloads are run by the handler threads.
+struct RpcCall {
+  brpc::Controller *cntl_ = nullptr;
+  google::protobuf::Closure *done_ = nullptr;
+  // only one of the responses is set, by InvokeRpc or InvokeBatchRpc
+  RpcResponse *response_ = nullptr;
+  RpcBatchResponse *batch_response_ = nullptr;
+  std::vector<std::string> payloads_;
+  std::vector<std::string> results_;
+  std::vector<bool> failed_;
+};
+
 class RpcService : public RpcBaseService {
  public:
-  RpcService() {}
-  virtual ~RpcService() {}
+  // Keeps num_threads handler threads for the batches, more are started
+  // while the queued batches outnumber the idle threads, so that an RPC
+  // waiting for a nested one never holds up the others.
+  explicit RpcService(int num_threads = 1);
+  virtual ~RpcService();
 
+  // Runs on the brpc worker, as the single RPCs did before batching.
   virtual void InvokeRpc(google::protobuf::RpcController *cntl_base,
                          const RpcRequest *request,
                          RpcResponse *response,
-                         google::protobuf::Closure *done) {
-    // This object helps you to call done->Run() in RAII style. If you need
-    // to process the request asynchronously, pass done_guard.release().
-    brpc::ClosureGuard done_guard(done);
-
-    brpc::Controller *cntl = static_cast<brpc::Controller *>(cntl_base);
-    VLOG(2) << "InvokeRpc API: Received request[log_id=" << cntl->log_id()
-            << "] from " << cntl->remote_side() << " to " << cntl->local_side()
-            << ": "
-            << " (attached=" << cntl->request_attachment() << ")";
-    std::string py_func_str = request->message();
-    std::shared_ptr<PythonRpcHandler> python_handler =
-        PythonRpcHandler::GetInstance();
-    // acquire gil, because native Python objects are used
-    py::gil_scoped_acquire ag;
-    py::object py_func_obj = python_handler->Deserialize(py_func_str);
-    py::object res = python_handler->RunPythonFunc(py_func_obj);
-    std::string res_str = python_handler->Serialize(res);
-    response->set_message(res_str);
-  }
+                         google::protobuf::Closure *done);
+
+  // Splits the payloads without the GIL and queues them for the handler
+  // threads, which take the GIL once per batch and run it in order.
+  virtual void InvokeBatchRpc(google::protobuf::RpcController *cntl_base,
+                              const RpcBatchRequest *request,
+                              RpcBatchResponse *response,
+                              google::protobuf::Closure *done);
+
+  // Joins the handler threads after running the batches queued.
+  void Stop();
+
+ private:
+  void Enqueue(std::unique_ptr<RpcCall> call);
+  void HandlerLoop();
+  // Runs the payloads of call with the GIL and completes it.
+  void RunAndFinish(RpcCall *call);
+  // Runs the payloads of call, the GIL must be held.
+  void Run(PythonRpcHandler *python_handler, RpcCall *call);
+  // Writes the results of call to its response and completes it.
+  void Finish(RpcCall *call);
+
+  std::vector<std::thread> threads_;
+  int idle_threads_ = 0;
+  std::deque<std::unique_ptr<RpcCall>> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_ = false;
 };
 }  // namespace distributed
 }  // namespace paddle
@@ -0,0 +1,447 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Load generator of the parameter server. It forks a BrpcPsServer serving
+// one sparse table, fills the table with ps_bench_key_num keys, and then
+// drives it with Zipfian key streams from ps_bench_client_threads client
+// threads, in a pull, a push and a mixed pull-push phase. Each phase
+// reports the request and key throughput, the request latency percentiles,
+// and the server CPU time per request and per key, and the fill reports the
+// server memory per key. e.g.
+//
+//   ./brpc_ps_benchmark --ps_bench_table_class=SSDSparseTable \
+//       --rocksdb_path=/ssd/ps_bench --ps_bench_client_threads=16
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
+#include "paddle/fluid/distributed/ps/service/brpc_ps_server.h"
+#include "paddle/fluid/distributed/ps/service/env.h"
+#include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/platform/enforce.h"
+
+PD_DEFINE_string(ps_bench_table_class,
+                 "MemorySparseTable",
+                 "MemorySparseTable or SSDSparseTable.");
+PD_DEFINE_string(ps_bench_accessor_class,
+                 "CtrCommonAccessor",
+                 "CtrCommonAccessor or SparseAccessor.");
+PD_DEFINE_int32(ps_bench_embedx_dim, 8, "The embedx dim of the table.");
+PD_DEFINE_int32(ps_bench_shard_num, 16, "The shard num of the table.");
+PD_DEFINE_int32(ps_bench_port, 4219, "The port of the server.");
+PD_DEFINE_int32(ps_bench_client_threads, 8, "The number of client threads.");
+PD_DEFINE_int64(ps_bench_key_num, 1000000, "The number of distinct keys.");
+PD_DEFINE_double(ps_bench_zipf_exponent,
+                 0.99,
+                 "The exponent of the Zipfian distribution of the keys.");
+PD_DEFINE_int32(ps_bench_batch_size, 1024, "The keys of one request.");
+PD_DEFINE_int32(ps_bench_seconds, 10, "The duration of each phase.");
+
+namespace paddle {
+namespace distributed {
+namespace {
+
+// Samples the ranks in [1, n] with P(k) ~ k^-s by rejection-inversion,
+// W. Hormann and G. Derflinger, in O(1) memory whatever n is.
+class ZipfGenerator {
+ public:
+  ZipfGenerator(int64_t n, double s, uint32_t seed)
+      : n_(n), s_(s), rng_(seed), uniform_(0.0, 1.0) {
+    h_integral_x1_ = HIntegral(1.5) - 1.0;
+    h_integral_n_ = HIntegral(static_cast<double>(n_) + 0.5);
+    threshold_ = 2.0 - HIntegralInverse(HIntegral(2.5) - H(2.0));
+  }
+
+  int64_t Next() {
+    while (true) {
+      double u = h_integral_n_ +
+                 uniform_(rng_) * (h_integral_x1_ - h_integral_n_);
+      double x = HIntegralInverse(u);
+      int64_t k = std::min(std::max(static_cast<int64_t>(x + 0.5),
+                                    static_cast<int64_t>(1)),
+                           n_);
+      if (k - x <= threshold_ ||
+          u >= HIntegral(static_cast<double>(k) + 0.5) -
+                   H(static_cast<double>(k))) {
+        return k;
+      }
+    }
+  }
+
+ private:
+  double H(double x) const { return std::exp(-s_ * std::log(x)); }
+
+  double HIntegral(double x) const {
+    double log_x = std::log(x);
+    return ExpM1OverX((1.0 - s_) * log_x) * log_x;
+  }
+
+  double HIntegralInverse(double x) const {
+    double t = std::max(x * (1.0 - s_), -1.0);
+    return std::exp(Log1POverX(t) * x);
+  }
+
+  static double ExpM1OverX(double x) {
+    return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5;
+  }
+
+  static double Log1POverX(double x) {
+    return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * 0.5;
+  }
+
+  int64_t n_;
+  double s_;
+  std::mt19937_64 rng_;
+  std::uniform_real_distribution<double> uniform_;
+  double h_integral_x1_;
+  double h_integral_n_;
+  double threshold_;
+};
+
+// Scatters the hot ranks over the shards, bijective on uint64_t.
+uint64_t RankToKey(uint64_t rank) {
+  uint64_t z = rank + 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+void GetSparseTableProto(TableParameter* table_proto) {
+  table_proto->set_table_id(0);
+  table_proto->set_table_class(FLAGS_ps_bench_table_class);
+  table_proto->set_shard_num(FLAGS_ps_bench_shard_num);
+  TableAccessorParameter* accessor_config = table_proto->mutable_accessor();
+  accessor_config->set_accessor_class(FLAGS_ps_bench_accessor_class);
+  accessor_config->set_fea_dim(FLAGS_ps_bench_embedx_dim + 3);
+  accessor_config->set_embedx_dim(FLAGS_ps_bench_embedx_dim);
+  accessor_config->set_embedx_threshold(0);
+  accessor_config->mutable_ctr_accessor_param()->set_nonclk_coeff(0.1);
+  accessor_config->mutable_ctr_accessor_param()->set_click_coeff(1);
+  accessor_config->mutable_ctr_accessor_param()->set_base_threshold(0);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_threshold(0);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_keep_days(16);
+  accessor_config->mutable_ctr_accessor_param()->set_show_click_decay_rate(
+      0.98);
+  for (auto* sgd_param : {accessor_config->mutable_embed_sgd_param(),
+                          accessor_config->mutable_embedx_sgd_param()}) {
+    sgd_param->set_name("SparseAdaGradSGDRule");
+    auto* adagrad_param = sgd_param->mutable_adagrad();
+    adagrad_param->set_learning_rate(0.05);
+    adagrad_param->set_initial_g2sum(3.0);
+    adagrad_param->set_initial_range(0.0001);
+    adagrad_param->add_weight_bounds(-10.0);
+    adagrad_param->add_weight_bounds(10.0);
+  }
+}
+
+void GetServerServiceProto(ServerParameter* server_proto) {
+  ServerServiceParameter* service_proto =
+      server_proto->mutable_downpour_server_param()->mutable_service_param();
+  service_proto->set_service_class("BrpcPsService");
+  service_proto->set_server_class("BrpcPsServer");
+  service_proto->set_client_class("BrpcPsClient");
+  service_proto->set_start_server_port(0);
+  service_proto->set_server_thread_num(12);
+}
+
+PSParameter GetServerProto() {
+  PSParameter server_fleet_desc;
+  ServerParameter* server_proto = server_fleet_desc.mutable_server_param();
+  GetServerServiceProto(server_proto);
+  GetSparseTableProto(server_proto->mutable_downpour_server_param()
+                          ->add_downpour_table_param());
+  return server_fleet_desc;
+}
+
+PSParameter GetWorkerProto() {
+  PSParameter worker_fleet_desc;
+  GetSparseTableProto(worker_fleet_desc.mutable_worker_param()
+                          ->mutable_downpour_worker_param()
+                          ->add_downpour_table_param());
+  ServerParameter* server_proto = worker_fleet_desc.mutable_server_param();
+  GetServerServiceProto(server_proto);
+  GetSparseTableProto(server_proto->mutable_downpour_server_param()
+                          ->add_downpour_table_param());
+  return worker_fleet_desc;
+}
+
+void RunServer(std::vector<std::string>* host_sign_list) {
+  PSParameter server_proto = GetServerProto();
+  PaddlePSEnvironment ps_env;
+  ps_env.SetPsServers(host_sign_list, 1);
+  std::shared_ptr<PSServer> server(PSServerFactory::Create(server_proto));
+  std::vector<paddle::framework::ProgramDesc> empty_vec(1);
+  server->Configure(server_proto, ps_env, 0, empty_vec);
+  // blocks until the client stops the server
+  server->Start("127.0.0.1", FLAGS_ps_bench_port);
+}
+
+// The CPU seconds, user and system, the process has used.
+double ProcessCpuSeconds(pid_t pid) {
+  std::ifstream stat_file("/proc/" + std::to_string(pid) + "/stat");
+  std::string stat;
+  std::getline(stat_file, stat);
+  // the fields after the command name, which may contain spaces
+  std::istringstream fields(stat.substr(stat.rfind(')') + 2));
+  std::string field;
+  uint64_t utime = 0, stime = 0;
+  // utime and stime are the 14th and 15th fields, the 12th and 13th here
+  for (int i = 1; i <= 13 && fields >> field; ++i) {
+    if (i == 12) {
+      utime = std::stoull(field);
+    } else if (i == 13) {
+      stime = std::stoull(field);
+    }
+  }
+  return static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+// The resident memory of the process in bytes.
+int64_t ProcessRssBytes(pid_t pid) {
+  std::ifstream status_file("/proc/" + std::to_string(pid) + "/status");
+  std::string line;
+  while (std::getline(status_file, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) {
+      return std::stoll(line.substr(6)) * 1024;
+    }
+  }
+  return 0;
+}
+
+enum class Phase { kPull, kPush, kPullPush };
+
+const char* PhaseName(Phase phase) {
+  switch (phase) {
+    case Phase::kPull:
+      return "pull";
+    case Phase::kPush:
+      return "push";
+    default:
+      return "pull+push";
+  }
+}
+
+class PsBenchmark {
+ public:
+  PsBenchmark(PSClient* client, pid_t server_pid)
+      : client_(client), server_pid_(server_pid) {
+    auto info = client_->GetTableAccessor(0)->GetAccessorInfo();
+    select_dim_ = info.select_dim;
+    update_dim_ = info.update_dim;
+  }
+
+  // Creates all the keys in the table, and reports the memory per key.
+  void Fill() {
+    int64_t rss_begin = ProcessRssBytes(server_pid_);
+    std::vector<std::thread> threads;
+    int num_threads = FLAGS_ps_bench_client_threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.emplace_back([this, t, num_threads]() {
+        std::vector<uint64_t> keys;
+        for (int64_t rank = t + 1; rank <= FLAGS_ps_bench_key_num;
+             rank += num_threads) {
+          keys.push_back(RankToKey(rank));
+          if (keys.size() == static_cast<size_t>(FLAGS_ps_bench_batch_size)) {
+            Pull(keys);
+            keys.clear();
+          }
+        }
+        if (!keys.empty()) {
+          Pull(keys);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    int64_t rss_end = ProcessRssBytes(server_pid_);
+    LOG(INFO) << "Filled " << FLAGS_ps_bench_key_num << " keys into "
+              << FLAGS_ps_bench_table_class << ", server memory "
+              << rss_end << " bytes, "
+              << static_cast<double>(rss_end - rss_begin) /
+                     FLAGS_ps_bench_key_num
+              << " bytes per key";
+  }
+
+  void Run(Phase phase) {
+    std::vector<std::vector<double>> latencies(FLAGS_ps_bench_client_threads);
+    std::vector<int64_t> requests(FLAGS_ps_bench_client_threads, 0);
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::seconds(FLAGS_ps_bench_seconds);
+    double cpu_begin = ProcessCpuSeconds(server_pid_);
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < FLAGS_ps_bench_client_threads; ++t) {
+      threads.emplace_back([&, t]() {
+        ZipfGenerator zipf(FLAGS_ps_bench_key_num,
+                           FLAGS_ps_bench_zipf_exponent,
+                           static_cast<uint32_t>(t + 1));
+        std::vector<uint64_t> keys(FLAGS_ps_bench_batch_size);
+        while (std::chrono::steady_clock::now() < deadline) {
+          for (auto& key : keys) {
+            key = RankToKey(zipf.Next());
+          }
+          auto start = std::chrono::steady_clock::now();
+          if (phase != Phase::kPush) {
+            Pull(keys);
+          }
+          if (phase != Phase::kPull) {
+            Push(keys);
+          }
+          latencies[t].push_back(
+              std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count());
+          ++requests[t];
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    double cpu_seconds = ProcessCpuSeconds(server_pid_) - cpu_begin;
+
+    std::vector<double> all_latencies;
+    int64_t total_requests = 0;
+    for (int t = 0; t < FLAGS_ps_bench_client_threads; ++t) {
+      all_latencies.insert(
+          all_latencies.end(), latencies[t].begin(), latencies[t].end());
+      total_requests += requests[t];
+    }
+    if (total_requests == 0) {
+      LOG(WARNING) << "No request finishes in the " << PhaseName(phase)
+                   << " phase";
+      return;
+    }
+    std::sort(all_latencies.begin(), all_latencies.end());
+    auto percentile = [&all_latencies](double p) {
+      size_t index = static_cast<size_t>(p * (all_latencies.size() - 1));
+      return all_latencies[index];
+    };
+    int64_t total_keys = total_requests * FLAGS_ps_bench_batch_size;
+    LOG(INFO) << PhaseName(phase) << ": " << total_requests / seconds
+              << " requests/s, " << total_keys / seconds
+              << " keys/s, latency ms p50 " << percentile(0.5) << " p90 "
+              << percentile(0.9) << " p99 " << percentile(0.99) << " p999 "
+              << percentile(0.999) << ", server cpu us "
+              << cpu_seconds * 1e6 / total_requests << " per request "
+              << cpu_seconds * 1e6 / total_keys << " per key";
+  }
+
+ private:
+  void Pull(const std::vector<uint64_t>& keys) {
+    std::vector<float> values(keys.size() * select_dim_);
+    std::vector<float*> value_ptrs(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      value_ptrs[i] = values.data() + i * select_dim_;
+    }
+    auto status = client_->PullSparse(
+        value_ptrs.data(), 0, keys.data(), keys.size(), true);
+    status.wait();
+  }
+
+  void Push(const std::vector<uint64_t>& keys) {
+    // slot, show, click, embed_g and embedx_g of the ctr accessors
+    std::vector<float> grads(keys.size() * update_dim_, 0.01);
+    std::vector<const float*> grad_ptrs(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      float* grad = grads.data() + i * update_dim_;
+      grad[0] = 1;
+      grad[1] = 1;
+      grad[2] = i % 10 == 0 ? 1 : 0;
+      grad_ptrs[i] = grad;
+    }
+    auto* closure = new DownpourBrpcClosure(1, [](void* done) {
+      auto* closure = reinterpret_cast<DownpourBrpcClosure*>(done);
+      int ret = closure->check_response(0, PS_PUSH_SPARSE_TABLE) != 0 ? -1 : 0;
+      closure->set_promise_value(ret);
+    });
+    auto status = client_->PushSparseRawGradient(
+        0, keys.data(), grad_ptrs.data(), keys.size(), closure);
+    status.wait();
+  }
+
+  PSClient* client_;
+  pid_t server_pid_;
+  size_t select_dim_;
+  size_t update_dim_;
+};
+
+int RunBenchmark() {
+  setenv("http_proxy", "", 1);
+  setenv("https_proxy", "", 1);
+  std::vector<std::string> host_sign_list;
+  host_sign_list.push_back(
+      PSHost("127.0.0.1", FLAGS_ps_bench_port, 0).SerializeToString());
+
+  // the server runs in its own process to measure its cpu and memory
+  pid_t server_pid = fork();
+  PADDLE_ENFORCE_GE(
+      server_pid,
+      0,
+      platform::errors::Unavailable("Failed to fork the server process."));
+  if (server_pid == 0) {
+    RunServer(&host_sign_list);
+    _exit(0);
+  }
+  sleep(3);
+
+  PSParameter worker_proto = GetWorkerProto();
+  PaddlePSEnvironment ps_env;
+  ps_env.SetPsServers(&host_sign_list, 1);
+  std::shared_ptr<PSClient> client(PSClientFactory::Create(worker_proto));
+  std::map<uint64_t, std::vector<Region>> dense_regions;
+  dense_regions[0] = {};
+  client->Configure(worker_proto, dense_regions, ps_env, 0);
+
+  PsBenchmark benchmark(client.get(), server_pid);
+  benchmark.Fill();
+  for (auto phase : {Phase::kPull, Phase::kPush, Phase::kPullPush}) {
+    benchmark.Run(phase);
+  }
+
+  client->StopServer().wait();
+  client->FinalizeWorker();
+  int status = 0;
+  waitpid(server_pid, &status, 0);
+  return 0;
+}
+
+}  // namespace
+}  // namespace distributed
+}  // namespace paddle
+
+int main(int argc, char* argv[]) {
+  paddle::flags::ParseCommandLineFlags(&argc, &argv);
+  google::InitGoogleLogging(argv[0]);
+  return paddle::distributed::RunBenchmark();
+}
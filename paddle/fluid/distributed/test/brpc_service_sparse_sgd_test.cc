@@ -14,10 +14,12 @@ limitations under the License. */
 
 #include <unistd.h>
 
+#include <cmath>
 #include <string>
 #include <thread>  // NOLINT
 
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/service/brpc_ps_client.h"
 #include "paddle/fluid/distributed/ps/service/brpc_ps_server.h"
 #include "paddle/fluid/distributed/ps/service/env.h"
@@ -41,6 +43,8 @@ namespace phi {
 class DenseTensor;
 }  // namespace phi
 
+PD_DECLARE_int32(pserver_pull_sparse_wire_format);
+
 namespace framework = paddle::framework;
 namespace platform = paddle::platform;
 
@@ -303,6 +307,55 @@ void RunBrpcPushSparse() {
     EXPECT_FLOAT_EQ(fea_temp_values[idx], fea_values[idx] - 1.0);
   }
 
+  /*-----------------------Test Pull Wire Formats----------------------------*/
+  // the keys repeat, so that their counts are sent too
+  std::vector<uint64_t> dup_keys;
+  for (size_t idx = 0; idx < fea_keys.size(); ++idx) {
+    dup_keys.push_back(fea_keys[idx]);
+    dup_keys.push_back(fea_keys[fea_keys.size() - 1 - idx]);
+  }
+  auto pull_with_format = [&](int32_t format,
+                              std::vector<float>* values,
+                              bool param) {
+    FLAGS_pserver_pull_sparse_wire_format = format;
+    values->assign(dup_keys.size() * 10, 0);
+    std::vector<float*> value_ptr(dup_keys.size());
+    for (size_t idx = 0; idx < dup_keys.size(); ++idx) {
+      value_ptr[idx] = values->data() + idx * 10;
+    }
+    auto status = param ? worker_ptr_->PullSparseParam(value_ptr.data(),
+                                                       0,
+                                                       dup_keys.data(),
+                                                       dup_keys.size(),
+                                                       false)
+                        : worker_ptr_->PullSparse(value_ptr.data(),
+                                                  0,
+                                                  dup_keys.data(),
+                                                  dup_keys.size(),
+                                                  false);
+    status.wait();
+    EXPECT_EQ(status.get(), 0);
+  };
+  std::vector<float> raw_values;
+  pull_with_format(0, &raw_values, false);
+  // the raw, bfloat16 and float16 values
+  const float tolerances[] = {0, 0, 1e-2, 1e-3};
+  for (int32_t format = 1; format <= 3; ++format) {
+    std::vector<float> values;
+    pull_with_format(format, &values, false);
+    for (size_t idx = 0; idx < values.size(); ++idx) {
+      EXPECT_NEAR(values[idx],
+                  raw_values[idx],
+                  tolerances[format] * std::abs(raw_values[idx]) + 1e-6);
+    }
+    // pull_sparse_param keeps sending raw keys under every format
+    pull_with_format(format, &values, true);
+    for (size_t idx = 0; idx < values.size(); ++idx) {
+      EXPECT_FLOAT_EQ(values[idx], raw_values[idx]);
+    }
+  }
+  FLAGS_pserver_pull_sparse_wire_format = 0;
+
   LOG(INFO) << "Run stop_server";
   worker_ptr_->StopServer();
   LOG(INFO) << "Run finalize_worker";
@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/fluid/distributed/ps/service/brpc_utils.h"
 
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -131,6 +132,44 @@ TEST(MultiVarMsgCPU, Run) {
   RunMultiVarMsg(place);
 }
 
+TEST(PullSparseWireFormat, KeysAndValues) {
+  namespace distributed = paddle::distributed;
+  std::vector<uint64_t> keys = {0, 3, 200, 1UL << 40, UINT64_MAX};
+  std::vector<uint32_t> counts = {1, 2, 300, 1, 70000};
+  std::string encoded;
+  distributed::EncodePullSparseKeys(
+      keys.data(), counts.data(), keys.size(), &encoded);
+  EXPECT_LT(encoded.size(), keys.size() * 12);
+
+  std::vector<uint64_t> out_keys;
+  std::vector<uint32_t> out_counts;
+  EXPECT_TRUE(distributed::DecodePullSparseKeys(
+      encoded.data(), encoded.size(), keys.size(), &out_keys, &out_counts));
+  EXPECT_EQ(out_keys, keys);
+  EXPECT_EQ(out_counts, counts);
+  EXPECT_FALSE(distributed::DecodePullSparseKeys(
+      encoded.data(), encoded.size() - 1, keys.size(), &out_keys, &out_counts));
+
+  std::vector<float> values = {0.f, 1.f, -0.5f, 3.25f, 100.f};
+  for (int format : {distributed::kPullSparseKeyDelta,
+                     distributed::kPullSparseBFloat16,
+                     distributed::kPullSparseFloat16}) {
+    butil::IOBuf buf;
+    distributed::EncodePullSparseValues(
+        values.data(), values.size(), format, &buf);
+    size_t bytes = distributed::PullSparseValueBytes(format) * values.size();
+    EXPECT_EQ(buf.size(), bytes);
+    std::string wire = buf.to_string();
+    std::vector<float> decoded(values.size());
+    distributed::DecodePullSparseValues(
+        wire.data(), values.size(), format, decoded.data());
+    for (size_t i = 0; i < values.size(); ++i) {
+      // the values are exact in both half formats
+      EXPECT_FLOAT_EQ(decoded[i], values[i]);
+    }
+  }
+}
+
 // #ifdef PADDLE_WITH_CUDA
 // TEST(MultiVarMsgGPU, Run) {
 //   platform::CUDAPlace place;
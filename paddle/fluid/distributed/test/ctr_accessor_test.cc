@@ -303,5 +303,73 @@ TEST(downpour_feature_value_accessor_test, test_string_related) {
     ASSERT_FLOAT_EQ(value[i], 0);
   }
 }
+
+void check_compressed_storage(ValueStorageType storage_type, float tolerance) {
+  TableAccessorParameter parameter = gen_param();
+  parameter.mutable_embedx_sgd_param()->set_name("StdAdaGradSGDRule");
+  auto* adagrad_param = parameter.mutable_embedx_sgd_param()->mutable_adagrad();
+  adagrad_param->set_learning_rate(0.1);
+  adagrad_param->set_initial_range(0.3);
+  adagrad_param->set_initial_g2sum(0.0);
+  adagrad_param->add_weight_bounds(-10.0);
+  adagrad_param->add_weight_bounds(10.0);
+  CtrCommonAccessor* fp32_acc = new CtrCommonAccessor();
+  ASSERT_EQ(fp32_acc->Configure(parameter), 0);
+  ASSERT_EQ(fp32_acc->Initialize(), 0);
+
+  parameter.mutable_ctr_accessor_param()->set_embedx_storage_type(storage_type);
+  parameter.mutable_ctr_accessor_param()->set_compress_embedx_g2sum(true);
+  CtrCommonAccessor* acc = new CtrCommonAccessor();
+  ASSERT_EQ(acc->Configure(parameter), 0);
+  ASSERT_EQ(acc->Initialize(), 0);
+  ASSERT_LT(acc->GetAccessorInfo().dim, fp32_acc->GetAccessorInfo().dim);
+  ASSERT_LT(acc->GetAccessorInfo().mf_size,
+            fp32_acc->GetAccessorInfo().mf_size);
+  ASSERT_EQ(acc->GetAccessorInfo().select_dim,
+            fp32_acc->GetAccessorInfo().select_dim);
+
+  std::vector<float> value(acc->GetAccessorInfo().dim);
+  float* value_ptr = value.data();
+  ASSERT_EQ(acc->Create(&value_ptr, 1), 0);
+  acc->common_feature_value.Show(value_ptr) = 100;
+  acc->common_feature_value.Click(value_ptr) = 10;
+
+  // the fp32 accessor loads the compressed value from its text save
+  std::vector<float> fp32_value(fp32_acc->GetAccessorInfo().dim);
+  auto str = acc->ParseToString(value_ptr, 100);
+  ASSERT_EQ(fp32_acc->ParseFromString(str, fp32_value.data()),
+            static_cast<int>(fp32_value.size()));
+  ASSERT_EQ(acc->ParseFromString(str, value_ptr),
+            static_cast<int>(value.size()));
+
+  std::vector<float> grad(acc->GetAccessorInfo().update_dim);
+  for (size_t i = 0; i < grad.size(); ++i) {
+    grad[i] = 0.1 * static_cast<float>(i) - 0.3;
+  }
+  const float* grad_ptr = grad.data();
+  float* fp32_value_ptr = fp32_value.data();
+  ASSERT_EQ(acc->Update(&value_ptr, &grad_ptr, 1), 0);
+  ASSERT_EQ(fp32_acc->Update(&fp32_value_ptr, &grad_ptr, 1), 0);
+
+  std::vector<float> select(acc->GetAccessorInfo().select_dim);
+  std::vector<float> fp32_select(select.size());
+  float* select_ptr = select.data();
+  float* fp32_select_ptr = fp32_select.data();
+  ASSERT_EQ(acc->Select(&select_ptr, (const float**)&value_ptr, 1), 0);
+  ASSERT_EQ(
+      fp32_acc->Select(&fp32_select_ptr, (const float**)&fp32_value_ptr, 1),
+      0);
+  for (size_t i = 0; i < select.size(); ++i) {
+    ASSERT_NEAR(select[i], fp32_select[i], tolerance);
+  }
+}
+
+TEST(downpour_feature_value_accessor_test, test_fp16_storage) {
+  check_compressed_storage(STORE_FP16, 1e-2);
+}
+
+TEST(downpour_feature_value_accessor_test, test_int8_storage) {
+  check_compressed_storage(STORE_INT8, 1e-2);
+}
 }  // namespace distributed
 }  // namespace paddle
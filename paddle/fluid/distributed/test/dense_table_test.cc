@@ -20,6 +20,8 @@ limitations under the License. */
 #include "paddle/fluid/distributed/ps/table/memory_dense_table.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
 
+PD_DECLARE_bool(pserver_merge_dense_push);
+
 namespace paddle {
 namespace distributed {
 
@@ -227,5 +229,72 @@ TEST(MemoryDenseTable, SGD) {
   }
 }
 
+// MemoryDenseTable + SGD, with the concurrent pushes merged
+TEST(MemoryDenseTable, MergedSGD) {
+  // more than one cache line for each block
+  int fea_dim = 1000;
+  int trainers = 8;
+  FLAGS_pserver_merge_dense_push = true;
+
+  TableParameter table_config;
+  table_config.set_table_class("MemoryDenseTable");
+  FsClientParameter fs_config;
+  Table *table = new MemoryDenseTable();
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CommMergeAccessor");
+  CommonAccessorParameter *common_config = table_config.mutable_common();
+  common_config->set_name("sgd");
+  common_config->set_table_name("merged_sgd_test_table");
+  common_config->set_trainer_num(trainers);
+  common_config->add_params("Param");
+  common_config->add_dims(fea_dim);
+  common_config->add_initializers("fill_constant&1.0");
+  common_config->add_params("LearningRate");
+  common_config->add_dims(1);
+  common_config->add_initializers("fill_constant&0.5");
+  auto ret = table->Initialize(table_config, fs_config);
+  ASSERT_EQ(ret, 0);
+
+  // the sums are exact in float, whatever pushes are merged
+  std::vector<std::vector<float>> trainer_gradient_values(trainers);
+  std::vector<float> total_gradients(fea_dim, 0);
+  for (int i = 0; i < trainers; i++) {
+    for (int k = 0; k < fea_dim; k++) {
+      float grad = static_cast<float>((i + k) % 4) * 0.25f;
+      trainer_gradient_values[i].push_back(grad);
+      total_gradients[k] += grad;
+    }
+  }
+
+  std::shared_ptr<::ThreadPool> pool_ =
+      std::make_shared<::ThreadPool>(trainers);
+  std::vector<std::future<void>> task_status;
+  for (int i = 0; i < trainers; i++) {
+    auto &push_values = trainer_gradient_values[i];
+    auto task = [table, &push_values] {
+      TableContext table_context;
+      table_context.value_type = Dense;
+      table_context.push_context.values = push_values.data();
+      table_context.num = push_values.size();
+      table->Push(table_context);
+    };
+    task_status.push_back(pool_->enqueue(std::move(task)));
+  }
+  for (auto &status : task_status) {
+    status.wait();
+  }
+  FLAGS_pserver_merge_dense_push = false;
+
+  std::vector<float> pull_values(fea_dim);
+  TableContext table_context;
+  table_context.value_type = Dense;
+  table_context.pull_context.values = pull_values.data();
+  table_context.num = fea_dim;
+  table->Pull(table_context);
+  for (int j = 0; j < fea_dim; j++) {
+    ASSERT_FLOAT_EQ(pull_values[j], 1.0 - 0.5 * total_gradients[j]);
+  }
+}
+
 }  // namespace distributed
 }  // namespace paddle
@@ -46,5 +46,49 @@ TEST(BENCHMARK, LargeScaleKV) {
   ASSERT_FLOAT_EQ(value_data[3], 0.3);
 }
 
+TEST(BENCHMARK, LargeScaleKVFlatMap) {
+  typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
+  shard_type shard;
+  shard.set_flat_map(true);
+  ASSERT_TRUE(shard.use_flat_map());
+
+  // keys of one pserver shard share the same residue
+  const uint64_t shard_num = 1000;
+  const size_t key_num = 10000;
+  for (size_t i = 0; i < key_num; ++i) {
+    uint64_t key = i * shard_num + 7;
+    auto& feature_value = shard[key];
+    feature_value.resize(2);
+    feature_value.data()[0] = static_cast<float>(i);
+  }
+  ASSERT_EQ(shard.size(), key_num);
+
+  size_t visited = 0;
+  for (auto it = shard.begin(); it != shard.end(); ++it) {
+    ASSERT_EQ(it.key(), it.value().data()[0] * shard_num + 7);
+    ++visited;
+  }
+  ASSERT_EQ(visited, key_num);
+
+  for (auto it = shard.begin(); it != shard.end();) {
+    if ((it.key() / shard_num) % 2 == 1) {
+      it = shard.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(shard.size(), key_num / 2);
+  for (size_t i = 0; i < key_num; ++i) {
+    auto itr = shard.find(i * shard_num + 7);
+    ASSERT_EQ(itr != shard.end(), i % 2 == 0);
+  }
+
+  ASSERT_EQ(shard.erase(static_cast<uint64_t>(7)), 1UL);
+  ASSERT_TRUE(shard.find(7) == shard.end());
+  shard.clear();
+  ASSERT_TRUE(shard.empty());
+  ASSERT_TRUE(shard.begin() == shard.end());
+}
+
 }  // namespace distributed
 }  // namespace paddle
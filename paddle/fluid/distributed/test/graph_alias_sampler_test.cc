@@ -0,0 +1,61 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(AliasSampler, SampleK) {
+  GraphNode node(1);
+  node.build_edges(true);
+  int degree = 50;
+  for (int i = 0; i < degree; ++i) {
+    // one heavy edge makes the rejection path fall back to reservoir
+    node.add_edge(100 + i, i == 0 ? 1000.0f : 1.0f);
+  }
+  node.build_sampler("alias");
+
+  auto rng = std::make_shared<std::mt19937_64>(2024);
+  std::vector<int> out(degree);
+  std::vector<int> hits(degree, 0);
+  for (int round = 0; round < 200; ++round) {
+    for (int k : {1, 5, 30}) {
+      int n = node.sample_k(k, rng, out.data());
+      ASSERT_EQ(n, k);
+      std::set<int> uniq(out.begin(), out.begin() + n);
+      ASSERT_EQ(static_cast<int>(uniq.size()), k);
+      for (int i = 0; i < n; ++i) {
+        ASSERT_TRUE(out[i] >= 0 && out[i] < degree);
+        hits[out[i]]++;
+      }
+    }
+  }
+  for (int i = 0; i < degree; ++i) {
+    ASSERT_TRUE(hits[i] > 0);
+  }
+#ifdef PADDLE_WITH_CUDA
+  // the heavy edge is in nearly every sample
+  ASSERT_TRUE(hits[0] > 560);
+#endif
+
+  std::vector<int> all = node.sample_k(degree + 10, rng);
+  ASSERT_EQ(static_cast<int>(all.size()), degree);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,77 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_csr_shard.h"
+
+#include <unistd.h>
+
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(GraphCsrShard, BuildLoadSample) {
+  std::vector<std::unique_ptr<GraphNode>> holder;
+  std::vector<Node *> nodes;
+  // ids out of order, node 7 without edge must be skipped
+  for (uint64_t id : {30, 10, 7, 20}) {
+    holder.emplace_back(new GraphNode(id));
+    holder.back()->build_edges(true);
+    for (uint64_t j = 0; id != 7 && j < id / 10 * 3; ++j) {
+      holder.back()->add_edge(id * 100 + j, 1.0f + j);
+    }
+    nodes.push_back(holder.back().get());
+  }
+  std::string path = "./graph_csr_shard_test.csr";
+  ASSERT_EQ(GraphCsrShard::Build(nodes, true, path), 0);
+
+  GraphCsrShard shard;
+  ASSERT_EQ(shard.Load(path), 0);
+  ASSERT_EQ(shard.NodeNum(), 3UL);
+  ASSERT_EQ(shard.EdgeNum(), 18UL);
+  ASSERT_TRUE(shard.HasWeight());
+  ASSERT_EQ(shard.Find(7), -1);
+  ASSERT_EQ(shard.Find(15), -1);
+
+  int64_t pos = shard.Find(20);
+  ASSERT_GE(pos, 0);
+  ASSERT_EQ(shard.Degree(pos), 6UL);
+  for (int j = 0; j < 6; ++j) {
+    ASSERT_EQ(shard.NeighborId(pos, j), 2000UL + j);
+#ifdef PADDLE_WITH_CUDA
+    ASSERT_FLOAT_EQ(shard.NeighborWeight(pos, j), 1.0f + j);
+#else
+    ASSERT_FLOAT_EQ(shard.NeighborWeight(pos, j), 1.0f);
+#endif
+  }
+
+  auto rng = std::make_shared<std::mt19937_64>(2024);
+  for (bool weighted : {true, false}) {
+    std::vector<int> res = shard.SampleK(pos, 4, weighted, rng);
+    ASSERT_EQ(res.size(), 4UL);
+    std::set<int> uniq(res.begin(), res.end());
+    ASSERT_EQ(uniq.size(), 4UL);
+    for (int x : res) {
+      ASSERT_TRUE(x >= 0 && x < 6);
+    }
+  }
+  ASSERT_EQ(shard.SampleK(pos, 10, false, rng).size(), 6UL);
+  unlink(path.c_str());
+}
+
+}  // namespace distributed
+}  // namespace paddle
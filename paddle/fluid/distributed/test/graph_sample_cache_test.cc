@@ -0,0 +1,87 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_sample_cache.h"
+
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(ShardedClockCache, QueryInsertExpire) {
+  ShardedClockCache<uint64_t, int> cache(4, 64, 2);
+  std::vector<uint64_t> keys;
+  std::vector<int> values;
+  for (uint64_t i = 0; i < 10; ++i) {
+    keys.push_back(i);
+    values.push_back(static_cast<int>(i * 10));
+  }
+  cache.Insert(keys.data(), values.data(), keys.size());
+
+  std::vector<std::pair<uint64_t, int>> res;
+  cache.Query(keys.data(), keys.size(), &res);
+  ASSERT_EQ(res.size(), 10UL);
+  for (size_t i = 0; i < res.size(); ++i) {
+    ASSERT_EQ(res[i].first, keys[i]);
+    ASSERT_EQ(res[i].second, values[i]);
+  }
+
+  // still valid one pass later, gone after ttl passes
+  cache.SetPass(1);
+  res.clear();
+  cache.Query(keys.data(), keys.size(), &res);
+  ASSERT_EQ(res.size(), 10UL);
+  cache.SetPass(2);
+  res.clear();
+  cache.Query(keys.data(), keys.size(), &res);
+  ASSERT_EQ(res.size(), 0UL);
+
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.hit, 20UL);
+  ASSERT_EQ(stats.miss, 10UL);
+  ASSERT_EQ(stats.expire, 10UL);
+  ASSERT_EQ(cache.Size(), 0UL);
+}
+
+TEST(ShardedClockCache, EvictAndConcurrent) {
+  ShardedClockCache<uint64_t, uint64_t> cache(8, 256, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&cache, t]() {
+      std::vector<std::pair<uint64_t, uint64_t>> res;
+      for (uint64_t i = 0; i < 2000; ++i) {
+        uint64_t key = (t * 2000 + i) % 3000;
+        uint64_t value = key + 1;
+        res.clear();
+        cache.Query(&key, 1, &res);
+        if (res.empty()) {
+          cache.Insert(&key, &value, 1);
+        } else {
+          ASSERT_EQ(res[0].second, key + 1);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto stats = cache.GetStats();
+  ASSERT_EQ(stats.hit + stats.miss, 16000UL);
+  ASSERT_TRUE(stats.evict > 0);
+  ASSERT_TRUE(cache.Size() <= 256UL);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -0,0 +1,72 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/graph/graph_stream_partitioner.h"
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(HdrfPartitioner, DeterministicAndBalanced) {
+  // 4 communities of 100 vertices, 5% of the edges across them
+  std::mt19937_64 rng(2024);
+  std::vector<std::pair<uint64_t, uint64_t>> edges;
+  for (int i = 0; i < 4000; ++i) {
+    uint64_t c = rng() % 4;
+    uint64_t dst_c = (rng() % 20 == 0) ? rng() % 4 : c;
+    edges.emplace_back(c * 100 + rng() % 100, dst_c * 100 + rng() % 100);
+  }
+
+  const int part_num = 4;
+  HdrfPartitioner a(part_num), b(part_num);
+  for (auto &e : edges) {
+    ASSERT_EQ(a.Assign(e.first, e.second), b.Assign(e.first, e.second));
+  }
+  StreamPartitionStat stat = a.GetStat();
+  ASSERT_EQ(stat.vertex_num, 400UL);
+  uint64_t total = 0;
+  for (int p = 0; p < part_num; ++p) {
+    total += stat.edges[p];
+    ASSERT_TRUE(stat.cut_edges[p] <= stat.edges[p]);
+    // within 10% of an even split
+    ASSERT_TRUE(stat.edges[p] * part_num < edges.size() * 11 / 10);
+  }
+  ASSERT_EQ(total, edges.size());
+  // a random vertex-cut replicates almost every vertex on every partition
+  std::vector<std::vector<bool>> random_parts(400,
+                                              std::vector<bool>(part_num));
+  uint64_t random_replicas = 0;
+  for (size_t i = 0; i < edges.size(); ++i) {
+    int p = static_cast<int>(i % part_num);
+    for (uint64_t id : {edges[i].first, edges[i].second}) {
+      if (!random_parts[id][p]) {
+        random_parts[id][p] = true;
+        ++random_replicas;
+      }
+    }
+  }
+  ASSERT_TRUE(stat.ReplicationFactor() >= 1.0);
+  ASSERT_TRUE(stat.ReplicationFactor() < 0.8 * random_replicas / 400);
+
+  StreamPartitionStat merged;
+  merged.Merge(stat);
+  merged.Merge(stat);
+  ASSERT_EQ(merged.edges[0], stat.edges[0] * 2);
+  ASSERT_EQ(merged.vertex_num, stat.vertex_num * 2);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -18,6 +18,7 @@
 #include <condition_variable>  // NOLINT
 #include <fstream>
 #include <iomanip>
+#include <memory>
 #include <string>
 #include <thread>  // NOLINT
 #include <unordered_set>
@@ -83,3 +84,54 @@ void testGraphSample() {
 }
 
 TEST(testGraphSample, Run) { testGraphSample(); }
+
+TEST(testGraphSample, SampleCacheExpiresByPass) {
+  ::paddle::distributed::GraphParameter table_proto;
+  table_proto.set_task_pool_size(4);
+  table_proto.set_shard_num(8);
+  table_proto.add_edge_types("user2item");
+  table_proto.add_node_types("user");
+  table_proto.add_node_types("item");
+  table_proto.add_graph_feature();
+  table_proto.add_graph_feature();
+  table_proto.set_use_cache(true);
+  table_proto.set_cache_ttl(1);
+
+  distributed::GraphTable graph_table;
+  graph_table.Initialize(table_proto);
+  ASSERT_TRUE(graph_table.use_cache);
+  prepare_file(edge_file_name, edges);
+  graph_table.load_edges(std::string(edge_file_name), false, "user2item");
+
+  std::vector<uint64_t> ids = {37, 96, 59, 97};
+  auto sample = [&]() {
+    std::vector<std::shared_ptr<char>> buffers(ids.size());
+    std::vector<int> actual_sizes(ids.size(), 0);
+    graph_table.random_sample_neighbors(
+        0, ids.data(), 2, buffers, actual_sizes, false);
+    for (int actual_size : actual_sizes) {
+      ASSERT_EQ(actual_size, 2 * static_cast<int>(sizeof(uint64_t)));
+    }
+  };
+
+  graph_table.begin_pass(0);
+  sample();
+  sample();
+  auto stats = graph_table.sample_cache->GetStats();
+  ASSERT_EQ(stats.miss, 4UL);
+  ASSERT_EQ(stats.hit, 4UL);
+  ASSERT_EQ(stats.insert, 4UL);
+  graph_table.end_pass();
+
+  // the samples of pass 0 live for one pass
+  graph_table.begin_pass(1);
+  sample();
+  stats = graph_table.sample_cache->GetStats();
+  ASSERT_EQ(stats.expire, 4UL);
+  ASSERT_EQ(stats.miss, 8UL);
+  ASSERT_EQ(stats.insert, 8UL);
+  sample();
+  stats = graph_table.sample_cache->GetStats();
+  ASSERT_EQ(stats.hit, 8UL);
+  graph_table.end_pass();
+}
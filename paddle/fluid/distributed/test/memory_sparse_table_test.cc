@@ -17,13 +17,19 @@ limitations under the License. */
 #include <ThreadPool.h>
 #include <unistd.h>
 
+#include <set>
 #include <string>
 #include <thread>  // NOLINT
 
 #include "google/protobuf/text_format.h"
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/distributed/ps/table/depends/sparse_delta.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/utils/string/string_helper.h"
+
+PD_DECLARE_bool(pserver_create_value_when_push);
 
 namespace paddle {
 namespace distributed {
@@ -152,5 +158,82 @@ TEST(MemorySparseTable, SGD) {
   }
 }
 
+TEST(MemorySparseTable, DeltaSaveOfPulledKeys) {
+  int emb_dim = 8;
+  int shard_num = 10;
+
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(shard_num);
+  table_config.set_enable_delta_save(true);
+  FsClientParameter fs_config;
+  Table *table = new MemorySparseTable();
+  table->SetShard(0, 1);
+
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(emb_dim);
+  accessor_config->set_embedx_threshold(5);
+  accessor_config->mutable_embed_sgd_param()->set_name("SparseNaiveSGDRule");
+  auto *naive_param =
+      accessor_config->mutable_embed_sgd_param()->mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.3);
+  accessor_config->mutable_embedx_sgd_param()->set_name("SparseNaiveSGDRule");
+  naive_param = accessor_config->mutable_embedx_sgd_param()->mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.3);
+  ASSERT_EQ(table->Initialize(table_config, fs_config), 0);
+
+  // the pull creates the values, no push follows
+  bool create_value_when_push = FLAGS_pserver_create_value_when_push;
+  FLAGS_pserver_create_value_when_push = false;
+  std::vector<uint64_t> keys = {0, 1, 2, 3, 4, 15, 27};
+  std::vector<uint32_t> fres(keys.size(), 1);
+  std::vector<float> values(keys.size() * (emb_dim + 3));
+  auto value = PullSparseValue(keys, fres, emb_dim);
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = value;
+  table_context.pull_context.values = values.data();
+  table->Pull(table_context);
+  FLAGS_pserver_create_value_when_push = create_value_when_push;
+
+  std::string dirname = "./memory_sparse_table_delta_test";
+  ASSERT_EQ(table->Save(dirname, "6"), 0);
+
+  std::set<uint64_t> saved_keys;
+  for (int i = 0; i < shard_num; ++i) {
+    std::string content;
+    ASSERT_TRUE(ReadSparseDeltaFile(
+        ::paddle::string::format_string(
+            "%s/000/part-000-%05d", dirname.c_str(), i),
+        &content));
+    ASSERT_GE(ParseSparseDelta(content.data(),
+                               content.size(),
+                               [&saved_keys](uint64_t key,
+                                             const float *data,
+                                             size_t dim) {
+                                 ASSERT_GT(dim, 0u);
+                                 saved_keys.insert(key);
+                               }),
+              0);
+  }
+  ASSERT_EQ(saved_keys, std::set<uint64_t>(keys.begin(), keys.end()));
+
+  // the next delta only holds the keys touched since this one
+  ASSERT_EQ(table->Save(dirname, "6"), 0);
+  for (int i = 0; i < shard_num; ++i) {
+    std::string content;
+    ASSERT_TRUE(ReadSparseDeltaFile(
+        ::paddle::string::format_string(
+            "%s/000/part-000-%05d", dirname.c_str(), i),
+        &content));
+    ASSERT_TRUE(content.empty());
+  }
+  delete table;
+}
+
 }  // namespace distributed
 }  // namespace paddle
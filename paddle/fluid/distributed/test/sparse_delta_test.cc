@@ -0,0 +1,92 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/ps/table/depends/sparse_delta.h"
+
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace distributed {
+
+TEST(SparseDelta, WriteAndParse) {
+  SparseDeltaWriter writer;
+  std::vector<float> value = {1.0f, 2.0f, 3.0f};
+  writer.Append(11, value.data(), value.size());
+  writer.AppendErased(12);
+  ASSERT_EQ(writer.RecordNum(), 2u);
+  ASSERT_EQ(writer.Size(),
+            2 * SparseDeltaWriter::kRecordHeadSize + 3 * sizeof(float));
+
+  std::map<uint64_t, std::vector<float>> parsed;
+  int64_t ret = ParseSparseDelta(
+      writer.Data(),
+      writer.Size(),
+      [&parsed](uint64_t key, const float* data, size_t dim) {
+        parsed[key].assign(data, data + dim);
+      });
+  ASSERT_EQ(ret, 2);
+  ASSERT_EQ(parsed[11], value);
+  ASSERT_TRUE(parsed[12].empty());
+
+  // a truncated buffer is reported instead of being half applied
+  ret = ParseSparseDelta(writer.Data(),
+                         writer.Size() - 1,
+                         [](uint64_t, const float*, size_t) {});
+  ASSERT_EQ(ret, -1);
+}
+
+TEST(SparseDelta, MergeChain) {
+  std::vector<float> v1 = {1.0f, 1.0f};
+  std::vector<float> v2 = {2.0f, 2.0f};
+  SparseDeltaWriter first;
+  first.Append(1, v1.data(), v1.size());
+  first.Append(2, v1.data(), v1.size());
+  SparseDeltaWriter second;
+  second.Append(1, v2.data(), v2.size());
+  second.AppendErased(2);
+  second.Append(3, v2.data(), v2.size());
+
+  std::vector<std::string> inputs = {"./sparse_delta_test_0",
+                                     "./sparse_delta_test_1"};
+  std::vector<SparseDeltaWriter*> writers = {&first, &second};
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    int err_no = 0;
+    auto fp = paddle::framework::fs_open_write(inputs[i], &err_no, "");
+    ASSERT_EQ(fwrite(writers[i]->Data(), 1, writers[i]->Size(), fp.get()),
+              writers[i]->Size());
+  }
+  std::string output = "./sparse_delta_test_merged";
+  ASSERT_EQ(MergeSparseDeltaFiles(inputs, output), 3);
+
+  std::string content;
+  ASSERT_TRUE(ReadSparseDeltaFile(output, &content));
+  std::vector<uint64_t> keys;
+  std::map<uint64_t, std::vector<float>> merged;
+  ParseSparseDelta(content.data(),
+                   content.size(),
+                   [&](uint64_t key, const float* data, size_t dim) {
+                     keys.push_back(key);
+                     merged[key].assign(data, data + dim);
+                   });
+  ASSERT_EQ(keys, std::vector<uint64_t>({1, 2, 3}));
+  ASSERT_EQ(merged[1], v2);
+  ASSERT_TRUE(merged[2].empty());
+  ASSERT_EQ(merged[3], v2);
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <cmath>
 #include <iostream>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
@@ -205,5 +206,78 @@ TEST(downpour_sparse_adam_test, test_init_and_update) {
     ASSERT_FLOAT_EQ(value[i], label[i]) << "i is " << i;
   }
 }
+
+// the batched update gives the same values as the update of each key
+void CheckBatchUpdate(SparseValueSGDRule* rule, size_t embed_dim) {
+  const size_t kNum = 4;
+  size_t rule_dim = rule->Dim();
+  std::vector<std::vector<float>> w(kNum, std::vector<float>(embed_dim));
+  std::vector<std::vector<float>> sgd(kNum, std::vector<float>(rule_dim));
+  std::vector<std::vector<float>> grad(kNum, std::vector<float>(embed_dim));
+  for (size_t k = 0; k < kNum; ++k) {
+    rule->InitValue(w[k].data(), sgd[k].data(), false);
+    for (size_t i = 0; i < embed_dim; ++i) {
+      grad[k][i] = static_cast<float>((k + 1) * (i % 5)) * 0.37f - 1.1f;
+    }
+  }
+  auto expected_w = w;
+  auto expected_sgd = sgd;
+  std::vector<float> scale = {1.f, 2.f, 0.5f, 3.f};
+  for (size_t k = 0; k < kNum; ++k) {
+    rule->UpdateValue(
+        expected_w[k].data(), expected_sgd[k].data(), grad[k].data(), scale[k]);
+  }
+  std::vector<float*> w_ptr;
+  std::vector<float*> sgd_ptr;
+  std::vector<const float*> grad_ptr;
+  for (size_t k = 0; k < kNum; ++k) {
+    w_ptr.push_back(w[k].data());
+    sgd_ptr.push_back(sgd[k].data());
+    grad_ptr.push_back(grad[k].data());
+  }
+  rule->UpdateValueBatch(
+      w_ptr.data(), sgd_ptr.data(), grad_ptr.data(), scale.data(), kNum);
+  for (size_t k = 0; k < kNum; ++k) {
+    for (size_t i = 0; i < embed_dim; ++i) {
+      ASSERT_EQ(w[k][i], expected_w[k][i]) << "k is " << k << ", i is " << i;
+    }
+    for (size_t i = 0; i < rule_dim; ++i) {
+      ASSERT_EQ(sgd[k][i], expected_sgd[k][i]) << "k is " << k;
+    }
+  }
+}
+
+TEST(sparse_sgd_rule_test, test_batch_update) {
+  // not a multiple of the vector width, to cover the scalar tail
+  const size_t embed_dim = 13;
+  SparseCommonSGDRuleParameter param;
+  param.set_name("adagrad");
+  auto* adagrad_param = param.mutable_adagrad();
+  adagrad_param->set_learning_rate(0.1);
+  adagrad_param->set_initial_g2sum(0.2);
+  adagrad_param->set_initial_range(0.3);
+  adagrad_param->add_weight_bounds(-0.5);
+  adagrad_param->add_weight_bounds(0.5);
+  SparseAdaGradSGDRule adagrad_rule;
+  adagrad_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&adagrad_rule, embed_dim);
+
+  param.set_name("adam");
+  auto* adam_param = param.mutable_adam();
+  adam_param->set_learning_rate(0.1);
+  adam_param->set_initial_range(0.3);
+  adam_param->set_beta1_decay_rate(0.9);
+  adam_param->set_beta2_decay_rate(0.999);
+  adam_param->set_ada_epsilon(1e-08);
+  adam_param->add_weight_bounds(-0.5);
+  adam_param->add_weight_bounds(0.5);
+  SparseAdamSGDRule adam_rule;
+  adam_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&adam_rule, embed_dim);
+
+  SparseSharedAdamSGDRule shared_adam_rule;
+  shared_adam_rule.LoadConfig(param, embed_dim);
+  CheckBatchUpdate(&shared_adam_rule, embed_dim);
+}
 }  // namespace distributed
 }  // namespace paddle
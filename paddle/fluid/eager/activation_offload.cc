@@ -0,0 +1,313 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/activation_offload.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#endif
+
+namespace egr {
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+namespace {
+
+// the streams the activations of a device are offloaded and prefetched on,
+// never destroyed
+gpuStream_t CopyStream(int device_id, bool prefetch) {
+  static std::mutex mutex;
+  static std::map<std::pair<int, bool>, gpuStream_t> streams;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& stream = streams[std::make_pair(device_id, prefetch)];
+  if (stream == nullptr) {
+    paddle::platform::CUDADeviceGuard device_guard(device_id);
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
+#endif
+  }
+  return stream;
+}
+
+gpuStream_t ComputeStream(const phi::Place& place) {
+  return static_cast<phi::GPUContext*>(
+             paddle::platform::DeviceContextPool::Instance().Get(place))
+      ->stream();
+}
+
+gpuEvent_t RecordEvent(gpuStream_t stream) {
+  gpuEvent_t event;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventCreateWithFlags(&event, hipEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, stream));
+#endif
+  return event;
+}
+
+void StreamWaitEvent(gpuStream_t stream, gpuEvent_t event) {
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(stream, event, 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(stream, event, 0));
+#endif
+}
+
+// the work waiting for event keeps waiting for it once it is destroyed
+void DestroyEvent(gpuEvent_t event, bool synchronize) {
+#ifdef PADDLE_WITH_CUDA
+  if (synchronize) {
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event));
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(event));
+#else
+  if (synchronize) {
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event));
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventDestroy(event));
+#endif
+}
+
+}  // namespace
+#endif
+
+OffloadedActivation::OffloadedActivation(const phi::DenseTensor& tensor)
+    : place_(tensor.place()),
+      meta_(tensor.meta()),
+      size_(tensor.numel() * phi::SizeOf(tensor.dtype())) {
+  meta_.offset = 0;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  int device_id = place_.GetDeviceId();
+  paddle::platform::CUDADeviceGuard guard(device_id);
+  gpuStream_t offload_stream = CopyStream(device_id, /*prefetch=*/false);
+  // the copy starts after the kernel writing tensor
+  gpuEvent_t event = RecordEvent(ComputeStream(place_));
+  StreamWaitEvent(offload_stream, event);
+  DestroyEvent(event, /*synchronize=*/false);
+
+  host_ = paddle::memory::AllocShared(phi::GPUPinnedPlace(), size_);
+  paddle::memory::Copy(phi::GPUPinnedPlace(),
+                       host_->ptr(),
+                       phi::GPUPlace(device_id),
+                       tensor.data(),
+                       size_,
+                       offload_stream);
+  // the stream safe allocator reuses the device memory of tensor only once
+  // the copy completes
+  paddle::memory::RecordStream(tensor.Holder(), offload_stream);
+  offload_event_ = RecordEvent(offload_stream);
+#else
+  PADDLE_THROW(paddle::platform::errors::Unimplemented(
+      "Activations can only be offloaded from GPU."));
+#endif
+}
+
+OffloadedActivation::~OffloadedActivation() {
+  ActivationOffloader::Instance().Unregister(this);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  paddle::platform::CUDADeviceGuard guard(place_.GetDeviceId());
+  // the pinned memory is freed after the copies from and to it
+  if (offload_event_ != nullptr) {
+    DestroyEvent(offload_event_, /*synchronize=*/true);
+  }
+  if (prefetch_event_ != nullptr) {
+    DestroyEvent(prefetch_event_, /*synchronize=*/true);
+  }
+#endif
+}
+
+void OffloadedActivation::Prefetch() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (device_ != nullptr) {
+    return;
+  }
+  int device_id = place_.GetDeviceId();
+  paddle::platform::CUDADeviceGuard guard(device_id);
+  gpuStream_t compute_stream = ComputeStream(place_);
+  gpuStream_t prefetch_stream = CopyStream(device_id, /*prefetch=*/true);
+  // allocated on the compute stream, so the copy waits for the kernels that
+  // used the memory before
+  device_ = paddle::memory::AllocShared(place_, size_);
+  gpuEvent_t event = RecordEvent(compute_stream);
+  StreamWaitEvent(prefetch_stream, event);
+  DestroyEvent(event, /*synchronize=*/false);
+  StreamWaitEvent(prefetch_stream, offload_event_);
+
+  paddle::memory::Copy(phi::GPUPlace(device_id),
+                       device_->ptr(),
+                       phi::GPUPinnedPlace(),
+                       host_->ptr(),
+                       size_,
+                       prefetch_stream);
+  prefetch_event_ = RecordEvent(prefetch_stream);
+  VLOG(6) << "Prefetch offloaded activation of " << size_ << " bytes on "
+          << place_;
+#endif
+}
+
+std::shared_ptr<phi::Allocation> OffloadedActivation::Restore() {
+  Prefetch();
+  std::lock_guard<std::mutex> lock(mutex_);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!restored_) {
+    paddle::platform::CUDADeviceGuard guard(place_.GetDeviceId());
+    StreamWaitEvent(ComputeStream(place_), prefetch_event_);
+    restored_ = true;
+  }
+#endif
+  return device_;
+}
+
+ActivationOffloader& ActivationOffloader::Instance() {
+  // leaked, the activations of the graphs alive at exit unregister from it
+  static auto* offloader = new ActivationOffloader();
+  return *offloader;
+}
+
+void ActivationOffloader::Enable(int64_t min_bytes) {
+  PADDLE_ENFORCE_GE(min_bytes,
+                    0,
+                    paddle::platform::errors::InvalidArgument(
+                        "The min_bytes of offloaded activations should be "
+                        "non-negative, but got %d.",
+                        min_bytes));
+  min_bytes_ = min_bytes;
+  enabled_ = true;
+}
+
+void ActivationOffloader::Disable() { enabled_ = false; }
+
+std::shared_ptr<OffloadedActivation> ActivationOffloader::Offload(
+    const paddle::Tensor& tensor, GradNodeBase* owner) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!enabled_ || owner == nullptr || !tensor.initialized() ||
+      !tensor.is_dense_tensor() || !tensor.is_gpu()) {
+    return nullptr;
+  }
+  auto* dense_tensor = static_cast<phi::DenseTensor*>(tensor.impl().get());
+  int64_t size = dense_tensor->numel() * phi::SizeOf(dense_tensor->dtype());
+  if (size < min_bytes_ || size == 0 || !dense_tensor->meta().is_contiguous()) {
+    return nullptr;
+  }
+  const auto& holder = dense_tensor->Holder();
+  uint32_t inplace_version =
+      dense_tensor->InplaceVersionCounter().CurrentVersion();
+
+  std::shared_ptr<OffloadedActivation> activation;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = holders_.find(holder.get());
+    if (iter != holders_.end()) {
+      activation = iter->second.lock();
+      // the same memory may be saved again after an inplace update, or be
+      // freed and reused for another tensor
+      if (activation != nullptr &&
+          (activation->source_.lock() != holder ||
+           activation->inplace_version_ != inplace_version ||
+           activation->meta_.dims != dense_tensor->dims())) {
+        activation = nullptr;
+      }
+    }
+  }
+  if (activation == nullptr) {
+    activation = std::make_shared<OffloadedActivation>(*dense_tensor);
+    activation->source_ = holder;
+    activation->source_key_ = holder.get();
+    activation->inplace_version_ = inplace_version;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  holders_[holder.get()] = activation;
+  auto& owners = activation->owners_;
+  if (std::find(owners.begin(), owners.end(), owner) == owners.end()) {
+    owners.push_back(owner);
+    activations_[owner].push_back(activation);
+  }
+  VLOG(6) << "Offload activation of " << size << " bytes saved by GradNode "
+          << owner;
+  return activation;
+#else
+  return nullptr;
+#endif
+}
+
+void ActivationOffloader::Prefetch(GradNodeBase* node) {
+  std::vector<std::shared_ptr<OffloadedActivation>> activations;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = activations_.find(node);
+    if (iter == activations_.end()) {
+      return;
+    }
+    for (auto& activation : iter->second) {
+      if (auto ptr = activation.lock()) {
+        activations.emplace_back(std::move(ptr));
+      }
+    }
+  }
+  // outside of the lock, the last reference may be dropped here
+  for (auto& activation : activations) {
+    activation->Prefetch();
+  }
+}
+
+bool ActivationOffloader::HasOffloaded() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !activations_.empty();
+}
+
+void ActivationOffloader::Unregister(OffloadedActivation* activation) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto* owner : activation->owners_) {
+    auto iter = activations_.find(owner);
+    if (iter == activations_.end()) {
+      continue;
+    }
+    auto& list = iter->second;
+    list.erase(std::remove_if(list.begin(),
+                              list.end(),
+                              [](const std::weak_ptr<OffloadedActivation>& a) {
+                                return a.expired();
+                              }),
+               list.end());
+    if (list.empty()) {
+      activations_.erase(iter);
+    }
+  }
+  auto iter = holders_.find(activation->source_key_);
+  if (iter != holders_.end() && iter->second.expired()) {
+    holders_.erase(iter);
+  }
+}
+
+}  // namespace egr
@@ -0,0 +1,120 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace egr {
+
+class GradNodeBase;
+
+// The host copy of an activation saved by TensorWrappers of GradNodes. It is
+// copied to pinned memory on the offload stream of its device, after the work
+// queued on the compute stream so far, and copied back on the prefetch stream
+// ahead of the backward of its GradNodes.
+class OffloadedActivation {
+ public:
+  explicit OffloadedActivation(const phi::DenseTensor& tensor);
+  ~OffloadedActivation();
+  OffloadedActivation(const OffloadedActivation&) = delete;
+  OffloadedActivation& operator=(const OffloadedActivation&) = delete;
+
+  // starts copying it back to the device if it was not yet
+  void Prefetch();
+
+  // the device memory holding it, the compute stream waits for the copy
+  std::shared_ptr<phi::Allocation> Restore();
+
+  // of the tensor that was offloaded, with offset 0
+  const phi::DenseTensorMeta& meta() const { return meta_; }
+
+ private:
+  phi::Place place_;
+  phi::DenseTensorMeta meta_;
+  size_t size_ = 0;
+  std::mutex mutex_;
+  std::shared_ptr<phi::Allocation> host_;
+  std::shared_ptr<phi::Allocation> device_;
+  gpuEvent_t offload_event_ = nullptr;
+  gpuEvent_t prefetch_event_ = nullptr;
+  bool restored_ = false;
+
+  friend class ActivationOffloader;
+  // guarded by the mutex of ActivationOffloader
+  std::vector<GradNodeBase*> owners_;
+  std::weak_ptr<phi::Allocation> source_;
+  const phi::Allocation* source_key_ = nullptr;
+  uint32_t inplace_version_ = 0;
+};
+
+// Offloads the activations saved for backward to the host, see
+// paddle.autograd.offload_activations, so that their device memory is freed
+// until the backward needs them again.
+//
+// While enabled, a TensorWrapper of a GradNode saving an initialized,
+// contiguous GPU DenseTensor of at least min_bytes that is no leaf tensor
+// keeps it as an OffloadedActivation instead. RunBackward prefetches the
+// activations of the GradNodes about to run, see Prefetch, and the
+// TensorWrapper restores it when recovered. The tensors saved by the same
+// GradNode or by several are offloaded once.
+//
+// The CPU only builds never offload.
+class ActivationOffloader {
+ public:
+  static ActivationOffloader& Instance();
+
+  void Enable(int64_t min_bytes);
+  void Disable();
+  bool IsEnabled() const { return enabled_; }
+
+  // nullptr if tensor is not to be offloaded
+  std::shared_ptr<OffloadedActivation> Offload(const paddle::Tensor& tensor,
+                                               GradNodeBase* owner);
+
+  // starts copying back the activations saved by node
+  void Prefetch(GradNodeBase* node);
+
+  // whether some activation is offloaded
+  bool HasOffloaded();
+
+ private:
+  friend class OffloadedActivation;
+
+  ActivationOffloader() = default;
+
+  void Unregister(OffloadedActivation* activation);
+
+  bool enabled_ = false;
+  int64_t min_bytes_ = 0;
+  std::mutex mutex_;
+  std::unordered_map<GradNodeBase*,
+                     std::vector<std::weak_ptr<OffloadedActivation>>>
+      activations_;
+  // by the holder they were copied from, to offload the ones saved again
+  // only once
+  std::unordered_map<const phi::Allocation*,
+                     std::weak_ptr<OffloadedActivation>>
+      holders_;
+};
+
+}  // namespace egr
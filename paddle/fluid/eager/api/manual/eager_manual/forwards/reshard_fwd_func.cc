@@ -46,8 +46,7 @@ paddle::Tensor reshard_ad_function(
         1);
 
     // Node Construction
-    grad_node =
-        std::shared_ptr<ReshardGradNode>(new ReshardGradNode(1, 1));  // NOLINT
+    grad_node = egr::MakeGradNode<ReshardGradNode>(1, 1);
 
     // Set TensorWrappers for Forward Inputs if needed
     grad_node->SetTensorWrapperNoNeedBuffer_Input(input);
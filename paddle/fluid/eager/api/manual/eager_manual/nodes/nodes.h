@@ -40,8 +40,7 @@ class Conv2dGradNodeFinal : public egr::GradNodeBase {
   }
 
   std::shared_ptr<GradNodeBase> Copy() const override {
-    auto copied_node =
-        std::shared_ptr<Conv2dGradNodeFinal>(new Conv2dGradNodeFinal(*this));
+    auto copied_node = egr::MakeGradNode<Conv2dGradNodeFinal>(*this);
     VLOG(3) << "Copy Conv2dGradNodeFinal: " << this
             << " to: " << copied_node.get();
     return copied_node;
@@ -184,8 +183,7 @@ class AddNGradNodeFinal : public egr::GradNodeBase {
   }
 
   std::shared_ptr<GradNodeBase> Copy() const override {
-    auto copied_node =
-        std::shared_ptr<AddNGradNodeFinal>(new AddNGradNodeFinal(*this));
+    auto copied_node = egr::MakeGradNode<AddNGradNodeFinal>(*this);
     return copied_node;
   }
 
@@ -227,8 +225,7 @@ class MultiplyGradNode : public egr::GradNodeBase {
   }
 
   std::shared_ptr<GradNodeBase> Copy() const override {
-    auto copied_node =
-        std::shared_ptr<MultiplyGradNode>(new MultiplyGradNode(*this));
+    auto copied_node = egr::MakeGradNode<MultiplyGradNode>(*this);
     return copied_node;
   }
 
@@ -426,8 +423,7 @@ class ReshardGradNode : public egr::GradNodeBase {
 
   std::shared_ptr<GradNodeBase> Copy() const override {
     {
-      auto copied_node =
-          std::shared_ptr<ReshardGradNode>(new ReshardGradNode(*this));
+      auto copied_node = egr::MakeGradNode<ReshardGradNode>(*this);
       return copied_node;
     }
   }
@@ -551,8 +547,7 @@ class MultiplyGradNode : public egr::GradNodeBase {
   }
 
   std::shared_ptr<GradNodeBase> Copy() const override {
-    auto copied_node =
-        std::shared_ptr<MultiplyGradNode>(new MultiplyGradNode(*this));
+    auto copied_node = egr::MakeGradNode<MultiplyGradNode>(*this);
     return copied_node;
   }
 
@@ -141,13 +141,13 @@ def ParseArguments():
 # Code Gen Templates #
 ######################
 SET_PLAIN_TENSOR_WRAPPER_TEMPLATE = """  void SetTensorWrapper_{}(const paddle::Tensor& {}) {{
-    {} = egr::TensorWrapper({}, {});
+    {} = egr::TensorWrapper({}, {}, this);
   }}
 """
 
 SET_VECTOR_TENSOR_WRAPPER_TEMPLATE = """  void SetTensorWrapper_{}(const std::vector<paddle::Tensor>& {}) {{
     for(const auto& eager_tensor : {}) {{
-      {}.emplace_back(egr::TensorWrapper(eager_tensor, {}));
+      {}.emplace_back(egr::TensorWrapper(eager_tensor, {}, this));
     }};
   }}
 """
@@ -195,7 +195,7 @@ class {} : public egr::GradNodeBase {{
   }}
 
   std::shared_ptr<GradNodeBase> Copy() const override {{
-    auto copied_node = std::shared_ptr<{}>(new {}(*this));
+    auto copied_node = egr::MakeGradNode<{}>(*this);
     return copied_node;
   }}
 
@@ -274,13 +274,16 @@ TEST_API {} {}({}) {{
   // Get Input AutoGradMeta
 {}
 
+  bool trace_backward = egr::Controller::Instance().HasGrad();
+  bool require_any_grad = egr::EagerUtils::ComputeRequireGrad({});
+
+  // Fast path if no input requires grad
+{}
+
   VLOG(5) << \"Running C++ API: \" << \"{}\";
  // Before log info
 {}
 
-  bool trace_backward = egr::Controller::Instance().HasGrad();
-  bool require_any_grad = egr::EagerUtils::ComputeRequireGrad({});
-
   // Node Declaration
   std::shared_ptr<{}> grad_node;
 
@@ -363,6 +366,19 @@ TEST_API {} {}({}) {{
 }}
 """
 
+# AMP, type promotion and layout autotune have returned before this point if
+# they are enabled, so without grad only the api call itself is left to run.
+# The outputs get their AutogradMeta lazily, when it is first asked for.
+FORWARD_NO_GRAD_FAST_PATH_TEMPLATE = """  if (!require_any_grad && !VLOG_IS_ON(3)) {{
+  {}
+  {}
+{}
+{}
+{}
+    return {};
+  }}
+"""
+
 FORWARD_BODY_BEFORE_API_CALL_TEMPLATE = """  if (require_any_grad) {{
 {}
     // Node Construction
@@ -1061,8 +1077,10 @@ class DygraphFunctionGeneratorBase(FunctionGeneratorBase):
         # request MEMALIGN for allocation (Maybe).
         # See https://stackoverflow.com/questions/31228656/how-can-shared-ptr-disrupt-alignment
         # and https://github.com/MRtrix3/mrtrix3/issues/957
-        node_construction_str = f"{indent}auto grad_node = std::shared_ptr<{grad_node_name}>(new {grad_node_name}({num_backward_inputs}, {num_backward_outputs})); // NOLINT"
-        node_assignment_str = f"{indent}grad_node = std::shared_ptr<{grad_node_name}>(new {grad_node_name}({num_backward_inputs}, {num_backward_outputs})); // NOLINT"
+        # MakeGradNode takes the node from GradNodePool, which falls back to
+        # std::allocator for over-aligned nodes.
+        node_construction_str = f"{indent}auto grad_node = egr::MakeGradNode<{grad_node_name}>({num_backward_inputs}, {num_backward_outputs});"
+        node_assignment_str = f"{indent}grad_node = egr::MakeGradNode<{grad_node_name}>({num_backward_inputs}, {num_backward_outputs});"
 
         # SetAttributes
         set_attributes_list = []
@@ -1802,12 +1820,24 @@ class DygraphForwardFunctionGenerator(DygraphFunctionGeneratorBase):
             node_creation_pre_contiguous_str = (
                 self.node_creation_pre_contiguous_str
             )
+            # The fast path calls the api with the inputs as they are, the
+            # contiguous copies are only made for the tensor wrappers
+            no_grad_forward_call_str = forward_call_str
             if self.inputs_call_list_tmp is not None:
                 inputs_call_args_str_tmp = ", ".join(self.inputs_call_list_tmp)
                 forward_call_str = f"{indent}{api_out_type} api_result = paddle::experimental::{namespace}{function_name}({inputs_call_args_str_tmp});"
 
         dygraph_event_str = f"{indent}paddle::platform::RecordEvent dygraph_entrance_record_event(\"{forward_api_name} dygraph\", paddle::platform::TracerEventType::Operator, 1);\n"
         log_memory_info_str = f"{indent}paddle::memory::LogDeviceMemoryStats(egr::Controller::Instance().GetExpectedPlace(), \"{forward_api_name}\");"
+        if not self.is_forward_only:
+            no_grad_fast_path_str = FORWARD_NO_GRAD_FAST_PATH_TEMPLATE.format(
+                no_grad_forward_call_str,
+                log_memory_info_str,
+                check_nan_inf_str,
+                get_outputs_str,
+                bump_inplace_version_str,
+                returns_str,
+            )
         forward_ad_function_name = GetDygraphForwardFunctionName(
             forward_api_name
         )
@@ -1929,9 +1959,10 @@ class DygraphForwardFunctionGenerator(DygraphFunctionGeneratorBase):
                 type_promotion_logic_str,
                 layout_logic_str,
                 inputs_autograd_meta_str,
+                compute_require_grad_args_str,
+                no_grad_fast_path_str,
                 forward_api_name,
                 before_log_str,
-                compute_require_grad_args_str,
                 self.grad_node_name,
                 node_creation_pre_contiguous_str,
                 node_creation_before_call_str,
@@ -2250,7 +2281,6 @@ class DygraphNodeGenerator(DygraphFunctionGeneratorBase):
             grad_node_name,
             clear_tensor_wrapper_str,
             grad_node_name,
-            grad_node_name,
             set_tensor_wrapper_methods_str,
             set_attribute_methods_str,
             tensor_wrapper_members_str,
@@ -14,9 +14,27 @@
 
 #include "paddle/fluid/eager/backward.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <map>
+#include <mutex>  // NOLINT
+#include <tuple>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/eager/activation_offload.h"
 #include "paddle/fluid/eager/general_grad.h"
+#include "paddle/fluid/framework/details/nan_inf_utils.h"
 #include "paddle/fluid/memory/stats.h"
+#include "paddle/phi/core/threadpool.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
+
+COMMON_DECLARE_bool(check_nan_inf);
+COMMON_DECLARE_int32(eager_activation_offload_prefetch_depth);
+COMMON_DECLARE_int32(eager_backward_num_threads);
 
 namespace egr {
 
@@ -52,7 +70,7 @@ std::unordered_map<GradNodeBase*, int> getInDegreeMap(
     for (const auto& meta_list : metas) {
       for (const GradSlotMeta& meta : meta_list) {
         const auto& edge = meta.GetEdge();
-        GradNodeBase* next_node = edge.GetMutableGradNode().get();
+        GradNodeBase* next_node = edge.GetGradNode();
         // Next node could be nullptr if it is leaf tensor with no
         // AccumulationNode attached
         // Or it could also originated from dispensable inputs
@@ -83,6 +101,36 @@ void EnforceGradNodeHasInput(GradNodeBase* node) {
           node->name()));
 }
 
+// Starts copying back the offloaded activations of node and of the nodes
+// reachable from it within FLAGS_eager_activation_offload_prefetch_depth
+// edges, which run after it, so the copies overlap the kernels of node
+void PrefetchOffloadedActivations(GradNodeBase* node) {
+  auto& offloader = ActivationOffloader::Instance();
+  if (!offloader.HasOffloaded()) {
+    return;
+  }
+  std::unordered_set<GradNodeBase*> visited = {node};
+  std::vector<GradNodeBase*> nodes = {node};
+  for (int depth = 0; !nodes.empty(); ++depth) {
+    std::vector<GradNodeBase*> next_nodes;
+    for (GradNodeBase* cur : nodes) {
+      offloader.Prefetch(cur);
+      if (depth >= FLAGS_eager_activation_offload_prefetch_depth) {
+        continue;
+      }
+      for (const auto& meta_list : cur->OutputMeta()) {
+        for (const GradSlotMeta& meta : meta_list) {
+          GradNodeBase* next_node = meta.GetEdge().GetGradNode();
+          if (next_node && visited.insert(next_node).second) {
+            next_nodes.push_back(next_node);
+          }
+        }
+      }
+    }
+    nodes.swap(next_nodes);
+  }
+}
+
 void DuplicateCheck(const std::vector<paddle::Tensor>& inputs, bool is_input) {
   std::unordered_set<AutogradMeta*> visited_ins;
   std::string msg = is_input ? "inputs" : "outputs";
@@ -100,6 +148,303 @@ void DuplicateCheck(const std::vector<paddle::Tensor>& inputs, bool is_input) {
   }
 }
 
+// Set on the threads of ParallelBackwardEngine, a backward started from a
+// GradNode running there, e.g. by a PyLayer, runs serially instead of
+// waiting for the threads it occupies.
+static thread_local bool in_parallel_backward = false;
+
+// ParallelBackwardEngine runs the GradNodes whose inputs are ready on
+// FLAGS_eager_backward_num_threads threads per place, so that independent
+// branches of the backward graph overlap. The grads a GradNode receives are
+// kept until all of its producers finished, then summed in the order of
+// their producers in the graph, so the result does not depend on which
+// branch finished first.
+class ParallelBackwardEngine {
+ public:
+  ParallelBackwardEngine(
+      std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+          node_input_buffers_dict,
+      std::unordered_map<GradNodeBase*, int>* node_in_degree_map,
+      bool retain_graph)
+      : node_input_buffers_dict_(node_input_buffers_dict),
+        node_in_degree_map_(node_in_degree_map),
+        retain_graph_(retain_graph),
+        tracer_(egr::Controller::Instance().GetCurrentTracer()) {}
+
+  void Run(const std::deque<GradNodeBase*>& startup_nodes) {
+    SetNodeOrder(startup_nodes);
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      for (GradNodeBase* node : startup_nodes) {
+        if ((*node_in_degree_map_)[node] == 0) {
+          Dispatch(node);
+        }
+      }
+      // As in the serial loop, the first startup node runs even if it also
+      // waits for grads from the rest of the graph
+      if (running_num_ == 0 && !startup_nodes.empty()) {
+        Dispatch(startup_nodes.front());
+      }
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, [this] { return running_num_ == 0; });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+ private:
+  // A grad for the input (slot, rank) of a GradNode, produced by output
+  // (producer_slot, producer_rank) of the GradNode ordered producer_order
+  struct PendingGrad {
+    size_t producer_order;
+    size_t producer_slot;
+    size_t producer_rank;
+    size_t slot;
+    size_t rank;
+    paddle::Tensor tensor;
+  };
+
+  // Numbers the nodes in breadth first order from the startup nodes, which
+  // only depends on the graph
+  void SetNodeOrder(const std::deque<GradNodeBase*>& startup_nodes) {
+    std::deque<GradNodeBase*> queue(startup_nodes.begin(),
+                                    startup_nodes.end());
+    while (!queue.empty()) {
+      GradNodeBase* node = queue.front();
+      queue.pop_front();
+      if (!node_order_.emplace(node, node_order_.size()).second) {
+        continue;
+      }
+      for (const auto& meta_list : node->OutputMeta()) {
+        for (const GradSlotMeta& meta : meta_list) {
+          GradNodeBase* next_node = meta.GetEdge().GetGradNode();
+          if (next_node) {
+            queue.push_back(next_node);
+          }
+        }
+      }
+    }
+  }
+
+  static phi::Place PlaceOf(GradNodeBase* node) {
+    for (const auto& meta_list : node->InputMeta()) {
+      for (const GradSlotMeta& meta : meta_list) {
+        if (meta.GetPlace().GetType() != phi::AllocationType::UNDEFINED) {
+          return meta.GetPlace();
+        }
+      }
+    }
+    return egr::Controller::Instance().GetExpectedPlace();
+  }
+
+  // The ready queue of each place is the task queue of its thread pool
+  static phi::ThreadPool* ThreadPoolOf(const phi::Place& place) {
+    static std::mutex mutex;
+    static std::map<phi::Place, std::unique_ptr<phi::ThreadPool>> pools;
+    std::lock_guard<std::mutex> guard(mutex);
+    auto& pool = pools[place];
+    if (!pool) {
+      pool = std::make_unique<phi::ThreadPool>(
+          FLAGS_eager_backward_num_threads);
+    }
+    return pool.get();
+  }
+
+  // Called with mutex_ held
+  void Dispatch(GradNodeBase* node) {
+    ++running_num_;
+    phi::Place place = PlaceOf(node);
+    ThreadPoolOf(place)->RunAndGetException(
+        [this, node, place] { RunNode(node, place); });
+  }
+
+  // Takes the buffer of node and sums the pending grads into it
+  std::unique_ptr<GradTensorHolder> TakeInputBuffer(GradNodeBase* node) {
+    std::unique_ptr<GradTensorHolder> buffer;
+    std::vector<PendingGrad> grads;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto iter = node_input_buffers_dict_->find(node);
+      if (iter != node_input_buffers_dict_->end()) {
+        buffer = std::move(iter->second);
+        node_input_buffers_dict_->erase(iter);
+      }
+      auto grads_iter = pending_grads_.find(node);
+      if (grads_iter != pending_grads_.end()) {
+        grads = std::move(grads_iter->second);
+        pending_grads_.erase(grads_iter);
+      }
+    }
+    PADDLE_ENFORCE(
+        buffer || !grads.empty(),
+        paddle::platform::errors::Fatal(
+            "Unable to find next node in the GradTensorHolder \n"
+            "Trying to run Node without configuring its GradTensorHolder."));
+    if (!buffer) {
+      VLOG(7) << "Construct GradTensorHolder for grad node: " << node->name();
+      buffer = std::make_unique<GradTensorHolder>(node->InputMeta());
+    }
+    std::sort(grads.begin(),
+              grads.end(),
+              [](const PendingGrad& a, const PendingGrad& b) {
+                return std::tie(a.producer_order,
+                                a.producer_slot,
+                                a.producer_rank) <
+                       std::tie(b.producer_order,
+                                b.producer_slot,
+                                b.producer_rank);
+              });
+    for (const PendingGrad& grad : grads) {
+      buffer->add(grad.slot, grad.rank, grad.tensor, /*create_graph=*/false);
+    }
+    return buffer;
+  }
+
+  void RunNode(GradNodeBase* node, const phi::Place& place) {
+    in_parallel_backward = true;
+    egr::Controller::Instance().SetCurrentTracer(tracer_);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (place.GetType() == phi::AllocationType::GPU) {
+      phi::backends::gpu::SetDeviceId(place.GetDeviceId());
+    }
+#endif
+    std::vector<GradNodeBase*> ready_nodes;
+    try {
+      if (!failed_) {
+        ready_nodes = RunNodeAndCollectReady(node, place);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      failed_ = true;
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!failed_) {
+      for (GradNodeBase* next_node : ready_nodes) {
+        Dispatch(next_node);
+      }
+    }
+    if (--running_num_ == 0) {
+      finished_.notify_all();
+    }
+  }
+
+  std::vector<GradNodeBase*> RunNodeAndCollectReady(GradNodeBase* node,
+                                                    const phi::Place& place) {
+    VLOG(3) << "Preparing GradNode:" << node->name() << " addr:" << node;
+    std::unique_ptr<GradTensorHolder> node_input_buffer =
+        TakeInputBuffer(node);
+
+    EnforceGradNodeHasInput(node);
+
+    PrefetchOffloadedActivations(node);
+
+    paddle::platform::RecordEvent grad_node_record_event(
+        "Global_" + std::string((*node).name()),
+        paddle::platform::TracerEventType::Operator,
+        1);
+
+    // The accumulation nodes and the nodes with hooks run one at a time:
+    // the reduce hooks of DataParallel, e.g. EagerReducer::MarkVarReady,
+    // and the grad hooks are not thread safe.
+    std::unique_lock<std::mutex> serial_lock(serial_mutex_, std::defer_lock);
+    if (dynamic_cast<egr::GradNodeAccumulation*>(node) ||
+        node->GradientHooksRegistered()) {
+      serial_lock.lock();
+    }
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
+        grad_output_tensors = (*node)(node_input_buffer->Buffers(),
+                                      /*create_graph=*/false,
+                                      /*is_new_grad=*/false);
+    if (serial_lock.owns_lock()) {
+      serial_lock.unlock();
+    }
+
+    if (!retain_graph_) {
+      node->ClearTensorWrappers();
+    }
+    node_input_buffer.reset();
+
+    const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+        metas = node->OutputMeta();
+    PADDLE_ENFORCE(metas.size() == grad_output_tensors.size() || metas.empty(),
+                   paddle::platform::errors::Fatal(
+                       "Number of edges should be either empty ( for leaf node "
+                       ") or the same as number of output grad tensors, but we "
+                       "got edges size is: %d, grad_output size is: %d",
+                       metas.size(),
+                       grad_output_tensors.size()));
+
+    std::vector<GradNodeBase*> ready_nodes;
+    size_t producer_order = node_order_.at(node);
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      for (size_t i = 0; i < metas.size(); i++) {
+        for (size_t j = 0; j < metas[i].size(); j++) {
+          const Edge& edge = metas[i][j].GetEdge();
+          if (!edge.IsInitialized()) {
+            continue;
+          }
+          auto* next_node = edge.GetGradNode();
+          if (!next_node || grad_output_tensors[i].empty()) {
+            continue;
+          }
+          PADDLE_ENFORCE_LT(
+              j,
+              grad_output_tensors[i].size(),
+              paddle::platform::errors::Fatal(
+                  "Rank of grad_output_tensors should be less than "
+                  "grad_output_tensors[i].size(), which is: %d. This error "
+                  "may indicate autoprune or autograd api error. ",
+                  grad_output_tensors.size()));
+          auto edge_rank = edge.GetEdgeRankInfo();
+          pending_grads_[next_node].push_back(
+              PendingGrad{producer_order,
+                          i,
+                          j,
+                          edge_rank.first,
+                          edge_rank.second,
+                          std::move(grad_output_tensors[i][j])});
+
+          int& in_degree = (*node_in_degree_map_)[next_node];
+          --in_degree;
+          PADDLE_ENFORCE(
+              in_degree >= 0,
+              paddle::platform::errors::Fatal(
+                  "Detected in-degree value smaller than zero. For Node: %s"
+                  "Node's in-degree cannot be negative.",
+                  next_node->name()));
+          if (in_degree == 0) {
+            ready_nodes.push_back(next_node);
+          }
+        }
+      }
+    }
+    paddle::memory::LogDeviceMemoryStats(place, std::string((*node).name()));
+    return ready_nodes;
+  }
+
+  std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+      node_input_buffers_dict_;
+  std::unordered_map<GradNodeBase*, int>* node_in_degree_map_;
+  bool retain_graph_;
+  std::shared_ptr<paddle::imperative::Tracer> tracer_;
+  // Written before the first dispatch, read only afterwards
+  std::unordered_map<GradNodeBase*, size_t> node_order_;
+
+  std::mutex mutex_;
+  // held while running the nodes that must not run concurrently
+  std::mutex serial_mutex_;
+  std::condition_variable finished_;
+  std::unordered_map<GradNodeBase*, std::vector<PendingGrad>> pending_grads_;
+  int running_num_ = 0;
+  std::atomic<bool> failed_{false};
+  std::exception_ptr error_;
+};
+
 GeneralGrad* GeneralGrad::general_grad_ = new GeneralGrad();
 
 std::vector<paddle::Tensor> RunBackward(
@@ -243,6 +588,20 @@ std::vector<paddle::Tensor> RunBackward(
 
   VLOG(5) << "Startup_ops's size is " << queue.size();
 
+  // Force sequential nodes, paddle.grad and create_graph keep the serial
+  // loop below, which they depend on the order of.
+  bool run_parallel =
+      FLAGS_eager_backward_num_threads > 1 && !in_parallel_backward &&
+      !is_general_grad && !create_graph && force_sequential_nodes_set.empty();
+  if (run_parallel) {
+    VLOG(3) << "Run backward on " << FLAGS_eager_backward_num_threads
+            << " threads per place";
+    ParallelBackwardEngine engine(
+        &node_input_buffers_dict, &node_in_degree_map, retain_graph);
+    engine.Run(queue);
+    queue.clear();
+  }
+
   /* --- Topological Visit --- */
   // 1. Pop queue
   // 2. Run node
@@ -275,6 +634,8 @@ std::vector<paddle::Tensor> RunBackward(
     // Check input
     EnforceGradNodeHasInput(node);
 
+    PrefetchOffloadedActivations(node);
+
     VLOG(7) << "Run Backward Kernel with GradTensorHolder.";
 
     // This 'Global_XXXGradNode' record event is different with
@@ -331,17 +692,18 @@ std::vector<paddle::Tensor> RunBackward(
         auto edge_rank = edge.GetEdgeRankInfo();
         // Since we make edge has as same rank as bwd outputs, we indexing them
         // with the same rank(i, j)
-        auto next_node_shared = edge.GetMutableGradNode();
-        VLOG(3) << "Node: " << node->name() << " addr:" << node
-                << ", Found pending node: " << next_node_shared->name()
-                << " addr: " << next_node_shared.get();
+        // The graph holds the next node alive during backward, so it is used
+        // by raw pointer, without a shared_ptr copy per edge
+        auto* next_node = edge.GetGradNode();
         // Next node could be nullptr if it is leaf tensor with no
         // AccumulationNode attached
         // Or it could also originated from dispensable inputs
-        if (!next_node_shared || !next_node_shared.get() ||
-            grad_output_tensors[i].empty()) {
+        if (!next_node || grad_output_tensors[i].empty()) {
           continue;
         }
+        VLOG(3) << "Node: " << node->name() << " addr:" << node
+                << ", Found pending node: " << next_node->name()
+                << " addr: " << next_node;
 
         PADDLE_ENFORCE_LT(
             j,
@@ -363,7 +725,6 @@ std::vector<paddle::Tensor> RunBackward(
                 << ", rank: " << j
                 << " 's name is: " << grad_output_tensor.name();
 
-        auto* next_node = next_node_shared.get();
         if (!node_input_buffers_dict.count(next_node)) {
           const auto& input_meta = next_node->InputMeta();
           auto grad_tensor_holder =
@@ -431,6 +792,10 @@ std::vector<paddle::Tensor> RunBackward(
     (*hook)();
   }
   egr::Controller::Instance().ClearFinalBackwardHooks();
+  // the deferred nan/inf checks of the step are copied back at once
+  if (FLAGS_check_nan_inf) {
+    paddle::framework::details::CheckDeferredNanInf();
+  }
   if (!is_general_grad) return {};
   VLOG(3) << "Finish Backward";
   return GeneralGrad::Instance().GetResults(inputs, allow_unused, create_graph);
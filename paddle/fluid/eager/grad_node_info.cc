@@ -841,4 +841,84 @@ uintptr_t GradNodeBase::GetPtr() const {
   return reinterpret_cast<uintptr_t>(this);
 }
 
+namespace {
+
+// Blocks are rounded up to kGradNodeBlockAlign bytes. Larger ones, and the
+// blocks beyond kGradNodePoolBytesPerClass of a size class, go to the global
+// allocator.
+constexpr size_t kGradNodeBlockAlign = 64;
+constexpr size_t kGradNodePoolClassNum = 64;
+constexpr size_t kGradNodePoolBytesPerClass = 1 << 20;
+
+struct GradNodeFreeBlock {
+  GradNodeFreeBlock* next;
+};
+
+struct GradNodeFreeLists {
+  GradNodeFreeBlock* heads[kGradNodePoolClassNum] = {};
+  size_t sizes[kGradNodePoolClassNum] = {};
+
+  ~GradNodeFreeLists() {
+    for (auto* head : heads) {
+      while (head) {
+        auto* next = head->next;
+        ::operator delete(head);
+        head = next;
+      }
+    }
+  }
+};
+
+// Grad nodes may still be released after the free lists of their thread
+// are destroyed, e.g. by static objects at exit, they bypass the pool then.
+thread_local bool grad_node_pool_exited = false;
+
+struct GradNodeFreeListsHolder {
+  GradNodeFreeLists lists;
+  ~GradNodeFreeListsHolder() { grad_node_pool_exited = true; }
+};
+
+GradNodeFreeLists* ThreadGradNodeFreeLists() {
+  if (grad_node_pool_exited) {
+    return nullptr;
+  }
+  thread_local GradNodeFreeListsHolder holder;
+  return &holder.lists;
+}
+
+}  // namespace
+
+void* GradNodePool::Allocate(size_t size) {
+  size_t cls = (size + kGradNodeBlockAlign - 1) / kGradNodeBlockAlign;
+  if (cls == 0 || cls > kGradNodePoolClassNum) {
+    return ::operator new(size);
+  }
+  auto* lists = ThreadGradNodeFreeLists();
+  if (lists && lists->heads[cls - 1]) {
+    GradNodeFreeBlock* block = lists->heads[cls - 1];
+    lists->heads[cls - 1] = block->next;
+    --lists->sizes[cls - 1];
+    return block;
+  }
+  return ::operator new(cls * kGradNodeBlockAlign);
+}
+
+void GradNodePool::Deallocate(void* ptr, size_t size) {
+  size_t cls = (size + kGradNodeBlockAlign - 1) / kGradNodeBlockAlign;
+  if (cls == 0 || cls > kGradNodePoolClassNum) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto* lists = ThreadGradNodeFreeLists();
+  if (!lists || lists->sizes[cls - 1] * cls * kGradNodeBlockAlign >=
+                    kGradNodePoolBytesPerClass) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto* block = static_cast<GradNodeFreeBlock*>(ptr);
+  block->next = lists->heads[cls - 1];
+  lists->heads[cls - 1] = block;
+  ++lists->sizes[cls - 1];
+}
+
 }  // namespace egr
@@ -373,4 +373,60 @@ class GradNodeBase {
   bool is_run_auto_parallel_{false};
 };
 
+/**
+ * GradNodePool keeps the memory of released grad nodes in thread local free
+ * lists, one per size class, so that the nodes of the next iteration reuse
+ * it instead of going through the global allocator. A block may be released
+ * on another thread than the one it came from, it then joins the free lists
+ * of that thread.
+ **/
+class GradNodePool {
+ public:
+  TEST_API static void* Allocate(size_t size);
+  TEST_API static void Deallocate(void* ptr, size_t size);
+};
+
+template <typename T>
+class GradNodePoolAllocator {
+ public:
+  using value_type = T;
+
+  GradNodePoolAllocator() = default;
+  template <typename U>
+  GradNodePoolAllocator(const GradNodePoolAllocator<U>&) {}  // NOLINT
+
+  // The pooled blocks have the alignment of operator new, so over-aligned
+  // nodes, e.g. ones holding a complex128 Scalar on some platforms, are
+  // allocated by std::allocator instead.
+  T* allocate(size_t n) {
+    if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(GradNodePool::Allocate(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, size_t n) {
+    if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+      std::allocator<T>().deallocate(ptr, n);
+      return;
+    }
+    GradNodePool::Deallocate(ptr, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const GradNodePoolAllocator<U>&) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const GradNodePoolAllocator<U>&) const {
+    return false;
+  }
+};
+
+// Creates a grad node and its shared_ptr control block in one pooled block.
+template <typename T, typename... Args>
+std::shared_ptr<T> MakeGradNode(Args&&... args) {
+  return std::allocate_shared<T>(GradNodePoolAllocator<T>(),
+                                 std::forward<Args>(args)...);
+}
+
 }  // namespace egr
@@ -25,6 +25,7 @@
  * with no grad **/
 
 #pragma once
+#include "paddle/fluid/eager/activation_offload.h"
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/grad_node_info.h"
 #include "paddle/fluid/eager/utils.h"
@@ -39,8 +40,11 @@ namespace egr {
 class TensorWrapper {
  public:
   TensorWrapper() = default;
+  // owner is the GradNode saving tensor, the activations saved by one may be
+  // offloaded to the host, see ActivationOffloader
   explicit TensorWrapper(const paddle::Tensor& tensor,
-                         bool no_need_buffer = false) {
+                         bool no_need_buffer = false,
+                         GradNodeBase* owner = nullptr) {
     // set inplace_version_snapshot_ according to tensor's current inplace
     // version.
     if (tensor.initialized() && tensor.is_dense_tensor()) {
@@ -122,7 +126,22 @@ class TensorWrapper {
         packed_value_ = (*pack_hook)(tensor);
       } else {
 #endif
-        intermidiate_tensor_.set_impl(tensor.impl());
+        if (owner != nullptr && ActivationOffloader::Instance().IsEnabled() &&
+            !EagerUtils::IsLeafTensor(tensor)) {
+          offloaded_ = ActivationOffloader::Instance().Offload(tensor, owner);
+        }
+        if (offloaded_) {
+          // drops the reference to the device memory until recovered, but
+          // keeps counting the inplace updates of tensor
+          auto placeholder = std::make_shared<phi::DenseTensor>(
+              std::make_shared<phi::Allocation>(nullptr, 0, tensor.place()),
+              offloaded_->meta());
+          placeholder->ShareInplaceVersionCounterWith(
+              *static_cast<phi::DenseTensor*>(tensor.impl().get()));
+          intermidiate_tensor_.set_impl(placeholder);
+        } else {
+          intermidiate_tensor_.set_impl(tensor.impl());
+        }
 #ifndef PADDLE_NO_PYTHON
       }
 #endif
@@ -150,6 +169,7 @@ class TensorWrapper {
     inplace_version_snapshot_ = other.inplace_version_snapshot_;
     packed_value_ = other.packed_value_;
     unpack_hook_ = other.unpack_hook_;
+    offloaded_ = other.offloaded_;
     if (packed_value_) {
       packed_value_->inc_ref();
     }
@@ -162,6 +182,7 @@ class TensorWrapper {
     inplace_version_snapshot_ = other.inplace_version_snapshot_;
     packed_value_ = other.packed_value_;
     unpack_hook_ = other.unpack_hook_;
+    offloaded_ = other.offloaded_;
     if (packed_value_) {
       packed_value_->inc_ref();
     }
@@ -192,7 +213,12 @@ class TensorWrapper {
       }
     } else {
 #endif
+      // an inplace update after saving is an error with or without offload
       check_inplace_version();
+      if (offloaded_) {
+        static_cast<phi::DenseTensor*>(intermidiate_tensor_.impl().get())
+            ->ResetHolder(offloaded_->Restore());
+      }
 #ifndef PADDLE_NO_PYTHON
     }
 #endif
@@ -223,7 +249,10 @@ class TensorWrapper {
 
   paddle::Tensor get_intermidiate_tensor() { return intermidiate_tensor_; }
 
-  void clear() { intermidiate_tensor_.reset(); }
+  void clear() {
+    intermidiate_tensor_.reset();
+    offloaded_.reset();
+  }
 
  private:
   void check_inplace_version() {
@@ -277,6 +306,7 @@ class TensorWrapper {
   paddle::Tensor intermidiate_tensor_;
   std::weak_ptr<egr::GradNodeBase> weak_grad_node_;
   uint32_t inplace_version_snapshot_ = 0;
+  std::shared_ptr<OffloadedActivation> offloaded_;
 #ifndef PADDLE_NO_PYTHON
   std::shared_ptr<egr::PyObjectHolderBase> packed_value_;
   std::shared_ptr<egr::UnPackHookBase> unpack_hook_;
@@ -0,0 +1,415 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/async_checkpoint.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/io/fs.h"
+#include "paddle/fluid/framework/io/tensor_checkpoint.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/os_info.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/memory/allocation/pinned_staging_allocator.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#endif
+
+COMMON_DECLARE_int32(async_checkpoint_max_pending);
+
+namespace paddle {
+namespace framework {
+
+struct AsyncCheckpointSaver::Task {
+  int64_t id;
+  std::string path;
+  std::vector<std::string> names;
+  // dims, dtype and LoD only
+  std::vector<phi::DenseTensor> metas;
+  std::vector<std::vector<const void*>> chunks;
+  std::vector<memory::AllocationPtr> buffers;
+  // the host copies of the tensors on the other devices
+  std::vector<phi::DenseTensor> host_tensors;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // recorded on the side streams after the snapshot copies
+  std::vector<gpuEvent_t> events;
+#endif
+};
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+namespace {
+
+// the stream the snapshots of a device are copied on, never destroyed
+gpuStream_t SideStream(int device_id) {
+  static std::mutex mutex;
+  static std::map<int, gpuStream_t> streams;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& stream = streams[device_id];
+  if (stream == nullptr) {
+    platform::CUDADeviceGuard device_guard(device_id);
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
+#endif
+  }
+  return stream;
+}
+
+gpuEvent_t RecordEvent(gpuStream_t stream) {
+  gpuEvent_t event;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventCreateWithFlags(&event, hipEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, stream));
+#endif
+  return event;
+}
+
+void StreamWaitEvent(gpuStream_t stream, gpuEvent_t event) {
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(stream, event, 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(stream, event, 0));
+#endif
+}
+
+}  // namespace
+#endif
+
+AsyncCheckpointSaver& AsyncCheckpointSaver::Instance() {
+  // leaked, the saves left at exit are waited for by the Python side
+  static auto* saver = new AsyncCheckpointSaver();
+  return *saver;
+}
+
+AsyncCheckpointSaver::AsyncCheckpointSaver()
+    : thread_([this]() { Run(); }) {}
+
+AsyncCheckpointSaver::~AsyncCheckpointSaver() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+int64_t AsyncCheckpointSaver::Save(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<const phi::DenseTensor*>& tensors) {
+  PADDLE_ENFORCE_EQ(names.size(),
+                    tensors.size(),
+                    platform::errors::InvalidArgument(
+                        "The number of names (%d) and tensors (%d) to save "
+                        "should be the same.",
+                        names.size(),
+                        tensors.size()));
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t max_pending =
+        static_cast<size_t>(std::max(1, FLAGS_async_checkpoint_max_pending));
+    cv_.wait(lock, [&]() { return pending_num_ < max_pending; });
+    ++pending_num_;
+  }
+  std::unique_ptr<Task> task;
+  try {
+    task = Snapshot(path, names, tensors);
+  } catch (...) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    --pending_num_;
+    cv_.notify_all();
+    throw;
+  }
+  int64_t id;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    id = next_id_++;
+    task->id = id;
+    paths_[id] = path;
+    queue_.emplace_back(std::move(task));
+  }
+  cv_.notify_all();
+  VLOG(3) << "Queue the async checkpoint " << id << " of " << tensors.size()
+          << " tensors to " << path;
+  return id;
+}
+
+std::unique_ptr<AsyncCheckpointSaver::Task> AsyncCheckpointSaver::Snapshot(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<const phi::DenseTensor*>& tensors) {
+  constexpr size_t kChunkSize = kTensorCheckpointChunkSize;
+  auto task = std::make_unique<Task>();
+  task->path = path;
+  task->names = names;
+  task->metas.resize(tensors.size());
+  task->chunks.resize(tensors.size());
+  task->host_tensors.resize(tensors.size());
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // the compute stream of each device whose tensors are copied
+  std::map<int, gpuStream_t> compute_streams;
+#endif
+
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    auto& tensor = *tensors[i];
+    PADDLE_ENFORCE_EQ(
+        tensor.IsInitialized(),
+        true,
+        platform::errors::InvalidArgument(
+            "The Tensor with Index (%d) to be saved is not initialized.", i));
+    task->metas[i].set_meta(
+        phi::DenseTensorMeta(tensor.dtype(), tensor.dims(), tensor.lod()));
+    size_t size = tensor.numel() * phi::SizeOf(tensor.dtype());
+    if (size == 0) {
+      continue;
+    }
+    auto& chunks = task->chunks[i];
+    auto place = tensor.place();
+    const char* src = static_cast<const char*>(tensor.data());
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (platform::is_gpu_place(place)) {
+      int device_id = place.GetDeviceId();
+      platform::CUDAPlace gpu_place(device_id);
+      gpuStream_t side_stream = SideStream(device_id);
+      if (compute_streams.count(device_id) == 0) {
+        platform::CUDADeviceGuard guard(device_id);
+        auto* dev_ctx = static_cast<phi::GPUContext*>(
+            platform::DeviceContextPool::Instance().Get(place));
+        compute_streams[device_id] = dev_ctx->stream();
+        // the copies start after the work queued so far
+        gpuEvent_t event = RecordEvent(dev_ctx->stream());
+        StreamWaitEvent(side_stream, event);
+        task->events.push_back(event);
+      }
+      auto staging_allocator =
+          memory::allocation::PinnedStagingAllocator::Instance(gpu_place);
+      for (size_t begin = 0; begin < size; begin += kChunkSize) {
+        size_t chunk = std::min(kChunkSize, size - begin);
+        task->buffers.emplace_back(staging_allocator->Allocate(chunk));
+        void* dst = task->buffers.back()->ptr();
+        memory::Copy(platform::CUDAPinnedPlace(),
+                     dst,
+                     gpu_place,
+                     src + begin,
+                     chunk,
+                     side_stream);
+        chunks.push_back(dst);
+      }
+      continue;
+    }
+#endif
+    if (!platform::is_cpu_place(place) &&
+        !platform::is_cuda_pinned_place(place)) {
+      TensorCopySync(tensor, platform::CPUPlace(), &task->host_tensors[i]);
+      src = static_cast<const char*>(task->host_tensors[i].data());
+    } else {
+      task->buffers.emplace_back(memory::Alloc(platform::CPUPlace(), size));
+      char* dst = static_cast<char*>(task->buffers.back()->ptr());
+      std::memcpy(dst, src, size);
+      src = dst;
+    }
+    for (size_t begin = 0; begin < size; begin += kChunkSize) {
+      chunks.push_back(src + begin);
+    }
+  }
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // the kernels queued from now on, which may update the tensors in place,
+  // run after the copies
+  for (auto& item : compute_streams) {
+    platform::CUDADeviceGuard guard(item.first);
+    gpuEvent_t event = RecordEvent(SideStream(item.first));
+    StreamWaitEvent(item.second, event);
+    task->events.push_back(event);
+  }
+#endif
+  return task;
+}
+
+void AsyncCheckpointSaver::Run() {
+  while (true) {
+    std::unique_ptr<Task> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    std::string error;
+    try {
+      Write(task.get());
+    } catch (std::exception& e) {
+      error = e.what();
+    }
+    if (!error.empty()) {
+      LOG(WARNING) << "The async checkpoint " << task->id << " to "
+                   << task->path << " failed: " << error;
+    }
+    int64_t id = task->id;
+    // gives the staging buffers back before the waiters resume
+    task.reset();
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      finished_[id] = error;
+      --pending_num_;
+    }
+    cv_.notify_all();
+  }
+}
+
+void AsyncCheckpointSaver::Write(Task* task) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  for (gpuEvent_t event : task->events) {
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(event));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event));
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventDestroy(event));
+#endif
+  }
+  task->events.clear();
+#endif
+  std::vector<const phi::DenseTensor*> metas;
+  for (auto& meta : task->metas) {
+    metas.push_back(&meta);
+  }
+
+  bool is_local = fs_select_internal(task->path) == 0;
+  // renamed into place once complete, so a reader never sees a partial one
+  std::string local_path =
+      is_local ? task->path + ".tmp"
+               : "/tmp/paddle_async_checkpoint_" +
+                     std::to_string(phi::GetProcessId()) + "_" +
+                     std::to_string(task->id);
+  SaveTensorCheckpoint(local_path, task->names, metas, task->chunks);
+  task->buffers.clear();
+  task->host_tensors.clear();
+
+  if (is_local) {
+    PADDLE_ENFORCE_EQ(
+        std::rename(local_path.c_str(), task->path.c_str()),
+        0,
+        platform::errors::Unavailable(
+            "Fail to rename %s to %s.", local_path, task->path));
+    return;
+  }
+
+  std::string remote_tmp = task->path + ".tmp";
+  {
+    std::ifstream fin(local_path, std::ios::binary);
+    int err_no = 0;
+    std::shared_ptr<FILE> fout = fs_open_write(remote_tmp, &err_no, "");
+    std::vector<char> buf(4UL << 20);
+    while (fin) {
+      fin.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+      size_t n = static_cast<size_t>(fin.gcount());
+      if (n > 0 && fwrite(buf.data(), 1, n, fout.get()) != n) {
+        err_no = -1;
+        break;
+      }
+    }
+    // closing the pipe waits for the upload and sets err_no
+    fout.reset();
+    std::remove(local_path.c_str());
+    PADDLE_ENFORCE_EQ(err_no,
+                      0,
+                      platform::errors::Unavailable(
+                          "Fail to upload the checkpoint to %s.", remote_tmp));
+  }
+  fs_mv(remote_tmp, task->path);
+}
+
+void AsyncCheckpointSaver::Wait(int64_t id) {
+  std::string error;
+  std::string path;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_LT(id,
+                      next_id_,
+                      platform::errors::InvalidArgument(
+                          "There is no async checkpoint %d.", id));
+    cv_.wait(lock, [&]() { return finished_.count(id) > 0; });
+    error = finished_[id];
+    path = paths_[id];
+  }
+  PADDLE_ENFORCE_EQ(error.empty(),
+                    true,
+                    platform::errors::Unavailable(
+                        "The async checkpoint %d to %s failed: %s",
+                        id,
+                        path,
+                        error));
+}
+
+void AsyncCheckpointSaver::WaitAll() {
+  int64_t last_id;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    last_id = next_id_;
+  }
+  // throws the error of the first failed save once all are finished
+  std::exception_ptr error;
+  for (int64_t id = 0; id < last_id; ++id) {
+    try {
+      Wait(id);
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+bool AsyncCheckpointSaver::IsDone(int64_t id, std::string* error) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = finished_.find(id);
+  if (it == finished_.end()) {
+    return false;
+  }
+  if (error != nullptr) {
+    *error = it->second;
+  }
+  return true;
+}
+
+}  // namespace framework
+}  // namespace paddle
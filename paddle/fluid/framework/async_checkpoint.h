@@ -0,0 +1,87 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+// Saves tensor checkpoints, see io/tensor_checkpoint.h, without stalling
+// training until the bytes hit storage.
+//
+// Save snapshots the tensors and returns: the GPU tensors are copied into
+// pinned staging buffers on a side stream of their device, which their
+// compute stream then waits for, so the kernels updating the tensors in place
+// run after the copies without the host waiting. A background thread waits
+// for the copies, writes the checkpoint next to path and renames it into
+// place, or uploads it through fs_open_write for hdfs: and afs: paths. At
+// most FLAGS_async_checkpoint_max_pending saves are in flight, Save blocks
+// for an older one to finish beyond that.
+class AsyncCheckpointSaver {
+ public:
+  static AsyncCheckpointSaver& Instance();
+
+  AsyncCheckpointSaver();
+  ~AsyncCheckpointSaver();
+  AsyncCheckpointSaver(const AsyncCheckpointSaver&) = delete;
+  AsyncCheckpointSaver& operator=(const AsyncCheckpointSaver&) = delete;
+
+  // returns the id of the save
+  int64_t Save(const std::string& path,
+               const std::vector<std::string>& names,
+               const std::vector<const phi::DenseTensor*>& tensors);
+
+  // blocks until the save is written, and throws if it failed
+  void Wait(int64_t id);
+  void WaitAll();
+
+  // whether the save is finished, *error gets its error if it failed
+  bool IsDone(int64_t id, std::string* error);
+
+ private:
+  struct Task;
+
+  std::unique_ptr<Task> Snapshot(
+      const std::string& path,
+      const std::vector<std::string>& names,
+      const std::vector<const phi::DenseTensor*>& tensors);
+  void Run();
+  void Write(Task* task);
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Task>> queue_;
+  size_t pending_num_ = 0;
+  int64_t next_id_ = 0;
+  // the errors of the finished saves, empty for the successful ones
+  std::unordered_map<int64_t, std::string> finished_;
+  std::unordered_map<int64_t, std::string> paths_;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -123,6 +123,21 @@ class ChannelObject {
     return finished;
   }
 
+  // non-blocking operation
+  // takes at most n of the items that are in the channel right now
+  size_t TryRead(size_t n, T* p) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t m = (std::min)(n, data_.size());
+    for (size_t i = 0; i < m; i++) {
+      p[i] = std::move(data_.front());
+      data_.pop_front();
+    }
+    if (m > 0) {
+      Notify();
+    }
+    return m;
+  }
+
   // blocking operation
   bool Put(T&& val) { return WriteMove(1, &val) != 0; }
 
@@ -19,6 +19,7 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/data_feed.h"
 
+#include "paddle/fluid/framework/data_feed_columnar.h"
 #include "paddle/fluid/framework/fleet/ps_gpu_wrapper.h"
 #ifdef _LINUX
 #include <stdio_ext.h>
@@ -28,9 +29,12 @@ limitations under the License. */
 #include "io/fs.h"
 #include "paddle/fluid/platform/monitor.h"
 #include "paddle/fluid/platform/timer.h"
+#include "paddle/phi/core/lod_utils.h"
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 COMMON_DECLARE_bool(enable_ins_parser_file);
+COMMON_DECLARE_bool(enable_slotrecord_line_view);
+COMMON_DECLARE_bool(enable_reader_work_stealing);
 namespace paddle {
 namespace framework {
 
@@ -39,6 +43,19 @@ DLManager& global_dlmanager_pool() {
   return manager;
 }
 
+// Counts the batches and the instances read, their rates are the throughput
+// of the readers.
+static void RecordDataFeedBatch(int batch_size) {
+  static auto* batches = phi::MetricsRegistry::Instance().GetCounter(
+      "paddle_data_feed_batches_total", "Number of the batches read.");
+  static auto* instances = phi::MetricsRegistry::Instance().GetCounter(
+      "paddle_data_feed_instances_total", "Number of the instances read.");
+  if (batch_size > 0) {
+    batches->Increase();
+    instances->Increase(batch_size);
+  }
+}
+
 class BufferedLineFileReader {
   typedef std::function<bool()> SampleFunc;
   static const int MAX_FILE_BUFF_SIZE = 4 * 1024 * 1024;
@@ -55,6 +72,8 @@ class BufferedLineFileReader {
 
  public:
   typedef std::function<bool(const std::string&)> LineFunc;
+  // str is '\0' terminated and only valid during the call
+  typedef std::function<bool(const char* str, size_t len)> LineViewFunc;
 
  private:
   template <typename T>
@@ -101,6 +120,60 @@ class BufferedLineFileReader {
     }
     return lines;
   }
+  // same as read_lines, but a line that sits inside one block is handed out
+  // in place with its '\n' overwritten by '\0', only the line crossing two
+  // blocks is copied
+  template <typename T>
+  int read_line_views(T* reader, LineViewFunc func, int skip_lines) {
+    int lines = 0;
+    size_t ret = 0;
+    char* ptr = nullptr;
+    char* eol = nullptr;
+    total_len_ = 0;
+    error_line_ = 0;
+
+    SampleFunc spfunc = get_sample_func();
+    std::string x;
+    while (!is_error() && (ret = reader->read(buff_, MAX_FILE_BUFF_SIZE)) > 0) {
+      total_len_ += ret;
+      ptr = buff_;
+      eol = reinterpret_cast<char*>(memchr(ptr, '\n', ret));
+      while (eol != nullptr) {
+        size_t size = (eol - ptr) + 1;
+        *eol = '\0';
+        ++lines;
+        if (lines > skip_lines && spfunc()) {
+          bool ok = true;
+          if (x.empty()) {
+            ok = func(ptr, size - 1);
+          } else {
+            x.append(ptr, size - 1);
+            ok = func(x.c_str(), x.size());
+          }
+          if (!ok) {
+            ++error_line_;
+          }
+        }
+
+        x.clear();
+        ptr += size;
+        ret -= size;
+        eol = reinterpret_cast<char*>(memchr(ptr, '\n', ret));
+      }
+      if (ret > 0) {
+        x.append(ptr, ret);
+      }
+    }
+    if (!is_error() && !x.empty()) {
+      ++lines;
+      if (lines > skip_lines && spfunc()) {
+        if (!func(x.c_str(), x.size())) {
+          ++error_line_;
+        }
+      }
+    }
+    return lines;
+  }
 
  public:
   BufferedLineFileReader()
@@ -117,6 +190,10 @@ class BufferedLineFileReader {
     FILEReader reader(fp);
     return read_lines<FILEReader>(&reader, func, skip_lines);
   }
+  int read_file_view(FILE* fp, LineViewFunc func, int skip_lines) {
+    FILEReader reader(fp);
+    return read_line_views<FILEReader>(&reader, func, skip_lines);
+  }
   uint64_t file_size() { return total_len_; }
   void set_sample_rate(float r) { sample_rate_ = r; }
   size_t get_sample_line() { return sample_line_; }
@@ -339,6 +416,7 @@ int PrivateQueueDataFeed<T>::Next() {
   if (batch_size_ != 0) {
     PutToFeedVec(ins_vec);
   }
+  RecordDataFeedBatch(batch_size_);
   return batch_size_;
 #else
   return 0;
@@ -393,21 +471,51 @@ int InMemoryDataFeed<T>::Next() {
   if (!enable_heterps_) {
     CHECK(output_channel_ != nullptr);
     CHECK(consume_channel_ != nullptr);
+    if (channel_size_metric_ == nullptr) {
+      channel_size_metric_ = phi::MetricsRegistry::Instance().GetGauge(
+          "paddle_data_feed_channel_size",
+          "Number of the instances left in the output channel of a reader.",
+          "reader=\"" + std::to_string(thread_id_) + "\"");
+    }
+    channel_size_metric_->Set(static_cast<double>(output_channel_->Size()));
     VLOG(3) << "output_channel_ size=" << output_channel_->Size()
             << ", consume_channel_ size=" << consume_channel_->Size()
             << ", thread_id=" << thread_id_;
     int index = 0;
-    T instance;
     std::vector<T> ins_vec;
     ins_vec.reserve(this->default_batch_size_);
-    while (index < this->default_batch_size_) {
-      if (output_channel_->Size() == 0) {
-        break;
+    // read under one lock, other readers may steal from output_channel_
+    // between a Size check and a Get
+    std::vector<T> instances(this->default_batch_size_);
+    size_t num =
+        output_channel_->TryRead(this->default_batch_size_, instances.data());
+    for (size_t i = 0; i < num; ++i) {
+      ins_vec.push_back(instances[i]);
+      consume_channel_->Put(std::move(instances[i]));
+    }
+    index += static_cast<int>(num);
+    if (index < this->default_batch_size_ &&
+        FLAGS_enable_reader_work_stealing && !steal_channels_.empty()) {
+      // the own channel ran dry, finish the batch from the other readers so
+      // skewed channels do not leave threads idle till the pass ends
+      size_t channel_num = steal_channels_.size();
+      for (size_t k = 1; k <= channel_num; ++k) {
+        auto* victim = steal_channels_[(thread_id_ + k) % channel_num];
+        if (victim == output_channel_) {
+          continue;
+        }
+        num = victim->TryRead(this->default_batch_size_ - index,
+                              instances.data());
+        for (size_t i = 0; i < num; ++i) {
+          ins_vec.push_back(instances[i]);
+          consume_channel_->Put(std::move(instances[i]));
+        }
+        index += static_cast<int>(num);
+        stolen_ins_num_ += static_cast<int64_t>(num);
+        if (index >= this->default_batch_size_) {
+          break;
+        }
       }
-      output_channel_->Get(instance);
-      ins_vec.push_back(instance);
-      ++index;
-      consume_channel_->Put(std::move(instance));
     }
     this->batch_size_ = index;
     VLOG(3) << "batch_size_=" << this->batch_size_
@@ -442,6 +550,7 @@ int InMemoryDataFeed<T>::Next() {
             << " batch_offsets: " << batch_offsets_.size()
             << " batch_size: " << this->batch_size_;
   }
+  RecordDataFeedBatch(this->batch_size_);
   return this->batch_size_;
 #else
   return 0;
@@ -458,6 +567,16 @@ void InMemoryDataFeed<T>::SetOutputChannel(void* channel) {
   output_channel_ = static_cast<paddle::framework::ChannelObject<T>*>(channel);
 }
 
+template <typename T>
+void InMemoryDataFeed<T>::SetStealChannels(
+    const std::vector<void*>& channels) {
+  steal_channels_.clear();
+  for (auto* channel : channels) {
+    steal_channels_.push_back(
+        static_cast<paddle::framework::ChannelObject<T>*>(channel));
+  }
+}
+
 template <typename T>
 void InMemoryDataFeed<T>::SetConsumeChannel(void* channel) {
   consume_channel_ = static_cast<paddle::framework::ChannelObject<T>*>(channel);
@@ -1013,8 +1132,7 @@ void MultiSlotDataFeed::PutToFeedVec(
     }
 
     if (!use_slots_is_dense_[i]) {
-      LoD data_lod{offset};
-      feed_vec_[i]->set_lod(data_lod);
+      phi::AssignSingleLevelLoD(offset, feed_vec_[i]->mutable_lod());
     }
     if (use_slots_is_dense_[i]) {
       if (inductive_shape_index_[i] != -1) {
@@ -1397,8 +1515,7 @@ void MultiSlotInMemoryDataFeed::PutToFeedVec(const Record* ins_vec, int num) {
     }
     auto& slot_offset = offset_[i];
     if (this->input_type_ == 0) {
-      LoD data_lod{slot_offset};
-      feed_vec_[i]->set_lod(data_lod);
+      phi::AssignSingleLevelLoD(slot_offset, feed_vec_[i]->mutable_lod());
     } else if (this->input_type_ == 1) {
       if (!use_slots_is_dense_[i]) {
         std::vector<size_t> tmp_offset;
@@ -1414,8 +1531,7 @@ void MultiSlotInMemoryDataFeed::PutToFeedVec(const Record* ins_vec, int num) {
           tmp_offset.emplace_back(k);
         }
         slot_offset = tmp_offset;
-        LoD data_lod{slot_offset};
-        feed_vec_[i]->set_lod(data_lod);
+        phi::AssignSingleLevelLoD(slot_offset, feed_vec_[i]->mutable_lod());
       }
     }
     if (use_slots_is_dense_[i]) {
@@ -1496,8 +1612,7 @@ void MultiSlotInMemoryDataFeed::PutToFeedVec(
     auto& slot_offset = offset_[i];
     if (this->input_type_ == 0) {
       if (!use_slots_is_dense_[i]) {
-        LoD data_lod{slot_offset};
-        feed_vec_[i]->set_lod(data_lod);
+        phi::AssignSingleLevelLoD(slot_offset, feed_vec_[i]->mutable_lod());
       }
     } else if (this->input_type_ == 1) {
       if (!use_slots_is_dense_[i]) {
@@ -1514,8 +1629,7 @@ void MultiSlotInMemoryDataFeed::PutToFeedVec(
           tmp_offset.emplace_back(k);
         }
         slot_offset = tmp_offset;
-        LoD data_lod{slot_offset};
-        feed_vec_[i]->set_lod(data_lod);
+        phi::AssignSingleLevelLoD(slot_offset, feed_vec_[i]->mutable_lod());
       }
     }
     if (use_slots_is_dense_[i]) {
@@ -1551,8 +1665,7 @@ void PrivateInstantDataFeed<T>::PutToFeedVec() {
           tensor_ptr, &feasign[0], total_instance * sizeof(int64_t));
     }
 
-    LoD data_lod{offset};
-    feed_vec_[i]->set_lod(data_lod);
+    phi::AssignSingleLevelLoD(offset, feed_vec_[i]->mutable_lod());
     if (use_slots_is_dense_[i]) {
       int64_t total_dims = 1;
       for (const auto e : use_slots_shape_[i]) {
@@ -1991,8 +2104,7 @@ void PaddleBoxDataFeed::PutToFeedVec(const std::vector<Record*>& ins_vec) {
       CopyToFeedTensor(tensor_ptr, feasign, total_instance * sizeof(int64_t));
     }
     auto& slot_offset = offset_[i];
-    LoD data_lod{slot_offset};
-    feed_vec_[i]->set_lod(data_lod);
+    phi::AssignSingleLevelLoD(slot_offset, feed_vec_[i]->mutable_lod());
     if (use_slots_is_dense_[i]) {
       if (inductive_shape_index_[i] != -1) {
         use_slots_shape_[i][inductive_shape_index_[i]] =
@@ -2358,25 +2470,33 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
       CHECK(this->fp_ != nullptr);
       __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
 
-      lines = line_reader.read_file(
-          this->fp_.get(),
-          [this, &record_vec, &offset, &filename](const std::string& line) {
-            if (ParseOneInstance(line, &record_vec[offset])) {
-              ++offset;
-            } else {
-              LOG(WARNING) << "read file:[" << filename
-                           << "] item error, line:[" << line << "]";
-              return false;
-            }
-            if (offset >= OBJPOOL_BLOCK_SIZE) {
-              input_channel_->Write(std::move(record_vec));
-              record_vec.clear();
-              SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
-              offset = 0;
-            }
-            return true;
-          },
-          lines);
+      auto line_func = [this, &record_vec, &offset, &filename](
+                           const char* str, size_t len) {
+        if (ParseOneInstance(str, len, &record_vec[offset])) {
+          ++offset;
+        } else {
+          LOG(WARNING) << "read file:[" << filename << "] item error, line:["
+                       << str << "]";
+          return false;
+        }
+        if (offset >= OBJPOOL_BLOCK_SIZE) {
+          input_channel_->Write(std::move(record_vec));
+          record_vec.clear();
+          SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+          offset = 0;
+        }
+        return true;
+      };
+      if (FLAGS_enable_slotrecord_line_view) {
+        lines = line_reader.read_file_view(this->fp_.get(), line_func, lines);
+      } else {
+        lines = line_reader.read_file(
+            this->fp_.get(),
+            [&line_func](const std::string& line) {
+              return line_func(line.c_str(), line.size());
+            },
+            lines);
+      }
     } while (line_reader.is_error());
     if (offset > 0) {
       input_channel_->WriteMove(offset, &record_vec[0]);
@@ -2416,38 +2536,38 @@ static void parser_log_key(const std::string& log_key,
 
 bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
                                                   SlotRecord* ins) {
+  return ParseOneInstance(line.c_str(), line.size(), ins);
+}
+
+bool SlotRecordInMemoryDataFeed::ParseOneInstance(const char* str,
+                                                  size_t len,
+                                                  SlotRecord* ins) {
   SlotRecord& rec = (*ins);
   // parse line
-  const char* str = line.c_str();
   char* endptr = const_cast<char*>(str);
   int pos = 0;
 
-  thread_local std::vector<std::vector<float>> slot_float_feasigns;
-  thread_local std::vector<std::vector<uint64_t>> slot_uint64_feasigns;
-  slot_float_feasigns.resize(float_use_slot_size_);
-  slot_uint64_feasigns.resize(uint64_use_slot_size_);
-
   if (parse_ins_id_) {
     int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
     CHECK(num == 1);  // NOLINT
     pos = static_cast<int>(endptr - str + 1);
-    size_t len = 0;
-    while (str[pos + len] != ' ') {
-      ++len;
+    size_t id_len = 0;
+    while (str[pos + id_len] != ' ') {
+      ++id_len;
     }
-    rec->ins_id_ = std::string(str + pos, len);
-    pos += static_cast<int>(len + 1);
+    rec->ins_id_.assign(str + pos, id_len);
+    pos += static_cast<int>(id_len + 1);
   }
   if (parse_logkey_) {
     int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
     CHECK(num == 1);  // NOLINT
     pos = static_cast<int>(endptr - str + 1);
-    size_t len = 0;
-    while (str[pos + len] != ' ') {
-      ++len;
+    size_t id_len = 0;
+    while (str[pos + id_len] != ' ') {
+      ++id_len;
     }
     // parse_logkey
-    std::string log_key = std::string(str + pos, len);
+    std::string log_key = std::string(str + pos, id_len);
     uint64_t search_id = 0;
     uint32_t cmatch = 0;
     uint32_t rank = 0;
@@ -2457,11 +2577,17 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
     rec->search_id = search_id;
     rec->cmatch = cmatch;
     rec->rank = rank;
-    pos += static_cast<int>(len + 1);
+    pos += static_cast<int>(id_len + 1);
   }
 
-  int float_total_slot_num = 0;
-  int uint64_total_slot_num = 0;
+  // used slots of one type have increasing slot_value_idx in all_slots_info_
+  // order, so the values are appended straight into the record, whose buffers
+  // are kept by the pool between passes
+  auto& float_feasigns = rec->slot_float_feasigns_;
+  auto& uint64_feasigns = rec->slot_uint64_feasigns_;
+  float_feasigns.slot_offsets.resize(float_use_slot_size_ + 1);
+  uint64_feasigns.slot_offsets.resize(uint64_use_slot_size_ + 1);
+  size_t uint64_start = uint64_feasigns.slot_values.size();
 
   for (auto& info : all_slots_info_) {
     int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
@@ -2473,42 +2599,220 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
                    str);
     if (info.used_idx != -1) {
       if (info.type[0] == 'f') {  // float
-        auto& slot_fea = slot_float_feasigns[info.slot_value_idx];
-        slot_fea.clear();
+        auto& values = float_feasigns.slot_values;
+        float_feasigns.slot_offsets[info.slot_value_idx] =
+            static_cast<uint32_t>(values.size());
         for (int j = 0; j < num; ++j) {
           float feasign = strtof(endptr, &endptr);
           if (fabs(feasign) < 1e-6 && !used_slots_info_[info.used_idx].dense) {
             continue;
           }
-          slot_fea.push_back(feasign);
-          ++float_total_slot_num;
+          values.push_back(feasign);
         }
       } else if (info.type[0] == 'u') {  // uint64
-        auto& slot_fea = slot_uint64_feasigns[info.slot_value_idx];
-        slot_fea.clear();
+        auto& values = uint64_feasigns.slot_values;
+        uint64_feasigns.slot_offsets[info.slot_value_idx] =
+            static_cast<uint32_t>(values.size());
         for (int j = 0; j < num; ++j) {
           uint64_t feasign =
               static_cast<uint64_t>(strtoull(endptr, &endptr, 10));
-          slot_fea.push_back(feasign);
-          ++uint64_total_slot_num;
+          values.push_back(feasign);
         }
       }
       pos = static_cast<int>(endptr - str);
     } else {
       for (int j = 0; j <= num; ++j) {
         // pos = line.find_first_of(' ', pos + 1);
-        while (line[pos + 1] != ' ') {
+        while (static_cast<size_t>(pos + 1) < len && str[pos + 1] != ' ') {
           pos++;
         }
       }
     }
   }
-  rec->slot_float_feasigns_.add_slot_feasigns(slot_float_feasigns,
-                                              float_total_slot_num);
-  rec->slot_uint64_feasigns_.add_slot_feasigns(slot_uint64_feasigns,
-                                               uint64_total_slot_num);
+  float_feasigns.slot_offsets[float_use_slot_size_] =
+      static_cast<uint32_t>(float_feasigns.slot_values.size());
+  uint64_feasigns.slot_offsets[uint64_use_slot_size_] =
+      static_cast<uint32_t>(uint64_feasigns.slot_values.size());
+
+  return (uint64_feasigns.slot_values.size() > uint64_start);
+}
+
+uint32_t SlotRecordColumnarDataFeed::ColumnarFlags() const {
+  uint32_t flags = 0;
+  if (parse_ins_id_ || parse_logkey_) {
+    flags |= columnar::kWithInsId;
+  }
+  if (parse_logkey_) {
+    flags |= columnar::kWithLogKey;
+  }
+  return flags;
+}
+
+int64_t SlotRecordColumnarDataFeed::ConvertFile(
+    const std::string& text_file, const std::string& columnar_file) {
+  int64_t ins_num = 0;
+#ifdef _LINUX
+  int err_no = 0;
+  auto fp_in = fs_open_read(text_file, &err_no, this->pipe_command_, true);
+  PADDLE_ENFORCE_NOT_NULL(
+      fp_in,
+      platform::errors::Unavailable("Failed to open file %s.", text_file));
+  auto fp_out = fs_open_write(columnar_file, &err_no, "");
+  PADDLE_ENFORCE_NOT_NULL(
+      fp_out,
+      platform::errors::Unavailable("Failed to open file %s.", columnar_file));
+
+  uint32_t flags = ColumnarFlags();
+  std::string buf;
+  columnar::FileHeader header = {columnar::kMagic,
+                                 columnar::kVersion,
+                                 static_cast<uint32_t>(uint64_use_slot_size_),
+                                 static_cast<uint32_t>(float_use_slot_size_),
+                                 flags};
+  columnar::PutFixed(header, &buf);
+  columnar::BlockEncoder encoder(
+      uint64_use_slot_size_, float_use_slot_size_, flags);
+  std::vector<uint64_t> block_offsets;
+  uint64_t written = 0;
+  auto write_buf = [&fp_out, &buf, &written, &columnar_file]() {
+    PADDLE_ENFORCE_EQ(
+        fwrite(buf.data(), 1, buf.size(), fp_out.get()),
+        buf.size(),
+        platform::errors::Unavailable("Failed to write file %s.",
+                                      columnar_file));
+    written += buf.size();
+    buf.clear();
+  };
+  write_buf();
+
+  SlotRecord rec = make_slotrecord();
+  BufferedLineFileReader line_reader;
+  line_reader.read_file_view(
+      fp_in.get(),
+      [&](const char* str, size_t len) {
+        rec->reset();
+        if (!ParseOneInstance(str, len, &rec)) {
+          LOG(WARNING) << "read file:[" << text_file << "] item error, line:["
+                       << str << "]";
+          return false;
+        }
+        encoder.Add(*rec);
+        ++ins_num;
+        if (encoder.InsNum() >= static_cast<uint32_t>(OBJPOOL_BLOCK_SIZE)) {
+          block_offsets.push_back(written);
+          encoder.Flush(&buf);
+          write_buf();
+        }
+        return true;
+      },
+      0);
+  free_slotrecord(rec);
+  if (encoder.InsNum() > 0) {
+    block_offsets.push_back(written);
+    encoder.Flush(&buf);
+  }
+  columnar::BlockHeader end_block = {0, 0};
+  columnar::PutFixed(end_block, &buf);
+  for (auto offset : block_offsets) {
+    columnar::PutFixed(offset, &buf);
+  }
+  columnar::PutFixed(static_cast<uint64_t>(block_offsets.size()), &buf);
+  columnar::PutFixed(columnar::kMagic, &buf);
+  write_buf();
+  VLOG(0) << "ConvertFile [" << text_file << "] to [" << columnar_file
+          << "], ins num=" << ins_num << ", block num=" << block_offsets.size()
+          << ", bytes=" << written;
+#endif
+  return ins_num;
+}
+
+void SlotRecordColumnarDataFeed::LoadIntoMemory() {
+#ifdef _LINUX
+  uint32_t flags = ColumnarFlags();
+  std::string filename;
+  std::string payload;
+  auto read_exact = [this](void* buf, size_t size) {
+    return fread(buf, 1, size, this->fp_.get()) == size;
+  };
+  while (this->PickOneFile(&filename)) {
+    VLOG(3) << "PickOneFile, filename=" << filename
+            << ", thread_id=" << thread_id_;
+    platform::Timer timeline;
+    timeline.Start();
+    int err_no = 0;
+    this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
+    CHECK(this->fp_ != nullptr);
+    __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
 
-  return (uint64_total_slot_num > 0);
+    columnar::FileHeader header;
+    PADDLE_ENFORCE_EQ(
+        read_exact(&header, sizeof(header)) &&
+            header.magic == columnar::kMagic &&
+            header.version == columnar::kVersion,
+        true,
+        platform::errors::InvalidArgument(
+            "File %s is not a columnar SlotRecord file.", filename));
+    bool same_layout =
+        header.uint64_slot_num ==
+            static_cast<uint32_t>(uint64_use_slot_size_) &&
+        header.float_slot_num == static_cast<uint32_t>(float_use_slot_size_) &&
+        header.flags == flags;
+    PADDLE_ENFORCE_EQ(
+        same_layout,
+        true,
+        platform::errors::InvalidArgument(
+            "File %s was converted with another slot config, uint64 slots "
+            "[%d vs %d], float slots [%d vs %d], flags [%d vs %d].",
+            filename,
+            header.uint64_slot_num,
+            uint64_use_slot_size_,
+            header.float_slot_num,
+            float_use_slot_size_,
+            header.flags,
+            flags));
+
+    uint64_t lines = 0;
+    columnar::BlockHeader block;
+    while (true) {
+      PADDLE_ENFORCE_EQ(read_exact(&block, sizeof(block)),
+                        true,
+                        platform::errors::InvalidArgument(
+                            "File %s is truncated after %d records.",
+                            filename,
+                            lines));
+      if (block.ins_num == 0) {
+        break;
+      }
+      payload.resize(block.payload_size);
+      PADDLE_ENFORCE_EQ(read_exact(&payload[0], block.payload_size),
+                        true,
+                        platform::errors::InvalidArgument(
+                            "File %s is truncated after %d records.",
+                            filename,
+                            lines));
+      std::vector<SlotRecord> record_vec;
+      SlotRecordPool().get(&record_vec, static_cast<int>(block.ins_num));
+      PADDLE_ENFORCE_EQ(columnar::DecodeBlock(payload.data(),
+                                              payload.size(),
+                                              uint64_use_slot_size_,
+                                              float_use_slot_size_,
+                                              flags,
+                                              record_vec.data(),
+                                              block.ins_num),
+                        true,
+                        platform::errors::InvalidArgument(
+                            "File %s has a corrupted block after %d records.",
+                            filename,
+                            lines));
+      lines += block.ins_num;
+      input_channel_->Write(std::move(record_vec));
+    }
+    timeline.Pause();
+    VLOG(3) << "LoadIntoMemory() read all blocks, file=" << filename
+            << ", lines=" << lines << ", cost time=" << timeline.ElapsedSec()
+            << " seconds, thread_id=" << thread_id_;
+  }
+#endif
 }
 
 void SlotRecordInMemoryDataFeed::AssignFeedVar(const Scope& scope) {
@@ -2617,8 +2921,7 @@ void SlotRecordInMemoryDataFeed::PutToFeedVec(const SlotRecord* ins_vec,
       }
       feed->Resize(common::make_ddim(info.local_shape));
     } else {
-      LoD data_lod{slot_offset};
-      feed_vec_[j]->set_lod(data_lod);
+      phi::AssignSingleLevelLoD(slot_offset, feed_vec_[j]->mutable_lod());
     }
   }
 #endif
@@ -2794,6 +3097,7 @@ int SlotRecordInMemoryDataFeed::Next() {
 #endif
   }
 
+  RecordDataFeedBatch(this->batch_size_);
   return this->batch_size_;
 #else
   return 0;
@@ -2861,11 +3165,13 @@ void SlotRecordInMemoryDataFeed::BuildSlotBatchGPU(const int ins_num,
   size_t float_zero_slot_index = 0;
   size_t uint64_zero_slot_index = 0;
 
-  // copy index
-  CUDA_CHECK(cudaMemcpy(offsets.data(),
-                        d_slot_offsets,
-                        slot_total_num * sizeof(size_t),
-                        cudaMemcpyDeviceToHost));
+  // copy index, the only wait of the pack stream for a batch
+  CUDA_CHECK(cudaMemcpyAsync(offsets.data(),
+                             d_slot_offsets,
+                             slot_total_num * sizeof(size_t),
+                             cudaMemcpyDeviceToHost,
+                             pack->get_stream()));
+  CUDA_CHECK(cudaStreamSynchronize(pack->get_stream()));
   auto* dev_ctx = static_cast<phi::GPUContext*>(
       platform::DeviceContextPool::Instance().Get(this->place_));
   for (int j = 0; j < use_slot_size_; ++j) {
@@ -2936,6 +3242,8 @@ void SlotRecordInMemoryDataFeed::BuildSlotBatchGPU(const int ins_num,
                 float_use_slot_size_,
                 used_slot_gpu_types,
                 pack->get_stream());
+  // the stream using the batch waits for the copy in PackToScope
+  pack->record_event();
 }
 
 void SlotRecordInMemoryDataFeed::PackToScope(MiniBatchGpuPack* pack,
@@ -2958,6 +3266,10 @@ void SlotRecordInMemoryDataFeed::PackToScope(MiniBatchGpuPack* pack,
 
   CHECK(feed_vec != nullptr) << "feed_vec nullptr.";
 
+  auto* dev_ctx = static_cast<phi::GPUContext*>(
+      platform::DeviceContextPool::Instance().Get(this->place_));
+  pack->wait_event(dev_ctx->stream());
+
   for (int j = 0; j < use_slot_size_; ++j) {
     auto& feed = (*feed_vec)[j];
     if (feed == nullptr) {
@@ -3058,6 +3370,7 @@ MiniBatchGpuPack::MiniBatchGpuPack(const paddle::platform::Place& place,
     }
   }
   copy_host2device(&gpu_slots_, gpu_used_slots_.data(), gpu_used_slots_.size());
+  CUDA_CHECK(cudaEventCreateWithFlags(&event_, cudaEventDisableTiming));
 
   slot_buf_ptr_ = memory::AllocShared(place_, used_slot_size_ * sizeof(void*));
 
@@ -3069,7 +3382,7 @@ MiniBatchGpuPack::MiniBatchGpuPack(const paddle::platform::Place& place,
   uint64_tensor_vec_.resize(used_slot_size_);
 }
 
-MiniBatchGpuPack::~MiniBatchGpuPack() {}
+MiniBatchGpuPack::~MiniBatchGpuPack() { cudaEventDestroy(event_); }
 
 void MiniBatchGpuPack::reset(const paddle::platform::Place& place) {
   place_ = place;
@@ -3221,6 +3534,8 @@ void MiniBatchGpuPack::pack_float_data(const SlotRecord* ins_vec, int num) {
 }
 
 void MiniBatchGpuPack::pack_instance(const SlotRecord* ins_vec, int num) {
+  // the host buffers may still be copied for the last batch of the pack
+  CUDA_CHECK(cudaEventSynchronize(event_));
   ins_num_ = num;
   batch_ins_ = ins_vec;
   CHECK(used_uint64_num_ > 0 || used_float_num_ > 0);
@@ -3244,7 +3559,6 @@ void MiniBatchGpuPack::transfer_to_gpu() {
   copy_host2device(&value_.d_float_lens, buf_.h_float_lens);
   copy_host2device(&value_.d_float_keys, buf_.h_float_keys);
   copy_host2device(&value_.d_float_offset, buf_.h_float_offset);
-  CUDA_CHECK(cudaStreamSynchronize(stream_));
 }
 #endif
 
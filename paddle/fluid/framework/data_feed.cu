@@ -388,7 +388,6 @@ void SlotRecordInMemoryDataFeed::FillSlotValueOffset(
                                         float_offsets,
                                         float_slot_size,
                                         used_slots);
-  cudaStreamSynchronize(stream);
 }
 
 __global__ void CopyForTensorKernel(const int used_slot_num,
@@ -469,7 +468,6 @@ void SlotRecordInMemoryDataFeed::CopyForTensor(
                                   float_ins_lens,
                                   float_slot_size,
                                   used_slots);
-  cudaStreamSynchronize(stream);
 }
 
 __global__ void GraphFillCVMKernel(int64_t *tensor, int len) {
@@ -1405,13 +1403,25 @@ __global__ void GraphFillFirstStepKernel(int *prefix_sum,
   }
 }
 
-__global__ void get_each_ins_info(uint8_t *slot_list,
-                                  uint32_t *slot_size_list,
-                                  uint32_t *slot_size_prefix,
-                                  uint32_t *each_ins_slot_num,
-                                  uint32_t *each_ins_slot_num_inner_prefix,
-                                  size_t key_num,
-                                  int slot_num) {
+void ReserveGraphBuffer(std::shared_ptr<phi::Allocation> *buf,
+                        size_t bytes,
+                        const paddle::platform::Place &place) {
+  if (*buf == NULL || (*buf)->size() < bytes) {
+    *buf = memory::AllocShared(place, bytes);
+  }
+}
+
+// Count the features of each slot of each instance. The counts are also
+// written slot by slot, so the counts of all the slots are scanned at once.
+__global__ void GraphCountSlotFeaKernel(
+    const uint8_t *slot_list,
+    const uint32_t *slot_size_list,
+    const uint32_t *slot_size_prefix,
+    uint32_t *each_ins_slot_num,
+    uint32_t *each_ins_slot_num_inner_prefix,
+    uint32_t *slot_fea_num,
+    size_t key_num,
+    int slot_num) {
   const size_t i = blockIdx.x * blockDim.y + threadIdx.y;
   if (i < key_num) {
     uint32_t slot_index = slot_size_prefix[i];
@@ -1419,11 +1429,32 @@ __global__ void get_each_ins_info(uint8_t *slot_list,
     for (int j = 0; j < slot_size_list[i]; j++) {
       each_ins_slot_num[each_ins_slot_index + slot_list[slot_index + j]] += 1;
     }
-    each_ins_slot_num_inner_prefix[each_ins_slot_index] = 0;
-    for (int j = 1; j < slot_num; j++) {
-      each_ins_slot_num_inner_prefix[each_ins_slot_index + j] =
-          each_ins_slot_num[each_ins_slot_index + j - 1] +
-          each_ins_slot_num_inner_prefix[each_ins_slot_index + j - 1];
+    uint32_t inner_prefix = 0;
+    for (int j = 0; j < slot_num; j++) {
+      uint32_t num = each_ins_slot_num[each_ins_slot_index + j];
+      each_ins_slot_num_inner_prefix[each_ins_slot_index + j] = inner_prefix;
+      slot_fea_num[j * key_num + i] = num;
+      inner_prefix += num;
+    }
+  }
+}
+
+// The lod of each slot from the scan of the counts of all the slots.
+__global__ void GraphFillSlotLodFusedKernel(const int64_t *slot_fea_prefix,
+                                            int64_t **slot_lod,
+                                            int64_t *each_slot_fea_num,
+                                            size_t key_num) {
+  const size_t i = blockIdx.x * blockDim.y + threadIdx.y;
+  const int slot = blockIdx.y;
+  if (i < key_num) {
+    const int64_t *prefix = slot_fea_prefix + slot * key_num;
+    int64_t base = slot == 0 ? 0 : prefix[-1];
+    slot_lod[slot][i + 1] = prefix[i] - base;
+    if (i == 0) {
+      slot_lod[slot][0] = 0;
+    }
+    if (i == key_num - 1) {
+      each_slot_fea_num[slot] = prefix[i] - base;
     }
   }
 }
@@ -1465,23 +1496,23 @@ __global__ void fill_slot_num(uint32_t *d_each_ins_slot_num_ptr,
     }
   }
 }
-// 可以搞成模板
-__global__ void fill_slot_tensor(uint64_t *feature_list,
-                                 uint32_t *feature_size_prefixsum,
-                                 uint32_t *each_ins_slot_num_inner_prefix,
-                                 uint64_t *ins_slot_num,
-                                 int64_t *slot_lod_tensor,
-                                 int64_t *slot_tensor,
-                                 int slot,
-                                 int slot_num,
-                                 size_t node_num) {
+__global__ void GraphFillSlotTensorFusedKernel(
+    const uint64_t *feature_list,
+    const uint32_t *feature_size_prefixsum,
+    const uint32_t *each_ins_slot_num_inner_prefix,
+    int64_t **slot_lod,
+    int64_t **slot_tensor,
+    int slot_num,
+    size_t key_num) {
   const size_t i = blockIdx.x * blockDim.y + threadIdx.y;
-  if (i < node_num) {
-    size_t dst_index = slot_lod_tensor[i];
+  const int slot = blockIdx.y;
+  if (i < key_num) {
+    int64_t dst_index = slot_lod[slot][i];
+    int64_t num = slot_lod[slot][i + 1] - dst_index;
     size_t src_index = feature_size_prefixsum[i] +
                        each_ins_slot_num_inner_prefix[slot_num * i + slot];
-    for (uint64_t j = 0; j < ins_slot_num[i]; j++) {
-      slot_tensor[dst_index + j] = feature_list[src_index + j];
+    for (int64_t j = 0; j < num; j++) {
+      slot_tensor[slot][dst_index + j] = feature_list[src_index + j];
     }
   }
 }
@@ -1778,142 +1809,134 @@ int GraphDataGenerator::FillSlotFeature(uint64_t *d_walk,
 
   CUDA_CHECK(cudaStreamSynchronize(train_stream_));
 
-  std::shared_ptr<phi::Allocation> d_each_ins_slot_num_inner_prefix =
-      memory::AllocShared(place_, (conf_slot_num * key_num) * sizeof(uint32_t));
-  std::shared_ptr<phi::Allocation> d_each_ins_slot_num =
-      memory::AllocShared(place_, (conf_slot_num * key_num) * sizeof(uint32_t));
+  // The counts, lods and tensors of all the slots are filled by three
+  // kernels and one scan on the persistent buffers, with one copy back of
+  // the feature num of each slot.
+  size_t ins_slot_bytes = conf_slot_num * key_num * sizeof(uint32_t);
+  ReserveGraphBuffer(&d_ins_slot_fea_num_buf_, ins_slot_bytes, place_);
+  ReserveGraphBuffer(&d_ins_slot_inner_prefix_buf_, ins_slot_bytes, place_);
+  ReserveGraphBuffer(&d_slot_fea_num_buf_, ins_slot_bytes, place_);
+  ReserveGraphBuffer(&d_slot_fea_prefix_buf_,
+                     conf_slot_num * key_num * sizeof(int64_t),
+                     place_);
+  ReserveGraphBuffer(&d_slot_lod_ptr_buf_,
+                     slot_num * 3 * sizeof(int64_t),
+                     place_);
   uint32_t *d_each_ins_slot_num_ptr =
-      reinterpret_cast<uint32_t *>(d_each_ins_slot_num->ptr());
+      reinterpret_cast<uint32_t *>(d_ins_slot_fea_num_buf_->ptr());
   uint32_t *d_each_ins_slot_num_inner_prefix_ptr =
-      reinterpret_cast<uint32_t *>(d_each_ins_slot_num_inner_prefix->ptr());
-  CUDA_CHECK(cudaMemsetAsync(d_each_ins_slot_num_ptr,
-                             0,
-                             conf_slot_num * key_num * sizeof(uint32_t),
-                             train_stream_));
+      reinterpret_cast<uint32_t *>(d_ins_slot_inner_prefix_buf_->ptr());
+  uint32_t *d_slot_fea_num_ptr =
+      reinterpret_cast<uint32_t *>(d_slot_fea_num_buf_->ptr());
+  int64_t *d_slot_fea_prefix_ptr =
+      reinterpret_cast<int64_t *>(d_slot_fea_prefix_buf_->ptr());
+  int64_t **d_slot_lod_ptr =
+      reinterpret_cast<int64_t **>(d_slot_lod_ptr_buf_->ptr());
+  int64_t **d_slot_tensor_ptr = d_slot_lod_ptr + slot_num;
+  CUDA_CHECK(cudaMemsetAsync(
+      d_each_ins_slot_num_ptr, 0, ins_slot_bytes, train_stream_));
 
   dim3 grid((key_num - 1) / 256 + 1);
   dim3 block(1, 256);
-  get_each_ins_info<<<grid, block, 0, train_stream_>>>(
+  GraphCountSlotFeaKernel<<<grid, block, 0, train_stream_>>>(
       d_slot_list_ptr,
       d_feature_size_list_ptr,
       d_feature_size_prefixsum_ptr,
       d_each_ins_slot_num_ptr,
       d_each_ins_slot_num_inner_prefix_ptr,
+      d_slot_fea_num_ptr,
       key_num,
       slot_num);
 
-  std::vector<std::shared_ptr<phi::Allocation>> ins_slot_num(slot_num, nullptr);
-  std::vector<uint64_t *> ins_slot_num_vecotr(slot_num, NULL);
-  std::shared_ptr<phi::Allocation> d_ins_slot_num_vector =
-      memory::AllocShared(place_, (slot_num) * sizeof(uint64_t *));
-  uint64_t **d_ins_slot_num_vector_ptr =
-      reinterpret_cast<uint64_t **>(d_ins_slot_num_vector->ptr());
-
-  int ii = 0;
-  for (int i = 0; i < conf_slot_num; i++) {
-    if ((*feed_info_)[feed_vec_idx + 2 * i].type[0] == 'u') {
-      ins_slot_num[ii] =
-          memory::AllocShared(place_, key_num * sizeof(uint64_t));
-      ins_slot_num_vecotr[ii] =
-          reinterpret_cast<uint64_t *>(ins_slot_num[ii]->ptr());
-      ii++;
-    }
-  }
   if (slot_num > 0) {
-    CUDA_CHECK(
-        cudaMemcpyAsync(reinterpret_cast<char *>(d_ins_slot_num_vector_ptr),
-                        ins_slot_num_vecotr.data(),
-                        sizeof(uint64_t *) * slot_num,
-                        cudaMemcpyHostToDevice,
-                        train_stream_));
-    fill_slot_num<<<grid, block, 0, train_stream_>>>(
-        d_each_ins_slot_num_ptr, d_ins_slot_num_vector_ptr, key_num, slot_num);
-    CUDA_CHECK(cudaStreamSynchronize(train_stream_));
-
-    ii = 0;
+    std::vector<int64_t *> h_slot_ptr(slot_num * 2, nullptr);
+    int ii = 0;
     for (int i = 0; i < conf_slot_num; ++i) {
       if ((*feed_info_)[feed_vec_idx + 2 * i].type[0] == 'u') {
         slot_lod_tensor_ptr_[ii] =
             feed_vec_[feed_vec_idx + 2 * i + 1]->mutable_data<int64_t>(
                 {(long)key_num + 1}, this->place_);  // NOLINT
+        h_slot_ptr[ii] = slot_lod_tensor_ptr_[ii];
         ii++;
       }
     }
+    // the feature num of each slot, behind the tensor pointers
+    int64_t *d_each_slot_fea_num =
+        reinterpret_cast<int64_t *>(d_slot_tensor_ptr + slot_num);
+    CUDA_CHECK(cudaMemcpyAsync(d_slot_lod_ptr,
+                               h_slot_ptr.data(),
+                               sizeof(int64_t *) * slot_num,
+                               cudaMemcpyHostToDevice,
+                               train_stream_));
 
+    // one scan over the counts of all the slots, slot after slot
+    size_t scan_len = static_cast<size_t>(slot_num) * key_num;
     size_t temp_storage_bytes = 0;
     CUDA_CHECK(cub::DeviceScan::InclusiveSum(NULL,
                                              temp_storage_bytes,
-                                             ins_slot_num_vecotr[0],
-                                             slot_lod_tensor_ptr_[0] + 1,
-                                             key_num,
+                                             d_slot_fea_num_ptr,
+                                             d_slot_fea_prefix_ptr,
+                                             scan_len,
                                              train_stream_));
-    CUDA_CHECK(cudaStreamSynchronize(train_stream_));
-
-    auto d_temp_storage = memory::Alloc(
-        this->place_,
-        temp_storage_bytes,
-        phi::Stream(reinterpret_cast<phi::StreamId>(train_stream_)));
+    ReserveGraphBuffer(&d_slot_scan_temp_buf_, temp_storage_bytes, place_);
+    CUDA_CHECK(cub::DeviceScan::InclusiveSum(d_slot_scan_temp_buf_->ptr(),
+                                             temp_storage_bytes,
+                                             d_slot_fea_num_ptr,
+                                             d_slot_fea_prefix_ptr,
+                                             scan_len,
+                                             train_stream_));
+    dim3 lod_grid((key_num - 1) / 256 + 1, slot_num);
+    GraphFillSlotLodFusedKernel<<<lod_grid, block, 0, train_stream_>>>(
+        d_slot_fea_prefix_ptr,
+        d_slot_lod_ptr,
+        d_each_slot_fea_num,
+        key_num);
 
-    ii = 0;
     std::vector<int64_t> each_slot_fea_num(slot_num, 0);
-    for (int i = 0; i < conf_slot_num; ++i) {
-      if ((*feed_info_)[feed_vec_idx + 2 * i].type[0] == 'u') {
-        CUDA_CHECK(cudaMemsetAsync(
-            slot_lod_tensor_ptr_[ii], 0, sizeof(uint64_t), train_stream_));
-        CUDA_CHECK(cub::DeviceScan::InclusiveSum(d_temp_storage->ptr(),
-                                                 temp_storage_bytes,
-                                                 ins_slot_num_vecotr[ii],
-                                                 slot_lod_tensor_ptr_[ii] + 1,
-                                                 key_num,
-                                                 train_stream_));
-        CUDA_CHECK(cudaMemcpyAsync(&each_slot_fea_num[ii],
-                                   slot_lod_tensor_ptr_[ii] + key_num,
-                                   sizeof(uint64_t),
-                                   cudaMemcpyDeviceToHost,
-                                   train_stream_));
-        ii++;
-      }
-    }
+    CUDA_CHECK(cudaMemcpyAsync(each_slot_fea_num.data(),
+                               d_each_slot_fea_num,
+                               sizeof(int64_t) * slot_num,
+                               cudaMemcpyDeviceToHost,
+                               train_stream_));
     CUDA_CHECK(cudaStreamSynchronize(train_stream_));
+
     ii = 0;
     for (int i = 0; i < conf_slot_num; ++i) {
       if ((*feed_info_)[feed_vec_idx + 2 * i].type[0] == 'u') {
+        // trick for empty tensor
         slot_tensor_ptr_[ii] =
             feed_vec_[feed_vec_idx + 2 * i]->mutable_data<int64_t>(
-                {each_slot_fea_num[ii], 1}, this->place_);
+                {std::max<int64_t>(each_slot_fea_num[ii], 1), 1},
+                this->place_);
+        h_slot_ptr[slot_num + ii] = slot_tensor_ptr_[ii];
         ii++;
       }
     }
-    ii = 0;
-    int64_t default_lod = 1;
-    for (int i = 0; i < conf_slot_num; ++i) {
-      if ((*feed_info_)[feed_vec_idx + 2 * i].type[0] == 'u') {
-        fill_slot_tensor<<<grid, block, 0, train_stream_>>>(
-            d_feature_list_ptr,
-            d_feature_size_prefixsum_ptr,
-            d_each_ins_slot_num_inner_prefix_ptr,
-            ins_slot_num_vecotr[ii],
-            slot_lod_tensor_ptr_[ii],
-            slot_tensor_ptr_[ii],
-            ii,
-            slot_num,
-            key_num);
+    CUDA_CHECK(cudaMemcpyAsync(d_slot_tensor_ptr,
+                               h_slot_ptr.data() + slot_num,
+                               sizeof(int64_t *) * slot_num,
+                               cudaMemcpyHostToDevice,
+                               train_stream_));
+    GraphFillSlotTensorFusedKernel<<<lod_grid, block, 0, train_stream_>>>(
+        d_feature_list_ptr,
+        d_feature_size_prefixsum_ptr,
+        d_each_ins_slot_num_inner_prefix_ptr,
+        d_slot_lod_ptr,
+        d_slot_tensor_ptr,
+        slot_num,
+        key_num);
 
-        // trick for empty tensor
-        if (each_slot_fea_num[ii] == 0) {
-          slot_tensor_ptr_[ii] =
-              feed_vec_[feed_vec_idx + 2 * i]->mutable_data<int64_t>(
-                  {1, 1}, this->place_);
-          CUDA_CHECK(cudaMemsetAsync(
-              slot_tensor_ptr_[ii], 0, sizeof(uint64_t), train_stream_));
-          CUDA_CHECK(cudaMemcpyAsync(
-              reinterpret_cast<char *>(slot_lod_tensor_ptr_[ii] + key_num),
-              &default_lod,
-              sizeof(int64_t),
-              cudaMemcpyHostToDevice,
-              train_stream_));
-        }
-        ii++;
+    int64_t default_lod = 1;
+    for (int i = 0; i < slot_num; ++i) {
+      if (each_slot_fea_num[i] == 0) {
+        CUDA_CHECK(cudaMemsetAsync(
+            slot_tensor_ptr_[i], 0, sizeof(uint64_t), train_stream_));
+        CUDA_CHECK(cudaMemcpyAsync(
+            reinterpret_cast<char *>(slot_lod_tensor_ptr_[i] + key_num),
+            &default_lod,
+            sizeof(int64_t),
+            cudaMemcpyHostToDevice,
+            train_stream_));
       }
     }
     CUDA_CHECK(cudaStreamSynchronize(train_stream_));
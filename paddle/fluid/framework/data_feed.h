@@ -41,6 +41,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/reader.h"
 #include "paddle/fluid/framework/variable.h"
 #include "paddle/fluid/platform/timer.h"
+#include "paddle/phi/core/metrics.h"
 #include "paddle/utils/string/string_helper.h"
 #if defined(PADDLE_WITH_CUDA)
 #include "paddle/fluid/framework/fleet/heter_ps/gpu_graph_utils.h"
@@ -110,6 +111,11 @@ struct SlotValues {
     (*size) = slot_offsets[idx + 1] - offset;
     return &slot_values[offset];
   }
+  const T* get_values(int idx, size_t* size) const {
+    uint32_t offset = slot_offsets[idx];
+    (*size) = slot_offsets[idx + 1] - offset;
+    return slot_values.data() + offset;
+  }
   void add_slot_feasigns(const std::vector<std::vector<T>>& slot_feasigns,
                          uint32_t fea_num) {
     slot_values.reserve(fea_num);
@@ -603,6 +609,13 @@ class MiniBatchGpuPack {
 
   cudaStream_t get_stream() { return stream_; }
 
+  // The copies of a batch are only ordered on the stream of the pack, the
+  // stream training on the batch waits for them by the event.
+  void record_event() { CUDA_CHECK(cudaEventRecord(event_, stream_)); }
+  void wait_event(cudaStream_t stream) {
+    CUDA_CHECK(cudaStreamWaitEvent(stream, event_, 0));
+  }
+
  private:
   void transfer_to_gpu(void);
   void pack_all_data(const SlotRecord* ins_vec, int num);
@@ -629,6 +642,7 @@ class MiniBatchGpuPack {
   paddle::platform::Place place_;
   std::unique_ptr<phi::CUDAStream> stream_holder_;
   cudaStream_t stream_;
+  cudaEvent_t event_;
   BatchGPUValue value_;
   BatchCPUValue buf_;
   int ins_num_ = 0;
@@ -1088,6 +1102,13 @@ class GraphDataGenerator {
   std::vector<std::shared_ptr<phi::Allocation>> d_ins_buf_;
   std::shared_ptr<phi::Allocation> d_feature_size_list_buf_;
   std::shared_ptr<phi::Allocation> d_feature_size_prefixsum_buf_;
+  // persistent buffers of the fused slot feature fill
+  std::shared_ptr<phi::Allocation> d_ins_slot_fea_num_buf_;
+  std::shared_ptr<phi::Allocation> d_ins_slot_inner_prefix_buf_;
+  std::shared_ptr<phi::Allocation> d_slot_fea_num_buf_;
+  std::shared_ptr<phi::Allocation> d_slot_fea_prefix_buf_;
+  std::shared_ptr<phi::Allocation> d_slot_lod_ptr_buf_;
+  std::shared_ptr<phi::Allocation> d_slot_scan_temp_buf_;
   std::vector<std::shared_ptr<phi::Allocation>> d_pair_num_;
   std::shared_ptr<phi::Allocation> d_slot_tensor_ptr_;
   std::shared_ptr<phi::Allocation> d_slot_lod_tensor_ptr_;
@@ -1187,6 +1208,11 @@ class DataFeed {
   // This function will do nothing at default
   virtual void SetConsumeChannel(void* channel UNUSED) {}
   // This function will do nothing at default
+  virtual void SetStealChannels(const std::vector<void*>& channels UNUSED) {}
+  // instances taken from other readers' output channels, see
+  // FLAGS_enable_reader_work_stealing
+  virtual int64_t GetStolenInsNum() { return 0; }
+  // This function will do nothing at default
   virtual void SetThreadId(int thread_id UNUSED) {}
   // This function will do nothing at default
   virtual void SetThreadNum(int thread_num UNUSED) {}
@@ -1469,6 +1495,8 @@ class InMemoryDataFeed : public DataFeed {
   virtual void SetInputChannel(void* channel);
   virtual void SetOutputChannel(void* channel);
   virtual void SetConsumeChannel(void* channel);
+  void SetStealChannels(const std::vector<void*>& channels) override;
+  int64_t GetStolenInsNum() override { return stolen_ins_num_; }
   virtual void SetThreadId(int thread_id);
   virtual void SetThreadNum(int thread_num);
   virtual void SetParseInsId(bool parse_ins_id);
@@ -1518,6 +1546,11 @@ class InMemoryDataFeed : public DataFeed {
   paddle::framework::ChannelObject<T>* input_channel_;
   paddle::framework::ChannelObject<T>* output_channel_;
   paddle::framework::ChannelObject<T>* consume_channel_;
+  // output channels of all readers, read from once output_channel_ is empty
+  std::vector<paddle::framework::ChannelObject<T>*> steal_channels_;
+  int64_t stolen_ins_num_ = 0;
+  // the size of output_channel_ seen by the last Next
+  phi::MetricGauge* channel_size_metric_ = nullptr;
 
   paddle::framework::ChannelObject<PvInstance>* input_pv_channel_;
   paddle::framework::ChannelObject<PvInstance>* output_pv_channel_;
@@ -1917,6 +1950,8 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
     input_channel_ = static_cast<ChannelObject<SlotRecord>*>(channel);
   }
   bool ParseOneInstance(const std::string& line, SlotRecord* rec);
+  // str must be '\0' terminated at len
+  bool ParseOneInstance(const char* str, size_t len, SlotRecord* rec);
   void PutToFeedVec(const SlotRecord* ins_vec, int num) override;
   void AssignFeedVar(const Scope& scope) override;
   std::vector<std::string> GetInputVarNames() override {
@@ -2004,6 +2039,23 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
 #endif
 };
 
+// Reads SlotRecord files in the columnar binary layout of
+// data_feed_columnar.h, the records are filled block by block without any
+// text parsing. ConvertFile builds such a file from one text file in the
+// format SlotRecordInMemoryDataFeed reads, with the same used slots.
+class SlotRecordColumnarDataFeed : public SlotRecordInMemoryDataFeed {
+ public:
+  SlotRecordColumnarDataFeed() = default;
+  virtual ~SlotRecordColumnarDataFeed() {}
+  void LoadIntoMemory() override;
+  // returns the number of records written
+  int64_t ConvertFile(const std::string& text_file,
+                      const std::string& columnar_file);
+
+ protected:
+  uint32_t ColumnarFlags() const;
+};
+
 class PaddleBoxDataFeed : public MultiSlotInMemoryDataFeed {
  public:
   PaddleBoxDataFeed() {}
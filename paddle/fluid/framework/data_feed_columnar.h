@@ -0,0 +1,354 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/data_feed.h"
+
+namespace paddle {
+namespace framework {
+
+// Columnar binary layout of SlotRecord files, written by
+// SlotRecordColumnarDataFeed::ConvertFile and read back without any text
+// parsing. All integers are little endian.
+//
+//   file   := header block* end_block index
+//   header := magic:u32 version:u32 uint64_slot_num:u32 float_slot_num:u32
+//             flags:u32
+//   block  := ins_num:u32 payload_size:u32 payload
+//   end_block := 0:u32 0:u32
+//   index  := block_offset:u64 * block_num, block_num:u64, magic:u32
+//
+// A payload stores every column of ins_num records one after another:
+//   ins_id column (flags & kWithInsId): varint size + bytes per record
+//   logkey column (flags & kWithLogKey): search_id:u64 cmatch:varint
+//                                        rank:varint per record
+//   per uint64 slot: encoding:u8, varint length per record, then the
+//     values, either raw u64 or zigzag varint deltas restarting at every
+//     record, whichever the encoder found smaller for the block
+//   per float slot: varint length per record, then raw floats
+// The index lets tools split a file on block boundaries, readers stream the
+// blocks and stop at the end block.
+namespace columnar {
+
+static const uint32_t kMagic = 0x4c4f4350;  // "PCOL"
+static const uint32_t kVersion = 1;
+static const uint32_t kWithInsId = 1;
+static const uint32_t kWithLogKey = 2;
+static const uint8_t kRawEncoding = 0;
+static const uint8_t kDeltaEncoding = 1;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t uint64_slot_num;
+  uint32_t float_slot_num;
+  uint32_t flags;
+};
+
+struct BlockHeader {
+  uint32_t ins_num;
+  uint32_t payload_size;
+};
+
+inline void PutVarint(uint64_t v, std::string* out) {
+  while (v >= 0x80) {
+    out->push_back(static_cast<char>(v | 0x80));
+    v >>= 7;
+  }
+  out->push_back(static_cast<char>(v));
+}
+
+inline size_t VarintSize(uint64_t v) {
+  size_t size = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+inline bool GetVarint(const char** ptr, const char* end, uint64_t* v) {
+  uint64_t result = 0;
+  for (int shift = 0; shift <= 63 && *ptr < end; shift += 7) {
+    uint64_t byte = static_cast<uint8_t>(**ptr);
+    ++(*ptr);
+    result |= (byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *v = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+inline uint64_t ZigZag(uint64_t delta) {
+  return (delta << 1) ^
+         static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+}
+
+inline uint64_t UnZigZag(uint64_t v) { return (v >> 1) ^ (~(v & 1) + 1); }
+
+template <typename T>
+inline void PutFixed(const T& v, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+inline bool GetFixed(const char** ptr, const char* end, T* v) {
+  if (end - *ptr < static_cast<std::ptrdiff_t>(sizeof(T))) {
+    return false;
+  }
+  memcpy(v, *ptr, sizeof(T));
+  *ptr += sizeof(T);
+  return true;
+}
+
+// Collects records column by column and serializes them as one block.
+class BlockEncoder {
+ public:
+  BlockEncoder(int uint64_slot_num, int float_slot_num, uint32_t flags)
+      : flags_(flags),
+        uint64_lens_(uint64_slot_num),
+        uint64_values_(uint64_slot_num),
+        float_lens_(float_slot_num),
+        float_values_(float_slot_num) {}
+
+  void Add(const SlotRecordObject& rec) {
+    if (flags_ & kWithInsId) {
+      PutVarint(rec.ins_id_.size(), &ins_id_);
+      ins_id_.append(rec.ins_id_);
+    }
+    if (flags_ & kWithLogKey) {
+      PutFixed(rec.search_id, &logkey_);
+      PutVarint(rec.cmatch, &logkey_);
+      PutVarint(rec.rank, &logkey_);
+    }
+    const auto& uint64_feas = rec.slot_uint64_feasigns_;
+    for (size_t i = 0; i < uint64_values_.size(); ++i) {
+      size_t num = 0;
+      const uint64_t* values = nullptr;
+      if (i + 1 < uint64_feas.slot_offsets.size()) {
+        values = uint64_feas.get_values(static_cast<int>(i), &num);
+      }
+      uint64_lens_[i].push_back(static_cast<uint32_t>(num));
+      uint64_values_[i].insert(uint64_values_[i].end(), values, values + num);
+    }
+    const auto& float_feas = rec.slot_float_feasigns_;
+    for (size_t i = 0; i < float_values_.size(); ++i) {
+      size_t num = 0;
+      const float* values = nullptr;
+      if (i + 1 < float_feas.slot_offsets.size()) {
+        values = float_feas.get_values(static_cast<int>(i), &num);
+      }
+      float_lens_[i].push_back(static_cast<uint32_t>(num));
+      float_values_[i].insert(float_values_[i].end(), values, values + num);
+    }
+    ++ins_num_;
+  }
+
+  uint32_t InsNum() const { return ins_num_; }
+
+  // appends block header and payload to out and starts a new block
+  void Flush(std::string* out) {
+    std::string payload;
+    payload.append(ins_id_);
+    payload.append(logkey_);
+    for (size_t i = 0; i < uint64_values_.size(); ++i) {
+      EncodeUint64Column(uint64_lens_[i], uint64_values_[i], &payload);
+    }
+    for (size_t i = 0; i < float_values_.size(); ++i) {
+      for (auto len : float_lens_[i]) {
+        PutVarint(len, &payload);
+      }
+      payload.append(reinterpret_cast<const char*>(float_values_[i].data()),
+                     float_values_[i].size() * sizeof(float));
+    }
+    BlockHeader header = {ins_num_, static_cast<uint32_t>(payload.size())};
+    PutFixed(header, out);
+    out->append(payload);
+    Reset();
+  }
+
+ private:
+  static void EncodeUint64Column(const std::vector<uint32_t>& lens,
+                                 const std::vector<uint64_t>& values,
+                                 std::string* out) {
+    // feasigns are mostly hashes, deltas only pay off for sorted or small ids
+    size_t delta_size = 0;
+    size_t pos = 0;
+    for (auto len : lens) {
+      uint64_t prev = 0;
+      for (uint32_t j = 0; j < len; ++j, ++pos) {
+        delta_size += VarintSize(ZigZag(values[pos] - prev));
+        prev = values[pos];
+      }
+    }
+    uint8_t encoding = delta_size < values.size() * sizeof(uint64_t)
+                           ? kDeltaEncoding
+                           : kRawEncoding;
+    out->push_back(static_cast<char>(encoding));
+    for (auto len : lens) {
+      PutVarint(len, out);
+    }
+    if (encoding == kRawEncoding) {
+      out->append(reinterpret_cast<const char*>(values.data()),
+                  values.size() * sizeof(uint64_t));
+      return;
+    }
+    pos = 0;
+    for (auto len : lens) {
+      uint64_t prev = 0;
+      for (uint32_t j = 0; j < len; ++j, ++pos) {
+        PutVarint(ZigZag(values[pos] - prev), out);
+        prev = values[pos];
+      }
+    }
+  }
+
+  void Reset() {
+    ins_num_ = 0;
+    ins_id_.clear();
+    logkey_.clear();
+    for (auto& lens : uint64_lens_) lens.clear();
+    for (auto& values : uint64_values_) values.clear();
+    for (auto& lens : float_lens_) lens.clear();
+    for (auto& values : float_values_) values.clear();
+  }
+
+  uint32_t flags_;
+  uint32_t ins_num_ = 0;
+  std::string ins_id_;
+  std::string logkey_;
+  std::vector<std::vector<uint32_t>> uint64_lens_;
+  std::vector<std::vector<uint64_t>> uint64_values_;
+  std::vector<std::vector<uint32_t>> float_lens_;
+  std::vector<std::vector<float>> float_values_;
+};
+
+// Fills ins_num reset records from one block payload, returns false when
+// the payload is truncated or does not match the slot layout.
+inline bool DecodeBlock(const char* payload,
+                        size_t payload_size,
+                        int uint64_slot_num,
+                        int float_slot_num,
+                        uint32_t flags,
+                        SlotRecord* recs,
+                        uint32_t ins_num) {
+  const char* ptr = payload;
+  const char* end = payload + payload_size;
+  uint64_t v = 0;
+  if (flags & kWithInsId) {
+    for (uint32_t i = 0; i < ins_num; ++i) {
+      if (!GetVarint(&ptr, end, &v) || static_cast<uint64_t>(end - ptr) < v) {
+        return false;
+      }
+      recs[i]->ins_id_.assign(ptr, v);
+      ptr += v;
+    }
+  }
+  if (flags & kWithLogKey) {
+    for (uint32_t i = 0; i < ins_num; ++i) {
+      uint64_t cmatch = 0, rank = 0;
+      if (!GetFixed(&ptr, end, &recs[i]->search_id) ||
+          !GetVarint(&ptr, end, &cmatch) || !GetVarint(&ptr, end, &rank)) {
+        return false;
+      }
+      recs[i]->cmatch = static_cast<uint32_t>(cmatch);
+      recs[i]->rank = static_cast<uint32_t>(rank);
+    }
+  }
+  for (uint32_t i = 0; i < ins_num; ++i) {
+    auto& uint64_feas = recs[i]->slot_uint64_feasigns_;
+    uint64_feas.slot_offsets.resize(uint64_slot_num + 1);
+    uint64_feas.slot_offsets[0] =
+        static_cast<uint32_t>(uint64_feas.slot_values.size());
+    auto& float_feas = recs[i]->slot_float_feasigns_;
+    float_feas.slot_offsets.resize(float_slot_num + 1);
+    float_feas.slot_offsets[0] =
+        static_cast<uint32_t>(float_feas.slot_values.size());
+  }
+  thread_local std::vector<uint32_t> lens;
+  lens.resize(ins_num);
+  for (int s = 0; s < uint64_slot_num; ++s) {
+    uint8_t encoding = 0;
+    if (!GetFixed(&ptr, end, &encoding)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < ins_num; ++i) {
+      if (!GetVarint(&ptr, end, &v)) {
+        return false;
+      }
+      lens[i] = static_cast<uint32_t>(v);
+    }
+    for (uint32_t i = 0; i < ins_num; ++i) {
+      auto& feas = recs[i]->slot_uint64_feasigns_;
+      if (encoding == kRawEncoding) {
+        size_t bytes = lens[i] * sizeof(uint64_t);
+        if (static_cast<size_t>(end - ptr) < bytes) {
+          return false;
+        }
+        if (bytes > 0) {
+          size_t old_size = feas.slot_values.size();
+          feas.slot_values.resize(old_size + lens[i]);
+          memcpy(feas.slot_values.data() + old_size, ptr, bytes);
+          ptr += bytes;
+        }
+      } else {
+        uint64_t prev = 0;
+        for (uint32_t j = 0; j < lens[i]; ++j) {
+          if (!GetVarint(&ptr, end, &v)) {
+            return false;
+          }
+          prev += UnZigZag(v);
+          feas.slot_values.push_back(prev);
+        }
+      }
+      feas.slot_offsets[s + 1] = static_cast<uint32_t>(feas.slot_values.size());
+    }
+  }
+  for (int s = 0; s < float_slot_num; ++s) {
+    for (uint32_t i = 0; i < ins_num; ++i) {
+      if (!GetVarint(&ptr, end, &v)) {
+        return false;
+      }
+      lens[i] = static_cast<uint32_t>(v);
+    }
+    for (uint32_t i = 0; i < ins_num; ++i) {
+      auto& feas = recs[i]->slot_float_feasigns_;
+      size_t bytes = lens[i] * sizeof(float);
+      if (static_cast<size_t>(end - ptr) < bytes) {
+        return false;
+      }
+      if (bytes > 0) {
+        size_t old_size = feas.slot_values.size();
+        feas.slot_values.resize(old_size + lens[i]);
+        memcpy(feas.slot_values.data() + old_size, ptr, bytes);
+        ptr += bytes;
+      }
+      feas.slot_offsets[s + 1] = static_cast<uint32_t>(feas.slot_values.size());
+    }
+  }
+  return ptr == end;
+}
+
+}  // namespace columnar
+}  // namespace framework
+}  // namespace paddle
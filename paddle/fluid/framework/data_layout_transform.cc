@@ -16,6 +16,7 @@
 #include "paddle/fluid/framework/op_kernel_type.h"
 
 #include "paddle/phi/core/utils/data_type.h"
+#include "paddle/phi/kernels/funcs/cpu_batch_transpose.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace paddle {
@@ -42,9 +43,14 @@ void CastDataLayout::apply() {
   auto place = ctx_->GetPlace();
 
   if (platform::is_cpu_place(place)) {
-    phi::funcs::Transpose<phi::CPUContext, T, 4> trans4;
-    auto* context = static_cast<const phi::CPUContext*>(ctx_);
-    trans4(*context, in_, out_, axis_);
+    // GetAxis only gives NCHW to NHWC and NHWC to NCHW, which transpose
+    // C x HW and HW x C of each batch
+    auto dims = in_.dims();
+    bool to_nhwc = axis_[1] == 2;
+    int64_t rows = to_nhwc ? dims[1] : dims[1] * dims[2];
+    int64_t cols = to_nhwc ? dims[2] * dims[3] : dims[3];
+    phi::funcs::CPUBatchTranspose(
+        in_.data<T>(), dims[0], rows, cols, out_->data<T>());
   } else {
     PADDLE_THROW(platform::errors::PreconditionNotMet(
         "Unsupported data layout cast from CPU to GPU."));
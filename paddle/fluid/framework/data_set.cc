@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/framework/data_set.h"
 
+#include <deque>
+
 #include "google/protobuf/text_format.h"
 #if (defined PADDLE_WITH_DISTRIBUTE) && (defined PADDLE_WITH_PSCORE)
 #include "paddle/fluid/distributed/index_dataset/index_sampler.h"
@@ -42,6 +44,7 @@ COMMON_DECLARE_bool(graph_get_neighbor_id);
 COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_string(graph_edges_split_mode);
 COMMON_DECLARE_bool(query_dest_rank_by_multi_node);
+COMMON_DECLARE_int32(global_shuffle_max_inflight_batches);
 
 namespace paddle {
 namespace framework {
@@ -559,6 +562,7 @@ void DatasetImpl<T>::LoadIntoMemory() {
             << "]";
 #endif
   } else {
+    fs_prefetch_read(filelist_, data_feed_desc_.pipe_command());
     std::vector<std::thread> load_threads;
     for (int64_t i = 0; i < thread_num_; ++i) {
       load_threads.emplace_back(&paddle::framework::DataFeed::LoadIntoMemory,
@@ -581,6 +585,7 @@ void DatasetImpl<T>::LoadIntoMemory() {
 template <typename T>
 void DatasetImpl<T>::PreLoadIntoMemory() {
   VLOG(3) << "DatasetImpl<T>::PreLoadIntoMemory() begin";
+  fs_prefetch_read(filelist_, data_feed_desc_.pipe_command());
   if (preload_thread_num_ != 0) {
     CHECK(static_cast<size_t>(preload_thread_num_) == preload_readers_.size());
     preload_threads_.clear();
@@ -867,51 +872,101 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
     }
   };
 
-  auto global_shuffle_func = [this, get_client_id]() {
+  // sent bytes, records and summed send latency per destination trainer
+  struct PeerShuffleStat {
+    uint64_t bytes = 0;
+    uint64_t records = 0;
+    uint64_t msgs = 0;
+    double latency_sec = 0;
+  };
+  std::mutex peer_stat_mutex;
+  std::vector<PeerShuffleStat> peer_stats(trainer_num_);
+
+  auto global_shuffle_func =
+      [this, get_client_id, &peer_stat_mutex, &peer_stats]() {
 #ifdef PADDLE_WITH_PSCORE
-    auto fleet_ptr = distributed::FleetWrapper::GetInstance();
+        auto fleet_ptr = distributed::FleetWrapper::GetInstance();
 #else
-    auto fleet_ptr = framework::FleetWrapper::GetInstance();
+        auto fleet_ptr = framework::FleetWrapper::GetInstance();
 #endif
-    // auto fleet_ptr = framework::FleetWrapper::GetInstance();
-    std::vector<Record> data;
-    while (this->input_channel_->Read(data)) {
-      std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
-      for (auto& t : data) {
-        auto client_id = get_client_id(t);
-        ars[client_id] << t;
-      }
-      std::vector<std::future<int32_t>> total_status;
-      std::vector<int> send_index(this->trainer_num_);
-      for (int i = 0; i < this->trainer_num_; ++i) {
-        send_index[i] = i;
-      }
-      std::shuffle(
-          send_index.begin(), send_index.end(), fleet_ptr->LocalRandomEngine());
-      for (int index = 0; index < this->trainer_num_; ++index) {
-        int i = send_index[index];
-        if (ars[i].Length() == 0) {
-          continue;
+        // sends of one batch, the next batches are serialized while these
+        // are in flight
+        struct InflightBatch {
+          std::vector<std::future<int32_t>> status;
+          std::vector<int> peers;
+          platform::Timer timer;
+        };
+        std::deque<InflightBatch> inflight;
+        std::vector<PeerShuffleStat> local_stats(this->trainer_num_);
+        size_t max_inflight = static_cast<size_t>(
+            std::max(FLAGS_global_shuffle_max_inflight_batches, 1));
+        auto finish_oldest = [&inflight, &local_stats]() {
+          InflightBatch& batch = inflight.front();
+          for (auto& t : batch.status) {
+            t.wait();
+          }
+          batch.timer.Pause();
+          for (int peer : batch.peers) {
+            local_stats[peer].latency_sec += batch.timer.ElapsedSec();
+          }
+          inflight.pop_front();
+        };
+
+        std::vector<Record> data;
+        std::vector<paddle::framework::BinaryArchive> ars(this->trainer_num_);
+        std::vector<uint64_t> records(this->trainer_num_);
+        std::vector<int> send_index(this->trainer_num_);
+        for (int i = 0; i < this->trainer_num_; ++i) {
+          send_index[i] = i;
         }
-        std::string msg(ars[i].Buffer(), ars[i].Length());
-        auto ret = fleet_ptr->SendClientToClientMsg(0, i, msg);
-        total_status.push_back(std::move(ret));
-      }
-      for (auto& t : total_status) {
-        t.wait();
-      }
-      ars.clear();
-      ars.shrink_to_fit();
-      data.clear();
-      data.shrink_to_fit();
-      // currently we find bottleneck is server not able to handle large data
-      // in time, so we can remove this sleep and set fleet_send_batch_size to
-      // 1024, and set server thread to 24.
-      if (fleet_send_sleep_seconds_ != 0) {
-        sleep(this->fleet_send_sleep_seconds_);
-      }
-    }
-  };
+        while (this->input_channel_->Read(data)) {
+          for (auto& t : data) {
+            auto client_id = get_client_id(t);
+            ars[client_id] << t;
+            ++records[client_id];
+          }
+          if (inflight.size() >= max_inflight) {
+            finish_oldest();
+          }
+          inflight.emplace_back();
+          InflightBatch& batch = inflight.back();
+          batch.timer.Start();
+          std::shuffle(send_index.begin(),
+                       send_index.end(),
+                       fleet_ptr->LocalRandomEngine());
+          for (int index = 0; index < this->trainer_num_; ++index) {
+            int i = send_index[index];
+            if (ars[i].Length() == 0) {
+              continue;
+            }
+            std::string msg(ars[i].Buffer(), ars[i].Length());
+            local_stats[i].bytes += msg.size();
+            local_stats[i].records += records[i];
+            ++local_stats[i].msgs;
+            batch.status.push_back(fleet_ptr->SendClientToClientMsg(0, i, msg));
+            batch.peers.push_back(i);
+            ars[i].Clear();
+            records[i] = 0;
+          }
+          data.clear();
+          // currently we find bottleneck is server not able to handle large
+          // data in time, so we can remove this sleep and set
+          // fleet_send_batch_size to 1024, and set server thread to 24.
+          if (fleet_send_sleep_seconds_ != 0) {
+            sleep(this->fleet_send_sleep_seconds_);
+          }
+        }
+        while (!inflight.empty()) {
+          finish_oldest();
+        }
+        std::lock_guard<std::mutex> lock(peer_stat_mutex);
+        for (int i = 0; i < this->trainer_num_; ++i) {
+          peer_stats[i].bytes += local_stats[i].bytes;
+          peer_stats[i].records += local_stats[i].records;
+          peer_stats[i].msgs += local_stats[i].msgs;
+          peer_stats[i].latency_sec += local_stats[i].latency_sec;
+        }
+      };
 
   std::vector<std::thread> global_shuffle_threads;
   if (thread_num == -1) {
@@ -928,6 +983,16 @@ void MultiSlotDataset::GlobalShuffle(int thread_num) {
   global_shuffle_threads.shrink_to_fit();
   input_channel_->Clear();
   timeline.Pause();
+  double cost = std::max(timeline.ElapsedSec(), 1e-6);
+  for (int i = 0; i < trainer_num_; ++i) {
+    const PeerShuffleStat& stat = peer_stats[i];
+    VLOG(1) << "GlobalShuffle to trainer " << i << ": records=" << stat.records
+            << ", msgs=" << stat.msgs << ", MB=" << stat.bytes / 1048576.0
+            << ", MB/s=" << stat.bytes / 1048576.0 / cost
+            << ", avg batch latency="
+            << (stat.msgs == 0 ? 0 : stat.latency_sec / stat.msgs)
+            << " seconds";
+  }
   VLOG(3) << "DatasetImpl<T>::GlobalShuffle() end, cost time="
           << timeline.ElapsedSec() << " seconds";
 }
@@ -1129,6 +1194,17 @@ void DatasetImpl<T>::CreateReaders() {
       channel_idx = 0;
     }
   }
+  if (multi_output_channel_.size() > 1) {
+    std::vector<void*> steal_channels;
+    for (size_t i = 0; i < multi_output_channel_.size(); ++i) {
+      steal_channels.push_back(cur_channel_ == 0
+                                   ? multi_output_channel_[i].get()
+                                   : multi_consume_channel_[i].get());
+    }
+    for (auto& reader : readers_) {
+      reader->SetStealChannels(steal_channels);
+    }
+  }
   VLOG(3) << "readers size: " << readers_.size();
 }
 
@@ -17,6 +17,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/selected_rows_utils.h"
 #include "paddle/phi/common/transform.h"
+#include "paddle/phi/kernels/funcs/cpu_cast.h"
 
 #if defined(PADDLE_WITH_XPU)
 #include "paddle/fluid/platform/device/device_wrapper.h"
@@ -94,13 +95,7 @@ struct CastDataType {
     auto* out_begin = out_->mutable_data<OutType>(in_.place());
 
     if (platform::is_cpu_place(in_.place())) {
-      phi::Transform<phi::CPUContext> trans;
-      auto* context = static_cast<const phi::CPUContext*>(ctx_);
-      trans(*context,
-            in_begin,
-            in_end,
-            out_begin,
-            CastDataTypeFunctor<InType, OutType>());
+      phi::funcs::CPUCast(in_begin, in_.numel(), out_begin);
 #if defined(__NVCC__) || defined(__HIPCC__)
     } else if (platform::is_gpu_place(in_.place())) {
       phi::Transform<phi::GPUContext> trans;
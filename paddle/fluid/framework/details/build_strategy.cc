@@ -21,12 +21,18 @@ limitations under the License. */
 #include "paddle/fluid/framework/details/reduce_op_handle.h"
 #include "paddle/fluid/framework/ir/graph_printer.h"
 #include "paddle/fluid/framework/ir/multi_devices_graph_pass/multi_devices_graph_pass.h"
+#ifdef PADDLE_WITH_CUDNN_FRONTEND
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#endif
 
 PD_DECLARE_bool(convert_all_blocks);
 COMMON_DECLARE_bool(use_mkldnn);
 #ifdef PADDLE_WITH_CINN
 PD_DECLARE_bool(use_cinn);
 #endif
+#ifdef PADDLE_WITH_CUDNN_FRONTEND
+COMMON_DECLARE_bool(auto_fuse_resunit);
+#endif
 
 namespace paddle {
 namespace framework {
@@ -42,6 +48,19 @@ static inline bool SeqOnlyAllReduceOps(const BuildStrategy &strategy) {
          !strategy.enable_parallel_graph_;
 }
 
+#ifdef PADDLE_WITH_CUDNN_FRONTEND
+// Whether to apply fuse_resunit_pass without BuildStrategy.fuse_resunit,
+// on the GPUs where its fused kernels are supported.
+static inline bool AutoFuseResUnit() {
+  if (!FLAGS_auto_fuse_resunit) {
+    return false;
+  }
+  int device_id = platform::GetCurrentDeviceId();
+  return platform::GetGPUComputeCapability(device_id) >= 80 &&
+         platform::DnnVersion() >= 8800;
+}
+#endif
+
 static inline void ConvertDefaultValue(paddle::optional<bool> *default_value) {
   if (*default_value == paddle::none) {
     *default_value = true;
@@ -185,7 +204,8 @@ class ParallelExecutorPassBuilder : public ir::PassBuilder {
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
     AppendPassWithCheck(strategy_.fuse_dot_product_attention_,
                         "fuse_dot_product_attention_pass");
-    AppendPassWithCheck(strategy_.fuse_resunit_, "fuse_resunit_pass");
+    AppendPassWithCheck(strategy_.fuse_resunit_ || AutoFuseResUnit(),
+                        "fuse_resunit_pass");
 #endif
     AppendPassWithCheck(strategy_.fuse_relu_depthwise_conv_,
                         "fuse_relu_depthwise_conv_pass");
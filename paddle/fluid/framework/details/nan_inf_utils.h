@@ -40,6 +40,11 @@ void CheckOpHasNanOrInf(const framework::OperatorBase& op,
                         const framework::Scope& scope,
                         const platform::Place& place);
 
+// Check the nan/inf counts accumulated on the devices since the last call,
+// when FLAGS_check_nan_inf_deferred is set. It copies them back once per
+// device and reports the ops per FLAGS_check_nan_inf_level.
+void CheckDeferredNanInf();
+
 template <typename VarType>
 void CheckOpHasNanOrInfInDygraph(const std::string& op_type,
                                  const imperative::NameVarMap<VarType>& op_outs,
@@ -22,6 +22,7 @@
 #include "paddle/common/flags.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/phi/kernels/funcs/eigen/extensions.h"
+#include "paddle/phi/kernels/funcs/nan_inf_accumulator.h"
 
 namespace paddle {
 namespace framework {
@@ -239,6 +240,57 @@ void CheckVarHasNanOrInf(const std::string& op_type,
   CheckVarHasNanOrInf(op_type, var_name, var, place);
 }
 
+bool DeferTensorCheck(const std::string& op_type,
+                      const std::string& var_name,
+                      const phi::DenseTensor& tensor) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  auto* dev_ctx = static_cast<phi::GPUContext*>(
+      platform::DeviceContextPool::Instance().Get(tensor.place()));
+  return phi::funcs::NanInfAccumulator::Instance().Add(
+      *dev_ctx, tensor, op_type, var_name);
+#else
+  return false;
+#endif
+}
+
+void CheckDeferredNanInf() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!FLAGS_check_nan_inf_deferred) return;
+  // the max of float16, the level 2 reports the outputs overflowing it
+  constexpr float kFloat16Max = 65504.f;
+  std::ostringstream nan_inf_ops;
+  int num_nan_inf_ops = 0;
+  for (auto& stats : phi::funcs::NanInfAccumulator::Instance().Collect()) {
+    bool has_nan_inf = stats.num_nan > 0 || stats.num_inf > 0;
+    std::ostringstream info;
+    info << "op=" << stats.op_type << ", tensor=" << stats.var_name
+         << ", checks=" << stats.num_checks << ", numel=" << stats.numel
+         << ", num_nan=" << stats.num_nan << ", num_inf=" << stats.num_inf
+         << ", num_zero=" << stats.num_zero << ", max_abs=" << stats.max_abs;
+    if (has_nan_inf) {
+      ++num_nan_inf_ops;
+      nan_inf_ops << "\n  " << info.str();
+      if (FLAGS_check_nan_inf_level > 0) {
+        LOG(WARNING) << "[PRECISION] [ERROR] " << info.str();
+      }
+    } else if (FLAGS_check_nan_inf_level >= 3 ||
+               (FLAGS_check_nan_inf_level == 2 &&
+                stats.max_abs > kFloat16Max)) {
+      LOG(INFO) << "[PRECISION] " << info.str();
+    }
+  }
+  if (FLAGS_check_nan_inf_level == 0) {
+    PADDLE_ENFORCE_EQ(num_nan_inf_ops,
+                      0,
+                      platform::errors::PreconditionNotMet(
+                          "There are NAN or INF in the outputs of %d "
+                          "operators:%s",
+                          num_nan_inf_ops,
+                          nan_inf_ops.str()));
+  }
+#endif
+}
+
 bool IsSkipOp(const framework::OperatorBase& op) {
   if (op_type_nan_inf_white_list().count(op.Type()) != 0) return true;
 
@@ -24,6 +24,7 @@
 #include "paddle/phi/kernels/funcs/eigen/extensions.h"
 
 COMMON_DECLARE_int32(check_nan_inf_level);
+COMMON_DECLARE_bool(check_nan_inf_deferred);
 
 namespace paddle {
 namespace framework {
@@ -37,6 +38,13 @@ void SetNanInfStackLimit(const int& stack_limit);
 
 int GetNanInfStackLimit();
 
+// Accumulate the nan/inf counts of a GPU tensor on the device, they are
+// checked by CheckDeferredNanInf. Return false if the tensor must be checked
+// at once.
+bool DeferTensorCheck(const std::string& op_type,
+                      const std::string& var_name,
+                      const phi::DenseTensor& tensor);
+
 template <typename Context>
 struct TensorCheckerVisitor {
   TensorCheckerVisitor(const std::string& o,
@@ -86,6 +94,13 @@ void tensor_check(const std::string& op_type,
                   const std::string& var_name,
                   const phi::DenseTensor& tensor,
                   const platform::Place& place) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (std::is_same<Context, phi::GPUContext>::value &&
+      FLAGS_check_nan_inf_deferred &&
+      DeferTensorCheck(op_type, var_name, tensor)) {
+    return;
+  }
+#endif
   TensorCheckerVisitor<Context> vistor(op_type, var_name, tensor, place);
   VisitDataType(framework::TransToProtoVarType(tensor.dtype()), vistor);
 }
@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -296,6 +297,10 @@ class HogwildWorker : public CPUWorkerBase {
  protected:
   void CreateThreadOperators(const ProgramDesc& program);
   void CreateThreadScope(const ProgramDesc& program);
+  // resolve the variables of ops_ and unused_vars_ to slots in thread_scope_
+  void BindVariableSlots();
+  // collect the unused tensors after the op runs
+  void CollectUnusedTensors(const OperatorBase* op, GarbageCollector* gc);
   // check batch num
   bool CheckBatchNum(int flag);
   bool GetPassEnd(int flag);
@@ -318,6 +323,9 @@ class HogwildWorker : public CPUWorkerBase {
   std::vector<std::string> skip_vars_;
   std::unordered_map<const OperatorBase*, std::vector<std::string>>
       unused_vars_;
+  // with FLAGS_worker_variable_slots, the slots of unused_vars_
+  VariableSlotTable var_slots_;
+  std::unordered_map<const OperatorBase*, std::vector<int>> unused_var_slots_;
   int ring_id_ = 0;
   int nccl_rank_id_ = 0;
   std::unordered_map<std::string, int> params2rootid_;
@@ -362,6 +370,12 @@ class DownpourWorker : public HogwildWorker {
   void CopySparseTable();
   void CopyDenseTable();
   void CopyDenseVars();
+  // keep the push statuses of the batch, see
+  // FLAGS_downpour_max_inflight_push_batches
+  void FinishBatchPushes();
+  // wait the pushes of the oldest batches, before the next pull
+  void WaitInflightPushes();
+  void DrainInflightPushes();
 
   DownpourWorkerParameter param_;
   // copy table
@@ -392,6 +406,8 @@ class DownpourWorker : public HogwildWorker {
   std::map<uint64_t, std::vector<std::string>> dense_grad_names_;
   float scale_datanorm_;
   std::vector<::std::future<int32_t>> push_dense_status_;
+  // the push statuses of the batches not waited yet, oldest first
+  std::deque<std::vector<::std::future<int32_t>>> inflight_pushes_;
   // skipped ops
   std::vector<std::string> skip_ops_;
   // just save the value in param_ for easy access
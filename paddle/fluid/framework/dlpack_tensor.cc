@@ -15,7 +15,11 @@
 
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
+#include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/place.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -119,6 +123,95 @@ struct DLDeviceVisitor {
 #endif
   }
 };
+
+static platform::Place GetPlaceFromDLDevice(const ::DLDevice &device) {
+  switch (device.device_type) {
+    case kDLCPU:
+      return platform::CPUPlace();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    case kDLGPU:
+      return platform::CUDAPlace(device.device_id);
+    case kDLCPUPinned:
+      return platform::CUDAPinnedPlace();
+#endif
+    default:
+      PADDLE_THROW(platform::errors::Unimplemented(
+          "Unsupported DLDevice type %d.", device.device_type));
+  }
+}
+
+static phi::DataType GetDataTypeFromDLDataType(const ::DLDataType &type) {
+  PADDLE_ENFORCE_EQ(type.lanes,
+                    1,
+                    platform::errors::Unimplemented(
+                        "Only DLDataType.lanes 1 is supported, but got %d.",
+                        type.lanes));
+  switch (type.code) {
+    case kDLInt:
+      switch (type.bits) {
+        case 8:
+          return phi::DataType::INT8;
+        case 16:
+          return phi::DataType::INT16;
+        case 32:
+          return phi::DataType::INT32;
+        case 64:
+          return phi::DataType::INT64;
+      }
+      break;
+    case kDLUInt:
+      if (type.bits == 8) {
+        return phi::DataType::UINT8;
+      }
+      break;
+    case kDLFloat:
+      switch (type.bits) {
+        case 16:
+          return phi::DataType::FLOAT16;
+        case 32:
+          return phi::DataType::FLOAT32;
+        case 64:
+          return phi::DataType::FLOAT64;
+      }
+      break;
+    case kDLBfloat:
+      if (type.bits == 16) {
+        return phi::DataType::BFLOAT16;
+      }
+      break;
+    case kDLComplex:
+      switch (type.bits) {
+        case 64:
+          return phi::DataType::COMPLEX64;
+        case 128:
+          return phi::DataType::COMPLEX128;
+      }
+      break;
+  }
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "Unsupported DLDataType with code %d and bits %d.",
+      type.code,
+      type.bits));
+}
+
+// The producer memory of an imported DLManagedTensor, its deleter is called
+// when the last tensor sharing it is released.
+class DLPackAllocation : public phi::Allocation {
+ public:
+  DLPackAllocation(::DLManagedTensor *src,
+                   size_t size,
+                   const platform::Place &place)
+      : phi::Allocation(src->dl_tensor.data, size, place), src_(src) {}
+
+  ~DLPackAllocation() override {
+    if (src_->deleter != nullptr) {
+      src_->deleter(src_);
+    }
+  }
+
+ private:
+  ::DLManagedTensor *src_;
+};
 }  // namespace internal
 
 struct PaddleDLMTensor {
@@ -151,13 +244,21 @@ DLManagedTensor *toDLPack(const phi::DenseTensor &src) {
   }
   pdDLMTensor->tensor.dl_tensor.shape = shape;
 
-  // init stride
+  // init stride, in elements as in DLPack, so the views made by the stride
+  // kernels are exported without copying
   auto strides = new int64_t[ndim];
-  for (DimType i = 0; i < ndim; ++i) {
-    strides[i] = 1;
-  }
-  for (DimType i = ndim - 2; i >= 0; --i) {
-    strides[i] = shape[i + 1] * strides[i + 1];
+  const auto &src_strides = src.strides();
+  if (src_strides.size() == ndim) {
+    for (DimType i = 0; i < ndim; ++i) {
+      strides[i] = src_strides[i];
+    }
+  } else {
+    for (DimType i = 0; i < ndim; ++i) {
+      strides[i] = 1;
+    }
+    for (DimType i = ndim - 2; i >= 0; --i) {
+      strides[i] = shape[i + 1] * strides[i + 1];
+    }
   }
   pdDLMTensor->tensor.dl_tensor.strides = strides;
 
@@ -204,6 +305,85 @@ DLPackTensor::DLPackTensor(const phi::DenseTensor &tensor, LaneType lanes) {
   t_.byte_offset = 0;
 }
 
+void TensorFromDLPackNoCopy(DLManagedTensor *src, phi::DenseTensor *dst) {
+  const ::DLTensor &dl = src->dl_tensor;
+  auto place = internal::GetPlaceFromDLDevice(dl.device);
+  auto dtype = internal::GetDataTypeFromDLDataType(dl.dtype);
+
+  std::vector<int64_t> shape(dl.shape, dl.shape + dl.ndim);
+  DDim dims = common::make_ddim(shape);
+  DDim strides = phi::DenseTensorMeta::calc_strides(dims);
+  if (dl.strides != nullptr) {
+    for (int i = 0; i < dl.ndim; ++i) {
+      PADDLE_ENFORCE_GE(dl.strides[i],
+                        0,
+                        platform::errors::Unimplemented(
+                            "Negative DLPack strides are not supported, but "
+                            "the stride of dim %d is %d.",
+                            i,
+                            dl.strides[i]));
+      strides[i] = dl.strides[i];
+    }
+  }
+
+  // the bytes from the data pointer to the end of the last element
+  size_t size = dl.byte_offset;
+  if (common::product(dims) > 0) {
+    int64_t extent = 1;
+    for (int i = 0; i < dl.ndim; ++i) {
+      extent += (shape[i] - 1) * strides[i];
+    }
+    size += extent * phi::SizeOf(dtype);
+  }
+
+  phi::DenseTensorMeta meta(dtype, dims, strides);
+  meta.offset = dl.byte_offset;
+  dst->set_meta(meta);
+  dst->ResetHolder(
+      std::make_shared<internal::DLPackAllocation>(src, size, place));
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+void DLPackWaitStream(const phi::DenseTensor &src, int64_t stream) {
+  if (stream == -1 || !platform::is_gpu_place(src.place())) {
+    return;
+  }
+  auto *ctx = static_cast<phi::GPUContext *>(
+      platform::DeviceContextPool::Instance().Get(src.place()));
+  gpuStream_t consumer = reinterpret_cast<gpuStream_t>(stream);
+#ifdef PADDLE_WITH_CUDA
+  if (stream == 1) {
+    consumer = cudaStreamLegacy;
+  } else if (stream == 2) {
+    consumer = cudaStreamPerThread;
+  }
+#else
+  if (stream == 1) {
+    consumer = nullptr;
+  }
+#endif
+  if (consumer == ctx->stream()) {
+    return;
+  }
+  platform::CUDADeviceGuard guard(src.place().GetDeviceId());
+  gpuEvent_t event;
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventCreateWithFlags(&event, hipEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, ctx->stream()));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(consumer, event, 0));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventDestroy(event));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, ctx->stream()));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(consumer, event, 0));
+  // the wait is enqueued already, the event is released once it completes
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(event));
+#endif
+}
+#endif
+
 ::DLManagedTensor *DLPackTensor::ToDLManagedTensor() {
   // init shape
   auto shape = new int64_t[t_.ndim];
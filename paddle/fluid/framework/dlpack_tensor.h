@@ -45,7 +45,23 @@ class DLPackTensor {
   ShapeType shape_[phi::DDim::kMaxRank];
 };
 
+// Exports the tensor without copying, with its strides. The DLManagedTensor
+// keeps the memory of the tensor alive until its deleter is called.
 DLManagedTensor* toDLPack(const phi::DenseTensor& src);
 
+// Imports the tensor without copying, src is owned by dst afterwards and its
+// deleter is called when the memory is no longer used. The strides must not
+// be negative, the byte offset becomes the offset of dst.
+TEST_API void TensorFromDLPackNoCopy(DLManagedTensor* src,
+                                     phi::DenseTensor* dst);
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// The handoff of __dlpack__(stream=...): makes the consumer stream wait for
+// the work enqueued to the stream of src so far with an event, without
+// blocking the host. -1 means no synchronization, 1 and 2 are the legacy and
+// the per-thread default streams.
+void DLPackWaitStream(const phi::DenseTensor& src, int64_t stream);
+#endif
+
 }  // namespace framework
 }  // namespace paddle
@@ -12,6 +12,7 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/framework/fleet/metrics.h"
 #include "paddle/fluid/operators/isfinite_op.h"
@@ -32,6 +33,8 @@ class Variable;
 #define _LINUX
 #endif
 
+COMMON_DECLARE_int32(downpour_max_inflight_push_batches);
+
 namespace paddle {
 namespace framework {
 void DownpourWorker::Initialize(const TrainerDesc& desc) {
@@ -452,6 +455,39 @@ void DownpourWorker::CopyDenseVars() {
   }
 }
 
+void DownpourWorker::FinishBatchPushes() {
+  if (FLAGS_downpour_max_inflight_push_batches < 0) {
+    // unbounded, the statuses are not checked
+    push_sparse_status_.resize(0);
+    return;
+  }
+  inflight_pushes_.push_back(std::move(push_sparse_status_));
+  push_sparse_status_.clear();
+}
+
+void DownpourWorker::WaitInflightPushes() {
+  if (FLAGS_downpour_max_inflight_push_batches < 0) {
+    return;
+  }
+  size_t max_batches =
+      static_cast<size_t>(FLAGS_downpour_max_inflight_push_batches);
+  while (inflight_pushes_.size() > max_batches) {
+    for (auto& t : inflight_pushes_.front()) {
+      t.wait();
+    }
+    inflight_pushes_.pop_front();
+  }
+}
+
+void DownpourWorker::DrainInflightPushes() {
+  for (auto& batch : inflight_pushes_) {
+    for (auto& t : batch) {
+      t.wait();
+    }
+  }
+  inflight_pushes_.clear();
+}
+
 void DownpourWorker::TrainFilesWithProfiler() {
   VLOG(3) << "Begin to train files with profiler";
   platform::SetNumThreads(1);
@@ -509,6 +545,7 @@ void DownpourWorker::TrainFilesWithProfiler() {
     total_time += timeline.ElapsedSec();
 
     VLOG(3) << "program config size: " << param_.program_config_size();
+    WaitInflightPushes();
     for (int i = 0; i < param_.program_config(0).pull_sparse_table_id_size();
          ++i) {
       uint64_t tid = static_cast<uint64_t>(
@@ -673,21 +710,8 @@ void DownpourWorker::TrainFilesWithProfiler() {
       }
     }
 
+    FinishBatchPushes();
     if (need_to_push_sparse_) {
-      int32_t tmp_push_sparse_wait_times = -1;
-      static uint32_t push_sparse_wait_times =
-          static_cast<uint32_t>(tmp_push_sparse_wait_times);
-      if (push_sparse_status_.size() >= push_sparse_wait_times) {
-        for (auto& t : push_sparse_status_) {
-          t.wait();
-        }
-        push_sparse_status_.resize(0);
-      }
-
-      if (tmp_push_sparse_wait_times == -1) {
-        push_sparse_status_.resize(0);
-      }
-
       VLOG(3) << "going to increase thread version";
       VLOG(3) << "push dense table id size: "
               << param_.program_config(0).push_dense_table_id_size();
@@ -776,6 +800,7 @@ void DownpourWorker::TrainFilesWithProfiler() {
     }
     timeline.Start();
   }
+  DrainInflightPushes();
   if (copy_table_config_.need_copy()) {
     CopySparseTable();
     CopyDenseTable();
@@ -815,6 +840,7 @@ void DownpourWorker::TrainFiles() {
       }
     }
     // pull sparse here
+    WaitInflightPushes();
     for (int i = 0; i < param_.program_config(0).pull_sparse_table_id_size();
          ++i) {
       uint64_t tid = static_cast<uint64_t>(
@@ -1039,20 +1065,8 @@ void DownpourWorker::TrainFiles() {
 
     if (need_to_push_sparse_) {
       VLOG(3) << "push sparse gradient done.";
-      int32_t tmp_push_sparse_wait_times = -1;
-      static uint32_t push_sparse_wait_times =
-          static_cast<uint32_t>(tmp_push_sparse_wait_times);
-      if (push_sparse_status_.size() >= push_sparse_wait_times) {
-        for (auto& t : push_sparse_status_) {
-          t.wait();
-        }
-        push_sparse_status_.resize(0);
-      }
-
-      if (tmp_push_sparse_wait_times == -1) {
-        push_sparse_status_.resize(0);
-      }
     }
+    FinishBatchPushes();
 
     if (need_to_push_dense_) {
       for (int i = 0; i < param_.program_config(0).push_dense_table_id_size();
@@ -1073,6 +1087,7 @@ void DownpourWorker::TrainFiles() {
     thread_scope_->DropKids();
     ++batch_cnt;
   }
+  DrainInflightPushes();
   if (need_dump_field_ || need_dump_param_) {
     writer_.Flush();
   }
@@ -16,6 +16,7 @@ limitations under the License. */
 
 #include <memory>
 
+#include "paddle/fluid/framework/details/nan_inf_utils.h"
 #include "paddle/fluid/framework/feed_fetch_method.h"
 #include "paddle/fluid/framework/trainer_desc.pb.h"
 #include "paddle/fluid/framework/trainer_factory.h"
@@ -32,6 +33,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/executor_gc_helper.h"
 
 PD_DECLARE_bool(benchmark);
+COMMON_DECLARE_bool(check_nan_inf);
 COMMON_DECLARE_bool(use_mkldnn);
 
 namespace paddle {
@@ -504,6 +506,11 @@ void Executor::RunPartialPreparedContext(ExecutorPrepareContext* ctx,
     }
   }
 
+  // the deferred nan/inf checks of this run are copied back at once
+  if (FLAGS_check_nan_inf) {
+    details::CheckDeferredNanInf();
+  }
+
   auto callback = [scope, local_scope, keep_kids]() {
     if (local_scope != scope) {
       VLOG(4) << "Delete scope: " << local_scope;
@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/framework/executor_cache.h"
 
+#include <algorithm>
+
 #include "paddle/common/flags.h"
 #include "paddle/common/macros.h"
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
@@ -30,6 +32,8 @@ DECLARE_FILE_SYMBOLS(print_statistics);
 
 COMMON_DECLARE_bool(pir_apply_inplace_pass);
 COMMON_DECLARE_bool(print_ir);
+COMMON_DECLARE_int32(dy2st_interpreter_cache_capacity);
+COMMON_DECLARE_int64(dy2st_interpreter_cache_max_ops);
 
 namespace paddle {
 namespace framework {
@@ -305,6 +309,38 @@ InterpreterCoreInfoCache &InterpreterCoreInfoCache::Instance() {
   return g_info_cache;
 }
 
+InterpreterCoreInfo::CacheValue &InterpreterCoreInfoCache::Insert(
+    int64_t program_id,
+    const framework::Scope *scope,
+    const int64_t &place_hash_key,
+    bool is_grad,
+    bool in_pir_mode,
+    size_t op_num) {
+  int64_t key = CacheKey(program_id, scope, place_hash_key, in_pir_mode);
+  Touch(key);
+  auto &cached_value = info_map_[key].GetMutable(is_grad);
+  op_num_ = op_num_ - cached_value.op_num_ + op_num;
+  cached_value.op_num_ = op_num;
+
+  const size_t capacity = static_cast<size_t>(
+      std::max<int32_t>(FLAGS_dy2st_interpreter_cache_capacity, 0));
+  const size_t max_ops = static_cast<size_t>(
+      std::max<int64_t>(FLAGS_dy2st_interpreter_cache_max_ops, 0));
+  while (lru_list_.size() > 1 &&
+         ((capacity > 0 && lru_list_.size() > capacity) ||
+          (max_ops > 0 && op_num_ > max_ops))) {
+    int64_t evicted = lru_list_.back();
+    auto iter = info_map_.find(evicted);
+    VLOG(2) << "Evict the interpretercore cache of key " << evicted
+            << ", which holds " << iter->second.OpNum() << " ops";
+    op_num_ -= iter->second.OpNum();
+    info_map_.erase(iter);
+    lru_pos_.erase(evicted);
+    lru_list_.pop_back();
+  }
+  return cached_value;
+}
+
 std::shared_ptr<InterpreterCore> CreateProgramInterpreterCoreInfoToCache(
     const ProgramDesc &program_desc,
     const platform::Place &place,
@@ -313,11 +349,6 @@ std::shared_ptr<InterpreterCore> CreateProgramInterpreterCoreInfoToCache(
     framework::Scope *scope,
     const int64_t &place_hash_key) {
   auto &cache = framework::InterpreterCoreInfoCache::Instance();
-  if (cache.Size() > 256000u /* max_cached_size*/) {
-    PADDLE_THROW(platform::errors::Fatal(
-        "The cached info size has exceeded max_cached_size: 256000, "
-        "which will cause error. "));
-  }
   interpreter::ExecutionConfig execution_config;
   execution_config.create_local_scope = false;
   execution_config.used_for_jit = true;
@@ -327,8 +358,12 @@ std::shared_ptr<InterpreterCore> CreateProgramInterpreterCoreInfoToCache(
   core.reset(new InterpreterCore(
       place, program_desc.Block(0), scope, execution_config));
 
-  auto &cached_value = cache.GetMutable(
-      program_id, scope, place_hash_key, is_grad, /*in_pir_mode=*/false);
+  auto &cached_value = cache.Insert(program_id,
+                                   scope,
+                                   place_hash_key,
+                                   is_grad,
+                                   /*in_pir_mode=*/false,
+                                   program_desc.Block(0).OpSize());
   cached_value.core_ = core;
   return core;
 }
@@ -341,24 +376,25 @@ std::shared_ptr<InterpreterCore> CreatePirInterpreterCoreInfoToCache(
     framework::Scope *scope,
     const int64_t &place_hash_key) {
   auto &cache = framework::InterpreterCoreInfoCache::Instance();
-  if (cache.Size() > 256000u /* max_cached_size*/) {
-    PADDLE_THROW(platform::errors::Fatal(
-        "The cached info size has exceeded max_cached_size: 256000, "
-        "which will cause error. "));
-  }
   interpreter::ExecutionConfig execution_config;
   execution_config.create_local_scope = false;
   execution_config.used_for_jit = true;
 
-  std::shared_ptr<InterpreterCore> core = nullptr;
-
-  core.reset(new InterpreterCore(
-      place, {}, ir_program->block(), scope, execution_config));
-
-  auto &cached_value = cache.GetMutable(
-      program_id, scope, place_hash_key, is_grad, /*in_pir_mode=*/true);
+  std::shared_ptr<::pir::Program> program = std::move(ir_program);
+  // the core keeps the program of its blocks alive, a caller may still run
+  // it after the cache evicts it
+  std::shared_ptr<InterpreterCore> core(
+      new InterpreterCore(place, {}, program->block(), scope, execution_config),
+      [program](InterpreterCore *core) { delete core; });
+
+  auto &cached_value = cache.Insert(program_id,
+                                   scope,
+                                   place_hash_key,
+                                   is_grad,
+                                   /*in_pir_mode=*/true,
+                                   program->block()->num_ops());
   cached_value.core_ = core;
-  cached_value.ir_prog_ = std::move(ir_program);
+  cached_value.ir_prog_ = program;
   return core;
 }
 
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <functional>
+#include <list>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -172,7 +173,10 @@ class InterpreterCoreInfo {
   struct CacheValue {
     std::shared_ptr<InterpreterCore> core_{nullptr};
     std::set<std::string> skip_eager_delete_vars_;
-    std::unique_ptr<::pir::Program> ir_prog_{nullptr};
+    // also owned by core_, which a caller may still run after an eviction
+    std::shared_ptr<::pir::Program> ir_prog_{nullptr};
+    // the number of ops run by core_, used to bound the cache
+    size_t op_num_{0};
   };
 
   bool IsAvailable(bool is_grad) {
@@ -184,11 +188,19 @@ class InterpreterCoreInfo {
     return is_grad ? backward_info_ : forward_info_;
   }
 
+  size_t OpNum() const {
+    return forward_info_.op_num_ + backward_info_.op_num_;
+  }
+
  private:
   CacheValue forward_info_;
   CacheValue backward_info_;
 };
 
+// The interpreters of dy2static keyed by program id, and by scope and place
+// in pir mode. As retraces keep adding programs, the least recently used
+// entries are evicted beyond FLAGS_dy2st_interpreter_cache_capacity entries
+// or FLAGS_dy2st_interpreter_cache_max_ops ops.
 class InterpreterCoreInfoCache {
  public:
   static InterpreterCoreInfoCache& Instance();
@@ -198,13 +210,9 @@ class InterpreterCoreInfoCache {
            const int64_t& place_hash_key,
            bool is_grad,
            bool in_pir_mode) {
-    if (in_pir_mode) {
-      int64_t scope_i = reinterpret_cast<int64_t>(scope);
-      program_id = hash_with_seed(program_id, scope_i);
-      program_id = hash_with_seed(program_id, place_hash_key);
-    }
-    return info_map_.find(program_id) != info_map_.end() &&
-           info_map_[program_id].IsAvailable(is_grad);
+    int64_t key = CacheKey(program_id, scope, place_hash_key, in_pir_mode);
+    auto iter = info_map_.find(key);
+    return iter != info_map_.end() && iter->second.IsAvailable(is_grad);
   }
 
   InterpreterCoreInfo::CacheValue& GetMutable(int64_t program_id,
@@ -212,14 +220,20 @@ class InterpreterCoreInfoCache {
                                               const int64_t& place_hash_key,
                                               bool is_grad,
                                               bool in_pir_mode) {
-    if (in_pir_mode) {
-      int64_t scope_i = reinterpret_cast<int64_t>(scope);
-      program_id = hash_with_seed(program_id, scope_i);
-      program_id = hash_with_seed(program_id, place_hash_key);
-    }
-    return info_map_[program_id].GetMutable(is_grad);
+    int64_t key = CacheKey(program_id, scope, place_hash_key, in_pir_mode);
+    Touch(key);
+    return info_map_[key].GetMutable(is_grad);
   }
 
+  // Returns the value to hold a new interpreter of op_num ops, after evicting
+  // the least recently used entries other than its own to make room for it.
+  InterpreterCoreInfo::CacheValue& Insert(int64_t program_id,
+                                          const framework::Scope* scope,
+                                          const int64_t& place_hash_key,
+                                          bool is_grad,
+                                          bool in_pir_mode,
+                                          size_t op_num);
+
   void UpdateSkipEagerDeleteVars(int64_t program_id,
                                  const framework::Scope* scope,
                                  const int64_t& place_hash_key,
@@ -243,15 +257,47 @@ class InterpreterCoreInfoCache {
 
   size_t Size() const { return info_map_.size(); }
 
+  size_t OpNum() const { return op_num_; }
+
   void Finalize() {
     // NOTE(Aurelius84): DO NOT perform finalize in destructor
     // to avoid problems caused by destructor order of static
     // object.
     info_map_.clear();
+    lru_list_.clear();
+    lru_pos_.clear();
+    op_num_ = 0;
   }
 
  private:
+  int64_t CacheKey(int64_t program_id,
+                   const framework::Scope* scope,
+                   const int64_t& place_hash_key,
+                   bool in_pir_mode) const {
+    if (in_pir_mode) {
+      int64_t scope_i = reinterpret_cast<int64_t>(scope);
+      program_id = hash_with_seed(program_id, scope_i);
+      program_id = hash_with_seed(program_id, place_hash_key);
+    }
+    return program_id;
+  }
+
+  // Moves the key to the front of the lru list.
+  void Touch(int64_t key) {
+    auto iter = lru_pos_.find(key);
+    if (iter != lru_pos_.end()) {
+      lru_list_.splice(lru_list_.begin(), lru_list_, iter->second);
+    } else {
+      lru_list_.push_front(key);
+      lru_pos_[key] = lru_list_.begin();
+    }
+  }
+
   std::unordered_map<int64_t, InterpreterCoreInfo> info_map_;
+  // the keys from the most to the least recently used
+  std::list<int64_t> lru_list_;
+  std::unordered_map<int64_t, std::list<int64_t>::iterator> lru_pos_;
+  size_t op_num_{0};
 };
 
 std::shared_ptr<InterpreterCore> CreateProgramInterpreterCoreInfoToCache(
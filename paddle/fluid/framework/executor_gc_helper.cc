@@ -175,6 +175,35 @@ GetUnusedVars(const BlockDesc &block,
   return result;
 }
 
+static void CollectGarbage(
+    Variable *var,
+    const std::string &var_name,
+    std::deque<std::shared_ptr<memory::Allocation>> *garbages) {
+  VLOG(2) << "Erase variable " << var_name;
+  if (var->IsType<phi::DenseTensor>()) {
+    garbages->emplace_back(
+        var->GetMutable<phi::DenseTensor>()->MoveMemoryHolder());
+  } else if (var->IsType<phi::SelectedRows>()) {
+    garbages->emplace_back(var->GetMutable<phi::SelectedRows>()
+                               ->mutable_value()
+                               ->MoveMemoryHolder());
+  } else if (var->IsType<LoDTensorArray>()) {
+    auto *lod_tensor_arr = var->GetMutable<LoDTensorArray>();
+    for (auto &t : *lod_tensor_arr) {
+      garbages->emplace_back(t.MoveMemoryHolder());
+    }
+    // NOTE(wangxi): need clear the vector, otherwise lod_tensor_arr.size() is
+    // wrong, if size() decrease in next step, an error maybe occur.
+    lod_tensor_arr->clear();
+  } else if (var->IsType<Strings>()) {
+  } else {
+    PADDLE_THROW(platform::errors::Unimplemented(
+        "Type %s of variable %s is not supported eager deletion.",
+        framework::ToTypeName(var->Type()),
+        var_name));
+  }
+}
+
 void DeleteUnusedTensors(const Scope &scope,
                          const std::vector<std::string> &delete_vars,
                          GarbageCollector *gc) {
@@ -185,30 +214,30 @@ void DeleteUnusedTensors(const Scope &scope,
     if (var == nullptr) {
       continue;
     }
+    CollectGarbage(var, var_name, &garbages);
+  }
 
-    VLOG(2) << "Erase variable " << var_name;
-    if (var->IsType<phi::DenseTensor>()) {
-      garbages.emplace_back(
-          var->GetMutable<phi::DenseTensor>()->MoveMemoryHolder());
-    } else if (var->IsType<phi::SelectedRows>()) {
-      garbages.emplace_back(var->GetMutable<phi::SelectedRows>()
-                                ->mutable_value()
-                                ->MoveMemoryHolder());
-    } else if (var->IsType<LoDTensorArray>()) {
-      auto *lod_tensor_arr = var->GetMutable<LoDTensorArray>();
-      for (auto &t : *lod_tensor_arr) {
-        garbages.emplace_back(t.MoveMemoryHolder());
+  if (!garbages.empty()) {
+    gc->Add(std::move(garbages));
+  }
+}
+
+void DeleteUnusedTensors(const Scope &scope,
+                         const VariableSlotTable &slot_table,
+                         const std::vector<int> &delete_slots,
+                         GarbageCollector *gc) {
+  std::deque<std::shared_ptr<memory::Allocation>> garbages;
+
+  for (int slot : delete_slots) {
+    auto *var = slot_table.Get(slot);
+    // the variable may be created after the table was bound
+    if (var == nullptr) {
+      var = scope.FindVar(slot_table.Name(slot));
+      if (var == nullptr) {
+        continue;
       }
-      // NOTE(wangxi): need clear the vector, otherwise lod_tensor_arr.size() is
-      // wrong, if size() decrease in next step, an error maybe occur.
-      lod_tensor_arr->clear();
-    } else if (var->IsType<Strings>()) {
-    } else {
-      PADDLE_THROW(platform::errors::Unimplemented(
-          "Type %s of variable %s is not supported eager deletion.",
-          framework::ToTypeName(var->Type()),
-          var_name));
     }
+    CollectGarbage(var, slot_table.Name(slot), &garbages);
   }
 
   if (!garbages.empty()) {
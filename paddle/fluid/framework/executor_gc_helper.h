@@ -59,6 +59,12 @@ void DeleteUnusedTensors(const Scope &scope,
                          const std::vector<std::string> &delete_vars,
                          GarbageCollector *gc);
 
+// Collect unused tensors by their slots in the table bound to the scope
+void DeleteUnusedTensors(const Scope &scope,
+                         const VariableSlotTable &slot_table,
+                         const std::vector<int> &delete_slots,
+                         GarbageCollector *gc);
+
 // Collect unused tensors after op runs
 void DeleteUnusedTensors(
     const Scope &scope,
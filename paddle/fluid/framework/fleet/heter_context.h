@@ -106,6 +106,8 @@ class HeterContext {
   void* sub_graph_float_feas = NULL;
   uint32_t shard_num_ = 37;
   uint16_t pass_id_ = 0;
+  // device keys are divided and ready for BuildGPUTask
+  bool device_task_ready_ = false;
   uint64_t size() {
     uint64_t total_size = 0;
     for (auto& keys : feature_keys_) {
@@ -200,6 +202,7 @@ class HeterContext {
       item.clear();
     }
     keys2rank_map_vec_.clear();
+    device_task_ready_ = false;
   }
   void batch_add_keys(
       const std::vector<std::unordered_set<uint64_t>>& thread_keys) {
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "paddle/common/flags.h"
+#include "paddle/common/hostdevice.h"
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/memory/memory.h"
 #include "paddle/fluid/platform/cuda_device_guard.h"
@@ -46,6 +47,13 @@ struct GpuPsCommGraph {
   half *weight_list;  // locate on both side, which length is the same as
                       // neighbor_list
   bool is_weighted;
+  // out-of-core mode on gpu side: only the neighbors at [0,
+  // hot_neighbor_size) are in neighbor_list and weight_list on hbm, the rest
+  // are in cold_neighbor_list and cold_weight_list, mapped pinned host memory
+  // the kernels read directly. cold_neighbor_list is null when all are on hbm
+  uint64_t *cold_neighbor_list;
+  half *cold_weight_list;
+  int64_t hot_neighbor_size;
   GpuPsCommGraph()
       : node_list(nullptr),
         node_size(0),
@@ -53,7 +61,10 @@ struct GpuPsCommGraph {
         neighbor_list(nullptr),
         neighbor_size(0),
         weight_list(nullptr),
-        is_weighted(false) {}
+        is_weighted(false),
+        cold_neighbor_list(nullptr),
+        cold_weight_list(nullptr),
+        hot_neighbor_size(0) {}
   GpuPsCommGraph(uint64_t *node_list_,
                  int64_t node_size_,
                  GpuPsNodeInfo *node_info_list_,
@@ -67,7 +78,20 @@ struct GpuPsCommGraph {
         neighbor_list(neighbor_list_),
         neighbor_size(neighbor_size_),
         weight_list(weight_list_),
-        is_weighted(is_weighted_) {}
+        is_weighted(is_weighted_),
+        cold_neighbor_list(nullptr),
+        cold_weight_list(nullptr),
+        hot_neighbor_size(0) {}
+  HOSTDEVICE inline uint64_t neighbor_at(int64_t pos) const {
+    return (cold_neighbor_list == nullptr || pos < hot_neighbor_size)
+               ? neighbor_list[pos]
+               : cold_neighbor_list[pos - hot_neighbor_size];
+  }
+  HOSTDEVICE inline half weight_at(int64_t pos) const {
+    return (cold_weight_list == nullptr || pos < hot_neighbor_size)
+               ? weight_list[pos]
+               : cold_weight_list[pos - hot_neighbor_size];
+  }
   void init_on_cpu(int64_t neighbor_size_,
                    int64_t node_size_,
                    bool is_weighted_) {
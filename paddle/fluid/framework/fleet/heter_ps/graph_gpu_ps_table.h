@@ -115,6 +115,11 @@ class GpuPsGraphTable
     device_mutex_.clear();
   }
   void build_graph_on_single_gpu(const GpuPsCommGraph &g, int gpu_id, int idx);
+  void build_out_of_core_neighbor(const GpuPsCommGraph &g,
+                                  int gpu_id,
+                                  int offset,
+                                  const std::vector<GpuPsNodeInfo> &node_info,
+                                  gpuStream_t stream);
   void build_graph_fea_on_single_gpu(const GpuPsCommGraphFea &g, int gpu_id);
   void build_graph_float_fea_on_single_gpu(const GpuPsCommGraphFloatFea &g,
                                            int gpu_id);
@@ -16,7 +16,9 @@
 #include <thrust/device_vector.h>
 #include <thrust/reduce.h>
 #include <thrust/scan.h>
+#include <algorithm>
 #include <functional>
+#include <numeric>
 #include "cub/cub.cuh"
 #pragma once
 #ifdef PADDLE_WITH_HETERPS
@@ -31,6 +33,7 @@
 #define SAMPLE_SIZE_THRESHOLD 1024
 
 COMMON_DECLARE_bool(enable_neighbor_list_use_uva);
+COMMON_DECLARE_double(gpugraph_neighbor_hbm_ratio);
 COMMON_DECLARE_bool(enable_graph_multi_node_sampling);
 
 namespace paddle {
@@ -226,10 +229,9 @@ __global__ void neighbor_sample_kernel_walking(GpuPsCommGraph graph,
     int neighbor_len = node_info_list[i].neighbor_size;
     uint32_t data_offset = node_info_list[i].neighbor_offset;
     int offset = i * sample_len;
-    uint64_t* data = graph.neighbor_list;
     if (neighbor_len <= sample_len) {
       for (int j = threadIdx.x; j < neighbor_len; j += WARP_SIZE) {
-        res[offset + j] = data[data_offset + j];
+        res[offset + j] = graph.neighbor_at(data_offset + j);
       }
       actual_size[i] = neighbor_len;
     } else {
@@ -253,7 +255,7 @@ __global__ void neighbor_sample_kernel_walking(GpuPsCommGraph graph,
       __syncwarp();
       for (int j = threadIdx.x; j < sample_len; j += WARP_SIZE) {
         const int64_t perm_idx = res[offset + j] + data_offset;
-        res[offset + j] = data[perm_idx];
+        res[offset + j] = graph.neighbor_at(perm_idx);
       }
       actual_size[i] = sample_len;
     }
@@ -402,20 +404,20 @@ __launch_bounds__(BLOCK_SIZE) __global__
   int neighbor_len = node_info_list[i].neighbor_size;
   uint32_t data_offset = node_info_list[i].neighbor_offset;
   int offset = i * sample_len;
-  uint64_t* data = graph.neighbor_list;
-  half* weight = graph.weight_list;
   float* weight_keys_local_buff = weight_keys_buff + target_neighbor_offset[i];
   if (neighbor_len <= sample_len) {  // directly copy
     for (int j = threadIdx.x; j < neighbor_len; j += BLOCK_SIZE) {
-      res[offset + j] = data[data_offset + j];
+      res[offset + j] = graph.neighbor_at(data_offset + j);
       if (return_weight) {
-        weight_array[offset + j] = static_cast<float>(weight[data_offset + j]);
+        weight_array[offset + j] =
+            static_cast<float>(graph.weight_at(data_offset + j));
       }
     }
   } else {
     RandomNumGen rng(gidx, random_seed);  // get weight threshold
     for (int j = threadIdx.x; j < neighbor_len; j += BLOCK_SIZE) {
-      float thread_weight = static_cast<float>(weight[data_offset + j]);
+      float thread_weight =
+          static_cast<float>(graph.weight_at(data_offset + j));
       weight_keys_local_buff[j] =
           static_cast<float>(gen_key_from_weight(thread_weight, rng));
     }
@@ -451,10 +453,10 @@ __launch_bounds__(BLOCK_SIZE) __global__
         bool has_topk = (key >= topk_val);  // diff 1
         if (has_topk) {
           int write_index = atomicAdd(&cnt, 1);
-          res[offset + write_index] = data[data_offset + j];
+          res[offset + write_index] = graph.neighbor_at(data_offset + j);
           if (return_weight) {
             weight_array[offset + write_index] =
-                static_cast<float>(weight[data_offset + j]);
+                static_cast<float>(graph.weight_at(data_offset + j));
           }
         }
       }
@@ -464,10 +466,10 @@ __launch_bounds__(BLOCK_SIZE) __global__
         bool has_topk = (key > topk_val);  // diff 1
         if (has_topk) {
           int write_index = atomicAdd(&cnt, 1);
-          res[offset + write_index] = data[data_offset + j];
+          res[offset + write_index] = graph.neighbor_at(data_offset + j);
           if (return_weight) {
             weight_array[offset + write_index] =
-                static_cast<float>(weight[data_offset + j]);
+                static_cast<float>(graph.weight_at(data_offset + j));
           }
         }
       }
@@ -481,10 +483,10 @@ __launch_bounds__(BLOCK_SIZE) __global__
           if (write_index >= sample_len) {
             break;
           }
-          res[offset + write_index] = data[data_offset + j];
+          res[offset + write_index] = graph.neighbor_at(data_offset + j);
           if (return_weight) {
             weight_array[offset + write_index] =
-                static_cast<float>(weight[data_offset + j]);
+                static_cast<float>(graph.weight_at(data_offset + j));
           }
         }
       }
@@ -509,14 +511,13 @@ __launch_bounds__(BLOCK_SIZE) __global__
   int neighbor_len = node_info_list[i].neighbor_size;
   uint32_t data_offset = node_info_list[i].neighbor_offset;
   int offset = i * sample_len;
-  uint64_t* data = graph.neighbor_list;
-  half* weight = graph.weight_list;
 
   if (neighbor_len <= sample_len) {
     for (int j = threadIdx.x; j < neighbor_len; j += BLOCK_SIZE) {
-      res[offset + j] = data[data_offset + j];
+      res[offset + j] = graph.neighbor_at(data_offset + j);
       if (return_weight) {
-        weight_array[offset + j] = static_cast<float>(weight[data_offset + j]);
+        weight_array[offset + j] =
+            static_cast<float>(graph.weight_at(data_offset + j));
       }
     }
   } else {
@@ -533,7 +534,8 @@ __launch_bounds__(BLOCK_SIZE) __global__
     for (int j = 0; j < ITEMS_PER_THREAD; j++) {
       int idx = BLOCK_SIZE * j + tx;
       if (idx < neighbor_len) {
-        float thread_weight = static_cast<float>(weight[data_offset + idx]);
+        float thread_weight =
+            static_cast<float>(graph.weight_at(data_offset + idx));
         weight_keys[j] = gen_key_from_weight(thread_weight, rng);
         neighbor_idxs[j] = idx;
       }
@@ -555,7 +557,7 @@ __launch_bounds__(BLOCK_SIZE) __global__
         int target_idx = idx_offset + local_idx;
         if (local_idx >= 0 && target_idx < neighbor_len) {
           float thread_weight =
-              static_cast<float>(weight[data_offset + target_idx]);
+              static_cast<float>(graph.weight_at(data_offset + target_idx));
           weight_keys[j] = gen_key_from_weight(thread_weight, rng);
           neighbor_idxs[j] = target_idx;
         }
@@ -572,10 +574,10 @@ __launch_bounds__(BLOCK_SIZE) __global__
     for (int j = 0; j < ITEMS_PER_THREAD; j++) {
       int idx = j * BLOCK_SIZE + tx;
       if (idx < sample_len) {
-        res[offset + idx] = data[data_offset + neighbor_idxs[j]];
+        res[offset + idx] = graph.neighbor_at(data_offset + neighbor_idxs[j]);
         if (return_weight) {
-          weight_array[offset + idx] =
-              static_cast<float>(weight[data_offset + neighbor_idxs[j]]);
+          weight_array[offset + idx] = static_cast<float>(
+              graph.weight_at(data_offset + neighbor_idxs[j]));
         }
       }
     }
@@ -600,14 +602,13 @@ __global__ void unweighted_sample_large_kernel(GpuPsCommGraph graph,
   int neighbor_len = node_info_list[i].neighbor_size;
   uint32_t data_offset = node_info_list[i].neighbor_offset;
   int offset = i * sample_len;
-  uint64_t* data = graph.neighbor_list;
-  half* weight = graph.weight_list;
   if (neighbor_len <= sample_len) {  // directly copy
     actual_size[i] = neighbor_len;
     for (int j = threadIdx.x; j < neighbor_len; j += blockDim.x) {
-      res[offset + j] = data[data_offset + j];
+      res[offset + j] = graph.neighbor_at(data_offset + j);
       if (return_weight) {
-        weight_array[offset + j] = static_cast<float>(weight[data_offset + j]);
+        weight_array[offset + j] =
+            static_cast<float>(graph.weight_at(data_offset + j));
       }
     }
   } else {
@@ -626,7 +627,7 @@ __global__ void unweighted_sample_large_kernel(GpuPsCommGraph graph,
     __syncthreads();
     for (int j = threadIdx.x; j < sample_len; j += blockDim.x) {
       const int64_t perm_idx = res[offset + j] + data_offset;
-      res[offset + j] = data[perm_idx];
+      res[offset + j] = graph.neighbor_at(perm_idx);
     }
   }
 }
@@ -654,15 +655,14 @@ __global__ void unweighted_sample_kernel(GpuPsCommGraph graph,
   int neighbor_len = node_info_list[i].neighbor_size;
   uint32_t data_offset = node_info_list[i].neighbor_offset;
   int offset = i * sample_len;
-  uint64_t* data = graph.neighbor_list;
-  half* weight = graph.weight_list;
 
   if (neighbor_len <= sample_len) {
     actual_size[i] = neighbor_len;
     for (int j = threadIdx.x; j < neighbor_len; j += blockDim.x) {
-      res[offset + j] = data[data_offset + j];
+      res[offset + j] = graph.neighbor_at(data_offset + j);
       if (return_weight) {
-        weight_array[offset + j] = static_cast<float>(weight[data_offset + j]);
+        weight_array[offset + j] =
+            static_cast<float>(graph.weight_at(data_offset + j));
       }
     }
   } else {
@@ -766,10 +766,10 @@ __global__ void unweighted_sample_kernel(GpuPsCommGraph graph,
       int idx = j * BLOCK_DIM + threadIdx.x;
       int ai = sa_p[j];
       if (idx < M) {
-        res[offset + idx] = data[data_offset + ai];
+        res[offset + idx] = graph.neighbor_at(data_offset + ai);
         if (return_weight) {
           weight_array[offset + idx] =
-              static_cast<float>(weight[data_offset + ai]);
+              static_cast<float>(graph.weight_at(data_offset + ai));
         }
       }
     }
@@ -1603,6 +1603,20 @@ void GpuPsGraphTable::clear_graph_info(int gpu_id, int idx) {
     cudaFree(graph.neighbor_list);
     graph.neighbor_list = nullptr;
   }
+  if (graph.weight_list != NULL) {
+    cudaFree(graph.weight_list);
+    graph.weight_list = nullptr;
+  }
+  // mapped pinned memory, the device pointer is the host one under uva
+  if (graph.cold_neighbor_list != NULL) {
+    cudaFreeHost(graph.cold_neighbor_list);
+    graph.cold_neighbor_list = nullptr;
+  }
+  if (graph.cold_weight_list != NULL) {
+    cudaFreeHost(graph.cold_weight_list);
+    graph.cold_weight_list = nullptr;
+  }
+  graph.hot_neighbor_size = 0;
   if (graph.node_list != NULL) {
     cudaFree(graph.node_list);
     graph.node_list = nullptr;
@@ -1834,6 +1848,101 @@ void GpuPsGraphTable::build_rank_fea_on_single_gpu(const GpuPsCommRankFea& g,
           << " finish, size:" << g.feature_size;
 }
 
+/*
+out-of-core layout of g: the neighbors are laid out again with the nodes
+sorted by degree descending, so the nodes visited most by walks and samples
+come first and their neighbors fill the hbm part. node_info gets the new
+offsets, indexed as g.node_info_list.
+*/
+static void plan_out_of_core_neighbor(const GpuPsCommGraph& g,
+                                      std::vector<GpuPsNodeInfo>* node_info) {
+  std::vector<int64_t> order(g.node_size);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&g](int64_t a, int64_t b) {
+    return g.node_info_list[a].neighbor_size >
+           g.node_info_list[b].neighbor_size;
+  });
+  node_info->assign(g.node_info_list, g.node_info_list + g.node_size);
+  uint32_t pos = 0;
+  for (int64_t idx : order) {
+    (*node_info)[idx].neighbor_offset = pos;
+    pos += (*node_info)[idx].neighbor_size;
+  }
+}
+
+void GpuPsGraphTable::build_out_of_core_neighbor(
+    const GpuPsCommGraph& g,
+    int gpu_id,
+    int offset,
+    const std::vector<GpuPsNodeInfo>& node_info,
+    gpuStream_t stream) {
+  auto& graph = gpu_graph_list_[offset];
+  double ratio = std::max(0.0, FLAGS_gpugraph_neighbor_hbm_ratio);
+  int64_t hot_size = std::min(
+      g.neighbor_size, static_cast<int64_t>(ratio * g.neighbor_size));
+  int64_t cold_size = g.neighbor_size - hot_size;
+  std::vector<uint64_t> hot_neighbor(hot_size);
+  std::vector<half> hot_weight(g.is_weighted ? hot_size : 0);
+  uint64_t* cold_neighbor = nullptr;
+  half* cold_weight = nullptr;
+  if (cold_size > 0) {
+    CUDA_CHECK(cudaHostAlloc(reinterpret_cast<void**>(&cold_neighbor),
+                             cold_size * sizeof(uint64_t),
+                             cudaHostAllocMapped | cudaHostAllocPortable));
+    if (g.is_weighted) {
+      CUDA_CHECK(cudaHostAlloc(reinterpret_cast<void**>(&cold_weight),
+                               cold_size * sizeof(half),
+                               cudaHostAllocMapped | cudaHostAllocPortable));
+    }
+  }
+  for (int64_t i = 0; i < g.node_size; i++) {
+    const GpuPsNodeInfo& src = g.node_info_list[i];
+    int64_t dst = node_info[i].neighbor_offset;
+    for (uint32_t j = 0; j < src.neighbor_size; j++, dst++) {
+      int64_t src_pos = src.neighbor_offset + j;
+      if (dst < hot_size) {
+        hot_neighbor[dst] = g.neighbor_list[src_pos];
+        if (g.is_weighted) hot_weight[dst] = g.weight_list[src_pos];
+      } else {
+        cold_neighbor[dst - hot_size] = g.neighbor_list[src_pos];
+        if (g.is_weighted) cold_weight[dst - hot_size] = g.weight_list[src_pos];
+      }
+    }
+  }
+
+  if (hot_size > 0) {
+    CUDA_CHECK(cudaMalloc(&graph.neighbor_list, hot_size * sizeof(uint64_t)));
+    CUDA_CHECK(cudaMemcpyAsync(graph.neighbor_list,
+                               hot_neighbor.data(),
+                               hot_size * sizeof(uint64_t),
+                               cudaMemcpyHostToDevice,
+                               stream));
+    if (g.is_weighted) {
+      CUDA_CHECK(cudaMalloc(&graph.weight_list, hot_size * sizeof(half)));
+      CUDA_CHECK(cudaMemcpyAsync(graph.weight_list,
+                                 hot_weight.data(),
+                                 hot_size * sizeof(half),
+                                 cudaMemcpyHostToDevice,
+                                 stream));
+    }
+  }
+  if (cold_size > 0) {
+    CUDA_CHECK(cudaHostGetDevicePointer(
+        reinterpret_cast<void**>(&graph.cold_neighbor_list), cold_neighbor, 0));
+    if (g.is_weighted) {
+      CUDA_CHECK(cudaHostGetDevicePointer(
+          reinterpret_cast<void**>(&graph.cold_weight_list), cold_weight, 0));
+    }
+  }
+  graph.hot_neighbor_size = hot_size;
+  graph.neighbor_size = g.neighbor_size;
+  // the host staging buffers are released on return
+  CUDA_CHECK(cudaStreamSynchronize(stream));
+  VLOG(0) << "out-of-core graph-edges on gpu " << resource_->dev_id(gpu_id)
+          << ", hbm neighbor_size:" << hot_size
+          << ", pinned host neighbor_size:" << cold_size;
+}
+
 /*
 the parameter std::vector<GpuPsCommGraph> cpu_graph_list is generated by cpu.
 it saves the graph to be saved on each gpu.
@@ -1854,6 +1963,14 @@ void GpuPsGraphTable::build_graph_on_single_gpu(const GpuPsCommGraph& g,
   size_t capacity = std::max((uint64_t)1, (uint64_t)g.node_size) / load_factor_;
   auto stream = get_local_stream(gpu_id);
   tables_[table_offset] = new Table(capacity, stream);
+  bool out_of_core =
+      g.neighbor_size > 0 && FLAGS_gpugraph_neighbor_hbm_ratio < 1.0;
+  std::vector<GpuPsNodeInfo> out_of_core_node_info;
+  if (out_of_core) {
+    plan_out_of_core_neighbor(g, &out_of_core_node_info);
+  }
+  GpuPsNodeInfo* node_info_list =
+      out_of_core ? out_of_core_node_info.data() : g.node_info_list;
   if (g.node_size > 0) {
     if (FLAGS_gpugraph_load_node_list_into_hbm) {
       CUDA_CHECK(cudaMalloc(&gpu_graph_list_[offset].node_list,
@@ -1868,7 +1985,7 @@ void GpuPsGraphTable::build_graph_on_single_gpu(const GpuPsCommGraph& g,
 
     build_ps(gpu_id,
              g.node_list,
-             reinterpret_cast<uint64_t*>(g.node_info_list),
+             reinterpret_cast<uint64_t*>(node_info_list),
              g.node_size,
              HBMPS_MAX_BUFF,
              8,
@@ -1879,7 +1996,10 @@ void GpuPsGraphTable::build_graph_on_single_gpu(const GpuPsCommGraph& g,
     gpu_graph_list_[offset].node_list = NULL;
     gpu_graph_list_[offset].node_size = 0;
   }
-  if (g.neighbor_size) {
+  if (out_of_core) {
+    build_out_of_core_neighbor(
+        g, gpu_id, offset, out_of_core_node_info, stream);
+  } else if (g.neighbor_size) {
     cudaError_t cudaStatus;
     if (!FLAGS_enable_neighbor_list_use_uva) {
       cudaStatus = cudaMalloc(&gpu_graph_list_[offset].neighbor_list,
@@ -16,6 +16,7 @@ limitations under the License. */
 #ifdef PADDLE_WITH_HETERPS
 #include <glog/logging.h>
 
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -61,6 +62,28 @@ class TableContainer
                                  std::numeric_limits<KeyType>::max()>(
             stream, capacity, ValType()) {}
 };
+
+// value ranges of the hbm pools that overflowed into host memory, see
+// HBMMemoryPoolFix::set_host_overflow. The pull and push kernels count the
+// keys they serve from there.
+struct HostTierRange {
+  static constexpr int kMaxRanges = 8;
+  const char* begin[kMaxRanges] = {};
+  const char* end[kMaxRanges] = {};
+  int num = 0;
+  // device counters, [0] pull hits and [1] push hits
+  unsigned long long* hits = nullptr;  // NOLINT
+
+  __host__ __device__ bool contains(const void* ptr) const {
+    const char* p = reinterpret_cast<const char*>(ptr);
+    for (int i = 0; i < num; ++i) {
+      if (p >= begin[i] && p < end[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
 #elif defined(PADDLE_WITH_XPU_KP)
 template <typename KeyType, typename ValType>
 class XPUCacheArray {
@@ -202,6 +225,22 @@ class HashTable {
               Sgd sgd,
               StreamType stream);
 
+  // merges the d_fea_num[i] gradients d_sorted_idx[d_offset[i]...] of the
+  // unique key d_keys[i] into d_merged_grads and applies sgd to it in the
+  // same thread, instead of a merge kernel followed by update
+  template <typename Sgd, typename GPUAccessor, typename StreamType>
+  void merge_update(const KeyType* d_keys,
+                    const uint32_t* d_offset,
+                    const uint32_t* d_fea_num,
+                    const uint32_t* d_sorted_idx,
+                    const char* d_grads,
+                    char* d_merged_grads,
+                    size_t len,
+                    size_t grad_dim,
+                    Sgd sgd,
+                    GPUAccessor gpu_accessor,
+                    StreamType stream);
+
 #elif defined(PADDLE_WITH_XPU_KP)
   template <typename GradType, typename StreamType>
   void update(const KeyType* d_keys,
@@ -231,9 +270,24 @@ class HashTable {
     return container_->prefetch(dev_id, stream);
   }
 
-  void clear(cudaStream_t stream = 0) { container_->clear_async(stream); }
+  void clear(cudaStream_t stream = 0) {
+    container_->clear_async(stream);
+#if defined(PADDLE_WITH_CUDA)
+    host_tier_.num = 0;
+#endif
+  }
 
-  void show_collision(int id) { return container_->print_collision(id); }
+  void show_collision(int id) {
+    container_->print_collision(id);
+#if defined(PADDLE_WITH_CUDA)
+    show_host_tier(id);
+#endif
+  }
+#if defined(PADDLE_WITH_CUDA)
+  // values of the idx-th pool in [begin, end) live in host memory
+  void set_host_tier(int idx, char* begin, char* end);
+  void show_host_tier(int id);
+#endif
   // infer mode
   void set_mode(bool infer_mode) { infer_mode_ = infer_mode; }
 
@@ -243,6 +297,9 @@ class HashTable {
 #if defined(PADDLE_WITH_CUDA)
   TableContainer<KeyType, ValType>* container_;
   cudaStream_t stream_ = 0;
+  HostTierRange host_tier_;
+  std::atomic<uint64_t> host_tier_pull_keys_{0};
+  std::atomic<uint64_t> host_tier_push_keys_{0};
 #elif defined(PADDLE_WITH_XPU_KP)
   XPUCacheArray<KeyType, ValType>* container_;
 #endif
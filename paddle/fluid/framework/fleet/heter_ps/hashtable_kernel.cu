@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #ifdef PADDLE_WITH_HETERPS
+#include <algorithm>
 #include <thread>
 
 #include "paddle/fluid/framework/fleet/heter_ps/hashtable.h"
@@ -162,7 +163,8 @@ __global__ void dy_mf_search_kernel_fill(
     char* vals,
     size_t len,
     size_t pull_feature_value_size,
-    GPUAccessor gpu_accessor) {
+    GPUAccessor gpu_accessor,
+    HostTierRange host_tier) {
   const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
     auto it = table->find(keys[i]);
@@ -170,6 +172,9 @@ __global__ void dy_mf_search_kernel_fill(
       uint64_t offset = i * pull_feature_value_size;
       float* cur = reinterpret_cast<float*>(vals + offset);
       float* input = it->second;
+      if (host_tier.contains(input)) {
+        atomicAdd(&host_tier.hits[0], 1ULL);
+      }
       gpu_accessor.PullValueFill(cur, input);
     } else {
       float* cur = reinterpret_cast<float*>(&vals[i * pull_feature_value_size]);
@@ -184,7 +189,8 @@ __global__ void dy_mf_search_kernel(Table* table,
                                     char* vals,
                                     size_t len,
                                     size_t pull_feature_value_size,
-                                    GPUAccessor gpu_accessor) {
+                                    GPUAccessor gpu_accessor,
+                                    HostTierRange host_tier) {
   const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
     auto it = table->find(keys[i]);
@@ -192,6 +198,9 @@ __global__ void dy_mf_search_kernel(Table* table,
       uint64_t offset = i * pull_feature_value_size;
       float* cur = reinterpret_cast<float*>(vals + offset);
       float* input = it->second;
+      if (host_tier.contains(input)) {
+        atomicAdd(&host_tier.hits[0], 1ULL);
+      }
       gpu_accessor.PullValueFill(cur, input);
     } else {
       PADDLE_ENFORCE(false, "warning: pull miss key: %lu", keys[i]);
@@ -222,11 +231,15 @@ __global__ void dy_mf_update_kernel(Table* table,
                                     const char* const grads,
                                     size_t len,
                                     Sgd sgd,
-                                    size_t grad_value_size) {
+                                    size_t grad_value_size,
+                                    HostTierRange host_tier) {
   const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
   if (i < len) {
     auto it = table->find(keys[i]);
     if (it != table->end()) {
+      if (host_tier.contains((it.getter())->second)) {
+        atomicAdd(&host_tier.hits[1], 1ULL);
+      }
       const float* cur =
           reinterpret_cast<const float*>(grads + i * grad_value_size);
       sgd.dy_mf_update_value(optimizer_config, (it.getter())->second, cur);
@@ -236,6 +249,61 @@ __global__ void dy_mf_update_kernel(Table* table,
   }
 }
 
+template <typename Table, typename Sgd, typename GPUAccessor>
+__global__ void dy_mf_merge_update_kernel(
+    Table* table,
+    const OptimizerConfig& optimizer_config,
+    const typename Table::key_type* const keys,
+    const uint32_t* offset,
+    const uint32_t* fea_num,
+    const uint32_t* index,
+    const char* const grads,
+    char* merged_grads,
+    size_t len,
+    size_t grad_dim,
+    Sgd sgd,
+    size_t grad_value_size,
+    GPUAccessor gpu_accessor,
+    HostTierRange host_tier) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < len) {
+    uint32_t start = offset[i];
+    uint32_t num = fea_num[i];
+    float* out = reinterpret_cast<float*>(merged_grads + i * grad_value_size);
+    const float* in = reinterpret_cast<const float*>(
+        grads + size_t(index[start]) * grad_value_size);
+    gpu_accessor.PushValueFillBasic(out, in);
+    if (keys[i] != 0) {
+      for (uint32_t j = 1; j < num; ++j) {
+        in = reinterpret_cast<const float*>(
+            grads + size_t(index[start + j]) * grad_value_size);
+        gpu_accessor.MergePushValueBasic(out, in);
+      }
+    }
+    // same double accumulation as merge_gradients_embedx_kernel
+    uint32_t embedx_off = gpu_accessor.common_push_value.EmbedxGIndex();
+    for (size_t x = 0; x < grad_dim; ++x) {
+      double val = 0;
+      for (uint32_t j = 0; j < num; ++j) {
+        val += reinterpret_cast<const float*>(
+            grads + size_t(index[start + j]) *
+                        grad_value_size)[embedx_off + x];
+      }
+      out[embedx_off + x] = val;
+    }
+
+    auto it = table->find(keys[i]);
+    if (it != table->end()) {
+      if (host_tier.contains((it.getter())->second)) {
+        atomicAdd(&host_tier.hits[1], 1ULL);
+      }
+      sgd.dy_mf_update_value(optimizer_config, (it.getter())->second, out);
+    } else {
+      PADDLE_ENFORCE(false, "warning: push miss key: %lu", keys[i]);
+    }
+  }
+}
+
 template <typename Table>
 __global__ void get_keys_kernel(Table* table,
                                 typename Table::key_type* d_out,
@@ -330,6 +398,9 @@ template <typename KeyType, typename ValType>
 HashTable<KeyType, ValType>::~HashTable() {
   delete container_;
   cudaFree(device_optimizer_config_);
+  if (host_tier_.hits != nullptr) {
+    cudaFree(host_tier_.hits);
+  }
 }
 
 template <typename KeyType, typename ValType>
@@ -386,13 +457,28 @@ void HashTable<KeyType, ValType>::get(const KeyType* d_keys,
     return;
   }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
+  if (host_tier_.num > 0) {
+    host_tier_pull_keys_ += len;
+  }
   // infer need zero fill
   if (infer_mode_) {
     dy_mf_search_kernel_fill<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-        container_, d_keys, d_vals, len, pull_feature_value_size_, fv_accessor);
+        container_,
+        d_keys,
+        d_vals,
+        len,
+        pull_feature_value_size_,
+        fv_accessor,
+        host_tier_);
   } else {
     dy_mf_search_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
-        container_, d_keys, d_vals, len, pull_feature_value_size_, fv_accessor);
+        container_,
+        d_keys,
+        d_vals,
+        len,
+        pull_feature_value_size_,
+        fv_accessor,
+        host_tier_);
   }
 }
 
@@ -533,6 +619,9 @@ void HashTable<KeyType, ValType>::update(const KeyType* d_keys,
     return;
   }
   const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
+  if (host_tier_.num > 0) {
+    host_tier_push_keys_ += len;
+  }
   dy_mf_update_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
       container_,
       *device_optimizer_config_,
@@ -540,7 +629,83 @@ void HashTable<KeyType, ValType>::update(const KeyType* d_keys,
       d_grads,
       len,
       sgd,
-      push_grad_value_size_);
+      push_grad_value_size_,
+      host_tier_);
+}
+
+template <typename KeyType, typename ValType>
+template <typename Sgd, typename GPUAccessor, typename StreamType>
+void HashTable<KeyType, ValType>::merge_update(const KeyType* d_keys,
+                                               const uint32_t* d_offset,
+                                               const uint32_t* d_fea_num,
+                                               const uint32_t* d_sorted_idx,
+                                               const char* d_grads,
+                                               char* d_merged_grads,
+                                               size_t len,
+                                               size_t grad_dim,
+                                               Sgd sgd,
+                                               GPUAccessor gpu_accessor,
+                                               StreamType stream) {
+  if (len == 0) {
+    return;
+  }
+  const int grid_size = (len - 1) / BLOCK_SIZE_ + 1;
+  if (host_tier_.num > 0) {
+    host_tier_push_keys_ += len;
+  }
+  dy_mf_merge_update_kernel<<<grid_size, BLOCK_SIZE_, 0, stream>>>(
+      container_,
+      *device_optimizer_config_,
+      d_keys,
+      d_offset,
+      d_fea_num,
+      d_sorted_idx,
+      d_grads,
+      d_merged_grads,
+      len,
+      grad_dim,
+      sgd,
+      push_grad_value_size_,
+      gpu_accessor,
+      host_tier_);
+}
+
+template <typename KeyType, typename ValType>
+void HashTable<KeyType, ValType>::set_host_tier(int idx,
+                                                char* begin,
+                                                char* end) {
+  PADDLE_ENFORCE_LT(idx,
+                    HostTierRange::kMaxRanges,
+                    phi::errors::InvalidArgument(
+                        "host tier index %d exceeds %d pools per table",
+                        idx,
+                        HostTierRange::kMaxRanges));
+  if (host_tier_.hits == nullptr) {
+    CUDA_RT_CALL(cudaMalloc(reinterpret_cast<void**>(&host_tier_.hits),
+                            2 * sizeof(unsigned long long)));  // NOLINT
+    CUDA_RT_CALL(cudaMemset(
+        host_tier_.hits, 0, 2 * sizeof(unsigned long long)));  // NOLINT
+  }
+  host_tier_.begin[idx] = begin;
+  host_tier_.end[idx] = end;
+  host_tier_.num = std::max(host_tier_.num, idx + 1);
+}
+
+template <typename KeyType, typename ValType>
+void HashTable<KeyType, ValType>::show_host_tier(int id) {
+  if (host_tier_.hits == nullptr) {
+    return;
+  }
+  unsigned long long hits[2] = {0, 0};  // NOLINT
+  CUDA_RT_CALL(cudaMemcpy(
+      hits, host_tier_.hits, sizeof(hits), cudaMemcpyDeviceToHost));
+  uint64_t pull_keys = host_tier_pull_keys_;
+  uint64_t push_keys = host_tier_push_keys_;
+  VLOG(0) << "host tier stat for hbm table " << id << ", pull(" << pull_keys
+          << ":" << hits[0] << ":"
+          << (pull_keys == 0 ? 0.0 : 1.0 * hits[0] / pull_keys) << "), push("
+          << push_keys << ":" << hits[1] << ":"
+          << (push_keys == 0 ? 0.0 : 1.0 * hits[1] / push_keys) << ")";
 }
 
 template class HashTable<uint64_t, float>;
@@ -732,6 +897,81 @@ template void HashTable<uint64_t, float*>::update<
                   SparseAdamSharedOptimizer<CommonFeatureValueAccessor> sgd,
                   cudaStream_t stream);
 
+template void HashTable<uint64_t, float*>::merge_update<
+    SparseAdagradOptimizer<CommonFeatureValueAccessor>,
+    CommonFeatureValueAccessor,
+    cudaStream_t>(const uint64_t* d_keys,
+                  const uint32_t* d_offset,
+                  const uint32_t* d_fea_num,
+                  const uint32_t* d_sorted_idx,
+                  const char* d_grads,
+                  char* d_merged_grads,
+                  size_t len,
+                  size_t grad_dim,
+                  SparseAdagradOptimizer<CommonFeatureValueAccessor> sgd,
+                  CommonFeatureValueAccessor gpu_accessor,
+                  cudaStream_t stream);
+
+template void HashTable<uint64_t, float*>::merge_update<
+    SparseAdagradV2Optimizer<CommonFeatureValueAccessor>,
+    CommonFeatureValueAccessor,
+    cudaStream_t>(const uint64_t* d_keys,
+                  const uint32_t* d_offset,
+                  const uint32_t* d_fea_num,
+                  const uint32_t* d_sorted_idx,
+                  const char* d_grads,
+                  char* d_merged_grads,
+                  size_t len,
+                  size_t grad_dim,
+                  SparseAdagradV2Optimizer<CommonFeatureValueAccessor> sgd,
+                  CommonFeatureValueAccessor gpu_accessor,
+                  cudaStream_t stream);
+
+template void HashTable<uint64_t, float*>::merge_update<
+    StdAdagradOptimizer<CommonFeatureValueAccessor>,
+    CommonFeatureValueAccessor,
+    cudaStream_t>(const uint64_t* d_keys,
+                  const uint32_t* d_offset,
+                  const uint32_t* d_fea_num,
+                  const uint32_t* d_sorted_idx,
+                  const char* d_grads,
+                  char* d_merged_grads,
+                  size_t len,
+                  size_t grad_dim,
+                  StdAdagradOptimizer<CommonFeatureValueAccessor> sgd,
+                  CommonFeatureValueAccessor gpu_accessor,
+                  cudaStream_t stream);
+
+template void HashTable<uint64_t, float*>::merge_update<
+    SparseAdamOptimizer<CommonFeatureValueAccessor>,
+    CommonFeatureValueAccessor,
+    cudaStream_t>(const uint64_t* d_keys,
+                  const uint32_t* d_offset,
+                  const uint32_t* d_fea_num,
+                  const uint32_t* d_sorted_idx,
+                  const char* d_grads,
+                  char* d_merged_grads,
+                  size_t len,
+                  size_t grad_dim,
+                  SparseAdamOptimizer<CommonFeatureValueAccessor> sgd,
+                  CommonFeatureValueAccessor gpu_accessor,
+                  cudaStream_t stream);
+
+template void HashTable<uint64_t, float*>::merge_update<
+    SparseAdamSharedOptimizer<CommonFeatureValueAccessor>,
+    CommonFeatureValueAccessor,
+    cudaStream_t>(const uint64_t* d_keys,
+                  const uint32_t* d_offset,
+                  const uint32_t* d_fea_num,
+                  const uint32_t* d_sorted_idx,
+                  const char* d_grads,
+                  char* d_merged_grads,
+                  size_t len,
+                  size_t grad_dim,
+                  SparseAdamSharedOptimizer<CommonFeatureValueAccessor> sgd,
+                  CommonFeatureValueAccessor gpu_accessor,
+                  cudaStream_t stream);
+
 // template void HashTable<uint64_t,
 // paddle::framework::FeatureValue>::update<
 //    Optimizer<paddle::framework::FeatureValue,
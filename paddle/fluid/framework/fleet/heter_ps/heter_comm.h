@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "cub/cub.cuh"
@@ -128,8 +129,16 @@ class HeterComm {
   void show_one_table(int gpu_num);
   void show_table_collisions();
   int get_index_by_devid(int devid);
+  // device allocations made for the pull/push temporaries of card num, they
+  // stay flat once every workspace has grown to its high-water mark
+  uint64_t workspace_alloc_num(int num);
+  uint64_t workspace_alloc_bytes(int num);
+  void show_workspace_stat();
 
 #if defined(PADDLE_WITH_CUDA)
+  // values of the dim_idx-th pool of device num in [begin, end) live in
+  // host memory
+  void set_host_tier(int num, int dim_idx, char* begin, char* end);
   template <typename Sgd>
   void push_sparse(int num,
                    KeyType* d_keys,
@@ -165,6 +174,14 @@ class HeterComm {
                         GradType* d_grads,
                         size_t len,
                         Sgd& sgd);  // NOLINT
+  // dedups d_keys and applies the merged gradients to the local table of
+  // gpu_id with one fused kernel, all temporaries are cached per thread
+  template <typename Sgd>
+  void merge_update_one_table(int gpu_id,
+                              const KeyType* d_keys,
+                              const char* d_grads,
+                              size_t len,
+                              Sgd& sgd);  // NOLINT
 
   void set_nccl_comm_and_size(const std::vector<ncclComm_t>& inner_comms,
                               const std::vector<ncclComm_t>& inter_comms,
@@ -224,9 +241,21 @@ class HeterComm {
     int sync;
     size_t key_bytes_len;
     size_t val_bytes_len;
+    // bytes allocated behind key_storage and val_storage, kept across calls
+    size_t key_capacity = 0;
+    size_t val_capacity = 0;
     int dev_num;
   };
 
+  struct WorkspaceStat {
+    std::atomic<uint64_t> alloc_num{0};
+    std::atomic<uint64_t> alloc_bytes{0};
+    void add(size_t bytes) {
+      alloc_num.fetch_add(1, std::memory_order_relaxed);
+      alloc_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  };
+
   struct Path {
     std::vector<Node> nodes_;
   };
@@ -286,17 +315,25 @@ class HeterComm {
 
   struct LocalStorage {
     LocalStorage() { sem_wait = std::make_unique<Semaphore>(); }
-    void init(int device_num, int dev_id, phi::Stream stream) {
+    void init(int device_num,
+              int dev_id,
+              phi::Stream stream,
+              WorkspaceStat* stat) {
       place_ = platform::CUDAPlace(dev_id);
       h_recv_offsets.resize(device_num);
       h_fea_sizes.resize(device_num);
       stream_ = stream;
+      stat_ = stat;
     }
     template <typename T>
     T* alloc_cache(const size_t& len,
                    std::shared_ptr<memory::Allocation>& alloc,  // NOLINT
                    bool need_copy = false) {
       size_t need_mem = len * sizeof(T);
+      if (stat_ != nullptr &&
+          (alloc.get() == nullptr || need_mem > alloc->size())) {
+        stat_->add(need_mem);
+      }
       if (alloc.get() == nullptr) {
         alloc = memory::Alloc(place_, need_mem, stream_);
       } else if (need_mem > alloc->size()) {
@@ -382,6 +419,7 @@ class HeterComm {
     platform::XPUPlace place_;
 #endif
     phi::Stream stream_;
+    WorkspaceStat* stat_ = nullptr;
     std::shared_ptr<memory::Allocation> all_keys_mem = nullptr;
     std::shared_ptr<memory::Allocation> all_grads_mem = nullptr;
 
@@ -573,13 +611,16 @@ class HeterComm {
                                       const KeyType* d_in_keys,
                                       const cudaStream_t& stream,
                                       bool debug = false);
+  // with restore false the vals stay in d_tmp_vals in node shard order,
+  // for scatter_inner_vals_by_copy to restore together with its own merge
   void scatter_inter_vals_by_all2all(const int& gpu_id,
                                      const size_t& fea_size,
                                      const char* d_in_vals,
                                      void* d_out_vals,
                                      const size_t& value_bytes,
                                      void* d_tmp_vals,
-                                     const cudaStream_t& stream);
+                                     const cudaStream_t& stream,
+                                     bool restore = true);
   void recalc_local_and_remote_size(const int& gpu_id,
                                     const size_t& pull_size,
                                     const size_t& node_num,
@@ -659,12 +700,15 @@ class HeterComm {
                               const int& trans_id,
                               const size_t& value_bytes,
                               const cudaStream_t& stream);
+  // with d_inverse_idx set, the val of merged key k is
+  // d_in_vals[d_inverse_idx[k]]
   void scatter_inner_vals_by_copy(const int& gpu_id,
                                   const size_t& fea_size,
                                   const char* d_in_vals,
                                   void* d_out_vals,
                                   const size_t& value_bytes,
-                                  const cudaStream_t& stream);
+                                  const cudaStream_t& stream,
+                                  const uint32_t* d_inverse_idx = nullptr);
   void gather_inner_data_p2p(const size_t& total_fea_num,
                              const KeyType* d_keys,
                              const void* d_vals,
@@ -736,6 +780,8 @@ class HeterComm {
                 const size_t& byte_len) {
     if (alloc->get() == nullptr || byte_len > (*alloc)->size()) {
       alloc->reset();
+      workspace_stats_[resource_->get_index_by_devid(place.GetDeviceId())]
+          .add(byte_len);
       if (resource_->multi_mf()) {
         *alloc = memory::Alloc(place, byte_len);
       } else {
@@ -749,6 +795,8 @@ class HeterComm {
   template <typename TPlace>
   std::shared_ptr<memory::Allocation> MemoryAlloc(const TPlace& place,
                                                   const size_t& byte_len) {
+    workspace_stats_[resource_->get_index_by_devid(place.GetDeviceId())].add(
+        byte_len);
     if (resource_->multi_mf()) {
       return memory::Alloc(place, byte_len);
     } else {
@@ -773,6 +821,7 @@ class HeterComm {
  protected:
   int topo_aware_{0};
   std::vector<LocalStorage> storage_;
+  std::unique_ptr<WorkspaceStat[]> workspace_stats_;
   DynamicGradMerger merger_;
   int device_num_ = 8;
   int multi_node_{0};
@@ -31,6 +31,7 @@ COMMON_DECLARE_double(gpugraph_hbm_table_load_factor);
 COMMON_DECLARE_bool(gpugraph_enable_gpu_direct_access);
 COMMON_DECLARE_bool(gpugraph_enable_segment_merge_grads);
 COMMON_DECLARE_uint64(gpugraph_merge_grads_segment_size);
+COMMON_DECLARE_bool(gpugraph_enable_fused_push_update);
 COMMON_DECLARE_int32(gpugraph_dedup_pull_push_mode);
 COMMON_DECLARE_bool(enable_tracker_all2all);
 COMMON_DECLARE_bool(enable_all2all_use_fp16);
@@ -54,6 +55,7 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::HeterComm(
   resource_ = resource;
   device_num_ = resource_->total_device();
   storage_.resize(device_num_);
+  workspace_stats_.reset(new WorkspaceStat[device_num_]);
   multi_mf_dim_ = resource->multi_mf();
   load_factor_ = FLAGS_gpugraph_hbm_table_load_factor;
   multi_node_ = resource_->multi_node();
@@ -114,7 +116,8 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::HeterComm(
     if (multi_node_) {
       storage_[i].init(device_num_,
                        resource_->dev_id(i),
-                       phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+                       phi::Stream(reinterpret_cast<phi::StreamId>(stream)),
+                       &workspace_stats_[i]);
     }
   }
   barrier_.reset(device_num_);
@@ -134,6 +137,7 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::HeterComm(
   resource_ = resource;
   device_num_ = resource_->total_device();
   storage_.resize(device_num_);
+  workspace_stats_.reset(new WorkspaceStat[device_num_]);
   multi_mf_dim_ = resource->multi_mf();
   gpu_accessor_ = gpu_accessor;
   load_factor_ = FLAGS_gpugraph_hbm_table_load_factor;
@@ -196,7 +200,8 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::HeterComm(
     if (multi_node_) {
       storage_[i].init(device_num_,
                        resource_->dev_id(i),
-                       phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+                       phi::Stream(reinterpret_cast<phi::StreamId>(stream)),
+                       &workspace_stats_[i]);
     }
   }
   barrier_.reset(device_num_);
@@ -438,24 +443,42 @@ template <typename KeyType,
 void HeterComm<KeyType, ValType, GradType, GPUAccessor>::create_storage(
     int start_index, int end_index, size_t keylen, size_t vallen) {
 #if defined(PADDLE_WITH_CUDA)
+  // the storage of a path only grows, destroy_storage releases it
   auto &allocator = allocators_[start_index];
   auto &nodes = path_[start_index][end_index].nodes_;
   for (size_t i = 0; i < nodes.size(); ++i) {
-    platform::CUDADeviceGuard guard(resource_->dev_id(nodes[i].dev_num));
-    if (keylen > 0) {
+    int dev_id = resource_->dev_id(nodes[i].dev_num);
+    platform::CUDADeviceGuard guard(dev_id);
+    if (keylen > nodes[i].key_capacity) {
+      if (nodes[i].key_capacity > 0) {
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            allocator->DeviceFree(dev_id, nodes[i].key_storage));
+      }
       PADDLE_ENFORCE_GPU_SUCCESS(allocator->DeviceAllocate(
-          resource_->dev_id(nodes[i].dev_num),
+          dev_id,
           (void **)&(nodes[i].key_storage),  // NOLINT
           keylen,
           resource_->remote_stream(nodes[i].dev_num, start_index)));
+      nodes[i].key_capacity = keylen;
+      workspace_stats_[nodes[i].dev_num].add(keylen);
+    }
+    if (keylen > 0) {
       nodes[i].key_bytes_len = keylen;
     }
-    if (vallen > 0) {
+    if (vallen > nodes[i].val_capacity) {
+      if (nodes[i].val_capacity > 0) {
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            allocator->DeviceFree(dev_id, nodes[i].val_storage));
+      }
       PADDLE_ENFORCE_GPU_SUCCESS(allocator->DeviceAllocate(
-          resource_->dev_id(nodes[i].dev_num),
+          dev_id,
           (void **)&(nodes[i].val_storage),  // NOLINT
           vallen,
           resource_->remote_stream(nodes[i].dev_num, start_index)));
+      nodes[i].val_capacity = vallen;
+      workspace_stats_[nodes[i].dev_num].add(vallen);
+    }
+    if (vallen > 0) {
       nodes[i].val_bytes_len = vallen;
     }
   }
@@ -511,12 +534,18 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::destroy_storage(
   auto &allocator = allocators_[start_index];
   auto &nodes = path_[start_index][end_index].nodes_;
   for (size_t i = 0; i < nodes.size(); ++i) {
-    platform::CUDADeviceGuard guard(resource_->dev_id(nodes[i].dev_num));
-
-    PADDLE_ENFORCE_GPU_SUCCESS(allocator->DeviceFree(
-        resource_->dev_id(nodes[i].dev_num), nodes[i].key_storage));
-    PADDLE_ENFORCE_GPU_SUCCESS(allocator->DeviceFree(
-        resource_->dev_id(nodes[i].dev_num), nodes[i].val_storage));
+    int dev_id = resource_->dev_id(nodes[i].dev_num);
+    platform::CUDADeviceGuard guard(dev_id);
+    if (nodes[i].key_capacity > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          allocator->DeviceFree(dev_id, nodes[i].key_storage));
+      nodes[i].key_capacity = 0;
+    }
+    if (nodes[i].val_capacity > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          allocator->DeviceFree(dev_id, nodes[i].val_storage));
+      nodes[i].val_capacity = 0;
+    }
   }
 #endif
 }
@@ -721,6 +750,12 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::~HeterComm() {
   for (int i = 0; i < device_num_; ++i) {
     print_debug_time(i, true);
   }
+  show_workspace_stat();
+  for (size_t i = 0; i < path_.size(); ++i) {
+    for (size_t j = 0; j < path_[i].size(); ++j) {
+      destroy_storage(i, j);
+    }
+  }
   if (!multi_mf_dim_) {
     for (auto &table : tables_) {
       delete table;
@@ -738,6 +773,38 @@ HeterComm<KeyType, ValType, GradType, GPUAccessor>::~HeterComm() {
   }
 }
 
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+uint64_t
+HeterComm<KeyType, ValType, GradType, GPUAccessor>::workspace_alloc_num(
+    int num) {
+  return workspace_stats_[num].alloc_num.load(std::memory_order_relaxed);
+}
+
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+uint64_t
+HeterComm<KeyType, ValType, GradType, GPUAccessor>::workspace_alloc_bytes(
+    int num) {
+  return workspace_stats_[num].alloc_bytes.load(std::memory_order_relaxed);
+}
+
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::show_workspace_stat() {
+  for (int i = 0; i < device_num_; ++i) {
+    VLOG(1) << "gpu id=" << i
+            << ", workspace alloc num=" << workspace_alloc_num(i)
+            << ", alloc bytes=" << workspace_alloc_bytes(i);
+  }
+}
+
 template <typename KeyType,
           typename ValType,
           typename GradType,
@@ -769,6 +836,22 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
   }
 }
 
+#if defined(PADDLE_WITH_CUDA)
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::set_host_tier(
+    int num, int dim_idx, char *begin, char *end) {
+  PADDLE_ENFORCE_LT(
+      num,
+      static_cast<int>(ptr_tables_.size()),
+      paddle::platform::errors::InvalidArgument(
+          "dev num %d more than table num %d", num, ptr_tables_.size()));
+  ptr_tables_[num]->set_host_tier(dim_idx, begin, end);
+}
+#endif
+
 template <typename KeyType,
           typename ValType,
           typename GradType,
@@ -994,11 +1077,12 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::merge_grad(
   AnyDeviceGuard guard(dev_id);
   auto stream = resource_->local_stream(dev_num, 0);
   size_t temp_storage_bytes;
-  auto d_merge_keys = MemoryAlloc(place, len * sizeof(KeyType));
-  KeyType *d_merge_keys_ptr = reinterpret_cast<KeyType *>(d_merge_keys->ptr());
-  auto d_merge_grads = MemoryAlloc(place, len * sizeof(GradType));
+  thread_local std::shared_ptr<memory::Allocation> d_merge_keys = nullptr;
+  KeyType *d_merge_keys_ptr =
+      AllocCache<KeyType>(&d_merge_keys, place, len * sizeof(KeyType));
+  thread_local std::shared_ptr<memory::Allocation> d_merge_grads = nullptr;
   GradType *d_merge_grads_ptr =
-      reinterpret_cast<GradType *>(d_merge_grads->ptr());
+      AllocCache<GradType>(&d_merge_grads, place, len * sizeof(GradType));
   heter_comm_kernel_->sort_pairs(NULL,
                                  temp_storage_bytes,
                                  d_keys,
@@ -1011,8 +1095,10 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::merge_grad(
                                  8 * sizeof(KeyType),
                                  stream,
                                  false);
-  auto d_temp_storage = MemoryAlloc(place, temp_storage_bytes);
-  heter_comm_kernel_->sort_pairs(d_temp_storage->ptr(),
+  thread_local std::shared_ptr<memory::Allocation> d_temp_storage = nullptr;
+  void *d_temp_storage_ptr =
+      AllocCache<void>(&d_temp_storage, place, temp_storage_bytes);
+  heter_comm_kernel_->sort_pairs(d_temp_storage_ptr,
                                  temp_storage_bytes,
                                  d_keys,
                                  d_merge_keys_ptr,
@@ -1025,8 +1111,9 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::merge_grad(
                                  stream,
                                  false);
   temp_storage_bytes = 0;
-  auto d_num_runs_out_mem = MemoryAlloc(place, sizeof(int));
-  int *d_num_runs_out = reinterpret_cast<int *>(d_num_runs_out_mem->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_num_runs_out_mem = nullptr;
+  int *d_num_runs_out =
+      AllocCache<int>(&d_num_runs_out_mem, place, sizeof(int));
   heter_comm_kernel_->reduce_by_key(NULL,
                                     temp_storage_bytes,
                                     d_merge_keys_ptr,
@@ -1037,11 +1124,9 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::merge_grad(
                                     len,
                                     stream,
                                     false);
-  if (d_temp_storage->size() < temp_storage_bytes) {
-    d_temp_storage = NULL;
-    d_temp_storage = MemoryAlloc(place, temp_storage_bytes);
-  }
-  heter_comm_kernel_->reduce_by_key(d_temp_storage->ptr(),
+  d_temp_storage_ptr =
+      AllocCache<void>(&d_temp_storage, place, temp_storage_bytes);
+  heter_comm_kernel_->reduce_by_key(d_temp_storage_ptr,
                                     temp_storage_bytes,
                                     d_merge_keys_ptr,
                                     d_keys,
@@ -1081,11 +1166,13 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::dynamic_merge_grad(
       GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
   size_t grad_value_size = accessor_wrapper_ptr->GetPushValueSize(max_mf_dim_);
 
-  auto d_merge_keys = MemoryAlloc(place, len * sizeof(KeyType));
-  KeyType *d_merge_keys_ptr = reinterpret_cast<KeyType *>(d_merge_keys->ptr());
-  auto d_fea_num_info = MemoryAlloc(place, sizeof(uint32_t) * (len * 3 + 1));
-  uint32_t *d_fea_num_info_ptr =
-      reinterpret_cast<uint32_t *>(d_fea_num_info->ptr());
+  // cached per thread, push runs on the same worker thread every step
+  thread_local std::shared_ptr<memory::Allocation> d_merge_keys = nullptr;
+  KeyType *d_merge_keys_ptr =
+      AllocCache<KeyType>(&d_merge_keys, place, len * sizeof(KeyType));
+  thread_local std::shared_ptr<memory::Allocation> d_fea_num_info = nullptr;
+  uint32_t *d_fea_num_info_ptr = AllocCache<uint32_t>(
+      &d_fea_num_info, place, sizeof(uint32_t) * (len * 3 + 1));
   uint32_t *d_index = static_cast<uint32_t *>(&d_fea_num_info_ptr[len]);
   uint32_t *d_idx = reinterpret_cast<uint32_t *>(&d_index[len]);
   int *d_merged_size = reinterpret_cast<int *>(&d_idx[len]);
@@ -1102,9 +1189,11 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::dynamic_merge_grad(
                                       0,
                                       8 * sizeof(KeyType),
                                       stream));
-  auto d_temp_storage = MemoryAlloc(place, temp_storage_bytes);
+  thread_local std::shared_ptr<memory::Allocation> d_temp_storage = nullptr;
+  void *d_temp_storage_ptr =
+      AllocCache<void>(&d_temp_storage, place, temp_storage_bytes);
   PADDLE_ENFORCE_GPU_SUCCESS(
-      cub::DeviceRadixSort::SortPairs(d_temp_storage->ptr(),
+      cub::DeviceRadixSort::SortPairs(d_temp_storage_ptr,
                                       temp_storage_bytes,
                                       d_keys,
                                       d_merge_keys_ptr,
@@ -1126,12 +1215,10 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::dynamic_merge_grad(
                                          d_merged_size,
                                          len,
                                          stream));
-  if (d_temp_storage->size() < temp_storage_bytes) {
-    d_temp_storage = NULL;
-    d_temp_storage = MemoryAlloc(place, temp_storage_bytes);
-  }
+  d_temp_storage_ptr =
+      AllocCache<void>(&d_temp_storage, place, temp_storage_bytes);
   PADDLE_ENFORCE_GPU_SUCCESS(
-      cub::DeviceRunLengthEncode::Encode(d_temp_storage->ptr(),
+      cub::DeviceRunLengthEncode::Encode(d_temp_storage_ptr,
                                          temp_storage_bytes,
                                          d_merge_keys_ptr,
                                          d_keys,
@@ -1156,12 +1243,10 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::dynamic_merge_grad(
                                                            d_offset,
                                                            uniq_len,
                                                            stream));
-  if (d_temp_storage->size() < temp_storage_bytes) {
-    d_temp_storage = NULL;
-    d_temp_storage = MemoryAlloc(place, temp_storage_bytes);
-  }
+  d_temp_storage_ptr =
+      AllocCache<void>(&d_temp_storage, place, temp_storage_bytes);
   PADDLE_ENFORCE_GPU_SUCCESS(
-      cub::DeviceScan::ExclusiveSum(d_temp_storage->ptr(),
+      cub::DeviceScan::ExclusiveSum(d_temp_storage_ptr,
                                     temp_storage_bytes,
                                     d_fea_num_info_ptr,
                                     d_offset,
@@ -1185,8 +1270,9 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::dynamic_merge_grad(
                                                stream));
     PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
   } else {
-    auto d_merge_grads = MemoryAlloc(place, len * grad_value_size);
-    float *d_merge_grads_ptr = reinterpret_cast<float *>(d_merge_grads->ptr());
+    thread_local std::shared_ptr<memory::Allocation> d_merge_grads = nullptr;
+    float *d_merge_grads_ptr =
+        AllocCache<float>(&d_merge_grads, place, len * grad_value_size);
     // copy merge keys to d_keys
     PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(d_keys,
                                                d_merge_keys_ptr,
@@ -1242,17 +1328,21 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::segment_merge_grad(
       GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
   size_t grad_value_size = accessor_wrapper_ptr->GetPushValueSize(max_mf_dim_);
 
-  auto d_buffer1 = MemoryAlloc(place, sizeof(uint32_t) * len);
-  auto d_segments = reinterpret_cast<uint32_t *>(d_buffer1->ptr());
-  auto d_buffer2 = MemoryAlloc(place, sizeof(uint32_t) * len);
-  auto d_segments_offset = reinterpret_cast<uint32_t *>(d_buffer2->ptr());
-  auto d_buffer3 = MemoryAlloc(place, sizeof(uint32_t) * len);
-  auto d_segments_fea_num_info = reinterpret_cast<uint32_t *>(d_buffer3->ptr());
-  auto d_buffer4 = MemoryAlloc(place, sizeof(uint32_t) * len);
-  auto d_segments_fea_num_offset =
-      reinterpret_cast<uint32_t *>(d_buffer4->ptr());
-  auto d_buffer5 = MemoryAlloc(place, sizeof(uint32_t));
-  auto d_segments_num = reinterpret_cast<uint32_t *>(d_buffer5->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_buffer1 = nullptr;
+  uint32_t *d_segments =
+      AllocCache<uint32_t>(&d_buffer1, place, sizeof(uint32_t) * len);
+  thread_local std::shared_ptr<memory::Allocation> d_buffer2 = nullptr;
+  uint32_t *d_segments_offset =
+      AllocCache<uint32_t>(&d_buffer2, place, sizeof(uint32_t) * len);
+  thread_local std::shared_ptr<memory::Allocation> d_buffer3 = nullptr;
+  uint32_t *d_segments_fea_num_info =
+      AllocCache<uint32_t>(&d_buffer3, place, sizeof(uint32_t) * len);
+  thread_local std::shared_ptr<memory::Allocation> d_buffer4 = nullptr;
+  uint32_t *d_segments_fea_num_offset =
+      AllocCache<uint32_t>(&d_buffer4, place, sizeof(uint32_t) * len);
+  thread_local std::shared_ptr<memory::Allocation> d_buffer5 = nullptr;
+  uint32_t *d_segments_num =
+      AllocCache<uint32_t>(&d_buffer5, place, sizeof(uint32_t));
   CUDA_CHECK(cudaMemsetAsync(d_segments_num, 0, sizeof(uint32_t), stream));
 
   uint32_t segment_size = FLAGS_gpugraph_merge_grads_segment_size;
@@ -1267,8 +1357,10 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::segment_merge_grad(
   size_t temp_storage_bytes = 0;
   PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceReduce::Sum(
       NULL, temp_storage_bytes, d_segments, d_segments_num, uniq_len, stream));
-  auto d_temp_storage = MemoryAlloc(place, temp_storage_bytes);
-  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceReduce::Sum(d_temp_storage->ptr(),
+  thread_local std::shared_ptr<memory::Allocation> d_temp_storage = nullptr;
+  void *d_temp_storage_ptr =
+      AllocCache<void>(&d_temp_storage, place, temp_storage_bytes);
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceReduce::Sum(d_temp_storage_ptr,
                                                     temp_storage_bytes,
                                                     d_segments,
                                                     d_segments_num,
@@ -1288,12 +1380,10 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::segment_merge_grad(
                                                            d_segments_offset,
                                                            uniq_len,
                                                            stream));
-  if (d_temp_storage->size() < temp_storage_bytes) {
-    d_temp_storage = NULL;
-    d_temp_storage = MemoryAlloc(place, temp_storage_bytes);
-  }
+  d_temp_storage_ptr =
+      AllocCache<void>(&d_temp_storage, place, temp_storage_bytes);
   PADDLE_ENFORCE_GPU_SUCCESS(
-      cub::DeviceScan::ExclusiveSum(d_temp_storage->ptr(),
+      cub::DeviceScan::ExclusiveSum(d_temp_storage_ptr,
                                     temp_storage_bytes,
                                     d_segments,
                                     d_segments_offset,
@@ -1316,12 +1406,10 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::segment_merge_grad(
                                     d_segments_fea_num_offset,
                                     segments_num,
                                     stream));
-  if (d_temp_storage->size() < temp_storage_bytes) {
-    d_temp_storage = NULL;
-    d_temp_storage = MemoryAlloc(place, temp_storage_bytes);
-  }
+  d_temp_storage_ptr =
+      AllocCache<void>(&d_temp_storage, place, temp_storage_bytes);
   PADDLE_ENFORCE_GPU_SUCCESS(
-      cub::DeviceScan::ExclusiveSum(d_temp_storage->ptr(),
+      cub::DeviceScan::ExclusiveSum(d_temp_storage_ptr,
                                     temp_storage_bytes,
                                     d_segments_fea_num_info,
                                     d_segments_fea_num_offset,
@@ -1329,9 +1417,9 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::segment_merge_grad(
                                     stream));
   PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
 
-  auto d_segments_keys = MemoryAlloc(place, sizeof(KeyType) * segments_num);
-  auto d_segments_keys_ptr =
-      reinterpret_cast<KeyType *>(d_segments_keys->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_segments_keys = nullptr;
+  KeyType *d_segments_keys_ptr = AllocCache<KeyType>(
+      &d_segments_keys, place, sizeof(KeyType) * segments_num);
   heter_comm_kernel_->shrink_keys(d_keys,
                                   d_segments_fea_num_offset,
                                   d_segments_keys_ptr,
@@ -1339,8 +1427,9 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::segment_merge_grad(
                                   stream);
   PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
 
-  auto d_segment_grads = MemoryAlloc(place, segments_num * grad_value_size);
-  auto d_segment_grads_ptr = reinterpret_cast<float *>(d_segment_grads->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_segment_grads = nullptr;
+  float *d_segment_grads_ptr = AllocCache<float>(
+      &d_segment_grads, place, segments_num * grad_value_size);
   heter_comm_kernel_->merge_gradient(
       d_segments_keys_ptr,
       d_segments_fea_num_offset,
@@ -1496,10 +1585,12 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_merge_sparse(
   int h_left[total_device];   // NOLINT
   int h_right[total_device];  // NOLINT
 
-  auto d_left = MemoryAlloc(place, total_device * sizeof(int));
-  auto d_right = MemoryAlloc(place, total_device * sizeof(int));
-  int *d_left_ptr = reinterpret_cast<int *>(d_left->ptr());
-  int *d_right_ptr = reinterpret_cast<int *>(d_right->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_left = nullptr;
+  thread_local std::shared_ptr<memory::Allocation> d_right = nullptr;
+  int *d_left_ptr =
+      AllocCache<int>(&d_left, place, total_device * sizeof(int));
+  int *d_right_ptr =
+      AllocCache<int>(&d_right, place, total_device * sizeof(int));
 
 #if defined(PADDLE_WITH_CUDA)
   cudaMemsetAsync(d_left_ptr, -1, total_device * sizeof(int), stream);
@@ -1530,16 +1621,21 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_merge_sparse(
       GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
   size_t val_type_size = accessor_wrapper_ptr->GetPullValueSize(max_mf_dim_);
   VLOG(3) << "pull_sparse len:" << len << "  val_type_size: " << val_type_size;
-  auto d_sorted_keys = MemoryAlloc(place, len * sizeof(KeyType));
-  auto d_sorted_keys_ptr = reinterpret_cast<KeyType *>(d_sorted_keys->ptr());
-  auto d_merged_keys = MemoryAlloc(place, len * sizeof(KeyType));
-  auto d_merged_keys_ptr = reinterpret_cast<KeyType *>(d_merged_keys->ptr());
-  auto d_restore_idx = MemoryAlloc(place, len * sizeof(uint32_t));
-  auto d_restore_idx_ptr = reinterpret_cast<uint32_t *>(d_restore_idx->ptr());
-  auto d_shard_keys = MemoryAlloc(place, len * sizeof(KeyType));
-  auto d_shard_keys_ptr = reinterpret_cast<KeyType *>(d_shard_keys->ptr());
-  auto d_shard_vals = MemoryAlloc(place, len * val_type_size);
-  auto d_shard_vals_ptr = reinterpret_cast<float *>(d_shard_vals->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_sorted_keys = nullptr;
+  KeyType *d_sorted_keys_ptr =
+      AllocCache<KeyType>(&d_sorted_keys, place, len * sizeof(KeyType));
+  thread_local std::shared_ptr<memory::Allocation> d_merged_keys = nullptr;
+  KeyType *d_merged_keys_ptr =
+      AllocCache<KeyType>(&d_merged_keys, place, len * sizeof(KeyType));
+  thread_local std::shared_ptr<memory::Allocation> d_restore_idx = nullptr;
+  uint32_t *d_restore_idx_ptr =
+      AllocCache<uint32_t>(&d_restore_idx, place, len * sizeof(uint32_t));
+  thread_local std::shared_ptr<memory::Allocation> d_shard_keys = nullptr;
+  KeyType *d_shard_keys_ptr =
+      AllocCache<KeyType>(&d_shard_keys, place, len * sizeof(KeyType));
+  thread_local std::shared_ptr<memory::Allocation> d_shard_vals = nullptr;
+  float *d_shard_vals_ptr =
+      AllocCache<float>(&d_shard_vals, place, len * val_type_size);
 
   size_t uniq_len = merge_keys(num,
                                d_keys,
@@ -1550,8 +1646,8 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_merge_sparse(
                                stream);
   sync_stream(stream);
 
-  auto d_idx = MemoryAlloc(place, uniq_len * sizeof(int));
-  auto d_idx_ptr = reinterpret_cast<int *>(d_idx->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_idx = nullptr;
+  int *d_idx_ptr = AllocCache<int>(&d_idx, place, uniq_len * sizeof(int));
   split_idx_to_shard(d_merged_keys_ptr,
                      d_idx_ptr,
                      uniq_len,
@@ -1632,8 +1728,9 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_merge_sparse(
   }
 
   AnyDeviceGuard guard2(dev_id);
-  auto d_merged_vals = MemoryAlloc(place, uniq_len * val_type_size);
-  auto d_merged_vals_ptr = reinterpret_cast<float *>(d_merged_vals->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_merged_vals = nullptr;
+  float *d_merged_vals_ptr =
+      AllocCache<float>(&d_merged_vals, place, uniq_len * val_type_size);
   heter_comm_kernel_->dy_mf_fill_dvals(d_shard_vals_ptr,
                                        d_merged_vals_ptr,
                                        d_idx_ptr,
@@ -1650,15 +1747,6 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_merge_sparse(
                                          val_type_size,
                                          stream);
   sync_stream(stream);
-
-  if (!enable_gpu_direct_access_) {
-    for (int i = 0; i < total_device; ++i) {
-      if (h_left[i] == -1 || h_right[i] == -1) {
-        continue;
-      }
-      destroy_storage(num, i);
-    }
-  }
 }
 template <typename KeyType,
           typename ValType,
@@ -1675,10 +1763,12 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_normal_sparse(
   int h_left[total_device];   // NOLINT
   int h_right[total_device];  // NOLINT
 
-  auto d_left = MemoryAlloc(place, total_device * sizeof(int));
-  auto d_right = MemoryAlloc(place, total_device * sizeof(int));
-  int *d_left_ptr = reinterpret_cast<int *>(d_left->ptr());
-  int *d_right_ptr = reinterpret_cast<int *>(d_right->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_left = nullptr;
+  thread_local std::shared_ptr<memory::Allocation> d_right = nullptr;
+  int *d_left_ptr =
+      AllocCache<int>(&d_left, place, total_device * sizeof(int));
+  int *d_right_ptr =
+      AllocCache<int>(&d_right, place, total_device * sizeof(int));
 
 #if defined(PADDLE_WITH_CUDA)
   cudaMemsetAsync(d_left_ptr, -1, total_device * sizeof(int), stream);
@@ -1705,17 +1795,19 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_normal_sparse(
                         XPUAPIErrorMsg[r2]));
 #endif
 
-  auto d_idx = MemoryAlloc(place, len * sizeof(int));
-  int *d_idx_ptr = reinterpret_cast<int *>(d_idx->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_idx = nullptr;
+  int *d_idx_ptr = AllocCache<int>(&d_idx, place, len * sizeof(int));
 
   auto accessor_wrapper_ptr =
       GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
   size_t val_type_size = accessor_wrapper_ptr->GetPullValueSize(max_mf_dim_);
   VLOG(3) << "pull_sparse len:" << len << "  val_type_size: " << val_type_size;
-  auto d_shard_keys = MemoryAlloc(place, len * sizeof(KeyType));
-  KeyType *d_shard_keys_ptr = reinterpret_cast<KeyType *>(d_shard_keys->ptr());
-  auto d_shard_vals = MemoryAlloc(place, len * val_type_size);
-  float *d_shard_vals_ptr = reinterpret_cast<float *>(d_shard_vals->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_shard_keys = nullptr;
+  KeyType *d_shard_keys_ptr =
+      AllocCache<KeyType>(&d_shard_keys, place, len * sizeof(KeyType));
+  thread_local std::shared_ptr<memory::Allocation> d_shard_vals = nullptr;
+  float *d_shard_vals_ptr =
+      AllocCache<float>(&d_shard_vals, place, len * val_type_size);
 
   split_idx_to_shard(
       d_keys, d_idx_ptr, len, d_left_ptr, d_right_ptr, num, stream);
@@ -1795,15 +1887,6 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_normal_sparse(
       d_shard_vals_ptr, d_vals, d_idx_ptr, len, val_type_size, stream);
 
   sync_stream(stream);
-
-  if (!enable_gpu_direct_access_) {
-    for (int i = 0; i < total_device; ++i) {
-      if (h_left[i] == -1 || h_right[i] == -1) {
-        continue;
-      }
-      destroy_storage(num, i);
-    }
-  }
 }
 
 template <typename KeyType,
@@ -1875,13 +1958,26 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::push_normal_sparse(
   AnyDeviceGuard guard(dev_id);
   auto stream = resource_->local_stream(dev_num, 0);
 
+  if (FLAGS_gpugraph_enable_fused_push_update && total_device == 1 &&
+      multi_mf_dim_) {
+    // every key lives on the local table, so no shard grads are needed
+    merge_update_one_table(dev_num,
+                           d_keys,
+                           reinterpret_cast<const char *>(d_grads),
+                           len,
+                           sgd);
+    return;
+  }
+
   int h_left[total_device];   // NOLINT
   int h_right[total_device];  // NOLINT
 
-  auto d_left = MemoryAlloc(place, total_device * sizeof(int));
-  auto d_right = MemoryAlloc(place, total_device * sizeof(int));
-  int *d_left_ptr = reinterpret_cast<int *>(d_left->ptr());
-  int *d_right_ptr = reinterpret_cast<int *>(d_right->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_left = nullptr;
+  thread_local std::shared_ptr<memory::Allocation> d_right = nullptr;
+  int *d_left_ptr =
+      AllocCache<int>(&d_left, place, total_device * sizeof(int));
+  int *d_right_ptr =
+      AllocCache<int>(&d_right, place, total_device * sizeof(int));
 
 #if defined(PADDLE_WITH_CUDA)
   cudaMemsetAsync(d_left_ptr, -1, total_device * sizeof(int), stream);
@@ -1908,15 +2004,16 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::push_normal_sparse(
                         XPUAPIErrorMsg[r2]));
 #endif
 
-  auto d_idx = MemoryAlloc(place, len * sizeof(int));
-  int *d_idx_ptr = reinterpret_cast<int *>(d_idx->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_idx = nullptr;
+  int *d_idx_ptr = AllocCache<int>(&d_idx, place, len * sizeof(int));
 
-  auto d_shard_keys = MemoryAlloc(place, len * sizeof(KeyType));
-  KeyType *d_shard_keys_ptr = reinterpret_cast<KeyType *>(d_shard_keys->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_shard_keys = nullptr;
+  KeyType *d_shard_keys_ptr =
+      AllocCache<KeyType>(&d_shard_keys, place, len * sizeof(KeyType));
 
-  float *d_shard_grads_ptr;
-  auto d_shard_grads = MemoryAlloc(place, len * grad_value_size);
-  d_shard_grads_ptr = reinterpret_cast<float *>(d_shard_grads->ptr());
+  thread_local std::shared_ptr<memory::Allocation> d_shard_grads = nullptr;
+  float *d_shard_grads_ptr =
+      AllocCache<float>(&d_shard_grads, place, len * grad_value_size);
 
   int uniq_len = len;
   if (!FLAGS_gpugraph_dedup_pull_push_mode) {
@@ -2021,15 +2118,6 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::push_normal_sparse(
       ptr_tables_[i]->rwlock_->UNLock();
     }
   }
-
-  if (!enable_gpu_direct_access_) {
-    for (int i = 0; i < total_device; ++i) {
-      if (h_left[i] == -1 || h_right[i] == -1) {
-        continue;
-      }
-      destroy_storage(dev_num, i);
-    }
-  }
 }
 
 #elif defined(PADDLE_WITH_XPU_KP)
@@ -2204,6 +2292,70 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::update_one_table(
   }
   cudaStreamSynchronize(stream);
 }
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+template <typename Sgd>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::merge_update_one_table(
+    int gpu_id,
+    const KeyType *d_keys,
+    const char *d_grads,
+    size_t len,
+    Sgd &sgd) {  // NOLINT
+  if (len == 0) {
+    return;
+  }
+  int dev_id = resource_->dev_id(gpu_id);
+  platform::CUDADeviceGuard guard(dev_id);
+  auto place = platform::CUDAPlace(dev_id);
+  auto stream = resource_->local_stream(gpu_id, 0);
+
+  thread_local std::shared_ptr<memory::Allocation> d_fea_num_info = nullptr;
+  uint32_t *d_offset =
+      AllocCache<uint32_t>(&d_fea_num_info, place, sizeof(uint32_t) * len * 4);
+  uint32_t *d_sorted_idx = &d_offset[len];
+  uint32_t *d_restore_idx = &d_sorted_idx[len];
+  uint32_t *d_merged_cnts = &d_restore_idx[len];
+
+  thread_local std::shared_ptr<memory::Allocation> d_keys_ptr = nullptr;
+  KeyType *d_sorted_keys =
+      AllocCache<KeyType>(&d_keys_ptr, place, sizeof(KeyType) * len * 2);
+  KeyType *d_merged_keys = &d_sorted_keys[len];
+
+  thread_local std::shared_ptr<memory::Allocation> d_merged_grads_ptr =
+      nullptr;
+  char *d_merged_grads =
+      AllocCache<char>(&d_merged_grads_ptr, place, grad_type_size_ * len);
+
+  size_t uniq_len = dedup_keys_and_fillidx(gpu_id,
+                                           len,
+                                           d_keys,
+                                           d_merged_keys,
+                                           d_sorted_keys,
+                                           d_restore_idx,
+                                           d_sorted_idx,
+                                           d_offset,
+                                           d_merged_cnts,
+                                           false,
+                                           stream);
+
+  auto &table = ptr_tables_[gpu_id];
+  table->rwlock_->WRLock();
+  table->merge_update(d_merged_keys,
+                      d_offset,
+                      d_merged_cnts,
+                      d_sorted_idx,
+                      d_grads,
+                      d_merged_grads,
+                      uniq_len,
+                      max_mf_dim_,
+                      sgd,
+                      gpu_accessor_,
+                      stream);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+  table->rwlock_->UNLock();
+}
 #endif
 
 template <typename KeyType,
@@ -2213,6 +2365,7 @@ template <typename KeyType,
 void HeterComm<KeyType, ValType, GradType, GPUAccessor>::end_pass() {
   int total_device = resource_->total_device();
   std::vector<std::thread> threads;
+  show_workspace_stat();
 
   auto dump_to_cpu_func = [this](int index) {
     auto stream = resource_->local_stream(index, 0);
@@ -2455,20 +2608,42 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_sparse_all2all(
 
       PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
     } else {
+      // leave the vals in node shard order, the inner scatter restores them
+      // in the same pass as the inner merge
       scatter_inter_vals_by_all2all(gpu_id,
                                     gather_inner_size,
                                     loc.d_merged_vals,
                                     loc.d_merged_vals,
                                     pull_type_size_,
                                     loc.d_merged_push_vals,
-                                    stream);
+                                    stream,
+                                    false);
     }
     loc.node_span_.Pause();
 
     // innter scatter
     loc.inner_span_.Resume();
-    scatter_inner_vals_by_copy(
-        gpu_id, fea_num, loc.d_merged_vals, d_vals, pull_type_size_, stream);
+    if (FLAGS_enable_all2all_use_fp16) {
+      scatter_inner_vals_by_copy(
+          gpu_id, fea_num, loc.d_merged_vals, d_vals, pull_type_size_, stream);
+    } else {
+      thread_local std::shared_ptr<memory::Allocation> d_inverse_tmp = nullptr;
+      uint32_t *d_inverse_idx =
+          AllocCache<uint32_t>(&d_inverse_tmp,
+                               DevPlace(resource_->dev_id(gpu_id)),
+                               (gather_inner_size + 1) * sizeof(uint32_t));
+      heter_comm_kernel_->fill_inverse_idx(loc.shard_res.d_local_idx_parted,
+                                           d_inverse_idx,
+                                           gather_inner_size,
+                                           stream);
+      scatter_inner_vals_by_copy(gpu_id,
+                                 fea_num,
+                                 loc.d_merged_push_vals,
+                                 d_vals,
+                                 pull_type_size_,
+                                 stream,
+                                 d_inverse_idx);
+    }
     loc.inner_span_.Pause();
   } else {
     loc.alloc(fea_num, max_type_size_);
@@ -3030,7 +3205,8 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
                                   void *d_out_vals,
                                   const size_t &value_bytes,
                                   void *d_tmp_vals,
-                                  const cudaStream_t &stream) {
+                                  const cudaStream_t &stream,
+                                  bool restore) {
   AnyDeviceGuard guard(resource_->dev_id(gpu_id));
   auto &cache = storage_[gpu_id];
   auto &res = cache.shard_res;
@@ -3066,6 +3242,9 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
     cache.node_trans_.Pause();
   }
   PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+  if (!restore) {
+    return;
+  }
 
   // fill vals
   heter_comm_kernel_->scatter_vals(
@@ -3241,17 +3420,35 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
                                const char *d_in_vals,
                                void *d_out_vals,
                                const size_t &value_bytes,
-                               const cudaStream_t &stream) {
+                               const cudaStream_t &stream,
+                               const uint32_t *d_inverse_idx) {
   AnyDeviceGuard guard(resource_->dev_id(gpu_id));
   auto &my_cache = storage_[gpu_id];
+  // shard ordered vals sit in d_merged_push_vals, the restored ones and the
+  // peers' copies swap buffers then. every gpu takes the same branch.
+  bool fused = (d_inverse_idx != nullptr);
+  auto gather_buf = [fused](const LocalStorage &cache) {
+    return fused ? cache.d_merged_vals : cache.d_merged_push_vals;
+  };
   // restore vals
-  heter_comm_kernel_->gather_vals(
-      reinterpret_cast<float *>(my_cache.d_merged_push_vals),  // out
-      reinterpret_cast<const float *>(d_in_vals),              // in
-      my_cache.pull_res.d_restore_keys_idx,
-      my_cache.pull_res.h_recv_fea_num,
-      value_bytes,
-      stream);
+  if (fused) {
+    heter_comm_kernel_->gather_vals_by_inverse_idx(
+        reinterpret_cast<float *>(gather_buf(my_cache)),  // out
+        reinterpret_cast<const float *>(d_in_vals),       // in
+        d_inverse_idx,
+        my_cache.pull_res.d_restore_keys_idx,
+        my_cache.pull_res.h_recv_fea_num,
+        value_bytes,
+        stream);
+  } else {
+    heter_comm_kernel_->gather_vals(
+        reinterpret_cast<float *>(gather_buf(my_cache)),  // out
+        reinterpret_cast<const float *>(d_in_vals),       // in
+        my_cache.pull_res.d_restore_keys_idx,
+        my_cache.pull_res.h_recv_fea_num,
+        value_bytes,
+        stream);
+  }
   PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
 
   auto &res = my_cache.inner_res;
@@ -3267,7 +3464,7 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
   for (int i = 0; i < device_num_; ++i) {
     auto &cache = storage_[i];
     size_t &recv_offset = cache.h_recv_offsets[gpu_id];
-    res.d_remote_vals[i] = &cache.d_merged_push_vals[recv_offset * value_bytes];
+    res.d_remote_vals[i] = &gather_buf(cache)[recv_offset * value_bytes];
     if (trans_id >= 0) {
       // set transfer buffer
       auto &trans_cache = storage_[trans_id];
@@ -3276,7 +3473,8 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
                .d_merged_push_vals[trans_cache.h_trans_offset * value_bytes];
     }
   }
-  res.d_vals_parted = my_cache.d_merged_vals;
+  res.d_vals_parted =
+      fused ? my_cache.d_merged_push_vals : my_cache.d_merged_vals;
   my_cache.inner_barrier_.Resume();
   // barrier wait set buffer ptr
   barrier_.wait();
@@ -3541,6 +3739,19 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::push_sparse_all2all(
     VLOG(0) << "push gpu id=" << gpu_id
             << ", gather_sparse_gradient_by_all2all len=" << node_push_len;
   }
+  if (FLAGS_gpugraph_enable_fused_push_update &&
+      FLAGS_enable_sparse_inner_gather && multi_mf_dim_ &&
+      !FLAGS_enable_tracker_all2all) {
+    // merge and update the local table in one kernel
+    merge_update_one_table(
+        gpu_id,
+        my_cache.d_merged_push_keys,
+        reinterpret_cast<const char *>(my_cache.d_merged_push_vals),
+        node_push_len,
+        sgd);
+    my_cache.all2all_span_.Pause();
+    return;
+  }
   // all embedx merge
   size_t uniq_len = merge_grad(gpu_id,
                                node_push_len,
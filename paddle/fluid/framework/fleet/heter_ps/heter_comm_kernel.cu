@@ -335,6 +335,32 @@ __global__ void scatter_dvals_by_unit_kernel(TUnit* d_dest_vals,
   }
 }
 
+template <typename T>
+__global__ void fill_inverse_idx_kernel(const T* idx,
+                                        T* inverse_idx,
+                                        size_t len) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < len) {
+    inverse_idx[idx[i]] = i;
+  }
+}
+
+template <typename TUnit, typename T>
+__global__ void gather_dvals_by_inverse_unit_kernel(
+    TUnit* d_dest_vals,
+    const TUnit* d_src_vals,
+    const T* inverse_idx,
+    const T* idx,
+    size_t len,
+    const size_t val_size_unit) {
+  const size_t i = blockIdx.x * blockDim.x + threadIdx.x;
+  if (i < len) {
+    size_t pos = size_t(inverse_idx[idx[i / val_size_unit]]) * val_size_unit +
+                 (i % val_size_unit);
+    d_dest_vals[i] = d_src_vals[pos];
+  }
+}
+
 // cuda implemention of  heter_comm_kernel.h
 template <typename T, typename StreamType>
 void HeterCommKernel::fill_idx(T* idx,
@@ -773,6 +799,38 @@ void HeterCommKernel::scatter_vals(const ValType* d_shard_vals,
       d_vals, d_shard_vals, idx, N, val_size_unit);
 }
 
+template <typename StreamType>
+void HeterCommKernel::fill_inverse_idx(const uint32_t* idx,
+                                       uint32_t* d_inverse_idx,
+                                       int64_t len,
+                                       const StreamType& stream) {
+  if (len <= 0) {
+    return;
+  }
+  size_t N = len;
+  int grid_size = (N - 1) / block_size_ + 1;
+  fill_inverse_idx_kernel<<<grid_size, block_size_, 0, stream>>>(
+      idx, d_inverse_idx, N);
+}
+template <typename StreamType>
+void HeterCommKernel::gather_vals_by_inverse_idx(float* d_shard_vals,
+                                                 const float* d_vals,
+                                                 const uint32_t* inverse_idx,
+                                                 const uint32_t* idx,
+                                                 int64_t len,
+                                                 size_t value_bytes,
+                                                 const StreamType& stream) {
+  if (len <= 0) {
+    return;
+  }
+  const size_t value_size_float = size_t(value_bytes / sizeof(float));
+  size_t N = len * value_size_float;
+  int grid_size = (N - 1) / block_size_ + 1;
+  // d_vals -> d_shard_vals
+  gather_dvals_by_inverse_unit_kernel<<<grid_size, block_size_, 0, stream>>>(
+      d_shard_vals, d_vals, inverse_idx, idx, N, value_size_float);
+}
+
 template <typename KeyType>
 __global__ void check_valid_values_kernel(const int type,
                                           const size_t N,
@@ -1485,6 +1543,19 @@ template void HeterCommKernel::scatter_vals<uint8_t, cudaStream_t>(
     int64_t len,
     size_t value_bytes,
     const cudaStream_t& stream);
+template void HeterCommKernel::fill_inverse_idx<cudaStream_t>(
+    const uint32_t* idx,
+    uint32_t* d_inverse_idx,
+    int64_t len,
+    const cudaStream_t& stream);
+template void HeterCommKernel::gather_vals_by_inverse_idx<cudaStream_t>(
+    float* d_shard_vals,
+    const float* d_vals,
+    const uint32_t* inverse_idx,
+    const uint32_t* idx,
+    int64_t len,
+    size_t value_bytes,
+    const cudaStream_t& stream);
 template void HeterCommKernel::check_valid_values<int32_t, cudaStream_t>(
     const int& type,
     const size_t& N,
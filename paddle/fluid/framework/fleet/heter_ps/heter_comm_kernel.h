@@ -299,6 +299,22 @@ class HeterCommKernel {
                     int64_t len,
                     size_t value_bytes,
                     const StreamType& stream);
+  // d_inverse_idx[idx[i]] = i
+  template <typename StreamType>
+  void fill_inverse_idx(const uint32_t* idx,
+                        uint32_t* d_inverse_idx,
+                        int64_t len,
+                        const StreamType& stream);
+  // d_shard_vals[i] = d_vals[inverse_idx[idx[i]]], the scatter_vals of a
+  // partition and the gather_vals of a merge in one pass
+  template <typename StreamType>
+  void gather_vals_by_inverse_idx(float* d_shard_vals,
+                                  const float* d_vals,
+                                  const uint32_t* inverse_idx,
+                                  const uint32_t* idx,
+                                  int64_t len,
+                                  size_t value_bytes,
+                                  const StreamType& stream);
   // scale grad values
   template <typename StreamType, typename GPUAccessor>
   void scale_grad(const size_t& len,
@@ -152,6 +152,19 @@ void HeterPs<GPUAccessor, GPUOptimizer>::show_table_collisions() {
   comm_->show_table_collisions();
 }
 
+template <typename GPUAccessor, template <typename T> class GPUOptimizer>
+uint64_t HeterPs<GPUAccessor, GPUOptimizer>::workspace_alloc_num(int num) {
+  return comm_->workspace_alloc_num(num);
+}
+
+template <typename GPUAccessor, template <typename T> class GPUOptimizer>
+void HeterPs<GPUAccessor, GPUOptimizer>::set_host_tier(int num,
+                                                       int dim_idx,
+                                                       char* begin,
+                                                       char* end) {
+  comm_->set_host_tier(num, dim_idx, begin, end);
+}
+
 template <typename GPUAccessor, template <typename T> class GPUOptimizer>
 int HeterPs<GPUAccessor, GPUOptimizer>::dedup_keys_and_fillidx(
     const int gpu_id,
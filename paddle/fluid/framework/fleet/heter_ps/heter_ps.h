@@ -65,7 +65,9 @@ class HeterPs : public HeterPsBase {
   void show_one_table(int gpu_num) override;
   void push_sparse(int num, FeatureKey* d_keys, float* d_grads, size_t len);
   void show_table_collisions() override;
+  uint64_t workspace_alloc_num(int num) override;
 #if defined(PADDLE_WITH_CUDA)
+  void set_host_tier(int num, int dim_idx, char* begin, char* end) override;
   // dedup
   int dedup_keys_and_fillidx(const int gpu_id,
                              const int total_fea_num,
@@ -51,11 +51,13 @@ class HeterPsBase {
       int comm_size,
       int rank_id) = 0;
   virtual void set_multi_mf_dim(int multi_mf_dim, int max_mf_dim) = 0;
+  virtual void set_host_tier(int num, int dim_idx, char* begin, char* end) {}
 
 #endif
   virtual void end_pass() = 0;
   virtual void show_one_table(int gpu_num) = 0;
   virtual void show_table_collisions() = 0;
+  virtual uint64_t workspace_alloc_num(int num) { return 0; }
   virtual void push_sparse(int num,
                            FeatureKey* d_keys,
                            float* d_grads,
@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #ifdef PADDLE_WITH_HETERPS
+#include <algorithm>
 #include <iostream>
 #ifdef PADDLE_WITH_CUDA
 #include "paddle/fluid/framework/fleet/heter_ps/cudf/managed.cuh"
@@ -111,33 +112,116 @@ class HBMMemoryPoolFix : public managed {
 
   void clear(void) { cudaMemset(mem_, 0, block_size_ * capacity_); }
 
+  // With host overflow the pool is allocated as managed memory: the values
+  // that fit in HBM, keeping reserve_bytes free, are pinned to the device
+  // and the rest stay in host memory, mapped for the device to access in
+  // place. mem() stays one contiguous range, the table pointers and copies
+  // into and out of the pool do not change.
+  void set_host_overflow(bool enable, size_t reserve_bytes) {
+    host_overflow_ = enable;
+    reserve_bytes_ = reserve_bytes;
+  }
+
   void reset(size_t capacity, size_t block_size) {
-    if (max_byte_capacity_ < capacity * block_size) {
+    if (max_byte_capacity_ < capacity * block_size ||
+        managed_ != host_overflow_) {
       if (mem_ != NULL) {
         cudaFree(mem_);
       }
       max_byte_capacity_ = (block_size * capacity / 8 + 1) * 8;
-      CUDA_CHECK(cudaMalloc(&mem_, max_byte_capacity_));
+      if (host_overflow_) {
+        CUDA_CHECK(cudaMallocManaged(&mem_, max_byte_capacity_));
+      } else {
+        CUDA_CHECK(cudaMalloc(&mem_, max_byte_capacity_));
+      }
+      managed_ = host_overflow_;
+      device_bytes_ = 0;
     }
     size_ = capacity;
     block_size_ = block_size;
     capacity_ = max_byte_capacity_ / block_size;
+    device_size_ = size_;
+    if (managed_) {
+      place_values();
+    }
   }
 
   char* mem() { return mem_; }
 
   size_t capacity() { return capacity_; }
   size_t size() { return size_; }
+  // values resident in HBM, the rest of size() lives in host memory
+  size_t device_size() { return device_size_; }
+  size_t host_size() { return size_ - device_size_; }
+  char* host_begin() { return mem_ + device_size_ * block_size_; }
+  char* host_end() { return mem_ + size_ * block_size_; }
+  size_t byte_size() { return size_ * block_size_; }
+  size_t max_byte_capacity() { return max_byte_capacity_; }
+
+  // reset only ever grows the allocation, so a dim whose share of the keys
+  // drops keeps the hbm it needed once. Gives the allocation back when the
+  // last pass used less than 1 / ratio of it, the next reset allocates what
+  // its pass needs.
+  bool shrink(double ratio) {
+    if (mem_ == NULL || max_byte_capacity_ <= byte_size() * ratio) {
+      return false;
+    }
+    cudaFree(mem_);
+    mem_ = NULL;
+    max_byte_capacity_ = 0;
+    capacity_ = 0;
+    size_ = 0;
+    managed_ = false;
+    device_size_ = 0;
+    device_bytes_ = 0;
+    return true;
+  }
   __forceinline__ __device__ void* mem_address(const uint32_t& idx) {
     return &mem_[(idx)*block_size_];
   }
 
  private:
+  void place_values() {
+    int dev_id = 0;
+    CUDA_CHECK(cudaGetDevice(&dev_id));
+    size_t free_bytes = 0;
+    size_t total_bytes = 0;
+    CUDA_CHECK(cudaMemGetInfo(&free_bytes, &total_bytes));
+    // what this pool holds on the device already is free for it again
+    size_t budget = free_bytes + device_bytes_;
+    budget = budget > reserve_bytes_ ? budget - reserve_bytes_ : 0;
+    device_size_ = std::min(size_, budget / block_size_);
+    device_bytes_ = device_size_ * block_size_;
+    if (device_bytes_ > 0) {
+      CUDA_CHECK(cudaMemAdvise(
+          mem_, device_bytes_, cudaMemAdviseSetPreferredLocation, dev_id));
+      CUDA_CHECK(cudaMemPrefetchAsync(mem_, device_bytes_, dev_id, 0));
+    }
+    if (device_bytes_ < max_byte_capacity_) {
+      char* host_mem = mem_ + device_bytes_;
+      size_t host_bytes = max_byte_capacity_ - device_bytes_;
+      CUDA_CHECK(cudaMemAdvise(host_mem,
+                               host_bytes,
+                               cudaMemAdviseSetPreferredLocation,
+                               cudaCpuDeviceId));
+      CUDA_CHECK(cudaMemAdvise(
+          host_mem, host_bytes, cudaMemAdviseSetAccessedBy, dev_id));
+      CUDA_CHECK(
+          cudaMemPrefetchAsync(host_mem, host_bytes, cudaCpuDeviceId, 0));
+    }
+    CUDA_CHECK(cudaStreamSynchronize(0));
+  }
+
   char* mem_ = NULL;
   size_t capacity_;
   size_t size_;
   size_t block_size_;
   size_t max_byte_capacity_;
+  bool host_overflow_ = false;
+  bool managed_ = false;
+  size_t reserve_bytes_ = 0;
+  size_t device_size_ = 0;
+  size_t device_bytes_ = 0;
 };
 
 }  // end namespace framework
@@ -46,12 +46,21 @@ void BasicAucCalculator::reset() {
   _local_abserr = 0;
   _local_sqrerr = 0;
   _local_pred = 0;
+#if defined(PADDLE_WITH_CUDA)
+  reset_device_data();
+#endif
 }
 
 void BasicAucCalculator::add_data(const float* d_pred,
                                   const int64_t* d_label,
                                   int batch_size,
                                   const paddle::platform::Place& place) {
+#if defined(PADDLE_WITH_CUDA)
+  if (platform::is_gpu_place(place)) {
+    add_device_data(d_pred, d_label, nullptr, batch_size, place);
+    return;
+  }
+#endif
   thread_local std::vector<float> h_pred;
   thread_local std::vector<int64_t> h_label;
   h_pred.resize(batch_size);
@@ -101,6 +110,12 @@ void BasicAucCalculator::add_mask_data(const float* d_pred,
                                        const int64_t* d_mask,
                                        int batch_size,
                                        const paddle::platform::Place& place) {
+#if defined(PADDLE_WITH_CUDA)
+  if (platform::is_gpu_place(place)) {
+    add_device_data(d_pred, d_label, d_mask, batch_size, place);
+    return;
+  }
+#endif
   thread_local std::vector<float> h_pred;
   thread_local std::vector<int64_t> h_label;
   thread_local std::vector<int64_t> h_mask;
@@ -122,6 +137,9 @@ void BasicAucCalculator::add_mask_data(const float* d_pred,
 
 void BasicAucCalculator::compute() {
 #if defined(PADDLE_WITH_GLOO)
+#if defined(PADDLE_WITH_CUDA)
+  collect_device_data();
+#endif
   double area = 0;
   double fp = 0;
   double tp = 0;
@@ -132,24 +150,25 @@ void BasicAucCalculator::compute() {
     gloo_wrapper->Init();
   }
 
+  // the tables and the errors of the ranks are summed by one allreduce
+  std::vector<double> stats(2 * _table_size + 3);
+  std::copy(_table[0].begin(), _table[0].end(), stats.begin());
+  std::copy(_table[1].begin(), _table[1].end(), stats.begin() + _table_size);
+  stats[2 * _table_size] = _local_abserr;
+  stats[2 * _table_size + 1] = _local_sqrerr;
+  stats[2 * _table_size + 2] = _local_pred;
   if (gloo_wrapper->Size() > 1) {
-    auto neg_table = gloo_wrapper->AllReduce(_table[0], "sum");
-    auto pos_table = gloo_wrapper->AllReduce(_table[1], "sum");
-    for (int i = _table_size - 1; i >= 0; i--) {
-      double newfp = fp + neg_table[i];
-      double newtp = tp + pos_table[i];
-      area += (newfp - fp) * (tp + newtp) / 2;
-      fp = newfp;
-      tp = newtp;
-    }
-  } else {
-    for (int i = _table_size - 1; i >= 0; i--) {
-      double newfp = fp + _table[0][i];
-      double newtp = tp + _table[1][i];
-      area += (newfp - fp) * (tp + newtp) / 2;
-      fp = newfp;
-      tp = newtp;
-    }
+    stats = gloo_wrapper->AllReduce(stats, "sum");
+  }
+  const double* neg_table = stats.data();
+  const double* pos_table = stats.data() + _table_size;
+
+  for (int i = _table_size - 1; i >= 0; i--) {
+    double newfp = fp + neg_table[i];
+    double newtp = tp + pos_table[i];
+    area += (newfp - fp) * (tp + newtp) / 2;
+    fp = newfp;
+    tp = newtp;
   }
 
   if (fp < 1e-3 || tp < 1e-3) {
@@ -158,95 +177,50 @@ void BasicAucCalculator::compute() {
     _auc = area / (fp * tp);
   }
 
-  if (gloo_wrapper->Size() > 1) {
-    // allreduce sum
-    std::vector<double> local_abserr_vec(1, _local_abserr);
-    std::vector<double> local_sqrerr_vec(1, _local_sqrerr);
-    std::vector<double> local_pred_vec(1, _local_pred);
-    auto global_abserr_vec = gloo_wrapper->AllReduce(local_abserr_vec, "sum");
-    auto global_sqrerr_vec = gloo_wrapper->AllReduce(local_sqrerr_vec, "sum");
-    auto global_pred_vec = gloo_wrapper->AllReduce(local_pred_vec, "sum");
-    _mae = global_abserr_vec[0] / (fp + tp);
-    _rmse = sqrt(global_sqrerr_vec[0] / (fp + tp));
-    _predicted_ctr = global_pred_vec[0] / (fp + tp);
-  } else {
-    _mae = _local_abserr / (fp + tp);
-    _rmse = sqrt(_local_sqrerr / (fp + tp));
-    _predicted_ctr = _local_pred / (fp + tp);
-  }
+  _mae = stats[2 * _table_size] / (fp + tp);
+  _rmse = sqrt(stats[2 * _table_size + 1] / (fp + tp));
+  _predicted_ctr = stats[2 * _table_size + 2] / (fp + tp);
   _actual_ctr = tp / (fp + tp);
 
   _size = fp + tp;
 
-  calculate_bucket_error();
+  calculate_bucket_error(neg_table, pos_table);
 #endif
 }
 
-void BasicAucCalculator::calculate_bucket_error() {
-#if defined(PADDLE_WITH_GLOO)
+void BasicAucCalculator::calculate_bucket_error(const double* neg_table,
+                                                const double* pos_table) {
   double last_ctr = -1;
   double impression_sum = 0;
   double ctr_sum = 0.0;
   double click_sum = 0.0;
   double error_sum = 0.0;
   double error_count = 0;
-  auto gloo_wrapper = paddle::framework::GlooWrapper::GetInstance();
-  if (gloo_wrapper->Size() > 1) {
-    auto neg_table = gloo_wrapper->AllReduce(_table[0], "sum");
-    auto pos_table = gloo_wrapper->AllReduce(_table[1], "sum");
-    for (int i = 0; i < _table_size; i++) {
-      double click = pos_table[i];
-      double show = neg_table[i] + pos_table[i];
-      double ctr = static_cast<double>(i) / _table_size;
-      if (fabs(ctr - last_ctr) > kMaxSpan) {
-        last_ctr = ctr;
-        impression_sum = 0.0;
-        ctr_sum = 0.0;
-        click_sum = 0.0;
-      }
-      impression_sum += show;
-      ctr_sum += ctr * show;
-      click_sum += click;
-      double adjust_ctr = ctr_sum / impression_sum;
-      double relative_error =
-          sqrt((1 - adjust_ctr) / (adjust_ctr * impression_sum));
-      if (relative_error < kRelativeErrorBound) {
-        double actual_ctr = click_sum / impression_sum;
-        double relative_ctr_error = fabs(actual_ctr / adjust_ctr - 1);
-        error_sum += relative_ctr_error * impression_sum;
-        error_count += impression_sum;
-        last_ctr = -1;
-      }
+  for (int i = 0; i < _table_size; i++) {
+    double click = pos_table[i];
+    double show = neg_table[i] + pos_table[i];
+    double ctr = static_cast<double>(i) / _table_size;
+    if (fabs(ctr - last_ctr) > kMaxSpan) {
+      last_ctr = ctr;
+      impression_sum = 0.0;
+      ctr_sum = 0.0;
+      click_sum = 0.0;
     }
-  } else {
-    double* table[2] = {&_table[0][0], &_table[1][0]};  // NOLINT
-    for (int i = 0; i < _table_size; i++) {
-      double click = table[1][i];
-      double show = table[0][i] + table[1][i];
-      double ctr = static_cast<double>(i) / _table_size;
-      if (fabs(ctr - last_ctr) > kMaxSpan) {
-        last_ctr = ctr;
-        impression_sum = 0.0;
-        ctr_sum = 0.0;
-        click_sum = 0.0;
-      }
-      impression_sum += show;
-      ctr_sum += ctr * show;
-      click_sum += click;
-      double adjust_ctr = ctr_sum / impression_sum;
-      double relative_error =
-          sqrt((1 - adjust_ctr) / (adjust_ctr * impression_sum));
-      if (relative_error < kRelativeErrorBound) {
-        double actual_ctr = click_sum / impression_sum;
-        double relative_ctr_error = fabs(actual_ctr / adjust_ctr - 1);
-        error_sum += relative_ctr_error * impression_sum;
-        error_count += impression_sum;
-        last_ctr = -1;
-      }
+    impression_sum += show;
+    ctr_sum += ctr * show;
+    click_sum += click;
+    double adjust_ctr = ctr_sum / impression_sum;
+    double relative_error =
+        sqrt((1 - adjust_ctr) / (adjust_ctr * impression_sum));
+    if (relative_error < kRelativeErrorBound) {
+      double actual_ctr = click_sum / impression_sum;
+      double relative_ctr_error = fabs(actual_ctr / adjust_ctr - 1);
+      error_sum += relative_ctr_error * impression_sum;
+      error_count += impression_sum;
+      last_ctr = -1;
     }
   }
   _bucket_error = error_count > 0 ? error_sum / error_count : 0.0;
-#endif
 }
 
 void BasicAucCalculator::reset_records() {
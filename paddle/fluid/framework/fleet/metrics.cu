@@ -0,0 +1,171 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if defined(PADDLE_WITH_PSLIB) || defined(PADDLE_WITH_PSCORE)
+#include <algorithm>
+#include <vector>
+
+#include "paddle/fluid/framework/fleet/metrics.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+// the abserr, sqrerr, pred and the count of the invalid data
+constexpr int kNumDeviceSums = 4;
+
+__device__ __forceinline__ double WarpSum(double value) {
+  for (int offset = 16; offset > 0; offset /= 2) {
+    value += __shfl_down_sync(0xffffffff, value, offset);
+  }
+  return value;
+}
+
+// Adds each instance into the bucket of its pred in the table of its label,
+// and the errors into the sums, with one atomic per warp for the sums. The
+// invalid instances are only counted, the host reports them at compute time.
+__global__ void AddAucDataKernel(const float* pred,
+                                 const int64_t* label,
+                                 const int64_t* mask,
+                                 int batch_size,
+                                 int table_size,
+                                 double* table,
+                                 double* sums) {
+  double abserr = 0;
+  double sqrerr = 0;
+  double pred_sum = 0;
+  double invalid = 0;
+  for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < batch_size;
+       i += blockDim.x * gridDim.x) {
+    if (mask != nullptr && mask[i] == 0) {
+      continue;
+    }
+    double p = pred[i];
+    int64_t l = label[i];
+    if (!(p >= 0.0 && p <= 1.0) || (l != 0 && l != 1)) {
+      invalid += 1;
+      continue;
+    }
+    int pos = min(static_cast<int>(p * table_size), table_size - 1);
+    phi::CudaAtomicAdd(table + l * table_size + pos, 1.0);
+    abserr += fabs(p - l);
+    sqrerr += (p - l) * (p - l);
+    pred_sum += p;
+  }
+  abserr = WarpSum(abserr);
+  sqrerr = WarpSum(sqrerr);
+  pred_sum = WarpSum(pred_sum);
+  invalid = WarpSum(invalid);
+  if (threadIdx.x % 32 == 0) {
+    phi::CudaAtomicAdd(sums, abserr);
+    phi::CudaAtomicAdd(sums + 1, sqrerr);
+    phi::CudaAtomicAdd(sums + 2, pred_sum);
+    phi::CudaAtomicAdd(sums + 3, invalid);
+  }
+}
+
+}  // namespace
+
+void BasicAucCalculator::add_device_data(const float* d_pred,
+                                         const int64_t* d_label,
+                                         const int64_t* d_mask,
+                                         int batch_size,
+                                         const paddle::platform::Place& place) {
+  int dev_id = place.GetDeviceId();
+  auto* dev_ctx = static_cast<phi::GPUContext*>(
+      platform::DeviceContextPool::Instance().Get(place));
+  auto stream = dev_ctx->stream();
+  size_t stats_size = (2 * _table_size + kNumDeviceSums) * sizeof(double);
+  double* stats = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(_table_mutex);
+    auto& allocation = _device_stats[dev_id];
+    if (allocation == nullptr) {
+      allocation = memory::AllocShared(place, stats_size);
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaMemsetAsync(allocation->ptr(), 0, stats_size, stream));
+    }
+    stats = static_cast<double*>(allocation->ptr());
+  }
+  if (batch_size == 0) {
+    return;
+  }
+  // the sums are added by the leading thread of each warp
+  constexpr int kThreads = 256;
+  int blocks = std::min((batch_size + kThreads - 1) / kThreads,
+                        dev_ctx->GetSMCount() * 4);
+  AddAucDataKernel<<<blocks, kThreads, 0, stream>>>(d_pred,
+                                                    d_label,
+                                                    d_mask,
+                                                    batch_size,
+                                                    _table_size,
+                                                    stats,
+                                                    stats + 2 * _table_size);
+}
+
+void BasicAucCalculator::collect_device_data() {
+  std::lock_guard<std::mutex> lock(_table_mutex);
+  std::vector<double> h_stats(2 * _table_size + kNumDeviceSums);
+  for (auto& item : _device_stats) {
+    platform::CUDAPlace place(item.first);
+    auto* dev_ctx = static_cast<phi::GPUContext*>(
+        platform::DeviceContextPool::Instance().Get(place));
+    auto stream = dev_ctx->stream();
+    size_t stats_size = h_stats.size() * sizeof(double);
+    memory::Copy(platform::CPUPlace(),
+                 h_stats.data(),
+                 place,
+                 item.second->ptr(),
+                 stats_size,
+                 stream);
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaMemsetAsync(item.second->ptr(), 0, stats_size, stream));
+    dev_ctx->Wait();
+    PADDLE_ENFORCE_EQ(h_stats[2 * _table_size + 3],
+                      0.0,
+                      platform::errors::PreconditionNotMet(
+                          "%d instances on GPU %d have a pred out of [0, 1] "
+                          "or a label other than 0 and 1.",
+                          static_cast<int64_t>(h_stats[2 * _table_size + 3]),
+                          item.first));
+    for (int i = 0; i < _table_size; ++i) {
+      _table[0][i] += h_stats[i];
+      _table[1][i] += h_stats[_table_size + i];
+    }
+    _local_abserr += h_stats[2 * _table_size];
+    _local_sqrerr += h_stats[2 * _table_size + 1];
+    _local_pred += h_stats[2 * _table_size + 2];
+  }
+}
+
+void BasicAucCalculator::reset_device_data() {
+  for (auto& item : _device_stats) {
+    platform::CUDAPlace place(item.first);
+    auto* dev_ctx = static_cast<phi::GPUContext*>(
+        platform::DeviceContextPool::Instance().Get(place));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(item.second->ptr(),
+                                               0,
+                                               item.second->size(),
+                                               dev_ctx->stream()));
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
+#endif
@@ -84,6 +84,16 @@ class BasicAucCalculator {
                     int batch_size,
                     const paddle::platform::Place& place);
 
+#if defined(PADDLE_WITH_CUDA)
+  // add batch data on the GPU of place, into the stat table of the device,
+  // without copying it to the host. d_mask can be null.
+  void add_device_data(const float* d_pred,
+                       const int64_t* d_label,
+                       const int64_t* d_mask,
+                       int batch_size,
+                       const paddle::platform::Place& place);
+#endif
+
   void compute();
   void computeWuAuc();
   WuaucRocData computeSingleUserAuc(const std::vector<WuaucRecord>& records);
@@ -103,7 +113,14 @@ class BasicAucCalculator {
   std::mutex& table_mutex(void) { return _table_mutex; }
 
  private:
-  void calculate_bucket_error();
+  void calculate_bucket_error(const double* neg_table,
+                              const double* pos_table);
+#if defined(PADDLE_WITH_CUDA)
+  // adds the stat tables of the devices into the host one and clears them,
+  // the only device to host copy, at compute time
+  void collect_device_data();
+  void reset_device_data();
+#endif
 
  protected:
   double _local_abserr = 0;
@@ -126,6 +143,11 @@ class BasicAucCalculator {
   int _table_size;
   std::vector<double> _table[2];
   std::vector<WuaucRecord> wuauc_records_;
+#if defined(PADDLE_WITH_CUDA)
+  // device id -> the negative and positive tables followed by the abserr,
+  // sqrerr, pred and the count of the invalid data, in doubles
+  std::map<int, std::shared_ptr<phi::Allocation>> _device_stats;
+#endif
   static constexpr double kRelativeErrorBound = 0.05;
   static constexpr double kMaxSpan = 0.01;
   std::mutex _table_mutex;
@@ -48,6 +48,10 @@ COMMON_DECLARE_int32(gpugraph_dedup_pull_push_mode);
 COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_bool(query_dest_rank_by_multi_node);
 COMMON_DECLARE_string(graph_edges_split_mode);
+COMMON_DECLARE_bool(gpugraph_enable_pass_overlap);
+COMMON_DECLARE_bool(gpugraph_enable_hbm_table_overflow);
+COMMON_DECLARE_int64(gpugraph_hbm_table_reserve_mb);
+COMMON_DECLARE_double(gpugraph_hbm_pool_shrink_ratio);
 
 namespace paddle {
 namespace framework {
@@ -1818,16 +1822,27 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
       int mf_dim = this->index_dim_vec_[j];
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
-      this->hbm_pools_[i * this->multi_mf_dim_ + j]->reset(len,
-                                                           feature_value_size);
-      this->HeterPs_->build_ps(
-          i,
-          device_dim_keys.data(),
-          this->hbm_pools_[i * this->multi_mf_dim_ + j]->mem(),
-          len,
-          feature_value_size,
-          4 * 1024 * 1024,
-          2);
+      auto hbm_pool = this->hbm_pools_[i * this->multi_mf_dim_ + j];
+      hbm_pool->set_host_overflow(
+          FLAGS_gpugraph_enable_hbm_table_overflow,
+          static_cast<size_t>(FLAGS_gpugraph_hbm_table_reserve_mb) << 20);
+      hbm_pool->reset(len, feature_value_size);
+      this->HeterPs_->build_ps(i,
+                               device_dim_keys.data(),
+                               hbm_pool->mem(),
+                               len,
+                               feature_value_size,
+                               4 * 1024 * 1024,
+                               2);
+      if (FLAGS_gpugraph_enable_hbm_table_overflow) {
+        this->HeterPs_->set_host_tier(
+            i, j, hbm_pool->host_begin(), hbm_pool->host_end());
+        if (hbm_pool->host_size() > 0) {
+          VLOG(0) << "card: " << i << " dim: " << mf_dim << " keeps "
+                  << hbm_pool->host_size() << " of " << len
+                  << " feasigns in host memory";
+        }
+      }
       if (device_dim_keys.size() > 0) {
         VLOG(3) << "show table: " << i
                 << " table kv size: " << device_dim_keys.size()
@@ -2025,6 +2040,17 @@ void PSGPUWrapper::build_pull_thread() {
     VLOG(0) << "passid=" << gpu_task->pass_id_
             << ", thread BuildPull end, cost time: " << timer.ElapsedSec()
             << "s";
+    // MergePull barriers through gloo on multi node, so it keeps its place
+    // in BeginPass there; on a single node the key division only touches
+    // gpu_task and runs here while the current pass trains
+    if (FLAGS_gpugraph_enable_pass_overlap && !multi_node_) {
+      timer.Start();
+      PrepareDeviceTask(gpu_task);
+      timer.Pause();
+      VLOG(0) << "passid=" << gpu_task->pass_id_
+              << ", thread PrepareGPUTask end, cost time: "
+              << timer.ElapsedSec() << "s";
+    }
     buildpull_ready_channel_->Put(gpu_task);
   }
   VLOG(3) << "build cpu thread end";
@@ -2041,13 +2067,11 @@ void PSGPUWrapper::build_task() {
   VLOG(1) << "passid=" << gpu_task->pass_id_ << ", PrepareGPUTask start.";
   platform::Timer timer;
   timer.Start();
-  // merge pull
-  MergePull(gpu_task);
-  if (multi_mf_dim_) {
-    divide_to_device(gpu_task);
-  } else {
-    PrepareGPUTask(gpu_task);
+  if (!gpu_task->device_task_ready_) {
+    PrepareDeviceTask(gpu_task);
   }
+  // the hbm tables and cpu values are only free again after the write-back
+  WaitEndPass();
   BuildGPUTask(gpu_task);
   timer.Pause();
   VLOG(1) << "passid=" << gpu_task->pass_id_
@@ -2057,6 +2081,23 @@ void PSGPUWrapper::build_task() {
   current_task_ = gpu_task;
 }
 
+void PSGPUWrapper::PrepareDeviceTask(std::shared_ptr<HeterContext> gpu_task) {
+  // merge pull
+  MergePull(gpu_task);
+  if (multi_mf_dim_) {
+    divide_to_device(gpu_task);
+  } else {
+    PrepareGPUTask(gpu_task);
+  }
+  gpu_task->device_task_ready_ = true;
+}
+
+void PSGPUWrapper::WaitEndPass() {
+  if (end_pass_future_.valid()) {
+    end_pass_future_.get();
+  }
+}
+
 void PSGPUWrapper::BeginPass() {
   platform::Timer timer;
 #if defined(PADDLE_WITH_GPU_GRAPH) && defined(PADDLE_WITH_HETERPS)
@@ -2099,6 +2140,27 @@ void PSGPUWrapper::EndPass() {
   if (current_task_ == nullptr) {
     return;
   }
+  if (FLAGS_gpugraph_enable_pass_overlap) {
+    // write back while the next pass loads, BeginPass waits for it
+    WaitEndPass();
+    std::shared_ptr<HeterContext> gpu_task = current_task_;
+    current_task_ = nullptr;
+    if (end_pass_pool_ == nullptr) {
+      end_pass_pool_.reset(new ::ThreadPool(1));
+    }
+    end_pass_future_ = end_pass_pool_->enqueue([this, gpu_task]() {
+      platform::Timer stagetime;
+      stagetime.Start();
+      HbmToSparseTable(gpu_task);
+      stagetime.Pause();
+      VLOG(0) << "passid=" << gpu_task->pass_id_
+              << ", EndPass async HbmToSparseTable cost time: "
+              << stagetime.ElapsedSec() << "s";
+      ShrinkHbmPools();
+      gpu_task_pool_.Push(gpu_task);
+    });
+    return;
+  }
   platform::Timer stagetime;
   stagetime.Start();
   HbmToSparseTable();
@@ -2106,12 +2168,49 @@ void PSGPUWrapper::EndPass() {
   VLOG(0) << "passid=" << current_task_->pass_id_
           << ", EndPass HbmToSparseTable cost time: " << stagetime.ElapsedSec()
           << "s";
+  ShrinkHbmPools();
 
   gpu_task_pool_.Push(current_task_);
   current_task_ = nullptr;
   // fleet_ptr->pslib_ptr_->_worker_ptr->release_table_mutex(this->table_id_);
 }
 
+void PSGPUWrapper::ShrinkHbmPools() {
+#ifdef PADDLE_WITH_CUDA
+  // the values went back to the cpu table, every pool is free until the
+  // next BuildGPUTask
+  auto accessor_wrapper_ptr =
+      GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
+  for (size_t i = 0; i < heter_devices_.size(); ++i) {
+    platform::CUDADeviceGuard guard(resource_->dev_id(i));
+    bool shrunk = false;
+    for (int j = 0; j < multi_mf_dim_; ++j) {
+      auto hbm_pool = hbm_pools_[i * multi_mf_dim_ + j];
+      size_t used = hbm_pool->byte_size();
+      size_t reserved = hbm_pool->max_byte_capacity();
+      VLOG(1) << "card: " << i << " dim: " << index_dim_vec_[j]
+              << " value size: "
+              << accessor_wrapper_ptr->GetFeatureValueSize(index_dim_vec_[j])
+              << " hbm pool used: " << (used >> 20) << "MB of "
+              << (reserved >> 20) << "MB, occupancy: "
+              << (reserved == 0 ? 0.0 : 1.0 * used / reserved);
+      if (FLAGS_gpugraph_hbm_pool_shrink_ratio > 0 &&
+          hbm_pool->shrink(FLAGS_gpugraph_hbm_pool_shrink_ratio)) {
+        VLOG(0) << "card: " << i << " dim: " << index_dim_vec_[j]
+                << " release hbm pool of " << (reserved >> 20) << "MB";
+        shrunk = true;
+      }
+    }
+    if (shrunk && HeterPs_ != nullptr) {
+      // the table of the card points into the freed pool, drop its entries
+      // till the next BuildGPUTask fills it again
+      HeterPs_->reset_table(
+          i, 0, optimizer_config_, optimizer_config_, infer_mode_);
+    }
+  }
+#endif
+}
+
 void PSGPUWrapper::SparseTableToHbm() {
 #if defined(PADDLE_WITH_PSCORE) && defined(PADDLE_WITH_GPU_GRAPH)
   std::shared_ptr<HeterContext> gpu_task = gpu_task_pool_.Get();
@@ -2150,14 +2249,16 @@ void PSGPUWrapper::SparseTableToHbm() {
 #endif
 }
 
-void PSGPUWrapper::HbmToSparseTable() {
+void PSGPUWrapper::HbmToSparseTable() { HbmToSparseTable(current_task_); }
+
+void PSGPUWrapper::HbmToSparseTable(std::shared_ptr<HeterContext> gpu_task) {
   // hbm no update not need dump
   if (grad_push_count_ == 0) {
     return;
   }
   grad_push_count_ = 0;
 
-  if (!current_task_) {
+  if (!gpu_task) {
     PADDLE_THROW(
         platform::errors::Fatal("[EndPass] current task has been ended."));
   }
@@ -2167,7 +2268,7 @@ void PSGPUWrapper::HbmToSparseTable() {
   for (size_t i = 0; i < heter_devices_.size(); i++) {
     for (int j = 0; j < multi_mf_dim_; j++) {
       keysize_max =
-          std::max(keysize_max, current_task_->device_dim_keys_[i][j].size());
+          std::max(keysize_max, gpu_task->device_dim_keys_[i][j].size());
     }
   }
   auto accessor_wrapper_ptr =
@@ -2176,8 +2277,10 @@ void PSGPUWrapper::HbmToSparseTable() {
   int once_cpu_num = 16 * 1024;
   int once_gpu_copy = 8 * once_cpu_num;
 
-  auto dump_pool_to_cpu_func = [this, &accessor_wrapper_ptr, once_cpu_num](
-                                   int i, size_t once_gpu_copy) {
+  auto dump_pool_to_cpu_func = [this,
+                                &gpu_task,
+                                &accessor_wrapper_ptr,
+                                once_cpu_num](int i, size_t once_gpu_copy) {
     platform::Timer tm;
     tm.Start();
     PADDLE_ENFORCE_GPU_SUCCESS(cudaSetDevice(this->resource_->dev_id(i)));
@@ -2192,7 +2295,7 @@ void PSGPUWrapper::HbmToSparseTable() {
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
 
-      auto& device_keys = this->current_task_->device_dim_keys_[i][j];
+      auto& device_keys = gpu_task->device_dim_keys_[i][j];
       size_t len = device_keys.size();
       size_t start = 0;
       while (start < len) {
@@ -2231,12 +2334,11 @@ void PSGPUWrapper::HbmToSparseTable() {
     VLOG(1) << "dump_pool_to_cpu_func i=" << i << ", total len=" << total_len
             << ", span=" << tm.ElapsedSec();
   };
-  auto cpu_func = [this, &accessor_wrapper_ptr](int j) {
+  auto cpu_func = [this, &gpu_task, &accessor_wrapper_ptr](int j) {
     struct task_info task;
     while (cpu_reday_channels_[j]->Get(task)) {
       auto& device_keys =
-          this->current_task_
-              ->device_dim_keys_[task.device_id][task.multi_mf_dim];
+          gpu_task->device_dim_keys_[task.device_id][task.multi_mf_dim];
       uint64_t unuse_key = std::numeric_limits<uint64_t>::max();
       for (int i = task.start; i < task.end; ++i) {
         if (device_keys[i + task.offset] == unuse_key) {
@@ -2278,7 +2380,7 @@ void PSGPUWrapper::HbmToSparseTable() {
     f.wait();
   }
   timer.Pause();
-  VLOG(1) << "passid=" << current_task_->pass_id_
+  VLOG(1) << "passid=" << gpu_task->pass_id_
           << ", EndPass  dump_pool_to_cpu_func "
           << " cost " << timer.ElapsedSec() << " s.";
   for (size_t i = 0; i < device_num; i++) {
@@ -2291,7 +2393,7 @@ void PSGPUWrapper::HbmToSparseTable() {
   }
   cpu_task_futures.clear();
   timer.Pause();
-  VLOG(1) << "passid=" << current_task_->pass_id_ << ", EndPass  cpu_func "
+  VLOG(1) << "passid=" << gpu_task->pass_id_ << ", EndPass  cpu_func "
           << " cost " << timer.ElapsedSec() << " s.";
   if (keysize_max != 0) {
     HeterPs_->end_pass();
@@ -2299,6 +2401,7 @@ void PSGPUWrapper::HbmToSparseTable() {
 }
 
 void PSGPUWrapper::DumpToMem() {
+  WaitEndPass();
 #if defined(PADDLE_WITH_PSCORE) && defined(PADDLE_WITH_GPU_GRAPH)
   if (FLAGS_gpugraph_storage_mode == GpuGraphStorageMode::WHOLE_HBM) {
     this->HbmToSparseTable();
@@ -18,6 +18,7 @@ limitations under the License. */
 #include <google/protobuf/text_format.h>
 #include <atomic>
 #include <ctime>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -219,6 +220,13 @@ class PSGPUWrapper {
   void resize_gputask(std::shared_ptr<HeterContext> gpu_task);
   void SparseTableToHbm();
   void HbmToSparseTable();
+  void HbmToSparseTable(std::shared_ptr<HeterContext> gpu_task);
+  // blocks until the write-back of an overlapped EndPass is done
+  void WaitEndPass();
+  void PrepareDeviceTask(std::shared_ptr<HeterContext> gpu_task);
+  // logs per mf dim hbm pool occupancy, frees the oversized pools and clears
+  // the tables of their cards, see FLAGS_gpugraph_hbm_pool_shrink_ratio
+  void ShrinkHbmPools();
   void start_build_thread();
   void AddSparseKeys();
   void build_pull_thread();
@@ -252,6 +260,7 @@ class PSGPUWrapper {
     if (s_instance_ == nullptr) {
       return;
     }
+    WaitEndPass();
 #if defined(PADDLE_WITH_GPU_GRAPH) && defined(PADDLE_WITH_HETERPS)
     if (FLAGS_gpugraph_storage_mode == GpuGraphStorageMode::WHOLE_HBM) {
       this->EndPass();
@@ -901,6 +910,18 @@ class PSGPUWrapper {
 
   void ShowOneTable(int index) { HeterPs_->show_one_table(index); }
 
+  // device allocations of the pull/push workspaces over all cards, a steady
+  // state step leaves it unchanged
+  uint64_t GetWorkspaceAllocNum() {
+    uint64_t alloc_num = 0;
+    if (HeterPs_ != nullptr) {
+      for (int i = 0; i < resource_->total_device(); ++i) {
+        alloc_num += HeterPs_->workspace_alloc_num(i);
+      }
+    }
+    return alloc_num;
+  }
+
   int UseAfsApi() { return use_afs_api_; }
 
 #ifdef PADDLE_WITH_PSLIB
@@ -1030,6 +1051,9 @@ class PSGPUWrapper {
       cpu_reday_channels_;
   std::shared_ptr<HeterContext> current_task_ = nullptr;
   std::thread buildpull_threads_;
+  // HbmToSparseTable of the last pass when FLAGS_gpugraph_enable_pass_overlap
+  std::shared_ptr<::ThreadPool> end_pass_pool_ = nullptr;
+  std::future<void> end_pass_future_;
   bool running_ = false;
   std::vector<std::shared_ptr<::ThreadPool>> pull_thread_pool_;
   std::vector<std::shared_ptr<::ThreadPool>> hbm_thread_pool_;
@@ -53,6 +53,7 @@ PHI_DEFINE_EXPORTED_bool(gpugraph_force_device_batch_num_equal,
                          false,
                          "enable force_device_batch_num_equal, default false");
 COMMON_DECLARE_bool(enable_dump_main_program);
+COMMON_DECLARE_bool(worker_variable_slots);
 PHI_DEFINE_EXPORTED_int32(gpugraph_offload_param_stat,
                           0,
                           "enable offload param stat, default 0");
@@ -1134,6 +1135,36 @@ void HogwildWorker::SetZero(phi::DenseTensor *tensor,
   phi::funcs::set_constant(*dev_ctx_, tensor, 0.0);
 }
 
+void HogwildWorker::BindVariableSlots() {
+  unused_var_slots_.clear();
+  for (auto &op : ops_) {
+    op->BindVariableSlots(&var_slots_);
+    auto it = unused_vars_.find(op.get());
+    if (it == unused_vars_.end()) {
+      continue;
+    }
+    auto &slots = unused_var_slots_[op.get()];
+    for (auto &name : it->second) {
+      slots.push_back(var_slots_.Register(name));
+    }
+  }
+  var_slots_.Bind(*thread_scope_);
+  VLOG(1) << "thread id=" << thread_id_ << " bind " << var_slots_.size()
+          << " variable slots of " << ops_.size() << " ops";
+}
+
+void HogwildWorker::CollectUnusedTensors(const OperatorBase *op,
+                                         GarbageCollector *gc) {
+  if (var_slots_.scope() != thread_scope_) {
+    DeleteUnusedTensors(*thread_scope_, op, unused_vars_, gc);
+    return;
+  }
+  auto it = unused_var_slots_.find(op);
+  if (it != unused_var_slots_.end()) {
+    DeleteUnusedTensors(*thread_scope_, var_slots_, it->second, gc);
+  }
+}
+
 void HogwildWorker::BindingDataFeedMemory() {
   const std::vector<std::string> &input_feed =
       device_reader_->GetUseSlotAlias();
@@ -1146,6 +1177,9 @@ void HogwildWorker::CreateDeviceResource(const ProgramDesc &main_prog) {
   BuildShardingDepends(main_prog);
   CreateThreadScope(main_prog);
   CreateThreadOperators(main_prog);
+  if (FLAGS_worker_variable_slots) {
+    BindVariableSlots();
+  }
 
 #if defined(PADDLE_WITH_CUDA) && defined(PADDLE_WITH_GPU_GRAPH)
   float *stat_ptr = sync_stat_.mutable_data<float>(place_, sizeof(float) * 3);
@@ -1378,7 +1412,7 @@ void HogwildWorker::TrainFilesWithProfiler() {
         op_total_time[i] += timeline.ElapsedSec();
         total_time += timeline.ElapsedSec();
         if (gc) {
-          DeleteUnusedTensors(*thread_scope_, op.get(), unused_vars_, gc.get());
+          CollectUnusedTensors(op.get(), gc.get());
         }
       }
     } else {
@@ -1408,7 +1442,7 @@ void HogwildWorker::TrainFilesWithProfiler() {
         op_total_time[i] += timeline.ElapsedSec();
         total_time += timeline.ElapsedSec();
         if (gc) {
-          DeleteUnusedTensors(*thread_scope_, op.get(), unused_vars_, gc.get());
+          CollectUnusedTensors(op.get(), gc.get());
         }
       }
     }
@@ -1520,8 +1554,12 @@ void HogwildWorker::TrainFiles() {
   }
 #endif
   bool infer_out_of_ins = false;
+  int64_t stolen_ins_begin = device_reader_->GetStolenInsNum();
+  platform::Timer read_timer;
   while (1) {
+    read_timer.Resume();
     cur_batch = device_reader_->Next();
+    read_timer.Pause();
 #if defined(PADDLE_WITH_GPU_GRAPH)
     if (FLAGS_gpugraph_force_device_batch_num_equal) {
       if (!CheckBatchNum(cur_batch)) {
@@ -1571,7 +1609,7 @@ void HogwildWorker::TrainFiles() {
           op->Run(*thread_scope_, place_);
         }
         if (gc) {
-          DeleteUnusedTensors(*thread_scope_, op.get(), unused_vars_, gc.get());
+          CollectUnusedTensors(op.get(), gc.get());
         }
       }
     } else {
@@ -1596,7 +1634,7 @@ void HogwildWorker::TrainFiles() {
         }
 #endif
         if (gc) {
-          DeleteUnusedTensors(*thread_scope_, op.get(), unused_vars_, gc.get());
+          CollectUnusedTensors(op.get(), gc.get());
         }
       }
     }
@@ -1654,7 +1692,12 @@ void HogwildWorker::TrainFiles() {
 #endif
   timeline.Pause();
   VLOG(1) << "worker " << thread_id_ << " train cost " << timeline.ElapsedSec()
-          << " seconds, batch_num: " << total_batch_num;
+          << " seconds, batch_num: " << total_batch_num
+          << ", read cost: " << read_timer.ElapsedSec()
+          << " seconds, busy cost: "
+          << timeline.ElapsedSec() - read_timer.ElapsedSec()
+          << " seconds, stolen ins: "
+          << device_reader_->GetStolenInsNum() - stolen_ins_begin;
 
   if (need_dump_field_ || need_dump_param_) {
     writer_.Flush();
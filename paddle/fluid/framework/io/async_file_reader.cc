@@ -0,0 +1,345 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/async_file_reader.h"
+
+#include <fcntl.h>
+#include <zlib.h>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/io/fs.h"
+
+COMMON_DECLARE_int32(async_file_reader_thread_num);
+COMMON_DECLARE_int64(async_file_reader_block_size);
+COMMON_DECLARE_int32(async_file_reader_buffered_blocks);
+
+namespace paddle {
+namespace framework {
+
+static bool end_with(const std::string& path, const std::string& str) {
+  return path.length() >= str.length() &&
+         path.compare(path.length() - str.length(), str.length(), str) == 0;
+}
+
+// the converters of dataset configs that leave the bytes as they are
+static bool is_identity_converter(const std::string& converter) {
+  return converter.empty() || converter == "cat";
+}
+
+static std::shared_ptr<FILE> sync_open_read(const std::string& path,
+                                            const std::string& converter,
+                                            int* err_no) {
+  if (fs_select_internal(path) == 1) {
+    return hdfs_open_read(path, err_no, converter, true);
+  }
+  return localfs_open_read(path, converter);
+}
+
+AsyncFileReader::AsyncFileReader(int thread_num,
+                                 size_t block_size,
+                                 size_t buffered_blocks)
+    : block_size_(std::max<size_t>(block_size, 4096)),
+      buffered_blocks_(std::max<size_t>(buffered_blocks, 1)) {
+  for (int i = 0; i < std::max(thread_num, 1); ++i) {
+    threads_.emplace_back([this]() { Run(); });
+  }
+}
+
+AsyncFileReader::~AsyncFileReader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    for (auto& it : pending_) {
+      it.second->blocks->Close();
+    }
+    pending_.clear();
+    todo_.clear();
+  }
+  cond_.notify_all();
+  for (auto& t : threads_) {
+    t.join();
+  }
+}
+
+AsyncFileReader& AsyncFileReader::GetInstance() {
+  static AsyncFileReader reader(FLAGS_async_file_reader_thread_num,
+                                FLAGS_async_file_reader_block_size,
+                                FLAGS_async_file_reader_buffered_blocks);
+  return reader;
+}
+
+std::shared_ptr<AsyncFileReader::Stream> AsyncFileReader::Enqueue(
+    const std::string& path, const std::string& converter) {
+  auto stream = std::make_shared<Stream>();
+  stream->path = path;
+  stream->converter = converter;
+  stream->blocks = MakeChannel<std::string>(buffered_blocks_);
+  todo_.push_back(stream);
+  return stream;
+}
+
+void AsyncFileReader::Prefetch(const std::vector<std::string>& paths,
+                               const std::string& converter) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // whatever the last pass left unopened is stale now, streams opened
+    // already stay queued for their readers
+    for (auto& it : pending_) {
+      it.second->blocks->Close();
+    }
+    pending_.clear();
+    todo_.erase(std::remove_if(todo_.begin(),
+                               todo_.end(),
+                               [](const std::shared_ptr<Stream>& stream) {
+                                 return !stream->reserved;
+                               }),
+                todo_.end());
+    for (auto& path : paths) {
+      Key key(path, converter);
+      if (pending_.count(key) == 0) {
+        pending_[key] = Enqueue(path, converter);
+      }
+    }
+  }
+  cond_.notify_all();
+  VLOG(3) << "AsyncFileReader prefetch " << paths.size() << " files";
+}
+
+std::shared_ptr<FILE> AsyncFileReader::Open(const std::string& path,
+                                            const std::string& converter,
+                                            int* err_no) {
+  if (err_no != nullptr) {
+    *err_no = 0;
+  }
+#if defined(__linux__)
+  std::shared_ptr<Stream> stream;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pending_.find(Key(path, converter));
+    if (it != pending_.end()) {
+      stream = it->second;
+      pending_.erase(it);
+      auto pos = std::find(todo_.begin(), todo_.end(), stream);
+      if (pos != todo_.end()) {
+        todo_.erase(pos);
+        if (idle_threads_ > reserved_) {
+          stream->reserved = true;
+          ++reserved_;
+          todo_.push_front(stream);
+        } else {
+          // every pool thread is busy with files ahead of it, waiting for
+          // one could block on streams only this caller would drain later
+          stream = nullptr;
+        }
+      }
+    }
+  }
+  if (stream == nullptr) {
+    VLOG(3) << "AsyncFileReader open " << path << " without prefetch";
+    return sync_open_read(path, converter, err_no);
+  }
+  stream->err_no = err_no;
+  cookie_io_functions_t funcs;
+  memset(&funcs, 0, sizeof(funcs));
+  funcs.read = &AsyncFileReader::CookieRead;
+  funcs.close = &AsyncFileReader::CookieClose;
+  auto* cookie = new std::shared_ptr<Stream>(std::move(stream));
+  FILE* fp = fopencookie(cookie, "r", funcs);
+  if (fp == nullptr) {
+    CookieClose(cookie);
+    return sync_open_read(path, converter, err_no);
+  }
+  return {fp, [](FILE* fp) { fclose(fp); }};
+#else
+  return sync_open_read(path, converter, err_no);
+#endif
+}
+
+size_t AsyncFileReader::PendingNum() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+void AsyncFileReader::Run() {
+  while (true) {
+    std::shared_ptr<Stream> stream;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++idle_threads_;
+      cond_.wait(lock, [this]() { return stop_ || !todo_.empty(); });
+      --idle_threads_;
+      if (stop_) {
+        return;
+      }
+      stream = todo_.front();
+      todo_.pop_front();
+      if (stream->reserved) {
+        --reserved_;
+      }
+    }
+    Fill(stream.get());
+  }
+}
+
+void AsyncFileReader::Fill(Stream* stream) {
+  bool ok = true;
+  if (fs_select_internal(stream->path) == 0 &&
+      is_identity_converter(stream->converter)) {
+    ok = end_with(stream->path, ".gz") ? ReadGzip(stream) : ReadLocal(stream);
+  } else {
+    ok = ReadPipe(stream);
+  }
+  if (!ok) {
+    stream->failed = true;
+    LOG(WARNING) << "AsyncFileReader failed to read " << stream->path;
+  }
+  stream->blocks->Close();
+}
+
+bool AsyncFileReader::Emit(Stream* stream, std::string* block) {
+  return stream->blocks->Put(std::move(*block));
+}
+
+bool AsyncFileReader::ReadLocal(Stream* stream) {
+#if defined(__linux__)
+  int fd = open(stream->path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  bool ok = true;
+  while (true) {
+    std::string block(block_size_, '\0');
+    size_t len = 0;
+    while (len < block_size_) {
+      ssize_t ret = read(fd, &block[len], block_size_ - len);
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ret <= 0) {
+        ok = (ret == 0);
+        break;
+      }
+      len += ret;
+    }
+    if (len == 0) {
+      break;
+    }
+    block.resize(len);
+    if (!Emit(stream, &block) || len < block_size_) {
+      break;
+    }
+  }
+  close(fd);
+  return ok;
+#else
+  return ReadPipe(stream);
+#endif
+}
+
+bool AsyncFileReader::ReadGzip(Stream* stream) {
+  gzFile gz = gzopen(stream->path.c_str(), "rb");
+  if (gz == nullptr) {
+    return false;
+  }
+  gzbuffer(gz, static_cast<unsigned>(std::min<size_t>(block_size_, 1 << 30)));
+  bool ok = true;
+  while (true) {
+    std::string block(block_size_, '\0');
+    int ret = gzread(gz, &block[0], static_cast<unsigned>(block_size_));
+    if (ret < 0) {
+      int err = 0;
+      LOG(WARNING) << "gzread " << stream->path << ": " << gzerror(gz, &err);
+      ok = false;
+      break;
+    }
+    if (ret == 0) {
+      break;
+    }
+    block.resize(ret);
+    if (!Emit(stream, &block)) {
+      break;
+    }
+  }
+  gzclose(gz);
+  return ok;
+}
+
+bool AsyncFileReader::ReadPipe(Stream* stream) {
+  auto fp = sync_open_read(stream->path, stream->converter);
+  if (fp == nullptr) {
+    return false;
+  }
+  while (true) {
+    std::string block(block_size_, '\0');
+    size_t len = fread(&block[0], 1, block_size_, fp.get());
+    if (len == 0) {
+      break;
+    }
+    block.resize(len);
+    if (!Emit(stream, &block)) {
+      break;
+    }
+  }
+  return ferror(fp.get()) == 0;
+}
+
+#if defined(__linux__)
+ssize_t AsyncFileReader::CookieRead(void* cookie, char* buf, size_t size) {
+  Stream* stream = static_cast<std::shared_ptr<Stream>*>(cookie)->get();
+  size_t done = 0;
+  while (done < size) {
+    if (stream->current_pos == stream->current.size()) {
+      stream->current.clear();
+      stream->current_pos = 0;
+      if (!stream->blocks->Get(stream->current)) {
+        // like the exit status of a pipe the sync path reports
+        if (stream->failed && stream->err_no != nullptr) {
+          *stream->err_no = -1;
+        }
+        break;
+      }
+      continue;
+    }
+    size_t len =
+        std::min(size - done, stream->current.size() - stream->current_pos);
+    memcpy(buf + done, stream->current.data() + stream->current_pos, len);
+    stream->current_pos += len;
+    done += len;
+  }
+  if (done == 0 && stream->failed) {
+    return -1;
+  }
+  return static_cast<ssize_t>(done);
+}
+
+int AsyncFileReader::CookieClose(void* cookie) {
+  auto* stream = static_cast<std::shared_ptr<Stream>*>(cookie);
+  // a reader that stops early releases the pool thread filling the stream
+  (*stream)->blocks->Close();
+  delete stream;
+  return 0;
+}
+#endif
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdio.h>
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/framework/channel.h"
+
+namespace paddle {
+namespace framework {
+
+// Reads dataset files ahead of the DataFeed readers on a pool of threads.
+// Local files are read with plain read(2) in large blocks and .gz files are
+// inflated in process, so no shell is spawned for them. Paths that need a
+// shell anyway (hdfs/afs, or a converter other than cat) still go through
+// fs_open_read, but on a pool thread and ahead of time. The blocks of each
+// file go through a bounded Channel and Open hands them out as a FILE*, so
+// the existing line readers work unchanged.
+class AsyncFileReader {
+ public:
+  AsyncFileReader(int thread_num, size_t block_size, size_t buffered_blocks);
+  ~AsyncFileReader();
+  AsyncFileReader(const AsyncFileReader&) = delete;
+  AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+  static AsyncFileReader& GetInstance();
+
+  // queues the files in order, a file already queued and not opened yet is
+  // not queued twice
+  void Prefetch(const std::vector<std::string>& paths,
+                const std::string& converter);
+  // hands out the prefetched stream of path, a file that was not prefetched
+  // or that no pool thread started yet is opened synchronously instead. As
+  // with fs_open_read, err_no is set to 0, and to -1 once a read finds the
+  // stream failed, it should outlive the FILE.
+  std::shared_ptr<FILE> Open(const std::string& path,
+                             const std::string& converter,
+                             int* err_no = nullptr);
+
+  size_t PendingNum();
+
+ private:
+  struct Stream {
+    std::string path;
+    std::string converter;
+    Channel<std::string> blocks;
+    std::string current;
+    size_t current_pos = 0;
+    bool failed = false;
+    // of the caller of Open
+    int* err_no = nullptr;
+    // opened before a pool thread took it, with an idle thread set aside
+    bool reserved = false;
+  };
+  using Key = std::pair<std::string, std::string>;
+
+  std::shared_ptr<Stream> Enqueue(const std::string& path,
+                                  const std::string& converter);
+  void Run();
+  void Fill(Stream* stream);
+  bool ReadLocal(Stream* stream);
+  bool ReadGzip(Stream* stream);
+  bool ReadPipe(Stream* stream);
+  bool Emit(Stream* stream, std::string* block);
+
+#if defined(__linux__)
+  static ssize_t CookieRead(void* cookie, char* buf, size_t size);
+  static int CookieClose(void* cookie);
+#endif
+
+  size_t block_size_;
+  size_t buffered_blocks_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stop_ = false;
+  int idle_threads_ = 0;
+  int reserved_ = 0;
+  std::deque<std::shared_ptr<Stream>> todo_;
+  // streams queued or being filled that nobody opened yet
+  std::map<Key, std::shared_ptr<Stream>> pending_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -19,8 +19,12 @@ limitations under the License. */
 #include <memory>
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/io/async_file_reader.h"
 #include "paddle/fluid/platform/enforce.h"
 
+COMMON_DECLARE_bool(enable_async_file_reader);
+
 namespace paddle {
 namespace framework {
 
@@ -411,6 +415,9 @@ std::shared_ptr<FILE> fs_open_read(const std::string& path,
                                    int* err_no,
                                    const std::string& converter,
                                    bool read_data) {
+  if (read_data && FLAGS_enable_async_file_reader) {
+    return AsyncFileReader::GetInstance().Open(path, converter, err_no);
+  }
   switch (fs_select_internal(path)) {
     case 0:
       return localfs_open_read(path, converter);
@@ -427,6 +434,13 @@ std::shared_ptr<FILE> fs_open_read(const std::string& path,
   return {};
 }
 
+void fs_prefetch_read(const std::vector<std::string>& paths,
+                      const std::string& converter) {
+  if (FLAGS_enable_async_file_reader) {
+    AsyncFileReader::GetInstance().Prefetch(paths, converter);
+  }
+}
+
 std::shared_ptr<FILE> fs_open_write(const std::string& path,
                                     int* err_no,
                                     const std::string& converter) {
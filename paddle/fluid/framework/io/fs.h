@@ -99,6 +99,11 @@ extern std::shared_ptr<FILE> fs_open_read(const std::string& path,
                                           const std::string& converter,
                                           bool read_data = false);
 
+// starts reading the dataset files ahead when FLAGS_enable_async_file_reader
+// is set, fs_open_read with read_data then takes them from the reader pool
+extern void fs_prefetch_read(const std::vector<std::string>& paths,
+                             const std::string& converter);
+
 extern std::shared_ptr<FILE> fs_open_write(const std::string& path,
                                            int* err_no,
                                            const std::string& converter);
@@ -0,0 +1,527 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/tensor_checkpoint.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/tensor_utils.h"
+
+COMMON_DECLARE_int32(tensor_checkpoint_thread_num);
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+template <typename T>
+void AppendValue(std::string* buf, const T& value) {
+  buf->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+class IndexReader {
+ public:
+  IndexReader(const std::string& buf, const std::string& path)
+      : buf_(buf), path_(path) {}
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  const char* Take(size_t size) {
+    PADDLE_ENFORCE_LE(
+        pos_ + size,
+        buf_.size(),
+        phi::errors::Unavailable(
+            "The index of the tensor checkpoint %s is truncated, please "
+            "check whether the file is complete or damaged.",
+            path_));
+    const char* data = buf_.data() + pos_;
+    pos_ += size;
+    return data;
+  }
+
+ private:
+  const std::string& buf_;
+  const std::string& path_;
+  size_t pos_ = 0;
+};
+
+uint64_t AlignUp(uint64_t value) {
+  return (value + kTensorCheckpointAlignment - 1) /
+         kTensorCheckpointAlignment * kTensorCheckpointAlignment;
+}
+
+size_t ChunkNum(uint64_t size, uint64_t chunk_size) {
+  return (size + chunk_size - 1) / chunk_size;
+}
+
+uint32_t Checksum(const char* data, uint64_t size) {
+  return static_cast<uint32_t>(crc32(
+      0L, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size)));
+}
+
+int ThreadNum(int thread_num, size_t task_num) {
+  if (thread_num <= 0) {
+    thread_num = FLAGS_tensor_checkpoint_thread_num;
+  }
+  if (thread_num <= 0) {
+    thread_num = std::min(16, static_cast<int>(std::max(
+                                  1U, std::thread::hardware_concurrency())));
+  }
+  return static_cast<int>(
+      std::max<size_t>(1, std::min<size_t>(thread_num, task_num)));
+}
+
+// runs fn(thread_id, task) for the tasks in [0, task_num) on thread_num
+// threads, the first exception is rethrown once all the threads are done
+template <typename Fn>
+void ParallelFor(size_t task_num, int thread_num, Fn fn) {
+  std::atomic<size_t> next{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto run = [&](int thread_id) {
+    size_t task;
+    while (!failed && (task = next++) < task_num) {
+      try {
+        fn(thread_id, task);
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < thread_num; ++i) {
+    threads.emplace_back(run, i);
+  }
+  run(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+std::string SerializeIndex(const std::vector<TensorCheckpointEntry>& entries) {
+  std::string buf;
+  for (auto& entry : entries) {
+    AppendValue(&buf, static_cast<uint32_t>(entry.name.size()));
+    buf.append(entry.name);
+    AppendValue(&buf, static_cast<int32_t>(entry.dtype));
+    AppendValue(&buf, static_cast<uint32_t>(entry.dims.size()));
+    for (auto dim : entry.dims) {
+      AppendValue(&buf, dim);
+    }
+    AppendValue(&buf, static_cast<uint32_t>(entry.lod.size()));
+    for (auto& level : entry.lod) {
+      AppendValue(&buf, static_cast<uint64_t>(level.size()));
+      for (auto offset : level) {
+        AppendValue(&buf, static_cast<uint64_t>(offset));
+      }
+    }
+    AppendValue(&buf, entry.offset);
+    AppendValue(&buf, entry.size);
+    for (auto checksum : entry.checksums) {
+      AppendValue(&buf, checksum);
+    }
+  }
+  return buf;
+}
+
+size_t HeaderSize() {
+  return sizeof(kTensorCheckpointMagic) + 2 * sizeof(uint32_t) +
+         2 * sizeof(uint64_t);
+}
+
+}  // namespace
+
+bool IsTensorCheckpoint(const std::string& path) {
+  std::ifstream fin(path, std::ios::binary);
+  char magic[sizeof(kTensorCheckpointMagic)];
+  return fin.read(magic, sizeof(magic)) &&
+         std::memcmp(magic, kTensorCheckpointMagic, sizeof(magic)) == 0;
+}
+
+// chunk_data(i, begin) gives the kTensorCheckpointChunkSize bytes at begin
+// of the payload of tensors[i] and chunk_done(i) is called once they are
+// written, both on the writer threads
+template <typename ChunkData, typename ChunkDone>
+static void WriteTensorCheckpoint(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<const phi::DenseTensor*>& tensors,
+    int thread_num,
+    ChunkData chunk_data,
+    ChunkDone chunk_done) {
+  PADDLE_ENFORCE_EQ(names.size(),
+                    tensors.size(),
+                    phi::errors::InvalidArgument(
+                        "The number of names (%d) and tensors (%d) to save "
+                        "should be the same.",
+                        names.size(),
+                        tensors.size()));
+  const uint64_t chunk_size = kTensorCheckpointChunkSize;
+  std::vector<TensorCheckpointEntry> entries(tensors.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    auto& tensor = *tensors[i];
+    auto& entry = entries[i];
+    entry.name = names[i];
+    entry.dtype = tensor.dtype();
+    entry.dims = common::vectorize(tensor.dims());
+    entry.lod = tensor.lod();
+    entry.size = tensor.numel() * phi::SizeOf(tensor.dtype());
+    entry.checksums.resize(ChunkNum(entry.size, chunk_size));
+  }
+  // the payload offsets only depend on the index size, which does not depend
+  // on their values
+  size_t index_size = SerializeIndex(entries).size();
+  uint64_t offset = AlignUp(HeaderSize() + index_size);
+  struct Chunk {
+    size_t tensor;
+    uint64_t begin;
+  };
+  std::vector<Chunk> chunks;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    entries[i].offset = offset;
+    offset = AlignUp(offset + entries[i].size);
+    for (uint64_t begin = 0; begin < entries[i].size; begin += chunk_size) {
+      chunks.push_back({i, begin});
+    }
+  }
+  uint64_t file_size = offset;
+
+  MkDirRecursively(DirName(path).c_str());
+  {
+    std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+    PADDLE_ENFORCE_EQ(
+        static_cast<bool>(fout),
+        true,
+        phi::errors::Unavailable("Cannot open %s to save variables.", path));
+    // sized up front so that the writer threads can each seek in it
+    if (file_size > 0) {
+      fout.seekp(static_cast<std::streamoff>(file_size - 1));
+      fout.put('\0');
+    }
+  }
+
+  thread_num = ThreadNum(thread_num, chunks.size());
+  std::vector<std::unique_ptr<std::fstream>> files(thread_num);
+  auto write_chunk = [&](int thread_id, size_t index) {
+    auto& file = files[thread_id];
+    if (file == nullptr) {
+      file = std::make_unique<std::fstream>(
+          path, std::ios::binary | std::ios::in | std::ios::out);
+      PADDLE_ENFORCE_EQ(static_cast<bool>(*file),
+                        true,
+                        phi::errors::Unavailable(
+                            "Cannot open %s to save variables.", path));
+    }
+
+    auto& chunk = chunks[index];
+    auto& entry = entries[chunk.tensor];
+    const char* data = chunk_data(chunk.tensor, chunk.begin);
+    uint64_t size = std::min(chunk_size, entry.size - chunk.begin);
+    entry.checksums[chunk.begin / chunk_size] = Checksum(data, size);
+    file->seekp(static_cast<std::streamoff>(entry.offset + chunk.begin));
+    file->write(data, static_cast<std::streamsize>(size));
+    PADDLE_ENFORCE_EQ(static_cast<bool>(*file),
+                      true,
+                      phi::errors::Unavailable(
+                          "Fail to write %s into %s.", entry.name, path));
+    chunk_done(chunk.tensor);
+  };
+  ParallelFor(chunks.size(), thread_num, write_chunk);
+  for (auto& file : files) {
+    if (file != nullptr) {
+      file->close();
+    }
+  }
+
+  // written last so that a partial checkpoint is not taken for a valid one
+  std::string index = SerializeIndex(entries);
+  std::fstream fout(path, std::ios::binary | std::ios::in | std::ios::out);
+  fout.seekp(sizeof(kTensorCheckpointMagic));
+  uint32_t version = kTensorCheckpointVersion;
+  uint32_t tensor_num = static_cast<uint32_t>(entries.size());
+  uint64_t index_size64 = index.size();
+  fout.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  fout.write(reinterpret_cast<const char*>(&tensor_num), sizeof(tensor_num));
+  fout.write(reinterpret_cast<const char*>(&index_size64),
+             sizeof(index_size64));
+  fout.write(reinterpret_cast<const char*>(&chunk_size), sizeof(chunk_size));
+  fout.write(index.data(), static_cast<std::streamsize>(index.size()));
+  fout.flush();
+  fout.seekp(0);
+  fout.write(kTensorCheckpointMagic, sizeof(kTensorCheckpointMagic));
+  fout.close();
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fout),
+      true,
+      phi::errors::Unavailable("Fail to write the index of %s.", path));
+  VLOG(3) << "Save " << entries.size() << " tensors of " << file_size
+          << " bytes to " << path << " with " << thread_num << " threads";
+}
+
+void SaveTensorCheckpoint(const std::string& path,
+                          const std::vector<std::string>& names,
+                          const std::vector<const phi::DenseTensor*>& tensors,
+                          int thread_num) {
+  // the host copies of the tensors not on the host, made by the first thread
+  // writing one of their chunks and dropped after their last one
+  std::vector<std::once_flag> copied(tensors.size());
+  std::vector<std::unique_ptr<phi::DenseTensor>> host_tensors(tensors.size());
+  std::vector<std::atomic<size_t>> remaining(tensors.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        tensors[i]->IsInitialized(),
+        true,
+        phi::errors::InvalidArgument(
+            "The Tensor with Index (%d) to be saved is not initialized.", i));
+    remaining[i] =
+        ChunkNum(tensors[i]->numel() * phi::SizeOf(tensors[i]->dtype()),
+                 kTensorCheckpointChunkSize);
+  }
+  auto chunk_data = [&](size_t i, uint64_t begin) {
+    const phi::DenseTensor* tensor = tensors[i];
+    if (!phi::is_cpu_place(tensor->place()) &&
+        !phi::is_cuda_pinned_place(tensor->place())) {
+      std::call_once(copied[i], [&]() {
+        host_tensors[i] = std::make_unique<phi::DenseTensor>();
+        auto* dev_ctx =
+            phi::DeviceContextPool::Instance().Get(tensor->place());
+        phi::Copy(*dev_ctx,
+                  *tensor,
+                  phi::CPUPlace(),
+                  /*blocking=*/true,
+                  host_tensors[i].get());
+      });
+      tensor = host_tensors[i].get();
+    }
+    return static_cast<const char*>(tensor->data()) + begin;
+  };
+  auto chunk_done = [&](size_t i) {
+    if (--remaining[i] == 0) {
+      host_tensors[i].reset();
+    }
+  };
+  WriteTensorCheckpoint(
+      path, names, tensors, thread_num, chunk_data, chunk_done);
+}
+
+void SaveTensorCheckpoint(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<const phi::DenseTensor*>& tensors,
+    const std::vector<std::vector<const void*>>& chunks,
+    int thread_num) {
+  PADDLE_ENFORCE_EQ(chunks.size(),
+                    tensors.size(),
+                    phi::errors::InvalidArgument(
+                        "The number of chunk lists (%d) and tensors (%d) to "
+                        "save should be the same.",
+                        chunks.size(),
+                        tensors.size()));
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    size_t chunk_num =
+        ChunkNum(tensors[i]->numel() * phi::SizeOf(tensors[i]->dtype()),
+                 kTensorCheckpointChunkSize);
+    PADDLE_ENFORCE_EQ(chunks[i].size(),
+                      chunk_num,
+                      phi::errors::InvalidArgument(
+                          "The tensor with Index (%d) has %d chunks, but %d "
+                          "are given.",
+                          i,
+                          chunk_num,
+                          chunks[i].size()));
+  }
+  auto chunk_data = [&](size_t i, uint64_t begin) {
+    return static_cast<const char*>(
+        chunks[i][begin / kTensorCheckpointChunkSize]);
+  };
+  WriteTensorCheckpoint(
+      path, names, tensors, thread_num, chunk_data, [](size_t) {});
+}
+
+std::vector<TensorCheckpointEntry> LoadTensorCheckpointIndex(
+    const std::string& path, uint64_t* chunk_size) {
+  std::ifstream fin(path, std::ios::binary);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fin),
+                    true,
+                    phi::errors::Unavailable(
+                        "Fail to open the tensor checkpoint %s, please check "
+                        "whether the file is complete or damaged.",
+                        path));
+  std::string header(HeaderSize(), '\0');
+  fin.read(&header[0], static_cast<std::streamsize>(header.size()));
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(fin) &&
+          std::memcmp(header.data(),
+                      kTensorCheckpointMagic,
+                      sizeof(kTensorCheckpointMagic)) == 0,
+      true,
+      phi::errors::InvalidArgument("%s is not a tensor checkpoint.", path));
+  IndexReader header_reader(header, path);
+  header_reader.Take(sizeof(kTensorCheckpointMagic));
+  uint32_t version = header_reader.Read<uint32_t>();
+  PADDLE_ENFORCE_EQ(
+      version,
+      kTensorCheckpointVersion,
+      phi::errors::InvalidArgument(
+          "The version %u of the tensor checkpoint %s is not supported, only "
+          "version %u is.",
+          version,
+          path,
+          kTensorCheckpointVersion));
+  uint32_t tensor_num = header_reader.Read<uint32_t>();
+  uint64_t index_size = header_reader.Read<uint64_t>();
+  uint64_t chunk = header_reader.Read<uint64_t>();
+  PADDLE_ENFORCE_GT(chunk,
+                    0UL,
+                    phi::errors::InvalidArgument(
+                        "The chunk size of the tensor checkpoint %s is 0.",
+                        path));
+  if (chunk_size != nullptr) {
+    *chunk_size = chunk;
+  }
+
+  std::string buf(index_size, '\0');
+  fin.read(&buf[0], static_cast<std::streamsize>(index_size));
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fin),
+                    true,
+                    phi::errors::Unavailable(
+                        "The index of the tensor checkpoint %s is truncated, "
+                        "please check whether the file is complete or "
+                        "damaged.",
+                        path));
+  IndexReader reader(buf, path);
+  std::vector<TensorCheckpointEntry> entries(tensor_num);
+  for (auto& entry : entries) {
+    uint32_t name_size = reader.Read<uint32_t>();
+    entry.name.assign(reader.Take(name_size), name_size);
+    entry.dtype = static_cast<phi::DataType>(reader.Read<int32_t>());
+    entry.dims.resize(reader.Read<uint32_t>());
+    for (auto& dim : entry.dims) {
+      dim = reader.Read<int64_t>();
+    }
+    entry.lod.resize(reader.Read<uint32_t>());
+    for (auto& level : entry.lod) {
+      level.resize(reader.Read<uint64_t>());
+      for (auto& offset : level) {
+        offset = reader.Read<uint64_t>();
+      }
+    }
+    entry.offset = reader.Read<uint64_t>();
+    entry.size = reader.Read<uint64_t>();
+    entry.checksums.resize(ChunkNum(entry.size, chunk));
+    for (auto& checksum : entry.checksums) {
+      checksum = reader.Read<uint32_t>();
+    }
+  }
+  return entries;
+}
+
+std::vector<std::pair<std::string, phi::DenseTensor>> LoadTensorCheckpoint(
+    const std::string& path, int thread_num) {
+  uint64_t chunk_size = 0;
+  auto entries = LoadTensorCheckpointIndex(path, &chunk_size);
+  std::vector<std::pair<std::string, phi::DenseTensor>> tensors(
+      entries.size());
+  struct Chunk {
+    size_t tensor;
+    uint64_t begin;
+  };
+  std::vector<Chunk> chunks;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto& entry = entries[i];
+    auto& tensor = tensors[i].second;
+    tensors[i].first = entry.name;
+    tensor.Resize(common::make_ddim(entry.dims));
+    tensor.set_lod(entry.lod);
+    PADDLE_ENFORCE_EQ(
+        entry.size,
+        tensor.numel() * phi::SizeOf(entry.dtype),
+        phi::errors::InvalidArgument(
+            "The size of %s in the tensor checkpoint %s does not match its "
+            "shape, please check whether the file is complete or damaged.",
+            entry.name,
+            path));
+    tensor.mutable_data(phi::CPUPlace(), entry.dtype);
+    for (uint64_t begin = 0; begin < entry.size; begin += chunk_size) {
+      chunks.push_back({i, begin});
+    }
+  }
+
+  thread_num = ThreadNum(thread_num, chunks.size());
+  std::vector<std::unique_ptr<std::ifstream>> files(thread_num);
+  auto read_chunk = [&](int thread_id, size_t index) {
+    auto& file = files[thread_id];
+    if (file == nullptr) {
+      file = std::make_unique<std::ifstream>(path, std::ios::binary);
+    }
+
+    auto& chunk = chunks[index];
+    auto& entry = entries[chunk.tensor];
+    char* data = static_cast<char*>(tensors[chunk.tensor].second.data());
+    uint64_t size = std::min(chunk_size, entry.size - chunk.begin);
+    file->seekg(static_cast<std::streamoff>(entry.offset + chunk.begin));
+    file->read(data + chunk.begin, static_cast<std::streamsize>(size));
+    PADDLE_ENFORCE_EQ(static_cast<bool>(*file),
+                      true,
+                      phi::errors::Unavailable(
+                          "Fail to read %s from the tensor checkpoint %s, "
+                          "please check whether the file is complete or "
+                          "damaged.",
+                          entry.name,
+                          path));
+    size_t chunk_id = chunk.begin / chunk_size;
+    PADDLE_ENFORCE_EQ(Checksum(data + chunk.begin, size),
+                      entry.checksums[chunk_id],
+                      phi::errors::Unavailable(
+                          "The checksum of chunk %d of %s in the tensor "
+                          "checkpoint %s does not match, the file is damaged.",
+                          chunk_id,
+                          entry.name,
+                          path));
+  };
+  ParallelFor(chunks.size(), thread_num, read_chunk);
+  VLOG(3) << "Load " << entries.size() << " tensors from " << path << " with "
+          << thread_num << " threads";
+  return tensors;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,87 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+
+// Checkpoint file of named phi::DenseTensors, written and read by a pool of
+// threads instead of one tensor after the other through a stream:
+//
+//   header   magic "PDTCKPT", uint32 version, uint32 tensor number,
+//            uint64 index size, uint64 chunk size
+//   index    one TensorCheckpointEntry per tensor
+//   payloads the data of each tensor, at an offset aligned to
+//            kTensorCheckpointAlignment so it can be read with direct I/O or
+//            mapped
+//
+// Every chunk_size bytes of a payload carry a CRC32 in the index, checked on
+// load. All the integers are little endian.
+constexpr char kTensorCheckpointMagic[8] = "PDTCKPT";
+constexpr uint32_t kTensorCheckpointVersion = 1;
+constexpr uint64_t kTensorCheckpointAlignment = 4096;
+constexpr uint64_t kTensorCheckpointChunkSize = 16UL << 20;
+
+struct TensorCheckpointEntry {
+  std::string name;
+  phi::DataType dtype;
+  std::vector<int64_t> dims;
+  phi::LoD lod;
+  // of the payload in the file
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  std::vector<uint32_t> checksums;
+};
+
+// whether path starts with kTensorCheckpointMagic
+bool IsTensorCheckpoint(const std::string& path);
+
+// The tensors may live on any place, the ones not on CPU are copied to the
+// host by the writer threads. names may be empty strings, e.g. for the
+// positional tensors of save_combine. thread_num <= 0 picks
+// FLAGS_tensor_checkpoint_thread_num threads.
+void SaveTensorCheckpoint(const std::string& path,
+                          const std::vector<std::string>& names,
+                          const std::vector<const phi::DenseTensor*>& tensors,
+                          int thread_num = 0);
+
+// The same, but only the dims, dtype and LoD of the tensors are used and
+// their payloads are read from chunks: chunks[i][j] holds bytes
+// [j * kTensorCheckpointChunkSize, (j + 1) * kTensorCheckpointChunkSize) of
+// tensors[i], e.g. in pinned staging buffers that a snapshot copied them to.
+void SaveTensorCheckpoint(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<const phi::DenseTensor*>& tensors,
+    const std::vector<std::vector<const void*>>& chunks,
+    int thread_num = 0);
+
+std::vector<TensorCheckpointEntry> LoadTensorCheckpointIndex(
+    const std::string& path, uint64_t* chunk_size = nullptr);
+
+// Loads all the tensors onto CPU in the order they were saved, a chunk whose
+// checksum does not match fails the load.
+std::vector<std::pair<std::string, phi::DenseTensor>> LoadTensorCheckpoint(
+    const std::string& path, int thread_num = 0);
+
+}  // namespace framework
+}  // namespace paddle
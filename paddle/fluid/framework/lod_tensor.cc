@@ -14,10 +14,16 @@ limitations under the License. */
 
 #include "paddle/fluid/framework/lod_tensor.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/version.h"
+#include "paddle/fluid/memory/memcpy.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/memory/allocation/pinned_staging_allocator.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -320,6 +326,145 @@ void DeserializeFromStream(std::istream &is,
       is, static_cast<phi::DenseTensor *>(tensor), dev_ctx);
 }
 
+#ifndef _WIN32
+namespace {
+
+const char *ReadMappedFile(const memory::allocation::MappedFile &file,
+                           size_t *offset,
+                           size_t size) {
+  PADDLE_ENFORCE_LE(
+      *offset + size,
+      file.size(),
+      phi::errors::Unavailable(
+          "Fail to read %d bytes at offset %d of %s, please check whether "
+          "the model file is complete or damaged.",
+          size,
+          *offset,
+          file.path()));
+  const char *data = file.data() + *offset;
+  *offset += size;
+  return data;
+}
+
+template <typename T>
+T ReadMappedValue(const memory::allocation::MappedFile &file,
+                  size_t *offset) {
+  T value;
+  std::memcpy(&value, ReadMappedFile(file, offset, sizeof(T)), sizeof(T));
+  return value;
+}
+
+}  // namespace
+
+phi::DataType DeserializeMetaFromMappedFile(
+    const memory::allocation::MappedFile &file,
+    size_t *offset,
+    phi::DenseTensor *tensor) {
+  {
+    // the 1st field, unit32_t version for DenseTensor
+    uint32_t version = ReadMappedValue<uint32_t>(file, offset);
+    PADDLE_ENFORCE_EQ(
+        version,
+        0U,
+        phi::errors::InvalidArgument(
+            "Deserialize to tensor failed, maybe the loaded file is "
+            "not a paddle model(expected file format: 0, but %u found).",
+            version));
+  }
+  {
+    // the 2st field, LoD information
+    uint64_t lod_level = ReadMappedValue<uint64_t>(file, offset);
+    auto &lod = *tensor->mutable_lod();
+    lod.resize(lod_level);
+    for (uint64_t i = 0; i < lod_level; ++i) {
+      uint64_t size = ReadMappedValue<uint64_t>(file, offset);
+      std::vector<size_t> tmp(size / sizeof(size_t));
+      std::memcpy(tmp.data(), ReadMappedFile(file, offset, size), size);
+      lod[i] = tmp;
+    }
+  }
+  // the 3st field, Tensor
+  uint32_t version = ReadMappedValue<uint32_t>(file, offset);
+  PADDLE_ENFORCE_EQ(
+      version,
+      0U,
+      phi::errors::InvalidArgument(
+          "tensor version %u is not supported, Only version 0 is supported",
+          version));
+  proto::VarType::TensorDesc desc;
+  int32_t desc_size = ReadMappedValue<int32_t>(file, offset);
+  PADDLE_ENFORCE_GE(
+      desc_size,
+      0,
+      phi::errors::InvalidArgument("phi::DenseTensor desc size should >= 0"));
+  PADDLE_ENFORCE_EQ(
+      desc.ParseFromArray(ReadMappedFile(file, offset, desc_size), desc_size),
+      true,
+      phi::errors::InvalidArgument("Cannot parse tensor desc"));
+
+  std::vector<int64_t> dims(desc.dims().begin(), desc.dims().end());
+  tensor->Resize(common::make_ddim(dims));
+  return TransToPhiDataType(desc.data_type());
+}
+
+void DeserializeFromMappedFile(
+    const std::shared_ptr<memory::allocation::MappedFile> &file,
+    size_t *offset,
+    phi::DenseTensor *tensor,
+    const platform::DeviceContext &dev_ctx) {
+  auto dtype = DeserializeMetaFromMappedFile(*file, offset, tensor);
+  size_t size = tensor->numel() * phi::SizeOf(dtype);
+  size_t data_offset = *offset;
+  const char *data = ReadMappedFile(*file, offset, size);
+  auto place = dev_ctx.GetPlace();
+
+  if (platform::is_cpu_place(place)) {
+    if (size > 0 &&
+        reinterpret_cast<uintptr_t>(data) % phi::SizeOf(dtype) == 0) {
+      tensor->ResetHolderWithType(
+          std::make_shared<memory::allocation::MappedFileAllocation>(
+              file, data_offset, size),
+          dtype);
+    } else {
+      void *dst = tensor->mutable_data(place, dtype);
+      std::memcpy(dst, data, size);
+    }
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place)) {
+    // the host copy of a chunk overlaps the device copy of the previous one,
+    // a staging buffer is reused once its device copy completes
+    constexpr size_t kChunkSize = 16UL << 20;
+    platform::CUDAPlace gpu_place(place.GetDeviceId());
+    auto stream = static_cast<const phi::GPUContext &>(dev_ctx).stream();
+    auto staging_allocator =
+        memory::allocation::PinnedStagingAllocator::Instance(gpu_place);
+    char *dst = static_cast<char *>(tensor->mutable_data(place, dtype));
+    for (size_t done = 0; done < size; done += kChunkSize) {
+      size_t chunk = std::min(kChunkSize, size - done);
+      auto staging = staging_allocator->Allocate(chunk);
+      std::memcpy(staging->ptr(), data + done, chunk);
+      memory::Copy(gpu_place,
+                   dst + done,
+                   platform::CUDAPinnedPlace(),
+                   staging->ptr(),
+                   chunk,
+                   stream);
+      staging_allocator->RecordStream(staging.get(), stream);
+    }
+    return;
+  }
+#endif
+  phi::DenseTensor cpu_tensor;
+  cpu_tensor.Resize(tensor->dims());
+  std::memcpy(
+      cpu_tensor.mutable_data(platform::CPUPlace(), dtype), data, size);
+  framework::TensorCopy(cpu_tensor, place, dev_ctx, tensor);
+  dev_ctx.Wait();
+}
+#endif
+
 LoD ConvertToOffsetBasedLoD(const LoD &length_lod) {
   LoD offset_lod;
   offset_lod.reserve(length_lod.size());
@@ -23,6 +23,9 @@ limitations under the License. */
 
 #include "paddle/common/ddim.h"
 #include "paddle/fluid/framework/tensor_util.h"
+#ifndef _WIN32
+#include "paddle/fluid/memory/allocation/mmap_allocator.h"
+#endif
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/place.h"
 #include "paddle/phi/core/dense_tensor.h"
@@ -190,5 +193,29 @@ void SerializeToStream(std::ostream& os, const phi::DenseTensor& tensor);
 
 void DeserializeFromStream(std::istream& os, phi::DenseTensor* tensor);
 
+#ifndef _WIN32
+/*
+ * Deserialize the LoD and dims of the phi::DenseTensor SerializeToStream wrote
+ * at *offset of file into tensor without allocating it, and advance *offset to
+ * its data, of tensor->numel() elements of the returned data type.
+ */
+phi::DataType DeserializeMetaFromMappedFile(
+    const memory::allocation::MappedFile& file,
+    size_t* offset,
+    phi::DenseTensor* tensor);
+
+/*
+ * Deserialize the phi::DenseTensor SerializeToStream wrote at *offset of
+ * file, and advance *offset past it. A CPU tensor shares the memory of the
+ * mapping when its data is aligned to its data type, a GPU tensor is copied
+ * in chunks through pinned staging buffers on the stream of dev_ctx.
+ */
+void DeserializeFromMappedFile(
+    const std::shared_ptr<memory::allocation::MappedFile>& file,
+    size_t* offset,
+    phi::DenseTensor* tensor,
+    const platform::DeviceContext& dev_ctx);
+#endif
+
 }  // namespace framework
 }  // namespace paddle
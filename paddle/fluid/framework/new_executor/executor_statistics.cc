@@ -14,13 +14,17 @@
 
 #include "paddle/fluid/framework/new_executor/executor_statistics.h"
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
 #include <map>
 #include <ostream>
 #include <queue>
 #include <set>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "glog/logging.h"
@@ -112,6 +116,14 @@ class StatisticsEngine {
 
   int StatNormalizationTime(const std::vector<std::vector<StdEvent>>& all_evts);
 
+  // device time of the kernels summed over the streams, their union and the
+  // difference of the two, which is what multi-stream execution overlapped
+  int StatStreamOverlap(const platform::NodeTrees& trees);
+
+  // critical path through the device activities and their launches on the
+  // host, and the idle gaps of every stream, split by their causes
+  int StatCriticalPath(const platform::NodeTrees& trees);
+
   bool inited_ = false;
   ExecutorType executor_type_;
   std::vector<std::string> names_;
@@ -122,7 +134,8 @@ class StatisticsEngine {
 };
 
 int StatisticsEngine::Apply(const platform::NodeTrees& tree) {
-  return Init(tree) || Stat(tree);
+  return Init(tree) || Stat(tree) || StatStreamOverlap(tree) ||
+         StatCriticalPath(tree);
 }
 
 int StatisticsEngine::Init(const platform::NodeTrees& trees) {
@@ -589,6 +602,394 @@ int StatisticsEngine::StatNormalizationTime(
   return 0;
 }
 
+int StatisticsEngine::StatStreamOverlap(const platform::NodeTrees& trees) {
+  std::vector<std::pair<uint64_t, uint64_t>> kernels;
+  std::set<uint64_t> streams;
+  for (const auto& thr_nodes : trees.Traverse(true)) {
+    for (const auto* host_node : thr_nodes.second) {
+      for (const auto* runtime_node : host_node->GetRuntimeTraceEventNodes()) {
+        for (const auto* device_node :
+             runtime_node->GetDeviceTraceEventNodes()) {
+          if (device_node->Type() != platform::TracerEventType::Kernel) {
+            continue;
+          }
+          kernels.emplace_back(device_node->StartNs(), device_node->EndNs());
+          streams.insert(device_node->StreamId());
+        }
+      }
+    }
+  }
+
+  EventStat kernel_time;
+  EventStat busy_time;
+  std::sort(kernels.begin(), kernels.end());
+  uint64_t busy_end = 0;
+  for (const auto& kernel : kernels) {
+    kernel_time.total_time += kernel.second - kernel.first;
+    if (kernel.first >= busy_end) {
+      busy_time.total_time += kernel.second - kernel.first;
+    } else if (kernel.second > busy_end) {
+      busy_time.total_time += kernel.second - busy_end;
+    }
+    busy_end = std::max(busy_end, kernel.second);
+  }
+  kernel_time.count = kernels.size();
+  busy_time.count = streams.size();
+  EventStat overlap_time;
+  overlap_time.total_time = kernel_time.total_time - busy_time.total_time;
+  overlap_time.count = streams.size();
+
+  for (auto* stat : {&kernel_time, &busy_time, &overlap_time}) {
+    stat->normalization_time = stat->total_time;
+  }
+  names_.emplace_back("DeviceKernelTime");
+  statistics_.push_back(kernel_time);
+  names_.emplace_back("DeviceBusyTime");
+  statistics_.push_back(busy_time);
+  names_.emplace_back("StreamOverlapTime");
+  statistics_.push_back(overlap_time);
+  return 0;
+}
+
+namespace {
+
+// causes of the time on the critical path besides the device time, and of
+// the idle gaps of the streams
+enum GapCause {
+  kHostDispatch = 0,
+  kEventWait,
+  kGarbageCollect,
+  kMemcpy,
+  kNumGapCauses
+};
+
+const char* kGapCauseNames[kNumGapCauses] = {
+    "HostDispatch", "EventWait", "GarbageCollect", "Memcpy"};
+
+using Interval = std::pair<uint64_t, uint64_t>;
+
+// a kernel, memcpy or memset on a stream and the host call launching it
+struct DeviceActivity {
+  uint64_t start_ns;
+  uint64_t end_ns;
+  uint64_t stream_id;
+  uint64_t launch_start_ns;
+  uint64_t launch_end_ns;
+  uint64_t thread_id;
+  std::string op_name;
+};
+
+struct HostTimeline {
+  // activities launched by the thread, in the order of launch end
+  std::vector<size_t> launches;
+  // host time of the thread spent in the causes other than host dispatch
+  std::vector<Interval> cause_intervals[kNumGapCauses];
+  // calls blocking the thread until the device finishes
+  std::vector<Interval> blocking_intervals;
+  std::vector<uint64_t> blocking_ends;
+};
+
+constexpr size_t kNoActivity = static_cast<size_t>(-1);
+
+void MergeIntervals(std::vector<Interval>* intervals) {
+  std::sort(intervals->begin(), intervals->end());
+  std::vector<Interval> merged;
+  for (const auto& interval : *intervals) {
+    if (!merged.empty() && interval.first <= merged.back().second) {
+      merged.back().second = std::max(merged.back().second, interval.second);
+    } else {
+      merged.push_back(interval);
+    }
+  }
+  intervals->swap(merged);
+}
+
+uint64_t OverlapTime(const std::vector<Interval>& intervals,
+                     uint64_t start,
+                     uint64_t end) {
+  uint64_t overlap = 0;
+  auto iter = std::lower_bound(
+      intervals.begin(),
+      intervals.end(),
+      start,
+      [](const Interval& interval, uint64_t t) { return interval.second < t; });
+  for (; iter != intervals.end() && iter->first < end; ++iter) {
+    overlap += std::min(iter->second, end) - std::max(iter->first, start);
+  }
+  return overlap;
+}
+
+// Splits the host time [start, end) of a thread into the causes, the time
+// not spent in GC, memcpy or synchronization is host dispatch.
+void AttributeHostTime(const HostTimeline& thread,
+                       uint64_t start,
+                       uint64_t end,
+                       uint64_t* causes) {
+  if (end <= start) {
+    return;
+  }
+  uint64_t rest = end - start;
+  for (int cause = kEventWait; cause < kNumGapCauses; ++cause) {
+    uint64_t time = std::min(
+        OverlapTime(thread.cause_intervals[cause], start, end), rest);
+    causes[cause] += time;
+    rest -= time;
+  }
+  causes[kHostDispatch] += rest;
+}
+
+// Returns the index in `ends`, sorted, of the last one not after `t`.
+size_t LastEndedBefore(const std::vector<uint64_t>& ends, uint64_t t) {
+  auto iter = std::upper_bound(ends.begin(), ends.end(), t);
+  return iter == ends.begin() ? kNoActivity : iter - ends.begin() - 1;
+}
+
+}  // namespace
+
+int StatisticsEngine::StatCriticalPath(const platform::NodeTrees& trees) {
+  std::vector<DeviceActivity> activities;
+  std::map<uint64_t, HostTimeline> threads;
+  for (const auto& kv : trees.GetNodeTrees()) {
+    auto& thread = threads[kv.first];
+    // host node and the innermost operator it runs in
+    std::vector<std::pair<const platform::HostTraceEventNode*, std::string>>
+        stack = {{kv.second, ""}};
+    while (!stack.empty()) {
+      const auto* node = stack.back().first;
+      std::string op_name = std::move(stack.back().second);
+      stack.pop_back();
+      const auto& name = node->Name();
+      if (node->Type() == platform::TracerEventType::Operator) {
+        op_name = name;
+      }
+      if (name == "CheckGC" || name == "RecordStreamForGC" ||
+          name == "eager_deletion") {
+        thread.cause_intervals[kGarbageCollect].emplace_back(node->StartNs(),
+                                                             node->EndNs());
+      }
+      for (const auto* runtime_node : node->GetRuntimeTraceEventNodes()) {
+        const auto& api = runtime_node->Name();
+        Interval interval(runtime_node->StartNs(), runtime_node->EndNs());
+        if (api.find("Synchronize") != std::string::npos ||
+            api.find("WaitEvent") != std::string::npos) {
+          thread.cause_intervals[kEventWait].push_back(interval);
+          thread.blocking_intervals.push_back(interval);
+        } else if (api.find("Memcpy") != std::string::npos ||
+                   api.find("Memset") != std::string::npos) {
+          thread.cause_intervals[kMemcpy].push_back(interval);
+          if (api.find("Async") == std::string::npos) {
+            thread.blocking_intervals.push_back(interval);
+          }
+        }
+        for (const auto* device_node :
+             runtime_node->GetDeviceTraceEventNodes()) {
+          if (device_node->Type() != platform::TracerEventType::Kernel &&
+              device_node->Type() != platform::TracerEventType::Memcpy &&
+              device_node->Type() != platform::TracerEventType::Memset) {
+            continue;
+          }
+          thread.launches.push_back(activities.size());
+          activities.push_back({device_node->StartNs(),
+                                device_node->EndNs(),
+                                device_node->StreamId(),
+                                runtime_node->StartNs(),
+                                runtime_node->EndNs(),
+                                kv.first,
+                                op_name});
+        }
+      }
+      for (const auto* child : node->GetChildren()) {
+        stack.emplace_back(child, op_name);
+      }
+    }
+  }
+  if (activities.empty()) {
+    VLOG(10) << "No device activities for the critical path";
+    return 0;
+  }
+
+  std::vector<size_t> launch_pos(activities.size());
+  for (auto& kv : threads) {
+    auto& thread = kv.second;
+    std::sort(thread.launches.begin(),
+              thread.launches.end(),
+              [&activities](size_t a, size_t b) {
+                return activities[a].launch_end_ns <
+                       activities[b].launch_end_ns;
+              });
+    for (size_t pos = 0; pos < thread.launches.size(); ++pos) {
+      launch_pos[thread.launches[pos]] = pos;
+    }
+    for (auto& intervals : thread.cause_intervals) {
+      MergeIntervals(&intervals);
+    }
+    MergeIntervals(&thread.blocking_intervals);
+    for (const auto& interval : thread.blocking_intervals) {
+      thread.blocking_ends.push_back(interval.second);
+    }
+  }
+
+  std::vector<size_t> by_end(activities.size());
+  for (size_t idx = 0; idx < by_end.size(); ++idx) {
+    by_end[idx] = idx;
+  }
+  std::sort(by_end.begin(), by_end.end(), [&activities](size_t a, size_t b) {
+    return activities[a].end_ns < activities[b].end_ns;
+  });
+  std::vector<uint64_t> ends;
+  ends.reserve(by_end.size());
+  for (auto idx : by_end) {
+    ends.push_back(activities[idx].end_ns);
+  }
+
+  // Idle gaps of every stream. The part of a gap before the next activity
+  // is launched is split into the host causes, the rest is waiting for an
+  // event if an activity of another stream finished meanwhile, otherwise it
+  // is the launch latency.
+  std::map<uint64_t, std::vector<size_t>> streams;
+  for (size_t idx = 0; idx < activities.size(); ++idx) {
+    streams[activities[idx].stream_id].push_back(idx);
+  }
+  std::map<uint64_t, std::vector<EventStat>> stream_idle;
+  for (auto& kv : streams) {
+    auto& stream = kv.second;
+    std::sort(stream.begin(), stream.end(), [&activities](size_t a, size_t b) {
+      return activities[a].start_ns < activities[b].start_ns;
+    });
+    auto& idle = stream_idle[kv.first];
+    idle.resize(kNumGapCauses);
+    for (size_t i = 1; i < stream.size(); ++i) {
+      const auto& prev = activities[stream[i - 1]];
+      const auto& cur = activities[stream[i]];
+      if (cur.start_ns <= prev.end_ns) {
+        continue;
+      }
+      uint64_t causes[kNumGapCauses] = {0};
+      uint64_t launched = std::min(cur.launch_end_ns, cur.start_ns);
+      AttributeHostTime(threads[cur.thread_id], prev.end_ns, launched, causes);
+      uint64_t ready = std::max(prev.end_ns, launched);
+      size_t last = LastEndedBefore(ends, cur.start_ns);
+      if (last != kNoActivity && ends[last] > ready) {
+        causes[kEventWait] += cur.start_ns - ready;
+      } else {
+        causes[kHostDispatch] += cur.start_ns - ready;
+      }
+      for (int cause = 0; cause < kNumGapCauses; ++cause) {
+        if (causes[cause] > 0) {
+          idle[cause].total_time += causes[cause];
+          idle[cause].count += 1;
+        }
+      }
+    }
+  }
+
+  // Walk the critical path back from the activity finishing last. An
+  // activity waits for the last one finished before it starts, on its own
+  // stream or on another one, or for its launch. Launches wait for the
+  // previous launch of the thread, unless the thread blocked in a
+  // synchronization until an activity finished.
+  uint64_t path_causes[kNumGapCauses] = {0};
+  EventStat path_device;
+  std::unordered_map<std::string, EventStat> path_ops;
+  size_t cur = by_end.back();
+  for (size_t step = 0; step < activities.size() && cur != kNoActivity;
+       ++step) {
+    const auto& act = activities[cur];
+    path_device.total_time += act.end_ns - act.start_ns;
+    path_device.count += 1;
+    auto& op_stat = path_ops[act.op_name];
+    op_stat.total_time += act.end_ns - act.start_ns;
+    op_stat.count += 1;
+
+    // the activity finished last before this one started, on its stream or
+    // on another one it waited for
+    size_t last = LastEndedBefore(ends, act.start_ns);
+    if (last != kNoActivity && ends[last] >= act.launch_end_ns &&
+        by_end[last] != cur) {
+      path_causes[kEventWait] += act.start_ns - ends[last];
+      cur = by_end[last];
+      continue;
+    }
+
+    if (act.start_ns > act.launch_end_ns) {
+      path_causes[kHostDispatch] += act.start_ns - act.launch_end_ns;
+    }
+    const auto& thread = threads[act.thread_id];
+    const auto& blocking_ends = thread.blocking_ends;
+    uint64_t t = act.launch_end_ns;
+    size_t pos = launch_pos[cur];
+    cur = kNoActivity;
+    while (true) {
+      uint64_t prev_launch_end =
+          pos > 0 ? activities[thread.launches[pos - 1]].launch_end_ns : 0;
+      size_t sync = LastEndedBefore(blocking_ends, t);
+      if (sync != kNoActivity && blocking_ends[sync] > prev_launch_end) {
+        size_t waited = LastEndedBefore(ends, blocking_ends[sync]);
+        if (waited != kNoActivity) {
+          AttributeHostTime(
+              thread, activities[by_end[waited]].end_ns, t, path_causes);
+          cur = by_end[waited];
+          break;
+        }
+      }
+      if (pos == 0) {
+        AttributeHostTime(thread,
+                          activities[thread.launches[0]].launch_start_ns,
+                          t,
+                          path_causes);
+        break;
+      }
+      AttributeHostTime(thread, prev_launch_end, t, path_causes);
+      t = prev_launch_end;
+      --pos;
+    }
+  }
+
+  size_t first_stat = statistics_.size();
+  EventStat path_total = path_device;
+  for (auto time : path_causes) {
+    path_total.total_time += time;
+  }
+  names_.emplace_back("CriticalPathTime");
+  statistics_.push_back(path_total);
+  names_.emplace_back("CriticalPathDeviceTime");
+  statistics_.push_back(path_device);
+  for (int cause = 0; cause < kNumGapCauses; ++cause) {
+    EventStat stat;
+    stat.total_time = path_causes[cause];
+    names_.emplace_back(std::string("CriticalPath") + kGapCauseNames[cause]);
+    statistics_.push_back(stat);
+  }
+  // the operators taking the most device time on the critical path
+  std::vector<std::pair<std::string, EventStat>> sorted_ops(path_ops.begin(),
+                                                            path_ops.end());
+  std::sort(sorted_ops.begin(),
+            sorted_ops.end(),
+            [](const std::pair<std::string, EventStat>& a,
+               const std::pair<std::string, EventStat>& b) {
+              return a.second.total_time > b.second.total_time;
+            });
+  if (sorted_ops.size() > 10) {
+    sorted_ops.resize(10);
+  }
+  for (auto& kv : sorted_ops) {
+    names_.emplace_back("CriticalPathOp::" +
+                        (kv.first.empty() ? "[no operator]" : kv.first));
+    statistics_.push_back(kv.second);
+  }
+  for (const auto& kv : stream_idle) {
+    for (int cause = 0; cause < kNumGapCauses; ++cause) {
+      names_.emplace_back("Stream" + std::to_string(kv.first) + "Idle" +
+                          kGapCauseNames[cause]);
+      statistics_.push_back(kv.second[cause]);
+    }
+  }
+  for (size_t idx = first_stat; idx < statistics_.size(); ++idx) {
+    statistics_[idx].normalization_time = statistics_[idx].total_time;
+  }
+  return 0;
+}
+
 void StatisticsEngine::Log(const std::string& filepath) {
   std::ofstream ofs;
   ofs.open(filepath, std::ofstream::out | std::ofstream::trunc);
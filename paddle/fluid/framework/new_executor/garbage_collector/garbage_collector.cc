@@ -16,11 +16,34 @@
 #include "paddle/fluid/framework/garbage_collector.h"
 #include "paddle/fluid/framework/new_executor/garbage_collector/event_garbage_collector.h"
 #include "paddle/fluid/framework/new_executor/garbage_collector/fast_garbage_collector.h"
+#include "paddle/fluid/framework/new_executor/garbage_collector/grouped_event_garbage_collector.h"
 #include "paddle/fluid/framework/new_executor/garbage_collector/no_event_garbage_collector.h"
 
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+#include "paddle/phi/backends/device_manager.h"
+
+COMMON_DECLARE_bool(custom_device_stream_ordered_allocator);
+#endif
+
 namespace paddle {
 namespace framework {
 
+// The stream-ordered allocator frees the memory after the work enqueued to
+// the stream before, so the gc needs no event per var, as on GPU.
+static bool IsCustomDeviceFastGCEnabled(const platform::Place& place) {
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  return platform::is_custom_place(place) &&
+         FLAGS_custom_device_stream_ordered_allocator &&
+         FLAGS_fast_eager_deletion_mode &&
+         memory::allocation::AllocatorFacade::Instance()
+             .IsStreamSafeCUDAAllocatorUsed() &&
+         phi::DeviceManager::GetDeviceWithPlace(place)
+             ->IsStreamOrderedAllocatorSupported();
+#else
+  return false;
+#endif
+}
+
 InterpreterCoreGarbageCollector::InterpreterCoreGarbageCollector() {
   garbages_ = std::make_unique<GarbageQueue>();
   max_memory_size_ = static_cast<int64_t>(GetEagerDeletionThreshold());
@@ -35,6 +58,9 @@ CreateInterpreterCoreGarbageCollector(
     if (IsInterpretercoreFastGCEnabled()) {  // NOLINT
       return std::unique_ptr<InterpreterCoreGarbageCollector>(
           new InterpreterCoreFastGarbageCollector());
+    } else if (FLAGS_new_executor_gc_batch_groups > 0) {
+      return std::unique_ptr<InterpreterCoreGarbageCollector>(
+          new InterpreterCoreGroupedEventGarbageCollector(vec_instruction));
     } else {
       return std::unique_ptr<InterpreterCoreGarbageCollector>(
           new InterpreterCoreEventGarbageCollector(vec_instruction));
@@ -51,6 +77,9 @@ CreateInterpreterCoreGarbageCollector(
   } else if (platform::is_ipu_place(place)) {
     return std::unique_ptr<InterpreterCoreGarbageCollector>(
         new InterpreterCoreNoEventGarbageCollector());
+  } else if (IsCustomDeviceFastGCEnabled(place)) {
+    return std::unique_ptr<InterpreterCoreGarbageCollector>(
+        new InterpreterCoreFastGarbageCollector());
   } else {
     return std::unique_ptr<InterpreterCoreGarbageCollector>(
         new InterpreterCoreEventGarbageCollector(vec_instruction));
@@ -81,6 +110,9 @@ CreateInterpreterCoreGarbageCollector(
   } else if (platform::is_ipu_place(place)) {
     return std::unique_ptr<InterpreterCoreGarbageCollector>(
         new InterpreterCoreNoEventGarbageCollector());
+  } else if (IsCustomDeviceFastGCEnabled(place)) {
+    return std::unique_ptr<InterpreterCoreGarbageCollector>(
+        new InterpreterCoreFastGarbageCollector());
   } else {
     return std::unique_ptr<InterpreterCoreGarbageCollector>(
         new InterpreterCoreEventGarbageCollector(vec_instruction));
@@ -40,6 +40,12 @@ class InterpreterCoreGarbageCollector {
 
   virtual void Add(Variable* var, const InstructionBase* instruction) = 0;
 
+  // Called once all the vars whose last use is the instruction are added.
+  virtual void FinishInstruction(const InstructionBase* instruction) {}
+
+  // Called at the end of a run, releases what the gc still holds back.
+  virtual void Flush() {}
+
   DISABLE_COPY_AND_ASSIGN(InterpreterCoreGarbageCollector);
 
  protected:
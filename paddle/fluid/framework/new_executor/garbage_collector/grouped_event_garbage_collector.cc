@@ -0,0 +1,200 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/garbage_collector/grouped_event_garbage_collector.h"
+
+#if !defined(_WIN32)
+#include <sched.h>
+#else
+#define NOMINMAX
+#include <windows.h>
+#endif  // !_WIN32
+
+#include <algorithm>
+
+#include "paddle/phi/core/metrics.h"
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+struct GroupedGCMetrics {
+  phi::MetricCounter* groups;
+  phi::MetricCounter* batches;
+  phi::MetricCounter* freed_bytes;
+  phi::MetricHistogram* latency;
+};
+
+GroupedGCMetrics& GetGroupedGCMetrics() {
+  static GroupedGCMetrics metrics = [] {
+    auto& registry = phi::MetricsRegistry::Instance();
+    GroupedGCMetrics m;
+    m.groups = registry.GetCounter(
+        "paddle_executor_gc_groups_total",
+        "Number of the groups of vars freed by the grouped gc.");
+    m.batches = registry.GetCounter(
+        "paddle_executor_gc_batches_total",
+        "Number of the tasks the grouped gc handed to the gc thread.");
+    m.freed_bytes =
+        registry.GetCounter("paddle_executor_gc_freed_bytes_total",
+                            "Bytes of the memory freed by the grouped gc.");
+    m.latency = registry.GetHistogram(
+        "paddle_executor_gc_latency_seconds",
+        "Time from the last use of a group of vars to its release.");
+    return m;
+  }();
+  return metrics;
+}
+
+}  // namespace
+
+InterpreterCoreGroupedEventGarbageCollector::
+    InterpreterCoreGroupedEventGarbageCollector(
+        const std::vector<std::unique_ptr<InstructionBase>>& vec_instruction)
+    : batch_groups_(static_cast<size_t>(
+          std::max(FLAGS_new_executor_gc_batch_groups, 1))) {
+  WorkQueueOptions options(/*name*/ "GarbageCollector",
+                           /*num_threads*/ 1,
+                           /*allow_spinning*/ true,
+                           /*track_task*/ false);
+  queue_ = CreateSingleThreadedWorkQueue(options);
+  for (auto& instruct : vec_instruction) {
+    gc_event_.emplace_back(instruct->DeviceContext().GetPlace(),
+                           platform::GenerateDeviceEventFlag());
+  }
+  open_groups_.resize(vec_instruction.size());
+}
+
+InterpreterCoreGroupedEventGarbageCollector::
+    ~InterpreterCoreGroupedEventGarbageCollector() {  // NOLINT
+  queue_.reset(nullptr);
+}
+
+void InterpreterCoreGroupedEventGarbageCollector::Add(
+    Variable* var, const Instruction& instr) {
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "The grouped event gc only serves the instructions of PirInterpreter."));
+}
+
+void InterpreterCoreGroupedEventGarbageCollector::Add(
+    Variable* var, const InstructionBase* instr) {
+  PADDLE_ENFORCE_LT(instr->Id(),
+                    open_groups_.size(),
+                    platform::errors::OutOfRange(
+                        "The index should be less than the size of gc event "
+                        ", but got index is %d and size is %d",
+                        instr->Id(),
+                        open_groups_.size()));
+  if (UNLIKELY(max_memory_size_ < 0) || var == nullptr) {
+    return;
+  }
+
+  GarbageGroup* group = &open_groups_[instr->Id()];
+  if (var->IsType<phi::DenseTensor>()) {
+    Add(var->GetMutable<phi::DenseTensor>()->MoveMemoryHolder(), group);
+  } else if (
+      var->IsType<
+          operators::reader::
+              OrderedMultiDeviceLoDTensorBlockingQueueHolder>()) {  // NOLINT
+    // not supported in eager deletion, as the event gc
+  } else if (var->IsType<LoDRankTable>()) {
+    // not supported in eager deletion, as the event gc
+  } else if (var->IsType<phi::SelectedRows>()) {
+    Add(var->GetMutable<phi::SelectedRows>()
+            ->mutable_value()
+            ->MoveMemoryHolder(),
+        group);
+    var->GetMutable<phi::SelectedRows>()->mutable_rows()->clear();
+  } else if (var->IsType<LoDTensorArray>()) {
+    auto* tensor_arr = var->GetMutable<LoDTensorArray>();
+    for (auto& t : *tensor_arr) {
+      Add(t.MoveMemoryHolder(), group);
+    }
+  } else if (var->IsType<std::vector<Scope*>>()) {
+    // the sub scope is deleted by the sub executor
+  } else {
+    PADDLE_THROW(platform::errors::Unimplemented(
+        "The variable(%s) is not supported in eager deletion.",
+        framework::ToTypeName(var->Type())));
+  }
+}
+
+void InterpreterCoreGroupedEventGarbageCollector::Add(Garbage garbage,
+                                                      GarbageGroup* group) {
+  if (!garbage) {
+    return;
+  }
+  group->bytes += static_cast<int64_t>(garbage->size());
+  group->garbages.push_back(std::move(garbage));
+}
+
+void InterpreterCoreGroupedEventGarbageCollector::FinishInstruction(
+    const InstructionBase* instr) {
+  GarbageGroup* group = &open_groups_.at(instr->Id());
+  if (group->garbages.empty()) {
+    return;
+  }
+  // one event per group, however many vars the instruction releases
+  group->event = &gc_event_.at(instr->Id());
+  group->event->Record(&instr->DeviceContext());
+  group->event->SetFinished();  // Only for CPU Event
+  group->closed_at = std::chrono::steady_clock::now();
+
+  std::lock_guard<memory::SpinLock> guard(spinlock_);
+  cur_memory_size_ += group->bytes;
+  batch_.emplace_back(std::move(*group));
+  *group = GarbageGroup();
+  if (batch_.size() >= batch_groups_ ||
+      (max_memory_size_ > 1 && cur_memory_size_ >= max_memory_size_)) {
+    FreeBatch();
+  }
+}
+
+void InterpreterCoreGroupedEventGarbageCollector::Flush() {
+  std::lock_guard<memory::SpinLock> guard(spinlock_);
+  if (!batch_.empty()) {
+    FreeBatch();
+  }
+}
+
+void InterpreterCoreGroupedEventGarbageCollector::FreeBatch() {
+  auto& metrics = GetGroupedGCMetrics();
+  metrics.batches->Increase();
+  metrics.groups->Increase(static_cast<int64_t>(batch_.size()));
+  queue_->AddTask([groups = std::move(batch_), &metrics]() mutable {
+    // the groups are closed in order, release each as soon as it is done
+    for (auto& group : groups) {
+      while (!group.event->Query()) {
+#if defined(_WIN32)
+        SleepEx(50, FALSE);
+#else
+        sched_yield();
+#endif
+        continue;
+      }
+      group.garbages.clear();
+      metrics.freed_bytes->Increase(group.bytes);
+      metrics.latency->Observe(
+          std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                        group.closed_at)
+              .count());
+    }
+  });
+  batch_.clear();
+  cur_memory_size_ = 0;
+}
+
+}  // namespace framework
+}  // namespace paddle
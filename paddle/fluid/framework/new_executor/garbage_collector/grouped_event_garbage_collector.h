@@ -0,0 +1,75 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <chrono>
+
+#include "paddle/fluid/framework/new_executor/garbage_collector/garbage_collector.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
+
+COMMON_DECLARE_int32(new_executor_gc_batch_groups);
+
+namespace paddle {
+namespace framework {
+
+/**
+ * InterpreterCoreGroupedEventGarbageCollector frees the vars of the pir
+ * interpreter by their lifetime instead of one by one.
+ *
+ * The vars whose last use is the same instruction share one group, which is
+ * closed by FinishInstruction with one event recorded on the context of the
+ * instruction. The closed groups are handed to the gc thread
+ * FLAGS_new_executor_gc_batch_groups at a time (or once they hold the eager
+ * deletion threshold), so a batch costs one task however many vars it frees.
+ * Flush hands over the groups left at the end of a run.
+ */
+class InterpreterCoreGroupedEventGarbageCollector
+    : public InterpreterCoreGarbageCollector {
+ public:
+  explicit InterpreterCoreGroupedEventGarbageCollector(
+      const std::vector<std::unique_ptr<InstructionBase>>& vec_instruction);
+
+  ~InterpreterCoreGroupedEventGarbageCollector();
+
+  void Add(Variable* var, const Instruction& instruction) override;
+
+  void Add(Variable* var, const InstructionBase* instruction) override;
+
+  void FinishInstruction(const InstructionBase* instruction) override;
+
+  void Flush() override;
+
+ private:
+  struct GarbageGroup {
+    GarbageQueue garbages;
+    platform::DeviceEvent* event{nullptr};
+    int64_t bytes{0};
+    std::chrono::steady_clock::time_point closed_at;
+  };
+
+  void Add(Garbage garbage, GarbageGroup* group);
+
+  void FreeBatch();
+
+  std::unique_ptr<WorkQueue> queue_;
+  std::vector<paddle::platform::DeviceEvent> gc_event_;
+  // the open group of each instruction, only touched by the thread running
+  // the instruction
+  std::vector<GarbageGroup> open_groups_;
+  std::vector<GarbageGroup> batch_;
+  size_t batch_groups_;
+};
+
+}  // namespace framework
+}  // namespace paddle
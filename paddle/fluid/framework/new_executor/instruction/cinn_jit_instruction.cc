@@ -40,6 +40,7 @@ class CinnJitInstruction::FnPtrImpl {
       : cinn_kernel_info_(cinn_kernel_info) {}
 
   void Run(const std::vector<phi::DenseTensor*>& kernel_args, void* stream) {
+    WaitCompiled();
     VLOG(6) << "Start Run: " << cinn_kernel_info_.fn_name;
     func_args_.clear();
 
@@ -72,6 +73,7 @@ class CinnJitInstruction::FnPtrImpl {
   void InferShape(const std::vector<phi::DenseTensor*>& kernel_args,
                   int32_t input_tensor_size,
                   int32_t output_tensor_size) {
+    WaitCompiled();
     VLOG(6) << "Start InferShape: " << cinn_kernel_info_.fn_name;
     func_args_.clear();
 
@@ -120,6 +122,20 @@ class CinnJitInstruction::FnPtrImpl {
   }
 
  private:
+  // The kernel may still be compiled in the background when the instruction
+  // is created, see FLAGS_cinn_async_compile. to_static runs the program
+  // without CINN until its kernels are ready, other callers wait here.
+  void WaitCompiled() {
+    if (cinn_kernel_info_.fn_ptr != nullptr ||
+        !cinn_kernel_info_.async_fn_ptrs.valid()) {
+      return;
+    }
+    VLOG(4) << "Wait for the compilation of " << cinn_kernel_info_.fn_name;
+    std::pair<void*, void*> fn_ptrs = cinn_kernel_info_.async_fn_ptrs.get();
+    cinn_kernel_info_.fn_ptr = fn_ptrs.first;
+    cinn_kernel_info_.infer_shape_fn_ptr = fn_ptrs.second;
+  }
+
   CINNKernelInfo cinn_kernel_info_;
 
   std::vector<cinn_pod_value_t> func_args_;
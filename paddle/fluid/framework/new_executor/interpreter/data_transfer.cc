@@ -236,6 +236,25 @@ void DataTransferHelper::RunAndConstructOpFuncNode(
   new_op_func_nodes->emplace_back(std::move(new_op_func_node));
 }
 
+bool CheckDataTransferCache(phi::DenseTensor* src, DataTransferStat* stat) {
+  if (!stat->cacheable || !src->IsInitialized()) {
+    return false;
+  }
+  const std::shared_ptr<phi::Allocation>& holder = src->Holder();
+  uint32_t inplace_version = src->InplaceVersionCounter().CurrentVersion();
+  if (stat->cached && stat->holder == holder &&
+      stat->offset == src->offset() &&
+      stat->inplace_version == inplace_version && stat->dims == src->dims()) {
+    return true;
+  }
+  stat->cached = true;
+  stat->holder = holder;
+  stat->offset = src->offset();
+  stat->inplace_version = inplace_version;
+  stat->dims = src->dims();
+  return false;
+}
+
 // Var is initialized && var contains tensor && tensor is initialized
 bool IsTensorOfVarInitialized(Variable* var) {
   if (var->IsInitialized()) {
@@ -524,6 +543,7 @@ void ApplyDataTransform(const OpKernelType& expected_kernel_key,
 
           bool is_transferred = false;
           std::string new_var_name;
+          size_t first_transfer_node = new_op_func_nodes->size();
           // special case
           if (!tensor_in->IsInitialized()) {
             if (should_skip_input) {
@@ -625,6 +645,15 @@ void ApplyDataTransform(const OpKernelType& expected_kernel_key,
 
           if (is_transferred) {
             transfered = true;
+            auto* var_desc = var_scope->VarDesc(var_name);
+            int src_var_id = var_desc && var_desc->Persistable()
+                                 ? var_scope->VarId(var_name)
+                                 : -1;
+            for (size_t j = first_transfer_node; j < new_op_func_nodes->size();
+                 ++j) {
+              new_op_func_nodes->at(j).transfer_for_op_ = op_base->Type();
+              new_op_func_nodes->at(j).transfer_src_var_id_ = src_var_id;
+            }
             // update RuntimeContext.inputs and original op_func_node inputs
             op_func_node->input_index[parameter_name][i] =
                 var_scope->VarId(new_var_name);
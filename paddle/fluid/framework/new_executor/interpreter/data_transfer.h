@@ -18,6 +18,7 @@
 #include "paddle/fluid/framework/data_layout.h"
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
 #include "paddle/fluid/framework/op_kernel_type.h"
+#include "paddle/phi/core/metrics.h"
 
 namespace paddle {
 namespace framework {
@@ -61,6 +62,29 @@ class DataTransferHelper {
   Scope* scope_;
 };
 
+/*
+ * The runtime state of a data transfer instruction: the counters of its runs
+ * and cache hits, labeled with the op the data is transferred for, and the
+ * source tensor of its last run if the source var is cached.
+ */
+struct DataTransferStat {
+  phi::MetricCounter* runs{nullptr};
+  phi::MetricCounter* cache_hits{nullptr};
+
+  bool cacheable{false};
+  bool cached{false};
+  // held so that a new allocation of the source cannot take its address
+  std::shared_ptr<phi::Allocation> holder;
+  size_t offset{0};
+  uint32_t inplace_version{0};
+  phi::DDim dims;
+};
+
+// Returns true if the transfer of a cacheable source can be skipped, since
+// the source tensor keeps the allocation, offset, dims and inplace version of
+// the last run, otherwise records them.
+bool CheckDataTransferCache(phi::DenseTensor* src, DataTransferStat* stat);
+
 void ApplyDataTransform(const OpKernelType& expected_kernel_key,
                         const platform::Place& place,
                         VariableValueMap* ins_map_temp,
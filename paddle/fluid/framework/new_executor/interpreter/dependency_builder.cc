@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/dependency_builder.h"
 
+#include <algorithm>
 #include <queue>
 #include <sstream>
 #include <stack>
@@ -148,6 +149,59 @@ const std::map<size_t, std::set<size_t>>& DependencyBuilder::OpDownstreamMap()
   return *op_downstream_map_;
 }
 
+std::vector<int64_t> DependencyBuilder::CriticalPathCost(
+    const std::vector<int64_t>& op_costs) const {
+  const auto& downstream_map = OpDownstreamMap();
+  size_t op_num = op_costs.size();
+  std::vector<size_t> upstream_num(op_num, 0);
+  for (auto& item : downstream_map) {
+    for (auto next_op : item.second) {
+      ++upstream_num[next_op];
+    }
+  }
+
+  // topological order, then accumulate the costs backward
+  std::vector<size_t> order;
+  order.reserve(op_num);
+  for (size_t op_idx = 0; op_idx < op_num; ++op_idx) {
+    if (upstream_num[op_idx] == 0) {
+      order.push_back(op_idx);
+    }
+  }
+  for (size_t i = 0; i < order.size(); ++i) {
+    auto it = downstream_map.find(order[i]);
+    if (it == downstream_map.end()) {
+      continue;
+    }
+    for (auto next_op : it->second) {
+      if (--upstream_num[next_op] == 0) {
+        order.push_back(next_op);
+      }
+    }
+  }
+  PADDLE_ENFORCE_EQ(
+      order.size(),
+      op_num,
+      phi::errors::PreconditionNotMet(
+          "The op dependency is not a DAG, %d ops are sorted in %d ops.",
+          order.size(),
+          op_num));
+
+  std::vector<int64_t> path_costs(op_costs);
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    auto downstream = downstream_map.find(*it);
+    if (downstream == downstream_map.end()) {
+      continue;
+    }
+    int64_t max_cost = 0;
+    for (auto next_op : downstream->second) {
+      max_cost = std::max(max_cost, path_costs[next_op]);
+    }
+    path_costs[*it] += max_cost;
+  }
+  return path_costs;
+}
+
 void DependencyBuilder::AddDependencyForCoalesceTensorOp() {
   for (size_t op_idx = 0; op_idx < op_num_; ++op_idx) {
     if (instructions_->at(op_idx).OpBaseValid() &&
@@ -57,6 +57,12 @@ class DependencyBuilder {
 
   void ShareDependencyFrom(const DependencyBuilder& src);
 
+  // the cost of the longest path from each op to an op without downstream
+  // ops, the op itself included. Ops on the critical path are scheduled first
+  // by FLAGS_new_executor_critical_path_schedule.
+  std::vector<int64_t> CriticalPathCost(
+      const std::vector<int64_t>& op_costs) const;
+
  protected:
   void AddDependencyForCoalesceTensorOp();
   virtual void AddDependencyForCommunicationOp();
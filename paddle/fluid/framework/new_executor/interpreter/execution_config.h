@@ -30,6 +30,7 @@ struct ExecutionConfig {
   bool used_for_control_flow_op{false};
   bool used_for_jit{false};
   bool used_for_inference{false};
+  bool auto_cuda_graph{false};
 
   size_t device_num_threads{0};
   size_t host_num_threads{0};
@@ -40,6 +40,7 @@
 #include "paddle/phi/core/distributed/comm_context_manager.h"
 #include "paddle/phi/core/kernel_context.h"
 #include "paddle/phi/core/kernel_factory.h"
+#include "paddle/utils/string/string_helper.h"
 
 #ifdef PADDLE_WITH_DNNL
 #include "paddle/fluid/platform/onednn_helper.h"
@@ -53,6 +54,8 @@ COMMON_DECLARE_bool(use_mkldnn);
 COMMON_DECLARE_bool(check_nan_inf);
 COMMON_DECLARE_string(static_runtime_data_save_path);
 COMMON_DECLARE_bool(save_static_runtime_data);
+COMMON_DECLARE_bool(new_executor_adaptive_spinning);
+COMMON_DECLARE_string(new_executor_workqueue_cpus);
 
 namespace paddle {
 namespace framework {
@@ -92,6 +95,31 @@ class SingleStreamGuard {
   std::shared_ptr<OperatorBase> op_;
 };
 
+// Parses a cpu list like "0-3,8".
+static std::vector<int> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> cpus;
+  for (auto& item : paddle::string::split_string<std::string>(cpu_list, ",")) {
+    auto range = paddle::string::split_string<std::string>(item, "-");
+    PADDLE_ENFORCE_EQ(
+        !item.empty() && range.size() <= 2 &&
+            std::all_of(range.begin(),
+                        range.end(),
+                        [](const std::string& cpu) {
+                          return !cpu.empty() &&
+                                 std::all_of(cpu.begin(), cpu.end(), ::isdigit);
+                        }),
+        true,
+        platform::errors::InvalidArgument(
+            "The cpu list should be like 0-3,8, but got %s.", cpu_list));
+    int first = std::stoi(range.front());
+    int last = std::stoi(range.back());
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
 const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
     size_t host_num_threads, size_t device_num_threads, EventsWaiter* waiter) {
   std::vector<WorkQueueOptions> group_options;
@@ -111,6 +139,12 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  std::vector<int> cpu_affinity =
+      ParseCpuList(FLAGS_new_executor_workqueue_cpus);
+  for (auto& options : group_options) {
+    options.adaptive_spinning = FLAGS_new_executor_adaptive_spinning;
+    options.cpu_affinity = cpu_affinity;
+  }
   return group_options;
 }
 
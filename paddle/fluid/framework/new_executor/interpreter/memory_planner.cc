@@ -0,0 +1,79 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/memory_planner.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+static size_t AlignUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+size_t PlanMemoryBlocks(std::vector<MemoryBlock>* blocks, size_t alignment) {
+  std::vector<size_t> order(blocks->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [blocks](size_t a, size_t b) {
+    return (*blocks)[a].size > (*blocks)[b].size;
+  });
+
+  size_t arena_size = 0;
+  std::vector<size_t> placed;
+  std::vector<const MemoryBlock*> alive;
+  for (auto idx : order) {
+    MemoryBlock* block = &(*blocks)[idx];
+    alive.clear();
+    for (auto other : placed) {
+      const MemoryBlock& o = (*blocks)[other];
+      if (o.begin <= block->end && block->begin <= o.end) {
+        alive.push_back(&o);
+      }
+    }
+    std::sort(alive.begin(),
+              alive.end(),
+              [](const MemoryBlock* a, const MemoryBlock* b) {
+                return a->offset < b->offset;
+              });
+    size_t size = AlignUp(block->size, alignment);
+    size_t offset = 0;
+    for (auto* o : alive) {
+      if (offset + size <= o->offset) {
+        break;
+      }
+      offset = std::max(offset, AlignUp(o->offset + o->size, alignment));
+    }
+    block->offset = offset;
+    arena_size = std::max(arena_size, offset + size);
+    placed.push_back(idx);
+  }
+  return arena_size;
+}
+
+size_t PlanMemoryBlocksWithoutReuse(std::vector<MemoryBlock>* blocks,
+                                    size_t alignment) {
+  size_t arena_size = 0;
+  for (auto& block : *blocks) {
+    block.offset = arena_size;
+    arena_size += AlignUp(block.size, alignment);
+  }
+  return arena_size;
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
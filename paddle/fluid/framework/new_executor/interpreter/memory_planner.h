@@ -0,0 +1,66 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/core/allocator.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// A tensor of size bytes that is alive from the begin-th to the end-th
+// instruction of the execution order, both included.
+struct MemoryBlock {
+  size_t size{0};
+  size_t begin{0};
+  size_t end{0};
+  size_t offset{0};
+  // the number of instructions reading or writing the tensor
+  size_t accesses{0};
+};
+
+// The slice of a planned block in the arena, it keeps the arena alive so the
+// vars holding it never dangle.
+class MemoryBlockAllocation : public phi::Allocation {
+ public:
+  MemoryBlockAllocation(std::shared_ptr<phi::Allocation> arena,
+                        size_t offset,
+                        size_t size)
+      : phi::Allocation(static_cast<char*>(arena->ptr()) + offset,
+                        size,
+                        arena->place()),
+        arena_(std::move(arena)) {}
+
+ private:
+  std::shared_ptr<phi::Allocation> arena_;
+};
+
+// Assigns the offset of every block in one arena so that blocks alive at the
+// same time do not overlap. The largest blocks are placed first, each at the
+// lowest aligned gap between the blocks placed already that overlap it in
+// time (greedy by size). Returns the arena size.
+size_t PlanMemoryBlocks(std::vector<MemoryBlock>* blocks, size_t alignment);
+
+// Offsets without any reuse, used to check a plan before it shares memory.
+size_t PlanMemoryBlocksWithoutReuse(std::vector<MemoryBlock>* blocks,
+                                    size_t alignment);
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
@@ -14,12 +14,18 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/stream_analyzer.h"
 
+#include <algorithm>
 #include <future>
 #include <unordered_set>
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_attribute.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_dialect.h"
 #include "paddle/fluid/platform/device_context.h"
+#include "paddle/phi/core/compat/convert_utils.h"
+#include "paddle/pir/include/core/block.h"
+#include "paddle/pir/include/core/builtin_attribute.h"
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/common/flags.h"
 #include "paddle/fluid/platform/collective_helper.h"
@@ -820,6 +826,96 @@ void PirStreamAnalyzer::ShrinkEventInfo(
   shrink_event_info<PirDependencyBuilder>(dependency_builder, event_info_map);
 }
 
+static bool IsAutoStreamOp(const pir::Operation& op) {
+  if (op.dialect()->name() != paddle::dialect::KernelDialect::name()) {
+    return false;
+  }
+  auto& attrs = op.attributes();
+  if (attrs.count("ring_id") ||
+      (attrs.count("execution_stream") &&
+       attrs.at("execution_stream").dyn_cast<pir::StrAttribute>().AsString() !=
+           kDefaultStream)) {
+    return false;
+  }
+  std::string op_name =
+      attrs.at("op_name").dyn_cast<pir::StrAttribute>().AsString();
+  if (op_name.find("memcpy") != std::string::npos ||
+      op_name == "pd_op.fetch" || op_name == "pd_op.shadow_feed") {
+    return false;
+  }
+  if (attrs.count("kernel_key")) {
+    auto kernel_key =
+        attrs.at("kernel_key").dyn_cast<dialect::KernelAttribute>().data();
+    if (phi::TransToPhiPlace(kernel_key.backend()).GetType() ==
+        phi::AllocationType::CPU) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<size_t> AssignAutoStreams(const pir::Block& block,
+                                      const platform::Place& place,
+                                      int stream_num) {
+  std::vector<size_t> stream_op_nums(std::max(stream_num, 1), 0);
+  if (stream_num <= 1 || !platform::is_gpu_place(place)) {
+    return stream_op_nums;
+  }
+
+  // the stream of each op and whether one of its consumers continued it,
+  // builtin ops like combine pass the producers of their operands through
+  std::unordered_map<const pir::Operation*, int> op2stream;
+  std::unordered_set<const pir::Operation*> continued;
+  std::unordered_map<const pir::Operation*, std::vector<pir::Operation*>>
+      forwarded;
+  int next_stream = 0;
+  for (auto& op : block) {
+    std::vector<pir::Operation*> producers;
+    for (size_t i = 0; i < op.num_operands(); ++i) {
+      auto value = op.operand_source(i);
+      if (!value || value.defining_op() == nullptr) {
+        continue;
+      }
+      auto* producer = value.defining_op();
+      auto it = forwarded.find(producer);
+      if (it != forwarded.end()) {
+        producers.insert(producers.end(), it->second.begin(), it->second.end());
+      } else if (op2stream.count(producer)) {
+        producers.push_back(producer);
+      }
+    }
+    if (!IsAutoStreamOp(op)) {
+      if (op.dialect()->name() == "builtin") {
+        forwarded[&op] = producers;
+      }
+      continue;
+    }
+
+    int stream_id = -1;
+    for (auto* producer : producers) {
+      if (!continued.count(producer)) {
+        continued.insert(producer);
+        stream_id = op2stream.at(producer);
+        break;
+      }
+    }
+    if (stream_id < 0) {
+      // ops without kernel producers stay on the default stream, the other
+      // consumers of a fork start a new branch
+      stream_id = producers.empty() ? 0 : (++next_stream) % stream_num;
+    }
+    op2stream[&op] = stream_id;
+    ++stream_op_nums[stream_id];
+    if (stream_id > 0) {
+      op.set_attribute(
+          "execution_stream",
+          pir::StrAttribute::get(pir::IrContext::Instance(),
+                                 "auto_stream_" + std::to_string(stream_id)));
+    }
+  }
+  return stream_op_nums;
+}
+
 platform::DeviceType PirStreamAnalyzer::GetWaiterType(
     const paddle::framework::InstructionBase* instr) const {
   if (instr->KernelType() == OpFuncType::kCpuSync) {
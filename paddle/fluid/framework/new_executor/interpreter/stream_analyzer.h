@@ -22,6 +22,10 @@
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/device_event.h"
 
+namespace pir {
+class Block;
+}  // namespace pir
+
 namespace paddle {
 namespace framework {
 namespace interpreter {
@@ -127,6 +131,17 @@ class StreamAnalyzer {
 /// ======================== ///
 ///        For new ir        ///
 /// ======================== ///
+
+// Spreads the independent branches of block over stream_num compute streams
+// by setting the execution_stream of their kernel ops, stream 0 is the default
+// stream. An op continues the stream of the first producer whose stream no
+// other consumer continued yet, the other consumers of a fork start a new
+// stream round robin. Comm, memcpy and cpu ops and the ops given a stream
+// already are left alone. Returns the number of ops on each stream.
+std::vector<size_t> AssignAutoStreams(const pir::Block& block,
+                                      const platform::Place& place,
+                                      int stream_num);
+
 class PirStreamAnalyzer {
  public:
   using DeviceContext = platform::DeviceContext;
@@ -14,8 +14,11 @@
 
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
 
+#include <chrono>
+
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 #include "paddle/fluid/framework/new_executor/program_interpreter.h"
+#include "paddle/phi/core/metrics.h"
 #include "paddle/pir/include/core/program.h"
 #include "paddle/pir/include/core/value.h"
 
@@ -34,6 +37,12 @@ PADDLE_DEFINE_EXPORTED_bool(new_executor_use_local_scope,
                             true,
                             "Use local_scope in new executor(especially used "
                             "in UT), can turn off for better performance");
+PADDLE_DEFINE_EXPORTED_bool(
+    new_executor_cache_data_transfer,
+    false,
+    "Skip the data transfer ops of the persistable vars which no op of the "
+    "program writes, while the vars are unchanged. Only applies to the "
+    "inference predictors, whose weights are not rewritten in place.");
 
 namespace paddle {
 namespace framework {
@@ -63,12 +72,34 @@ InterpreterCore::~InterpreterCore() {
   impl_.reset(nullptr);
 }
 
+namespace {
+
+// Observes the host time of a step into the step time histogram.
+class StepTimer {
+ public:
+  StepTimer() : start_(std::chrono::steady_clock::now()) {}
+  ~StepTimer() {
+    static auto* step_time = phi::MetricsRegistry::Instance().GetHistogram(
+        "paddle_executor_step_seconds",
+        "Host time of a run of the standalone executor.");
+    step_time->Observe(std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start_)
+                           .count());
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace
+
 FetchList InterpreterCore::Run(
     const std::vector<std::string>& feed_names,
     const std::vector<phi::DenseTensor>& feed_tensors,
     bool need_fetch,
     bool enable_job_schedule_profiler,
     bool switch_stream) {
+  StepTimer step_timer;
   return impl_->Run(feed_names,
                     feed_tensors,
                     need_fetch,
@@ -81,6 +112,7 @@ FetchList InterpreterCore::Run(const std::vector<std::string>& feed_names,
                                bool enable_job_schedule_profiler,
                                bool enable_op_profiling,
                                bool switch_stream) {
+  StepTimer step_timer;
   return impl_->Run(feed_names,
                     need_fetch,
                     enable_job_schedule_profiler,
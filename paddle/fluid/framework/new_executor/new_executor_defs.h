@@ -199,6 +199,11 @@ struct OpFuncNode {
 
   bool fluid_op{false};
   std::shared_ptr<RuntimeContext> runtime_ctx_{nullptr};
+
+  // for the data transfer ops, the type of the op the data is transferred
+  // for, and the id of the source var if it is persistable, otherwise -1
+  std::string transfer_for_op_;
+  int transfer_src_var_id_{-1};
 };
 
 class Instruction {
@@ -14,7 +14,9 @@
 
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <unordered_set>
 
 #include "paddle/common/flags.h"
@@ -24,12 +26,16 @@
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/framework/new_executor/interpreter/static_build.h"
 #include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/memory/allocation/allocation_tracer.h"
+#include "paddle/fluid/memory/malloc.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/os_info.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/metrics.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/sparse_csr_tensor.h"
 
@@ -48,6 +54,12 @@
 #include "paddle/fluid/framework/new_executor/instruction/cinn_jit_instruction.h"
 #endif
 
+#ifdef PADDLE_WITH_XPU
+#include "paddle/phi/backends/xpu/xpu_header.h"
+#include "paddle/phi/backends/xpu/xpu_info.h"
+#include "paddle/phi/backends/xpu/xpu_l3_strategy.h"
+#endif
+
 #include "paddle/fluid/framework/new_executor/instruction/builtin_combine_instruction.h"
 #include "paddle/fluid/framework/new_executor/instruction/control_flow/assert_instruction.h"
 #include "paddle/fluid/framework/new_executor/instruction/control_flow/has_elements_instruction.h"
@@ -82,6 +94,13 @@ COMMON_DECLARE_bool(dynamic_static_unified_comm);
 COMMON_DECLARE_bool(enable_pir_in_executor);
 COMMON_DECLARE_bool(enable_pir_in_executor_trace_run);
 COMMON_DECLARE_int32(low_precision_op_list);
+COMMON_DECLARE_bool(new_executor_auto_cuda_graph);
+COMMON_DECLARE_int32(new_executor_auto_cuda_graph_warmup_steps);
+COMMON_DECLARE_int32(new_executor_auto_cuda_graph_max_buckets);
+COMMON_DECLARE_bool(new_executor_static_memory_plan);
+COMMON_DECLARE_int64(new_executor_xpu_l3_plan_size);
+COMMON_DECLARE_bool(new_executor_critical_path_schedule);
+COMMON_DECLARE_int32(new_executor_auto_stream_num);
 
 #define CREATE_INSTR(instr_name)                                   \
   vec_instruction_base_.emplace_back(std::make_unique<instr_name>( \
@@ -147,6 +166,10 @@ PirInterpreter::PirInterpreter(const platform::Place& place,
     SchedulingPriority rhs_scheduling_priority =
         vec_instruction_base_[rhs]->GetSchedulingPriority();
     if (lhs_scheduling_priority == rhs_scheduling_priority) {
+      if (!critical_path_costs_.empty() &&
+          critical_path_costs_[lhs] != critical_path_costs_[rhs]) {
+        return critical_path_costs_[lhs] < critical_path_costs_[rhs];
+      }
       return lhs > rhs;
     }
     return lhs_scheduling_priority > rhs_scheduling_priority;
@@ -209,6 +232,10 @@ PirInterpreter::PirInterpreter(
     SchedulingPriority rhs_scheduling_priority =
         vec_instruction_base_[rhs]->GetSchedulingPriority();
     if (lhs_scheduling_priority == rhs_scheduling_priority) {
+      if (!critical_path_costs_.empty() &&
+          critical_path_costs_[lhs] != critical_path_costs_[rhs]) {
+        return critical_path_costs_[lhs] < critical_path_costs_[rhs];
+      }
       return lhs > rhs;
     }
     return lhs_scheduling_priority > rhs_scheduling_priority;
@@ -400,6 +427,536 @@ void PirInterpreter::CheckCUDAGraphBeforeRun(
 #endif
 }
 
+bool PirInterpreter::IsAutoCUDAGraphCapturable() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (auto_cuda_graph_capturable_ >= 0) {
+    return auto_cuda_graph_capturable_ > 0;
+  }
+  auto_cuda_graph_capturable_ = 0;
+  auto_cuda_graph_tail_.clear();
+  if (!platform::is_gpu_place(place_) || !IsInterpretercoreFastGCEnabled()) {
+    VLOG(1) << "Auto CUDA Graph needs a GPU place and the fast GC";
+    return false;
+  }
+  // kernels that sync with the host on data dependent sizes
+  static const std::unordered_set<std::string> kNotCapturableOps = {
+      "pd_op.memcpy_d2h",
+      "pd_op.memcpy_d2h_multi_io",
+      "pd_op.memcpy_h2d",
+      "pd_op.nonzero",
+      "pd_op.masked_select",
+      "pd_op.unique",
+      "pd_op.unique_consecutive",
+      "pd_op.print",
+  };
+  auto* default_dev_ctx = platform::DeviceContextPool::Instance().Get(place_);
+  for (auto instr_id : trace_execute_order_) {
+    auto* instr = vec_instruction_base_.at(instr_id).get();
+    const std::string& op_name = instr->Name();
+    if (op_name == "pd_op.fetch") {
+      auto_cuda_graph_tail_.push_back(instr_id);
+      continue;
+    }
+    // control flow ops of the pd_op and cf dialects decide on the host
+    const std::string& dialect = instr->Operation()->dialect()->name();
+    if (dialect == "pd_op" || dialect == "cf" ||
+        instr->KernelType() != OpFuncType::kGpuAsync ||
+        &instr->DeviceContext() != default_dev_ctx ||
+        kNotCapturableOps.count(op_name)) {
+      LOG_FIRST_N(WARNING, 1)
+          << "Auto CUDA Graph is disabled, instruction " << op_name << "["
+          << instr_id << "] can not be captured";
+      auto_cuda_graph_tail_.clear();
+      return false;
+    }
+  }
+  auto_cuda_graph_capturable_ = 1;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool PirInterpreter::RunByAutoCUDAGraph(
+    const std::vector<std::string>& feed_names) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!(FLAGS_new_executor_auto_cuda_graph ||
+        execution_config_.auto_cuda_graph) ||
+      FLAGS_new_executor_use_cuda_graph || enable_job_schedule_profiler_ ||
+      platform::IsCUDAGraphCapturing() || !IsAutoCUDAGraphCapturable()) {
+    return false;
+  }
+
+  // the feed shapes select the captured step
+  std::string key;
+  std::vector<phi::DenseTensor*> feeds;
+  for (auto& feed_name : feed_names) {
+    auto* feed_var = InnerScope()->FindVar(feed_name);
+    if (feed_var == nullptr || !feed_var->IsType<phi::DenseTensor>()) {
+      return false;
+    }
+    auto* feed_tensor = feed_var->GetMutable<phi::DenseTensor>();
+    if (!feed_tensor->IsInitialized() || !feed_tensor->lod().empty() ||
+        feed_tensor->place() != place_) {
+      return false;
+    }
+    key += feed_tensor->dims().to_str() +
+           phi::DataTypeToString(feed_tensor->dtype()) + ";";
+    feeds.push_back(feed_tensor);
+  }
+  auto it = auto_cuda_graphs_.find(key);
+  if (it == auto_cuda_graphs_.end()) {
+    if (static_cast<int>(auto_cuda_graphs_.size()) >=
+        FLAGS_new_executor_auto_cuda_graph_max_buckets) {
+      return false;
+    }
+    it = auto_cuda_graphs_.emplace(key, std::make_unique<AutoCUDAGraph>())
+             .first;
+  }
+  AutoCUDAGraph* bucket = it->second.get();
+  if (bucket->disabled) {
+    return false;
+  }
+  if (bucket->graph == nullptr &&
+      bucket->run_num++ < FLAGS_new_executor_auto_cuda_graph_warmup_steps) {
+    // warm up autotune, lazy handles and the parameters eagerly first
+    return false;
+  }
+
+  // copy the feeds into the buffers the graph reads
+  auto* dev_ctx = platform::DeviceContextPool::Instance().Get(place_);
+  bucket->feeds.resize(feeds.size());
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    // the feed var still holds the buffer if the caller did not feed again
+    if (!bucket->feeds[i].IsInitialized() ||
+        feeds[i]->data() != bucket->feeds[i].data()) {
+      framework::TensorCopy(*feeds[i], place_, *dev_ctx, &bucket->feeds[i]);
+      feeds[i]->ShareDataWith(bucket->feeds[i]);
+    }
+  }
+
+  if (bucket->graph == nullptr) {
+    CaptureAutoCUDAGraph(bucket);
+    return !bucket->disabled;
+  }
+
+  for (auto& param : bucket->params) {
+    auto& tensor = param.first->Get<phi::DenseTensor>();
+    if (!tensor.IsInitialized() || tensor.data() != param.second) {
+      LOG_FIRST_N(WARNING, 1)
+          << "Auto CUDA Graph of feed shape " << key
+          << " is disabled, a parameter was reallocated after the capture";
+      bucket->disabled = true;
+      bucket->fetch_inputs.clear();
+      bucket->graph.reset();
+      return false;
+    }
+  }
+
+  interpreter::ResetAtomicGuard guard(&deps_, &refs_);
+  bucket->graph->Replay();
+  RunAutoCUDAGraphTail(bucket);
+  return true;
+#else
+  return false;
+#endif
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+void PirInterpreter::CaptureAutoCUDAGraph(AutoCUDAGraph* bucket) {
+  VLOG(1) << "Auto CUDA Graph capture " << auto_cuda_graph_tail_.size()
+          << " fetch ops after " << trace_execute_order_.size()
+          << " instructions";
+  std::unordered_set<size_t> tail(auto_cuda_graph_tail_.begin(),
+                                  auto_cuda_graph_tail_.end());
+  {
+    interpreter::ResetAtomicGuard guard(&deps_, &refs_);
+    exception_holder_.Clear();
+    platform::BeginCUDAGraphCapture(place_, gpuStreamCaptureModeThreadLocal);
+    for (auto instr_id : trace_execute_order_) {
+      if (tail.count(instr_id)) {
+        continue;
+      }
+      RunInstructionBase(vec_instruction_base_.at(instr_id).get());
+      if (UNLIKELY(exception_holder_.IsCaught())) {
+        break;
+      }
+    }
+    bucket->graph = platform::EndCUDAGraphCapture();
+  }
+
+  if (UNLIKELY(exception_holder_.IsCaught())) {
+    // nothing ran while capturing, so the step runs again eagerly
+    LOG(WARNING) << "Auto CUDA Graph is disabled, the capture failed: "
+                 << exception_holder_.Type();
+    exception_holder_.Clear();
+    bucket->graph.reset();
+    bucket->disabled = true;
+    auto_cuda_graph_capturable_ = 0;
+    TraceRunImpl();
+    return;
+  }
+
+  for (auto& name : parameter_var_names_) {
+    auto* var = InnerScope()->FindVar(name);
+    if (var != nullptr && var->IsType<phi::DenseTensor>() &&
+        var->Get<phi::DenseTensor>().IsInitialized()) {
+      bucket->params.emplace_back(var, var->Get<phi::DenseTensor>().data());
+    }
+  }
+  // keep the fetched outputs of the graph alive, the fetch ops free them
+  for (auto instr_id : auto_cuda_graph_tail_) {
+    for (auto var_id : vec_instruction_base_.at(instr_id)->GCCheckVars()) {
+      auto* var = refs_[var_id]->Var();
+      if (var->IsType<phi::DenseTensor>()) {
+        bucket->fetch_inputs.emplace_back(var, var->Get<phi::DenseTensor>());
+      }
+    }
+  }
+
+  interpreter::ResetAtomicGuard guard(&deps_, &refs_);
+  bucket->graph->Replay();
+  RunAutoCUDAGraphTail(bucket);
+}
+
+void PirInterpreter::RunAutoCUDAGraphTail(AutoCUDAGraph* bucket) {
+  for (auto& input : bucket->fetch_inputs) {
+    input.first->GetMutable<phi::DenseTensor>()->ShareDataWith(input.second);
+  }
+  exception_holder_.Clear();
+  for (auto instr_id : auto_cuda_graph_tail_) {
+    RunInstructionBase(vec_instruction_base_.at(instr_id).get());
+    if (UNLIKELY(exception_holder_.IsCaught())) {
+      exception_holder_.ReThrow();
+    }
+  }
+}
+#endif
+
+bool PirInterpreter::PrepareStaticMemoryPlan() {
+  if (!FLAGS_new_executor_static_memory_plan) {
+    if (memory_plan_state_ != kMemoryPlanUnknown) {
+      ResetStaticMemoryPlan();
+      memory_plan_state_ = kMemoryPlanUnknown;
+    }
+    return false;
+  }
+  if (memory_plan_state_ == kMemoryPlanChecking) {
+    // the checking step did not finish
+    ResetStaticMemoryPlan();
+    memory_plan_state_ = kMemoryPlanOff;
+  }
+  if (memory_plan_state_ == kMemoryPlanUnknown) {
+    memory_plan_state_ = kMemoryPlanOff;
+    // the plan follows the trace order, control flow runs sub blocks
+    if (!sub_blocks_.empty()) {
+      VLOG(1) << "Static memory plan is disabled by control flow ops";
+      return false;
+    }
+    CollectStaticMemoryBlocks();
+    if (memory_plan_var_ids_.empty()) {
+      return false;
+    }
+    AssignStaticMemoryPlan(false);
+    memory_plan_state_ = kMemoryPlanChecking;
+  }
+  return memory_plan_state_ != kMemoryPlanOff;
+}
+
+void PirInterpreter::CollectStaticMemoryBlocks() {
+  constexpr size_t kUnknown = std::numeric_limits<size_t>::max();
+  const auto& var_list = value_exe_info_->GetVarList();
+  std::vector<size_t> sizes(var_list.size(), 0);
+  std::vector<size_t> begins(var_list.size(), kUnknown);
+  std::vector<size_t> first_uses(var_list.size(), kUnknown);
+  std::vector<size_t> accesses(var_list.size(), 0);
+  std::vector<bool> dynamic(var_list.size(), false);
+  // the vars touched by the instructions off the default stream, whose
+  // accesses the trace order does not bound
+  std::vector<bool> multi_stream(var_list.size(), false);
+  std::vector<size_t> positions(vec_instruction_base_.size(), 0);
+  auto* default_dev_ctx = platform::DeviceContextPool::Instance().Get(place_);
+
+  for (size_t pos = 0; pos < trace_execute_order_.size(); ++pos) {
+    auto* instr = vec_instruction_base_.at(trace_execute_order_[pos]).get();
+    positions[instr->Id()] = pos;
+    if (&instr->DeviceContext() != default_dev_ctx ||
+        interpreter::IsCommunicationOp(instr->Operation())) {
+      for (auto* items : {&instr->Inputs(), &instr->Outputs()}) {
+        for (auto& item : *items) {
+          for (auto var_id : item.second) {
+            multi_stream[var_id] = true;
+          }
+        }
+      }
+    }
+    for (auto& item : instr->Outputs()) {
+      size_t bytes = 0;
+      auto type = item.first.type()
+                      .dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+      bool is_static = type && !common::contain_unknown_dim(type.dims()) &&
+                       type.place() == place_;
+      if (is_static) {
+        bytes = common::product(type.dims()) *
+                phi::SizeOf(paddle::dialect::TransToPhiDataType(type.dtype()));
+      }
+      for (auto var_id : item.second) {
+        dynamic[var_id] = dynamic[var_id] || !is_static;
+        sizes[var_id] = std::max(sizes[var_id], bytes);
+        begins[var_id] = std::min(begins[var_id], pos);
+        ++accesses[var_id];
+      }
+    }
+    for (auto& item : instr->Inputs()) {
+      for (auto var_id : item.second) {
+        first_uses[var_id] = std::min(first_uses[var_id], pos);
+        ++accesses[var_id];
+      }
+    }
+  }
+
+  std::unordered_set<std::string> skip_names(fetch_var_names_.begin(),
+                                             fetch_var_names_.end());
+  skip_names.insert(JitInputVars().begin(), JitInputVars().end());
+  memory_plan_var_ids_.clear();
+  memory_plan_blocks_.clear();
+  // only the vars gc frees after their last use, their lifetime is known
+  for (auto& item : last_live_ops_) {
+    size_t var_id = item.first;
+    const std::string& name =
+        value_exe_info_->GetNameById(static_cast<int>(var_id));
+    if (item.second.empty() || dynamic[var_id] || multi_stream[var_id] ||
+        sizes[var_id] == 0 || begins[var_id] == kUnknown ||
+        first_uses[var_id] <= begins[var_id] ||
+        !var_list[var_id]->IsType<phi::DenseTensor>() ||
+        parameter_var_names_.count(name) || skip_names.count(name)) {
+      continue;
+    }
+    interpreter::MemoryBlock block;
+    block.size = sizes[var_id];
+    block.begin = begins[var_id];
+    block.end = block.begin;
+    block.accesses = accesses[var_id];
+    for (auto instr_id : item.second) {
+      block.end = std::max(block.end, positions[instr_id]);
+    }
+    memory_plan_var_ids_.push_back(var_id);
+    memory_plan_blocks_.push_back(block);
+  }
+  VLOG(1) << "Static memory plan of " << memory_plan_var_ids_.size() << " in "
+          << var_list.size() << " vars";
+}
+
+void PirInterpreter::AssignStaticMemoryPlan(bool reuse) {
+  constexpr size_t kAlignment = 256;
+  // the blocks placed in the xpu l3 arena keep their offsets there
+  std::vector<bool> in_l3(memory_plan_blocks_.size(), false);
+#ifdef PADDLE_WITH_XPU
+  if (reuse) {
+    PlanXPUL3Cache(kAlignment, &in_l3);
+  }
+#endif
+  std::vector<interpreter::MemoryBlock> blocks;
+  for (size_t i = 0; i < memory_plan_blocks_.size(); ++i) {
+    if (!in_l3[i]) {
+      blocks.push_back(memory_plan_blocks_[i]);
+    }
+  }
+  size_t arena_size =
+      reuse ? interpreter::PlanMemoryBlocks(&blocks, kAlignment)
+            : interpreter::PlanMemoryBlocksWithoutReuse(&blocks, kAlignment);
+  for (size_t i = 0, j = 0; i < memory_plan_blocks_.size(); ++i) {
+    if (!in_l3[i]) {
+      memory_plan_blocks_[i].offset = blocks[j++].offset;
+    }
+  }
+  ResetStaticMemoryPlan();
+  memory_plan_arena_ = memory::AllocShared(place_, arena_size);
+  const auto& var_list = value_exe_info_->GetVarList();
+  memory_planned_vars_.assign(var_list.size(), false);
+  memory_plan_holders_.clear();
+  for (size_t i = 0; i < memory_plan_var_ids_.size(); ++i) {
+    auto& block = memory_plan_blocks_[i];
+    memory_plan_holders_.emplace_back(
+        std::make_shared<interpreter::MemoryBlockAllocation>(
+            in_l3[i] ? memory_plan_l3_arena_ : memory_plan_arena_,
+            block.offset,
+            block.size));
+    auto* tensor =
+        var_list[memory_plan_var_ids_[i]]->GetMutable<phi::DenseTensor>();
+    tensor->clear();
+    tensor->ResetHolder(memory_plan_holders_.back());
+    memory_plan_holder_set_.insert(memory_plan_holders_.back().get());
+    memory_planned_vars_[memory_plan_var_ids_[i]] = true;
+  }
+  VLOG(1) << "Static memory plan arena " << arena_size << " bytes"
+          << (reuse ? "" : " without reuse");
+}
+
+#ifdef PADDLE_WITH_XPU
+void PirInterpreter::PlanXPUL3Cache(size_t alignment,
+                                    std::vector<bool>* in_l3) {
+  memory_plan_l3_accesses_ = 0;
+  memory_plan_global_accesses_ = 0;
+  for (auto& block : memory_plan_blocks_) {
+    memory_plan_global_accesses_ += block.accesses;
+  }
+  if (FLAGS_new_executor_xpu_l3_plan_size <= 0 ||
+      !platform::is_xpu_place(place_)) {
+    return;
+  }
+  size_t l3_size = static_cast<size_t>(FLAGS_new_executor_xpu_l3_plan_size);
+  if (memory_plan_l3_arena_ == nullptr ||
+      memory_plan_l3_arena_->size() != l3_size) {
+    // the old arena is released when no var holds a slice of it any more
+    memory_plan_l3_arena_.reset();
+    phi::backends::xpu::XPUDeviceGuard guard(place_.GetDeviceId());
+    void* l3_ptr = nullptr;
+    int ret = xpu_malloc(&l3_ptr, l3_size, XPU_MEM_L3);
+    if (ret != XPU_SUCCESS || l3_ptr == nullptr) {
+      LOG(WARNING) << "Failed to reserve " << l3_size
+                   << " bytes of XPU L3 for the static memory plan, all the "
+                      "planned vars stay in global memory";
+      return;
+    }
+    memory_plan_l3_arena_ = std::make_shared<phi::Allocation>(
+        l3_ptr,
+        l3_size,
+        [](phi::Allocation* allocation) {
+          phi::backends::xpu::XPUDeviceGuard guard(
+              allocation->place().GetDeviceId());
+          xpu_free(allocation->ptr());
+        },
+        place_);
+  }
+
+  std::vector<phi::XPUL3LiveBlock> live_blocks(memory_plan_blocks_.size());
+  for (size_t i = 0; i < memory_plan_blocks_.size(); ++i) {
+    live_blocks[i].size = memory_plan_blocks_[i].size;
+    live_blocks[i].begin = memory_plan_blocks_[i].begin;
+    live_blocks[i].end = memory_plan_blocks_[i].end;
+    live_blocks[i].accesses = memory_plan_blocks_[i].accesses;
+  }
+  size_t used =
+      phi::XPUL3Planner::RunLivenessAutotune(&live_blocks, l3_size, alignment);
+  size_t num = 0;
+  for (size_t i = 0; i < live_blocks.size(); ++i) {
+    if (live_blocks[i].in_l3) {
+      (*in_l3)[i] = true;
+      memory_plan_blocks_[i].offset = live_blocks[i].offset;
+      memory_plan_l3_accesses_ += live_blocks[i].accesses;
+      memory_plan_global_accesses_ -= live_blocks[i].accesses;
+      ++num;
+    }
+  }
+  static auto* l3_bytes = phi::MetricsRegistry::Instance().GetGauge(
+      "paddle_executor_xpu_l3_plan_bytes",
+      "Bytes of XPU L3 taken by the last static memory plan.");
+  l3_bytes->Set(static_cast<double>(used));
+  VLOG(1) << "Static memory plan places " << num << " of "
+          << memory_plan_blocks_.size() << " vars in " << used << " of "
+          << l3_size << " bytes of XPU L3";
+}
+#endif
+
+void PirInterpreter::FinishStaticMemoryPlan() {
+  const auto& var_list = value_exe_info_->GetVarList();
+  std::unordered_map<const phi::Allocation*, size_t> holder2idx;
+  for (size_t i = 0; i < memory_plan_holders_.size(); ++i) {
+    holder2idx[memory_plan_holders_[i].get()] = i;
+  }
+  std::vector<bool> broken(memory_plan_var_ids_.size(), false);
+  bool any_broken = false;
+  for (size_t var_id = 0; var_id < var_list.size(); ++var_id) {
+    auto* var = var_list[var_id];
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      continue;
+    }
+    auto holder = var->Get<phi::DenseTensor>().Holder();
+    auto it = holder2idx.find(holder.get());
+    bool own = it != holder2idx.end() &&
+               memory_plan_var_ids_[it->second] == var_id;
+    if (memory_planned_vars_[var_id] && !own) {
+      // reallocated, or aliased to another var by the kernel
+      auto self = std::find(memory_plan_var_ids_.begin(),
+                            memory_plan_var_ids_.end(),
+                            var_id);
+      broken[self - memory_plan_var_ids_.begin()] = true;
+      any_broken = true;
+    }
+    if (it != holder2idx.end() && !own) {
+      broken[it->second] = true;
+      any_broken = true;
+    }
+  }
+
+  if (memory_plan_state_ == kMemoryPlanDone) {
+    if (any_broken) {
+      LOG(WARNING) << "Static memory plan is disabled, a planned var changed "
+                      "its holder while running";
+      ResetStaticMemoryPlan();
+      memory_plan_state_ = kMemoryPlanOff;
+      return;
+    }
+#ifdef PADDLE_WITH_XPU
+    static auto* l3_accesses = phi::MetricsRegistry::Instance().GetCounter(
+        "paddle_executor_xpu_l3_tensor_accesses_total",
+        "Number of the accesses of the planned vars by the instructions.",
+        "memory=\"l3\"");
+    static auto* global_accesses = phi::MetricsRegistry::Instance().GetCounter(
+        "paddle_executor_xpu_l3_tensor_accesses_total",
+        "Number of the accesses of the planned vars by the instructions.",
+        "memory=\"global\"");
+    l3_accesses->Increase(static_cast<int64_t>(memory_plan_l3_accesses_));
+    global_accesses->Increase(
+        static_cast<int64_t>(memory_plan_global_accesses_));
+#endif
+    return;
+  }
+
+  size_t num = 0;
+  for (size_t i = 0; i < memory_plan_var_ids_.size(); ++i) {
+    if (!broken[i]) {
+      memory_plan_var_ids_[num] = memory_plan_var_ids_[i];
+      memory_plan_blocks_[num] = memory_plan_blocks_[i];
+      ++num;
+    }
+  }
+  VLOG(1) << "Static memory plan drops "
+          << memory_plan_var_ids_.size() - num << " vars after checking";
+  memory_plan_var_ids_.resize(num);
+  memory_plan_blocks_.resize(num);
+  if (num == 0) {
+    ResetStaticMemoryPlan();
+    memory_plan_state_ = kMemoryPlanOff;
+    return;
+  }
+  AssignStaticMemoryPlan(true);
+  memory_plan_state_ = kMemoryPlanDone;
+}
+
+void PirInterpreter::ResetStaticMemoryPlan() {
+  if (memory_plan_arena_ == nullptr) {
+    return;
+  }
+  // no var may keep a slice of the arena, planned or not
+  for (auto* var : value_exe_info_->GetVarList()) {
+    if (var != nullptr && HoldsStaticMemoryBlock(var)) {
+      var->GetMutable<phi::DenseTensor>()->clear();
+    }
+  }
+  memory_planned_vars_.clear();
+  memory_plan_holders_.clear();
+  memory_plan_holder_set_.clear();
+  memory_plan_arena_.reset();
+}
+
+bool PirInterpreter::HoldsStaticMemoryBlock(const Variable* var) const {
+  return var->IsType<phi::DenseTensor>() &&
+         memory_plan_holder_set_.count(
+             var->Get<phi::DenseTensor>().Holder().get());
+}
+
 void PirInterpreter::ClearLoDTensorArrayInLocalScope() {
   auto vars = local_scope_->LocalVars();
   for (auto var : vars) {
@@ -699,6 +1256,11 @@ void PirInterpreter::AnalyseExecuteOrderForTrace(
 
 void PirInterpreter::BuildInstruction() {
   VLOG(6) << "Build Instructions for pir ... ";
+  // once, the streams assigned become the ops' execution_stream
+  if (FLAGS_new_executor_auto_stream_num > 1 && auto_stream_op_nums_.empty()) {
+    auto_stream_op_nums_ = interpreter::AssignAutoStreams(
+        *ir_block_, place_, FLAGS_new_executor_auto_stream_num);
+  }
   vec_instruction_base_.clear();
   size_t op_idx = 0;
   for (auto& op : *ir_block_) {
@@ -1151,10 +1713,19 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
   RecordStreamForGC(instr);
 #endif
 
+  // the step checking the static memory plan keeps the vars holding a slice
+  // of the arena, to find the ones aliased to a planned var
+  bool checking = memory_plan_state_ == kMemoryPlanChecking;
   for (auto var_id : instr->GCCheckVars()) {
     VLOG(4) << "GC:" << value_exe_info_->GetNameById(static_cast<int>(var_id))
             << ", id:" << var_id << ", ref:" << refs_[var_id]->DynamicRef();
     bool is_ready = refs_[var_id]->CheckAndDecrease();
+    if (!memory_planned_vars_.empty() && memory_planned_vars_[var_id]) {
+      continue;
+    }
+    if (UNLIKELY(checking) && HoldsStaticMemoryBlock(refs_[var_id]->Var())) {
+      continue;
+    }
     // ignore all persistable var while GCphi
     if (parameter_var_names_.count(
             value_exe_info_->GetNameById(static_cast<int>(var_id)))) {
@@ -1171,9 +1742,13 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
   }
 
   for (auto var : instr->EagerGCVars()) {
+    if (UNLIKELY(checking) && HoldsStaticMemoryBlock(var)) {
+      continue;
+    }
     gc_->Add(var, instr);
   }
   instr->ClearEagerGCVars();
+  gc_->FinishInstruction(instr);
 }
 
 void PirInterpreter::CalculateLastLiveOps() {
@@ -1385,16 +1960,28 @@ paddle::framework::FetchList PirInterpreter::Run(
     if (switch_stream) {
       BuildInstruction();
       VLOG(4) << "Done BuildInstruction";
+      auto_cuda_graphs_.clear();
+      auto_cuda_graph_capturable_ = -1;
+      ResetStaticMemoryPlan();
+      memory_plan_state_ = kMemoryPlanUnknown;
     }
 #endif
-    if (FLAGS_enable_pir_in_executor_trace_run || onednn_op_num_ ||
-        execution_config_.used_for_inference ||
-        ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
-         (sync_op_num_ == 0))) {
+    bool use_memory_plan = PrepareStaticMemoryPlan();
+    if (memory_plan_state_ != kMemoryPlanChecking &&
+        RunByAutoCUDAGraph(feed_names)) {
+      VLOG(4) << "Done RunByAutoCUDAGraph";
+    } else if (use_memory_plan || FLAGS_enable_pir_in_executor_trace_run ||
+               onednn_op_num_ || execution_config_.used_for_inference ||
+               ((execution_config_.used_for_jit ||
+                 execution_config_.used_for_cinn) &&
+                (sync_op_num_ == 0))) {
       TraceRunImpl();
     } else {
       MultiThreadRunImpl();
     }
+    if (use_memory_plan) {
+      FinishStaticMemoryPlan();
+    }
   }
 
   if (HasLocalScope()) {
@@ -1476,16 +2063,28 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
     if (switch_stream) {
       BuildInstruction();
       VLOG(4) << "Done BuildInstruction";
+      auto_cuda_graphs_.clear();
+      auto_cuda_graph_capturable_ = -1;
+      ResetStaticMemoryPlan();
+      memory_plan_state_ = kMemoryPlanUnknown;
     }
 #endif
-    if (FLAGS_enable_pir_in_executor_trace_run || onednn_op_num_ ||
-        execution_config_.used_for_inference ||
-        ((execution_config_.used_for_jit || execution_config_.used_for_cinn) &&
-         (sync_op_num_ == 0))) {
+    bool use_memory_plan = PrepareStaticMemoryPlan();
+    if (memory_plan_state_ != kMemoryPlanChecking &&
+        RunByAutoCUDAGraph(feed_names)) {
+      VLOG(4) << "Done RunByAutoCUDAGraph";
+    } else if (use_memory_plan || FLAGS_enable_pir_in_executor_trace_run ||
+               onednn_op_num_ || execution_config_.used_for_inference ||
+               ((execution_config_.used_for_jit ||
+                 execution_config_.used_for_cinn) &&
+                (sync_op_num_ == 0))) {
       TraceRunImpl();
     } else {
       MultiThreadRunImpl();
     }
+    if (use_memory_plan) {
+      FinishStaticMemoryPlan();
+    }
   }
 
   if (HasLocalScope()) {
@@ -1519,6 +2118,7 @@ void PirInterpreter::TraceRunImpl() {
 
   TraceRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done TraceRunInstructionList";
+  gc_->Flush();
 }
 
 void PirInterpreter::MultiThreadRunImpl() {
@@ -1533,6 +2133,7 @@ void PirInterpreter::MultiThreadRunImpl() {
   async_work_queue_ = GetWorkQueue();
   MultiThreadRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done MultiThreadRunInstructionList";
+  gc_->Flush();
 }
 
 void PirInterpreter::TraceRunInstructionList(
@@ -1732,12 +2333,33 @@ void PirInterpreter::RunNextInstructions(InstructionBase* instr,
     return deps_[next_id]->CheckAndDecrease();
   };
 
-  for (size_t next_instr_id : instr->NextInstrsInDifferenceThread()) {
-    if (IsReady(next_instr_id)) {
+  if (!critical_path_costs_.empty()) {
+    // the other thread pools pop their queues in order, so the op with
+    // the longest path to the fetch ops goes first
+    std::vector<size_t> ready_ops;
+    for (size_t next_instr_id : instr->NextInstrsInDifferenceThread()) {
+      if (IsReady(next_instr_id)) {
+        ready_ops.push_back(next_instr_id);
+      }
+    }
+    std::sort(ready_ops.begin(), ready_ops.end(), [this](size_t a, size_t b) {
+      return ir_instruction_scheduling_priority_less(b, a);
+    });
+    for (size_t next_instr_id : ready_ops) {
       async_work_queue_->AddTask(
           vec_instruction_base_[next_instr_id]->KernelType(),
           [this, next_instr_id]() { RunInstructionBaseAsync(next_instr_id); });
     }
+  } else {
+    for (size_t next_instr_id : instr->NextInstrsInDifferenceThread()) {
+      if (IsReady(next_instr_id)) {
+        async_work_queue_->AddTask(
+            vec_instruction_base_[next_instr_id]->KernelType(),
+            [this, next_instr_id]() {
+              RunInstructionBaseAsync(next_instr_id);
+            });
+      }
+    }
   }
 
   for (size_t next_instr_id : instr->NextInstrsInSameThread()) {
@@ -1750,6 +2372,8 @@ void PirInterpreter::RunNextInstructions(InstructionBase* instr,
 void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
   platform::RecordEvent instruction_event(
       instr_node->Name(), platform::TracerEventType::Operator, 1);
+  memory::allocation::AllocationTracer::OpGuard trace_guard(
+      instr_node->Name());
 
   auto cur_place = instr_node->DeviceContext().GetPlace();
   SetDeviceId(cur_place);
@@ -1860,6 +2484,21 @@ void PirInterpreter::PreAnalysis() {
   ir_stream_analyzer_.ConstructEvents(vec_instruction_base_);
   VLOG(4) << "Done ConstructEvents";
 
+  if (auto_stream_op_nums_.size() > 1) {
+    std::stringstream ss;
+    for (size_t i = 0; i < auto_stream_op_nums_.size(); ++i) {
+      ss << " stream " << i << ": " << auto_stream_op_nums_[i] << " ops";
+    }
+    size_t event_num = 0;
+    for (auto& context_item : *ir_stream_analyzer_.GetEventInfo()) {
+      for (auto& waiter_item : context_item.second) {
+        event_num += waiter_item.second.size();
+      }
+    }
+    LOG_FIRST_N(INFO, 1) << "pir interpreter auto streams," << ss.str()
+                         << ", " << event_num << " cross stream events";
+  }
+
   // add event for the input var of jit program, since there are async copied
   // from gpu_pinned place to gpu place on compute stream.
   ConstructEventForJitInput();
@@ -1875,6 +2514,13 @@ void PirInterpreter::PreAnalysis() {
     }
   }
 
+  critical_path_costs_.clear();
+  if (FLAGS_new_executor_critical_path_schedule) {
+    critical_path_costs_ = ir_dependency_builder_.CriticalPathCost(
+        std::vector<int64_t>(vec_instruction_base_.size(), 1));
+    VLOG(4) << "Done CriticalPathCost";
+  }
+
   AnalyseExecuteOrderForTrace(ir_dependency_builder_.OpDownstreamMap(),
                               ir_instruction_scheduling_priority_less);
   VLOG(4) << "Done AnalyseExecuteOrderForTrace";
@@ -15,10 +15,12 @@
 #pragma once
 #include <memory>
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/interpreter/memory_planner.h"
 #include "paddle/fluid/framework/new_executor/interpreter_base_impl.h"
 #include "paddle/pir/include/core/value.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/cuda_graph_with_memory_pool.h"
 #include "paddle/phi/kernels/autotune/gpu_timer.h"
 #endif
 
@@ -138,9 +140,26 @@ class PirInterpreter : public InterpreterBaseImpl {
   // gc
   void ClearLoDTensorArrayInLocalScope();
 
+  // FLAGS_new_executor_static_memory_plan, returns true if the step has to
+  // run in trace order with the planned holders
+  bool PrepareStaticMemoryPlan();
+  void FinishStaticMemoryPlan();
+  void CollectStaticMemoryBlocks();
+  void AssignStaticMemoryPlan(bool reuse);
+  void ResetStaticMemoryPlan();
+  bool HoldsStaticMemoryBlock(const Variable* var) const;
+#ifdef PADDLE_WITH_XPU
+  // FLAGS_new_executor_xpu_l3_plan_size, marks the blocks placed in l3
+  void PlanXPUL3Cache(size_t alignment, std::vector<bool>* in_l3);
+#endif
+
   // cuda graph
   void CheckCUDAGraphBeforeRun(const std::vector<std::string>& feed_names);
   void PrepareForCUDAGraphCapture();
+  // FLAGS_new_executor_auto_cuda_graph, returns false if the step has to run
+  // eagerly
+  bool RunByAutoCUDAGraph(const std::vector<std::string>& feed_names);
+  bool IsAutoCUDAGraphCapturable();
 
   void Build(const std::vector<std::string>& feed_names,
              std::vector<paddle::framework::OpFuncNode>* op_func_nodes,
@@ -198,12 +217,43 @@ class PirInterpreter : public InterpreterBaseImpl {
   std::vector<std::shared_ptr<interpreter::OpDepInfo>> deps_;
   std::vector<std::shared_ptr<interpreter::VarRefInfo>> refs_;
 
+  // static memory plan, the planned vars keep their slice of the arena and
+  // are skipped by gc. The first step after planning runs without any reuse
+  // and keeps the vars holding a slice, to find the vars that kernels alias
+  // or reallocate. The vars touched off the default stream are not planned.
+  enum MemoryPlanState {
+    kMemoryPlanUnknown,
+    kMemoryPlanChecking,
+    kMemoryPlanDone,
+    kMemoryPlanOff,
+  };
+  MemoryPlanState memory_plan_state_{kMemoryPlanUnknown};
+  std::vector<size_t> memory_plan_var_ids_;
+  std::vector<interpreter::MemoryBlock> memory_plan_blocks_;
+  // indexed by var id
+  std::vector<bool> memory_planned_vars_;
+  std::shared_ptr<phi::Allocation> memory_plan_arena_;
+  std::vector<std::shared_ptr<phi::Allocation>> memory_plan_holders_;
+  std::unordered_set<const phi::Allocation*> memory_plan_holder_set_;
+  // the xpu l3 arena outlives the replans, the accesses of the planned vars
+  // per step are split by where they are placed
+  std::shared_ptr<phi::Allocation> memory_plan_l3_arena_;
+  size_t memory_plan_l3_accesses_{0};
+  size_t memory_plan_global_accesses_{0};
+
   // used for Trace
   int64_t sync_op_num_{-1};
   int64_t nccl_op_num_{-1};
   int64_t onednn_op_num_{-1};
   std::vector<size_t> trace_execute_order_;
 
+  // FLAGS_new_executor_critical_path_schedule, the cost of the longest path
+  // from each instruction to the end of the program
+  std::vector<int64_t> critical_path_costs_;
+
+  // FLAGS_new_executor_auto_stream_num, the number of ops on each stream
+  std::vector<size_t> auto_stream_op_nums_;
+
   std::vector<PirHookFunc> pir_output_hookfuncs_;
   std::vector<PirHookFunc> pir_input_hookfuncs_;
 
@@ -280,6 +330,29 @@ class PirInterpreter : public InterpreterBaseImpl {
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   std::unique_ptr<phi::CalculateStreamTimer> calculate_stream_timer_;
+
+  // one captured step per feed shape of FLAGS_new_executor_auto_cuda_graph
+  struct AutoCUDAGraph {
+    // declared first to be destroyed after the tensors of its memory pool
+    std::unique_ptr<platform::CUDAGraph> graph;
+    int64_t run_num = 0;
+    bool disabled = false;
+    // the graph reads the feeds from here, they are copied in every step
+    std::vector<phi::DenseTensor> feeds;
+    // inputs of the fetch ops, which run eagerly after each replay
+    std::vector<std::pair<Variable*, phi::DenseTensor>> fetch_inputs;
+    // addresses of the parameters when captured
+    std::vector<std::pair<Variable*, const void*>> params;
+  };
+  void CaptureAutoCUDAGraph(AutoCUDAGraph* bucket);
+  void RunAutoCUDAGraphTail(AutoCUDAGraph* bucket);
+
+  std::unordered_map<std::string, std::unique_ptr<AutoCUDAGraph>>
+      auto_cuda_graphs_;
+  // -1 not analysed yet, 0 some instruction can not be captured
+  int auto_cuda_graph_capturable_{-1};
+  // the fetch ops, run after the replay in trace order
+  std::vector<size_t> auto_cuda_graph_tail_;
 #endif
   size_t last_calculate_instr_id_;
   bool enable_job_schedule_profiler_;
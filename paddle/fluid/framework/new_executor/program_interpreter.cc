@@ -20,6 +20,7 @@
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
 #include "paddle/fluid/framework/new_executor/interpreter/static_build.h"
 #include "paddle/fluid/framework/operator.h"
+#include "paddle/fluid/memory/allocation/allocation_tracer.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/os_info.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
@@ -176,6 +177,11 @@ FetchList ProgramInterpreter::Run(const std::vector<std::string>& feed_names,
     ClearLoDTensorArrayInLocalScope();
   }
 
+  // the deferred nan/inf checks of this run are copied back at once
+  if (FLAGS_check_nan_inf) {
+    framework::details::CheckDeferredNanInf();
+  }
+
   // NOTE (liuchenghao): we need to reset "is_in_op_profiling_mode_" to false.
   // This is because ProgramInterpreter::Run(...) has two implementations, only
   // this implementation correctly updates its state, if user switches to
@@ -262,6 +268,11 @@ FetchList ProgramInterpreter::Run(
     ClearLoDTensorArrayInLocalScope();
   }
 
+  // the deferred nan/inf checks of this run are copied back at once
+  if (FLAGS_check_nan_inf) {
+    framework::details::CheckDeferredNanInf();
+  }
+
   if (need_fetch) {
     // return Fetch Tensors
     Scope* inner_scope =
@@ -822,6 +833,66 @@ void ProgramInterpreter::Convert(
     }
   }
 
+  // The data transfer ops of the persistable vars which no other op writes
+  // may be skipped while the vars are unchanged, so their outputs are kept.
+  std::set<int> written_vars;
+  for (const Instruction& instr : vec_instruction_) {
+    if (!instr.OpFunc()->transfer_for_op_.empty()) {
+      continue;
+    }
+    for (auto& item : instr.Outputs()) {
+      written_vars.insert(item.second.begin(), item.second.end());
+    }
+  }
+  data_transfer_stats_.clear();
+  data_transfer_stats_.resize(op_nums);
+  for (size_t op_idx = 0; op_idx < op_nums; ++op_idx) {
+    const Instruction& instr = vec_instruction_[op_idx];
+    const OpFuncNode* op_func = instr.OpFunc();
+    if (op_func->transfer_for_op_.empty()) {
+      continue;
+    }
+    auto stat = std::make_unique<interpreter::DataTransferStat>();
+    std::string labels = "op=\"" + op_func->transfer_for_op_ +
+                         "\",transfer=\"" + instr.OpBase()->Type() + "\"";
+    auto& registry = phi::MetricsRegistry::Instance();
+    stat->runs = registry.GetCounter(
+        "paddle_executor_data_transfer_total",
+        "Number of the runs of the data transfer ops of the new executor.",
+        labels);
+    stat->cache_hits = registry.GetCounter(
+        "paddle_executor_data_transfer_cache_hits_total",
+        "Number of the data transfer ops skipped since the persistable vars "
+        "they transfer are unchanged.",
+        labels);
+    // only the inference programs, whose weights are not written out of the
+    // program in place between the runs, e.g. by tensor.set
+    stat->cacheable = FLAGS_new_executor_cache_data_transfer &&
+                      execution_config_.used_for_inference &&
+                      op_func->transfer_src_var_id_ != -1 &&
+                      written_vars.count(op_func->transfer_src_var_id_) == 0;
+    // and their outputs must not be written in place by the consumer ops
+    for (auto& item : instr.Outputs()) {
+      for (int var_id : item.second) {
+        if (written_vars.count(var_id) != 0) {
+          stat->cacheable = false;
+        }
+      }
+    }
+    if (stat->cacheable) {
+      for (auto& item : instr.Outputs()) {
+        for (int var_id : item.second) {
+          last_live_ops_[var_id].clear();
+          var_scope_.SetVarSkipInplace(var_scope_.GetNameById(var_id), true);
+        }
+      }
+      VLOG(4) << "Cache the data transfer of persistable var "
+              << var_scope_.GetNameById(op_func->transfer_src_var_id_)
+              << " by " << instr.OpBase()->Type();
+    }
+    data_transfer_stats_[op_idx] = std::move(stat);
+  }
+
   // shrink, find the downstream op that has no other op in the
   // downstream list happens before it
   // For example,
@@ -1139,6 +1210,28 @@ void ProgramInterpreter::RunOperator(const Instruction& instr_node) {
   }
 }
 
+bool ProgramInterpreter::SkipDataTransfer(const Instruction& instr_node) {
+  if (instr_node.Id() >= data_transfer_stats_.size() ||
+      data_transfer_stats_[instr_node.Id()] == nullptr) {
+    return false;
+  }
+  auto* stat = data_transfer_stats_[instr_node.Id()].get();
+  if (stat->cacheable) {
+    int src_var_id = instr_node.OpFunc()->transfer_src_var_id_;
+    auto* src_var = var_scope_.VarRef(src_var_id);
+    if (src_var->IsType<phi::DenseTensor>() &&
+        interpreter::CheckDataTransferCache(
+            src_var->GetMutable<phi::DenseTensor>(), stat)) {
+      VLOG(5) << "Skip " << instr_node.OpBase()->Type()
+              << " of unchanged var " << var_scope_.GetNameById(src_var_id);
+      stat->cache_hits->Increase();
+      return true;
+    }
+  }
+  stat->runs->Increase();
+  return false;
+}
+
 void ProgramInterpreter::RunInstruction(const Instruction& instr_node) {
   VLOG(5) << __func__ << " OP id:" << instr_node.Id()
           << " name:" << instr_node.OpBase()->Type() << " type:"
@@ -1152,6 +1245,7 @@ void ProgramInterpreter::RunInstruction(const Instruction& instr_node) {
   auto* op = instr_node.OpBase();
   platform::RecordEvent instruction_event(
       op->Type(), platform::TracerEventType::Operator, 1);
+  memory::allocation::AllocationTracer::OpGuard trace_guard(op->Type());
 
   SetDeviceId(instr_node.DeviceContext().GetPlace());
 
@@ -1168,7 +1262,9 @@ void ProgramInterpreter::RunInstruction(const Instruction& instr_node) {
 #endif
 
     if (!instr_node.IsArtificial()) {
-      RunOperator(instr_node);
+      if (!SkipDataTransfer(instr_node)) {
+        RunOperator(instr_node);
+      }
       CheckGC(instr_node);
       if (FLAGS_log_memory_stats) {
         memory::LogDeviceMemoryStats(place_, instr_node.OpBase()->Type());
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "paddle/fluid/framework/new_executor/interpreter/data_transfer.h"
 #include "paddle/fluid/framework/new_executor/interpreter_base_impl.h"
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -150,6 +151,8 @@ class ProgramInterpreter : public InterpreterBaseImpl {
   void RunNextInstructions(const Instruction& instr_id,
                            SchedulingQueue* reserved_next_ops);
   void RunOperator(const Instruction& instr_node);
+  // Returns true if the instruction is a data transfer op that need not run
+  bool SkipDataTransfer(const Instruction& instr_node);
   // Trace
   void TraceInstructionList(const std::vector<Instruction>& vec_instr);
 
@@ -225,6 +228,11 @@ class ProgramInterpreter : public InterpreterBaseImpl {
   // var
   std::map<size_t, std::set<size_t>> last_live_ops_;
 
+  // data_transfer_stats_[i] is the state of the i-th instruction if it is a
+  // data transfer op, otherwise nullptr
+  std::vector<std::unique_ptr<interpreter::DataTransferStat>>
+      data_transfer_stats_;
+
   // (*dependency_count_)[i] contains the number of dependencies that the i-th
   // op need to wait
   std::shared_ptr<std::vector<size_t>> dependency_count_;
@@ -9,7 +9,14 @@
 
 #pragma once
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <vector>
 
@@ -29,14 +36,30 @@ class ThreadPoolTempl {
   typedef typename Environment::Task Task;
   typedef RunQueue<Task, 1024> Queue;
 
+  struct Stats {
+    // the wakeups of the blocked worker threads by the new tasks, and the
+    // time from the notification to the wakeup
+    uint64_t wakeups{0};
+    uint64_t total_wakeup_latency_ns{0};
+    uint64_t max_wakeup_latency_ns{0};
+    // the spins of the worker threads out of work, which find a task before
+    // blocking or not
+    uint64_t spin_hits{0};
+    uint64_t spin_misses{0};
+  };
+
   ThreadPoolTempl(const std::string& name,
                   int num_threads,
                   bool allow_spinning,
                   bool always_spinning,
+                  bool adaptive_spinning = false,
+                  const std::vector<int>& cpu_affinity = {},
                   Environment env = Environment())
       : env_(env),
         allow_spinning_(allow_spinning),
         always_spinning_(always_spinning),
+        adaptive_spinning_(allow_spinning && adaptive_spinning),
+        cpu_affinity_(cpu_affinity),
         global_steal_partition_(EncodePartition(0, num_threads)),
         blocked_(0),
         done_(false),
@@ -106,6 +129,11 @@ class ThreadPoolTempl {
   }
 
   void AddTaskWithHint(std::function<void()> fn, int start, int limit) {
+    uint64_t now_ns = 0;
+    if (adaptive_spinning_) {
+      now_ns = NowNs();
+      UpdateArrivalInterval(now_ns);
+    }
     Task t = env_.CreateTask(std::move(fn));
     PerThread* pt = GetPerThread();
     if (pt->pool == this) {
@@ -134,6 +162,10 @@ class ThreadPoolTempl {
     if (!t.f) {
       // Allow 'false positive' which makes a redundant notification.
       VLOG(6) << "Add task, Notify";
+      if (blocked_.load(std::memory_order_relaxed) > 0) {
+        last_notify_ns_.store(now_ns != 0 ? now_ns : NowNs(),
+                              std::memory_order_relaxed);
+      }
       ec_.Notify(false);
     } else {
       env_.ExecuteTask(t);  // Push failed, execute directly.
@@ -156,6 +188,18 @@ class ThreadPoolTempl {
 
   size_t NumThreads() const { return num_threads_; }
 
+  Stats GetStats() const {
+    Stats stats;
+    stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+    stats.total_wakeup_latency_ns =
+        total_wakeup_latency_ns_.load(std::memory_order_relaxed);
+    stats.max_wakeup_latency_ns =
+        max_wakeup_latency_ns_.load(std::memory_order_relaxed);
+    stats.spin_hits = spin_hits_.load(std::memory_order_relaxed);
+    stats.spin_misses = spin_misses_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
   int CurrentThreadId() const {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
     if (pt->pool == this) {
@@ -175,6 +219,9 @@ class ThreadPoolTempl {
   // scheduling and steal domain(s).
   static const int kMaxPartitionBits = 16;
   static const int kMaxThreads = 1 << kMaxPartitionBits;
+  // An adaptive spin is never longer than this, since blocking costs about as
+  // much as a wakeup then.
+  static constexpr uint64_t kMaxAdaptiveSpinNs = 50000;
 
   inline unsigned EncodePartition(unsigned start, unsigned limit) {
     return (start << kMaxPartitionBits) | limit;
@@ -235,6 +282,8 @@ class ThreadPoolTempl {
   Environment env_;
   const bool allow_spinning_;
   const bool always_spinning_;
+  const bool adaptive_spinning_;
+  const std::vector<int> cpu_affinity_;
   std::vector<std::vector<unsigned>> all_coprimes_;
   unsigned global_steal_partition_;
   std::atomic<unsigned> blocked_;
@@ -245,11 +294,108 @@ class ThreadPoolTempl {
   std::vector<ThreadData> thread_data_;
   std::string name_;
 
+  // the arrival time of the latest task and the moving average of the
+  // intervals between the tasks, updated racily by the adding threads
+  std::atomic<uint64_t> last_arrival_ns_{0};
+  std::atomic<uint64_t> arrival_interval_ns_{0};
+  std::atomic<uint64_t> last_notify_ns_{0};
+  std::atomic<uint64_t> wakeups_{0};
+  std::atomic<uint64_t> total_wakeup_latency_ns_{0};
+  std::atomic<uint64_t> max_wakeup_latency_ns_{0};
+  std::atomic<uint64_t> spin_hits_{0};
+  std::atomic<uint64_t> spin_misses_{0};
+
+  static inline uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void UpdateArrivalInterval(uint64_t now_ns) {
+    uint64_t last_ns =
+        last_arrival_ns_.exchange(now_ns, std::memory_order_relaxed);
+    if (last_ns == 0 || now_ns <= last_ns) {
+      return;
+    }
+    uint64_t interval = now_ns - last_ns;
+    uint64_t average = arrival_interval_ns_.load(std::memory_order_relaxed);
+    // weight the latest interval by 1/8
+    average = average == 0 ? interval : average - average / 8 + interval / 8;
+    arrival_interval_ns_.store(average, std::memory_order_relaxed);
+  }
+
+  // Returns the time a worker thread out of work spins until, 0 not to spin.
+  // It spins for about two intervals between the recent tasks if the tasks
+  // arrive often enough, and blocks at once if they do not.
+  uint64_t AdaptiveSpinDeadline() {
+    uint64_t interval = arrival_interval_ns_.load(std::memory_order_relaxed);
+    if (interval == 0 || interval > kMaxAdaptiveSpinNs) {
+      return 0;
+    }
+    return NowNs() + std::min(2 * interval, kMaxAdaptiveSpinNs);
+  }
+
+  inline bool KeepSpinning(int i, int spin_count, uint64_t spin_deadline) {
+    if (!adaptive_spinning_) {
+      return i < spin_count;
+    }
+    // read the clock once in a few rounds
+    return spin_deadline != 0 && ((i & 15) != 0 || NowNs() < spin_deadline);
+  }
+
+  void RecordSpin(bool hit) {
+    if (hit) {
+      spin_hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      spin_misses_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void RecordWakeup() {
+    // taken by one woken thread, so the wakeups of the shutdown are not
+    // counted against a stale notification
+    uint64_t notify_ns = last_notify_ns_.exchange(0, std::memory_order_relaxed);
+    uint64_t now_ns = NowNs();
+    if (notify_ns == 0 || now_ns <= notify_ns) {
+      return;
+    }
+    uint64_t latency = now_ns - notify_ns;
+    wakeups_.fetch_add(1, std::memory_order_relaxed);
+    total_wakeup_latency_ns_.fetch_add(latency, std::memory_order_relaxed);
+    uint64_t max_latency =
+        max_wakeup_latency_ns_.load(std::memory_order_relaxed);
+    while (latency > max_latency &&
+           !max_wakeup_latency_ns_.compare_exchange_weak(
+               max_latency, latency, std::memory_order_relaxed)) {
+    }
+  }
+
+  void SetCurrentThreadAffinity() {
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : cpu_affinity_) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (ret != 0) {
+      LOG(WARNING) << "Failed to set the cpu affinity of " << name_
+                   << " threads, error " << ret;
+    }
+#else
+    LOG(WARNING) << "The cpu affinity of " << name_
+                 << " threads is only supported on linux";
+#endif
+  }
+
   // Main worker thread loop.
   void WorkerLoop(int thread_id) {
     std::string thr_name = name_ + "_thread_" + std::to_string(thread_id);
     VLOG(1) << thr_name << " started ";
     platform::SetCurrentThreadName(thr_name);
+    if (!cpu_affinity_.empty()) {
+      SetCurrentThreadAffinity();
+    }
     PerThread* pt = GetPerThread();
     pt->pool = this;
     pt->rand = GlobalThreadIdHash();
@@ -271,10 +417,16 @@ class ThreadPoolTempl {
       // pools tend to be used for.
       while (!cancelled_) {
         Task t = q.PopFront();
-        for (int i = 0; i < spin_count && !t.f; i++) {
-          if (!cancelled_.load(std::memory_order_relaxed)) {
-            t = q.PopFront();
+        if (!t.f && allow_spinning_) {
+          uint64_t spin_deadline =
+              adaptive_spinning_ ? AdaptiveSpinDeadline() : 0;
+          for (int i = 0; KeepSpinning(i, spin_count, spin_deadline) && !t.f;
+               i++) {
+            if (!cancelled_.load(std::memory_order_relaxed)) {
+              t = q.PopFront();
+            }
           }
+          RecordSpin(t.f != nullptr);
         }
         if (!t.f) {
           if (!WaitForWork(waiter, &t)) {
@@ -294,13 +446,18 @@ class ThreadPoolTempl {
             t = GlobalSteal();
             if (!t.f) {
               if (allow_spinning_) {
-                for (int i = 0; i < spin_count && !t.f; i++) {
+                uint64_t spin_deadline =
+                    adaptive_spinning_ ? AdaptiveSpinDeadline() : 0;
+                for (int i = 0;
+                     KeepSpinning(i, spin_count, spin_deadline) && !t.f;
+                     i++) {
                   if (!cancelled_.load(std::memory_order_relaxed)) {
                     t = GlobalSteal();
                   } else {
                     return;
                   }
                 }
+                RecordSpin(t.f != nullptr);
               }
               if (!t.f) {
                 if (!WaitForWork(waiter, &t)) {
@@ -425,6 +582,7 @@ class ThreadPoolTempl {
         "WaitForWork", platform::TracerEventType::UserDefined, 10);
     ec_.CommitWait(waiter);
     blocked_--;
+    RecordWakeup();
     return true;
   }
 
@@ -29,6 +29,20 @@ void WorkQueueOptions::Validate() const {
       false,
       platform::errors::InvalidArgument("WorkQueueOptions.allow_spinning must "
                                         "be true when always_spinning is set"));
+  PADDLE_ENFORCE_EQ(
+      adaptive_spinning && (!allow_spinning || always_spinning),
+      false,
+      platform::errors::InvalidArgument(
+          "WorkQueueOptions.adaptive_spinning must be set with allow_spinning "
+          "and without always_spinning"));
+  for (int cpu : cpu_affinity) {
+    PADDLE_ENFORCE_GE(cpu,
+                      0,
+                      platform::errors::InvalidArgument(
+                          "WorkQueueOptions.cpu_affinity must be nonnegative, "
+                          "but got %d",
+                          cpu));
+  }
 }
 
 namespace {
@@ -50,7 +64,9 @@ class WorkQueueImpl : public WorkQueue {
     queue_ = new NonblockingThreadPool(options_.name,
                                        static_cast<int>(options_.num_threads),
                                        options_.allow_spinning,
-                                       options_.always_spinning);
+                                       options_.always_spinning,
+                                       options_.adaptive_spinning,
+                                       options_.cpu_affinity);
   }
 
   ~WorkQueueImpl() override {
@@ -102,6 +118,8 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
 
   size_t QueueGroupNumThreads() const override;
 
+  WorkQueueStats QueueStats(size_t queue_idx) const override;
+
   void Cancel() override;
 
  private:
@@ -143,7 +161,9 @@ WorkQueueGroupImpl::WorkQueueGroupImpl(
         NonblockingThreadPool(options.name,
                               static_cast<int>(options.num_threads),
                               options.allow_spinning,
-                              options.always_spinning);
+                              options.always_spinning,
+                              options.adaptive_spinning,
+                              options.cpu_affinity);
   }
 }
 
@@ -195,6 +215,21 @@ size_t WorkQueueGroupImpl::QueueGroupNumThreads() const {
   return total_num;
 }
 
+WorkQueueStats WorkQueueGroupImpl::QueueStats(size_t queue_idx) const {
+  assert(queue_idx < queues_.size());
+  WorkQueueStats stats;
+  if (!queues_.at(queue_idx)) {
+    return stats;
+  }
+  auto pool_stats = queues_.at(queue_idx)->GetStats();
+  stats.wakeups = pool_stats.wakeups;
+  stats.total_wakeup_latency_ns = pool_stats.total_wakeup_latency_ns;
+  stats.max_wakeup_latency_ns = pool_stats.max_wakeup_latency_ns;
+  stats.spin_hits = pool_stats.spin_hits;
+  stats.spin_misses = pool_stats.spin_misses;
+  return stats;
+}
+
 void WorkQueueGroupImpl::Cancel() {
   for (auto queue : queues_) {
     if (queue) {
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <memory>
@@ -102,6 +103,23 @@ struct WorkQueueOptions {
   // false and set events_waiter.
   bool detached{true};
   EventsWaiter* events_waiter{nullptr};  // not owned
+  // Worker threads spin only while the tasks arrive often enough, and for
+  // about the interval between them, if this flag is set with
+  // allow_spinning. Better for several queues sharing the cores.
+  bool adaptive_spinning{false};
+  // The CPUs worker threads are pinned to, not pinned if empty.
+  std::vector<int> cpu_affinity;
+};
+
+struct WorkQueueStats {
+  // The wakeups of the blocked worker threads by new tasks.
+  uint64_t wakeups{0};
+  uint64_t total_wakeup_latency_ns{0};
+  uint64_t max_wakeup_latency_ns{0};
+  // The spins of the worker threads out of work that find a task before
+  // blocking, and that do not.
+  uint64_t spin_hits{0};
+  uint64_t spin_misses{0};
 };
 
 class WorkQueue {
@@ -178,6 +196,8 @@ class WorkQueueGroup {
 
   virtual size_t QueueGroupNumThreads() const = 0;
 
+  virtual WorkQueueStats QueueStats(size_t queue_idx) const = 0;
+
   virtual void Cancel() = 0;
 
  protected:
@@ -1671,7 +1671,8 @@ bool HasSameTensorType(phi::TensorBase* phi_tensor, Variable* var) {
 void OperatorWithKernel::CheckWhetherPreparePhiData(
     const VariableNameMap& innames,
     const VariableNameMap& outnames,
-    const Scope& scope) const {
+    const Scope& scope,
+    const VariableValueMap* outvars) const {
   if (run_phi_kernel_ && impl_ != nullptr) {
     const auto& phi_kernel_context = impl_->getKernelContext();
     size_t phi_tensor_index = 0;
@@ -1689,8 +1690,10 @@ void OperatorWithKernel::CheckWhetherPreparePhiData(
     for (auto& phi_output_name : phi_output_names) {
       const auto& iter = outnames.find(phi_output_name);
       if (iter != outnames.end()) {
-        for (auto& var_name : iter->second) {
-          auto var_output = scope.FindVar(var_name);
+        for (size_t i = 0; i < iter->second.size(); ++i) {
+          auto var_output = outvars != nullptr
+                                ? outvars->at(phi_output_name)[i]
+                                : scope.FindVar(iter->second[i]);
           auto phi_output =
               phi_kernel_context->MutableOutputAt<phi::TensorBase>(
                   phi_tensor_index);
@@ -1711,6 +1714,41 @@ void OperatorWithKernel::CheckWhetherPreparePhiData(
   }
 }
 
+void OperatorWithKernel::BindVariableSlots(VariableSlotTable* table) {
+  var_slots_ = table;
+  input_slots_.clear();
+  output_slots_.clear();
+  for (auto& var_name_item : Inputs()) {
+    auto& slots = input_slots_[var_name_item.first];
+    for (auto& var_name : var_name_item.second) {
+      slots.push_back(table->Register(var_name));
+    }
+  }
+  for (auto& var_name_item : Outputs()) {
+    auto& slots = output_slots_[var_name_item.first];
+    for (auto& var_name : var_name_item.second) {
+      slots.push_back(table->Register(var_name));
+    }
+  }
+}
+
+void OperatorWithKernel::ResolveVariableSlots(const VariableSlotMap& slots,
+                                              const Scope& scope,
+                                              VariableValueMap* vars) const {
+  for (auto& slot_item : slots) {
+    auto& item_vars = (*vars)[slot_item.first];
+    item_vars.reserve(slot_item.second.size());
+    for (int slot : slot_item.second) {
+      auto* var = var_slots_->Get(slot);
+      // the variable may be created after the table was bound
+      if (var == nullptr) {
+        var = scope.FindVar(var_slots_->Name(slot));
+      }
+      item_vars.push_back(var);
+    }
+  }
+}
+
 void OperatorWithKernel::RunImpl(const Scope& scope,
                                  const platform::Place& place) const {
   // To reduce the elapsed time of HasAttr, we use bool variable to record the
@@ -1721,13 +1759,28 @@ void OperatorWithKernel::RunImpl(const Scope& scope,
       HasAttr(kAllKernelsMustComputeRuntimeShape))
     all_kernels_must_compute_runtime_shape_ = true;
   const Scope* cur_scope = &scope;
-  CheckWhetherPreparePhiData(Inputs(), Outputs(), scope);
+  // Without the cache of the runtime context, the variables are resolved by
+  // their slots when the op is bound to the slot table of this scope.
+  bool use_var_slots = !enable_cache_runtime_context_ &&
+                       var_slots_ != nullptr &&
+                       var_slots_->scope() == cur_scope;
+  RuntimeContext slot_ctx(VariableValueMap{}, VariableValueMap{});
+  if (use_var_slots) {
+    ResolveVariableSlots(input_slots_, scope, &slot_ctx.inputs);
+    ResolveVariableSlots(output_slots_, scope, &slot_ctx.outputs);
+  }
+  CheckWhetherPreparePhiData(Inputs(),
+                             Outputs(),
+                             scope,
+                             use_var_slots ? &slot_ctx.outputs : nullptr);
 #if defined(PADDLE_WITH_XPU)
   if (std::getenv("XPU_NEED_PREPARE_PHI_DATA") != nullptr) {
     need_prepare_phi_data_ = atoi(std::getenv("XPU_NEED_PREPARE_PHI_DATA"));
   }
 #endif
-  if (!enable_cache_runtime_context_) {
+  if (use_var_slots) {
+    RunImpl(scope, place, &slot_ctx);
+  } else if (!enable_cache_runtime_context_) {
     RuntimeContext ctx(Inputs(), Outputs(), scope);
     RunImpl(scope, place, &ctx);
   } else if (run_phi_kernel_ && impl_ != nullptr && !need_prepare_data_ &&
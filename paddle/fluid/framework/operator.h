@@ -372,6 +372,11 @@ class TEST_API OperatorBase {
     return place;
   }
 
+  // Register the inputs and outputs of the op in the table. While the table
+  // is bound to the scope the op runs in, the op may get its variables by
+  // their slots instead of looking up their names in the scope.
+  virtual void BindVariableSlots(VariableSlotTable* table UNUSED) {}
+
   uint64_t Id() const { return id_; }
 
   void SetId(uint64_t id) { id_ = id; }
@@ -755,6 +760,8 @@ class OperatorWithKernel : public OperatorBase {
 
   virtual ~OperatorWithKernel();
 
+  void BindVariableSlots(VariableSlotTable* table) override;
+
   static paddle::flat_hash_map<std::string /* op_type */, OpKernelMap>&
   AllOpKernels() {
     static paddle::flat_hash_map<std::string, OpKernelMap> g_all_op_kernels;
@@ -881,9 +888,16 @@ class OperatorWithKernel : public OperatorBase {
                      RuntimeContext* ctx,
                      const phi::Place& place) const;
 
+  // outvars are the resolved outputs, or nullptr to look them up in the
+  // scope.
   void CheckWhetherPreparePhiData(const VariableNameMap& innames,
                                   const VariableNameMap& outnames,
-                                  const Scope& scope) const;
+                                  const Scope& scope,
+                                  const VariableValueMap* outvars) const;
+
+  void ResolveVariableSlots(const VariableSlotMap& slots,
+                            const Scope& scope,
+                            VariableValueMap* vars) const;
 
   void TransferInplaceVarsBack(const Scope& scope,
                                const std::vector<std::string>& inplace_vars,
@@ -932,6 +946,10 @@ class OperatorWithKernel : public OperatorBase {
   mutable std::unique_ptr<phi::KernelSignature> kernel_signature_;
   mutable std::unique_ptr<phi::Kernel> phi_kernel_;
   mutable std::unique_ptr<phi::ArgumentMappingFn> arg_map_fn_;
+  // the table of BindVariableSlots, and the slots of inputs_ and outputs_
+  VariableSlotTable* var_slots_ = nullptr;
+  VariableSlotMap input_slots_;
+  VariableSlotMap output_slots_;
 
  private:
   struct CacheImpl;
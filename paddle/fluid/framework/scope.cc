@@ -266,6 +266,32 @@ void Scope::EraseVarsExcept(const std::unordered_set<Variable*>& vars) {
   }
 }
 
+int VariableSlotTable::Register(const std::string& name) {
+  auto it = slots_.find(name);
+  if (it != slots_.end()) {
+    return it->second;
+  }
+  int slot = static_cast<int>(names_.size());
+  slots_.emplace(name, slot);
+  names_.push_back(name);
+  // a name registered after Bind is resolved by the next Bind
+  vars_.push_back(nullptr);
+  return slot;
+}
+
+int VariableSlotTable::Find(const std::string& name) const {
+  auto it = slots_.find(name);
+  return it == slots_.end() ? -1 : it->second;
+}
+
+void VariableSlotTable::Bind(const Scope& scope) {
+  for (size_t i = 0; i < names_.size(); ++i) {
+    vars_[i] = scope.FindVar(names_[i]);
+  }
+  scope_ = &scope;
+  VLOG(3) << "Bind " << names_.size() << " variable slots to scope " << &scope;
+}
+
 std::string GenScopeTreeDebugInfo(Scope* root) {
   std::stringstream os;
 
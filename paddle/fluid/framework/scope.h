@@ -176,6 +176,43 @@ class TEST_API Scope {
   mutable phi::RWLock vars_lock_;
 };
 
+/**
+ * @brief VariableSlotTable resolves variable names to dense slots.
+ *
+ * The names are registered once, e.g. when the operators of a program are
+ * created, and each gets an integer slot. Bind resolves all of them in a
+ * scope, after which Get is a plain vector index without any lock or hash.
+ * The table does not track the scope: it must be bound again if variables
+ * are erased or renamed. It is not thread safe, each worker thread owns one.
+ */
+class TEST_API VariableSlotTable {
+ public:
+  /// Register the name if it is new, and return its slot.
+  int Register(const std::string& name);
+
+  /// Return the slot of the name, -1 if it is not registered.
+  int Find(const std::string& name) const;
+
+  /// Resolve all the registered names in the scope or its ancestors. The
+  /// slots of the names not found get nullptr.
+  void Bind(const Scope& scope);
+
+  Variable* Get(int slot) const { return vars_[slot]; }
+
+  const std::string& Name(int slot) const { return names_[slot]; }
+
+  /// The scope of the last Bind, nullptr if it is not bound.
+  const Scope* scope() const { return scope_; }
+
+  size_t size() const { return names_.size(); }
+
+ private:
+  std::unordered_map<std::string, int> slots_;
+  std::vector<std::string> names_;
+  std::vector<Variable*> vars_;
+  const Scope* scope_{nullptr};
+};
+
 // Generate some debug string about the inherience structure of scope, quite
 // naive.
 TEST_API std::string GenScopeTreeDebugInfo(Scope*);
@@ -46,6 +46,7 @@ class InferNoNeedBufferVarsFN;
 // TODO(panyx0718): Replace vector with something like gtl::Vector.
 using VariableNameMap = std::map<std::string, std::vector<std::string>>;
 using VariableValueMap = std::map<std::string, std::vector<Variable*>>;
+using VariableSlotMap = std::map<std::string, std::vector<int>>;
 
 using Attribute = paddle::variant<paddle::blank,
                                   int,
@@ -295,6 +295,12 @@ struct Argument {
   DECL_ARGUMENT_FIELD(tensorrt_use_explicit_quantization,
                       TensorRtUseExplicitQuantization,
                       bool);
+  DECL_ARGUMENT_FIELD(tensorrt_background_build,
+                      TensorRtBackgroundBuild,
+                      bool);
+  DECL_ARGUMENT_FIELD(tensorrt_online_shape_engines,
+                      TensorRtOnlineShapeEngines,
+                      int);
   DECL_ARGUMENT_FIELD(tensorrt_optimization_level,
                       TensorRtOptimizationLevel,
                       int);
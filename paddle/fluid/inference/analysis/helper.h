@@ -16,11 +16,14 @@ limitations under the License. */
 
 #include <sys/stat.h>
 
+#include <chrono>
 #include <cstdio>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <typeindex>
 #include <unordered_map>
 #include <utility>
@@ -250,9 +253,25 @@ static std::string GetTrtEngineSerializedData(
 static void SaveTrtEngineSerializedDataToFile(
     const std::string &trt_serialized_path,
     const std::string &engine_serialized_data) {
-  std::ofstream outfile(trt_serialized_path, std::ios::binary);
+  // written aside and renamed, so that the predictors loading the engine
+  // concurrently never read a partial one
+  std::string tmp_path =
+      trt_serialized_path + ".tmp" +
+      std::to_string(
+          std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+          static_cast<size_t>(
+              std::chrono::steady_clock::now().time_since_epoch().count()));
+  std::ofstream outfile(tmp_path, std::ios::binary);
   outfile << engine_serialized_data;
   outfile.close();
+#ifdef _WIN32
+  // rename does not replace an existing file on windows
+  std::remove(trt_serialized_path.c_str());
+#endif
+  if (!outfile || std::rename(tmp_path.c_str(), trt_serialized_path.c_str())) {
+    LOG(WARNING) << "Fail to save the TRT engine to " << trt_serialized_path;
+    std::remove(tmp_path.c_str());
+  }
 }
 
 }  // namespace analysis
@@ -250,6 +250,10 @@ void IRPassManager::CreatePasses(Argument *argument,
                     argument->tensorrt_ops_run_float()));
       pass->Set("use_explicit_quantization",
                 new bool(argument->tensorrt_use_explicit_quantization()));
+      pass->Set("background_build",
+                new bool(argument->tensorrt_background_build()));
+      pass->Set("online_shape_engines",
+                new int(argument->tensorrt_online_shape_engines()));
 
       // tuned trt dynamic_shape
       pass->Set("trt_shape_range_info_path",
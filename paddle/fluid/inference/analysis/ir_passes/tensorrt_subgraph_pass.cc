@@ -16,10 +16,12 @@
 #include "paddle/fluid/inference/analysis/ir_passes/tensorrt_subgraph_pass.h"
 #include <fcntl.h>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_set>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/block_desc.h"
 #include "paddle/fluid/framework/ir/graph_helper.h"
 #include "paddle/fluid/framework/ir/graph_pattern_detector.h"
@@ -31,13 +33,17 @@
 #include "paddle/fluid/inference/analysis/passes/convert_to_mixed_precision.h"
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/tensorrt/convert/op_converter.h"
+#include "paddle/fluid/inference/tensorrt/dynamic_shape_infermeta_factory.h"
 #include "paddle/fluid/inference/tensorrt/engine.h"
 #include "paddle/fluid/inference/tensorrt/op_teller.h"
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
 
+COMMON_DECLARE_bool(trt_bridge_ops_between_engines);
+
 namespace paddle {
 namespace inference {
 namespace analysis {
@@ -120,6 +126,51 @@ bool AllNodesLowerToTrtPostProcess(framework::ir::Graph *graph) {
   }
   return all_nodes_offload_to_trt;
 }
+
+// Find the ops refused by the op teller that can run in an engine, told by
+// tell_bridge, on paths between the ops of the engines. Taking them in merges
+// the engines around them, without their outputs and reformats between.
+std::unordered_set<const framework::ir::Node *> FindBridgeOps(
+    framework::ir::Graph *graph,
+    const std::unordered_set<const framework::ir::Node *> &trt_ops,
+    const std::function<bool(const framework::ir::Node *)> &is_disabled,
+    const std::function<bool(framework::ir::Node *)> &tell_bridge) {
+  std::unordered_set<const framework::ir::Node *> bridge_ops;
+  for (auto *node : graph->Nodes()) {
+    if (!node->IsOp() || !node->Op() || trt_ops.count(node) ||
+        is_disabled(node)) {
+      continue;
+    }
+    if (tell_bridge(node)) bridge_ops.insert(node);
+  }
+  // Drop the candidates not fed by the engines or not feeding them, until a
+  // chain of candidates is bounded by the ops of the engines at both ends.
+  auto in_engine = [&](const framework::ir::Node *node) {
+    return trt_ops.count(node) || bridge_ops.count(node);
+  };
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = bridge_ops.begin(); it != bridge_ops.end();) {
+      const auto *node = *it;
+      bool fed = false;
+      for (auto *producer : node->inputs[0]->inputs) {
+        fed = fed || in_engine(producer);
+      }
+      bool feeding = false;
+      for (auto *consumer : node->outputs[0]->outputs) {
+        feeding = feeding || in_engine(consumer);
+      }
+      if (fed && feeding) {
+        ++it;
+      } else {
+        it = bridge_ops.erase(it);
+        changed = true;
+      }
+    }
+  }
+  return bridge_ops;
+}
 }  // namespace
 
 using framework::ir::Node;
@@ -153,15 +204,14 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
   auto with_dynamic_shape = Get<bool>("with_dynamic_shape");
   auto use_explicit_quantization = Get<bool>("use_explicit_quantization");
   auto forbid_dynamic_op = Get<bool>("forbid_dynamic_op");
-  auto teller = [&](const framework::ir::Node *node) {
-    if (!node->IsOp() || !node->Op()) return false;
+  auto is_disabled = [&](const framework::ir::Node *node) {
     if (find(trt_disabled_ops.begin(),
              trt_disabled_ops.end(),
              node->Op()->Type()) != trt_disabled_ops.end()) {
       VLOG(3) << node->Op()->Type().c_str()
 
               << " is diabled by config in TensorRT";
-      return false;
+      return true;
     }
     for (const auto &out_var : node->Op()->OutputNames()) {
       for (const auto &var_name : node->Op()->Output(out_var)) {
@@ -169,18 +219,42 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
             trt_disabled_ops.end()) {
           VLOG(3) << node->Op()->Type().c_str()
                   << " is diabled by config in TensorRT";
-          return false;
+          return true;
         }
       }
     }
+    return false;
+  };
+  std::unordered_set<const framework::ir::Node *> trt_ops;
+  for (auto *node : graph->Nodes()) {
+    if (!node->IsOp() || !node->Op() || is_disabled(node)) continue;
     bool is_ok = tensorrt::OpTeller::Global().Tell(node,
                                                    no_calib_int8,
                                                    with_dynamic_shape,
                                                    forbid_dynamic_op,
                                                    use_explicit_quantization);
-    if (!is_ok)
+    if (is_ok) {
+      trt_ops.insert(node);
+    } else {
       VLOG(3) << node->Op()->Type().c_str() << " op is not in TensorRT";
-    return is_ok;
+    }
+  }
+  std::unordered_set<const framework::ir::Node *> bridge_ops;
+  if (FLAGS_trt_bridge_ops_between_engines) {
+    bridge_ops = FindBridgeOps(graph, trt_ops, is_disabled, [&](Node *node) {
+      return tensorrt::OpTeller::Global().TellBridge(
+          node, no_calib_int8, with_dynamic_shape);
+    });
+    for (auto *node : bridge_ops) {
+      auto *op = const_cast<Node *>(node)->Op();
+      op->SetAttr(tensorrt::kTrtBridgeOpAttrName, true);
+      tensorrt::OpTeller::Global().SetOpConverterType(
+          op, tensorrt::OpConverterType::GenericPluginCreater);
+      trt_ops.insert(node);
+    }
+  }
+  auto teller = [&](const framework::ir::Node *node) {
+    return trt_ops.count(node) > 0;
   };
 
   framework::ir::SubGraphFuser fuser(
@@ -191,6 +265,18 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
       "tensorrt_engine");
   fuser();
 
+  // A chain of bridge ops inside an engine removes an engine boundary.
+  int num_bridged_boundaries = 0;
+  for (auto *node : bridge_ops) {
+    auto *op_node = const_cast<Node *>(node);
+    if (!framework::ir::Agent(op_node).deleted()) continue;
+    bool chain_head = true;
+    for (auto *producer : op_node->inputs[0]->inputs) {
+      if (bridge_ops.count(producer)) chain_head = false;
+    }
+    if (chain_head) ++num_bridged_boundaries;
+  }
+
   std::vector<std::string> graph_param_names =
       ExtractParameters(graph->Nodes());
   // those parameter already exist in trt, and should not have another copy in
@@ -220,6 +306,13 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
   graph->Set(framework::ir::kRepetitiveParamAttr,
              new std::vector<std::string>(repetitive_params));
 
+  if (FLAGS_trt_bridge_ops_between_engines) {
+    LOG(INFO) << "Bridged " << bridge_ops.size()
+              << " ops refused by TensorRT between engines, removing "
+              << num_bridged_boundaries << " engine boundaries, "
+              << engine_names.size() << " engines in total.";
+  }
+
   bool all_nodes_offload_to_trt = AllNodesLowerToTrtPostProcess(graph);
   if (all_nodes_offload_to_trt) {
     LOG(INFO) << "The entire graph is offloaded to TensorRT.";
@@ -261,13 +354,48 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
   }
 }
 
+// The parts of the key of a serialized engine beyond the io of its subgraph,
+// so that the engines are only loaded by the same subgraph on the same
+// TensorRT, GPU arch and shape profile.
+std::string GenerateEngineSignature(
+    const std::string &subgraph,
+    int device_id,
+    const std::map<std::string, std::vector<int>> &min_input_shape,
+    const std::map<std::string, std::vector<int>> &max_input_shape,
+    const std::map<std::string, std::vector<int>> &optim_input_shape,
+    const std::map<std::string, std::vector<int>> &min_shape_tensor,
+    const std::map<std::string, std::vector<int>> &max_shape_tensor,
+    const std::map<std::string, std::vector<int>> &optim_shape_tensor) {
+  std::string signature = std::to_string(std::hash<std::string>()(subgraph));
+  signature += "#trt" + std::to_string(TRT_VERSION) + "-" +
+               std::to_string(tensorrt::GetInferLibVersion());
+  signature +=
+      "#sm" + std::to_string(platform::GetGPUComputeCapability(device_id));
+  for (const auto *shapes : {&min_input_shape,
+                             &max_input_shape,
+                             &optim_input_shape,
+                             &min_shape_tensor,
+                             &max_shape_tensor,
+                             &optim_shape_tensor}) {
+    signature += "#";
+    for (const auto &it : *shapes) {
+      signature += it.first + ":";
+      for (auto dim : it.second) {
+        signature += std::to_string(dim) + ",";
+      }
+    }
+  }
+  return signature;
+}
+
 std::string GenerateEngineKey(const std::set<std::string> &engine_inputs,
                               const std::set<std::string> &engine_outputs,
                               const std::string &predictor_id,
                               const std::string &max_batch_size,
                               const std::string &precision,
                               bool use_cuda_graph,
-                              const bool for_calibration) {
+                              const bool for_calibration,
+                              const std::string &signature = "") {
   std::string engine_hash_key = "";
   for (auto name : engine_inputs) {
     engine_hash_key += name;
@@ -287,6 +415,10 @@ std::string GenerateEngineKey(const std::set<std::string> &engine_inputs,
 
   engine_hash_key += "#";
   engine_hash_key += std::to_string(use_cuda_graph);
+  if (!for_calibration) {
+    engine_hash_key += "#";
+    engine_hash_key += signature;
+  }
 
   auto engine_key = std::to_string(std::hash<std::string>()(engine_hash_key));
   VLOG(2) << "TRT engine hash key: " << engine_hash_key;
@@ -739,7 +871,16 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
                         std::to_string(max_batch_size),
                         std::to_string(static_cast<int>(precision_mode)),
                         use_cuda_graph,
-                        false);
+                        false,
+                        GenerateEngineSignature(
+                            block_desc.Proto()->SerializeAsString(),
+                            gpu_device_id,
+                            min_input_shape,
+                            max_input_shape,
+                            optim_input_shape,
+                            min_shape_tensor,
+                            max_shape_tensor,
+                            optim_shape_tensor));
   auto calibration_engine_key =
       GenerateEngineKey(input_names_with_id,
                         output_names_with_id,
@@ -772,6 +913,17 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   op_desc->SetAttr("dla_core", dla_core);
   op_desc->SetAttr("disable_trt_plugin_fp16", disable_trt_plugin_fp16);
   op_desc->SetAttr("context_memory_sharing", context_memory_sharing);
+  // the engines not loaded from the cache are built by the op at runtime
+  bool background_build = Has("background_build") &&
+                          Get<bool>("background_build") &&
+                          !(with_dynamic_shape && min_input_shape.empty());
+  op_desc->SetAttr("background_build", background_build);
+  // the engines of the hot shapes are built by the op at runtime
+  int online_shape_engines = 0;
+  if (with_dynamic_shape && Has("online_shape_engines")) {
+    online_shape_engines = Get<int>("online_shape_engines");
+  }
+  op_desc->SetAttr("online_shape_engines", online_shape_engines);
   std::string trt_engine_serialized_data;
   op_desc->SetAttr("engine_serialized_data", trt_engine_serialized_data);
 
@@ -801,9 +953,12 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
     return calibration_engine_key;
   }
 
-  std::copy(params_not_shared.begin(),
-            params_not_shared.end(),
-            std::back_inserter(*repetitive_params));
+  // the native runs until the engine is built need the params
+  if (!background_build) {
+    std::copy(params_not_shared.begin(),
+              params_not_shared.end(),
+              std::back_inserter(*repetitive_params));
+  }
 
   // Check trt version for dynamic shape input.
 
@@ -898,6 +1053,11 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   if (with_dynamic_shape && min_input_shape.empty()) {
     return engine_key + std::to_string(predictor_id);
   }
+  if (background_build) {
+    LOG(INFO) << "TRT engine " << engine_key
+              << " will be built in the background at runtime.";
+    return engine_key + std::to_string(predictor_id);
+  }
 
   // the following code will NOT run in following situation:
   // 1. calibration mode (generate trt int8 calibration table data)
@@ -28,6 +28,7 @@
 #include "paddle/fluid/platform/errors.h"
 #include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/utils/string/split.h"
+#include "paddle/utils/string/string_helper.h"
 
 #ifdef PADDLE_WITH_TENSORRT
 #include "paddle/fluid/inference/tensorrt/helper.h"
@@ -452,6 +453,8 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(use_cudnn_);
   CP_MEMBER(gpu_device_id_);
   CP_MEMBER(memory_pool_init_size_mb_);
+  CP_MEMBER(gpu_memory_quota_mb_);
+  CP_MEMBER(gpu_memory_quota_hard_);
 
   // Mixed precision related.
   CP_MEMBER(mixed_black_list_);
@@ -487,9 +490,13 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(trt_allow_build_at_runtime_);
   CP_MEMBER(collect_shape_range_info_);
   CP_MEMBER(shape_range_info_path_);
+  CP_MEMBER(input_shape_buckets_);
+  CP_MEMBER(output_shape_bucket_axes_);
   CP_MEMBER(trt_use_inspector_);
   CP_MEMBER(trt_inspector_serialize_);
   CP_MEMBER(trt_use_explicit_quantization_);
+  CP_MEMBER(trt_background_build_);
+  CP_MEMBER(trt_online_shape_engines_);
   CP_MEMBER(trt_engine_memory_sharing_);
   CP_MEMBER(trt_engine_memory_sharing_identifier_);
   CP_MEMBER(trt_optimization_level_);
@@ -558,6 +565,8 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(use_optimized_model_);
 
   CP_MEMBER(cpu_math_library_num_threads_);
+  CP_MEMBER(cpu_core_ids_);
+  CP_MEMBER(cpu_spin_wait_);
 
   CP_MEMBER(serialized_info_cache_);
 
@@ -591,10 +600,14 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(skip_load_params_);
 
   CP_MEMBER(use_new_executor_);
+  CP_MEMBER(use_new_executor_cuda_graph_);
   CP_MEMBER(use_pir_);
   CP_MEMBER(custom_passes_);
   CP_MEMBER(custom_pass_only_);
   CP_MEMBER(pm_opt_level_);
+  CP_MEMBER(use_weight_only_quant_);
+  CP_MEMBER(weight_only_algo_);
+  CP_MEMBER(weight_only_group_size_);
   CP_MEMBER(ir_debug_passes_);
 
   if (use_gpu_) {
@@ -1162,6 +1175,8 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << use_fc_padding_;
   ss << gpu_device_id_;
   ss << memory_pool_init_size_mb_;
+  ss << gpu_memory_quota_mb_;
+  ss << gpu_memory_quota_hard_;
 
   ss << use_tensorrt_;
   ss << tensorrt_workspace_size_;
@@ -1272,6 +1287,20 @@ void AnalysisConfig::SetCpuMathLibraryNumThreads(
   Update();
 }
 
+void AnalysisConfig::EnableCpuCoreBinding(const std::vector<int> &cpu_ids,
+                                          bool spin_wait) {
+  for (int cpu_id : cpu_ids) {
+    PADDLE_ENFORCE_GE(cpu_id,
+                      0,
+                      platform::errors::InvalidArgument(
+                          "The cpu ids to bind should not be negative, but "
+                          "got %d.",
+                          cpu_id));
+  }
+  cpu_core_ids_ = cpu_ids;
+  cpu_spin_wait_ = spin_wait;
+}
+
 float AnalysisConfig::fraction_of_gpu_memory_for_pool() const {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // Get the GPU memory details and calculate the fraction of memory for the
@@ -1392,6 +1421,10 @@ std::string AnalysisConfig::Summary() {
   // cpu info
   os.InsertRow(
       {"cpu_math_thread", std::to_string(cpu_math_library_num_threads_)});
+  if (cpu_core_binding_enabled()) {
+    os.InsertRow({"cpu_core_ids", string::join_strings(cpu_core_ids_, ',')});
+    os.InsertRow({"cpu_spin_wait", cpu_spin_wait_ ? "true" : "false"});
+  }
   os.InsertRow({"enable_mkldnn", use_mkldnn_ ? "true" : "false"});
   os.InsertRow(
       {"mkldnn_cache_capacity", std::to_string(mkldnn_cache_capacity_)});
@@ -1407,6 +1440,11 @@ std::string AnalysisConfig::Summary() {
                   inference::Precision2String(mixed_precision_mode_)});
     os.InsertRow({"memory_pool_init_size",
                   std::to_string(memory_pool_init_size_mb_) + "MB"});
+    if (gpu_memory_quota_mb_ > 0) {
+      os.InsertRow({"gpu_memory_quota",
+                    std::to_string(gpu_memory_quota_mb_) + "MB" +
+                        (gpu_memory_quota_hard_ ? "" : " (soft)")});
+    }
     os.InsertRow(
         {"use_external_stream", use_external_stream_ ? "true" : "false"});
     os.InsertRow(
@@ -1546,6 +1584,13 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow({"enable_log", with_glog_info_ ? "true" : "false"});
   os.InsertRow({"collect_shape_range_info",
                 collect_shape_range_info_ ? shape_range_info_path_ : "false"});
+  os.InsertRow(
+      {"shape_bucketing", shape_bucketing_enabled() ? "true" : "false"});
+  if (use_weight_only_quant_) {
+    os.InsertRow({"weight_only_quant",
+                  weight_only_algo_ + ", group_size " +
+                      std::to_string(weight_only_group_size_)});
+  }
 
   return os.PrintTable();
 }
@@ -1631,6 +1676,45 @@ bool AnalysisConfig::shape_range_info_collected() const {
   return collect_shape_range_info_;
 }
 
+void AnalysisConfig::SetInputShapeBuckets(const std::string &input_name,
+                                          int axis,
+                                          const std::vector<int> &boundaries) {
+  PADDLE_ENFORCE_GE(axis,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The axis of the shape buckets of input %s should be "
+                        "non-negative, but got %d.",
+                        input_name,
+                        axis));
+  for (size_t i = 0; i < boundaries.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        boundaries[i] > 0 && (i == 0 || boundaries[i] > boundaries[i - 1]),
+        true,
+        platform::errors::InvalidArgument(
+            "The shape bucket boundaries of input %s should be positive and "
+            "increasing.",
+            input_name));
+  }
+  input_shape_buckets_[input_name] = std::make_pair(axis, boundaries);
+}
+
+void AnalysisConfig::SetOutputShapeBucketAxis(const std::string &output_name,
+                                              const std::string &input_name,
+                                              int axis) {
+  PADDLE_ENFORCE_GE(axis,
+                    0,
+                    platform::errors::InvalidArgument(
+                        "The axis of the shape buckets of output %s should be "
+                        "non-negative, but got %d.",
+                        output_name,
+                        axis));
+  output_shape_bucket_axes_[output_name] = std::make_pair(input_name, axis);
+}
+
+bool AnalysisConfig::shape_bucketing_enabled() const {
+  return !input_shape_buckets_.empty();
+}
+
 void AnalysisConfig::EnableTunedTensorRtDynamicShape(
     const std::string &shape_range_info_path, bool allow_build_at_runtime) {
   shape_range_info_path_ = shape_range_info_path;
@@ -1678,4 +1762,25 @@ void AnalysisConfig::EnableCustomPasses(const std::vector<std::string> &passes,
 void AnalysisConfig::SetOptimizationLevel(int opt_level) {
   pm_opt_level_ = opt_level;
 }
+
+void AnalysisConfig::EnableWeightOnlyQuantization(const std::string &algo,
+                                                  int group_size) {
+  PADDLE_ENFORCE_EQ(
+      algo == "weight_only_int8" || algo == "weight_only_int4",
+      true,
+      platform::errors::InvalidArgument(
+          "The algo of the weight only quantization must be weight_only_int8 "
+          "or weight_only_int4, but got %s.",
+          algo));
+  PADDLE_ENFORCE_EQ(
+      group_size == -1 || group_size == 64 || group_size == 128,
+      true,
+      platform::errors::InvalidArgument(
+          "The group_size of the weight only quantization must be -1, 64 or "
+          "128, but got %d.",
+          group_size));
+  use_weight_only_quant_ = true;
+  weight_only_algo_ = algo;
+  weight_only_group_size_ = group_size;
+}
 }  // namespace paddle
@@ -18,10 +18,13 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -68,6 +71,7 @@
 #include "paddle/phi/core/generator.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
 #include "paddle/utils/string/split.h"
+#include "paddle/utils/string/string_helper.h"
 
 #if defined(PADDLE_WITH_DISTRIBUTE) && defined(PADDLE_WITH_PSCORE)
 #include "paddle/fluid/distributed/fleet_executor/fleet_executor.h"
@@ -81,6 +85,7 @@
 
 #ifdef PADDLE_WITH_DNNL
 #include "paddle/fluid/inference/api/onednn_quantizer.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
 #endif
 
 #ifdef PADDLE_WITH_ONNXRUNTIME
@@ -113,11 +118,13 @@
 
 #include "paddle/common/flags.h"
 #include "paddle/fluid/ir_adaptor/translator/translate.h"
+#include "paddle/fluid/pir/drr/include/drr_pass_group.h"
 #include "paddle/fluid/pir/transforms/general/constant_folding_pass.h"
 #include "paddle/fluid/pir/transforms/general/dead_code_elimination_pass.h"
 #include "paddle/fluid/pir/transforms/general/inplace_pass.h"
 #include "paddle/fluid/pir/transforms/general/params_sync_among_devices_pass.h"
 #include "paddle/fluid/pir/transforms/general/replace_fetch_with_shadow_output_pass.h"
+#include "paddle/fluid/pir/transforms/gpu/fusion_planner.h"
 #include "paddle/fluid/pir/transforms/passes.h"
 #include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
 #include "paddle/fluid/pir/transforms/shape_optimization_pass.h"
@@ -125,9 +132,19 @@
 #include "paddle/pir/include/pass/pass_registry.h"
 
 COMMON_DECLARE_bool(pir_apply_inplace_pass);
+COMMON_DECLARE_bool(pir_fusion_planner);
+COMMON_DECLARE_bool(pir_group_drr_passes);
+COMMON_DECLARE_bool(trt_int8_calib_merge_table);
 
 namespace paddle {
 namespace {
+bool IsFusionPass(const std::string &pass_name) {
+  const std::string suffix = "_fuse_pass";
+  return pass_name.size() > suffix.size() &&
+         pass_name.compare(
+             pass_name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 void UpdatePrivateDeviceContext(InferGPUContext *gpu_context,
                                 GPUContextResource *gpu_resource,
@@ -458,8 +475,17 @@ bool AnalysisPredictor::Init(
   if (config_.use_gpu_ && config_.use_external_stream_) {
     private_context_ = true;
   }
+  // the memory quota is applied to the allocator of the private context
+  if (config_.use_gpu_ && config_.gpu_memory_quota_mb_ > 0) {
+    private_context_ = true;
+    memory_domain_ = std::make_shared<memory::allocation::MemoryDomain>(
+        place_,
+        config_.gpu_memory_quota_mb_ << 20,
+        config_.gpu_memory_quota_hard_);
+    memory_domain_->SetReleaseCallback([this] { return ReleaseIdleMemory(); });
+  }
   if (private_context_) {
-    if (!status_is_cloned_) {
+    if (!status_is_cloned_ && config_.use_external_stream_) {
       predictor_stream_ = config_.GetExecStream();
     }
     // NOTE: If the external_stream equals to global_device_contexts's stream,
@@ -489,6 +515,8 @@ bool AnalysisPredictor::Init(
   }
 #endif
 
+  InitShapeBuckets();
+
   inference::DisplayMemoryInfo(place_, "Init predictor");
   return true;
 }
@@ -658,6 +686,10 @@ void AnalysisPredictor::InitDeviceContexts() {
               ResourceManager::Instance().GetGPUResource(predictor_stream_);
           auto *gpu_context = new InferGPUContext(place_);
           UpdatePrivateDeviceContext(gpu_context, gpu_resource, place_);
+          if (memory_domain_) {
+            gpu_context->SetAllocator(
+                GetQuotaAllocator(gpu_resource->GetStream()));
+          }
           return std::unique_ptr<phi::DeviceContext>(gpu_context);
         }));
   }
@@ -696,6 +728,55 @@ void AnalysisPredictor::InitDeviceContexts() {
 #endif
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+phi::Allocator *AnalysisPredictor::GetQuotaAllocator(void *stream) {
+  auto &allocator = quota_allocators_[stream];
+  if (allocator == nullptr) {
+    allocator = std::make_shared<memory::allocation::QuotaAllocator>(
+        memory::allocation::AllocatorFacade::Instance().GetAllocator(
+            place_, reinterpret_cast<gpuStream_t>(stream)),
+        memory_domain_);
+  }
+  return allocator.get();
+}
+
+uint64_t AnalysisPredictor::ReleaseIdleMemory() {
+  // the inputs and the outputs are kept for the user
+  std::unordered_set<std::string> io_names;
+  for (auto &item : idx2feeds_) {
+    io_names.insert(item.second);
+  }
+  for (auto &item : idx2fetches_) {
+    io_names.insert(item.second);
+  }
+  if (inference_program_ != nullptr && executor_ != nullptr) {
+    for (auto *var : inference_program_->MutableBlock(0)->AllVars()) {
+      if (IsPersistable(var) || io_names.count(var->Name())) {
+        continue;
+      }
+      auto *variable = executor_->GetScope()->FindVar(var->Name());
+      if (variable != nullptr && variable->IsType<phi::DenseTensor>()) {
+        variable->GetMutable<phi::DenseTensor>()->clear();
+      }
+    }
+  }
+#ifdef PADDLE_WITH_TENSORRT
+  if (config_.trt_engine_memory_sharing()) {
+    inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
+        .ReleaseContextMemory(predictor_id_);
+  }
+#endif
+  uint64_t released = 0;
+  for (auto &item : quota_allocators_) {
+    released += memory::Release(platform::CUDAPlace(place_.GetDeviceId()),
+                                reinterpret_cast<gpuStream_t>(item.first));
+  }
+  VLOG(3) << "The idle predictor " << predictor_id_ << " releases "
+          << released << " bytes of the device memory";
+  return released;
+}
+#endif
+
 void *AnalysisPredictor::GetExecStream() const {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   if (place_.GetType() == phi::AllocationType::GPU) {
@@ -887,6 +968,14 @@ bool AnalysisPredictor::PrepareExecutor() {
     framework::interpreter::ExecutionConfig execution_config;
     execution_config.create_local_scope = false;
     execution_config.used_for_inference = true;
+    if (config_.new_executor_cuda_graph_enabled()) {
+      if (config_.use_gpu() && config_.new_ir_enabled()) {
+        execution_config.auto_cuda_graph = true;
+      } else {
+        LOG(WARNING) << "CUDA Graph of the new executor is only used on GPU "
+                        "with the new IR.";
+      }
+    }
     auto input_names = GetInputNames();
     execution_config.skip_gc_vars.insert(input_names.begin(),
                                          input_names.end());
@@ -944,6 +1033,7 @@ bool AnalysisPredictor::PrepareExecutor() {
       // Apply some optimization passes required by the inference
       ::pir::PassManager pass_pm(::pir::IrContext::Instance(),
                                  config_.pm_opt_level_);
+      std::vector<std::string> planned_fusion_passes;
       if (!config_.custom_passes_.empty()) {
         for (const auto &custom_pass : config_.custom_passes_) {
           pass_pm.AddPass(pir::PassRegistry::Instance().Get(custom_pass));
@@ -951,9 +1041,32 @@ bool AnalysisPredictor::PrepareExecutor() {
       }
       if (config_.use_gpu()) {
         // gpu
+        if (config_.use_weight_only_quant_) {
+          // before fc_fuse_pass, which fuses the matmuls it rewrites
+          auto weight_only_pass = pir::PassRegistry::Instance().Get(
+              "fused_weight_only_linear_pass");
+          weight_only_pass->Set("weight_only_algo",
+                                new std::string(config_.weight_only_algo_));
+          weight_only_pass->Set("weight_only_group_size",
+                                new int(config_.weight_only_group_size_));
+          pass_pm.AddPass(std::move(weight_only_pass));
+        }
         if (!config_.custom_pass_only_) {
+          std::vector<std::unique_ptr<pir::Pass>> gpu_passes;
           for (const auto &gpu_pass : kPirGpuPasses) {
-            pass_pm.AddPass(pir::PassRegistry::Instance().Get(gpu_pass));
+            // The fusion passes are ordered by the planner after the others.
+            if (FLAGS_pir_fusion_planner && IsFusionPass(gpu_pass)) {
+              planned_fusion_passes.push_back(gpu_pass);
+              continue;
+            }
+            gpu_passes.push_back(pir::PassRegistry::Instance().Get(gpu_pass));
+          }
+          if (FLAGS_pir_group_drr_passes) {
+            gpu_passes = paddle::drr::GroupDrrPasses(
+                std::move(gpu_passes), ::pir::IrContext::Instance());
+          }
+          for (auto &gpu_pass : gpu_passes) {
+            pass_pm.AddPass(std::move(gpu_pass));
           }
         }
 
@@ -995,6 +1108,10 @@ bool AnalysisPredictor::PrepareExecutor() {
                 ir_printing_conditions, ir_printing_conditions));
       }
       pass_pm.Run(pir_program_.get());
+      if (!planned_fusion_passes.empty()) {
+        ::pir::ApplyPlannedFusionPasses(
+            pir_program_.get(), planned_fusion_passes, config_.pm_opt_level_);
+      }
 
       // Apply some basic passes required by the framework
       ::pir::PassManager basic_pass_pm(::pir::IrContext::Instance(),
@@ -1394,12 +1511,23 @@ void AnalysisPredictor::MkldnnPreSet(
   }
   phi::OneDNNContext::tls().set_cur_input_shape_cache_capacity(
       config_.mkldnn_cache_capacity_);
+  // A predictor and its clones run the same program, so they share the
+  // oneDNN primitives they create.
+  phi::OneDNNContext::tls().set_shared_cache_scope(root_predictor_id_);
 
 #endif
 }
 
 void AnalysisPredictor::MkldnnPostReset() {
 #ifdef PADDLE_WITH_DNNL
+  phi::OneDNNContext::tls().reset_shared_cache_scope();
+  if (VLOG_IS_ON(3) && phi::OneDNNPrimitiveCache::Instance().Enabled()) {
+    auto stats = phi::OneDNNPrimitiveCache::Instance().GetStats();
+    VLOG(3) << "Shared oneDNN primitive cache: hits=" << stats.hits
+            << ", misses=" << stats.misses
+            << ", evictions=" << stats.evictions << ", size=" << stats.size
+            << "/" << stats.capacity;
+  }
   // In cache clearing mode.
   if (config_.mkldnn_cache_capacity_ > 0 &&
       static_cast<phi::OneDNNContext *>(
@@ -1420,10 +1548,32 @@ void AnalysisPredictor::MkldnnPostReset() {
 #endif
 }
 
+void AnalysisPredictor::SetCpuThreadsOfRun() {
+  const auto &cpu_ids = config_.cpu_core_ids();
+  if (cpu_ids.empty()) {
+    paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+    return;
+  }
+  // the OpenMP threads of a thread stay bound, until a run of another
+  // predictor binds them
+  thread_local int bound_predictor_id = -1;
+  if (bound_predictor_id != predictor_id_) {
+    VLOG(3) << "Bind the threads of the run of predictor " << predictor_id_
+            << " to cpus " << string::join_strings(cpu_ids, ',');
+    paddle::platform::BindThreadsToCpus(cpu_ids);
+    paddle::platform::SetThreadsSpinWait(config_.cpu_spin_wait());
+    bound_predictor_id = predictor_id_;
+  } else {
+    paddle::platform::SetNumThreads(static_cast<int>(cpu_ids.size()));
+  }
+}
+
 bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
                             std::vector<PaddleTensor> *output_data,
                             int batch_size) {
-  paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  memory::allocation::MemoryDomainGuard memory_domain_guard(
+      memory_domain_.get());
+  SetCpuThreadsOfRun();
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
 #endif
@@ -1492,11 +1642,13 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
 
 bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
                             std::vector<paddle::Tensor> *outputs) {
+  memory::allocation::MemoryDomainGuard memory_domain_guard(
+      memory_domain_.get());
   inference::DisplayMemoryInfo(place_, "before run");
   if (private_context_) {
     paddle::platform::DeviceContextPool::SetDeviceContexts(&device_contexts_);
   }
-  paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  SetCpuThreadsOfRun();
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
 #endif
@@ -1786,6 +1938,9 @@ void AnalysisPredictor::PrepareArgument() {
     argument_->SetTensorRtInspectorSerialize(config_.trt_inspector_serialize_);
     argument_->SetTensorRtUseExplicitQuantization(
         config_.trt_use_explicit_quantization_);
+    argument_->SetTensorRtBackgroundBuild(config_.trt_background_build_);
+    argument_->SetTensorRtOnlineShapeEngines(
+        config_.trt_online_shape_engines_);
     argument_->SetTrtEngineMemorySharing(config_.trt_engine_memory_sharing());
     argument_->SetTensorRtOptimizationLevel(config_.trt_optimization_level_);
     argument_->SetTensorRtOpsRunFloat(config_.trt_ops_run_float_);
@@ -2463,6 +2618,8 @@ std::unique_ptr<ZeroCopyTensor> AnalysisPredictor::GetOutputTensor(
 }
 
 bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
+  memory::allocation::MemoryDomainGuard memory_domain_guard(
+      memory_domain_.get());
   inference::DisplayMemoryInfo(place_, "before run");
 #if defined(PADDLE_WITH_DISTRIBUTE) && defined(PADDLE_WITH_PSCORE)
   if (config_.dist_config().use_dist_model()) {  // NOLINT
@@ -2474,7 +2631,7 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   if (private_context_) {
     paddle::platform::DeviceContextPool::SetDeviceContexts(&device_contexts_);
   }
-  paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  SetCpuThreadsOfRun();
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) {
     std::vector<std::vector<int>> shape_vector;
@@ -2524,12 +2681,24 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   }
 #endif
 
+  if (!shape_buckets_.empty()) {
+    PadInputsToShapeBuckets();
+  }
   if (config_.new_executor_enabled()) {  // NOLINT
-    executor_->RunInterpreterCore({}, false, switch_stream);
+    // the captured graphs are selected by the shapes of the feeds
+    bool use_cuda_graph = config_.new_executor_cuda_graph_enabled() &&
+                          config_.new_ir_enabled();
+    executor_->RunInterpreterCore(
+        use_cuda_graph ? GetInputNames() : std::vector<std::string>{},
+        false,
+        switch_stream);
   } else {
     executor_->Run();
   }
   inference::DisplayMemoryInfo(place_, "after run");
+  if (!unpadded_inputs_.empty()) {
+    RestoreBucketedInputs();
+  }
 
 #ifdef PADDLE_WITH_XPU
   if (config_.use_xpu_ && !config_.use_lite_ && infer_xpu_ctx != nullptr) {
@@ -2592,6 +2761,10 @@ bool AnalysisPredictor::ExpRunWithExternalStream(const gpuStream_t stream) {
               ResourceManager::Instance().GetGPUResource(predictor_stream_);
           auto *gpu_context = new InferGPUContext(place_);
           UpdatePrivateDeviceContext(gpu_context, gpu_resource, place_);
+          if (memory_domain_) {
+            gpu_context->SetAllocator(
+                GetQuotaAllocator(gpu_resource->GetStream()));
+          }
           return std::unique_ptr<phi::DeviceContext>(gpu_context);
         }));
     auto &pool = paddle::experimental::DeviceContextPool::Instance();
@@ -2726,6 +2899,251 @@ bool AnalysisPredictor::ExpRunWithRuntimeConfig(void *config) {
   return false;
 }
 
+void AnalysisPredictor::InitShapeBuckets() {
+  shape_buckets_.clear();
+  std::map<std::string, std::vector<int32_t>> min_shapes;
+  std::map<std::string, std::vector<int32_t>> max_shapes;
+  std::map<std::string, std::vector<int32_t>> opt_shapes;
+  std::map<std::string, std::vector<int32_t>> min_values;
+  std::map<std::string, std::vector<int32_t>> max_values;
+  std::map<std::string, std::vector<int32_t>> opt_values;
+  bool shape_range_info_loaded = false;
+  for (const auto &item : config_.input_shape_buckets_) {
+    const auto &name = item.first;
+    int axis = item.second.first;
+    std::vector<int> boundaries = item.second.second;
+    PADDLE_ENFORCE_NE(
+        feed_names_.count(name),
+        0,
+        platform::errors::InvalidArgument(
+            "The input %s of the shape buckets is not an input of the model.",
+            name));
+    if (boundaries.empty()) {
+      if (!shape_range_info_loaded) {
+        PADDLE_ENFORCE_EQ(
+            FileExists(config_.shape_range_info_path()),
+            true,
+            platform::errors::InvalidArgument(
+                "The shape buckets of input %s are seeded from the shape "
+                "range info, but the shape range info file %s does not "
+                "exist, please set it by EnableTunedTensorRtDynamicShape.",
+                name,
+                config_.shape_range_info_path()));
+        inference::DeserializeShapeRangeInfo(config_.shape_range_info_path(),
+                                             &min_shapes,
+                                             &max_shapes,
+                                             &opt_shapes,
+                                             &min_values,
+                                             &max_values,
+                                             &opt_values);
+        shape_range_info_loaded = true;
+      }
+      auto min_iter = min_shapes.find(name);
+      auto max_iter = max_shapes.find(name);
+      PADDLE_ENFORCE_EQ(
+          min_iter != min_shapes.end() && max_iter != max_shapes.end() &&
+              axis < static_cast<int>(max_iter->second.size()),
+          true,
+          platform::errors::InvalidArgument(
+              "The shape range info has no axis %d of input %s.", axis, name));
+      int64_t min_size = std::max(min_iter->second[axis], 1);
+      int64_t max_size = max_iter->second[axis];
+      for (int64_t boundary = 1; boundary < max_size; boundary *= 2) {
+        if (boundary >= min_size) {
+          boundaries.push_back(static_cast<int>(boundary));
+        }
+      }
+      boundaries.push_back(static_cast<int>(max_size));
+    }
+    VLOG(3) << "Input " << name << " is padded along axis " << axis
+            << " to the shape buckets "
+            << string::join_strings(boundaries, ',');
+    shape_buckets_[name] = std::make_pair(axis, boundaries);
+  }
+
+  std::set<std::string> output_names;
+  for (const auto &item : idx2fetches_) {
+    output_names.insert(item.second);
+  }
+  for (const auto &item : config_.output_shape_bucket_axes_) {
+    PADDLE_ENFORCE_NE(
+        output_names.count(item.first),
+        0,
+        platform::errors::InvalidArgument(
+            "The output %s of the shape buckets is not an output of the "
+            "model.",
+            item.first));
+    PADDLE_ENFORCE_NE(
+        shape_buckets_.count(item.second.first),
+        0,
+        platform::errors::InvalidArgument(
+            "The output %s is cut back to the size of input %s, but the "
+            "input has no shape buckets, please set them by "
+            "SetInputShapeBuckets.",
+            item.first,
+            item.second.first));
+  }
+}
+
+// Copies rows of width bytes from src to dst, with the given distances
+// between the rows, and zeros the rest of the rows of dst if it is wider.
+static bool CopyPitchedRows(const phi::Place &place,
+                            void *dst,
+                            size_t dst_pitch,
+                            const void *src,
+                            size_t src_pitch,
+                            size_t width,
+                            int64_t rows) {
+  if (platform::is_cpu_place(place)) {
+    if (dst_pitch > width) {
+      std::memset(dst, 0, rows * dst_pitch);
+    }
+    for (int64_t i = 0; i < rows; ++i) {
+      std::memcpy(static_cast<char *>(dst) + i * dst_pitch,
+                  static_cast<const char *>(src) + i * src_pitch,
+                  width);
+    }
+    return true;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place)) {
+    auto stream = static_cast<phi::GPUContext *>(
+                      platform::DeviceContextPool::Instance().Get(place))
+                      ->stream();
+#ifdef PADDLE_WITH_HIP
+    if (dst_pitch > width) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          hipMemsetAsync(dst, 0, rows * dst_pitch, stream));
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(hipMemcpy2DAsync(dst,
+                                                dst_pitch,
+                                                src,
+                                                src_pitch,
+                                                width,
+                                                rows,
+                                                hipMemcpyDeviceToDevice,
+                                                stream));
+#else
+    if (dst_pitch > width) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaMemsetAsync(dst, 0, rows * dst_pitch, stream));
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpy2DAsync(dst,
+                                                 dst_pitch,
+                                                 src,
+                                                 src_pitch,
+                                                 width,
+                                                 rows,
+                                                 cudaMemcpyDeviceToDevice,
+                                                 stream));
+#endif
+    return true;
+  }
+#endif
+  return false;
+}
+
+// The rows before axis of dims, and the bytes of one index of axis.
+static std::pair<int64_t, size_t> PitchOf(const phi::DDim &dims,
+                                          int axis,
+                                          phi::DataType dtype) {
+  int64_t outer = 1;
+  for (int i = 0; i < axis; ++i) {
+    outer *= dims[i];
+  }
+  size_t inner_bytes = phi::SizeOf(dtype);
+  for (int i = axis + 1; i < dims.size(); ++i) {
+    inner_bytes *= dims[i];
+  }
+  return std::make_pair(outer, inner_bytes);
+}
+
+void AnalysisPredictor::PadInputsToShapeBuckets() {
+  auto *scope = executor_->GetScope();
+  for (const auto &item : shape_buckets_) {
+    const auto &name = item.first;
+    int axis = item.second.first;
+    const auto &boundaries = item.second.second;
+    auto *tensor = scope->FindVar(name)->GetMutable<phi::DenseTensor>();
+    auto &padded = bucketed_inputs_[name];
+    if (tensor->IsSharedBufferWith(padded)) {
+      // left padded by a failed run, and refilled since then
+      padded = phi::DenseTensor();
+    }
+    if (!tensor->initialized() || !tensor->lod().empty() ||
+        axis >= tensor->dims().size()) {
+      continue;
+    }
+    auto dims = tensor->dims();
+    int64_t size = dims[axis];
+    auto iter = std::lower_bound(boundaries.begin(), boundaries.end(), size);
+    if (iter == boundaries.end() || *iter == size) {
+      continue;
+    }
+
+    auto pitch = PitchOf(dims, axis, tensor->dtype());
+    dims[axis] = *iter;
+    padded.Resize(dims);
+    void *dst = padded.mutable_data(place_, tensor->dtype());
+    if (!CopyPitchedRows(place_,
+                         dst,
+                         *iter * pitch.second,
+                         tensor->data(),
+                         size * pitch.second,
+                         size * pitch.second,
+                         pitch.first)) {
+      LOG_FIRST_N(WARNING, 1) << "The shape buckets are only supported on "
+                                 "CPU and GPU, the inputs are not padded.";
+      continue;
+    }
+    VLOG(3) << "Pad input " << name << " along axis " << axis << " from "
+            << size << " to " << *iter;
+    unpadded_inputs_[name] = *tensor;
+    tensor->ShareDataWith(padded);
+  }
+}
+
+void AnalysisPredictor::RestoreBucketedInputs() {
+  auto *scope = executor_->GetScope();
+  for (const auto &item : config_.output_shape_bucket_axes_) {
+    const auto &output_name = item.first;
+    auto input_iter = unpadded_inputs_.find(item.second.first);
+    if (input_iter == unpadded_inputs_.end()) {
+      continue;
+    }
+    int input_axis = shape_buckets_.at(item.second.first).first;
+    int64_t size = input_iter->second.dims()[input_axis];
+    int axis = item.second.second;
+    auto *output =
+        scope->FindVar(output_name)->GetMutable<phi::DenseTensor>();
+    if (!output->initialized() || axis >= output->dims().size() ||
+        output->dims()[axis] <= size) {
+      continue;
+    }
+    auto dims = output->dims();
+    auto pitch = PitchOf(dims, axis, output->dtype());
+    size_t padded_pitch = dims[axis] * pitch.second;
+    dims[axis] = size;
+    phi::DenseTensor sliced;
+    sliced.Resize(dims);
+    void *dst = sliced.mutable_data(output->place(), output->dtype());
+    CopyPitchedRows(output->place(),
+                    dst,
+                    size * pitch.second,
+                    output->data(),
+                    padded_pitch,
+                    size * pitch.second,
+                    pitch.first);
+    VLOG(3) << "Cut output " << output_name << " along axis " << axis
+            << " back to " << size;
+    *output = sliced;
+  }
+  for (const auto &item : unpadded_inputs_) {
+    *scope->FindVar(item.first)->GetMutable<phi::DenseTensor>() = item.second;
+  }
+  unpadded_inputs_.clear();
+}
+
 void AnalysisPredictor::StatisticShapeRangeInfo() {
   std::map<std::string, std::vector<int32_t>> min_shapes;
   std::map<std::string, std::vector<int32_t>> max_shapes;
@@ -2894,6 +3312,17 @@ bool AnalysisPredictor::LoadParameters() {
   return true;
 }
 
+std::map<std::string, uint64_t> AnalysisPredictor::GetMemoryStats() {
+  if (memory_domain_ == nullptr) {
+    return {};
+  }
+  return {{"allocated", memory_domain_->allocated()},
+          {"peak_allocated", memory_domain_->peak_allocated()},
+          {"quota", memory_domain_->quota()},
+          {"exceeded_count", memory_domain_->exceeded_count()},
+          {"released", memory_domain_->released_bytes()}};
+}
+
 uint64_t AnalysisPredictor::TryShrinkMemory() {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   if (config_.use_gpu()) {
@@ -2965,6 +3394,18 @@ bool AnalysisPredictor::SaveTrtCalibToDisk() {
                   model_opt_cache_dir),
               engine_name);
 
+      if (FLAGS_trt_int8_calib_merge_table) {
+        std::ifstream saved_file(calibration_table_data_path);
+        if (saved_file.is_open()) {
+          std::string saved_table((std::istreambuf_iterator<char>(saved_file)),
+                                  std::istreambuf_iterator<char>());
+          LOG(INFO) << "Merge Paddle-TRT INT8 calibration table data with "
+                    << calibration_table_data_path;
+          calibration_table_data = TRTInt8Calibrator::MergeCalibrationTables(
+              saved_table, calibration_table_data);
+        }
+      }
+
       std::ofstream ofile(calibration_table_data_path, std::ios::out);
       LOG(INFO) << "Write Paddle-TRT INT8 calibration table data to file "
                 << calibration_table_data_path;
@@ -2979,6 +3420,10 @@ bool AnalysisPredictor::SaveTrtCalibToDisk() {
 #endif
 
 AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
+  // no other predictor releases the memory of this one from now on
+  if (memory_domain_) {
+    memory_domain_->SetReleaseCallback(nullptr);
+  }
 #ifdef PADDLE_WITH_TENSORRT
   if (config_.tensorrt_engine_enabled() &&
       config_.tensorrt_precision_mode_ == AnalysisConfig::Precision::kInt8 &&
@@ -3024,6 +3469,10 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
     memory::Release(place_);
   }
   device_contexts_.clear();
+  // the tensors still held, e.g. the outputs, are freed to them later
+  for (auto &item : quota_allocators_) {
+    memory::allocation::MemoryDomainRegistry::Instance().Retire(item.second);
+  }
 
 #ifdef PADDLE_WITH_TENSORRT
   if (config_.trt_engine_memory_sharing()) {
@@ -3498,6 +3947,10 @@ void Predictor::ClearIntermediateTensor() {
 
 uint64_t Predictor::TryShrinkMemory() { return predictor_->TryShrinkMemory(); }
 
+std::map<std::string, uint64_t> Predictor::GetMemoryStats() {
+  return predictor_->GetMemoryStats();
+}
+
 void Predictor::RegisterOutputHook(const OutputTensorHookFunc &hookfunc) {
   predictor_->RegisterOutputHook(hookfunc);
 }
@@ -3593,6 +4046,28 @@ PredictorPool::PredictorPool(const Config &config, size_t size) {
       preds_.emplace_back(main_pred_->Clone());
     }
   }
+  busy_.resize(size, false);
+}
+
+PredictorPool::PredictorPool(const Config &config,
+                             const std::vector<void *> &streams) {
+  PADDLE_ENFORCE_GE(
+      streams.size(),
+      1UL,
+      paddle::platform::errors::InvalidArgument(
+          "The predictor pool should have at least one stream, but got (%d)",
+          streams.size()));
+  PADDLE_ENFORCE_EQ(config.use_gpu(),
+                    true,
+                    paddle::platform::errors::InvalidArgument(
+                        "The predictor pool of streams needs a GPU config."));
+  Config stream_config(config);
+  stream_config.SetExecStream(streams[0]);
+  main_pred_ = std::make_unique<Predictor>(stream_config);
+  for (size_t i = 1; i < streams.size(); i++) {
+    preds_.emplace_back(main_pred_->Clone(streams[i]));
+  }
+  busy_.resize(streams.size(), false);
 }
 
 Predictor *PredictorPool::Retrieve(size_t idx) {
@@ -3608,6 +4083,42 @@ Predictor *PredictorPool::Retrieve(size_t idx) {
   }
   return preds_[idx - 1].get();
 }
+
+Predictor *PredictorPool::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  size_t idx = 0;
+  // from the one after the last acquired, to spread the runs
+  released_.wait(lock, [this, &idx] {
+    for (size_t i = 0; i < busy_.size(); ++i) {
+      idx = (next_ + i) % busy_.size();
+      if (!busy_[idx]) {
+        return true;
+      }
+    }
+    return false;
+  });
+  busy_[idx] = true;
+  next_ = idx + 1;
+  return Retrieve(idx);
+}
+
+void PredictorPool::Release(Predictor *pred) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t idx = 0; idx < busy_.size(); ++idx) {
+    if (Retrieve(idx) == pred) {
+      PADDLE_ENFORCE_EQ(busy_[idx],
+                        true,
+                        paddle::platform::errors::PreconditionNotMet(
+                            "The predictor (%d) is released but not acquired.",
+                            idx));
+      busy_[idx] = false;
+      released_.notify_one();
+      return;
+    }
+  }
+  PADDLE_THROW(paddle::platform::errors::InvalidArgument(
+      "The predictor to release is not in the pool."));
+}
 }  // namespace services
 
 namespace experimental {
@@ -3616,6 +4127,12 @@ namespace experimental {
 bool InternalUtils::RunWithExternalStream(paddle_infer::Predictor *p,
                                           cudaStream_t stream) {
 #ifdef PADDLE_WITH_CUDA
+#ifdef PADDLE_WITH_ONNXRUNTIME
+  if (auto *ort_pred =
+          dynamic_cast<paddle::ONNXRuntimePredictor *>(p->predictor_.get())) {
+    return ort_pred->ExpRunWithExternalStream(stream);
+  }
+#endif
   auto pred = dynamic_cast<paddle::AnalysisPredictor *>(p->predictor_.get());
   return pred->ExpRunWithExternalStream(stream);
 #endif
@@ -28,6 +28,7 @@
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/resource_manager.h"
+#include "paddle/fluid/memory/allocation/quota_allocator.h"
 #include "paddle/fluid/platform/device/gpu/gpu_types.h"
 #include "paddle/utils/string/printf.h"
 
@@ -268,6 +269,14 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   uint64_t TryShrinkMemory() override;
 
+  ///
+  /// \brief Get the stats of the GPU memory of the predictor, if it has a
+  /// memory quota set by AnalysisConfig::SetGpuMemoryQuota.
+  ///
+  /// \return the map of the names and values of the stats
+  ///
+  std::map<std::string, uint64_t> GetMemoryStats() override;
+
   ///
   /// \brief Get the argument used by predictor
   ///
@@ -491,9 +500,26 @@ class AnalysisPredictor : public PaddlePredictor {
  private:
   void StatisticShapeRangeInfo();
   void HookCollectShapeRangeInfo();
+  // resolves the shape buckets of the config, seeding the empty ones from the
+  // shape range info
+  void InitShapeBuckets();
+  // pads the inputs to their shape buckets in place for a run, and restores
+  // them after it, cutting the mapped outputs back to the unpadded size
+  void PadInputsToShapeBuckets();
+  void RestoreBucketedInputs();
+  // sets the cpu math library threads of a run of the calling thread, bound
+  // to the cpu cores of the config if any
+  void SetCpuThreadsOfRun();
   void InitPlace();
   void InitDeviceContexts();
   void InitResourceManager(void *stream);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // the allocator accounting to the memory domain on the stream
+  phi::Allocator *GetQuotaAllocator(void *stream);
+  // releases the memory kept between the runs, when the predictor is idle
+  // and another one is short of memory
+  uint64_t ReleaseIdleMemory();
+#endif
   std::string GetOptimizedModelPath();
   void ClearExtraParams();
 
@@ -597,6 +623,19 @@ class AnalysisPredictor : public PaddlePredictor {
   std::map<std::string, std::vector<std::vector<int32_t>>> shape_info_;
   std::map<std::string, std::vector<std::vector<int32_t>>> shape_tensor_value_;
 
+  // the axis and the bucket boundaries of the inputs padded to shape buckets
+  std::map<std::string, std::pair<int, std::vector<int>>> shape_buckets_;
+  // of the padded inputs, reused across runs
+  std::map<std::string, phi::DenseTensor> bucketed_inputs_;
+  // the inputs as set by the user, during a run with padded inputs
+  std::map<std::string, phi::DenseTensor> unpadded_inputs_;
+
+  // the memory domain of the GPU memory quota, and its allocators by the
+  // streams of the private contexts
+  std::shared_ptr<memory::allocation::MemoryDomain> memory_domain_;
+  std::map<void *, std::shared_ptr<memory::allocation::QuotaAllocator>>
+      quota_allocators_;
+
   bool private_context_{false};
   void *predictor_stream_{nullptr};
   std::map<phi::Place, std::shared_future<std::unique_ptr<phi::DeviceContext>>>
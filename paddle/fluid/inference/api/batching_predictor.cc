@@ -0,0 +1,437 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/float16.h"
+#include "paddle/phi/common/bfloat16.h"
+
+namespace paddle_infer {
+namespace services {
+
+namespace {
+
+using float16 = paddle::platform::float16;
+using bfloat16 = phi::dtype::bfloat16;
+
+constexpr size_t kNumQueueWaitBuckets = 32;
+
+int64_t RowBytes(const paddle::PaddleTensor& tensor) {
+  int64_t numel = 1;
+  for (size_t i = 1; i < tensor.shape.size(); ++i) {
+    numel *= tensor.shape[i];
+  }
+  return numel * paddle::PaddleDtypeSize(tensor.dtype);
+}
+
+// whether the requests can be concatenated along dim 0
+bool IsBatchable(const std::vector<paddle::PaddleTensor>& a,
+                 const std::vector<paddle::PaddleTensor>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].name != b[i].name || a[i].dtype != b[i].dtype ||
+        a[i].shape.size() != b[i].shape.size() || !a[i].lod.empty() ||
+        !b[i].lod.empty()) {
+      return false;
+    }
+    for (size_t j = 1; j < a[i].shape.size(); ++j) {
+      if (a[i].shape[j] != b[i].shape[j]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void CopyFromCpu(Tensor* tensor, DataType dtype, const void* data) {
+  switch (dtype) {
+    case DataType::FLOAT32:
+      tensor->CopyFromCpu(static_cast<const float*>(data));
+      break;
+    case DataType::INT64:
+      tensor->CopyFromCpu(static_cast<const int64_t*>(data));
+      break;
+    case DataType::INT32:
+      tensor->CopyFromCpu(static_cast<const int32_t*>(data));
+      break;
+    case DataType::UINT8:
+      tensor->CopyFromCpu(static_cast<const uint8_t*>(data));
+      break;
+    case DataType::INT8:
+      tensor->CopyFromCpu(static_cast<const int8_t*>(data));
+      break;
+    case DataType::FLOAT16:
+      tensor->CopyFromCpu(static_cast<const float16*>(data));
+      break;
+    case DataType::BOOL:
+      tensor->CopyFromCpu(static_cast<const bool*>(data));
+      break;
+    case DataType::FLOAT64:
+      tensor->CopyFromCpu(static_cast<const double*>(data));
+      break;
+    case DataType::BFLOAT16:
+      tensor->CopyFromCpu(static_cast<const bfloat16*>(data));
+      break;
+  }
+}
+
+void CopyToCpu(const Tensor& tensor, void* data) {
+  switch (tensor.type()) {
+    case DataType::FLOAT32:
+      tensor.CopyToCpu(static_cast<float*>(data));
+      break;
+    case DataType::INT64:
+      tensor.CopyToCpu(static_cast<int64_t*>(data));
+      break;
+    case DataType::INT32:
+      tensor.CopyToCpu(static_cast<int32_t*>(data));
+      break;
+    case DataType::UINT8:
+      tensor.CopyToCpu(static_cast<uint8_t*>(data));
+      break;
+    case DataType::INT8:
+      tensor.CopyToCpu(static_cast<int8_t*>(data));
+      break;
+    case DataType::FLOAT16:
+      tensor.CopyToCpu(static_cast<float16*>(data));
+      break;
+    case DataType::BOOL:
+      tensor.CopyToCpu(static_cast<bool*>(data));
+      break;
+    case DataType::FLOAT64:
+      tensor.CopyToCpu(static_cast<double*>(data));
+      break;
+    case DataType::BFLOAT16:
+      tensor.CopyToCpu(static_cast<bfloat16*>(data));
+      break;
+  }
+}
+
+size_t QueueWaitBucket(int64_t wait_us) {
+  size_t bucket = 0;
+  while (wait_us > 0 && bucket + 1 < kNumQueueWaitBuckets) {
+    wait_us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+class BatchingPredictor::Impl {
+ public:
+  Impl(const Config& config,
+       size_t num_predictors,
+       int max_batch_size,
+       int64_t max_queue_delay_us)
+      : pool_(config, num_predictors),
+        max_batch_size_(max_batch_size),
+        max_queue_delay_(max_queue_delay_us) {
+    PADDLE_ENFORCE_GE(max_batch_size,
+                      1,
+                      paddle::platform::errors::InvalidArgument(
+                          "The max_batch_size of BatchingPredictor should be "
+                          "positive, but got %d.",
+                          max_batch_size));
+    PADDLE_ENFORCE_GE(max_queue_delay_us,
+                      0,
+                      paddle::platform::errors::InvalidArgument(
+                          "The max_queue_delay_us of BatchingPredictor should "
+                          "be non-negative, but got %d.",
+                          max_queue_delay_us));
+    stats_.batch_size_histogram.resize(max_batch_size + 1);
+    stats_.queue_wait_us_histogram.resize(kNumQueueWaitBuckets);
+    for (size_t i = 0; i < num_predictors; ++i) {
+      workers_.emplace_back([this, i] { Work(pool_.Retrieve(i)); });
+    }
+  }
+
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  std::future<std::vector<paddle::PaddleTensor>> Submit(
+      std::vector<paddle::PaddleTensor> inputs) {
+    PADDLE_ENFORCE_EQ(inputs.empty(),
+                      false,
+                      paddle::platform::errors::InvalidArgument(
+                          "The inputs of a request should not be empty."));
+    int64_t rows = inputs[0].shape.empty() ? 0 : inputs[0].shape[0];
+    for (const auto& input : inputs) {
+      PADDLE_ENFORCE_EQ(
+          !input.shape.empty() && input.shape[0] == rows && rows > 0,
+          true,
+          paddle::platform::errors::InvalidArgument(
+              "The inputs of a request should have the same positive dim 0, "
+              "but input %s does not.",
+              input.name));
+      PADDLE_ENFORCE_GE(
+          input.data.length(),
+          static_cast<size_t>(rows * RowBytes(input)),
+          paddle::platform::errors::InvalidArgument(
+              "The data of input %s is smaller than its shape.", input.name));
+    }
+
+    std::unique_ptr<Request> request(new Request);
+    request->inputs = std::move(inputs);
+    request->rows = rows;
+    request->enqueue_time = std::chrono::steady_clock::now();
+    auto future = request->promise.get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.push_back(std::move(request));
+    }
+    cv_.notify_all();
+    return future;
+  }
+
+  BatchingStats GetStats() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+  }
+
+ private:
+  struct Request {
+    std::vector<paddle::PaddleTensor> inputs;
+    int64_t rows{0};
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::promise<std::vector<paddle::PaddleTensor>> promise;
+  };
+
+  // the rows of the requests at the front of the queue the next batch would
+  // take, under mutex_
+  int64_t BatchableRows() const {
+    int64_t rows = queue_.front()->rows;
+    for (size_t i = 1; i < queue_.size() && rows < max_batch_size_; ++i) {
+      if (!IsBatchable(queue_.front()->inputs, queue_[i]->inputs) ||
+          rows + queue_[i]->rows > max_batch_size_) {
+        break;
+      }
+      rows += queue_[i]->rows;
+    }
+    return rows;
+  }
+
+  void Work(Predictor* predictor) {
+    while (true) {
+      std::vector<std::unique_ptr<Request>> batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        // until the batch is full, or the oldest request is due
+        auto deadline = queue_.front()->enqueue_time + max_queue_delay_;
+        cv_.wait_until(lock, deadline, [this] {
+          return stop_ || queue_.empty() ||
+                 BatchableRows() >= max_batch_size_;
+        });
+        if (queue_.empty()) {
+          // taken by another predictor meanwhile
+          continue;
+        }
+        int64_t rows = queue_.front()->rows;
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+        while (!queue_.empty() &&
+               IsBatchable(batch[0]->inputs, queue_.front()->inputs) &&
+               rows + queue_.front()->rows <= max_batch_size_) {
+          rows += queue_.front()->rows;
+          batch.push_back(std::move(queue_.front()));
+          queue_.pop_front();
+        }
+      }
+      RunBatch(predictor, &batch);
+    }
+  }
+
+  void RunBatch(Predictor* predictor,
+                std::vector<std::unique_ptr<Request>>* batch) {
+    auto now = std::chrono::steady_clock::now();
+    int64_t rows = 0;
+    {
+      std::lock_guard<std::mutex> lock(stats_mutex_);
+      for (const auto& request : *batch) {
+        rows += request->rows;
+        int64_t wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                              now - request->enqueue_time)
+                              .count();
+        ++stats_.queue_wait_us_histogram[QueueWaitBucket(wait_us)];
+        ++stats_.num_requests;
+      }
+      if (rows < static_cast<int64_t>(stats_.batch_size_histogram.size())) {
+        ++stats_.batch_size_histogram[rows];
+      }
+      ++stats_.num_batches;
+    }
+    VLOG(3) << "BatchingPredictor runs a batch of " << batch->size()
+            << " requests, " << rows << " rows";
+
+    try {
+      const auto& first = batch->front()->inputs;
+      auto input_names = predictor->GetInputNames();
+      std::vector<char> buffer;
+      for (size_t i = 0; i < first.size(); ++i) {
+        const auto& name = first[i].name.empty() ? input_names.at(i)
+                                                 : first[i].name;
+        auto handle = predictor->GetInputHandle(name);
+        std::vector<int> shape = first[i].shape;
+        shape[0] = static_cast<int>(rows);
+        handle->Reshape(shape);
+        if (batch->size() == 1) {
+          CopyFromCpu(handle.get(), first[i].dtype, first[i].data.data());
+          continue;
+        }
+        // concatenated along dim 0
+        int64_t row_bytes = RowBytes(first[i]);
+        buffer.resize(rows * row_bytes);
+        char* dst = buffer.data();
+        for (const auto& request : *batch) {
+          size_t bytes = request->rows * row_bytes;
+          std::memcpy(dst, request->inputs[i].data.data(), bytes);
+          dst += bytes;
+        }
+        CopyFromCpu(handle.get(), first[i].dtype, buffer.data());
+      }
+
+      PADDLE_ENFORCE_EQ(
+          predictor->Run(),
+          true,
+          paddle::platform::errors::Fatal("BatchingPredictor fails to run."));
+
+      std::vector<std::vector<paddle::PaddleTensor>> outputs(batch->size());
+      for (const auto& name : predictor->GetOutputNames()) {
+        auto handle = predictor->GetOutputHandle(name);
+        paddle::PaddleTensor output;
+        output.name = name;
+        output.shape = handle->shape();
+        output.dtype = handle->type();
+        int64_t numel = 1;
+        for (auto dim : output.shape) {
+          numel *= dim;
+        }
+        output.data.Resize(numel * paddle::PaddleDtypeSize(output.dtype));
+        CopyToCpu(*handle, output.data.data());
+        if (batch->size() == 1) {
+          outputs[0].emplace_back(std::move(output));
+          continue;
+        }
+
+        bool batched = !output.shape.empty() && output.shape[0] == rows;
+        int64_t row_bytes = batched ? RowBytes(output) : 0;
+        const char* src = static_cast<const char*>(output.data.data());
+        for (size_t j = 0; j < batch->size(); ++j) {
+          if (!batched) {
+            // not along the batch dim, every request gets all of it
+            outputs[j].push_back(output);
+            continue;
+          }
+          int64_t request_rows = (*batch)[j]->rows;
+          paddle::PaddleTensor split;
+          split.name = name;
+          split.shape = output.shape;
+          split.shape[0] = static_cast<int>(request_rows);
+          split.dtype = output.dtype;
+          split.data.Resize(request_rows * row_bytes);
+          std::memcpy(split.data.data(), src, request_rows * row_bytes);
+          src += request_rows * row_bytes;
+          outputs[j].emplace_back(std::move(split));
+        }
+      }
+      for (size_t j = 0; j < batch->size(); ++j) {
+        (*batch)[j]->promise.set_value(std::move(outputs[j]));
+      }
+    } catch (...) {
+      auto exception = std::current_exception();
+      for (auto& request : *batch) {
+        request->promise.set_exception(exception);
+      }
+    }
+  }
+
+  PredictorPool pool_;
+  const int64_t max_batch_size_;
+  const std::chrono::microseconds max_queue_delay_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<Request>> queue_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+
+  std::mutex stats_mutex_;
+  BatchingStats stats_;
+};
+
+BatchingPredictor::BatchingPredictor(const Config& config,
+                                     size_t num_predictors,
+                                     int max_batch_size,
+                                     int64_t max_queue_delay_us)
+    : impl_(new Impl(
+          config, num_predictors, max_batch_size, max_queue_delay_us)) {}
+
+BatchingPredictor::~BatchingPredictor() = default;
+
+std::future<std::vector<paddle::PaddleTensor>> BatchingPredictor::Submit(
+    std::vector<paddle::PaddleTensor> inputs) {
+  return impl_->Submit(std::move(inputs));
+}
+
+bool BatchingPredictor::Run(const std::vector<paddle::PaddleTensor>& inputs,
+                            std::vector<paddle::PaddleTensor>* outputs) {
+  try {
+    // views of the memory of inputs, alive until the outputs are ready
+    std::vector<paddle::PaddleTensor> views(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      views[i].name = inputs[i].name;
+      views[i].shape = inputs[i].shape;
+      views[i].dtype = inputs[i].dtype;
+      views[i].lod = inputs[i].lod;
+      views[i].data.Reset(const_cast<void*>(inputs[i].data.data()),
+                          inputs[i].data.length());
+    }
+    *outputs = impl_->Submit(std::move(views)).get();
+    return true;
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "BatchingPredictor fails to run the request: " << e.what();
+    return false;
+  }
+}
+
+BatchingStats BatchingPredictor::GetStats() { return impl_->GetStats(); }
+
+}  // namespace services
+}  // namespace paddle_infer
@@ -0,0 +1,238 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle_infer {
+namespace services {
+
+class DecodeScheduler::Impl {
+ public:
+  Impl(KVCacheManager* cache_manager, int max_batch_size, int max_num_tokens)
+      : cache_manager_(cache_manager),
+        max_batch_size_(max_batch_size),
+        max_num_tokens_(max_num_tokens) {
+    PADDLE_ENFORCE_NOT_NULL(
+        cache_manager,
+        paddle::platform::errors::InvalidArgument(
+            "The cache manager of DecodeScheduler should not be null."));
+    PADDLE_ENFORCE_EQ(max_batch_size > 0 && max_batch_size <= max_num_tokens,
+                      true,
+                      paddle::platform::errors::InvalidArgument(
+                          "The max_batch_size of DecodeScheduler should be in "
+                          "[1, max_num_tokens %d], but got %d.",
+                          max_num_tokens,
+                          max_batch_size));
+  }
+
+  void AddRequest(int64_t request_id, int prompt_len, int max_new_tokens) {
+    PADDLE_ENFORCE_EQ(prompt_len > 0 && max_new_tokens > 0,
+                      true,
+                      paddle::platform::errors::InvalidArgument(
+                          "The prompt_len and max_new_tokens of a request "
+                          "should be positive, but got %d and %d.",
+                          prompt_len,
+                          max_new_tokens));
+    std::lock_guard<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_EQ(requests_.count(request_id),
+                      0,
+                      paddle::platform::errors::AlreadyExists(
+                          "The request %d is already added.", request_id));
+    Request request;
+    request.prompt_len = prompt_len;
+    request.max_new_tokens = max_new_tokens;
+    requests_.emplace(request_id, request);
+    waiting_.push_back(request_id);
+  }
+
+  DecodeStep Schedule() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DecodeStep step;
+    int budget = max_num_tokens_;
+
+    // decode the running requests in the order they were admitted, the
+    // latest ones give up their blocks if the cache is full
+    for (size_t i = 0; i < running_.size();) {
+      int64_t id = running_[i];
+      bool appended = cache_manager_->Append(id, 1);
+      while (!appended && running_.size() > i + 1) {
+        Preempt(running_.back());
+        running_.pop_back();
+        appended = cache_manager_->Append(id, 1);
+      }
+      if (!appended) {
+        // alone and still out of blocks, or beyond max_blocks_per_seq
+        LOG(WARNING) << "The request " << id
+                     << " is finished for the KV cache is full.";
+        aborted_.push_back(id);
+        running_.erase(running_.begin() + i);
+        continue;
+      }
+      step.request_ids.push_back(id);
+      step.seq_lens_encoder.push_back(0);
+      step.seq_lens_decoder.push_back(requests_.at(id).num_cached);
+      step.seq_lens_this_time.push_back(1);
+      --budget;
+      ++i;
+    }
+
+    // prefill the waiting requests in order, a prompt longer than the budget
+    // is prefilled alone
+    while (!waiting_.empty() &&
+           static_cast<int>(step.request_ids.size()) < max_batch_size_) {
+      int64_t id = waiting_.front();
+      auto& request = requests_.at(id);
+      int len = request.prefill_len();
+      if (len > budget && !step.empty()) {
+        break;
+      }
+      if (!cache_manager_->Allocate(id, len)) {
+        PADDLE_ENFORCE_EQ(
+            running_.empty(),
+            false,
+            paddle::platform::errors::ResourceExhausted(
+                "The KV cache can not hold the %d tokens of the request %d.",
+                len,
+                id));
+        break;
+      }
+      waiting_.pop_front();
+      running_.push_back(id);
+      step.request_ids.push_back(id);
+      step.seq_lens_encoder.push_back(len);
+      step.seq_lens_decoder.push_back(0);
+      step.seq_lens_this_time.push_back(len);
+      budget -= len;
+    }
+    step.num_tokens = max_num_tokens_ - budget;
+    VLOG(3) << "Schedule a decode step of " << step.request_ids.size()
+            << " requests and " << step.num_tokens << " tokens, "
+            << waiting_.size() << " requests waiting";
+    return step;
+  }
+
+  std::vector<int64_t> Update(const DecodeStep& step,
+                              const std::vector<int64_t>& eos_request_ids) {
+    std::unordered_set<int64_t> eos(eos_request_ids.begin(),
+                                    eos_request_ids.end());
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<int64_t> finished;
+    finished.swap(aborted_);
+    for (size_t i = 0; i < step.request_ids.size(); ++i) {
+      int64_t id = step.request_ids[i];
+      auto& request = requests_.at(id);
+      request.num_cached += step.seq_lens_this_time[i];
+      ++request.num_generated;
+      if (eos.count(id) || request.num_generated >= request.max_new_tokens) {
+        finished.push_back(id);
+        running_.erase(std::find(running_.begin(), running_.end(), id));
+      }
+    }
+    for (int64_t id : finished) {
+      cache_manager_->Free(id);
+      requests_.erase(id);
+    }
+    return finished;
+  }
+
+  size_t NumRequests() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_.size();
+  }
+
+  void ShareStepInputs(const DecodeStep& step, Predictor* predictor) {
+    int bsz = static_cast<int>(step.request_ids.size());
+    const std::vector<std::pair<const char*, const std::vector<int>*>>
+        inputs = {{"seq_lens_encoder", &step.seq_lens_encoder},
+                  {"seq_lens_decoder", &step.seq_lens_decoder},
+                  {"seq_lens_this_time", &step.seq_lens_this_time}};
+    for (const auto& input : inputs) {
+      auto tensor = predictor->GetInputHandle(input.first);
+      tensor->Reshape({bsz, 1});
+      tensor->CopyFromCpu(input.second->data());
+    }
+    cache_manager_->ShareBlockTables(
+        step.request_ids, predictor, "block_tables");
+  }
+
+ private:
+  struct Request {
+    int prompt_len{0};
+    int max_new_tokens{0};
+    int num_generated{0};
+    // in the cache
+    int num_cached{0};
+
+    // the prompt and the tokens generated before a preemption
+    int prefill_len() const { return prompt_len + num_generated; }
+  };
+
+  void Preempt(int64_t id) {
+    VLOG(3) << "Preempt the request " << id << " for the KV cache is full";
+    cache_manager_->Free(id);
+    requests_.at(id).num_cached = 0;
+    waiting_.push_front(id);
+  }
+
+  KVCacheManager* cache_manager_;
+  int max_batch_size_;
+  int max_num_tokens_;
+
+  std::mutex mutex_;
+  std::unordered_map<int64_t, Request> requests_;
+  std::deque<int64_t> waiting_;
+  // in the order they were admitted
+  std::vector<int64_t> running_;
+  // to be reported by the next Update
+  std::vector<int64_t> aborted_;
+};
+
+DecodeScheduler::DecodeScheduler(KVCacheManager* cache_manager,
+                                 int max_batch_size,
+                                 int max_num_tokens)
+    : impl_(new Impl(cache_manager, max_batch_size, max_num_tokens)) {}
+
+DecodeScheduler::~DecodeScheduler() = default;
+
+void DecodeScheduler::AddRequest(int64_t request_id,
+                                 int prompt_len,
+                                 int max_new_tokens) {
+  impl_->AddRequest(request_id, prompt_len, max_new_tokens);
+}
+
+DecodeStep DecodeScheduler::Schedule() { return impl_->Schedule(); }
+
+void DecodeScheduler::ShareStepInputs(const DecodeStep& step,
+                                      Predictor* predictor) {
+  impl_->ShareStepInputs(step, predictor);
+}
+
+std::vector<int64_t> DecodeScheduler::Update(
+    const DecodeStep& step, const std::vector<int64_t>& eos_request_ids) {
+  return impl_->Update(step, eos_request_ids);
+}
+
+size_t DecodeScheduler::NumRequests() { return impl_->NumRequests(); }
+
+}  // namespace services
+}  // namespace paddle_infer
@@ -0,0 +1,373 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * A benchmark of any inference model, on the configs of the backends.
+ *
+ * Each of the --threads threads runs its own predictor of a PredictorPool,
+ * --warmup times and then --repeats times, and the tool reports the
+ * distribution of the latency of a request, the QPS of all the threads, the
+ * time of feeding, running and fetching, and the GPU memory in use.
+ *
+ *   ./paddle_infer_bench --model_dir=./resnet50 --config=trt_fp16 \
+ *       --shapes="x:1,3,224,224" --threads=4 --repeats=1000
+ */
+
+#include <glog/logging.h>  // use glog instead of CHECK to avoid importing other paddle header files.
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#ifdef PADDLE_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+
+#include "gflags/gflags.h"
+#include "utils.h"  // NOLINT
+
+DEFINE_string(model_dir, "", "Directory of the inference model.");
+DEFINE_string(model_file, "", "Path of the model file, if combined.");
+DEFINE_string(params_file, "", "Path of the params file, if combined.");
+DEFINE_string(config,
+              "cpu",
+              "One of cpu, onednn, gpu, trt_fp32, trt_fp16, trt_int8 and "
+              "cinn.");
+DEFINE_string(shapes,
+              "",
+              "Shapes of the synthesized inputs, e.g. 'x:1,3,224,224;y:1,8', "
+              "the dynamic dims of the inputs not given are --batch_size.");
+DEFINE_int32(batch_size, 1, "Dynamic dims of the synthesized inputs.");
+DEFINE_string(data,
+              "",
+              "Path of the inputs instead of synthesizing them; each line is "
+              "an input, in the order of the input names, and its format is "
+              "'<space split floats as data>\t<space split ints as shape>'");
+DEFINE_int32(threads, 1, "Number of the threads sending requests.");
+DEFINE_int32(warmup, 10, "Number of the warmup runs of each thread.");
+DEFINE_int32(repeats, 100, "Number of the timed runs of each thread.");
+DEFINE_int32(cpu_threads, 1, "Number of the math library threads.");
+DEFINE_int32(gpu_id, 0, "Id of the GPU.");
+
+namespace paddle {
+namespace demo {
+
+using Clock = std::chrono::steady_clock;
+
+struct InputData {
+  std::string name;
+  paddle_infer::DataType dtype;
+  std::vector<int> shape;
+  std::vector<float> data;
+};
+
+struct RunTimes {
+  // In milliseconds, one for each timed run
+  std::vector<double> feed;
+  std::vector<double> run;
+  std::vector<double> fetch;
+  std::vector<double> latency;
+};
+
+static double ElapsedMs(const Clock::time_point& start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+paddle_infer::Config MakeConfig() {
+  paddle_infer::Config config;
+  if (!FLAGS_model_file.empty()) {
+    config.SetModel(FLAGS_model_file, FLAGS_params_file);
+  } else {
+    config.SetModel(FLAGS_model_dir);
+  }
+  config.SetCpuMathLibraryNumThreads(FLAGS_cpu_threads);
+  const std::string& name = FLAGS_config;
+  if (name == "cpu") {
+    config.DisableGpu();
+  } else if (name == "onednn") {
+    config.DisableGpu();
+    config.EnableMKLDNN();
+  } else {
+    config.EnableUseGpu(256, FLAGS_gpu_id);
+    if (name == "trt_fp32" || name == "trt_fp16" || name == "trt_int8") {
+      auto precision = paddle_infer::PrecisionType::kFloat32;
+      if (name == "trt_fp16") {
+        precision = paddle_infer::PrecisionType::kHalf;
+      } else if (name == "trt_int8") {
+        precision = paddle_infer::PrecisionType::kInt8;
+      }
+      config.EnableTensorRtEngine(
+          1 << 30, FLAGS_batch_size, 3, precision, false, false);
+    } else if (name == "cinn") {
+      config.EnableCINN();
+    } else {
+      CHECK_EQ(name, "gpu") << "Unknown config " << name;
+    }
+  }
+  return config;
+}
+
+static std::map<std::string, std::vector<int>> ParseShapes(
+    const std::string& shapes) {
+  std::map<std::string, std::vector<int>> result;
+  std::vector<std::string> inputs;
+  split(shapes, ';', &inputs);
+  for (auto& input : inputs) {
+    std::vector<std::string> name_and_dims, dims;
+    split(input, ':', &name_and_dims);
+    CHECK_EQ(name_and_dims.size(), 2UL)
+        << "shape format error, should be <name>:<dims>";
+    split(name_and_dims[1], ',', &dims);
+    for (auto& dim : dims) {
+      result[name_and_dims[0]].push_back(std::stoi(dim));
+    }
+  }
+  return result;
+}
+
+std::vector<InputData> PrepareInputs(paddle_infer::Predictor* predictor) {
+  auto names = predictor->GetInputNames();
+  auto dtypes = predictor->GetInputTypes();
+  auto model_shapes = predictor->GetInputTensorShape();
+  auto shapes = ParseShapes(FLAGS_shapes);
+
+  std::vector<InputData> inputs;
+  std::ifstream file;
+  if (!FLAGS_data.empty()) {
+    file.open(FLAGS_data);
+    CHECK(file.is_open()) << "Failed to open " << FLAGS_data;
+  }
+  for (auto& name : names) {
+    InputData input;
+    input.name = name;
+    input.dtype = dtypes[name];
+    if (file.is_open()) {
+      std::string line;
+      CHECK(std::getline(file, line)) << "No data of input " << name;
+      auto record = ProcessALine(line);
+      input.shape = record.shape;
+      input.data = std::move(record.data);
+    } else {
+      if (shapes.count(name)) {
+        input.shape = shapes[name];
+      } else {
+        for (auto dim : model_shapes[name]) {
+          input.shape.push_back(dim < 0 ? FLAGS_batch_size : dim);
+        }
+      }
+      int64_t numel = std::accumulate(input.shape.begin(),
+                                      input.shape.end(),
+                                      int64_t{1},
+                                      std::multiplies<int64_t>());
+      // small integers, valid as ids of the embedding inputs as well
+      input.data.resize(numel);
+      for (int64_t i = 0; i < numel; ++i) {
+        input.data[i] = static_cast<float>(i % 8);
+      }
+    }
+    inputs.push_back(std::move(input));
+  }
+  return inputs;
+}
+
+template <typename T>
+static void CopyFromCpuAs(paddle_infer::Tensor* tensor,
+                          const std::vector<float>& data) {
+  std::vector<T> casted(data.begin(), data.end());
+  tensor->CopyFromCpu(casted.data());
+}
+
+void Feed(paddle_infer::Predictor* predictor,
+          const std::vector<InputData>& inputs) {
+  for (auto& input : inputs) {
+    auto tensor = predictor->GetInputHandle(input.name);
+    tensor->Reshape(input.shape);
+    switch (input.dtype) {
+      case paddle_infer::DataType::FLOAT32:
+        tensor->CopyFromCpu(input.data.data());
+        break;
+      case paddle_infer::DataType::INT64:
+        CopyFromCpuAs<int64_t>(tensor.get(), input.data);
+        break;
+      case paddle_infer::DataType::INT32:
+        CopyFromCpuAs<int32_t>(tensor.get(), input.data);
+        break;
+      case paddle_infer::DataType::INT8:
+        CopyFromCpuAs<int8_t>(tensor.get(), input.data);
+        break;
+      case paddle_infer::DataType::UINT8:
+        CopyFromCpuAs<uint8_t>(tensor.get(), input.data);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported dtype of input " << input.name;
+    }
+  }
+}
+
+void Fetch(paddle_infer::Predictor* predictor,
+           std::vector<std::vector<char>>* outputs) {
+  auto names = predictor->GetOutputNames();
+  outputs->resize(names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    auto tensor = predictor->GetOutputHandle(names[i]);
+    auto shape = tensor->shape();
+    int64_t numel = std::accumulate(
+        shape.begin(), shape.end(), int64_t{1}, std::multiplies<int64_t>());
+    auto& buffer = (*outputs)[i];
+    switch (tensor->type()) {
+      case paddle_infer::DataType::FLOAT32:
+        buffer.resize(numel * sizeof(float));
+        tensor->CopyToCpu(reinterpret_cast<float*>(buffer.data()));
+        break;
+      case paddle_infer::DataType::INT64:
+        buffer.resize(numel * sizeof(int64_t));
+        tensor->CopyToCpu(reinterpret_cast<int64_t*>(buffer.data()));
+        break;
+      case paddle_infer::DataType::INT32:
+        buffer.resize(numel * sizeof(int32_t));
+        tensor->CopyToCpu(reinterpret_cast<int32_t*>(buffer.data()));
+        break;
+      case paddle_infer::DataType::INT8:
+        buffer.resize(numel * sizeof(int8_t));
+        tensor->CopyToCpu(reinterpret_cast<int8_t*>(buffer.data()));
+        break;
+      case paddle_infer::DataType::UINT8:
+        buffer.resize(numel * sizeof(uint8_t));
+        tensor->CopyToCpu(reinterpret_cast<uint8_t*>(buffer.data()));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported dtype of output " << names[i];
+    }
+  }
+}
+
+void RunThread(paddle_infer::Predictor* predictor,
+               const std::vector<InputData>& inputs,
+               RunTimes* times) {
+  std::vector<std::vector<char>> outputs;
+  for (int i = 0; i < FLAGS_warmup + FLAGS_repeats; ++i) {
+    auto start = Clock::now();
+    Feed(predictor, inputs);
+    double feed = ElapsedMs(start);
+    auto run_start = Clock::now();
+    CHECK(predictor->Run()) << "Failed to run the predictor";
+    double run = ElapsedMs(run_start);
+    auto fetch_start = Clock::now();
+    // CopyToCpu waits for the device, so the fetch time includes the kernels
+    // still running after Run returns.
+    Fetch(predictor, &outputs);
+    double fetch = ElapsedMs(fetch_start);
+    if (i >= FLAGS_warmup) {
+      times->feed.push_back(feed);
+      times->run.push_back(run);
+      times->fetch.push_back(fetch);
+      times->latency.push_back(ElapsedMs(start));
+    }
+  }
+}
+
+static double Percentile(const std::vector<double>& sorted, double p) {
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+static double Mean(const std::vector<double>& times) {
+  return std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+}
+
+static std::string GpuMemory() {
+#ifdef PADDLE_WITH_CUDA
+  if (FLAGS_config != "cpu" && FLAGS_config != "onednn") {
+    size_t free = 0, total = 0;
+    cudaSetDevice(FLAGS_gpu_id);
+    if (cudaMemGetInfo(&free, &total) == cudaSuccess) {
+      return std::to_string((total - free) >> 20) + " MB";
+    }
+  }
+#endif
+  return "N/A";
+}
+
+void Main() {
+  CHECK_GT(FLAGS_threads, 0);
+  CHECK_GT(FLAGS_repeats, 0);
+  auto config = MakeConfig();
+  paddle_infer::services::PredictorPool pool(config, FLAGS_threads);
+  auto inputs = PrepareInputs(pool.Retrieve(0));
+
+  std::vector<RunTimes> times(FLAGS_threads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < FLAGS_threads; ++i) {
+    threads.emplace_back(
+        RunThread, pool.Retrieve(i), std::cref(inputs), &times[i]);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // The QPS excludes the warmup runs, so it is over the timed runs of the
+  // slowest thread.
+  double wall_ms = 0;
+  for (auto& thread_times : times) {
+    wall_ms = std::max(wall_ms,
+                       std::accumulate(thread_times.latency.begin(),
+                                       thread_times.latency.end(),
+                                       0.0));
+  }
+
+  RunTimes all;
+  for (auto& thread_times : times) {
+    all.feed.insert(
+        all.feed.end(), thread_times.feed.begin(), thread_times.feed.end());
+    all.run.insert(
+        all.run.end(), thread_times.run.begin(), thread_times.run.end());
+    all.fetch.insert(
+        all.fetch.end(), thread_times.fetch.begin(), thread_times.fetch.end());
+    all.latency.insert(all.latency.end(),
+                       thread_times.latency.begin(),
+                       thread_times.latency.end());
+  }
+  std::sort(all.latency.begin(), all.latency.end());
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "config: " << FLAGS_config << ", threads: " << FLAGS_threads
+            << ", runs: " << all.latency.size() << std::endl;
+  std::cout << "latency(ms): mean " << Mean(all.latency) << ", p50 "
+            << Percentile(all.latency, 0.5) << ", p90 "
+            << Percentile(all.latency, 0.9) << ", p99 "
+            << Percentile(all.latency, 0.99) << ", p999 "
+            << Percentile(all.latency, 0.999) << ", max "
+            << all.latency.back() << std::endl;
+  std::cout << "breakdown(ms): feed " << Mean(all.feed) << ", run "
+            << Mean(all.run) << ", fetch " << Mean(all.fetch) << std::endl;
+  std::cout << "qps: " << all.latency.size() * 1000.0 / wall_ms << std::endl;
+  std::cout << "gpu memory: " << GpuMemory() << std::endl;
+}
+
+}  // namespace demo
+}  // namespace paddle
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  paddle::demo::Main();
+  return 0;
+}
@@ -253,6 +253,33 @@ for WITH_STATIC_LIB in ON OFF; do
         fi
       done
     done
+    # --------paddle_infer_bench on linux/mac------
+    rm -rf *
+    cmake .. -DPADDLE_LIB=${inference_install_dir} \
+      -DWITH_MKL=$TURN_ON_MKL \
+      -DDEMO_NAME=paddle_infer_bench \
+      -DWITH_GPU=$TEST_GPU_CPU \
+      -DWITH_STATIC_LIB=$WITH_STATIC_LIB \
+      -DWITH_ONNXRUNTIME=$WITH_ONNXRUNTIME
+    make -j$(nproc)
+    bench_config_list='cpu'
+    if [ $TEST_GPU_CPU == ON ]; then
+      bench_config_list='cpu gpu'
+    fi
+    for bench_config in $bench_config_list; do
+      ./paddle_infer_bench \
+        --model_file=$DATA_DIR/mobilenet/model/__model__ \
+        --params_file=$DATA_DIR/mobilenet/model/__params__ \
+        --data=$DATA_DIR/mobilenet/data.txt \
+        --config=$bench_config \
+        --threads=2 \
+        --warmup=2 \
+        --repeats=10
+      if [ $? -ne 0 ]; then
+        echo "paddle_infer_bench config:${bench_config} runs failed " >> ${current_dir}/test_summary.txt
+        EXIT_CODE=1
+      fi
+    done
     # --------tensorrt mobilenet on linux/mac------
     if [ $USE_TENSORRT == ON -a $TEST_GPU_CPU == ON ]; then
       rm -rf *
@@ -809,10 +809,24 @@ void Tensor::ORTCopyToCpu(T *data) const {
 
   if (place_ == PlaceType::kCPU) {
     std::memcpy(static_cast<void *>(data), value.GetTensorData<void *>(), size);
-  } else {
+  } else if (place_ == PlaceType::kGPU) {
+#if defined(PADDLE_WITH_CUDA)
+    // the run has synchronized the stream of the session
+    paddle::memory::Copy(paddle::platform::CPUPlace(),
+                         static_cast<void *>(data),
+                         paddle::platform::CUDAPlace(device_),
+                         value.GetTensorData<void>(),
+                         size,
+                         nullptr);
+#else
     PADDLE_THROW(paddle::platform::errors::Unavailable(
         "CopyToCpu error.The current ONNXRuntime backend doesn't support "
         "GPU."));
+#endif
+  } else {
+    PADDLE_THROW(paddle::platform::errors::Unavailable(
+        "CopyToCpu error.The current ONNXRuntime backend only supports CPU "
+        "and GPU."));
   }
 }
 
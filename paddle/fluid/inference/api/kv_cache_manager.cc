@@ -0,0 +1,397 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/float16.h"
+#include "paddle/fluid/platform/place.h"
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/common/bfloat16.h"
+
+namespace paddle_infer {
+namespace services {
+
+class KVCacheManager::Impl {
+ public:
+  Impl(int num_caches,
+       int num_blocks,
+       int block_size,
+       int num_heads,
+       int head_dim,
+       DataType dtype,
+       int max_seqs,
+       int max_blocks_per_seq,
+       int device_id,
+       void* stream)
+      : num_blocks_(num_blocks),
+        block_size_(block_size),
+        num_heads_(num_heads),
+        head_dim_(head_dim),
+        dtype_(dtype),
+        max_seqs_(max_seqs),
+        max_blocks_per_seq_(max_blocks_per_seq),
+        place_(device_id),
+        stream_(stream),
+        ref_counts_(num_blocks, 0) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    PADDLE_ENFORCE_EQ(
+        num_caches > 0 && num_blocks > 0 && block_size > 0 && num_heads > 0 &&
+            head_dim > 0 && max_seqs > 0 && max_blocks_per_seq > 0,
+        true,
+        paddle::platform::errors::InvalidArgument(
+            "The sizes of KVCacheManager should be positive."));
+    block_bytes_ = static_cast<size_t>(num_heads) * block_size * head_dim *
+                   GetNumBytesOfDataType(dtype);
+    for (int i = 0; i < num_caches; ++i) {
+      caches_.push_back(
+          paddle::memory::Alloc(place_, num_blocks * block_bytes_));
+    }
+    block_tables_ = paddle::memory::Alloc(
+        place_, sizeof(int32_t) * max_seqs * max_blocks_per_seq);
+    host_block_tables_.resize(static_cast<size_t>(max_seqs) *
+                              max_blocks_per_seq);
+    // the lowest blocks first
+    for (int i = num_blocks - 1; i >= 0; --i) {
+      free_blocks_.push_back(i);
+    }
+    VLOG(3) << "KVCacheManager of " << num_caches << " caches of "
+            << num_blocks << " blocks of " << block_bytes_ << " bytes on "
+            << place_;
+#else
+    PADDLE_THROW(paddle::platform::errors::Unavailable(
+        "KVCacheManager needs Paddle compiled with CUDA or HIP."));
+#endif
+  }
+
+  void BindCaches(Predictor* predictor,
+                  const std::vector<std::string>& cache_names) {
+    PADDLE_ENFORCE_EQ(cache_names.size(),
+                      caches_.size(),
+                      paddle::platform::errors::InvalidArgument(
+                          "Expected %d cache names, but received %d.",
+                          caches_.size(),
+                          cache_names.size()));
+    std::vector<int> shape = {num_blocks_, num_heads_, block_size_, head_dim_};
+    for (size_t i = 0; i < caches_.size(); ++i) {
+      auto tensor = predictor->GetInputHandle(cache_names[i]);
+      void* data = caches_[i]->ptr();
+      switch (dtype_) {
+        case DataType::FLOAT32:
+          tensor->ShareExternalData(
+              static_cast<float*>(data), shape, PlaceType::kGPU);
+          break;
+        case DataType::FLOAT16:
+          tensor->ShareExternalData(
+              static_cast<paddle::platform::float16*>(data),
+              shape,
+              PlaceType::kGPU);
+          break;
+        case DataType::BFLOAT16:
+          tensor->ShareExternalData(
+              static_cast<phi::dtype::bfloat16*>(data), shape, PlaceType::kGPU);
+          break;
+        case DataType::INT8:
+          tensor->ShareExternalData(
+              static_cast<int8_t*>(data), shape, PlaceType::kGPU);
+          break;
+        case DataType::UINT8:
+          tensor->ShareExternalData(
+              static_cast<uint8_t*>(data), shape, PlaceType::kGPU);
+          break;
+        default:
+          PADDLE_THROW(paddle::platform::errors::Unimplemented(
+              "Unsupported data type %d of the KV cache.",
+              static_cast<int>(dtype_)));
+      }
+    }
+  }
+
+  bool Allocate(int64_t seq_id, int num_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_EQ(seqs_.count(seq_id),
+                      0,
+                      paddle::platform::errors::AlreadyExists(
+                          "The sequence %d is already allocated.", seq_id));
+    int num_blocks = NumBlocksOf(num_tokens);
+    if (num_blocks > max_blocks_per_seq_ ||
+        num_blocks > static_cast<int>(free_blocks_.size())) {
+      return false;
+    }
+    auto& seq = seqs_[seq_id];
+    seq.num_tokens = num_tokens;
+    for (int i = 0; i < num_blocks; ++i) {
+      seq.blocks.push_back(PopFreeBlock());
+    }
+    return true;
+  }
+
+  bool Append(int64_t seq_id, int num_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& seq = GetSequence(seq_id);
+    int num_blocks = NumBlocksOf(seq.num_tokens + num_tokens);
+    // the tokens are written to the partial last block first, which is
+    // copied if shared
+    bool copy_on_write = seq.num_tokens % block_size_ != 0 &&
+                         !seq.blocks.empty() &&
+                         ref_counts_[seq.blocks.back()] > 1;
+    int num_new_blocks = num_blocks - static_cast<int>(seq.blocks.size()) +
+                         (copy_on_write ? 1 : 0);
+    if (num_blocks > max_blocks_per_seq_ ||
+        num_new_blocks > static_cast<int>(free_blocks_.size())) {
+      return false;
+    }
+    if (copy_on_write) {
+      int src = seq.blocks.back();
+      int dst = PopFreeBlock();
+      CopyBlock(src, dst);
+      --ref_counts_[src];
+      seq.blocks.back() = dst;
+    }
+    while (static_cast<int>(seq.blocks.size()) < num_blocks) {
+      seq.blocks.push_back(PopFreeBlock());
+    }
+    seq.num_tokens += num_tokens;
+    return true;
+  }
+
+  void Fork(int64_t parent_id, int64_t child_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_EQ(seqs_.count(child_id),
+                      0,
+                      paddle::platform::errors::AlreadyExists(
+                          "The sequence %d is already allocated.", child_id));
+    Sequence child = GetSequence(parent_id);
+    for (int block : child.blocks) {
+      ++ref_counts_[block];
+    }
+    seqs_.emplace(child_id, std::move(child));
+  }
+
+  void Rollback(int64_t seq_id, int num_tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& seq = GetSequence(seq_id);
+    PADDLE_ENFORCE_LE(num_tokens,
+                      seq.num_tokens,
+                      paddle::platform::errors::InvalidArgument(
+                          "Can not roll back %d tokens of the sequence %d "
+                          "of %d tokens.",
+                          num_tokens,
+                          seq_id,
+                          seq.num_tokens));
+    seq.num_tokens -= num_tokens;
+    int num_blocks = NumBlocksOf(seq.num_tokens);
+    while (static_cast<int>(seq.blocks.size()) > num_blocks) {
+      ReleaseBlock(seq.blocks.back());
+      seq.blocks.pop_back();
+    }
+  }
+
+  void Free(int64_t seq_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& seq = GetSequence(seq_id);
+    for (int block : seq.blocks) {
+      ReleaseBlock(block);
+    }
+    seqs_.erase(seq_id);
+  }
+
+  int NumFreeBlocks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(free_blocks_.size());
+  }
+
+  std::vector<int> GetBlockTable(int64_t seq_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = seqs_.find(seq_id);
+    PADDLE_ENFORCE_NE(iter,
+                      seqs_.end(),
+                      paddle::platform::errors::NotFound(
+                          "The sequence %d is not allocated.", seq_id));
+    return iter->second.blocks;
+  }
+
+  void ShareBlockTables(const std::vector<int64_t>& seq_ids,
+                        Predictor* predictor,
+                        const std::string& name) {
+    PADDLE_ENFORCE_LE(seq_ids.size(),
+                      static_cast<size_t>(max_seqs_),
+                      paddle::platform::errors::InvalidArgument(
+                          "The number of sequences %d exceeds max_seqs %d.",
+                          seq_ids.size(),
+                          max_seqs_));
+    size_t numel = seq_ids.size() * max_blocks_per_seq_;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::fill(host_block_tables_.begin(),
+                host_block_tables_.begin() + numel,
+                -1);
+      for (size_t i = 0; i < seq_ids.size(); ++i) {
+        const auto& blocks = GetSequence(seq_ids[i]).blocks;
+        std::copy(blocks.begin(),
+                  blocks.end(),
+                  host_block_tables_.begin() + i * max_blocks_per_seq_);
+      }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      // from pageable memory, the host buffer is reusable on return
+      paddle::memory::Copy(place_,
+                           block_tables_->ptr(),
+                           paddle::platform::CPUPlace(),
+                           host_block_tables_.data(),
+                           sizeof(int32_t) * numel,
+                           static_cast<phi::gpuStream_t>(stream_));
+#endif
+    }
+    auto tensor = predictor->GetInputHandle(name);
+    tensor->ShareExternalData(
+        static_cast<int32_t*>(block_tables_->ptr()),
+        {static_cast<int>(seq_ids.size()), max_blocks_per_seq_},
+        PlaceType::kGPU);
+  }
+
+ private:
+  struct Sequence {
+    std::vector<int> blocks;
+    int num_tokens{0};
+  };
+
+  int NumBlocksOf(int num_tokens) const {
+    return (num_tokens + block_size_ - 1) / block_size_;
+  }
+
+  Sequence& GetSequence(int64_t seq_id) {
+    auto iter = seqs_.find(seq_id);
+    PADDLE_ENFORCE_NE(iter,
+                      seqs_.end(),
+                      paddle::platform::errors::NotFound(
+                          "The sequence %d is not allocated.", seq_id));
+    return iter->second;
+  }
+
+  int PopFreeBlock() {
+    int block = free_blocks_.back();
+    free_blocks_.pop_back();
+    ref_counts_[block] = 1;
+    return block;
+  }
+
+  void ReleaseBlock(int block) {
+    if (--ref_counts_[block] == 0) {
+      free_blocks_.push_back(block);
+    }
+  }
+
+  void CopyBlock(int src, int dst) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    for (auto& cache : caches_) {
+      auto* data = static_cast<char*>(cache->ptr());
+      paddle::memory::Copy(place_,
+                           data + dst * block_bytes_,
+                           place_,
+                           data + src * block_bytes_,
+                           block_bytes_,
+                           static_cast<phi::gpuStream_t>(stream_));
+    }
+#endif
+  }
+
+  int num_blocks_;
+  int block_size_;
+  int num_heads_;
+  int head_dim_;
+  DataType dtype_;
+  int max_seqs_;
+  int max_blocks_per_seq_;
+  paddle::platform::CUDAPlace place_;
+  void* stream_;
+  size_t block_bytes_{0};
+
+  std::vector<paddle::memory::AllocationPtr> caches_;
+  paddle::memory::AllocationPtr block_tables_;
+  std::vector<int32_t> host_block_tables_;
+
+  mutable std::mutex mutex_;
+  // by the sequences sharing them
+  std::vector<int> ref_counts_;
+  std::vector<int> free_blocks_;
+  std::unordered_map<int64_t, Sequence> seqs_;
+};
+
+KVCacheManager::KVCacheManager(int num_caches,
+                               int num_blocks,
+                               int block_size,
+                               int num_heads,
+                               int head_dim,
+                               DataType dtype,
+                               int max_seqs,
+                               int max_blocks_per_seq,
+                               int device_id,
+                               void* stream)
+    : impl_(new Impl(num_caches,
+                     num_blocks,
+                     block_size,
+                     num_heads,
+                     head_dim,
+                     dtype,
+                     max_seqs,
+                     max_blocks_per_seq,
+                     device_id,
+                     stream)) {}
+
+KVCacheManager::~KVCacheManager() = default;
+
+void KVCacheManager::BindCaches(Predictor* predictor,
+                                const std::vector<std::string>& cache_names) {
+  impl_->BindCaches(predictor, cache_names);
+}
+
+bool KVCacheManager::Allocate(int64_t seq_id, int num_tokens) {
+  return impl_->Allocate(seq_id, num_tokens);
+}
+
+bool KVCacheManager::Append(int64_t seq_id, int num_tokens) {
+  return impl_->Append(seq_id, num_tokens);
+}
+
+void KVCacheManager::Fork(int64_t parent_id, int64_t child_id) {
+  impl_->Fork(parent_id, child_id);
+}
+
+void KVCacheManager::Rollback(int64_t seq_id, int num_tokens) {
+  impl_->Rollback(seq_id, num_tokens);
+}
+
+void KVCacheManager::Free(int64_t seq_id) { impl_->Free(seq_id); }
+
+int KVCacheManager::NumFreeBlocks() const { return impl_->NumFreeBlocks(); }
+
+std::vector<int> KVCacheManager::GetBlockTable(int64_t seq_id) const {
+  return impl_->GetBlockTable(seq_id);
+}
+
+void KVCacheManager::ShareBlockTables(const std::vector<int64_t>& seq_ids,
+                                      Predictor* predictor,
+                                      const std::string& name) {
+  impl_->ShareBlockTables(seq_ids, predictor, name);
+}
+
+}  // namespace services
+}  // namespace paddle_infer
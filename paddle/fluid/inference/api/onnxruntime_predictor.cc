@@ -35,6 +35,8 @@
 #include "paddle/fluid/memory/memcpy.h"
 #include "paddle/fluid/platform/cpu_helper.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/init.h"
 #include "paddle/fluid/platform/place.h"
 #include "paddle/fluid/platform/profiler.h"
 
@@ -60,6 +62,33 @@ paddle_infer::DataType ConvertONNXType(ONNXTensorElementDataType type) {
   }
 }
 
+static phi::DataType ConvertONNXTypeToPhi(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return phi::DataType::FLOAT32;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+      return phi::DataType::FLOAT16;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+      return phi::DataType::INT8;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+      return phi::DataType::INT32;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+      return phi::DataType::INT64;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return phi::DataType::UINT8;
+    default:
+      return phi::DataType::UNDEFINED;
+  }
+}
+
+#if defined(PADDLE_WITH_CUDA)
+static gpuStream_t GetSessionStream(const platform::Place &place) {
+  return static_cast<phi::GPUContext *>(
+             platform::DeviceContextPool::Instance().Get(place))
+      ->stream();
+}
+#endif
+
 bool CheckConvertToONNX(const AnalysisConfig &config) {
   if (!config.model_dir().empty()) {
     LOG(ERROR) << "Paddle2ONNX not support model_dir config";
@@ -129,6 +158,9 @@ bool ONNXRuntimePredictor::InitBinding() {
         type_info.GetTensorTypeAndShapeInfo().GetElementType();
     output_desc_.emplace_back(ONNXDesc{output_name, shape, data_type});
 
+    auto *ptr = scope_->Var(output_name);
+    framework::InitializeVariable(ptr, proto_type);
+
     Ort::MemoryInfo out_memory_info(device_name,
                                     OrtDeviceAllocator,
                                     place_.GetDeviceId(),
@@ -170,6 +202,20 @@ bool ONNXRuntimePredictor::Init() {
   // session_options.EnableMemPattern();
   // session_options.SetInterOpNumThreads(config_.cpu_math_library_num_threads());
   session_options.SetIntraOpNumThreads(config_.cpu_math_library_num_threads());
+#if defined(PADDLE_WITH_CUDA)
+  if (config_.use_gpu()) {
+    // the session runs on the stream of Paddle, so it reads the inputs and
+    // writes the outputs in place on the device
+    paddle::framework::InitMemoryMethod();
+    paddle::framework::InitDevices();
+    OrtCUDAProviderOptions cuda_options;
+    cuda_options.device_id = config_.gpu_device_id();
+    cuda_options.has_user_compute_stream = 1;
+    cuda_options.user_compute_stream =
+        GetSessionStream(platform::CUDAPlace(config_.gpu_device_id()));
+    session_options.AppendExecutionProvider_CUDA(cuda_options);
+  }
+#endif
   VLOG(2) << "ONNXRuntime threads " << config_.cpu_math_library_num_threads();
   if (config_.profile_enabled()) {
     LOG(WARNING) << "ONNXRuntime Profiler is activated, which might affect the "
@@ -333,23 +379,91 @@ bool ONNXRuntimePredictor::Run(const std::vector<PaddleTensor> &inputs,
   return false;
 }
 
+bool ONNXRuntimePredictor::BindPreallocatedOutputs(
+    const std::vector<std::vector<int64_t>> &input_shapes,
+    std::vector<Ort::Value> *outputs) {
+  auto it = output_shapes_.find(input_shapes);
+  if (!preallocate_outputs_ || it == output_shapes_.end()) {
+    return false;
+  }
+  for (const auto &desc : output_desc_) {
+    if (ConvertONNXTypeToPhi(desc.dtype) == phi::DataType::UNDEFINED) {
+      return false;
+    }
+  }
+  const char *device_name = platform::is_cpu_place(place_) ? "Cpu" : "Cuda";
+  Ort::MemoryInfo memory_info(
+      device_name, OrtDeviceAllocator, place_.GetDeviceId(), OrtMemTypeDefault);
+  outputs->reserve(output_desc_.size());
+  for (size_t i = 0; i < output_desc_.size(); ++i) {
+    const auto &desc = output_desc_[i];
+    const auto &shape = it->second[i];
+    // the tensors keep their allocations across the runs and only grow
+    auto *tensor = scope_->Var(desc.name)->GetMutable<phi::DenseTensor>();
+    auto dtype = ConvertONNXTypeToPhi(desc.dtype);
+    tensor->Resize(common::make_ddim(shape));
+    void *data = tensor->mutable_data(place_, dtype);
+    outputs->push_back(
+        Ort::Value::CreateTensor(memory_info,
+                                 data,
+                                 tensor->numel() * phi::SizeOf(dtype),
+                                 shape.data(),
+                                 shape.size(),
+                                 desc.dtype));
+    binding_->BindOutput(desc.name.c_str(), outputs->back());
+  }
+  return true;
+}
+
 bool ONNXRuntimePredictor::ZeroCopyRun(bool switch_stream) {
   try {
     const char *device_name = platform::is_cpu_place(place_) ? "Cpu" : "Cuda";
     std::vector<Ort::Value> inputs;
+    std::vector<std::vector<int64_t>> input_shapes;
     inputs.reserve(input_desc_.size());
     for (auto desc : input_desc_) {
       inputs.push_back(GetOrtValue(desc, device_name));
+      input_shapes.push_back(
+          inputs.back().GetTensorTypeAndShapeInfo().GetShape());
       binding_->BindInput(desc.name.c_str(), inputs.back());
     }
-    for (auto output : output_desc_) {
-      Ort::MemoryInfo out_memory_info(device_name,
-                                      OrtDeviceAllocator,
-                                      place_.GetDeviceId(),
-                                      OrtMemTypeDefault);
-      binding_->BindOutput(output.name.c_str(), out_memory_info);
+    auto bind_device_outputs = [&]() {
+      for (auto output : output_desc_) {
+        Ort::MemoryInfo out_memory_info(device_name,
+                                        OrtDeviceAllocator,
+                                        place_.GetDeviceId(),
+                                        OrtMemTypeDefault);
+        binding_->BindOutput(output.name.c_str(), out_memory_info);
+      }
+    };
+    std::vector<Ort::Value> outputs;
+    if (BindPreallocatedOutputs(input_shapes, &outputs)) {
+      try {
+        session_->Run({}, *(binding_.get()));
+      } catch (const Ort::Exception &e) {
+        LOG(WARNING) << "ONNXRuntime rejects the preallocated outputs, and "
+                        "they are not preallocated any more: "
+                     << e.what();
+        preallocate_outputs_ = false;
+        output_shapes_.clear();
+        bind_device_outputs();
+        session_->Run({}, *(binding_.get()));
+      }
+    } else {
+      bind_device_outputs();
+      session_->Run({}, *(binding_.get()));
+      if (preallocate_outputs_) {
+        std::vector<std::vector<int64_t>> output_shapes;
+        for (auto &value : binding_->GetOutputValues()) {
+          output_shapes.push_back(value.GetTensorTypeAndShapeInfo().GetShape());
+        }
+        // bound the memory of the shapes of a model with dynamic shapes
+        if (output_shapes_.size() >= 64) {
+          output_shapes_.clear();
+        }
+        output_shapes_[input_shapes] = std::move(output_shapes);
+      }
     }
-    session_->Run({}, *(binding_.get()));
   } catch (const std::exception &e) {
     LOG(ERROR) << e.what();
     return false;
@@ -358,6 +472,29 @@ bool ONNXRuntimePredictor::ZeroCopyRun(bool switch_stream) {
   return true;
 }
 
+#if defined(PADDLE_WITH_CUDA)
+bool ONNXRuntimePredictor::ExpRunWithExternalStream(const gpuStream_t stream) {
+  PADDLE_ENFORCE_EQ(platform::is_gpu_place(place_),
+                    true,
+                    platform::errors::PreconditionNotMet(
+                        "ExpRunWithExternalStream of ONNXRuntimePredictor "
+                        "needs the predictor to use GPU."));
+  gpuStream_t session_stream = GetSessionStream(place_);
+  if (stream != session_stream) {
+    if (stream_event_ == nullptr) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaEventCreateWithFlags(&stream_event_, cudaEventDisableTiming));
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(stream_event_, stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaStreamWaitEvent(session_stream, stream_event_, 0));
+  }
+  // ONNXRuntime synchronizes its stream at the end of a run, so the outputs
+  // are ready for stream once it returns
+  return ZeroCopyRun(false);
+}
+#endif
+
 std::unique_ptr<PaddlePredictor> ONNXRuntimePredictor::Clone(void *stream) {
   std::lock_guard<std::mutex> lk(clone_mutex_);
   auto *x = new ONNXRuntimePredictor(config_, env_, session_);
@@ -372,6 +509,11 @@ uint64_t ONNXRuntimePredictor::TryShrinkMemory() {
 ONNXRuntimePredictor::~ONNXRuntimePredictor() {
   binding_->ClearBoundInputs();
   binding_->ClearBoundOutputs();
+#if defined(PADDLE_WITH_CUDA)
+  if (stream_event_ != nullptr) {
+    cudaEventDestroy(stream_event_);
+  }
+#endif
 
   memory::Release(place_);
 }
@@ -180,6 +180,19 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   ///
   bool ZeroCopyRun(bool switch_stream = false) override;
 
+#if defined(PADDLE_WITH_CUDA)
+  ///
+  /// \brief Run the prediction engine after the work queued on stream, and
+  /// make stream wait for the prediction. The session runs on the stream of
+  /// the predictor, which is ordered after stream by an event.
+  ///
+  /// \param stream the stream the inputs are produced and the outputs are
+  /// consumed on
+  /// \return Whether the function executed successfully
+  ///
+  bool ExpRunWithExternalStream(const gpuStream_t stream);
+#endif
+
   ///
   /// \brief Release all tmp tensor to compress the size of the memory pool.
   /// The memory pool is considered to be composed of a list of chunks, if
@@ -224,6 +237,19 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   ///
   Ort::Value GetOrtValue(const ONNXDesc &desc, const char *device_name);
 
+  /// \brief Bind the outputs to the tensors of the scope allocated by
+  /// Paddle, if the output shapes of the input shapes are known.
+  ///
+  /// \param[in] input_shapes the shapes of the inputs of this run
+  ///
+  /// \param[out] outputs the Ort Values over the output tensors
+  ///
+  /// \return Whether the outputs are bound to preallocated tensors
+  ///
+  bool BindPreallocatedOutputs(
+      const std::vector<std::vector<int64_t>> &input_shapes,
+      std::vector<Ort::Value> *outputs);
+
  private:
   // ONNXRuntime
   std::shared_ptr<Ort::Env> env_;
@@ -235,6 +261,17 @@ class ONNXRuntimePredictor : public PaddlePredictor {
   platform::Place place_;
   std::vector<ONNXDesc> input_desc_;
   std::vector<ONNXDesc> output_desc_;
+  // the output shapes the session produced for the input shapes, to bind
+  // the outputs to preallocated tensors the next time
+  std::map<std::vector<std::vector<int64_t>>,
+           std::vector<std::vector<int64_t>>>
+      output_shapes_;
+  // turned off once a preallocated output mismatches the session, whose
+  // output shapes depend on more than the input shapes
+  bool preallocate_outputs_{true};
+#if defined(PADDLE_WITH_CUDA)
+  cudaEvent_t stream_event_{nullptr};
+#endif
   int predictor_id_;
 
 // Some more detailed tests, they are made the friends of the predictor, so that
@@ -580,6 +580,27 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   float fraction_of_gpu_memory_for_pool() const;
 
+  ///
+  /// \brief Limit the GPU memory the predictor allocates, out of the memory
+  /// pool shared by all the predictors of the device. It makes the predictor
+  /// run on a stream of its own, if no stream is set by SetExecStream.
+  ///
+  /// When a run of a predictor goes beyond its soft quota, or the device
+  /// runs out of memory, the idle predictors of the device release the
+  /// intermediate tensors they keep and the TensorRT context memory shared
+  /// by their engines.
+  ///
+  /// \param quota_mb the quota in MB, 0 for no quota.
+  /// \param hard_quota whether an allocation beyond the quota fails rather
+  /// than goes on.
+  ///
+  void SetGpuMemoryQuota(uint64_t quota_mb, bool hard_quota = true) {
+    gpu_memory_quota_mb_ = quota_mb;
+    gpu_memory_quota_hard_ = hard_quota;
+  }
+  uint64_t gpu_memory_quota_mb() const { return gpu_memory_quota_mb_; }
+  bool gpu_memory_quota_hard() const { return gpu_memory_quota_hard_; }
+
   // CUDNN related.
   ///
   /// \brief Turn on CUDNN.
@@ -805,6 +826,48 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool shape_range_info_collected() const;
 
+  ///
+  /// \brief Pad the input of input_name with zeros along axis to the smallest
+  /// bucket boundary not less than its size, so that the requests of varying
+  /// shapes run with the few shapes of the buckets, whose allocations and
+  /// TensorRT profiles are reused from one request to another. The outputs
+  /// keep the padded shapes, unless they are cut back by
+  /// SetOutputShapeBucketAxis. The inputs larger than the largest boundary
+  /// and the ones with lod are not padded.
+  ///
+  /// \param input_name the name of the input.
+  /// \param axis the axis of the input to pad.
+  /// \param boundaries the increasing bucket boundaries, or empty for the
+  /// powers of 2 between the min and max shape of axis in the shape range
+  /// info of EnableTunedTensorRtDynamicShape, with the max.
+  ///
+  void SetInputShapeBuckets(const std::string& input_name,
+                            int axis,
+                            const std::vector<int>& boundaries = {});
+
+  ///
+  /// \brief A boolean state telling whether any input is padded to shape
+  /// buckets.
+  ///
+  /// \return bool Whether any input is padded to shape buckets.
+  ///
+  bool shape_bucketing_enabled() const;
+
+  ///
+  /// \brief Cut the output of output_name along axis back to the size of the
+  /// input of input_name before it is padded by SetInputShapeBuckets, so
+  /// that the padding does not show in the output. The rows of the output
+  /// along axis must follow the ones of the input along its bucket axis,
+  /// e.g. the batch.
+  ///
+  /// \param output_name the name of the output.
+  /// \param input_name the name of the padded input.
+  /// \param axis the axis of the output to cut.
+  ///
+  void SetOutputShapeBucketAxis(const std::string& output_name,
+                                const std::string& input_name,
+                                int axis);
+
   ///
   /// \brief Prevent ops running in Paddle-TRT
   /// NOTE: just experimental, not an official stable API, easy to be broken.
@@ -883,6 +946,40 @@ struct PD_INFER_DECL AnalysisConfig {
     return trt_use_explicit_quantization_;
   }
 
+  ///
+  /// \brief Build the TensorRT engines not found in the serialized engines
+  /// of the optimization cache in the background, rather than at the init of
+  /// the predictor, and run their subgraphs natively until they are built.
+  /// The engines built are saved to the cache if use_static is set by
+  /// EnableTensorRtEngine, for the next predictors to load them.
+  ///
+  /// \param x whether to build the TensorRT engines in the background.
+  ///
+  void EnableTensorRtBackgroundBuild(bool x = true) {
+    trt_background_build_ = x;
+  }
+  bool tensorrt_background_build_enabled() const {
+    return trt_background_build_;
+  }
+
+  ///
+  /// \brief Tune the TensorRT engines of dynamic shape to the live traffic.
+  /// Each engine counts the input shapes it runs, and builds an engine of a
+  /// profile fixed to a shape hot in the recent runs in the background. The
+  /// runs of that shape are routed to it once built, and the others to the
+  /// engine of the whole shape range. The engine of the shape least run is
+  /// replaced when the hot shapes drift.
+  ///
+  /// \param max_engines the number of engines of hot shapes of each
+  /// TensorRT subgraph, 0 to disable the tuning.
+  ///
+  void EnableTensorRtOnlineShapeTuning(int max_engines = 4) {
+    trt_online_shape_engines_ = max_engines;
+  }
+  int tensorrt_online_shape_engines() const {
+    return trt_online_shape_engines_;
+  }
+
   ///
   /// \brief Set the optimization level of TensorRT
   /// \param level The optimization level
@@ -916,6 +1013,24 @@ struct PD_INFER_DECL AnalysisConfig {
 
   bool new_ir_enabled() const { return use_pir_; }
 
+  /// \brief Capture the whole run of the new executor into a CUDA Graph per
+  /// input shape and replay it, which saves the launch of every kernel of
+  /// small models. The inputs are copied into the buffers the graphs read.
+  /// The runs that cannot be captured, with ops syncing with the host or
+  /// control flow, run kernel by kernel as usual. The input shapes are best
+  /// bounded by SetInputShapeBuckets, see
+  /// FLAGS_new_executor_auto_cuda_graph_max_buckets.
+  ///
+  /// \param x whether to use CUDA Graph in the new executor on GPU.
+  ///
+  void EnableNewExecutorCUDAGraph(bool x = true) {
+    use_new_executor_cuda_graph_ = x;
+  }
+
+  bool new_executor_cuda_graph_enabled() const {
+    return use_new_executor_cuda_graph_;
+  }
+
   ///
   /// \brief Control whether to use optimized model to inference.
   ///
@@ -1014,6 +1129,28 @@ struct PD_INFER_DECL AnalysisConfig {
     return cpu_math_library_num_threads_;
   }
 
+  ///
+  /// \brief Run the CPU kernels of the predictor on a thread for each of
+  /// \param cpu_ids, bound to it, instead of the
+  /// cpu_math_library_num_threads threads free to move on all the cores.
+  /// The predictors of a process given disjoint cores do not preempt each
+  /// other's threads, which bounds their tail latency. The threads are the
+  /// OpenMP ones of the thread calling Run, so it is bound to cpu_ids[0],
+  /// and OneDNN runs on them too.
+  ///
+  /// \param spin_wait whether the idle threads spin for the next kernel,
+  /// which is faster on dedicated cores, or sleep at once. Set by the Intel
+  /// OpenMP runtime of MKL, otherwise by OMP_WAIT_POLICY.
+  ///
+  void EnableCpuCoreBinding(const std::vector<int>& cpu_ids,
+                            bool spin_wait = false);
+
+  bool cpu_core_binding_enabled() const { return !cpu_core_ids_.empty(); }
+
+  const std::vector<int>& cpu_core_ids() const { return cpu_core_ids_; }
+
+  bool cpu_spin_wait() const { return cpu_spin_wait_; }
+
   ///
   /// \brief Transform the AnalysisConfig to NativeConfig.
   ///
@@ -1263,6 +1400,27 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   void SetOptimizationLevel(int opt_level);
 
+  ///
+  /// \brief Quantize the FP16/BF16 weights of the matmul and fc layers to
+  /// INT8 or INT4 when the predictor is created, and run these layers by the
+  /// weight only GEMMs of the new IR on GPU. The activations stay in
+  /// FP16/BF16, so no calibration is needed, and the weights read by each
+  /// layer are 2x or 4x smaller, which is the bound of the decoding of large
+  /// language models. Requires Paddle compiled with CUTLASS and a GPU of
+  /// sm 70, 75, 80 or 86, the other layers are left as they are.
+  ///
+  /// \param algo "weight_only_int8" or "weight_only_int4".
+  /// \param group_size -1 for a scale of each output channel, 64 or 128 for
+  /// a scale of each group_size input channels of each output channel, which
+  /// is more accurate for INT4.
+  ///
+  void EnableWeightOnlyQuantization(
+      const std::string& algo = "weight_only_int8", int group_size = -1);
+
+  bool weight_only_quantization_enabled() const {
+    return use_weight_only_quant_;
+  }
+
  protected:
   // Update the config.
   void Update();
@@ -1286,6 +1444,8 @@ struct PD_INFER_DECL AnalysisConfig {
   bool use_cutlass_{false};
   int gpu_device_id_{0};
   uint64_t memory_pool_init_size_mb_{100};  // initial size is 100MB.
+  uint64_t gpu_memory_quota_mb_{0};
+  bool gpu_memory_quota_hard_{true};
   bool enable_gpu_mixed_{false};
   bool thread_local_stream_{false};
 
@@ -1351,6 +1511,8 @@ struct PD_INFER_DECL AnalysisConfig {
   bool trt_use_inspector_{false};
   bool trt_inspector_serialize_{false};
   bool trt_use_explicit_quantization_{false};
+  bool trt_background_build_{false};
+  int trt_online_shape_engines_{0};
   int trt_optimization_level_{3};
 
   // In CollectShapeInfo mode, we will collect the shape information of
@@ -1359,6 +1521,11 @@ struct PD_INFER_DECL AnalysisConfig {
   bool collect_shape_range_info_{false};
   std::string shape_range_info_path_;
 
+  // the axis and the bucket boundaries of the inputs padded to shape buckets
+  std::map<std::string, std::pair<int, std::vector<int>>> input_shape_buckets_;
+  // the input and the axis of the outputs cut back to the unpadded size
+  std::map<std::string, std::pair<std::string, int>> output_shape_bucket_axes_;
+
   // dlnne related.
   bool use_dlnne_{false};
   int dlnne_min_subgraph_size_{3};
@@ -1392,10 +1559,13 @@ struct PD_INFER_DECL AnalysisConfig {
   bool use_optimized_model_{false};
 
   bool use_new_executor_{false};
+  bool use_new_executor_cuda_graph_{false};
 
   bool specify_input_name_{false};
 
   int cpu_math_library_num_threads_{1};
+  std::vector<int> cpu_core_ids_;
+  bool cpu_spin_wait_{false};
 
   bool with_profile_{false};
 
@@ -1493,6 +1663,9 @@ struct PD_INFER_DECL AnalysisConfig {
   std::vector<std::string> custom_passes_;
   bool custom_pass_only_{false};
   int pm_opt_level_{2};
+  bool use_weight_only_quant_{false};
+  std::string weight_only_algo_{"weight_only_int8"};
+  int weight_only_group_size_{-1};
   std::vector<std::string> ir_debug_passes_;
 };
 
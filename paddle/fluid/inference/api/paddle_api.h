@@ -315,6 +315,14 @@ class PD_INFER_DECL PaddlePredictor {
   ///
   virtual uint64_t TryShrinkMemory() { return 0; }
 
+  ///
+  /// \brief Get the stats of the GPU memory of the predictor, if it has a
+  /// memory quota.
+  ///
+  /// \return the map of the names and values of the stats
+  ///
+  virtual std::map<std::string, uint64_t> GetMemoryStats() { return {}; }
+
   ///
   /// \brief Register a output hook function to operate the intermediate tensor
   /// of op output. when using this function, memory reuse should be turned off.
@@ -22,8 +22,11 @@ limitations under the License. */
 #pragma once
 
 #include <cassert>
+#include <condition_variable>  // NOLINT
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -190,6 +193,16 @@ class PD_INFER_DECL Predictor {
   ///
   uint64_t TryShrinkMemory();
 
+  ///
+  /// \brief Get the stats of the GPU memory of the predictor, if it has a
+  /// memory quota set by Config::SetGpuMemoryQuota: the bytes "allocated",
+  /// "peak_allocated" and "quota", the "exceeded_count" of the allocations
+  /// beyond the quota, and the bytes "released" for the other predictors.
+  ///
+  /// \return the map of the names and values of the stats
+  ///
+  std::map<std::string, uint64_t> GetMemoryStats();
+
   ///
   /// \brief Register a output hook function to operate the intermediate tensor
   /// of op output. when using this function, memory reuse should be turned off.
@@ -260,18 +273,297 @@ namespace services {
 class PD_INFER_DECL PredictorPool {
  public:
   PredictorPool() = delete;
+  // neither copyable nor movable, the pool is shared by the threads
   PredictorPool(const PredictorPool&) = delete;
   PredictorPool& operator=(const PredictorPool&) = delete;
 
   /// \brief Construct the predictor pool with \param size predictor instances.
   explicit PredictorPool(const Config& config, size_t size = 1);
 
+  /// \brief Construct the predictor pool with a predictor on each of \param
+  /// streams of the GPU of \param config. The predictors are cloned from the
+  /// one of the first stream, so they share its weights and TensorRT engines,
+  /// which run an execution context for each of them.
+  PredictorPool(const Config& config, const std::vector<void*>& streams);
+
   /// \brief Get \param id-th predictor.
   Predictor* Retrieve(size_t idx);
 
+  /// \brief Get a predictor no other thread runs, waiting for a Release when
+  /// all of them are busy. Release it after the run of the calling thread.
+  Predictor* Acquire();
+
+  /// \brief Release \param pred got by Acquire.
+  void Release(Predictor* pred);
+
  private:
   std::shared_ptr<Predictor> main_pred_;
   std::vector<std::unique_ptr<Predictor>> preds_;
+
+  std::mutex mutex_;
+  std::condition_variable released_;
+  // whether the predictors are acquired, by index
+  std::vector<bool> busy_;
+  size_t next_{0};
+};
+
+///
+/// \brief The histograms of a BatchingPredictor since its construction.
+///
+struct PD_INFER_DECL BatchingStats {
+  /// The number of batches run by their number of rows, index 0 is unused.
+  std::vector<int64_t> batch_size_histogram;
+  /// The number of requests by the microseconds they waited in the queue,
+  /// bucket i > 0 counts the waits in [2^(i-1), 2^i).
+  std::vector<int64_t> queue_wait_us_histogram;
+  int64_t num_requests{0};
+  int64_t num_batches{0};
+};
+
+///
+/// \class BatchingPredictor
+///
+/// \brief BatchingPredictor serves individual requests from many threads by
+/// coalescing them into batches. The requests queued within max_queue_delay_us
+/// of the oldest one are concatenated along dim 0 of their inputs, up to
+/// max_batch_size rows, and run on one of a pool of predictors. The outputs
+/// are split back along dim 0 to the requests. Requests whose inputs differ
+/// in names, dtypes or dims other than dim 0, or have LoD, run in separate
+/// batches, and one of more than max_batch_size rows runs alone.
+///
+/// Usage:
+///
+/// \code{.cpp}
+/// services::BatchingPredictor predictor(config, 2, 32, 2000);
+/// // in each serving thread
+/// std::vector<paddle::PaddleTensor> outputs;
+/// predictor.Run(inputs, &outputs);
+/// \endcode
+///
+class PD_INFER_DECL BatchingPredictor {
+ public:
+  BatchingPredictor() = delete;
+  BatchingPredictor(const BatchingPredictor&) = delete;
+  BatchingPredictor& operator=(const BatchingPredictor&) = delete;
+
+  /// \brief Construct with \param num_predictors predictors of \param config,
+  /// each batch waits up to \param max_queue_delay_us microseconds for
+  /// \param max_batch_size rows.
+  BatchingPredictor(const Config& config,
+                    size_t num_predictors,
+                    int max_batch_size,
+                    int64_t max_queue_delay_us);
+
+  /// \brief Runs the queued requests, and stops the predictors.
+  ~BatchingPredictor();
+
+  ///
+  /// \brief Queue a request, the inputs on CPU with the same dim 0, matched
+  /// to the inputs of the model by name, or by position if unnamed. The
+  /// memory of inputs with external PaddleBuf should stay valid until the
+  /// future is ready.
+  ///
+  /// \return The future of the outputs, in the order of GetOutputNames()
+  ///
+  std::future<std::vector<paddle::PaddleTensor>> Submit(
+      std::vector<paddle::PaddleTensor> inputs);
+
+  ///
+  /// \brief Submit a request and wait for its outputs.
+  ///
+  /// \return Whether the run is successful
+  ///
+  bool Run(const std::vector<paddle::PaddleTensor>& inputs,
+           std::vector<paddle::PaddleTensor>* outputs);
+
+  BatchingStats GetStats();
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+///
+/// \class KVCacheManager
+///
+/// \brief KVCacheManager allocates the blocks of the paged key and value
+/// caches of block_multi_head_attention to the sequences being decoded. It
+/// preallocates num_caches caches of [num_blocks, num_heads, block_size,
+/// head_dim] on a GPU, to be bound to the cache inputs of the predictors,
+/// and writes the block tables of the sequences of a step directly to the
+/// GPU for the kernel. A Fork shares the blocks of the parent, e.g. of a
+/// common prompt, and the last block is copied on the first Append to it
+/// from either sequence. The blocks are freed with their last sequence, and
+/// an Allocate or Append that needs more blocks than are free fails without
+/// changing anything, for the caller to evict (Free) sequences.
+///
+/// Usage:
+///
+/// \code{.cpp}
+/// services::KVCacheManager manager(2 * num_layers, 4096, 64, num_heads,
+///                                  head_dim, DataType::FLOAT16, max_seqs,
+///                                  max_blocks_per_seq, device_id, stream);
+/// manager.BindCaches(predictor.get(), cache_names);
+/// manager.Allocate(seq_id, prompt_len);
+/// // before each decode step
+/// manager.Append(seq_id);
+/// manager.ShareBlockTables(seq_ids, predictor.get(), "block_tables");
+/// \endcode
+///
+class PD_INFER_DECL KVCacheManager {
+ public:
+  KVCacheManager() = delete;
+  KVCacheManager(const KVCacheManager&) = delete;
+  KVCacheManager& operator=(const KVCacheManager&) = delete;
+
+  /// \brief Construct with the caches on GPU \param device_id, the copies of
+  /// the blocks and block tables run on \param stream, that should be the
+  /// one of the predictors or be synchronized with it.
+  KVCacheManager(int num_caches,
+                 int num_blocks,
+                 int block_size,
+                 int num_heads,
+                 int head_dim,
+                 DataType dtype,
+                 int max_seqs,
+                 int max_blocks_per_seq,
+                 int device_id = 0,
+                 void* stream = nullptr);
+
+  ~KVCacheManager();
+
+  /// \brief Share the caches with the inputs \param cache_names of \param
+  /// predictor, one for each cache.
+  void BindCaches(Predictor* predictor,
+                  const std::vector<std::string>& cache_names);
+
+  /// \brief Add the sequence \param seq_id with the blocks of \param
+  /// num_tokens tokens.
+  ///
+  /// \return Whether there are enough free blocks
+  bool Allocate(int64_t seq_id, int num_tokens);
+
+  /// \brief Extend the sequence \param seq_id by \param num_tokens tokens.
+  ///
+  /// \return Whether there are enough free blocks
+  bool Append(int64_t seq_id, int num_tokens = 1);
+
+  /// \brief Add the sequence \param child_id sharing the blocks and tokens
+  /// of \param parent_id.
+  void Fork(int64_t parent_id, int64_t child_id);
+
+  /// \brief Drop the last \param num_tokens tokens of the sequence \param
+  /// seq_id, e.g. the rejected draft tokens of a speculative decoding step,
+  /// and free the blocks left empty.
+  void Rollback(int64_t seq_id, int num_tokens);
+
+  /// \brief Remove the sequence \param seq_id.
+  void Free(int64_t seq_id);
+
+  int NumFreeBlocks() const;
+
+  std::vector<int> GetBlockTable(int64_t seq_id) const;
+
+  /// \brief Write the block tables of \param seq_ids in order to the input
+  /// \param name of \param predictor, as an int32 tensor of
+  /// [seq_ids.size(), max_blocks_per_seq] on the GPU padded with -1.
+  void ShareBlockTables(const std::vector<int64_t>& seq_ids,
+                        Predictor* predictor,
+                        const std::string& name);
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+///
+/// \brief The batch of a decode step scheduled by a DecodeScheduler, with a
+/// slot for each of request_ids, in order.
+///
+struct PD_INFER_DECL DecodeStep {
+  std::vector<int64_t> request_ids;
+  /// The prompt lengths of the requests prefilled in the step, 0 for the
+  /// others.
+  std::vector<int> seq_lens_encoder;
+  /// The cached tokens of the requests decoded in the step, 0 for the
+  /// others.
+  std::vector<int> seq_lens_decoder;
+  std::vector<int> seq_lens_this_time;
+  /// The tokens of all the requests.
+  int num_tokens{0};
+
+  bool empty() const { return request_ids.empty(); }
+};
+
+///
+/// \class DecodeScheduler
+///
+/// \brief DecodeScheduler batches the requests of a decoder model at the
+/// iteration level: the requests join the running batch in the step after
+/// they are added and leave it in the step after they finish, instead of
+/// holding their slots until the whole batch finishes. Each step decodes a
+/// token of every running request first, then prefills the waiting requests
+/// in order within the token budget, the batch size and the free blocks of
+/// the KVCacheManager. When the cache runs out of blocks, the latest
+/// admitted requests are preempted, freed and queued again to be prefilled
+/// with the tokens they generated.
+///
+/// Usage:
+///
+/// \code{.cpp}
+/// services::DecodeScheduler scheduler(&cache_manager, 64, 4096);
+/// scheduler.AddRequest(id, prompt_len, max_new_tokens);
+/// // in the serving loop
+/// auto step = scheduler.Schedule();
+/// scheduler.ShareStepInputs(step, predictor.get());
+/// // feed the input ids of step.request_ids and run the predictor
+/// auto finished = scheduler.Update(step, eos_request_ids);
+/// \endcode
+///
+class PD_INFER_DECL DecodeScheduler {
+ public:
+  DecodeScheduler() = delete;
+  DecodeScheduler(const DecodeScheduler&) = delete;
+  DecodeScheduler& operator=(const DecodeScheduler&) = delete;
+
+  /// \brief Construct with at most \param max_batch_size requests and
+  /// \param max_num_tokens tokens in a step, the caches of the requests are
+  /// allocated by \param cache_manager, which should outlive the scheduler.
+  DecodeScheduler(KVCacheManager* cache_manager,
+                  int max_batch_size,
+                  int max_num_tokens);
+
+  ~DecodeScheduler();
+
+  /// \brief Queue the request \param request_id of \param prompt_len
+  /// tokens, that finishes after \param max_new_tokens tokens at most. Can
+  /// be called from any thread.
+  void AddRequest(int64_t request_id, int prompt_len, int max_new_tokens);
+
+  /// \brief Schedule the next step, empty if no request is running or can
+  /// be admitted.
+  DecodeStep Schedule();
+
+  /// \brief Write seq_lens_encoder, seq_lens_decoder and seq_lens_this_time
+  /// of \param step to the int32 inputs of the same names of \param
+  /// predictor, of [step.request_ids.size(), 1], and the block tables to its
+  /// input block_tables.
+  void ShareStepInputs(const DecodeStep& step, Predictor* predictor);
+
+  /// \brief Account for the token generated for each request of \param
+  /// step, \param eos_request_ids are the ones that generated the end of
+  /// their sequence.
+  ///
+  /// \return The requests finished, whose caches are freed
+  std::vector<int64_t> Update(const DecodeStep& step,
+                              const std::vector<int64_t>& eos_request_ids);
+
+  /// \brief The number of requests waiting or running.
+  size_t NumRequests();
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
 };
 }  // namespace services
 
@@ -143,6 +143,22 @@ PD_Bool PD_PredictorRun(__pd_keep PD_Predictor* pd_predictor) {
   return predictor->Run();  // NOLINT
 }
 
+PD_Bool PD_PredictorRunWithExternalStream(__pd_keep PD_Predictor* pd_predictor,
+                                          void* stream) {
+  CHECK_AND_CONVERT_PD_PREDICTOR;
+#if defined(PADDLE_WITH_CUDA)
+  return paddle_infer::experimental::InternalUtils::RunWithExternalStream(
+      predictor.get(), reinterpret_cast<cudaStream_t>(stream));
+#elif defined(PADDLE_WITH_HIP)
+  return paddle_infer::experimental::InternalUtils::RunWithExternalStream(
+      predictor.get(), reinterpret_cast<hipStream_t>(stream));
+#else
+  PADDLE_THROW(paddle::platform::errors::Unimplemented(
+      "PD_PredictorRunWithExternalStream needs Paddle built with CUDA or "
+      "ROCm."));
+#endif
+}
+
 void PD_PredictorClearIntermediateTensor(__pd_keep PD_Predictor* pd_predictor) {
   CHECK_AND_CONVERT_PD_PREDICTOR;
   predictor->ClearIntermediateTensor();
@@ -131,6 +131,19 @@ PADDLE_CAPI_EXPORT extern __pd_give PD_Tensor* PD_PredictorGetOutputHandle(
 PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorRun(
     __pd_keep PD_Predictor* pd_predictor);
 
+///
+/// \brief Run the prediction engine on the given stream, without waiting
+/// for it. The predictor must be created from a config with
+/// PD_ConfigSetExecStream. The caller synchronizes the stream before using
+/// the outputs, e.g. bound with PD_TensorShareExternalData*.
+///
+/// \param[in] pd_predictor predictor
+/// \param[in] stream The cudaStream_t or hipStream_t to run on.
+/// \return Whether the function executed successfully
+///
+PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorRunWithExternalStream(
+    __pd_keep PD_Predictor* pd_predictor, void* stream);
+
 /// \brief Clear the intermediate tensors of the predictor
 ///
 /// \param[in] pd_predictor predictor
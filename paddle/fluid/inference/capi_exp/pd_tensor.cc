@@ -92,6 +92,20 @@ REPEAT_ALL_DATA_TYPE(PD_TENSOR_COPY_FROM_CPU_IMPL)
 REPEAT_ALL_DATA_TYPE(PD_TENSOR_COPY_TO_CPU_IMPL)
 #undef PD_TENSOR_COPY_TO_CPU_IMPL
 
+#define PD_TENSOR_SHARE_EXTERNAL_DATA_IMPL(type, Type)                   \
+  void PD_TensorShareExternalData##Type(__pd_keep PD_Tensor* pd_tensor, \
+                                        type* data,                     \
+                                        size_t shape_size,              \
+                                        int32_t* shape,                 \
+                                        PD_PlaceType place) {           \
+    CHECK_AND_CONVERT_PD_TENSOR;                                        \
+    std::vector<int> shapes(shape, shape + shape_size);                 \
+    tensor->ShareExternalData<type>(                                    \
+        data, shapes, paddle_infer::CvtToCxxPlaceType(place));          \
+  }
+REPEAT_ALL_DATA_TYPE(PD_TENSOR_SHARE_EXTERNAL_DATA_IMPL)
+#undef PD_TENSOR_SHARE_EXTERNAL_DATA_IMPL
+
 #undef REPEAT_ALL_DATA_TYPE
 
 __pd_give PD_OneDimArrayInt32* PD_TensorGetShape(
@@ -246,6 +246,91 @@ PADDLE_CAPI_EXPORT extern void PD_TensorCopyToCpuUint8(
 PADDLE_CAPI_EXPORT extern void PD_TensorCopyToCpuInt8(
     __pd_keep PD_Tensor* pd_tensor, int8_t* data);
 ///
+/// \brief Share the caller's memory with the tensor, without any copy.
+/// It's usually used to set the input tensor data, or to bind the buffer
+/// an output is written to, which must be large enough for the output.
+/// The memory must outlive the use of the tensor by the predictor.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, on the host or the device.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataFloat(
+    __pd_keep PD_Tensor* pd_tensor,
+    float* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the caller's memory with the tensor, without any copy.
+/// It's usually used to set the input tensor data, or to bind the buffer
+/// an output is written to, which must be large enough for the output.
+/// The memory must outlive the use of the tensor by the predictor.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, on the host or the device.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt64(
+    __pd_keep PD_Tensor* pd_tensor,
+    int64_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the caller's memory with the tensor, without any copy.
+/// It's usually used to set the input tensor data, or to bind the buffer
+/// an output is written to, which must be large enough for the output.
+/// The memory must outlive the use of the tensor by the predictor.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, on the host or the device.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt32(
+    __pd_keep PD_Tensor* pd_tensor,
+    int32_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the caller's memory with the tensor, without any copy.
+/// It's usually used to set the input tensor data, or to bind the buffer
+/// an output is written to, which must be large enough for the output.
+/// The memory must outlive the use of the tensor by the predictor.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, on the host or the device.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataUint8(
+    __pd_keep PD_Tensor* pd_tensor,
+    uint8_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the caller's memory with the tensor, without any copy.
+/// It's usually used to set the input tensor data, or to bind the buffer
+/// an output is written to, which must be large enough for the output.
+/// The memory must outlive the use of the tensor by the predictor.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the data, on the host or the device.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the data.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt8(
+    __pd_keep PD_Tensor* pd_tensor,
+    int8_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
 /// \brief Get the tensor shape
 /// \param[in] pd_tensor tensor.
 /// \return The tensor shape.
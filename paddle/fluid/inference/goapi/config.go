@@ -782,6 +782,17 @@ func (config *Config) EnableGpuMultiStream() {
 	C.PD_ConfigEnableGpuMultiStream(config.c)
 }
 
+///
+/// \brief Set the execution stream, a cudaStream_t or hipStream_t, for
+/// Predictor.RunWithExternalStream. If not set a stream will be created
+/// internally.
+///
+/// \param[in] stream The execution stream.
+///
+func (config *Config) SetExecStream(stream unsafe.Pointer) {
+	C.PD_ConfigSetExecStream(config.c, stream)
+}
+
 ///
 /// \brief Delete all passes that has a certain type 'pass'.
 ///
@@ -145,6 +145,19 @@ func (p *Predictor) Run() {
 	C.PD_PredictorRun(p.c)
 }
 
+///
+/// \brief Run the prediction engine on the given stream, without waiting
+/// for it. The config of the predictor must set the stream with
+/// SetExecStream. The caller synchronizes the stream before using the
+/// outputs.
+///
+/// \param[in] stream The cudaStream_t or hipStream_t to run on.
+/// \return Whether the function executed successfully
+///
+func (p *Predictor) RunWithExternalStream(stream unsafe.Pointer) bool {
+	return cvtPDBoolToGo(C.PD_PredictorRunWithExternalStream(p.c, stream))
+}
+
 ///
 /// \brief Clear the intermediate tensors of the predictor
 ///
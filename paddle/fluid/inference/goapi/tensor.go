@@ -212,6 +212,35 @@ func (t *Tensor) CopyToCpu(value interface{}) {
 	}
 }
 
+///
+/// \brief Share the caller's memory with the tensor, without any copy.
+/// It's usually used to set the input tensor data, or to bind the buffer an
+/// output is written to, which must be large enough for the output. The
+/// memory, e.g. device memory from cgo, must outlive the use of the tensor.
+///
+/// \param[in] data The pointer of the data, on the host or the device.
+/// \param[in] dtype The data type of the data.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the data.
+///
+func (t *Tensor) ShareExternalData(data unsafe.Pointer, dtype DataType, shape []int32, place PlaceType) {
+	cShape := (*C.int32_t)(unsafe.Pointer(&shape[0]))
+	size := C.size_t(len(shape))
+	cPlace := C.PD_PlaceType(place)
+	switch dtype {
+	case Float32:
+		C.PD_TensorShareExternalDataFloat(t.c, (*C.float)(data), size, cShape, cPlace)
+	case Int32:
+		C.PD_TensorShareExternalDataInt32(t.c, (*C.int32_t)(data), size, cShape, cPlace)
+	case Int64:
+		C.PD_TensorShareExternalDataInt64(t.c, (*C.int64_t)(data), size, cShape, cPlace)
+	case Uint8:
+		C.PD_TensorShareExternalDataUint8(t.c, (*C.uint8_t)(data), size, cShape, cPlace)
+	case Int8:
+		C.PD_TensorShareExternalDataInt8(t.c, (*C.int8_t)(data), size, cShape, cPlace)
+	}
+}
+
 var types = []struct {
 	typ      reflect.Type
 	dataType C.PD_DataType
@@ -34,6 +34,11 @@ using DynamicMetaFn =
                             nvinfer1::IExprBuilder& expr_builder,  // NOLINT
                             const framework::OpDesc& op_desc);
 
+// The attribute of the ops bridged into an engine by tensorrt_subgraph_pass.
+// Their generic plugins have the dims of their only input if the op has no
+// dynamic meta fn.
+constexpr char kTrtBridgeOpAttrName[] = "trt_bridge_op";
+
 class DynamicMetaFnFactory {
  public:
   static DynamicMetaFnFactory& Instance() {
@@ -514,6 +514,7 @@ class TensorRTEngine {
   bool disable_trt_plugin_fp16() { return params_.disable_trt_plugin_fp16; }
   bool with_dynamic_shape() { return params_.with_dynamic_shape; }
   phi::DataType precision() { return params_.precision; }
+  const ConstructionParams& params() const { return params_; }
 
 #if IS_TRT_VERSION_GE(6000)
   nvinfer1::IPluginV2Layer* AddDynamicPlugin(
@@ -3438,6 +3438,49 @@ bool OpTeller::Tell(const framework::ir::Node* node,
   return false;
 }
 
+bool OpTeller::TellBridge(const framework::ir::Node* node,
+                          bool use_no_calib_int8,
+                          bool with_dynamic_shape) {
+  // the generic plugins only run in dynamic shape mode, without int8
+  if (!with_dynamic_shape || use_no_calib_int8) return false;
+  if (node->Op()->HasAttr("skip_quant")) return false;
+  if (node->inputs.size() != 1 || node->outputs.size() != 1) return false;
+  auto* x = node->inputs[0]->Var();
+  auto* out = node->outputs[0]->Var();
+  if (x == nullptr || out == nullptr || x->Persistable()) return false;
+  for (auto* var : {x, out}) {
+    if (var->GetType() != framework::proto::VarType::LOD_TENSOR ||
+        var->GetLoDLevel() != 0) {
+      return false;
+    }
+  }
+  // The output must have the dtype and the dims of the input for any input:
+  // all the dims but the batch dim are known, and the ops changing the numel
+  // like unique are left out by the rank.
+  auto dtype = x->GetDataType();
+  if ((dtype != framework::proto::VarType::FP32 &&
+       dtype != framework::proto::VarType::FP16) ||
+      out->GetDataType() != dtype) {
+    return false;
+  }
+  auto shape = x->GetShape();
+  if (shape.size() < 2 || out->GetShape() != shape) return false;
+  for (size_t i = 1; i < shape.size(); ++i) {
+    if (shape[i] < 0) return false;
+  }
+
+  const std::string& op_type = node->Op()->Type();
+  framework::InitDefaultKernelSignatureMap();
+  if (!phi::OpUtilsMap::Instance().HasArgumentMappingFn(op_type) &&
+      !phi::DefaultKernelSignatureMap::Instance().Has(op_type)) {
+    return false;
+  }
+  if (!phi::KernelFactory::Instance().HasCompatiblePhiKernel(op_type)) {
+    return false;
+  }
+  return true;
+}
+
 OpTeller::OpTeller() {  // NOLINT
   tellers_.emplace_back(new tensorrt::SimpleOpTypeSetTeller);
   tellers_.emplace_back(new tensorrt::GenericPluginTeller);
@@ -81,6 +81,14 @@ class OpTeller {
             bool forbid_dynamic_op_enter_into_trt = false,
             bool use_explicit_quantization = false);
 
+  // Tell whether an op refused by Tell can still run in an engine as a
+  // generic plugin, because it keeps the dims and the dtype of its only input.
+  // The caller decides whether it bridges two parts of the engines, and then
+  // marks it with kTrtBridgeOpAttrName and the generic plugin converter.
+  bool TellBridge(const framework::ir::Node* node,
+                  bool use_no_calib_int8 = false,
+                  bool with_dynamic_shape = false);
+
   std::unique_ptr<Teller>& GetDefaultTeller() { return tellers_.at(0); }
 
   std::unique_ptr<Teller>& GetGenericPluginTeller() { return tellers_.at(1); }
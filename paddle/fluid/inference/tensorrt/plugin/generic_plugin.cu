@@ -541,6 +541,11 @@ nvinfer1::DimsExprs GenericPlugin::getOutputDimensions(
     nvinfer1::IExprBuilder& expr_builder) TRT_NOEXCEPT {
   CHECK(output_index < getNbOutputs());
   auto& dynamic_infermeta_factory = tensorrt::DynamicMetaFnFactory::Instance();
+  if (!dynamic_infermeta_factory.Contains(op_desc_.Type()) &&
+      op_desc_.GetAttrIfExists<bool>(tensorrt::kTrtBridgeOpAttrName)) {
+    CHECK(nb_inputs == 1);
+    return inputs[0];
+  }
   PADDLE_ENFORCE_EQ(dynamic_infermeta_factory.Contains(op_desc_.Type()),
                     true,
                     platform::errors::InvalidArgument(
@@ -14,9 +14,18 @@
 
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <sstream>
+
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/platform/enforce.h"
 
+COMMON_DECLARE_int32(trt_int8_calib_queue_size);
+
 namespace paddle {
 namespace inference {
 namespace tensorrt {
@@ -31,30 +40,34 @@ TRTInt8Calibrator::TRTInt8Calibrator(
     const platform::Place place)
     : batch_size_(batch_size), engine_name_(engine_name) {
   VLOG(4) << "Init a new calibrator: " << engine_name_;
-  for (const auto& it : buffers) {
-    phi::DenseTensor temp_tensor;
-    std::string input_name = it.first;
-    int data_size = it.second;
-    int num_ele = data_size / sizeof(int16_t);
-    framework::DDim data_shape = common::make_ddim({num_ele});
-    temp_tensor.Resize(data_shape);
-    data_tensors_.push_back(temp_tensor);
-    data_buffers_[input_name] = std::pair<void*, size_t>(
-        static_cast<void*>(temp_tensor.mutable_data<int16_t>(place)),
-        data_size);
+  int num_slots = std::max(FLAGS_trt_int8_calib_queue_size, 1);
+  data_buffers_.resize(num_slots);
+  for (int slot = 0; slot < num_slots; ++slot) {
+    for (const auto& it : buffers) {
+      phi::DenseTensor temp_tensor;
+      std::string input_name = it.first;
+      int data_size = it.second;
+      int num_ele = data_size / sizeof(int16_t);
+      framework::DDim data_shape = common::make_ddim({num_ele});
+      temp_tensor.Resize(data_shape);
+      void* data = temp_tensor.mutable_data<int16_t>(place);
+      data_tensors_.push_back(temp_tensor);
+      data_buffers_[slot][input_name] =
+          std::pair<void*, size_t>(data, data_size);
+    }
+    free_slots_.push_back(slot);
   }
 }
 
 TRTInt8Calibrator::TRTInt8Calibrator(const std::string& calib_data)
     : batch_size_(0),
       calib_running_(false),
-      data_is_set_(false),
       done_(true),
       calibration_table_(calib_data) {}
 
 void TRTInt8Calibrator::waitAndSetDone() {
   std::unique_lock<std::mutex> lk(mut_);
-  while ((calib_running_ || data_is_set_) && !done_) cond_.wait(lk);
+  while ((calib_running_ || !ready_slots_.empty()) && !done_) cond_.wait(lk);
   if (!done_) {
     done_ = true;
     cond_.notify_all();
@@ -68,18 +81,22 @@ bool TRTInt8Calibrator::setBatch(
   VLOG(3) << "set batch: " << engine_name_;
   std::unique_lock<std::mutex> lk(mut_);
   //  There is a producer and a consumer. The producer set the batch data and
-  //  the consumer get the batch data. The size of the data pool is one.
-  //  So, the producer has to wait for the consumer to finish processing before
-  //  they can set the data.
-  while ((calib_running_ || data_is_set_) && (!done_)) cond_.wait(lk);
+  //  the consumer get the batch data. The producer waits for a free slot of
+  //  the data pool, i.e. one the consumer does not read or has not yet got.
+  while (free_slots_.empty() && !done_) cond_.wait(lk);
   // The done_ is set to true using waitAndSetDone, When all calibration data
   // are processed.
   if (done_) return false;
+  int slot = free_slots_.front();
+  free_slots_.pop_front();
+  lk.unlock();
 
   // Sets the batch.
   for (const auto& it : data) {
-    auto dataptr = data_buffers_.find(it.first);
-    if (dataptr == data_buffers_.end()) {
+    auto dataptr = data_buffers_[slot].find(it.first);
+    if (dataptr == data_buffers_[slot].end()) {
+      lk.lock();
+      free_slots_.push_back(slot);
       PADDLE_THROW(platform::errors::Fatal(
           "%s input name '%s' does not match with the buffer names.",
           engine_name_,
@@ -90,7 +107,8 @@ bool TRTInt8Calibrator::setBatch(
         cudaMemcpy(d.first, it.second, d.second, cudaMemcpyDeviceToDevice));
   }
 
-  data_is_set_ = true;
+  lk.lock();
+  ready_slots_.push_back(slot);
   cond_.notify_all();
   return true;
 }
@@ -102,17 +120,23 @@ bool TRTInt8Calibrator::getBatch(void** bindings,
   std::unique_lock<std::mutex> lk(mut_);
   // The consumer has just finished processing a data.
   // The producer can set the data again.
+  if (held_slot_ >= 0) {
+    free_slots_.push_back(held_slot_);
+    held_slot_ = -1;
+  }
   calib_running_ = false;
   cond_.notify_all();
 
   // As long as there is data in the pool, the consumer can get it.
-  while (!data_is_set_ && !done_) cond_.wait(lk);
+  while (ready_slots_.empty() && !done_) cond_.wait(lk);
   if (done_) return false;
 
   // Gets the batch
+  int slot = ready_slots_.front();
+  ready_slots_.pop_front();
   for (int i = 0; i < num_bindings; i++) {
-    auto it = data_buffers_.find(names[i]);
-    if (it == data_buffers_.end()) {
+    auto it = data_buffers_[slot].find(names[i]);
+    if (it == data_buffers_[slot].end()) {
       try {
         PADDLE_THROW(platform::errors::Fatal(
             "Calibration engine asked for unknown tensor "
@@ -125,8 +149,9 @@ bool TRTInt8Calibrator::getBatch(void** bindings,
     bindings[i] = it->second.first;
   }
 
-  data_is_set_ = false;
+  held_slot_ = slot;
   calib_running_ = true;
+  cond_.notify_all();
   VLOG(4) << "get batch done: " << engine_name_;
   return true;
 }
@@ -150,6 +175,53 @@ void TRTInt8Calibrator::writeCalibrationCache(const void* ptr,
   VLOG(4) << "Got calibration data for " << engine_name_ << " " << ptr
           << " length=" << length;
 }
+std::string TRTInt8Calibrator::MergeCalibrationTables(
+    const std::string& table, const std::string& other) {
+  // A table is a header line, e.g. TRT-8601-EntropyCalibration2, and a line
+  // "name: scale" per tensor, the scale being the hex of the float bits.
+  auto parse = [](const std::string& data,
+                  std::string* header,
+                  std::map<std::string, float>* scales) {
+    std::istringstream is(data);
+    std::string line;
+    std::getline(is, *header);
+    while (std::getline(is, line)) {
+      auto pos = line.rfind(": ");
+      if (pos == std::string::npos) continue;
+      uint32_t bits =
+          static_cast<uint32_t>(std::stoul(line.substr(pos + 2), nullptr, 16));
+      float scale = 0;
+      std::memcpy(&scale, &bits, sizeof(scale));
+      auto& merged = (*scales)[line.substr(0, pos)];
+      merged = std::max(merged, scale);
+    }
+  };
+  if (table.empty()) return other;
+  if (other.empty()) return table;
+  std::string header;
+  std::string other_header;
+  std::map<std::string, float> scales;
+  parse(table, &header, &scales);
+  parse(other, &other_header, &scales);
+  PADDLE_ENFORCE_EQ(header,
+                    other_header,
+                    platform::errors::InvalidArgument(
+                        "Cannot merge the calibration tables of '%s' and '%s', "
+                        "they are not of the same TensorRT and calibrator.",
+                        header,
+                        other_header));
+  std::ostringstream os;
+  os << header << "\n";
+  for (const auto& item : scales) {
+    uint32_t bits = 0;
+    std::memcpy(&bits, &item.second, sizeof(bits));
+    char hex[9];
+    snprintf(hex, sizeof(hex), "%08x", bits);
+    os << item.first << ": " << hex << "\n";
+  }
+  return os.str();
+}
+
 TRTInt8Calibrator::~TRTInt8Calibrator() {
   VLOG(4) << "Destroying calibrator for " << engine_name_;
 }
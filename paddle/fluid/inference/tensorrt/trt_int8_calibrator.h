@@ -18,6 +18,7 @@
 #include <cuda_runtime_api.h>
 
 #include <atomic>
+#include <deque>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
@@ -35,6 +36,9 @@ namespace tensorrt {
 
 class TensorRTEngine;
 
+// The calibrator keeps a queue of FLAGS_trt_int8_calib_queue_size input
+// slots, so that the predictor thread copies the next batches in and runs
+// the program while the calibration engine thread consumes the former ones.
 class TRTInt8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
  public:
   TRTInt8Calibrator(const std::unordered_map<std::string, size_t>& buffers,
@@ -62,18 +66,29 @@ class TRTInt8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
     return calibration_table_;
   }
 
+  // Merge two calibration tables of the same calibrator, e.g. of the shards
+  // of a calibration set run on several GPUs or one after another. The scale
+  // of a tensor in both is the larger one, which keeps the ranges of both.
+  static std::string MergeCalibrationTables(const std::string& table,
+                                            const std::string& other);
+
  private:
   const int batch_size_;
 
   bool calib_running_{true};
-  bool data_is_set_{false};
   bool done_{false};
 
   std::mutex mut_;
   std::condition_variable cond_;
 
-  std::unordered_map<std::string, std::pair<void*, size_t>> data_buffers_;
+  // the input buffers of each slot
+  std::vector<std::unordered_map<std::string, std::pair<void*, size_t>>>
+      data_buffers_;
   std::vector<phi::DenseTensor> data_tensors_;
+  std::deque<int> free_slots_;
+  std::deque<int> ready_slots_;
+  // the slot read by the engine, it is freed by the next getBatch
+  int held_slot_{-1};
 
   std::string engine_name_;
   std::string calibration_table_;
@@ -0,0 +1,70 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/jit/engine/lazy_engine.h"
+
+#include "glog/logging.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace jit {
+
+LazyEngine::LazyEngine(const std::string &name, Builder builder)
+    : name_(name), builder_(std::move(builder)) {}
+
+BaseEngine *LazyEngine::Engine() {
+  std::call_once(built_, [this] {
+    VLOG(3) << "Build the engine of function " << name_;
+    engine_ = builder_();
+    is_built_ = engine_ != nullptr;
+  });
+  PADDLE_ENFORCE_NOT_NULL(
+      engine_,
+      phi::errors::PreconditionNotMet(
+          "Failed to build the engine of function %s.", name_));
+  return engine_.get();
+}
+
+std::vector<Tensor> LazyEngine::operator()(const std::vector<Tensor> &inputs) {
+  return (*Engine())(inputs);
+}
+
+std::vector<DenseTensor> LazyEngine::operator()(
+    const std::vector<DenseTensor> &inputs) {
+  return (*Engine())(inputs);
+}
+
+std::unique_ptr<BaseEngine> LazyEngine::Clone(void *stream) {
+  return Engine()->Clone(stream);
+}
+
+void LazyEngine::Warmup() {
+  if (warmup_.valid()) {
+    return;
+  }
+  warmup_ = std::async(std::launch::async, [this] {
+    // a failed build is raised again by the first call
+    try {
+      Engine();
+    } catch (const std::exception &e) {
+      LOG(WARNING) << "Failed to warm up function " << name_ << ": "
+                   << e.what();
+    }
+  });
+}
+
+bool LazyEngine::IsBuilt() const { return is_built_; }
+
+}  // namespace jit
+}  // namespace paddle
@@ -0,0 +1,65 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/jit/engine/base_engine.h"
+
+namespace paddle {
+namespace jit {
+
+// LazyEngine builds the engine of a function on its first call, so loading a
+// Layer only pays for the functions it runs. Warmup builds it on a background
+// thread instead, the first call then waits for it if it is not done yet.
+class LazyEngine : public BaseEngine {
+ public:
+  using Builder = std::function<std::shared_ptr<BaseEngine>()>;
+
+  LazyEngine(const std::string &name, Builder builder);
+
+  ~LazyEngine() noexcept {}
+
+  std::vector<Tensor> operator()(const std::vector<Tensor> &inputs) override;
+
+  std::vector<DenseTensor> operator()(
+      const std::vector<DenseTensor> &inputs) override;
+
+  std::unique_ptr<BaseEngine> Clone(void *stream = nullptr) override;
+
+  void Warmup();
+
+  bool IsBuilt() const;
+
+ private:
+  BaseEngine *Engine();
+
+  std::string name_;
+  Builder builder_;
+  std::once_flag built_;
+  std::shared_ptr<BaseEngine> engine_;
+  std::atomic<bool> is_built_{false};
+  // destroyed first, waits for the warmup before the engine goes away
+  std::future<void> warmup_;
+};
+
+}  // namespace jit
+}  // namespace paddle
@@ -22,12 +22,15 @@
 
 #include "paddle/common/flags.h"
 #include "paddle/fluid/jit/engine/interpreter_engine.h"
+#include "paddle/fluid/jit/engine/lazy_engine.h"
 #include "paddle/fluid/jit/engine/predictor_engine.h"
 #include "paddle/fluid/jit/layer.h"
 #include "paddle/fluid/jit/property.h"
 #include "paddle/fluid/jit/serializer_utils.h"
 
 COMMON_DECLARE_string(jit_engine_type);
+COMMON_DECLARE_bool(jit_lazy_engine);
+COMMON_DECLARE_bool(jit_engine_warmup);
 
 namespace paddle {
 namespace jit {
@@ -75,17 +78,27 @@ Layer Deserializer::operator()(const std::string& path,
     auto& info = map_item.second;
     VLOG(3) << "Add function type: " << FLAGS_jit_engine_type
             << " Function name: " << func_name;
+    LazyEngine::Builder builder;
     if (FLAGS_jit_engine_type == "New") {
-      layer.SetEngine(
-          func_name,
-          utils::MakeEngine<InterpreterEngine>(info, params_dict, place));
+      builder = [info, params_dict, place]() -> std::shared_ptr<BaseEngine> {
+        return utils::MakeEngine<InterpreterEngine>(info, params_dict, place);
+      };
     } else if (FLAGS_jit_engine_type == "Predictor") {
-      layer.SetEngine(
-          info->FunctionName(),
-          utils::MakeEngine<PredictorEngine>(info, params_dict, place));
+      builder = [info, params_dict, place]() -> std::shared_ptr<BaseEngine> {
+        return utils::MakeEngine<PredictorEngine>(info, params_dict, place);
+      };
     } else {
       PD_THROW("Invalid JitLayer engine type.");
     }
+    if (FLAGS_jit_lazy_engine) {
+      auto engine = std::make_shared<LazyEngine>(func_name, builder);
+      if (FLAGS_jit_engine_warmup) {
+        engine->Warmup();
+      }
+      layer.SetEngine(func_name, engine);
+    } else {
+      layer.SetEngine(func_name, builder());
+    }
   }
 
   return layer;
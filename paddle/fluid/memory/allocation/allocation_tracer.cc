@@ -0,0 +1,331 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/allocation_tracer.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+#include "paddle/fluid/memory/allocation/naive_best_fit_allocator.h"
+#include "paddle/fluid/memory/allocation/size_class_cpu_allocator.h"
+#include "paddle/fluid/memory/stats.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/os_info.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/memory/allocation/auto_growth_best_fit_allocator_v2.h"
+#include "paddle/fluid/memory/allocation/cuda_allocator.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+#if defined(PADDLE_WITH_HIP) || CUDA_VERSION >= 10020
+#include "paddle/fluid/memory/allocation/cuda_malloc_async_allocator.h"
+#endif
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 10020
+#include "paddle/fluid/memory/allocation/cuda_virtual_mem_allocator.h"
+#include "paddle/fluid/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
+#endif
+#endif
+
+COMMON_DECLARE_int64(allocation_trace_capacity);
+COMMON_DECLARE_uint64(auto_growth_chunk_size_in_mb);
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+std::atomic<bool> AllocationTracer::enabled_{false};
+
+// the op the allocations of the current thread are made for
+static thread_local int32_t tls_op_id = -1;
+
+AllocationTracer& AllocationTracer::Instance() {
+  static AllocationTracer tracer;
+  return tracer;
+}
+
+AllocationTracer::AllocationTracer() {
+  if (FLAGS_allocation_trace_capacity > 0) {
+    Enable(FLAGS_allocation_trace_capacity);
+  }
+}
+
+void AllocationTracer::Enable(size_t capacity) {
+  PADDLE_ENFORCE_GT(capacity,
+                    0UL,
+                    platform::errors::InvalidArgument(
+                        "The capacity of the allocation trace should be "
+                        "greater than 0."));
+  std::lock_guard<SpinLock> guard(lock_);
+  events_.assign(capacity, AllocationEvent());
+  next_ = 0;
+  wrapped_ = false;
+  enabled_ = true;
+  VLOG(1) << "Enable the allocation trace of " << capacity << " events";
+}
+
+void AllocationTracer::Disable() { enabled_ = false; }
+
+void AllocationTracer::Record(bool is_alloc,
+                              const phi::Allocation& allocation,
+                              uint64_t stream) {
+  AllocationEvent event;
+  event.timestamp_ns = phi::PosixInNsec();
+  event.ptr = reinterpret_cast<uint64_t>(allocation.ptr());
+  event.size = allocation.size();
+  event.stream = stream;
+  event.op_id = tls_op_id;
+  event.device_id = static_cast<int16_t>(allocation.place().GetDeviceId());
+  event.place_type = static_cast<int8_t>(allocation.place().GetType());
+  event.is_alloc = is_alloc;
+
+  std::lock_guard<SpinLock> guard(lock_);
+  if (events_.empty()) {
+    return;
+  }
+  events_[next_] = event;
+  if (++next_ == events_.size()) {
+    next_ = 0;
+    wrapped_ = true;
+  }
+}
+
+std::vector<AllocationEvent> AllocationTracer::Events() {
+  std::lock_guard<SpinLock> guard(lock_);
+  std::vector<AllocationEvent> events;
+  if (wrapped_) {
+    events.assign(events_.begin() + next_, events_.end());
+  }
+  events.insert(events.end(), events_.begin(), events_.begin() + next_);
+  return events;
+}
+
+std::vector<std::string> AllocationTracer::OpNames() {
+  std::lock_guard<std::mutex> guard(op_mutex_);
+  return op_names_;
+}
+
+int32_t AllocationTracer::OpId(const std::string& op_name) {
+  std::lock_guard<std::mutex> guard(op_mutex_);
+  auto it = op_ids_.find(op_name);
+  if (it != op_ids_.end()) {
+    return it->second;
+  }
+  int32_t id = static_cast<int32_t>(op_names_.size());
+  op_names_.push_back(op_name);
+  op_ids_.emplace(op_name, id);
+  return id;
+}
+
+void AllocationTracer::Dump(const std::string& path) {
+  auto events = Events();
+  auto op_names = OpNames();
+  std::ofstream os(path);
+  PADDLE_ENFORCE_EQ(
+      os.is_open(),
+      true,
+      platform::errors::Unavailable(
+          "Cannot open %s to dump the allocation trace.", path));
+  os << "# paddle allocation trace\n"
+     << "# op <op_id> <name>\n"
+     << "# ev <timestamp_ns> <a|f> <place_type> <device_id> <stream> <ptr> "
+        "<size> <op_id>\n";
+  for (size_t i = 0; i < op_names.size(); ++i) {
+    os << "op " << i << " " << op_names[i] << "\n";
+  }
+  for (auto& event : events) {
+    os << "ev " << event.timestamp_ns << " " << (event.is_alloc ? "a" : "f")
+       << " " << static_cast<int>(event.place_type) << " " << event.device_id
+       << " " << event.stream << " " << event.ptr << " " << event.size << " "
+       << event.op_id << "\n";
+  }
+  VLOG(1) << "Dump " << events.size() << " allocation events to " << path;
+}
+
+AllocationTracer::OpGuard::OpGuard(const std::string& op_name)
+    : enabled_(AllocationTracer::IsEnabled()), prev_op_id_(tls_op_id) {
+  if (enabled_) {
+    tls_op_id = AllocationTracer::Instance().OpId(op_name);
+  }
+}
+
+AllocationTracer::OpGuard::~OpGuard() {
+  if (enabled_) {
+    tls_op_id = prev_op_id_;
+  }
+}
+
+void LoadAllocationTrace(const std::string& path,
+                         std::vector<AllocationEvent>* events,
+                         std::vector<std::string>* op_names) {
+  std::ifstream is(path);
+  PADDLE_ENFORCE_EQ(
+      is.is_open(),
+      true,
+      platform::errors::NotFound("Cannot open the allocation trace %s.", path));
+  events->clear();
+  op_names->clear();
+  std::string line;
+  while (std::getline(is, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream ss(line);
+    std::string tag;
+    ss >> tag;
+    if (tag == "op") {
+      size_t id = 0;
+      std::string name;
+      ss >> id >> name;
+      if (op_names->size() <= id) {
+        op_names->resize(id + 1);
+      }
+      (*op_names)[id] = name;
+      continue;
+    }
+    AllocationEvent event;
+    std::string type;
+    int place_type = 0;
+    ss >> event.timestamp_ns >> type >> place_type >> event.device_id >>
+        event.stream >> event.ptr >> event.size >> event.op_id;
+    PADDLE_ENFORCE_EQ(
+        tag == "ev" && !ss.fail() && (type == "a" || type == "f"),
+        true,
+        platform::errors::InvalidArgument(
+            "Malformed line in the allocation trace %s: %s", path, line));
+    event.place_type = static_cast<int8_t>(place_type);
+    event.is_alloc = type == "a";
+    events->push_back(event);
+  }
+}
+
+static int64_t ReservedSize(const platform::Place& place) {
+  if (platform::is_cpu_place(place) || platform::is_cuda_pinned_place(place)) {
+    return HOST_MEMORY_STAT_CURRENT_VALUE(Reserved, place.GetDeviceId());
+  }
+  return DEVICE_MEMORY_STAT_CURRENT_VALUE(Reserved, place.GetDeviceId());
+}
+
+AllocationReplayResult ReplayAllocationTrace(
+    const std::vector<AllocationEvent>& events,
+    const std::vector<std::string>& op_names,
+    const platform::Place& place,
+    const std::shared_ptr<Allocator>& allocator) {
+  AllocationReplayResult result;
+  // the allocations of the trace by the address they got when traced
+  std::unordered_map<uint64_t, std::pair<AllocationPtr, uint64_t>> live;
+  int64_t allocated = 0;
+  int64_t base_reserved = ReservedSize(place);
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto& event : events) {
+    if (event.place_type != static_cast<int8_t>(place.GetType()) ||
+        event.device_id != place.GetDeviceId()) {
+      continue;
+    }
+    auto it = live.find(event.ptr);
+    if (it != live.end()) {
+      // a free, or an allocation whose free fell out of the ring buffer
+      allocated -= it->second.second;
+      live.erase(it);
+    }
+    if (!event.is_alloc) {
+      continue;
+    }
+
+    ++result.alloc_num;
+    try {
+      live.emplace(event.ptr,
+                   std::make_pair(allocator->Allocate(event.size), event.size));
+    } catch (BadAlloc&) {
+      if (result.failed_num++ == 0 && event.op_id >= 0 &&
+          static_cast<size_t>(event.op_id) < op_names.size()) {
+        result.first_failed_op = op_names[event.op_id];
+      }
+      continue;
+    }
+    allocated += event.size;
+    result.peak_allocated = std::max(result.peak_allocated, allocated);
+    result.peak_reserved =
+        std::max(result.peak_reserved, ReservedSize(place) - base_reserved);
+  }
+  live.clear();
+  result.elapsed_ms = std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+  return result;
+}
+
+std::shared_ptr<Allocator> CreateReplayAllocator(const std::string& strategy,
+                                                 const platform::Place& place) {
+  if (platform::is_cpu_place(place)) {
+    // the facade uses CPUAllocator on CPU for the other strategies
+    if (strategy == "size_class") {
+      return std::make_shared<SizeClassCPUAllocator>(
+          std::make_shared<CPUAllocator>());
+    }
+    if (strategy == "naive_best_fit" || strategy == "auto_growth") {
+      return std::make_shared<CPUAllocator>();
+    }
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (platform::is_gpu_place(place)) {
+    platform::CUDAPlace p(place.GetDeviceId());
+    size_t chunk_size = FLAGS_auto_growth_chunk_size_in_mb << 20;
+    if (strategy == "naive_best_fit") {
+      return std::make_shared<NaiveBestFitAllocator>(place);
+    }
+    if (strategy == "auto_growth" || strategy == "size_class") {
+      return std::make_shared<AutoGrowthBestFitAllocator>(
+          std::make_shared<CUDAAllocator>(p),
+          platform::GpuMinChunkSize(),
+          chunk_size);
+    }
+    if (strategy == "auto_growth_v2") {
+      return std::make_shared<AutoGrowthBestFitAllocatorV2>(
+          std::make_shared<CUDAAllocator>(p),
+          platform::GpuMinChunkSize(),
+          p,
+          chunk_size);
+    }
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 10020
+    if (strategy == "virtual_memory") {
+      return std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
+          std::make_shared<CUDAVirtualMemAllocator>(p),
+          platform::GpuMinChunkSize(),
+          p);
+    }
+#endif
+#if defined(PADDLE_WITH_HIP) || CUDA_VERSION >= 10020
+    if (strategy == "cuda_malloc_async") {
+      return std::make_shared<CUDAMallocAsyncAllocator>(
+          std::make_shared<CUDAAllocator>(p), p, /*default_stream=*/nullptr);
+    }
+#endif
+  }
+#endif
+  PADDLE_THROW(platform::errors::Unimplemented(
+      "Replaying the allocation trace with strategy %s on %s is not "
+      "supported.",
+      strategy,
+      place));
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
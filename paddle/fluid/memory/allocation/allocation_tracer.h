@@ -0,0 +1,131 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/spin_lock.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+struct AllocationEvent {
+  uint64_t timestamp_ns;
+  uint64_t ptr;
+  uint64_t size;
+  uint64_t stream;
+  // index into the op names of the trace, -1 outside of any op
+  int32_t op_id;
+  int16_t device_id;
+  int8_t place_type;  // phi::AllocationType
+  bool is_alloc;
+};
+
+// Records the allocations and frees that go through the StatAllocators of
+// AllocatorFacade into a ring buffer, the last `capacity` events are kept.
+// FLAGS_allocation_trace_capacity > 0 enables it from the start. A dumped
+// trace can be replayed against the allocators of each strategy offline, see
+// tools/replay_allocation_trace.py.
+class AllocationTracer {
+ public:
+  static AllocationTracer& Instance();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // drops the events recorded so far
+  void Enable(size_t capacity);
+  void Disable();
+
+  void Record(bool is_alloc,
+              const phi::Allocation& allocation,
+              uint64_t stream);
+
+  // the events kept, oldest first
+  std::vector<AllocationEvent> Events();
+  std::vector<std::string> OpNames();
+
+  // writes the trace as text, the events after the op names
+  void Dump(const std::string& path);
+
+  // makes the allocations of this thread be recorded for op_name
+  class OpGuard {
+   public:
+    explicit OpGuard(const std::string& op_name);
+    ~OpGuard();
+
+   private:
+    bool enabled_;
+    int32_t prev_op_id_;
+  };
+
+ private:
+  AllocationTracer();
+  int32_t OpId(const std::string& op_name);
+
+  static std::atomic<bool> enabled_;
+
+  SpinLock lock_;
+  std::vector<AllocationEvent> events_;
+  size_t next_ = 0;
+  bool wrapped_ = false;
+
+  std::mutex op_mutex_;
+  std::unordered_map<std::string, int32_t> op_ids_;
+  std::vector<std::string> op_names_;
+};
+
+void LoadAllocationTrace(const std::string& path,
+                         std::vector<AllocationEvent>* events,
+                         std::vector<std::string>* op_names);
+
+struct AllocationReplayResult {
+  size_t alloc_num = 0;
+  size_t failed_num = 0;
+  int64_t peak_allocated = 0;
+  // from the Reserved memory stat of the place, so it covers the memory the
+  // allocator keeps for itself
+  int64_t peak_reserved = 0;
+  double elapsed_ms = 0;
+  std::string first_failed_op;
+};
+
+// Replays the events of place against allocator, the frees of allocations not
+// in the trace are skipped and the streams are not replayed. A failed
+// allocation is counted and its free skipped.
+AllocationReplayResult ReplayAllocationTrace(
+    const std::vector<AllocationEvent>& events,
+    const std::vector<std::string>& op_names,
+    const platform::Place& place,
+    const std::shared_ptr<Allocator>& allocator);
+
+// The allocator FLAGS_allocator_strategy=strategy would build for place,
+// without the stream safe, retry and stat wrappers. strategy is one of
+// naive_best_fit, auto_growth, auto_growth_v2, virtual_memory,
+// cuda_malloc_async and size_class, depending on place and build.
+std::shared_ptr<Allocator> CreateReplayAllocator(const std::string& strategy,
+                                                 const platform::Place& place);
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
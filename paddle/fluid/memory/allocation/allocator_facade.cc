@@ -24,6 +24,7 @@
 #include "paddle/fluid/memory/allocation/cpu_allocator.h"
 #include "paddle/fluid/memory/allocation/naive_best_fit_allocator.h"
 #include "paddle/fluid/memory/allocation/retry_allocator.h"
+#include "paddle/fluid/memory/allocation/size_class_cpu_allocator.h"
 #include "paddle/fluid/memory/allocation/stat_allocator.h"
 #include "paddle/fluid/platform/device_context.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -70,6 +71,7 @@
 #endif
 
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
+#include "paddle/fluid/memory/allocation/custom_allocator.h"
 #include "paddle/fluid/memory/allocation/stream_safe_custom_device_allocator.h"
 #endif
 
@@ -115,6 +117,9 @@ COMMON_DECLARE_uint64(auto_growth_chunk_size_in_mb);
 COMMON_DECLARE_bool(use_auto_growth_pinned_allocator);
 COMMON_DECLARE_bool(use_cuda_malloc_async_allocator);
 COMMON_DECLARE_bool(auto_free_cudagraph_allocations_on_launch);
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+COMMON_DECLARE_bool(custom_device_stream_ordered_allocator);
+#endif
 
 namespace paddle {
 namespace memory {
@@ -235,8 +240,12 @@ class AllocatorFacadePrivate {
         break;
       }
 
-      case AllocatorStrategy::kAutoGrowth: {
+      case AllocatorStrategy::kAutoGrowth:
+      case AllocatorStrategy::kSizeClass: {
         InitNaiveBestFitCPUAllocator();
+        if (strategy_ == AllocatorStrategy::kSizeClass) {
+          WrapSizeClassCPUAllocator();
+        }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
         allow_free_idle_chunk_ = allow_free_idle_chunk;
         for (int dev_id = 0; dev_id < platform::GetGPUDeviceCount(); ++dev_id) {
@@ -338,6 +347,8 @@ class AllocatorFacadePrivate {
       WrapCUDARetryAllocator(FLAGS_gpu_allocator_retry_time);
     }
 
+    // reads FLAGS_allocation_trace_capacity before the first allocation
+    AllocationTracer::Instance();
     WrapStatAllocator();
 
     CheckAllocThreadSafe();
@@ -804,6 +815,11 @@ class AllocatorFacadePrivate {
 #endif
   }
 
+  void WrapSizeClassCPUAllocator() {
+    allocators_[platform::CPUPlace()] = std::make_shared<SizeClassCPUAllocator>(
+        allocators_[platform::CPUPlace()]);
+  }
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   void InitNaiveBestFitCUDAPinnedAllocator() {
     if (FLAGS_use_auto_growth_pinned_allocator) {
@@ -831,8 +847,8 @@ class AllocatorFacadePrivate {
   std::shared_ptr<Allocator> CreateCUDAAllocator(platform::CUDAPlace p) {
     if (FLAGS_use_cuda_managed_memory) {
       PADDLE_ENFORCE_EQ(
-          strategy_,
-          AllocatorStrategy::kAutoGrowth,
+          IsAutoGrowthStrategy(strategy_),
+          true,
           platform::errors::InvalidArgument(
               "CUDA managed memory is only implemented for auto_growth "
               "strategy, not support %s strategy.\n"
@@ -858,8 +874,8 @@ class AllocatorFacadePrivate {
 
   void InitStreamSafeCUDAAllocator(platform::CUDAPlace p, gpuStream_t stream) {
     PADDLE_ENFORCE_EQ(
-        strategy_,
-        AllocatorStrategy::kAutoGrowth,
+        IsAutoGrowthStrategy(strategy_),
+        true,
         platform::errors::Unimplemented(
             "Only support auto-growth strategy for StreamSafeCUDAAllocator, "
             "the allocator strategy %d is unsupported for multi-stream",
@@ -1190,7 +1206,8 @@ class AllocatorFacadePrivate {
 
   void WrapStatAllocator(platform::CUDAPlace p, gpuStream_t stream) {
     std::shared_ptr<Allocator>& allocator = cuda_allocators_[p][stream];
-    allocator = std::make_shared<StatAllocator>(allocator);
+    allocator = std::make_shared<StatAllocator>(
+        allocator, reinterpret_cast<uint64_t>(stream));
   }
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -1226,8 +1243,8 @@ class AllocatorFacadePrivate {
 
   void InitStreamSafeXPUAllocator(platform::XPUPlace p, XPUStream stream) {
     PADDLE_ENFORCE_EQ(
-        strategy_,
-        AllocatorStrategy::kAutoGrowth,
+        IsAutoGrowthStrategy(strategy_),
+        true,
         platform::errors::Unimplemented(
             "Only support auto-growth strategy for StreamSafeXPUAllocator, "
             "the allocator strategy %d is unsupported for multi-stream",
@@ -1313,7 +1330,8 @@ class AllocatorFacadePrivate {
 
   void WrapStatAllocator(platform::XPUPlace p, XPUStream stream) {
     std::shared_ptr<Allocator>& allocator = xpu_allocators_[p][stream];
-    allocator = std::make_shared<StatAllocator>(allocator);
+    allocator = std::make_shared<StatAllocator>(
+        allocator, reinterpret_cast<uint64_t>(stream));
   }
 
 #endif
@@ -1337,8 +1355,8 @@ class AllocatorFacadePrivate {
   void InitStreamSafeCustomDeviceAllocator(platform::CustomPlace p,
                                            phi::stream::stream_t stream) {
     PADDLE_ENFORCE_EQ(
-        strategy_,
-        AllocatorStrategy::kAutoGrowth,
+        IsAutoGrowthStrategy(strategy_),
+        true,
         platform::errors::Unimplemented(
             "Only support auto-growth strategy for "
             "StreamSafeCustomDeviceAllocator, "
@@ -1358,6 +1376,11 @@ class AllocatorFacadePrivate {
     VLOG(4) << "FLAGS_auto_growth_chunk_size_in_mb is "
             << FLAGS_auto_growth_chunk_size_in_mb;
 
+    if (IsStreamOrderedCustomDeviceAllocatorUsed(p)) {
+      custom_device_allocators_[p][stream] =
+          std::make_shared<StreamOrderedCustomAllocator>(p, stream);
+      return;
+    }
     auto custom_allocator =
         std::make_shared<paddle::memory::allocation::CustomAllocator>(p);
     auto alignment = phi::DeviceManager::GetMinChunkSize(p);
@@ -1375,6 +1398,12 @@ class AllocatorFacadePrivate {
     auto chunk_size = FLAGS_auto_growth_chunk_size_in_mb << 20;
     VLOG(4) << "FLAGS_auto_growth_chunk_size_in_mb is "
             << FLAGS_auto_growth_chunk_size_in_mb;
+    if (IsStreamOrderedCustomDeviceAllocatorUsed(p)) {
+      // the stream of the device context
+      allocators_[p] =
+          std::make_shared<StreamOrderedCustomAllocator>(p, nullptr);
+      return;
+    }
     auto custom_allocator =
         std::make_shared<paddle::memory::allocation::CustomAllocator>(p);
     allocators_[p] = std::make_shared<AutoGrowthBestFitAllocator>(
@@ -1385,6 +1414,14 @@ class AllocatorFacadePrivate {
         phi::DeviceManager::GetExtraPaddingSize(p));
   }
 
+  // The plugin pools the memory of the stream-ordered allocator itself, so it
+  // replaces the auto growth allocator instead of being wrapped by it.
+  bool IsStreamOrderedCustomDeviceAllocatorUsed(platform::CustomPlace p) {
+    return FLAGS_custom_device_stream_ordered_allocator &&
+           phi::DeviceManager::GetDeviceWithPlace(p)
+               ->IsStreamOrderedAllocatorSupported();
+  }
+
   void WrapStreamSafeCustomDeviceAllocatorForDefault() {
     for (auto& pair : allocators_) {
       auto& place = pair.first;
@@ -1611,8 +1648,8 @@ const std::shared_ptr<Allocator>& AllocatorFacade::GetAllocator(
 
 void* AllocatorFacade::GetBasePtr(
     const std::shared_ptr<phi::Allocation>& allocation) {
-  PADDLE_ENFORCE_EQ(GetAllocatorStrategy(),
-                    AllocatorStrategy::kAutoGrowth,
+  PADDLE_ENFORCE_EQ(IsAutoGrowthStrategy(GetAllocatorStrategy()),
+                    true,
                     paddle::platform::errors::Unimplemented(
                         "GetBasePtr() is only implemented for auto_growth "
                         "strategy, not support allocator strategy: %d",
@@ -1777,8 +1814,8 @@ void AllocatorFacade::SetDefaultStream(const platform::CUDAPlace& place,
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 void AllocatorFacade::PrepareMemoryPoolForCUDAGraph(int64_t id) {
-  PADDLE_ENFORCE_EQ(GetAllocatorStrategy(),
-                    AllocatorStrategy::kAutoGrowth,
+  PADDLE_ENFORCE_EQ(IsAutoGrowthStrategy(GetAllocatorStrategy()),
+                    true,
                     platform::errors::InvalidArgument(
                         "CUDA Graph is only supported when the "
                         "FLAGS_allocator_strategy=\"auto_growth\", but got "
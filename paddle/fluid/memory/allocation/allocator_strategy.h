@@ -19,7 +19,19 @@ namespace paddle {
 namespace memory {
 namespace allocation {
 
-enum class AllocatorStrategy { kNaiveBestFit, kAutoGrowth, kThreadLocal };
+enum class AllocatorStrategy {
+  kNaiveBestFit,
+  kAutoGrowth,
+  kThreadLocal,
+  // auto_growth on devices, SizeClassCPUAllocator on CPU
+  kSizeClass
+};
+
+// whether the device allocators are the auto_growth ones
+inline bool IsAutoGrowthStrategy(AllocatorStrategy strategy) {
+  return strategy == AllocatorStrategy::kAutoGrowth ||
+         strategy == AllocatorStrategy::kSizeClass;
+}
 
 extern AllocatorStrategy GetAllocatorStrategy();
 
@@ -21,6 +21,7 @@
 #include "paddle/fluid/platform/flags.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/phi/backends/device_manager.h"
+#include "paddle/phi/core/metrics.h"
 
 PADDLE_DEFINE_EXPORTED_READONLY_bool(
     free_idle_chunk,
@@ -106,10 +107,18 @@ phi::Allocation *AutoGrowthBestFitAllocator::AllocateImpl(
       chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
           underlying_allocator_->Allocate(realloc_size)));
     } catch (BadAlloc &ex) {
-      if (FLAGS_free_when_no_cache_hit) throw ex;
+      if (FLAGS_free_when_no_cache_hit) {
+        ReportAllocationFailure(realloc_size);
+        throw ex;
+      }
       FreeIdleChunks();
-      chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
-          underlying_allocator_->Allocate(realloc_size)));
+      try {
+        chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
+            underlying_allocator_->Allocate(realloc_size)));
+      } catch (BadAlloc &) {
+        ReportAllocationFailure(realloc_size);
+        throw;
+      }
     }
 
     auto *chunk = &(*chunks_.rbegin());
@@ -126,6 +135,7 @@ phi::Allocation *AutoGrowthBestFitAllocator::AllocateImpl(
     block_it = --(blocks.end());
     VLOG(2) << "Not found and reallocate " << realloc_size << "("
             << static_cast<void *>(p) << "), and remaining " << remaining_size;
+    UpdateFragmentationMetrics(chunk->allocation_->place());
   }
   ++total_alloc_times_;
   total_alloc_size_ += size;
@@ -203,6 +213,48 @@ uint64_t AutoGrowthBestFitAllocator::FreeIdleChunks() {
   return bytes;
 }
 
+FragmentationReport AutoGrowthBestFitAllocator::GetFragmentationReport() {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  return CollectFragmentationReport();
+}
+
+FragmentationReport AutoGrowthBestFitAllocator::CollectFragmentationReport()
+    const {
+  FragmentationReport report;
+  for (auto &chunk : chunks_) {
+    report.AddChunk();
+    for (auto &block : chunk.blocks_) {
+      report.AddBlock(block.size_, block.is_free_);
+    }
+  }
+  return report;
+}
+
+void AutoGrowthBestFitAllocator::UpdateFragmentationMetrics(
+    const platform::Place &place) const {
+  // Only on growing, collecting the report walks all the blocks.
+  auto report = CollectFragmentationReport();
+  auto &registry = phi::MetricsRegistry::Instance();
+  std::string labels = "place=\"" + place.DebugString() + "\"";
+  registry
+      .GetGauge("paddle_allocator_reserved_bytes",
+                "Bytes reserved by the auto growth allocator.",
+                labels)
+      ->Set(static_cast<double>(report.ReservedSize()));
+  registry
+      .GetGauge("paddle_allocator_fragmentation",
+                "1 - largest free block / free bytes of the auto growth "
+                "allocator, when it last grew.",
+                labels)
+      ->Set(report.Fragmentation());
+}
+
+void AutoGrowthBestFitAllocator::ReportAllocationFailure(size_t size) const {
+  LOG(WARNING) << "AutoGrowthBestFitAllocator failed to allocate a chunk of "
+               << size << " bytes, "
+               << CollectFragmentationReport().ToString();
+}
+
 void AutoGrowthBestFitAllocator::Trace() const {
   size_t cur_idle_bytes = 0;
   auto it = free_blocks_.begin();
@@ -223,6 +275,7 @@ void AutoGrowthBestFitAllocator::Trace() const {
           << " free_times:" << total_free_times_
           << " free_blocks_num:" << free_blocks_.size()
           << " curr_chunks_num:" << chunks_.size();
+  VLOG(1) << CollectFragmentationReport().ToString();
 }
 
 }  // namespace allocation
@@ -21,6 +21,7 @@
 #include <utility>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/fragmentation_report.h"
 #include "paddle/fluid/memory/allocation/spin_lock.h"
 
 namespace paddle {
@@ -38,6 +39,8 @@ class AutoGrowthBestFitAllocator : public Allocator {
 
   bool IsAllocThreadSafe() const override { return true; }
 
+  FragmentationReport GetFragmentationReport();
+
  protected:
   phi::Allocation *AllocateImpl(size_t size) override;
 
@@ -51,6 +54,12 @@ class AutoGrowthBestFitAllocator : public Allocator {
  protected:
   uint64_t FreeIdleChunks();
   void Trace() const;
+  // with spinlock_ held
+  FragmentationReport CollectFragmentationReport() const;
+  // logs why the underlying allocator failed to allocate a chunk of size
+  void ReportAllocationFailure(size_t size) const;
+  // with spinlock_ held, sets the fragmentation gauges of the place
+  void UpdateFragmentationMetrics(const platform::Place &place) const;
 
   template <typename T>
   using List = std::list<T>;
@@ -134,10 +134,18 @@ phi::Allocation *AutoGrowthBestFitAllocatorV2::AllocateImpl(
         chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
             underlying_allocator_->Allocate(realloc_size)));
       } catch (BadAlloc &ex) {
-        if (FLAGS_free_when_no_cache_hit) throw ex;
+        if (FLAGS_free_when_no_cache_hit) {
+          ReportAllocationFailure(realloc_size);
+          throw ex;
+        }
         FreeIdleChunks();
-        chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
-            underlying_allocator_->Allocate(realloc_size)));
+        try {
+          chunks_.emplace_back(static_unique_ptr_cast<Allocation>(
+              underlying_allocator_->Allocate(realloc_size)));
+        } catch (BadAlloc &) {
+          ReportAllocationFailure(realloc_size);
+          throw;
+        }
       }
 
       auto *chunk = &(*chunks_.rbegin());
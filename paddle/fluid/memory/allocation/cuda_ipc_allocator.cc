@@ -17,14 +17,23 @@
 #include "paddle/fluid/memory/allocation/cuda_ipc_allocator.h"
 
 #include <fcntl.h>
+#include <signal.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
 #include <cstdlib>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <random>
 #include <string>
+#include <thread>
 
 #include "glog/logging.h"
 #include "paddle/fluid/platform/cuda_device_guard.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/enforce.h"
 
 namespace paddle {
@@ -73,6 +82,208 @@ CudaIpcAllocation::~CudaIpcAllocation() {
           << "\t" << this->ptr();
 }
 
+// lives in the shared memory segment, zeroed by ftruncate
+struct SharedDeviceRegion::Header {
+  enum State : int32_t { kInitializing = 0, kReady = 1, kFailed = 2 };
+
+  std::atomic<int32_t> state;
+  int32_t owner_pid;
+  int32_t device_id;
+  uint64_t size;
+  cudaIpcMemHandle_t handle;
+};
+
+std::shared_ptr<SharedDeviceRegion> SharedDeviceRegion::Open(
+    const std::string &name, size_t size, const platform::CUDAPlace &place) {
+  return std::shared_ptr<SharedDeviceRegion>(
+      new SharedDeviceRegion(name, size, place));
+}
+
+SharedDeviceRegion::SharedDeviceRegion(const std::string &name,
+                                       size_t size,
+                                       const platform::CUDAPlace &place)
+    : shm_name_("/paddle_shared_region_" + name), size_(size), place_(place) {
+  int fd = shm_open(shm_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd != -1) {
+    owner_ = true;
+    Create(fd);
+  } else {
+    PADDLE_ENFORCE_EQ(errno,
+                      EEXIST,
+                      platform::errors::Unavailable(
+                          "Fail to open the shared memory segment %s.",
+                          shm_name_));
+    fd = shm_open(shm_name_.c_str(), O_RDWR, 0600);
+    PADDLE_ENFORCE_NE(fd,
+                      -1,
+                      platform::errors::Unavailable(
+                          "Fail to open the shared memory segment %s.",
+                          shm_name_));
+    Attach(fd);
+  }
+}
+
+void SharedDeviceRegion::Create(int fd) {
+  void *ptr = nullptr;
+  if (ftruncate(fd, sizeof(Header)) == 0) {
+    ptr = mmap(nullptr,
+               sizeof(Header),
+               PROT_READ | PROT_WRITE,
+               MAP_SHARED,
+               fd,
+               0);
+  }
+  close(fd);
+  if (ptr == nullptr || ptr == MAP_FAILED) {
+    shm_unlink(shm_name_.c_str());
+    PADDLE_THROW(platform::errors::Unavailable(
+        "Fail to map the shared memory segment %s.", shm_name_));
+  }
+  header_ = static_cast<Header *>(ptr);
+  header_->owner_pid = getpid();
+  header_->device_id = place_.device;
+  header_->size = size_;
+
+  void *base = nullptr;
+  int device_id = place_.device;
+  size_t size = size_;
+  auto result =
+      platform::RecordedGpuMalloc(&base, std::max<size_t>(size, 1), device_id);
+  if (result != cudaSuccess) {
+    // let the processes waiting for the region fail fast
+    header_->state.store(Header::kFailed, std::memory_order_release);
+    shm_unlink(shm_name_.c_str());
+    munmap(header_, sizeof(Header));
+    header_ = nullptr;
+    PADDLE_ENFORCE_GPU_SUCCESS(result);
+  }
+  base_ = std::shared_ptr<void>(base, [size, device_id](void *ptr) {
+    platform::RecordedGpuFree(ptr, std::max<size_t>(size, 1), device_id);
+  });
+  VLOG(1) << "Create the shared device region " << shm_name_ << " of "
+          << size_ << " bytes on " << place_;
+}
+
+void SharedDeviceRegion::Attach(int fd) {
+  // the owner may not have sized the segment yet
+  constexpr int kTimeoutSeconds = 600;
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(kTimeoutSeconds);
+  auto wait = [&](const char *what) {
+    PADDLE_ENFORCE_LT(std::chrono::steady_clock::now(),
+                      deadline,
+                      platform::errors::Unavailable(
+                          "Timeout waiting for %s of the shared device "
+                          "region %s.",
+                          what,
+                          shm_name_));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  };
+  struct stat shm_stat;
+  while (fstat(fd, &shm_stat) == 0 &&
+         static_cast<size_t>(shm_stat.st_size) < sizeof(Header)) {
+    wait("the creation");
+  }
+  void *ptr = mmap(
+      nullptr, sizeof(Header), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  PADDLE_ENFORCE_NE(ptr,
+                    MAP_FAILED,
+                    platform::errors::Unavailable(
+                        "Fail to map the shared memory segment %s.",
+                        shm_name_));
+  header_ = static_cast<Header *>(ptr);
+
+  while (header_->state.load(std::memory_order_acquire) ==
+         Header::kInitializing) {
+    PADDLE_ENFORCE_EQ(
+        header_->owner_pid == 0 || kill(header_->owner_pid, 0) == 0 ||
+            errno != ESRCH,
+        true,
+        platform::errors::Unavailable(
+            "The process creating the shared device region %s exited "
+            "before it was ready, remove /dev/shm%s and retry.",
+            shm_name_,
+            shm_name_));
+    wait("the parameters");
+  }
+  PADDLE_ENFORCE_EQ(header_->state.load(),
+                    Header::kReady,
+                    platform::errors::Unavailable(
+                        "The process creating the shared device region %s "
+                        "failed to fill it.",
+                        shm_name_));
+  PADDLE_ENFORCE_EQ(
+      header_->size,
+      size_,
+      platform::errors::InvalidArgument(
+          "The shared device region %s has %d bytes, but %d are expected, "
+          "the processes sharing it should load the same parameters.",
+          shm_name_,
+          header_->size,
+          size_));
+  PADDLE_ENFORCE_EQ(
+      header_->device_id,
+      place_.device,
+      platform::errors::InvalidArgument(
+          "The shared device region %s is on GPU %d, but GPU %d is used.",
+          shm_name_,
+          header_->device_id,
+          place_.device));
+
+  platform::CUDADeviceGuard guard(place_.device);
+  base_ = GetIpcBasePtr(
+      std::string(reinterpret_cast<const char *>(&header_->handle),
+                  sizeof(header_->handle)));
+  ready_ = true;
+  VLOG(1) << "Attach the shared device region " << shm_name_ << " of "
+          << size_ << " bytes on " << place_;
+}
+
+void SharedDeviceRegion::MarkReady() {
+  PADDLE_ENFORCE_EQ(owner_,
+                    true,
+                    platform::errors::PreconditionNotMet(
+                        "Only the process creating the shared device region "
+                        "%s can mark it ready.",
+                        shm_name_));
+  platform::CUDADeviceGuard guard(place_.device);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaIpcGetMemHandle(&header_->handle, ptr()));
+  header_->state.store(Header::kReady, std::memory_order_release);
+  ready_ = true;
+}
+
+std::shared_ptr<phi::Allocation> SharedDeviceRegion::Slice(size_t offset,
+                                                           size_t size) {
+  PADDLE_ENFORCE_LE(offset + size,
+                    size_,
+                    platform::errors::OutOfRange(
+                        "The slice [%d, %d) is out of the shared device "
+                        "region of %d bytes.",
+                        offset,
+                        offset + size,
+                        size_));
+  return std::make_shared<CudaIpcAllocation>(
+      static_cast<char *>(ptr()) + offset,
+      size,
+      place_.device,
+      std::shared_ptr<void>(shared_from_this()));
+}
+
+SharedDeviceRegion::~SharedDeviceRegion() {
+  if (owner_ && header_ != nullptr) {
+    if (!ready_) {
+      header_->state.store(Header::kFailed, std::memory_order_release);
+    }
+    // the processes still mapping the region keep using it, new ones create
+    // their own
+    shm_unlink(shm_name_.c_str());
+  }
+  if (header_ != nullptr) {
+    munmap(header_, sizeof(Header));
+  }
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -51,6 +51,52 @@ class CudaIpcAllocation : public Allocation {
   std::shared_ptr<void> shared_ptr_;
 };
 
+// A named region of device memory shared by the processes of a host that
+// load the same parameters, e.g. several serving replicas.
+//
+// The first process to open name allocates the region, fills it and calls
+// MarkReady() to publish its CUDA IPC handle through a POSIX shared memory
+// segment. The other processes wait for it and map the same device memory.
+// As with any CUDA IPC memory, the owning process has to outlive the ones
+// mapping the region.
+class SharedDeviceRegion
+    : public std::enable_shared_from_this<SharedDeviceRegion> {
+ public:
+  // size has to be the same in every process opening name
+  static std::shared_ptr<SharedDeviceRegion> Open(
+      const std::string &name, size_t size, const platform::CUDAPlace &place);
+
+  ~SharedDeviceRegion();
+
+  // whether this process allocated the region and has to fill it
+  bool IsOwner() const { return owner_; }
+  void *ptr() const { return base_.get(); }
+  size_t size() const { return size_; }
+
+  // owner only, once the region is filled
+  void MarkReady();
+
+  // size bytes at offset of the region, which stays alive with it
+  std::shared_ptr<phi::Allocation> Slice(size_t offset, size_t size);
+
+ private:
+  struct Header;
+
+  SharedDeviceRegion(const std::string &name,
+                     size_t size,
+                     const platform::CUDAPlace &place);
+  void Create(int fd);
+  void Attach(int fd);
+
+  std::string shm_name_;
+  size_t size_;
+  platform::CUDAPlace place_;
+  bool owner_ = false;
+  bool ready_ = false;
+  Header *header_ = nullptr;
+  std::shared_ptr<void> base_;
+};
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
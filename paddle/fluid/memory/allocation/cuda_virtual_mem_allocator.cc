@@ -138,6 +138,15 @@ void CUDAVirtualMemAllocator::FreeImpl(phi::Allocation* allocation) {
   }
 
   virtual_2_physical_map_.erase(iter);
+  // the next mapping starts right after the last one left, so it stays
+  // contiguous with it
+  if (virtual_2_physical_map_.empty()) {
+    virtual_mem_alloced_offset_ = 0;
+  } else {
+    auto last = virtual_2_physical_map_.rbegin();
+    virtual_mem_alloced_offset_ =
+        last->first + last->second.second - virtual_mem_base_;
+  }
 
   delete allocation;
 }
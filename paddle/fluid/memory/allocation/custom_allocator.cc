@@ -18,6 +18,7 @@
 #include "paddle/fluid/platform/enforce.h"
 #include "paddle/fluid/platform/profiler.h"
 #include "paddle/fluid/platform/profiler/trace_event.h"
+#include "paddle/phi/backends/context_pool.h"
 
 COMMON_DECLARE_bool(custom_device_mem_record);
 
@@ -86,6 +87,65 @@ phi::Allocation* CustomAllocator::AllocateImpl(size_t size) {
       dev_type));
 }
 
+bool StreamOrderedCustomAllocator::IsAllocThreadSafe() const { return true; }
+
+void StreamOrderedCustomAllocator::FreeImpl(phi::Allocation* allocation) {
+  PADDLE_ENFORCE_EQ(
+      allocation->place(),
+      place_,
+      platform::errors::PermissionDenied("CustomDevice memory is "
+                                         "freed in incorrect device. "
+                                         "This may be a bug"));
+  if (phi::DeviceManager::HasDeviceType(place_.GetDeviceType())) {
+    phi::DeviceManager::GetDeviceWithPlace(place_)->MemoryDeallocateAsync(
+        allocation->ptr(), allocation->size(), stream_.get());
+  }
+  if (FLAGS_custom_device_mem_record) {
+    DEVICE_MEMORY_STAT_UPDATE(
+        Reserved, place_.GetDeviceId(), -allocation->size());
+    platform::RecordMemEvent(allocation->ptr(),
+                             place_,
+                             allocation->size(),
+                             platform::TracerMemEventType::ReservedFree);
+  }
+  delete allocation;
+}
+
+phi::Allocation* StreamOrderedCustomAllocator::AllocateImpl(size_t size) {
+  std::call_once(once_flag_, [this] {
+    phi::DeviceManager::SetDevice(place_);
+    if (raw_stream_ == nullptr) {
+      raw_stream_ = reinterpret_cast<phi::CustomContext*>(
+                        phi::DeviceContextPool::Instance().Get(place_))
+                        ->stream();
+    }
+    stream_ = std::make_unique<phi::stream::Stream>(place_, raw_stream_);
+  });
+
+  void* ptr = phi::DeviceManager::GetDeviceWithPlace(place_)
+                  ->MemoryAllocateAsync(size, stream_.get());
+  if (LIKELY(ptr)) {
+    if (FLAGS_custom_device_mem_record) {
+      DEVICE_MEMORY_STAT_UPDATE(Reserved, place_.GetDeviceId(), size);
+      platform::RecordMemEvent(
+          ptr, place_, size, platform::TracerMemEventType::ReservedAllocate);
+    }
+    return new Allocation(ptr, size, place_);
+  }
+
+  size_t avail, total;
+  phi::DeviceManager::MemoryStats(place_, &total, &avail);
+  PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
+      "\n\nOut of memory error on %s:%d. "
+      "Cannot allocate %s memory on the stream %p, "
+      "available memory is only %s.\n\n",
+      platform::PlaceHelper::GetDeviceType(place_),
+      platform::PlaceHelper::GetDeviceId(place_),
+      string::HumanReadableSize(size),
+      raw_stream_,
+      string::HumanReadableSize(avail)));
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -13,10 +13,12 @@
 // limitations under the License.
 
 #pragma once
+#include <memory>
 #include <mutex>  // NOLINT
 
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/platform/place.h"
+#include "paddle/phi/backends/stream.h"
 
 namespace paddle {
 namespace memory {
@@ -38,6 +40,29 @@ class CustomAllocator : public Allocator {
   std::once_flag once_flag_;
 };
 
+// Allocates through the stream-ordered allocator of the plugin, the memory
+// freed is reused by the work enqueued to the stream afterwards, so neither
+// allocating nor freeing synchronizes the host. A null stream means the
+// stream of the device context.
+class StreamOrderedCustomAllocator : public Allocator {
+ public:
+  StreamOrderedCustomAllocator(const platform::CustomPlace& place,
+                               phi::stream::stream_t stream)
+      : place_(place), raw_stream_(stream) {}
+
+  bool IsAllocThreadSafe() const override;
+
+ protected:
+  void FreeImpl(phi::Allocation* allocation) override;
+  phi::Allocation* AllocateImpl(size_t size) override;
+
+ private:
+  platform::Place place_;
+  phi::stream::stream_t raw_stream_;
+  std::unique_ptr<phi::stream::Stream> stream_;
+  std::once_flag once_flag_;
+};
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
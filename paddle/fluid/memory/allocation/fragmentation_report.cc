@@ -0,0 +1,107 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/fragmentation_report.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "paddle/utils/string/printf.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// the chunks listed by ToString at most
+static constexpr size_t kMaxReportedChunks = 16;
+
+void FragmentationReport::AddChunk() { chunks_.emplace_back(); }
+
+void FragmentationReport::AddBlock(size_t size, bool is_free) {
+  if (chunks_.empty()) {
+    AddChunk();
+  }
+  auto& chunk = chunks_.back();
+  chunk.size += size;
+  reserved_size_ += size;
+  if (!is_free || size == 0) {
+    return;
+  }
+  chunk.free_size += size;
+  chunk.largest_free_block = std::max(chunk.largest_free_block, size);
+  ++chunk.free_block_num;
+  free_size_ += size;
+  largest_free_block_ = std::max(largest_free_block_, size);
+
+  size_t size_class = 0;
+  while ((size >> (size_class + 1)) != 0) {
+    ++size_class;
+  }
+  ++free_block_num_[size_class];
+  free_block_size_[size_class] += size;
+}
+
+double FragmentationReport::Fragmentation() const {
+  if (free_size_ == 0) {
+    return 0.0;
+  }
+  return 1.0 - static_cast<double>(largest_free_block_) / free_size_;
+}
+
+std::string FragmentationReport::ToString() const {
+  using string::HumanReadableSize;
+  std::ostringstream os;
+  os << "reserved " << HumanReadableSize(reserved_size_) << " in "
+     << chunks_.size() << " chunks, allocated "
+     << HumanReadableSize(reserved_size_ - free_size_) << ", free "
+     << HumanReadableSize(free_size_) << ", largest free block "
+     << HumanReadableSize(largest_free_block_) << ", fragmentation "
+     << Fragmentation() * 100 << "%";
+
+  std::vector<size_t> order;
+  for (size_t i = 0; i < chunks_.size(); ++i) {
+    if (chunks_[i].free_size > 0) {
+      order.push_back(i);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return chunks_[a].free_size > chunks_[b].free_size;
+  });
+  for (size_t i = 0; i < std::min(order.size(), kMaxReportedChunks); ++i) {
+    const auto& chunk = chunks_[order[i]];
+    os << "\n  chunk " << order[i] << ": size "
+       << HumanReadableSize(chunk.size) << ", free "
+       << HumanReadableSize(chunk.free_size) << " in "
+       << chunk.free_block_num << " blocks, largest "
+       << HumanReadableSize(chunk.largest_free_block);
+  }
+  if (order.size() > kMaxReportedChunks) {
+    os << "\n  ... " << order.size() - kMaxReportedChunks
+       << " more chunks with free memory";
+  }
+
+  for (size_t i = 0; i < free_block_num_.size(); ++i) {
+    if (free_block_num_[i] > 0) {
+      os << "\n  free blocks of [" << HumanReadableSize(1ULL << i) << ", "
+         << HumanReadableSize(2.0 * (1ULL << i))
+         << "): " << free_block_num_[i] << ", "
+         << HumanReadableSize(free_block_size_[i]);
+    }
+  }
+  return os.str();
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,64 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// How the free memory of a best fit allocator is scattered over its chunks.
+// When little of the free memory is in one block, requests fail although far
+// more memory is reserved than allocated.
+class FragmentationReport {
+ public:
+  // starts a new chunk, the blocks added after it belong to that chunk
+  void AddChunk();
+  void AddBlock(size_t size, bool is_free);
+
+  size_t ReservedSize() const { return reserved_size_; }
+  size_t FreeSize() const { return free_size_; }
+  size_t LargestFreeBlock() const { return largest_free_block_; }
+  // 1 - largest free block / free size, 0 without free memory
+  double Fragmentation() const;
+
+  // a summary line, the chunks with the most free memory and the free blocks
+  // by power of two size class
+  std::string ToString() const;
+
+ private:
+  struct ChunkInfo {
+    size_t size = 0;
+    size_t free_size = 0;
+    size_t largest_free_block = 0;
+    size_t free_block_num = 0;
+  };
+
+  std::vector<ChunkInfo> chunks_;
+  size_t reserved_size_ = 0;
+  size_t free_size_ = 0;
+  size_t largest_free_block_ = 0;
+  // [i] is about the free blocks of [2^i, 2^(i+1)) bytes
+  std::array<size_t, 64> free_block_num_{};
+  std::array<size_t, 64> free_block_size_{};
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
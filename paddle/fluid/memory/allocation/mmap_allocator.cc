@@ -18,6 +18,8 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <cstdlib>
 
 #include <atomic>
@@ -421,6 +423,36 @@ void MemoryMapAllocationPool::Clear() {
 
 MemoryMapAllocationPool::~MemoryMapAllocationPool() { Clear(); }  // NOLINT
 
+MappedFile::MappedFile(const std::string &path) : path_(path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  PADDLE_ENFORCE_NE(
+      fd,
+      -1,
+      platform::errors::Unavailable("Fail to open file %s to map it.", path));
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    PADDLE_THROW(
+        platform::errors::Unavailable("Fail to get the size of %s.", path));
+  }
+  size_ = static_cast<size_t>(file_stat.st_size);
+  if (size_ > 0) {
+    ptr_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  PADDLE_ENFORCE_NE(
+      ptr_,
+      MAP_FAILED,
+      platform::errors::Unavailable("Memory map of file %s failed.", path));
+  VLOG(3) << "Map " << size_ << " bytes of " << path << " at " << ptr_;
+}
+
+MappedFile::~MappedFile() {
+  if (ptr_ != nullptr && munmap(ptr_, size_) != 0) {
+    LOG(WARNING) << "munmap of " << path_ << " failed.";
+  }
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
@@ -235,6 +235,41 @@ class MemoryMapAllocationPool {
   std::mutex mtx_;
 };
 
+// A private, copy-on-write mapping of a whole file opened for reading, e.g.
+// the combined params file of an inference model. Writes to the mapped memory
+// stay private to the process and never reach the file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const std::string &path() const { return path_; }
+  char *data() const { return static_cast<char *>(ptr_); }
+  size_t size() const { return size_; }
+
+ private:
+  std::string path_;
+  void *ptr_ = nullptr;
+  size_t size_ = 0;
+};
+
+// size bytes at offset of a MappedFile, the file stays mapped as long as any
+// of its allocations is alive
+class MappedFileAllocation : public Allocation {
+ public:
+  MappedFileAllocation(std::shared_ptr<MappedFile> file,
+                       size_t offset,
+                       size_t size)
+      : Allocation(file->data() + offset, size, platform::CPUPlace()),
+        file_(std::move(file)) {}
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+};
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
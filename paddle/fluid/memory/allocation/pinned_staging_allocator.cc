@@ -0,0 +1,359 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/pinned_staging_allocator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "paddle/fluid/memory/stats.h"
+#include "paddle/fluid/platform/cuda_device_guard.h"
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/fluid/platform/profiler/mem_tracing.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+namespace {
+
+// -1 if the NUMA node of the device is unknown
+int DeviceNumaNode(int device) {
+#ifdef __linux__
+  char bus_id[64] = {0};
+#ifdef PADDLE_WITH_CUDA
+  if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device) != cudaSuccess) {
+    cudaGetLastError();
+    return -1;
+  }
+#else
+  if (hipDeviceGetPCIBusId(bus_id, sizeof(bus_id), device) != hipSuccess) {
+    hipGetLastError();
+    return -1;
+  }
+#endif
+  std::string path = "/sys/bus/pci/devices/";
+  for (char* c = bus_id; *c != '\0'; ++c) {
+    path += static_cast<char>(std::tolower(*c));
+  }
+  std::ifstream is(path + "/numa_node");
+  int node = -1;
+  if (is >> node) {
+    return node;
+  }
+#endif
+  return -1;
+}
+
+}  // namespace
+
+std::shared_ptr<PinnedStagingAllocator> PinnedStagingAllocator::Instance(
+    const platform::CUDAPlace& place) {
+  static std::mutex mutex;
+  // never destroyed, the CUDA runtime may be gone already at exit
+  static auto* allocators =
+      new std::map<int, std::shared_ptr<PinnedStagingAllocator>>();
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& allocator = (*allocators)[place.device];
+  if (allocator == nullptr) {
+    allocator = std::make_shared<PinnedStagingAllocator>(place);
+  }
+  return allocator;
+}
+
+PinnedStagingAllocator::PinnedStagingAllocator(const platform::CUDAPlace& place)
+    : place_(place), numa_node_(DeviceNumaNode(place.device)) {
+  VLOG(1) << "Pinned staging pool of " << place_ << " on NUMA node "
+          << numa_node_;
+}
+
+PinnedStagingAllocator::~PinnedStagingAllocator() {
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    size_t size = kMinSize << i;
+    for (auto& block : ready_blocks_[i]) {
+      FreePinned(block.ptr, size);
+    }
+    for (auto& block : pending_blocks_[i]) {
+      for (gpuEvent_t event : block.events) {
+#ifdef PADDLE_WITH_CUDA
+        cudaEventSynchronize(event);
+        cudaEventDestroy(event);
+#else
+        hipEventSynchronize(event);
+        hipEventDestroy(event);
+#endif
+      }
+      FreePinned(block.ptr, size);
+    }
+  }
+  for (gpuEvent_t event : free_events_) {
+#ifdef PADDLE_WITH_CUDA
+    cudaEventDestroy(event);
+#else
+    hipEventDestroy(event);
+#endif
+  }
+}
+
+size_t PinnedStagingAllocator::SizeClassIndex(size_t size) {
+  size_t index = 0;
+  while ((kMinSize << index) < size) {
+    ++index;
+  }
+  return index;
+}
+
+void PinnedStagingAllocator::RecordStream(phi::Allocation* allocation,
+                                          gpuStream_t stream) {
+  auto* staging = dynamic_cast<PinnedStagingAllocation*>(allocation);
+  PADDLE_ENFORCE_NOT_NULL(
+      staging,
+      platform::errors::InvalidArgument(
+          "The allocation to record a stream for is not from the pinned "
+          "staging pool."));
+  gpuEvent_t event = nullptr;
+  {
+    std::lock_guard<SpinLock> guard(lock_);
+    if (!free_events_.empty()) {
+      event = free_events_.back();
+      free_events_.pop_back();
+    }
+  }
+  if (event == nullptr) {
+    platform::CUDADeviceGuard guard(place_.device);
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipEventCreateWithFlags(&event, hipEventDisableTiming));
+#endif
+  }
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, stream));
+#endif
+  staging->events_.push_back(event);
+}
+
+bool PinnedStagingAllocator::IsCompleted(
+    const std::vector<gpuEvent_t>& events) {
+  for (gpuEvent_t event : events) {
+#ifdef PADDLE_WITH_CUDA
+    gpuError_t err = cudaEventQuery(event);
+    if (err == cudaErrorNotReady) {
+      return false;
+    }
+#else
+    gpuError_t err = hipEventQuery(event);
+    if (err == hipErrorNotReady) {
+      return false;
+    }
+#endif
+    PADDLE_ENFORCE_GPU_SUCCESS(err);
+  }
+  return true;
+}
+
+void PinnedStagingAllocator::RecycleEvents(std::vector<gpuEvent_t>* events) {
+  free_events_.insert(free_events_.end(), events->begin(), events->end());
+  events->clear();
+}
+
+void PinnedStagingAllocator::CollectCompletedBlocks(size_t index) {
+  // the copies of a size class mostly complete in the order they were queued,
+  // so only the oldest pending blocks are checked
+  auto& pending = pending_blocks_[index];
+  while (!pending.empty() && IsCompleted(pending.front().events)) {
+    RecycleEvents(&pending.front().events);
+    ready_blocks_[index].emplace_back(std::move(pending.front()));
+    pending.pop_front();
+  }
+}
+
+phi::Allocation* PinnedStagingAllocator::AllocateImpl(size_t size) {
+  if (size > kMaxSize) {
+    return new PinnedStagingAllocation(
+        AllocPinned(size), size, platform::CUDAPinnedPlace());
+  }
+  size_t index = SizeClassIndex(std::max(size, kMinSize));
+  size_t block_size = kMinSize << index;
+  {
+    std::lock_guard<SpinLock> guard(lock_);
+    CollectCompletedBlocks(index);
+    auto& ready = ready_blocks_[index];
+    if (!ready.empty()) {
+      void* ptr = ready.back().ptr;
+      ready.pop_back();
+      return new PinnedStagingAllocation(
+          ptr, block_size, platform::CUDAPinnedPlace());
+    }
+  }
+  // not under the lock, page-locking takes long
+  return new PinnedStagingAllocation(
+      AllocPinned(block_size), block_size, platform::CUDAPinnedPlace());
+}
+
+void PinnedStagingAllocator::FreeImpl(phi::Allocation* allocation) {
+  auto* staging = static_cast<PinnedStagingAllocation*>(allocation);
+  size_t size = staging->size();
+  if (size > kMaxSize) {
+    // not cached, so the pages can only be unlocked after the copies
+    for (gpuEvent_t event : staging->events_) {
+#ifdef PADDLE_WITH_CUDA
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event));
+#endif
+    }
+    FreePinned(staging->ptr(), size);
+    std::lock_guard<SpinLock> guard(lock_);
+    RecycleEvents(&staging->events_);
+  } else {
+    size_t index = SizeClassIndex(size);
+    Block block{staging->ptr(), std::move(staging->events_)};
+    std::lock_guard<SpinLock> guard(lock_);
+    if (block.events.empty()) {
+      ready_blocks_[index].emplace_back(std::move(block));
+    } else {
+      pending_blocks_[index].emplace_back(std::move(block));
+    }
+  }
+  delete staging;
+}
+
+uint64_t PinnedStagingAllocator::ReleaseImpl(const platform::Place& place) {
+  std::vector<std::pair<void*, size_t>> blocks;
+  {
+    std::lock_guard<SpinLock> guard(lock_);
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      CollectCompletedBlocks(i);
+      for (auto& block : ready_blocks_[i]) {
+        blocks.emplace_back(block.ptr, kMinSize << i);
+      }
+      ready_blocks_[i].clear();
+    }
+  }
+  uint64_t released_size = 0;
+  for (auto& block : blocks) {
+    FreePinned(block.first, block.second);
+    released_size += block.second;
+  }
+  VLOG(8) << "Release " << released_size << " bytes of pinned staging pool";
+  return released_size;
+}
+
+void* PinnedStagingAllocator::AllocPinned(size_t size) {
+  void* ptr = nullptr;
+#ifdef __linux__
+  if (numa_node_ >= 0) {
+    ptr = mmap(nullptr,
+               size,
+               PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS,
+               -1,
+               0);
+    PADDLE_ENFORCE_NE(ptr,
+                      MAP_FAILED,
+                      platform::errors::ResourceExhausted(
+                          "Fail to mmap %d bytes for the pinned staging pool.",
+                          size));
+    // MPOL_PREFERRED, falls back to other nodes when the node is full
+    constexpr int kMpolPreferred = 1;
+    constexpr size_t kBits = 8 * sizeof(unsigned long);  // NOLINT
+    std::vector<unsigned long> mask(numa_node_ / kBits + 1, 0);  // NOLINT
+    mask[numa_node_ / kBits] = 1UL << (numa_node_ % kBits);
+    if (syscall(SYS_mbind,
+                ptr,
+                size,
+                kMpolPreferred,
+                mask.data(),
+                mask.size() * kBits + 1,
+                0) != 0) {
+      VLOG(4) << "Fail to bind the pinned staging memory to NUMA node "
+              << numa_node_;
+    }
+#ifdef PADDLE_WITH_CUDA
+    gpuError_t err = cudaHostRegister(ptr, size, cudaHostRegisterPortable);
+#else
+    gpuError_t err = hipHostRegister(ptr, size, hipHostRegisterPortable);
+#endif
+#ifdef PADDLE_WITH_CUDA
+    if (err != cudaSuccess) {
+#else
+    if (err != hipSuccess) {
+#endif
+      munmap(ptr, size);
+      PADDLE_ENFORCE_GPU_SUCCESS(err);
+    }
+  }
+#endif
+  if (ptr == nullptr) {
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaHostAlloc(&ptr, size, cudaHostAllocPortable));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipHostMalloc(&ptr, size, hipHostMallocPortable));
+#endif
+  }
+  VLOG(10) << "Pin " << size << " bytes at " << ptr << " for staging";
+  HOST_MEMORY_STAT_UPDATE(Reserved, 0, size);
+  platform::RecordMemEvent(ptr,
+                           platform::CUDAPinnedPlace(),
+                           size,
+                           platform::TracerMemEventType::ReservedAllocate);
+  return ptr;
+}
+
+void PinnedStagingAllocator::FreePinned(void* ptr, size_t size) {
+#ifdef __linux__
+  if (numa_node_ >= 0) {
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaHostUnregister(ptr));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(hipHostUnregister(ptr));
+#endif
+    munmap(ptr, size);
+  }
+#endif
+  if (numa_node_ < 0) {
+#ifdef PADDLE_WITH_CUDA
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaFreeHost(ptr));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(hipHostFree(ptr));
+#endif
+  }
+  VLOG(10) << "Unpin " << size << " bytes at " << ptr;
+  HOST_MEMORY_STAT_UPDATE(Reserved, 0, -size);
+  platform::RecordMemEvent(ptr,
+                           platform::CUDAPinnedPlace(),
+                           size,
+                           platform::TracerMemEventType::ReservedFree);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/spin_lock.h"
+#include "paddle/fluid/platform/place.h"
+
+#ifdef PADDLE_WITH_CUDA
+#include <cuda_runtime.h>
+#else
+#include <hip/hip_runtime.h>
+#endif
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class PinnedStagingAllocation : public Allocation {
+ public:
+  using Allocation::Allocation;
+
+ private:
+  friend class PinnedStagingAllocator;
+  // recorded on the streams whose copies use the buffer
+  std::vector<gpuEvent_t> events_;
+};
+
+// Pool of pinned host buffers to stage copies between pageable host memory
+// and one device, see FLAGS_use_pinned_staging_pool.
+//
+// Requests up to kMaxSize are rounded up to a power of two no less than
+// kMinSize and served from the free blocks of that size class, larger ones
+// are page-locked on each request and their free waits for their copies.
+// The pinned memory is bound to the NUMA node of the device when it is known
+// (Linux only). A cached buffer used by a copy on a stream, see RecordStream,
+// comes back to the pool once that copy completes without being waited for:
+// allocations skip the pending blocks that are not done yet.
+class PinnedStagingAllocator : public Allocator {
+ public:
+  constexpr static size_t kMinSize = 4UL << 10;
+  constexpr static size_t kMaxSize = 64UL << 20;
+  constexpr static size_t kNumSizeClasses = 15;
+
+  static std::shared_ptr<PinnedStagingAllocator> Instance(
+      const platform::CUDAPlace& place);
+
+  explicit PinnedStagingAllocator(const platform::CUDAPlace& place);
+  ~PinnedStagingAllocator() override;
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // allocation comes back to the pool only once the work queued on stream so
+  // far completes, call it after queueing the copies that use allocation
+  void RecordStream(phi::Allocation* allocation, gpuStream_t stream);
+
+  int NumaNode() const { return numa_node_; }
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  // frees the cached blocks whose copies have completed
+  uint64_t ReleaseImpl(const platform::Place& place) override;
+
+ private:
+  struct Block {
+    void* ptr;
+    std::vector<gpuEvent_t> events;
+  };
+
+  static size_t SizeClassIndex(size_t size);
+  // moves the blocks whose copies have completed from pending to ready
+  void CollectCompletedBlocks(size_t index);
+  bool IsCompleted(const std::vector<gpuEvent_t>& events);
+  void RecycleEvents(std::vector<gpuEvent_t>* events);
+
+  void* AllocPinned(size_t size);
+  void FreePinned(void* ptr, size_t size);
+
+  platform::CUDAPlace place_;
+  int numa_node_;
+
+  SpinLock lock_;
+  std::array<std::vector<Block>, kNumSizeClasses> ready_blocks_;
+  std::array<std::deque<Block>, kNumSizeClasses> pending_blocks_;
+  std::vector<gpuEvent_t> free_events_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
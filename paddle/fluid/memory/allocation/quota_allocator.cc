@@ -0,0 +1,203 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/quota_allocator.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+MemoryDomain::MemoryDomain(const platform::Place& place,
+                           size_t quota,
+                           bool hard_quota)
+    : place_(place), quota_(quota), hard_quota_(hard_quota) {
+  MemoryDomainRegistry::Instance().Register(this);
+}
+
+MemoryDomain::~MemoryDomain() {
+  MemoryDomainRegistry::Instance().Unregister(this);
+}
+
+void MemoryDomain::SetReleaseCallback(std::function<uint64_t()> callback) {
+  std::lock_guard<std::mutex> lock(busy_mutex_);
+  release_callback_ = std::move(callback);
+}
+
+void MemoryDomain::Enter() { busy_mutex_.lock(); }
+
+void MemoryDomain::Exit() { busy_mutex_.unlock(); }
+
+uint64_t MemoryDomain::ReleaseIfIdle() {
+  std::unique_lock<std::mutex> lock(busy_mutex_, std::try_to_lock);
+  if (!lock.owns_lock() || !release_callback_) {
+    return 0;
+  }
+  uint64_t released = release_callback_();
+  released_bytes_ += released;
+  return released;
+}
+
+bool MemoryDomain::Reserve(size_t size) {
+  // the quota check and the add are one step, so that the concurrent
+  // allocations cannot pass the check together and overrun a hard quota
+  size_t allocated = allocated_.load();
+  bool within_quota = false;
+  do {
+    within_quota = quota_ == 0 || allocated + size <= quota_;
+    if (!within_quota && hard_quota_) {
+      ++exceeded_count_;
+      return false;
+    }
+  } while (!allocated_.compare_exchange_weak(allocated, allocated + size));
+  if (!within_quota) {
+    ++exceeded_count_;
+  }
+  UpdatePeak(allocated + size);
+  return within_quota;
+}
+
+void MemoryDomain::Add(size_t size) {
+  UpdatePeak(allocated_.fetch_add(size) + size);
+}
+
+void MemoryDomain::UpdatePeak(size_t allocated) {
+  size_t peak = peak_allocated_.load();
+  while (allocated > peak &&
+         !peak_allocated_.compare_exchange_weak(peak, allocated)) {
+  }
+}
+
+void MemoryDomain::Unreserve(size_t size) { allocated_ -= size; }
+
+QuotaAllocator::QuotaAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                               std::shared_ptr<MemoryDomain> domain)
+    : underlying_allocator_(std::move(underlying_allocator)),
+      domain_(std::move(domain)) {
+  PADDLE_ENFORCE_NOT_NULL(
+      underlying_allocator_,
+      platform::errors::InvalidArgument(
+          "Underlying allocator of QuotaAllocator is NULL"));
+  PADDLE_ENFORCE_NOT_NULL(domain_,
+                          platform::errors::InvalidArgument(
+                              "Memory domain of QuotaAllocator is NULL"));
+}
+
+phi::Allocation* QuotaAllocator::AllocateImpl(size_t size) {
+  auto& registry = MemoryDomainRegistry::Instance();
+  if (!domain_->Reserve(size)) {
+    if (domain_->hard_quota()) {
+      PADDLE_THROW_BAD_ALLOC(platform::errors::ResourceExhausted(
+          "Cannot allocate %d bytes on %s, since %d bytes are allocated "
+          "already under the hard memory quota of %d bytes.",
+          size,
+          domain_->place(),
+          domain_->allocated(),
+          domain_->quota()));
+    }
+    if (domain_->exceeded_count() == 1) {
+      LOG(WARNING) << "The memory allocated on " << domain_->place()
+                   << " exceeds the soft quota of " << domain_->quota()
+                   << " bytes, the idle tenants are asked to release theirs.";
+    }
+    registry.ReleaseIdle(domain_->place(), domain_.get());
+  }
+
+  phi::Allocator::AllocationPtr allocation;
+  try {
+    allocation = underlying_allocator_->Allocate(size);
+  } catch (BadAlloc&) {
+    // retry once if the idle tenants release any memory to the device
+    if (registry.ReleaseIdle(domain_->place(), domain_.get()) == 0) {
+      domain_->Unreserve(size);
+      throw;
+    }
+    try {
+      allocation = underlying_allocator_->Allocate(size);
+    } catch (BadAlloc&) {
+      domain_->Unreserve(size);
+      throw;
+    }
+  }
+  // account the size the underlying allocator rounds the request up to
+  if (allocation->size() > size) {
+    domain_->Add(allocation->size() - size);
+  } else {
+    domain_->Unreserve(size - allocation->size());
+  }
+  return allocation.release();
+}
+
+void QuotaAllocator::FreeImpl(phi::Allocation* allocation) {
+  domain_->Unreserve(allocation->size());
+  underlying_allocator_->Free(allocation);
+}
+
+MemoryDomainRegistry& MemoryDomainRegistry::Instance() {
+  static MemoryDomainRegistry registry;
+  return registry;
+}
+
+void MemoryDomainRegistry::Register(MemoryDomain* domain) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  domains_.push_back(domain);
+}
+
+void MemoryDomainRegistry::Unregister(MemoryDomain* domain) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  domains_.erase(std::remove(domains_.begin(), domains_.end(), domain),
+                 domains_.end());
+}
+
+uint64_t MemoryDomainRegistry::ReleaseIdle(const platform::Place& place,
+                                           const MemoryDomain* requester) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t released = 0;
+  for (auto* domain : domains_) {
+    if (domain != requester && domain->place() == place) {
+      released += domain->ReleaseIfIdle();
+    }
+  }
+  VLOG(3) << "The idle memory domains on " << place << " release " << released
+          << " bytes";
+  return released;
+}
+
+void MemoryDomainRegistry::Retire(std::shared_ptr<QuotaAllocator> allocator) {
+  // the allocators are destroyed out of the lock, since their domains
+  // unregister themselves
+  std::vector<std::shared_ptr<QuotaAllocator>> freed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    retired_allocators_.push_back(std::move(allocator));
+    auto iter = std::stable_partition(
+        retired_allocators_.begin(),
+        retired_allocators_.end(),
+        [](const std::shared_ptr<QuotaAllocator>& retired) {
+          return retired->domain()->allocated() > 0;
+        });
+    std::move(iter, retired_allocators_.end(), std::back_inserter(freed));
+    retired_allocators_.erase(iter, retired_allocators_.end());
+  }
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,167 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/platform/place.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+/**
+ * MemoryDomain accounts the memory that one tenant of a place, e.g. one of
+ * the predictors serving on a GPU, allocates out of the allocator shared by
+ * all the tenants of the place, against the quota of the tenant.
+ *
+ * An allocation beyond a hard quota fails with BadAlloc, while an allocation
+ * beyond a soft quota goes on after asking the idle tenants of the place to
+ * release their memory. The idle tenants are asked as well when the device
+ * runs out of memory. A tenant is busy between Enter() and Exit(), and only
+ * the release callback of an idle tenant is run.
+ */
+class MemoryDomain {
+ public:
+  // A quota of 0 bytes is unlimited.
+  MemoryDomain(const platform::Place& place, size_t quota, bool hard_quota);
+  ~MemoryDomain();
+
+  const platform::Place& place() const { return place_; }
+  size_t quota() const { return quota_; }
+  bool hard_quota() const { return hard_quota_; }
+
+  size_t allocated() const { return allocated_.load(); }
+  size_t peak_allocated() const { return peak_allocated_.load(); }
+  // The allocations beyond the quota, failed or not.
+  uint64_t exceeded_count() const { return exceeded_count_.load(); }
+  // The bytes released by the release callback for the other tenants.
+  uint64_t released_bytes() const { return released_bytes_.load(); }
+
+  // The callback frees the memory the tenant caches between its runs, and
+  // returns the bytes released to the device. It waits for a running
+  // callback, so the tenant resets it to nullptr before it goes away.
+  void SetReleaseCallback(std::function<uint64_t()> callback);
+
+  void Enter();
+  void Exit();
+
+  // Returns 0 without running the callback if the tenant is busy.
+  uint64_t ReleaseIfIdle();
+
+ private:
+  friend class QuotaAllocator;
+
+  // Returns false if it is beyond the quota, and only adds the size to the
+  // allocated bytes under a soft quota then.
+  bool Reserve(size_t size);
+  void Add(size_t size);
+  void Unreserve(size_t size);
+  void UpdatePeak(size_t allocated);
+
+  platform::Place place_;
+  size_t quota_;
+  bool hard_quota_;
+
+  std::atomic<size_t> allocated_{0};
+  std::atomic<size_t> peak_allocated_{0};
+  std::atomic<uint64_t> exceeded_count_{0};
+  std::atomic<uint64_t> released_bytes_{0};
+
+  // held while the tenant is busy or the callback runs
+  std::mutex busy_mutex_;
+  std::function<uint64_t()> release_callback_;
+
+  DISABLE_COPY_AND_ASSIGN(MemoryDomain);
+};
+
+class MemoryDomainGuard {
+ public:
+  explicit MemoryDomainGuard(MemoryDomain* domain) : domain_(domain) {
+    if (domain_ != nullptr) {
+      domain_->Enter();
+    }
+  }
+
+  ~MemoryDomainGuard() {
+    if (domain_ != nullptr) {
+      domain_->Exit();
+    }
+  }
+
+ private:
+  MemoryDomain* domain_;
+
+  DISABLE_COPY_AND_ASSIGN(MemoryDomainGuard);
+};
+
+// The allocations out of QuotaAllocator are accounted to its domain.
+class QuotaAllocator : public Allocator {
+ public:
+  QuotaAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                 std::shared_ptr<MemoryDomain> domain);
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  const std::shared_ptr<MemoryDomain>& domain() const { return domain_; }
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+  uint64_t ReleaseImpl(const platform::Place& place) override {
+    return underlying_allocator_->Release(place);
+  }
+
+ private:
+  std::shared_ptr<Allocator> underlying_allocator_;
+  std::shared_ptr<MemoryDomain> domain_;
+};
+
+class MemoryDomainRegistry {
+ public:
+  static MemoryDomainRegistry& Instance();
+
+  void Register(MemoryDomain* domain);
+  void Unregister(MemoryDomain* domain);
+
+  // Runs the release callbacks of the idle domains of the place except the
+  // requester, returns the bytes released.
+  uint64_t ReleaseIdle(const platform::Place& place,
+                       const MemoryDomain* requester);
+
+  // Keeps the allocator of a tenant that goes away until all the
+  // allocations out of it, e.g. the outputs still held by the user, are
+  // freed.
+  void Retire(std::shared_ptr<QuotaAllocator> allocator);
+
+ private:
+  MemoryDomainRegistry() = default;
+
+  std::mutex mutex_;
+  std::vector<MemoryDomain*> domains_;
+  std::vector<std::shared_ptr<QuotaAllocator>> retired_allocators_;
+
+  DISABLE_COPY_AND_ASSIGN(MemoryDomainRegistry);
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,259 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/size_class_cpu_allocator.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/fluid/memory/allocation/spin_lock.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// a thread cache moves this many bytes of a size class at once
+static constexpr size_t kBatchBytes = 64UL << 10;
+static constexpr size_t kMinSpanBytes = 64UL << 10;
+static constexpr size_t kMaxSpanBytes = 2UL << 20;
+
+static size_t BatchNum(size_t index) {
+  return std::min<size_t>(
+      std::max<size_t>(
+          kBatchBytes / SizeClassCPUAllocator::SizeClassSize(index), 2),
+      64);
+}
+
+size_t SizeClassCPUAllocator::SizeClassIndex(size_t size) {
+  // 64, 128, 192, 256, then 4 classes between two powers of two
+  if (size <= 4 * kMinSize) {
+    return size == 0 ? 0 : (size - 1) / kMinSize;
+  }
+  size_t n = size - 1;
+  size_t p = 8;
+  while ((static_cast<size_t>(1) << (p + 1)) <= n) {
+    ++p;
+  }
+  size_t step = static_cast<size_t>(1) << (p - 2);
+  return 4 + (p - 8) * 4 + (n - (static_cast<size_t>(1) << p)) / step;
+}
+
+size_t SizeClassCPUAllocator::SizeClassSize(size_t index) {
+  if (index < 4) {
+    return (index + 1) * kMinSize;
+  }
+  size_t p = 8 + (index - 4) / 4;
+  size_t k = (index - 4) % 4;
+  size_t step = static_cast<size_t>(1) << (p - 2);
+  return (static_cast<size_t>(1) << p) + (k + 1) * step;
+}
+
+struct SizeClassCPUAllocator::Central {
+  struct Shard {
+    SpinLock lock;
+    std::vector<void*> free_blocks;
+  };
+
+  explicit Central(std::shared_ptr<Allocator> allocator)
+      : underlying_allocator(std::move(allocator)) {}
+
+  // appends num free blocks of the size class to blocks
+  void Fetch(size_t index, size_t num, std::vector<void*>* blocks) {
+    auto& shard = shards[index];
+    {
+      std::lock_guard<SpinLock> guard(shard.lock);
+      size_t take = std::min(num, shard.free_blocks.size());
+      blocks->insert(blocks->end(),
+                     shard.free_blocks.end() - take,
+                     shard.free_blocks.end());
+      shard.free_blocks.resize(shard.free_blocks.size() - take);
+      num -= take;
+    }
+    if (num == 0) {
+      return;
+    }
+
+    size_t block_size = SizeClassSize(index);
+    size_t span_size =
+        std::min(std::max(block_size * 64, kMinSpanBytes), kMaxSpanBytes);
+    size_t block_num = std::max(span_size / block_size, num);
+    // not under the shard lock, the underlying allocator may take long
+    auto span = underlying_allocator->Allocate(block_num * block_size);
+    char* base = static_cast<char*>(span->ptr());
+    {
+      std::lock_guard<std::mutex> guard(span_mutex);
+      spans.emplace_back(std::move(span));
+    }
+    for (size_t i = 0; i < num; ++i) {
+      blocks->push_back(base + i * block_size);
+    }
+    std::lock_guard<SpinLock> guard(shard.lock);
+    for (size_t i = num; i < block_num; ++i) {
+      shard.free_blocks.push_back(base + i * block_size);
+    }
+  }
+
+  void Return(size_t index, void* const* blocks, size_t num) {
+    auto& shard = shards[index];
+    std::lock_guard<SpinLock> guard(shard.lock);
+    shard.free_blocks.insert(shard.free_blocks.end(), blocks, blocks + num);
+  }
+
+  std::shared_ptr<Allocator> underlying_allocator;
+  std::array<Shard, kNumSizeClasses> shards;
+  std::mutex span_mutex;
+  std::vector<AllocationPtr> spans;
+};
+
+class SizeClassCPUAllocator::ThreadCache {
+ public:
+  explicit ThreadCache(std::shared_ptr<Central> central)
+      : central_(std::move(central)) {}
+
+  ~ThreadCache() {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      central_->Return(i, free_blocks_[i].data(), free_blocks_[i].size());
+    }
+  }
+
+  void* Pop(size_t index) {
+    auto& blocks = free_blocks_[index];
+    if (blocks.empty()) {
+      central_->Fetch(index, BatchNum(index), &blocks);
+    }
+    void* ptr = blocks.back();
+    blocks.pop_back();
+    return ptr;
+  }
+
+  void Push(size_t index, void* ptr) {
+    auto& blocks = free_blocks_[index];
+    blocks.push_back(ptr);
+    size_t batch = BatchNum(index);
+    if (blocks.size() > 2 * batch) {
+      central_->Return(index, blocks.data() + blocks.size() - batch, batch);
+      blocks.resize(blocks.size() - batch);
+    }
+  }
+
+ private:
+  std::shared_ptr<Central> central_;
+  std::array<std::vector<void*>, kNumSizeClasses> free_blocks_;
+};
+
+namespace {
+
+// trivially destructible, so still readable while and after the registry of
+// an exiting thread is destroyed, e.g. by a later thread_local freeing memory
+thread_local bool tls_registry_destroyed = false;
+thread_local uint64_t tls_last_id = 0;
+thread_local void* tls_last_cache = nullptr;
+
+template <typename ThreadCacheT>
+struct ThreadCacheMap {
+  ~ThreadCacheMap() {
+    tls_registry_destroyed = true;
+    tls_last_id = 0;
+    tls_last_cache = nullptr;
+  }
+
+  std::unordered_map<uint64_t, std::unique_ptr<ThreadCacheT>> caches;
+};
+
+std::atomic<uint64_t> next_allocator_id{1};
+
+}  // namespace
+
+SizeClassCPUAllocator::SizeClassCPUAllocator(
+    std::shared_ptr<Allocator> underlying_allocator)
+    : underlying_allocator_(std::move(underlying_allocator)),
+      central_(std::make_shared<Central>(underlying_allocator_)),
+      id_(next_allocator_id.fetch_add(1)) {
+  PADDLE_ENFORCE_EQ(
+      SizeClassSize(kNumSizeClasses - 1),
+      kMaxSmallSize,
+      platform::errors::PreconditionNotMet(
+          "The largest size class should be %d, but got %d.",
+          kMaxSmallSize,
+          SizeClassSize(kNumSizeClasses - 1)));
+}
+
+SizeClassCPUAllocator::~SizeClassCPUAllocator() {
+  // the caches of other threads keep the central list alive until they exit
+  if (tls_last_id == id_) {
+    tls_last_id = 0;
+    tls_last_cache = nullptr;
+  }
+}
+
+SizeClassCPUAllocator::ThreadCache* SizeClassCPUAllocator::GetThreadCache() {
+  if (tls_last_id == id_) {
+    return static_cast<ThreadCache*>(tls_last_cache);
+  }
+  if (tls_registry_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadCacheMap<ThreadCache> registry;
+  auto& cache = registry.caches[id_];
+  if (cache == nullptr) {
+    cache = std::make_unique<ThreadCache>(central_);
+  }
+  tls_last_id = id_;
+  tls_last_cache = cache.get();
+  return cache.get();
+}
+
+phi::Allocation* SizeClassCPUAllocator::AllocateImpl(size_t size) {
+  if (size > kMaxSmallSize) {
+    return underlying_allocator_->Allocate(size).release();
+  }
+  size_t index = SizeClassIndex(size);
+  void* ptr = nullptr;
+  auto* cache = GetThreadCache();
+  if (LIKELY(cache != nullptr)) {
+    ptr = cache->Pop(index);
+  } else {
+    std::vector<void*> blocks;
+    central_->Fetch(index, 1, &blocks);
+    ptr = blocks[0];
+  }
+  return new Allocation(ptr, SizeClassSize(index), platform::CPUPlace());
+}
+
+void SizeClassCPUAllocator::FreeImpl(phi::Allocation* allocation) {
+  size_t size = allocation->size();
+  if (size > kMaxSmallSize) {
+    underlying_allocator_->Free(allocation);
+    return;
+  }
+  size_t index = SizeClassIndex(size);
+  void* ptr = allocation->ptr();
+  auto* cache = GetThreadCache();
+  if (LIKELY(cache != nullptr)) {
+    cache->Push(index, ptr);
+  } else {
+    central_->Return(index, &ptr, 1);
+  }
+  delete allocation;
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,73 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "paddle/fluid/memory/allocation/allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// CPU allocator for many threads allocating small tensors at once.
+//
+// Requests up to kMaxSmallSize are rounded up to one of kNumSizeClasses size
+// classes (four classes per power of two, so at most 25% is wasted) and served
+// from a per-thread cache of free blocks without any lock. A thread cache that
+// runs empty or overflows moves a batch of blocks from or to the central free
+// list of that size class, which is sharded by size class and refilled by
+// carving spans allocated from the underlying allocator. Larger requests go to
+// the underlying allocator directly.
+//
+// Spans are kept until the allocator and every thread cache that used it are
+// gone, a block freed by another thread than the allocating one just moves to
+// the cache of the freeing thread.
+class SizeClassCPUAllocator : public Allocator {
+ public:
+  constexpr static size_t kMinSize = 64UL;
+  constexpr static size_t kMaxSmallSize = 256UL << 10;
+  constexpr static size_t kNumSizeClasses = 44;
+
+  explicit SizeClassCPUAllocator(
+      std::shared_ptr<Allocator> underlying_allocator);
+  ~SizeClassCPUAllocator() override;
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  // the index of the size class serving size bytes, size <= kMaxSmallSize
+  static size_t SizeClassIndex(size_t size);
+  static size_t SizeClassSize(size_t index);
+
+ protected:
+  phi::Allocation* AllocateImpl(size_t size) override;
+  void FreeImpl(phi::Allocation* allocation) override;
+
+ private:
+  struct Central;
+  class ThreadCache;
+
+  // nullptr once the thread local caches of this thread are destroyed
+  ThreadCache* GetThreadCache();
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  std::shared_ptr<Central> central_;
+  uint64_t id_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -14,35 +14,75 @@
 
 #pragma once
 
+#include "paddle/common/macros.h"
+#include "paddle/fluid/memory/allocation/allocation_tracer.h"
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/memory/stats.h"
 #include "paddle/fluid/platform/profiler/mem_tracing.h"
+#include "paddle/phi/core/metrics.h"
 
 namespace paddle {
 namespace memory {
 namespace allocation {
 
+// The counters of the allocations of the host or the device memory
+struct AllocatorMetrics {
+  explicit AllocatorMetrics(const std::string& memory) {
+    auto& registry = phi::MetricsRegistry::Instance();
+    std::string labels = "memory=\"" + memory + "\"";
+    alloc_count = registry.GetCounter(
+        "paddle_allocator_alloc_total", "Number of the allocations.", labels);
+    alloc_bytes = registry.GetCounter(
+        "paddle_allocator_alloc_bytes_total", "Bytes allocated.", labels);
+    free_count = registry.GetCounter(
+        "paddle_allocator_free_total", "Number of the frees.", labels);
+    free_bytes = registry.GetCounter(
+        "paddle_allocator_free_bytes_total", "Bytes freed.", labels);
+  }
+
+  static AllocatorMetrics& Get(bool is_host) {
+    static AllocatorMetrics host("host");
+    static AllocatorMetrics device("device");
+    return is_host ? host : device;
+  }
+
+  phi::MetricCounter* alloc_count;
+  phi::MetricCounter* alloc_bytes;
+  phi::MetricCounter* free_count;
+  phi::MetricCounter* free_bytes;
+};
+
 class StatAllocator : public Allocator {
  public:
-  explicit StatAllocator(std::shared_ptr<Allocator> underlying_allocator)
-      : underlying_allocator_(std::move(underlying_allocator)) {}
+  // stream is only recorded into the allocation trace
+  explicit StatAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                         uint64_t stream = 0)
+      : underlying_allocator_(std::move(underlying_allocator)),
+        stream_(stream) {}
 
   bool IsAllocThreadSafe() const override { return true; }
 
  protected:
   void FreeImpl(phi::Allocation* allocation) override {
-    if (platform::is_cpu_place(allocation->place()) ||
-        platform::is_cuda_pinned_place(allocation->place())) {
+    bool is_host = platform::is_cpu_place(allocation->place()) ||
+                   platform::is_cuda_pinned_place(allocation->place());
+    if (is_host) {
       HOST_MEMORY_STAT_UPDATE(
           Allocated, allocation->place().GetDeviceId(), -allocation->size());
     } else {
       DEVICE_MEMORY_STAT_UPDATE(
           Allocated, allocation->place().GetDeviceId(), -allocation->size());
     }
+    auto& metrics = AllocatorMetrics::Get(is_host);
+    metrics.free_count->Increase();
+    metrics.free_bytes->Increase(static_cast<int64_t>(allocation->size()));
     platform::RecordMemEvent(allocation->ptr(),
                              allocation->place(),
                              allocation->size(),
                              platform::TracerMemEventType::Free);
+    if (UNLIKELY(AllocationTracer::IsEnabled())) {
+      AllocationTracer::Instance().Record(false, *allocation, stream_);
+    }
     underlying_allocator_->Free(allocation);
   }
 
@@ -51,18 +91,25 @@ class StatAllocator : public Allocator {
         underlying_allocator_->Allocate(size);
 
     const platform::Place& place = allocation->place();
-    if (platform::is_cpu_place(place) ||
-        platform::is_cuda_pinned_place(place)) {
+    bool is_host = platform::is_cpu_place(place) ||
+                   platform::is_cuda_pinned_place(place);
+    if (is_host) {
       HOST_MEMORY_STAT_UPDATE(
           Allocated, place.GetDeviceId(), allocation->size());
     } else {
       DEVICE_MEMORY_STAT_UPDATE(
           Allocated, place.GetDeviceId(), allocation->size());
     }
+    auto& metrics = AllocatorMetrics::Get(is_host);
+    metrics.alloc_count->Increase();
+    metrics.alloc_bytes->Increase(static_cast<int64_t>(allocation->size()));
     platform::RecordMemEvent(allocation->ptr(),
                              allocation->place(),
                              allocation->size(),
                              platform::TracerMemEventType::Allocate);
+    if (UNLIKELY(AllocationTracer::IsEnabled())) {
+      AllocationTracer::Instance().Record(true, *allocation, stream_);
+    }
     return allocation.release();
   }
 
@@ -72,6 +119,7 @@ class StatAllocator : public Allocator {
 
  private:
   std::shared_ptr<Allocator> underlying_allocator_;
+  uint64_t stream_;
 };
 
 }  // namespace allocation
@@ -15,6 +15,8 @@
 #include "paddle/fluid/memory/allocation/stream_safe_cuda_allocator.h"
 #include <thread>
 
+#include "paddle/common/flags.h"
+#include "paddle/fluid/platform/cuda_device_guard.h"
 #include "paddle/fluid/platform/profiler/event_tracing.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 
@@ -24,6 +26,8 @@
 #include "paddle/phi/backends/gpu/rocm/hip_graph.h"
 #endif
 
+COMMON_DECLARE_bool(stream_ordered_cuda_free);
+
 namespace paddle {
 namespace memory {
 namespace allocation {
@@ -37,6 +41,7 @@ StreamSafeCUDAAllocation::StreamSafeCUDAAllocation(
                  underlying_allocation->size(),
                  underlying_allocation->place()),
       underlying_allocation_(std::move(underlying_allocation)),
+      stream_ordered_(allocator->IsStreamOrdered()),
       owning_stream_(owning_stream),
       allocator_(allocator->shared_from_this()) {}
 
@@ -57,6 +62,11 @@ void StreamSafeCUDAAllocation::RecordStream(gpuStream_t stream) {
   }
 #endif
 
+  if (stream_ordered_) {
+    used_stream_set_.insert(stream);
+    return;
+  }
+
   RecordStreamWithNoGraphCapturing(stream);
   RecordGraphCapturingStreams();
 }
@@ -65,6 +75,7 @@ void StreamSafeCUDAAllocation::EraseStream(gpuStream_t stream) {
   VLOG(8) << "Try remove stream " << stream << " for address " << ptr();
   std::lock_guard<SpinLock> lock_guard(outstanding_event_map_lock_);
   outstanding_event_map_.erase(stream);
+  used_stream_set_.erase(stream);
 }
 
 bool StreamSafeCUDAAllocation::CanBeFreed() {
@@ -114,6 +125,13 @@ gpuStream_t StreamSafeCUDAAllocation::GetOwningStream() const {
   return owning_stream_;
 }
 
+std::set<gpuStream_t> StreamSafeCUDAAllocation::TakeUsedStreams() {
+  std::lock_guard<SpinLock> lock_guard(outstanding_event_map_lock_);
+  std::set<gpuStream_t> streams;
+  streams.swap(used_stream_set_);
+  return streams;
+}
+
 void StreamSafeCUDAAllocation::RecordGraphCapturingStreams() {
   for (gpuStream_t stream : graph_capturing_stream_set_) {
     RecordStreamWithNoGraphCapturing(stream);
@@ -158,6 +176,8 @@ StreamSafeCUDAAllocator::StreamSafeCUDAAllocator(
     : underlying_allocator_(std::move(underlying_allocator)),
       place_(place),
       default_stream_(default_stream),
+      stream_ordered_(FLAGS_stream_ordered_cuda_free &&
+                      !in_cuda_graph_capturing),
       in_cuda_graph_capturing_(in_cuda_graph_capturing) {
   if (LIKELY(!in_cuda_graph_capturing)) {
     std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
@@ -172,6 +192,13 @@ StreamSafeCUDAAllocator::~StreamSafeCUDAAllocator() {
     allocators.erase(std::remove(allocators.begin(), allocators.end(), this),
                      allocators.end());
   }
+  for (auto& pair : stream_events_) {
+#ifdef PADDLE_WITH_CUDA
+    cudaEventDestroy(pair.second);
+#else
+    hipEventDestroy(pair.second);
+#endif
+  }
 }
 
 bool StreamSafeCUDAAllocator::IsAllocThreadSafe() const { return true; }
@@ -184,10 +211,15 @@ void StreamSafeCUDAAllocator::SetDefaultStream(gpuStream_t stream) {
   default_stream_ = stream;
 }
 
+bool StreamSafeCUDAAllocator::IsStreamOrdered() const {
+  return stream_ordered_;
+}
+
 phi::Allocation* StreamSafeCUDAAllocator::AllocateImpl(size_t size) {
   platform::RecordEvent record("StreamSafeCUDAAllocator::Allocate",
                                platform::TracerEventType::UserDefined,
                                9 /*level*/);
+  ProcessPendingFrees();
   ProcessUnfreedAllocations();
   VLOG(8) << "Try allocate " << size << " bytes";
   AllocationPtr underlying_allocation;
@@ -224,6 +256,19 @@ void StreamSafeCUDAAllocator::FreeImpl(phi::Allocation* allocation) {
       static_cast<StreamSafeCUDAAllocation*>(allocation);
 
   VLOG(8) << "Try free allocation " << stream_safe_cuda_allocation->ptr();
+  if (stream_ordered_ &&
+      LIKELY(!phi::backends::gpu::CUDAGraph::IsThisThreadCapturing())) {
+    std::set<gpuStream_t> streams =
+        stream_safe_cuda_allocation->TakeUsedStreams();
+    if (!streams.empty()) {
+      VLOG(9) << "Put into pending free batch";
+      std::lock_guard<SpinLock> lock_guard(pending_free_lock_);
+      pending_streams_.insert(streams.begin(), streams.end());
+      pending_frees_.emplace_back(stream_safe_cuda_allocation);
+      return;
+    }
+  }
+
   if (stream_safe_cuda_allocation->CanBeFreed()) {
     VLOG(9) << "Directly delete allocation";
     delete stream_safe_cuda_allocation;
@@ -269,7 +314,56 @@ void StreamSafeCUDAAllocator::ProcessUnfreedAllocations() {
   }
 }
 
+void StreamSafeCUDAAllocator::ProcessPendingFrees() {
+  // Same as in ProcessUnfreedAllocations, a misjudgment is permissible here.
+  if (pending_frees_.empty()) {
+    return;
+  }
+
+  std::vector<StreamSafeCUDAAllocation*> frees;
+  {
+    std::lock_guard<SpinLock> lock_guard(pending_free_lock_);
+    for (gpuStream_t stream : pending_streams_) {
+      gpuEvent_t& event = stream_events_[stream];
+      if (event == nullptr) {
+        platform::CUDADeviceGuard guard(place_.device);
+#ifdef PADDLE_WITH_CUDA
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+#else
+        PADDLE_ENFORCE_GPU_SUCCESS(
+            hipEventCreateWithFlags(&event, hipEventDisableTiming));
+#endif
+      }
+#ifdef PADDLE_WITH_CUDA
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaStreamWaitEvent(default_stream_, event, 0));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, stream));
+      PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(default_stream_, event, 0));
+#endif
+      VLOG(9) << "Stream " << default_stream_ << " waits for stream "
+              << stream;
+    }
+    pending_streams_.clear();
+    frees.swap(pending_frees_);
+  }
+  VLOG(8) << "Free " << frees.size() << " allocations in stream order";
+
+  for (StreamSafeCUDAAllocation* allocation : frees) {
+    // events recorded while capturing a CUDA Graph are still polled
+    if (allocation->CanBeFreed()) {
+      delete allocation;
+    } else {
+      std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
+      unfreed_allocations_.emplace_back(allocation);
+    }
+  }
+}
+
 uint64_t StreamSafeCUDAAllocator::ProcessUnfreedAllocationsAndRelease() {
+  ProcessPendingFrees();
   ProcessUnfreedAllocations();
   return underlying_allocator_->Release(place_);
 }
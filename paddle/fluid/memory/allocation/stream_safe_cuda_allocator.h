@@ -17,6 +17,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
 #include "paddle/fluid/memory/allocation/spin_lock.h"
@@ -44,6 +45,8 @@ class StreamSafeCUDAAllocation : public Allocation {
   void EraseStream(gpuStream_t stream);
   bool CanBeFreed();
   gpuStream_t GetOwningStream() const;
+  // the streams recorded in stream ordered mode, cleared
+  std::set<gpuStream_t> TakeUsedStreams();
 
  private:
   thread_local static std::once_flag once_flag_;
@@ -51,6 +54,10 @@ class StreamSafeCUDAAllocation : public Allocation {
   void RecordStreamWithNoGraphCapturing(gpuStream_t stream);
   DecoratedAllocationPtr underlying_allocation_;
   std::set<gpuStream_t> graph_capturing_stream_set_;
+  // with FLAGS_stream_ordered_cuda_free, the streams are only remembered by
+  // RecordStream and synchronized with once the allocation is freed
+  bool stream_ordered_;
+  std::set<gpuStream_t> used_stream_set_;
   std::map<gpuStream_t, gpuEvent_t> outstanding_event_map_;
   gpuStream_t owning_stream_;
   SpinLock outstanding_event_map_lock_;
@@ -72,6 +79,7 @@ class StreamSafeCUDAAllocator
   bool IsAllocThreadSafe() const override;
   gpuStream_t GetDefaultStream() const;
   void SetDefaultStream(gpuStream_t stream);
+  bool IsStreamOrdered() const;
 
  protected:
   phi::Allocation *AllocateImpl(size_t size) override;
@@ -81,6 +89,11 @@ class StreamSafeCUDAAllocator
  private:
   void ProcessUnfreedAllocations();
   uint64_t ProcessUnfreedAllocationsAndRelease();
+  // Makes the default stream wait for the streams used by the pending frees,
+  // one event per stream, then gives the allocations back to the underlying
+  // allocator, their memory is safe to reuse in the order of the default
+  // stream from then on.
+  void ProcessPendingFrees();
 
   static std::map<platform::Place, std::vector<StreamSafeCUDAAllocator *>>
       allocator_map_;
@@ -92,6 +105,13 @@ class StreamSafeCUDAAllocator
   std::list<StreamSafeCUDAAllocation *> unfreed_allocations_;
   SpinLock unfreed_allocation_lock_;
 
+  bool stream_ordered_;
+  std::vector<StreamSafeCUDAAllocation *> pending_frees_;
+  std::set<gpuStream_t> pending_streams_;
+  // re-recorded for every batch of frees
+  std::map<gpuStream_t, gpuEvent_t> stream_events_;
+  SpinLock pending_free_lock_;
+
   bool in_cuda_graph_capturing_;
 };
 
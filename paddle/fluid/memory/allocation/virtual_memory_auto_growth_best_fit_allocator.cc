@@ -14,9 +14,17 @@
 
 #include "paddle/fluid/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
 
+#include <algorithm>
 #include <mutex>
 
-#include "paddle/fluid/memory/allocation/aligned_allocator.h"
+#include "paddle/fluid/platform/flags.h"
+
+PADDLE_DEFINE_EXPORTED_bool(
+    virtual_memory_compact_on_oom,
+    true,
+    "Whether VirtualMemoryAutoGrowthBestFitAllocator unmaps the free "
+    "extensions and grows the free block at the end, instead of mapping the "
+    "whole request anew, when the GPU runs out of memory.");
 
 namespace paddle {
 namespace memory {
@@ -26,13 +34,15 @@ bool NeedSplit(size_t block_size, size_t alignment, size_t alloc_size) {
   return block_size > (alloc_size * 2) || (block_size - alloc_size) > alignment;
 }
 
+// CUDAVirtualMemAllocator maps at multiples of its granularity already, an
+// AlignedAllocator in between would pad every extension, so that no two
+// extensions were contiguous and merged
 VirtualMemoryAutoGrowthBestFitAllocator::
     VirtualMemoryAutoGrowthBestFitAllocator(
         const std::shared_ptr<Allocator> &underlying_allocator,
         size_t alignment,
         const platform::CUDAPlace &place)
-    : underlying_allocator_(
-          std::make_shared<AlignedAllocator>(underlying_allocator, alignment)),
+    : underlying_allocator_(underlying_allocator),
       alignment_(alignment),
       place_(place) {}
 
@@ -43,13 +53,100 @@ phi::Allocation *VirtualMemoryAutoGrowthBestFitAllocator::AllocateImpl(
   auto result = AllocFromFreeBlocks(size);
 
   if (!result) {
-    ExtendAndMerge(size);
+    try {
+      ExtendAndMerge(size);
+    } catch (BadAlloc &) {
+      if (!FLAGS_virtual_memory_compact_on_oom) {
+        throw;
+      }
+      CompactAndExtend(size);
+    }
     result = AllocFromFreeBlocks(size);
   }
 
   return result;
 }
 
+FragmentationReport
+VirtualMemoryAutoGrowthBestFitAllocator::GetFragmentationReport() {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  return CollectFragmentationReport();
+}
+
+FragmentationReport
+VirtualMemoryAutoGrowthBestFitAllocator::CollectFragmentationReport() const {
+  // a chunk is a run of contiguous blocks here
+  FragmentationReport report;
+  const uint8_t *end = nullptr;
+  for (auto &block : all_blocks_) {
+    if (block.ptr_ != end) {
+      report.AddChunk();
+    }
+    report.AddBlock(block.size_, block.is_free_);
+    end = reinterpret_cast<const uint8_t *>(block.ptr_) + block.size_;
+  }
+  return report;
+}
+
+uint64_t VirtualMemoryAutoGrowthBestFitAllocator::ReleaseFreeExtensions() {
+  uint64_t bytes = 0;
+  for (auto it = allocations_.begin(); it != allocations_.end();) {
+    auto *begin = reinterpret_cast<uint8_t *>((*it)->ptr());
+    auto *end = begin + (*it)->size();
+    auto block_it = std::find_if(
+        all_blocks_.begin(), all_blocks_.end(), [&](const Block &block) {
+          auto *ptr = reinterpret_cast<uint8_t *>(block.ptr_);
+          return block.is_free_ && ptr <= begin && end <= ptr + block.size_;
+        });
+    if (block_it == all_blocks_.end()) {
+      ++it;
+      continue;
+    }
+
+    // keep what the free block has before and after the extension
+    auto *ptr = reinterpret_cast<uint8_t *>(block_it->ptr_);
+    auto *block_end = ptr + block_it->size_;
+    free_blocks_.erase(std::make_pair(block_it->size_, block_it->ptr_));
+    if (ptr < begin) {
+      auto iter = all_blocks_.insert(block_it, Block(ptr, begin - ptr, true));
+      free_blocks_.emplace(std::make_pair(iter->size_, iter->ptr_), iter);
+    }
+    if (end < block_end) {
+      auto iter =
+          all_blocks_.insert(block_it, Block(end, block_end - end, true));
+      free_blocks_.emplace(std::make_pair(iter->size_, iter->ptr_), iter);
+    }
+    all_blocks_.erase(block_it);
+
+    bytes += (*it)->size();
+    it = allocations_.erase(it);
+  }
+  return bytes;
+}
+
+void VirtualMemoryAutoGrowthBestFitAllocator::CompactAndExtend(size_t size) {
+  auto report = CollectFragmentationReport();
+  uint64_t released = ReleaseFreeExtensions();
+  // the next extension is mapped right after the last one, so a free block
+  // at the end only needs what it lacks
+  size_t extend_size = size;
+  if (!all_blocks_.empty() && all_blocks_.back().is_free_ &&
+      all_blocks_.back().size_ < size) {
+    extend_size = size - all_blocks_.back().size_;
+  }
+  LOG(WARNING) << "VirtualMemoryAutoGrowthBestFitAllocator failed to extend "
+               << size << " bytes, released " << released
+               << " free bytes and extends " << extend_size << " bytes, "
+               << report.ToString();
+
+  // a BadAlloc from here goes to the RetryAllocator
+  ExtendAndMerge(extend_size);
+  if (free_blocks_.lower_bound(std::make_pair(size, nullptr)) ==
+      free_blocks_.end()) {
+    ExtendAndMerge(size);
+  }
+}
+
 void VirtualMemoryAutoGrowthBestFitAllocator::FreeImpl(
     phi::Allocation *allocation) {
   std::lock_guard<SpinLock> guard(spinlock_);
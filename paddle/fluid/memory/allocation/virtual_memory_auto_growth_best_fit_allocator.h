@@ -19,6 +19,7 @@
 #include <set>
 
 #include "paddle/fluid/memory/allocation/allocator.h"
+#include "paddle/fluid/memory/allocation/fragmentation_report.h"
 #include "paddle/fluid/memory/allocation/spin_lock.h"
 
 namespace paddle {
@@ -50,6 +51,11 @@ struct BlockAllocation : public Allocation {
  * address. If the video memory applied for twice is continuous, we can combine
  * the two video memories later. This combination can greatly reduce
  * fragmentation.
+ *
+ * When the underlying allocator runs out of memory, the extensions that are
+ * entirely free are unmapped first, so their physical memory backs the new
+ * extension mapped right after the last one, and the free block at the end
+ * only needs to grow by the missing part (FLAGS_virtual_memory_compact_on_oom).
  */
 class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
  public:
@@ -60,6 +66,8 @@ class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
 
   bool IsAllocThreadSafe() const override { return true; }
 
+  FragmentationReport GetFragmentationReport();
+
  protected:
   phi::Allocation *AllocateImpl(size_t size) override;
 
@@ -69,6 +77,10 @@ class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
   phi::Allocation *AllocFromFreeBlocks(size_t size);
   void ExtendAndMerge(size_t size);
   void TryMergeBlock2Blocks(std::list<Block>::iterator iter);
+  // unmaps the extensions no allocation uses, returns the bytes released
+  uint64_t ReleaseFreeExtensions();
+  void CompactAndExtend(size_t size);
+  FragmentationReport CollectFragmentationReport() const;
 
   std::shared_ptr<Allocator> underlying_allocator_;
   size_t alignment_;
@@ -23,6 +23,14 @@ limitations under the License. */
 #ifdef PADDLE_WITH_XPU
 #include "paddle/fluid/platform/device/xpu/xpu_header.h"
 #endif
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include <cstring>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/memory/allocation/pinned_staging_allocator.h"
+
+COMMON_DECLARE_bool(use_pinned_staging_pool);
+#endif
 
 namespace paddle {
 namespace memory {
@@ -349,7 +357,33 @@ TEST_API void Copy<platform::CUDAPlace, platform::CPUPlace>(
   platform::SetDeviceId(dst_place.device);
   VLOG(4) << "memory::Copy " << num << " Bytes from " << src_place << " to "
           << dst_place << " by stream(" << stream << ")";
-  if (stream) {
+  if (stream && FLAGS_use_pinned_staging_pool &&
+      num <= allocation::PinnedStagingAllocator::kMaxSize) {
+    platform::RecordEvent record_event(
+        "GpuMemcpyAsync(staged):CPU->GPU",
+        platform::TracerEventType::UserDefined,
+        1);
+    auto staging_allocator =
+        allocation::PinnedStagingAllocator::Instance(dst_place);
+    auto staging = staging_allocator->Allocate(num);
+    std::memcpy(staging->ptr(), src, num);
+#ifdef PADDLE_WITH_HIP
+    platform::GpuMemcpyAsync(dst,
+                             staging->ptr(),
+                             num,
+                             hipMemcpyHostToDevice,
+                             reinterpret_cast<gpuStream_t>(stream));
+#else
+    platform::GpuMemcpyAsync(dst,
+                             staging->ptr(),
+                             num,
+                             cudaMemcpyHostToDevice,
+                             reinterpret_cast<gpuStream_t>(stream));
+#endif
+    // the buffer is reused once the copy completes
+    staging_allocator->RecordStream(staging.get(),
+                                    reinterpret_cast<gpuStream_t>(stream));
+  } else if (stream) {
     platform::RecordEvent record_event(
         "GpuMemcpyAsync:CPU->GPU", platform::TracerEventType::UserDefined, 1);
 #ifdef PADDLE_WITH_HIP
@@ -0,0 +1,268 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. */
+
+#include "paddle/fluid/operators/fused/fusion_embedding_seqpool_concat_op.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+
+namespace paddle {
+namespace operators {
+
+void FusionEmbeddingSeqPoolConcatOp::InferShape(
+    framework::InferShapeContext* ctx) const {
+  OP_INOUT_CHECK(ctx->HasInputs("W"), "Input", "W", "FusionEmbSeqPoolConcat");
+  OP_INOUT_CHECK(
+      ctx->HasInputs("Ids"), "Input", "Ids", "FusionEmbSeqPoolConcat");
+  OP_INOUT_CHECK(
+      ctx->HasOutput("Out"), "Output", "Out", "FusionEmbSeqPoolConcat");
+
+  auto tables_dims = ctx->GetInputsDim("W");
+  auto ids_dims = ctx->GetInputsDim("Ids");
+  const size_t n = ids_dims.size();
+  PADDLE_ENFORCE_EQ(
+      tables_dims.size() == 1 || tables_dims.size() == n,
+      true,
+      platform::errors::InvalidArgument(
+          "The Input(W) of FusionEmbeddingSeqPoolConcatOp should be one table "
+          "shared by the slots or one table of each slot, but received %d "
+          "tables of %d slots.",
+          tables_dims.size(),
+          n));
+  int64_t w = tables_dims[0][1];
+  for (const auto& dims : tables_dims) {
+    PADDLE_ENFORCE_EQ(dims.size(),
+                      2,
+                      platform::errors::InvalidArgument(
+                          "The dims size of Input(W) should be equal to 2, "
+                          "but received value is %d.",
+                          dims.size()));
+    PADDLE_ENFORCE_EQ(dims[1],
+                      w,
+                      platform::errors::InvalidArgument(
+                          "The width of all tables should be equal, but "
+                          "received %d and %d.",
+                          dims[1],
+                          w));
+  }
+  for (const auto& dims : ids_dims) {
+    PADDLE_ENFORCE_EQ(
+        dims.size() == 2 && dims[1] == 1,
+        true,
+        platform::errors::InvalidArgument(
+            "The shape of each Input(Ids) should be [N, 1], but received %s.",
+            dims));
+  }
+
+  // The output height should be confirmed in Compute,
+  // since input lod is not accessible here.
+  ctx->SetOutputDim("Out", {-1, w * static_cast<int64_t>(n)});
+  if (!ctx->IsRuntime()) {
+    ctx->SetLoDLevel("Out", 1);
+  }
+}
+
+phi::KernelKey FusionEmbeddingSeqPoolConcatOp::GetExpectedKernelType(
+    const framework::ExecutionContext& ctx) const {
+  return phi::KernelKey(OperatorWithKernel::IndicateVarDataType(ctx, "W"),
+                        ctx.GetPlace());
+}
+
+void FusionEmbeddingSeqPoolConcatOpMaker::Make() {
+  AddInput("W",
+           "(phi::DenseTensor) The embedding tables of [table_height, w], "
+           "one shared by all the slots or one of each slot.")
+      .AsDuplicable();
+  AddInput("Ids",
+           "(phi::DenseTensor) The int64 ids of [N, 1] and LoD level 1 of "
+           "each slot, of the same batch size.")
+      .AsDuplicable();
+  AddOutput("Out",
+            "(phi::DenseTensor) The pooled embeddings of [batch_size, "
+            "slots * w], the ones of each instance concatenated in the order "
+            "of the slots.");
+  AddAttr<std::string>("pooltype",
+                       "(string, default 'SUM') some of the pooling "
+                       "pooltype of SequencePoolOp.")
+      .SetDefault("SUM")
+      .InEnum({"AVERAGE", "SUM", "SQRT"});
+  AddAttr<int64_t>("padding_idx",
+                   "(int64, default -1) The ids of padding_idx are neither "
+                   "pooled nor counted. -1 means no padding.")
+      .SetDefault(-1);
+  AddComment(R"DOC(
+Fusion Embedding Lookup, Sequence Pool of pooltype(sum, average and sqrt) and
+Concat Operator.
+
+It looks up the ids of all the slots in one call, so the instances of all the
+slots are pooled in parallel, and the gathered rows are prefetched ahead.
+)DOC");
+}
+
+namespace {
+
+// the ids looked up ahead of the row being pooled
+constexpr int64_t kPrefetchDistance = 4;
+
+template <typename T>
+inline void PrefetchRow(const T* row, int64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+  const char* begin = reinterpret_cast<const char*>(row);
+  const char* end = reinterpret_cast<const char*>(row + w);
+  for (const char* p = begin; p < end; p += 64) {
+    __builtin_prefetch(p);
+  }
+#endif
+}
+
+}  // namespace
+
+template <typename T, typename DeviceContext>
+class FusionEmbeddingSeqPoolConcatKernel : public framework::OpKernel<T> {
+ public:
+  void Compute(const framework::ExecutionContext& ctx) const override {
+    auto tables = ctx.MultiInput<phi::DenseTensor>("W");
+    auto ids = ctx.MultiInput<phi::DenseTensor>("Ids");
+    auto* out = ctx.Output<phi::DenseTensor>("Out");
+    std::string pooltype = ctx.Attr<std::string>("pooltype");
+    int64_t padding_idx = ctx.Attr<int64_t>("padding_idx");
+    if (padding_idx == -1) {
+      // no id is padding
+      padding_idx = std::numeric_limits<int64_t>::min();
+    }
+
+    const size_t n = ids.size();
+    const int64_t w = tables[0]->dims()[1];
+    PADDLE_ENFORCE_EQ(ids[0]->lod().size(),
+                      1UL,
+                      platform::errors::InvalidArgument(
+                          "The LoD level of Input(Ids) should be 1. But "
+                          "received Ids's LoD level = %d.",
+                          ids[0]->lod().size()));
+    const size_t bs = ids[0]->lod()[0].size() - 1;
+
+    std::vector<const T*> tables_data(n);
+    std::vector<const int64_t*> ids_data(n);
+    std::vector<const phi::Vector<size_t>*> ids_lods(n);
+    for (size_t i = 0; i < n; ++i) {
+      const auto* table = tables.size() == 1 ? tables[0] : tables[i];
+      const auto& lod = ids[i]->lod();
+      PADDLE_ENFORCE_EQ(
+          lod.size() == 1 && lod[0].size() == bs + 1,
+          true,
+          platform::errors::InvalidArgument(
+              "The Input(Ids) of all slots should be of LoD level 1 and "
+              "batch size %d, but the %d-th is not.",
+              bs,
+              i));
+      tables_data[i] = table->data<T>();
+      ids_data[i] = ids[i]->data<int64_t>();
+      ids_lods[i] = &lod[0];
+
+      // checked here, the pool below runs in parallel
+      int64_t table_height = table->dims()[0];
+      for (int64_t k = 0; k < ids[i]->numel(); ++k) {
+        int64_t id = ids_data[i][k];
+        PADDLE_ENFORCE_EQ(
+            (id >= 0 && id < table_height) || id == padding_idx,
+            true,
+            platform::errors::InvalidArgument(
+                "The ids of the %d-th slot should be in [0, %d) or be "
+                "padding_idx, but the %d-th is %d.",
+                i,
+                table_height,
+                k,
+                id));
+      }
+    }
+
+    out->Resize({static_cast<int64_t>(bs), static_cast<int64_t>(n) * w});
+    framework::LoD out_lod(1);
+    out_lod[0].resize(bs + 1);
+    for (size_t i = 0; i <= bs; ++i) {
+      out_lod[0][i] = i;
+    }
+    out->set_lod(out_lod);
+    T* out_data = out->mutable_data<T>(ctx.GetPlace());
+
+    auto vadd = phi::jit::KernelFuncs<phi::jit::VAddTuple<T>,
+                                      platform::CPUPlace>::Cache()
+                    .At(static_cast<int>(w));
+    auto vscal = phi::jit::KernelFuncs<phi::jit::VScalTuple<T>,
+                                       platform::CPUPlace>::Cache()
+                     .At(static_cast<int>(w));
+
+    // the slots of an instance are neighbours in the output
+    const int64_t num_tasks = static_cast<int64_t>(bs * n);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t task = 0; task < num_tasks; ++task) {
+      size_t slot = task % n;
+      size_t ins = task / n;
+      const T* table = tables_data[slot];
+      const int64_t* id = ids_data[slot] + (*ids_lods[slot])[ins];
+      const int64_t len =
+          (*ids_lods[slot])[ins + 1] - (*ids_lods[slot])[ins];
+      T* dst = out_data + task * w;
+
+      int64_t count = 0;
+      for (int64_t k = 0; k < len; ++k) {
+        if (k + kPrefetchDistance < len &&
+            id[k + kPrefetchDistance] != padding_idx) {
+          PrefetchRow(table + id[k + kPrefetchDistance] * w, w);
+        }
+        if (id[k] == padding_idx) {
+          continue;
+        }
+        const T* row = table + id[k] * w;
+        if (count == 0) {
+          std::memcpy(dst, row, w * sizeof(T));
+        } else {
+          vadd(row, dst, dst, static_cast<int>(w));
+        }
+        ++count;
+      }
+
+      if (count == 0) {
+        std::memset(dst, 0, w * sizeof(T));
+      } else if (count > 1 && pooltype != "SUM") {
+        T scale = pooltype == "AVERAGE"
+                      ? static_cast<T>(1) / static_cast<T>(count)
+                      : static_cast<T>(1) / std::sqrt(static_cast<T>(count));
+        vscal(&scale, dst, dst, static_cast<int>(w));
+      }
+    }
+  }
+};
+
+}  // namespace operators
+}  // namespace paddle
+
+namespace ops = paddle::operators;
+REGISTER_OPERATOR(fusion_embedding_seqpool_concat,
+                  ops::FusionEmbeddingSeqPoolConcatOp,
+                  ops::FusionEmbeddingSeqPoolConcatOpMaker);
+
+PD_REGISTER_STRUCT_KERNEL(fusion_embedding_seqpool_concat,
+                          CPU,
+                          ALL_LAYOUT,
+                          ops::FusionEmbeddingSeqPoolConcatKernel,
+                          float,
+                          double) {}
@@ -18,13 +18,22 @@ limitations under the License. */
 #include <string>
 #include <vector>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/io/tensor_checkpoint.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/string_array.h"
 #include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/platform/device_context.h"
+#if defined(PADDLE_WITH_CUDA) && !defined(_WIN32)
+#include "paddle/fluid/memory/allocation/cuda_ipc_allocator.h"
+#include "paddle/fluid/memory/memcpy.h"
+#endif
+
+COMMON_DECLARE_bool(load_combined_params_with_mmap);
+COMMON_DECLARE_string(shared_params_name);
 
 namespace paddle {
 namespace operators {
@@ -45,6 +54,20 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
                           "it to be greater than 0.",
                           out_var_names.size()));
     if (!model_from_memory) {
+      if (framework::IsTensorCheckpoint(filename)) {
+        LoadParamsFromCheckpoint(
+            ctx, place, filename, load_as_fp16, out_var_names);
+        return;
+      }
+#ifndef _WIN32
+      if (FLAGS_load_combined_params_with_mmap &&
+          (platform::is_cpu_place(place) || platform::is_gpu_place(place)) &&
+          !HasVocab(ctx)) {
+        LoadParamsFromMappedFile(
+            ctx, place, filename, load_as_fp16, out_var_names);
+        return;
+      }
+#endif
       std::ifstream fin(filename, std::ios::binary);
       PADDLE_ENFORCE_EQ(
           static_cast<bool>(fin),
@@ -115,28 +138,7 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
 
         // Get data from fin to tensor
         paddle::framework::DeserializeFromStream(*buffer, tensor, dev_ctx);
-
-        auto in_dtype = tensor->dtype();
-        auto out_dtype = load_as_fp16 ? phi::DataType::FLOAT16 : in_dtype;
-
-        if (in_dtype != out_dtype) {
-          // convert to float16 tensor
-          auto in_kernel_type =
-              phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, in_dtype);
-          auto out_kernel_type =
-              phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, out_dtype);
-          phi::DenseTensor fp16_tensor;
-          // copy LoD info to the new tensor
-          fp16_tensor.set_lod(tensor->lod());
-          framework::TransDataType(
-              in_kernel_type, out_kernel_type, *tensor, &fp16_tensor);
-
-          // reset output tensor
-          out_vars[i]->Clear();
-          tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
-          tensor->set_lod(fp16_tensor.lod());
-          tensor->ShareDataWith(fp16_tensor);
-        }
+        CastLoadedTensor(place, load_as_fp16, out_vars[i]);
       }
     }
     buffer->peek();
@@ -146,6 +148,201 @@ class LoadCombineOpKernel : public framework::OpKernel<T> {
                           "Not allowed to load partial data via "
                           "load_combine_op, please use load_op instead."));
   }
+
+  // save_combine wrote the tensors positionally with
+  // FLAGS_save_combine_with_tensor_checkpoint
+  void LoadParamsFromCheckpoint(
+      const framework::ExecutionContext &context,
+      const platform::Place &place,
+      const std::string &filename,
+      bool load_as_fp16,
+      const std::vector<std::string> &out_var_names) const {
+    platform::DeviceContextPool &pool = platform::DeviceContextPool::Instance();
+    auto &dev_ctx = *pool.Get(place);
+    auto out_vars = context.MultiOutputVar("Out");
+    auto tensors = framework::LoadTensorCheckpoint(filename);
+    PADDLE_ENFORCE_EQ(tensors.size(),
+                      out_var_names.size(),
+                      platform::errors::Unavailable(
+                          "The tensor checkpoint %s has %d tensors, but %d "
+                          "variables are loaded. Not allowed to load partial "
+                          "data via load_combine_op, please use load_op "
+                          "instead.",
+                          filename,
+                          tensors.size(),
+                          out_var_names.size()));
+    for (size_t i = 0; i < out_var_names.size(); i++) {
+      VLOG(4) << "loading tensor: " << out_var_names[i] << " from checkpoint";
+      PADDLE_ENFORCE_NOT_NULL(
+          out_vars[i],
+          platform::errors::InvalidArgument(
+              "The variable %s to be loaded cannot be found.",
+              out_var_names[i]));
+      auto *tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
+      if (platform::is_cpu_place(place)) {
+        *tensor = std::move(tensors[i].second);
+      } else {
+        framework::TensorCopy(tensors[i].second, place, dev_ctx, tensor);
+      }
+      CastLoadedTensor(place, load_as_fp16, out_vars[i]);
+    }
+    dev_ctx.Wait();
+  }
+
+#ifndef _WIN32
+  // The CPU parameters share the pages of a copy-on-write mapping of the
+  // params file instead of being read into fresh tensors, the GPU ones are
+  // streamed to the device through pinned staging buffers.
+  void LoadParamsFromMappedFile(
+      const framework::ExecutionContext &context,
+      const platform::Place &place,
+      const std::string &filename,
+      bool load_as_fp16,
+      const std::vector<std::string> &out_var_names) const {
+    platform::DeviceContextPool &pool = platform::DeviceContextPool::Instance();
+    auto &dev_ctx = *pool.Get(place);
+    auto out_vars = context.MultiOutputVar("Out");
+    auto file = std::make_shared<memory::allocation::MappedFile>(filename);
+#if defined(PADDLE_WITH_CUDA)
+    if (!FLAGS_shared_params_name.empty() && platform::is_gpu_place(place) &&
+        !load_as_fp16) {
+      LoadSharedParamsFromMappedFile(dev_ctx, *file, out_vars, out_var_names);
+      return;
+    }
+#endif
+
+    size_t offset = 0;
+    for (size_t i = 0; i < out_var_names.size(); i++) {
+      VLOG(4) << "loading tensor: " << out_var_names[i] << " from mapping";
+      PADDLE_ENFORCE_NOT_NULL(
+          out_vars[i],
+          platform::errors::InvalidArgument(
+              "The variable %s to be loaded cannot be found.",
+              out_var_names[i]));
+      auto *tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
+      framework::DeserializeFromMappedFile(file, &offset, tensor, dev_ctx);
+      CastLoadedTensor(place, load_as_fp16, out_vars[i]);
+    }
+    dev_ctx.Wait();
+    PADDLE_ENFORCE_EQ(offset,
+                      file->size(),
+                      platform::errors::Unavailable(
+                          "Not allowed to load partial data via "
+                          "load_combine_op, please use load_op instead."));
+  }
+
+#if defined(PADDLE_WITH_CUDA)
+  // The processes loading the same params file on the same GPU with the same
+  // FLAGS_shared_params_name share one read-only copy of the parameters: the
+  // first one fills a device region the others map through CUDA IPC.
+  void LoadSharedParamsFromMappedFile(
+      const platform::DeviceContext &dev_ctx,
+      const memory::allocation::MappedFile &file,
+      const std::vector<framework::Variable *> &out_vars,
+      const std::vector<std::string> &out_var_names) const {
+    constexpr size_t kAlignment = 256;
+    std::vector<phi::DataType> dtypes(out_vars.size());
+    std::vector<size_t> data_offsets(out_vars.size());
+    std::vector<size_t> region_offsets(out_vars.size());
+    size_t offset = 0;
+    size_t region_size = 0;
+    for (size_t i = 0; i < out_vars.size(); i++) {
+      PADDLE_ENFORCE_NOT_NULL(
+          out_vars[i],
+          platform::errors::InvalidArgument(
+              "The variable %s to be loaded cannot be found.",
+              out_var_names[i]));
+      auto *tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
+      dtypes[i] =
+          framework::DeserializeMetaFromMappedFile(file, &offset, tensor);
+      size_t size = tensor->numel() * phi::SizeOf(dtypes[i]);
+      PADDLE_ENFORCE_LE(offset + size,
+                        file.size(),
+                        platform::errors::Unavailable(
+                            "The data of %s is out of %s, please check "
+                            "whether the model file is complete or damaged.",
+                            out_var_names[i],
+                            file.path()));
+      data_offsets[i] = offset;
+      region_offsets[i] = region_size;
+      offset += size;
+      region_size += (size + kAlignment - 1) / kAlignment * kAlignment;
+    }
+    PADDLE_ENFORCE_EQ(offset,
+                      file.size(),
+                      platform::errors::Unavailable(
+                          "Not allowed to load partial data via "
+                          "load_combine_op, please use load_op instead."));
+
+    // one region per params file and device
+    platform::CUDAPlace place(dev_ctx.GetPlace().GetDeviceId());
+    std::string name = FLAGS_shared_params_name + "_" +
+                       std::to_string(place.GetDeviceId()) + "_" +
+                       std::to_string(std::hash<std::string>()(file.path()));
+    auto region =
+        memory::allocation::SharedDeviceRegion::Open(name, region_size, place);
+    auto stream = static_cast<const phi::GPUContext &>(dev_ctx).stream();
+    for (size_t i = 0; i < out_vars.size(); i++) {
+      auto *tensor = out_vars[i]->GetMutable<phi::DenseTensor>();
+      size_t size = tensor->numel() * phi::SizeOf(dtypes[i]);
+      auto holder = region->Slice(region_offsets[i], size);
+      if (region->IsOwner() && size > 0) {
+        memory::Copy(place,
+                     holder->ptr(),
+                     platform::CPUPlace(),
+                     file.data() + data_offsets[i],
+                     size,
+                     stream);
+      }
+      tensor->ResetHolderWithType(holder, dtypes[i]);
+    }
+    if (region->IsOwner()) {
+      dev_ctx.Wait();
+      region->MarkReady();
+    }
+    VLOG(3) << "Load " << out_vars.size() << " params of " << region_size
+            << " bytes " << (region->IsOwner() ? "into" : "from")
+            << " the shared device region " << name;
+  }
+#endif
+
+  bool HasVocab(const framework::ExecutionContext &context) const {
+    for (auto *var : context.MultiOutputVar("Out")) {
+      if (var != nullptr && var->IsType<framework::Vocab>()) {
+        return true;
+      }
+    }
+    return false;
+  }
+#endif
+
+  // converts the tensor loaded into var to float16 if load_as_fp16
+  void CastLoadedTensor(const platform::Place &place,
+                        bool load_as_fp16,
+                        framework::Variable *var) const {
+    auto *tensor = var->GetMutable<phi::DenseTensor>();
+    auto in_dtype = tensor->dtype();
+    auto out_dtype = load_as_fp16 ? phi::DataType::FLOAT16 : in_dtype;
+
+    if (in_dtype != out_dtype) {
+      // convert to float16 tensor
+      auto in_kernel_type =
+          phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, in_dtype);
+      auto out_kernel_type =
+          phi::KernelKey(place, phi::DataLayout::ALL_LAYOUT, out_dtype);
+      phi::DenseTensor fp16_tensor;
+      // copy LoD info to the new tensor
+      fp16_tensor.set_lod(tensor->lod());
+      framework::TransDataType(
+          in_kernel_type, out_kernel_type, *tensor, &fp16_tensor);
+
+      // reset output tensor
+      var->Clear();
+      tensor = var->GetMutable<phi::DenseTensor>();
+      tensor->set_lod(fp16_tensor.lod());
+      tensor->ShareDataWith(fp16_tensor);
+    }
+  }
 };
 
 }  // namespace operators
@@ -14,11 +14,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT
 #include <condition_variable>  // NOLINT
-#include <deque>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "paddle/fluid/memory/allocation/spin_lock.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/core/metrics.h"
 
 namespace paddle {
 namespace operators {
@@ -31,105 +37,154 @@ class BlockingQueue {
   // framework::Channel, but which has currently a deadlock bug. BlockingQueue
   // is a workaround and a simplified version of framework::Channel as it
   // doesn't support GPU and it implements on buffered blocking queue.
+  //
+  // The elements are kept in a ring buffer of the capacity. A sender or a
+  // receiver which would block first spins for spin_iterations checks of the
+  // size, and each side notifies the other one only if it is blocked, so the
+  // handoffs between the sides which keep up with each other make no futex
+  // calls. With a metrics_name, the depth and the blocked time of the queues
+  // of that name are reported to phi::MetricsRegistry.
  public:
-  explicit BlockingQueue(size_t capacity, bool speed_test_mode = false)
-      : capacity_(capacity), speed_test_mode_(speed_test_mode) {
+  explicit BlockingQueue(size_t capacity,
+                         bool speed_test_mode = false,
+                         int spin_iterations = 0,
+                         const std::string& metrics_name = "")
+      : capacity_(capacity),
+        speed_test_mode_(speed_test_mode),
+        spin_iterations_(spin_iterations) {
     PADDLE_ENFORCE_GT(capacity_,
                       static_cast<size_t>(0),
                       platform::errors::InvalidArgument(
                           "The capacity of a reader::BlockingQueue must be "
                           "greater than 0, but received capacity is %d.",
                           capacity_));
+    ring_.resize(capacity_);
+    if (!metrics_name.empty()) {
+      auto& registry = phi::MetricsRegistry::Instance();
+      std::string labels = "queue=\"" + metrics_name + "\"";
+      depth_metric_ = registry.GetGauge("paddle_reader_queue_depth",
+                                        "Number of the elements in the "
+                                        "reader queues.",
+                                        labels);
+      send_wait_metric_ = registry.GetHistogram(
+          "paddle_reader_queue_send_wait_seconds",
+          "Time the senders of the reader queues blocked on a full queue.",
+          labels);
+      receive_wait_metric_ = registry.GetHistogram(
+          "paddle_reader_queue_receive_wait_seconds",
+          "Time the receivers of the reader queues blocked on an empty "
+          "queue.",
+          labels);
+    }
   }
 
-  bool Send(const T& elem) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    send_cv_.wait(
-        lock, [&] { return queue_.size() < capacity_ || closed_ || killed_; });
-    if (killed_) {
-      VLOG(3)
-          << "WARNING:: Sending an element to a killed reader::BlockingQueue";
-      return false;
+  ~BlockingQueue() {
+    if (depth_metric_ != nullptr) {
+      depth_metric_->Add(-static_cast<double>(size_.load()));
     }
-    if (closed_) {
-      VLOG(5)
-          << "WARNING: Sending an element to a closed reader::BlockingQueue.";
-      return false;
-    }
-    PADDLE_ENFORCE_LT(
-        queue_.size(),
-        capacity_,
-        platform::errors::PermissionDenied(
-            "The queue size cannot exceed the set queue capacity. Expected "
-            "queue size is less than %d. But received %d",
-            capacity_,
-            queue_.size()));
-    queue_.push_back(elem);
-    receive_cv_.notify_one();
-    return true;
   }
 
+  bool Send(const T& elem) { return Send(T(elem)); }
+
   bool Send(T&& elem) {
+    SpinUntil([this] { return CanSend(); });
     std::unique_lock<std::mutex> lock(mutex_);
-    send_cv_.wait(
-        lock, [&] { return queue_.size() < capacity_ || closed_ || killed_; });
-    if (killed_) {
-      VLOG(3)
-          << "WARNING:: Sending an element to a killed reader::BlockingQueue";
+    Wait(&lock, &send_cv_, &send_waiters_, send_wait_metric_, [this] {
+      return CanSend();
+    });
+    if (!EnforceCanSend()) {
       return false;
     }
-    if (closed_) {
-      VLOG(5)
-          << "WARNING: Sending an element to a closed reader::BlockingQueue.";
-      return false;
-    }
-    PADDLE_ENFORCE_LT(
-        queue_.size(),
-        capacity_,
-        platform::errors::PermissionDenied(
-            "The queue size cannot exceed the set queue capacity. Expected "
-            "queue size is less than %d. But received %d",
-            capacity_,
-            queue_.size()));
-    queue_.emplace_back(std::move(elem));
-    receive_cv_.notify_one();
+    PushUnlocked(std::move(elem));
+    Notify(&receive_cv_, receive_waiters_, 1);
     return true;
   }
 
+  // Sends the elements in order, blocking while the queue is full, and
+  // returns the number of the sent ones, which is less than the size of elems
+  // only if the queue is closed.
+  size_t SendBatch(std::vector<T>* elems) {
+    size_t sent = 0;
+    while (sent < elems->size()) {
+      SpinUntil([this] { return CanSend(); });
+      std::unique_lock<std::mutex> lock(mutex_);
+      Wait(&lock, &send_cv_, &send_waiters_, send_wait_metric_, [this] {
+        return CanSend();
+      });
+      if (!EnforceCanSend()) {
+        break;
+      }
+      size_t num = std::min(elems->size() - sent, capacity_ - size_.load());
+      for (size_t i = 0; i < num; ++i) {
+        PushUnlocked(std::move((*elems)[sent++]));
+      }
+      Notify(&receive_cv_, receive_waiters_, num);
+    }
+    return sent;
+  }
+
   bool Receive(T* elem) {
+    SpinUntil([this] { return CanReceive(); });
     std::unique_lock<std::mutex> lock(mutex_);
-    receive_cv_.wait(lock,
-                     [&] { return !queue_.empty() || closed_ || killed_; });
+    Wait(&lock, &receive_cv_, &receive_waiters_, receive_wait_metric_, [this] {
+      return CanReceive();
+    });
     EnforceNotKilled();
-    if (!queue_.empty()) {
+    if (size_.load() > 0) {
       PADDLE_ENFORCE_NOT_NULL(
           elem,
           platform::errors::InvalidArgument(
               "The holder to receive queue data is null pointer."));
-      *elem = queue_.front();
-      if (LIKELY(!speed_test_mode_)) {
-        queue_.pop_front();
-      }
-      send_cv_.notify_one();
+      PopUnlocked(elem);
+      Notify(&send_cv_, send_waiters_, 1);
       return true;
     } else {
-      PADDLE_ENFORCE_EQ(closed_,
-                        true,
-                        platform::errors::PermissionDenied(
-                            "Blocking queue status error, if queue is empty "
-                            "when pop data, it should be closed."));
+      EnforceClosed();
       VLOG(3) << "queue is closed! return nothing.";
       return false;
     }
   }
 
+  // Receives at most max_num elements to the back of elems, blocking while
+  // the queue is empty, and returns the number of them, which is 0 only if
+  // the queue is closed.
+  size_t ReceiveBatch(size_t max_num, std::vector<T>* elems) {
+    PADDLE_ENFORCE_NOT_NULL(
+        elems,
+        platform::errors::InvalidArgument(
+            "The holder to receive queue data is null pointer."));
+    SpinUntil([this] { return CanReceive(); });
+    std::unique_lock<std::mutex> lock(mutex_);
+    Wait(&lock, &receive_cv_, &receive_waiters_, receive_wait_metric_, [this] {
+      return CanReceive();
+    });
+    EnforceNotKilled();
+    size_t num = std::min(max_num, size_.load());
+    if (num == 0) {
+      EnforceClosed();
+      VLOG(3) << "queue is closed! return nothing.";
+      return 0;
+    }
+    for (size_t i = 0; i < num; ++i) {
+      elems->emplace_back();
+      PopUnlocked(&elems->back());
+    }
+    Notify(&send_cv_, send_waiters_, num);
+    return num;
+  }
+
   void ReOpen() {
     std::lock_guard<std::mutex> lock(mutex_);
     EnforceNotKilled();
     VLOG(1) << "reopen queue";
     closed_ = false;
-    std::deque<T> new_deque;
-    queue_.swap(new_deque);
+    if (depth_metric_ != nullptr) {
+      depth_metric_->Add(-static_cast<double>(size_.load()));
+    }
+    std::vector<T> new_ring(capacity_);
+    ring_.swap(new_ring);
+    head_ = 0;
+    size_ = 0;
     send_cv_.notify_all();
     receive_cv_.notify_all();
   }
@@ -142,20 +197,11 @@ class BlockingQueue {
     receive_cv_.notify_all();
   }
 
-  bool IsClosed() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return closed_;
-  }
+  bool IsClosed() const { return closed_.load(); }
 
-  size_t Cap() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return capacity_;
-  }
+  size_t Cap() const { return capacity_; }
 
-  size_t Size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
-  }
+  size_t Size() const { return size_.load(); }
 
   void Kill() {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -167,6 +213,101 @@ class BlockingQueue {
   }
 
  private:
+  bool CanSend() const {
+    return size_.load(std::memory_order_relaxed) < capacity_ ||
+           closed_.load(std::memory_order_relaxed);
+  }
+
+  bool CanReceive() const {
+    return size_.load(std::memory_order_relaxed) > 0 ||
+           closed_.load(std::memory_order_relaxed);
+  }
+
+  // without the lock, the caller checks again with it
+  template <typename Pred>
+  void SpinUntil(Pred ready) const {
+    for (int i = 0; i < spin_iterations_ && !ready(); ++i) {
+      memory::CpuRelax();
+    }
+  }
+
+  template <typename Pred>
+  void Wait(std::unique_lock<std::mutex>* lock,
+            std::condition_variable* cv,
+            size_t* waiters,
+            phi::MetricHistogram* wait_metric,
+            Pred ready) {
+    if (ready()) {
+      return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    ++*waiters;
+    cv->wait(*lock, ready);
+    --*waiters;
+    if (wait_metric != nullptr) {
+      wait_metric->Observe(std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
+    }
+  }
+
+  // with the lock held, only the blocked side is notified
+  void Notify(std::condition_variable* cv, size_t waiters, size_t num) {
+    if (waiters == 0 || num == 0) {
+      return;
+    }
+    if (num == 1) {
+      cv->notify_one();
+    } else {
+      cv->notify_all();
+    }
+  }
+
+  // with the lock held, after the senders wait
+  bool EnforceCanSend() {
+    if (killed_) {
+      VLOG(3)
+          << "WARNING:: Sending an element to a killed reader::BlockingQueue";
+      return false;
+    }
+    if (closed_) {
+      VLOG(5)
+          << "WARNING: Sending an element to a closed reader::BlockingQueue.";
+      return false;
+    }
+    PADDLE_ENFORCE_LT(
+        size_.load(),
+        capacity_,
+        platform::errors::PermissionDenied(
+            "The queue size cannot exceed the set queue capacity. Expected "
+            "queue size is less than %d. But received %d",
+            capacity_,
+            size_.load()));
+    return true;
+  }
+
+  void PushUnlocked(T&& elem) {
+    ring_[(head_ + size_.load()) % capacity_] = std::move(elem);
+    size_.fetch_add(1);
+    if (depth_metric_ != nullptr) {
+      depth_metric_->Add(1);
+    }
+  }
+
+  void PopUnlocked(T* elem) {
+    if (UNLIKELY(speed_test_mode_)) {
+      *elem = ring_[head_];
+      return;
+    }
+    *elem = std::move(ring_[head_]);
+    ring_[head_] = T();
+    head_ = (head_ + 1) % capacity_;
+    size_.fetch_sub(1);
+    if (depth_metric_ != nullptr) {
+      depth_metric_->Add(-1);
+    }
+  }
+
   inline void EnforceNotKilled() {
     PADDLE_ENFORCE_NE(
         killed_,
@@ -175,16 +316,35 @@ class BlockingQueue {
                                 "data reader raises an exception."));
   }
 
+  inline void EnforceClosed() {
+    PADDLE_ENFORCE_EQ(closed_.load(),
+                      true,
+                      platform::errors::PermissionDenied(
+                          "Blocking queue status error, if queue is empty "
+                          "when pop data, it should be closed."));
+  }
+
  private:
   size_t capacity_;
   bool speed_test_mode_;
-  bool closed_{false};
+  int spin_iterations_;
+  std::atomic<bool> closed_{false};
   bool killed_{false};  // the queue is broken since exception raises
-  std::deque<T> queue_;
+  std::vector<T> ring_;
+  size_t head_{0};
+  // written with the lock held, read without it by the spinning sides
+  std::atomic<size_t> size_{0};
 
   mutable std::mutex mutex_;
   mutable std::condition_variable receive_cv_;
   mutable std::condition_variable send_cv_;
+  // the numbers of the blocked receivers and senders
+  size_t receive_waiters_{0};
+  size_t send_waiters_{0};
+
+  phi::MetricGauge* depth_metric_{nullptr};
+  phi::MetricHistogram* send_wait_metric_{nullptr};
+  phi::MetricHistogram* receive_wait_metric_{nullptr};
 };
 }  // namespace reader
 }  // namespace operators
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/operators/reader/buffered_reader.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/platform/device/device_wrapper.h"
 #include "paddle/fluid/platform/profiler.h"
@@ -21,6 +22,16 @@
 
 #include "paddle/phi/backends/device_guard.h"
 #include "paddle/phi/backends/device_manager.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include <cstring>
+
+#include "paddle/fluid/memory/allocation/pinned_staging_allocator.h"
+#include "paddle/fluid/memory/malloc.h"
+#endif
+
+COMMON_DECLARE_bool(use_pinned_staging_pool);
+COMMON_DECLARE_bool(reader_packed_copy);
+COMMON_DECLARE_int32(reader_copy_streams);
 
 namespace paddle {
 namespace operators {
@@ -60,6 +71,18 @@ BufferedReader::BufferedReader(
       event = platform::CudaEventResourcePool::Instance().New(dev_idx);
     }
     stream_ = platform::CudaStreamResourcePool::Instance().New(dev_idx);
+    packed_copy_ = FLAGS_reader_packed_copy;
+    if (packed_copy_) {
+      copy_streams_.emplace_back(stream_);
+      for (int k = 1; k < FLAGS_reader_copy_streams; ++k) {
+        copy_streams_.emplace_back(
+            platform::CudaStreamResourcePool::Instance().New(dev_idx));
+      }
+      copy_events_.resize(buffer_size);
+      for (auto &event : copy_events_) {
+        event = platform::CudaEventResourcePool::Instance().New(dev_idx);
+      }
+    }
   }
 #endif
 
@@ -175,6 +198,8 @@ void BufferedReader::ReadAsync(size_t i) {
             cuda[i].ShareDataWith(cpu[i]);
           }
         }
+      } else if (packed_copy_) {
+        PackedCopyToGPU(i, cpu, &cuda);
       } else {
         // NOTE(liangdun): using async copy instead of TensorCopySync
         // TensorCopySync would block other stream, because TensorCopySync
@@ -214,7 +239,10 @@ void BufferedReader::ReadAsync(size_t i) {
           auto gpu_ptr = gpu_ptrs[i];
           auto size = cpu[i].numel() * phi::SizeOf(cpu[i].dtype());
           if (platform::is_cuda_pinned_place(cpu_place) ||
-              platform::is_gpu_place(cpu_place)) {
+              platform::is_gpu_place(cpu_place) ||
+              FLAGS_use_pinned_staging_pool) {
+            // a CPU source is staged through the pinned staging pool by
+            // memory::Copy, without waiting for the copy
             memory::Copy(
                 place_, gpu_ptr, cpu_place, cpu_ptr, size, stream_.get());
           } else {
@@ -353,6 +381,90 @@ void BufferedReader::ReadAsync(size_t i) {
   }));
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+void BufferedReader::PackedCopyToGPU(size_t i,
+                                     const TensorVec &cpu,
+                                     TensorVec *cuda) {
+  // the alignment of cudaMalloc, for the views into the device block
+  constexpr size_t kAlignment = 256;
+  std::vector<size_t> offsets(cpu.size());
+  std::vector<size_t> sizes(cpu.size());
+  size_t total_size = 0;
+  for (size_t k = 0; k < cpu.size(); ++k) {
+    offsets[k] = total_size;
+    sizes[k] = cpu[k].numel() * phi::SizeOf(cpu[k].dtype());
+    total_size += (sizes[k] + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  platform::SetDeviceId(place_.device);
+  auto device_block =
+      memory::AllocShared(place_, std::max<size_t>(total_size, 1));
+  for (size_t k = 0; k < cpu.size(); ++k) {
+    auto &tensor = (*cuda)[k];
+    tensor.Resize(cpu[k].dims());
+    tensor.set_layout(cpu[k].layout());
+    tensor.set_offset(offsets[k]);
+    tensor.ResetHolderWithType(device_block, cpu[k].dtype());
+    tensor.set_lod(cpu[k].lod());
+  }
+
+  // NOTE(zjl): the copy stream must wait for the compute stream after the
+  // device block is allocated, see ReadAsync
+  auto copy_stream = copy_streams_[i % copy_streams_.size()]->get();
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(events_[i].get(), compute_stream_));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipStreamWaitEvent(copy_stream, events_[i].get(), 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(events_[i].get(), compute_stream_));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaStreamWaitEvent(copy_stream, events_[i].get(), 0));
+#endif
+
+  platform::RecordEvent record_event("BufferedReader:PackedMemoryCopy",
+                                     platform::TracerEventType::UserDefined,
+                                     1);
+  auto staging_allocator =
+      memory::allocation::PinnedStagingAllocator::Instance(
+          platform::CUDAPlace(place_.device));
+  auto staging = staging_allocator->Allocate(total_size);
+  auto *staging_ptr = static_cast<uint8_t *>(staging->ptr());
+  auto *device_ptr = static_cast<uint8_t *>(device_block->ptr());
+  for (size_t k = 0; k < cpu.size(); ++k) {
+    if (!platform::is_gpu_place(cpu[k].place())) {
+      std::memcpy(staging_ptr + offsets[k], cpu[k].data(), sizes[k]);
+    }
+  }
+  memory::Copy(place_,
+               device_ptr,
+               platform::CUDAPinnedPlace(),
+               staging_ptr,
+               total_size,
+               copy_stream);
+  // after the packed copy, which overwrites their ranges of the device block
+  for (size_t k = 0; k < cpu.size(); ++k) {
+    if (platform::is_gpu_place(cpu[k].place())) {
+      memory::Copy(place_,
+                   device_ptr + offsets[k],
+                   cpu[k].place(),
+                   cpu[k].data(),
+                   sizes[k],
+                   copy_stream);
+    }
+  }
+  // the staging block comes back to the pool once the copy completes
+  staging_allocator->RecordStream(staging.get(), copy_stream);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventRecord(copy_events_[i].get(), copy_stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventRecord(copy_events_[i].get(), copy_stream));
+#endif
+}
+#endif
+
 void BufferedReader::ShutdownImpl() {
   VLOG(1) << "ShutdownImpl";
   reader_->Shutdown();
@@ -380,6 +492,19 @@ void BufferedReader::ReadNextImpl(paddle::framework::LoDTensorArray *out) {
     return;
   }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (packed_copy_ && platform::is_gpu_place(place_)) {
+    platform::SetDeviceId(place_.device);
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipStreamWaitEvent(compute_stream_, copy_events_[i].get(), 0));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaStreamWaitEvent(compute_stream_, copy_events_[i].get(), 0));
+#endif
+  }
+#endif
+
   if (platform::is_gpu_place(place_)) {  // NOLINT
     *out = std::move(cuda_buffer_[i]);
   } else if (platform::is_xpu_place(place_)) {
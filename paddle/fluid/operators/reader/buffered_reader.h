@@ -57,6 +57,14 @@ class BufferedReader : public framework::DecoratedReader {
 
   void ReadAsync(size_t i);
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // Copies the tensors of the batch with one memcpy: they are packed in one
+  // pinned staging block and the tensors of cuda are views into one device
+  // block. The copy is not waited for, the compute stream waits for it in
+  // ReadNextImpl.
+  void PackedCopyToGPU(size_t i, const TensorVec& cpu, TensorVec* cuda);
+#endif
+
  protected:
   void ShutdownImpl() override;
   void StartImpl() override;
@@ -84,6 +92,11 @@ class BufferedReader : public framework::DecoratedReader {
   gpuStream_t compute_stream_;
   std::shared_ptr<platform::CudaStreamObject> stream_;
   std::vector<std::shared_ptr<platform::CudaEventObject>> events_;
+  // FLAGS_reader_packed_copy, the batches are copied by PackedCopyToGPU on
+  // the copy streams in turn
+  bool packed_copy_{false};
+  std::vector<std::shared_ptr<platform::CudaStreamObject>> copy_streams_;
+  std::vector<std::shared_ptr<platform::CudaEventObject>> copy_events_;
 #endif
 
 #ifdef PADDLE_WITH_XPU
@@ -0,0 +1,122 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/operators/reader/gpu_image_reader.h"
+#include "paddle/fluid/operators/reader/reader_op_registry.h"
+
+namespace paddle {
+namespace operators {
+namespace reader {
+class CreateGPUImageReaderOp : public framework::OperatorBase {
+ public:
+  using framework::OperatorBase::OperatorBase;
+
+ private:
+  void RunImpl(const framework::Scope& scope,
+               const platform::Place& dev_place) const override {
+    auto* out = scope.FindVar(Output("Out"))
+                    ->template GetMutable<framework::ReaderHolder>();
+    const auto& underlying_reader = scope.FindVar(Input("UnderlyingReader"))
+                                        ->Get<framework::ReaderHolder>();
+
+    if (out->Get() != nullptr) {
+      auto* decorated_reader =
+          dynamic_cast<framework::DecoratedReader*>(out->Get().get());
+      PADDLE_ENFORCE_NOT_NULL(
+          decorated_reader,
+          platform::errors::NotFound("The inited reader should be a "
+                                     "DecoratedReader when running "
+                                     "create_gpu_image_reader op."));
+      if (decorated_reader->UnderlyingReader() == underlying_reader.Get()) {
+        return;
+      }
+    }
+
+    PADDLE_ENFORCE_EQ(platform::is_gpu_place(dev_place),
+                      true,
+                      platform::errors::InvalidArgument(
+                          "The create_gpu_image_reader op should run on a "
+                          "GPU, but got %s.",
+                          dev_place));
+    GPUImageTransform transform;
+    transform.height = Attr<int>("height");
+    transform.width = Attr<int>("width");
+    transform.data_layout = Attr<std::string>("data_layout");
+    transform.mean = Attr<std::vector<float>>("mean");
+    transform.std = Attr<std::vector<float>>("std");
+    transform.random_crop = Attr<bool>("random_crop");
+    transform.min_area = Attr<float>("min_area");
+    transform.flip_prob = Attr<float>("flip_prob");
+    transform.seed = Attr<int>("seed");
+
+    VLOG(10) << "Create new gpu image reader on " << dev_place;
+
+    out->Clear();
+    out->Reset(framework::MakeDecoratedReader<GPUImageReader>(
+        underlying_reader,
+        platform::CUDAPlace(dev_place.GetDeviceId()),
+        transform));
+  }
+};
+
+class CreateGPUImageReaderOpMaker : public DecoratedReaderMakerBase {
+ protected:
+  void Apply() override {
+    AddComment(R"DOC(
+      CreateGPUImageReader Operator
+
+      A gpu image reader takes another reader as its 'underlying reader',
+      whose first variable is the JPEG file bytes of a batch of images, an
+      uint8 LoDTensor with one sequence per image, e.g. fed by a py_reader.
+      It decodes the images with the batched nvjpeg decoder, then crops,
+      resizes, flips and normalizes them with one fused kernel, and outputs
+      a float32 batch in NCHW or NHWC. Decorate it with a double buffer
+      reader to overlap the decoding with the training.
+    )DOC");
+    AddAttr<int>("height", "The height of the output images.").SetDefault(224);
+    AddAttr<int>("width", "The width of the output images.").SetDefault(224);
+    AddAttr<std::string>("data_layout", "The layout of the output batch.")
+        .SetDefault("NCHW")
+        .InEnum({"NCHW", "NHWC"});
+    AddAttr<std::vector<float>>("mean",
+                                "The mean of the RGB channels, of the pixels "
+                                "in [0, 255].")
+        .SetDefault({0.f, 0.f, 0.f});
+    AddAttr<std::vector<float>>("std",
+                                "The std of the RGB channels, of the pixels "
+                                "in [0, 255].")
+        .SetDefault({1.f, 1.f, 1.f});
+    AddAttr<bool>("random_crop",
+                  "Whether to crop a random area of each image, otherwise "
+                  "the whole image is resized.")
+        .SetDefault(false);
+    AddAttr<float>("min_area",
+                   "The lower bound of the area of the random crops, as a "
+                   "fraction of the image.")
+        .SetDefault(0.08f);
+    AddAttr<float>("flip_prob", "The probability of the horizontal flip.")
+        .SetDefault(0.f);
+    AddAttr<int>("seed", "The seed of the random crops and flips.")
+        .SetDefault(0);
+  }
+};
+
+}  // namespace reader
+}  // namespace operators
+}  // namespace paddle
+
+namespace ops = paddle::operators::reader;
+REGISTER_DECORATED_READER_OPERATOR(create_gpu_image_reader,
+                                   ops::CreateGPUImageReaderOp,
+                                   ops::CreateGPUImageReaderOpMaker);
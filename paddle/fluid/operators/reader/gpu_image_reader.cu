@@ -0,0 +1,341 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/operators/reader/gpu_image_reader.h"
+
+#include <cmath>
+
+#include "paddle/fluid/memory/malloc.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/device_context.h"
+#include "paddle/fluid/platform/profiler/event_tracing.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+
+namespace paddle {
+namespace operators {
+namespace reader {
+
+namespace {
+
+// The crop of a decoded image, which is interleaved RGB at offset of the
+// decode buffer.
+struct ImageCrop {
+  int64_t offset;
+  int width;
+  int height;
+  float x;
+  float y;
+  float crop_width;
+  float crop_height;
+  bool flip;
+};
+
+struct Normalization {
+  float mean[3];
+  float inv_std[3];
+};
+
+void CheckNvjpeg(nvjpegStatus_t status, const char* api) {
+  PADDLE_ENFORCE_EQ(
+      status,
+      NVJPEG_STATUS_SUCCESS,
+      platform::errors::External("%s failed with status %d.", api, status));
+}
+
+ImageCrop SampleCrop(int width,
+                     int height,
+                     const GPUImageTransform& transform,
+                     std::mt19937* engine) {
+  ImageCrop crop;
+  crop.width = width;
+  crop.height = height;
+  crop.x = 0.f;
+  crop.y = 0.f;
+  crop.crop_width = width;
+  crop.crop_height = height;
+  if (transform.random_crop) {
+    std::uniform_real_distribution<float> area_dist(transform.min_area, 1.f);
+    std::uniform_real_distribution<float> log_ratio_dist(std::log(3.f / 4.f),
+                                                         std::log(4.f / 3.f));
+    // falls back to the whole image if no crop fits in the attempts
+    for (int attempt = 0; attempt < 10; ++attempt) {
+      float area = area_dist(*engine) * width * height;
+      float ratio = std::exp(log_ratio_dist(*engine));
+      float crop_width = std::sqrt(area * ratio);
+      float crop_height = std::sqrt(area / ratio);
+      if (crop_width <= width && crop_height <= height) {
+        crop.x = std::uniform_real_distribution<float>(
+            0.f, width - crop_width)(*engine);
+        crop.y = std::uniform_real_distribution<float>(
+            0.f, height - crop_height)(*engine);
+        crop.crop_width = crop_width;
+        crop.crop_height = crop_height;
+        break;
+      }
+    }
+  }
+  crop.flip = std::bernoulli_distribution(transform.flip_prob)(*engine);
+  return crop;
+}
+
+// One thread per output pixel, samples the crop bilinearly and writes the
+// normalized channels.
+template <bool kChannelLast>
+__global__ void CropResizeNormalizeKernel(const uint8_t* decoded,
+                                          const ImageCrop* crops,
+                                          int64_t num_pixels,
+                                          int out_height,
+                                          int out_width,
+                                          Normalization normalization,
+                                          float* out) {
+  CUDA_KERNEL_LOOP_TYPE(idx, num_pixels, int64_t) {
+    int x = idx % out_width;
+    int y = (idx / out_width) % out_height;
+    int64_t n = idx / (out_width * out_height);
+    const ImageCrop crop = crops[n];
+    int crop_x = crop.flip ? out_width - 1 - x : x;
+    float src_x = crop.x + (crop_x + 0.5f) * crop.crop_width / out_width - 0.5f;
+    float src_y = crop.y + (y + 0.5f) * crop.crop_height / out_height - 0.5f;
+    src_x = fminf(fmaxf(src_x, 0.f), crop.width - 1.f);
+    src_y = fminf(fmaxf(src_y, 0.f), crop.height - 1.f);
+    int x0 = static_cast<int>(src_x);
+    int y0 = static_cast<int>(src_y);
+    int x1 = min(x0 + 1, crop.width - 1);
+    int y1 = min(y0 + 1, crop.height - 1);
+    float dx = src_x - x0;
+    float dy = src_y - y0;
+
+    const uint8_t* image = decoded + crop.offset;
+    const uint8_t* p00 = image + (y0 * crop.width + x0) * 3;
+    const uint8_t* p01 = image + (y0 * crop.width + x1) * 3;
+    const uint8_t* p10 = image + (y1 * crop.width + x0) * 3;
+    const uint8_t* p11 = image + (y1 * crop.width + x1) * 3;
+    int64_t plane = static_cast<int64_t>(out_height) * out_width;
+#pragma unroll
+    for (int c = 0; c < 3; ++c) {
+      float top = p00[c] + (p01[c] - p00[c]) * dx;
+      float bottom = p10[c] + (p11[c] - p10[c]) * dx;
+      float value = top + (bottom - top) * dy;
+      value = (value - normalization.mean[c]) * normalization.inv_std[c];
+      if (kChannelLast) {
+        out[idx * 3 + c] = value;
+      } else {
+        out[(n * 3 + c) * plane + y * out_width + x] = value;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+GPUImageReader::GPUImageReader(
+    const std::shared_ptr<framework::ReaderBase>& reader,
+    const platform::CUDAPlace& place,
+    const GPUImageTransform& transform)
+    : framework::DecoratedReader(reader),
+      place_(place),
+      transform_(transform),
+      engine_(transform.seed) {
+  PADDLE_ENFORCE_EQ(
+      transform_.height > 0 && transform_.width > 0,
+      true,
+      platform::errors::InvalidArgument(
+          "The output size of the images should be positive, but got %d x %d.",
+          transform_.height,
+          transform_.width));
+  PADDLE_ENFORCE_EQ(transform_.mean.size() == 3 && transform_.std.size() == 3,
+                    true,
+                    platform::errors::InvalidArgument(
+                        "The mean and std should have 3 values, one per RGB "
+                        "channel."));
+  PADDLE_ENFORCE_EQ(
+      transform_.data_layout == "NCHW" || transform_.data_layout == "NHWC",
+      true,
+      platform::errors::InvalidArgument(
+          "The data layout should be NCHW or NHWC, but got %s.",
+          transform_.data_layout));
+  PADDLE_ENFORCE_EQ(shapes_.empty(),
+                    false,
+                    platform::errors::InvalidArgument(
+                        "The underlying reader should feed the file bytes of "
+                        "the images as its first variable."));
+
+  // the first variable becomes the batch of the images
+  shapes_[0] = ImagesDims(-1);
+  var_types_[0] = framework::proto::VarType::FP32;
+  need_check_feed_[0] = false;
+
+  CheckNvjpeg(phi::dynload::nvjpegCreateSimple(&handle_), "nvjpegCreateSimple");
+  CheckNvjpeg(phi::dynload::nvjpegJpegStateCreate(handle_, &state_),
+              "nvjpegJpegStateCreate");
+}
+
+GPUImageReader::~GPUImageReader() {
+  if (state_ != nullptr) {
+    phi::dynload::nvjpegJpegStateDestroy(state_);
+  }
+  if (handle_ != nullptr) {
+    phi::dynload::nvjpegDestroy(handle_);
+  }
+}
+
+framework::DDim GPUImageReader::ImagesDims(int64_t batch_size) const {
+  if (transform_.data_layout == "NCHW") {
+    return common::make_ddim(
+        {batch_size, 3, transform_.height, transform_.width});
+  }
+  return common::make_ddim(
+      {batch_size, transform_.height, transform_.width, 3});
+}
+
+void GPUImageReader::ReadNextImpl(paddle::framework::LoDTensorArray* out) {
+  reader_->ReadNext(out);
+  if (out->empty()) {
+    return;
+  }
+  platform::RecordEvent record_event("GPUImageReader:DecodeAndTransform",
+                                     platform::TracerEventType::UserDefined,
+                                     1);
+  phi::DenseTensor images;
+  DecodeAndTransform((*out)[0], &images);
+  (*out)[0] = std::move(images);
+}
+
+void GPUImageReader::DecodeAndTransform(const phi::DenseTensor& bytes,
+                                        phi::DenseTensor* images) {
+  PADDLE_ENFORCE_EQ(platform::is_cpu_place(bytes.place()),
+                    true,
+                    platform::errors::InvalidArgument(
+                        "The file bytes of the images should be on the CPU, "
+                        "but got %s.",
+                        bytes.place()));
+  PADDLE_ENFORCE_EQ(bytes.dtype(),
+                    phi::DataType::UINT8,
+                    platform::errors::InvalidArgument(
+                        "The file bytes of the images should be uint8."));
+  PADDLE_ENFORCE_EQ(bytes.lod().size(),
+                    1UL,
+                    platform::errors::InvalidArgument(
+                        "The file bytes of the images should have one LoD "
+                        "level, a sequence per image."));
+  const auto& offsets = bytes.lod()[0];
+  int batch_size = static_cast<int>(offsets.size()) - 1;
+  const uint8_t* data = bytes.data<uint8_t>();
+
+  // the sizes of the images, for the crops and the decode buffer
+  std::vector<const unsigned char*> bitstreams(batch_size);
+  std::vector<size_t> lengths(batch_size);
+  std::vector<ImageCrop> crops(batch_size);
+  int64_t decoded_size = 0;
+  for (int i = 0; i < batch_size; ++i) {
+    bitstreams[i] = data + offsets[i];
+    lengths[i] = offsets[i + 1] - offsets[i];
+    int components;
+    nvjpegChromaSubsampling_t subsampling;
+    int widths[NVJPEG_MAX_COMPONENT];
+    int heights[NVJPEG_MAX_COMPONENT];
+    CheckNvjpeg(phi::dynload::nvjpegGetImageInfo(handle_,
+                                                 bitstreams[i],
+                                                 lengths[i],
+                                                 &components,
+                                                 &subsampling,
+                                                 widths,
+                                                 heights),
+                "nvjpegGetImageInfo");
+    crops[i] = SampleCrop(widths[0], heights[0], transform_, &engine_);
+    crops[i].offset = decoded_size;
+    decoded_size += static_cast<int64_t>(3) * widths[0] * heights[0];
+  }
+
+  images->Resize(ImagesDims(batch_size));
+  auto* dev_ctx = static_cast<phi::GPUContext*>(
+      platform::DeviceContextPool::Instance().Get(place_));
+  float* out = dev_ctx->Alloc<float>(images);
+  if (batch_size == 0) {
+    return;
+  }
+  auto stream = dev_ctx->stream();
+  phi::Stream alloc_stream(reinterpret_cast<phi::StreamId>(stream));
+
+  // decodes all the images to interleaved RGB in one buffer
+  auto decoded = memory::Alloc(place_, decoded_size, alloc_stream);
+  auto* decoded_data = static_cast<uint8_t*>(decoded->ptr());
+  std::vector<nvjpegImage_t> destinations(batch_size);
+  for (int i = 0; i < batch_size; ++i) {
+    for (int c = 0; c < NVJPEG_MAX_COMPONENT; ++c) {
+      destinations[i].channel[c] = nullptr;
+      destinations[i].pitch[c] = 0;
+    }
+    destinations[i].channel[0] = decoded_data + crops[i].offset;
+    destinations[i].pitch[0] = 3 * crops[i].width;
+  }
+  if (batch_size != decode_batch_size_) {
+    CheckNvjpeg(phi::dynload::nvjpegDecodeBatchedInitialize(
+                    handle_, state_, batch_size, 1, NVJPEG_OUTPUT_RGBI),
+                "nvjpegDecodeBatchedInitialize");
+    decode_batch_size_ = batch_size;
+  }
+  CheckNvjpeg(phi::dynload::nvjpegDecodeBatched(handle_,
+                                                state_,
+                                                bitstreams.data(),
+                                                lengths.data(),
+                                                destinations.data(),
+                                                stream),
+              "nvjpegDecodeBatched");
+
+  auto crops_buffer =
+      memory::Alloc(place_, crops.size() * sizeof(ImageCrop), alloc_stream);
+  memory::Copy(place_,
+               crops_buffer->ptr(),
+               platform::CPUPlace(),
+               crops.data(),
+               crops.size() * sizeof(ImageCrop),
+               stream);
+  Normalization normalization;
+  for (int c = 0; c < 3; ++c) {
+    normalization.mean[c] = transform_.mean[c];
+    normalization.inv_std[c] = 1.f / transform_.std[c];
+  }
+
+  int64_t num_pixels =
+      static_cast<int64_t>(batch_size) * transform_.height * transform_.width;
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(*dev_ctx, num_pixels);
+  if (transform_.data_layout == "NHWC") {
+    CropResizeNormalizeKernel<true>
+        <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+            decoded_data,
+            static_cast<const ImageCrop*>(crops_buffer->ptr()),
+            num_pixels,
+            transform_.height,
+            transform_.width,
+            normalization,
+            out);
+  } else {
+    CropResizeNormalizeKernel<false>
+        <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+            decoded_data,
+            static_cast<const ImageCrop*>(crops_buffer->ptr()),
+            num_pixels,
+            transform_.height,
+            transform_.width,
+            normalization,
+            out);
+  }
+  // NOTE: the decode and crops buffers are allocated on the stream of the
+  // kernel, so they are not reused before it completes.
+}
+
+}  // namespace reader
+}  // namespace operators
+}  // namespace paddle
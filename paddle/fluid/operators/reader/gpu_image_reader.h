@@ -0,0 +1,86 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/framework/reader.h"
+#include "paddle/phi/backends/dynload/nvjpeg.h"
+
+namespace paddle {
+namespace operators {
+namespace reader {
+
+// The transform of the decoded images to the output batch, applied by one
+// fused crop, resize, flip and normalize kernel.
+struct GPUImageTransform {
+  // size of the output images
+  int height{224};
+  int width{224};
+  // "NCHW" or "NHWC"
+  std::string data_layout{"NCHW"};
+  // per RGB channel, the output is (pixel - mean) / std on pixels in [0, 255]
+  std::vector<float> mean{0.f, 0.f, 0.f};
+  std::vector<float> std{1.f, 1.f, 1.f};
+  // Random resized crop of an area in [min_area, 1] of the image and an
+  // aspect ratio in [3/4, 4/3], otherwise the whole image is resized.
+  bool random_crop{false};
+  float min_area{0.08f};
+  // probability of the horizontal flip
+  float flip_prob{0.f};
+  int seed{0};
+};
+
+// Decodes the JPEG images of a batch on the GPU with the batched nvjpeg
+// decoder, and transforms them to one float32 batch.
+//
+// The first variable of the underlying reader holds the file bytes of the
+// images: an uint8 LoDTensor on the CPU with one LoD level, the k-th sequence
+// of which is the k-th image. It is replaced by the batch of the images, of
+// shape [N, 3, height, width] or [N, height, width, 3], on the GPU. The other
+// variables, e.g. the labels, are passed through.
+class GPUImageReader : public framework::DecoratedReader {
+ public:
+  GPUImageReader(const std::shared_ptr<framework::ReaderBase>& reader,
+                 const platform::CUDAPlace& place,
+                 const GPUImageTransform& transform);
+
+  ~GPUImageReader() override;
+
+ protected:
+  void ReadNextImpl(paddle::framework::LoDTensorArray* out) override;
+
+ private:
+  framework::DDim ImagesDims(int64_t batch_size) const;
+
+  void DecodeAndTransform(const phi::DenseTensor& bytes,
+                          phi::DenseTensor* images);
+
+  platform::CUDAPlace place_;
+  GPUImageTransform transform_;
+  std::mt19937 engine_;
+
+  nvjpegHandle_t handle_{nullptr};
+  nvjpegJpegState_t state_{nullptr};
+  // the batch size nvjpegDecodeBatchedInitialize was called with
+  int decode_batch_size_{0};
+};
+
+}  // namespace reader
+}  // namespace operators
+}  // namespace paddle
@@ -19,10 +19,13 @@
 #include <vector>
 
 #include "paddle/common/ddim.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/operators/reader/blocking_queue.h"
 #include "paddle/fluid/platform/place.h"
 
+COMMON_DECLARE_int32(reader_queue_spin_iterations);
+
 namespace paddle {
 namespace operators {
 namespace reader {
@@ -30,7 +33,10 @@ namespace reader {
 class LoDTensorBlockingQueue {
  public:
   explicit LoDTensorBlockingQueue(size_t capacity, bool speed_test_mode = false)
-      : queue_(capacity, speed_test_mode) {}
+      : queue_(capacity,
+               speed_test_mode,
+               FLAGS_reader_queue_spin_iterations,
+               "lod_tensor_blocking_queue") {}
 
   ~LoDTensorBlockingQueue() { VLOG(10) << "Destruct LoDTensorBlockingQueue"; }
 
@@ -49,6 +55,20 @@ class LoDTensorBlockingQueue {
     return lod_tensor_vec;
   }
 
+  // Returns the number of the pushed batches, less than the size of
+  // lod_tensor_vecs only if the queue is closed.
+  size_t PushBatch(
+      std::vector<paddle::framework::LoDTensorArray>* lod_tensor_vecs) {
+    return queue_.SendBatch(lod_tensor_vecs);
+  }
+
+  // Pops at most max_num batches, at least one unless the queue is closed.
+  std::vector<paddle::framework::LoDTensorArray> PopBatch(size_t max_num) {
+    std::vector<paddle::framework::LoDTensorArray> lod_tensor_vecs;
+    queue_.ReceiveBatch(max_num, &lod_tensor_vecs);
+    return lod_tensor_vecs;
+  }
+
   inline size_t Cap() const { return queue_.Cap(); }
 
   inline size_t Size() const { return queue_.Size(); }
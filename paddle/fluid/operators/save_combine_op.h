@@ -22,9 +22,12 @@ limitations under the License. */
 #include <string>
 #include <unordered_map>
 
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/async_checkpoint.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/io/tensor_checkpoint.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/raw_tensor.h"
@@ -33,6 +36,9 @@ limitations under the License. */
 #include "paddle/phi/common/port.h"
 #include "paddle/phi/core/dense_tensor.h"
 
+COMMON_DECLARE_bool(save_combine_with_tensor_checkpoint);
+COMMON_DECLARE_bool(save_combine_async);
+
 namespace paddle {
 namespace operators {
 
@@ -89,6 +95,12 @@ void SaveCombineTensorKernel(const Context& dev_ctx,
                         "it to be greater than 0.",
                         x.size()));
 
+  bool use_checkpoint =
+      (FLAGS_save_combine_with_tensor_checkpoint || FLAGS_save_combine_async) &&
+      !save_to_memory;
+  // the fp16 copies, kept until the checkpoint is written
+  std::vector<phi::DenseTensor> converted(use_checkpoint ? x.size() : 0);
+  std::vector<const phi::DenseTensor*> to_save(x.begin(), x.end());
   for (size_t i = 0; i < x.size(); i++) {
     auto& tensor = *(x[i]);
     PADDLE_ENFORCE_EQ(
@@ -110,12 +122,29 @@ void SaveCombineTensorKernel(const Context& dev_ctx,
       framework::TransDataType(in_kernel_type, out_kernel_type, tensor, &out);
       // copy LoD info to the new tensor
       out.set_lod(tensor.lod());
-      framework::SerializeToStream(ss, out, dev_ctx);
-    } else {
+      if (use_checkpoint) {
+        converted[i] = out;
+        to_save[i] = &converted[i];
+      } else {
+        framework::SerializeToStream(ss, out, dev_ctx);
+      }
+    } else if (!use_checkpoint) {
       framework::SerializeToStream(ss, tensor, dev_ctx);
     }
   }
 
+  if (use_checkpoint && FLAGS_save_combine_async) {
+    // the snapshot is ordered after the kernels queued so far
+    framework::AsyncCheckpointSaver::Instance().Save(
+        file_path, std::vector<std::string>(x.size()), to_save);
+    return;
+  }
+  if (use_checkpoint) {
+    dev_ctx.Wait();
+    framework::SaveTensorCheckpoint(
+        file_path, std::vector<std::string>(x.size()), to_save);
+    return;
+  }
   SaveToMemory(file_path, ss, save_to_memory, y);
 }
 
@@ -15,8 +15,13 @@
 #pragma once
 
 #ifdef PADDLE_WITH_CUDA
+#include <chrono>
 #include <cstdint>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -36,6 +41,7 @@
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/place.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/place.h"
@@ -175,6 +181,28 @@ class TensorRTEngineOp : public framework::OperatorBase {
   std::string model_opt_cache_dir_;
   bool use_static_engine_;
   phi::DataType precision_mode_;
+  bool background_build_{false};
+  // the build of trt_engine_ in the background, shared with the ops of the
+  // cloned predictors
+  mutable std::shared_future<void> background_build_future_;
+  mutable bool background_build_done_{false};
+  mutable bool background_build_failed_{false};
+  mutable std::unique_ptr<framework::ExecutorPrepareContext> native_ctx_;
+  // the engines of the hot input shapes, see
+  // AnalysisConfig::EnableTensorRtOnlineShapeTuning
+  using InputShapes = std::map<std::string, std::vector<int32_t>>;
+  struct OnlineShapeEngine {
+    std::string key;
+    TensorRTEngine *engine{nullptr};
+    std::shared_future<void> build;
+    bool ready{false};
+    int64_t runs{0};
+  };
+  int online_shape_engines_{0};
+  mutable int64_t online_runs_{0};
+  mutable std::map<InputShapes, int64_t> online_shape_runs_;
+  mutable std::map<InputShapes, OnlineShapeEngine> online_engines_;
+  mutable std::set<InputShapes> online_failed_shapes_;
 
  public:
   TensorRTEngineOp(const std::string &type,
@@ -200,6 +228,12 @@ class TensorRTEngineOp : public framework::OperatorBase {
     if (use_static_engine_) {
       model_opt_cache_dir_ = Attr<std::string>("model_opt_cache_dir");
     }
+    if (HasAttr("background_build")) {
+      background_build_ = Attr<bool>("background_build");
+    }
+    if (HasAttr("online_shape_engines")) {
+      online_shape_engines_ = Attr<int>("online_shape_engines");
+    }
 
     auto params = Attr<std::vector<std::string>>("parameters");
     for (const auto &param : params) {
@@ -236,6 +270,16 @@ class TensorRTEngineOp : public framework::OperatorBase {
     }
   }
 
+  ~TensorRTEngineOp() override {
+    // the build in the background runs on this op
+    if (background_build_future_.valid()) {
+      background_build_future_.wait();
+    }
+    for (auto &it : online_engines_) {
+      it.second.build.wait();
+    }
+  }
+
   void PrepareTRTEngine(const framework::Scope &scope,
                         TensorRTEngine *engine) const {
     LOG(INFO) << "Prepare TRT engine (Optimize model structure, Select OP "
@@ -259,9 +303,224 @@ class TensorRTEngineOp : public framework::OperatorBase {
     framework::Executor executor(dev_place);
     auto *block = Attr<framework::BlockDesc *>("sub_block");
     auto *program = block->Program();
+    if (native_ctx_ == nullptr) {
+      native_ctx_ = executor.Prepare(*program, block->ID());
+    }
     auto &current_scope = scope.NewScope();
-    auto ctx = executor.Prepare(*program, block->ID());
-    executor.RunPreparedContext(ctx.get(), &current_scope, false, true, true);
+    executor.RunPreparedContext(
+        native_ctx_.get(), &current_scope, false, true, true);
+    scope.DeleteScope(&current_scope);
+  }
+
+  // Whether the engine built in the background is ready, the first call
+  // starts the build.
+  bool BackgroundBuildReady(const framework::Scope &scope,
+                            const platform::Place &dev_place) const {
+    if (background_build_done_ || background_build_failed_) {
+      return background_build_done_;
+    }
+    if (!background_build_future_.valid()) {
+      if (trt_engine_ == nullptr || trt_engine_->engine() != nullptr) {
+        // not created by the pass, or loaded from the cache
+        background_build_done_ = true;
+        return true;
+      }
+      static std::mutex mutex;
+      static std::map<TensorRTEngine *, std::shared_future<void>> builds;
+      std::lock_guard<std::mutex> lock(mutex);
+      auto &build = builds[trt_engine_];
+      // or of a destroyed engine at the same address
+      if (!build.valid() ||
+          (build.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready &&
+           trt_engine_->engine() == nullptr)) {
+        const framework::Scope *anc = &scope;
+        while (anc->parent()) {
+          anc = anc->parent();
+        }
+        auto *trt_engine = trt_engine_;
+        int device_id = dev_place.device;
+        LOG(INFO) << "Build TRT engine " << engine_key_
+                  << " in the background, its subgraph runs natively until "
+                     "the engine is built.";
+        build = std::async(std::launch::async, [=] {
+                  std::lock_guard<std::mutex> build_lock(BuildMutex());
+                  platform::SetDeviceId(device_id);
+                  PrepareTRTEngine(*anc, trt_engine);
+                  if (use_static_engine_) {
+                    SaveEngine(trt_engine);
+                  }
+                }).share();
+      }
+      background_build_future_ = build;
+    }
+    if (background_build_future_.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return false;
+    }
+    try {
+      background_build_future_.get();
+      LOG(INFO) << "TRT engine " << engine_key_
+                << " is built in the background, switch to it.";
+      background_build_done_ = true;
+    } catch (const std::exception &e) {
+      LOG(WARNING) << "Fail to build TRT engine " << engine_key_
+                   << " in the background, its subgraph keeps running "
+                      "natively: "
+                   << e.what();
+      background_build_failed_ = true;
+    }
+    return background_build_done_;
+  }
+
+  // The builds run one at a time, as the converters are shared.
+  static std::mutex &BuildMutex() {
+    static std::mutex build_mutex;
+    return build_mutex;
+  }
+
+  // Counts the input shapes of the run, and returns the engine built for
+  // them if any. Every kOnlineShapeWindow runs, the hottest shape of the
+  // window without an engine gets one built in the background, if it takes
+  // kOnlineShapeMinShare of the runs.
+  TensorRTEngine *SelectOnlineShapeEngine(
+      const framework::Scope &scope,
+      const platform::Place &dev_place,
+      TensorRTEngine *trt_engine,
+      const InputShapes &runtime_input_shape) const {
+    constexpr int64_t kOnlineShapeWindow = 1000;
+    constexpr double kOnlineShapeMinShare = 0.1;
+
+    ++online_shape_runs_[runtime_input_shape];
+    TensorRTEngine *selected = nullptr;
+    auto it = online_engines_.find(runtime_input_shape);
+    if (it != online_engines_.end()) {
+      auto &online = it->second;
+      ++online.runs;
+      if (!online.ready && online.build.wait_for(std::chrono::seconds(0)) ==
+                               std::future_status::ready) {
+        try {
+          online.build.get();
+          online.ready = true;
+          LOG(INFO) << "TRT engine " << online.key
+                    << " of a hot shape is built, switch to it.";
+        } catch (const std::exception &e) {
+          LOG(WARNING) << "Fail to build TRT engine " << online.key
+                       << " of a hot shape: " << e.what();
+          inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
+              .DeleteKey(online.key);
+          online_failed_shapes_.insert(runtime_input_shape);
+          online_engines_.erase(it);
+          it = online_engines_.end();
+        }
+      }
+      if (it != online_engines_.end() && online.ready) {
+        selected = online.engine;
+      }
+    }
+
+    if (++online_runs_ % kOnlineShapeWindow != 0) {
+      return selected;
+    }
+    const InputShapes *hottest = nullptr;
+    int64_t hottest_runs = 0;
+    for (auto &shape_runs : online_shape_runs_) {
+      if (shape_runs.second > hottest_runs &&
+          !online_engines_.count(shape_runs.first) &&
+          !online_failed_shapes_.count(shape_runs.first)) {
+        hottest = &shape_runs.first;
+        hottest_runs = shape_runs.second;
+      }
+    }
+    if (hottest != nullptr &&
+        hottest_runs >= kOnlineShapeWindow * kOnlineShapeMinShare) {
+      if (static_cast<int>(online_engines_.size()) >= online_shape_engines_) {
+        // replace the engine least run in the window, if it is colder
+        auto coldest = online_engines_.end();
+        for (auto e = online_engines_.begin(); e != online_engines_.end();
+             ++e) {
+          if (e->second.ready && (coldest == online_engines_.end() ||
+                                  e->second.runs < coldest->second.runs)) {
+            coldest = e;
+          }
+        }
+        if (coldest != online_engines_.end() &&
+            coldest->second.runs < hottest_runs) {
+          LOG(INFO) << "Release TRT engine " << coldest->second.key
+                    << " of a shape gone cold.";
+          if (selected == coldest->second.engine) {
+            // still to run this time
+            selected = nullptr;
+          }
+          inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
+              .DeleteKey(coldest->second.key);
+          online_engines_.erase(coldest);
+        }
+      }
+      if (static_cast<int>(online_engines_.size()) < online_shape_engines_) {
+        BuildOnlineShapeEngine(scope, dev_place, trt_engine, *hottest);
+      }
+    }
+    online_shape_runs_.clear();
+    for (auto &e : online_engines_) {
+      e.second.runs = 0;
+    }
+    return selected;
+  }
+
+  void BuildOnlineShapeEngine(const framework::Scope &scope,
+                              const platform::Place &dev_place,
+                              TensorRTEngine *trt_engine,
+                              const InputShapes &input_shape) const {
+    // a profile fixed to the shape, the shape tensors keep their ranges
+    TensorRTEngine::ConstructionParams params = trt_engine->params();
+    std::string signature;
+    for (auto &it : input_shape) {
+      auto shape = it.second;
+      // Make 0-D tensor to 1-D tensor.
+      if (shape.empty()) {
+        shape.push_back(1);
+      }
+      params.min_input_shape[it.first] = shape;
+      params.max_input_shape[it.first] = shape;
+      params.optim_input_shape[it.first] = shape;
+      signature += "#" + it.first + ":" + string::join_strings(shape, ',');
+    }
+
+    OnlineShapeEngine online;
+    online.key = engine_key_ + std::to_string(predictor_id_) + "#online" +
+                 std::to_string(reinterpret_cast<uintptr_t>(this)) + signature;
+    online.engine =
+        inference::Singleton<inference::tensorrt::TRTEngineManager>::Global()
+            .Create(online.key, params);
+    const framework::Scope *anc = &scope;
+    while (anc->parent()) {
+      anc = anc->parent();
+    }
+    auto *engine = online.engine;
+    int device_id = dev_place.device;
+    LOG(INFO) << "Build TRT engine " << online.key
+              << " of a hot shape in the background.";
+    online.build = std::async(std::launch::async, [=] {
+                     std::lock_guard<std::mutex> build_lock(BuildMutex());
+                     platform::SetDeviceId(device_id);
+                     PrepareTRTEngine(*anc, engine);
+                   }).share();
+    online_engines_.emplace(input_shape, std::move(online));
+  }
+
+  void SaveEngine(TensorRTEngine *trt_engine) const {
+    nvinfer1::IHostMemory *serialized_engine_data = trt_engine->Serialize();
+    std::string trt_engine_serialized_data =
+        std::string((const char *)serialized_engine_data->data(),
+                    serialized_engine_data->size());
+    inference::analysis::SaveTrtEngineSerializedDataToFile(
+        inference::analysis::GetTrtEngineSerializedPath(model_opt_cache_dir_,
+                                                        engine_key_),
+        trt_engine_serialized_data);
+    LOG(INFO) << "Save TRT Optimized Info to "
+              << inference::analysis::GetTrtEngineSerializedPath(
+                     model_opt_cache_dir_, engine_key_);
   }
 
   void RunImpl(const framework::Scope &scope,
@@ -270,6 +529,10 @@ class TensorRTEngineOp : public framework::OperatorBase {
       RunCalibration(scope, dev_place);
       return;
     }
+    if (background_build_ && !BackgroundBuildReady(scope, dev_place)) {
+      RunNativeImpl(scope, dev_place);
+      return;
+    }
     auto *trt_engine = GetEngine(scope, dev_place);
     if (trt_engine->with_dynamic_shape()) {
       // get runtime input shapes and shape tensors.
@@ -346,6 +609,14 @@ class TensorRTEngineOp : public framework::OperatorBase {
           runtime_shape_tensor[name] = int32_host;
         }
       }
+      if (online_shape_engines_ > 0 && runtime_shape_tensor.empty()) {
+        auto *online_engine = SelectOnlineShapeEngine(
+            scope, dev_place, trt_engine, runtime_input_shape);
+        if (online_engine != nullptr) {
+          RunTrt(scope, dev_place, online_engine);
+          return;
+        }
+      }
       if (!allow_build_at_runtime_) {
         std::map<std::string, std::vector<int>> min_input_shape =
             trt_engine->min_input_shape();
@@ -411,18 +682,7 @@ class TensorRTEngineOp : public framework::OperatorBase {
           }
 
           if (use_static_engine_) {
-            nvinfer1::IHostMemory *serialized_engine_data =
-                trt_engine->Serialize();
-            std::string trt_engine_serialized_data =
-                std::string((const char *)serialized_engine_data->data(),
-                            serialized_engine_data->size());
-            inference::analysis::SaveTrtEngineSerializedDataToFile(
-                inference::analysis::GetTrtEngineSerializedPath(
-                    model_opt_cache_dir_, engine_key_),
-                trt_engine_serialized_data);
-            LOG(INFO) << "Save TRT Optimized Info to "
-                      << inference::analysis::GetTrtEngineSerializedPath(
-                             model_opt_cache_dir_, engine_key_);
+            SaveEngine(trt_engine);
           }
         }
       }
@@ -0,0 +1,42 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "paddle/pir/include/pass/pass.h"
+
+namespace pir {
+class IrContext;
+}
+
+namespace paddle {
+namespace drr {
+
+// Merge the runs of consecutive passes whose patterns are all DRR patterns
+// into passes which apply the patterns of the run in one greedy traversal,
+// instead of one traversal per pass.
+//
+// The passes of a run have the same opt level and rewrite config, and none
+// of them matches an op that another one matches or creates, so the order of
+// the passes does not change the result. The others are returned as they
+// are, in the same order. The passes of a run are expected to apply on the
+// same ops: the merged pass applies on an op only if all of them do.
+TEST_API std::vector<std::unique_ptr<pir::Pass>> GroupDrrPasses(
+    std::vector<std::unique_ptr<pir::Pass>> passes, pir::IrContext* context);
+
+}  // namespace drr
+}  // namespace paddle
@@ -15,8 +15,10 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "paddle/fluid/pir/drr/include/drr_pattern_context.h"
@@ -50,7 +52,22 @@ class DrrRewritePattern : public pir::RewritePattern {
       pir::Operation* op,
       pir::PatternRewriter& rewriter) const override;  // // NOLINT
 
+  // The names of the ops matched by the source pattern.
+  const std::unordered_set<std::string>& source_op_names() const {
+    return source_op_names_;
+  }
+
+  // The names of the ops created by the result pattern.
+  const std::unordered_set<std::string>& result_op_names() const {
+    return result_op_names_;
+  }
+
  private:
+  // Reject the ops which can not be the anchor of the source pattern by the
+  // number of operands and results and the names of the producers, before
+  // the pattern graph is matched.
+  bool MatchAnchorSignature(pir::Operation* op) const;
+
   bool PatternGraphMatch(pir::Operation* op,
                          MatchContextImpl* source_pattern_match_ctx) const;
 
@@ -101,6 +118,16 @@ class DrrRewritePattern : public pir::RewritePattern {
   const std::vector<Constraint> constraints_;
   const std::shared_ptr<ResultPatternGraph> result_pattern_graph_;
 
+  std::unordered_set<std::string> source_op_names_;
+  std::unordered_set<std::string> result_op_names_;
+
+  // The signature of the anchor: the number of its operands and results,
+  // and the operands produced by an op of the source pattern with the name
+  // of the producer.
+  size_t anchor_num_operands_;
+  size_t anchor_num_results_;
+  std::vector<std::pair<size_t, std::string>> anchor_producer_names_;
+
   // Not used, just for hold it's life cycle.
   const std::shared_ptr<const DrrPatternBase> drr_pattern_owner_;
 };
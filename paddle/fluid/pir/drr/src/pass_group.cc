@@ -0,0 +1,182 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/fluid/pir/drr/include/drr_pass_group.h"
+#include "paddle/fluid/pir/drr/include/drr_rewrite_pattern.h"
+#include "paddle/pir/include/pattern_rewrite/frozen_rewrite_pattern_set.h"
+#include "paddle/pir/include/pattern_rewrite/pattern_match.h"
+#include "paddle/pir/include/pattern_rewrite/pattern_rewrite_driver.h"
+
+namespace paddle {
+namespace drr {
+
+namespace {
+
+struct DrrPassInfo {
+  std::unique_ptr<pir::Pass> pass;
+  // Empty if the pass is not made of DRR patterns.
+  pir::RewritePatternSet patterns;
+  pir::GreedyRewriteConfig config;
+  std::unordered_set<std::string> source_op_names;
+  std::unordered_set<std::string> result_op_names;
+};
+
+bool Intersect(const std::unordered_set<std::string>& lhs,
+               const std::unordered_set<std::string>& rhs) {
+  for (const auto& name : lhs) {
+    if (rhs.count(name)) return true;
+  }
+  return false;
+}
+
+bool SameConfig(const pir::GreedyRewriteConfig& lhs,
+                const pir::GreedyRewriteConfig& rhs) {
+  return lhs.use_top_down_traversal == rhs.use_top_down_traversal &&
+         lhs.max_iterations == rhs.max_iterations &&
+         lhs.max_num_rewrites == rhs.max_num_rewrites &&
+         lhs.region == rhs.region && lhs.strict_mode == rhs.strict_mode &&
+         lhs.incremental == rhs.incremental;
+}
+
+// Whether the patterns of `info` can run in one traversal with those of
+// `group`: the patterns of neither match the ops the other matches or
+// creates.
+bool CanJoin(const DrrPassInfo& info, const std::vector<DrrPassInfo>& group) {
+  if (info.patterns.Empty()) return false;
+  if (group.empty()) return true;
+  const DrrPassInfo& first = group.front();
+  if (info.pass->pass_info().opt_level != first.pass->pass_info().opt_level ||
+      !SameConfig(info.config, first.config)) {
+    return false;
+  }
+  for (const auto& member : group) {
+    if (Intersect(info.source_op_names, member.source_op_names) ||
+        Intersect(info.source_op_names, member.result_op_names) ||
+        Intersect(info.result_op_names, member.source_op_names)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+DrrPassInfo AnalyzePass(std::unique_ptr<pir::Pass> pass,
+                        pir::IrContext* context) {
+  DrrPassInfo info{std::move(pass), pir::RewritePatternSet(context)};
+  auto* rewrite_pass = dynamic_cast<pir::PatternRewritePass*>(info.pass.get());
+  if (rewrite_pass == nullptr) return info;
+  pir::RewritePatternSet patterns = rewrite_pass->BuildPatterns(context);
+  for (const auto& pattern : patterns.native_patterns()) {
+    auto* drr_pattern = dynamic_cast<const DrrRewritePattern*>(pattern.get());
+    if (drr_pattern == nullptr) return info;
+    info.source_op_names.insert(drr_pattern->source_op_names().begin(),
+                                drr_pattern->source_op_names().end());
+    info.result_op_names.insert(drr_pattern->result_op_names().begin(),
+                                drr_pattern->result_op_names().end());
+  }
+  info.patterns = std::move(patterns);
+  info.config = rewrite_pass->BuildConfig();
+  return info;
+}
+
+class DrrPassGroup : public pir::Pass {
+ public:
+  DrrPassGroup(const std::string& name,
+               uint8_t opt_level,
+               std::vector<DrrPassInfo> members)
+      : pir::Pass(name, opt_level),
+        patterns_(members.front().patterns.ir_context()),
+        config_(members.front().config) {
+    for (auto& member : members) {
+      for (auto& pattern : member.patterns.native_patterns()) {
+        patterns_.Add(std::move(pattern));
+      }
+      passes_.push_back(std::move(member.pass));
+    }
+  }
+
+  bool Initialize(pir::IrContext* context) override {
+    // the pass manager initializes the passes on each run
+    if (!patterns_.Empty()) {
+      frozen_patterns_ = pir::FrozenRewritePatternSet(std::move(patterns_));
+      patterns_.Clear();
+    }
+    return true;
+  }
+
+  void Run(pir::Operation* op) override {
+    auto [_, num_rewrites] =
+        pir::ApplyPatternsGreedily(op, frozen_patterns_, config_);
+    AddStatistics(num_rewrites);
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    for (const auto& pass : passes_) {
+      if (!pass->CanApplyOn(op)) return false;
+    }
+    return true;
+  }
+
+ private:
+  // The members are kept for their attributes, which the patterns may use.
+  std::vector<std::unique_ptr<pir::Pass>> passes_;
+  pir::RewritePatternSet patterns_;
+  pir::FrozenRewritePatternSet frozen_patterns_;
+  pir::GreedyRewriteConfig config_;
+};
+
+}  // namespace
+
+std::vector<std::unique_ptr<pir::Pass>> GroupDrrPasses(
+    std::vector<std::unique_ptr<pir::Pass>> passes, pir::IrContext* context) {
+  std::vector<std::unique_ptr<pir::Pass>> result;
+  std::vector<DrrPassInfo> group;
+  auto FlushGroup = [&]() {
+    if (group.size() == 1) {
+      // the pass builds its patterns again when it is initialized
+      result.push_back(std::move(group.front().pass));
+    } else if (group.size() > 1) {
+      std::string name = "drr_pass_group(" + group.front().pass->name();
+      for (size_t i = 1; i < group.size(); ++i) {
+        name += "," + group[i].pass->name();
+      }
+      name += ")";
+      VLOG(4) << "Apply the patterns of " << name << " in one traversal";
+      uint8_t opt_level = group.front().pass->pass_info().opt_level;
+      result.push_back(
+          std::make_unique<DrrPassGroup>(name, opt_level, std::move(group)));
+    }
+    group.clear();
+  };
+  for (auto& pass : passes) {
+    DrrPassInfo info = AnalyzePass(std::move(pass), context);
+    if (!CanJoin(info, group)) {
+      FlushGroup();
+    }
+    if (info.patterns.Empty()) {
+      result.push_back(std::move(info.pass));
+    } else {
+      group.push_back(std::move(info));
+    }
+  }
+  FlushGroup();
+  return result;
+}
+
+}  // namespace drr
+}  // namespace paddle
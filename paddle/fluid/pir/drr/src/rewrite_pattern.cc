@@ -49,6 +49,21 @@ DrrRewritePattern::DrrRewritePattern(
                     phi::errors::InvalidArgument(
                         "Source pattern graph is empty. Suggested fix: please "
                         "check the drr source pattern definition code."));
+  for (const auto& op_call : source_pattern_graph_->owned_op_call()) {
+    source_op_names_.insert(op_call->name());
+  }
+  for (const auto& op_call : result_pattern_graph_->owned_op_call()) {
+    result_op_names_.insert(op_call->name());
+  }
+  const OpCall* anchor = *source_pattern_graph_->OutputNodes().begin();
+  anchor_num_operands_ = anchor->inputs().size();
+  anchor_num_results_ = anchor->outputs().size();
+  for (size_t i = 0; i < anchor->inputs().size(); ++i) {
+    const OpCall* producer = anchor->inputs()[i]->producer();
+    if (producer != nullptr) {
+      anchor_producer_names_.emplace_back(i, producer->name());
+    }
+  }
   if (VLOG_IS_ON(4)) {
     std::cout << "\nThe source pattern graph in [" << pattern_name << "]:\n"
               << *source_pattern_graph_ << std::endl;
@@ -57,9 +72,27 @@ DrrRewritePattern::DrrRewritePattern(
   }
 }
 
+bool DrrRewritePattern::MatchAnchorSignature(pir::Operation* op) const {
+  if (op->num_operands() != anchor_num_operands_ ||
+      op->num_results() != anchor_num_results_) {
+    return false;
+  }
+  for (const auto& [index, producer_name] : anchor_producer_names_) {
+    pir::Value operand = op->operand_source(index);
+    if (!operand || operand.defining_op() == nullptr ||
+        operand.defining_op()->name() != producer_name) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool DrrRewritePattern::MatchAndRewrite(
     pir::Operation* op,
     pir::PatternRewriter& rewriter) const {  // NOLINT
+  if (!MatchAnchorSignature(op)) {
+    return false;
+  }
   std::shared_ptr<MatchContextImpl> src_match_ctx =
       std::make_shared<MatchContextImpl>();
   if (PatternGraphMatch(op, src_match_ctx.get())) {
@@ -29,6 +29,9 @@ namespace pir {
  * @param[in] trainable    (Optional parameter, default to true) If true,
  * operation has opresult_attrs for training like stop_gradient,persistable;
  * Otherwise, it may only has opinfo attrs.
+ * @param[in] binary       (Optional parameter, default to false) If true, the
+ * program is written in CBOR, the binary encoding of JSON, which is smaller
+ * and much faster to load than the text. `readable` is ignored then.
  *
  * @return void。
  *
@@ -40,7 +43,8 @@ void WriteModule(const pir::Program& program,
                  const uint64_t& pir_version,
                  bool overwrite,
                  bool readable = false,
-                 bool trainable = true);
+                 bool trainable = true,
+                 bool binary = false);
 
 /**
  * @brief Gets a PIR program from the specified file path.
@@ -55,7 +59,8 @@ void WriteModule(const pir::Program& program,
  * read from the file.
  *
  * @note If 'pir_version' is larger than the version of file, will trigger
- * version compatibility modification rule.
+ * version compatibility modification rule. Both the text and the binary
+ * files written by WriteModule are accepted.
  */
 void ReadModule(const std::string& file_path,
                 pir::Program* program,
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
+#include <vector>
 #include "paddle/common/enforce.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_serialize.h"
@@ -29,7 +30,8 @@ void WriteModule(const pir::Program& program,
                  const uint64_t& pir_version,
                  bool overwrite,
                  bool readable,
-                 bool trainable) {
+                 bool trainable,
+                 bool binary) {
   PADDLE_ENFORCE_EQ(
       FileExists(file_path) && !overwrite,
       false,
@@ -47,7 +49,10 @@ void WriteModule(const pir::Program& program,
   // write program
   total[PROGRAM] = writer.GetProgramJson(&program);
   std::string total_str;
-  if (readable) {
+  if (binary) {
+    std::vector<uint8_t> bytes = Json::to_cbor(total);
+    total_str.assign(bytes.begin(), bytes.end());
+  } else if (readable) {
     total_str = total.dump(4);
   } else {
     total_str = total.dump();
@@ -66,8 +71,19 @@ void WriteModule(const pir::Program& program,
 void ReadModule(const std::string& file_path,
                 pir::Program* program,
                 const uint64_t& pir_version) {
-  std::ifstream f(file_path);
-  Json data = Json::parse(f);
+  std::ifstream f(file_path, std::ios::binary);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(f),
+                    true,
+                    common::errors::Unavailable(
+                        "Cannot open %s to load the program.", file_path));
+  // The text format starts with '{' or whitespace, while the binary format
+  // starts with a CBOR map header, whose major type is 5.
+  Json data;
+  if ((f.peek() & 0xE0) == 0xA0) {
+    data = Json::from_cbor(f);
+  } else {
+    data = Json::parse(f);
+  }
 
   ProgramReader reader(pir_version);
   reader.RecoverProgram(&(data[PROGRAM]), program);
@@ -14,22 +14,45 @@
 
 #include "paddle/fluid/pir/transforms/build_cinn_pass.h"
 
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+
 #include "paddle/cinn/hlir/dialect/operator/ir/manual_op.h"
+#include "paddle/cinn/hlir/dialect/operator/ir/op_dialect.h"
 #include "paddle/cinn/hlir/framework/pir/utils.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/pir/transforms/sub_graph_detector.h"
 #include "paddle/pir/include/core/builtin_op.h"
 #include "paddle/pir/include/pass/pass.h"
 #include "paddle/pir/include/pass/pass_registry.h"
 
+COMMON_DECLARE_string(deny_cinn_groups);
+
 namespace {
 using GroupOpsVec = std::vector<pir::Operation*>;
 using CompatibleInfo = cinn::hlir::framework::pir::CompatibleInfo;
 
 void VerifyOperationOrder(const pir::Block& block);
 
+std::unordered_set<std::string> DeniedGroupsInFLAGS() {
+  std::unordered_set<std::string> denied_groups;
+  std::stringstream ss(FLAGS_deny_cinn_groups);
+  std::string fingerprint;
+  while (std::getline(ss, fingerprint, ';')) {
+    if (!fingerprint.empty()) denied_groups.insert(fingerprint);
+  }
+  return denied_groups;
+}
+
 class BuildCinnPass : public pir::Pass {
  public:
-  BuildCinnPass() : pir::Pass("build_cinn_pass", /*opt_level=*/1) {}
+  BuildCinnPass() : BuildCinnPass(DeniedGroupsInFLAGS()) {}
+
+  explicit BuildCinnPass(std::unordered_set<std::string> denied_groups)
+      : pir::Pass("build_cinn_pass", /*opt_level=*/1),
+        denied_groups_(std::move(denied_groups)) {}
 
   void Run(pir::Operation* op) override {
     for (uint32_t i = 0; i < op->num_regions(); ++i) {
@@ -54,10 +77,33 @@ class BuildCinnPass : public pir::Pass {
       if (group_ops.size() == 1 && group_ops[0]->name() == "pd_op.full") {
         continue;
       }
+      if (IsDenied(group_ops)) {
+        DenyGroup(block, group_ops);
+        continue;
+      }
       VLOG(4) << "current group_ops.size(): " << group_ops.size();
       ::pir::ReplaceWithGroupOp(block, group_ops);
     }
   }
+
+  bool IsDenied(const GroupOpsVec& group_ops) const {
+    if (denied_groups_.empty()) return false;
+    const std::string fingerprint = ::pir::CinnGroupFingerprint(group_ops);
+    VLOG(4) << "The fingerprint of the group is " << fingerprint;
+    return denied_groups_.count(fingerprint) > 0;
+  }
+
+  // The ops converted by pd_to_cinn_pass have no phi kernel, so they are
+  // still compiled by CINN, but one by one.
+  void DenyGroup(pir::Block* block, const GroupOpsVec& group_ops) {
+    for (auto* op : group_ops) {
+      if (op->dialect()->name() == cinn::dialect::OperatorDialect::name()) {
+        ::pir::ReplaceWithGroupOp(block, {op});
+      }
+    }
+  }
+
+  std::unordered_set<std::string> denied_groups_;
 };
 
 void VerifyOperationOrder(const pir::Block& block) {
@@ -112,6 +158,35 @@ std::unique_ptr<Pass> CreateBuildCinnPass() {
   return std::make_unique<BuildCinnPass>();
 }
 
+std::unique_ptr<Pass> CreateBuildCinnPass(
+    const std::unordered_set<std::string>& denied_groups) {
+  return std::make_unique<BuildCinnPass>(denied_groups);
+}
+
+std::string CinnGroupFingerprint(const std::vector<Operation*>& ops) {
+  std::vector<std::string> signatures;
+  signatures.reserve(ops.size());
+  for (auto* op : ops) {
+    std::ostringstream os;
+    os << op->name() << "(";
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      os << op->result(i).type() << ",";
+    }
+    os << ")";
+    signatures.emplace_back(os.str());
+  }
+  std::sort(signatures.begin(), signatures.end());
+  std::string key;
+  for (auto& signature : signatures) {
+    key += signature;
+    key += ";";
+  }
+  std::ostringstream fingerprint;
+  fingerprint << std::hex << std::setw(16) << std::setfill('0')
+              << std::hash<std::string>()(key);
+  return fingerprint.str();
+}
+
 }  // namespace pir
 
 REGISTER_IR_PASS(build_cinn_pass, BuildCinnPass);
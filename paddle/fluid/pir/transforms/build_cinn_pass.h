@@ -15,12 +15,28 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 #include "paddle/pir/include/core/dll_decl.h"
 
 namespace pir {
 
+class Operation;
 class Pass;
 
 IR_API std::unique_ptr<Pass> CreateBuildCinnPass();
 
+// The groups of the given fingerprints are not fused: their pd ops are left
+// to the phi kernels, and the ops that exist only in the cinn dialect are
+// each put into a group of their own. CreateBuildCinnPass() denies the
+// groups listed in FLAGS_deny_cinn_groups.
+IR_API std::unique_ptr<Pass> CreateBuildCinnPass(
+    const std::unordered_set<std::string>& denied_groups);
+
+// Returns the fingerprint of the ops of a group, built from the names and
+// the result types of the ops, regardless of their order.
+IR_API std::string CinnGroupFingerprint(const std::vector<Operation*>& ops);
+
 }  // namespace pir
@@ -0,0 +1,342 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/general/auto_layout_pass.h"
+
+#include <functional>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/pir/include/core/block.h"
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_attribute.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/builtin_type.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+const std::vector<int> kNCHWToNHWC = {0, 2, 3, 1};
+const std::vector<int> kNHWCToNCHW = {0, 3, 1, 2};
+
+// The ops with a data_format attribute, their first operand and result are
+// the feature maps.
+const std::unordered_set<std::string>& LayoutOps() {
+  static const std::unordered_set<std::string> ops = {
+      paddle::dialect::Conv2dOp::name(),
+      paddle::dialect::DepthwiseConv2dOp::name(),
+      paddle::dialect::BatchNormOp::name(),
+      paddle::dialect::BatchNorm_Op::name(),
+      paddle::dialect::Pool2dOp::name(),
+  };
+  return ops;
+}
+
+// The ops computing each element of their 4-D results out of the elements of
+// their 4-D operands at the same index, they run in any layout.
+const std::unordered_set<std::string>& LayoutAgnosticOps() {
+  static const std::unordered_set<std::string> ops = {
+      paddle::dialect::ReluOp::name(),
+      paddle::dialect::Relu6Op::name(),
+      paddle::dialect::SiluOp::name(),
+      paddle::dialect::SigmoidOp::name(),
+      paddle::dialect::SwishOp::name(),
+      paddle::dialect::HardswishOp::name(),
+      paddle::dialect::HardsigmoidOp::name(),
+      paddle::dialect::LeakyReluOp::name(),
+      paddle::dialect::GeluOp::name(),
+      paddle::dialect::TanhOp::name(),
+      paddle::dialect::ScaleOp::name(),
+      paddle::dialect::CastOp::name(),
+      paddle::dialect::AddOp::name(),
+      paddle::dialect::SubtractOp::name(),
+      paddle::dialect::MultiplyOp::name(),
+      paddle::dialect::MaximumOp::name(),
+      paddle::dialect::MinimumOp::name(),
+  };
+  return ops;
+}
+
+bool IsConvOp(const pir::Operation* op) {
+  return op->name() == paddle::dialect::Conv2dOp::name() ||
+         op->name() == paddle::dialect::DepthwiseConv2dOp::name();
+}
+
+paddle::dialect::DenseTensorType GetDenseTensorType(pir::Value value) {
+  if (!value || !value.type()) {
+    return paddle::dialect::DenseTensorType();
+  }
+  return value.type().dyn_cast<paddle::dialect::DenseTensorType>();
+}
+
+bool Is4DTensor(pir::Value value) {
+  auto type = GetDenseTensorType(value);
+  return type && type.dims().size() == 4;
+}
+
+bool IsScalarTensor(pir::Value value) {
+  auto type = GetDenseTensorType(value);
+  return type && type.dims().size() <= 1 && common::product(type.dims()) == 1;
+}
+
+// The convs cuDNN runs on tensor cores, which prefer NHWC.
+bool IsTensorCoreConv(pir::Operation* op) {
+  auto dtype = GetDenseTensorType(op->operand_source(0)).dtype();
+  return dtype.isa<pir::Float16Type>() || dtype.isa<pir::BFloat16Type>();
+}
+
+bool IsConstantLike(pir::Value value) {
+  auto* op = value.defining_op();
+  return op && (op->isa<pir::ParameterOp>() ||
+                op->isa<pir::ConstantTensorOp>() ||
+                op->isa<paddle::dialect::FullOp>());
+}
+
+bool IsCandidate(pir::Operation* op) {
+  if (op->num_operands() == 0 || op->num_results() == 0 ||
+      !Is4DTensor(op->operand_source(0)) || !Is4DTensor(op->result(0))) {
+    return false;
+  }
+  if (LayoutOps().count(op->name())) {
+    return op->HasAttribute("data_format") &&
+           op->attribute<pir::StrAttribute>("data_format").AsString() ==
+               "NCHW";
+  }
+  if (!LayoutAgnosticOps().count(op->name())) {
+    return false;
+  }
+  // a broadcast operand of lower rank would be aligned to another axis
+  for (size_t i = 0; i < op->num_operands(); ++i) {
+    auto operand = op->operand_source(i);
+    if (GetDenseTensorType(operand) && !Is4DTensor(operand) &&
+        !IsScalarTensor(operand)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < op->num_results(); ++i) {
+    if (GetDenseTensorType(op->result(i)) && !Is4DTensor(op->result(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The 4-D values an op of a region takes and produces in the region layout.
+std::vector<size_t> LayoutOperands(pir::Operation* op) {
+  if (LayoutOps().count(op->name())) {
+    return {0};
+  }
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < op->num_operands(); ++i) {
+    if (Is4DTensor(op->operand_source(i))) indices.push_back(i);
+  }
+  return indices;
+}
+
+std::vector<size_t> LayoutResults(pir::Operation* op) {
+  if (LayoutOps().count(op->name())) {
+    return {0};
+  }
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < op->num_results(); ++i) {
+    if (Is4DTensor(op->result(i))) indices.push_back(i);
+  }
+  return indices;
+}
+
+bool IsLayoutResult(pir::Operation* op, pir::Value value) {
+  for (size_t idx : LayoutResults(op)) {
+    if (op->result(idx) == value) return true;
+  }
+  return false;
+}
+
+class AutoLayoutPass : public pir::Pass {
+ public:
+  AutoLayoutPass() : pir::Pass("auto_layout_pass", 2) {}
+
+  void Run(pir::Operation* op) override {
+    int64_t num_rewrites = 0;
+    for (size_t i = 0; i < op->num_regions(); ++i) {
+      for (auto& block : op->region(i)) {
+        num_rewrites += RewriteBlock(&block);
+      }
+    }
+    AddStatistics(num_rewrites);
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    return op->num_regions() > 0;
+  }
+
+ private:
+  // Split the candidate ops of the block into regions connected by their
+  // 4-D values, and turn the regions worth it to NHWC. Inside a region no
+  // transpose is needed, so the transposes are only the ones at its border.
+  int64_t RewriteBlock(pir::Block* block) {
+    std::vector<pir::Operation*> ops;
+    std::unordered_map<pir::Operation*, size_t> op_index;
+    for (auto& op : *block) {
+      if (IsCandidate(&op)) {
+        op_index[&op] = ops.size();
+        ops.push_back(&op);
+      }
+    }
+    if (ops.empty()) return 0;
+
+    std::vector<size_t> parent(ops.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    std::function<size_t(size_t)> find = [&](size_t i) {
+      return parent[i] == i ? i : parent[i] = find(parent[i]);
+    };
+    for (size_t i = 0; i < ops.size(); ++i) {
+      for (size_t idx : LayoutOperands(ops[i])) {
+        auto value = ops[i]->operand_source(idx);
+        auto it = op_index.find(value.defining_op());
+        if (it != op_index.end() && IsLayoutResult(it->first, value)) {
+          parent[find(i)] = find(it->second);
+        }
+      }
+    }
+    std::unordered_map<size_t, std::vector<pir::Operation*>> regions;
+    for (size_t i = 0; i < ops.size(); ++i) {
+      regions[find(i)].push_back(ops[i]);
+    }
+
+    int64_t num_rewrites = 0;
+    for (auto& item : regions) {
+      std::unordered_set<pir::Operation*> region(item.second.begin(),
+                                                 item.second.end());
+      if (Worthwhile(item.second, region)) {
+        RewriteRegion(block, item.second, region);
+        ++num_rewrites;
+      }
+    }
+    return num_rewrites;
+  }
+
+  bool IsRegionValue(pir::Value value,
+                     const std::unordered_set<pir::Operation*>& region) {
+    auto* op = value.defining_op();
+    return op && region.count(op) && IsLayoutResult(op, value);
+  }
+
+  // cuDNN runs a tensor core conv of NCHW tensors by transposing its input
+  // and output, so the region pays off once its convs save more transposes
+  // than its border adds. The constant operands are left to constant folding.
+  bool Worthwhile(const std::vector<pir::Operation*>& ops,
+                  const std::unordered_set<pir::Operation*>& region) {
+    int64_t num_convs = 0;
+    std::unordered_set<pir::Value> border_values;
+    for (auto* op : ops) {
+      if (IsConvOp(op) && IsTensorCoreConv(op)) ++num_convs;
+      for (size_t idx : LayoutOperands(op)) {
+        auto value = op->operand_source(idx);
+        if (!IsRegionValue(value, region) && !IsConstantLike(value)) {
+          border_values.insert(value);
+        }
+      }
+      for (size_t idx : LayoutResults(op)) {
+        auto value = op->result(idx);
+        for (auto it = value.use_begin(); it != value.use_end(); ++it) {
+          if (!region.count(it->owner())) {
+            border_values.insert(value);
+            break;
+          }
+        }
+      }
+    }
+    VLOG(6) << "Layout region of " << ops.size() << " ops, " << num_convs
+            << " tensor core convs, " << border_values.size()
+            << " border values";
+    return num_convs > 0 &&
+           2 * num_convs > static_cast<int64_t>(border_values.size());
+  }
+
+  void RewriteRegion(pir::Block* block,
+                     const std::vector<pir::Operation*>& ops,
+                     const std::unordered_set<pir::Operation*>& region) {
+    pir::IrContext* ctx = pir::IrContext::Instance();
+    pir::Builder builder(ctx, block);
+    std::unordered_map<pir::Value, pir::Value> nhwc_inputs;
+    for (auto* op : ops) {
+      for (size_t idx : LayoutOperands(op)) {
+        auto value = op->operand_source(idx);
+        if (IsRegionValue(value, region)) continue;
+        auto it = nhwc_inputs.find(value);
+        if (it == nhwc_inputs.end()) {
+          builder.set_insertion_point(op);
+          auto transpose =
+              builder.Build<paddle::dialect::TransposeOp>(value, kNCHWToNHWC);
+          it = nhwc_inputs.emplace(value, transpose->result(0)).first;
+        }
+        op->operand(idx).set_source(it->second);
+      }
+      if (LayoutOps().count(op->name())) {
+        op->set_attribute("data_format", pir::StrAttribute::get(ctx, "NHWC"));
+      }
+      for (size_t idx : LayoutResults(op)) {
+        auto type = GetDenseTensorType(op->result(idx));
+        const auto& dims = type.dims();
+        op->result(idx).set_type(paddle::dialect::DenseTensorType::get(
+            ctx,
+            type.dtype(),
+            common::make_ddim({dims[0], dims[2], dims[3], dims[1]}),
+            type.data_layout(),
+            type.lod(),
+            type.offset()));
+      }
+    }
+
+    // the users out of the region get the value back in NCHW
+    for (auto* op : ops) {
+      for (size_t idx : LayoutResults(op)) {
+        auto value = op->result(idx);
+        bool used_outside = false;
+        for (auto it = value.use_begin(); it != value.use_end(); ++it) {
+          used_outside |= !region.count(it->owner());
+        }
+        if (!used_outside) continue;
+        builder.SetInsertionPointAfter(op);
+        auto transpose =
+            builder.Build<paddle::dialect::TransposeOp>(value, kNHWCToNCHW);
+        pir::Operation* transpose_op = transpose.operation();
+        value.ReplaceUsesWithIf(
+            transpose->result(0), [&](pir::OpOperand operand) {
+              return operand.owner() != transpose_op &&
+                     !region.count(operand.owner());
+            });
+      }
+    }
+  }
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateAutoLayoutPass() {
+  return std::make_unique<AutoLayoutPass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(auto_layout_pass, AutoLayoutPass);
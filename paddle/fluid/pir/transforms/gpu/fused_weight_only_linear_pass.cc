@@ -37,18 +37,90 @@ int getSMVersion() {
   return sm_version;
 }
 
+// Whether w of match_ctx is a weight the weight only linear can run by.
+bool IsQuantizableWeight(const paddle::drr::MatchContext &match_ctx,
+                         int group_size) {
+  if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
+    return false;
+  }
+  auto w_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w"));
+  if (!w_dtype.isa<pir::Float16Type>() && !w_dtype.isa<pir::BFloat16Type>()) {
+    return false;
+  }
+  auto w_dims = pir::GetShapeFromValue(match_ctx.Tensor("w"));
+  auto x_dims = pir::GetShapeFromValue(match_ctx.Tensor("x"));
+  if (!(w_dims.size() == 2 && x_dims.size() >= 2)) {
+    return false;
+  }
+  if (w_dims.at(0) % 64 != 0 || w_dims.at(1) % 16 != 0) return false;
+  // the groups are of the rows of w, i.e. of the k dim
+  if (group_size > 0 && w_dims.at(0) % group_size != 0) return false;
+  if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
+  return true;
+}
+
+// Quantizes w of res to quanted_weight_tensor and weight_scale_tensor.
+void QuantizeWeight(paddle::drr::ResultPattern *res,
+                    const std::string &algo,
+                    int sm_version,
+                    int group_size) {
+  // TODO(liuyuanle): When the operator weight_quantize supports
+  // weight_only_int4 and group wise scales on gpu version, delete the memory
+  // copy.
+  if (algo == "weight_only_int4" || group_size > 0) {
+    const auto &memcpy_d2h =
+        res->Op(paddle::dialect::MemcpyD2hOp::name(),
+                {{"dst_place_type", res->Int32Attr(0 /*cpu*/)}});
+    res->Tensor("w_cpu") = memcpy_d2h(res->Tensor("w"));
+    const auto &weight_quantize =
+        res->Op(paddle::dialect::WeightQuantizeOp::name(),
+                {{"algo", res->StrAttr(algo)},
+                 {"arch", res->Int32Attr(sm_version)},
+                 {"group_size", res->Int32Attr(group_size)}});
+    weight_quantize({&res->Tensor("w_cpu")},
+                    {&res->Tensor("quanted_weight_tensor_cpu"),
+                     &res->Tensor("weight_scale_tensor_cpu")});
+
+    const auto &memcpy_h2d_1 =
+        res->Op(paddle::dialect::MemcpyH2dOp::name(),
+                {{"dst_place_type", res->Int32Attr(1 /*gpu*/)}});
+    res->Tensor("quanted_weight_tensor") =
+        memcpy_h2d_1(res->Tensor("quanted_weight_tensor_cpu"));
+    const auto &memcpy_h2d_2 =
+        res->Op(paddle::dialect::MemcpyH2dOp::name(),
+                {{"dst_place_type", res->Int32Attr(1 /*gpu*/)}});
+    res->Tensor("weight_scale_tensor") =
+        memcpy_h2d_2(res->Tensor("weight_scale_tensor_cpu"));
+  } else {
+    const auto &weight_quantize =
+        res->Op(paddle::dialect::WeightQuantizeOp::name(),
+                {{"algo", res->StrAttr(algo)},
+                 {"arch", res->Int32Attr(sm_version)},
+                 {"group_size", res->Int32Attr(group_size)}});
+
+    weight_quantize({&res->Tensor("w")},
+                    {&res->Tensor("quanted_weight_tensor"),
+                     &res->Tensor("weight_scale_tensor")});
+  }
+}
+
 class FusedWeightOnlyLinearWithBiasPattern
     : public paddle::drr::DrrPatternBase {
  private:
   bool reverse_add_;
   std::string algo_;
   int sm_version_;
+  int group_size_;
 
  public:
   FusedWeightOnlyLinearWithBiasPattern(bool reverse_add,
                                        const std::string &algo,
-                                       int sm_version)
-      : reverse_add_(reverse_add), algo_(algo), sm_version_(sm_version) {}
+                                       int sm_version,
+                                       int group_size)
+      : reverse_add_(reverse_add),
+        algo_(algo),
+        sm_version_(sm_version),
+        group_size_(group_size) {}
 
   std::string name() const override {
     return "FusedWeightOnlyLinearWithBiasPattern";
@@ -76,82 +148,29 @@ class FusedWeightOnlyLinearWithBiasPattern
     // Constraints.
     //
     src.RequireNativeCall(
-        [](const paddle::drr::MatchContext &match_ctx) -> bool {
-          if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
-            return false;
-          }
+        [this](const paddle::drr::MatchContext &match_ctx) -> bool {
           bool matmul_trans_x = match_ctx.Attr<bool>("matmul_transpose_x");
           bool matmul_trans_y = match_ctx.Attr<bool>("matmul_transpose_y");
           if (matmul_trans_x || matmul_trans_y) return false;
 
-          auto w_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w"));
-          if (!w_dtype.isa<pir::Float16Type>() &&
-              !w_dtype.isa<pir::BFloat16Type>()) {
-            return false;
-          }
+          if (!IsQuantizableWeight(match_ctx, group_size_)) return false;
 
-          auto w_dims = pir::GetShapeFromValue(match_ctx.Tensor("w"));
-          auto x_dims = pir::GetShapeFromValue(match_ctx.Tensor("x"));
           auto bias_dims = pir::GetShapeFromValue(match_ctx.Tensor("bias"));
-          if (!(w_dims.size() == 2 && x_dims.size() >= 2 &&
-                bias_dims.size() == 1)) {
-            return false;
-          }
-
-          if (w_dims.at(0) % 64 != 0 || w_dims.at(1) % 16 != 0) return false;
-          if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
-
-          return true;
+          return bias_dims.size() == 1;
         });
     //
     // Result Pattern.
     //
     paddle::drr::ResultPattern res = src.ResultPattern();
 
-    if (algo_ == "weight_only_int4") {
-      // TODO(liuyuanle): When the operator weight_quantize supports
-      // weight_only_int4 on gpu version, delete the memory copy.
-      const auto &memcpy_d2h =
-          res.Op(paddle::dialect::MemcpyD2hOp::name(),
-                 {{"dst_place_type", res.Int32Attr(0 /*cpu*/)}});
-      res.Tensor("w_cpu") = memcpy_d2h(res.Tensor("w"));
-      const auto &weight_quantize =
-          res.Op(paddle::dialect::WeightQuantizeOp::name(),
-                 {{"algo", res.StrAttr(algo_)},
-                  {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
-      weight_quantize({&res.Tensor("w_cpu")},
-                      {&res.Tensor("quanted_weight_tensor_cpu"),
-                       &res.Tensor("weight_scale_tensor_cpu")});
-
-      const auto &memcpy_h2d_1 =
-          res.Op(paddle::dialect::MemcpyH2dOp::name(),
-                 {{"dst_place_type", res.Int32Attr(1 /*gpu*/)}});
-      res.Tensor("quanted_weight_tensor") =
-          memcpy_h2d_1(res.Tensor("quanted_weight_tensor_cpu"));
-      const auto &memcpy_h2d_2 =
-          res.Op(paddle::dialect::MemcpyH2dOp::name(),
-                 {{"dst_place_type", res.Int32Attr(1 /*gpu*/)}});
-      res.Tensor("weight_scale_tensor") =
-          memcpy_h2d_2(res.Tensor("weight_scale_tensor_cpu"));
-    } else {
-      const auto &weight_quantize =
-          res.Op(paddle::dialect::WeightQuantizeOp::name(),
-                 {{"algo", res.StrAttr(algo_)},
-                  {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
-
-      weight_quantize({&res.Tensor("w")},
-                      {&res.Tensor("quanted_weight_tensor"),
-                       &res.Tensor("weight_scale_tensor")});
-    }
+    QuantizeWeight(&res, algo_, sm_version_, group_size_);
 
     const auto &weight_only_linear =
         res.Op(paddle::dialect::WeightOnlyLinearOp::name(),
                {{"weight_dtype",
                  res.StrAttr(algo_ == "weight_only_int8" ? "int8" : "int4")},
                 {"arch", res.Int32Attr(sm_version_)},
-                {"group_size", res.Int32Attr(-1)}});
+                {"group_size", res.Int32Attr(group_size_)}});
     weight_only_linear({&res.Tensor("x"),
                         &res.Tensor("quanted_weight_tensor"),
                         &res.Tensor("bias"),
@@ -164,10 +183,13 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
  private:
   std::string algo_;
   int sm_version_;
+  int group_size_;
 
  public:
-  FusedWeightOnlyLinearNoBiasPattern(const std::string &algo, int sm_version)
-      : algo_(algo), sm_version_(sm_version) {}
+  FusedWeightOnlyLinearNoBiasPattern(const std::string &algo,
+                                     int sm_version,
+                                     int group_size)
+      : algo_(algo), sm_version_(sm_version), group_size_(group_size) {}
 
  public:
   std::string name() const override {
@@ -191,84 +213,103 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
     // Constraints.
     //
     src.RequireNativeCall(
-        [](const paddle::drr::MatchContext &match_ctx) -> bool {
-          if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
-            return false;
-          }
+        [this](const paddle::drr::MatchContext &match_ctx) -> bool {
           bool matmul_trans_x = match_ctx.Attr<bool>("matmul_transpose_x");
           bool matmul_trans_y = match_ctx.Attr<bool>("matmul_transpose_y");
           if (matmul_trans_x || matmul_trans_y) return false;
 
-          auto w_dims = pir::GetShapeFromValue(match_ctx.Tensor("w"));
-          auto x_dims = pir::GetShapeFromValue(match_ctx.Tensor("x"));
-          if (!(w_dims.size() == 2 && x_dims.size() >= 2)) {
-            return false;
-          }
+          return IsQuantizableWeight(match_ctx, group_size_);
+        });
+    //
+    // Result Pattern.
+    //
+    paddle::drr::ResultPattern res = src.ResultPattern();
 
-          if (w_dims.at(0) % 64 != 0 || w_dims.at(1) % 16 != 0) return false;
+    QuantizeWeight(&res, algo_, sm_version_, group_size_);
 
-          auto w_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w"));
-          if (!w_dtype.isa<pir::Float16Type>() &&
-              !w_dtype.isa<pir::BFloat16Type>())
+    const auto &weight_only_linear =
+        res.Op(paddle::dialect::WeightOnlyLinearOp::name(),
+               {{"weight_dtype",
+                 res.StrAttr(algo_ == "weight_only_int8" ? "int8" : "int4")},
+                {"arch", res.Int32Attr(sm_version_)},
+                {"group_size", res.Int32Attr(group_size_)}});
+    weight_only_linear({&res.Tensor("x"),
+                        &res.Tensor("quanted_weight_tensor"),
+                        &res.InputNoneTensor(),
+                        &res.Tensor("weight_scale_tensor")},
+                       {&res.Tensor("matmul_out")});
+  }
+};
+
+// The fc of the models saved with it, without activation, as a linear of
+// the last dim of x.
+class FusedWeightOnlyLinearFcPattern : public paddle::drr::DrrPatternBase {
+ private:
+  std::string algo_;
+  int sm_version_;
+  int group_size_;
+
+ public:
+  FusedWeightOnlyLinearFcPattern(const std::string &algo,
+                                 int sm_version,
+                                 int group_size)
+      : algo_(algo), sm_version_(sm_version), group_size_(group_size) {}
+
+  std::string name() const override {
+    return "FusedWeightOnlyLinearFcPattern";
+  }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    //
+    // Source Pattern.
+    //
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &fc =
+        src.Op(paddle::dialect::FcOp::name(),
+               {{"in_num_col_dims", src.Attr("in_num_col_dims")},
+                {"activation_type", src.Attr("activation_type")},
+                {"padding_weights", src.Attr("padding_weights")}});
+    fc({&src.Tensor("x"), &src.Tensor("w"), &src.Tensor("bias")},
+       {&src.Tensor("fc_out")});
+
+    //
+    // Constraints.
+    //
+    src.RequireNativeCall(
+        [this](const paddle::drr::MatchContext &match_ctx) -> bool {
+          if (!match_ctx.Attr<std::string>("activation_type").empty() ||
+              match_ctx.Attr<bool>("padding_weights")) {
+            return false;
+          }
+          auto x_dims = pir::GetShapeFromValue(match_ctx.Tensor("x"));
+          if (match_ctx.Attr<int>("in_num_col_dims") !=
+              static_cast<int>(x_dims.size()) - 1) {
             return false;
+          }
 
-          if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
+          if (!IsQuantizableWeight(match_ctx, group_size_)) return false;
 
-          return true;
+          auto bias_dims = pir::GetShapeFromValue(match_ctx.Tensor("bias"));
+          return bias_dims.size() == 1;
         });
     //
     // Result Pattern.
     //
     paddle::drr::ResultPattern res = src.ResultPattern();
 
-    if (algo_ == "weight_only_int4") {
-      // TODO(liuyuanle): When the operator weight_quantize supports
-      // weight_only_int4 on gpu version, delete the memory copy.
-      const auto &memcpy_d2h =
-          res.Op(paddle::dialect::MemcpyD2hOp::name(),
-                 {{"dst_place_type", res.Int32Attr(0 /*cpu*/)}});
-      res.Tensor("w_cpu") = memcpy_d2h(res.Tensor("w"));
-      const auto &weight_quantize =
-          res.Op(paddle::dialect::WeightQuantizeOp::name(),
-                 {{"algo", res.StrAttr(algo_)},
-                  {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
-      weight_quantize({&res.Tensor("w_cpu")},
-                      {&res.Tensor("quanted_weight_tensor_cpu"),
-                       &res.Tensor("weight_scale_tensor_cpu")});
-
-      const auto &memcpy_h2d_1 =
-          res.Op(paddle::dialect::MemcpyH2dOp::name(),
-                 {{"dst_place_type", res.Int32Attr(1 /*gpu*/)}});
-      res.Tensor("quanted_weight_tensor") =
-          memcpy_h2d_1(res.Tensor("quanted_weight_tensor_cpu"));
-      const auto &memcpy_h2d_2 =
-          res.Op(paddle::dialect::MemcpyH2dOp::name(),
-                 {{"dst_place_type", res.Int32Attr(1 /*gpu*/)}});
-      res.Tensor("weight_scale_tensor") =
-          memcpy_h2d_2(res.Tensor("weight_scale_tensor_cpu"));
-    } else {
-      const auto &weight_quantize =
-          res.Op(paddle::dialect::WeightQuantizeOp::name(),
-                 {{"algo", res.StrAttr(algo_)},
-                  {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
-
-      weight_quantize({&res.Tensor("w")},
-                      {&res.Tensor("quanted_weight_tensor"),
-                       &res.Tensor("weight_scale_tensor")});
-    }
+    QuantizeWeight(&res, algo_, sm_version_, group_size_);
+
     const auto &weight_only_linear =
         res.Op(paddle::dialect::WeightOnlyLinearOp::name(),
                {{"weight_dtype",
                  res.StrAttr(algo_ == "weight_only_int8" ? "int8" : "int4")},
                 {"arch", res.Int32Attr(sm_version_)},
-                {"group_size", res.Int32Attr(-1)}});
+                {"group_size", res.Int32Attr(group_size_)}});
     weight_only_linear({&res.Tensor("x"),
                         &res.Tensor("quanted_weight_tensor"),
-                        &res.InputNoneTensor(),
+                        &res.Tensor("bias"),
                         &res.Tensor("weight_scale_tensor")},
-                       {&res.Tensor("matmul_out")});
+                       {&res.Tensor("fc_out")});
   }
 };
 
@@ -289,14 +330,28 @@ class FusedWeightOnlyLinearPass : public pir::PatternRewritePass {
                           "fused_weight_only_linear_pass only support "
                           "weight_only_int8 or weight_only_int4, but get %s.",
                           algo));
+    // -1 for the per channel scales, else a scale of each group_size rows
+    int group_size = -1;
+    if (Has("weight_only_group_size")) {
+      group_size = Get<int>("weight_only_group_size");
+    }
+    PADDLE_ENFORCE_EQ(
+        group_size == -1 || group_size == 64 || group_size == 128,
+        true,
+        common::errors::InvalidArgument(
+            "fused_weight_only_linear_pass only support group_size -1, 64 "
+            "or 128, but get %d.",
+            group_size));
 
     pir::RewritePatternSet ps(context);
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearWithBiasPattern>(
-        context, true, algo, sm_version_));
+        context, true, algo, sm_version_, group_size));
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearWithBiasPattern>(
-        context, false, algo, sm_version_));
+        context, false, algo, sm_version_, group_size));
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearNoBiasPattern>(
-        context, algo, sm_version_));
+        context, algo, sm_version_, group_size));
+    ps.Add(paddle::drr::Create<FusedWeightOnlyLinearFcPattern>(
+        context, algo, sm_version_, group_size));
     return ps;
   }
 
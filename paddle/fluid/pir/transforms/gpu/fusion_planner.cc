@@ -0,0 +1,166 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/gpu/fusion_planner.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_set>
+
+#include "paddle/common/ddim.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/utils/utils.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/pir/include/core/builtin_type.h"
+#include "paddle/pir/include/core/dialect.h"
+#include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/include/core/ir_mapping.h"
+#include "paddle/pir/include/core/program.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_manager.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+// About 5 us to launch a kernel, and 1 TB/s of global memory bandwidth.
+constexpr double kLaunchCostUs = 5.0;
+constexpr double kBytesPerUs = 1e6;
+
+const std::unordered_set<std::string> kNoKernelOps{
+    "pd_op.data", "pd_op.feed", "pd_op.fetch"};
+
+int64_t TypeBytes(pir::Type type) {
+  if (auto vector_type = type.dyn_cast<pir::VectorType>()) {
+    int64_t bytes = 0;
+    for (size_t i = 0; i < vector_type.size(); ++i) {
+      bytes += TypeBytes(vector_type[i]);
+    }
+    return bytes;
+  }
+  auto tensor_type = type.dyn_cast<paddle::dialect::DenseTensorType>();
+  if (!tensor_type) {
+    return 0;
+  }
+  int64_t numel = 1;
+  for (int64_t dim : common::vectorize(tensor_type.dims())) {
+    numel *= std::max<int64_t>(dim, 1);
+  }
+  return numel * static_cast<int64_t>(phi::SizeOf(
+                     paddle::dialect::TransToPhiDataType(tensor_type.dtype())));
+}
+
+bool LaunchesKernel(pir::Operation* op) {
+  return op->num_regions() == 0 && op->dialect()->name() != "builtin" &&
+         !kNoKernelOps.count(op->name());
+}
+
+int64_t NumOps(pir::Program* program) {
+  int64_t num_ops = 0;
+  program->module_op()->Walk([&](pir::Operation* op) { ++num_ops; });
+  return num_ops;
+}
+
+bool RunPass(const std::string& pass_name,
+             pir::Program* program,
+             uint8_t opt_level) {
+  pir::PassManager pm(pir::IrContext::Instance(), opt_level);
+  pm.AddPass(pir::PassRegistry::Instance().Get(pass_name));
+  return pm.Run(program);
+}
+
+std::shared_ptr<pir::Program> CloneProgram(pir::Program* program) {
+  pir::IrMapping mapping;
+  return program->Clone(mapping);
+}
+
+}  // namespace
+
+namespace pir {
+
+double EstimateFusionCost(Program* program) {
+  double cost = 0;
+  program->module_op()->Walk([&](Operation* op) {
+    if (!LaunchesKernel(op)) {
+      return;
+    }
+    int64_t bytes = 0;
+    for (uint32_t i = 0; i < op->num_operands(); ++i) {
+      if (op->operand_source(i)) {
+        bytes += TypeBytes(op->operand_source(i).type());
+      }
+    }
+    for (uint32_t i = 0; i < op->num_results(); ++i) {
+      bytes += TypeBytes(op->result(i).type());
+    }
+    cost += kLaunchCostUs + static_cast<double>(bytes) / kBytesPerUs;
+  });
+  return cost;
+}
+
+FusionPlanReport ApplyPlannedFusionPasses(
+    Program* program,
+    const std::vector<std::string>& pass_names,
+    uint8_t opt_level) {
+  FusionPlanReport report;
+  report.original_cost = EstimateFusionCost(program);
+
+  auto fixed_order = CloneProgram(program);
+  for (const auto& pass_name : pass_names) {
+    RunPass(pass_name, fixed_order.get(), opt_level);
+  }
+  report.fixed_order_cost = EstimateFusionCost(fixed_order.get());
+
+  std::vector<std::string> remaining = pass_names;
+  double cost = report.original_cost;
+  while (!remaining.empty()) {
+    auto best = remaining.end();
+    double best_cost = cost;
+    for (auto it = remaining.begin(); it != remaining.end(); ++it) {
+      auto trial = CloneProgram(program);
+      if (!RunPass(*it, trial.get(), opt_level)) {
+        continue;
+      }
+      double trial_cost = EstimateFusionCost(trial.get());
+      VLOG(6) << "Fusion planner: " << *it << " changes the cost from "
+              << cost << " to " << trial_cost;
+      if (trial_cost < best_cost) {
+        best = it;
+        best_cost = trial_cost;
+      }
+    }
+    if (best == remaining.end()) {
+      break;
+    }
+    int64_t num_ops = NumOps(program);
+    RunPass(*best, program, opt_level);
+    report.steps.push_back(
+        {*best, cost - best_cost, num_ops - NumOps(program)});
+    cost = EstimateFusionCost(program);
+    remaining.erase(best);
+  }
+  report.planned_cost = cost;
+
+  VLOG(1) << "Fusion planner: the estimated cost is " << report.original_cost
+          << " us before fusion, " << report.fixed_order_cost
+          << " us with the given order and " << report.planned_cost
+          << " us with the planned order";
+  for (const auto& step : report.steps) {
+    VLOG(1) << "Fusion planner: applied " << step.pass_name
+            << ", estimated to save " << step.estimated_saving
+            << " us, removed " << step.num_removed_ops << " ops";
+  }
+  return report;
+}
+
+}  // namespace pir
@@ -0,0 +1,63 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "paddle/pir/include/core/dll_decl.h"
+
+namespace pir {
+
+class Program;
+
+// The estimated cost of running a program on GPU, in microseconds: every op
+// that launches a kernel pays a fixed launch overhead, plus the time to read
+// its inputs and write its outputs from global memory. Unknown dims count as
+// 1, so the cost is only meant to compare versions of the same program.
+IR_API double EstimateFusionCost(Program* program);
+
+struct FusionPlanStep {
+  std::string pass_name;
+  // The estimated cost saved by the pass when it was chosen.
+  double estimated_saving;
+  // The number of ops removed by the pass.
+  int64_t num_removed_ops;
+};
+
+struct FusionPlanReport {
+  std::vector<FusionPlanStep> steps;
+  // The estimated costs of the program before fusion, after fusion with the
+  // planned order, and after fusion with the given order.
+  double original_cost;
+  double planned_cost;
+  double fixed_order_cost;
+};
+
+// Applies the fusion passes named by `pass_names` to `program` in the order
+// planned by EstimateFusionCost instead of the given order.
+//
+// Several passes may match the same ops, and the first one to run takes them
+// from the others. The planner therefore tries every remaining pass on a
+// clone of the program, applies the one that saves the most, and repeats
+// until no pass saves anything. The passes that never save anything are not
+// applied.
+IR_API FusionPlanReport
+ApplyPlannedFusionPasses(Program* program,
+                         const std::vector<std::string>& pass_names,
+                         uint8_t opt_level);
+
+}  // namespace pir
@@ -14,12 +14,22 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/cpu_helper.h"
 
-#ifdef PADDLE_WITH_MKLML
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(PADDLE_WITH_MKLML) || defined(_OPENMP)
 #include <omp.h>
+#endif
 
+#ifdef PADDLE_WITH_MKLML
 #include "paddle/phi/backends/dynload/mklml.h"
 #endif
 
+#include "glog/logging.h"
+
 #ifdef PADDLE_USE_OPENBLAS
 #include <cblas.h>
 #endif
@@ -52,5 +62,50 @@ void SetNumThreads(int num_threads) {
 #endif
 }
 
+void BindThreadsToCpus(const std::vector<int>& cpu_ids) {
+  if (cpu_ids.empty()) {
+    return;
+  }
+  SetNumThreads(static_cast<int>(cpu_ids.size()));
+#if defined(__linux__) && (defined(PADDLE_WITH_MKLML) || defined(_OPENMP))
+  // the threads of the team of the calling thread are kept by the runtime
+  // for its next parallel regions
+#pragma omp parallel num_threads(static_cast<int>(cpu_ids.size()))
+  {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu_ids[omp_get_thread_num() % cpu_ids.size()], &mask);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) != 0) {
+      LOG(WARNING) << "Failed to bind the thread "
+                   << omp_get_thread_num() << " to cpu "
+                   << cpu_ids[omp_get_thread_num() % cpu_ids.size()];
+    }
+  }
+#else
+  LOG_FIRST_N(WARNING, 1) << "Binding the threads to cpus needs Linux and "
+                             "OpenMP, the threads are not bound.";
+#endif
+}
+
+void SetThreadsSpinWait(bool spin_wait) {
+#if defined(__linux__)
+  // kmp_set_blocktime of the Intel OpenMP runtime of MKL sets the time the
+  // threads of the calling thread spin before sleeping, GNU OpenMP only has
+  // OMP_WAIT_POLICY read at its start
+  using SetBlocktime = void (*)(int);
+  static auto set_blocktime = reinterpret_cast<SetBlocktime>(
+      dlsym(RTLD_DEFAULT, "kmp_set_blocktime"));
+  if (set_blocktime != nullptr) {
+    // in ms
+    set_blocktime(spin_wait ? 200 : 0);
+    return;
+  }
+#endif
+  LOG_FIRST_N(WARNING, 1)
+      << "The OpenMP runtime can not set the wait policy of its threads, "
+         "set OMP_WAIT_POLICY=" << (spin_wait ? "ACTIVE" : "PASSIVE")
+      << " before the process starts instead.";
+}
+
 }  // namespace platform
 }  // namespace paddle
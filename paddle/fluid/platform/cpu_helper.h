@@ -16,11 +16,21 @@ limitations under the License. */
 
 #include <stddef.h>
 
+#include <vector>
+
 namespace paddle {
 namespace platform {
 
 //! Set the number of threads in use.
 void SetNumThreads(int num_threads);
 
+//! Pin the OpenMP threads of the calling thread to cpu_ids, one each, and
+//! set their number to cpu_ids.size(). The calling thread is pinned to
+//! cpu_ids[0].
+void BindThreadsToCpus(const std::vector<int>& cpu_ids);
+
+//! Whether the idle OpenMP threads of the calling thread spin or sleep.
+void SetThreadsSpinWait(bool spin_wait);
+
 }  // namespace platform
 }  // namespace paddle
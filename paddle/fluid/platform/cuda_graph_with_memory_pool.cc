@@ -18,6 +18,8 @@
 #include "paddle/fluid/memory/allocation/allocator_facade.h"
 #include "paddle/fluid/platform/device_event.h"
 #include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/generator.h"
+#include "paddle/phi/kernels/funcs/generator_graph_state.h"
 
 PD_DECLARE_bool(use_stream_safe_cuda_allocator);
 COMMON_DECLARE_bool(new_executor_use_cuda_graph);
@@ -26,6 +28,9 @@ namespace paddle {
 namespace platform {
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// the philox state of the graph being captured, graphs are captured one by one
+static std::shared_ptr<phi::funcs::GeneratorGraphState> capturing_philox_state;
+
 void InitCUDNNRelatedHandle(phi::GPUContext* dev_ctx) {
   dev_ctx->cudnn_workspace_handle().ResetWorkspace();
 
@@ -100,6 +105,10 @@ void BeginCUDAGraphCapture(phi::GPUPlace place,
     }
   }
 
+  // allocated before the capture, out of the memory pool of the graph
+  capturing_philox_state = std::make_shared<phi::funcs::GeneratorGraphState>(
+      *dev_ctx, phi::DefaultCUDAGenerator(place.GetDeviceId()).get());
+
   auto stream = dev_ctx->stream();
   CUDAGraph::BeginCapture(place, stream, mode);
 
@@ -182,6 +191,12 @@ std::unique_ptr<CUDAGraph> EndCUDAGraphCapture() {
       .ClearDeviceContextsRecords();
   dev_ctx->cudnn_workspace_handle().ResetWorkspace();
   dev_ctx->SetCUDAGraphAllocator(nullptr);
+
+  // each replay writes its philox seed and base offset before the launch
+  auto philox_state = std::move(capturing_philox_state);
+  philox_state->EndCapture();
+  CUDAGraph::AddPreLaunchCallbackDuringCapturing(
+      [philox_state] { philox_state->PrepareReplay(); });
   return CUDAGraph::EndCapture();
 }
 #endif
@@ -52,6 +52,8 @@ namespace dynload {
   __macro(cusparseSpMV);                  \
   __macro(cusparseSpMatGetSize);          \
   __macro(cusparseCsrSetPointers);        \
+  __macro(cusparseSpMatSetValues);        \
+  __macro(cusparseDnMatSetValues);        \
   __macro(cusparseSpGEMM_createDescr);    \
   __macro(cusparseSpGEMM_compute);        \
   __macro(cusparseSpGEMM_workEstimation); \
@@ -146,6 +146,25 @@ void ChromeTracingLogger::LogMemTraceEventNode(
       mem_node.CurrentReserved(),
       mem_node.PeakAllocated(),
       mem_node.PeakReserved());
+  // counter track of the memory of the place, drawn as a curve
+  output_file_stream_ << string_format(
+      std::string(
+          R"JSON(
+  {
+    "name": "Memory %s", "pid": %lld,
+    "ts": %lld,
+    "ph": "C",
+    "args": {
+      "allocated": %llu,
+      "reserved": %llu
+    }
+  },
+  )JSON"),
+      mem_node.Place().c_str(),
+      mem_node.ProcessId(),
+      nsToUs(mem_node.TimeStampNs()),
+      mem_node.CurrentAllocated(),
+      mem_node.CurrentReserved());
   pid_tid_set_.insert({mem_node.ProcessId(), mem_node.ThreadId()});
 }
 
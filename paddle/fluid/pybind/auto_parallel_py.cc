@@ -31,6 +31,7 @@
 #include "paddle/phi/common/reduce_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/device_context.h"
+#include "paddle/phi/core/distributed/auto_parallel/checkpoint_reader.h"
 #include "paddle/phi/core/distributed/auto_parallel/device_mesh.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_mapper.h"
@@ -755,6 +756,47 @@ void BindAutoParallel(py::module *m) {
       },
       py::return_value_policy::reference);
 
+  m->def(
+      "read_checkpoint_slices",
+      [](const py::list &py_items, int num_threads) {
+        // each item is (file_path, byte_offset, storage_shape,
+        // storage_offsets, lengths, dst_tensor, dst_offsets)
+        std::vector<phi::distributed::CheckpointReadItem> items;
+        items.reserve(py_items.size());
+        for (auto &py_item : py_items) {
+          auto item_tuple = py_item.cast<py::tuple>();
+          PADDLE_ENFORCE_EQ(
+              item_tuple.size(),
+              7,
+              phi::errors::InvalidArgument(
+                  "The item of read_checkpoint_slices should have 7 fields, "
+                  "but got %d.",
+                  item_tuple.size()));
+          auto tensor = CastPyArg2Tensor(item_tuple[5].ptr(), 0);
+          PADDLE_ENFORCE_EQ(
+              phi::DenseTensor::classof(tensor.impl().get()) &&
+                  tensor.place().GetType() == phi::AllocationType::CPU,
+              true,
+              phi::errors::InvalidArgument(
+                  "The checkpoint slices can only be read into the dense "
+                  "tensors on CPU."));
+          phi::distributed::CheckpointReadItem item;
+          item.file_path = item_tuple[0].cast<std::string>();
+          item.byte_offset = item_tuple[1].cast<int64_t>();
+          item.storage_shape = item_tuple[2].cast<std::vector<int64_t>>();
+          item.storage_offsets = item_tuple[3].cast<std::vector<int64_t>>();
+          item.lengths = item_tuple[4].cast<std::vector<int64_t>>();
+          item.dst = static_cast<phi::DenseTensor *>(tensor.impl().get());
+          item.dst_offsets = item_tuple[6].cast<std::vector<int64_t>>();
+          items.emplace_back(std::move(item));
+        }
+        // the tensors stay alive in py_items
+        py::gil_scoped_release release;
+        phi::distributed::ReadCheckpointSlices(items, num_threads);
+      },
+      py::arg("items"),
+      py::arg("num_threads") = 1);
+
   // TODO(liuzhenhai): DistributedMapper is not used for now, but
   // dist_mapper_test need the symbols touch DistributedMapper to be linked,
   // remove it later
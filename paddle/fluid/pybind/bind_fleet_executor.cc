@@ -203,7 +203,8 @@ void BindFleetExecutor(py::module* m) {
       .def_readwrite("local_rank", &DistModelConfig::local_rank)
       .def_readwrite("ring_id_to_ranks", &DistModelConfig::ring_id_to_ranks_)
       .def_readwrite("rank_to_ring_ids", &DistModelConfig::rank_to_ring_ids_)
-      .def_readwrite("enable_timer", &DistModelConfig::enable_timer);
+      .def_readwrite("enable_timer", &DistModelConfig::enable_timer)
+      .def_readwrite("num_micro_batches", &DistModelConfig::num_micro_batches);
 
   py::class_<DistModel>(*m, "DistModel")
       .def(py::init<const DistModelConfig&>())
@@ -213,6 +214,13 @@ void BindFleetExecutor(py::module* m) {
              std::vector<DistModelTensor> outputs;
              self.Run(inputs, &outputs);
              return outputs;
+           })
+      .def("run_batch",
+           [](DistModel& self,
+              const std::vector<std::vector<DistModelTensor>>& inputs) {
+             std::vector<std::vector<DistModelTensor>> outputs;
+             self.Run(inputs, &outputs);
+             return outputs;
            });
 
   py::class_<DistModelDataBuf>(*m, "DistModelDataBuf")
@@ -395,6 +395,20 @@ void BindDataset(py::module *m) {
                     bool>())
       .def("_start", &IterableDatasetWrapper::Start)
       .def("_next", &IterableDatasetWrapper::Next);
+
+  m->def(
+      "convert_slot_record_to_columnar",
+      [](const std::string &data_feed_desc_str,
+         const std::string &text_file,
+         const std::string &columnar_file) {
+        framework::DataFeedDesc data_feed_desc;
+        google::protobuf::TextFormat::ParseFromString(data_feed_desc_str,
+                                                      &data_feed_desc);
+        framework::SlotRecordColumnarDataFeed feed;
+        feed.Init(data_feed_desc);
+        return feed.ConvertFile(text_file, columnar_file);
+      },
+      py::call_guard<py::gil_scoped_release>());
 }
 
 }  // namespace pybind
@@ -22,6 +22,7 @@ limitations under the License. */
 #endif
 
 #include "paddle/fluid/distributed/collective/process_group.h"
+#include "paddle/fluid/distributed/collective/param_gather_scheduler.h"
 #include "paddle/fluid/distributed/collective/reducer.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/tensor.h"
@@ -34,6 +35,7 @@ limitations under the License. */
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/fluid/distributed/collective/process_group_nccl.h"
+#include "paddle/phi/core/distributed/comm_telemetry.h"
 #endif
 
 #if defined(PADDLE_WITH_MPI)
@@ -126,18 +128,20 @@ void BindDistributed(py::module *m) {
               [](distributed::ProcessGroup &self,
                  py::handle py_tensor,
                  distributed::ReduceOp op,
-                 bool sync_op) {
+                 bool sync_op,
+                 bool hierarchical) {
                 auto tensor = CastPyArg2Tensor(py_tensor.ptr(), 0);
                 auto p_dense =
                     std::dynamic_pointer_cast<phi::DenseTensor>(tensor.impl());
                 auto *out_dense = p_dense.get();
                 auto in_dense = *p_dense;
-                distributed::AllreduceOptions opts{op};
+                distributed::AllreduceOptions opts{op, hierarchical};
                 return self.AllReduce(out_dense, in_dense, opts, sync_op);
               },
               py::arg("tensor"),
               py::arg("op"),
               py::arg("sync_op"),
+              py::arg("hierarchical") = false,
               py::call_guard<py::gil_scoped_release>())
 
           .def(
@@ -1238,7 +1242,68 @@ void BindDistributed(py::module *m) {
                   py::arg("nccl_comm_init_option") = 0,
                   py::call_guard<py::gil_scoped_release>())
       .def_static("group_start", distributed::ProcessGroupNCCL::GroupStart)
-      .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd);
+      .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd)
+      .def("start_coalescing",
+           &distributed::ProcessGroupNCCL::StartCoalescing,
+           py::call_guard<py::gil_scoped_release>())
+      .def("end_coalescing",
+           &distributed::ProcessGroupNCCL::EndCoalescing,
+           py::call_guard<py::gil_scoped_release>())
+      .def("is_coalescing", &distributed::ProcessGroupNCCL::IsCoalescing)
+      .def(
+          "hierarchical_all_reduce_stats",
+          [](distributed::ProcessGroupNCCL &self) {
+            auto stats = self.GetHierarchicalAllReduceStats();
+            py::dict result;
+            result["count"] = stats.count;
+            result["reduce_scatter_ms"] = stats.reduce_scatter_ms;
+            result["all_reduce_ms"] = stats.all_reduce_ms;
+            result["all_gather_ms"] = stats.all_gather_ms;
+            return result;
+          });
+
+  m->def("get_comm_telemetry", []() {
+    py::list result;
+    for (const auto &record :
+         phi::distributed::CommTelemetry::GetInstance().GetRecords()) {
+      py::dict item;
+      item["group_key"] = record.group_key;
+      item["global_rank"] = record.global_rank;
+      item["rank"] = record.rank;
+      item["nranks"] = record.size;
+      item["seq"] = record.seq;
+      item["op"] = phi::distributed::CommTypeToString(record.comm_type);
+      item["bytes"] = record.bytes;
+      item["start_us"] = record.start_us;
+      item["end_us"] = record.end_us;
+      item["algbw"] = record.algbw;
+      item["busbw"] = record.busbw;
+      result.append(item);
+    }
+    return result;
+  });
+
+  m->def(
+      "get_comm_skew",
+      [](const std::string &group_key) {
+        std::vector<phi::distributed::CommSkew> skews;
+        {
+          py::gil_scoped_release release;
+          skews = phi::distributed::CommTelemetry::GetInstance().GetSkew(
+              group_key);
+        }
+        py::list result;
+        for (const auto &skew : skews) {
+          py::dict item;
+          item["seq"] = skew.seq;
+          item["op"] = phi::distributed::CommTypeToString(skew.comm_type);
+          item["skew_us"] = skew.skew_us;
+          item["slowest_rank"] = skew.slowest_rank;
+          result.append(item);
+        }
+        return result;
+      },
+      py::arg("group_key"));
 
 #endif
 
@@ -1350,8 +1415,52 @@ void BindDistributed(py::module *m) {
             self.PrepareForBackward(params);
           },
           py::arg("tensors"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "register_comm_hook",
+          [](distributed::EagerReducer &self,
+             const std::string &hook_type,
+             int64_t matrix_approximation_rank,
+             int64_t start_step) {
+            self.SetCommHook(distributed::CreateEagerCommHook(
+                hook_type, matrix_approximation_rank, start_step));
+          },
+          py::arg("hook_type"),
+          py::arg("matrix_approximation_rank") = 1,
+          py::arg("start_step") = 10,
           py::call_guard<py::gil_scoped_release>());
 
+  py::class_<distributed::ParamGatherScheduler,
+             std::shared_ptr<distributed::ParamGatherScheduler>>(
+      *m, "ParamGatherScheduler", R"DOC()DOC")
+      .def(py::init<int64_t, int64_t>(),
+           py::arg("prefetch_layers") = 1,
+           py::arg("memory_budget") = 0)
+      .def("record_layer",
+           &distributed::ParamGatherScheduler::RecordLayer,
+           py::arg("layer_id"),
+           py::arg("gather_bytes"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("has_layer",
+           &distributed::ParamGatherScheduler::HasLayer,
+           py::arg("layer_id"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("schedule",
+           &distributed::ParamGatherScheduler::Schedule,
+           py::arg("layer_id"),
+           py::arg("forward") = true,
+           py::call_guard<py::gil_scoped_release>())
+      .def("release",
+           &distributed::ParamGatherScheduler::Release,
+           py::arg("layer_id"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("reset",
+           &distributed::ParamGatherScheduler::Reset,
+           py::call_guard<py::gil_scoped_release>())
+      .def("gathered_bytes",
+           &distributed::ParamGatherScheduler::GatheredBytes,
+           py::call_guard<py::gil_scoped_release>());
+
   py::class_<distributed::ProcessGroupIdMap,
              std::shared_ptr<distributed::ProcessGroupIdMap>>(
       *m, "ProcessGroupIdMap")
@@ -26,6 +26,7 @@ typedef SSIZE_T ssize_t;
 #include <vector>
 
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
+#include "paddle/fluid/eager/activation_offload.h"
 #include "paddle/fluid/eager/api/all.h"
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/backward.h"
@@ -974,6 +975,25 @@ static PyObject* eager_api_reset_saved_tensors_hooks(PyObject* self,
   EAGER_CATCH_AND_THROW_RETURN_NULL
 }
 
+static PyObject* eager_api_enable_activation_offload(PyObject* self,
+                                                     PyObject* args,
+                                                     PyObject* kwargs) {
+  EAGER_TRY
+  int64_t min_bytes = CastPyArg2AttrLong(PyTuple_GET_ITEM(args, 0), 0);
+  egr::ActivationOffloader::Instance().Enable(min_bytes);
+  RETURN_PY_NONE
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
+static PyObject* eager_api_disable_activation_offload(PyObject* self,
+                                                      PyObject* args,
+                                                      PyObject* kwargs) {
+  EAGER_TRY
+  egr::ActivationOffloader::Instance().Disable();
+  RETURN_PY_NONE
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
 #if defined(PADDLE_WITH_CUDA)
 static PyObject* eager_api_async_read(PyObject* self,
                                       PyObject* args,
@@ -1430,6 +1450,14 @@ PyMethodDef variable_functions[] = {  // NOLINT
      (PyCFunction)(void (*)())eager_api_reset_saved_tensors_hooks,
      METH_VARARGS | METH_KEYWORDS,
      nullptr},
+    {"enable_activation_offload",
+     (PyCFunction)(void (*)())eager_api_enable_activation_offload,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
+    {"disable_activation_offload",
+     (PyCFunction)(void (*)())eager_api_disable_activation_offload,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
     /**amp functions**/
     {"set_master_grads",
      (PyCFunction)(void (*)())eager_api_set_master_grads,
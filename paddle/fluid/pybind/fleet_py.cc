@@ -237,6 +237,8 @@ void BindGraphPyClient(py::module* m) {
       // .def("use_neighbors_sample_cache",
       //      &GraphPyClient::use_neighbors_sample_cache)
       .def("remove_graph_node", &GraphPyClient::remove_graph_node)
+      .def("begin_pass", &GraphPyClient::begin_pass)
+      .def("end_pass", &GraphPyClient::end_pass)
       .def("random_sample_nodes", &GraphPyClient::random_sample_nodes)
       .def("stop_server", &GraphPyClient::StopServer)
       .def("get_node_feat",
@@ -451,7 +453,11 @@ void BindIndexSampler(py::module* m) {
       }))
       .def("init_layerwise_conf", &IndexSampler::init_layerwise_conf)
       .def("init_beamsearch_conf", &IndexSampler::init_beamsearch_conf)
-      .def("sample", &IndexSampler::sample);
+      .def("sample", &IndexSampler::sample)
+      .def("set_thread_num", &IndexSampler::set_thread_num)
+      .def("sample_batch",
+           &IndexSampler::sample_batch,
+           py::call_guard<py::gil_scoped_release>());
 }
 }  // end namespace pybind
 }  // namespace paddle
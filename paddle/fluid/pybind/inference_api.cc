@@ -856,6 +856,12 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::memory_pool_init_size_mb)
       .def("fraction_of_gpu_memory_for_pool",
            &AnalysisConfig::fraction_of_gpu_memory_for_pool)
+      .def("set_gpu_memory_quota",
+           &AnalysisConfig::SetGpuMemoryQuota,
+           py::arg("quota_mb"),
+           py::arg("hard_quota") = true)
+      .def("gpu_memory_quota_mb", &AnalysisConfig::gpu_memory_quota_mb)
+      .def("gpu_memory_quota_hard", &AnalysisConfig::gpu_memory_quota_hard)
       .def("switch_ir_optim",
            &AnalysisConfig::SwitchIrOptim,
            py::arg("x") = true)
@@ -925,6 +931,17 @@ void BindAnalysisConfig(py::module *m) {
       .def("shape_range_info_path", &AnalysisConfig::shape_range_info_path)
       .def("shape_range_info_collected",
            &AnalysisConfig::shape_range_info_collected)
+      .def("set_input_shape_buckets",
+           &AnalysisConfig::SetInputShapeBuckets,
+           py::arg("input_name"),
+           py::arg("axis"),
+           py::arg("boundaries") = std::vector<int>())
+      .def("shape_bucketing_enabled", &AnalysisConfig::shape_bucketing_enabled)
+      .def("set_output_shape_bucket_axis",
+           &AnalysisConfig::SetOutputShapeBucketAxis,
+           py::arg("output_name"),
+           py::arg("input_name"),
+           py::arg("axis"))
       .def("enable_tuned_tensorrt_dynamic_shape",
            &AnalysisConfig::EnableTunedTensorRtDynamicShape,
            py::arg("shape_range_info_path") = "",
@@ -991,6 +1008,12 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::SetCpuMathLibraryNumThreads)
       .def("cpu_math_library_num_threads",
            &AnalysisConfig::cpu_math_library_num_threads)
+      .def("enable_cpu_core_binding",
+           &AnalysisConfig::EnableCpuCoreBinding,
+           py::arg("cpu_ids"),
+           py::arg("spin_wait") = false)
+      .def("cpu_core_binding_enabled",
+           &AnalysisConfig::cpu_core_binding_enabled)
       .def("to_native_config", &AnalysisConfig::ToNativeConfig)
       .def("enable_quantizer", &AnalysisConfig::EnableMkldnnQuantizer)
       .def("enable_mkldnn_bfloat16", &AnalysisConfig::EnableMkldnnBfloat16)
@@ -1044,6 +1067,12 @@ void BindAnalysisConfig(py::module *m) {
       .def("set_optimization_level",
            &AnalysisConfig::SetOptimizationLevel,
            py::arg("opt_level") = 2)
+      .def("enable_weight_only_quantization",
+           &AnalysisConfig::EnableWeightOnlyQuantization,
+           py::arg("algo") = "weight_only_int8",
+           py::arg("group_size") = -1)
+      .def("weight_only_quantization_enabled",
+           &AnalysisConfig::weight_only_quantization_enabled)
       .def("nnadapter", &AnalysisConfig::NNAdapter)
       .def("set_dist_config", &AnalysisConfig::SetDistConfig)
       .def("dist_config", &AnalysisConfig::dist_config);
@@ -1160,6 +1189,7 @@ void BindAnalysisPredictor(py::module *m) {
       .def("clear_intermediate_tensor",
            &AnalysisPredictor::ClearIntermediateTensor)
       .def("try_shrink_memory", &AnalysisPredictor::TryShrinkMemory)
+      .def("get_memory_stats", &AnalysisPredictor::GetMemoryStats)
       .def("create_feed_fetch_var", &AnalysisPredictor::CreateFeedFetchVar)
       .def("prepare_feed_fetch", &AnalysisPredictor::PrepareFeedFetch)
       .def("prepare_argument", &AnalysisPredictor::PrepareArgument)
@@ -1223,6 +1253,7 @@ void BindPaddleInferPredictor(py::module *m) {
            })
 #endif
       .def("try_shrink_memory", &paddle_infer::Predictor::TryShrinkMemory)
+      .def("get_memory_stats", &paddle_infer::Predictor::GetMemoryStats)
       .def("clear_intermediate_tensor",
            &paddle_infer::Predictor::ClearIntermediateTensor)
       .def("register_output_hook", &paddle_infer::Predictor::RegisterOutputHook)
@@ -14,7 +14,9 @@ limitations under the License. */
 
 #include "paddle/fluid/pybind/io.h"
 
+#include "paddle/fluid/framework/async_checkpoint.h"
 #include "paddle/fluid/framework/io/save_load_tensor.h"
+#include "paddle/fluid/framework/io/tensor_checkpoint.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/selected_rows_utils.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
@@ -123,6 +125,70 @@ void BindIO(pybind11::module *m) {
     paddle::framework::LoadTensor(path, &tensor_load);
     return tensor_load;
   });
+  m->def(
+      "save_tensor_checkpoint",
+      [](const std::string &path,
+         const std::vector<std::string> &names,
+         const std::vector<phi::DenseTensor> &tensors,
+         int thread_num) {
+        std::vector<const phi::DenseTensor *> ptrs;
+        ptrs.reserve(tensors.size());
+        for (auto &tensor : tensors) {
+          ptrs.push_back(&tensor);
+        }
+        py::gil_scoped_release release;
+        paddle::framework::SaveTensorCheckpoint(path, names, ptrs, thread_num);
+      },
+      py::arg("path"),
+      py::arg("names"),
+      py::arg("tensors"),
+      py::arg("thread_num") = 0);
+  m->def(
+      "load_tensor_checkpoint",
+      [](const std::string &path, int thread_num) {
+        py::gil_scoped_release release;
+        return paddle::framework::LoadTensorCheckpoint(path, thread_num);
+      },
+      py::arg("path"),
+      py::arg("thread_num") = 0);
+  m->def("is_tensor_checkpoint", &paddle::framework::IsTensorCheckpoint);
+  m->def(
+      "async_save_tensor_checkpoint",
+      [](const std::string &path,
+         const std::vector<std::string> &names,
+         const std::vector<phi::DenseTensor> &tensors) {
+        std::vector<const phi::DenseTensor *> ptrs;
+        ptrs.reserve(tensors.size());
+        for (auto &tensor : tensors) {
+          ptrs.push_back(&tensor);
+        }
+        py::gil_scoped_release release;
+        return paddle::framework::AsyncCheckpointSaver::Instance().Save(
+            path, names, ptrs);
+      },
+      py::arg("path"),
+      py::arg("names"),
+      py::arg("tensors"));
+  m->def(
+      "wait_async_checkpoint",
+      [](int64_t id) {
+        py::gil_scoped_release release;
+        paddle::framework::AsyncCheckpointSaver::Instance().Wait(id);
+      },
+      py::arg("id"));
+  m->def("wait_all_async_checkpoints", []() {
+    py::gil_scoped_release release;
+    paddle::framework::AsyncCheckpointSaver::Instance().WaitAll();
+  });
+  m->def(
+      "async_checkpoint_status",
+      [](int64_t id) {
+        std::string error;
+        auto &saver = paddle::framework::AsyncCheckpointSaver::Instance();
+        bool done = saver.IsDone(id, &error);
+        return std::make_pair(done, error);
+      },
+      py::arg("id"));
   m->def("serialize_pir_program",
          &pir::WriteModule,
          py::arg("program"),
@@ -130,7 +196,8 @@ void BindIO(pybind11::module *m) {
          py::arg("pir_version"),
          py::arg("overwrite") = true,
          py::arg("readable") = false,
-         py::arg("trainable") = true);
+         py::arg("trainable") = true,
+         py::arg("binary") = false);
   m->def("deserialize_pir_program", &pir::ReadModule);
 }
 }  // namespace pybind
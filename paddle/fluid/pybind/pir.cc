@@ -16,6 +16,8 @@
 
 #include <Python.h>
 #include <algorithm>
+#include <chrono>  // NOLINT
+#include <future>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -71,6 +73,7 @@
 #ifdef PADDLE_WITH_CINN
 #include "paddle/cinn/hlir/dialect/operator/ir/op_dialect.h"
 #include "paddle/cinn/hlir/dialect/operator/transforms/add_cinn_pass.h"
+#include "paddle/cinn/hlir/dialect/runtime/ir/jit_kernel_op.h"
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
 #endif
 
@@ -1880,6 +1883,41 @@ void ApplyCinnPass(Program &program) {  // NOLINT
 #endif
 }
 
+#ifdef PADDLE_WITH_CINN
+bool IsCinnCompiled(pir::Block &block) {  // NOLINT
+  for (auto &op : block) {
+    if (op.isa<cinn::dialect::JitKernelOp>()) {
+      const auto &async_fn_ptrs = op.dyn_cast<cinn::dialect::JitKernelOp>()
+                                      .cinn_kernel_info()
+                                      .async_fn_ptrs;
+      if (async_fn_ptrs.valid() &&
+          async_fn_ptrs.wait_for(std::chrono::seconds(0)) !=
+              std::future_status::ready) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < op.num_regions(); ++i) {
+      for (auto &inner_block : op.region(i)) {
+        if (!IsCinnCompiled(inner_block)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+#endif
+
+// Whether every CINN kernel of the program is compiled, false while some are
+// still compiled in the background, see FLAGS_cinn_async_compile.
+bool IsCinnCompiled(Program &program) {  // NOLINT
+#ifdef PADDLE_WITH_CINN
+  return IsCinnCompiled(*program.block());
+#else
+  return true;
+#endif
+}
+
 }  // namespace
 
 void InferSymbolicShapePass(
@@ -1895,6 +1933,9 @@ void InferSymbolicShapePass(
 
 void BindIrPass(pybind11::module *m) {
   m->def("apply_cinn_pass", ApplyCinnPass);
+  m->def("is_cinn_compiled", [](Program &program) {  // NOLINT
+    return IsCinnCompiled(program);
+  });
   m->def("infer_symbolic_shape_pass", InferSymbolicShapePass);
 
   py::class_<Pass, std::shared_ptr<Pass>> pass(*m,
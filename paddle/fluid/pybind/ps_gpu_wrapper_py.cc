@@ -65,6 +65,12 @@ void BindPSGPUWrapper(py::module* m) {
       .def("begin_pass",
            &framework::PSGPUWrapper::BeginPass,
            py::call_guard<py::gil_scoped_release>())
+      .def("wait_end_pass",
+           &framework::PSGPUWrapper::WaitEndPass,
+           py::call_guard<py::gil_scoped_release>())
+      .def("get_workspace_alloc_num",
+           &framework::PSGPUWrapper::GetWorkspaceAllocNum,
+           py::call_guard<py::gil_scoped_release>())
       .def("dump_to_mem",
            &framework::PSGPUWrapper::DumpToMem,
            py::call_guard<py::gil_scoped_release>())
@@ -40,6 +40,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/custom_operator.h"
 #include "paddle/fluid/framework/data_layout.h"
 #include "paddle/fluid/framework/data_type_transform.h"
+#include "paddle/fluid/framework/details/nan_inf_utils.h"
 #include "paddle/fluid/framework/details/nan_inf_utils_detail.h"
 #include "paddle/fluid/framework/executor.h"
 #include "paddle/fluid/framework/executor_cache.h"
@@ -74,6 +75,7 @@ limitations under the License. */
 #include "paddle/fluid/framework/version.h"
 #include "paddle/fluid/imperative/amp_auto_cast.h"
 #include "paddle/fluid/imperative/layer.h"
+#include "paddle/fluid/memory/allocation/allocation_tracer.h"
 #include "paddle/fluid/memory/allocation/allocator_strategy.h"
 #include "paddle/fluid/platform/bfloat16.h"
 #include "paddle/fluid/platform/float16.h"
@@ -133,6 +135,7 @@ limitations under the License. */
 #include "paddle/phi/backends/device_manager.h"
 #include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/core/lod_utils.h"
+#include "paddle/phi/core/metrics.h"
 #include "paddle/utils/none.h"
 
 #ifdef PADDLE_WITH_DISTRIBUTE
@@ -1014,20 +1017,19 @@ PYBIND11_MODULE(libpaddle, m) {
             "from_dlpack received an invalid capsule. "
             "Note that a DLPack tensor can be consumed only once."));
 
+    // the tensor owns dmt from now on, it shares the memory of the producer
     PyCapsule_SetName(dltensor->ptr(), "used_dltensor");
-    DLTensor dl = dmt->dl_tensor;
     phi::DenseTensor tensor;
+    paddle::framework::TensorFromDLPackNoCopy(dmt, &tensor);
+    return tensor;
+  });
 
-    if (dl.device.device_type == kDLCPU) {
-      paddle::framework::TensorFromDLPack(dmt, &tensor);
-    }
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-    if (dl.device.device_type == kDLGPU) {
-      paddle::framework::TensorFromDLPack(dmt, &tensor);
-    }
+  m.def("_dlpack_wait_stream",
+        [](const phi::DenseTensor &tensor, int64_t stream) {
+          paddle::framework::DLPackWaitStream(tensor, stream);
+        });
 #endif
-    return tensor;
-  });
 
   m.def("_create_loaded_parameter",
         [](const py::handle &vec_var_list,
@@ -2196,11 +2198,46 @@ All parameter, weight, gradient are variables in Paddle.
     }
     return stats_map;
   });
+  m.def("get_metrics",
+        []() { return phi::MetricsRegistry::Instance().ExportText(); });
   m.def("device_memory_stat_current_value",
         memory::DeviceMemoryStatCurrentValue);
   m.def("device_memory_stat_peak_value", memory::DeviceMemoryStatPeakValue);
   m.def("host_memory_stat_current_value", memory::HostMemoryStatCurrentValue);
   m.def("host_memory_stat_peak_value", memory::HostMemoryStatPeakValue);
+  m.def(
+      "enable_allocation_trace",
+      [](size_t capacity) {
+        memory::allocation::AllocationTracer::Instance().Enable(capacity);
+      },
+      py::arg("capacity"));
+  m.def("disable_allocation_trace", []() {
+    memory::allocation::AllocationTracer::Instance().Disable();
+  });
+  m.def("dump_allocation_trace", [](const std::string &path) {
+    memory::allocation::AllocationTracer::Instance().Dump(path);
+  });
+  m.def("replay_allocation_trace",
+        [](const std::string &path,
+           const std::string &strategy,
+           const platform::Place &place) {
+          std::vector<memory::allocation::AllocationEvent> events;
+          std::vector<std::string> op_names;
+          memory::allocation::LoadAllocationTrace(path, &events, &op_names);
+          auto result = memory::allocation::ReplayAllocationTrace(
+              events,
+              op_names,
+              place,
+              memory::allocation::CreateReplayAllocator(strategy, place));
+          py::dict res;
+          res["alloc_num"] = result.alloc_num;
+          res["failed_num"] = result.failed_num;
+          res["peak_allocated"] = result.peak_allocated;
+          res["peak_reserved"] = result.peak_reserved;
+          res["elapsed_ms"] = result.elapsed_ms;
+          res["first_failed_op"] = result.first_failed_op;
+          return res;
+        });
   m.def(
       "run_cmd",
       [](const std::string &cmd,
@@ -2953,6 +2990,10 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("set_nan_inf_debug_path",
         &paddle::framework::details::SetNanInfDebugPath);
 
+  // Add the api for the deferred nan/inf checks
+  m.def("check_deferred_nan_inf",
+        &paddle::framework::details::CheckDeferredNanInf);
+
   // Add check op lost
   m.def("set_checked_op_list",
         [](const std::string &op_list) { egr::SetCheckOpList(op_list); });
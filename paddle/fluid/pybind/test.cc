@@ -15,16 +15,24 @@
 #include "paddle/fluid/pybind/test.h"
 
 #include <Python.h>
+#include "pybind11/stl.h"
+
 #include "paddle/fluid/sub_graph/sub_graph_checker.h"
 
 namespace py = pybind11;
 
 namespace paddle::pybind {
+using paddle::test::GroupSpeed;
 using paddle::test::SubGraphChecker;
 using pir::Program;
 
 void BindTest(pybind11::module* module) {
   auto test_module = module->def_submodule("test");
+  py::class_<GroupSpeed>(*test_module, "GroupSpeed")
+      .def_readonly("fingerprint", &GroupSpeed::fingerprint)
+      .def_readonly("op_names", &GroupSpeed::op_names)
+      .def_readonly("phi_time", &GroupSpeed::phi_time)
+      .def_readonly("cinn_time", &GroupSpeed::cinn_time);
   py::class_<SubGraphChecker, std::shared_ptr<SubGraphChecker>>
       subgraph_checker(
           *test_module,
@@ -40,7 +48,15 @@ void BindTest(pybind11::module* module) {
       .def("check_result",
            [](std::shared_ptr<SubGraphChecker> self) { self->CheckResult(); })
       .def("check_speed",
-           [](std::shared_ptr<SubGraphChecker> self) { self->CheckSpeed(); });
+           [](std::shared_ptr<SubGraphChecker> self) { self->CheckSpeed(); })
+      .def("check_group_speed",
+           [](std::shared_ptr<SubGraphChecker> self) {
+             return self->CheckGroupSpeed();
+           })
+      .def_static("deny_group_list",
+                  &SubGraphChecker::DenyGroupList,
+                  py::arg("speeds"),
+                  py::arg("tolerance") = 0.05);
 }
 
 }  // namespace paddle::pybind
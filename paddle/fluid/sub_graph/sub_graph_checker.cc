@@ -32,6 +32,8 @@
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/pir/dialect/operator/utils/utils.h"
 #include "paddle/fluid/pir/transforms/build_cinn_pass.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/ir_mapping.h"
 #include "paddle/pir/include/core/operation_utils.h"
 #include "paddle/pir/include/pass/pass.h"
 #include "paddle/pir/include/pass/pass_manager.h"
@@ -311,6 +313,155 @@ double SubGraphChecker::RunCinnSpeed() {
   return elapsed_seconds.count();
 }
 
+std::vector<GroupSpeed> SubGraphChecker::CheckGroupSpeed() {
+  ::pir::IrContext* ctx = ::pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<cinn::dialect::OperatorDialect>();
+
+  pir::IrMapping ir_mapping;
+  auto program = prim_program_->Clone(ir_mapping);
+  pir::PassManager pm(ctx);
+  pm.AddPass(cinn::dialect::ir::CreatePdOpToCinnOpPass());
+  pm.AddPass(cinn::dialect::ir::CreateAddBroadcastToElementwisePass());
+  pm.AddPass(pir::CreateBuildCinnPass(std::unordered_set<std::string>{}));
+  pm.Run(program.get());
+
+  std::vector<GroupSpeed> speeds;
+  for (auto& op : *program->block()) {
+    if (!op.isa<cinn::dialect::GroupOp>()) {
+      continue;
+    }
+    auto group_block = op.dyn_cast<cinn::dialect::GroupOp>().block();
+    std::vector<pir::Operation*> group_ops;
+    GroupSpeed speed;
+    for (auto& inner_op : *group_block) {
+      if (inner_op.isa<pir::YieldOp>()) {
+        continue;
+      }
+      group_ops.push_back(&inner_op);
+      speed.op_names.push_back(inner_op.name());
+    }
+    speed.fingerprint = pir::CinnGroupFingerprint(group_ops);
+
+    std::vector<pir::Value> input_values;
+    auto group_program = ExtractGroup(group_block, &input_values);
+    paddle::framework::Scope scope;
+    InitInputs(input_values, group_program->block(), &scope);
+    speed.cinn_time =
+        RunGroupSpeed(*group_program, {}, input_values.size(), &scope);
+    speed.phi_time = RunGroupSpeed(
+        *group_program, {speed.fingerprint}, input_values.size(), &scope);
+
+    LOG(INFO) << "group " << speed.fingerprint << " with "
+              << group_ops.size() << " ops, time cost: Phi: "
+              << speed.phi_time << "\tCINN : " << speed.cinn_time;
+    speeds.push_back(std::move(speed));
+  }
+  return speeds;
+}
+
+std::string SubGraphChecker::DenyGroupList(
+    const std::vector<GroupSpeed>& speeds, double tolerance) {
+  std::string deny_list;
+  for (auto& speed : speeds) {
+    if (speed.cinn_time <= speed.phi_time * (1.0 + tolerance)) {
+      continue;
+    }
+    if (!deny_list.empty()) {
+      deny_list += ";";
+    }
+    deny_list += speed.fingerprint;
+  }
+  return deny_list;
+}
+
+std::shared_ptr<pir::Program> SubGraphChecker::ExtractGroup(
+    pir::Block* group_block, std::vector<pir::Value>* input_values) {
+  ::pir::IrContext* ctx = ::pir::IrContext::Instance();
+  auto program = std::make_shared<::pir::Program>(ctx);
+  ::pir::Builder builder = ::pir::Builder(ctx, program->block());
+
+  // the values defined out of the group are read from the parameters
+  pir::IrMapping ir_mapping;
+  auto group_inputs = GetBlockInput(group_block);
+  for (size_t i = 0; i < group_inputs.size(); ++i) {
+    auto param = builder
+                     .Build<pir::ParameterOp>(kInputPrefix + std::to_string(i),
+                                              group_inputs[i].type())
+                     .result(0);
+    ir_mapping.Add(group_inputs[i], param);
+    input_values->push_back(param);
+  }
+
+  auto clone_options = pir::CloneOptions(true, true, false);
+  for (auto& op : *group_block) {
+    if (op.isa<pir::YieldOp>()) {
+      for (size_t i = 0; i < op.num_operands(); ++i) {
+        builder.Build<paddle::dialect::FetchOp>(
+            ir_mapping.Lookup(op.operand_source(i)),
+            kOutputPrefix + std::to_string(i),
+            i);
+      }
+      continue;
+    }
+    program->block()->push_back(op.Clone(ir_mapping, clone_options));
+  }
+  return program;
+}
+
+double SubGraphChecker::RunGroupSpeed(
+    const pir::Program& program,
+    const std::unordered_set<std::string>& denied_groups,
+    size_t num_inputs,
+    paddle::framework::Scope* scope) {
+  ::pir::IrContext* ctx = ::pir::IrContext::Instance();
+  pir::IrMapping ir_mapping;
+  auto group_program = program.Clone(ir_mapping);
+
+  pir::PassManager pm(ctx);
+  pm.AddPass(pir::CreateBuildCinnPass(denied_groups));
+  pm.AddPass(cinn::dialect::ir::CreateDivideGroupOpToFusionOpPass());
+  pm.AddPass(cinn::dialect::ir::CreateLowerCinnFusionOpPass());
+  pm.Run(group_program.get());
+
+  paddle::platform::Place place = paddle::platform::CUDAPlace(0);
+  auto kernel_program =
+      paddle::dialect::PdOpLowerToKernelPass(group_program.get(), place);
+
+  std::vector<std::string> fetch_var_names;
+  for (auto& op : *group_program->block()) {
+    if (op.isa<paddle::dialect::FetchOp>()) {
+      fetch_var_names.push_back(
+          op.attribute("name").dyn_cast<pir::StrAttribute>().AsString() +
+          kFetchSuffix);
+    }
+  }
+
+  paddle::framework::interpreter::ExecutionConfig exec_config;
+  exec_config.create_local_scope = false;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    std::string name = kInputPrefix + std::to_string(i);
+    exec_config.skip_gc_vars.insert(name);
+  }
+
+  paddle::framework::InterpreterCore executor(
+      place, fetch_var_names, kernel_program->block(), scope, exec_config);
+  // warm up
+  for (size_t i = 0; i < 10; ++i) {
+    executor.Run({}, true);
+  }
+
+  auto start = std::chrono::system_clock::now();
+  for (size_t i = 0; i < 1000; ++i) {
+    executor.Run({}, true);
+  }
+  auto end = std::chrono::system_clock::now();
+
+  std::chrono::duration<double> elapsed_seconds = end - start;
+
+  return elapsed_seconds.count();
+}
+
 void SubGraphChecker::RemoveFetchOp(pir::Block* block) {
   for (auto it = block->begin(); it != block->end();) {
     if (it->isa<paddle::dialect::FetchOp>()) {
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/pir/include/core/program.h"
 
@@ -24,6 +28,15 @@ constexpr char kInputPrefix[] = "pt_input_";
 constexpr char kOutputPrefix[] = "pt_output_";
 constexpr char kFetchSuffix[] = "@fetch";
 
+// The time of a group built by build_cinn_pass, fused by CINN and denied,
+// i.e. its pd ops run by the phi kernels.
+struct GroupSpeed {
+  std::string fingerprint;
+  std::vector<std::string> op_names;
+  double phi_time;
+  double cinn_time;
+};
+
 class SubGraphChecker {
  public:
   SubGraphChecker(std::shared_ptr<pir::Program> orig_program,
@@ -33,6 +46,14 @@ class SubGraphChecker {
 
   std::vector<double> CheckSpeed();
 
+  // Times each group of prim_program on the shapes of its inputs.
+  std::vector<GroupSpeed> CheckGroupSpeed();
+
+  // Returns the fingerprints of the groups slower than the phi kernels by
+  // more than `tolerance`, joined as FLAGS_deny_cinn_groups expects.
+  static std::string DenyGroupList(const std::vector<GroupSpeed>& speeds,
+                                   double tolerance = 0.05);
+
  private:
   void InitInputs(const std::vector<pir::Value>& input_values,
                   pir::Block* block,
@@ -50,6 +71,14 @@ class SubGraphChecker {
 
   double RunPhiSpeed();
   double RunCinnSpeed();
+
+  std::shared_ptr<pir::Program> ExtractGroup(
+      pir::Block* group_block, std::vector<pir::Value>* input_values);
+  double RunGroupSpeed(const pir::Program& program,
+                       const std::unordered_set<std::string>& denied_groups,
+                       size_t num_inputs,
+                       paddle::framework::Scope* scope);
+
   std::shared_ptr<pir::Program> phi_program_;
   std::shared_ptr<pir::Program> prim_program_;
 
@@ -79,6 +79,9 @@ class TEST_API RecordEvent {
                          const EventRole role,
                          const std::string& attr);
 
+  // Starts timing the event for OpStatsSampler if it is sampled.
+  void StartSample(const char* name, const TracerEventType type);
+
   bool is_enabled_{false};
   bool is_pushed_{false};
   // Event name
@@ -92,6 +95,9 @@ class TEST_API RecordEvent {
   TracerEventType type_{TracerEventType::UserDefined};
   std::string* attr_{nullptr};
   bool finished_{false};
+  // The name of the event if it is sampled by OpStatsSampler.
+  std::string* sample_name_{nullptr};
+  uint64_t sample_start_ns_{0};
 };
 
 }  // namespace phi
@@ -0,0 +1,203 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/api/profiler/op_stats_sampler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#include "glog/logging.h"
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/os_info.h"
+
+COMMON_DECLARE_int32(op_stats_sample_interval);
+COMMON_DECLARE_string(op_stats_output_path);
+COMMON_DECLARE_int32(op_stats_flush_interval_s);
+
+namespace phi {
+
+namespace {
+
+std::string EscapeJson(const std::string& str) {
+  std::string escaped;
+  escaped.reserve(str.size());
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped.push_back('\\');
+    }
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+double Percentile(const std::vector<uint64_t>& sorted, double p) {
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+}  // namespace
+
+bool OpStatsSampler::SampleRing::Push(std::string&& name,
+                                      uint64_t duration_ns) {
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) >= kCapacity) {
+    return false;
+  }
+  auto& slot = slots_[tail % kCapacity];
+  slot.name = std::move(name);
+  slot.duration_ns = duration_ns;
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename Visitor>
+void OpStatsSampler::SampleRing::PopAll(Visitor&& visitor) {
+  size_t head = head_.load(std::memory_order_relaxed);
+  size_t tail = tail_.load(std::memory_order_acquire);
+  for (size_t i = head; i < tail; ++i) {
+    visitor(&slots_[i % kCapacity]);
+  }
+  head_.store(tail, std::memory_order_release);
+}
+
+OpStatsSampler& OpStatsSampler::GetInstance() {
+  static OpStatsSampler instance;
+  return instance;
+}
+
+OpStatsSampler::~OpStatsSampler() {
+  if (!flush_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(stop_mutex_);
+    stop_ = true;
+  }
+  stop_cv_.notify_all();
+  flush_thread_.join();
+  Flush();
+}
+
+std::shared_ptr<OpStatsSampler::SampleRing>
+OpStatsSampler::GetThreadLocalRing() {
+  // The sampler also holds the ring, so the samples of a thread are still
+  // flushed after the thread exits.
+  thread_local std::shared_ptr<SampleRing> ring;
+  if (ring == nullptr) {
+    ring = std::make_shared<SampleRing>();
+    std::lock_guard<std::mutex> guard(rings_mutex_);
+    rings_.push_back(ring);
+  }
+  return ring;
+}
+
+void OpStatsSampler::AddSample(std::string&& name, uint64_t duration_ns) {
+  std::call_once(start_flag_, [this] { StartFlushThread(); });
+  if (!GetThreadLocalRing()->Push(std::move(name), duration_ns)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void OpStatsSampler::StartFlushThread() {
+  // Read the flags once, they may be destroyed before the sampler at exit.
+  sample_interval_ = FLAGS_op_stats_sample_interval;
+  flush_interval_s_ = std::max(FLAGS_op_stats_flush_interval_s, 1);
+  output_path_ = FLAGS_op_stats_output_path;
+  if (output_path_.empty()) {
+    output_path_ = "op_stats." + std::to_string(GetProcessId()) + ".jsonl";
+  }
+  VLOG(1) << "Sample 1 in every " << sample_interval_
+          << " operator events, and write the statistics to " << output_path_
+          << " every " << flush_interval_s_ << " seconds.";
+  flush_thread_ = std::thread([this] { FlushLoop(); });
+}
+
+void OpStatsSampler::FlushLoop() {
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  while (!stop_) {
+    stop_cv_.wait_for(lock, std::chrono::seconds(flush_interval_s_), [this] {
+      return stop_;
+    });
+    if (!stop_) {
+      lock.unlock();
+      Flush();
+      lock.lock();
+    }
+  }
+}
+
+void OpStatsSampler::Flush() {
+  std::lock_guard<std::mutex> flush_guard(flush_mutex_);
+  std::unordered_map<std::string, std::vector<uint64_t>> durations;
+  {
+    std::lock_guard<std::mutex> guard(rings_mutex_);
+    for (auto& ring : rings_) {
+      ring->PopAll([&durations](Sample* sample) {
+        durations[sample->name].push_back(sample->duration_ns);
+      });
+    }
+    // Release the rings of the exited threads.
+    rings_.erase(std::remove_if(rings_.begin(),
+                                rings_.end(),
+                                [](const std::shared_ptr<SampleRing>& ring) {
+                                  return ring.use_count() == 1 &&
+                                         ring->Empty();
+                                }),
+                 rings_.end());
+  }
+  uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+  if (durations.empty() && dropped == 0) {
+    return;
+  }
+
+  std::ostringstream line;
+  line << "{\"timestamp_ns\": " << PosixInNsec()
+       << ", \"pid\": " << GetProcessId()
+       << ", \"sample_interval\": " << sample_interval_
+       << ", \"dropped_samples\": " << dropped << ", \"ops\": [";
+  bool first = true;
+  for (auto& item : durations) {
+    auto& samples = item.second;
+    std::sort(samples.begin(), samples.end());
+    uint64_t total_ns = 0;
+    for (auto duration : samples) {
+      total_ns += duration;
+    }
+    line << (first ? "" : ", ") << "{\"name\": \"" << EscapeJson(item.first)
+         << "\", \"samples\": " << samples.size()
+         << ", \"estimated_count\": " << samples.size() * sample_interval_
+         << ", \"mean_us\": "
+         << static_cast<double>(total_ns) / samples.size() / 1000.0
+         << ", \"p50_us\": " << Percentile(samples, 0.5)
+         << ", \"p99_us\": " << Percentile(samples, 0.99)
+         << ", \"max_us\": " << static_cast<double>(samples.back()) / 1000.0
+         << "}";
+    first = false;
+  }
+  line << "]}\n";
+
+  std::ofstream out(output_path_, std::ios::app);
+  if (!out) {
+    LOG_FIRST_N(WARNING, 1) << "Failed to open " << output_path_
+                            << " to write the operator statistics.";
+    return;
+  }
+  out << line.str();
+}
+
+}  // namespace phi
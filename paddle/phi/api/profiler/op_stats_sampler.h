@@ -0,0 +1,114 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "paddle/common/macros.h"
+
+namespace phi {
+
+// Always-on sampling of operator events for long running jobs, where the
+// full profiler is too heavy to be left on.
+//
+// When FLAGS_op_stats_sample_interval is N > 0, RecordEvent times 1 in every
+// N operator events of every thread. The sampled host times are pushed into
+// a bounded ring buffer of the thread, and a background thread aggregates
+// them into per-op statistics, i.e. the count, the p50, p99 and max time,
+// and appends them as a JSON line to FLAGS_op_stats_output_path every
+// FLAGS_op_stats_flush_interval_s seconds.
+class OpStatsSampler {
+ public:
+  static OpStatsSampler& GetInstance();
+
+  // Returns true for 1 in every `interval` calls of the calling thread.
+  static bool ShouldSample(int interval) {
+    thread_local int counter = 0;
+    if (++counter < interval) {
+      return false;
+    }
+    counter = 0;
+    return true;
+  }
+
+  // thread-safe, never blocks. The sample is dropped if the ring buffer of
+  // the calling thread is full.
+  void AddSample(std::string&& name, uint64_t duration_ns);
+
+  // Aggregates the samples collected since the last flush and appends the
+  // statistics to the output file.
+  void Flush();
+
+  ~OpStatsSampler();
+
+ private:
+  struct Sample {
+    std::string name;
+    uint64_t duration_ns;
+  };
+
+  // Single producer, the recording thread, and single consumer, the flush.
+  class SampleRing {
+   public:
+    static constexpr size_t kCapacity = 4096;
+
+    SampleRing() : slots_(kCapacity) {}
+
+    bool Push(std::string&& name, uint64_t duration_ns);
+
+    template <typename Visitor>
+    void PopAll(Visitor&& visitor);
+
+    bool Empty() const {
+      return head_.load(std::memory_order_acquire) ==
+             tail_.load(std::memory_order_acquire);
+    }
+
+   private:
+    std::vector<Sample> slots_;
+    std::atomic<size_t> head_{0};
+    std::atomic<size_t> tail_{0};
+  };
+
+  OpStatsSampler() = default;
+  DISABLE_COPY_AND_ASSIGN(OpStatsSampler);
+
+  std::shared_ptr<SampleRing> GetThreadLocalRing();
+  void StartFlushThread();
+  void FlushLoop();
+
+  std::mutex rings_mutex_;
+  std::vector<std::shared_ptr<SampleRing>> rings_;
+  std::atomic<uint64_t> dropped_{0};
+
+  std::once_flag start_flag_;
+  std::mutex flush_mutex_;
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_{false};
+  std::thread flush_thread_;
+  std::string output_path_;
+  int sample_interval_{1};
+  int flush_interval_s_{60};
+};
+
+}  // namespace phi
@@ -22,10 +22,12 @@ limitations under the License. */
 
 #include "glog/logging.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/api/profiler/common_event.h"
 #include "paddle/phi/api/profiler/device_tracer.h"
 #include "paddle/phi/api/profiler/host_event_recorder.h"
 #include "paddle/phi/api/profiler/host_tracer.h"
+#include "paddle/phi/api/profiler/op_stats_sampler.h"
 #include "paddle/phi/api/profiler/profiler_helper.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/os_info.h"
@@ -33,6 +35,8 @@ limitations under the License. */
 #include "paddle/phi/backends/dynload/nvtx.h"
 #endif
 
+COMMON_DECLARE_int32(op_stats_sample_interval);
+
 PHI_DEFINE_bool(enable_host_event_recorder_hook,
                 false,
                 "enable HostEventRecorder, hook Profiler");
@@ -100,6 +104,9 @@ RecordEvent::RecordEvent(const char *name,
                          const TracerEventType type,
                          uint32_t level,
                          const EventRole role) {
+  if (UNLIKELY(FLAGS_op_stats_sample_interval > 0)) {
+    StartSample(name, type);
+  }
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
   if (ProfilerHelper::g_enable_nvprof_hook) {
@@ -134,6 +141,9 @@ RecordEvent::RecordEvent(const std::string &name,
                          const TracerEventType type,
                          uint32_t level,
                          const EventRole role) {
+  if (UNLIKELY(FLAGS_op_stats_sample_interval > 0)) {
+    StartSample(name.c_str(), type);
+  }
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
   if (ProfilerHelper::g_enable_nvprof_hook) {
@@ -167,6 +177,9 @@ RecordEvent::RecordEvent(const std::string &name,
                          const TracerEventType type,
                          uint32_t level,
                          const EventRole role) {
+  if (UNLIKELY(FLAGS_op_stats_sample_interval > 0)) {
+    StartSample(name.c_str(), type);
+  }
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
   if (ProfilerHelper::g_enable_nvprof_hook) {
@@ -215,7 +228,21 @@ void RecordEvent::OriginalConstruct(const std::string &name,
   *name_ = e->name();
 }
 
+void RecordEvent::StartSample(const char *name, const TracerEventType type) {
+  if (type == TracerEventType::Operator &&
+      OpStatsSampler::ShouldSample(FLAGS_op_stats_sample_interval)) {
+    sample_name_ = new std::string(name);
+    sample_start_ns_ = PosixInNsec();
+  }
+}
+
 void RecordEvent::End() {
+  if (UNLIKELY(sample_name_ != nullptr)) {
+    OpStatsSampler::GetInstance().AddSample(std::move(*sample_name_),
+                                            PosixInNsec() - sample_start_ns_);
+    delete sample_name_;
+    sample_name_ = nullptr;
+  }
 #ifndef _WIN32
 #ifdef PADDLE_WITH_CUDA
   if (ProfilerHelper::g_enable_nvprof_hook && is_pushed_) {
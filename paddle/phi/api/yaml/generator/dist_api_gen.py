@@ -98,8 +98,9 @@ OPTIONAL_VECTOR_DIST_META_IN_TEMPLATE = """
         }}
     }}"""
 INFER_SPMD_TEMPLATE = """
-    auto spmd_info = phi::distributed::{}({});
-    DebugInfoForInferSpmd("{}", spmd_info);
+    auto spmd_info = phi::distributed::CachedInferSpmd(
+        "{2}", [&]() {{ return phi::distributed::{0}({1}); }}, {1});
+    DebugInfoForInferSpmd("{2}", spmd_info);
 """
 GENERAL_INFER_SPMD_TEMPLATE = """
     auto spmd_info = phi::distributed::VariadicReplicatedInferSpmdDynamic({});
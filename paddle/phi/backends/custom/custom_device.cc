@@ -434,10 +434,15 @@ class CustomDevice : public DeviceInterface {
   void MemorySet(size_t dev_id,
                  void* ptr,
                  uint8_t value,
-                 size_t size) override {
+                 size_t size,
+                 const stream::Stream* stream = nullptr) override {
     const auto device = &devices_pool[dev_id];
 
-    if (pimpl_->device_memory_set) {
+    if (stream && stream->raw_stream() && pimpl_->async_device_memory_set) {
+      C_Stream c_stream = reinterpret_cast<C_Stream>(stream->raw_stream());
+      PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->async_device_memory_set(
+          device, c_stream, ptr, value, size));
+    } else if (pimpl_->device_memory_set) {
       PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
           pimpl_->device_memory_set(device, ptr, value, size));
     } else {
@@ -447,6 +452,42 @@ class CustomDevice : public DeviceInterface {
     }
   }
 
+  bool IsStreamOrderedAllocatorSupported(size_t dev_id) override {
+    return pimpl_->async_device_memory_allocate &&
+           pimpl_->async_device_memory_deallocate;
+  }
+
+  void* MemoryAllocateAsync(size_t dev_id,
+                            size_t size,
+                            const stream::Stream* stream) override {
+    void* ptr = nullptr;
+    const auto device = &devices_pool[dev_id];
+    C_Stream c_stream = reinterpret_cast<C_Stream>(stream->raw_stream());
+
+    if (!IsStreamOrderedAllocatorSupported(dev_id)) {
+      PADDLE_THROW(phi::errors::Unavailable(
+          "MemoryAllocateAsync is not supported on %s.", Type()));
+    }
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
+        pimpl_->async_device_memory_allocate(device, c_stream, &ptr, size));
+    return ptr;
+  }
+
+  void MemoryDeallocateAsync(size_t dev_id,
+                             void* ptr,
+                             size_t size,
+                             const stream::Stream* stream) override {
+    const auto device = &devices_pool[dev_id];
+    C_Stream c_stream = reinterpret_cast<C_Stream>(stream->raw_stream());
+
+    if (!IsStreamOrderedAllocatorSupported(dev_id)) {
+      PADDLE_THROW(phi::errors::Unavailable(
+          "MemoryDeallocateAsync is not supported on %s.", Type()));
+    }
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
+        pimpl_->async_device_memory_deallocate(device, c_stream, ptr, size));
+  }
+
   void MemoryStats(size_t dev_id, size_t* total, size_t* free) override {
     if (pimpl_->device_memory_stats) {
       const auto device = &devices_pool[dev_id];
@@ -1006,6 +1047,9 @@ bool ValidCustomCustomRuntimeParams(const CustomRuntimeParams* params) {
   CHECK_INTERFACE(async_memory_copy_d2h, false);
   CHECK_INTERFACE(async_memory_copy_d2d, false);
   CHECK_INTERFACE(async_memory_copy_p2p, false);
+  CHECK_INTERFACE(async_device_memory_set, false);
+  CHECK_INTERFACE(async_device_memory_allocate, false);
+  CHECK_INTERFACE(async_device_memory_deallocate, false);
 
   CHECK_INTERFACE(get_device_count, true);
   CHECK_INTERFACE(get_device_list, true);
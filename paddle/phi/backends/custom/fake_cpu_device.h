@@ -77,6 +77,29 @@ C_Status Deallocate(const C_Device device, void *ptr, size_t size) {
   return C_SUCCESS;
 }
 
+C_Status AsyncAllocate(const C_Device device,
+                       C_Stream stream,
+                       void **ptr,
+                       size_t size) {
+  return Allocate(device, ptr, size);
+}
+
+C_Status AsyncDeallocate(const C_Device device,
+                         C_Stream stream,
+                         void *ptr,
+                         size_t size) {
+  return Deallocate(device, ptr, size);
+}
+
+C_Status AsyncMemSet(const C_Device device,
+                     C_Stream stream,
+                     void *ptr,
+                     unsigned char value,
+                     size_t size) {
+  memset(ptr, value, size);
+  return C_SUCCESS;
+}
+
 C_Status CreateStream(const C_Device device, C_Stream *stream) {
   return C_SUCCESS;
 }
@@ -268,6 +291,9 @@ void InitFakeCPUDevice(CustomRuntimeParams *params) {
   params->interface->device_memory_deallocate = Deallocate;
   params->interface->host_memory_deallocate = Deallocate;
   params->interface->unified_memory_deallocate = Deallocate;
+  params->interface->async_device_memory_allocate = AsyncAllocate;
+  params->interface->async_device_memory_deallocate = AsyncDeallocate;
+  params->interface->async_device_memory_set = AsyncMemSet;
 
   params->interface->get_device_count = GetDevicesCount;
   params->interface->get_device_list = GetDevicesList;
@@ -192,7 +192,26 @@ void DeviceInterface::MemoryDeallocateUnified(size_t dev_id,
 void DeviceInterface::MemorySet(size_t dev_id,
                                 void* ptr,
                                 uint8_t value,
-                                size_t size) {
+                                size_t size,
+                                const stream::Stream* stream) {
+  INTERFACE_UNIMPLEMENT;
+}
+
+bool DeviceInterface::IsStreamOrderedAllocatorSupported(size_t dev_id) {
+  return false;
+}
+
+void* DeviceInterface::MemoryAllocateAsync(size_t dev_id,
+                                           size_t size,
+                                           const stream::Stream* stream) {
+  INTERFACE_UNIMPLEMENT;
+  return nullptr;
+}
+
+void DeviceInterface::MemoryDeallocateAsync(size_t dev_id,
+                                            void* ptr,
+                                            size_t size,
+                                            const stream::Stream* stream) {
   INTERFACE_UNIMPLEMENT;
 }
 
@@ -152,7 +152,24 @@ class DeviceInterface {  // Driver / Runtime
 
   virtual void MemoryDeallocateUnified(size_t dev_id, void* ptr, size_t size);
 
-  virtual void MemorySet(size_t dev_id, void* ptr, uint8_t value, size_t size);
+  virtual void MemorySet(size_t dev_id,
+                         void* ptr,
+                         uint8_t value,
+                         size_t size,
+                         const stream::Stream* stream = nullptr);
+
+  // Stream-ordered allocation, the memory is allocated and freed in the order
+  // of the work on the stream, without synchronizing the host.
+  virtual bool IsStreamOrderedAllocatorSupported(size_t dev_id);
+
+  virtual void* MemoryAllocateAsync(size_t dev_id,
+                                    size_t size,
+                                    const stream::Stream* stream);
+
+  virtual void MemoryDeallocateAsync(size_t dev_id,
+                                     void* ptr,
+                                     size_t size,
+                                     const stream::Stream* stream);
 
   virtual void MemoryStats(size_t dev_id, size_t* total, size_t* free);
 
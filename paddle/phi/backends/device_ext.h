@@ -447,7 +447,50 @@ struct C_DeviceInterface {
                                     const void* src,
                                     size_t size);
 
-  void* reserved_mem_api[8];
+  /**
+   * @brief Asynchronous device memory set
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void*]      ptr
+   * @param[unsigned char] value
+   * @param[size_t]     size
+   */
+  C_Status (*async_device_memory_set)(const C_Device device,
+                                      C_Stream stream,
+                                      void* ptr,
+                                      unsigned char value,
+                                      size_t size);
+
+  /**
+   * @brief Stream-ordered device memory allocate, the memory can be used by
+   * the work enqueued to the stream after this call
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void**]     ptr        Plugin allocate an address and fill it
+   * @param[size_t]     size
+   */
+  C_Status (*async_device_memory_allocate)(const C_Device device,
+                                           C_Stream stream,
+                                           void** ptr,
+                                           size_t size);
+
+  /**
+   * @brief Stream-ordered device memory deallocate, the memory may be reused
+   * once the work enqueued to the stream before this call completes
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[void*]      ptr
+   * @param[size_t]     size
+   */
+  C_Status (*async_device_memory_deallocate)(const C_Device device,
+                                             C_Stream stream,
+                                             void* ptr,
+                                             size_t size);
+
+  void* reserved_mem_api[5];
 
   //////////////
   // info api //
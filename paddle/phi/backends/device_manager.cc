@@ -166,9 +166,28 @@ void Device::MemoryDeallocateUnified(void* ptr, size_t size) {
   impl_->MemoryDeallocateUnified(dev_id_, ptr, size);
 }
 
-void Device::MemorySet(void* ptr, uint8_t value, size_t size) {
+void Device::MemorySet(void* ptr,
+                       uint8_t value,
+                       size_t size,
+                       const stream::Stream* stream) {
   CheckInitialized();
-  impl_->MemorySet(dev_id_, ptr, value, size);
+  impl_->MemorySet(dev_id_, ptr, value, size, stream);
+}
+
+bool Device::IsStreamOrderedAllocatorSupported() {
+  return impl_->IsStreamOrderedAllocatorSupported(dev_id_);
+}
+
+void* Device::MemoryAllocateAsync(size_t size, const stream::Stream* stream) {
+  CheckInitialized();
+  return impl_->MemoryAllocateAsync(dev_id_, size, stream);
+}
+
+void Device::MemoryDeallocateAsync(void* ptr,
+                                   size_t size,
+                                   const stream::Stream* stream) {
+  CheckInitialized();
+  impl_->MemoryDeallocateAsync(dev_id_, ptr, size, stream);
 }
 
 template <typename T>
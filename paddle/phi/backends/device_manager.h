@@ -110,7 +110,18 @@ class Device final {
 
   void MemoryDeallocateUnified(void* ptr, size_t size);
 
-  void MemorySet(void* ptr, uint8_t value, size_t size);
+  void MemorySet(void* ptr,
+                 uint8_t value,
+                 size_t size,
+                 const stream::Stream* stream = nullptr);
+
+  bool IsStreamOrderedAllocatorSupported();
+
+  void* MemoryAllocateAsync(size_t size, const stream::Stream* stream);
+
+  void MemoryDeallocateAsync(void* ptr,
+                             size_t size,
+                             const stream::Stream* stream);
 
   // Blas
   // ! y = alpha * x + beta * y
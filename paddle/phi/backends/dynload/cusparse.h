@@ -64,6 +64,8 @@ extern void *cusparse_dso_handle;
   __macro(cusparseSpMV);                  \
   __macro(cusparseSpMatGetSize);          \
   __macro(cusparseCsrSetPointers);        \
+  __macro(cusparseSpMatSetValues);        \
+  __macro(cusparseDnMatSetValues);        \
   __macro(cusparseSpGEMM_createDescr);    \
   __macro(cusparseSpGEMM_compute);        \
   __macro(cusparseSpGEMM_workEstimation); \
@@ -42,7 +42,10 @@ extern void *nvjpeg_dso_handle;
   __macro(nvjpegJpegStateCreate);         \
   __macro(nvjpegGetImageInfo);            \
   __macro(nvjpegJpegStateDestroy);        \
-  __macro(nvjpegDecode);
+  __macro(nvjpegDecode);                  \
+  __macro(nvjpegDestroy);                 \
+  __macro(nvjpegDecodeBatchedInitialize); \
+  __macro(nvjpegDecodeBatched);
 
 NVJPEG_RAND_ROUTINE_EACH(DECLARE_DYNAMIC_LOAD_NVJPEG_WRAP);
 
@@ -258,6 +258,11 @@ class CUDAGraph {
     cudagraph_post_capture_callbacks_.push_back(std::move(callback));
   }
 
+  void AddPreLaunchCallback(std::function<void()> callback) {
+    std::lock_guard<std::mutex> guard(mtx_);
+    cudagraph_pre_launch_callbacks_.push_back(std::move(callback));
+  }
+
   void PrintToDotFiles(const std::string &dirname, unsigned int flags);
 
   static void BeginCapture(phi::GPUPlace place,
@@ -278,6 +283,11 @@ class CUDAGraph {
     capturing_graph_->AddPostCaptureCallback(std::move(callback));
   }
 
+  static void AddPreLaunchCallbackDuringCapturing(
+      std::function<void()> callback) {
+    capturing_graph_->AddPreLaunchCallback(std::move(callback));
+  }
+
   // No need to add CUDA_VERSION macro because capturing_graph_ would
   // always be nullptr (constructor throws error)
   static bool IsCapturing() { return capturing_graph_ != nullptr; }
@@ -347,6 +357,11 @@ class CUDAGraph {
   // during the graph's lifecycle.
   std::vector<std::function<void()>> cudagraph_post_capture_callbacks_;
 
+  // Holds callbacks that are invoked on every replay, including the first
+  // one, before the graph is launched, e.g. to update the device states read
+  // by the captured kernels.
+  std::vector<std::function<void()>> cudagraph_pre_launch_callbacks_;
+
   // Maintains a collection of 'pre-hooks' - functions that are executed before
   // the CUDA graph is replayed. These pre-hooks are essential for setting up
   // the necessary conditions or states required for the correct execution of
@@ -118,6 +118,9 @@ void CUDAGraph::Replay() {
                     false,
                     phi::errors::PermissionDenied(
                         "Cannot replay the CUDA Graph after reset is called."));
+  for (auto &callback : cudagraph_pre_launch_callbacks_) {
+    callback();
+  }
   size_t n = exec_graphs_.size();
   for (size_t i = 0; i < n; ++i) {
     if (!is_first_run_) {
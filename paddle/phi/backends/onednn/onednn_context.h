@@ -50,6 +50,10 @@ class OneDNNContextThreadLocals {
     std::string key_suffix;  // Key identifying current Executor
     bool key_attach_thread_id = true;
     void* exec_ptr_ = nullptr;
+    // Predictors with the same scope id share their primitives through
+    // OneDNNPrimitiveCache. Unset outside of a predictor run.
+    bool use_shared_cache_scope = false;
+    int64_t shared_cache_scope = 0;
 
     Body();
     ~Body();
@@ -68,6 +72,13 @@ class OneDNNContextThreadLocals {
     bool is_tid_used_in_key(void) const { return key_attach_thread_id; }
     void set_curr_exec(void* exec_ptr) { exec_ptr_ = exec_ptr; }
     void* get_curr_exec(void) const { return exec_ptr_; }
+    void set_shared_cache_scope(int64_t scope) {
+      shared_cache_scope = scope;
+      use_shared_cache_scope = true;
+    }
+    void reset_shared_cache_scope(void) { use_shared_cache_scope = false; }
+    bool has_shared_cache_scope(void) const { return use_shared_cache_scope; }
+    int64_t get_shared_cache_scope(void) const { return shared_cache_scope; }
   };
   OneDNNContextThreadLocals() = default;
   OneDNNContextThreadLocals(const OneDNNContextThreadLocals& c) = delete;
@@ -0,0 +1,106 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifdef PADDLE_WITH_DNNL
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_int32(onednn_primitive_cache_capacity);
+
+namespace phi {
+
+OneDNNPrimitiveCache& OneDNNPrimitiveCache::Instance() {
+  static OneDNNPrimitiveCache cache;
+  return cache;
+}
+
+bool OneDNNPrimitiveCache::Enabled() const {
+  return FLAGS_onednn_primitive_cache_capacity > 0;
+}
+
+size_t OneDNNPrimitiveCache::StripeCapacity() const {
+  size_t capacity =
+      static_cast<size_t>(std::max(FLAGS_onednn_primitive_cache_capacity, 0));
+  return (capacity + kStripeNum - 1) / kStripeNum;
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Get(
+    const OneDNNPrimitiveCacheKey& key) {
+  Stripe& stripe = StripeOf(key.hash());
+  {
+    std::lock_guard<std::mutex> lock(stripe.mtx);
+    auto it = stripe.index.find(key.hash());
+    if (it != stripe.index.end() && it->second->second.bytes == key.bytes()) {
+      stripe.lru.splice(stripe.lru.begin(), stripe.lru, it->second);
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return it->second->second.value;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return nullptr;
+}
+
+void OneDNNPrimitiveCache::Set(const OneDNNPrimitiveCacheKey& key,
+                               std::shared_ptr<void> value) {
+  size_t capacity = StripeCapacity();
+  if (capacity == 0) {
+    return;
+  }
+  Stripe& stripe = StripeOf(key.hash());
+  std::lock_guard<std::mutex> lock(stripe.mtx);
+  auto it = stripe.index.find(key.hash());
+  if (it != stripe.index.end()) {
+    // Either another thread created the same entry first, or two keys
+    // collide on the hash. Keep the latest one in both cases.
+    it->second->second = Entry{key.bytes(), std::move(value)};
+    stripe.lru.splice(stripe.lru.begin(), stripe.lru, it->second);
+    return;
+  }
+  while (stripe.lru.size() >= capacity) {
+    stripe.index.erase(stripe.lru.back().first);
+    stripe.lru.pop_back();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+  stripe.lru.emplace_front(key.hash(), Entry{key.bytes(), std::move(value)});
+  stripe.index[key.hash()] = stripe.lru.begin();
+}
+
+OneDNNPrimitiveCache::Stats OneDNNPrimitiveCache::GetStats() const {
+  Stats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  stats.size = 0;
+  for (const auto& stripe : stripes_) {
+    std::lock_guard<std::mutex> lock(stripe.mtx);
+    stats.size += stripe.lru.size();
+  }
+  stats.capacity = StripeCapacity() * kStripeNum;
+  return stats;
+}
+
+void OneDNNPrimitiveCache::Clear() {
+  for (auto& stripe : stripes_) {
+    std::lock_guard<std::mutex> lock(stripe.mtx);
+    stripe.index.clear();
+    stripe.lru.clear();
+  }
+  VLOG(3) << "Cleared the shared oneDNN primitive cache.";
+}
+
+}  // namespace phi
+#endif
@@ -0,0 +1,133 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#ifdef PADDLE_WITH_DNNL
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+// Binary key of an entry of OneDNNPrimitiveCache. The fields are appended
+// as raw bytes and the hash is computed once, when the key is complete.
+class OneDNNPrimitiveCacheKey {
+ public:
+  OneDNNPrimitiveCacheKey() { bytes_.reserve(128); }
+
+  template <typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value ||
+                              std::is_enum<T>::value,
+                          OneDNNPrimitiveCacheKey&>::type
+  Append(T value) {
+    bytes_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    return *this;
+  }
+
+  // Strings are length prefixed, so that ("ab", "c") and ("a", "bc") differ.
+  OneDNNPrimitiveCacheKey& Append(const std::string& value) {
+    Append(value.size());
+    bytes_.append(value);
+    return *this;
+  }
+
+  OneDNNPrimitiveCacheKey& Finalize() {
+    hash_ = std::hash<std::string>()(bytes_);
+    return *this;
+  }
+
+  uint64_t hash() const { return hash_; }
+  const std::string& bytes() const { return bytes_; }
+
+ private:
+  std::string bytes_;
+  uint64_t hash_ = 0;
+};
+
+// Process-wide cache of oneDNN primitives and primitive descriptors.
+//
+// The blobs of OneDNNContext are keyed by executor and thread, so every
+// cloned predictor and every new thread creates the same primitives again.
+// Primitives and primitive descriptors hold no tensor data and may be
+// executed from many threads at once, so OneDNNHandlerT also publishes them
+// here, keyed without the executor and thread, for the predictors that share
+// a scope (see OneDNNContextThreadLocals::Body::set_shared_cache_scope).
+//
+// The cache is split into stripes, each with its own lock and LRU list, and
+// holds at most FLAGS_onednn_primitive_cache_capacity entries. A capacity of
+// 0 disables it.
+class OneDNNPrimitiveCache {
+ public:
+  struct Stats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t size;
+    size_t capacity;
+  };
+
+  TEST_API static OneDNNPrimitiveCache& Instance();
+
+  bool Enabled() const;
+
+  // Returns nullptr on a miss.
+  TEST_API std::shared_ptr<void> Get(const OneDNNPrimitiveCacheKey& key);
+
+  // Inserts the value, or replaces the entry already held for the key.
+  TEST_API void Set(const OneDNNPrimitiveCacheKey& key,
+                    std::shared_ptr<void> value);
+
+  TEST_API Stats GetStats() const;
+
+  TEST_API void Clear();
+
+ private:
+  static constexpr size_t kStripeNum = 16;
+
+  struct Entry {
+    std::string bytes;
+    std::shared_ptr<void> value;
+  };
+  using EntryList = std::list<std::pair<uint64_t, Entry>>;
+
+  struct Stripe {
+    mutable std::mutex mtx;
+    EntryList lru;  // most recently used first
+    std::unordered_map<uint64_t, EntryList::iterator> index;
+  };
+
+  OneDNNPrimitiveCache() = default;
+  OneDNNPrimitiveCache(const OneDNNPrimitiveCache&) = delete;
+  OneDNNPrimitiveCache& operator=(const OneDNNPrimitiveCache&) = delete;
+
+  Stripe& StripeOf(uint64_t hash) { return stripes_[hash % kStripeNum]; }
+  size_t StripeCapacity() const;
+
+  std::array<Stripe, kStripeNum> stripes_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+
+}  // namespace phi
+#endif
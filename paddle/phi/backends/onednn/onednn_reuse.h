@@ -19,11 +19,13 @@ limitations under the License. */
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
 #include "paddle/phi/backends/onednn/onednn_context.h"
 #include "paddle/phi/backends/onednn/onednn_helper.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/int_array.h"
 #include "paddle/phi/common/place.h"
@@ -161,7 +163,11 @@ class OneDNNHandlerT {
     auto forward_p =
         std::static_pointer_cast<TForward>(dev_ctx_.GetBlob(key_p));
     if (forward_p == nullptr) {
-      forward_p = std::make_shared<TForward>(*fwd_pd_);
+      forward_p = GetShared<TForward>("@fwd_p");
+      if (forward_p == nullptr) {
+        forward_p = std::make_shared<TForward>(*fwd_pd_);
+        SetShared("@fwd_p", forward_p);
+      }
       dev_ctx_.SetBlob(key_p, forward_p);
     }
     return forward_p;
@@ -172,7 +178,11 @@ class OneDNNHandlerT {
     auto backward_p =
         std::static_pointer_cast<TBackward>(dev_ctx_.GetBlob(key_p));
     if (backward_p == nullptr) {
-      backward_p = std::make_shared<TBackward>(*bwd_pd_);
+      backward_p = GetShared<TBackward>("@bwd_p");
+      if (backward_p == nullptr) {
+        backward_p = std::make_shared<TBackward>(*bwd_pd_);
+        SetShared("@bwd_p", backward_p);
+      }
       dev_ctx_.SetBlob(key_p, backward_p);
     }
     return backward_p;
@@ -188,7 +198,11 @@ class OneDNNHandlerT {
           errors::Unavailable("BWD_PD should be set when "
                               "getting BWD prim witk key: %s .",
                               key_p));
-      backward_p = std::make_shared<TBackward_params>(*bwd_w_pd_);
+      backward_p = GetShared<TBackward_params>("@bwd_w_p");
+      if (backward_p == nullptr) {
+        backward_p = std::make_shared<TBackward_params>(*bwd_w_pd_);
+        SetShared("@bwd_w_p", backward_p);
+      }
       dev_ctx_.SetBlob(key_p, backward_p);
     }
     return backward_p;
@@ -307,7 +321,12 @@ class OneDNNHandlerT {
     fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
         dev_ctx_.GetBlob(key_pd));
     if (fwd_pd_ == nullptr) {
-      CreateForwardPrimitiveDescriptor(first_arg, std::forward<Args>(args)...);
+      fwd_pd_ = GetShared<typename TForward::primitive_desc>("@fwd_pd");
+      if (fwd_pd_ == nullptr) {
+        CreateForwardPrimitiveDescriptor(first_arg,
+                                         std::forward<Args>(args)...);
+        SetShared("@fwd_pd", fwd_pd_);
+      }
       dev_ctx_.SetBlob(key_pd, fwd_pd_);
     }
   }
@@ -342,8 +361,12 @@ class OneDNNHandlerT {
     bwd_pd_ = std::static_pointer_cast<typename TBackward::primitive_desc>(
         dev_ctx_.GetBlob(key_pd));
     if (bwd_pd_ == nullptr) {
-      bwd_pd_ = std::make_shared<typename TBackward::primitive_desc>(
-          engine_, std::forward<Args>(args)..., *fwd_pd_);
+      bwd_pd_ = GetShared<typename TBackward::primitive_desc>("@bwd_pd");
+      if (bwd_pd_ == nullptr) {
+        bwd_pd_ = std::make_shared<typename TBackward::primitive_desc>(
+            engine_, std::forward<Args>(args)..., *fwd_pd_);
+        SetShared("@bwd_pd", bwd_pd_);
+      }
       dev_ctx_.SetBlob(key_pd, bwd_pd_);
     }
   }
@@ -361,8 +384,14 @@ class OneDNNHandlerT {
         std::static_pointer_cast<typename TBackward_params::primitive_desc>(
             dev_ctx_.GetBlob(key_pd));
     if (bwd_w_pd_ == nullptr) {
-      bwd_w_pd_ = std::make_shared<typename TBackward_params::primitive_desc>(
-          engine_, std::forward<Args>(args)..., *fwd_pd_);
+      bwd_w_pd_ =
+          GetShared<typename TBackward_params::primitive_desc>("@bwd_w_pd");
+      if (bwd_w_pd_ == nullptr) {
+        bwd_w_pd_ =
+            std::make_shared<typename TBackward_params::primitive_desc>(
+                engine_, std::forward<Args>(args)..., *fwd_pd_);
+        SetShared("@bwd_w_pd", bwd_w_pd_);
+      }
       dev_ctx_.SetBlob(key_pd, bwd_w_pd_);
     }
   }
@@ -509,6 +538,57 @@ class OneDNNHandlerT {
     return;
   }
 
+  // Primitives and primitive descriptors are also looked up in the
+  // process-wide OneDNNPrimitiveCache when the current thread runs in a
+  // shared cache scope. Their key drops the executor suffix and thread id of
+  // key_, so the clones of a predictor and all their threads find the same
+  // entry. Memory objects are bound to tensor data and stay in the blobs.
+  bool UseSharedCache() const {
+    return OneDNNContext::tls().has_shared_cache_scope() &&
+           OneDNNPrimitiveCache::Instance().Enabled();
+  }
+
+  OneDNNPrimitiveCacheKey SharedKey(const std::string& suffix,
+                                    size_t type_hash) const {
+    auto& tls = OneDNNContext::tls();
+    std::string base_key = key_common_;
+    const std::string& exec_suffix = tls.get_key_suffix();
+    if (!exec_suffix.empty() && base_key.size() >= exec_suffix.size() &&
+        base_key.compare(base_key.size() - exec_suffix.size(),
+                         exec_suffix.size(),
+                         exec_suffix) == 0) {
+      base_key.resize(base_key.size() - exec_suffix.size());
+    }
+    OneDNNPrimitiveCacheKey key;
+    key.Append(tls.get_shared_cache_scope())
+        .Append(type_hash)
+        .Append(tls.get_cur_paddle_data_layout())
+        .Append(tls.cur_input_shape_str)
+        .Append(base_key)
+        .Append(suffix)
+        .Finalize();
+    return key;
+  }
+
+  template <typename TObject>
+  std::shared_ptr<TObject> GetShared(const std::string& suffix) const {
+    if (!UseSharedCache()) {
+      return nullptr;
+    }
+    return std::static_pointer_cast<TObject>(
+        OneDNNPrimitiveCache::Instance().Get(
+            SharedKey(suffix, typeid(TObject).hash_code())));
+  }
+
+  template <typename TObject>
+  void SetShared(const std::string& suffix,
+                 const std::shared_ptr<TObject>& object) const {
+    if (UseSharedCache()) {
+      OneDNNPrimitiveCache::Instance().Set(
+          SharedKey(suffix, typeid(TObject).hash_code()), object);
+    }
+  }
+
   const OneDNNContext& dev_ctx_;
   dnnl::engine engine_;
   Place place_;
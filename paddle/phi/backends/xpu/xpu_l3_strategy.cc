@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "paddle/phi/backends/xpu/xpu_l3_strategy.h"
+
+#include <utility>
+
 #include "glog/logging.h"
 #include "paddle/phi/backends/xpu/enforce_xpu.h"
 
@@ -152,4 +155,65 @@ void XPUL3Planner::RunAutotune(
   VLOG(3) << "AutoTune XPU L3 Cache Block End.";
 }
 
+size_t XPUL3Planner::RunLivenessAutotune(std::vector<XPUL3LiveBlock>* blocks,
+                                         size_t l3_size,
+                                         size_t alignment) {
+  auto align_up = [alignment](size_t size) {
+    return (size + alignment - 1) / alignment * alignment;
+  };
+  std::vector<size_t> order;
+  for (size_t i = 0; i < blocks->size(); ++i) {
+    auto& block = (*blocks)[i];
+    block.offset = 0;
+    block.in_l3 = false;
+    if (block.size > 0 && block.accesses > 0 && block.size <= l3_size) {
+      order.push_back(i);
+    }
+  }
+  // accesses per op alive, the compare is a / la > b / lb without division
+  std::stable_sort(order.begin(), order.end(), [blocks](size_t a, size_t b) {
+    const auto& x = (*blocks)[a];
+    const auto& y = (*blocks)[b];
+    size_t x_ops = x.end - x.begin + 1;
+    size_t y_ops = y.end - y.begin + 1;
+    if (x.accesses * y_ops != y.accesses * x_ops) {
+      return x.accesses * y_ops > y.accesses * x_ops;
+    }
+    return x.size < y.size;
+  });
+
+  size_t used = 0;
+  std::vector<size_t> placed;
+  for (auto idx : order) {
+    auto& block = (*blocks)[idx];
+    // the ranges taken by the placed blocks alive at the same time
+    std::vector<std::pair<size_t, size_t>> taken;
+    for (auto other_idx : placed) {
+      const auto& other = (*blocks)[other_idx];
+      if (other.begin <= block.end && block.begin <= other.end) {
+        taken.emplace_back(other.offset, other.offset + other.size);
+      }
+    }
+    std::sort(taken.begin(), taken.end());
+    size_t offset = 0;
+    for (auto& range : taken) {
+      if (offset + block.size <= range.first) {
+        break;
+      }
+      offset = std::max(offset, align_up(range.second));
+    }
+    if (offset + block.size > l3_size) {
+      continue;
+    }
+    block.offset = offset;
+    block.in_l3 = true;
+    placed.push_back(idx);
+    used = std::max(used, offset + block.size);
+  }
+  VLOG(3) << "XPU L3 liveness autotune places " << placed.size() << " of "
+          << blocks->size() << " blocks in " << used << " of " << l3_size
+          << " bytes";
+  return used;
+}
+
 }  // namespace phi
@@ -39,11 +39,31 @@ struct XPUL3CacheBlock {
   std::vector<size_t> history_;
 };
 
+// A tensor of size bytes that is alive from the begin-th to the end-th op of
+// a program, both included, and is read or written by accesses ops.
+struct XPUL3LiveBlock {
+  size_t size{0};
+  size_t begin{0};
+  size_t end{0};
+  size_t accesses{0};
+  // set by RunLivenessAutotune
+  size_t offset{0};
+  bool in_l3{false};
+};
+
 class XPUL3Planner {
  public:
   void RunAutotune(const std::vector<XPUL3CacheBlock*>& l3_block_dict,
                    size_t l3_size);
 
+  // Places the blocks with the most accesses per op of lifetime in l3 first,
+  // each at the lowest aligned gap between the placed blocks that overlap it
+  // in time, blocks alive at different ops share the same l3. The blocks
+  // which do not fit stay in global memory. Returns the l3 bytes used.
+  static size_t RunLivenessAutotune(std::vector<XPUL3LiveBlock>* blocks,
+                                    size_t l3_size,
+                                    size_t alignment);
+
   std::vector<size_t>* plan() { return &plan_; }
 
  private:
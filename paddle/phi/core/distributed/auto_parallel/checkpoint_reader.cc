@@ -0,0 +1,216 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/core/distributed/auto_parallel/checkpoint_reader.h"
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <tuple>
+
+#include "glog/logging.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+// A contiguous byte range of a file read into a contiguous destination.
+struct ReadRun {
+  const std::string* file_path;
+  int64_t file_offset;
+  char* dst;
+  int64_t bytes;
+};
+
+std::vector<int64_t> RowMajorStrides(const std::vector<int64_t>& shape) {
+  std::vector<int64_t> strides(shape.size(), 1);
+  for (int i = static_cast<int>(shape.size()) - 2; i >= 0; --i) {
+    strides[i] = strides[i + 1] * shape[i + 1];
+  }
+  return strides;
+}
+
+void AppendRuns(const CheckpointReadItem& item, std::vector<ReadRun>* runs) {
+  const auto& dst_shape = common::vectorize(item.dst->dims());
+  const int ndim = static_cast<int>(item.lengths.size());
+  PADDLE_ENFORCE_EQ(
+      item.storage_shape.size() == static_cast<size_t>(ndim) &&
+          item.storage_offsets.size() == static_cast<size_t>(ndim) &&
+          item.dst_offsets.size() == static_cast<size_t>(ndim) &&
+          dst_shape.size() == static_cast<size_t>(ndim),
+      true,
+      errors::InvalidArgument("The slice of %s read from %s has %d dims, "
+                              "which mismatch its storage or destination.",
+                              item.dst->dims(),
+                              item.file_path,
+                              ndim));
+  const int64_t elem_bytes = static_cast<int64_t>(SizeOf(item.dst->dtype()));
+  char* dst_base = static_cast<char*>(item.dst->data());
+  if (ndim == 0) {
+    runs->push_back({&item.file_path, item.byte_offset, dst_base, elem_bytes});
+    return;
+  }
+  for (int i = 0; i < ndim; ++i) {
+    if (item.lengths[i] == 0) {
+      return;
+    }
+  }
+
+  // the run spans the dims from first_run_dim on
+  int first_run_dim = ndim - 1;
+  int64_t run_elems = item.lengths[ndim - 1];
+  while (first_run_dim > 0 &&
+         item.lengths[first_run_dim] == item.storage_shape[first_run_dim] &&
+         item.lengths[first_run_dim] == dst_shape[first_run_dim]) {
+    --first_run_dim;
+    run_elems *= item.lengths[first_run_dim];
+  }
+
+  const auto storage_strides = RowMajorStrides(item.storage_shape);
+  const auto dst_strides = RowMajorStrides(dst_shape);
+  std::vector<int64_t> index(first_run_dim, 0);
+  while (true) {
+    int64_t storage_elem = 0;
+    int64_t dst_elem = 0;
+    for (int i = 0; i < ndim; ++i) {
+      int64_t pos = i < first_run_dim ? index[i] : 0;
+      storage_elem += (item.storage_offsets[i] + pos) * storage_strides[i];
+      dst_elem += (item.dst_offsets[i] + pos) * dst_strides[i];
+    }
+    runs->push_back({&item.file_path,
+                     item.byte_offset + storage_elem * elem_bytes,
+                     dst_base + dst_elem * elem_bytes,
+                     run_elems * elem_bytes});
+    // advance the index of the outer dims
+    int dim = first_run_dim - 1;
+    while (dim >= 0 && ++index[dim] == item.lengths[dim]) {
+      index[dim] = 0;
+      --dim;
+    }
+    if (dim < 0) {
+      break;
+    }
+  }
+}
+
+void ReadRuns(const std::vector<ReadRun>& runs, size_t begin, size_t end) {
+  std::map<std::string, std::unique_ptr<std::ifstream>> files;
+  for (size_t i = begin; i < end; ++i) {
+    const auto& run = runs[i];
+    auto& file = files[*run.file_path];
+    if (file == nullptr) {
+      file = std::make_unique<std::ifstream>(*run.file_path,
+                                             std::ios::in | std::ios::binary);
+      PADDLE_ENFORCE_EQ(
+          file->is_open(),
+          true,
+          errors::Unavailable("Failed to open the checkpoint file %s.",
+                              *run.file_path));
+    }
+    file->seekg(run.file_offset);
+    file->read(run.dst, run.bytes);
+    PADDLE_ENFORCE_EQ(
+        file->gcount(),
+        run.bytes,
+        errors::Unavailable("Failed to read %d bytes at %d of the checkpoint "
+                            "file %s.",
+                            run.bytes,
+                            run.file_offset,
+                            *run.file_path));
+  }
+}
+
+}  // namespace
+
+void ReadCheckpointSlices(const std::vector<CheckpointReadItem>& items,
+                          int num_threads) {
+  std::vector<ReadRun> runs;
+  for (const auto& item : items) {
+    AppendRuns(item, &runs);
+  }
+  if (runs.empty()) {
+    return;
+  }
+
+  // read each file forward, and coalesce the adjacent runs
+  std::sort(runs.begin(), runs.end(), [](const ReadRun& a, const ReadRun& b) {
+    return std::tie(*a.file_path, a.file_offset) <
+           std::tie(*b.file_path, b.file_offset);
+  });
+  std::vector<ReadRun> coalesced;
+  coalesced.push_back(runs[0]);
+  int64_t total_bytes = runs[0].bytes;
+  for (size_t i = 1; i < runs.size(); ++i) {
+    auto& last = coalesced.back();
+    const auto& run = runs[i];
+    total_bytes += run.bytes;
+    if (*last.file_path == *run.file_path &&
+        last.file_offset + last.bytes == run.file_offset &&
+        last.dst + last.bytes == run.dst) {
+      last.bytes += run.bytes;
+    } else {
+      coalesced.push_back(run);
+    }
+  }
+
+  // split the runs into the threads by their bytes
+  num_threads = std::max(
+      1, std::min(num_threads, static_cast<int>(coalesced.size())));
+  std::vector<size_t> bounds = {0};
+  int64_t bytes = 0;
+  for (size_t i = 0; i < coalesced.size(); ++i) {
+    bytes += coalesced[i].bytes;
+    if (bytes * num_threads >=
+            total_bytes * static_cast<int64_t>(bounds.size()) &&
+        bounds.size() < static_cast<size_t>(num_threads)) {
+      bounds.push_back(i + 1);
+    }
+  }
+  if (bounds.back() != coalesced.size()) {
+    bounds.push_back(coalesced.size());
+  }
+  VLOG(3) << "Read " << total_bytes << " bytes of the checkpoint in "
+          << coalesced.size() << " ranges on " << bounds.size() - 1
+          << " threads";
+
+  std::vector<std::exception_ptr> errors(bounds.size() - 1);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t + 1 < bounds.size(); ++t) {
+    threads.emplace_back([&, t]() {
+      try {
+        ReadRuns(coalesced, bounds[t], bounds[t + 1]);
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+}  // namespace distributed
+}  // namespace phi
@@ -0,0 +1,46 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace phi {
+class DenseTensor;
+namespace distributed {
+
+// A slice of a local tensor stored row-major as raw bytes in a checkpoint
+// file, and the slice of the same lengths of a CPU tensor it is read into.
+struct CheckpointReadItem {
+  std::string file_path;
+  // where the stored local tensor begins in the file
+  int64_t byte_offset{0};
+  std::vector<int64_t> storage_shape;
+  std::vector<int64_t> storage_offsets;
+  std::vector<int64_t> lengths;
+  phi::DenseTensor* dst{nullptr};
+  std::vector<int64_t> dst_offsets;
+};
+
+// Reads the slices by range reads of the files on num_threads threads. A
+// slice is read as the contiguous runs of its innermost dims, the dims of
+// which the slice covers the whole of both tensors are merged into the runs,
+// and the runs adjacent in both the file and the destination are coalesced.
+void ReadCheckpointSlices(const std::vector<CheckpointReadItem>& items,
+                          int num_threads);
+
+}  // namespace distributed
+}  // namespace phi
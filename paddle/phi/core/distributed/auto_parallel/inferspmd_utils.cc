@@ -14,6 +14,12 @@ limitations under the License. */
 
 #include "paddle/phi/core/distributed/auto_parallel/inferspmd_utils.h"
 
+#include <algorithm>
+
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_bool(auto_parallel_spmd_rule_cache);
+
 namespace phi {
 namespace distributed {
 
@@ -159,5 +165,149 @@ const SpmdRule& SpmdRuleFactory::GetSpmdRule(
   return it->second;
 }
 
+// the cache is dropped when it grows beyond it, e.g. with dynamic shapes
+constexpr size_t kMaxSpmdRuleCacheSize = 16384;
+
+SpmdRuleCache& SpmdRuleCache::Instance() {
+  static thread_local SpmdRuleCache cache;
+  return cache;
+}
+
+bool SpmdRuleCache::Enabled() { return FLAGS_auto_parallel_spmd_rule_cache; }
+
+const SpmdInfo* SpmdRuleCache::Find(const std::string& key) const {
+  auto it = cache_.find(key);
+  return it == cache_.end() ? nullptr : &it->second;
+}
+
+void SpmdRuleCache::Insert(std::string key, const SpmdInfo& info) {
+  if (cache_.size() >= kMaxSpmdRuleCacheSize) {
+    cache_.clear();
+  }
+  cache_.emplace(std::move(key), info);
+}
+
+namespace {
+
+template <typename T>
+void AppendPod(const T& value, std::string* key) {
+  key->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void AppendPodVector(const std::vector<T>& values, std::string* key) {
+  AppendPod(values.size(), key);
+  key->append(reinterpret_cast<const char*>(values.data()),
+              values.size() * sizeof(T));
+}
+
+void AppendString(const std::string& value, std::string* key) {
+  AppendPod(value.size(), key);
+  key->append(value);
+}
+
+void AppendDistAttr(const TensorDistAttr& dist_attr, std::string* key) {
+  const auto& mesh = dist_attr.process_mesh();
+  AppendPodVector(mesh.shape(), key);
+  AppendPodVector(mesh.process_ids(), key);
+  AppendPod(mesh.dim_names().size(), key);
+  for (const auto& name : mesh.dim_names()) {
+    AppendString(name, key);
+  }
+  AppendPodVector(dist_attr.dims_mapping(), key);
+  AppendPod(dist_attr.chunk_id(), key);
+  // the partial status is a hash map, its order is not stable
+  std::vector<std::pair<int64_t, ReduceType>> partial(
+      dist_attr.partial_status().begin(), dist_attr.partial_status().end());
+  std::sort(partial.begin(), partial.end());
+  AppendPod(partial.size(), key);
+  for (const auto& item : partial) {
+    AppendPod(item.first, key);
+    AppendPod(item.second, key);
+  }
+  const auto& dynamic_dims = dist_attr.dynamic_dims();
+  AppendPodVector(std::vector<char>(dynamic_dims.begin(), dynamic_dims.end()),
+                  key);
+  AppendPod(dist_attr.annotated().size(), key);
+  for (const auto& item : dist_attr.annotated()) {
+    AppendString(item.first, key);
+    AppendPod(item.second, key);
+  }
+}
+
+}  // namespace
+
+bool AppendSpmdCacheKey(const DistMetaTensor& arg, std::string* key) {
+  if (arg.initialized() && !arg.is_dist()) {
+    return false;
+  }
+  AppendPod(arg.initialized(), key);
+  AppendPodVector(common::vectorize(arg.dims()), key);
+  AppendPod(arg.initialized() ? arg.dtype() : DataType::UNDEFINED, key);
+  AppendDistAttr(arg.dist_attr(), key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(const std::vector<DistMetaTensor>& arg,
+                        std::string* key) {
+  AppendPod(arg.size(), key);
+  for (const auto& tensor : arg) {
+    if (!AppendSpmdCacheKey(tensor, key)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AppendSpmdCacheKey(bool arg, std::string* key) {
+  AppendPod(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(int arg, std::string* key) {
+  AppendPod(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(int64_t arg, std::string* key) {
+  AppendPod(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(float arg, std::string* key) {
+  AppendPod(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(double arg, std::string* key) {
+  AppendPod(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(DataType arg, std::string* key) {
+  AppendPod(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(const char* arg, std::string* key) {
+  AppendString(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(const std::string& arg, std::string* key) {
+  AppendString(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(const std::vector<int>& arg, std::string* key) {
+  AppendPodVector(arg, key);
+  return true;
+}
+
+bool AppendSpmdCacheKey(const std::vector<int64_t>& arg, std::string* key) {
+  AppendPodVector(arg, key);
+  return true;
+}
+
 }  // namespace distributed
 }  // namespace phi
@@ -18,6 +18,7 @@ limitations under the License. */
 #include <typeindex>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/common/int_array.h"
@@ -225,8 +226,7 @@ class SpmdRule {
   InferSpmdFn backward_fn_;
 };
 
-// SpmdRuleFactory manage the spmd rules and cache the propagate results
-// TODO(chenweihang): Add spmd caching impl later
+// SpmdRuleFactory manage the spmd rules
 class SpmdRuleFactory {
  public:
   static SpmdRuleFactory& Instance();
@@ -245,6 +245,78 @@ class SpmdRuleFactory {
   DISABLE_COPY_AND_ASSIGN(SpmdRuleFactory);
 };
 
+// The spmd rules are pure functions of the input dims, dtypes and dist attrs
+// and the attributes. SpmdRuleCache keeps their results per thread, keyed by
+// the api name and the arguments, so that the repeated calls of an api in
+// dygraph skip the rule.
+class SpmdRuleCache {
+ public:
+  static SpmdRuleCache& Instance();
+
+  static bool Enabled();
+
+  const SpmdInfo* Find(const std::string& key) const;
+
+  void Insert(std::string key, const SpmdInfo& info);
+
+ private:
+  SpmdRuleCache() = default;
+
+  paddle::flat_hash_map<std::string, SpmdInfo> cache_;
+
+  DISABLE_COPY_AND_ASSIGN(SpmdRuleCache);
+};
+
+// Append an argument of a spmd rule to the cache key. An argument of other
+// types makes the call not cached.
+template <typename T>
+bool AppendSpmdCacheKey(const T& arg UNUSED, std::string* key UNUSED) {
+  return false;
+}
+bool AppendSpmdCacheKey(const DistMetaTensor& arg, std::string* key);
+bool AppendSpmdCacheKey(const std::vector<DistMetaTensor>& arg,
+                        std::string* key);
+bool AppendSpmdCacheKey(bool arg, std::string* key);
+bool AppendSpmdCacheKey(int arg, std::string* key);
+bool AppendSpmdCacheKey(int64_t arg, std::string* key);
+bool AppendSpmdCacheKey(float arg, std::string* key);
+bool AppendSpmdCacheKey(double arg, std::string* key);
+bool AppendSpmdCacheKey(DataType arg, std::string* key);
+bool AppendSpmdCacheKey(const char* arg, std::string* key);
+bool AppendSpmdCacheKey(const std::string& arg, std::string* key);
+bool AppendSpmdCacheKey(const std::vector<int>& arg, std::string* key);
+bool AppendSpmdCacheKey(const std::vector<int64_t>& arg, std::string* key);
+template <typename T>
+bool AppendSpmdCacheKey(const paddle::experimental::ScalarBase<T>& arg,
+                        std::string* key) {
+  auto dtype = arg.dtype();
+  key->append(reinterpret_cast<const char*>(&dtype), sizeof(dtype));
+  return AppendSpmdCacheKey(arg.ToString(), key);
+}
+
+// Call infer_spmd, a closure calling the spmd rule of api with args, or
+// return the result of a previous call with equal args.
+template <typename InferFn, typename... Args>
+SpmdInfo CachedInferSpmd(const char* api,
+                         InferFn&& infer_spmd,
+                         const Args&... args) {
+  if (!SpmdRuleCache::Enabled()) {
+    return infer_spmd();
+  }
+  std::string key(api);
+  key.push_back('\0');
+  if (!(AppendSpmdCacheKey(args, &key) && ...)) {
+    return infer_spmd();
+  }
+  auto& cache = SpmdRuleCache::Instance();
+  if (const SpmdInfo* info = cache.Find(key)) {
+    return *info;
+  }
+  SpmdInfo info = infer_spmd();
+  cache.Insert(std::move(key), info);
+  return info;
+}
+
 #define PD_REGISTER_SPMD_RULE(kernel_name, ...)                       \
   UNUSED static int ___registrar_spmd_rule_for_##kernel_name =        \
       ::phi::distributed::SpmdRuleFactory::Instance().InsertSpmdRule( \
@@ -15,6 +15,7 @@
 #include "paddle/phi/core/distributed/auto_parallel/reshard/nd_mesh_reshard_function.h"
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/phi/common/int_array.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
@@ -22,11 +23,15 @@
 #include "paddle/phi/core/distributed/auto_parallel/reshard/p_to_s_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/r_to_p_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/r_to_s_reshard_function.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_planner.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_r_reshard_function.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_s_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/same_status_reshard_function.h"
 #include "paddle/phi/core/distributed/store/store_utils.h"
 
+COMMON_DECLARE_bool(auto_parallel_reshard_planner);
+
 namespace phi {
 namespace distributed {
 
@@ -96,6 +101,13 @@ void SameNdMeshReshardFunction::Eval(phi::DeviceContext* dev_ctx,
   const auto& in_dist_attr = in.dist_attr();
   const auto& process_mesh = out_dist_attr.process_mesh();
 
+  if (FLAGS_auto_parallel_reshard_planner) {
+    auto plan = ReshardPlanner::Instance().GetPlan(
+        in_dist_attr, out_dist_attr, in.dims(), in.dtype());
+    EvalPlan(dev_ctx, in, out_dist_attr, plan, out);
+    return;
+  }
+
   int64_t first_diff_axis = FindFirstDiffShardAxis(in_dist_attr, out_dist_attr);
 
   // Backup out_dist_attr to to avoid overwriting the out's dist attr
@@ -273,6 +285,114 @@ void SameNdMeshReshardFunction::Eval(phi::DeviceContext* dev_ctx,
   }
 }
 
+void SameNdMeshReshardFunction::EvalPlan(DeviceContext* dev_ctx,
+                                         const DistTensor& in,
+                                         const TensorDistAttr& out_dist_attr,
+                                         const ReshardPlan& plan,
+                                         DistTensor* out) {
+  const auto& process_mesh = out_dist_attr.process_mesh();
+  const auto& out_partial_status = out_dist_attr.partial_status();
+
+  SetValue(out, in.value());
+  SetDistProps(out, in.dims(), in.dist_attr());
+
+  for (const auto& step : plan.steps) {
+    VLOG(3) << "Reshard step " << step.to_string();
+    int64_t mesh_axis = step.mesh_axis;
+    ProcessMesh sub_mesh = GetSubProcessMesh(process_mesh, mesh_axis);
+
+    // the dist attr after this step
+    TensorDistAttr real_out_dist_attr(out->dist_attr());
+    std::vector<int64_t> real_dims_mapping = real_out_dist_attr.dims_mapping();
+    if (step.in_dim != -1) {
+      real_dims_mapping[step.in_dim] = -1;
+    }
+    if (step.out_dim != -1) {
+      real_dims_mapping[step.out_dim] = mesh_axis;
+    }
+    real_out_dist_attr.set_dims_mapping(real_dims_mapping);
+
+    // the one dim dist attrs on the sub mesh
+    TensorDistAttr in_one_dim_dist_attr(common::vectorize(in.dims()));
+    in_one_dim_dist_attr.set_process_mesh(sub_mesh);
+    std::vector<int64_t> in_one_dims_mapping =
+        in_one_dim_dist_attr.dims_mapping();
+    if (step.in_dim != -1) {
+      in_one_dims_mapping[step.in_dim] = 0;
+    }
+    in_one_dim_dist_attr.set_dims_mapping(in_one_dims_mapping);
+    if (out->dist_attr().is_partial(mesh_axis)) {
+      in_one_dim_dist_attr.set_partial_status(
+          std::vector<int64_t>{0},
+          out->dist_attr().partial_status().at(mesh_axis));
+      real_out_dist_attr.clean_partial_dims({mesh_axis});
+    }
+
+    TensorDistAttr out_one_dim_dist_attr(common::vectorize(in.dims()));
+    out_one_dim_dist_attr.set_process_mesh(sub_mesh);
+    std::vector<int64_t> out_one_dims_mapping =
+        out_one_dim_dist_attr.dims_mapping();
+    if (step.out_dim != -1) {
+      out_one_dims_mapping[step.out_dim] = 0;
+    }
+    out_one_dim_dist_attr.set_dims_mapping(out_one_dims_mapping);
+    if (step.type == ReshardStep::Type::kRToP) {
+      auto reduce_type = out_partial_status.at(mesh_axis);
+      out_one_dim_dist_attr.set_partial_status(std::vector<int64_t>{0},
+                                               reduce_type);
+      real_out_dist_attr.set_partial_status(std::vector<int64_t>{mesh_axis},
+                                            reduce_type);
+    }
+
+    DistTensor tmp_result;
+    switch (step.type) {
+      case ReshardStep::Type::kPToR: {
+        SetDistProps(out, in_one_dim_dist_attr);
+        PToRReshardFunction func;
+        func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      case ReshardStep::Type::kPToS: {
+        SetDistProps(out, in_one_dim_dist_attr);
+        PToSReshardFunction func;
+        func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      case ReshardStep::Type::kSToR: {
+        SetDistProps(out, in_one_dim_dist_attr);
+        SToRReshardFunction func;
+        func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      case ReshardStep::Type::kRToS: {
+        SetDistProps(out, in_one_dim_dist_attr);
+        RToSReshardFunction func;
+        func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      case ReshardStep::Type::kSToS: {
+        // SToSReshardFunction reshapes the local value by the dims, which are
+        // the ones on the sub mesh here as the other dims may be sharded
+        DDim sub_mesh_dims = out->local_dims();
+        sub_mesh_dims[step.in_dim] *= sub_mesh.size();
+        SetDistProps(out, sub_mesh_dims, in_one_dim_dist_attr);
+        SToSReshardFunction func;
+        func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+      case ReshardStep::Type::kRToP: {
+        SetDistProps(out, in_one_dim_dist_attr);
+        RToPReshardFunction func;
+        func.Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
+        break;
+      }
+    }
+
+    SetValue(out, tmp_result.value());
+    SetDistProps(out, in.dims(), real_out_dist_attr);
+  }
+}
+
 bool CrossNdMeshReshardFunction::IsSuitable(
     const DistTensor& in, const TensorDistAttr& out_dist_attr) {
   const ProcessMesh& in_process_mesh = in.dist_attr().process_mesh();
@@ -19,6 +19,8 @@
 namespace phi {
 namespace distributed {
 
+struct ReshardPlan;
+
 class SameNdMeshReshardFunction final : public ReshardFunction {
  public:
   bool IsSuitable(const DistTensor& in,
@@ -30,6 +32,14 @@ class SameNdMeshReshardFunction final : public ReshardFunction {
             DistTensor* out) override;
 
   std::string Name() override { return "SameNdMeshReshard"; }
+
+ private:
+  // Runs the steps of plan, see FLAGS_auto_parallel_reshard_planner.
+  void EvalPlan(DeviceContext* dev_ctx,
+                const DistTensor& in,
+                const TensorDistAttr& out_dist_attr,
+                const ReshardPlan& plan,
+                DistTensor* out);
 };
 
 class CrossNdMeshReshardFunction final : public ReshardFunction {
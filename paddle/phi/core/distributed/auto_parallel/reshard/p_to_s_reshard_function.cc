@@ -46,6 +46,70 @@ bool PToSReshardFunction::IsSuitable(const DistTensor& in,
   return true;
 }
 
+namespace {
+
+// The transpose of split_axis to axis 0, reduce scatter and transpose back of
+// the input chunked along axis 0, for which the rows of out are contiguous.
+void PipelinedReshardPToS(DeviceContext* dev_ctx,
+                          int64_t split_axis,
+                          const std::vector<int64_t>& process_ids,
+                          const DenseTensor& in,
+                          int64_t num_chunks,
+                          DenseTensor* out) {
+  int64_t num_of_process = process_ids.size();
+  auto dtype = in.dtype();
+
+  // swaps axis 0 and split_axis, so is its own inverse
+  std::vector<int> axis;
+  for (int i = 0; i < in.dims().size(); ++i) {
+    axis.emplace_back(i);
+  }
+  std::swap(axis[0], axis[split_axis]);
+
+  DDim out_dims = in.dims();
+  out_dims[split_axis] /= num_of_process;
+  out->Resize(out_dims);
+  dev_ctx->Alloc(out, dtype);
+
+  std::vector<int64_t> rows = BalancedSplit(in.dims()[0], num_chunks);
+  std::vector<int64_t> begins(num_chunks, 0);
+  for (int64_t i = 1; i < num_chunks; ++i) {
+    begins[i] = begins[i - 1] + rows[i - 1];
+  }
+
+  DenseTensor transposed[2];
+  DenseTensor scattered[2];
+  RunReshardPipeline(
+      dev_ctx,
+      process_ids,
+      num_chunks,
+      [&](int64_t i) {
+        DenseTensor chunk = in.Slice(begins[i], begins[i] + rows[i]);
+        RESHARD_FUNCTOR(
+            dev_ctx, Transpose, dtype, chunk, axis, &transposed[i % 2]);
+        // allocated on dev_ctx, as the collective runs on another stream
+        DDim scattered_dims = transposed[i % 2].dims();
+        scattered_dims[0] /= num_of_process;
+        scattered[i % 2].Resize(scattered_dims);
+        dev_ctx->Alloc(&scattered[i % 2], dtype);
+      },
+      [&](int64_t i, DeviceContext* comm_dev_ctx) {
+        RESHARD_FUNCTOR(comm_dev_ctx,
+                        ReduceScatter,
+                        dtype,
+                        transposed[i % 2],
+                        num_of_process,
+                        &scattered[i % 2]);
+      },
+      [&](int64_t i) {
+        DenseTensor out_chunk = out->Slice(begins[i], begins[i] + rows[i]);
+        RESHARD_FUNCTOR(
+            dev_ctx, Transpose, dtype, scattered[i % 2], axis, &out_chunk);
+      });
+}
+
+}  // namespace
+
 void ReshardPToSWithPadding(DeviceContext* dev_ctx,
                             int64_t split_axis,
                             const std::vector<int64_t>& process_ids,
@@ -57,7 +121,13 @@ void ReshardPToSWithPadding(DeviceContext* dev_ctx,
   const auto& logical_ddim = in.dims();
   auto dtype = in.dtype();
 
-  if (split_axis != 0) {
+  int64_t num_chunks =
+      split_axis != 0 ? GetReshardNumChunks(in.dims(), dtype) : 1;
+  DenseTensor out_result;
+  if (num_chunks > 1) {
+    PipelinedReshardPToS(
+        dev_ctx, split_axis, process_ids, in, num_chunks, &out_result);
+  } else if (split_axis != 0) {
     for (size_t i = 0; i < common::vectorize(logical_ddim).size(); ++i) {
       axis.emplace_back(i);
     }
@@ -67,21 +137,22 @@ void ReshardPToSWithPadding(DeviceContext* dev_ctx,
     in_reduce_scatter.ShareDataWith(in);
   }
 
-  DenseTensor out_reduce_scatter;
-  RESHARD_FUNCTOR_WITH_COMM(dev_ctx,
-                            ReduceScatter,
-                            dtype,
-                            process_ids,
-                            in_reduce_scatter,
-                            static_cast<int64_t>(process_ids.size()),
-                            &out_reduce_scatter);
-
-  DenseTensor out_result;
-  if (split_axis != 0) {
-    RESHARD_FUNCTOR(
-        dev_ctx, Transpose, dtype, out_reduce_scatter, axis, &out_result);
-  } else {
-    out_result.ShareDataNoCheckWith(out_reduce_scatter);
+  if (num_chunks == 1) {
+    DenseTensor out_reduce_scatter;
+    RESHARD_FUNCTOR_WITH_COMM(dev_ctx,
+                              ReduceScatter,
+                              dtype,
+                              process_ids,
+                              in_reduce_scatter,
+                              static_cast<int64_t>(process_ids.size()),
+                              &out_reduce_scatter);
+
+    if (split_axis != 0) {
+      RESHARD_FUNCTOR(
+          dev_ctx, Transpose, dtype, out_reduce_scatter, axis, &out_result);
+    } else {
+      out_result.ShareDataNoCheckWith(out_reduce_scatter);
+    }
   }
 
   int64_t cur_global_rank = GetCurGlobalRank();
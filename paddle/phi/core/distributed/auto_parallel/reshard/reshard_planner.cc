@@ -0,0 +1,323 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_planner.h"
+
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/distributed/auto_parallel/process_mesh.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+// of NVLink and of a 200Gb/s NIC, the latency of a collective is by far the
+// main cost of small tensors
+constexpr double kIntraNodeLatency = 1e-5;
+constexpr double kIntraNodeBandwidth = 1e11;
+constexpr double kInterNodeLatency = 3e-5;
+constexpr double kInterNodeBandwidth = 2.5e10;
+// of the local kernels
+constexpr double kDeviceBandwidth = 1e12;
+
+int64_t LocalSize() {
+  static int64_t local_size = [] {
+    const char* value = std::getenv("PADDLE_LOCAL_SIZE");
+    return value == nullptr ? int64_t(0) : std::atoll(value);
+  }();
+  return local_size;
+}
+
+bool IsIntraNodeAxis(const ProcessMesh& mesh, int64_t axis) {
+  int64_t local_size = LocalSize();
+  if (local_size <= 0) {
+    // unknown, as if all on one node
+    return true;
+  }
+  const auto& shape = mesh.shape();
+  const auto& process_ids = mesh.process_ids();
+  int64_t stride = 1;
+  for (int64_t i = axis + 1; i < static_cast<int64_t>(shape.size()); ++i) {
+    stride *= shape[i];
+  }
+  for (int64_t k = 0; k < static_cast<int64_t>(process_ids.size()); ++k) {
+    int64_t first = k - (k / stride) % shape[axis] * stride;
+    if (process_ids[k] / local_size != process_ids[first] / local_size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct PlanState {
+  std::vector<int64_t> dims_mapping;
+  // of the partial mesh axes
+  uint64_t partial_axes = 0;
+
+  std::string key() const {
+    std::string key;
+    for (auto axis : dims_mapping) {
+      key += std::to_string(axis) + ",";
+    }
+    return key + std::to_string(partial_axes);
+  }
+};
+
+PlanState GetPlanState(const TensorDistAttr& dist_attr) {
+  PlanState state;
+  state.dims_mapping = dist_attr.dims_mapping();
+  for (const auto& kv : dist_attr.partial_status()) {
+    state.partial_axes |= uint64_t(1) << kv.first;
+  }
+  return state;
+}
+
+int64_t LocalBytes(const ProcessMesh& mesh,
+                   const PlanState& state,
+                   const DDim& dims,
+                   DataType dtype) {
+  int64_t numel = 1;
+  for (int64_t i = 0; i < dims.size(); ++i) {
+    int64_t axis = state.dims_mapping[i];
+    int64_t size = axis == -1 ? 1 : mesh.dim_size(axis);
+    numel *= (dims[i] + size - 1) / size;
+  }
+  return numel * static_cast<int64_t>(phi::SizeOf(dtype));
+}
+
+PlanState ApplyStep(const PlanState& state, const ReshardStep& step) {
+  PlanState next = state;
+  uint64_t bit = uint64_t(1) << step.mesh_axis;
+  switch (step.type) {
+    case ReshardStep::Type::kPToR:
+      next.partial_axes &= ~bit;
+      break;
+    case ReshardStep::Type::kPToS:
+      next.partial_axes &= ~bit;
+      next.dims_mapping[step.out_dim] = step.mesh_axis;
+      break;
+    case ReshardStep::Type::kSToR:
+      next.dims_mapping[step.in_dim] = -1;
+      break;
+    case ReshardStep::Type::kRToS:
+      next.dims_mapping[step.out_dim] = step.mesh_axis;
+      break;
+    case ReshardStep::Type::kSToS:
+      next.dims_mapping[step.in_dim] = -1;
+      next.dims_mapping[step.out_dim] = step.mesh_axis;
+      break;
+    case ReshardStep::Type::kRToP:
+      next.partial_axes |= bit;
+      break;
+  }
+  return next;
+}
+
+// The steps on each axis of mesh from state, an axis shards at most one dim
+// and is not partial then.
+std::vector<ReshardStep> NextSteps(const ProcessMesh& mesh,
+                                   const PlanState& state,
+                                   const PlanState& target,
+                                   const DDim& dims) {
+  std::vector<ReshardStep> steps;
+  int64_t ndim = static_cast<int64_t>(state.dims_mapping.size());
+  for (int64_t axis = 0; axis < mesh.ndim(); ++axis) {
+    int64_t size = mesh.dim_size(axis);
+    uint64_t bit = uint64_t(1) << axis;
+    int64_t shard_dim = -1;
+    for (int64_t i = 0; i < ndim; ++i) {
+      if (state.dims_mapping[i] == axis) {
+        shard_dim = i;
+      }
+    }
+
+    if (state.partial_axes & bit) {
+      steps.push_back({ReshardStep::Type::kPToR, axis});
+      for (int64_t i = 0; i < ndim; ++i) {
+        if (state.dims_mapping[i] == -1) {
+          steps.push_back({ReshardStep::Type::kPToS, axis, -1, i});
+        }
+      }
+    } else if (shard_dim != -1) {
+      steps.push_back({ReshardStep::Type::kSToR, axis, shard_dim});
+      // the all to all of SToSReshardFunction only splits evenly
+      if (dims[shard_dim] % size != 0) {
+        continue;
+      }
+      for (int64_t i = 0; i < ndim; ++i) {
+        if (state.dims_mapping[i] == -1 && dims[i] % size == 0) {
+          steps.push_back({ReshardStep::Type::kSToS, axis, shard_dim, i});
+        }
+      }
+    } else {
+      for (int64_t i = 0; i < ndim; ++i) {
+        if (state.dims_mapping[i] == -1) {
+          steps.push_back({ReshardStep::Type::kRToS, axis, -1, i});
+        }
+      }
+      if (target.partial_axes & bit) {
+        steps.push_back({ReshardStep::Type::kRToP, axis});
+      }
+    }
+  }
+  return steps;
+}
+
+}  // namespace
+
+std::string ReshardStep::to_string() const {
+  static const char* names[] = {"PToR", "PToS", "SToR", "RToS", "SToS", "RToP"};
+  return std::string(names[static_cast<int>(type)]) +
+         "(mesh_axis=" + std::to_string(mesh_axis) +
+         ", in_dim=" + std::to_string(in_dim) +
+         ", out_dim=" + std::to_string(out_dim) + ")";
+}
+
+double ReshardStepCost(const ProcessMesh& mesh,
+                       const ReshardStep& step,
+                       int64_t local_bytes) {
+  double n = static_cast<double>(mesh.dim_size(step.mesh_axis));
+  double bytes = static_cast<double>(local_bytes);
+  bool intra_node = IsIntraNodeAxis(mesh, step.mesh_axis);
+  double latency = intra_node ? kIntraNodeLatency : kInterNodeLatency;
+  double bandwidth = intra_node ? kIntraNodeBandwidth : kInterNodeBandwidth;
+  // the bytes sent by each rank, as a ring would
+  switch (step.type) {
+    case ReshardStep::Type::kPToR:
+      return latency + 2 * (n - 1) / n * bytes / bandwidth;
+    case ReshardStep::Type::kPToS:
+    case ReshardStep::Type::kSToS:
+      return latency + (n - 1) / n * bytes / bandwidth;
+    case ReshardStep::Type::kSToR:
+      return latency + (n - 1) * bytes / bandwidth;
+    case ReshardStep::Type::kRToS:
+      return bytes / n / kDeviceBandwidth;
+    case ReshardStep::Type::kRToP:
+      return bytes / kDeviceBandwidth;
+  }
+  return 0;
+}
+
+ReshardPlanner& ReshardPlanner::Instance() {
+  static ReshardPlanner planner;
+  return planner;
+}
+
+ReshardPlan ReshardPlanner::GetPlan(const TensorDistAttr& in_dist_attr,
+                                    const TensorDistAttr& out_dist_attr,
+                                    const DDim& dims,
+                                    DataType dtype) {
+  std::string key = in_dist_attr.to_string() + "->" +
+                    out_dist_attr.to_string() + ";" + dims.to_str() + ";" +
+                    DataTypeToString(dtype);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = plans_.find(key);
+    if (iter != plans_.end()) {
+      return iter->second;
+    }
+  }
+  ReshardPlan plan = Search(in_dist_attr, out_dist_attr, dims, dtype);
+  VLOG(3) << "Plan the reshard from " << in_dist_attr.to_string() << " to "
+          << out_dist_attr.to_string() << " of dims " << dims << " with "
+          << plan.steps.size() << " steps, cost " << plan.cost << "s";
+  for (const auto& step : plan.steps) {
+    VLOG(3) << "  " << step.to_string();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  plans_[key] = plan;
+  return plan;
+}
+
+ReshardPlan ReshardPlanner::Search(const TensorDistAttr& in_dist_attr,
+                                   const TensorDistAttr& out_dist_attr,
+                                   const DDim& dims,
+                                   DataType dtype) {
+  const auto& mesh = in_dist_attr.process_mesh();
+  PlanState source = GetPlanState(in_dist_attr);
+  PlanState target = GetPlanState(out_dist_attr);
+  const std::string target_key = target.key();
+
+  // Dijkstra over the placements, from the source
+  std::vector<PlanState> states = {source};
+  std::vector<double> costs = {0};
+  // the state and step each state is reached by
+  std::vector<std::pair<int64_t, ReshardStep>> parents = {
+      {-1, ReshardStep{ReshardStep::Type::kPToR}}};
+  std::unordered_map<std::string, int64_t> ids = {{source.key(), 0}};
+  std::vector<bool> visited = {false};
+  using Item = std::pair<double, int64_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+  queue.emplace(0, 0);
+
+  int64_t target_id = -1;
+  while (!queue.empty()) {
+    auto item = queue.top();
+    queue.pop();
+    int64_t id = item.second;
+    if (visited[id]) {
+      continue;
+    }
+    visited[id] = true;
+    if (states[id].key() == target_key) {
+      target_id = id;
+      break;
+    }
+    const PlanState state = states[id];
+    int64_t local_bytes = LocalBytes(mesh, state, dims, dtype);
+    for (const auto& step : NextSteps(mesh, state, target, dims)) {
+      double cost = costs[id] + ReshardStepCost(mesh, step, local_bytes);
+      PlanState next = ApplyStep(state, step);
+      auto key = next.key();
+      auto iter = ids.find(key);
+      if (iter == ids.end()) {
+        iter = ids.emplace(key, states.size()).first;
+        states.push_back(next);
+        costs.push_back(cost);
+        parents.emplace_back(id, step);
+        visited.push_back(false);
+      } else if (cost < costs[iter->second]) {
+        costs[iter->second] = cost;
+        parents[iter->second] = std::make_pair(id, step);
+      } else {
+        continue;
+      }
+      queue.emplace(cost, iter->second);
+    }
+  }
+
+  PADDLE_ENFORCE_NE(target_id,
+                    -1,
+                    phi::errors::InvalidArgument(
+                        "Can not plan the reshard from %s to %s.",
+                        in_dist_attr.to_string(),
+                        out_dist_attr.to_string()));
+  ReshardPlan plan;
+  plan.cost = costs[target_id];
+  for (int64_t id = target_id; parents[id].first != -1;
+       id = parents[id].first) {
+    plan.steps.insert(plan.steps.begin(), parents[id].second);
+  }
+  return plan;
+}
+
+}  // namespace distributed
+}  // namespace phi
@@ -0,0 +1,97 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/common/ddim.h"
+#include "paddle/common/macros.h"
+#include "paddle/phi/common/data_type.h"
+
+namespace phi {
+namespace distributed {
+
+class ProcessMesh;
+class TensorDistAttr;
+
+// A reshard on one axis of a process mesh, run by a 1-D reshard function on
+// the sub mesh of the axis.
+struct ReshardStep {
+  enum class Type {
+    kPToR,  // all reduce
+    kPToS,  // reduce scatter to out_dim
+    kSToR,  // all gather of in_dim
+    kRToS,  // local slice of out_dim
+    kSToS,  // all to all from in_dim to out_dim
+    kRToP,  // local, keeps the value on one rank of the axis
+  };
+
+  Type type;
+  int64_t mesh_axis = -1;
+  int64_t in_dim = -1;
+  int64_t out_dim = -1;
+
+  std::string to_string() const;
+};
+
+struct ReshardPlan {
+  std::vector<ReshardStep> steps;
+  // estimated, in seconds
+  double cost = 0;
+};
+
+// The cost in seconds of step from a tensor of local_bytes on each rank, by
+// the latency and bandwidth of the axis of mesh: intra node if all the ranks
+// of the axis are on the same node of PADDLE_LOCAL_SIZE ranks, else inter
+// node.
+double ReshardStepCost(const ProcessMesh& mesh,
+                       const ReshardStep& step,
+                       int64_t local_bytes);
+
+// Plans the reshards between the dist attrs of the same nd mesh as the
+// cheapest sequence of steps by ReshardStepCost, among all the orders and
+// intermediate placements of the axes, e.g. an all gather on one axis and
+// an all to all on the other instead of all gathering the tensor on both
+// axes of an [S0, S1] to [S1, S0] reshard. The plans are cached by dist
+// attrs, shape and dtype.
+class ReshardPlanner {
+ public:
+  static ReshardPlanner& Instance();
+
+  ReshardPlan GetPlan(const TensorDistAttr& in_dist_attr,
+                      const TensorDistAttr& out_dist_attr,
+                      const DDim& dims,
+                      DataType dtype);
+
+ private:
+  ReshardPlanner() = default;
+
+  ReshardPlan Search(const TensorDistAttr& in_dist_attr,
+                     const TensorDistAttr& out_dist_attr,
+                     const DDim& dims,
+                     DataType dtype);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, ReshardPlan> plans_;
+
+  DISABLE_COPY_AND_ASSIGN(ReshardPlanner);
+};
+
+}  // namespace distributed
+}  // namespace phi
@@ -14,7 +14,10 @@
 
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
 
+#include <algorithm>
+
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/core/device_context.h"
 #include "paddle/phi/core/distributed/auto_parallel/process_mesh.h"
@@ -23,6 +26,13 @@
 #include "paddle/phi/core/distributed/store/store_utils.h"
 #include "paddle/phi/core/enforce.h"
 
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/distributed/nccl_comm_context.h"
+#endif
+
+COMMON_DECLARE_int64(auto_parallel_reshard_chunk_size_mb);
+
 namespace phi {
 namespace distributed {
 
@@ -34,6 +44,24 @@ std::string GenUniqueCommKey(const std::vector<int64_t>& process_ids) {
   }
   return unique_comm_key;
 }
+
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+void RecordEvent(gpuEvent_t event, gpuStream_t stream) {
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+#endif
+}
+
+void StreamWaitEvent(gpuStream_t stream, gpuEvent_t event) {
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(stream, event, 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(stream, event, 0));
+#endif
+}
+#endif
 }  // namespace
 
 std::vector<int64_t> GetUnionProcessIds(std::vector<int64_t> in_process_ids,
@@ -135,6 +163,79 @@ CommContext* CreateOrGetCommContext(const DeviceContext& dev_ctx,
   return comm_context;
 }
 
+int64_t GetReshardNumChunks(const DDim& dims, DataType dtype) {
+  if (FLAGS_auto_parallel_reshard_chunk_size_mb <= 0 || dims.size() < 2) {
+    return 1;
+  }
+  int64_t chunk_bytes = FLAGS_auto_parallel_reshard_chunk_size_mb << 20;
+  int64_t bytes = product(dims) * static_cast<int64_t>(phi::SizeOf(dtype));
+  int64_t num_chunks = (bytes + chunk_bytes - 1) / chunk_bytes;
+  return std::max<int64_t>(std::min(num_chunks, dims[0]), 1);
+}
+
+void RunReshardPipeline(
+    DeviceContext* dev_ctx,
+    const std::vector<int64_t>& process_ids,
+    int64_t num_chunks,
+    const std::function<void(int64_t)>& produce,
+    const std::function<void(int64_t, DeviceContext*)>& communicate,
+    const std::function<void(int64_t)>& consume) {
+  auto* comm_context = CreateOrGetCommContext(*dev_ctx, process_ids);
+  dev_ctx->SetCommContext(comm_context);
+  DeviceContext* comm_dev_ctx = dev_ctx;
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+  gpuStream_t calc_stream = nullptr;
+  gpuStream_t comm_stream = nullptr;
+  std::shared_ptr<std::remove_pointer<gpuEvent_t>::type> compute_event;
+  // of the chunks in flight, by chunk % 2
+  std::shared_ptr<std::remove_pointer<gpuEvent_t>::type> comm_events[2];
+  if (phi::GPUContext::classof(dev_ctx)) {
+    auto* nccl_comm_context = static_cast<NCCLCommContext*>(comm_context);
+    auto* nccl_dev_ctx = nccl_comm_context->GetDevContext();
+    if (nccl_dev_ctx != nullptr && num_chunks > 1) {
+      nccl_dev_ctx->SetCommContext(comm_context);
+      comm_dev_ctx = nccl_dev_ctx;
+      calc_stream = static_cast<GPUContext*>(dev_ctx)->stream();
+      comm_stream = nccl_dev_ctx->stream();
+      int device_id = dev_ctx->GetPlace().GetDeviceId();
+      compute_event = phi::memory_utils::GetCudaEvent(device_id);
+      comm_events[0] = phi::memory_utils::GetCudaEvent(device_id);
+      comm_events[1] = phi::memory_utils::GetCudaEvent(device_id);
+    }
+  }
+#endif
+
+  VLOG(3) << "Run reshard pipeline of " << num_chunks << " chunks";
+  for (int64_t i = 0; i <= num_chunks; ++i) {
+    if (i < num_chunks) {
+      produce(i);
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+      if (comm_stream != nullptr) {
+        // after produce of this chunk and consume of chunk i - 2, which
+        // shared its temporaries
+        RecordEvent(compute_event.get(), calc_stream);
+        StreamWaitEvent(comm_stream, compute_event.get());
+      }
+#endif
+      communicate(i, comm_dev_ctx);
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+      if (comm_stream != nullptr) {
+        RecordEvent(comm_events[i % 2].get(), comm_stream);
+      }
+#endif
+    }
+    // queued after the collective of chunk i, so that they overlap
+    if (i > 0) {
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+      if (comm_stream != nullptr) {
+        StreamWaitEvent(calc_stream, comm_events[(i - 1) % 2].get());
+      }
+#endif
+      consume(i - 1);
+    }
+  }
+}
+
 std::map<int, int64_t> GetSplitAxisWithDimsMapping(
     const std::vector<int64_t>& dims_mapping) {
   std::map<int, int64_t> split_axis_to_mesh_axis;
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -74,6 +75,25 @@ std::vector<int64_t> BalancedSplit(int64_t total_nums, int64_t num_of_pieces);
 CommContext* CreateOrGetCommContext(const DeviceContext& dev_ctx,
                                     const std::vector<int64_t>& process_ids);
 
+// The number of chunks along axis 0 a reshard of a tensor of dims and dtype
+// is pipelined in, see FLAGS_auto_parallel_reshard_chunk_size_mb. Returns 1
+// if it should not be chunked.
+int64_t GetReshardNumChunks(const DDim& dims, DataType dtype);
+
+// Runs a reshard among process_ids in num_chunks chunks. For each chunk,
+// produce queues the kernels preparing it on dev_ctx, communicate queues its
+// collective on the given context, and consume queues the kernels using the
+// result on dev_ctx. On GPU the collectives run on the stream of the comm
+// context, the collective of chunk i overlapping consume of chunk i - 1.
+// The temporaries of chunk i may be reused by chunk i + 2.
+void RunReshardPipeline(
+    DeviceContext* dev_ctx,
+    const std::vector<int64_t>& process_ids,
+    int64_t num_chunks,
+    const std::function<void(int64_t)>& produce,
+    const std::function<void(int64_t, DeviceContext*)>& communicate,
+    const std::function<void(int64_t)>& consume);
+
 phi::DDim InferShapeForReshardFromReplicate(
     const std::shared_ptr<phi::DenseTensor>& global_value,
     const TensorDistAttr& dist_attr);
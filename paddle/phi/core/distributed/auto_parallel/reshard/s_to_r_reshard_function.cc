@@ -31,6 +31,82 @@ namespace distributed {
 
 namespace {
 
+// The all gather along axis 0 and concat along split_axis of the input
+// chunked along axis 0, for which the rows of out are contiguous.
+void PipelinedReshardSToR(DeviceContext* dev_ctx,
+                          int64_t split_axis,
+                          const std::vector<int64_t>& process_ids,
+                          const DenseTensor& in,
+                          int64_t padding_nums,
+                          int64_t num_chunks,
+                          DenseTensor* out) {
+  int64_t num_of_process = process_ids.size();
+  auto dtype = in.dtype();
+
+  DDim out_dims = in.dims();
+  out_dims[split_axis] = out_dims[split_axis] * num_of_process - padding_nums;
+  out->Resize(out_dims);
+  dev_ctx->Alloc(out, dtype);
+
+  std::vector<int64_t> rows = BalancedSplit(in.dims()[0], num_chunks);
+  std::vector<int64_t> begins(num_chunks, 0);
+  for (int64_t i = 1; i < num_chunks; ++i) {
+    begins[i] = begins[i - 1] + rows[i - 1];
+  }
+
+  DenseTensor gathered[2];
+  RunReshardPipeline(
+      dev_ctx,
+      process_ids,
+      num_chunks,
+      [&](int64_t i) {
+        // allocated on dev_ctx, as the collective runs on another stream
+        DDim gathered_dims = in.dims();
+        gathered_dims[0] = rows[i] * num_of_process;
+        gathered[i % 2].Resize(gathered_dims);
+        dev_ctx->Alloc(&gathered[i % 2], dtype);
+      },
+      [&](int64_t i, DeviceContext* comm_dev_ctx) {
+        DenseTensor chunk = in.Slice(begins[i], begins[i] + rows[i]);
+        RESHARD_FUNCTOR(comm_dev_ctx,
+                        AllGather,
+                        dtype,
+                        chunk,
+                        num_of_process,
+                        &gathered[i % 2]);
+      },
+      [&](int64_t i) {
+        std::vector<DenseTensor> split_out_vec;
+        split_out_vec.reserve(num_of_process);
+        for (int64_t j = 0; j < num_of_process; ++j) {
+          split_out_vec.emplace_back(
+              gathered[i % 2].Slice(j * rows[i], (j + 1) * rows[i]));
+        }
+        if (padding_nums != 0) {
+          std::vector<DenseTensor> tmp_out_vec;
+          IntArray tmp_sections(std::vector<int64_t>{
+              in.dims()[split_axis] - padding_nums, padding_nums});
+          RESHARD_FUNCTOR(dev_ctx,
+                          Split,
+                          dtype,
+                          split_out_vec[num_of_process - 1],
+                          tmp_sections,
+                          split_axis,
+                          &tmp_out_vec);
+          split_out_vec[num_of_process - 1] = tmp_out_vec[0];
+        }
+
+        std::vector<const DenseTensor*> concat_input_vec;
+        concat_input_vec.reserve(split_out_vec.size());
+        for (const auto& tensor : split_out_vec) {
+          concat_input_vec.emplace_back(&tensor);
+        }
+        DenseTensor out_chunk = out->Slice(begins[i], begins[i] + rows[i]);
+        RESHARD_FUNCTOR(
+            dev_ctx, Concat, dtype, concat_input_vec, split_axis, &out_chunk);
+      });
+}
+
 void ReshardSToRWithPadding(DeviceContext* dev_ctx,
                             int64_t split_axis,
                             const std::vector<int64_t>& process_ids,
@@ -40,6 +116,19 @@ void ReshardSToRWithPadding(DeviceContext* dev_ctx,
   int64_t num_of_process = process_ids.size();
   auto dtype = in.dtype();
 
+  int64_t num_chunks =
+      split_axis != 0 ? GetReshardNumChunks(in.dims(), dtype) : 1;
+  if (num_chunks > 1) {
+    PipelinedReshardSToR(dev_ctx,
+                         split_axis,
+                         process_ids,
+                         in,
+                         padding_nums,
+                         num_chunks,
+                         out);
+    return;
+  }
+
   // For balanced split to replicate, we need to do all gather first.
   // If the input value doesn't split on axis 0, we need to split
   // and concat on specific axis.
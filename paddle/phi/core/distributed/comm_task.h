@@ -79,6 +79,8 @@ class CommTask {
   int GetSize() { return size_; }
   int GetGid() { return gid_; }
   int64_t GetNumel() { return numel_; }
+  int64_t GetBytes() { return bytes_; }
+  void SetBytes(int64_t bytes) { bytes_ = bytes; }
   uint64_t GetSeq() { return seq_; }
   CommType GetCommType() { return comm_type_; }
   bool GetTraceUpdated() { return start_trace_updated_; }
@@ -108,6 +110,12 @@ class CommTask {
     return;
   }
 
+  // the microseconds since epoch the collective started and completed at,
+  // false if it is not timed, see CommTelemetry
+  virtual bool GetTiming(int64_t* start_us UNUSED, int64_t* end_us UNUSED) {
+    return false;
+  }
+
   virtual void ClearRecord() {
     PADDLE_THROW(
         phi::errors::Unimplemented("%s is not implemented.", __func__));
@@ -160,6 +168,7 @@ class CommTask {
   int gid_;
   uint64_t seq_{0};
   int64_t numel_;
+  int64_t bytes_{0};
   ncclComm_t nccl_comm_;
   gpuStream_t nccl_stream_;
   CommType comm_type_;
@@ -34,6 +34,7 @@
 
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/phi/core/distributed/comm_task_manager.h"
+#include "paddle/phi/core/distributed/comm_telemetry.h"
 #include "paddle/phi/core/distributed/nccl_comm_context.h"
 #endif
 
@@ -182,6 +183,9 @@ void CommTaskManager::CommTaskLoop() {
       } else {
         if (task->IsStarted()) {
           if (task->IsCompleted()) {
+            if (CommTelemetry::IsEnabled()) {
+              CommTelemetry::GetInstance().Record(task.get());
+            }
             CommTaskClearEnqueue(task);
             iter = comm_task_list_.erase(iter);
           } else {
@@ -211,6 +215,9 @@ void CommTaskManager::CommTaskLoop() {
          iter != start_comm_task_map_.end();) {
       auto task = iter->second;
       if (task->IsCompleted()) {
+        if (CommTelemetry::IsEnabled()) {
+          CommTelemetry::GetInstance().Record(task.get());
+        }
         CommTaskClearEnqueue(task);
         UpdateLastCommTask(task);
         iter = start_comm_task_map_.erase(iter);
@@ -220,6 +227,10 @@ void CommTaskManager::CommTaskLoop() {
       }
     }
 
+    if (CommTelemetry::IsEnabled()) {
+      CommTelemetry::GetInstance().MaybeExport();
+    }
+
     if (comm_task_list_.empty() && init_comm_task_map_.empty() &&
         start_comm_task_map_.empty()) {
       done = true;
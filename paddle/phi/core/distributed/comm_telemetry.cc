@@ -0,0 +1,301 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/comm_telemetry.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/core/distributed/comm_task.h"
+#include "paddle/phi/core/distributed/store/store.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/metrics.h"
+
+COMMON_DECLARE_bool(enable_async_trace);
+COMMON_DECLARE_bool(enable_comm_telemetry);
+COMMON_DECLARE_int32(comm_telemetry_export_interval_s);
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+constexpr size_t kMaxRecords = 4096;
+// by group in each export
+constexpr size_t kMaxExportedRecords = 256;
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string TelemetryKey(const std::string& group_key, int rank) {
+  return "comm_telemetry/" + group_key + "/" + std::to_string(rank);
+}
+
+}  // namespace
+
+CommTimeReference::CommTimeReference(int device_id) {
+  backends::gpu::GPUDeviceGuard guard(device_id);
+  gpuStream_t stream;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventCreate(&event_));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event_, stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event_));
+  time_us_ = NowUs();
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(stream));
+#else  // PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventCreate(&event_));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event_, stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event_));
+  time_us_ = NowUs();
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(stream));
+#endif
+}
+
+CommTimeReference::~CommTimeReference() {
+#ifdef PADDLE_WITH_CUDA
+  cudaEventDestroy(event_);
+#else  // PADDLE_WITH_HIP
+  hipEventDestroy(event_);
+#endif
+}
+
+int64_t CommTimeReference::TimeUs(gpuEvent_t event) const {
+  float ms = 0;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventElapsedTime(&ms, event_, event));
+#else  // PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventElapsedTime(&ms, event_, event));
+#endif
+  return time_us_ + static_cast<int64_t>(ms * 1000);
+}
+
+CommTelemetry& CommTelemetry::GetInstance() {
+  static CommTelemetry instance;
+  return instance;
+}
+
+bool CommTelemetry::IsEnabled() {
+  // the collectives are only traced with the async trace
+  return FLAGS_enable_comm_telemetry && FLAGS_enable_async_trace;
+}
+
+std::shared_ptr<CommTimeReference> CommTelemetry::GetReference(
+    int device_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now = std::chrono::steady_clock::now();
+  auto& reference = references_[device_id];
+  if (reference.first == nullptr ||
+      now - reference.second >=
+          std::chrono::seconds(FLAGS_comm_telemetry_export_interval_s)) {
+    reference.first = std::make_shared<CommTimeReference>(device_id);
+    reference.second = now;
+  }
+  return reference.first;
+}
+
+void CommTelemetry::Record(CommTask* task) {
+  CommRecord record;
+  if (!task->GetTiming(&record.start_us, &record.end_us)) {
+    return;
+  }
+  record.group_key = task->GroupKey();
+  record.global_rank = task->GetGlobalRank();
+  record.rank = task->GetRank();
+  record.size = task->GetSize();
+  record.seq = task->GetSeq();
+  record.comm_type = task->GetCommType();
+  record.bytes = task->GetBytes();
+
+  // the size of the collective and the ratio of the bytes on the busiest
+  // link to it, as nccl-tests reports them
+  double nranks = record.size;
+  double size = static_cast<double>(record.bytes);
+  double factor = 1;
+  switch (record.comm_type) {
+    case CommType::ALLREDUCE:
+      factor = 2 * (nranks - 1) / nranks;
+      break;
+    case CommType::ALLGATHER:
+      // the bytes are the ones of a rank
+      size *= nranks;
+      factor = (nranks - 1) / nranks;
+      break;
+    case CommType::REDUCE_SCATTER:
+    case CommType::ALLTOALL:
+      factor = (nranks - 1) / nranks;
+      break;
+    default:
+      break;
+  }
+  int64_t time_us = std::max<int64_t>(record.end_us - record.start_us, 1);
+  record.algbw = size / static_cast<double>(time_us) / 1e3;
+  record.busbw = record.algbw * factor;
+  MetricsRegistry::Instance()
+      .GetHistogram("paddle_comm_task_seconds",
+                    "Device time of the communication tasks.",
+                    "op=\"" + CommTypeToString(record.comm_type) + "\"")
+      ->Observe(static_cast<double>(time_us) / 1e6);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& summary =
+      summaries_[std::make_pair(record.group_key, record.comm_type)];
+  ++summary.count;
+  summary.bytes += record.bytes;
+  summary.time_us += time_us;
+  summary.busbw_sum += record.busbw;
+  groups_[record.group_key] = std::make_pair(record.rank, record.size);
+  if (task->GetStore() != nullptr) {
+    store_ = task->GetStore();
+  }
+  records_.emplace_back(std::move(record));
+  if (records_.size() > kMaxRecords) {
+    records_.pop_front();
+  }
+}
+
+void CommTelemetry::MaybeExport() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_export_time_ <
+        std::chrono::seconds(FLAGS_comm_telemetry_export_interval_s)) {
+      return;
+    }
+    last_export_time_ = now;
+  }
+  Export();
+}
+
+void CommTelemetry::Export() {
+  std::shared_ptr<Store> store;
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> exports;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& item : summaries_) {
+      const auto& summary = item.second;
+      LOG(INFO) << "Comm telemetry of group_key:" << item.first.first
+                << ",op:" << CommTypeToString(item.first.second)
+                << ",count:" << summary.count
+                << ",bytes:" << summary.bytes / summary.count
+                << ",time_us:" << summary.time_us / summary.count
+                << ",busbw:" << summary.busbw_sum / summary.count << "GB/s";
+    }
+    summaries_.clear();
+
+    store = store_;
+    for (const auto& group : groups_) {
+      // seq,comm_type,start_us; of the latest records
+      std::vector<std::string> entries;
+      for (auto iter = records_.rbegin();
+           iter != records_.rend() && entries.size() < kMaxExportedRecords;
+           ++iter) {
+        if (iter->group_key != group.first) {
+          continue;
+        }
+        entries.push_back(std::to_string(iter->seq) + "," +
+                          std::to_string(static_cast<int>(iter->comm_type)) +
+                          "," + std::to_string(iter->start_us) + ";");
+      }
+      std::string value;
+      for (auto iter = entries.rbegin(); iter != entries.rend(); ++iter) {
+        value += *iter;
+      }
+      exports.emplace_back(TelemetryKey(group.first, group.second.first),
+                           std::vector<uint8_t>(value.begin(), value.end()));
+    }
+  }
+  if (store == nullptr) {
+    return;
+  }
+  for (const auto& item : exports) {
+    store->set(item.first, item.second);
+  }
+}
+
+std::vector<CommRecord> CommTelemetry::GetRecords() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::vector<CommRecord>(records_.begin(), records_.end());
+}
+
+std::vector<CommSkew> CommTelemetry::GetSkew(const std::string& group_key) {
+  std::shared_ptr<Store> store;
+  int size = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = groups_.find(group_key);
+    if (iter == groups_.end() || store_ == nullptr) {
+      return {};
+    }
+    store = store_;
+    size = iter->second.second;
+  }
+
+  // seq -> the comm type and the start time on each rank
+  std::map<uint64_t, std::pair<int, std::vector<int64_t>>> starts;
+  for (int rank = 0; rank < size; ++rank) {
+    const auto key = TelemetryKey(group_key, rank);
+    if (!store->check(key)) {
+      VLOG(3) << "No comm telemetry exported by rank " << rank
+              << " of group_key:" << group_key;
+      return {};
+    }
+    const auto value = store->get(key);
+    std::istringstream entries(std::string(value.begin(), value.end()));
+    std::string entry;
+    while (std::getline(entries, entry, ';')) {
+      uint64_t seq = 0;
+      int comm_type = 0;
+      int64_t start_us = 0;
+      char comma = 0;
+      std::istringstream fields(entry);
+      if (!(fields >> seq >> comma >> comm_type >> comma >> start_us)) {
+        continue;
+      }
+      auto& item = starts[seq];
+      item.first = comm_type;
+      item.second.resize(size, -1);
+      item.second[rank] = start_us;
+    }
+  }
+
+  std::vector<CommSkew> skews;
+  for (const auto& item : starts) {
+    const auto& times = item.second.second;
+    if (std::find(times.begin(), times.end(), -1) != times.end()) {
+      // not in the latest export of every rank
+      continue;
+    }
+    auto minmax = std::minmax_element(times.begin(), times.end());
+    CommSkew skew;
+    skew.seq = item.first;
+    skew.comm_type = static_cast<CommType>(item.second.first);
+    skew.skew_us = *minmax.second - *minmax.first;
+    skew.slowest_rank = static_cast<int>(minmax.second - times.begin());
+    skews.push_back(skew);
+  }
+  return skews;
+}
+
+}  // namespace distributed
+}  // namespace phi
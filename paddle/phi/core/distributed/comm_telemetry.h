@@ -0,0 +1,136 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/core/distributed/utils.h"
+
+namespace phi {
+namespace distributed {
+
+class CommTask;
+class Store;
+
+// Maps the CUDA events of a device to the system clock, which unlike the
+// GPU clocks is comparable across the nodes of a job (as far as they are
+// synchronized by NTP). Re-created periodically to bound the drift.
+class CommTimeReference {
+ public:
+  explicit CommTimeReference(int device_id);
+  ~CommTimeReference();
+
+  // the microseconds since epoch event completed at, event is a timing
+  // event of the device recorded after the reference
+  int64_t TimeUs(gpuEvent_t event) const;
+
+ private:
+  gpuEvent_t event_;
+  int64_t time_us_;
+
+  DISABLE_COPY_AND_ASSIGN(CommTimeReference);
+};
+
+// One completed collective of this rank.
+struct CommRecord {
+  std::string group_key;
+  int global_rank = -1;
+  int rank = -1;
+  int size = 0;
+  uint64_t seq = 0;
+  CommType comm_type = CommType::UNKNOWN;
+  int64_t bytes = 0;
+  // microseconds since epoch the kernel started and completed at
+  int64_t start_us = 0;
+  int64_t end_us = 0;
+  // GB/s, as defined by nccl-tests
+  double algbw = 0;
+  double busbw = 0;
+};
+
+// The arrival skew of the ranks of a collective, from their start times.
+struct CommSkew {
+  uint64_t seq = 0;
+  CommType comm_type = CommType::UNKNOWN;
+  int64_t skew_us = 0;
+  // rank in group arriving last
+  int slowest_rank = -1;
+};
+
+// Collects the timing of the collectives traced by CommTaskManager, see
+// FLAGS_enable_comm_telemetry. Every FLAGS_comm_telemetry_export_interval_s
+// it logs a summary by group and collective type and exports the start times
+// of the recent collectives of each group to the store, from which every
+// rank can compute the skew of the ranks.
+class CommTelemetry {
+ public:
+  static CommTelemetry& GetInstance();
+
+  static bool IsEnabled();
+
+  // the current reference of the device
+  std::shared_ptr<CommTimeReference> GetReference(int device_id);
+
+  // of a completed task
+  void Record(CommTask* task);
+
+  // exports if the interval elapsed since the last export
+  void MaybeExport();
+
+  // the latest records, oldest first
+  std::vector<CommRecord> GetRecords();
+
+  // of the collectives of group_key in the latest exports of all its ranks
+  std::vector<CommSkew> GetSkew(const std::string& group_key);
+
+ private:
+  CommTelemetry() = default;
+
+  void Export();
+
+  struct Summary {
+    int64_t count = 0;
+    int64_t bytes = 0;
+    int64_t time_us = 0;
+    double busbw_sum = 0;
+  };
+
+  std::mutex mutex_;
+  std::map<int, std::pair<std::shared_ptr<CommTimeReference>,
+                          std::chrono::steady_clock::time_point>>
+      references_;
+  std::deque<CommRecord> records_;
+  std::map<std::pair<std::string, CommType>, Summary> summaries_;
+  // the rank in group and size of the groups recorded
+  std::map<std::string, std::pair<int, int>> groups_;
+  std::shared_ptr<Store> store_;
+  std::chrono::steady_clock::time_point last_export_time_ =
+      std::chrono::steady_clock::now();
+
+  DISABLE_COPY_AND_ASSIGN(CommTelemetry);
+};
+
+}  // namespace distributed
+}  // namespace phi
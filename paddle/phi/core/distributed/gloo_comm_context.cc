@@ -40,6 +40,7 @@ GlooCommContext::GlooCommContext(
     : CommContext(rank, size) {
   gloo_context_ = std::make_shared<gloo::rendezvous::Context>(rank, size);
   gloo_context_->connectFullMesh(*store, device);
+  shm_comm_ = GlooShmComm::Create(rank, size, store.get(), device);
 }
 
 void GlooCommContext::Broadcast(phi::DenseTensor* out_tensor,
@@ -81,6 +82,10 @@ void GlooCommContext::AllReduce(phi::DenseTensor* out_tensor,
                                 const phi::DenseTensor& in_tensor,
                                 int reduce_type,
                                 uint32_t tag) {
+  if (shm_comm_ &&
+      shm_comm_->AllReduce(out_tensor, in_tensor, reduce_type, tag)) {
+    return;
+  }
   gloo::AllreduceOptions opts(gloo_context_);
   opts.setTag(tag);
   const auto& dtype = in_tensor.dtype();
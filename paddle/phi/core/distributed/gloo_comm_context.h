@@ -21,6 +21,7 @@
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/core/distributed/comm_context.h"
+#include "paddle/phi/core/distributed/gloo_shm_comm.h"
 
 namespace phi {
 class DenseTensor;
@@ -74,6 +75,9 @@ class GlooCommContext final : public CommContext {
   DISABLE_COPY_AND_ASSIGN(GlooCommContext);
 
   std::shared_ptr<gloo::rendezvous::Context> gloo_context_;
+  // all-reduces the ranks of one host in shared memory, null if no host runs
+  // two ranks of the group
+  std::unique_ptr<GlooShmComm> shm_comm_;
 };
 
 }  // namespace distributed
@@ -0,0 +1,424 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/gloo_shm_comm.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <gloo/allreduce.h>
+#include <gloo/rendezvous/prefix_store.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/distributed/gloo_utils.h"
+#include "paddle/phi/core/enforce.h"
+
+COMMON_DECLARE_bool(gloo_shm_allreduce);
+COMMON_DECLARE_int64(gloo_shm_buffer_size);
+
+namespace phi {
+namespace distributed {
+
+namespace {
+
+constexpr size_t kCacheLine = 64;
+
+// The nonce of the segment and the barrier of the local ranks, each counter
+// on its own cache line.
+struct ShmHeader {
+  uint64_t nonce;
+  alignas(kCacheLine) std::atomic<uint32_t> arrived;
+  alignas(kCacheLine) std::atomic<uint32_t> generation;
+};
+
+size_t AlignUp(size_t bytes) {
+  return (bytes + kCacheLine - 1) / kCacheLine * kCacheLine;
+}
+
+std::vector<char> ToBytes(const std::string& str) {
+  return std::vector<char>(str.begin(), str.end());
+}
+
+// The loops are kept plain so that the compiler vectorizes them.
+template <typename T>
+void ReduceInto(T* dst, const T* src, size_t n, ReduceType reduce_type) {
+  switch (reduce_type) {
+    case ReduceType::kRedSum:
+      for (size_t i = 0; i < n; ++i) dst[i] += src[i];
+      break;
+    case ReduceType::kRedMax:
+      for (size_t i = 0; i < n; ++i) dst[i] = std::max(dst[i], src[i]);
+      break;
+    case ReduceType::kRedProd:
+      for (size_t i = 0; i < n; ++i) dst[i] *= src[i];
+      break;
+    default:
+      // kRedMin, and kRedAll as the gloo all-reduce does
+      for (size_t i = 0; i < n; ++i) dst[i] = std::min(dst[i], src[i]);
+      break;
+  }
+}
+
+#ifndef _WIN32
+// The ranks that share both the boot id and the /dev/shm mount reach the
+// same shared memory. A host name is not enough, since machines and
+// containers may share one, and containers of one machine may each have
+// their own /dev/shm. Returns an empty string if unknown.
+std::string ShmDomain() {
+  std::ifstream boot_id_file("/proc/sys/kernel/random/boot_id");
+  std::string boot_id;
+  struct stat shm_stat;
+  if (!(boot_id_file >> boot_id) || stat("/dev/shm", &shm_stat) != 0) {
+    return "";
+  }
+  return boot_id + "/" + std::to_string(shm_stat.st_dev);
+}
+
+char* MapSegment(const std::string& name,
+                 int fd,
+                 size_t bytes,
+                 std::string* error) {
+  void* segment =
+      mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) {
+    *error = "failed to map the shared memory " + name + ", errno is " +
+             std::to_string(errno);
+    return nullptr;
+  }
+  return static_cast<char*>(segment);
+}
+
+char* CreateSegment(const std::string& name, size_t bytes, std::string* error) {
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd == -1) {
+    *error = "failed to create the shared memory " + name + ", errno is " +
+             std::to_string(errno);
+    return nullptr;
+  }
+  // allocate the pages up front, a segment larger than the free space of
+  // /dev/shm would raise SIGBUS on the first write past it otherwise
+  int ret = posix_fallocate(fd, 0, static_cast<off_t>(bytes));
+  if (ret != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    *error = "failed to allocate " + std::to_string(bytes) +
+             " bytes of the shared memory " + name + ", errno is " +
+             std::to_string(ret);
+    return nullptr;
+  }
+  char* segment = MapSegment(name, fd, bytes, error);
+  if (segment == nullptr) {
+    shm_unlink(name.c_str());
+  }
+  return segment;
+}
+
+char* OpenSegment(const std::string& name, size_t bytes, std::string* error) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd == -1) {
+    *error = "failed to open the shared memory " + name + ", errno is " +
+             std::to_string(errno);
+    return nullptr;
+  }
+  struct stat fd_stat;
+  if (fstat(fd, &fd_stat) != 0 ||
+      static_cast<size_t>(fd_stat.st_size) < bytes) {
+    close(fd);
+    *error = "the shared memory " + name + " is smaller than expected";
+    return nullptr;
+  }
+  return MapSegment(name, fd, bytes, error);
+}
+#endif
+
+bool IsSupported(int reduce_type) {
+  switch (static_cast<ReduceType>(reduce_type)) {
+    case ReduceType::kRedSum:
+    case ReduceType::kRedMax:
+    case ReduceType::kRedMin:
+    case ReduceType::kRedProd:
+    case ReduceType::kRedAll:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<GlooShmComm> GlooShmComm::Create(
+    int rank,
+    int size,
+    gloo::rendezvous::Store* store,
+    const std::shared_ptr<gloo::transport::Device>& device) {
+#ifdef _WIN32
+  return nullptr;
+#else
+  if (!FLAGS_gloo_shm_allreduce || size < 2) {
+    return nullptr;
+  }
+
+  // group the ranks by the shared memory they can reach, in the order of the
+  // ranks, a rank that cannot tell its own is a group of its own
+  std::string host = ShmDomain();
+  if (host.empty()) {
+    host = "rank_" + std::to_string(rank);
+  }
+  store->set("shm_host_" + std::to_string(rank), ToBytes(host));
+  std::vector<std::string> keys;
+  for (int i = 0; i < size; ++i) {
+    keys.push_back("shm_host_" + std::to_string(i));
+  }
+  store->wait(keys);
+  std::vector<std::string> host_order;
+  std::map<std::string, std::vector<int>> host_ranks;
+  size_t max_local_size = 0;
+  for (int i = 0; i < size; ++i) {
+    auto bytes = store->get(keys[i]);
+    std::string peer_host(bytes.begin(), bytes.end());
+    if (host_ranks.count(peer_host) == 0) {
+      host_order.push_back(peer_host);
+    }
+    host_ranks[peer_host].push_back(i);
+    max_local_size = std::max(max_local_size, host_ranks[peer_host].size());
+  }
+  if (max_local_size < 2) {
+    return nullptr;
+  }
+
+  std::unique_ptr<GlooShmComm> comm(new GlooShmComm());
+  const auto& local_ranks = host_ranks[host];
+  comm->local_size_ = static_cast<int>(local_ranks.size());
+  comm->local_rank_ = static_cast<int>(
+      std::find(local_ranks.begin(), local_ranks.end(), rank) -
+      local_ranks.begin());
+  comm->slot_bytes_ = AlignUp(static_cast<size_t>(std::max<int64_t>(
+      FLAGS_gloo_shm_buffer_size, static_cast<int64_t>(kCacheLine))));
+  comm->segment_bytes_ =
+      AlignUp(sizeof(ShmHeader)) + (comm->local_size_ + 1) * comm->slot_bytes_;
+
+  // The leader creates the segment and passes its name and a nonce by the
+  // store, an empty name if it failed. The nonce tells the local ranks that
+  // they mapped the very segment of their leader.
+  const int leader = local_ranks[0];
+  const std::string name_key = "shm_name_" + std::to_string(leader);
+  const std::string nonce_key = "shm_nonce_" + std::to_string(leader);
+  std::string shm_name;
+  std::string error;
+  if (rank == leader) {
+    static std::atomic<int> segment_count{0};
+    shm_name = "/paddle_gloo_" + std::to_string(getpid()) + "_" +
+               std::to_string(segment_count++);
+    const uint64_t nonce = std::random_device()();
+    comm->segment_ = CreateSegment(shm_name, comm->segment_bytes_, &error);
+    if (comm->segment_ != nullptr) {
+      new (comm->segment_) ShmHeader{nonce, {0}, {0}};
+    }
+    store->set(nonce_key, ToBytes(std::to_string(nonce)));
+    store->set(name_key, ToBytes(error.empty() ? shm_name : ""));
+  } else {
+    store->wait({name_key, nonce_key});
+    auto bytes = store->get(name_key);
+    shm_name.assign(bytes.begin(), bytes.end());
+    bytes = store->get(nonce_key);
+    const uint64_t nonce = std::stoull(std::string(bytes.begin(), bytes.end()));
+    if (shm_name.empty()) {
+      error = "the local rank " + std::to_string(leader) +
+              " failed to create the shared memory";
+    } else {
+      comm->segment_ = OpenSegment(shm_name, comm->segment_bytes_, &error);
+    }
+    if (comm->segment_ != nullptr &&
+        reinterpret_cast<ShmHeader*>(comm->segment_)->nonce != nonce) {
+      error = "the shared memory " + shm_name + " belongs to another rank";
+    }
+  }
+  if (!error.empty()) {
+    LOG(WARNING) << "Gloo rank " << rank << " cannot all-reduce through "
+                 << "shared memory: " << error << ".";
+  }
+
+  // Every rank of the group tells whether it set up, all of them fall back
+  // to gloo if one failed. The segment is unlinked once every local rank has
+  // tried to open it.
+  keys.clear();
+  for (int i = 0; i < size; ++i) {
+    keys.push_back("shm_ready_" + std::to_string(i));
+  }
+  store->set("shm_ready_" + std::to_string(rank),
+             ToBytes(error.empty() ? "1" : "0"));
+  store->wait(keys);
+  if (rank == leader && !shm_name.empty()) {
+    shm_unlink(shm_name.c_str());
+  }
+  for (const auto& key : keys) {
+    auto bytes = store->get(key);
+    if (std::string(bytes.begin(), bytes.end()) != "1") {
+      VLOG(3) << "Gloo rank " << rank << " all-reduces through gloo, since "
+              << "some rank failed to set up the shared memory";
+      return nullptr;
+    }
+  }
+
+  if (host_order.size() > 1 && rank == leader) {
+    int host_index = static_cast<int>(
+        std::find(host_order.begin(), host_order.end(), host) -
+        host_order.begin());
+    gloo::rendezvous::PrefixStore leader_store("shm_leaders", *store);
+    comm->leader_context_ = std::make_shared<gloo::rendezvous::Context>(
+        host_index, static_cast<int>(host_order.size()));
+    comm->leader_context_->connectFullMesh(leader_store, device);
+  }
+  VLOG(3) << "Gloo rank " << rank << " all-reduces through shared memory as "
+          << comm->local_rank_ << " of the " << comm->local_size_
+          << " ranks of " << host << ", with " << host_order.size()
+          << " hosts";
+  return comm;
+#endif
+}
+
+GlooShmComm::~GlooShmComm() {
+#ifndef _WIN32
+  if (segment_ != nullptr) {
+    munmap(segment_, segment_bytes_);
+  }
+#endif
+}
+
+char* GlooShmComm::slot(int local_rank) const {
+  return segment_ + AlignUp(sizeof(ShmHeader)) + local_rank * slot_bytes_;
+}
+
+void GlooShmComm::Barrier() {
+  auto* header = reinterpret_cast<ShmHeader*>(segment_);
+  uint32_t generation = header->generation.load(std::memory_order_acquire);
+  if (header->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      static_cast<uint32_t>(local_size_)) {
+    header->arrived.store(0, std::memory_order_relaxed);
+    header->generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  int spin = 0;
+  while (header->generation.load(std::memory_order_acquire) == generation) {
+    if (++spin > 1024) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+template <typename T>
+void GlooShmComm::AllReduceImpl(
+    T* out, const T* in, size_t numel, int reduce_type, uint32_t tag) {
+  const auto reduce_type_enum = static_cast<ReduceType>(reduce_type);
+  const size_t chunk = slot_bytes_ / sizeof(T);
+  T* local_slot = reinterpret_cast<T*>(slot(local_rank_));
+  T* result = reinterpret_cast<T*>(slot(local_size_));
+  for (size_t offset = 0; offset < numel; offset += chunk) {
+    const size_t len = std::min(chunk, numel - offset);
+    std::memcpy(local_slot, in + offset, len * sizeof(T));
+    Barrier();
+
+    // reduce scatter, each local rank reduces its share of the chunk
+    const size_t share = (len + local_size_ - 1) / local_size_;
+    const size_t begin = std::min(len, share * local_rank_);
+    const size_t end = std::min(len, begin + share);
+    if (begin < end) {
+      std::memcpy(result + begin,
+                  reinterpret_cast<T*>(slot(0)) + begin,
+                  (end - begin) * sizeof(T));
+      for (int i = 1; i < local_size_; ++i) {
+        ReduceInto(result + begin,
+                   reinterpret_cast<T*>(slot(i)) + begin,
+                   end - begin,
+                   reduce_type_enum);
+      }
+    }
+    Barrier();
+
+    if (leader_context_) {
+      gloo::AllreduceOptions opts(leader_context_);
+      opts.setTag(tag);
+      opts.setOutput(result, len);
+      SetReduceFunc<T>(&opts, reduce_type);
+      gloo::allreduce(opts);
+    }
+    Barrier();
+
+    // all gather, the result area is rewritten only after all the copies
+    std::memcpy(out + offset, result, len * sizeof(T));
+    Barrier();
+  }
+}
+
+bool GlooShmComm::AllReduce(phi::DenseTensor* out_tensor,
+                            const phi::DenseTensor& in_tensor,
+                            int reduce_type,
+                            uint32_t tag) {
+  if (!IsSupported(reduce_type)) {
+    return false;
+  }
+  const size_t numel = static_cast<size_t>(in_tensor.numel());
+  switch (in_tensor.dtype()) {
+    case phi::DataType::FLOAT32:
+      AllReduceImpl(out_tensor->data<float>(),
+                    in_tensor.data<float>(),
+                    numel,
+                    reduce_type,
+                    tag);
+      return true;
+    case phi::DataType::FLOAT64:
+      AllReduceImpl(out_tensor->data<double>(),
+                    in_tensor.data<double>(),
+                    numel,
+                    reduce_type,
+                    tag);
+      return true;
+    case phi::DataType::INT32:
+      AllReduceImpl(out_tensor->data<int32_t>(),
+                    in_tensor.data<int32_t>(),
+                    numel,
+                    reduce_type,
+                    tag);
+      return true;
+    case phi::DataType::INT64:
+      AllReduceImpl(out_tensor->data<int64_t>(),
+                    in_tensor.data<int64_t>(),
+                    numel,
+                    reduce_type,
+                    tag);
+      return true;
+    default:
+      // the half types are reduced by gloo
+      return false;
+  }
+}
+
+}  // namespace distributed
+}  // namespace phi
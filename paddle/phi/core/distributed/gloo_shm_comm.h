@@ -0,0 +1,84 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <gloo/rendezvous/context.h>
+#include <gloo/rendezvous/store.h>
+#include <gloo/transport/device.h>
+
+#include <memory>
+#include <string>
+
+#include "paddle/common/macros.h"
+
+namespace phi {
+class DenseTensor;
+namespace distributed {
+
+/**
+ * GlooShmComm all-reduces the CPU tensors of a gloo group hierarchically:
+ * the ranks of one host meet in a shared memory segment, and only the first
+ * rank of each host all-reduces over a gloo context of these leaders.
+ *
+ * For each chunk of the tensor, every local rank copies the chunk into its
+ * slot of the segment, reduces its share of the chunk over all the slots
+ * into the result area, the leader all-reduces the result area across the
+ * hosts, and every local rank copies the result out. The local ranks wait
+ * for each other on a spinning barrier in the segment.
+ */
+class GlooShmComm {
+ public:
+  // Returns nullptr if FLAGS_gloo_shm_allreduce is off, no host runs two
+  // ranks of the group, or any rank of the group fails to set up the shared
+  // memory. Every rank of the group has to call it, since the ranks agree
+  // through the store.
+  static std::unique_ptr<GlooShmComm> Create(
+      int rank,
+      int size,
+      gloo::rendezvous::Store* store,
+      const std::shared_ptr<gloo::transport::Device>& device);
+
+  ~GlooShmComm();
+
+  // Returns false if the dtype or the reduce type is not supported, which
+  // all the ranks decide alike, and the caller all-reduces over gloo.
+  bool AllReduce(phi::DenseTensor* out_tensor,
+                 const phi::DenseTensor& in_tensor,
+                 int reduce_type,
+                 uint32_t tag);
+
+ private:
+  GlooShmComm() = default;
+
+  template <typename T>
+  void AllReduceImpl(
+      T* out, const T* in, size_t numel, int reduce_type, uint32_t tag);
+
+  void Barrier();
+
+  char* slot(int local_rank) const;
+
+  int local_rank_{0};
+  int local_size_{1};
+  size_t slot_bytes_{0};
+  char* segment_{nullptr};
+  size_t segment_bytes_{0};
+  // only the leader of a host has it, if there are two hosts or more
+  std::shared_ptr<gloo::rendezvous::Context> leader_context_;
+
+  DISABLE_COPY_AND_ASSIGN(GlooShmComm);
+};
+
+}  // namespace distributed
+}  // namespace phi
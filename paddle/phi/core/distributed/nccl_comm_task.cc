@@ -55,6 +55,15 @@ NCCLCommTask::NCCLCommTask(const phi::Place& place,
   end_event_created_ = false;
   start_time_ = std::chrono::steady_clock::now();
   timeout_ = std::chrono::milliseconds(timeout);
+  if (CommTelemetry::IsEnabled()) {
+    // before the events are recorded
+    time_reference_ = CommTelemetry::GetInstance().GetReference(place.device);
+#ifdef PADDLE_WITH_CUDA
+    cuda_event_flags_ = cudaEventDefault;
+#else  // PADDLE_WITH_HIP
+    hip_event_flags_ = hipEventDefault;
+#endif
+  }
 }
 
 void NCCLCommTask::StartRecord() {
@@ -118,6 +127,17 @@ void NCCLCommTask::ClearRecord() {
 }
 #endif
 
+bool NCCLCommTask::GetTiming(int64_t* start_us, int64_t* end_us) {
+  if (time_reference_ == nullptr || !start_event_created_ ||
+      !end_event_created_ || !IsCompleted()) {
+    return false;
+  }
+  backends::gpu::GPUDeviceGuard guard(place_.device);
+  *start_us = time_reference_->TimeUs(nccl_start_event_);
+  *end_us = time_reference_->TimeUs(nccl_end_event_);
+  return true;
+}
+
 bool NCCLCommTask::CudaEventQuery(gpuEvent_t event) {
 #ifdef PADDLE_WITH_CUDA
   cudaError_t ret = cudaEventQuery(event);
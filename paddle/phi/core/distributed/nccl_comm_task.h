@@ -17,6 +17,7 @@
 #include "paddle/phi/backends/gpu/gpu_decls.h"
 #include "paddle/phi/core/distributed/comm_context.h"
 #include "paddle/phi/core/distributed/comm_task.h"
+#include "paddle/phi/core/distributed/comm_telemetry.h"
 #include "paddle/phi/core/distributed/utils.h"
 
 #if defined(PADDLE_WITH_RCCL)
@@ -62,6 +63,7 @@ class NCCLCommTask : public CommTask {
   void StartRecord() override;
   void EndRecord() override;
   void ClearRecord() override;
+  bool GetTiming(int64_t* start_us, int64_t* end_us) override;
 
   bool CudaEventQuery(gpuEvent_t event);
 
@@ -82,6 +84,8 @@ class NCCLCommTask : public CommTask {
   bool end_event_created_;
   gpuEvent_t nccl_start_event_;
   gpuEvent_t nccl_end_event_;
+  // set if the events are timed for CommTelemetry
+  std::shared_ptr<CommTimeReference> time_reference_;
 
   std::string comm_error_;
 
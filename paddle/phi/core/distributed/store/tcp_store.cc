@@ -14,9 +14,15 @@
 
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
+#include <unordered_set>
 
 #include "glog/logging.h"
 
@@ -29,6 +35,9 @@ namespace distributed {
 namespace detail {
 
 constexpr int INFTIME = 10000;  // 10 seconds
+#ifdef __linux__
+constexpr int kMaxEpollEvents = 1024;
+#endif
 
 std::unique_ptr<MasterDaemon> MasterDaemon::start(SocketType socket,
                                                   int nranks,
@@ -95,6 +104,68 @@ void MasterDaemon::_notify_waiting_sockets(const std::string& key) {
     }
     _waiting_sockets.erase(key);
   }
+
+  auto iter = _waiting_multi_gets.find(key);
+  if (iter != _waiting_multi_gets.end()) {
+    auto pendings = std::move(iter->second);
+    _waiting_multi_gets.erase(iter);
+    for (const auto& pending : pendings) {
+      if (--pending->missing == 0) {
+        _reply_multi_get(*pending);
+      }
+    }
+  }
+}
+
+void MasterDaemon::_do_multi_set(SocketType socket) {
+  auto count = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_multi_set " << count << " key(s) "
+          << GetSockName(socket);
+  for (size_t i = 0; i < count; ++i) {
+    std::string key = tcputils::receive_string(socket);
+    _store[key] = tcputils::receive_vector<uint8_t>(socket);
+    _notify_waiting_sockets(key);
+  }
+}
+
+void MasterDaemon::_do_multi_get(SocketType socket) {
+  auto count = tcputils::receive_value<size_t>(socket);
+  auto pending = std::make_shared<PendingMultiGet>();
+  pending->socket = socket;
+  pending->keys.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    pending->keys.emplace_back(tcputils::receive_string(socket));
+  }
+  VLOG(8) << "MasterDaemon::_do_multi_get " << count << " key(s) "
+          << GetSockName(socket);
+
+  std::unordered_set<std::string> missing;
+  for (const auto& key : pending->keys) {
+    if (_store.find(key) == _store.end()) {
+      missing.insert(key);
+    }
+  }
+  if (missing.empty()) {
+    _reply_multi_get(*pending);
+    return;
+  }
+  // replied once the last of them is set
+  pending->missing = missing.size();
+  for (const auto& key : missing) {
+    _waiting_multi_gets[key].emplace_back(pending);
+  }
+}
+
+void MasterDaemon::_reply_multi_get(const PendingMultiGet& pending) {
+  try {
+    for (const auto& key : pending.keys) {
+      tcputils::send_vector<uint8_t>(pending.socket, _store.at(key));
+    }
+  } catch (const std::exception& ex) {
+    // the socket is dropped once it is polled
+    VLOG(5) << "Failed to reply the multi get of " << pending.keys.size()
+            << " key(s): " << ex.what();
+  }
 }
 
 void MasterDaemon::_do_get(SocketType socket) {
@@ -177,9 +248,89 @@ void MasterDaemon::_do_wait(SocketType socket) {
   }
 }
 
+void MasterDaemon::RemoveWaitingSocket(SocketType socket) {
+  auto map_iter = _waiting_sockets.begin();
+  while (map_iter != _waiting_sockets.end()) {
+    auto vec_iter = map_iter->second.begin();
+    while (vec_iter != map_iter->second.end()) {
+      if (*vec_iter == socket) {
+        vec_iter = map_iter->second.erase(vec_iter);
+      } else {
+        ++vec_iter;
+      }
+    }
+    if (map_iter->second.empty()) {
+      map_iter = _waiting_sockets.erase(map_iter);
+    } else {
+      ++map_iter;
+    }
+  }
+
+  auto multi_iter = _waiting_multi_gets.begin();
+  while (multi_iter != _waiting_multi_gets.end()) {
+    auto& pendings = multi_iter->second;
+    pendings.erase(
+        std::remove_if(pendings.begin(),
+                       pendings.end(),
+                       [socket](const std::shared_ptr<PendingMultiGet>& p) {
+                         return p->socket == socket;
+                       }),
+        pendings.end());
+    if (pendings.empty()) {
+      multi_iter = _waiting_multi_gets.erase(multi_iter);
+    } else {
+      ++multi_iter;
+    }
+  }
+}
+
+bool MasterDaemon::ProcessCommand(SocketType socket) {
+  try {
+    VLOG(8) << "Plan to receive command from " << GetSockName(socket);
+    Command command = tcputils::receive_value<Command>(socket);
+    VLOG(7) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
+
+    switch (command) {
+      case Command::ADD:
+        _do_add(socket);
+        break;
+      case Command::GET:
+        _do_get(socket);
+        break;
+      case Command::CHECK:
+        _do_check(socket);
+        break;
+      case Command::SET:
+        _do_set(socket);
+        break;
+      case Command::WAIT:
+        _do_wait(socket);
+        break;
+      case Command::MULTI_GET:
+        _do_multi_get(socket);
+        break;
+      case Command::MULTI_SET:
+        _do_multi_set(socket);
+        break;
+      default:
+        VLOG(8) << "Unknown command: " << static_cast<int>(command)
+                << " from addr info:" << GetSockName(socket);
+    }
+  } catch (const std::exception& ex) {
+    RemoveWaitingSocket(socket);
+    std::string s(ex.what());
+    if (s.find("TCP connection reset by peer") != std::string::npos) {
+      VLOG(5) << "TCP connection reset by peer";
+    } else {
+      VLOG(5) << "Meet some exceptions during run:" << ex.what();
+    }
+    return false;
+  }
+  return true;
+}
+
 void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
   std::vector<struct pollfd>& fds = *p_fds;
-  // FIXME(gongwb): Don't loop all fds of set just the fds who have event.
 #ifdef _WIN32
   // 0: listen socket, so loop from 1.
   for (size_t i = 1; i < fds.size(); i++) {
@@ -187,53 +338,10 @@ void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
   // 0: listen socket, 1:controller pipe, so loop from 2.
   for (uint i = 2; i < fds.size(); i++) {
 #endif
-    try {
-      if (fds[i].revents == 0) {
-        continue;
-      }
-
-      VLOG(8) << "Plan to receive command from " << GetSockName(fds[i].fd);
-      Command command = tcputils::receive_value<Command>(fds[i].fd);
-      VLOG(7) << "TCPStore: recv command: " << static_cast<int>(command) << ".";
-
-      switch (command) {
-        case Command::ADD:
-          _do_add(fds[i].fd);
-          break;
-        case Command::GET:
-          _do_get(fds[i].fd);
-          break;
-        case Command::CHECK:
-          _do_check(fds[i].fd);
-          break;
-        case Command::SET:
-          _do_set(fds[i].fd);
-          break;
-        case Command::WAIT:
-          _do_wait(fds[i].fd);
-          break;
-        default:
-          VLOG(8) << "Unknown command: " << static_cast<int>(command)
-                  << " from addr info:" << GetSockName(fds[i].fd);
-      }
-    } catch (const std::exception& ex) {
-      auto map_iter = _waiting_sockets.begin();
-      while (map_iter != _waiting_sockets.end()) {
-        auto vec_iter = map_iter->second.begin();
-        while (vec_iter != map_iter->second.end()) {
-          if (*vec_iter == fds[i].fd) {
-            vec_iter = map_iter->second.erase(vec_iter);
-          } else {
-            ++vec_iter;
-          }
-        }
-        if (map_iter->second.empty()) {
-          map_iter = _waiting_sockets.erase(map_iter);
-        } else {
-          ++map_iter;
-        }
-      }
-
+    if (fds[i].revents == 0) {
+      continue;
+    }
+    if (!ProcessCommand(fds[i].fd)) {
       tcputils::close_socket(fds[i].fd);
       fds.erase(fds.begin() + i);
 #ifdef _WIN32
@@ -241,16 +349,68 @@ void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
 #else
       _sockets.erase(_sockets.begin() + i - 2);
 #endif
-      std::string s(ex.what());
-      if (s.find("TCP connection reset by peer") != std::string::npos) {
-        VLOG(5) << "TCP connection reset by peer";
-      } else {
-        VLOG(5) << "Meet some exceptions during run:" << ex.what();
-      }
     }
   }
 }
 
+#ifdef __linux__
+// Only the sockets with commands are visited, with thousands of ranks
+// connected.
+void MasterDaemon::run() {
+  int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+  PADDLE_ENFORCE_NE(
+      epoll_fd,
+      -1,
+      phi::errors::Fatal("failed to create epoll instance errno:%d", errno));
+  auto watch = [epoll_fd](int fd) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    PADDLE_ENFORCE_NE(
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event),
+        -1,
+        phi::errors::Fatal("failed to watch fd %d errno:%d", fd, errno));
+  };
+  watch(_listen_socket);
+  watch(_control_fd[0]);
+
+  std::vector<struct epoll_event> events(kMaxEpollEvents);
+  bool finished = false;
+  while (!finished) {
+    int count = ::epoll_wait(epoll_fd, events.data(), kMaxEpollEvents, INFTIME);
+    if (count < 0) {
+      PADDLE_ENFORCE_EQ(
+          errno,
+          EINTR,
+          phi::errors::Fatal("failed to wait for epoll errno:%d", errno));
+      continue;
+    }
+    for (int i = 0; i < count; ++i) {
+      int fd = events[i].data.fd;
+      if (fd == _control_fd[0]) {
+        VLOG(0)
+            << "receive shutdown event and so quit from MasterDaemon run loop";
+        finished = true;
+        break;
+      }
+      // accept connect request.
+      if (fd == _listen_socket) {
+        auto socket = tcputils::tcp_accept(_listen_socket);
+        _sockets.emplace_back(socket);
+        watch(socket);
+        continue;
+      }
+      if (!ProcessCommand(fd)) {
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        tcputils::close_socket(fd);
+        _sockets.erase(std::remove(_sockets.begin(), _sockets.end(), fd),
+                       _sockets.end());
+      }
+    }
+  }
+  ::close(epoll_fd);
+}
+#else
 void MasterDaemon::run() {
   std::vector<struct pollfd> fds;
 #ifdef _WIN32
@@ -311,6 +471,7 @@ void MasterDaemon::run() {
     ProcessCommands(&fds);
   }
 }
+#endif
 
 std::unique_ptr<TCPServer> TCPServer::create(uint16_t port,
                                              int nranks,
@@ -336,6 +497,10 @@ void TCPClient::send_command_for_key(Command type, const std::string& key) {
   tcputils::send_string(_socket, key);
 }
 
+void TCPClient::send_string(const std::string& value) {
+  tcputils::send_string(_socket, value);
+}
+
 template <typename T>
 void TCPClient::send_value(const T& value) {
   tcputils::send_bytes<T>(_socket, &value, 1);
@@ -434,10 +599,43 @@ void TCPStore::set(const std::string& key, const std::vector<uint8_t>& value) {
 }
 
 std::vector<uint8_t> TCPStore::get(const std::string& key) {
-  wait(key);
-  _client->send_command_for_key(Command::GET, _key_prefix + key);
   VLOG(7) << "TCPStore get.";
-  return _client->receive_vector<uint8_t>();
+  // waits in the same round trip
+  return multi_get({key})[0];
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multi_get(
+    const std::vector<std::string>& keys) {
+  VLOG(7) << "TCPStore multi_get " << keys.size() << " key(s).";
+  _client->send_command_for_key(Command::MULTI_GET, "");
+  _client->send_value<size_t>(keys.size());
+  for (const auto& key : keys) {
+    _client->send_string(_key_prefix + key);
+  }
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.emplace_back(_client->receive_vector<uint8_t>());
+  }
+  return values;
+}
+
+void TCPStore::multi_set(const std::vector<std::string>& keys,
+                         const std::vector<std::vector<uint8_t>>& values) {
+  PADDLE_ENFORCE_EQ(
+      keys.size(),
+      values.size(),
+      phi::errors::InvalidArgument("The number of keys (%d) and values (%d) "
+                                   "to set should be equal.",
+                                   keys.size(),
+                                   values.size()));
+  VLOG(7) << "TCPStore multi_set " << keys.size() << " key(s).";
+  _client->send_command_for_key(Command::MULTI_SET, "");
+  _client->send_value<size_t>(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    _client->send_string(_key_prefix + keys[i]);
+    _client->send_vector<uint8_t>(values[i]);
+  }
 }
 
 bool TCPStore::check(const std::string& key) {
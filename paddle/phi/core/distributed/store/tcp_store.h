@@ -29,6 +29,7 @@
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/phi/core/distributed/store/socket.h"
 #include "paddle/phi/core/distributed/store/store.h"
@@ -38,7 +39,7 @@ namespace phi {
 namespace distributed {
 
 enum class ReplyType { WAITING, STOP_WAIT, READY, NOT_READY };
-enum class Command { ADD, GET, CHECK, SET, WAIT, STOP };
+enum class Command { ADD, GET, CHECK, SET, WAIT, STOP, MULTI_GET, MULTI_SET };
 
 namespace detail {
 
@@ -54,13 +55,26 @@ class MasterDaemon {
   ~MasterDaemon();
 
  private:
+  // a MULTI_GET waiting for some of its keys
+  struct PendingMultiGet {
+    SocketType socket;
+    std::vector<std::string> keys;
+    size_t missing = 0;
+  };
+
   void run();
   void ProcessCommands(std::vector<struct pollfd>* p_fds);
+  // false if the socket failed, it is then removed from the waiting lists
+  bool ProcessCommand(SocketType socket);
+  void RemoveWaitingSocket(SocketType socket);
   void _do_add(SocketType socket);
   void _do_wait(SocketType socket);
   void _do_get(SocketType socket);
   void _do_check(SocketType socket);
   void _do_set(SocketType socket);
+  void _do_multi_get(SocketType socket);
+  void _do_multi_set(SocketType socket);
+  void _reply_multi_get(const PendingMultiGet& pending);
   void _notify_waiting_sockets(const std::string&);
   SocketType _listen_socket;
   std::vector<SocketType> _sockets;
@@ -70,6 +84,8 @@ class MasterDaemon {
   int _timeout = 0;
   std::unordered_map<std::string, std::vector<SocketType>>
       _waiting_sockets;  // key -> list of waiting sockets
+  std::unordered_map<std::string, std::vector<std::shared_ptr<PendingMultiGet>>>
+      _waiting_multi_gets;  // key -> MULTI_GETs missing it
 
   void InitControlFd();
   void CloseControlFd();
@@ -99,6 +115,7 @@ class TCPClient {
                                             uint16_t port);
   ~TCPClient() { tcputils::close_socket(_socket); }
   void send_command_for_key(Command type, const std::string& key);
+  void send_string(const std::string& value);
 
   template <typename T>
   void send_value(const T& value);
@@ -134,6 +151,11 @@ class TCPStore : public Store {
   bool check(const std::string& key) override;
   void wait(const std::string& key) override;
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
+  // in one round trip each, the master waits for the keys of multi_get
+  std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) override;
+  void multi_set(const std::vector<std::string>& keys,
+                 const std::vector<std::vector<uint8_t>>& values) override;
 
  private:
   void waitWorkers();
@@ -29,6 +29,10 @@ enum class ReduceOp : std::uint8_t { SUM = 0, MAX, MIN, PRODUCT, AVG };
 
 struct AllreduceOptions {
   ReduceOp reduce_op = ReduceOp::SUM;
+  // Whether to reduce-scatter in the node, all-reduce among the ranks of the
+  // same local rank on all nodes, then all-gather in the node. Only used by
+  // ProcessGroupNCCL.
+  bool hierarchical = false;
 };
 
 struct BroadcastOptions {
@@ -18,6 +18,7 @@ limitations under the License. */
 
 #include <cstdint>
 #include <memory>
+#include <tuple>
 #include <utility>
 
 #include "paddle/phi/backends/gpu/gpu_info.h"
@@ -284,4 +285,44 @@ std::pair<uint64_t, uint64_t> Generator::IncrementOffset(uint64_t increment) {
 #endif
 }
 
+PhiloxState Generator::IncrementPhiloxState(uint64_t increment) {
+  PhiloxState philox;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (graph_offset_ptr_ != nullptr && current_index == graph_state_index_) {
+      philox.seed_ptr = graph_seed_ptr_;
+      philox.offset_ptr = graph_offset_ptr_;
+      philox.offset = graph_offset_;
+      graph_offset_ += increment;
+      return philox;
+    }
+  }
+  std::tie(philox.seed, philox.offset) = IncrementOffset(increment);
+  return philox;
+}
+
+void Generator::BeginGraphCapture(const uint64_t* seed_ptr,
+                                  const uint64_t* offset_ptr) {
+  std::lock_guard<std::mutex> lock(mu_);
+  PADDLE_ENFORCE_EQ(graph_offset_ptr_ == nullptr,
+                    true,
+                    phi::errors::PreconditionNotMet(
+                        "The generator is already capturing a CUDA Graph."));
+  graph_seed_ptr_ = seed_ptr;
+  graph_offset_ptr_ = offset_ptr;
+  graph_offset_ = 0;
+  graph_state_index_ = current_index;
+  VLOG(4) << "Generator begins the graph capture on state "
+          << graph_state_index_;
+}
+
+uint64_t Generator::EndGraphCapture() {
+  std::lock_guard<std::mutex> lock(mu_);
+  graph_seed_ptr_ = nullptr;
+  graph_offset_ptr_ = nullptr;
+  VLOG(4) << "Generator ends the graph capture, a replay uses offset "
+          << graph_offset_;
+  return graph_offset_;
+}
+
 }  // namespace phi
@@ -24,11 +24,31 @@ limitations under the License. */
 #include <utility>
 #include <vector>
 
+#include "paddle/common/hostdevice.h"
 #include "paddle/phi/common/place.h"
 
 namespace phi {
 
 #define MAGIC_RANDOM_SEED 34342423252
+
+// The philox seed and offset of one random kernel launch. When the launch is
+// captured by a CUDA Graph, the seed and the base offset are read from the
+// device when the kernel runs, and offset is relative to the base offset, so
+// every replay draws new random numbers without touching the kernel node.
+struct PhiloxState {
+  uint64_t seed{0};
+  uint64_t offset{0};
+  const uint64_t* seed_ptr{nullptr};
+  const uint64_t* offset_ptr{nullptr};
+
+  HOSTDEVICE uint64_t Seed() const {
+    return seed_ptr == nullptr ? seed : *seed_ptr;
+  }
+  HOSTDEVICE uint64_t Offset() const {
+    return offset_ptr == nullptr ? offset : *offset_ptr + offset;
+  }
+};
+
 class Generator {
  public:
   struct GeneratorState {
@@ -125,6 +145,16 @@ class Generator {
   // and returns the new seed and offset.
   std::pair<uint64_t, uint64_t> IncrementOffset(uint64_t increment_offset);
 
+  // Same as IncrementOffset, but while a CUDA Graph is captured on the
+  // current state, the offset is relative to the device base offset.
+  PhiloxState IncrementPhiloxState(uint64_t increment_offset);
+
+  // Switches the current state to the graph capture mode, the seed and the
+  // base offset of each replay are written to seed_ptr and offset_ptr.
+  void BeginGraphCapture(const uint64_t* seed_ptr, const uint64_t* offset_ptr);
+  // Leaves the graph capture mode and returns the offset used by one replay.
+  uint64_t EndGraphCapture();
+
  private:
   // Accesses the current generator state by index.
   inline GeneratorState& state();
@@ -136,6 +166,13 @@ class Generator {
   size_t current_index = 0;
   std::vector<GeneratorState> states_;
   mutable std::mutex mu_;
+
+  // the device seed and base offset of the CUDA Graph being captured, only
+  // the launches on graph_state_index_ use them
+  const uint64_t* graph_seed_ptr_{nullptr};
+  const uint64_t* graph_offset_ptr_{nullptr};
+  uint64_t graph_offset_{0};
+  size_t graph_state_index_{0};
 };
 
 // The DefaultCPUGenerator is used in manual_seed()
@@ -369,6 +369,41 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
   return {kernel_iter->second, false, false};
 }
 
+KernelResult KernelDispatchCache::Select(const std::string& kernel_name,
+                                         const KernelKey& kernel_key,
+                                         bool use_strided_kernel) {
+  auto& factory = KernelFactory::Instance();
+  uint64_t version = factory.kernels_version();
+  if (version != version_) {
+    version_ = version;
+    size_ = 0;
+    next_ = 0;
+  }
+  uint64_t key = static_cast<uint64_t>(kernel_key.hash_value()) |
+                 (static_cast<uint64_t>(use_strided_kernel) << 32) |
+                 (static_cast<uint64_t>(FLAGS_use_stride_kernel) << 33) |
+                 (static_cast<uint64_t>(FLAGS_enable_api_kernel_fallback)
+                  << 34);
+#if defined(PADDLE_WITH_XPU_KP)
+  key |= static_cast<uint64_t>(FLAGS_run_kp_kernel) << 35;
+#endif
+  for (size_t i = 0; i < size_; ++i) {
+    const Entry& entry = entries_[i];
+    if (entry.key == key) {
+      return {*entry.kernel, entry.has_fallback_cpu, entry.is_stride_kernel};
+    }
+  }
+  auto result = factory.SelectKernelOrThrowError(
+      kernel_name, kernel_key, use_strided_kernel);
+  entries_[next_] = {
+      key, &result.kernel, result.has_fallback_cpu, result.is_stride_kernel};
+  next_ = (next_ + 1) % kEntryNum;
+  if (size_ < kEntryNum) {
+    ++size_;
+  }
+  return result;
+}
+
 const KernelArgsDef& KernelFactory::GetFirstKernelArgsDef(
     const std::string& kernel_name) const {
   auto iter = kernels_.find(kernel_name);
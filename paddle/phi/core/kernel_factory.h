@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <ostream>
 #include <unordered_map>
@@ -317,7 +319,16 @@ class KernelFactory {
  public:
   static KernelFactory& Instance();
 
-  KernelNameMap& kernels() { return kernels_; }
+  // Callers may insert kernels through the returned map, which moves the
+  // kernels in it, so every call invalidates the KernelDispatchCaches.
+  KernelNameMap& kernels() {
+    kernels_version_.fetch_add(1, std::memory_order_release);
+    return kernels_;
+  }
+
+  uint64_t kernels_version() const {
+    return kernels_version_.load(std::memory_order_acquire);
+  }
 
   bool HasCompatiblePhiKernel(const std::string& op_type) const;
 
@@ -353,10 +364,42 @@ class KernelFactory {
 
   KernelNameMap kernels_;
 
+  std::atomic<uint64_t> kernels_version_{0};
+
   // Get the low precision kernel list of current module.
   std::map<const std::string, OpCount> low_precision_kernels_;
 };
 
+/**
+ * Note: Inline cache of KernelFactory::SelectKernelOrThrowError for one call
+ *       site, i.e. one kernel name. It remembers the kernels selected for the
+ *       last few kernel keys, so that repeated calls skip the lookups in the
+ *       nested kernel maps. All entries are dropped when a kernel is
+ *       registered. It is not thread safe, so keep one per thread.
+ */
+class KernelDispatchCache {
+ public:
+  TEST_API KernelResult Select(const std::string& kernel_name,
+                               const KernelKey& kernel_key,
+                               bool use_strided_kernel = false);
+
+ private:
+  static constexpr size_t kEntryNum = 4;
+
+  struct Entry {
+    // KernelKey::hash_value() together with the flags the selection reads
+    uint64_t key;
+    const Kernel* kernel;
+    bool has_fallback_cpu;
+    bool is_stride_kernel;
+  };
+
+  uint64_t version_ = 0;
+  size_t size_ = 0;
+  size_t next_ = 0;
+  std::array<Entry, kEntryNum> entries_;
+};
+
 inline std::ostream& operator<<(std::ostream& os, const KernelKey& kernel_key) {
   os << "(" << kernel_key.backend() << ", " << kernel_key.layout() << ", "
      << kernel_key.dtype() << ")";
@@ -54,6 +54,11 @@ void AppendLoD(LoD *lod, const LoD &lod_length) {
   }
 }
 
+void AssignSingleLevelLoD(const std::vector<size_t> &offsets, LoD *lod) {
+  lod->resize(1);
+  (*lod)[0].assign(offsets.begin(), offsets.end());
+}
+
 LoD ConvertToLengthBasedLoD(const LoD &offset_lod) {
   LoD length_lod;
   length_lod.reserve(offset_lod.size());
@@ -28,6 +28,14 @@ LoD ToAbsOffset(const LoD& in);
 
 TEST_API void AppendLoD(LoD* lod, const LoD& lod_length);
 
+/*
+ * Set lod to the single level of offsets. The memory lod already holds is
+ * reused, so the readers refilling the same feed tensors every batch do not
+ * allocate their LoD again.
+ */
+TEST_API void AssignSingleLevelLoD(const std::vector<std::size_t>& offsets,
+                                   LoD* lod);
+
 /*
  * Convert between length-based LoD and offset-based LoD.
  * The implementation of LoDTensor class use offset-based LoD.
@@ -0,0 +1,275 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/core/metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "glog/logging.h"
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/os_info.h"
+
+COMMON_DECLARE_string(metrics_dump_path);
+COMMON_DECLARE_int32(metrics_dump_interval_s);
+
+namespace phi {
+
+namespace {
+
+void AtomicAdd(std::atomic<double>* target, double value) {
+  double old = target->load(std::memory_order_relaxed);
+  while (!target->compare_exchange_weak(
+      old, old + value, std::memory_order_relaxed)) {
+  }
+}
+
+std::string WithLabels(const std::string& name,
+                       const std::string& labels,
+                       const std::string& extra_label = "") {
+  std::string all_labels = labels;
+  if (!extra_label.empty()) {
+    all_labels += (all_labels.empty() ? "" : ",") + extra_label;
+  }
+  return all_labels.empty() ? name : name + "{" + all_labels + "}";
+}
+
+}  // namespace
+
+size_t MetricShardIndex() {
+  static std::atomic<size_t> next_index{0};
+  thread_local size_t index =
+      next_index.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+  return index;
+}
+
+int64_t MetricCounter::Value() const {
+  int64_t value = 0;
+  for (auto& shard : shards_) {
+    value += shard.value.load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
+void MetricGauge::Add(double value) { AtomicAdd(&value_, value); }
+
+MetricHistogram::MetricHistogram(const std::vector<double>& bounds)
+    : bounds_(bounds) {
+  PADDLE_ENFORCE_EQ(std::is_sorted(bounds_.begin(), bounds_.end()),
+                    true,
+                    phi::errors::InvalidArgument(
+                        "The bounds of a histogram should be sorted."));
+  for (auto& shard : shards_) {
+    shard.counts.reset(new std::atomic<int64_t>[bounds_.size() + 1]);
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+      shard.counts[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void MetricHistogram::Observe(double value) {
+  size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) -
+                  bounds_.begin();
+  auto& shard = shards_[MetricShardIndex()];
+  shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+  AtomicAdd(&shard.sum, value);
+}
+
+std::vector<int64_t> MetricHistogram::BucketCounts() const {
+  std::vector<int64_t> counts(bounds_.size() + 1, 0);
+  for (auto& shard : shards_) {
+    for (size_t i = 0; i < counts.size(); ++i) {
+      counts[i] += shard.counts[i].load(std::memory_order_relaxed);
+    }
+  }
+  return counts;
+}
+
+double MetricHistogram::Sum() const {
+  double sum = 0;
+  for (auto& shard : shards_) {
+    sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+const std::vector<double>& DefaultLatencyBounds() {
+  static const std::vector<double> bounds = {0.0001,
+                                             0.00025,
+                                             0.0005,
+                                             0.001,
+                                             0.0025,
+                                             0.005,
+                                             0.01,
+                                             0.025,
+                                             0.05,
+                                             0.1,
+                                             0.25,
+                                             0.5,
+                                             1,
+                                             2.5,
+                                             5,
+                                             10};
+  return bounds;
+}
+
+MetricsRegistry& MetricsRegistry::Instance() {
+  // Never destroyed, the hot paths may still update their metrics while the
+  // static objects are destroyed at exit.
+  static MetricsRegistry* registry = new MetricsRegistry();
+  return *registry;
+}
+
+MetricsRegistry::MetricFamily* MetricsRegistry::GetFamily(
+    const std::string& name, const std::string& help, MetricType type) {
+  std::call_once(dump_flag_, [this] { StartDumpThread(); });
+  auto iter = families_.find(name);
+  if (iter == families_.end()) {
+    iter = families_.emplace(name, MetricFamily()).first;
+    iter->second.type = type;
+    iter->second.help = help;
+  }
+  PADDLE_ENFORCE_EQ(
+      iter->second.type == type,
+      true,
+      phi::errors::AlreadyExists(
+          "The metric %s is already registered with another type.", name));
+  return &iter->second;
+}
+
+MetricCounter* MetricsRegistry::GetCounter(const std::string& name,
+                                           const std::string& help,
+                                           const std::string& labels) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& metric =
+      GetFamily(name, help, MetricType::kCounter)->counters[labels];
+  if (metric == nullptr) {
+    metric = std::make_unique<MetricCounter>();
+  }
+  return metric.get();
+}
+
+MetricGauge* MetricsRegistry::GetGauge(const std::string& name,
+                                       const std::string& help,
+                                       const std::string& labels) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& metric = GetFamily(name, help, MetricType::kGauge)->gauges[labels];
+  if (metric == nullptr) {
+    metric = std::make_unique<MetricGauge>();
+  }
+  return metric.get();
+}
+
+MetricHistogram* MetricsRegistry::GetHistogram(
+    const std::string& name,
+    const std::string& help,
+    const std::string& labels,
+    const std::vector<double>& bounds) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& metric =
+      GetFamily(name, help, MetricType::kHistogram)->histograms[labels];
+  if (metric == nullptr) {
+    metric = std::make_unique<MetricHistogram>(bounds);
+  }
+  return metric.get();
+}
+
+std::string MetricsRegistry::ExportText() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::ostringstream os;
+  for (auto& item : families_) {
+    const std::string& name = item.first;
+    const MetricFamily& family = item.second;
+    os << "# HELP " << name << " " << family.help << "\n";
+    switch (family.type) {
+      case MetricType::kCounter:
+        os << "# TYPE " << name << " counter\n";
+        for (auto& metric : family.counters) {
+          os << WithLabels(name, metric.first) << " "
+             << metric.second->Value() << "\n";
+        }
+        break;
+      case MetricType::kGauge:
+        os << "# TYPE " << name << " gauge\n";
+        for (auto& metric : family.gauges) {
+          os << WithLabels(name, metric.first) << " "
+             << metric.second->Value() << "\n";
+        }
+        break;
+      case MetricType::kHistogram:
+        os << "# TYPE " << name << " histogram\n";
+        for (auto& metric : family.histograms) {
+          const auto& bounds = metric.second->Bounds();
+          auto counts = metric.second->BucketCounts();
+          int64_t cumulative = 0;
+          for (size_t i = 0; i < counts.size(); ++i) {
+            cumulative += counts[i];
+            std::ostringstream le;
+            if (i < bounds.size()) {
+              le << "le=\"" << bounds[i] << "\"";
+            } else {
+              le << "le=\"+Inf\"";
+            }
+            os << WithLabels(name + "_bucket", metric.first, le.str()) << " "
+               << cumulative << "\n";
+          }
+          os << WithLabels(name + "_sum", metric.first) << " "
+             << metric.second->Sum() << "\n";
+          os << WithLabels(name + "_count", metric.first) << " " << cumulative
+             << "\n";
+        }
+        break;
+    }
+  }
+  return os.str();
+}
+
+bool MetricsRegistry::Dump(const std::string& path) {
+  std::string tmp_path = path + ".tmp." + std::to_string(GetProcessId());
+  {
+    std::ofstream out(tmp_path);
+    if (!out) {
+      return false;
+    }
+    out << ExportText();
+  }
+  return std::rename(tmp_path.c_str(), path.c_str()) == 0;
+}
+
+void MetricsRegistry::StartDumpThread() {
+  if (FLAGS_metrics_dump_path.empty()) {
+    return;
+  }
+  std::string path = FLAGS_metrics_dump_path;
+  int interval_s = std::max(FLAGS_metrics_dump_interval_s, 1);
+  VLOG(1) << "Dump the metrics to " << path << " every " << interval_s
+          << " seconds.";
+  // Detached like the registry is leaked, it sleeps till the process exits.
+  std::thread([this, path, interval_s] {
+    while (true) {
+      std::this_thread::sleep_for(std::chrono::seconds(interval_s));
+      if (!Dump(path)) {
+        LOG_FIRST_N(WARNING, 1) << "Failed to dump the metrics to " << path;
+      }
+    }
+  }).detach();
+}
+
+}  // namespace phi
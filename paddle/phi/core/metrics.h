@@ -0,0 +1,153 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+// The metrics are sharded, and each thread updates one of the shards, so the
+// hot paths of many threads do not contend on the same cache line. Reading a
+// metric sums up its shards.
+constexpr size_t kMetricShards = 16;
+
+// Index of the shard the calling thread updates
+size_t MetricShardIndex();
+
+// A monotonically increasing count, e.g. of the allocations.
+class TEST_API MetricCounter {
+ public:
+  void Increase(int64_t value = 1) {
+    shards_[MetricShardIndex()].value.fetch_add(value,
+                                                std::memory_order_relaxed);
+  }
+
+  int64_t Value() const;
+
+ private:
+  struct alignas(64) Shard {
+    std::atomic<int64_t> value{0};
+  };
+  std::array<Shard, kMetricShards> shards_;
+};
+
+// A value that goes up and down, e.g. the size of a queue.
+class TEST_API MetricGauge {
+ public:
+  void Set(double value) { value_.store(value, std::memory_order_relaxed); }
+
+  void Add(double value);
+
+  double Value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<double> value_{0};
+};
+
+// The distribution of the observed values over the buckets of the upper
+// bounds, e.g. of the latency in seconds.
+class TEST_API MetricHistogram {
+ public:
+  explicit MetricHistogram(const std::vector<double>& bounds);
+
+  void Observe(double value);
+
+  const std::vector<double>& Bounds() const { return bounds_; }
+  // The count of each bucket, not cumulative, and the last one is of the
+  // values greater than all the bounds.
+  std::vector<int64_t> BucketCounts() const;
+  double Sum() const;
+
+ private:
+  struct alignas(64) Shard {
+    std::unique_ptr<std::atomic<int64_t>[]> counts;
+    std::atomic<double> sum{0};
+  };
+  std::vector<double> bounds_;
+  std::array<Shard, kMetricShards> shards_;
+};
+
+// The bounds of the latency histograms in seconds, from 100us to 10s.
+TEST_API const std::vector<double>& DefaultLatencyBounds();
+
+// Registry of the metrics of the process, exported in the Prometheus text
+// format, by ExportText on demand or to FLAGS_metrics_dump_path every
+// FLAGS_metrics_dump_interval_s seconds.
+//
+// A metric is identified by its name and labels, e.g. `place="gpu"`, and it
+// is never removed, so the hot paths get it once and keep the pointer:
+//
+//   static auto* allocs = phi::MetricsRegistry::Instance().GetCounter(
+//       "paddle_allocator_alloc_total", "Number of the allocations.");
+//   allocs->Increase();
+class TEST_API MetricsRegistry {
+ public:
+  static MetricsRegistry& Instance();
+
+  MetricCounter* GetCounter(const std::string& name,
+                            const std::string& help,
+                            const std::string& labels = "");
+
+  MetricGauge* GetGauge(const std::string& name,
+                        const std::string& help,
+                        const std::string& labels = "");
+
+  MetricHistogram* GetHistogram(
+      const std::string& name,
+      const std::string& help,
+      const std::string& labels = "",
+      const std::vector<double>& bounds = DefaultLatencyBounds());
+
+  std::string ExportText();
+
+  // Writes ExportText to the path, through a temporary file renamed to it,
+  // so the readers of the file never see a partial dump.
+  bool Dump(const std::string& path);
+
+ private:
+  enum class MetricType { kCounter, kGauge, kHistogram };
+
+  struct MetricFamily {
+    MetricType type;
+    std::string help;
+    std::map<std::string, std::unique_ptr<MetricCounter>> counters;
+    std::map<std::string, std::unique_ptr<MetricGauge>> gauges;
+    std::map<std::string, std::unique_ptr<MetricHistogram>> histograms;
+  };
+
+  MetricsRegistry() = default;
+  DISABLE_COPY_AND_ASSIGN(MetricsRegistry);
+
+  MetricFamily* GetFamily(const std::string& name,
+                          const std::string& help,
+                          MetricType type);
+  void StartDumpThread();
+
+  std::mutex mutex_;
+  std::map<std::string, MetricFamily> families_;
+  std::once_flag dump_flag_;
+};
+
+}  // namespace phi
@@ -97,9 +97,8 @@ class SelectedRows : public TensorBase,
   }
 
   /*
-   * @brief Get the index of the key from id_to_index_ map. If the key not
-   * exist,
-   * add the key into id_to_index_.
+   * @brief Get the index of the key from the RowIndexMap. If the key does not
+   * exist, add the key into the RowIndexMap.
    *
    * Note!!! this interface is only used when selected_rows is used as
    * parameters
@@ -112,7 +111,8 @@ class SelectedRows : public TensorBase,
   }
 
   /*
-   * @brief Get the index of the key from id_to_index_ map.
+   * @brief Get the index of the key from the RowIndexMap, -1 if it does not
+   * exist.
    */
   inline int64_t GetIndexFromId(int64_t key) const {
     return impl_->GetIndexFromId(key);
@@ -104,70 +104,128 @@ bool SelectedRowsImpl::HasKey(int64_t key) const {
                                                                    : true;
 }
 
-int64_t SelectedRowsImpl::AutoGrownIndex(int64_t key,
-                                         bool auto_grown,
-                                         bool is_test) {
-  if (is_test) {
-    auto iter = id_to_index_.find(key);
-    if (iter == id_to_index_.end()) {
+RowIndexMap::RowIndexMap(int64_t max_rows) : max_rows_(max_rows) {
+  // at most half full, so the probes stay short
+  size_t capacity = 16;
+  while (capacity < 2 * static_cast<size_t>(max_rows)) {
+    capacity *= 2;
+  }
+  mask_ = capacity - 1;
+  slots_.reset(new Slot[capacity]);
+}
+
+size_t RowIndexMap::Hash(int64_t key) const {
+  // the finalizer of splitmix64, the keys are often consecutive
+  uint64_t h = static_cast<uint64_t>(key);
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return static_cast<size_t>(h ^ (h >> 31)) & mask_;
+}
+
+int64_t RowIndexMap::Find(int64_t key) const {
+  for (size_t i = Hash(key);; i = (i + 1) & mask_) {
+    int64_t index = slots_[i].index.load(std::memory_order_acquire);
+    if (index < 0) {
       return -1;
-    } else {
-      return iter->second;
+    }
+    if (slots_[i].key.load(std::memory_order_relaxed) == key) {
+      return index;
     }
   }
+}
 
-  rwlock_->RDLock();
-  auto iter = id_to_index_.find(key);
-  if (iter == id_to_index_.end()) {
-    rwlock_->UNLock();
-    PADDLE_ENFORCE_EQ(
-        auto_grown,
-        true,
-        phi::errors::NotFound("Input key(%lld) is not found.", key));
-    rwlock_->WRLock();
-    auto map_size = id_to_index_.size();
-    auto vector_size = rows_.size();
-    if (map_size != vector_size) {
-      rwlock_->UNLock();
-      PADDLE_THROW(phi::errors::InvalidArgument(
-          "Row map size(%zu) should be equal to rows size(%zu).",
-          map_size,
-          vector_size));
+void RowIndexMap::Insert(int64_t key, int64_t index) {
+  for (size_t i = Hash(key);; i = (i + 1) & mask_) {
+    if (slots_[i].index.load(std::memory_order_relaxed) < 0) {
+      PADDLE_ENFORCE_LT(
+          size_,
+          static_cast<size_t>(max_rows_),
+          phi::errors::ResourceExhausted(
+              "The row index map of %d rows is full.", max_rows_));
+      slots_[i].key.store(key, std::memory_order_relaxed);
+      slots_[i].index.store(index, std::memory_order_release);
+      ++size_;
+      return;
     }
-    auto write_iter = id_to_index_.find(key);
-    if (write_iter == id_to_index_.end()) {
-      int row_num = static_cast<int>(rows_.size());
-      if (row_num == value_->dims()[0]) {
-        rwlock_->UNLock();
-        PADDLE_THROW(phi::errors::InvalidArgument(
-            "Selected rows is full, then length exceed the length of first "
-            "dimension (%d).",
-            row_num));
-      }
-      // key logic to put a key into id_to_index_
-      rows_.push_back(key);
-      auto index = static_cast<int64_t>(rows_.size() - 1);
-      id_to_index_[key] = index;
-      rwlock_->UNLock();
-      return index;
-    } else {
-      auto index = write_iter->second;
-      rwlock_->UNLock();
-      return index;
+    if (slots_[i].key.load(std::memory_order_relaxed) == key) {
+      slots_[i].index.store(index, std::memory_order_release);
+      return;
     }
-  } else {
-    auto index = iter->second;
+  }
+}
+
+int64_t SelectedRowsImpl::AutoGrownIndex(int64_t key,
+                                         bool auto_grown,
+                                         bool is_test) {
+  int64_t index = GetIndexFromId(key);
+  if (is_test || index >= 0) {
+    return index;
+  }
+
+  PADDLE_ENFORCE_EQ(
+      auto_grown,
+      true,
+      phi::errors::NotFound("Input key(%lld) is not found.", key));
+  rwlock_->WRLock();
+  auto* map = index_.load(std::memory_order_relaxed);
+  auto map_size = map == nullptr ? 0 : map->size();
+  auto vector_size = rows_.size();
+  if (map_size != vector_size) {
+    rwlock_->UNLock();
+    PADDLE_THROW(phi::errors::InvalidArgument(
+        "Row map size(%zu) should be equal to rows size(%zu).",
+        map_size,
+        vector_size));
+  }
+  // another writer may have added the key
+  index = GetIndexFromId(key);
+  if (index >= 0) {
     rwlock_->UNLock();
     return index;
   }
+  int row_num = static_cast<int>(rows_.size());
+  if (row_num == value_->dims()[0]) {
+    rwlock_->UNLock();
+    PADDLE_THROW(phi::errors::InvalidArgument(
+        "Selected rows is full, then length exceed the length of first "
+        "dimension (%d).",
+        row_num));
+  }
+  if (map == nullptr || map->max_rows() <= row_num) {
+    ResetIndex();
+  }
+  // key logic to put a key into the index
+  rows_.push_back(key);
+  index = static_cast<int64_t>(rows_.size() - 1);
+  index_.load(std::memory_order_relaxed)->Insert(key, index);
+  rwlock_->UNLock();
+  return index;
+}
+
+void SelectedRowsImpl::ResetIndex() {
+  // room for twice the rows present, up to the rows of the value, so the map
+  // follows the rows actually added and the replaced maps add up to at most
+  // the size of the last one
+  int64_t row_num = static_cast<int64_t>(rows_.size());
+  int64_t max_rows = std::max<int64_t>(2 * row_num, 16);
+  if (value_->dims().size() > 0) {
+    max_rows = std::max(row_num, std::min(max_rows, value_->dims()[0]));
+  }
+  auto map = std::make_unique<RowIndexMap>(max_rows);
+  for (int64_t i = 0; i < row_num; ++i) {
+    map->Insert(rows_[i], i);
+  }
+  index_.store(map.get(), std::memory_order_release);
+  index_maps_.push_back(std::move(map));
 }
 
 void SelectedRowsImpl::SyncIndex() {
   rwlock_->WRLock();
-  id_to_index_.clear();
-  for (int i = 0; i < static_cast<int>(rows_.size()); ++i) {
-    id_to_index_[rows_[i]] = i;
-  }
+  // a lock free lookup may still read a map of the last generation, so those
+  // maps are retired here and only freed by the next SyncIndex
+  retired_index_maps_ = std::move(index_maps_);
+  index_maps_.clear();
+  ResetIndex();
   rwlock_->UNLock();
 }
 
@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <unordered_map>
@@ -28,6 +29,44 @@ limitations under the License. */
 #include "paddle/phi/core/utils/rw_lock.h"
 
 namespace phi {
+
+/*
+ * @brief An open addressing map from the row keys to their indices, for the
+ * AutoGrownIndex of the distributed lookup tables. It holds at most max_rows
+ * keys and never rehashes, a table that outgrows it builds a larger one. Find
+ * is lock free and may run concurrently with Insert, but the Inserts must be
+ * serialized by the caller.
+ */
+class RowIndexMap {
+ public:
+  explicit RowIndexMap(int64_t max_rows);
+
+  /// Return the index of the key, -1 if it is not in the map.
+  int64_t Find(int64_t key) const;
+
+  /// Insert the key, or set the index of the key if it is in the map.
+  void Insert(int64_t key, int64_t index);
+
+  /// The number of the keys in the map.
+  size_t size() const { return size_; }
+
+  int64_t max_rows() const { return max_rows_; }
+
+ private:
+  struct Slot {
+    std::atomic<int64_t> key{0};
+    // -1 means the slot is empty, it is published after the key
+    std::atomic<int64_t> index{-1};
+  };
+
+  size_t Hash(int64_t key) const;
+
+  int64_t max_rows_;
+  size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  size_t size_{0};
+};
+
 class SelectedRowsImpl {
   /*
    * @brief We can use the SelectedRowsImpl structure to reproduce a sparse
@@ -113,9 +152,9 @@ class SelectedRowsImpl {
                      bool fake_alloc = false);
 
   /*
-   * @brief Get the index of the key from id_to_index_ map. If the key not
-   * exist,
-   * add the key into id_to_index_.
+   * @brief Get the index of the key from the RowIndexMap. If the key does not
+   * exist, add the key into the RowIndexMap, replacing it with a larger one
+   * when it is full.
    *
    * Note!!! this interface is only used when selected_rows is used as
    * parameters
@@ -126,17 +165,18 @@ class SelectedRowsImpl {
   int64_t AutoGrownIndex(int64_t key, bool auto_grown, bool is_test = false);
 
   /*
-   * @brief Get the index of the key from id_to_index_ map.
+   * @brief Get the index of the key from the RowIndexMap, -1 if it does not
+   * exist. It does not lock, see RowIndexMap::Find.
    */
   inline int64_t GetIndexFromId(int64_t key) const {
-    auto iter = id_to_index_.find(key);
-    if (iter == id_to_index_.end()) {
-      return -1;
-    } else {
-      return iter->second;
-    }
+    auto* index = index_.load(std::memory_order_acquire);
+    return index == nullptr ? -1 : index->Find(key);
   }
 
+  /*
+   * @brief Rebuild the RowIndexMap from the rows. The maps it replaces are
+   * freed by the next SyncIndex, so a lookup must not outlive two of them.
+   */
   void SyncIndex();
   /*
    * @brief Get complete Dims before
@@ -188,11 +228,20 @@ class SelectedRowsImpl {
   // SelectedRowsImpl are simply concated when adding together. Until a
   // SelectedRowsImpl add a Tensor, will the duplicate rows be handled.
   std::vector<int64_t> rows_;
-  std::unordered_map<int64_t, int64_t>
-      id_to_index_;  // should not be used when rows_ has duplicate member
+  // should not be used when rows_ has duplicate member. The maps replaced
+  // when the value grows are kept, since lock free readers may still use them
+  std::atomic<RowIndexMap*> index_{nullptr};
+  std::vector<std::unique_ptr<RowIndexMap>> index_maps_;
+  // the maps replaced by the last SyncIndex, freed by the next one
+  std::vector<std::unique_ptr<RowIndexMap>> retired_index_maps_;
   std::unique_ptr<DenseTensor> value_{nullptr};
   int64_t height_;  // height indicates the underline tensor's height
+  // serializes the writers of rows_ and index_, the readers do not lock it
   std::unique_ptr<RWLock> rwlock_{nullptr};
+
+  // Replace index_ with a larger map holding the rows_.
+  // Called with rwlock_ held for write.
+  void ResetIndex();
 };
 
 }  // namespace phi
@@ -4187,4 +4187,147 @@ void RoformerRelativePosXPUInferMeta(const MetaTensor& x,
   out->set_dtype(x.dtype());
 }
 
+void Fp8CastTransposeInferMeta(const MetaTensor& x,
+                               const MetaTensor& scale,
+                               const std::string& fp8_format,
+                               MetaTensor* out,
+                               MetaTensor* out_t,
+                               MetaTensor* amax) {
+  PADDLE_ENFORCE_EQ(
+      fp8_format == "e4m3" || fp8_format == "e5m2",
+      true,
+      phi::errors::InvalidArgument(
+          "fp8_format should be e4m3 or e5m2, but received %s.", fp8_format));
+  const auto& x_dims = x.dims();
+  PADDLE_ENFORCE_GE(x_dims.size(),
+                    2,
+                    phi::errors::InvalidArgument(
+                        "The rank of Input(x) should be at least 2, but "
+                        "received %d.",
+                        x_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      scale.numel(),
+      1,
+      phi::errors::InvalidArgument("Input(scale) should have one element."));
+  // out_t is the transpose of x flattened to a matrix of its last dim.
+  int64_t cols = x_dims[x_dims.size() - 1];
+  int64_t rows = 1;
+  for (int i = 0; i + 1 < x_dims.size(); ++i) {
+    rows = rows < 0 || x_dims[i] < 0 ? -1 : rows * x_dims[i];
+  }
+  out->set_dims(x_dims);
+  out->set_dtype(DataType::UINT8);
+  out->set_layout(x.layout());
+  out_t->set_dims(common::make_ddim({cols, rows}));
+  out_t->set_dtype(DataType::UINT8);
+  out_t->set_layout(x.layout());
+  amax->set_dims(common::make_ddim({1}));
+  amax->set_dtype(DataType::FLOAT32);
+  amax->set_layout(x.layout());
+}
+
+void Fp8GemmInferMeta(const MetaTensor& x,
+                      const MetaTensor& y,
+                      const MetaTensor& x_scale_inv,
+                      const MetaTensor& y_scale_inv,
+                      const MetaTensor& bias,
+                      const std::string& x_format,
+                      const std::string& y_format,
+                      DataType out_dtype,
+                      MetaTensor* out) {
+  PADDLE_ENFORCE_EQ(x.dtype(),
+                    DataType::UINT8,
+                    phi::errors::InvalidArgument(
+                        "Input(x) should hold fp8 data as uint8."));
+  PADDLE_ENFORCE_EQ(y.dtype(),
+                    DataType::UINT8,
+                    phi::errors::InvalidArgument(
+                        "Input(y) should hold fp8 data as uint8."));
+  PADDLE_ENFORCE_EQ(
+      x_format == "e5m2" && y_format == "e5m2",
+      false,
+      phi::errors::InvalidArgument(
+          "At most one of Input(x) and Input(y) can be in e5m2 format."));
+  PADDLE_ENFORCE_EQ(
+      out_dtype == DataType::FLOAT16 || out_dtype == DataType::BFLOAT16 ||
+          out_dtype == DataType::FLOAT32,
+      true,
+      phi::errors::InvalidArgument(
+          "out_dtype should be float16, bfloat16 or float32."));
+  const auto& x_dims = x.dims();
+  const auto& y_dims = y.dims();
+  PADDLE_ENFORCE_EQ(
+      y_dims.size(),
+      2,
+      phi::errors::InvalidArgument(
+          "Input(y) should be a matrix of [N, K], but received %s.", y_dims));
+  PADDLE_ENFORCE_EQ(
+      x_dims[x_dims.size() - 1],
+      y_dims[1],
+      phi::errors::InvalidArgument(
+          "The last dim of Input(x) and Input(y) should be the same, but "
+          "received %s and %s.",
+          x_dims,
+          y_dims));
+  if (bias) {
+    PADDLE_ENFORCE_EQ(bias.dtype(),
+                      out_dtype,
+                      phi::errors::InvalidArgument(
+                          "The data type of Input(bias) should be out_dtype."));
+  }
+  auto out_dims = common::vectorize(x_dims);
+  out_dims.back() = y_dims[0];
+  out->set_dims(common::make_ddim(out_dims));
+  out->set_dtype(out_dtype);
+  out->set_layout(x.layout());
+}
+
+void MoeGroupedGemmInferMeta(const MetaTensor& x,
+                             const MetaTensor& weight,
+                             const MetaTensor& expert_offsets,
+                             bool transpose_weight,
+                             MetaTensor* out) {
+  const auto& x_dims = x.dims();
+  const auto& weight_dims = weight.dims();
+  const auto& offsets_dims = expert_offsets.dims();
+  PADDLE_ENFORCE_EQ(
+      x_dims.size(),
+      2,
+      phi::errors::InvalidArgument(
+          "Input(x) should be a matrix of [tokens, K], but received %s.",
+          x_dims));
+  PADDLE_ENFORCE_EQ(weight_dims.size(),
+                    3,
+                    phi::errors::InvalidArgument(
+                        "Input(weight) should be a tensor of [num_experts, K, "
+                        "N], but received %s.",
+                        weight_dims));
+  PADDLE_ENFORCE_EQ(
+      offsets_dims.size() == 1 && offsets_dims[0] == weight_dims[0],
+      true,
+      phi::errors::InvalidArgument(
+          "Input(expert_offsets) should be of shape [num_experts], but "
+          "received %s while the shape of Input(weight) is %s.",
+          offsets_dims,
+          weight_dims));
+  PADDLE_ENFORCE_EQ(expert_offsets.dtype(),
+                    DataType::INT64,
+                    phi::errors::InvalidArgument(
+                        "The data type of Input(expert_offsets) should be "
+                        "int64."));
+  int64_t k = transpose_weight ? weight_dims[2] : weight_dims[1];
+  int64_t n = transpose_weight ? weight_dims[1] : weight_dims[2];
+  PADDLE_ENFORCE_EQ(
+      x_dims[1],
+      k,
+      phi::errors::InvalidArgument(
+          "The last dim of Input(x) should be the input dim of Input(weight), "
+          "but received %s and %s.",
+          x_dims,
+          weight_dims));
+  out->set_dims(common::make_ddim({x_dims[0], n}));
+  out->set_dtype(x.dtype());
+  out->set_layout(x.layout());
+}
+
 }  // namespace phi
@@ -948,4 +948,27 @@ void FusionLstmInferMeta(const MetaTensor& x,
                          MetaTensor* reordered_c0,
                          MetaTensor* checked_cell);
 
+void Fp8CastTransposeInferMeta(const MetaTensor& x,
+                               const MetaTensor& scale,
+                               const std::string& fp8_format,
+                               MetaTensor* out,
+                               MetaTensor* out_t,
+                               MetaTensor* amax);
+
+void Fp8GemmInferMeta(const MetaTensor& x,
+                      const MetaTensor& y,
+                      const MetaTensor& x_scale_inv,
+                      const MetaTensor& y_scale_inv,
+                      const MetaTensor& bias,
+                      const std::string& x_format,
+                      const std::string& y_format,
+                      DataType out_dtype,
+                      MetaTensor* out);
+
+void MoeGroupedGemmInferMeta(const MetaTensor& x,
+                             const MetaTensor& weight,
+                             const MetaTensor& expert_offsets,
+                             bool transpose_weight,
+                             MetaTensor* out);
+
 }  // namespace phi
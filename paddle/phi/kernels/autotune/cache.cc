@@ -14,13 +14,88 @@
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
+#include <sstream>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "glog/logging.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
+
+COMMON_DECLARE_string(autotune_cache_file);
 
 namespace phi {
 namespace autotune {
 
+namespace {
+
+// bumped once the keys or the algorithms are generated differently, or the
+// values of AlgorithmType change
+constexpr int kCacheFileVersion = 2;
+
+// The algorithms are only valid on devices of the same model and versions.
+// Queried once, the cache is saved on exit when the device may be released.
+const std::string& DeviceKey() {
+  static const std::string device_key = [] {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    int id = phi::backends::gpu::GetCurrentDeviceId();
+    std::string name = phi::backends::gpu::GetDeviceProperties(id).name;
+    std::replace(name.begin(), name.end(), ' ', '_');
+    return name + "_sm" +
+           std::to_string(phi::backends::gpu::GetGPUComputeCapability(id)) +
+           "_driver" +
+           std::to_string(phi::backends::gpu::GetGPUDriverVersion(id)) +
+           "_runtime" +
+           std::to_string(phi::backends::gpu::GetGPURuntimeVersion(id)) +
+           "_dnn" + std::to_string(phi::backends::gpu::DnnVersion());
+#else
+    return std::string("cpu");
+#endif
+  }();
+  return device_key;
+}
+
+int ProcessId() {
+#ifdef _WIN32
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+template <typename T>
+void WriteVector(std::ostream& os, const std::vector<T>& vec) {
+  os << " " << vec.size();
+  for (const auto& v : vec) {
+    os << " " << v;
+  }
+}
+
+template <typename T>
+bool ReadVector(std::istream& is, std::vector<T>* vec) {
+  size_t size = 0;
+  if (!(is >> size)) {
+    return false;
+  }
+  vec->resize(size);
+  for (auto& v : *vec) {
+    if (!(is >> v)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 size_t TransposeKey(const std::vector<int64_t>& x_dims,
                     const std::vector<int32_t>& perm,
                     phi::DataType dtype) {
@@ -37,6 +112,10 @@ std::string AlgorithmTypeString(int64_t algo_type) {
   } else if (algo_type ==
              static_cast<int64_t>(AlgorithmType::kConvBackwardFilter)) {
     return "conv_backward_filter";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kGemmEpilogue)) {
+    return "gemm_epilogue";
+  } else if (algo_type == static_cast<int64_t>(AlgorithmType::kSpMM)) {
+    return "spmm";
   }
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
   if (algo_type == static_cast<int64_t>(AlgorithmType::kConvForwardV8)) {
@@ -116,5 +195,196 @@ void AutoTuneCache::UpdateStatus() {
   total_cache_misses_ = cache_misses;
 }
 
+// The file is of a header line and one line of each algorithm:
+//   paddle_autotune_cache <version> <device key>
+//   algo <algo type> <key> <algo>
+//   matmul <key> <algo>
+//   conv <algo type> <conv key> <algo> <workspace size> <exhaustive search>
+//   plan <algo type> <feature vector> <cudnn-frontend plan in json>
+bool AutoTuneCache::Load(const std::string& path) {
+  std::ifstream is(path);
+  if (!is) {
+    return false;
+  }
+  std::string line;
+  std::string magic;
+  int version = 0;
+  std::string device_key;
+  std::getline(is, line);
+  std::istringstream header(line);
+  header >> magic >> version >> device_key;
+  if (magic != "paddle_autotune_cache" || version != kCacheFileVersion ||
+      device_key != DeviceKey()) {
+    LOG(WARNING) << "Skip the autotune cache file " << path << " of version "
+                 << version << " saved on " << device_key << ", while "
+                 << DeviceKey() << " is in use.";
+    return false;
+  }
+
+  std::unordered_map<int64_t, std::unordered_map<size_t, int64_t>> algos;
+  std::unordered_map<size_t, int64_t> matmul_algos;
+  std::unordered_map<
+      int64_t,
+      std::unordered_map<ConvCacheKey,
+                         ConvAutoTuneResult,
+                         ConvCacheKeyHash,
+                         ConvCacheKeyEqual>>
+      conv_algos;
+#ifdef PADDLE_WITH_CUDNN_FRONTEND
+  std::unordered_map<int64_t,
+                     std::map<cudnn_frontend::feature_vector_t, std::string>>
+      plans;
+#endif
+  int64_t num_skipped = 0;
+  while (std::getline(is, line)) {
+    std::istringstream entry(line);
+    std::string kind;
+    int64_t algo_type = 0;
+    size_t key = 0;
+    int64_t algo = 0;
+    entry >> kind;
+    if (kind == "algo" && entry >> algo_type >> key >> algo) {
+      algos[algo_type][key] = algo;
+    } else if (kind == "matmul" && entry >> key >> algo) {
+      matmul_algos[key] = algo;
+    } else if (kind == "conv" && entry >> algo_type) {
+      ConvCacheKey conv_key;
+      ConvAutoTuneResult result;
+      int dtype = 0;
+      if (ReadVector(entry, &conv_key.x_dims) &&
+          ReadVector(entry, &conv_key.w_dims) &&
+          ReadVector(entry, &conv_key.strides) &&
+          ReadVector(entry, &conv_key.paddings) &&
+          ReadVector(entry, &conv_key.dilations) &&
+          entry >> dtype >> conv_key.groups >> conv_key.data_layout >>
+              result.algo >> result.workspace_size >>
+              result.exhaustive_search) {
+        conv_key.dtype = static_cast<phi::DataType>(dtype);
+        conv_algos[algo_type][conv_key] = result;
+      } else {
+        ++num_skipped;
+      }
+#ifdef PADDLE_WITH_CUDNN_FRONTEND
+    } else if (kind == "plan" && entry >> algo_type) {
+      cudnn_frontend::feature_vector_t feature;
+      std::string json;
+      if (ReadVector(entry, &feature) && std::getline(entry >> std::ws, json) &&
+          !json.empty()) {
+        plans[algo_type][feature] = json;
+      } else {
+        ++num_skipped;
+      }
+#endif
+    } else if (!kind.empty()) {
+      ++num_skipped;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(*autotune_cache_mutex_);
+  for (auto& v : algos) {
+    auto iter = auto_tune_map_.find(v.first);
+    if (iter != auto_tune_map_.end()) {
+      iter->second.Merge(v.second);
+    }
+  }
+  matmul_auto_tune_map_.Merge(matmul_algos);
+  for (auto& v : conv_algos) {
+    auto iter = conv_auto_tune_map_.find(v.first);
+    if (iter != conv_auto_tune_map_.end()) {
+      iter->second.Merge(v.second);
+    }
+  }
+#ifdef PADDLE_WITH_CUDNN_FRONTEND
+  for (auto& v : plans) {
+    auto iter = cudnn_v8_auto_tune_map_.find(v.first);
+    if (iter != cudnn_v8_auto_tune_map_.end()) {
+      iter->second.MergeSerializedPlans(v.second);
+    }
+  }
+#endif
+  VLOG(3) << "Load the autotune cache from " << path << ", " << num_skipped
+          << " malformed lines skipped.";
+  return true;
+}
+
+void AutoTuneCache::Save(const std::string& path) {
+  // the algorithms tuned by other processes since this one loaded the file
+  Load(path);
+
+  std::string tmp_path = path + ".tmp." + std::to_string(ProcessId());
+  {
+    std::ofstream os(tmp_path, std::ios::trunc);
+    if (!os) {
+      LOG(WARNING) << "Can not write the autotune cache to " << tmp_path;
+      return;
+    }
+    os << "paddle_autotune_cache " << kCacheFileVersion << " " << DeviceKey()
+       << "\n";
+    std::lock_guard<std::mutex> lock(*autotune_cache_mutex_);
+    for (auto& v : auto_tune_map_) {
+      for (const auto& item : v.second.Items()) {
+        os << "algo " << v.first << " " << item.first << " " << item.second
+           << "\n";
+      }
+    }
+    for (const auto& item : matmul_auto_tune_map_.Items()) {
+      os << "matmul " << item.first << " " << item.second << "\n";
+    }
+    for (auto& v : conv_auto_tune_map_) {
+      for (const auto& item : v.second.Items()) {
+        const auto& key = item.first;
+        os << "conv " << v.first;
+        WriteVector(os, key.x_dims);
+        WriteVector(os, key.w_dims);
+        WriteVector(os, key.strides);
+        WriteVector(os, key.paddings);
+        WriteVector(os, key.dilations);
+        os << " " << static_cast<int>(key.dtype) << " " << key.groups << " "
+           << key.data_layout << " " << item.second.algo << " "
+           << item.second.workspace_size << " "
+           << item.second.exhaustive_search << "\n";
+      }
+    }
+#ifdef PADDLE_WITH_CUDNN_FRONTEND
+    for (auto& v : cudnn_v8_auto_tune_map_) {
+      for (auto& item : v.second.SerializedPlans()) {
+        // json keeps no line breaks in its strings
+        std::string json = item.second;
+        std::replace(json.begin(), json.end(), '\n', ' ');
+        std::replace(json.begin(), json.end(), '\r', ' ');
+        os << "plan " << v.first;
+        WriteVector(os, item.first);
+        os << " " << json << "\n";
+      }
+    }
+#endif
+  }
+  // replaces the file at once, the processes saving concurrently do not
+  // interleave their lines
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(path.c_str());
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      LOG(WARNING) << "Can not write the autotune cache to " << path;
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  VLOG(3) << "Save the autotune cache to " << path;
+}
+
+void AutoTuneCache::LoadCacheFile() {
+  cache_file_ = FLAGS_autotune_cache_file;
+  if (!cache_file_.empty()) {
+    DeviceKey();
+    Load(cache_file_);
+  }
+}
+
+AutoTuneCache::~AutoTuneCache() {
+  if (!cache_file_.empty()) {
+    Save(cache_file_);
+  }
+}
+
 }  // namespace autotune
 }  // namespace phi
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <string>
 
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/kernels/autotune/cache_base.h"
@@ -39,6 +40,8 @@ size_t TransposeKey(const std::vector<int64_t>& x_dims,
                     const std::vector<int32_t>& perm,
                     phi::DataType dtype);
 
+// The values are saved in FLAGS_autotune_cache_file, bump kCacheFileVersion
+// in cache.cc when they change.
 enum class AlgorithmType {
   kConvForward = 1,
   kConvBackwardData = 2,
@@ -49,21 +52,24 @@ enum class AlgorithmType {
   kGatherGemmScatterFP32NN = 7,
   kGatherGemmScatterFP32TN = 8,
   kGatherGemmScatterFP32NT = 9,
+  kGemmEpilogue = 10,
 #if !defined(PADDLE_WITH_CUDNN_FRONTEND)
-  kAlgorithmCount = 10
+  kSpMM = 11,
+  kAlgorithmCount = 12
 #else
-  kConvForwardV8 = 10,
-  kConvBackwardDataV8 = 11,
-  kConvBackwardFilterV8 = 12,
-  kScaleBiasReluConvBNstats = 13,
-  kBNFinalize = 14,
-  kScaleBiasAddRelu = 15,
-  kDgradDreluBnBwdWeight = 16,
-  kDbnApply = 17,
-  kBnActWgrad = 18,
-  kPoolingForwardV8 = 19,
-  kPoolingBackwardV8 = 20,
-  kAlgorithmCount = 21
+  kConvForwardV8 = 11,
+  kConvBackwardDataV8 = 12,
+  kConvBackwardFilterV8 = 13,
+  kScaleBiasReluConvBNstats = 14,
+  kBNFinalize = 15,
+  kScaleBiasAddRelu = 16,
+  kDgradDreluBnBwdWeight = 17,
+  kDbnApply = 18,
+  kBnActWgrad = 19,
+  kPoolingForwardV8 = 20,
+  kPoolingBackwardV8 = 21,
+  kSpMM = 22,
+  kAlgorithmCount = 23
 #endif
 };
 
@@ -151,6 +157,17 @@ class AutoTuneCache {
 
   void UpdateStatus();
 
+  // Loads the algorithms saved in path on a device of the same model, driver
+  // and dnn versions, the ones already cached are kept. Returns false if path
+  // does not exist or was saved on another device.
+  bool Load(const std::string& path);
+
+  // Saves the cached algorithms to path, merged with the ones saved there by
+  // other processes. The cudnn-frontend plans are saved in json and rebuilt
+  // on their first lookup, the cublasLt descriptors hold handles of this
+  // process and are not saved.
+  void Save(const std::string& path);
+
   // The number of total config cached
   int64_t Size() const { return total_size_; }
 
@@ -173,8 +190,15 @@ class AutoTuneCache {
     for (int i = 1; i < static_cast<int>(AlgorithmType::kAlgorithmCount); ++i) {
       Register(static_cast<AlgorithmType>(i));
     }
+    LoadCacheFile();
   }
 
+  // Saves to FLAGS_autotune_cache_file if set.
+  ~AutoTuneCache();
+
+  // Loads FLAGS_autotune_cache_file if set.
+  void LoadCacheFile();
+
   void Register(const AlgorithmType& algo_type) {
     std::lock_guard<std::mutex> lock(*autotune_cache_mutex_);
     if (algo_type == AlgorithmType::kConvForward ||
@@ -187,7 +211,7 @@ class AutoTuneCache {
       }
 #ifdef PADDLE_WITH_CUDNN_FRONTEND
     } else if (algo_type >= AlgorithmType::kConvForwardV8 &&
-               algo_type < AlgorithmType::kAlgorithmCount) {
+               algo_type <= AlgorithmType::kPoolingBackwardV8) {
       int64_t key = static_cast<int64_t>(algo_type);
       if (cudnn_v8_auto_tune_map_.find(key) == cudnn_v8_auto_tune_map_.end()) {
         CudnnFrontendPlanCache cache;
@@ -210,6 +234,7 @@ class AutoTuneCache {
   CudnnV8AlgorithmsTypeMap cudnn_v8_auto_tune_map_;
 #endif
   std::shared_ptr<std::mutex> autotune_cache_mutex_;
+  std::string cache_file_;
   int64_t total_cache_hits_{0};
   int64_t total_cache_misses_{0};
   int64_t total_size_{0};
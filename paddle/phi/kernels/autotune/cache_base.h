@@ -153,6 +153,18 @@ class AlgorithmsCache {
 
   int64_t Size() const { return hash_.size(); }
 
+  std::unordered_map<KeyT, AlgorithmT, HashT, KeyEqualT> Items() {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    return hash_;
+  }
+
+  // Adds the items of keys not cached yet.
+  void Merge(const std::unordered_map<KeyT, AlgorithmT, HashT, KeyEqualT>&
+                 items) {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    hash_.insert(items.begin(), items.end());
+  }
+
  protected:
   std::unordered_map<KeyT, AlgorithmT, HashT, KeyEqualT> hash_;
   std::shared_ptr<std::mutex> cache_mutex_;
@@ -61,6 +61,7 @@ class CudnnFrontendPlanCache {
     std::lock_guard<std::mutex> lock(*cache_mutex_);
     map_.clear();
     tracker_.clear();
+    serialized_plans_.clear();
     cache_hits_ = 0;
     cache_misses_ = 0;
   }
@@ -70,7 +71,8 @@ class CudnnFrontendPlanCache {
     bool ret = false;
     std::lock_guard<std::mutex> lock(*cache_mutex_);
     auto &local_map = map_[hasher(std::this_thread::get_id())];
-    if (local_map.count(GetExtendedFeature(feature, handle)) > 0) {
+    if (local_map.count(GetExtendedFeature(feature, handle)) > 0 ||
+        LoadSerializedPlan(feature, handle, &local_map)) {
       cache_hits_++;
       ret = true;
     } else {
@@ -79,6 +81,37 @@ class CudnnFrontendPlanCache {
     return ret;
   }
 
+  // Adds the plans serialized by another process, which are built on the
+  // first lookup of their features, the plans already cached are kept.
+  void MergeSerializedPlans(
+      const std::map<cudnn_frontend::feature_vector_t, std::string> &plans) {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    serialized_plans_.insert(plans.begin(), plans.end());
+  }
+
+  // The cached plans in json, keyed by their features without the handle.
+  std::map<cudnn_frontend::feature_vector_t, std::string> SerializedPlans() {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    auto plans = serialized_plans_;
+#if CUDNN_VERSION >= 8400
+    for (auto &local_map : map_) {
+      for (auto &item : local_map.second) {
+        cudnn_frontend::feature_vector_t feature(item.first.begin(),
+                                                 item.first.end() - 1);
+        if (plans.count(feature) == 0) {
+          try {
+            plans[feature] = item.second.getJsonRepresentation();
+          } catch (cudnn_frontend::cudnnException &e) {
+            VLOG(4) << "[cudnn_frontend] Can not serialize plan "
+                    << item.second.getTag() << ": " << e.what();
+          }
+        }
+      }
+    }
+#endif
+    return plans;
+  }
+
   void GetPlanAndWorkspaceSize(const cudnn_frontend::feature_vector_t &feature,
                                const cudnn_frontend::ExecutionPlan **plan,
                                int64_t *workspace_size,
@@ -154,6 +187,35 @@ class CudnnFrontendPlanCache {
   }
 
  private:
+  using FeatureVectorToPlanMap =
+      std::map<cudnn_frontend::feature_vector_t, cudnn_frontend::ExecutionPlan>;
+
+  bool LoadSerializedPlan(const cudnn_frontend::feature_vector_t &feature,
+                          cudnnHandle_t handle,
+                          FeatureVectorToPlanMap *local_map) {
+#if CUDNN_VERSION >= 8400
+    auto it = serialized_plans_.find(feature);
+    if (it == serialized_plans_.end()) {
+      return false;
+    }
+    try {
+      auto plan = cudnn_frontend::ExecutionPlanBuilder()
+                      .setHandle(handle)
+                      .loadFromJson(it->second)
+                      .build();
+      VLOG(4) << "[cudnn_frontend] cache: Load serialized plan: "
+              << plan.getTag();
+      local_map->insert(
+          std::make_pair(GetExtendedFeature(feature, handle), plan));
+      return true;
+    } catch (cudnn_frontend::cudnnException &e) {
+      VLOG(4) << "[cudnn_frontend] Can not load serialized plan: " << e.what();
+      serialized_plans_.erase(it);
+    }
+#endif
+    return false;
+  }
+
   cudnn_frontend::feature_vector_t GetExtendedFeature(
       cudnn_frontend::feature_vector_t feat, cudnnHandle_t handle) {
     int64_t val = 0;
@@ -161,9 +223,9 @@ class CudnnFrontendPlanCache {
     feat.push_back(val);
     return feat;
   }
-  using FeatureVectorToPlanMap =
-      std::map<cudnn_frontend::feature_vector_t, cudnn_frontend::ExecutionPlan>;
   std::map<std::size_t, FeatureVectorToPlanMap> map_;
+  // the plans loaded from the autotune cache file, not built yet
+  std::map<cudnn_frontend::feature_vector_t, std::string> serialized_plans_;
   std::hash<std::thread::id> hasher;
 
   std::shared_ptr<std::mutex> cache_mutex_;
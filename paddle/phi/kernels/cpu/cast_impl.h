@@ -15,17 +15,10 @@
 #pragma once
 
 #include "paddle/phi/backends/cpu/cpu_context.h"
-
-// See Note [ Why still include the fluid headers? ]
-#include "paddle/phi/common/transform.h"
+#include "paddle/phi/kernels/funcs/cpu_cast.h"
 
 namespace phi {
 
-template <typename InT, typename OutT>
-struct CastOpTransformFunctor {
-  HOSTDEVICE OutT operator()(InT in) const { return static_cast<OutT>(in); }
-};
-
 template <typename InT, typename OutT>
 void CastKernelImpl(const CPUContext& dev_ctx,
                     const DenseTensor& x,
@@ -33,17 +26,11 @@ void CastKernelImpl(const CPUContext& dev_ctx,
                     DenseTensor* out) {
   auto* in_begin = x.data<InT>();
   auto numel = x.numel();
-  auto* in_end = in_begin + numel;
 
   auto* out_begin = dev_ctx.Alloc<OutT>(out);
   out->set_type(out_dtype);
 
-  phi::Transform<CPUContext> trans;
-  trans(dev_ctx,
-        in_begin,
-        in_end,
-        out_begin,
-        CastOpTransformFunctor<InT, OutT>());
+  phi::funcs::CPUCast(in_begin, numel, out_begin);
 }
 
 template <typename InT, typename OutT>
@@ -53,19 +40,13 @@ void CastInplaceKernelImpl(const CPUContext& dev_ctx,
                            DenseTensor* out) {
   auto numel = x.numel();
   auto* in_begin = new InT[numel];
-  auto* in_end = in_begin + numel;
   auto* data_origin = x.data<InT>();
   memcpy(in_begin, data_origin, sizeof(InT) * numel);
 
   auto* out_begin = dev_ctx.Alloc<OutT>(out);
   out->set_type(out_dtype);
 
-  phi::Transform<CPUContext> trans;
-  trans(dev_ctx,
-        in_begin,
-        in_end,
-        out_begin,
-        CastOpTransformFunctor<InT, OutT>());
+  phi::funcs::CPUCast(in_begin, numel, out_begin);
   delete[] in_begin;
 }
 
@@ -30,6 +30,17 @@ PD_REGISTER_KERNEL(matmul,
                    phi::dtype::complex<float>,
                    phi::dtype::complex<double>) {}
 
+PD_REGISTER_KERNEL(matmul,
+                   CPU,
+                   STRIDED,
+                   phi::MatmulStridedKernel,
+                   float,
+                   double,
+                   int32_t,
+                   int64_t,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>) {}
+
 PD_REGISTER_KERNEL(matmul_with_flatten,
                    CPU,
                    ALL_LAYOUT,
@@ -0,0 +1,60 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace phi {
+namespace funcs {
+
+constexpr int64_t kCPUTransposeTile = 32;
+constexpr int64_t kCPUTransposeParallelThreshold = 262144;
+
+/// Transpose each of the batch row-major rows x cols matrices of in into a
+/// cols x rows matrix of out, by tiles small enough that the rows read and
+/// the rows written stay in the L1 cache. The tiles are split over the
+/// OpenMP threads when there are at least kCPUTransposeParallelThreshold
+/// elements. NCHW to NHWC is a batch of N C x HW transposes, and NHWC to
+/// NCHW a batch of N HW x C transposes.
+template <typename T>
+void CPUBatchTranspose(
+    const T* in, int64_t batch, int64_t rows, int64_t cols, T* out) {
+  int64_t row_tiles = (rows + kCPUTransposeTile - 1) / kCPUTransposeTile;
+  int64_t num_tiles = batch * row_tiles;
+#ifdef PADDLE_WITH_MKLML
+  int64_t numel = batch * rows * cols;
+#pragma omp parallel for if (numel >= kCPUTransposeParallelThreshold)
+#endif
+  for (int64_t t = 0; t < num_tiles; ++t) {
+    int64_t b = t / row_tiles;
+    int64_t row_begin = (t % row_tiles) * kCPUTransposeTile;
+    int64_t row_end = std::min(rows, row_begin + kCPUTransposeTile);
+    const T* src = in + b * rows * cols;
+    T* dst = out + b * rows * cols;
+    for (int64_t col_begin = 0; col_begin < cols;
+         col_begin += kCPUTransposeTile) {
+      int64_t col_end = std::min(cols, col_begin + kCPUTransposeTile);
+      for (int64_t r = row_begin; r < row_end; ++r) {
+        for (int64_t c = col_begin; c < col_end; ++c) {
+          dst[c * rows + r] = src[r * cols + c];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/cpu_cast.h"
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+
+namespace phi {
+namespace funcs {
+namespace detail {
+
+// Defined in cpu_cast_avx2.cc and cpu_cast_avx512.cc, which are compiled with
+// the flags of their instruction set. They return false if built without.
+bool CastFP32ToBF16AVX2(const float* in, int64_t n, uint16_t* out, bool rne);
+bool CastBF16ToFP32AVX2(const uint16_t* in, int64_t n, float* out);
+bool CastFP32ToFP16AVX2(const float* in, int64_t n, uint16_t* out);
+bool CastFP16ToFP32AVX2(const uint16_t* in, int64_t n, float* out);
+bool CastINT64ToINT32AVX2(const int64_t* in, int64_t n, int32_t* out);
+bool CastINT32ToINT64AVX2(const int32_t* in, int64_t n, int64_t* out);
+
+bool CastFP32ToBF16AVX512(const float* in, int64_t n, uint16_t* out, bool rne);
+bool CastBF16ToFP32AVX512(const uint16_t* in, int64_t n, float* out);
+bool CastFP32ToFP16AVX512(const float* in, int64_t n, uint16_t* out);
+bool CastFP16ToFP32AVX512(const uint16_t* in, int64_t n, float* out);
+bool CastINT64ToINT32AVX512(const int64_t* in, int64_t n, int32_t* out);
+bool CastINT32ToINT64AVX512(const int32_t* in, int64_t n, int64_t* out);
+
+namespace {
+
+bool UseAVX512() {
+  static const bool use = backends::cpu::MayIUse(backends::cpu::avx512f);
+  return use;
+}
+
+bool UseAVX2() {
+  static const bool use = backends::cpu::MayIUse(backends::cpu::avx2);
+  return use;
+}
+
+uint16_t* Bits(dtype::bfloat16* data) {
+  return reinterpret_cast<uint16_t*>(data);
+}
+const uint16_t* Bits(const dtype::bfloat16* data) {
+  return reinterpret_cast<const uint16_t*>(data);
+}
+uint16_t* Bits(dtype::float16* data) {
+  return reinterpret_cast<uint16_t*>(data);
+}
+const uint16_t* Bits(const dtype::float16* data) {
+  return reinterpret_cast<const uint16_t*>(data);
+}
+
+}  // namespace
+
+bool VecCastFP32ToBF16(const float* in,
+                       int64_t n,
+                       dtype::bfloat16* out,
+                       bool round_to_nearest_even) {
+  if (UseAVX512() &&
+      CastFP32ToBF16AVX512(in, n, Bits(out), round_to_nearest_even)) {
+    return true;
+  }
+  return UseAVX2() &&
+         CastFP32ToBF16AVX2(in, n, Bits(out), round_to_nearest_even);
+}
+
+bool VecCastBF16ToFP32(const dtype::bfloat16* in, int64_t n, float* out) {
+  if (UseAVX512() && CastBF16ToFP32AVX512(Bits(in), n, out)) {
+    return true;
+  }
+  return UseAVX2() && CastBF16ToFP32AVX2(Bits(in), n, out);
+}
+
+bool VecCastFP32ToFP16(const float* in, int64_t n, dtype::float16* out) {
+  if (UseAVX512() && CastFP32ToFP16AVX512(in, n, Bits(out))) {
+    return true;
+  }
+  return UseAVX2() && CastFP32ToFP16AVX2(in, n, Bits(out));
+}
+
+bool VecCastFP16ToFP32(const dtype::float16* in, int64_t n, float* out) {
+  if (UseAVX512() && CastFP16ToFP32AVX512(Bits(in), n, out)) {
+    return true;
+  }
+  return UseAVX2() && CastFP16ToFP32AVX2(Bits(in), n, out);
+}
+
+bool VecCastINT64ToINT32(const int64_t* in, int64_t n, int32_t* out) {
+  if (UseAVX512() && CastINT64ToINT32AVX512(in, n, out)) {
+    return true;
+  }
+  return UseAVX2() && CastINT64ToINT32AVX2(in, n, out);
+}
+
+bool VecCastINT32ToINT64(const int32_t* in, int64_t n, int64_t* out) {
+  if (UseAVX512() && CastINT32ToINT64AVX512(in, n, out)) {
+    return true;
+  }
+  return UseAVX2() && CastINT32ToINT64AVX2(in, n, out);
+}
+
+}  // namespace detail
+}  // namespace funcs
+}  // namespace phi
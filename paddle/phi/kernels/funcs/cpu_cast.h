@@ -0,0 +1,146 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+namespace funcs {
+
+// The casts run by blocks, which are split over the OpenMP threads when the
+// tensor has at least kCPUCastParallelThreshold elements.
+constexpr int64_t kCPUCastBlockSize = 16384;
+constexpr int64_t kCPUCastParallelThreshold = 262144;
+
+namespace detail {
+
+// The AVX2 and AVX-512 casts of the common pairs. They return false if the
+// CPU supports neither, or paddle is not built with them. The float to
+// bfloat16 cast rounds to the nearest even if round_to_nearest_even, like the
+// host code compiled by nvcc, otherwise it truncates like the other host code.
+TEST_API bool VecCastFP32ToBF16(const float* in,
+                                int64_t n,
+                                dtype::bfloat16* out,
+                                bool round_to_nearest_even);
+TEST_API bool VecCastBF16ToFP32(const dtype::bfloat16* in,
+                                int64_t n,
+                                float* out);
+TEST_API bool VecCastFP32ToFP16(const float* in,
+                                int64_t n,
+                                dtype::float16* out);
+TEST_API bool VecCastFP16ToFP32(const dtype::float16* in,
+                                int64_t n,
+                                float* out);
+TEST_API bool VecCastINT64ToINT32(const int64_t* in, int64_t n, int32_t* out);
+TEST_API bool VecCastINT32ToINT64(const int32_t* in, int64_t n, int64_t* out);
+
+template <typename InT, typename OutT>
+struct VecCast {
+  static bool Run(const InT* in, int64_t n, OutT* out) { return false; }
+};
+
+template <>
+struct VecCast<float, dtype::bfloat16> {
+  static bool Run(const float* in, int64_t n, dtype::bfloat16* out) {
+#if defined(PADDLE_CUDA_BF16)
+    return VecCastFP32ToBF16(in, n, out, true);
+#else
+    return VecCastFP32ToBF16(in, n, out, false);
+#endif
+  }
+};
+
+template <>
+struct VecCast<dtype::bfloat16, float> {
+  static bool Run(const dtype::bfloat16* in, int64_t n, float* out) {
+    return VecCastBF16ToFP32(in, n, out);
+  }
+};
+
+template <>
+struct VecCast<float, dtype::float16> {
+  static bool Run(const float* in, int64_t n, dtype::float16* out) {
+    return VecCastFP32ToFP16(in, n, out);
+  }
+};
+
+template <>
+struct VecCast<dtype::float16, float> {
+  static bool Run(const dtype::float16* in, int64_t n, float* out) {
+    return VecCastFP16ToFP32(in, n, out);
+  }
+};
+
+template <>
+struct VecCast<int64_t, int32_t> {
+  static bool Run(const int64_t* in, int64_t n, int32_t* out) {
+    return VecCastINT64ToINT32(in, n, out);
+  }
+};
+
+template <>
+struct VecCast<int32_t, int64_t> {
+  static bool Run(const int32_t* in, int64_t n, int64_t* out) {
+    return VecCastINT32ToINT64(in, n, out);
+  }
+};
+
+// Runs kernel, which casts kWidth elements, over the whole vectors of in, and
+// over a zero padded copy of the tail, so the tail is rounded like the rest.
+template <int kWidth, typename InT, typename OutT, typename Kernel>
+inline void CastByVectors(const InT* in, int64_t n, OutT* out, Kernel kernel) {
+  int64_t i = 0;
+  for (; i + kWidth <= n; i += kWidth) {
+    kernel(in + i, out + i);
+  }
+  if (i < n) {
+    InT in_tail[kWidth] = {};
+    OutT out_tail[kWidth];
+    std::memcpy(in_tail, in + i, (n - i) * sizeof(InT));
+    kernel(in_tail, out_tail);
+    std::memcpy(out + i, out_tail, (n - i) * sizeof(OutT));
+  }
+}
+
+}  // namespace detail
+
+/// Cast the numel elements of in to out on the CPU, as static_cast does.
+/// The float from and to bfloat16 and float16 casts and the int64 from and to
+/// int32 casts are vectorized when the CPU supports AVX2 or AVX-512.
+template <typename InT, typename OutT>
+void CPUCast(const InT* in, int64_t numel, OutT* out) {
+  int64_t num_blocks = (numel + kCPUCastBlockSize - 1) / kCPUCastBlockSize;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for if (numel >= kCPUCastParallelThreshold)
+#endif
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    int64_t begin = b * kCPUCastBlockSize;
+    int64_t n = std::min(kCPUCastBlockSize, numel - begin);
+    if (!detail::VecCast<InT, OutT>::Run(in + begin, n, out + begin)) {
+      for (int64_t i = begin; i < begin + n; ++i) {
+        out[i] = static_cast<OutT>(in[i]);
+      }
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
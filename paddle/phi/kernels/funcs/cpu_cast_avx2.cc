@@ -0,0 +1,134 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// NOTE: this file is compiled with the AVX2 and F16C flags, its functions
+// must only be called after checking the CPU supports them.
+
+#if defined(__AVX2__) && defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#include "paddle/phi/kernels/funcs/cpu_cast.h"
+
+namespace phi {
+namespace funcs {
+namespace detail {
+
+#if defined(__AVX2__) && defined(__F16C__)
+
+namespace {
+
+__m256i FP32ToBF16Bits(__m256 v, bool rne) {
+  __m256i u = _mm256_castps_si256(v);
+  if (!rne) {
+    return _mm256_srli_epi32(u, 16);
+  }
+  __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+  __m256i bias = _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7fff));
+  __m256i r = _mm256_srli_epi32(_mm256_add_epi32(u, bias), 16);
+  __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+  return _mm256_blendv_epi8(r, _mm256_set1_epi32(0x7fff), nan);
+}
+
+}  // namespace
+
+bool CastFP32ToBF16AVX2(const float* in, int64_t n, uint16_t* out, bool rne) {
+  CastByVectors<16>(in, n, out, [rne](const float* x, uint16_t* y) {
+    __m256i lo = FP32ToBF16Bits(_mm256_loadu_ps(x), rne);
+    __m256i hi = FP32ToBF16Bits(_mm256_loadu_ps(x + 8), rne);
+    // packus interleaves the 128-bit lanes of lo and hi
+    __m256i packed =
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(y), packed);
+  });
+  return true;
+}
+
+bool CastBF16ToFP32AVX2(const uint16_t* in, int64_t n, float* out) {
+  CastByVectors<8>(in, n, out, [](const uint16_t* x, float* y) {
+    __m256i u = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+    _mm256_storeu_ps(y, _mm256_castsi256_ps(_mm256_slli_epi32(u, 16)));
+  });
+  return true;
+}
+
+bool CastFP32ToFP16AVX2(const float* in, int64_t n, uint16_t* out) {
+  CastByVectors<8>(in, n, out, [](const float* x, uint16_t* y) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(y),
+        _mm256_cvtps_ph(_mm256_loadu_ps(x), _MM_FROUND_TO_NEAREST_INT));
+  });
+  return true;
+}
+
+bool CastFP16ToFP32AVX2(const uint16_t* in, int64_t n, float* out) {
+  CastByVectors<8>(in, n, out, [](const uint16_t* x, float* y) {
+    _mm256_storeu_ps(y,
+                     _mm256_cvtph_ps(_mm_loadu_si128(
+                         reinterpret_cast<const __m128i*>(x))));
+  });
+  return true;
+}
+
+bool CastINT64ToINT32AVX2(const int64_t* in, int64_t n, int32_t* out) {
+  CastByVectors<8>(in, n, out, [](const int64_t* x, int32_t* y) {
+    // gathers the low halves of the 4 int64 into the low 128 bits
+    const __m256i idx = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    __m256i lo = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)), idx);
+    __m256i hi = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + 4)), idx);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(y),
+                        _mm256_permute2x128_si256(lo, hi, 0x20));
+  });
+  return true;
+}
+
+bool CastINT32ToINT64AVX2(const int32_t* in, int64_t n, int64_t* out) {
+  CastByVectors<4>(in, n, out, [](const int32_t* x, int64_t* y) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(y),
+                        _mm256_cvtepi32_epi64(_mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(x))));
+  });
+  return true;
+}
+
+#else
+
+bool CastFP32ToBF16AVX2(const float* in, int64_t n, uint16_t* out, bool rne) {
+  return false;
+}
+bool CastBF16ToFP32AVX2(const uint16_t* in, int64_t n, float* out) {
+  return false;
+}
+bool CastFP32ToFP16AVX2(const float* in, int64_t n, uint16_t* out) {
+  return false;
+}
+bool CastFP16ToFP32AVX2(const uint16_t* in, int64_t n, float* out) {
+  return false;
+}
+bool CastINT64ToINT32AVX2(const int64_t* in, int64_t n, int32_t* out) {
+  return false;
+}
+bool CastINT32ToINT64AVX2(const int32_t* in, int64_t n, int64_t* out) {
+  return false;
+}
+
+#endif
+
+}  // namespace detail
+}  // namespace funcs
+}  // namespace phi
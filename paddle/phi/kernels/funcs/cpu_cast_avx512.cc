@@ -0,0 +1,126 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// NOTE: this file is compiled with the AVX512F and F16C flags, its functions
+// must only be called after checking the CPU supports them.
+
+#if defined(__AVX512F__) && defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#include "paddle/phi/kernels/funcs/cpu_cast.h"
+
+namespace phi {
+namespace funcs {
+namespace detail {
+
+#if defined(__AVX512F__) && defined(__F16C__)
+
+bool CastFP32ToBF16AVX512(const float* in,
+                          int64_t n,
+                          uint16_t* out,
+                          bool rne) {
+  CastByVectors<16>(in, n, out, [rne](const float* x, uint16_t* y) {
+    __m512 v = _mm512_loadu_ps(x);
+    __m512i u = _mm512_castps_si512(v);
+    __m512i r;
+    if (rne) {
+      __m512i lsb =
+          _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+      __m512i bias = _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff));
+      r = _mm512_srli_epi32(_mm512_add_epi32(u, bias), 16);
+      __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+      r = _mm512_mask_mov_epi32(r, nan, _mm512_set1_epi32(0x7fff));
+    } else {
+      r = _mm512_srli_epi32(u, 16);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(y),
+                        _mm512_cvtepi32_epi16(r));
+  });
+  return true;
+}
+
+bool CastBF16ToFP32AVX512(const uint16_t* in, int64_t n, float* out) {
+  CastByVectors<16>(in, n, out, [](const uint16_t* x, float* y) {
+    __m512i u = _mm512_cvtepu16_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x)));
+    _mm512_storeu_ps(y, _mm512_castsi512_ps(_mm512_slli_epi32(u, 16)));
+  });
+  return true;
+}
+
+bool CastFP32ToFP16AVX512(const float* in, int64_t n, uint16_t* out) {
+  CastByVectors<16>(in, n, out, [](const float* x, uint16_t* y) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(y),
+        _mm512_cvtps_ph(_mm512_loadu_ps(x), _MM_FROUND_TO_NEAREST_INT));
+  });
+  return true;
+}
+
+bool CastFP16ToFP32AVX512(const uint16_t* in, int64_t n, float* out) {
+  CastByVectors<16>(in, n, out, [](const uint16_t* x, float* y) {
+    _mm512_storeu_ps(y,
+                     _mm512_cvtph_ps(_mm256_loadu_si256(
+                         reinterpret_cast<const __m256i*>(x))));
+  });
+  return true;
+}
+
+bool CastINT64ToINT32AVX512(const int64_t* in, int64_t n, int32_t* out) {
+  CastByVectors<8>(in, n, out, [](const int64_t* x, int32_t* y) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(y),
+                        _mm512_cvtepi64_epi32(_mm512_loadu_si512(x)));
+  });
+  return true;
+}
+
+bool CastINT32ToINT64AVX512(const int32_t* in, int64_t n, int64_t* out) {
+  CastByVectors<8>(in, n, out, [](const int32_t* x, int64_t* y) {
+    _mm512_storeu_si512(y,
+                        _mm512_cvtepi32_epi64(_mm256_loadu_si256(
+                            reinterpret_cast<const __m256i*>(x))));
+  });
+  return true;
+}
+
+#else
+
+bool CastFP32ToBF16AVX512(const float* in,
+                          int64_t n,
+                          uint16_t* out,
+                          bool rne) {
+  return false;
+}
+bool CastBF16ToFP32AVX512(const uint16_t* in, int64_t n, float* out) {
+  return false;
+}
+bool CastFP32ToFP16AVX512(const float* in, int64_t n, uint16_t* out) {
+  return false;
+}
+bool CastFP16ToFP32AVX512(const uint16_t* in, int64_t n, float* out) {
+  return false;
+}
+bool CastINT64ToINT32AVX512(const int64_t* in, int64_t n, int32_t* out) {
+  return false;
+}
+bool CastINT32ToINT64AVX512(const int32_t* in, int64_t n, int64_t* out) {
+  return false;
+}
+
+#endif
+
+}  // namespace detail
+}  // namespace funcs
+}  // namespace phi
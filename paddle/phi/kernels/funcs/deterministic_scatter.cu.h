@@ -0,0 +1,259 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+
+#ifdef PADDLE_WITH_CUDA
+#include "cub/cub.cuh"
+#else
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+COMMON_DECLARE_bool(cudnn_deterministic);
+COMMON_DECLARE_int64(deterministic_scatter_min_keys_per_row);
+
+namespace phi {
+namespace funcs {
+
+// How the rows scattered to the same destination row are combined.
+enum class DeterministicScatterMode {
+  // the row scattered last overwrites the destination
+  kAssign,
+  // the sum of the rows overwrites the destination
+  kSum,
+  // the sum of the rows is added to the destination
+  kAccumulate,
+};
+
+// Whether to scatter num_keys rows to num_rows rows by DeterministicScatter
+// rather than atomics: always under FLAGS_cudnn_deterministic, and otherwise
+// when so many keys hit each row that the atomics on it serialize.
+inline bool UseDeterministicScatter(int64_t num_keys, int64_t num_rows) {
+  if (FLAGS_cudnn_deterministic) {
+    return true;
+  }
+  const int64_t min_keys_per_row = FLAGS_deterministic_scatter_min_keys_per_row;
+  return min_keys_per_row > 0 && num_keys >= min_keys_per_row * num_rows;
+}
+
+template <typename KeyT>
+__global__ void DeterministicScatterIotaKernel(int64_t num, KeyT* out) {
+  CUDA_KERNEL_LOOP_TYPE(i, num, int64_t) { out[i] = static_cast<KeyT>(i); }
+}
+
+template <typename T, typename KeyT>
+__global__ void DeterministicScatterKernel(const T* src,
+                                           const KeyT* run_keys,
+                                           const KeyT* run_offsets,
+                                           const KeyT* run_counts,
+                                           const int64_t* num_runs,
+                                           const KeyT* sorted_pos,
+                                           int64_t outer_size,
+                                           int64_t num_keys,
+                                           int64_t num_rows,
+                                           int64_t slice_size,
+                                           DeterministicScatterMode mode,
+                                           T* out) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  // the runs beyond num_runs are empty, as the grid covers one run per key
+  const int64_t runs = *num_runs;
+  CUDA_KERNEL_LOOP_TYPE(i, outer_size * num_keys * slice_size, int64_t) {
+    int64_t run = i / slice_size % num_keys;
+    if (run >= runs) {
+      continue;
+    }
+    int64_t outer_i = i / (slice_size * num_keys);
+    int64_t slice_i = i % slice_size;
+    KeyT row = run_keys[run];
+
+    PADDLE_ENFORCE(
+        row >= 0 && row < num_rows,
+        "The index is out of bounds, "
+        "please check whether the dimensions of index and "
+        "input meet the requirements. It should "
+        "be less than [%d] and greater or equal to 0, but received [%d]",
+        num_rows,
+        row);
+
+    int64_t begin = run_offsets[run];
+    int64_t end = begin + run_counts[run];
+    const T* src_slice = src + outer_i * num_keys * slice_size + slice_i;
+    T* out_ptr = out + (outer_i * num_rows + row) * slice_size + slice_i;
+    if (mode == DeterministicScatterMode::kAssign) {
+      // the sort is stable, so the last one of the run is scattered last
+      int64_t pos = sorted_pos[end - 1];
+      *out_ptr = src_slice[pos * slice_size];
+      continue;
+    }
+    MT sum = mode == DeterministicScatterMode::kAccumulate
+                 ? static_cast<MT>(*out_ptr)
+                 : static_cast<MT>(0);
+    for (int64_t k = begin; k < end; ++k) {
+      int64_t pos = sorted_pos[k];
+      sum = sum + static_cast<MT>(src_slice[pos * slice_size]);
+    }
+    *out_ptr = static_cast<T>(sum);
+  }
+}
+
+static inline void* DeterministicScatterTempStorage(const phi::GPUContext& ctx,
+                                                    size_t bytes,
+                                                    DenseTensor* storage) {
+  // cub only queries the size when the storage is null.
+  storage->Resize(
+      common::make_ddim({static_cast<int64_t>(std::max<size_t>(bytes, 1))}));
+  return ctx.template Alloc<uint8_t>(storage);
+}
+
+/**
+ * Scatters src of shape [outer_size, num_keys, slice_size] to out of shape
+ * [outer_size, num_rows, slice_size] by the row ids in keys, without
+ * atomics, so that the result does not depend on the thread schedule:
+ * out[o, keys[k], s] is combined from src[o, k, s] following mode.
+ *
+ * The keys are radix sorted with their positions, the runs of equal keys
+ * are encoded, and each element of the destination rows is reduced by one
+ * thread over its run in the order of positions and written once. Heavy
+ * collisions on a few rows hence cost no more than spreading keys.
+ */
+template <typename T, typename KeyT>
+void DeterministicScatter(const phi::GPUContext& ctx,
+                          const KeyT* keys,
+                          const T* src,
+                          int64_t outer_size,
+                          int64_t num_keys,
+                          int64_t num_rows,
+                          int64_t slice_size,
+                          DeterministicScatterMode mode,
+                          T* out) {
+  if (outer_size == 0 || num_keys == 0 || slice_size == 0) {
+    return;
+  }
+  auto stream = ctx.stream();
+  DenseTensor temp_storage;
+  size_t temp_storage_bytes = 0;
+
+  // 0. Sort the keys with their positions, only over the bits of valid keys
+  DenseTensor positions, sorted_keys, sorted_pos;
+  positions.Resize(common::make_ddim({num_keys}));
+  sorted_keys.Resize(common::make_ddim({num_keys}));
+  sorted_pos.Resize(common::make_ddim({num_keys}));
+  auto* positions_data = ctx.template Alloc<KeyT>(&positions);
+  auto* sorted_keys_data = ctx.template Alloc<KeyT>(&sorted_keys);
+  auto* sorted_pos_data = ctx.template Alloc<KeyT>(&sorted_pos);
+  auto config = backends::gpu::GetGpuLaunchConfig1D(ctx, num_keys);
+  DeterministicScatterIotaKernel<KeyT>
+      <<<config.block_per_grid.x, config.thread_per_block.x, 0, stream>>>(
+          num_keys, positions_data);
+  int end_bit = 1;
+  while (end_bit < static_cast<int>(sizeof(KeyT) * 8) &&
+         (static_cast<int64_t>(1) << end_bit) < num_rows) {
+    ++end_bit;
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceRadixSort::SortPairs(nullptr,
+                                                             temp_storage_bytes,
+                                                             keys,
+                                                             sorted_keys_data,
+                                                             positions_data,
+                                                             sorted_pos_data,
+                                                             num_keys,
+                                                             0,
+                                                             end_bit,
+                                                             stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceRadixSort::SortPairs(
+      DeterministicScatterTempStorage(ctx, temp_storage_bytes, &temp_storage),
+      temp_storage_bytes,
+      keys,
+      sorted_keys_data,
+      positions_data,
+      sorted_pos_data,
+      num_keys,
+      0,
+      end_bit,
+      stream));
+
+  // 1. Encode the runs of equal keys, reusing the positions for the counts
+  DenseTensor run_keys, run_offsets, num_runs;
+  run_keys.Resize(common::make_ddim({num_keys}));
+  run_offsets.Resize(common::make_ddim({num_keys}));
+  num_runs.Resize(common::make_ddim({1}));
+  auto* run_keys_data = ctx.template Alloc<KeyT>(&run_keys);
+  auto* run_counts_data = positions_data;
+  auto* run_offsets_data = ctx.template Alloc<KeyT>(&run_offsets);
+  auto* num_runs_data = ctx.template Alloc<int64_t>(&num_runs);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceRunLengthEncode::Encode(nullptr,
+                                         temp_storage_bytes,
+                                         sorted_keys_data,
+                                         run_keys_data,
+                                         run_counts_data,
+                                         num_runs_data,
+                                         num_keys,
+                                         stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceRunLengthEncode::Encode(
+      DeterministicScatterTempStorage(ctx, temp_storage_bytes, &temp_storage),
+      temp_storage_bytes,
+      sorted_keys_data,
+      run_keys_data,
+      run_counts_data,
+      num_runs_data,
+      num_keys,
+      stream));
+  // the counts beyond num_runs are not written, but neither read
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceScan::ExclusiveSum(nullptr,
+                                                           temp_storage_bytes,
+                                                           run_counts_data,
+                                                           run_offsets_data,
+                                                           num_keys,
+                                                           stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceScan::ExclusiveSum(
+      DeterministicScatterTempStorage(ctx, temp_storage_bytes, &temp_storage),
+      temp_storage_bytes,
+      run_counts_data,
+      run_offsets_data,
+      num_keys,
+      stream));
+
+  // 2. Reduce each run and write the destination rows once. The number of
+  // runs stays on the device, so the grid covers one run per key.
+  int block = 512;
+  int64_t n = outer_size * num_keys * slice_size;
+  dim3 grid = dim3((n + block - 1) / block);
+  phi::backends::gpu::LimitGridDim(ctx, &grid);
+  DeterministicScatterKernel<T, KeyT>
+      <<<grid, block, 0, stream>>>(src,
+                                   run_keys_data,
+                                   run_offsets_data,
+                                   run_counts_data,
+                                   num_runs_data,
+                                   sorted_pos_data,
+                                   outer_size,
+                                   num_keys,
+                                   num_rows,
+                                   slice_size,
+                                   mode,
+                                   out);
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -137,7 +137,14 @@ __global__ void VectorizedRandomGenerator(
     T* dst,
     bool is_upscale_in_train,
     uint64_t increment,
-    size_t main_offset) {
+    size_t main_offset,
+    const uint64_t* seed_ptr = nullptr,
+    const uint64_t* offset_ptr = nullptr) {
+  // the seed and base offset of a CUDA Graph replay are on the device
+  if (offset_ptr) {
+    seed = seed_ptr[0];
+    increment += offset_ptr[0];
+  }
   size_t idx = static_cast<size_t>(BLOCK_ID_X * BLOCK_NUM_X);
   static constexpr int kCount =
       phi::funcs::uniform_distribution<float>::kReturnsCount;
@@ -203,11 +210,12 @@ __global__ void VectorizedGeneratorMask(const size_t n,
                                         uint64_t increment,
                                         size_t main_offset,
                                         MaskFunctor<T> mask_functor,
-
-                                        const uint64_t* seed_ptr) {
+                                        const uint64_t* seed_ptr,
+                                        const uint64_t* offset_ptr = nullptr) {
   // Vectorized Generate Mask
   // kCount is 4 for curand_uniform4 is used
   if (seed_ptr) seed = seed_ptr[0];
+  if (offset_ptr) increment += offset_ptr[0];
 
   constexpr int kCount = phi::funcs::uniform_distribution<float>::kReturnsCount;
   size_t idx = static_cast<size_t>(BLOCK_ID_X * BLOCK_NUM_X);
@@ -330,6 +338,16 @@ void DropoutFwGPUKernelDriver(
                                                     true);
       const uint64_t* seed_ptr =
           copy_in_kernel ? seed->data<uint64_t>() : nullptr;
+      const uint64_t* offset_ptr = nullptr;
+      if (!copy_in_kernel && !is_fix_seed &&
+          phi::backends::gpu::CUDAGraph::IsThisThreadCapturing()) {
+        auto philox = dev_ctx.GetGenerator()->IncrementPhiloxState(offset);
+        if (philox.offset_ptr != nullptr) {
+          seed_ptr = philox.seed_ptr;
+          offset_ptr = philox.offset_ptr;
+          increment = philox.offset;
+        }
+      }
 
       VectorizedGeneratorMask<T>
           <<<grid_size, block_size, 0, stream>>>(size,
@@ -340,7 +358,8 @@ void DropoutFwGPUKernelDriver(
                                                  increment,
                                                  main_offset,
                                                  mask_functor,
-                                                 seed_ptr);
+                                                 seed_ptr,
+                                                 offset_ptr);
       auto dst_functor =
           DstFunctor<T>(1.0f - dropout_prob, upscale_in_train, x_numel);
       std::vector<const phi::DenseTensor*> ins = {&x, mask};
@@ -366,6 +385,30 @@ void DropoutFwGPUKernelDriver(
       auto gen_cuda = dev_ctx.GetGenerator();
       auto state_index = gen_cuda->GetStateIndex();
 
+      // when the generator keeps the philox state of the captured graph on
+      // the device, the node reads it and is never updated by the host
+      phi::PhiloxState philox;
+      if (!is_fix_seed && seed == nullptr &&
+          phi::backends::gpu::CUDAGraph::IsThisThreadCapturing()) {
+        philox = gen_cuda->IncrementPhiloxState(offset);
+      }
+      if (philox.offset_ptr != nullptr) {
+        VectorizedRandomGenerator<T>
+            <<<grid_size, block_size, 0, stream>>>(0,
+                                                   size,
+                                                   seed_data,
+                                                   dropout_prob,
+                                                   x_data,
+                                                   mask_data,
+                                                   y_data,
+                                                   upscale_in_train,
+                                                   philox.offset,
+                                                   main_offset,
+                                                   philox.seed_ptr,
+                                                   philox.offset_ptr);
+        return;
+      }
+
       phi::backends::gpu::CUDAGraphNodeLauncher::parameterSetter_t
           parameterSetter = [offset, dev_ctx_p, state_index, is_fix_seed](
                                 phi::backends::gpu::gpuKernelParams& params) {
@@ -102,13 +102,15 @@ void exec_fft(const phi::CPUContext& ctx,
   const phi::DDim input_stride = common::stride(collapsed_input_shape);
   const phi::DDim output_stride = common::stride(collapsed_output_shape);
 
-  DftiDescriptor desc = plan_mkl_fft(x.dtype(),
-                                     out->dtype(),
-                                     input_stride,
-                                     output_stride,
-                                     signal_sizes,
-                                     normalization,
-                                     forward);
+  std::shared_ptr<DftiDescriptor> desc_ptr =
+      get_mkl_fft_descriptor(x.dtype(),
+                             out->dtype(),
+                             input_stride,
+                             output_stride,
+                             signal_sizes,
+                             normalization,
+                             forward);
+  const DftiDescriptor& desc = *desc_ptr;
   // execute the transform
   const FFTTransformType fft_type = GetFFTTransformType(x.dtype(), out->type());
   if (fft_type == FFTTransformType::C2R && forward) {
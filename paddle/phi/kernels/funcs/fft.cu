@@ -174,10 +174,12 @@ void exec_fft(const phi::GPUContext& ctx,
   std::unique_ptr<FFTConfig> config_ = nullptr;
   bool using_cache = use_cache(key.sizes_);
 
+  // held until the plan is launched, so the plan is neither evicted nor
+  // bound to another stream meanwhile
+  std::unique_lock<std::mutex> guard;
   if (using_cache) {
     FFTConfigCache& plan_cache = get_fft_plan_cache(device_id);
-    std::unique_lock<std::mutex> guard(plan_cache.mutex, std::defer_lock);
-    guard.lock();
+    guard = std::unique_lock<std::mutex>(plan_cache.mutex);
     config = &(plan_cache.lookup(key));
   } else {
     config_ = std::make_unique<FFTConfig>(key);
@@ -188,17 +190,7 @@ void exec_fft(const phi::GPUContext& ctx,
   DenseTensor workspace_tensor = Empty<uint8_t>(ctx, {workspace_size});
 
   // prepare cufft for execution
-#if defined(PADDLE_WITH_CUDA)
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::cufftSetStream(config->plan(), ctx.stream()));
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::cufftSetWorkArea(config->plan(), workspace_tensor.data()));
-#elif defined(PADDLE_WITH_HIP)
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::hipfftSetStream(config->plan(), ctx.stream()));
-  PADDLE_ENFORCE_GPU_SUCCESS(
-      phi::dynload::hipfftSetWorkArea(config->plan(), workspace_tensor.data()));
-#endif
+  config->Bind(ctx.stream(), workspace_tensor.data());
 
   // execution of fft plan
   const FFTTransformType fft_type = config->transform_type();
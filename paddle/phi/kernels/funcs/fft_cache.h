@@ -14,6 +14,7 @@
 
 #pragma once
 #include <functional>
+#include <iterator>
 #include <limits>
 #include <list>
 #include <memory>
@@ -21,12 +22,15 @@
 #include <unordered_map>
 #include <utility>
 
+#include "paddle/common/flags.h"
 #if defined(PADDLE_WITH_CUDA)
 #include "paddle/phi/kernels/funcs/cufft_util.h"
 #elif defined(PADDLE_WITH_HIP)
 #include "paddle/phi/kernels/funcs/hipfft_util.h"
 #endif
 
+COMMON_DECLARE_int64(fft_plan_cache_workspace_mb);
+
 namespace phi {
 namespace funcs {
 namespace detail {
@@ -63,7 +67,10 @@ class FFTConfigCache {
 
   FFTConfigCache() : FFTConfigCache(CUFFT_DEFAULT_CACHE_SIZE) {}
 
-  explicit FFTConfigCache(int64_t max_size) { _set_max_size(max_size); }
+  explicit FFTConfigCache(int64_t max_size)
+      : _workspace_budget(FLAGS_fft_plan_cache_workspace_mb << 20) {
+    _set_max_size(max_size);
+  }
 
   FFTConfigCache(const FFTConfigCache& other) = delete;
   FFTConfigCache& operator=(const FFTConfigCache& other) = delete;
@@ -71,12 +78,16 @@ class FFTConfigCache {
   FFTConfigCache(FFTConfigCache&& other) noexcept
       : _usage_list(std::move(other._usage_list)),
         _cache_map(std::move(other._cache_map)),
-        _max_size(other._max_size) {}
+        _max_size(other._max_size),
+        _workspace_size(other._workspace_size),
+        _workspace_budget(other._workspace_budget) {}
 
   FFTConfigCache& operator=(FFTConfigCache&& other) noexcept {
     _usage_list = std::move(other._usage_list);
     _cache_map = std::move(other._cache_map);
     _max_size = other._max_size;
+    _workspace_size = other._workspace_size;
+    _workspace_budget = other._workspace_budget;
     return *this;
   }
 
@@ -100,10 +111,7 @@ class FFTConfigCache {
     // Miss
     // remove if needed
     if (_usage_list.size() >= _max_size) {
-      auto last = _usage_list.end();
-      last--;
-      _cache_map.erase(last->first);
-      _usage_list.pop_back();
+      _evict_last();
     }
 
     // construct new plan at list front, then insert into _cache_map
@@ -114,29 +122,38 @@ class FFTConfigCache {
     _cache_map.emplace(std::piecewise_construct,
                        std::forward_as_tuple(kv_it->first),
                        std::forward_as_tuple(kv_it));
+    _workspace_size += kv_it->second.workspace_size();
+
+    // the workspace the cached plans ask for stays in the budget, the new
+    // plan is kept even if it alone exceeds it
+    while (_workspace_budget > 0 && _usage_list.size() > 1 &&
+           _workspace_size > static_cast<size_t>(_workspace_budget)) {
+      _evict_last();
+    }
     return kv_it->second;
   }
 
   void clear() {
     _cache_map.clear();
     _usage_list.clear();
+    _workspace_size = 0;
   }
 
   void resize(int64_t new_size) {
     _set_max_size(new_size);
     auto cur_size = _usage_list.size();
     if (cur_size > _max_size) {
-      auto delete_it = _usage_list.end();
       for (size_t i = 0; i < cur_size - _max_size; i++) {
-        delete_it--;
-        _cache_map.erase(delete_it->first);
+        _evict_last();
       }
-      _usage_list.erase(delete_it, _usage_list.end());
     }
   }
 
   size_t size() const { return _cache_map.size(); }
 
+  // the sum of the workspace sizes of the cached plans
+  size_t workspace_size() const { return _workspace_size; }
+
   size_t max_size() const noexcept { return _max_size; }
 
   std::mutex mutex;
@@ -163,9 +180,18 @@ class FFTConfigCache {
     _max_size = static_cast<size_t>(new_size);
   }
 
+  void _evict_last() {
+    auto last = std::prev(_usage_list.end());
+    _workspace_size -= last->second.workspace_size();
+    _cache_map.erase(last->first);
+    _usage_list.pop_back();
+  }
+
   std::list<kv_t> _usage_list;
   map_t _cache_map;
   size_t _max_size;
+  size_t _workspace_size{0};
+  int64_t _workspace_budget;
 };
 
 static std::vector<std::unique_ptr<FFTConfigCache>> plan_caches;
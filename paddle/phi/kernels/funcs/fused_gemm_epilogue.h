@@ -18,6 +18,7 @@ limitations under the License. */
 #include <algorithm>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #ifdef PADDLE_WITH_CUDA
 
@@ -37,10 +38,12 @@ limitations under the License. */
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/core/scope_guard.h"
+#include "paddle/phi/kernels/autotune/switch_autotune.h"
 #include "paddle/phi/kernels/funcs/blas/blaslt_impl.cu.h"
 #include "paddle/utils/optional.h"
 
 COMMON_DECLARE_int64(cublaslt_exhaustive_search_times);
+COMMON_DECLARE_bool(use_autotune);
 
 namespace phi {
 namespace funcs {
@@ -69,7 +72,14 @@ class GemmEpilogueAlgoCache {
                                     cudaStream_t stream,
                                     void* workspace,
                                     size_t workspace_size) {
-    if (search_times_ <= 0) return nullptr;
+    // the search of each shape is by FLAGS_cublaslt_exhaustive_search_times
+    // or by autotune, the winner is kept in AutoTuneCache
+    auto& autotune_cache = phi::autotune::AutoTuneCache::Instance().Get(
+        phi::autotune::AlgorithmType::kGemmEpilogue);
+    if (search_times_ <= 0 && !FLAGS_use_autotune &&
+        autotune_cache.Size() == 0) {
+      return nullptr;
+    }
 
     int64_t seed = 0;
     std::hash<int64_t> hash_fn;
@@ -79,7 +89,6 @@ class GemmEpilogueAlgoCache {
     HashMatrixLayoutDesc_(b_desc, &seed, hash_fn);
     HashMatrixLayoutDesc_(c_desc, &seed, hash_fn);
 
-    cublasLtMatmulAlgo_t ret;
     {
       std::lock_guard<std::mutex> lock(cache_mutex_);
       auto it = map_.find(seed);
@@ -88,6 +97,81 @@ class GemmEpilogueAlgoCache {
       }
     }
 
+    size_t key = static_cast<size_t>(seed);
+    int search_times = search_times_;
+    if (search_times <= 0 &&
+        phi::autotune::AutoTuneStatus::Instance().UseAutoTune()) {
+      search_times = kAutoTuneSearchTimes;
+    }
+    bool find_in_cache = autotune_cache.Find(key);
+    if (!find_in_cache && search_times <= 0) {
+      // left to the heuristic of cublasLt
+      return nullptr;
+    }
+
+    std::vector<cublasLtMatmulAlgo_t> candidates = GetCandidateAlgos_(
+        lt_handle, op_desc, a_desc, b_desc, c_desc, workspace_size);
+    int64_t best_algo_idx = -1;
+    if (find_in_cache) {
+      best_algo_idx = autotune_cache.Get(key);
+      if (best_algo_idx >= static_cast<int64_t>(candidates.size())) {
+        // tuned by another version of cublasLt
+        best_algo_idx = -1;
+      }
+    }
+    if (best_algo_idx == -1) {
+      if (search_times <= 0) {
+        return nullptr;
+      }
+      best_algo_idx = SearchBestAlgo_(candidates,
+                                      search_times,
+                                      lt_handle,
+                                      op_desc,
+                                      a_desc,
+                                      b_desc,
+                                      c_desc,
+                                      alpha,
+                                      beta,
+                                      a,
+                                      b,
+                                      c,
+                                      stream,
+                                      workspace,
+                                      workspace_size);
+      autotune_cache.Set(key, best_algo_idx);
+      VLOG(4) << "Search time:" << search_times << ", hash-key (" << seed
+              << ") not found in GemmEpilogueAlgoCache, the best of "
+              << candidates.size() << " algos is " << best_algo_idx;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto& algo_in_map = map_[seed];
+    algo_in_map = candidates[best_algo_idx];
+    return &algo_in_map;
+  }
+
+ private:
+  explicit GemmEpilogueAlgoCache(int search_times)
+      : search_times_(search_times) {
+    map_.clear();
+  }
+  std::unordered_map<int64_t, cublasLtMatmulAlgo_t> map_;
+  int search_times_;
+  const int requested_algo_count_ = 10;
+  // of each algo in the autotune range
+  static constexpr int kAutoTuneSearchTimes = 5;
+  std::mutex cache_mutex_;
+
+  // The heuristic algos of cublasLt, each followed by its split-K variants
+  // that fit in workspace_size. The order only depends on the descs, so the
+  // index of an algo is the same in each process.
+  std::vector<cublasLtMatmulAlgo_t> GetCandidateAlgos_(
+      cublasLtHandle_t lt_handle,
+      cublasLtMatmulDesc_t op_desc,
+      cublasLtMatrixLayout_t a_desc,
+      cublasLtMatrixLayout_t b_desc,
+      cublasLtMatrixLayout_t c_desc,
+      size_t workspace_size) {
     cublasLtMatmulPreference_t preference;
     PADDLE_ENFORCE_GPU_SUCCESS(
         phi::dynload::cublasLtMatmulPreferenceCreate(&preference));
@@ -121,7 +205,71 @@ class GemmEpilogueAlgoCache {
     PADDLE_ENFORCE_GPU_SUCCESS(
         phi::dynload::cublasLtMatmulPreferenceDestroy(preference));
 
-    int best_algo_idx = -1;
+    static const int32_t kSplitKNums[] = {2, 4, 8, 16};
+    std::vector<cublasLtMatmulAlgo_t> candidates;
+    for (int i = 0; i < returned_results; ++i) {
+      const cublasLtMatmulAlgo_t& algo = heuristic_results[i].algo;
+      candidates.push_back(algo);
+
+      int32_t splitk_support = 0;
+      size_t size_written = 0;
+      if (phi::dynload::cublasLtMatmulAlgoCapGetAttribute(
+              &algo,
+              CUBLASLT_ALGO_CAP_SPLITK_SUPPORT,
+              &splitk_support,
+              sizeof(splitk_support),
+              &size_written) != CUBLAS_STATUS_SUCCESS ||
+          !splitk_support) {
+        continue;
+      }
+      for (int32_t splitk_num : kSplitKNums) {
+        cublasLtMatmulAlgo_t splitk_algo = algo;
+        cublasLtMatmulHeuristicResult_t result;
+        uint32_t reduction_scheme = CUBLASLT_REDUCTION_SCHEME_COMPUTE_TYPE;
+        if (phi::dynload::cublasLtMatmulAlgoConfigSetAttribute(
+                &splitk_algo,
+                CUBLASLT_ALGO_CONFIG_SPLITK_NUM,
+                &splitk_num,
+                sizeof(splitk_num)) == CUBLAS_STATUS_SUCCESS &&
+            phi::dynload::cublasLtMatmulAlgoConfigSetAttribute(
+                &splitk_algo,
+                CUBLASLT_ALGO_CONFIG_REDUCTION_SCHEME,
+                &reduction_scheme,
+                sizeof(reduction_scheme)) == CUBLAS_STATUS_SUCCESS &&
+            phi::dynload::cublasLtMatmulAlgoCheck(lt_handle,
+                                                  op_desc,
+                                                  a_desc,
+                                                  b_desc,
+                                                  c_desc,
+                                                  c_desc,
+                                                  &splitk_algo,
+                                                  &result) ==
+                CUBLAS_STATUS_SUCCESS &&
+            result.workspaceSize <= workspace_size) {
+          candidates.push_back(splitk_algo);
+        }
+      }
+    }
+    return candidates;
+  }
+
+  int64_t SearchBestAlgo_(const std::vector<cublasLtMatmulAlgo_t>& candidates,
+                          int search_times,
+                          cublasLtHandle_t lt_handle,
+                          cublasLtMatmulDesc_t op_desc,
+                          cublasLtMatrixLayout_t a_desc,
+                          cublasLtMatrixLayout_t b_desc,
+                          cublasLtMatrixLayout_t c_desc,
+                          const void* alpha,
+                          const void* beta,
+                          const void* a,
+                          const void* b,
+                          void* c,
+                          cudaStream_t stream,
+                          void* workspace,
+                          size_t workspace_size) {
+    int num_candidates = static_cast<int>(candidates.size());
+    int64_t best_algo_idx = -1;
     float best_algo_time = 0;
 
     // Run 100 times for warmup
@@ -140,14 +288,14 @@ class GemmEpilogueAlgoCache {
                                        c_desc,
                                        c,
                                        c_desc,
-                                       &heuristic_results[warmup_algo_idx].algo,
+                                       &candidates[warmup_algo_idx],
                                        workspace,
                                        workspace_size,
                                        stream);
       if (status != CUBLAS_STATUS_SUCCESS) {
         t = -1;
         warmup_algo_idx += 1;
-        if (warmup_algo_idx == requested_algo_count_) {
+        if (warmup_algo_idx == num_candidates) {
           PADDLE_THROW(
               phi::errors::Unavailable("No GEMM epilogue algorithm support!"));
         }
@@ -158,9 +306,9 @@ class GemmEpilogueAlgoCache {
     PADDLE_ENFORCE_GPU_SUCCESS(cudaEventCreate(&start_event));
     PADDLE_ENFORCE_GPU_SUCCESS(cudaEventCreate(&stop_event));
 
-    for (int algo_idx = 0; algo_idx < returned_results; ++algo_idx) {
+    for (int algo_idx = 0; algo_idx < num_candidates; ++algo_idx) {
       float curr_time = 0;
-      for (int check_idx = 0; check_idx < search_times_; check_idx++) {
+      for (int check_idx = 0; check_idx < search_times; check_idx++) {
         float time = 0;
         PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(start_event, stream));
 
@@ -177,7 +325,7 @@ class GemmEpilogueAlgoCache {
                                          c_desc,
                                          c,
                                          c_desc,
-                                         &heuristic_results[algo_idx].algo,
+                                         &candidates[algo_idx],
                                          workspace,
                                          workspace_size,
                                          stream);
@@ -192,8 +340,7 @@ class GemmEpilogueAlgoCache {
           break;
         }
       }
-
-      curr_time = curr_time / search_times_;
+      curr_time = curr_time / search_times;
       if (curr_time < best_algo_time || algo_idx == 0) {
         best_algo_idx = algo_idx;
         best_algo_time = curr_time;
@@ -207,27 +354,8 @@ class GemmEpilogueAlgoCache {
       PADDLE_THROW(
           phi::errors::Unavailable("No GEMM epilogue algorithm support!"));
     }
-
-    ret = heuristic_results[best_algo_idx].algo;
-
-    VLOG(4) << "Search time:" << search_times_ << ", hash-key (" << seed
-            << ") not found in GemmEpilogueAlgoCache";
-
-    std::lock_guard<std::mutex> lock(cache_mutex_);
-    auto& algo_in_map = map_[seed];
-    algo_in_map = ret;
-    return &algo_in_map;
-  }
-
- private:
-  explicit GemmEpilogueAlgoCache(int search_times)
-      : search_times_(search_times) {
-    map_.clear();
+    return best_algo_idx;
   }
-  std::unordered_map<int64_t, cublasLtMatmulAlgo_t> map_;
-  int search_times_;
-  const int requested_algo_count_ = 10;
-  std::mutex cache_mutex_;
 
   void HashMatmulDesc_(cublasLtMatmulDesc_t desc,
                        int64_t* seed,
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/generator_graph_state.h"
+
+#include "glog/logging.h"
+#include "paddle/phi/common/memory_utils.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+__global__ void SetPhiloxBaseKernel(uint64_t* seed_offset,
+                                    uint64_t seed,
+                                    uint64_t offset) {
+  seed_offset[0] = seed;
+  seed_offset[1] = offset;
+}
+
+}  // namespace
+
+GeneratorGraphState::GeneratorGraphState(const GPUContext& ctx,
+                                         Generator* generator)
+    : generator_(generator), stream_(ctx.stream()) {
+  // allocated out of the memory pool of the graph, it outlives the capture
+  buffer_ = phi::memory_utils::Alloc(ctx.GetPlace(), 2 * sizeof(uint64_t));
+  auto* seed_offset = reinterpret_cast<uint64_t*>(buffer_->ptr());
+  generator_->BeginGraphCapture(seed_offset, seed_offset + 1);
+}
+
+void GeneratorGraphState::EndCapture() {
+  replay_offset_ = generator_->EndGraphCapture();
+}
+
+void GeneratorGraphState::PrepareReplay() {
+  if (replay_offset_ == 0) return;
+  auto seed_offset = generator_->IncrementOffset(replay_offset_);
+  VLOG(10) << "Replay the CUDA Graph with seed " << seed_offset.first
+           << ", base offset " << seed_offset.second;
+  SetPhiloxBaseKernel<<<1, 1, 0, stream_>>>(
+      reinterpret_cast<uint64_t*>(buffer_->ptr()),
+      seed_offset.first,
+      seed_offset.second);
+}
+
+}  // namespace funcs
+}  // namespace phi
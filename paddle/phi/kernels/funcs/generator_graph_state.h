@@ -0,0 +1,52 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/generator.h"
+
+namespace phi {
+namespace funcs {
+
+/**
+ * GeneratorGraphState keeps the philox seed and base offset of a captured
+ * CUDA Graph on the device.
+ *
+ * While the graph is captured, the random kernels get the PhiloxState of
+ * Generator::IncrementPhiloxState, which points at the device seed and base
+ * offset, so their nodes never change. Before each replay, PrepareReplay
+ * reserves the offsets of one replay on the generator and writes the seed
+ * and the new base offset with one kernel on the stream of the graph, which
+ * keeps the replays and the kernels outside the graph on distinct offsets.
+ */
+class GeneratorGraphState {
+ public:
+  GeneratorGraphState(const GPUContext& ctx, Generator* generator);
+
+  void EndCapture();
+
+  void PrepareReplay();
+
+ private:
+  Generator* generator_;
+  gpuStream_t stream_;
+  Allocator::AllocationPtr buffer_;
+  uint64_t replay_offset_{0};
+};
+
+}  // namespace funcs
+}  // namespace phi
+#endif
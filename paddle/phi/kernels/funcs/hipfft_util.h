@@ -109,9 +109,23 @@ class FFTConfig {
   DataType data_type() const { return precision_; }
   size_t workspace_size() const { return ws_size_; }
 
+  // Bind the plan to the stream and the workspace of a call. A cached plan is
+  // reused across streams, so the stream is only set again when it changes.
+  void Bind(hipStream_t stream, void* workspace) {
+    if (!stream_bound_ || stream != stream_) {
+      PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::hipfftSetStream(plan(), stream));
+      stream_ = stream;
+      stream_bound_ = true;
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::dynload::hipfftSetWorkArea(plan(), workspace));
+  }
+
  private:
   HIPFFTHandle plan_;
   size_t ws_size_;  // workspace size in bytes
+  hipStream_t stream_{nullptr};
+  bool stream_bound_{false};
   FFTTransformType fft_type_;
   DataType precision_;
 };
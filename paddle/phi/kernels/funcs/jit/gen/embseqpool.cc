@@ -24,13 +24,25 @@ namespace phi {
 namespace jit {
 namespace gen {
 
+void EmbSeqPoolJitCode::LoadTable(int reg_i, const Xbyak::Address& addr) {
+  if (bf16_) {
+    // the bfloat16 is the high half of the float
+    vpmovzxwd(ymm_t(reg_i), addr);
+    vpslld(ymm_t(reg_i), ymm_t(reg_i), 16);
+  } else {
+    vmovups(ymm_t(reg_i), addr);
+  }
+}
+
 void EmbSeqPoolJitCode::genCode() {
   preCode();
   constexpr int block = YMM_FLOAT_BLOCK;
   constexpr int max_num_regs = 8;
   const int num_block = tbl_w_ / block;
   const int num_groups = num_block / max_num_regs;
-  const size_t block_size = sizeof(float) * block;
+  // of the table and the output
+  const size_t type_size = bf16_ ? sizeof(int16_t) : sizeof(float);
+  const size_t block_size = type_size * block;
   std::vector<int> groups(num_groups, max_num_regs);
   int rest_num_regs = num_block % max_num_regs;
   if (rest_num_regs > 0) {
@@ -46,7 +58,7 @@ void EmbSeqPoolJitCode::genCode() {
   mov(rax, sizeof(int64_t));
   mul(reg_idx_width_in_byte);
   mov(reg_idx_width_in_byte, rax);
-  const size_t tbl_width_in_byte = sizeof(float) * tbl_w_;
+  const size_t tbl_width_in_byte = type_size * tbl_w_;
   int acc_num_regs = 0;
   for (int num_regs : groups) {
     Label l_next_idx_w, l_next_idx_h, l_save_now;
@@ -66,7 +78,7 @@ void EmbSeqPoolJitCode::genCode() {
       add(reg_ptr_tbl_i, param_tbl);  // reg is ptr_i now
       size_t w_offset = 0;
       for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ymm_t(reg_i + num_regs), ptr[reg_ptr_tbl_i + w_offset]);
+        LoadTable(reg_i + num_regs, ptr[reg_ptr_tbl_i + w_offset]);
         w_offset += block_size;
       }
       add(reg_ptr_idx_i, reg_idx_width_in_byte);
@@ -91,7 +103,7 @@ void EmbSeqPoolJitCode::genCode() {
         add(reg_ptr_tbl_i, param_tbl);
         size_t w_offset = 0;
         for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-          vmovups(ymm_t(reg_i), ptr[reg_ptr_tbl_i + w_offset]);
+          LoadTable(reg_i, ptr[reg_ptr_tbl_i + w_offset]);
           vaddps(
               ymm_t(reg_i + num_regs), ymm_t(reg_i + num_regs), ymm_t(reg_i));
           w_offset += block_size;
@@ -104,7 +116,12 @@ void EmbSeqPoolJitCode::genCode() {
       // avg or sqrt here, if needed
       w_offset = 0;
       for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ptr[reg_ptr_dst_i + w_offset], ymm_t(reg_i + num_regs));
+        if (bf16_) {
+          vcvtneps2bf16(xmm_t(reg_i + num_regs), ymm_t(reg_i + num_regs));
+          vmovdqu(ptr[reg_ptr_dst_i + w_offset], xmm_t(reg_i + num_regs));
+        } else {
+          vmovups(ptr[reg_ptr_dst_i + w_offset], ymm_t(reg_i + num_regs));
+        }
         w_offset += block_size;
       }
       add(reg_ptr_dst_i, tbl_width_in_byte);
@@ -130,6 +147,12 @@ class EmbSeqPoolCreator : public JitCodeCreator<emb_seq_pool_attr_t> {
   }
   std::unique_ptr<GenBase> CreateJitCode(
       const emb_seq_pool_attr_t& attr) const override {
+    CheckAttr(attr);
+    return make_unique<EmbSeqPoolJitCode>(attr, CodeSize(attr));
+  }
+
+ protected:
+  void CheckAttr(const emb_seq_pool_attr_t& attr) const {
     PADDLE_ENFORCE_GT(attr.table_height,
                       0,
                       phi::errors::InvalidArgument(
@@ -160,7 +183,20 @@ class EmbSeqPoolCreator : public JitCodeCreator<emb_seq_pool_attr_t> {
                           "The attribute out_width of EmbSeqPool should be "
                           "larger than 0. But it is %d.",
                           attr.out_width));
-    return make_unique<EmbSeqPoolJitCode>(attr, CodeSize(attr));
+  }
+};
+
+class EmbSeqPoolBF16Creator : public EmbSeqPoolCreator {
+ public:
+  bool CanBeUsed(const emb_seq_pool_attr_t& attr) const override {
+    return phi::backends::cpu::MayIUse(phi::backends::cpu::avx512_bf16) &&
+           attr.table_width % YMM_FLOAT_BLOCK == 0;
+  }
+  std::unique_ptr<GenBase> CreateJitCode(
+      const emb_seq_pool_attr_t& attr) const override {
+    CheckAttr(attr);
+    return make_unique<EmbSeqPoolJitCode>(
+        attr, CodeSize(attr), nullptr, /*bf16=*/true);
   }
 };
 
@@ -171,3 +207,4 @@ class EmbSeqPoolCreator : public JitCodeCreator<emb_seq_pool_attr_t> {
 namespace gen = phi::jit::gen;
 
 REGISTER_JITKERNEL_GEN(kEmbSeqPool, gen::EmbSeqPoolCreator);
+REGISTER_JITKERNEL_GEN(kEmbSeqPoolBF16, gen::EmbSeqPoolBF16Creator);
@@ -24,14 +24,17 @@ namespace phi {
 namespace jit {
 namespace gen {
 
+// bf16 is of a bfloat16 table and output, which needs avx512_bf16 to round.
 class EmbSeqPoolJitCode : public JitCode {
  public:
   explicit EmbSeqPoolJitCode(const emb_seq_pool_attr_t& attr,
                              size_t code_size = 256 * 1024,
-                             void* code_ptr = nullptr)
+                             void* code_ptr = nullptr,
+                             bool bf16 = false)
       : JitCode(code_size, code_ptr),
         tbl_w_(attr.table_width),
-        type_(attr.pool_type) {
+        type_(attr.pool_type),
+        bf16_(bf16) {
     if (type_ != SeqPoolType::kSum) {
       PADDLE_THROW(phi::errors::Unimplemented("Only supports sum pool yet."));
     }
@@ -48,13 +51,20 @@ class EmbSeqPoolJitCode : public JitCode {
       base += "_Sqrt";
     }
     base += ("_W" + std::to_string(tbl_w_));
+    if (bf16_) {
+      base += "_BF16";
+    }
     return base;
   }
   void genCode() override;
 
  private:
+  // to float of the accumulators
+  void LoadTable(int reg_i, const Xbyak::Address& addr);
+
   int tbl_w_;
   SeqPoolType type_;
+  bool bf16_;
   reg64_t param_tbl{abi_param1};
   reg64_t param_idx{abi_param2};
   reg64_t param_dst{abi_param3};
@@ -59,6 +59,7 @@ const char* to_string(KernelType kt) {
     ONE_CASE(kAdam);
     ONE_CASE(kAdamW);
     ONE_CASE(kEmbSeqPool);
+    ONE_CASE(kEmbSeqPoolBF16);
     ONE_CASE(kSgd);
     default:
       PADDLE_THROW(phi::errors::Unimplemented(
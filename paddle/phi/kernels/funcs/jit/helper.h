@@ -22,6 +22,7 @@
 #include <utility>  // for std::move
 #include <vector>
 
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/kernels/funcs/jit/gen_base.h"
@@ -36,7 +37,9 @@ class GenBase;
 
 template <typename KernelTuple, typename PlaceType>
 inline typename std::enable_if<
-    std::is_same<typename KernelTuple::data_type, float>::value &&
+    (std::is_same<typename KernelTuple::data_type, float>::value ||
+     std::is_same<typename KernelTuple::data_type,
+                  phi::dtype::bfloat16>::value) &&
         std::is_same<PlaceType, phi::CPUPlace>::value,
     const Kernel*>::type
 GetJitCode(const typename KernelTuple::attr_type& attr) {
@@ -71,7 +74,9 @@ GetJitCode(const typename KernelTuple::attr_type& attr) {
 
 template <typename KernelTuple, typename PlaceType>
 inline typename std::enable_if<
-    !std::is_same<typename KernelTuple::data_type, float>::value ||
+    (!std::is_same<typename KernelTuple::data_type, float>::value &&
+     !std::is_same<typename KernelTuple::data_type,
+                   phi::dtype::bfloat16>::value) ||
         !std::is_same<PlaceType, phi::CPUPlace>::value,
     const Kernel*>::type
 GetJitCode(const typename KernelTuple::attr_type& attr UNUSED) {
@@ -28,6 +28,7 @@ typedef enum {
   kAdamW,
   kCRFDecoding,
   kEmbSeqPool,
+  kEmbSeqPoolBF16,
   kGRUH1,
   kGRUHtPart1,
   kGRUHtPart2,
@@ -238,6 +239,13 @@ struct EmbSeqPoolTuple {
                             const emb_seq_pool_attr_t*);
 };
 
+// T is bfloat16, the embeddings are pooled in float and rounded to nearest
+// even once
+template <typename T>
+struct EmbSeqPoolBF16Tuple : public EmbSeqPoolTuple<T> {
+  static constexpr KernelType kernel_type = kEmbSeqPoolBF16;
+};
+
 typedef struct sgd_attr_s {
   int64_t param_height, param_width;
   int64_t grad_height, grad_width;
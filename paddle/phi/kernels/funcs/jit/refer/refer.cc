@@ -56,3 +56,6 @@ REGISTER_REFER_KERNEL(Sgd);
 REGISTER_REFER_KERNEL(VBroadcast);
 
 #undef REGISTER_REFER_KERNEL
+
+REGISTER_JITKERNEL_REFER(kEmbSeqPoolBF16,
+                         refer::EmbSeqPoolBF16Kernel<phi::dtype::bfloat16>);
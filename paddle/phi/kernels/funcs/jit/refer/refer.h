@@ -14,9 +14,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "paddle/phi/core/enforce.h"
 #include "paddle/phi/kernels/funcs/jit/helper.h"
@@ -451,6 +454,62 @@ void EmbSeqPool(const T* table,
   }
 }
 
+// The bfloat16 nearest to val, ties to even as vcvtneps2bf16.
+inline phi::dtype::bfloat16 RoundToBF16(float val) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &val, sizeof(bits));
+  phi::dtype::bfloat16 res;
+  if (std::isnan(val)) {
+    // quiet
+    res.x = static_cast<uint16_t>((bits >> 16) | 0x40);
+  } else {
+    bits += 0x7fff + ((bits >> 16) & 1);
+    res.x = static_cast<uint16_t>(bits >> 16);
+  }
+  return res;
+}
+
+// The sum pool of a bfloat16 table in float, each output rounded once.
+template <typename T>
+void EmbSeqPoolBF16(const T* table,
+                    const int64_t* idx,
+                    T* out,
+                    const emb_seq_pool_attr_t* attr) {
+  PADDLE_ENFORCE_EQ(
+      attr->table_width * attr->index_width,
+      attr->out_width,
+      phi::errors::InvalidArgument(
+          "The attribute table_width * index_width of EmbSeqPoolBF16 should "
+          "be equal to out_width. But table_width * index_width is %d and "
+          "out_width is %d.",
+          attr->table_width * attr->index_width,
+          attr->out_width));
+
+  std::vector<float> sum(attr->table_width);
+  for (int64_t w = 0; w < attr->index_width; ++w) {
+    std::fill(sum.begin(), sum.end(), 0.f);
+    for (int64_t h = 0; h < attr->index_height; ++h) {
+      int64_t i = h * attr->index_width + w;
+      PADDLE_ENFORCE_EQ(
+          idx[i] >= 0 && idx[i] < attr->table_height,
+          true,
+          phi::errors::InvalidArgument(
+              "The idx should be in [0, table_height %d) of EmbSeqPoolBF16. "
+              "But %dth of idx is %d.",
+              attr->table_height,
+              i,
+              idx[i]));
+      const T* row = table + idx[i] * attr->table_width;
+      for (int64_t j = 0; j < attr->table_width; ++j) {
+        sum[j] += static_cast<float>(row[j]);
+      }
+    }
+    for (int64_t j = 0; j < attr->table_width; ++j) {
+      out[w * attr->table_width + j] = RoundToBF16(sum[j]);
+    }
+  }
+}
+
 // SGD algorithm:
 // lr is pointor of learning rate scalar
 // param is an input matrix with (param_h, param_w)
@@ -603,6 +662,7 @@ DECLARE_REFER_KERNEL(LayerNorm);
 DECLARE_REFER_KERNEL(SeqPool);
 DECLARE_REFER_KERNEL(MatMul);
 DECLARE_REFER_KERNEL(EmbSeqPool);
+DECLARE_REFER_KERNEL(EmbSeqPoolBF16);
 DECLARE_REFER_KERNEL(Adam);
 DECLARE_REFER_KERNEL(AdamW);
 DECLARE_REFER_KERNEL(Sgd);
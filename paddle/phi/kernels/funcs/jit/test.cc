@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include <array>
+#include <cmath>
 #include <iostream>
 #include <random>
 
@@ -1472,3 +1473,56 @@ TEST_CPU_KERNEL(Adam);
 TEST_CPU_KERNEL(AdamW);
 TEST_CPU_KERNEL(Sgd);
 TEST_CPU_KERNEL(VBroadcast);
+
+TEST(JITKernel, EmbSeqPoolBF16) {
+  using T = phi::dtype::bfloat16;
+  using KernelTuple = jit::EmbSeqPoolBF16Tuple<T>;
+  int64_t tbl_h = 1000;
+  for (int tbl_w : {8, 16, 64, 72, 100}) {
+    std::vector<float> table_fp32(tbl_h * tbl_w);
+    RandomVec<float>(tbl_h * tbl_w, table_fp32.data());
+    std::vector<T> table(table_fp32.size());
+    for (size_t i = 0; i < table.size(); ++i) {
+      table[i] = static_cast<T>(table_fp32[i]);
+    }
+    for (int idx_w : {1, 2, 10}) {
+      for (int idx_h : {1, 2, 9, 13}) {
+        std::vector<int64_t> idx(idx_h * idx_w);
+        RandomVec<int64_t>(idx_h * idx_w, idx.data(), 0, tbl_h - 1);
+        int64_t out_w = tbl_w * idx_w;
+        jit::emb_seq_pool_attr_t attr(
+            tbl_h, tbl_w, idx_h, idx_w, out_w, jit::SeqPoolType::kSum);
+
+        // the refer rounds the float sum once
+        std::vector<T> oref(out_w);
+        auto ref = jit::GetReferFunc<KernelTuple>();
+        EXPECT_TRUE(ref != nullptr);
+        ref(table.data(), idx.data(), oref.data(), &attr);
+        for (int w = 0; w < idx_w; ++w) {
+          for (int j = 0; j < tbl_w; ++j) {
+            float sum = 0.f;
+            for (int h = 0; h < idx_h; ++h) {
+              sum += static_cast<float>(
+                  table[idx[h * idx_w + w] * tbl_w + j]);
+            }
+            EXPECT_NEAR(static_cast<float>(oref[w * tbl_w + j]),
+                        sum,
+                        std::abs(sum) / 256 + 1e-6);
+          }
+        }
+
+        // and the others the same sum
+        auto funcs =
+            jit::GetAllCandidateFuncsWithTypes<KernelTuple, CPUPlace>(attr);
+        for (auto const& f : funcs) {
+          VLOG(10) << "Test Kernel " << f.first;
+          std::vector<T> out(out_w);
+          f.second(table.data(), idx.data(), out.data(), &attr);
+          for (int64_t i = 0; i < out_w; ++i) {
+            EXPECT_EQ(out[i].x, oref[i].x) << " at index : " << i;
+          }
+        }
+      }
+    }
+  }
+}
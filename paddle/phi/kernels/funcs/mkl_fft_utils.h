@@ -14,10 +14,16 @@
 
 #pragma once
 #include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <unordered_map>
+#include <utility>
 #include "paddle/phi/backends/dynload/mklrt.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/kernels/funcs/fft.h"
+#include "paddle/phi/kernels/funcs/fft_key.h"
 
 namespace phi {
 namespace funcs {
@@ -167,6 +173,108 @@ static DftiDescriptor plan_mkl_fft(const DataType in_dtype,
   return descriptor;
 }
 
+// The committed descriptors are cached like the cuFFT plans, the same shapes
+// are transformed again and again by signal processing models.
+constexpr size_t kMKLFFTCacheSize = 64;
+
+struct MKLFFTConfigKey {
+  int signal_ndim_;
+  int64_t sizes_[kMaxDataNdim];
+  int64_t in_strides_[kMaxDataNdim];
+  int64_t out_strides_[kMaxDataNdim];
+  DataType in_dtype_;
+  DataType out_dtype_;
+  FFTNormMode normalization_;
+  bool forward_;
+
+  MKLFFTConfigKey() = default;
+
+  MKLFFTConfigKey(const DataType in_dtype,
+                  const DataType out_dtype,
+                  const phi::DDim& in_strides,
+                  const phi::DDim& out_strides,
+                  const std::vector<int64_t>& signal_sizes,
+                  FFTNormMode normalization,
+                  bool forward) {
+    // Padding bits must be zeroed for hashing
+    memset(this, 0, sizeof(*this));
+    signal_ndim_ = signal_sizes.size() - 1;
+    std::copy(signal_sizes.cbegin(), signal_sizes.cend(), sizes_);
+    for (int i = 0; i <= signal_ndim_; i++) {
+      in_strides_[i] = in_strides[i];
+      out_strides_[i] = out_strides[i];
+    }
+    in_dtype_ = in_dtype;
+    out_dtype_ = out_dtype;
+    normalization_ = normalization;
+    forward_ = forward;
+  }
+};
+
+// Return the committed descriptor of the transform, out of a LRU cache shared
+// by the threads. A descriptor evicted while in use lives until it is done.
+static std::shared_ptr<DftiDescriptor> get_mkl_fft_descriptor(
+    const DataType in_dtype,
+    const DataType out_dtype,
+    const phi::DDim& in_strides,
+    const phi::DDim& out_strides,
+    const std::vector<int64_t>& signal_sizes,
+    FFTNormMode normalization,
+    bool forward) {
+  if (signal_sizes.size() > static_cast<size_t>(kMaxDataNdim)) {
+    return std::make_shared<DftiDescriptor>(plan_mkl_fft(in_dtype,
+                                                         out_dtype,
+                                                         in_strides,
+                                                         out_strides,
+                                                         signal_sizes,
+                                                         normalization,
+                                                         forward));
+  }
+  using kv_t = std::pair<MKLFFTConfigKey, std::shared_ptr<DftiDescriptor>>;
+  static std::list<kv_t> usage_list;
+  static std::unordered_map<MKLFFTConfigKey,
+                            std::list<kv_t>::iterator,
+                            KeyHash<MKLFFTConfigKey>,
+                            KeyEqual<MKLFFTConfigKey>>
+      cache_map;
+  static std::mutex mutex;
+
+  MKLFFTConfigKey key(in_dtype,
+                      out_dtype,
+                      in_strides,
+                      out_strides,
+                      signal_sizes,
+                      normalization,
+                      forward);
+  {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = cache_map.find(key);
+    if (it != cache_map.end()) {
+      usage_list.splice(usage_list.begin(), usage_list, it->second);
+      return it->second->second;
+    }
+  }
+
+  // commit out of the lock, it is the slow part
+  auto descriptor = std::make_shared<DftiDescriptor>(plan_mkl_fft(in_dtype,
+                                                                  out_dtype,
+                                                                  in_strides,
+                                                                  out_strides,
+                                                                  signal_sizes,
+                                                                  normalization,
+                                                                  forward));
+  std::lock_guard<std::mutex> guard(mutex);
+  if (cache_map.count(key) == 0) {
+    if (usage_list.size() >= kMKLFFTCacheSize) {
+      cache_map.erase(usage_list.back().first);
+      usage_list.pop_back();
+    }
+    usage_list.emplace_front(key, descriptor);
+    cache_map.emplace(key, usage_list.begin());
+  }
+  return descriptor;
+}
+
 }  // namespace detail
 }  // namespace funcs
 }  // namespace phi
@@ -0,0 +1,219 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/nan_inf_accumulator.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+
+namespace phi {
+namespace funcs {
+
+namespace {
+
+struct NanInfSlot {
+  unsigned long long num_nan;   // NOLINT
+  unsigned long long num_inf;   // NOLINT
+  unsigned long long num_zero;  // NOLINT
+  // the bits of a non-negative float, which order as the floats do
+  unsigned int max_abs;
+  unsigned int padding;
+};
+
+constexpr size_t kInitialSlots = 64;
+
+// Each warp reduces the counts of its elements and adds them into the slot,
+// so the kernel costs one read of the tensor and a few atomics per warp.
+template <typename T>
+__global__ void AccumulateNanInfKernel(const T* value,
+                                       int64_t numel,
+                                       NanInfSlot* slot) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  unsigned long long num_nan = 0;   // NOLINT
+  unsigned long long num_inf = 0;   // NOLINT
+  unsigned long long num_zero = 0;  // NOLINT
+  float max_abs = 0.f;
+  int64_t stride = static_cast<int64_t>(blockDim.x) * gridDim.x;
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       i < numel;
+       i += stride) {
+    MT v = static_cast<MT>(value[i]);
+    if (isnan(v)) {
+      ++num_nan;
+    } else if (isinf(v)) {
+      ++num_inf;
+    } else {
+      if (v == static_cast<MT>(0)) ++num_zero;
+      max_abs = fmaxf(max_abs, static_cast<float>(v < 0 ? -v : v));
+    }
+  }
+  num_nan = WarpReduceSum(num_nan, FINAL_MASK);
+  num_inf = WarpReduceSum(num_inf, FINAL_MASK);
+  num_zero = WarpReduceSum(num_zero, FINAL_MASK);
+  max_abs = WarpReduceMax(max_abs, FINAL_MASK);
+  if ((threadIdx.x & WARP_SIZE_WIDTH_MASK) == 0) {
+    if (num_nan > 0) atomicAdd(&slot->num_nan, num_nan);
+    if (num_inf > 0) atomicAdd(&slot->num_inf, num_inf);
+    if (num_zero > 0) atomicAdd(&slot->num_zero, num_zero);
+    atomicMax(&slot->max_abs, __float_as_uint(max_abs));
+  }
+}
+
+template <typename T>
+void LaunchAccumulateNanInf(const GPUContext& ctx,
+                            const DenseTensor& tensor,
+                            NanInfSlot* slot) {
+  // a multiple of the warp size, all the lanes join the warp reduce
+  constexpr int kThreads = 512;
+  int64_t numel = tensor.numel();
+  int blocks = static_cast<int>(std::min<int64_t>(
+      (numel + kThreads - 1) / kThreads, ctx.GetSMCount() * 4));
+  AccumulateNanInfKernel<T>
+      <<<blocks, kThreads, 0, ctx.stream()>>>(tensor.data<T>(), numel, slot);
+}
+
+}  // namespace
+
+NanInfAccumulator& NanInfAccumulator::Instance() {
+  static NanInfAccumulator accumulator;
+  return accumulator;
+}
+
+int NanInfAccumulator::GetSlot(DeviceSlots* device,
+                               const GPUContext& ctx,
+                               const std::string& op_type,
+                               const std::string& var_name) {
+  auto key = std::make_pair(op_type, var_name);
+  auto it = device->slot_ids.find(key);
+  if (it != device->slot_ids.end()) {
+    return it->second;
+  }
+  int slot = static_cast<int>(device->keys.size());
+  if (device->keys.size() == device->capacity) {
+    // grow on the stream, the old slots keep counting until they are copied
+    size_t capacity = std::max(kInitialSlots, device->capacity * 2);
+    auto buffer = phi::memory_utils::Alloc(
+        ctx.GetPlace(),
+        capacity * sizeof(NanInfSlot),
+        phi::Stream(reinterpret_cast<phi::StreamId>(ctx.stream())));
+    phi::backends::gpu::GpuMemsetAsync(
+        buffer->ptr(), 0, capacity * sizeof(NanInfSlot), ctx.stream());
+    if (device->buffer != nullptr) {
+      phi::backends::gpu::GpuMemcpyAsync(
+          buffer->ptr(),
+          device->buffer->ptr(),
+          device->capacity * sizeof(NanInfSlot),
+          gpuMemcpyDeviceToDevice,
+          ctx.stream());
+      device->retired.emplace_back(std::move(device->buffer));
+    }
+    device->buffer = std::move(buffer);
+    device->capacity = capacity;
+    VLOG(4) << "Grow the nan/inf slots of " << ctx.GetPlace() << " to "
+            << capacity;
+  }
+  device->slot_ids.emplace(key, slot);
+  device->keys.emplace_back(std::move(key));
+  device->num_checks.push_back(0);
+  device->numel.push_back(0);
+  return slot;
+}
+
+bool NanInfAccumulator::Add(const GPUContext& ctx,
+                            const DenseTensor& tensor,
+                            const std::string& op_type,
+                            const std::string& var_name) {
+  auto dtype = tensor.dtype();
+  if (dtype != DataType::FLOAT32 && dtype != DataType::FLOAT64 &&
+      dtype != DataType::FLOAT16 && dtype != DataType::BFLOAT16) {
+    return false;
+  }
+  NanInfSlot* slot = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& device = devices_[ctx.GetPlace().GetDeviceId()];
+    int slot_id = GetSlot(&device, ctx, op_type, var_name);
+    device.ctx = &ctx;
+    device.num_checks[slot_id] += 1;
+    device.numel[slot_id] += tensor.numel();
+    slot = reinterpret_cast<NanInfSlot*>(device.buffer->ptr()) + slot_id;
+  }
+  if (tensor.numel() == 0) {
+    return true;
+  }
+  switch (dtype) {
+    case DataType::FLOAT32:
+      LaunchAccumulateNanInf<float>(ctx, tensor, slot);
+      break;
+    case DataType::FLOAT64:
+      LaunchAccumulateNanInf<double>(ctx, tensor, slot);
+      break;
+    case DataType::FLOAT16:
+      LaunchAccumulateNanInf<phi::dtype::float16>(ctx, tensor, slot);
+      break;
+    default:
+      LaunchAccumulateNanInf<phi::dtype::bfloat16>(ctx, tensor, slot);
+      break;
+  }
+  return true;
+}
+
+std::vector<NanInfStats> NanInfAccumulator::Collect() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::vector<NanInfStats> result;
+  for (auto& item : devices_) {
+    auto& device = item.second;
+    // nothing was added on the device since the last Collect
+    if (device.ctx == nullptr) continue;
+    size_t size = device.keys.size() * sizeof(NanInfSlot);
+    std::vector<NanInfSlot> h_slots(device.keys.size());
+    phi::backends::gpu::GpuMemcpyAsync(h_slots.data(),
+                                       device.buffer->ptr(),
+                                       size,
+                                       gpuMemcpyDeviceToHost,
+                                       device.ctx->stream());
+    phi::backends::gpu::GpuMemsetAsync(
+        device.buffer->ptr(), 0, size, device.ctx->stream());
+    device.ctx->Wait();
+    device.ctx = nullptr;
+    device.retired.clear();
+    for (size_t i = 0; i < h_slots.size(); ++i) {
+      if (device.num_checks[i] == 0) continue;
+      NanInfStats stats;
+      stats.op_type = device.keys[i].first;
+      stats.var_name = device.keys[i].second;
+      stats.num_checks = device.num_checks[i];
+      stats.numel = device.numel[i];
+      stats.num_nan = static_cast<int64_t>(h_slots[i].num_nan);
+      stats.num_inf = static_cast<int64_t>(h_slots[i].num_inf);
+      stats.num_zero = static_cast<int64_t>(h_slots[i].num_zero);
+      std::memcpy(&stats.max_abs, &h_slots[i].max_abs, sizeof(float));
+      result.emplace_back(std::move(stats));
+      device.num_checks[i] = 0;
+      device.numel[i] = 0;
+    }
+  }
+  return result;
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,94 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+namespace funcs {
+
+// The statistics of the outputs checked for one (op, var) pair since the
+// last Collect.
+struct NanInfStats {
+  std::string op_type;
+  std::string var_name;
+  int64_t num_checks = 0;
+  int64_t numel = 0;
+  int64_t num_nan = 0;
+  int64_t num_inf = 0;
+  int64_t num_zero = 0;
+  // the max abs of the finite values
+  float max_abs = 0.f;
+};
+
+/**
+ * NanInfAccumulator defers the nan/inf checks of the GPU tensors.
+ *
+ * Each (op, var) pair gets a slot of a per device buffer when it is first
+ * added. Add only launches one kernel, which adds the counts of the tensor
+ * into its slot with a few atomics per warp: nothing is copied back and the
+ * stream is never synchronized. Collect copies the slots of each device back
+ * once, resets them and returns the stats of the slots added since the last
+ * Collect, in the order the slots were registered, so the op holding NAN/INF
+ * is recovered from the slot index. The tensors of a device are expected to
+ * be added on one stream, as the executors do with the context of the pool.
+ */
+class NanInfAccumulator {
+ public:
+  static NanInfAccumulator& Instance();
+
+  // Return false if the dtype is not supported (e.g. complex), the caller
+  // checks the tensor at once instead.
+  bool Add(const GPUContext& ctx,
+           const DenseTensor& tensor,
+           const std::string& op_type,
+           const std::string& var_name);
+
+  std::vector<NanInfStats> Collect();
+
+ private:
+  struct DeviceSlots {
+    const GPUContext* ctx{nullptr};
+    Allocator::AllocationPtr buffer;
+    // the buffers replaced by a larger one, released by the next Collect
+    std::vector<Allocator::AllocationPtr> retired;
+    size_t capacity{0};
+    std::map<std::pair<std::string, std::string>, int> slot_ids;
+    std::vector<std::pair<std::string, std::string>> keys;
+    std::vector<int64_t> num_checks;
+    std::vector<int64_t> numel;
+  };
+
+  int GetSlot(DeviceSlots* device,
+              const GPUContext& ctx,
+              const std::string& op_type,
+              const std::string& var_name);
+
+  std::mutex mutex_;
+  std::unordered_map<int, DeviceSlots> devices_;
+};
+
+}  // namespace funcs
+}  // namespace phi
+#endif
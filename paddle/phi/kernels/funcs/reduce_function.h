@@ -251,6 +251,10 @@ struct ReduceConfig {
   bool reduce_last_dim = false;
   bool vectorize_input = false;
   MPType* tmp_data;
+  // When not null, the blocks that reduce the same outputs count themselves
+  // here, and the last one of them finishes the reduction of the partial
+  // results in tmp_data instead of a second kernel.
+  int* semaphores = nullptr;
   dim3 block;
   dim3 grid;
 
@@ -286,11 +290,19 @@ struct ReduceConfig {
   // If should_reduce_again, we need malloc temp space for temp data
   void SetOutputData(Ty* y_data,
                      const KPDevice& dev_ctx,
-                     phi::DenseTensor* tmp) {
+                     phi::DenseTensor* tmp,
+                     phi::DenseTensor* semaphore) {
     if (should_reduce_again) {
       tmp->Resize(common::make_ddim(
           {static_cast<int64_t>(left_num * grid.z * grid.y)}));
       tmp_data = dev_ctx.Alloc<MPType>(tmp);
+#ifndef PADDLE_WITH_XPU_KP
+      int64_t num_semaphores = static_cast<int64_t>(grid.x) * grid.z;
+      semaphore->Resize(common::make_ddim({num_semaphores}));
+      semaphores = dev_ctx.Alloc<int>(semaphore);
+      phi::backends::gpu::GpuMemsetAsync(
+          semaphores, 0, num_semaphores * sizeof(int), dev_ctx.stream());
+#endif
     }
   }
 
@@ -583,7 +595,8 @@ __global__ void ReduceAnyKernel(const Tx* x,
                                 const kps::DimConfig dim,
                                 bool is_mean,
                                 MPType* tmp_data,
-                                bool need_store_tmp = false) {
+                                bool need_store_tmp = false,
+                                int* semaphores = nullptr) {
   int input_idx, left_idx, stride;
   int block_size = 0;
   bool need_store = true;
@@ -683,10 +696,10 @@ __global__ void ReduceAnyKernel(const Tx* x,
 
     kps::Reduce<MPType, 1, 1, ReduceOp, kps::details::kGlobalMode>(
         &reduce_var, &reduce_var, reducer, reduce_last_dim);
-    if (is_mean) {
-      reduce_var = reduce_var / static_cast<MPType>(reduce_num);
-    }
     if (!need_store_tmp) {
+      if (is_mean) {
+        reduce_var = reduce_var / static_cast<MPType>(reduce_num);
+      }
       Ty result = static_cast<Ty>(reduce_var);
       kps::details::WriteData<Ty>(
           y + store_offset + i, &result, static_cast<int>(need_store));
@@ -696,6 +709,43 @@ __global__ void ReduceAnyKernel(const Tx* x,
                                       static_cast<int>(need_store));
     }
   }
+
+#ifndef PADDLE_WITH_XPU_KP
+  // 2. the last block along grid.y reduces the partial results of all the
+  // blocks along grid.y, which hold the same outputs, as a second kernel
+  // would do, but without launching it.
+  if (need_store_tmp && semaphores != nullptr) {
+    __shared__ bool is_last_block;
+    __threadfence();
+    __syncthreads();
+    if (THREAD_ID_X == 0 && THREAD_ID_Y == 0) {
+      int finished = atomicAdd(semaphores + BLOCK_ID_X, 1);
+      is_last_block = finished == GRID_NUM_Y - 1;
+    }
+    __syncthreads();
+    if (!is_last_block) {
+      return;
+    }
+    for (int i = 0; i < loop_left; i += stride_left) {
+      MPType reduce_var = init;
+      for (int j = tid; j < GRID_NUM_Y; j += block_size) {
+        reduce_var = reducer(reduce_var, tmp_data[j * left_num + left_idx + i]);
+      }
+      kps::Reduce<MPType, 1, 1, ReduceOp, kps::details::kGlobalMode>(
+          &reduce_var, &reduce_var, reducer, reduce_last_dim);
+      if (is_mean) {
+        reduce_var = reduce_var / static_cast<MPType>(reduce_num);
+      }
+      Ty result = static_cast<Ty>(reduce_var);
+      kps::details::WriteData<Ty>(
+          y + left_idx + i, &result, static_cast<int>(need_store));
+    }
+    // Reset the semaphore, in case the buffer is reused.
+    if (THREAD_ID_X == 0 && THREAD_ID_Y == 0) {
+      semaphores[BLOCK_ID_X] = 0;
+    }
+  }
+#endif
 }
 
 template <typename Tx,
@@ -715,7 +765,8 @@ __global__ void ReduceHigherDimKernel(const Tx* x,
                                       int mean_div,
                                       bool is_mean,
                                       MPType* tmp_data,
-                                      bool need_store_tmp = false) {
+                                      bool need_store_tmp = false,
+                                      int* semaphores = nullptr) {
   // when reduce_dim.size() == 1 and reduce_dim[0] != x_dim.size() - 1, this
   // function will be used
   auto block = ReduceIndexMapping<false>(dim);
@@ -744,7 +795,7 @@ __global__ void ReduceHigherDimKernel(const Tx* x,
       kps::Reduce<MPType, 1, 1, ReduceOp, kps::details::ReduceMode::kLocalMode>(
           &reduce_var, &reduce_compute, reducer, false);
     }
-    if (is_mean) {
+    if (is_mean && !need_store_tmp) {
       reduce_var = reduce_var / static_cast<MPType>(mean_div);
     }
     if (!need_store_tmp) {
@@ -773,7 +824,7 @@ __global__ void ReduceHigherDimKernel(const Tx* x,
           &reduce_var, &reduce_compute, reducer, false);
     }
 
-    if (is_mean) {
+    if (is_mean && !need_store_tmp) {
       reduce_var = reduce_var / static_cast<MPType>(mean_div);
     }
     if (!need_store_tmp) {
@@ -785,6 +836,41 @@ __global__ void ReduceHigherDimKernel(const Tx* x,
           tmp_data + store_offset + idx, &reduce_var, dim.rem_x);
     }
   }
+
+#ifndef PADDLE_WITH_XPU_KP
+  // The last block along grid.y reduces the partial results of the columns
+  // of this block instead of a second kernel.
+  if (need_store_tmp && semaphores != nullptr) {
+    __shared__ bool is_last_block;
+    __threadfence();
+    __syncthreads();
+    int semaphore_idx = BLOCK_ID_Z * GRID_NUM_X + BLOCK_ID_X;
+    if (THREAD_ID_X == 0) {
+      int finished = atomicAdd(semaphores + semaphore_idx, 1);
+      is_last_block = finished == GRID_NUM_Y - 1;
+    }
+    __syncthreads();
+    if (!is_last_block) {
+      return;
+    }
+    const MPType* partials = tmp_data + idz * GRID_NUM_Y;
+    for (int i = block.BlockIdX() * block.BlockDimX() + THREAD_ID_X;
+         i < left_num;
+         i += stride) {
+      MPType reduce_var = init;
+      for (int j = 0; j < GRID_NUM_Y; ++j) {
+        reduce_var = reducer(reduce_var, partials[j * left_num + i]);
+      }
+      if (is_mean) {
+        reduce_var = reduce_var / static_cast<MPType>(mean_div);
+      }
+      y[idz + i] = static_cast<Ty>(reduce_var);
+    }
+    if (THREAD_ID_X == 0) {
+      semaphores[semaphore_idx] = 0;
+    }
+  }
+#endif
 }
 
 template <typename Tx,
@@ -835,9 +921,10 @@ static void LaunchReduceKernel(const Tx* x_data,
             reduce_index_calculator,
             left_index_calculator,
             dim,
-            is_mean && (!config.should_reduce_again),
+            is_mean,
             config.tmp_data,
-            config.should_reduce_again);
+            config.should_reduce_again,
+            config.semaphores);
   } else {
     int reduce_rank = config.reduce_strides.size();
     int left_rank = config.left_strides.size();
@@ -876,12 +963,13 @@ static void LaunchReduceKernel(const Tx* x_data,
             reduce_index_calculator,
             left_index_calculator,
             dim,
-            is_mean && (!config.should_reduce_again),
+            is_mean,
             config.tmp_data,
-            config.should_reduce_again);
+            config.should_reduce_again,
+            config.semaphores);
   }
 
-  if (config.should_reduce_again) {
+  if (config.should_reduce_again && config.semaphores == nullptr) {
     dim3 block;
     dim3 grid;
     if (config.reduce_last_dim) {
@@ -1080,6 +1168,7 @@ void ReduceKernel(const KPDevice& dev_ctx,
 
   phi::DDim tmp_ddim;
   phi::DenseTensor tmp;
+  phi::DenseTensor semaphore;
 
   auto x_data = x.data<Tx>();
   auto y_data = y->data<Ty>();
@@ -1091,7 +1180,7 @@ void ReduceKernel(const KPDevice& dev_ctx,
     return;
   }
 
-  config.SetOutputData(y_data, dev_ctx, &tmp);
+  config.SetOutputData(y_data, dev_ctx, &tmp, &semaphore);
   constexpr bool kIsTxFP16 = std::is_same<Tx, phi::dtype::float16>::value;
   constexpr bool kIsTxBF16 = std::is_same<Tx, phi::dtype::bfloat16>::value;
   bool use_cub_reduce = config.reduce_num == numel && !kIsTxFP16 && !kIsTxBF16;
@@ -1142,11 +1231,12 @@ void ReduceKernel(const KPDevice& dev_ctx,
             config.blocking_size,
             dim,
             config.reduce_num,
-            IsMean && (!config.should_reduce_again),
+            IsMean,
             config.tmp_data,
-            config.should_reduce_again);
+            config.should_reduce_again,
+            config.semaphores);
 
-    if (config.should_reduce_again) {
+    if (config.should_reduce_again && config.semaphores == nullptr) {
       dim3 block = dim3(config.block.x, 1, 1);
       dim3 grid = dim3(config.grid.x, 1, config.grid.z);
       kps::DimConfig dim2 =
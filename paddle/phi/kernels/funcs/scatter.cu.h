@@ -20,6 +20,7 @@ limitations under the License. */
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/kernels/funcs/deterministic_scatter.cu.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace phi {
@@ -114,6 +115,34 @@ __global__ void ScatterNdCUDAKernel(const T* update,
   }
 }
 
+// The row of the output each slice of update is added to, as the index of
+// the first end_size dims of the output.
+template <typename IndexT = int>
+__global__ void ScatterNdRowsCUDAKernel(const IndexT* indices,
+                                        int64_t* rows,
+                                        const Dim<DDim::kMaxRank> output_dims,
+                                        size_t remain_size,
+                                        size_t end_size) {
+  CUDA_KERNEL_LOOP_TYPE(i, remain_size, int64_t) {
+    int64_t row = 0;
+    for (int64_t j = 0; j < end_size; ++j) {
+      IndexT index_value = indices[i * end_size + j];
+
+      PADDLE_ENFORCE(
+          index_value >= 0 && index_value < output_dims[j],
+          "The index is out of bounds, "
+          "please check whether the dimensions of index and "
+          "input meet the requirements. It should "
+          "be less than [%d] and greater or equal to 0, but received [%d]",
+          output_dims[j],
+          index_value);
+
+      row = row * output_dims[j] + index_value;
+    }
+    rows[i] = row;
+  }
+}
+
 /**
  * A thin wrapper on gpu tensor
  * Return a new updated tensor from source tensor, scatter-assigned according to
@@ -164,6 +193,22 @@ void GPUScatterAssign(const phi::GPUContext& ctx,
 
   const size_t& slice_bytes = slice_size * sizeof(T);
 
+  // reduce the duplicate indices by sorting them, without atomics
+  if (UseDeterministicScatter(index_size, output_dims[0])) {
+    DeterministicScatter<T, IndexT>(ctx,
+                                    p_index,
+                                    p_src,
+                                    1,
+                                    index_size,
+                                    output_dims[0],
+                                    slice_size,
+                                    overwrite
+                                        ? DeterministicScatterMode::kAssign
+                                        : DeterministicScatterMode::kSum,
+                                    p_output);
+    return;
+  }
+
   // set block and grid num
   int block = 512;
   int64_t n = slice_size * index_size;
@@ -243,6 +288,33 @@ void GPUScatterNdAdd(const phi::GPUContext& ctx,
     g_output_dims[i] = output_dims[i];
   }
 
+  int64_t num_rows = 1;
+  for (int64_t i = 0; i < end_size; ++i) {
+    num_rows *= output_dims[i];
+  }
+  // reduce the duplicate indices by sorting them, without atomics
+  if (remain_numel > 0 && UseDeterministicScatter(remain_numel, num_rows)) {
+    DenseTensor rows;
+    rows.Resize(common::make_ddim({remain_numel}));
+    auto* rows_data = ctx.template Alloc<int64_t>(&rows);
+    auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, remain_numel);
+    ScatterNdRowsCUDAKernel<IndexT><<<config.block_per_grid.x,
+                                      config.thread_per_block.x,
+                                      0,
+                                      ctx.stream()>>>(
+        p_index, rows_data, g_output_dims, remain_numel, end_size);
+    DeterministicScatter<T, int64_t>(ctx,
+                                     rows_data,
+                                     p_update,
+                                     1,
+                                     remain_numel,
+                                     num_rows,
+                                     slice_size,
+                                     DeterministicScatterMode::kAccumulate,
+                                     p_output);
+    return;
+  }
+
   int block = 512;
   int64_t n = slice_size * remain_numel;
   dim3 grid = dim3((n + block - 1) / block);
@@ -473,6 +473,10 @@ add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
   }
 }
 
+// The merging is split over the OpenMP threads when the output has at least
+// so many elements.
+constexpr int64_t kMergeAddParallelThreshold = 65536;
+
 template <typename T, typename DeviceContext>
 typename std::enable_if<!std::is_same<T, phi::dtype::bfloat16>::value>::type
 add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
@@ -482,18 +486,41 @@ add_sparse_inputs(const std::vector<const phi::SelectedRows*>& inputs,
                   T* out_data) {
   VLOG(4) << "[CPU] add_sparse_inputs <" << typeid(T).name();
   auto blas = phi::funcs::GetBlas<DeviceContext, T>(context);
+  // group the input rows by their output row, in the order of the inputs,
+  // so each output row is summed by one thread in the sequential order
+  size_t out_rows = rows_to_id.size();
+  std::vector<size_t> offsets(out_rows + 1, 0);
+  for (auto* input : inputs) {
+    for (auto row : input->rows()) {
+      ++offsets[rows_to_id.at(row) + 1];
+    }
+  }
+  for (size_t i = 0; i < out_rows; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  std::vector<const T*> sources(offsets[out_rows]);
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
   for (auto* input : inputs) {
     if (input->rows().empty()) {
       continue;
     }
     auto* input_data = input->value().data<T>();
     auto& input_rows = input->rows();
-
     for (size_t i = 0; i < input_rows.size(); i++) {
       size_t out_i = rows_to_id.at(input_rows[i]);
+      sources[next[out_i]++] = &input_data[i * input_width];
+    }
+  }
+
+#ifdef PADDLE_WITH_MKLML
+  int64_t out_numel = static_cast<int64_t>(out_rows) * input_width;
+#pragma omp parallel for if (out_numel >= kMergeAddParallelThreshold)
+#endif
+  for (int64_t out_i = 0; out_i < static_cast<int64_t>(out_rows); ++out_i) {
+    for (size_t k = offsets[out_i]; k < offsets[out_i + 1]; ++k) {
       elementwise_add_to<T, DeviceContext>(&blas,
                                            static_cast<size_t>(input_width),
-                                           &input_data[i * input_width],
+                                           sources[k],
                                            &out_data[out_i * input_width]);
     }
   }
@@ -540,7 +567,8 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
+    // the merged rows are sorted and unique
+    std::vector<int64_t> merge_rows;
     size_t row_num = 0;
     for (auto* input : inputs) {
       if (input->rows().empty()) {
@@ -556,19 +584,22 @@ struct MergeAddImpl {
           input->height(),
           phi::errors::InvalidArgument("All inputs should have same height."));
       row_num += input->rows().size();
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
+      merge_rows.insert(
+          merge_rows.end(), input->rows().begin(), input->rows().end());
     }
+    std::sort(merge_rows.begin(), merge_rows.end());
+    merge_rows.erase(std::unique(merge_rows.begin(), merge_rows.end()),
+                     merge_rows.end());
 
     out.set_height(input_height);
     DenseTensor* out_tensor = out.mutable_value();
     out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merged_row_set.size()), input_width}));
+        {static_cast<int64_t>(merge_rows.size()), input_width}));
     auto* out_data = context.template Alloc<T>(out_tensor);
 
-    if (merged_row_set.size() == row_num && !sorted_result) {
+    if (merge_rows.size() == row_num && !sorted_result) {
       // no duplicated ids, just concat the result together
-      std::vector<int64_t> merge_rows;
-      merge_rows.reserve(row_num);
+      merge_rows.clear();
       // concat rows
       for (auto* in : inputs) {
         merge_rows.insert(
@@ -589,13 +620,6 @@ struct MergeAddImpl {
         copied_numel += static_cast<int64_t>(in_numel);
       }
     } else {
-      std::vector<int64_t> merge_rows(merged_row_set.begin(),
-                                      merged_row_set.end());
-
-      if (sorted_result) {
-        std::sort(merge_rows.begin(), merge_rows.end());
-      }
-
       out.set_rows(merge_rows);
 
       phi::funcs::SetConstant<DeviceContext, T> constant_functor;
@@ -738,7 +762,8 @@ struct MergeAdd<phi::XPUContext, T> {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
+    // the merged rows are sorted and unique
+    std::vector<int64_t> merge_rows;
     size_t row_num = 0;
     for (auto* input : inputs) {
       if (input->rows().size() == 0) {
@@ -14,10 +14,17 @@
 
 #pragma once
 
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "glog/logging.h"
 
 #include "paddle/common/ddim.h"
 #include "paddle/phi/backends/dynload/cusparse.h"
+#include "paddle/phi/backends/gpu/cuda/cuda_graph.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/common/float16.h"
 #include "paddle/phi/common/memory_utils.h"
@@ -26,6 +33,9 @@
 #include "paddle/phi/core/sparse_coo_tensor.h"
 #include "paddle/phi/core/sparse_csr_tensor.h"
 #include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/autotune/cache.h"
+#include "paddle/phi/kernels/autotune/gpu_timer.h"
+#include "paddle/phi/kernels/autotune/switch_autotune.h"
 #include "paddle/phi/kernels/cast_kernel.h"
 #include "paddle/phi/kernels/concat_kernel.h"
 #include "paddle/phi/kernels/empty_kernel.h"
@@ -222,51 +232,58 @@ class CuSparseSpMatDescriptor {
 
 /************* DENSE MATRIX DESCRIPTOR ************/
 template <typename T>
-class CuSparseDnMatDescriptor {
- public:
-  explicit CuSparseDnMatDescriptor(const phi::DenseTensor& x,
-                                   const phi::GPUContext& dev_ctx)
-      : dev_ctx_(dev_ctx) {
-    std::vector<int64_t> xdim_vec = common::vectorize(x.dims());
-    auto x_ndims = xdim_vec.size();
-    PADDLE_ENFORCE_GE(
-        x_ndims,
-        2,
-        phi::errors::InvalidArgument("the dim size of DenseTensor must be "
-                                     "greater than or equal to 2."));
-
-    int64_t M = xdim_vec[x_ndims - 2];
-    int64_t N = xdim_vec[x_ndims - 1];
-    int batch_size = 1;
-    for (int i = 0; i < x_ndims - 2; i++) {
-      batch_size *= xdim_vec[i];
-    }
+inline void CreateDnMatDescriptor(const phi::DenseTensor& x,
+                                  const phi::GPUContext& dev_ctx,
+                                  cusparseDnMatDescr_t* descriptor) {
+  std::vector<int64_t> xdim_vec = common::vectorize(x.dims());
+  auto x_ndims = xdim_vec.size();
+  PADDLE_ENFORCE_GE(
+      x_ndims,
+      2,
+      phi::errors::InvalidArgument("the dim size of DenseTensor must be "
+                                   "greater than or equal to 2."));
 
-    const T* x_data = x.data<T>();
-    cudaDataType_t gpu_type = GetGpuDataType<T>();
-    dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
-      phi::dynload::cusparseCreateDnMat(&descriptor_,
-                                        M,
-                                        N,
-                                        N,
-                                        const_cast<T*>(x_data),
-                                        gpu_type,
-                                        CUSPARSE_ORDER_ROW);
-    });
+  int64_t M = xdim_vec[x_ndims - 2];
+  int64_t N = xdim_vec[x_ndims - 1];
+  int batch_size = 1;
+  for (int i = 0; i < x_ndims - 2; i++) {
+    batch_size *= xdim_vec[i];
+  }
+
+  const T* x_data = x.data<T>();
+  cudaDataType_t gpu_type = GetGpuDataType<T>();
+  dev_ctx.CusparseCall([&](cusparseHandle_t handle) {
+    phi::dynload::cusparseCreateDnMat(descriptor,
+                                      M,
+                                      N,
+                                      N,
+                                      const_cast<T*>(x_data),
+                                      gpu_type,
+                                      CUSPARSE_ORDER_ROW);
+  });
 
-    PADDLE_ENFORCE_EQ(x.numel(), batch_size * M * N);
-    if (batch_size > 1) {
+  PADDLE_ENFORCE_EQ(x.numel(), batch_size * M * N);
+  if (batch_size > 1) {
 #if CUDA_VERSION >= 11080
-      dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
-        phi::dynload::cusparseDnMatSetStridedBatch(
-            descriptor_, batch_size, M * N);
-      });
+    dev_ctx.CusparseCall([&](cusparseHandle_t handle) {
+      phi::dynload::cusparseDnMatSetStridedBatch(
+          *descriptor, batch_size, M * N);
+    });
 #else
-      PADDLE_THROW(phi::errors::Unimplemented(
-          "Batch Sparse matmul use 'cusparseDnMatSetStridedBatch', which is "
-          "supported from CUDA 11.8"));
+    PADDLE_THROW(phi::errors::Unimplemented(
+        "Batch Sparse matmul use 'cusparseDnMatSetStridedBatch', which is "
+        "supported from CUDA 11.8"));
 #endif
-    }
+  }
+}
+
+template <typename T>
+class CuSparseDnMatDescriptor {
+ public:
+  explicit CuSparseDnMatDescriptor(const phi::DenseTensor& x,
+                                   const phi::GPUContext& dev_ctx)
+      : dev_ctx_(dev_ctx) {
+    CreateDnMatDescriptor<T>(x, dev_ctx_, &descriptor_);
     VLOG(6) << "Create cusparseDnMatDescr_t " << &descriptor_;
   }
 
@@ -322,6 +339,384 @@ class CuSparseDnVecDescriptor {
   cusparseDnVecDescr_t descriptor_;
 };
 
+/************* DESCRIPTOR AND WORKSPACE CACHE ************/
+// A cuSPARSE descriptor only holds the pointers, sizes and types of a
+// matrix, so it is cached by them: the role of the matrix in the call, the
+// device, the pointers of the indices of a sparse matrix, i.e. the identity
+// of its sparsity pattern, and the shape, nnz and types. The values are
+// bound again at each call, so the calls on one pattern, e.g. the adjacency
+// of a GNN layer, skip creating the descriptors and querying the workspace.
+// The caches are per thread, so a descriptor is bound to one call at a time.
+using CuSparseCacheKey = std::vector<int64_t>;
+
+inline int64_t PtrToKey(const void* ptr) {
+  return static_cast<int64_t>(reinterpret_cast<uintptr_t>(ptr));
+}
+
+template <typename Descriptor>
+class CuSparseDescriptorCache {
+ public:
+  using Destroy = std::function<void(Descriptor)>;
+
+  explicit CuSparseDescriptorCache(Destroy destroy)
+      : destroy_(std::move(destroy)) {}
+
+  ~CuSparseDescriptorCache() {
+    for (auto& item : descriptors_) {
+      destroy_(item.second.first);
+    }
+  }
+
+  // Returns the descriptor of key, which is created by create on a miss.
+  template <typename Create>
+  Descriptor Get(const CuSparseCacheKey& key, Create&& create) {
+    auto it = descriptors_.find(key);
+    if (it != descriptors_.end()) {
+      it->second.second = ++clock_;
+      return it->second.first;
+    }
+    if (descriptors_.size() >= kMaxDescriptors) {
+      EvictLeastRecentlyUsed();
+    }
+    Descriptor descriptor;
+    create(&descriptor);
+    descriptors_.emplace(key, std::make_pair(descriptor, ++clock_));
+    VLOG(6) << "Cache cuSPARSE descriptor " << descriptor << ", "
+            << descriptors_.size() << " cached";
+    return descriptor;
+  }
+
+ private:
+  static constexpr size_t kMaxDescriptors = 256;
+
+  void EvictLeastRecentlyUsed() {
+    auto oldest = descriptors_.begin();
+    for (auto it = descriptors_.begin(); it != descriptors_.end(); ++it) {
+      if (it->second.second < oldest->second.second) {
+        oldest = it;
+      }
+    }
+    destroy_(oldest->second.first);
+    descriptors_.erase(oldest);
+  }
+
+  Destroy destroy_;
+  // key -> (descriptor, last use)
+  std::unordered_map<CuSparseCacheKey, std::pair<Descriptor, uint64_t>>
+      descriptors_;
+  uint64_t clock_{0};
+};
+
+class CuSparseCache {
+ public:
+  static CuSparseCache& Instance() {
+    thread_local CuSparseCache cache;
+    return cache;
+  }
+
+  template <typename T, typename IntT>
+  cusparseSpMatDescr_t GetSpMat(const phi::SparseCsrTensor& x,
+                                const phi::GPUContext& dev_ctx,
+                                int64_t role,
+                                CuSparseCacheKey* key) {
+    *key = {role,
+            0,
+            dev_ctx.GetPlace().GetDeviceId(),
+            PtrToKey(x.non_zero_crows().data<IntT>()),
+            PtrToKey(x.non_zero_cols().data<IntT>()),
+            x.nnz(),
+            static_cast<int64_t>(GetCusparseIndexType<IntT>()),
+            static_cast<int64_t>(GetGpuDataType<T>())};
+    auto dims = common::vectorize(x.dims());
+    key->insert(key->end(), dims.begin(), dims.end());
+    auto descriptor =
+        sp_mats_.Get(*key, [&](cusparseSpMatDescr_t* descriptor) {
+          CreateCsrDescriptor<T, IntT>(x, dev_ctx, descriptor);
+        });
+    BindValues(descriptor, x.non_zero_elements().data<T>(), dev_ctx);
+    return descriptor;
+  }
+
+  template <typename T, typename IntT>
+  cusparseSpMatDescr_t GetSpMat(const phi::SparseCooTensor& x,
+                                const phi::GPUContext& dev_ctx,
+                                int64_t role,
+                                CuSparseCacheKey* key) {
+    *key = {role,
+            1,
+            dev_ctx.GetPlace().GetDeviceId(),
+            PtrToKey(x.non_zero_indices().data<IntT>()),
+            x.nnz(),
+            static_cast<int64_t>(GetCusparseIndexType<IntT>()),
+            static_cast<int64_t>(GetGpuDataType<T>())};
+    auto dims = common::vectorize(x.dims());
+    key->insert(key->end(), dims.begin(), dims.end());
+    auto descriptor =
+        sp_mats_.Get(*key, [&](cusparseSpMatDescr_t* descriptor) {
+          CreateCooDescriptor<T, IntT>(x, dev_ctx, descriptor);
+        });
+    BindValues(descriptor, x.non_zero_elements().data<T>(), dev_ctx);
+    return descriptor;
+  }
+
+  // The dense descriptors are keyed on the shape only, role tells apart the
+  // matrices of the same shape in a call.
+  template <typename T>
+  cusparseDnMatDescr_t GetDnMat(const phi::DenseTensor& x,
+                                const phi::GPUContext& dev_ctx,
+                                int64_t role,
+                                CuSparseCacheKey* key) {
+    *key = {role,
+            2,
+            dev_ctx.GetPlace().GetDeviceId(),
+            static_cast<int64_t>(GetGpuDataType<T>())};
+    auto dims = common::vectorize(x.dims());
+    key->insert(key->end(), dims.begin(), dims.end());
+    auto descriptor =
+        dn_mats_.Get(*key, [&](cusparseDnMatDescr_t* descriptor) {
+          CreateDnMatDescriptor<T>(x, dev_ctx, descriptor);
+        });
+    dev_ctx.CusparseCall([&](cusparseHandle_t handle) {
+      phi::dynload::cusparseDnMatSetValues(descriptor,
+                                           const_cast<T*>(x.data<T>()));
+    });
+    return descriptor;
+  }
+
+  // The workspace of a stream grows to the largest size asked on it, the
+  // calls on the stream are ordered, so they share it. A call captured into
+  // a CUDA graph gets a buffer of its own in holder instead, since the graph
+  // replays on the buffer after a later call may have replaced the cached one.
+  void* GetWorkspace(const phi::GPUContext& dev_ctx,
+                     size_t size,
+                     phi::Allocator::AllocationPtr* holder) {
+    if (phi::backends::gpu::CUDAGraph::IsThisThreadCapturing()) {
+      *holder = phi::memory_utils::Alloc(
+          dev_ctx.GetPlace(),
+          size,
+          phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+      return (*holder)->ptr();
+    }
+    CuSparseCacheKey key = {dev_ctx.GetPlace().GetDeviceId(),
+                            PtrToKey(dev_ctx.stream())};
+    auto& workspace = workspaces_[key];
+    if (workspace == nullptr || workspace->size() < size) {
+      workspace.reset();
+      workspace = phi::memory_utils::Alloc(
+          dev_ctx.GetPlace(),
+          size,
+          phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+      VLOG(6) << "Grow the cuSPARSE workspace of stream " << dev_ctx.stream()
+              << " to " << size;
+    }
+    return workspace->ptr();
+  }
+
+  // The workspace size of a call, keyed on its descriptors and algorithm.
+  template <typename Query>
+  size_t GetBufferSize(const CuSparseCacheKey& key, Query&& query) {
+    auto it = buffer_sizes_.find(key);
+    if (it != buffer_sizes_.end()) {
+      return it->second;
+    }
+    size_t buffer_size = query();
+    if (buffer_sizes_.size() >= kMaxBufferSizes) {
+      buffer_sizes_.clear();
+    }
+    buffer_sizes_.emplace(key, buffer_size);
+    return buffer_size;
+  }
+
+ private:
+  static constexpr size_t kMaxBufferSizes = 1024;
+
+  CuSparseCache()
+      : sp_mats_([](cusparseSpMatDescr_t descriptor) {
+          phi::dynload::cusparseDestroySpMat(descriptor);
+        }),
+        dn_mats_([](cusparseDnMatDescr_t descriptor) {
+          phi::dynload::cusparseDestroyDnMat(descriptor);
+        }) {}
+
+  template <typename T>
+  void BindValues(cusparseSpMatDescr_t descriptor,
+                  const T* values,
+                  const phi::GPUContext& dev_ctx) {
+    dev_ctx.CusparseCall([&](cusparseHandle_t handle) {
+      phi::dynload::cusparseSpMatSetValues(descriptor,
+                                           const_cast<T*>(values));
+    });
+  }
+
+  CuSparseDescriptorCache<cusparseSpMatDescr_t> sp_mats_;
+  CuSparseDescriptorCache<cusparseDnMatDescr_t> dn_mats_;
+  std::unordered_map<CuSparseCacheKey, phi::Allocator::AllocationPtr>
+      workspaces_;
+  std::unordered_map<CuSparseCacheKey, size_t> buffer_sizes_;
+};
+
+template <typename T>
+inline cusparseSpMatDescr_t GetCachedSpMatDescriptor(
+    const phi::SparseCsrTensor& x,
+    const phi::GPUContext& dev_ctx,
+    int64_t role,
+    CuSparseCacheKey* key) {
+  cusparseSpMatDescr_t descriptor;
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      x.non_zero_crows().dtype(), "GetCachedSpMatDescriptor", ([&] {
+        descriptor = CuSparseCache::Instance().GetSpMat<T, data_t>(
+            x, dev_ctx, role, key);
+      }));
+  return descriptor;
+}
+
+template <typename T>
+inline cusparseSpMatDescr_t GetCachedSpMatDescriptor(
+    const phi::SparseCooTensor& x,
+    const phi::GPUContext& dev_ctx,
+    int64_t role,
+    CuSparseCacheKey* key) {
+  cusparseSpMatDescr_t descriptor;
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      x.non_zero_indices().dtype(), "GetCachedSpMatDescriptor", ([&] {
+        descriptor = CuSparseCache::Instance().GetSpMat<T, data_t>(
+            x, dev_ctx, role, key);
+      }));
+  return descriptor;
+}
+
+/************* SPMM ALGORITHM AUTOTUNE ************/
+inline std::vector<cusparseSpMMAlg_t> GetSpMMAlgorithmCandidates(
+    const SparseCsrTensor& x) {
+  return {CUSPARSE_SPMM_CSR_ALG2, CUSPARSE_SPMM_CSR_ALG1};
+}
+
+inline std::vector<cusparseSpMMAlg_t> GetSpMMAlgorithmCandidates(
+    const SparseCooTensor& x) {
+  // CUSPARSE_SPMM_COO_ALG2 only supports the column major dense matrices
+  return {CUSPARSE_SPMM_ALG_DEFAULT,
+          CUSPARSE_SPMM_COO_ALG1,
+          CUSPARSE_SPMM_COO_ALG3,
+          CUSPARSE_SPMM_COO_ALG4};
+}
+
+// Times the candidate algorithms of the SpMM into a scratch output, so the
+// output, which is accumulated into with beta, is not touched. The ones not
+// supported for the shapes are skipped.
+template <typename T, typename TensorType>
+cusparseSpMMAlg_t TuneSpMMAlgorithm(const phi::GPUContext& dev_ctx,
+                                    cusparseOperation_t transa,
+                                    cusparseOperation_t transb,
+                                    T alpha,
+                                    const TensorType& mat_a,
+                                    cusparseSpMatDescr_t a_descriptor,
+                                    cusparseDnMatDescr_t b_descriptor,
+                                    T beta,
+                                    const phi::DenseTensor& mat_out) {
+  constexpr int kRepeats = 3;
+  phi::DenseTensor scratch = phi::EmptyLike<T>(dev_ctx, mat_out);
+  auto scratch_descriptor = CuSparseDnMatDescriptor<T>(scratch, dev_ctx);
+  cudaDataType_t gpu_type = GetGpuDataType<T>();
+  cusparseSpMMAlg_t best_algo = GetSpMMAlgorithm(mat_a);
+  float best_time = std::numeric_limits<float>::max();
+  phi::GpuTimer timer;
+  for (auto algo : GetSpMMAlgorithmCandidates(mat_a)) {
+    size_t buffer_size = 0;
+    cusparseStatus_t status = CUSPARSE_STATUS_SUCCESS;
+    dev_ctx.CusparseCall([&](cusparseHandle_t handle) {
+      status = phi::dynload::cusparseSpMM_bufferSize(
+          handle,
+          transa,
+          transb,
+          &alpha,
+          a_descriptor,
+          b_descriptor,
+          &beta,
+          scratch_descriptor.descriptor(),
+          gpu_type,
+          algo,
+          &buffer_size);
+    });
+    if (status != CUSPARSE_STATUS_SUCCESS) continue;
+    auto buffer = phi::memory_utils::Alloc(
+        dev_ctx.GetPlace(),
+        buffer_size,
+        phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+    float time = 0.f;
+    // the first run is the warmup
+    for (int i = 0; i <= kRepeats && status == CUSPARSE_STATUS_SUCCESS; ++i) {
+      timer.Start(dev_ctx.stream());
+      dev_ctx.CusparseCall([&](cusparseHandle_t handle) {
+        status = phi::dynload::cusparseSpMM(handle,
+                                            transa,
+                                            transb,
+                                            &alpha,
+                                            a_descriptor,
+                                            b_descriptor,
+                                            &beta,
+                                            scratch_descriptor.descriptor(),
+                                            gpu_type,
+                                            algo,
+                                            buffer->ptr());
+      });
+      timer.Stop(dev_ctx.stream());
+      if (i > 0) time += timer.ElapsedTime();
+    }
+    if (status != CUSPARSE_STATUS_SUCCESS) continue;
+    VLOG(4) << "SpMM algorithm " << algo << " takes " << time / kRepeats
+            << " ms";
+    if (time < best_time) {
+      best_time = time;
+      best_algo = algo;
+    }
+  }
+  return best_algo;
+}
+
+// The algorithm of the SpMM, picked by timing the candidates on the first
+// call of each shape when autotune is on.
+template <typename T, typename TensorType>
+cusparseSpMMAlg_t GetTunedSpMMAlgorithm(const phi::GPUContext& dev_ctx,
+                                        cusparseOperation_t transa,
+                                        cusparseOperation_t transb,
+                                        T alpha,
+                                        const TensorType& mat_a,
+                                        cusparseSpMatDescr_t a_descriptor,
+                                        const phi::DenseTensor& mat_b,
+                                        cusparseDnMatDescr_t b_descriptor,
+                                        T beta,
+                                        const phi::DenseTensor& mat_out) {
+  size_t key = phi::autotune::GenKey(
+      std::is_same<TensorType, SparseCsrTensor>::value,
+      common::vectorize(mat_a.dims()),
+      mat_a.nnz(),
+      common::vectorize(mat_b.dims()),
+      static_cast<int64_t>(transa),
+      static_cast<int64_t>(transb),
+      static_cast<int64_t>(GetGpuDataType<T>()));
+  auto& cache = phi::autotune::AutoTuneCache::Instance().Get(
+      phi::autotune::AlgorithmType::kSpMM);
+  if (cache.Find(key)) {
+    return static_cast<cusparseSpMMAlg_t>(cache.Get(key));
+  }
+  // the candidates cannot be timed while a graph is captured
+  if (!phi::autotune::AutoTuneStatus::Instance().UseAutoTune() ||
+      phi::backends::gpu::CUDAGraph::IsThisThreadCapturing()) {
+    return GetSpMMAlgorithm(mat_a);
+  }
+  auto algo = TuneSpMMAlgorithm<T>(dev_ctx,
+                                   transa,
+                                   transb,
+                                   alpha,
+                                   mat_a,
+                                   a_descriptor,
+                                   b_descriptor,
+                                   beta,
+                                   mat_out);
+  cache.Set(key, static_cast<int64_t>(algo));
+  return algo;
+}
+
 /************* SPARSE*DENSE->DENSE MATMUL ************/
 template <>
 template <typename T, typename TensorType>
@@ -332,42 +727,63 @@ void SparseBlas<phi::GPUContext>::SPMM(bool transa,
                                        const phi::DenseTensor& mat_b,
                                        T beta,
                                        phi::DenseTensor* mat_out) const {
-  auto a_descriptor = CuSparseSpMatDescriptor<T>(mat_a, dev_ctx_);
-  auto b_descriptor = CuSparseDnMatDescriptor<T>(mat_b, dev_ctx_);
-  auto out_descriptor = CuSparseDnMatDescriptor<T>(*mat_out, dev_ctx_);
+  auto& cache = CuSparseCache::Instance();
+  CuSparseCacheKey a_key, b_key, out_key;
+  auto a_descriptor = GetCachedSpMatDescriptor<T>(mat_a, dev_ctx_, 0, &a_key);
+  auto b_descriptor = cache.GetDnMat<T>(mat_b, dev_ctx_, 1, &b_key);
+  auto out_descriptor = cache.GetDnMat<T>(*mat_out, dev_ctx_, 2, &out_key);
 
   cudaDataType_t gpu_type = GetGpuDataType<T>();
-  size_t buffer_size = 0;
-  dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
-    phi::dynload::cusparseSpMM_bufferSize(handle,
-                                          GetTransposeOperation(transa),
-                                          GetTransposeOperation(transb),
-                                          &alpha,
-                                          a_descriptor.descriptor(),
-                                          b_descriptor.descriptor(),
-                                          &beta,
-                                          out_descriptor.descriptor(),
-                                          gpu_type,
-                                          GetSpMMAlgorithm(mat_a),
-                                          &buffer_size);
+  auto op_a = GetTransposeOperation(transa);
+  auto op_b = GetTransposeOperation(transb);
+  auto algo = GetTunedSpMMAlgorithm<T>(dev_ctx_,
+                                       op_a,
+                                       op_b,
+                                       alpha,
+                                       mat_a,
+                                       a_descriptor,
+                                       mat_b,
+                                       b_descriptor,
+                                       beta,
+                                       *mat_out);
+
+  CuSparseCacheKey key = {static_cast<int64_t>(op_a),
+                          static_cast<int64_t>(op_b),
+                          static_cast<int64_t>(algo)};
+  key.insert(key.end(), a_key.begin(), a_key.end());
+  key.insert(key.end(), b_key.begin(), b_key.end());
+  key.insert(key.end(), out_key.begin(), out_key.end());
+  size_t buffer_size = cache.GetBufferSize(key, [&]() {
+    size_t size = 0;
+    dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
+      phi::dynload::cusparseSpMM_bufferSize(handle,
+                                            op_a,
+                                            op_b,
+                                            &alpha,
+                                            a_descriptor,
+                                            b_descriptor,
+                                            &beta,
+                                            out_descriptor,
+                                            gpu_type,
+                                            algo,
+                                            &size);
+    });
+    return size;
   });
 
-  phi::Allocator::AllocationPtr tmp_buffer = phi::memory_utils::Alloc(
-      dev_ctx_.GetPlace(),
-      buffer_size,
-      phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx_.stream())));
-  void* tmp_buffer_ptr = tmp_buffer->ptr();
+  phi::Allocator::AllocationPtr tmp_buffer;
+  void* tmp_buffer_ptr = cache.GetWorkspace(dev_ctx_, buffer_size, &tmp_buffer);
   dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
     phi::dynload::cusparseSpMM(handle,
-                               GetTransposeOperation(transa),
-                               GetTransposeOperation(transb),
+                               op_a,
+                               op_b,
                                &alpha,
-                               a_descriptor.descriptor(),
-                               b_descriptor.descriptor(),
+                               a_descriptor,
+                               b_descriptor,
                                &beta,
-                               out_descriptor.descriptor(),
+                               out_descriptor,
                                gpu_type,
-                               GetSpMMAlgorithm(mat_a),
+                               algo,
                                tmp_buffer_ptr);
   });
 }
@@ -438,41 +854,53 @@ void SparseBlas<phi::GPUContext>::SDDMM(bool transa,
                                         const phi::DenseTensor& mat_b,
                                         T beta,
                                         TensorType* mat_out) const {
-  auto a_descriptor = CuSparseDnMatDescriptor<T>(mat_a, dev_ctx_);
-  auto b_descriptor = CuSparseDnMatDescriptor<T>(mat_b, dev_ctx_);
-  auto out_descriptor = CuSparseSpMatDescriptor<T>(*mat_out, dev_ctx_);
+  auto& cache = CuSparseCache::Instance();
+  CuSparseCacheKey a_key, b_key, out_key;
+  auto a_descriptor = cache.GetDnMat<T>(mat_a, dev_ctx_, 0, &a_key);
+  auto b_descriptor = cache.GetDnMat<T>(mat_b, dev_ctx_, 1, &b_key);
+  auto out_descriptor =
+      GetCachedSpMatDescriptor<T>(*mat_out, dev_ctx_, 2, &out_key);
 
   cudaDataType_t gpu_type = GetGpuDataType<T>();
-  size_t buffer_size = 0;
-  dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
-    phi::dynload::cusparseSDDMM_bufferSize(handle,
-                                           GetTransposeOperation(transa),
-                                           GetTransposeOperation(transb),
-                                           &alpha,
-                                           a_descriptor.descriptor(),
-                                           b_descriptor.descriptor(),
-                                           &beta,
-                                           out_descriptor.descriptor(),
-                                           gpu_type,
-                                           CUSPARSE_SDDMM_ALG_DEFAULT,
-                                           &buffer_size);
+  auto op_a = GetTransposeOperation(transa);
+  auto op_b = GetTransposeOperation(transb);
+  // CUSPARSE_SDDMM_ALG_DEFAULT is the only algorithm of SDDMM
+  CuSparseCacheKey key = {static_cast<int64_t>(op_a),
+                          static_cast<int64_t>(op_b),
+                          -1};
+  key.insert(key.end(), a_key.begin(), a_key.end());
+  key.insert(key.end(), b_key.begin(), b_key.end());
+  key.insert(key.end(), out_key.begin(), out_key.end());
+  size_t buffer_size = cache.GetBufferSize(key, [&]() {
+    size_t size = 0;
+    dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
+      phi::dynload::cusparseSDDMM_bufferSize(handle,
+                                             op_a,
+                                             op_b,
+                                             &alpha,
+                                             a_descriptor,
+                                             b_descriptor,
+                                             &beta,
+                                             out_descriptor,
+                                             gpu_type,
+                                             CUSPARSE_SDDMM_ALG_DEFAULT,
+                                             &size);
+    });
+    return size;
   });
 
-  phi::Allocator::AllocationPtr tmp_buffer = phi::memory_utils::Alloc(
-      dev_ctx_.GetPlace(),
-      buffer_size,
-      phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx_.stream())));
-  void* tmp_buffer_ptr = tmp_buffer->ptr();
+  phi::Allocator::AllocationPtr tmp_buffer;
+  void* tmp_buffer_ptr = cache.GetWorkspace(dev_ctx_, buffer_size, &tmp_buffer);
 
   dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
     phi::dynload::cusparseSDDMM_preprocess(handle,
-                                           GetTransposeOperation(transa),
-                                           GetTransposeOperation(transb),
+                                           op_a,
+                                           op_b,
                                            &alpha,
-                                           a_descriptor.descriptor(),
-                                           b_descriptor.descriptor(),
+                                           a_descriptor,
+                                           b_descriptor,
                                            &beta,
-                                           out_descriptor.descriptor(),
+                                           out_descriptor,
                                            gpu_type,
                                            CUSPARSE_SDDMM_ALG_DEFAULT,
                                            tmp_buffer_ptr);
@@ -480,13 +908,13 @@ void SparseBlas<phi::GPUContext>::SDDMM(bool transa,
 
   dev_ctx_.CusparseCall([&](cusparseHandle_t handle) {
     phi::dynload::cusparseSDDMM(handle,
-                                GetTransposeOperation(transa),
-                                GetTransposeOperation(transb),
+                                op_a,
+                                op_b,
                                 &alpha,
-                                a_descriptor.descriptor(),
-                                b_descriptor.descriptor(),
+                                a_descriptor,
+                                b_descriptor,
                                 &beta,
-                                out_descriptor.descriptor(),
+                                out_descriptor,
                                 gpu_type,
                                 CUSPARSE_SDDMM_ALG_DEFAULT,
                                 tmp_buffer_ptr);
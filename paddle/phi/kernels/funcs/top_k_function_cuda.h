@@ -986,6 +986,144 @@ __global__ void RadixTopK(const T* input,
 #endif
 /*---------------------------Radix TopK End------------------*/
 
+/*---------------------------Warp TopK Begin------------------*/
+#if defined(PADDLE_WITH_CUDA)
+// The largest k handled by WarpTopK, which keeps up to kMaxK candidates of
+// every thread in registers.
+constexpr int kWarpTopKMaxK = 64;
+// The widest row handled by WarpTopK, beyond which a block per row is faster.
+constexpr int64_t kWarpTopKMaxWidth = 4096;
+
+// Whether (a_v, a_id) goes before (b_v, b_id) in the result: a better value
+// first, then a smaller index. A negative index marks an empty slot.
+template <typename T, bool Largest>
+__device__ __forceinline__ bool WarpTopKBefore(const T& a_v,
+                                               int64_t a_id,
+                                               const T& b_v,
+                                               int64_t b_id) {
+  if (b_id < 0) return a_id >= 0;
+  if (a_id < 0) return false;
+  if (a_v != b_v) return Largest ? a_v > b_v : a_v < b_v;
+  return a_id < b_id;
+}
+
+// Computes the sorted top k of rows of at most kWarpTopKMaxWidth elements
+// with one warp per row, for many short rows that leave most of a block per
+// row idle. Every thread keeps the best MaxK elements of its strided part of
+// the row in registers, and the warp merges the heads of the lists k times.
+template <typename T, int MaxK, bool Largest>
+__global__ void WarpTopK(const T* input,
+                         int64_t num_rows,
+                         int64_t num_cols,
+                         int k,
+                         T* output,
+                         int64_t* indices) {
+  constexpr int kWarpsPerBlock = 4;
+  const int lane = threadIdx.x % WARP_SIZE;
+  int64_t row = static_cast<int64_t>(blockIdx.x) * kWarpsPerBlock +
+                threadIdx.x / WARP_SIZE;
+  const int64_t row_stride = static_cast<int64_t>(gridDim.x) * kWarpsPerBlock;
+  for (; row < num_rows; row += row_stride) {
+    const T* row_input = input + row * num_cols;
+    T vals[MaxK];
+    int64_t ids[MaxK];
+#pragma unroll
+    for (int j = 0; j < MaxK; ++j) {
+      vals[j] = static_cast<T>(0);
+      ids[j] = -1;
+    }
+    for (int64_t col = lane; col < num_cols; col += WARP_SIZE) {
+      T v = row_input[col];
+      int64_t id = col;
+      if (!WarpTopKBefore<T, Largest>(v, id, vals[MaxK - 1], ids[MaxK - 1])) {
+        continue;
+      }
+#pragma unroll
+      for (int j = 0; j < MaxK; ++j) {
+        if (WarpTopKBefore<T, Largest>(v, id, vals[j], ids[j])) {
+          T tmp_v = vals[j];
+          int64_t tmp_id = ids[j];
+          vals[j] = v;
+          ids[j] = id;
+          v = tmp_v;
+          id = tmp_id;
+        }
+      }
+    }
+
+    for (int i = 0; i < k; ++i) {
+      T best_v = vals[0];
+      int64_t best_id = ids[0];
+#pragma unroll
+      for (int offset = WARP_SIZE / 2; offset > 0; offset /= 2) {
+        T other_v = phi::backends::gpu::CudaShuffleXorSync(
+            FINAL_MASK, best_v, offset);
+        int64_t other_id = phi::backends::gpu::CudaShuffleXorSync(
+            FINAL_MASK, best_id, offset);
+        if (WarpTopKBefore<T, Largest>(other_v, other_id, best_v, best_id)) {
+          best_v = other_v;
+          best_id = other_id;
+        }
+      }
+      if (lane == 0) {
+        output[row * k + i] = best_v;
+        indices[row * k + i] = best_id;
+      }
+      if (ids[0] == best_id) {
+#pragma unroll
+        for (int j = 0; j < MaxK - 1; ++j) {
+          vals[j] = vals[j + 1];
+          ids[j] = ids[j + 1];
+        }
+        ids[MaxK - 1] = -1;
+      }
+    }
+  }
+}
+
+// Launches WarpTopK on the rows of `input`, and returns false if the shape is
+// not handled by it.
+template <typename T>
+bool LaunchWarpTopK(const phi::GPUContext& ctx,
+                    const T* input,
+                    int64_t num_rows,
+                    int64_t num_cols,
+                    int k,
+                    bool largest,
+                    T* output,
+                    int64_t* indices) {
+  if (k > kWarpTopKMaxK || num_cols > kWarpTopKMaxWidth) {
+    return false;
+  }
+  constexpr int kWarpsPerBlock = 4;
+  const int64_t max_blocks =
+      ctx.GetMaxPhysicalThreadCount() / (kWarpsPerBlock * WARP_SIZE);
+  const int blocks = static_cast<int>(std::min<int64_t>(
+      std::max<int64_t>(max_blocks, 1),
+      (num_rows + kWarpsPerBlock - 1) / kWarpsPerBlock));
+  const int threads = kWarpsPerBlock * WARP_SIZE;
+
+#define WARP_TOPK_CASE(max_k)                                               \
+  if (k <= (max_k)) {                                                       \
+    if (largest) {                                                          \
+      WarpTopK<T, (max_k), true><<<blocks, threads, 0, ctx.stream()>>>(     \
+          input, num_rows, num_cols, k, output, indices);                   \
+    } else {                                                                \
+      WarpTopK<T, (max_k), false><<<blocks, threads, 0, ctx.stream()>>>(    \
+          input, num_rows, num_cols, k, output, indices);                   \
+    }                                                                       \
+    return true;                                                            \
+  }
+  WARP_TOPK_CASE(8);
+  WARP_TOPK_CASE(16);
+  WARP_TOPK_CASE(32);
+  WARP_TOPK_CASE(64);
+#undef WARP_TOPK_CASE
+  return false;
+}
+#endif
+/*---------------------------Warp TopK End------------------*/
+
 template <typename T, int MaxLength, int BlockSize>
 __global__ void AssignGrad(T* x_grad,
                            const int64_t* indices,
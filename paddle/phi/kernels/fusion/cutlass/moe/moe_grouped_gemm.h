@@ -0,0 +1,312 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+// Ignore CUTLASS warnings about type punning
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#pragma GCC diagnostic ignored "-Wunused-function"
+
+#include "cutlass/epilogue/thread/linear_combination.h"
+#include "cutlass/gemm/device/gemm_grouped.h"
+#include "cutlass/gemm/gemm.h"
+#include "cutlass/gemm/kernel/default_gemm_grouped.h"
+#include "paddle/phi/kernels/fusion/cutlass/moe/default_moe_fc_traits.h"
+#pragma GCC diagnostic pop
+
+namespace phi {
+namespace fusion {
+
+template <typename T>
+struct MoeCutlassType {};
+
+template <>
+struct MoeCutlassType<phi::dtype::float16> {
+  using Type = cutlass::half_t;
+};
+
+template <>
+struct MoeCutlassType<phi::dtype::bfloat16> {
+  using Type = cutlass::bfloat16_t;
+};
+
+// The problems of a grouped GEMM with one problem per expert. They are built
+// on the device from the expert offsets, the inclusive prefix sum of the
+// token counts of the experts, so the host never reads the token counts.
+template <typename T>
+struct MoeGroupedGemmArgs {
+  cutlass::gemm::GemmCoord* problems;
+  T** ptr_a;
+  T** ptr_b;
+  T** ptr_c;
+  int64_t* lda;
+  int64_t* ldb;
+  int64_t* ldc;
+};
+
+inline size_t MoeAlignTo16(size_t bytes) { return (bytes + 15) / 16 * 16; }
+
+template <typename T>
+MoeGroupedGemmArgs<T> AllocMoeGroupedGemmArgs(const phi::GPUContext& ctx,
+                                              int num_experts,
+                                              DenseTensor* buffer) {
+  size_t problems_bytes =
+      MoeAlignTo16(num_experts * sizeof(cutlass::gemm::GemmCoord));
+  size_t ptr_bytes = MoeAlignTo16(num_experts * sizeof(T*));
+  size_t ld_bytes = MoeAlignTo16(num_experts * sizeof(int64_t));
+  int64_t bytes =
+      static_cast<int64_t>(problems_bytes + 3 * ptr_bytes + 3 * ld_bytes);
+
+  buffer->Resize({bytes});
+  int8_t* ptr = ctx.Alloc<int8_t>(buffer);
+  MoeGroupedGemmArgs<T> args;
+  args.problems = reinterpret_cast<cutlass::gemm::GemmCoord*>(ptr);
+  ptr += problems_bytes;
+  args.ptr_a = reinterpret_cast<T**>(ptr);
+  args.ptr_b = reinterpret_cast<T**>(ptr + ptr_bytes);
+  args.ptr_c = reinterpret_cast<T**>(ptr + 2 * ptr_bytes);
+  ptr += 3 * ptr_bytes;
+  args.lda = reinterpret_cast<int64_t*>(ptr);
+  args.ldb = reinterpret_cast<int64_t*>(ptr + ld_bytes);
+  args.ldc = reinterpret_cast<int64_t*>(ptr + 2 * ld_bytes);
+  return args;
+}
+
+// c[rows_e] = a[rows_e] @ b[e], where b[e] is [k, n], or [n, k] if trans_b.
+template <typename T>
+__global__ void SetupMoeGroupedGemmKernel(const int64_t* expert_offsets,
+                                          int num_experts,
+                                          int64_t n,
+                                          int64_t k,
+                                          bool trans_b,
+                                          const T* a,
+                                          const T* b,
+                                          T* c,
+                                          MoeGroupedGemmArgs<T> args) {
+  int e = blockIdx.x * blockDim.x + threadIdx.x;
+  if (e >= num_experts) {
+    return;
+  }
+  int64_t begin = e == 0 ? 0 : expert_offsets[e - 1];
+  int64_t rows = expert_offsets[e] - begin;
+  args.problems[e] = cutlass::gemm::GemmCoord(rows, n, k);
+  args.ptr_a[e] = const_cast<T*>(a) + begin * k;
+  args.ptr_b[e] = const_cast<T*>(b) + e * k * n;
+  args.ptr_c[e] = c + begin * n;
+  args.lda[e] = k;
+  args.ldb[e] = trans_b ? k : n;
+  args.ldc[e] = n;
+}
+
+// c[e] = a[rows_e]^T @ b[rows_e], where a is [rows, m] and b is [rows, n],
+// i.e. the token dim is the reduced dim of every problem.
+template <typename T>
+__global__ void SetupMoeGroupedGemmVarKKernel(const int64_t* expert_offsets,
+                                              int num_experts,
+                                              int64_t m,
+                                              int64_t n,
+                                              const T* a,
+                                              const T* b,
+                                              T* c,
+                                              MoeGroupedGemmArgs<T> args) {
+  int e = blockIdx.x * blockDim.x + threadIdx.x;
+  if (e >= num_experts) {
+    return;
+  }
+  int64_t begin = e == 0 ? 0 : expert_offsets[e - 1];
+  int64_t rows = expert_offsets[e] - begin;
+  args.problems[e] = cutlass::gemm::GemmCoord(m, n, rows);
+  args.ptr_a[e] = const_cast<T*>(a) + begin * m;
+  args.ptr_b[e] = const_cast<T*>(b) + begin * n;
+  args.ptr_c[e] = c + e * m * n;
+  args.lda[e] = m;
+  args.ldb[e] = n;
+  args.ldc[e] = n;
+}
+
+// Runs the grouped GEMM of MoeGroupedGemmArgs in one launch. The problem
+// sizes are only read by the device, so the threadblocks are scheduled over
+// the tiles of all the experts by the kernel itself.
+template <typename T, typename LayoutA, typename LayoutB>
+void RunMoeGroupedGemm(const phi::GPUContext& ctx,
+                       int num_experts,
+                       const MoeGroupedGemmArgs<T>& args) {
+  using ElementType = typename MoeCutlassType<T>::Type;
+  using MoeArchTraits = cutlass::gemm::kernel::
+      MoeArchTraits<ElementType, ElementType, cutlass::arch::Sm80>;
+  using ElementAccumulator = typename MoeArchTraits::AccType;
+  using EpilogueOp = cutlass::epilogue::thread::LinearCombination<
+      ElementType,
+      MoeArchTraits::ElementsPerAccessC,
+      ElementAccumulator,
+      ElementAccumulator,
+      cutlass::epilogue::thread::ScaleType::Nothing>;
+
+  using GemmKernel = typename cutlass::gemm::kernel::DefaultGemmGrouped<
+      ElementType,
+      LayoutA,
+      cutlass::ComplexTransform::kNone,
+      MoeArchTraits::ElementsPerAccessA,
+      ElementType,
+      LayoutB,
+      cutlass::ComplexTransform::kNone,
+      MoeArchTraits::ElementsPerAccessB,
+      ElementType,
+      cutlass::layout::RowMajor,
+      ElementAccumulator,
+      typename MoeArchTraits::OperatorClass,
+      cutlass::arch::Sm80,
+      typename MoeArchTraits::ThreadBlockShape,
+      typename MoeArchTraits::WarpShape,
+      typename MoeArchTraits::InstructionShape,
+      EpilogueOp,
+      cutlass::gemm::threadblock::GemmBatchedIdentityThreadblockSwizzle,
+      MoeArchTraits::Stages,
+      cutlass::gemm::kernel::GroupScheduleMode::kDeviceOnly,
+      typename MoeArchTraits::Operator>::GemmKernel;
+  using GemmGrouped = cutlass::gemm::device::GemmGrouped<GemmKernel>;
+
+  int occupancy = GemmGrouped::maximum_active_blocks();
+  if (occupancy == 0) {
+    PADDLE_THROW(phi::errors::Fatal(
+        "[MoE GroupedGemm] GPU lacks the shared memory resources to run "
+        "GroupedGEMM kernel"));
+  }
+  const int threadblock_count = occupancy * ctx.GetSMCount();
+
+  typename EpilogueOp::Params epilogue_op(ElementAccumulator(1.f),
+                                          ElementAccumulator(0.f));
+  typename GemmGrouped::Arguments gemm_args(
+      args.problems,
+      num_experts,
+      threadblock_count,
+      epilogue_op,
+      reinterpret_cast<ElementType**>(args.ptr_a),
+      reinterpret_cast<ElementType**>(args.ptr_b),
+      reinterpret_cast<ElementType**>(args.ptr_c),
+      reinterpret_cast<ElementType**>(args.ptr_c),
+      args.lda,
+      args.ldb,
+      args.ldc,
+      args.ldc);
+  GemmGrouped gemm;
+  auto status = gemm.initialize(gemm_args, nullptr, ctx.stream());
+  if (status != cutlass::Status::kSuccess) {
+    PADDLE_THROW(phi::errors::Fatal(
+        "[MoE GroupedGemm] Failed to initialize cutlass grouped gemm. Error: " +
+        std::string(cutlassGetStatusString(status))));
+  }
+  status = gemm.run(ctx.stream());
+  if (status != cutlass::Status::kSuccess) {
+    PADDLE_THROW(phi::errors::Fatal(
+        "[MoE GroupedGemm] Failed to run cutlass grouped gemm. Error: " +
+        std::string(cutlassGetStatusString(status))));
+  }
+}
+
+// out[rows_e] = x[rows_e] @ weight[e], or x[rows_e] @ weight[e]^T if
+// trans_weight. x is [tokens, k] sorted by expert and out is [tokens, n].
+template <typename T>
+void MoeGroupedGemm(const phi::GPUContext& ctx,
+                    const DenseTensor& x,
+                    const DenseTensor& weight,
+                    const DenseTensor& expert_offsets,
+                    bool trans_weight,
+                    int64_t n,
+                    int64_t k,
+                    DenseTensor* out) {
+  int num_experts = static_cast<int>(weight.dims()[0]);
+  DenseTensor buffer;
+  auto args = AllocMoeGroupedGemmArgs<T>(ctx, num_experts, &buffer);
+  constexpr int kThreads = 128;
+  int blocks = (num_experts + kThreads - 1) / kThreads;
+  SetupMoeGroupedGemmKernel<T>
+      <<<blocks, kThreads, 0, ctx.stream()>>>(expert_offsets.data<int64_t>(),
+                                              num_experts,
+                                              n,
+                                              k,
+                                              trans_weight,
+                                              x.data<T>(),
+                                              weight.data<T>(),
+                                              out->data<T>(),
+                                              args);
+  using RowMajor = cutlass::layout::RowMajor;
+  using ColumnMajor = cutlass::layout::ColumnMajor;
+  if (trans_weight) {
+    RunMoeGroupedGemm<T, RowMajor, ColumnMajor>(ctx, num_experts, args);
+  } else {
+    RunMoeGroupedGemm<T, RowMajor, RowMajor>(ctx, num_experts, args);
+  }
+}
+
+// out[e] = a[rows_e]^T @ b[rows_e], where a is [tokens, m], b is [tokens, n]
+// and out is [num_experts, m, n].
+template <typename T>
+void MoeGroupedGemmVarK(const phi::GPUContext& ctx,
+                        const DenseTensor& a,
+                        const DenseTensor& b,
+                        const DenseTensor& expert_offsets,
+                        int num_experts,
+                        DenseTensor* out) {
+  int64_t m = a.dims()[1];
+  int64_t n = b.dims()[1];
+  DenseTensor buffer;
+  auto args = AllocMoeGroupedGemmArgs<T>(ctx, num_experts, &buffer);
+  constexpr int kThreads = 128;
+  int blocks = (num_experts + kThreads - 1) / kThreads;
+  SetupMoeGroupedGemmVarKKernel<T>
+      <<<blocks, kThreads, 0, ctx.stream()>>>(expert_offsets.data<int64_t>(),
+                                              num_experts,
+                                              m,
+                                              n,
+                                              a.data<T>(),
+                                              b.data<T>(),
+                                              out->data<T>(),
+                                              args);
+  using RowMajor = cutlass::layout::RowMajor;
+  using ColumnMajor = cutlass::layout::ColumnMajor;
+  RunMoeGroupedGemm<T, ColumnMajor, RowMajor>(ctx, num_experts, args);
+}
+
+inline void CheckMoeGroupedGemmDevice(const phi::GPUContext& ctx,
+                                      int64_t n,
+                                      int64_t k) {
+  PADDLE_ENFORCE_GE(
+      ctx.GetComputeCapability(),
+      80,
+      phi::errors::Unimplemented(
+          "moe_grouped_gemm requires a GPU of compute capability 8.0 or "
+          "higher, but the current one is %d.",
+          ctx.GetComputeCapability()));
+  // The tensor core kernels load 128 bits at a time.
+  PADDLE_ENFORCE_EQ(
+      n % 8 == 0 && k % 8 == 0,
+      true,
+      phi::errors::InvalidArgument(
+          "moe_grouped_gemm requires the dims of the weight to be multiples "
+          "of 8, but received %d and %d.",
+          k,
+          n));
+}
+
+}  // namespace fusion
+}  // namespace phi
@@ -0,0 +1,80 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/fusion/cutlass/moe/moe_grouped_gemm.h"
+
+namespace phi {
+namespace fusion {
+
+template <typename T, typename Context>
+void MoeGroupedGemmGradKernel(const Context& ctx,
+                              const DenseTensor& x,
+                              const DenseTensor& weight,
+                              const DenseTensor& expert_offsets,
+                              const DenseTensor& out_grad,
+                              bool transpose_weight,
+                              DenseTensor* x_grad,
+                              DenseTensor* weight_grad) {
+  int64_t k = x.dims()[1];
+  int64_t n = out_grad.dims()[1];
+  CheckMoeGroupedGemmDevice(ctx, n, k);
+
+  if (x_grad) {
+    // x_grad[rows_e] = out_grad[rows_e] @ weight[e]^T, so the same grouped
+    // GEMM as the forward runs with the transpose of the weight flipped.
+    ctx.template Alloc<T>(x_grad);
+    if (x.numel() > 0) {
+      MoeGroupedGemm<T>(ctx,
+                        out_grad,
+                        weight,
+                        expert_offsets,
+                        !transpose_weight,
+                        k,
+                        n,
+                        x_grad);
+    }
+  }
+  if (weight_grad) {
+    // weight_grad[e] = x[rows_e]^T @ out_grad[rows_e], reduced over the
+    // tokens of the expert. Experts without tokens get zero gradients.
+    ctx.template Alloc<T>(weight_grad);
+    int num_experts = static_cast<int>(weight.dims()[0]);
+    if (x.numel() == 0) {
+      phi::funcs::SetConstant<Context, T> set_zero;
+      set_zero(ctx, weight_grad, static_cast<T>(0));
+    } else if (transpose_weight) {
+      MoeGroupedGemmVarK<T>(
+          ctx, out_grad, x, expert_offsets, num_experts, weight_grad);
+    } else {
+      MoeGroupedGemmVarK<T>(
+          ctx, x, out_grad, expert_offsets, num_experts, weight_grad);
+    }
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(moe_grouped_gemm_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::MoeGroupedGemmGradKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(2).SetDataType(phi::DataType::INT64);
+}
@@ -0,0 +1,51 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/fusion/cutlass/moe/moe_grouped_gemm.h"
+
+namespace phi {
+namespace fusion {
+
+template <typename T, typename Context>
+void MoeGroupedGemmKernel(const Context& ctx,
+                          const DenseTensor& x,
+                          const DenseTensor& weight,
+                          const DenseTensor& expert_offsets,
+                          bool transpose_weight,
+                          DenseTensor* out) {
+  ctx.template Alloc<T>(out);
+  int64_t k = x.dims()[1];
+  int64_t n = out->dims()[1];
+  if (x.numel() == 0 || n == 0) {
+    return;
+  }
+  CheckMoeGroupedGemmDevice(ctx, n, k);
+  MoeGroupedGemm<T>(
+      ctx, x, weight, expert_offsets, transpose_weight, n, k, out);
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(moe_grouped_gemm,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::MoeGroupedGemmKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(2).SetDataType(phi::DataType::INT64);
+}
@@ -2851,5 +2851,337 @@ void InvokeTransposeRemovePadding(const phi::GPUContext &dev_ctx,
                                                        padding_offset);
 }
 
+// The max of seq_lens_this_time of the decoding sequences, more than 1 if
+// some of them verify draft tokens.
+template <int THREADBLOCK_SIZE>
+__global__ void GetMaxVerifyLenKernel(const int *seq_lens_encoder,
+                                      const int *seq_lens_decoder,
+                                      const int *seq_lens_this_time,
+                                      int *max_len,
+                                      const int batch_size) {
+  typedef cub::BlockReduce<int, THREADBLOCK_SIZE> BlockReduce;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+
+  int max_len_this_thread = 0;
+  for (int i = threadIdx.x; i < batch_size; i += blockDim.x) {
+    if (seq_lens_encoder[i] == 0 && seq_lens_decoder[i] > 0) {
+      max_len_this_thread = max(seq_lens_this_time[i], max_len_this_thread);
+    }
+  }
+  int total =
+      BlockReduce(temp_storage).Reduce(max_len_this_thread, MaxOp<int>());
+  if (threadIdx.x == 0) {
+    *max_len = total;
+  }
+}
+
+inline int GetMaxVerifyLen(const phi::GPUContext &dev_ctx,
+                           const phi::DenseTensor &seq_lens_encoder,
+                           const phi::DenseTensor &seq_lens_decoder,
+                           const phi::DenseTensor &seq_lens_this_time,
+                           phi::DenseTensor *max_len_tensor,
+                           const int batch_size) {
+  constexpr int blockSize = 128;
+  int max_len_cpu = 0;
+  GetMaxVerifyLenKernel<blockSize><<<1, blockSize, 0, dev_ctx.stream()>>>(
+      seq_lens_encoder.data<int>(),
+      seq_lens_decoder.data<int>(),
+      seq_lens_this_time.data<int>(),
+      max_len_tensor->data<int>(),
+      batch_size);
+  memory_utils::Copy(phi::CPUPlace(),
+                     &max_len_cpu,
+                     dev_ctx.GetPlace(),
+                     max_len_tensor->data<int>(),
+                     sizeof(int),
+                     dev_ctx.stream());
+  return max_len_cpu;
+}
+
+// Applies the rotary embedding to the q and k of the tokens of the decoding
+// sequences at their positions after the cached ones, and writes their k and
+// v to the caches, for each pair of elements of each head of each token.
+template <typename T>
+__global__ void VerifyRotaryCacheKernel(
+    T *qkv,  // [token_num, 3, num_head, dim_head]
+    T *key_cache,
+    T *value_cache,
+    const float *cos_emb,
+    const float *sin_emb,
+    const int rope_dim,
+    const int *block_tables,
+    const int *padding_offsets,
+    const int *seq_lens_encoder,
+    const int *seq_lens_decoder,
+    const int token_num,
+    const int num_head,
+    const int dim_head,
+    const int max_seq_len,
+    const int max_blocks_per_seq,
+    const int block_size,
+    const bool use_neox_style) {
+  const int half_dim = dim_head / 2;
+  const int64_t elem_cnt =
+      static_cast<int64_t>(token_num) * num_head * half_dim;
+  const int hidden_size = num_head * dim_head;
+  for (int64_t linear_index = blockDim.x * blockIdx.x + threadIdx.x;
+       linear_index < elem_cnt;
+       linear_index += gridDim.x * blockDim.x) {
+    const int token_idx = linear_index / (num_head * half_dim);
+    const int hi = linear_index / half_dim % num_head;
+    const int pair = linear_index % half_dim;
+    const int ori_token_idx = token_idx + padding_offsets[token_idx];
+    const int bi = ori_token_idx / max_seq_len;
+    if (seq_lens_encoder[bi] > 0 || seq_lens_decoder[bi] == 0) continue;
+    const int pos = seq_lens_decoder[bi] + ori_token_idx % max_seq_len;
+
+    const int left = use_neox_style ? pair : 2 * pair;
+    const int right = use_neox_style ? pair + half_dim : 2 * pair + 1;
+    float cos_val = 1;
+    float sin_val = 0;
+    if (cos_emb) {
+      const int emb_idx = pos * rope_dim + pair;
+      cos_val = cos_emb[emb_idx];
+      sin_val = sin_emb[emb_idx];
+    }
+
+    const int block_idx =
+        block_tables[bi * max_blocks_per_seq + pos / block_size];
+    const int64_t cache_base =
+        ((static_cast<int64_t>(block_idx) * num_head + hi) * block_size +
+         pos % block_size) *
+        dim_head;
+    T *token_qkv = qkv + static_cast<int64_t>(token_idx) * 3 * hidden_size;
+    for (int qkv_id = 0; qkv_id < 3; ++qkv_id) {
+      T *head = token_qkv + qkv_id * hidden_size + hi * dim_head;
+      float x = static_cast<float>(head[left]);
+      float y = static_cast<float>(head[right]);
+      if (qkv_id < 2) {
+        float rotated_x = x * cos_val - y * sin_val;
+        float rotated_y = y * cos_val + x * sin_val;
+        x = rotated_x;
+        y = rotated_y;
+      }
+      if (qkv_id == 0) {
+        head[left] = static_cast<T>(x);
+        head[right] = static_cast<T>(y);
+      } else {
+        T *cache = qkv_id == 1 ? key_cache : value_cache;
+        cache[cache_base + left] = static_cast<T>(x);
+        cache[cache_base + right] = static_cast<T>(y);
+      }
+    }
+  }
+}
+
+constexpr int kVerifyAttnWarps = 4;
+constexpr int kVerifyAttnMaxDimHead = 256;
+
+// The attention of a head of a token of a decoding sequence over the cached
+// tokens up to its own position, so each draft token attends to the ones
+// before it. Each warp runs an online softmax over a strided part of the
+// positions, which are merged at the end.
+template <typename T>
+__global__ void VerifyAttentionKernel(
+    const T *qkv,  // [token_num, 3, num_head, dim_head]
+    const T *key_cache,
+    const T *value_cache,
+    const int *block_tables,
+    const int *padding_offsets,
+    const int *seq_lens_encoder,
+    const int *seq_lens_decoder,
+    T *out,  // [token_num, num_head, dim_head]
+    const int num_head,
+    const int dim_head,
+    const int max_seq_len,
+    const int max_blocks_per_seq,
+    const int block_size,
+    const float inv_sqrt_dh) {
+  constexpr int kElemsPerLane = kVerifyAttnMaxDimHead / 32;
+  const int token_idx = blockIdx.x;
+  const int hi = blockIdx.y;
+  const int warp = threadIdx.x / 32;
+  const int lane = threadIdx.x % 32;
+  const int ori_token_idx = token_idx + padding_offsets[token_idx];
+  const int bi = ori_token_idx / max_seq_len;
+  if (seq_lens_encoder[bi] > 0 || seq_lens_decoder[bi] == 0) return;
+  const int pos = seq_lens_decoder[bi] + ori_token_idx % max_seq_len;
+  const int *block_table = block_tables + bi * max_blocks_per_seq;
+
+  const T *q = qkv + (static_cast<int64_t>(token_idx) * 3 * num_head + hi) *
+                         dim_head;
+  float q_vals[kElemsPerLane];
+  float acc[kElemsPerLane];
+#pragma unroll
+  for (int e = 0; e < kElemsPerLane; ++e) {
+    int d = e * 32 + lane;
+    q_vals[e] = d < dim_head ? static_cast<float>(q[d]) : 0.f;
+    acc[e] = 0.f;
+  }
+
+  float max_logit = -INFINITY;
+  float sum = 0.f;
+  for (int j = warp; j <= pos; j += kVerifyAttnWarps) {
+    const int64_t base =
+        ((static_cast<int64_t>(block_table[j / block_size]) * num_head + hi) *
+             block_size +
+         j % block_size) *
+        dim_head;
+    float qk = 0.f;
+#pragma unroll
+    for (int e = 0; e < kElemsPerLane; ++e) {
+      int d = e * 32 + lane;
+      if (d < dim_head) {
+        qk += q_vals[e] * static_cast<float>(key_cache[base + d]);
+      }
+    }
+#pragma unroll
+    for (int mask = 16; mask >= 1; mask /= 2) {
+      qk += __shfl_xor_sync(uint32_t(-1), qk, mask);
+    }
+    qk *= inv_sqrt_dh;
+
+    float new_max = fmaxf(max_logit, qk);
+    float scale = __expf(max_logit - new_max);
+    float p = __expf(qk - new_max);
+    sum = sum * scale + p;
+#pragma unroll
+    for (int e = 0; e < kElemsPerLane; ++e) {
+      int d = e * 32 + lane;
+      if (d < dim_head) {
+        acc[e] = acc[e] * scale + p * static_cast<float>(value_cache[base + d]);
+      }
+    }
+    max_logit = new_max;
+  }
+
+  __shared__ float warp_max[kVerifyAttnWarps];
+  __shared__ float warp_sum[kVerifyAttnWarps];
+  __shared__ float warp_acc[kVerifyAttnWarps][kVerifyAttnMaxDimHead];
+  if (lane == 0) {
+    warp_max[warp] = max_logit;
+    warp_sum[warp] = sum;
+  }
+#pragma unroll
+  for (int e = 0; e < kElemsPerLane; ++e) {
+    int d = e * 32 + lane;
+    if (d < dim_head) {
+      warp_acc[warp][d] = acc[e];
+    }
+  }
+  __syncthreads();
+
+  float total_max = -INFINITY;
+#pragma unroll
+  for (int w = 0; w < kVerifyAttnWarps; ++w) {
+    total_max = fmaxf(total_max, warp_max[w]);
+  }
+  float total_sum = 0.f;
+#pragma unroll
+  for (int w = 0; w < kVerifyAttnWarps; ++w) {
+    // the warps without any position have a max of -inf
+    if (warp_max[w] != -INFINITY) {
+      total_sum += warp_sum[w] * __expf(warp_max[w] - total_max);
+    }
+  }
+  T *out_head =
+      out + (static_cast<int64_t>(token_idx) * num_head + hi) * dim_head;
+  for (int d = threadIdx.x; d < dim_head; d += blockDim.x) {
+    float val = 0.f;
+#pragma unroll
+    for (int w = 0; w < kVerifyAttnWarps; ++w) {
+      if (warp_max[w] != -INFINITY) {
+        val += warp_acc[w][d] * __expf(warp_max[w] - total_max);
+      }
+    }
+    out_head[d] = static_cast<T>(val / total_sum);
+  }
+}
+
+// The attention of the decoding sequences when some of them verify draft
+// tokens, i.e. have more than one token this time: the tokens of each are
+// appended to its cache after the seq_lens_decoder cached ones, and each
+// attends to the cache up to itself. The caches beyond the accepted tokens
+// are simply overwritten by the next step, which rolls back the rejected
+// ones. The caches are not quantized.
+template <typename T>
+void VerifyDecoderAttention(const phi::GPUContext &dev_ctx,
+                            phi::DenseTensor *qkv,
+                            const phi::DenseTensor *rope_emb,
+                            const phi::DenseTensor &block_tables,
+                            const phi::DenseTensor &padding_offsets,
+                            const phi::DenseTensor &seq_lens_encoder,
+                            const phi::DenseTensor &seq_lens_decoder,
+                            phi::DenseTensor *key_cache,
+                            phi::DenseTensor *value_cache,
+                            phi::DenseTensor *out,
+                            const int token_num,
+                            const int num_head,
+                            const int dim_head,
+                            const int max_seq_len,
+                            const int block_size,
+                            const bool use_neox_style) {
+  PADDLE_ENFORCE_LE(
+      dim_head,
+      kVerifyAttnMaxDimHead,
+      phi::errors::InvalidArgument(
+          "The dim_head of the verification of draft tokens should be no "
+          "more than %d, but got %d.",
+          kVerifyAttnMaxDimHead,
+          dim_head));
+  const int max_blocks_per_seq = block_tables.dims()[1];
+  const float *cos_emb = nullptr;
+  const float *sin_emb = nullptr;
+  int rope_dim = 0;
+  if (rope_emb) {
+    // [2, 1, max_seq_len, 1, dim_head or dim_head / 2]
+    rope_dim = rope_emb->dims()[4];
+    cos_emb = rope_emb->data<float>();
+    sin_emb = cos_emb + rope_emb->dims()[2] * rope_dim;
+  }
+
+  const int64_t pair_num =
+      static_cast<int64_t>(token_num) * num_head * (dim_head / 2);
+  const int blocksize = 128;
+  int grid_size = 1;
+  GetNumBlocks(pair_num, &grid_size);
+  VerifyRotaryCacheKernel<T><<<grid_size, blocksize, 0, dev_ctx.stream()>>>(
+      qkv->data<T>(),
+      key_cache->data<T>(),
+      value_cache->data<T>(),
+      cos_emb,
+      sin_emb,
+      rope_dim,
+      block_tables.data<int>(),
+      padding_offsets.data<int>(),
+      seq_lens_encoder.data<int>(),
+      seq_lens_decoder.data<int>(),
+      token_num,
+      num_head,
+      dim_head,
+      max_seq_len,
+      max_blocks_per_seq,
+      block_size,
+      use_neox_style);
+
+  dim3 grid(token_num, num_head);
+  VerifyAttentionKernel<T>
+      <<<grid, kVerifyAttnWarps * 32, 0, dev_ctx.stream()>>>(
+          qkv->data<T>(),
+          key_cache->data<T>(),
+          value_cache->data<T>(),
+          block_tables.data<int>(),
+          padding_offsets.data<int>(),
+          seq_lens_encoder.data<int>(),
+          seq_lens_decoder.data<int>(),
+          out->data<T>(),
+          num_head,
+          dim_head,
+          max_seq_len,
+          max_blocks_per_seq,
+          block_size,
+          1.f / sqrt(static_cast<float>(dim_head)));
+}
+
 }  // namespace fusion
 }  // namespace phi
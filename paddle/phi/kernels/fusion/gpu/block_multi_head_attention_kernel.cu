@@ -514,7 +514,43 @@ void DispatchWithDtype(
   }
   VLOG(3) << "encoder done";
   VLOG(3) << "max_dec_len_this_time: " << max_dec_len_this_time;
+  // more than 1 if some decoding sequences verify draft tokens
+  int max_verify_len_this_time = 0;
   if (max_dec_len_this_time > 0) {
+    max_verify_len_this_time = GetMaxVerifyLen(dev_ctx,
+                                               seq_lens_encoder,
+                                               seq_lens_decoder,
+                                               seq_lens_this_time,
+                                               &max_dec_len_tensor,
+                                               bsz);
+    VLOG(3) << "max_verify_len_this_time: " << max_verify_len_this_time;
+  }
+  if (max_verify_len_this_time > 1) {
+    PADDLE_ENFORCE_EQ(
+        !cache_k_quant_scales && !use_pre_cache,
+        true,
+        phi::errors::Unimplemented(
+            "The verification of draft tokens, with more than one token of a "
+            "decoding sequence, does not support the quantized caches or the "
+            "pre caches."));
+    VerifyDecoderAttention<T>(dev_ctx,
+                              &qkv_buf,
+                              rope_emb ? &rope_emb.get() : nullptr,
+                              block_tables,
+                              padding_offsets,
+                              seq_lens_encoder,
+                              seq_lens_decoder,
+                              key_cache_out,
+                              value_cache_out,
+                              &fmha_buf,
+                              token_num,
+                              num_head,
+                              dim_head,
+                              max_seq_len,
+                              block_size,
+                              use_neox_style);
+    VLOG(3) << "verify end";
+  } else if (max_dec_len_this_time > 0) {
     GetDecoderTensor<T>(dev_ctx,
                         qkv_buf,
                         nullptr,
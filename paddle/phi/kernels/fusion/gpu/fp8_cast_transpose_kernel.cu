@@ -0,0 +1,166 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <limits>
+#include <string>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+#include <cuda_fp8.h>
+#endif
+
+namespace phi {
+namespace fusion {
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+
+constexpr int kTileDim = 32;
+constexpr int kBlockRows = 8;
+
+// Every block casts a tile of [kTileDim, kTileDim] elements of x to fp8,
+// writes it to out and, through shared memory, transposed to out_t, so that
+// x is read once for both layouts. The max of |x| over the tile is reduced
+// in every warp and merged into amax, whose bits order like ints since they
+// are non-negative.
+template <typename T, __nv_fp8_interpretation_t kFormat>
+__global__ void Fp8CastTransposeCUDAKernel(const T* x,
+                                           const float* scale,
+                                           int64_t rows,
+                                           int64_t cols,
+                                           uint8_t* out,
+                                           uint8_t* out_t,
+                                           float* amax) {
+  __shared__ uint8_t tile[kTileDim][kTileDim + 1];
+
+  int64_t num_col_tiles = (cols + kTileDim - 1) / kTileDim;
+  int64_t tile_row = blockIdx.x / num_col_tiles * kTileDim;
+  int64_t tile_col = blockIdx.x % num_col_tiles * kTileDim;
+  float s = *scale;
+  float local_amax = 0;
+
+  for (int i = threadIdx.y; i < kTileDim; i += kBlockRows) {
+    int64_t r = tile_row + i;
+    int64_t c = tile_col + threadIdx.x;
+    if (r < rows && c < cols) {
+      float v = static_cast<float>(x[r * cols + c]);
+      local_amax = fmaxf(local_amax, fabsf(v));
+      uint8_t q = __nv_cvt_float_to_fp8(v * s, __NV_SATFINITE, kFormat);
+      out[r * cols + c] = q;
+      tile[i][threadIdx.x] = q;
+    }
+  }
+  __syncthreads();
+
+  for (int i = threadIdx.y; i < kTileDim; i += kBlockRows) {
+    int64_t r = tile_row + threadIdx.x;
+    int64_t c = tile_col + i;
+    if (r < rows && c < cols) {
+      out_t[c * rows + r] = tile[threadIdx.x][i];
+    }
+  }
+
+  for (int offset = kTileDim / 2; offset > 0; offset >>= 1) {
+    local_amax =
+        fmaxf(local_amax, __shfl_xor_sync(0xFFFFFFFF, local_amax, offset));
+  }
+  if (threadIdx.x == 0) {
+    atomicMax(reinterpret_cast<int*>(amax), __float_as_int(local_amax));
+  }
+}
+
+template <typename T, typename Context>
+void Fp8CastTransposeKernel(const Context& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& scale,
+                            const std::string& fp8_format,
+                            DenseTensor* out,
+                            DenseTensor* out_t,
+                            DenseTensor* amax) {
+  int64_t cols = x.dims()[x.dims().size() - 1];
+  int64_t rows = cols == 0 ? 0 : x.numel() / cols;
+
+  auto* out_data = dev_ctx.template Alloc<uint8_t>(out);
+  auto* out_t_data = dev_ctx.template Alloc<uint8_t>(out_t);
+  auto* amax_data = dev_ctx.template Alloc<float>(amax);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(amax_data, 0, sizeof(float), dev_ctx.stream()));
+  if (x.numel() == 0) {
+    return;
+  }
+
+  int64_t num_tiles = ((rows + kTileDim - 1) / kTileDim) *
+                      ((cols + kTileDim - 1) / kTileDim);
+  PADDLE_ENFORCE_LE(num_tiles,
+                    std::numeric_limits<int32_t>::max(),
+                    phi::errors::InvalidArgument(
+                        "Input(x) of fp8_cast_transpose is too large."));
+  dim3 block(kTileDim, kBlockRows);
+  if (fp8_format == "e4m3") {
+    Fp8CastTransposeCUDAKernel<T, __NV_E4M3>
+        <<<num_tiles, block, 0, dev_ctx.stream()>>>(x.data<T>(),
+                                                    scale.data<float>(),
+                                                    rows,
+                                                    cols,
+                                                    out_data,
+                                                    out_t_data,
+                                                    amax_data);
+  } else if (fp8_format == "e5m2") {
+    Fp8CastTransposeCUDAKernel<T, __NV_E5M2>
+        <<<num_tiles, block, 0, dev_ctx.stream()>>>(x.data<T>(),
+                                                    scale.data<float>(),
+                                                    rows,
+                                                    cols,
+                                                    out_data,
+                                                    out_t_data,
+                                                    amax_data);
+  } else {
+    PADDLE_THROW(phi::errors::InvalidArgument(
+        "fp8_format should be e4m3 or e5m2, but received %s.", fp8_format));
+  }
+}
+
+#else
+template <typename T, typename Context>
+void Fp8CastTransposeKernel(const Context& dev_ctx,
+                            const DenseTensor& x,
+                            const DenseTensor& scale,
+                            const std::string& fp8_format,
+                            DenseTensor* out,
+                            DenseTensor* out_t,
+                            DenseTensor* amax) {
+  PADDLE_THROW(phi::errors::Unimplemented(
+      "fp8_cast_transpose is only supported when CUDA_VERSION >= 11.8."));
+}
+#endif
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_cast_transpose,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::Fp8CastTransposeKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(1).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(0).SetDataType(phi::DataType::UINT8);
+  kernel->OutputAt(1).SetDataType(phi::DataType::UINT8);
+  kernel->OutputAt(2).SetDataType(phi::DataType::FLOAT32);
+}
@@ -0,0 +1,257 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+#include "paddle/phi/backends/dynload/cublasLt.h"
+#include "paddle/phi/common/memory_utils.h"
+#endif
+
+namespace phi {
+namespace fusion {
+
+#if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11080
+
+namespace {
+
+template <typename T>
+cudaDataType_t ToCudaDataType();
+
+template <>
+cudaDataType_t ToCudaDataType<float>() {
+  return CUDA_R_32F;
+}
+
+template <>
+cudaDataType_t ToCudaDataType<phi::dtype::float16>() {
+  return CUDA_R_16F;
+}
+
+template <>
+cudaDataType_t ToCudaDataType<phi::dtype::bfloat16>() {
+  return CUDA_R_16BF;
+}
+
+cudaDataType_t Fp8CudaDataType(const std::string& format) {
+  if (format == "e4m3") {
+    return CUDA_R_8F_E4M3;
+  } else if (format == "e5m2") {
+    return CUDA_R_8F_E5M2;
+  }
+  PADDLE_THROW(phi::errors::InvalidArgument(
+      "The fp8 format should be e4m3 or e5m2, but received %s.", format));
+}
+
+}  // namespace
+
+// Computes out = (x * x_scale_inv) @ (y * y_scale_inv)^T + bias, where x of
+// [M, K] and y of [N, K] hold fp8 data scaled by x_scale_inv and y_scale_inv
+// in uint8 tensors. Both x and y are K-major, which is the only layout the
+// fp8 kernels of cublasLt take, so a weight of [K, N] and the operands of the
+// backward pass are given transposed by fp8_cast_transpose.
+template <typename T, typename Context>
+void Fp8GemmKernel(const Context& dev_ctx,
+                   const DenseTensor& x,
+                   const DenseTensor& y,
+                   const DenseTensor& x_scale_inv,
+                   const DenseTensor& y_scale_inv,
+                   const paddle::optional<DenseTensor>& bias,
+                   const std::string& x_format,
+                   const std::string& y_format,
+                   DataType out_dtype,
+                   DenseTensor* out) {
+  PADDLE_ENFORCE_GE(
+      dev_ctx.GetComputeCapability(),
+      89,
+      phi::errors::Unimplemented(
+          "fp8_gemm requires a GPU of compute capability 8.9 or higher, but "
+          "the current one is %d.",
+          dev_ctx.GetComputeCapability()));
+  auto* out_data = dev_ctx.template Alloc<T>(out);
+
+  int64_t K = x.dims()[x.dims().size() - 1];
+  int64_t M = K == 0 ? 0 : x.numel() / K;
+  int64_t N = y.dims()[0];
+  if (M == 0 || N == 0) {
+    return;
+  }
+  // cublasLt needs the leading dims of fp8 matrices to be multiples of 16.
+  PADDLE_ENFORCE_EQ(
+      K % 16 == 0 && N % 16 == 0,
+      true,
+      phi::errors::InvalidArgument(
+          "fp8_gemm requires the last dims of Input(x) and Input(y) to be "
+          "multiples of 16, but received K = %d and N = %d.",
+          K,
+          N));
+
+  cudaDataType_t out_type = ToCudaDataType<T>();
+  cublasLtMatmulDesc_t operation_desc = nullptr;
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulDescCreate(
+      &operation_desc, CUBLAS_COMPUTE_32F, CUDA_R_32F));
+  // cublasLt is column major, so compute out^T = y @ x^T.
+  cublasOperation_t trans_y = CUBLAS_OP_T;
+  cublasOperation_t trans_x = CUBLAS_OP_N;
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulDescSetAttribute(
+      operation_desc, CUBLASLT_MATMUL_DESC_TRANSA, &trans_y, sizeof(trans_y)));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulDescSetAttribute(
+      operation_desc, CUBLASLT_MATMUL_DESC_TRANSB, &trans_x, sizeof(trans_x)));
+  const float* y_scale_inv_data = y_scale_inv.data<float>();
+  const float* x_scale_inv_data = x_scale_inv.data<float>();
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulDescSetAttribute(
+      operation_desc,
+      CUBLASLT_MATMUL_DESC_A_SCALE_POINTER,
+      &y_scale_inv_data,
+      sizeof(y_scale_inv_data)));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulDescSetAttribute(
+      operation_desc,
+      CUBLASLT_MATMUL_DESC_B_SCALE_POINTER,
+      &x_scale_inv_data,
+      sizeof(x_scale_inv_data)));
+  if (bias) {
+    cublasLtEpilogue_t epilogue = CUBLASLT_EPILOGUE_BIAS;
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulDescSetAttribute(
+        operation_desc,
+        CUBLASLT_MATMUL_DESC_EPILOGUE,
+        &epilogue,
+        sizeof(epilogue)));
+    const T* bias_data = bias->data<T>();
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulDescSetAttribute(
+        operation_desc,
+        CUBLASLT_MATMUL_DESC_BIAS_POINTER,
+        &bias_data,
+        sizeof(bias_data)));
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulDescSetAttribute(
+        operation_desc,
+        CUBLASLT_MATMUL_DESC_BIAS_DATA_TYPE,
+        &out_type,
+        sizeof(out_type)));
+  }
+
+  cublasLtMatrixLayout_t y_desc = nullptr, x_desc = nullptr,
+                         out_desc = nullptr;
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatrixLayoutCreate(
+      &y_desc, Fp8CudaDataType(y_format), K, N, K));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatrixLayoutCreate(
+      &x_desc, Fp8CudaDataType(x_format), K, M, K));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cublasLtMatrixLayoutCreate(&out_desc, out_type, N, M, N));
+
+  cublasLtHandle_t lt_handle = dev_ctx.cublaslt_handle();
+  size_t workspace_size = static_cast<size_t>(4) * 1024 * 1024;
+  auto workspace = memory_utils::Alloc(
+      dev_ctx.GetPlace(),
+      workspace_size,
+      phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+
+  cublasLtMatmulPreference_t preference = nullptr;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cublasLtMatmulPreferenceCreate(&preference));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatmulPreferenceSetAttribute(
+      preference,
+      CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES,
+      &workspace_size,
+      sizeof(workspace_size)));
+  cublasLtMatmulHeuristicResult_t heuristic_result;
+  int returned_results = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cublasLtMatmulAlgoGetHeuristic(lt_handle,
+                                                   operation_desc,
+                                                   y_desc,
+                                                   x_desc,
+                                                   out_desc,
+                                                   out_desc,
+                                                   preference,
+                                                   1,
+                                                   &heuristic_result,
+                                                   &returned_results));
+  PADDLE_ENFORCE_GT(returned_results,
+                    0,
+                    phi::errors::Unavailable(
+                        "cublasLt has no fp8 algorithm for M = %d, N = %d "
+                        "and K = %d.",
+                        M,
+                        N,
+                        K));
+
+  float alpha = 1.0f;
+  float beta = 0.0f;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cublasLtMatmul(lt_handle,
+                                   operation_desc,
+                                   &alpha,
+                                   y.data<uint8_t>(),
+                                   y_desc,
+                                   x.data<uint8_t>(),
+                                   x_desc,
+                                   &beta,
+                                   out_data,
+                                   out_desc,
+                                   out_data,
+                                   out_desc,
+                                   &heuristic_result.algo,
+                                   workspace->ptr(),
+                                   workspace_size,
+                                   dev_ctx.stream()));
+
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cublasLtMatmulPreferenceDestroy(preference));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cublasLtMatmulDescDestroy(operation_desc));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatrixLayoutDestroy(y_desc));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cublasLtMatrixLayoutDestroy(x_desc));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cublasLtMatrixLayoutDestroy(out_desc));
+}
+
+#else
+template <typename T, typename Context>
+void Fp8GemmKernel(const Context& dev_ctx,
+                   const DenseTensor& x,
+                   const DenseTensor& y,
+                   const DenseTensor& x_scale_inv,
+                   const DenseTensor& y_scale_inv,
+                   const paddle::optional<DenseTensor>& bias,
+                   const std::string& x_format,
+                   const std::string& y_format,
+                   DataType out_dtype,
+                   DenseTensor* out) {
+  PADDLE_THROW(phi::errors::Unimplemented(
+      "fp8_gemm is only supported when CUDA_VERSION >= 11.8."));
+}
+#endif
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fp8_gemm,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::Fp8GemmKernel,
+                   float,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->InputAt(0).SetDataType(phi::DataType::UINT8);
+  kernel->InputAt(1).SetDataType(phi::DataType::UINT8);
+  kernel->InputAt(2).SetDataType(phi::DataType::FLOAT32);
+  kernel->InputAt(3).SetDataType(phi::DataType::FLOAT32);
+}
@@ -15,6 +15,16 @@
 #include "paddle/phi/kernels/embedding_grad_kernel.h"
 #include "paddle/phi/kernels/funcs/embedding_grad.h"
 
+#include <thrust/copy.h>
+#include <thrust/execution_policy.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+#include <thrust/unique.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "glog/logging.h"
 #include "paddle/common/flags.h"
 #include "paddle/phi/backends/gpu/gpu_context.h"
@@ -65,6 +75,32 @@ __global__ void EmbeddingGrad(T* table,
   }
 }
 
+// Sums the rows of `output` with the same id into one row of `table`, in the
+// order of their positions in `sorted_pos`, so that the result does not
+// depend on the scheduling of threads. Rows [seg_starts[i], seg_starts[i + 1])
+// of `sorted_pos` hold the positions of the i-th unique id.
+template <typename T>
+__global__ void MergeSortedEmbeddingGrad(T* table,
+                                         const T* output,
+                                         const int64_t* sorted_pos,
+                                         const int64_t* seg_starts,
+                                         const int64_t num_unique,
+                                         const int64_t K,
+                                         const int64_t D) {
+  using MT = typename dtype::MPTypeTrait<T>::Type;
+  for (int64_t row = blockIdx.x; row < num_unique; row += gridDim.x) {
+    int64_t start = seg_starts[row];
+    int64_t end = row + 1 < num_unique ? seg_starts[row + 1] : K;
+    for (int64_t col = threadIdx.x; col < D; col += blockDim.x) {
+      MT sum = static_cast<MT>(0);
+      for (int64_t i = start; i < end; ++i) {
+        sum += static_cast<MT>(output[sorted_pos[i] * D + col]);
+      }
+      table[row * D + col] = static_cast<T>(sum);
+    }
+  }
+}
+
 template <typename T, typename Context>
 struct EmbeddingGradCUDAFunctor {
   EmbeddingGradCUDAFunctor(const Context& dev_ctx,
@@ -172,6 +208,10 @@ struct EmbeddingSparseGradCUDAFunctor {
   void apply() {
     // Since paddings are not trainable and fixed in forward, the gradient of
     // paddings makes no sense and we don't deal with it in backward.
+    if (FLAGS_embedding_deterministic != 0) {
+      ApplyMerged<IdT>();
+      return;
+    }
 
     const auto* ids_data = input_.template data<IdT>();
     auto* d_table = weight_grad_;
@@ -228,6 +268,83 @@ struct EmbeddingSparseGradCUDAFunctor {
   }
 
  private:
+  // Emits one row per unique id, summed in a fixed order. The ids are sorted
+  // together with their positions, and the rows of each run of equal ids are
+  // reduced by one thread block without atomics, so that the sparse
+  // optimizers get the gradient merged and deterministic.
+  template <typename IdT>
+  void ApplyMerged() {
+    const int64_t K = input_.numel();
+    const int64_t D = weight_.dims()[1];
+    auto* d_table = weight_grad_;
+    auto* d_table_value = d_table->mutable_value();
+    if (K == 0) {
+      d_table->set_rows({});
+      d_table_value->Resize({0, D});
+      dev_ctx_.template Alloc<T>(d_table_value);
+      return;
+    }
+
+    DenseTensor sorted_ids, sorted_pos, unique_ids, seg_starts;
+    sorted_ids.Resize({K});
+    sorted_pos.Resize({K});
+    unique_ids.Resize({K});
+    seg_starts.Resize({K});
+    auto* sorted_ids_data = dev_ctx_.template Alloc<int64_t>(&sorted_ids);
+    auto* sorted_pos_data = dev_ctx_.template Alloc<int64_t>(&sorted_pos);
+    auto* unique_ids_data = dev_ctx_.template Alloc<int64_t>(&unique_ids);
+    auto* seg_starts_data = dev_ctx_.template Alloc<int64_t>(&seg_starts);
+
+#ifdef PADDLE_WITH_CUDA
+    phi::memory_utils::ThrustAllocator<cudaStream_t> allocator(
+        dev_ctx_.GetPlace(), dev_ctx_.stream());
+    const auto& exec_policy =
+        thrust::cuda::par(allocator).on(dev_ctx_.stream());
+#else
+    const auto& exec_policy = thrust::hip::par.on(dev_ctx_.stream());
+#endif
+    const auto* ids_data = input_.template data<IdT>();
+    thrust::copy(exec_policy, ids_data, ids_data + K, sorted_ids_data);
+    thrust::sequence(exec_policy, sorted_pos_data, sorted_pos_data + K);
+    // Stable, so that the rows of an id are summed in their original order.
+    thrust::stable_sort_by_key(
+        exec_policy, sorted_ids_data, sorted_ids_data + K, sorted_pos_data);
+    int64_t num_unique =
+        thrust::unique_by_key_copy(exec_policy,
+                                   sorted_ids_data,
+                                   sorted_ids_data + K,
+                                   thrust::counting_iterator<int64_t>(0),
+                                   unique_ids_data,
+                                   seg_starts_data)
+            .first -
+        unique_ids_data;
+
+    std::vector<int64_t> new_rows(num_unique);
+    memory_utils::Copy(phi::CPUPlace(),
+                       new_rows.data(),
+                       dev_ctx_.GetPlace(),
+                       unique_ids_data,
+                       num_unique * sizeof(int64_t),
+                       dev_ctx_.stream());
+    d_table_value->Resize({num_unique, D});
+    auto* d_table_data = dev_ctx_.template Alloc<T>(d_table_value);
+
+    const int threads = std::min<int64_t>(
+        256, std::max<int64_t>(32, (D + 31) / 32 * 32));
+    const int64_t blocks =
+        std::min<int64_t>(num_unique, 8 * dev_ctx_.GetSMCount());
+    MergeSortedEmbeddingGrad<T>
+        <<<blocks, threads, 0, dev_ctx_.stream()>>>(d_table_data,
+                                                    out_grad_.data<T>(),
+                                                    sorted_pos_data,
+                                                    seg_starts_data,
+                                                    num_unique,
+                                                    K,
+                                                    D);
+    dev_ctx_.Wait();
+    d_table->set_rows(new_rows);
+  }
+
   const phi::GPUContext& dev_ctx_;
   const DenseTensor& input_;
   const DenseTensor& weight_;
@@ -21,8 +21,7 @@
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/utils/data_type.h"
-
-COMMON_DECLARE_bool(cudnn_deterministic);
+#include "paddle/phi/kernels/funcs/deterministic_scatter.cu.h"
 
 namespace phi {
 
@@ -83,10 +82,34 @@ void IndexAddKernel(const Context& ctx,
   // todo(@limin29): inplace do not need copy.
   phi::Copy(ctx, x, ctx.GetPlace(), false, output);
 
-  if (FLAGS_cudnn_deterministic) {
-    VLOG(2) << "Run grad kernel of index_add with single thread.";
-    block_dim = 1;
-    grid_dim.x = 1;
+  // reduce the duplicate indices by sorting them, without atomics
+  if (funcs::UseDeterministicScatter(size, input_dim[dim])) {
+    VLOG(2) << "Run index_add by sorting the index.";
+    int64_t outer_size = numel / (size * stride);
+    if (index_type == phi::DataType::INT64) {
+      funcs::DeterministicScatter<T, int64_t>(
+          ctx,
+          index.data<int64_t>(),
+          add_value_data,
+          outer_size,
+          size,
+          input_dim[dim],
+          stride,
+          funcs::DeterministicScatterMode::kAccumulate,
+          out_data);
+    } else {
+      funcs::DeterministicScatter<T, int>(
+          ctx,
+          index.data<int>(),
+          add_value_data,
+          outer_size,
+          size,
+          input_dim[dim],
+          stride,
+          funcs::DeterministicScatterMode::kAccumulate,
+          out_data);
+    }
+    return;
   }
 
   if (index_type == phi::DataType::INT64) {
@@ -17,6 +17,7 @@
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/cast_kernel.h"
+#include "paddle/phi/kernels/funcs/deterministic_scatter.cu.h"
 #include "paddle/phi/kernels/funcs/index_put_utils.h"
 
 namespace phi {
@@ -60,6 +61,30 @@ __global__ void IndexPutCudaKernel(const T* x,
   }
 }
 
+// The offset in x of each element of value.
+__global__ void IndexPutOffsetCudaKernel(int64_t** indices,
+                                         Array<int64_t, DDim::kMaxRank> stride,
+                                         Array<int64_t, DDim::kMaxRank> shape,
+                                         const int rank,
+                                         const int64_t numel,
+                                         int64_t* offsets) {
+  CUDA_KERNEL_LOOP_TYPE(idx, numel, int64_t) {
+    int64_t offset = 0;
+#pragma unroll
+    for (int i = 0; i < DDim::kMaxRank; ++i) {
+      if (i >= rank) {
+        break;
+      }
+      int64_t cur_ix = *(indices[i] + idx);
+      if (cur_ix < 0) {
+        cur_ix += shape[i];
+      }
+      offset += stride[i] * cur_ix;
+    }
+    offsets[idx] = offset;
+  }
+}
+
 template <typename T, typename Context>
 void LaunchIndexPutCudaKernel(const Context& dev_ctx,
                               const DenseTensor& x,
@@ -93,6 +118,35 @@ void LaunchIndexPutCudaKernel(const Context& dev_ctx,
       funcs::GetDevicePointerArray<int64_t, Context>(dev_ctx, indices);
 
   auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, numel);
+  // write the duplicate indices in order by sorting them, where value has
+  // been expanded to the indices
+  if (value.numel() == numel &&
+      funcs::UseDeterministicScatter(numel, x.numel())) {
+    DenseTensor offsets;
+    offsets.Resize(common::make_ddim({numel}));
+    auto* offsets_data = dev_ctx.template Alloc<int64_t>(&offsets);
+    IndexPutOffsetCudaKernel<<<config.block_per_grid,
+                               config.thread_per_block,
+                               0,
+                               dev_ctx.stream()>>>(pd_indices,
+                                                   stride_array,
+                                                   shape_array,
+                                                   rank,
+                                                   numel,
+                                                   offsets_data);
+    funcs::DeterministicScatter<T, int64_t>(
+        dev_ctx,
+        offsets_data,
+        val_data,
+        1,
+        numel,
+        x.numel(),
+        1,
+        accumulate ? funcs::DeterministicScatterMode::kAccumulate
+                   : funcs::DeterministicScatterMode::kAssign,
+        out_data);
+    return;
+  }
   IndexPutCudaKernel<T>
       <<<config.block_per_grid, config.thread_per_block, 0, dev_ctx.stream()>>>(
           x_data,
@@ -155,7 +209,10 @@ void IndexPutKernel(const Context& dev_ctx,
                                      bd_dim,
                                      &res_dim_v);
 
-  if (value.numel() != 1) {
+  // a single value is expanded as well to be reduced by sorting the indices
+  if (value.numel() != 1 ||
+      funcs::UseDeterministicScatter(
+          common::product(common::make_ddim(res_dim_v)), x.numel())) {
     tmp_value_v.emplace_back(
         DenseTensor(value.dtype()).Resize(common::make_ddim(res_dim_v)));
     ExpandKernel<T, Context>(
@@ -56,6 +56,43 @@ PD_REGISTER_KERNEL(matmul,
 }
 #endif
 
+#ifdef PADDLE_WITH_CUDA
+PD_REGISTER_KERNEL(matmul,
+                   GPU,
+                   STRIDED,
+                   phi::MatmulStridedKernel,
+                   float,
+                   double,
+                   int32_t,
+                   int64_t,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>,
+                   int8_t) {
+  if (kernel_key.dtype() == phi::DataType::INT8) {
+    kernel->OutputAt(0).SetDataType(phi::DataType::INT32);
+  }
+}
+#else
+PD_REGISTER_KERNEL(matmul,
+                   GPU,
+                   STRIDED,
+                   phi::MatmulStridedKernel,
+                   float,
+                   double,
+                   int32_t,
+                   int64_t,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16,
+                   phi::dtype::complex<float>,
+                   phi::dtype::complex<double>) {
+  if (kernel_key.dtype() == phi::DataType::INT8) {
+    kernel->OutputAt(0).SetDataType(phi::DataType::INT32);
+  }
+}
+#endif
+
 #ifdef PADDLE_WITH_CUDA
 PD_REGISTER_KERNEL(matmul_with_flatten,
                    GPU,
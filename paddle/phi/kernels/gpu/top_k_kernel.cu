@@ -105,6 +105,22 @@ void TopkKernel(const Context& dev_ctx,
       k = input_width;
     }
 
+#if defined(PADDLE_WITH_CUDA)
+    // Many short rows, such as in retrieval and beam search, leave most of a
+    // block per row idle, so a warp computes the top k of each row.
+    if (input_height >= 4 * dev_ctx.GetSMCount() &&
+        phi::funcs::LaunchWarpTopK<T>(dev_ctx,
+                                      input_data,
+                                      input_height,
+                                      input_width,
+                                      k,
+                                      largest,
+                                      output_data,
+                                      indices_data)) {
+      return;
+    }
+#endif
+
     // The conclusion is drawn from the data through multiple sets of
     // statistics
     if (input_width >= 128 && k >= input_width * 0.25) {
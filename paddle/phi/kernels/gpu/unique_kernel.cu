@@ -23,6 +23,7 @@
 #include <thrust/sort.h>
 #include <thrust/unique.h>
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -33,6 +34,7 @@
 namespace cub = hipcub;
 #endif
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
@@ -106,7 +108,73 @@ struct BinaryNotEqual {
   }
 };
 
+// Allocates the temporary storage of a cub algorithm from the allocator of
+// the context, so that it is ordered with the stream of the context.
+template <typename Context>
+void* CubTempStorage(const Context& context,
+                     size_t bytes,
+                     DenseTensor* storage) {
+  // cub only queries the size when the storage is null.
+  storage->Resize(
+      common::make_ddim({static_cast<int64_t>(std::max<size_t>(bytes, 1))}));
+  return context.template Alloc<uint8_t>(storage);
+}
+
+template <typename IndexT>
+__global__ void SequenceKernel(int64_t num, IndexT* out) {
+  int64_t stride = static_cast<int64_t>(blockDim.x) * gridDim.x;
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       i < num;
+       i += stride) {
+    out[i] = static_cast<IndexT>(i);
+  }
+}
+
+// flags[i] is 1 if sorted[i] starts a new run of equal values.
+template <typename InT, typename IndexT>
+__global__ void MarkRunStartsKernel(const InT* sorted,
+                                    int64_t num,
+                                    IndexT* flags) {
+  int64_t stride = static_cast<int64_t>(blockDim.x) * gridDim.x;
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       i < num;
+       i += stride) {
+    flags[i] = (i > 0 && sorted[i] != sorted[i - 1]) ? 1 : 0;
+  }
+}
+
+template <typename IndexT>
+__global__ void ScatterInverseKernel(const IndexT* run_ids,
+                                     const IndexT* sorted_pos,
+                                     int64_t num,
+                                     IndexT* inverse) {
+  int64_t stride = static_cast<int64_t>(blockDim.x) * gridDim.x;
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       i < num;
+       i += stride) {
+    inverse[sorted_pos[i]] = run_ids[i];
+  }
+}
+
+template <typename IndexT>
+__global__ void GatherRunFirstPosKernel(const IndexT* run_offsets,
+                                        const IndexT* sorted_pos,
+                                        int64_t num_runs,
+                                        IndexT* first_pos) {
+  int64_t stride = static_cast<int64_t>(blockDim.x) * gridDim.x;
+  for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+       i < num_runs;
+       i += stride) {
+    first_pos[i] = sorted_pos[run_offsets[i]];
+  }
+}
+
 // The core logic of computing Unique for a flattend DenseTensor
+//
+// The values are sorted with their positions by cub radix sort, which is
+// stable, and the runs of equal values are found by cub run-length encoding.
+// All the temporary storage comes from the allocator of the context, and the
+// number of unique values is the only data read back to the host.
 template <typename Context, typename InT, typename IndexT>
 static typename std::enable_if<
     !std::is_same<InT, phi::dtype::float16>::value &&
@@ -121,120 +189,155 @@ UniqueFlattendCUDATensor(const Context& context,
                          bool return_inverse,
                          bool return_counts,
                          int64_t num_input) {
-  // 0. Prepration
-  auto equal = thrust::equal_to<InT>();
-  auto not_equal = thrust::not_equal_to<InT>();
-  DenseTensor in_hat;
-  phi::Copy(context, in, context.GetPlace(), false, &in_hat);
-  auto* in_data_hat = context.template Alloc<InT>(&in_hat);
-
+  if (num_input == 0) {
+    out->Resize(common::make_ddim({0}));
+    context.template Alloc<InT>(out);
+    for (auto* index_out : {indices, index, counts}) {
+      if (index_out) {
+        index_out->Resize(common::make_ddim({0}));
+        context.template Alloc<IndexT>(index_out);
+      }
+    }
+    return;
+  }
+  auto stream = context.stream();
+  auto config = backends::gpu::GetGpuLaunchConfig1D(context, num_input);
+  DenseTensor temp_storage;
+  size_t temp_storage_bytes = 0;
+
+  // 0. Sort the values with their positions
+  DenseTensor sorted_in, positions;
+  sorted_in.Resize(common::make_ddim({num_input}));
+  positions.Resize(common::make_ddim({num_input}));
+  auto* sorted_in_data = context.template Alloc<InT>(&sorted_in);
+  auto* positions_data = context.template Alloc<IndexT>(&positions);
   indices->Resize(common::make_ddim({num_input}));
   auto* indices_data = context.template Alloc<IndexT>(indices);
-
-#ifdef PADDLE_WITH_CUDA
-  phi::memory_utils::ThrustAllocator<cudaStream_t> allocator(context.GetPlace(),
-                                                             context.stream());
-  const auto& exec_policy = thrust::cuda::par(allocator).on(context.stream());
-#else
-  const auto& exec_policy = thrust::hip::par.on(context.stream());
-#endif
-
-  thrust::sequence(exec_policy, indices_data, indices_data + num_input);
-  thrust::sort_by_key(
-      exec_policy, in_data_hat, in_data_hat + num_input, indices_data);
-
-  // 1. Calculate op result: 'out'
-  DenseTensor range;
-  range.Resize(common::make_ddim({num_input + 1}));
-  auto* range_data_ptr = context.template Alloc<IndexT>(&range);
-  thrust::sequence(exec_policy, range_data_ptr, range_data_ptr + num_input + 1);
-  phi::Copy(context, in_hat, context.GetPlace(), false, out);
-  int num_out;
-  auto out_data = context.template Alloc<InT>(out);
-  num_out =
-      thrust::unique_by_key(
-          exec_policy, out_data, out_data + num_input, range_data_ptr, equal)
-          .first -
-      out_data;
+  SequenceKernel<IndexT>
+      <<<config.block_per_grid.x, config.thread_per_block.x, 0, stream>>>(
+          num_input, positions_data);
+  const InT* in_data = in.data<InT>();
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceRadixSort::SortPairs(nullptr,
+                                      temp_storage_bytes,
+                                      in_data,
+                                      sorted_in_data,
+                                      positions_data,
+                                      indices_data,
+                                      num_input,
+                                      0,
+                                      sizeof(InT) * 8,
+                                      stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceRadixSort::SortPairs(
+      CubTempStorage(context, temp_storage_bytes, &temp_storage),
+      temp_storage_bytes,
+      in_data,
+      sorted_in_data,
+      positions_data,
+      indices_data,
+      num_input,
+      0,
+      sizeof(InT) * 8,
+      stream));
+
+  // 1. Calculate op result: 'out', and the count of each unique value
+  out->Resize(common::make_ddim({num_input}));
+  auto* out_data = context.template Alloc<InT>(out);
+  DenseTensor run_counts, num_runs;
+  run_counts.Resize(common::make_ddim({num_input}));
+  num_runs.Resize(common::make_ddim({1}));
+  auto* run_counts_data = context.template Alloc<IndexT>(&run_counts);
+  auto* num_runs_data = context.template Alloc<int64_t>(&num_runs);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceRunLengthEncode::Encode(nullptr,
+                                         temp_storage_bytes,
+                                         sorted_in_data,
+                                         out_data,
+                                         run_counts_data,
+                                         num_runs_data,
+                                         num_input,
+                                         stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceRunLengthEncode::Encode(
+      CubTempStorage(context, temp_storage_bytes, &temp_storage),
+      temp_storage_bytes,
+      sorted_in_data,
+      out_data,
+      run_counts_data,
+      num_runs_data,
+      num_input,
+      stream));
+  int64_t num_out = 0;
+  memory_utils::Copy(phi::CPUPlace(),
+                     &num_out,
+                     context.GetPlace(),
+                     num_runs_data,
+                     sizeof(int64_t),
+                     stream);
+  context.Wait();
   out->Resize(common::make_ddim({num_out}));
 
   // 3. Calculate inverse index: 'inverse'
   if (return_inverse) {
     index->Resize(common::make_ddim({num_input}));
     auto* inverse_data = context.template Alloc<IndexT>(index);
-    DenseTensor inv_loc;
-    inv_loc.Resize(common::make_ddim({num_input}));
-    auto inv_loc_data_ptr = context.template Alloc<IndexT>(&inv_loc);
-    thrust::adjacent_difference(exec_policy,
-                                in_data_hat,
-                                in_data_hat + num_input,
-                                inv_loc_data_ptr,
-                                not_equal);
-#ifdef PADDLE_WITH_HIP
-    hipMemset(inv_loc_data_ptr, 0, sizeof(IndexT));
-#else
-    thrust::device_ptr<IndexT> inv_loc_data_dev(inv_loc_data_ptr);
-    inv_loc_data_dev[0] = 0;  // without device_ptr, segmentation fault
-#endif
-
-#ifdef PADDLE_WITH_HIP
-    size_t temp_storage_bytes = 0;
-    cub::DeviceScan::InclusiveSum(NULL,
-                                  temp_storage_bytes,
-                                  inv_loc_data_ptr,
-                                  inv_loc_data_ptr,
-                                  num_input,
-                                  context.stream());
-    auto d_temp_storage =
-        phi::memory_utils::Alloc(context.GetPlace(), temp_storage_bytes);
-    cub::DeviceScan::InclusiveSum(d_temp_storage->ptr(),
-                                  temp_storage_bytes,
-                                  inv_loc_data_ptr,
-                                  inv_loc_data_ptr,
-                                  num_input,
-                                  context.stream());
-#else
-    thrust::inclusive_scan(exec_policy,
-                           inv_loc_data_ptr,
-                           inv_loc_data_ptr + num_input,
-                           inv_loc_data_ptr);
-#endif
-    thrust::scatter(exec_policy,
-                    inv_loc_data_ptr,
-                    inv_loc_data_ptr + num_input,
-                    indices_data,
-                    inverse_data);
+    DenseTensor run_ids;
+    run_ids.Resize(common::make_ddim({num_input}));
+    auto* run_ids_data = context.template Alloc<IndexT>(&run_ids);
+    MarkRunStartsKernel<InT, IndexT>
+        <<<config.block_per_grid.x, config.thread_per_block.x, 0, stream>>>(
+            sorted_in_data, num_input, run_ids_data);
+    PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceScan::InclusiveSum(nullptr,
+                                                             temp_storage_bytes,
+                                                             run_ids_data,
+                                                             run_ids_data,
+                                                             num_input,
+                                                             stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceScan::InclusiveSum(
+        CubTempStorage(context, temp_storage_bytes, &temp_storage),
+        temp_storage_bytes,
+        run_ids_data,
+        run_ids_data,
+        num_input,
+        stream));
+    ScatterInverseKernel<IndexT>
+        <<<config.block_per_grid.x, config.thread_per_block.x, 0, stream>>>(
+            run_ids_data, indices_data, num_input, inverse_data);
   }
 
-  // 2. Calculate sorted index: 'indices'
+  // 2. Calculate sorted index: 'indices', the first position of each unique
+  // value, as the sort is stable
   if (return_index) {
-    DenseTensor tmp_indices;
-    tmp_indices.Resize(common::make_ddim({num_input}));
-    auto* tmp_indices_data_ptr = context.template Alloc<IndexT>(&tmp_indices);
-    thrust::copy(exec_policy,
-                 in_data_hat,
-                 in_data_hat + num_input,
-                 tmp_indices_data_ptr);
-    thrust::unique_by_key(exec_policy,
-                          tmp_indices_data_ptr,
-                          tmp_indices_data_ptr + num_input,
-                          indices_data,
-                          equal);
-    indices->Resize(common::make_ddim({num_out}));
+    DenseTensor run_offsets, first_pos;
+    run_offsets.Resize(common::make_ddim({num_out}));
+    first_pos.Resize(common::make_ddim({num_out}));
+    auto* run_offsets_data = context.template Alloc<IndexT>(&run_offsets);
+    auto* first_pos_data = context.template Alloc<IndexT>(&first_pos);
+    PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceScan::ExclusiveSum(nullptr,
+                                                             temp_storage_bytes,
+                                                             run_counts_data,
+                                                             run_offsets_data,
+                                                             num_out,
+                                                             stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(cub::DeviceScan::ExclusiveSum(
+        CubTempStorage(context, temp_storage_bytes, &temp_storage),
+        temp_storage_bytes,
+        run_counts_data,
+        run_offsets_data,
+        num_out,
+        stream));
+    auto out_config = backends::gpu::GetGpuLaunchConfig1D(context, num_out);
+    GatherRunFirstPosKernel<IndexT><<<out_config.block_per_grid.x,
+                                      out_config.thread_per_block.x,
+                                      0,
+                                      stream>>>(
+        run_offsets_data, indices_data, num_out, first_pos_data);
+    phi::Copy(context, first_pos, context.GetPlace(), false, indices);
   }
 
   // 4. Calculate 'counts'
   if (return_counts) {
-    counts->Resize(common::make_ddim({num_out}));
-    auto count_data = context.template Alloc<IndexT>(counts);
-    // init 'count_data' as 0
-    thrust::fill(exec_policy, count_data, count_data + num_out, 0);
-    thrust::device_ptr<IndexT> range_data_ptr_dev(range_data_ptr);
-    range_data_ptr_dev[num_out] = num_input;
-    thrust::adjacent_difference(exec_policy,
-                                range_data_ptr + 1,
-                                range_data_ptr + num_out + 1,
-                                count_data);
+    run_counts.Resize(common::make_ddim({num_out}));
+    phi::Copy(context, run_counts, context.GetPlace(), false, counts);
   }
 }
 
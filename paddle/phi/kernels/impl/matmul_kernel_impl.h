@@ -20,6 +20,7 @@ limitations under the License. */
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/autotune/cache_base.h"
 #include "paddle/phi/kernels/cast_kernel.h"
+#include "paddle/phi/kernels/contiguous_kernel.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
 #include "paddle/phi/kernels/funcs/blas/blaslt_impl.cu.h"
 #include "paddle/phi/kernels/funcs/complex_functors.h"
@@ -1490,6 +1491,67 @@ void MatmulKernel(const Context& ctx,
       ctx, x, y, x_dims, y_dims, out, transpose_x, transpose_y);
 }
 
+// Returns whether x is the transpose of the last two dims of a contiguous
+// tensor, e.g. the output of a transpose or of x.mT.
+inline bool IsTransposedContiguous(const DenseTensor& x) {
+  int rank = x.dims().size();
+  if (rank < 2) {
+    return false;
+  }
+  const auto& dims = x.dims();
+  const auto& strides = x.strides();
+  if (strides[rank - 2] != 1 || strides[rank - 1] != dims[rank - 2]) {
+    return false;
+  }
+  int64_t stride = dims[rank - 1] * dims[rank - 2];
+  for (int i = rank - 3; i >= 0; --i) {
+    if (dims[i] != 1 && strides[i] != stride) {
+      return false;
+    }
+    stride *= dims[i];
+  }
+  return true;
+}
+
+// Prepares an input of MatmulStridedKernel: a transposed view of a
+// contiguous tensor is aliased as the contiguous tensor with its transpose
+// flag flipped, and any other non-contiguous input is copied.
+template <typename T, typename Context>
+DenseTensor MatmulStridedInput(const Context& dev_ctx,
+                               const DenseTensor& x,
+                               bool* transpose) {
+  if (x.meta().is_contiguous()) {
+    return x;
+  }
+  if (!IsTransposedContiguous(x)) {
+    return Contiguous<T, Context>(dev_ctx, x);
+  }
+  int rank = x.dims().size();
+  DenseTensor alias;
+  auto meta = x.meta();
+  std::swap(meta.dims[rank - 2], meta.dims[rank - 1]);
+  meta.strides = DenseTensorMeta::calc_strides(meta.dims);
+  alias.set_meta(meta);
+  alias.ResetHolder(x.Holder());
+  *transpose = !*transpose;
+  return alias;
+}
+
+template <typename T, typename Context>
+void MatmulStridedKernel(const Context& dev_ctx,
+                         const DenseTensor& x,
+                         const DenseTensor& y,
+                         bool transpose_x,
+                         bool transpose_y,
+                         DenseTensor* out) {
+  DenseTensor x_in = MatmulStridedInput<T, Context>(dev_ctx, x, &transpose_x);
+  DenseTensor y_in = MatmulStridedInput<T, Context>(dev_ctx, y, &transpose_y);
+  auto meta = out->meta();
+  meta.strides = DenseTensorMeta::calc_strides(meta.dims);
+  out->set_meta(meta);
+  MatmulKernel<T, Context>(dev_ctx, x_in, y_in, transpose_x, transpose_y, out);
+}
+
 template <typename T, typename Context>
 void MatmulWithFlattenKernelImpl(const Context& dev_ctx,
                                  const DenseTensor& x,
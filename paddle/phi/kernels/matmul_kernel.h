@@ -28,6 +28,16 @@ void MatmulKernel(const Context& dev_ctx,
                   bool transpose_y,
                   DenseTensor* out);
 
+// Takes the inputs in any layout. Transposed views of contiguous matrices are
+// passed to MatmulKernel with the transpose flag flipped instead of copied.
+template <typename T, typename Context>
+void MatmulStridedKernel(const Context& dev_ctx,
+                         const DenseTensor& x,
+                         const DenseTensor& y,
+                         bool transpose_x,
+                         bool transpose_y,
+                         DenseTensor* out);
+
 // In order to be compatible with `mul` op in fluid,
 // it is no longer used in 2.x API
 template <typename T, typename Context>
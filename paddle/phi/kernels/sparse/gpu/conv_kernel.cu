@@ -14,7 +14,11 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/conv_kernel.h"
 
+#include <thrust/equal.h>
+#include <thrust/execution_policy.h>
+
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_meta.h"
 #include "paddle/phi/core/visit_type.h"
@@ -67,6 +71,76 @@ namespace sparse {
     }                                                                    \
   })
 
+// The rulebook of a submanifold conv only depends on the indices of x, which
+// are also the indices of out, the spatial dims of x and every argument of
+// ProductRuleBook: the spatial kernel size, the paddings, the dilations and
+// the strides. When no key is given, the rulebook is still cached in the
+// indices dict under a key made of them, with the indices it was built from,
+// so that the following submanifold convs with the same arguments reuse it
+// instead of building it again. Some kernels keep the dict but not the
+// indices, such as coalesce, so the indices are compared before the rulebook
+// is reused.
+inline std::string ImplicitSubmKey(const DDim& x_dims,
+                                   const DDim& kernel_dims,
+                                   const std::vector<int>& paddings,
+                                   const std::vector<int>& dilations,
+                                   const std::vector<int>& strides) {
+  std::string key = "__subm_rulebook_x";
+  for (int i = 1; i < x_dims.size() - 1; ++i) {
+    key += "_" + std::to_string(x_dims[i]);
+  }
+  key += "_k";
+  for (int i = 0; i < kernel_dims.size() - 2; ++i) {
+    key += "_" + std::to_string(kernel_dims[i]);
+  }
+  key += "_p";
+  for (int padding : paddings) {
+    key += "_" + std::to_string(padding);
+  }
+  key += "_d";
+  for (int dilation : dilations) {
+    key += "_" + std::to_string(dilation);
+  }
+  key += "_s";
+  for (int stride : strides) {
+    key += "_" + std::to_string(stride);
+  }
+  return key;
+}
+
+template <typename IntT>
+bool HasCachedSubmRulebook(const GPUContext& dev_ctx,
+                           const SparseCooTensor& x,
+                           const std::string& implicit_key) {
+  const auto* rulebook_pair = x.IndicesPairs(implicit_key);
+  const auto* indices_pair = x.IndicesPairs(implicit_key + "_indices");
+  if (rulebook_pair == nullptr || indices_pair == nullptr) {
+    return false;
+  }
+  const DenseTensor& indices = x.non_zero_indices();
+  const DenseTensor& cached_indices = indices_pair->first;
+  if (indices.dims() != cached_indices.dims() ||
+      indices.dtype() != cached_indices.dtype()) {
+    return false;
+  }
+  if (indices.Holder() == cached_indices.Holder() &&
+      indices.offset() == cached_indices.offset()) {
+    return true;
+  }
+  const IntT* indices_ptr = indices.data<IntT>();
+#ifdef PADDLE_WITH_HIP
+  const auto& exec_policy = thrust::hip::par.on(dev_ctx.stream());
+#else
+  phi::memory_utils::ThrustAllocator<cudaStream_t> allocator(dev_ctx.GetPlace(),
+                                                             dev_ctx.stream());
+  const auto& exec_policy = thrust::cuda::par(allocator).on(dev_ctx.stream());
+#endif
+  return thrust::equal(exec_policy,
+                       indices_ptr,
+                       indices_ptr + indices.numel(),
+                       cached_indices.data<IntT>());
+}
+
 template <typename T, typename IntT>
 void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
                         const SparseCooTensor& x,
@@ -147,6 +221,34 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
         &rulebook_len,
         &need_product_rulebook);
   }
+  std::string implicit_key;
+  if (subm && key.empty()) {
+    implicit_key = ImplicitSubmKey(
+        x_dims, kernel_dims, subm_paddings, dilations, subm_strides);
+    if (HasCachedSubmRulebook<IntT>(dev_ctx, x, implicit_key)) {
+      VLOG(6) << "Reuse the cached rulebook of " << implicit_key;
+      rulebook_ptr = phi::funcs::sparse::PrepareSubm<T, IntT, GPUContext>(
+          dev_ctx,
+          x,
+          implicit_key,
+          out_dims,
+          out,
+          h_counter.data<int>(),
+          h_offsets.data<int>(),
+          &rulebook_len,
+          &need_product_rulebook);
+      // The rulebook and counter are still outputs for the backward without
+      // a key.
+      phi::funcs::sparse::SaveToTable(dev_ctx,
+                                      x,
+                                      key,
+                                      x.IndicesPairs(implicit_key)->first,
+                                      h_counter,
+                                      out,
+                                      rulebook,
+                                      counter);
+    }
+  }
 
   if (need_product_rulebook) {
     DenseTensor tmp_rulebook;
@@ -170,6 +272,13 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
 
     phi::funcs::sparse::SaveToTable(
         dev_ctx, x, key, tmp_rulebook, h_counter, out, rulebook, counter);
+    if (!implicit_key.empty()) {
+      out->SaveIndicesPairs(implicit_key,
+                            std::make_pair(tmp_rulebook, h_counter));
+      out->SaveIndicesPairs(implicit_key + "_indices",
+                            std::make_pair(out->non_zero_indices(),
+                                           DenseTensor()));
+    }
   }
 
 #if defined(PADDLE_WITH_CUTLASS) && SPCONV_WITH_CUTLASS
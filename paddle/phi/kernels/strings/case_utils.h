@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #pragma once
+#include <cstring>
 #include <string>
 
 #include "paddle/phi/common/pstring.h"
@@ -28,20 +29,82 @@ namespace phi {
 namespace strings {
 
 using pstring = dtype::pstring;
+
+// The SWAR (SIMD within a register) helpers convert the case of 8 bytes at
+// once. Only the bytes of ASCII letters change, the bytes of the multi-byte
+// UTF-8 characters have the high bit set and are kept as they are.
+constexpr uint64_t kEachByte = 0x0101010101010101ULL;
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+// The high bit of each byte in [lo, hi] of the ASCII bytes of the word.
+HOSTDEVICE inline uint64_t AsciiRangeMask(uint64_t word, char lo, char hi) {
+  uint64_t heptets = word & ~kHighBits;
+  uint64_t above_hi = heptets + (0x7F - static_cast<uint64_t>(hi)) * kEachByte;
+  uint64_t from_lo = heptets + (0x80 - static_cast<uint64_t>(lo)) * kEachByte;
+  return ~word & (from_lo ^ above_hi) & kHighBits;
+}
+
+HOSTDEVICE inline bool IsAsciiWord(uint64_t word) {
+  return (word & kHighBits) == 0;
+}
+
 struct AsciiToLower {
   HOSTDEVICE char operator()(char in) const {
     return ('A' <= in && in <= 'Z') ? in - ('Z' - 'z') : in;
   }
+
+  HOSTDEVICE uint64_t ConvertWord(uint64_t word) const {
+    return word | (AsciiRangeMask(word, 'A', 'Z') >> 2);
+  }
 };
 
 struct AsciiToUpper {
   HOSTDEVICE char operator()(char in) const {
     return ('a' <= in && in <= 'z') ? in ^ 0x20 : in;
   }
+
+  HOSTDEVICE uint64_t ConvertWord(uint64_t word) const {
+    return word ^ (AsciiRangeMask(word, 'a', 'z') >> 2);
+  }
 };
 
+// Convert the ASCII letters of [in, in + len) into out, 8 bytes at a time.
+// in and out may be the same.
+template <typename CharConverter>
+HOSTDEVICE inline void ConvertAsciiCase(const char* in,
+                                        char* out,
+                                        size_t len,
+                                        CharConverter converter) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, in + i, sizeof(uint64_t));
+    word = converter.ConvertWord(word);
+    memcpy(out + i, &word, sizeof(uint64_t));
+  }
+  for (; i < len; ++i) {
+    out[i] = converter(in[i]);
+  }
+}
+
+HOSTDEVICE inline bool IsAsciiStr(const char* str, size_t len) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, str + i, sizeof(uint64_t));
+    if (!IsAsciiWord(word)) return false;
+  }
+  for (; i < len; ++i) {
+    if (static_cast<unsigned char>(str[i]) & 0x80) return false;
+  }
+  return true;
+}
+
 template <typename Context>
 struct UTF8ToLower {
+  // converts the strings without multi-byte characters
+  using AsciiConverter = AsciiToLower;
+
   HOSTDEVICE UTF8ToLower(const uint8_t* unicode_flag_map,
                          const uint16_t* cases_map)
       : unicode_flag_map_(unicode_flag_map), cases_map_(cases_map) {}
@@ -57,6 +120,9 @@ struct UTF8ToLower {
 
 template <typename Context>
 struct UTF8ToUpper {
+  // converts the strings without multi-byte characters
+  using AsciiConverter = AsciiToUpper;
+
   HOSTDEVICE UTF8ToUpper(const uint8_t* unicode_flag_map,
                          const uint16_t* cases_map)
       : unicode_flag_map_(unicode_flag_map), cases_map_(cases_map) {}
@@ -27,11 +27,8 @@ __global__ void StringCaseConvertCUDAKernel(pstring* out,
                                             size_t num) {
   CUDA_KERNEL_LOOP(i, num) {
     out[i] = pstring(in[i]);
-    thrust::transform(thrust::device,
-                      in[i].begin(),
-                      in[i].end(),
-                      out[i].mdata(),
-                      CharConverter());
+    ConvertAsciiCase(
+        in[i].data(), out[i].mdata(), in[i].size(), CharConverter());
   }
 }
 
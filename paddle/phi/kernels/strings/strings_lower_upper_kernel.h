@@ -86,8 +86,9 @@ struct AsciiCaseConverter {
                   pstring* out,
                   size_t num) const {
     for (size_t i = 0; i < num; ++i) {
-      std::transform(
-          in[i].begin(), in[i].end(), out[i].mdata(), CharConverter());
+      out[i].resize_uninitialized(in[i].size());
+      ConvertAsciiCase(
+          in[i].data(), out[i].mdata(), in[i].size(), CharConverter());
     }
   }
 };
@@ -103,6 +104,16 @@ struct UTF8CaseConverter {
     auto unicode_flag_map = GetUniFlagMap();
     auto cases_map = GetCharCasesMap();
     for (size_t i = 0; i < num; ++i) {
+      // the cases of ASCII characters are the same in UTF-8
+      if (IsAsciiStr(in[i].data(), in[i].size())) {
+        out[i].resize_uninitialized(in[i].size());
+        ConvertAsciiCase(
+            in[i].data(),
+            out[i].mdata(),
+            in[i].size(),
+            typename CharConverter<DeviceContext>::AsciiConverter());
+        continue;
+      }
       uint32_t unicode_len = GetUnicodeStrLen(in[i].data(), in[i].size());
       std::vector<uint32_t> unicode_in(unicode_len, 0);
       GetUnicodeStr(in[i].data(), unicode_in.data(), unicode_len);
@@ -55,6 +55,13 @@ using InsertionPoint = std::pair<Block *, Block::Iterator>;
 ///
 class Builder {
  public:
+  /// Observes the operations inserted by a builder.
+  class Listener {
+   public:
+    virtual ~Listener() = default;
+    virtual void NotifyOperationInserted(Operation *op) = 0;
+  };
+
   Builder(IrContext *context,
           Block *block,
           Block::Iterator insertion_point,
@@ -118,6 +125,9 @@ class Builder {
 
   const InsertionPoint &insertion_point() const { return insertion_point_; }
 
+  /// Set the listener notified of the inserted operations, nullptr for none.
+  void set_listener(Listener *listener) { listener_ = listener; }
+
   /// Creates an operation given the fields represented as an OperationState.
   IR_API Operation *Build(OperationArgument &&argument);
 
@@ -165,6 +175,8 @@ class Builder {
   InsertionPoint insertion_point_;
 
   bool forbid_insert_without_position_;
+
+  Listener *listener_{nullptr};
 };
 
 template <typename OpTy, typename... Args>
@@ -201,6 +201,14 @@ class IR_API PatternRewritePass : public Pass {
                      const std::vector<std::string>& dependents = {})
       : Pass(name, opt_level, dependents) {}
 
+  // Build the patterns and the config of the pass out of the pass manager,
+  // e.g. to run them with the patterns of other passes in one traversal.
+  RewritePatternSet BuildPatterns(IrContext* context) {
+    return InitializePatterns(context);
+  }
+
+  GreedyRewriteConfig BuildConfig() { return InitializeConfig(); }
+
  protected:
   virtual RewritePatternSet InitializePatterns(IrContext* context) = 0;
 
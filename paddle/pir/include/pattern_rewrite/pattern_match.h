@@ -291,7 +291,10 @@ class RewriterBase : public Builder {
                     std::function<bool(OpOperand&)> functor);
 
  protected:
-  explicit RewriterBase(IrContext* ctx) : Builder(ctx) {}
+  explicit RewriterBase(IrContext* ctx)
+      : Builder(ctx), insertion_listener_(this) {
+    set_listener(&insertion_listener_);
+  }
 
   virtual ~RewriterBase();
 
@@ -316,10 +319,26 @@ class RewriterBase : public Builder {
   }
 
  private:
+  // Forwards the operations inserted by this builder to
+  // NotifyOperationInserted.
+  class InsertionListener : public Builder::Listener {
+   public:
+    explicit InsertionListener(RewriterBase* rewriter) : rewriter_(rewriter) {}
+
+    void NotifyOperationInserted(Operation* op) override {
+      rewriter_->NotifyOperationInserted(op);
+    }
+
+   private:
+    RewriterBase* rewriter_;
+  };
+
   void operator=(const RewriterBase&) = delete;
   RewriterBase(const RewriterBase&) = delete;
 
   void ReplaceOpWithResultsOfAnotherOp(Operation* op, Operation* new_op);
+
+  InsertionListener insertion_listener_;
 };
 
 class PatternRewriter : public RewriterBase {
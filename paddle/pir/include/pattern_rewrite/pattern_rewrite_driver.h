@@ -57,6 +57,14 @@ class IR_API GreedyRewriteConfig {
   /// - ExistingOps: only pre-existing ops are added to the worklist.
   GreedyRewriteStrictness strict_mode = GreedyRewriteStrictness::AnyOp;
 
+  /// Scan the region only once, and then only revisit the ops touched by the
+  /// rewrites: the users of replaced ops, the ops updated in place or
+  /// inserted, and the producers of the operands of erased ops. Otherwise the
+  /// whole region is scanned again after every iteration with rewrites.
+  /// This requires the patterns to change the IR only through the rewriter,
+  /// and `max_iterations` bounds the number of rewrites per op on average.
+  bool incremental = false;
+
   static constexpr int64_t kNoLimit = -1;
 };
 
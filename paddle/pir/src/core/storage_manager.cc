@@ -15,6 +15,7 @@
 #include "paddle/pir/include/core/storage_manager.h"
 
 #include <glog/logging.h>
+#include <array>
 #include <memory>
 #include <unordered_map>
 
@@ -23,6 +24,10 @@
 namespace pir {
 // This is a structure for creating, caching, and looking up Storage of
 // parametric types.
+//
+// The instances are split into shards by their hash values, each with its own
+// lock, so that threads building programs at the same time, such as when
+// translating several programs, rarely wait for each other.
 struct ParametricStorageManager {
   using StorageBase = StorageManager::StorageBase;
 
@@ -30,10 +35,12 @@ struct ParametricStorageManager {
       : destroy_(destroy) {}
 
   ~ParametricStorageManager() {  // NOLINT
-    for (const auto &instance : parametric_instances_) {
-      destroy_(instance.second);
+    for (auto &shard : shards_) {
+      for (const auto &instance : shard.instances) {
+        destroy_(instance.second);
+      }
+      shard.instances.clear();
     }
-    parametric_instances_.clear();
   }
 
   // Get the storage of parametric type, if not in the cache, create and
@@ -41,20 +48,18 @@ struct ParametricStorageManager {
   StorageBase *GetOrCreate(std::size_t hash_value,
                            std::function<bool(StorageBase *)> equal_func,
                            std::function<StorageBase *()> constructor) {
-    if (parametric_instances_.count(hash_value) != 0) {
-      auto pr = parametric_instances_.equal_range(hash_value);
-      while (pr.first != pr.second) {
-        if (equal_func(pr.first->second)) {
-          VLOG(10) << "Found a cached parametric storage of: [param_hash="
-                   << hash_value << ", storage_ptr=" << pr.first->second
-                   << "].";
-          return pr.first->second;
-        }
-        ++pr.first;
+    Shard &shard = shards_[hash_value % kNumShards];
+    std::lock_guard<pir::SpinLock> guard(shard.lock);
+    auto pr = shard.instances.equal_range(hash_value);
+    for (; pr.first != pr.second; ++pr.first) {
+      if (equal_func(pr.first->second)) {
+        VLOG(10) << "Found a cached parametric storage of: [param_hash="
+                 << hash_value << ", storage_ptr=" << pr.first->second << "].";
+        return pr.first->second;
       }
     }
     StorageBase *storage = constructor();
-    parametric_instances_.emplace(hash_value, storage);
+    shard.instances.emplace(hash_value, storage);
     VLOG(10) << "No cache found, construct and cache a new parametric storage "
                 "of: [param_hash="
              << hash_value << ", storage_ptr=" << storage << "].";
@@ -62,9 +67,16 @@ struct ParametricStorageManager {
   }
 
  private:
-  // In order to prevent hash conflicts, the unordered_multimap data structure
-  // is used for storage.
-  std::unordered_multimap<size_t, StorageBase *> parametric_instances_;
+  static constexpr std::size_t kNumShards = 16;
+
+  struct Shard {
+    pir::SpinLock lock;
+    // In order to prevent hash conflicts, the unordered_multimap data
+    // structure is used for storage.
+    std::unordered_multimap<size_t, StorageBase *> instances;
+  };
+
+  std::array<Shard, kNumShards> shards_;
   std::function<void(StorageBase *)> destroy_;
 };
 
@@ -77,15 +89,21 @@ StorageManager::StorageBase *StorageManager::GetParametricStorageImpl(
     std::size_t hash_value,
     std::function<bool(const StorageBase *)> equal_func,
     std::function<StorageBase *()> constructor) {
-  std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
   VLOG(10) << "Try to get a parametric storage of: [TypeId_hash="
            << std::hash<pir::TypeId>()(type_id) << ", param_hash=" << hash_value
            << "].";
-  if (parametric_instance_.find(type_id) == parametric_instance_.end()) {
-    IR_THROW("The input data pointer is null.");
+  ParametricStorageManager *parametric_storage = nullptr;
+  {
+    // Only the lookup of the manager of the type is serialized, the manager
+    // locks the shard of the hash value by itself.
+    std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
+    auto iter = parametric_instance_.find(type_id);
+    if (iter == parametric_instance_.end()) {
+      IR_THROW("The input data pointer is null.");
+    }
+    parametric_storage = iter->second.get();
   }
-  ParametricStorageManager &parametric_storage = *parametric_instance_[type_id];
-  return parametric_storage.GetOrCreate(hash_value, equal_func, constructor);
+  return parametric_storage->GetOrCreate(hash_value, equal_func, constructor);
 }
 
 StorageManager::StorageBase *StorageManager::GetParameterlessStorageImpl(
@@ -79,6 +79,9 @@ class PassTimer : public PassInstrumentation {
 
   void RunAfterPass(Pass* pass, Operation* op) override {
     pass_timers_[op][pass->name()].Stop();
+    if (pass->Has("__match_count__")) {
+      rewrite_counts_[op][pass->name()] = pass->Get<int64_t>("__match_count__");
+    }
   }
 
  private:
@@ -90,8 +93,9 @@ class PassTimer : public PassInstrumentation {
 
     os << "  Total Execution Time: " << std::fixed << std::setprecision(3)
        << pipeline_timers_[op].GetTimePerSecond() << " seconds\n\n";
-    os << "  ----Walk Time----  ----Name----\n";
+    os << "  ----Walk Time----  ---Rewrites---  ----Name----\n";
 
+    auto& counts = rewrite_counts_[op];
     auto& map = pass_timers_[op];
     std::vector<std::pair<std::string, Timer>> pairs(map.begin(), map.end());
     std::sort(pairs.begin(),
@@ -109,6 +113,8 @@ class PassTimer : public PassInstrumentation {
          << 100 * v.second.GetTimePerSecond() /
                 pipeline_timers_[op].GetTimePerSecond()
          << "%)"
+         << "  " << std::setw(14)
+         << (counts.count(v.first) ? std::to_string(counts.at(v.first)) : "-")
          << "  " << v.first << "\n";
     }
   }
@@ -121,6 +127,11 @@ class PassTimer : public PassInstrumentation {
   std::unordered_map<Operation*,
                      std::unordered_map<std::string /*pass name*/, Timer>>
       pass_timers_;
+
+  // The number of rewrites reported by the passes through AddStatistics.
+  std::unordered_map<Operation*,
+                     std::unordered_map<std::string /*pass name*/, int64_t>>
+      rewrite_counts_;
 };
 
 void PassManager::EnablePassTiming(bool print_module) {
@@ -56,6 +56,9 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   }
 
   std::pair<bool, int64_t> Simplify() {
+    if (config_.incremental) {
+      return SimplifyIncrementally();
+    }
     int64_t sum_num_rewrites = 0;
     int64_t num_rewrites = 0;
     int64_t iteration = 0;
@@ -65,24 +68,8 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
           config_.max_iterations != pir::GreedyRewriteConfig::kNoLimit)
         break;
       VLOG(6) << "Iteration[" << iteration << "] for PatternRewrite";
-      worklist_.clear();
-      worklist_map_.clear();
-
-      for (auto& block_item : region_) {
-        for (auto& op_item : block_item) {
-          worklist_.push_back(&op_item);
-        }
-      }
-      if (config_.use_top_down_traversal) {
-        // Reverse the list so out pop-back loop process them in-order.
-        std::reverse(worklist_.begin(), worklist_.end());
-      }
-      for (size_t i = 0; i < worklist_.size(); ++i) {
-        worklist_map_[worklist_[i]] = i;
-        VLOG(6) << "worklist[" << i << "] is " << worklist_[i]->name();
-      }
-
-      num_rewrites = ProcessWorklist();
+      PopulateWorklist();
+      num_rewrites = ProcessWorklist(config_.max_num_rewrites);
       sum_num_rewrites += num_rewrites;
     } while (num_rewrites != 0);
     bool converged = num_rewrites == 0;
@@ -90,13 +77,53 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   }
 
  private:
-  /// Process ops until the worklist is empty or `config.max_num_rewrites`
-  /// is reached. Return `true` if any IR was changed.
-  int64_t ProcessWorklist() {
+  /// Scan the region once and process the worklist until it is empty, with
+  /// the ops touched by the rewrites added back to the worklist.
+  std::pair<bool, int64_t> SimplifyIncrementally() {
+    PopulateWorklist();
+    int64_t max_num_rewrites = config_.max_num_rewrites;
+    if (config_.max_iterations != pir::GreedyRewriteConfig::kNoLimit) {
+      int64_t limit = std::max<int64_t>(config_.max_iterations, 1) *
+                      std::max<int64_t>(worklist_.size(), 1);
+      if (max_num_rewrites == pir::GreedyRewriteConfig::kNoLimit ||
+          limit < max_num_rewrites) {
+        max_num_rewrites = limit;
+      }
+    }
+    int64_t num_rewrites = ProcessWorklist(max_num_rewrites);
+    bool converged = worklist_map_.empty();
+    VLOG(6) << "Incremental PatternRewrite: " << num_rewrites
+            << " rewrites, converged: " << converged;
+    return std::make_pair(converged, num_rewrites);
+  }
+
+  /// Reset the worklist to all the ops of the region.
+  void PopulateWorklist() {
+    worklist_.clear();
+    worklist_map_.clear();
+
+    for (auto& block_item : region_) {
+      for (auto& op_item : block_item) {
+        worklist_.push_back(&op_item);
+      }
+    }
+    if (config_.use_top_down_traversal) {
+      // Reverse the list so out pop-back loop process them in-order.
+      std::reverse(worklist_.begin(), worklist_.end());
+    }
+    for (size_t i = 0; i < worklist_.size(); ++i) {
+      worklist_map_[worklist_[i]] = i;
+      VLOG(6) << "worklist[" << i << "] is " << worklist_[i]->name();
+    }
+  }
+
+  /// Process ops until the worklist is empty or `max_num_rewrites` is
+  /// reached. Return the number of rewrites.
+  int64_t ProcessWorklist(int64_t max_num_rewrites) {
     int64_t num_rewrites = 0;
     while (!worklist_.empty() &&
-           (num_rewrites < config_.max_num_rewrites ||
-            config_.max_num_rewrites == pir::GreedyRewriteConfig::kNoLimit)) {
+           (num_rewrites < max_num_rewrites ||
+            max_num_rewrites == pir::GreedyRewriteConfig::kNoLimit)) {
       auto* op = PopFromWorklist();
       if (op == nullptr) continue;
       VLOG(6) << "PopFromWorklist, get op: " << op->name();
@@ -151,6 +178,8 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   }
 
   void NotifyOperationInserted(pir::Operation* op) override {
+    // The new ops are visited by the next scan of the region otherwise.
+    if (!config_.incremental) return;
     if (config_.strict_mode == pir::GreedyRewriteStrictness::ExistingAndNewOps)
       strict_mode_filtered_ops_.insert(op);
     AddToWorklist(op);
@@ -697,4 +697,7 @@ def disable_tensor_checker():
             >>> #      return _C_ops.elementwise_pow(x, y)
 
     """
+    # the deferred checks of the GPU tensors are copied back once per step
+    if paddle.get_flags("FLAGS_check_nan_inf")["FLAGS_check_nan_inf"]:
+        paddle.base.core.check_deferred_nan_inf()
     paddle.set_flags({"FLAGS_check_nan_inf": 0})
@@ -23,6 +23,7 @@ from . import (  # noqa: F401
     backward_mode,
     ir_backward,
 )
+from .activation_offload import offload_activations
 from .autograd import hessian, jacobian
 from .backward_mode import backward
 from .py_layer import PyLayer, PyLayerContext
@@ -35,4 +36,5 @@ __all__ = [
     'PyLayer',
     'PyLayerContext',
     'saved_tensors_hooks',
+    'offload_activations',
 ]
@@ -0,0 +1,71 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle.base import core
+
+__all__ = []
+
+# the min_bytes of the enclosing offload_activations
+_min_bytes_stack = []
+
+
+class offload_activations:
+    """
+    Dynamic graph, offloads the activations saved for backward by the
+    operators run in its scope to pinned host memory, so that their GPU
+    memory is freed until the backward. The backward copies them back ahead
+    of the gradient nodes using them, on a stream of its own, see
+    ``FLAGS_eager_activation_offload_prefetch_depth``. It trades the memory
+    of recompute for PCIe traffic instead of FLOPs.
+
+    Only the GPU tensors of at least ``min_bytes`` saved by the generated
+    gradient nodes are offloaded, the leaf tensors such as parameters are
+    not. It is not applied while ``paddle.autograd.saved_tensors_hooks`` is
+    active, and does nothing in the builds without CUDA or ROCm.
+
+    Parameters:
+        min_bytes (int, optional): The minimum size of the offloaded
+            tensors in bytes. Default is 1MB.
+
+    Returns:
+        None
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> paddle.device.set_device('gpu')
+
+            >>> x = paddle.randn([1024, 1024])
+            >>> x.stop_gradient = False
+            >>> with paddle.autograd.offload_activations():
+            ...     y = paddle.nn.functional.relu(paddle.matmul(x, x))
+            ...     z = paddle.tanh(y)
+            >>> z.sum().backward()
+    """
+
+    def __init__(self, min_bytes=1 << 20):
+        self.min_bytes = min_bytes
+
+    def __enter__(self):
+        core.eager.enable_activation_offload(self.min_bytes)
+        _min_bytes_stack.append(self.min_bytes)
+
+    def __exit__(self, *args):
+        _min_bytes_stack.pop()
+        if _min_bytes_stack:
+            core.eager.enable_activation_offload(_min_bytes_stack[-1])
+        else:
+            core.eager.disable_activation_offload()
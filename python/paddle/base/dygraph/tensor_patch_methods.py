@@ -966,6 +966,51 @@ def monkey_patch_tensor():
             array = array.astype(dtype)
         return array
 
+    def __dlpack__(self, stream=None):
+        """
+        Exports the Tensor as a DLPack capsule without copying, with its
+        strides, for the ``from_dlpack`` of other frameworks.
+
+        Args:
+            stream (int|None, optional): The CUDA stream of the consumer. It
+                waits for the work enqueued to the current stream of the
+                Tensor with an event, instead of a device synchronization.
+                None means the legacy default stream, -1 means no
+                synchronization. It is ignored on CPU. Default: None.
+
+        Returns:
+            PyCapsule, the DLPack capsule.
+
+        Examples:
+            .. code-block:: python
+
+                >>> import paddle
+                >>> x = paddle.to_tensor([1.0, 2.0, 3.0])
+                >>> capsule = x.__dlpack__()
+                >>> y = paddle.utils.dlpack.from_dlpack(capsule)
+        """
+        tensor = self.value().get_tensor()
+        if self.place.is_gpu_place():
+            core._dlpack_wait_stream(tensor, 1 if stream is None else stream)
+        return tensor._to_dlpack()
+
+    def __dlpack_device__(self):
+        """
+        Returns the DLPack device type and device id of the Tensor.
+
+        Returns:
+            tuple, (device_type, device_id), where device_type is 1 for CPU,
+            2 for GPU and 3 for pinned memory.
+        """
+        place = self.place
+        if place.is_gpu_place():
+            return (2, place.gpu_device_id())
+        if place.is_cuda_pinned_place():
+            return (3, 0)
+        if place.is_cpu_place():
+            return (1, 0)
+        raise ValueError(f"DLPack does not support the place {place}.")
+
     def pre_deal_index(self, item):
         # since in pybind there is no efficiency way to transfer Py_Tuple/Py_List/Py_Range to Tensor
         # we call this function in python level.
@@ -1236,6 +1281,8 @@ def monkey_patch_tensor():
         ("__deepcopy__", __deepcopy__),
         ("__module__", "paddle"),
         ("__array__", __array__),
+        ("__dlpack__", __dlpack__),
+        ("__dlpack_device__", __dlpack_device__),
         ("__getitem__", __getitem__),
         ("item", item),
         ("__setitem__", __setitem__),
@@ -2691,7 +2691,7 @@ class Executor:
         nrank = len(trainer_endpoints)
 
         assert 'scheduler' in fleet_opt or 'tasks' in fleet_opt, (
-            "Fleet executor need configuration for scheduler, you can choose from 1F1B or Origin. "
+            "Fleet executor need configuration for scheduler, you can choose from 1F1B, ZBH1 or Origin. "
             "Or you can provide a list of task nodes to init fleet executor directly."
         )
         if 'tasks' in fleet_opt:
@@ -2704,7 +2704,7 @@ class Executor:
             task_id_to_rank = fleet_opt['task_id_to_rank']
         else:
             scheduler = fleet_opt['scheduler']
-            if scheduler == '1F1B':
+            if scheduler in ('1F1B', 'ZBH1'):
                 from paddle.distributed.fleet.fleet_executor_utils import (
                     run1f1b,
                 )
@@ -2714,7 +2714,10 @@ class Executor:
                     or "pp_degree" not in fleet_opt["dist_strategy"]
                     or fleet_opt["dist_strategy"]["pp_degree"] == 1
                 ):
-                    warnings.warn("Using 1F1B scheduler with pp_degree == 1.")
+                    warnings.warn(
+                        f"Using {scheduler} scheduler with pp_degree == 1."
+                    )
+                # ZBH1 runs the weight grad in the bubbles of 1F1B
                 tasks, task_id_to_rank = run1f1b(
                     program,
                     cur_rank,
@@ -2722,6 +2725,7 @@ class Executor:
                     fleet_opt.get('dist_strategy', {}),
                     nrank,
                     with_standalone_executor,
+                    split_backward=scheduler == 'ZBH1',
                 )
             elif scheduler == 'Origin':
                 from paddle.distributed.fleet.fleet_executor_utils import origin
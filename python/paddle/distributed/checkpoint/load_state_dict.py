@@ -294,6 +294,34 @@ def not_overlap(
     return False
 
 
+def get_cur_chunk_metadata(val):
+    """
+    Get the location of the local tensor of current rank in the global tensor, None if current rank does not hold val.
+    """
+    if val.is_dist():
+        # when val is scalar, the shape is []
+        (
+            local_shape,
+            global_offset,
+        ) = (
+            compute_local_shape_and_global_offset(
+                val.shape,
+                val.process_mesh,
+                val.placements,
+            )
+            if len(val.shape) > 0
+            else ((), ())
+        )
+        if local_shape is None or global_offset is None:
+            return None
+    else:
+        local_shape = tuple(val.shape)
+        global_offset = (
+            tuple([0] * len(val.shape)) if len(val.shape) > 0 else ()
+        )
+    return LocalTensorMetadata(global_offset, local_shape)
+
+
 def get_read_items(path, state_dict, process_group, use_dist):
     storage_state_dict_metadata = {}
     metadata_files, _ = get_checkpoint_files(path)
@@ -310,28 +338,9 @@ def get_read_items(path, state_dict, process_group, use_dist):
     logger.debug(f"storage_state_dict_metadata:{storage_state_dict_metadata}")
     for tensor_key, val in state_dict.items():
         if isinstance(val, paddle.Tensor):
-            if val.is_dist():
-                # when val is scalar, the shape is []
-                (
-                    local_shape,
-                    global_offset,
-                ) = (
-                    compute_local_shape_and_global_offset(
-                        val.shape,
-                        val.process_mesh,
-                        val.placements,
-                    )
-                    if len(val.shape) > 0
-                    else ((), ())
-                )
-                if local_shape is None or global_offset is None:
-                    continue
-            else:
-                local_shape = tuple(val.shape)
-                global_offset = (
-                    tuple([0] * len(val.shape)) if len(val.shape) > 0 else ()
-                )
-            cur_chunk_metadata = LocalTensorMetadata(global_offset, local_shape)
+            cur_chunk_metadata = get_cur_chunk_metadata(val)
+            if cur_chunk_metadata is None:
+                continue
             assert (
                 tensor_key in storage_state_dict_metadata
             ), f"tensor_key:{tensor_key} not found in storage_state_dict_metadata:{storage_state_dict_metadata}."
@@ -374,11 +383,105 @@ def get_read_items(path, state_dict, process_group, use_dist):
     return global_read_items
 
 
+def is_raw_storage(path):
+    metadata_files, _ = get_checkpoint_files(path)
+    for metadata_file in metadata_files:
+        metadata = paddle.load(os.path.join(path, metadata_file))
+        if getattr(metadata, "storage_layout", None) is None:
+            return False
+    return True
+
+
+def load_raw_state_dict(path, state_dict, num_threads):
+    """
+    Load the state_dict saved with raw_storage=True. Every rank reads the slices of the data files overlapping its own local tensors by range reads, in num_threads threads, so that no data file is loaded as a whole and no tensor is broadcast among the ranks, whatever the meshes and placements of the saved and the loading tensors are.
+
+    Returns:
+        Set[str]: The keys of state_dict not found in the checkpoint.
+    """
+    storage_state_dict_metadata = {}
+    storage_metadata = {}
+    storage_layout = {}
+    metadata_files, _ = get_checkpoint_files(path)
+    for metadata_file in metadata_files:
+        metadata = paddle.load(os.path.join(path, metadata_file))
+        for (
+            tensor_key,
+            local_tensor_metadata,
+        ) in metadata.state_dict_metadata.items():
+            if tensor_key not in storage_state_dict_metadata:
+                storage_state_dict_metadata[tensor_key] = []
+            storage_state_dict_metadata[tensor_key] += local_tensor_metadata
+        storage_metadata.update(metadata.storage_metadata)
+        storage_layout.update(metadata.storage_layout)
+
+    missing_keys = set(state_dict.keys()) - set(
+        storage_state_dict_metadata.keys()
+    )
+    read_items = []
+    # the local tensors not on CPU are read into a CPU buffer first
+    buffers = []
+    for tensor_key, val in state_dict.items():
+        if tensor_key in missing_keys:
+            continue
+        cur_chunk_metadata = get_cur_chunk_metadata(val)
+        if cur_chunk_metadata is None:
+            continue
+        cur_local_tensor = val._local_value() if val.is_dist() else val
+        if cur_local_tensor.place.is_cpu_place():
+            dst_tensor = cur_local_tensor
+        else:
+            with paddle.base.framework._dygraph_place_guard(paddle.CPUPlace()):
+                dst_tensor = paddle.empty(
+                    cur_local_tensor.shape, dtype=cur_local_tensor.dtype
+                )
+            buffers.append((dst_tensor, cur_local_tensor))
+        for storage_local_tensor_metadata in storage_state_dict_metadata[
+            tensor_key
+        ]:
+            if not_overlap(cur_chunk_metadata, storage_local_tensor_metadata):
+                continue
+            cur_offsets, storage_offsets, lengths = compute_overlap(
+                cur_chunk_metadata, storage_local_tensor_metadata
+            )
+            storage_local_tensor_index = LocalTensorIndex(
+                tensor_key, tuple(storage_local_tensor_metadata.global_offset)
+            )
+            file_name = storage_metadata[storage_local_tensor_index]
+            byte_offset, dtype = storage_layout[storage_local_tensor_index]
+            assert dtype == str(
+                val.dtype
+            ), f"The dtype:{val.dtype} of {tensor_key} mismatches the dtype:{dtype} in the checkpoint."
+            file_path = os.path.join(path, file_name)
+            assert os.path.exists(
+                file_path
+            ), f"The data file:{file_path} saved as raw bytes should be accessible to every rank."
+            read_items.append(
+                (
+                    file_path,
+                    byte_offset,
+                    list(storage_local_tensor_metadata.local_shape),
+                    storage_offsets,
+                    lengths,
+                    dst_tensor,
+                    cur_offsets,
+                )
+            )
+    logger.debug(f"read {len(read_items)} slices of the raw checkpoint")
+    paddle.base.core.read_checkpoint_slices(read_items, num_threads)
+    for buffer, cur_local_tensor in buffers:
+        paddle.assign(
+            buffer._copy_to(cur_local_tensor.place, True), cur_local_tensor
+        )
+    return missing_keys
+
+
 def load_state_dict(
     state_dict,
     path,
     process_group=None,
     coordinator_rank=0,
+    num_threads=4,
 ) -> None:
     """
     Load the state_dict inplace from a checkpoint path.
@@ -388,6 +491,7 @@ def load_state_dict(
         path(str): The directory to load checkpoint files.
         process_group(paddle.distributed.collective.Group): ProcessGroup to be used for cross-rank synchronization. Use the default process group which contains all cards.
         coordinator_rank(int): The rank used to coordinate the checkpoint. Rank0 is used by default.
+        num_threads(int): The number of threads every rank reads the checkpoint saved with raw_storage=True in. 4 is used by default.
 
     Example:
         .. code-block:: python
@@ -434,6 +538,16 @@ def load_state_dict(
             # sync to avoid some ranks not write path yet
             paddle.distributed.barrier(process_group)
 
+        if is_raw_storage(path):
+            missing_keys = load_raw_state_dict(
+                path, flat_state_dict, num_threads
+            )
+            if len(missing_keys) > 0:
+                logger.warning(
+                    f"The following keys:{missing_keys} are not found in checkpoint path: {path}."
+                )
+            return
+
         rank_to_files, missing_keys = get_rank_to_files(
             path, flat_state_dict, process_group, use_dist
         )
@@ -41,3 +41,6 @@ class Metadata:
     state_dict_metadata: Dict[str, List[LocalTensorMetadata]] = None
     storage_metadata: Dict[LocalTensorIndex, str] = None
     flat_mapping: Dict[str, Tuple[str]] = None
+    # The byte offset and dtype of the local tensors in the data files saved
+    # as raw bytes, None for the data files saved by paddle.save.
+    storage_layout: Dict[LocalTensorIndex, Tuple[int, str]] = None
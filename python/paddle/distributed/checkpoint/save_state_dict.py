@@ -24,6 +24,8 @@ from .utils import (
     flatten_state_dict,
 )
 
+RAW_STORAGE_ALIGNMENT = 64
+
 
 def check_state_dict(state_dict, process_group):
     local_keys = list(state_dict.keys())
@@ -101,11 +103,44 @@ def dedup_tensor(
             local_state_dict.pop(tensor_index.tensor_key)
 
 
+def save_raw_state_dict(
+    local_state_dict, local_state_dict_metadata, file_path
+):
+    """
+    Save the local tensors as their raw bytes in row-major order, each aligned to RAW_STORAGE_ALIGNMENT bytes, so that any slice of them can be read by range reads of the file.
+
+    Args:
+        local_state_dict(Dict[str, paddle.Tensor]): The deduped local state_dict of current rank.
+        local_state_dict_metadata(Dict[str, LocalTensorMetadata]): The local tensor metadata of current rank.
+        file_path(str): The data file to save.
+
+    Returns:
+        Dict[LocalTensorIndex, Tuple[int, str]]: The byte offset and dtype of the local tensors in the file.
+    """
+    storage_layout = {}
+    offset = 0
+    with open(file_path, "wb") as f:
+        for key, local_tensor in local_state_dict.items():
+            padding = -offset % RAW_STORAGE_ALIGNMENT
+            f.write(b"\0" * padding)
+            offset += padding
+            data = local_tensor.numpy().tobytes()
+            f.write(data)
+            global_offset = local_state_dict_metadata[key].global_offset
+            storage_layout[LocalTensorIndex(key, tuple(global_offset))] = (
+                offset,
+                str(local_tensor.dtype),
+            )
+            offset += len(data)
+    return storage_layout
+
+
 def save_state_dict(
     state_dict,
     path,
     process_group=None,
     coordinator_rank=0,
+    raw_storage=False,
 ) -> None:
     """
     Save the state_dict of model to path.
@@ -115,6 +150,7 @@ def save_state_dict(
         path(str): The directory to save state_dict.
         process_group(paddle.distributed.collective.Group): ProcessGroup to be used for cross-rank synchronization. Use the default process group which contains all cards.
         coordinator_rank(int): The rank used to save non distributed values. Rank0 is used by default.
+        raw_storage(bool): Whether to save the local tensors as raw bytes, which lets every rank read only the slices it needs in load_state_dict. The checkpoint directory should be accessible to all the ranks that load it then. False is used by default.
 
     Examples:
         .. code-block:: python
@@ -231,11 +267,26 @@ def save_state_dict(
         )
         metadata.storage_metadata = dedup_key_in_dict(global_storage_metadata)
         metadata.flat_mapping = dedup_key_in_dict(global_flatten_mapping)
-        if coordinator_rank == paddle.distributed.get_rank():
-            logger.debug(f"metadata:{metadata}")
-            paddle.save(metadata, os.path.join(path, f"{unique_id}.metadata"))
         logger.debug(f"local_state_dict:{local_state_dict}")
         dedup_tensor(
             local_state_dict, local_storage_metadata, metadata.storage_metadata
         )
-        paddle.save(local_state_dict, os.path.join(path, file_name))
+        if raw_storage:
+            local_storage_layout = save_raw_state_dict(
+                local_state_dict,
+                local_state_dict_metadata,
+                os.path.join(path, file_name),
+            )
+            global_storage_layout = []
+            if use_dist:
+                paddle.distributed.all_gather_object(
+                    global_storage_layout, local_storage_layout, process_group
+                )
+            else:
+                global_storage_layout.append(local_storage_layout)
+            metadata.storage_layout = dedup_key_in_dict(global_storage_layout)
+        else:
+            paddle.save(local_state_dict, os.path.join(path, file_name))
+        if coordinator_rank == paddle.distributed.get_rank():
+            logger.debug(f"metadata:{metadata}")
+            paddle.save(metadata, os.path.join(path, f"{unique_id}.metadata"))
@@ -0,0 +1,72 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import contextlib
+
+from paddle import framework
+from paddle.distributed.communication.group import _get_global_group
+
+
+class _CoalescedTask:
+    def __init__(self):
+        self._task = None
+
+    def wait(self):
+        if self._task is not None:
+            self._task.wait()
+
+
+@contextlib.contextmanager
+def coalescing_manager(group=None):
+    """
+    Launch the asynchronous collectives issued in the context as one NCCL
+    group, with one stream synchronization and one task for all of them.
+
+    The collectives of the context should be called with ``sync_op=False`` on
+    the same place, and their tasks are only to be waited for after the
+    context exits, through the object it returns. Other backends than NCCL
+    launch the collectives one by one, their own tasks are to be waited for.
+
+    Args:
+        group (Group, optional): The group instance return by new_group or None for global
+            default group. Default: None.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env: DISTRIBUTED)
+            >>> import paddle
+            >>> import paddle.distributed as dist
+            >>> from paddle.distributed.communication.coalescing import coalescing_manager
+
+            >>> dist.init_parallel_env()
+            >>> tensors = [paddle.ones([4]) for _ in range(8)]
+            >>> with coalescing_manager() as work:
+            ...     for tensor in tensors:
+            ...         dist.all_reduce(tensor, sync_op=False)
+            >>> work.wait()
+    """
+    if not framework.in_dynamic_mode():
+        raise RuntimeError("coalescing_manager only supports dygraph mode.")
+    group = _get_global_group() if group is None else group
+    work = _CoalescedTask()
+    process_group = group.process_group
+    coalesce = group.backend == "NCCL"
+    if coalesce:
+        process_group.start_coalescing()
+    try:
+        yield work
+    finally:
+        if coalesce:
+            work._task = process_group.end_coalescing()
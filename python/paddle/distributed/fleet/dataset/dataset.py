@@ -619,7 +619,10 @@ class InMemoryDataset(DatasetBase):
         Set data_feed_desc
         """
         self.proto_desc.name = data_feed_type
-        if self.proto_desc.name == "SlotRecordInMemoryDataFeed":
+        if self.proto_desc.name in (
+            "SlotRecordInMemoryDataFeed",
+            "SlotRecordColumnarDataFeed",
+        ):
             self.dataset = core.Dataset("SlotRecordDataset")
 
     def _prepare_to_run(self):
@@ -229,14 +229,21 @@ class CoordSys:
 
 class FleetExecutorUtils:
     def __init__(
-        self, dist_strategy=None, rank=None, nrank=None, max_run_times=None
+        self,
+        dist_strategy=None,
+        rank=None,
+        nrank=None,
+        max_run_times=None,
+        split_backward=False,
     ):
         self.dist_strategy = dist_strategy
         self.rank = rank
         self.nrank = nrank
         self.max_run_times = max_run_times
         self.is_auto_parallel = True if dist_strategy is None else False
-        self.num_of_functionality = 4
+        # split the backward into the input grad and the weight grad parts
+        self.split_backward = split_backward
+        self.num_of_functionality = 5 if split_backward else 4
         self.coord_sys = None
         self.coord = None
         if dist_strategy:
@@ -278,6 +285,67 @@ class FleetExecutorUtils:
                 ) + " isn't one of LRSched, Forward, Backward or Optimizer."
         return op_list_map
 
+    def is_weight_grad_var(self, name, param_names):
+        grad_suffix = core.grad_var_suffix()
+        if grad_suffix not in name:
+            return False
+        return name[: name.index(grad_suffix)] in param_names
+
+    def split_backward_op_list(self, program, bwd_ops):
+        """
+        Split the backward ops into the input grad part (B), which computes
+        the grads sent to the previous stage, and the weight grad part (W),
+        which only computes the grads of the params. The ops computing both,
+        e.g. matmul_v2_grad, are copied into the two parts, each copy with the
+        outputs of the other part set to empty.
+        :return: the op descs of B and W, in the order of the program
+        """
+        param_names = {
+            param.name for param in program.global_block().all_parameters()
+        }
+        send_ops = ("send_v2", "partial_send")
+        # B is the backward slice of the sends to the previous stage
+        needed_vars = set()
+        in_b = [False] * len(bwd_ops)
+        for idx in reversed(range(len(bwd_ops))):
+            op = bwd_ops[idx]
+            if op.type in send_ops or any(
+                name in needed_vars for name in op.desc.output_arg_names()
+            ):
+                in_b[idx] = True
+                needed_vars.update(op.desc.input_arg_names())
+
+        empty_var = core.empty_var_name()
+        b_descs, w_descs = [], []
+        for op, is_b in zip(bwd_ops, in_b):
+            if not is_b:
+                w_descs.append(op.desc)
+                continue
+            outputs = [
+                name
+                for name in op.desc.output_arg_names()
+                if name != empty_var
+            ]
+            weight_grads = [
+                name
+                for name in outputs
+                if self.is_weight_grad_var(name, param_names)
+            ]
+            if not weight_grads or len(weight_grads) == len(outputs):
+                b_descs.append(op.desc)
+                continue
+            b_desc, w_desc = core.OpDesc(), core.OpDesc()
+            b_desc.copy_from(op.desc)
+            w_desc.copy_from(op.desc)
+            for name in outputs:
+                if name in weight_grads:
+                    b_desc._rename_output(name, empty_var)
+                else:
+                    w_desc._rename_output(name, empty_var)
+            b_descs.append(b_desc)
+            w_descs.append(w_desc)
+        return b_descs, w_descs
+
     def convert_op_list_to_program(self, op_list, complete_program):
         # TODO(liyurui): Complete this convert logic
         program_map = {
@@ -308,8 +376,20 @@ class FleetExecutorUtils:
         task_node_map["fwd"].add_upstream_task(cur_start_id)
         task_node_map["fwd"].add_downstream_task(cur_start_id + 2, pp_buff_size)
         task_node_map["bwd"].add_upstream_task(cur_start_id + 1, pp_buff_size)
-        task_node_map["bwd"].add_downstream_task(cur_start_id + 3)
-        task_node_map["opt"].add_upstream_task(cur_start_id + 2)
+        if self.split_backward:
+            # backward -> weight grad -> (m:1)optimize, at most pp_buff_size
+            # weight grads are deferred to the bubbles
+            task_node_map["bwd"].add_downstream_task(
+                cur_start_id + 4, pp_buff_size
+            )
+            task_node_map["bwd_w"].add_upstream_task(
+                cur_start_id + 2, pp_buff_size
+            )
+            task_node_map["bwd_w"].add_downstream_task(cur_start_id + 3)
+            task_node_map["opt"].add_upstream_task(cur_start_id + 4)
+        else:
+            task_node_map["bwd"].add_downstream_task(cur_start_id + 3)
+            task_node_map["opt"].add_upstream_task(cur_start_id + 2)
         # add dependency inter stage
         upstream_coord, downstream_coord = self.coord.copy(), self.coord.copy()
         upstream_coord['pp_idx'] = upstream_coord['pp_idx'] - 1
@@ -405,10 +485,27 @@ class FleetExecutorUtils:
         )
         opt_task_node.set_run_pre_steps(self.max_run_times)
         opt_task_node.set_run_at_offset(self.max_run_times - 1)
+        if not self.split_backward:
+            return {
+                "lr": lr_task_node,
+                "fwd": fwd_task_node,
+                "bwd": bwd_task_node,
+                "opt": opt_task_node,
+            }
+        bwd_w_task_node = TaskNode(
+            rank=self.rank,
+            max_run_times=self.max_run_times,
+            role=int(OpRole.Backward),
+            ops=op_list_map["bwd_w"],
+            task_id=cur_start_id + 4,
+            node_type="WeightGrad",
+        )
+        # the weight grad runs before the optimize, also for the gc
         return {
             "lr": lr_task_node,
             "fwd": fwd_task_node,
             "bwd": bwd_task_node,
+            "bwd_w": bwd_w_task_node,
             "opt": opt_task_node,
         }
 
@@ -420,28 +517,36 @@ def run1f1b(
     dist_opt,
     nrank,
     with_standalone_executor=False,
+    split_backward=False,
 ):
     """
     Split the program to support 1f1b pipeline scheduler.
     This function will split the program based on the op_role.
     The program will be split into four parts: lr_sched, fwd, bwd, opt.
     And will create task nodes based on the four parts of the program.
+    With split_backward, the bwd is further split into the input grad and
+    the weight grad, which runs in the bubbles of the pipeline (ZB-H1).
     :param program: The origin program.
     :param rank: Current rank (can be got from fleet.worker_index()).
     :param max_run_times: Max run times for a micro batch. AKA number of micro steps.
     :param dist_opt: The fleet_opt configured by user.
     :param nrank: Number of workers (can be got from fleet.worker_num()).
     :param with_standalone_executor: Experiment feature, use fleet executor with standalone executor.
+    :param split_backward: Whether to run the weight grad in the bubbles.
     :return:
         task_nodes (list): four task nodes for current rank
         task_id_to_rank (dict): task nodes' ids to it's corresponding rank
     """
     print("fleet executor will use python side 1f1b scheduler.")
+    assert not (
+        with_standalone_executor and split_backward
+    ), "The zero bubble scheduler doesn't support standalone executor."
     fleet_executor_utils = FleetExecutorUtils(
         dist_strategy=dist_opt,
         rank=rank,
         nrank=nrank,
         max_run_times=max_run_times,
+        split_backward=split_backward,
     )
     op_list_map = fleet_executor_utils.split_program_to_op_list(program)
     task_node_map = None
@@ -457,6 +562,13 @@ def run1f1b(
         for key in op_list_map:
             for op in op_list_map[key]:
                 op_desc_list_map[key].append(op.desc)
+        if split_backward:
+            (
+                op_desc_list_map["bwd"],
+                op_desc_list_map["bwd_w"],
+            ) = fleet_executor_utils.split_backward_op_list(
+                program, op_list_map["bwd"]
+            )
         task_node_map = fleet_executor_utils.construct_task_nodes_1f1b_op_list(
             op_desc_list_map
         )
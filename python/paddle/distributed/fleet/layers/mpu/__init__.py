@@ -16,6 +16,7 @@ from .mp_layers import (  # noqa: F401
     ColumnParallelLinear,
     ParallelCrossEntropy,
     RowParallelLinear,
+    ShardedEmbeddingBag,
     VocabParallelEmbedding,
 )
 from .random import (  # noqa: F401
@@ -182,6 +182,242 @@ class VocabParallelEmbedding(paddle.nn.Layer):
         return output
 
 
+class _AllToAllSingle(PyLayer):
+    @staticmethod
+    def forward(ctx, x, in_split_sizes, out_split_sizes, group):
+        ctx.in_split_sizes = in_split_sizes
+        ctx.out_split_sizes = out_split_sizes
+        ctx.group = group
+        out = paddle.empty(
+            [sum(out_split_sizes)] + list(x.shape[1:]), dtype=x.dtype
+        )
+        paddle.distributed.alltoall_single(
+            x, out, in_split_sizes, out_split_sizes, group=group
+        )
+        return out
+
+    @staticmethod
+    def backward(ctx, dy):
+        dx = paddle.empty(
+            [sum(ctx.in_split_sizes)] + list(dy.shape[1:]), dtype=dy.dtype
+        )
+        paddle.distributed.alltoall_single(
+            dy, dx, ctx.out_split_sizes, ctx.in_split_sizes, group=ctx.group
+        )
+        return dx
+
+
+class ShardedEmbeddingBag(paddle.nn.Layer):
+    """Embedding mp parallelized in the vocabulary dimension, looked up by
+    all-to-all instead of all-reducing the full outputs.
+
+    Each rank keeps a contiguous range of rows of the table. The ids of a
+    rank are bucketized by the ranks owning them and sent there with an
+    all-to-all. The owners look the ids up and pool them by bag, and the
+    pooled partial bags are returned with a second all-to-all and summed
+    into the bags. The gradients go back the same way, and the gradient of
+    the weight is sparse, so it can be updated by a sparse optimizer. The
+    ranks may feed different ids, but they have to call it in lockstep.
+
+    Args:
+        num_embeddings(int): One element which indicate the size of the dictionary of embeddings.
+        embedding_dim(int): One element which indicate the size of each embedding vector respectively.
+        pooling(str|None): How the ids of a bag are pooled, "sum" or "mean". Each row of a 2-D input
+            is a bag. None to look every id up without pooling. Default: "sum".
+        weight_attr(ParamAttr|None): To specify the weight parameter property. Default: None, which means the
+            default weight parameter property is used. See usage for details in :ref:`api_paddle_ParamAttr` .
+        mp_group(Group): The tensor parallel group.
+        name(str, optional): For detailed information, please refer
+               to :ref:`api_guide_Name`. Usually name is no need to set and
+               None by default.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env: DISTRIBUTED)
+            >>> import paddle
+            >>> from paddle.distributed import fleet
+
+            >>> class SparseNet(paddle.nn.Layer):
+            ...     def __init__(self, vocab_size, hidden_size):
+            ...         super().__init__()
+            ...         self.embedding = fleet.meta_parallel.ShardedEmbeddingBag(
+            ...             vocab_size,
+            ...             hidden_size,
+            ...             pooling="mean")
+            ...         self.linear = paddle.nn.Linear(hidden_size, 1)
+            ...     def forward(self, ids):
+            ...         # ids is of shape [batch_size, bag_size]
+            ...         return self.linear(self.embedding(ids))
+
+    """
+
+    def __init__(
+        self,
+        num_embeddings,
+        embedding_dim,
+        pooling="sum",
+        weight_attr=None,
+        mp_group=None,
+        name=None,
+    ):
+        super().__init__()
+
+        self.model_parallel_group = (
+            tp._HYBRID_PARALLEL_GROUP.get_model_parallel_group()
+            if mp_group is None
+            else mp_group
+        )
+        self.world_size = (
+            tp._HYBRID_PARALLEL_GROUP.get_model_parallel_world_size()
+            if mp_group is None
+            else mp_group.nranks
+        )
+        self.rank = (
+            tp._HYBRID_PARALLEL_GROUP.get_model_parallel_rank()
+            if mp_group is None
+            else mp_group.rank
+        )
+
+        self.is_mp = self.world_size > 1
+
+        assert (
+            num_embeddings % self.world_size == 0
+        ), "The length of the vocabulary must be divisible by the parallelism degree of MP"
+        assert pooling in (
+            "sum",
+            "mean",
+            None,
+        ), f"The pooling must be sum, mean or None, but got {pooling}"
+
+        self.per_part_size = num_embeddings // self.world_size
+        self.vocab_start_index = self.rank * self.per_part_size
+        self.pooling = pooling
+        self._dtype = self._helper.get_default_dtype()
+        self._size = [self.per_part_size, embedding_dim]
+        self._weight_attr = weight_attr
+        self._name = name
+        self.num_embeddings = num_embeddings
+        self.embedding_dim = embedding_dim
+
+        if self.is_mp and paddle.in_dynamic_mode():
+            with get_rng_state_tracker().rng_state():
+                self.weight = self.create_parameter(
+                    attr=self._weight_attr,
+                    shape=self._size,
+                    dtype=self._dtype,
+                    is_bias=False,
+                )
+        else:
+            self.weight = self.create_parameter(
+                attr=self._weight_attr,
+                shape=self._size,
+                dtype=self._dtype,
+                is_bias=False,
+            )
+
+        self.weight.is_distributed = True if self.is_mp else False
+        if self.weight.is_distributed:
+            self.weight.split_axis = 0
+
+    def _lookup(self, ids, slots):
+        # ids of the local rows, and the partial bags they are pooled into,
+        # which are sorted
+        emb = F.embedding(
+            ids - self.vocab_start_index,
+            weight=self.weight,
+            padding_idx=None,
+            sparse=True,
+            name=self._name,
+        )
+        if ids.shape[0] == 0:
+            return emb
+        return paddle.geometric.segment_sum(emb, slots)
+
+    def forward(self, x):
+        ids = x.flatten().astype("int64")
+        if self.pooling is None:
+            num_bags = ids.shape[0]
+            bags = paddle.arange(num_bags, dtype="int64")
+        else:
+            assert (
+                len(x.shape) == 2
+            ), "The ids of ShardedEmbeddingBag must be [batch_size, bag_size]"
+            num_bags = x.shape[0]
+            bags = (
+                paddle.arange(num_bags, dtype="int64")
+                .unsqueeze(1)
+                .expand(x.shape)
+                .flatten()
+            )
+
+        # sort the ids by their owners and bags, the ids of a rank in one bag
+        # make a partial bag
+        owners = ids // self.per_part_size
+        keys = owners * num_bags + bags
+        order = paddle.argsort(keys)
+        ids = paddle.gather(ids, order)
+        owners = paddle.gather(owners, order)
+        slot_keys, slots = paddle.unique(
+            paddle.gather(keys, order), return_inverse=True
+        )
+        slot_bags = slot_keys % num_bags
+
+        if not self.is_mp:
+            pooled = self._lookup(ids, slots)
+        else:
+            group = self.model_parallel_group
+            id_counts = paddle.bincount(owners, minlength=self.world_size)
+            slot_counts = paddle.bincount(
+                slot_keys // num_bags, minlength=self.world_size
+            )
+            # the partial bags are numbered from 0 for each owner
+            slots = slots - paddle.gather(
+                paddle.cumsum(slot_counts) - slot_counts, owners
+            )
+
+            counts = paddle.stack([id_counts, slot_counts], axis=1)
+            recv_counts = paddle.empty_like(counts)
+            paddle.distributed.alltoall_single(counts, recv_counts, group=group)
+            send_id_counts = id_counts.tolist()
+            send_slot_counts = slot_counts.tolist()
+            recv_id_counts = recv_counts[:, 0]
+            recv_slot_counts = recv_counts[:, 1]
+
+            send = paddle.stack([ids, slots], axis=1)
+            recv = paddle.empty([int(recv_id_counts.sum()), 2], dtype="int64")
+            paddle.distributed.alltoall_single(
+                send,
+                recv,
+                send_id_counts,
+                recv_id_counts.tolist(),
+                group=group,
+            )
+            sources = paddle.repeat_interleave(
+                paddle.arange(self.world_size, dtype="int64"), recv_id_counts
+            )
+            recv_slots = recv[:, 1] + paddle.gather(
+                paddle.cumsum(recv_slot_counts) - recv_slot_counts, sources
+            )
+            partial = self._lookup(recv[:, 0], recv_slots)
+            pooled = _AllToAllSingle.apply(
+                partial, recv_slot_counts.tolist(), send_slot_counts, group
+            )
+
+        out = paddle.index_add(
+            paddle.zeros([num_bags, self.embedding_dim], dtype=pooled.dtype),
+            slot_bags,
+            0,
+            pooled,
+        )
+        if self.pooling is None:
+            return out.reshape(list(x.shape) + [self.embedding_dim])
+        if self.pooling == "mean":
+            sizes = paddle.bincount(bags, minlength=num_bags).clip(min=1)
+            out = out / sizes.unsqueeze(1).astype(out.dtype)
+        return out
+
+
 _raise_cuda_env_unset_warning = True
 
 
@@ -19,6 +19,7 @@ from .parallel_layers import (  # noqa: F401
     PipelineLayer,
     RNGStatesTracker,
     RowParallelLinear,
+    ShardedEmbeddingBag,
     SharedLayerDesc,
     VocabParallelEmbedding,
     get_rng_state_tracker,
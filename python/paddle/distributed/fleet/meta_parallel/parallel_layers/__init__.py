@@ -16,6 +16,7 @@ from .mp_layers import (  # noqa: F401
     ColumnParallelLinear,
     ParallelCrossEntropy,
     RowParallelLinear,
+    ShardedEmbeddingBag,
     VocabParallelEmbedding,
 )
 from .pp_layers import LayerDesc, PipelineLayer, SharedLayerDesc  # noqa: F401
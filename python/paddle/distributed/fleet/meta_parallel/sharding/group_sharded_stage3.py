@@ -111,6 +111,8 @@ class GroupShardedStage3(nn.Layer):
         sync_comm=False,
         dp_group=None,
         exclude_layer=None,
+        prefetch_layers=1,
+        prefetch_memory_bytes=0,
     ):
         super().__init__()
 
@@ -228,6 +230,12 @@ class GroupShardedStage3(nn.Layer):
         self._order_tracer["order"] = 0
         self._order_tracer["layer"] = []
 
+        # From the 2nd step, allgather the params of the next prefetch_layers
+        # layers ahead of time, within prefetch_memory_bytes (0 for no limit)
+        self._gather_scheduler = core.ParamGatherScheduler(
+            prefetch_layers, prefetch_memory_bytes
+        )
+
         # Register task flow
         self._task_flow = TaskFlow()
 
@@ -580,6 +588,7 @@ class GroupShardedStage3(nn.Layer):
             return ForwardPreHooks(
                 layer,
                 self._order_tracer,
+                self._gather_scheduler,
                 self._trainable_params,
                 self._param2buffer_size,
                 self._group,
@@ -593,6 +602,7 @@ class GroupShardedStage3(nn.Layer):
                 outputs,
                 layer,
                 self._order_tracer,
+                self._gather_scheduler,
                 self._trainable_params,
                 self._param2buffer,
                 self._param2buffer_size,
@@ -849,6 +859,7 @@ class GroupShardedStage3(nn.Layer):
 def ForwardPreHooks(
     layer,
     order_tracer,
+    scheduler,
     trainable_params,
     param2buffer_size,
     group,
@@ -866,6 +877,9 @@ def ForwardPreHooks(
         # Whether to use calc stream
         task_flow.use_calc[layer_id] = use_calc
     else:
+        # a new step begins, no layer is gathered yet
+        if layer_id == order_tracer["layer"][0]:
+            scheduler.reset()
         # Whether to use calc stream
         task_flow.use_calc[layer_id] = use_calc
         # wait current layer params
@@ -878,10 +892,18 @@ def ForwardPreHooks(
             offload,
         )
 
-        if layer_id == order_tracer["layer"][-1]:
-            return
-        order_ = order_tracer[layer_id]
-        layer_id = order_tracer["layer"][order_ + 1]
+        # the next layers to allgather while the current one runs
+        for next_id in scheduler.schedule(layer_id, True):
+            _allgather_buffer(
+                trainable_params[next_id],
+                group,
+                param2buffer_size=param2buffer_size,
+                use_calc_stream=use_calc,
+                task_flow=task_flow,
+                sync_wait=sync_wait,
+                offload=offload,
+            )
+        return
 
     _allgather_buffer(
         trainable_params[layer_id],
@@ -903,6 +925,7 @@ class ForwardPostHooks(PyLayer):
         inputs,
         layer,
         order_tracer,
+        scheduler,
         trainable_params,
         param2buffer,
         param2buffer_size,
@@ -917,15 +940,24 @@ class ForwardPostHooks(PyLayer):
         _release_param(
             trainable_params[layer_id], param2buffer, rank, task_flow, offload
         )
+        scheduler.release(layer_id)
 
         if layer_id not in order_tracer.keys():
             order_ = order_tracer["order"]
             order_tracer[layer_id] = order_
             order_tracer["order"] += 1
             order_tracer["layer"].append(layer_id)
+            scheduler.record_layer(
+                layer_id,
+                sum(
+                    param2buffer_size[param.name] * param.element_size()
+                    for param in trainable_params[layer_id]
+                ),
+            )
 
         # Record fw info
         ctx.order_tracer = order_tracer
+        ctx.scheduler = scheduler
         ctx.task_flow = task_flow
         ctx.group = group
         ctx.layer_id = layer_id
@@ -940,6 +972,7 @@ class ForwardPostHooks(PyLayer):
     def backward(ctx, *args):
         # Load context value
         order_tracer = ctx.order_tracer
+        scheduler = ctx.scheduler
         task_flow = ctx.task_flow
         group = ctx.group
         layer_id = ctx.layer_id
@@ -978,17 +1011,22 @@ class ForwardPostHooks(PyLayer):
 
         # Whether to use calc stream
         task_flow.use_calc[layer_id] = use_calc
-        if layer_id != order_tracer["layer"][0] and not sync_comm:
-            layer_next_id = order_tracer["layer"][order_tracer[layer_id] - 1]
-            _allgather_buffer(
-                trainable_params[layer_next_id],
-                group,
-                param2buffer_size=param2buffer_size,
-                use_calc_stream=use_calc,
-                task_flow=task_flow,
-                sync_wait=sync_wait,
-                offload=offload,
-            )
+        if not sync_comm:
+            # the full params of the layer after it are released by the
+            # allreduce of their grads, which is about done by now
+            order_ = order_tracer[layer_id]
+            if order_ + 1 < len(order_tracer["layer"]):
+                scheduler.release(order_tracer["layer"][order_ + 1])
+            for layer_next_id in scheduler.schedule(layer_id, False):
+                _allgather_buffer(
+                    trainable_params[layer_next_id],
+                    group,
+                    param2buffer_size=param2buffer_size,
+                    use_calc_stream=use_calc,
+                    task_flow=task_flow,
+                    sync_wait=sync_wait,
+                    offload=offload,
+                )
 
         return args
 
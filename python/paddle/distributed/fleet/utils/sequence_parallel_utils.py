@@ -138,6 +138,136 @@ class ReduceScatterOp(PyLayer):
         return all_gather(grad)
 
 
+# The collective matmuls pipeline the communication of sequence parallel with
+# the matmuls in a ring of the mp ranks: the first dim of the input is split
+# into a chunk per rank, and while a rank multiplies a chunk, the next chunk
+# is sent and received on the communication stream.
+def _ring_peers(group):
+    nranks = group.nranks
+    next_peer = group.ranks[(group.rank + 1) % nranks]
+    prev_peer = group.ranks[(group.rank - 1) % nranks]
+    return next_peer, prev_peer
+
+
+def _ring_exchange(send_tensor, recv_tensor, group):
+    next_peer, prev_peer = _ring_peers(group)
+    return dist.batch_isend_irecv(
+        [
+            dist.P2POp(dist.isend, send_tensor, next_peer, group),
+            dist.P2POp(dist.irecv, recv_tensor, prev_peer, group),
+        ]
+    )
+
+
+def all_gather_matmul(x, weight, group, transpose_y=False):
+    """
+    Computes matmul(all_gather(x), weight), where each rank passes the chunk
+    of x it holds to the next rank while it multiplies the chunk.
+
+    Returns the output and the gathered x.
+    """
+    nranks = group.nranks
+    rank = group.rank
+    chunk = x
+    chunks = [None] * nranks
+    outputs = [None] * nranks
+    for step in range(nranks):
+        index = (rank - step) % nranks
+        chunks[index] = chunk
+        tasks = []
+        if step < nranks - 1:
+            recv_chunk = paddle.empty_like(chunk)
+            tasks = _ring_exchange(chunk, recv_chunk, group)
+        outputs[index] = paddle.matmul(chunk, weight, transpose_y=transpose_y)
+        for task in tasks:
+            task.wait()
+        if step < nranks - 1:
+            chunk = recv_chunk
+    return paddle.concat(outputs, axis=0), paddle.concat(chunks, axis=0)
+
+
+def matmul_reduce_scatter(x, weight, group, transpose_y=False):
+    """
+    Computes reduce_scatter(matmul(x, weight)), where the partial sum of each
+    chunk of the output is passed around the ring and accumulated, while the
+    ranks multiply the chunks of the next step.
+    """
+    nranks = group.nranks
+    rank = group.rank
+    assert (
+        x.shape[0] % nranks == 0
+    ), f"Input sequence length {x.shape[0]} can't be divided exactly by sequence parallelism {nranks}"
+    x_chunks = paddle.split(x, nranks, axis=0)
+    tasks = []
+    for step in range(nranks):
+        # the partial sum of the chunk ends at the rank it belongs to
+        index = (rank - 1 - step) % nranks
+        partial = paddle.matmul(
+            x_chunks[index], weight, transpose_y=transpose_y
+        )
+        if step > 0:
+            for task in tasks:
+                task.wait()
+            partial = partial + received
+        if step < nranks - 1:
+            received = paddle.empty_like(partial)
+            tasks = _ring_exchange(partial, received, group)
+    return partial
+
+
+# All gather along the first dim and matmul during forward pass
+# Matmul and reduce scatter along the first dim during backward pass
+class AllGatherMatmul(PyLayer):
+    # input shape: [s/n, b, h], n is mp parallelism
+    # after forward shape: [s, b, h/n]
+    @staticmethod
+    def forward(ctx, x, weight, group):
+        output, input_parallel = all_gather_matmul(x, weight, group)
+        ctx.group = group
+        ctx.save_for_backward(input_parallel, weight)
+        return output
+
+    @staticmethod
+    def backward(ctx, dy):
+        input_parallel, weight = ctx.saved_tensor()
+        if dy.dtype != weight.dtype:
+            weight = paddle.cast(weight, dtype=dy.dtype)
+        dx = matmul_reduce_scatter(dy, weight, ctx.group, transpose_y=True)
+        dw = paddle.matmul(
+            input_parallel.reshape([-1, input_parallel.shape[-1]]),
+            dy.reshape([-1, dy.shape[-1]]),
+            transpose_x=True,
+        )
+        return dx, dw
+
+
+# Matmul and reduce scatter along the first dim during forward pass
+# All gather along the first dim and matmul during backward pass
+class MatmulReduceScatter(PyLayer):
+    # input shape: [s, b, h/n], n is mp parallelism
+    # after forward shape: [s/n, b, h]
+    @staticmethod
+    def forward(ctx, x, weight, group):
+        ctx.group = group
+        ctx.save_for_backward(x, weight)
+        return matmul_reduce_scatter(x, weight, group)
+
+    @staticmethod
+    def backward(ctx, dy):
+        x, weight = ctx.saved_tensor()
+        if dy.dtype != weight.dtype:
+            weight = paddle.cast(weight, dtype=dy.dtype)
+        dx, dy_parallel = all_gather_matmul(
+            dy, weight, ctx.group, transpose_y=True
+        )
+        dw = paddle.matmul(
+            x.reshape([-1, x.shape[-1]]),
+            dy_parallel.reshape([-1, dy_parallel.shape[-1]]),
+            transpose_x=True,
+        )
+        return dx, dw
+
+
 ###################################################
 #                                                 #
 #        Modified Parallel Linear Operator        #
@@ -490,9 +620,17 @@ class ColumnSequenceParallelLinear(Layer):
             self.mp_async_allreduce
             and mp_configs.mp_fused_linear_param_grad_add
         )
+        self.sp_collective_matmul = mp_configs.sp_collective_matmul
 
     def forward(self, x):
         # sequence parallelism is same as model parallelis, if sequence parallel is true, input shape is [s, b, h],else input shape is [b, s, h]
+        if self.sp_collective_matmul:
+            output = AllGatherMatmul.apply(
+                x, self.weight, self.model_parallel_group
+            )
+            if self.bias is not None:
+                output = output + self.bias
+            return output
         return SPInnerOverlapLinear.apply(
             x,
             self.weight,
@@ -612,9 +750,20 @@ class RowSequenceParallelLinear(Layer):
             if self.is_mp and has_bias:
                 self.mp_scale = MPScale.apply
 
+        mp_configs = fleet.fleet._user_defined_strategy.hybrid_configs[
+            "mp_configs"
+        ]
+        self.sp_collective_matmul = mp_configs.sp_collective_matmul
+
     def forward(self, x):
         input_parallel = x
-        if self.is_mp:
+        if self.is_mp and self.sp_collective_matmul:
+            output = MatmulReduceScatter.apply(
+                input_parallel, self.weight, self.model_parallel_group
+            )
+            if self.bias is not None:
+                output = output + self.bias
+        elif self.is_mp:
             if self.mp_scale is not None:
                 bias = self.mp_scale(self.bias, self.world_size)
             else:
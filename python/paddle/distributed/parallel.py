@@ -524,6 +524,42 @@ class DataParallel(layers.Layer):
         finally:
             self.grad_need_sync = tmp_grad_need_sync
 
+    def register_comm_hook(
+        self, hook_type, matrix_approximation_rank=1, start_step=10
+    ):
+        """
+        Compresses the gradients of the dense parameters for their
+        all-reduce, which cuts the bytes sent when the training is bound by
+        the bandwidth between the ranks. Call it before the first backward.
+
+        Parameters:
+            hook_type (str): 'fp16' or 'bf16' all-reduces each fused group of
+                gradients cast to float16 or bfloat16 and casts the mean back
+                to the dtype of the gradients. 'powersgd' all-reduces the rank
+                ``matrix_approximation_rank`` factors of each group instead,
+                with error feedback, see PowerSGD (Vogels et al. 2019).
+            matrix_approximation_rank (int, optional): The rank of the
+                PowerSGD factors. Default is 1.
+            start_step (int, optional): The number of steps all-reduced
+                uncompressed before PowerSGD starts. Default is 10.
+
+        Examples:
+            .. code-block:: python
+
+                >>> # doctest: +REQUIRES(env:DISTRIBUTED)
+                >>> import paddle
+                >>> import paddle.distributed as dist
+
+                >>> dist.init_parallel_env()
+                >>> model = paddle.DataParallel(paddle.nn.Linear(10, 1))
+                >>> model.register_comm_hook('powersgd')
+                >>> model(paddle.randn([10, 10])).backward()
+        """
+        if self._strategy.nranks > 1 and in_dynamic_mode():
+            self._reducer.register_comm_hook(
+                hook_type, matrix_approximation_rank, start_step
+            )
+
     def forward(self, *inputs, **kwargs):
         outputs = self._layers(*inputs, **kwargs)
         if (
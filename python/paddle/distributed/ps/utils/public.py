@@ -129,6 +129,10 @@ class TrainerRuntimeConfig:
         self.runtime_configs['communicator_is_sgd_optimizer'] = os.getenv(
             "FLAGS_communicator_is_sgd_optimizer", "1"
         )
+        # "ratio" or "ratio,table_id:ratio,..." of sparse rows sent by GEO
+        self.runtime_configs[
+            'communicator_geo_sparse_topk_ratio'
+        ] = os.getenv("FLAGS_communicator_geo_sparse_topk_ratio", "1.0")
 
     def get_communicator_flags(self):
         need_keys = []
@@ -155,6 +159,7 @@ class TrainerRuntimeConfig:
                 'communicator_send_wait_times',
                 'communicator_max_merge_var_num',
                 'communicator_send_queue_size',
+                'communicator_geo_sparse_topk_ratio',
             ]
         else:
             raise ValueError("Unsupported Mode")
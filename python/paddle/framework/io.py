@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import atexit
 import collections
 import copyreg
 import os
@@ -62,6 +63,27 @@ def clear_async_save_task_queue():
             task.join()
 
 
+class _AsyncCheckpointTask:
+    """Handle of a save of the C++ async checkpoint engine, joined like the
+    threads of async_save_queue."""
+
+    _atexit_registered = False
+
+    def __init__(self, save_id):
+        self._id = save_id
+        if not _AsyncCheckpointTask._atexit_registered:
+            atexit.register(core.wait_all_async_checkpoints)
+            _AsyncCheckpointTask._atexit_registered = True
+
+    def is_alive(self):
+        done, _ = core.async_checkpoint_status(self._id)
+        return not done
+
+    def join(self):
+        # raises the error of the save if it failed
+        core.wait_async_checkpoint(self._id)
+
+
 def async_save(obj, path, protocol=4, sync_other_task=False, **configs):
     '''
     async version of paddle.save.
@@ -76,7 +98,10 @@ def async_save(obj, path, protocol=4, sync_other_task=False, **configs):
         protocol(int, optional): The protocol version of pickle module must be greater than 1 and less than 5.
                                  Default: 4
         sync_other_task(bool) : Determine whether to wait other async save task to be finished before this one be put in queue.
-        **configs(dict, optional): compatible argument to paddle.save, but will be overridden by default setting.
+        **configs(dict, optional): compatible argument to paddle.save, but will be overridden by default setting,
+          except for ``use_tensor_checkpoint``: when True and ``obj`` is a flat dict of Tensors, the Tensors are
+          snapshotted into pinned host memory after the queued kernels and written as a tensor checkpoint by a
+          background thread of the C++ engine, ``paddle.clear_async_save_task_queue`` raises its errors.
     Examples:
         .. code-block:: python
             :name: code-example-1
@@ -96,10 +121,28 @@ def async_save(obj, path, protocol=4, sync_other_task=False, **configs):
         raise ValueError(
             "async_save currently is not supported in static mode."
         )
+    use_tensor_checkpoint = configs.pop('use_tensor_checkpoint', False)
     if len(configs) > 0:
         warnings.warn(
             "configs are not supported in async mode, will be overridden by default settings."
         )
+    if use_tensor_checkpoint:
+        if not _is_file_path(path) or not (
+            isinstance(obj, dict)
+            and all(isinstance(v, core.eager.Tensor) for v in obj.values())
+        ):
+            raise TypeError(
+                "`use_tensor_checkpoint` only supports saving a dict of Tensors to a file."
+            )
+        if sync_other_task:
+            clear_async_save_task_queue()
+        save_id = core.async_save_tensor_checkpoint(
+            path,
+            [str(key) for key in obj.keys()],
+            [value.value().get_tensor() for value in obj.values()],
+        )
+        async_save_queue.append(_AsyncCheckpointTask(save_id))
+        return
 
     # TODO: make this part async
     def move_state_dict_to_cpu(sd):
@@ -338,7 +381,11 @@ def _parse_load_config(configs):
 
 
 def _parse_save_config(configs):
-    supported_configs = ['use_binary_format', 'pickle_protocol']
+    supported_configs = [
+        'use_binary_format',
+        'pickle_protocol',
+        'use_tensor_checkpoint',
+    ]
 
     # input check
     for key in configs:
@@ -356,6 +403,9 @@ def _parse_save_config(configs):
     inner_config = _SaveLoadConfig()
     inner_config.use_binary_format = configs.get('use_binary_format', False)
     inner_config.pickle_protocol = configs.get('pickle_protocol', None)
+    inner_config.use_tensor_checkpoint = configs.get(
+        'use_tensor_checkpoint', False
+    )
 
     return inner_config
 
@@ -720,6 +770,38 @@ def _save_binary_var(obj, path):
         )
 
 
+def _save_tensor_checkpoint(obj, path):
+    if not in_dygraph_mode():
+        raise ValueError(
+            "`use_tensor_checkpoint` is only supported in dynamic graph mode."
+        )
+    if not _is_file_path(path):
+        raise ValueError(
+            f"`use_tensor_checkpoint` only supports saving to a file, but got {type(path)}."
+        )
+    if not isinstance(obj, dict) or not all(
+        isinstance(value, core.eager.Tensor) for value in obj.values()
+    ):
+        raise TypeError(
+            "`use_tensor_checkpoint` only supports saving a dict of Tensors."
+        )
+    names = [str(key) for key in obj.keys()]
+    tensors = [value.value().get_tensor() for value in obj.values()]
+    core.save_tensor_checkpoint(path, names, tensors)
+
+
+def _load_tensor_checkpoint(path, return_numpy):
+    result = {}
+    for name, tensor in core.load_tensor_checkpoint(path):
+        if return_numpy:
+            result[name] = np.array(tensor)
+        elif in_dygraph_mode():
+            result[name] = _lod_tensor2varbase(tensor)
+        else:
+            result[name] = tensor
+    return result
+
+
 def save(obj, path, protocol=4, **configs):
     '''
     Save an object to the specified path.
@@ -746,6 +828,9 @@ def save(obj, path, protocol=4, **configs):
           use_binary_format(bool): When the saved object is static graph variable, you can specify ``use_binary_for_var``.
           If True, save the file in the c++ binary format when saving a single static graph variable; otherwise, save it in pickle format.
           Default: False
+          use_tensor_checkpoint(bool): When the saved object is a flat ``state_dict`` of Tensors in dynamic graph mode and
+          ``path`` is a file name, save it in the indexed and checksummed tensor checkpoint format, written by a pool of threads.
+          ``paddle.load`` returns it as a dict of Tensors. Default: False
 
     Returns:
         None
@@ -877,7 +962,9 @@ def save(obj, path, protocol=4, **configs):
             f"Type of `use_binary_format` should be bool, but received {type(config.use_binary_format)}."
         )
 
-    if config.use_binary_format:
+    if config.use_tensor_checkpoint:
+        _save_tensor_checkpoint(obj, path)
+    elif config.use_binary_format:
         _save_binary_var(obj, path)
     else:
         # `protocol` need to be used, `pickle_protocol` is a deprecated arg.
@@ -1122,6 +1209,10 @@ def load(path, **configs):
 
     '''
 
+    if _is_file_path(path) and core.is_tensor_checkpoint(path):
+        config = _parse_load_config(configs)
+        return _load_tensor_checkpoint(path, config.return_numpy)
+
     if _is_memory_buffer(path) or os.path.isfile(path):
         config = _parse_load_config(configs)
         exception_type = pickle.UnpicklingError
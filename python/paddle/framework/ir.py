@@ -53,6 +53,19 @@ def _update_grad_persistable(main_program):
             g_var.persistable = True
 
 
+def _auto_fuse_resunit():
+    # fuse_resunit_pass is applied without BuildStrategy.fuse_resunit on the
+    # GPUs where its fused kernels are supported
+    flag = "FLAGS_auto_fuse_resunit"
+    if flag not in core.globals() or not core.globals()[flag]:
+        return False
+    from ..device import cuda, get_cudnn_version
+
+    major, _ = cuda.get_device_capability()
+    cudnn_version = get_cudnn_version()
+    return major >= 8 and cudnn_version is not None and cudnn_version >= 8800
+
+
 def apply_build_strategy(
     main_program, startup_program, build_strategy, pass_attrs
 ):
@@ -86,7 +99,7 @@ def apply_build_strategy(
     if build_strategy.fuse_relu_depthwise_conv and use_cuda:
         apply_pass("fuse_relu_depthwise_conv_pass")
         build_strategy.fuse_relu_depthwise_conv = False
-    if build_strategy.fuse_resunit:
+    if build_strategy.fuse_resunit or (use_cuda and _auto_fuse_resunit()):
         apply_pass("fuse_resunit_pass")
         build_strategy.fuse_resunit = False
     if build_strategy.fuse_bn_act_ops and use_cuda:
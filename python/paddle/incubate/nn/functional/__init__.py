@@ -13,6 +13,7 @@
 # limitations under the License.
 
 from .block_multihead_attention import block_multihead_attention
+from .fp8 import fp8_cast_transpose, fp8_gemm
 from .fused_dot_product_attention import (
     fused_dot_product_attention,  # noqa: F401
 )
@@ -20,6 +21,7 @@ from .fused_dropout_add import fused_dropout_add
 from .fused_ec_moe import fused_ec_moe
 from .fused_gate_attention import fused_gate_attention  # noqa: F401
 from .fused_layer_norm import fused_layer_norm
+from .fused_linear_cross_entropy import fused_linear_cross_entropy
 from .fused_matmul_bias import (
     fused_linear,
     fused_linear_activation,
@@ -34,6 +36,7 @@ from .fused_transformer import (
     fused_multi_transformer,
 )
 from .masked_multihead_attention import masked_multihead_attention
+from .moe_grouped_gemm import moe_grouped_gemm
 from .swiglu import swiglu
 from .variable_length_memory_efficient_attention import (
     variable_length_memory_efficient_attention,
@@ -56,4 +59,8 @@ __all__ = [
     "masked_multihead_attention",
     "block_multihead_attention",
     "swiglu",
+    "fp8_cast_transpose",
+    "fp8_gemm",
+    "fused_linear_cross_entropy",
+    "moe_grouped_gemm",
 ]
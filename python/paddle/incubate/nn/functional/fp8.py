@@ -0,0 +1,155 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle import _C_ops
+from paddle.base import core
+from paddle.base.framework import convert_np_dtype_to_dtype_
+
+from ....framework import LayerHelper, in_dynamic_or_pir_mode
+
+
+def fp8_cast_transpose(x, scale, fp8_format="e4m3", name=None):
+    """
+    Casts x multiplied by scale to fp8, together with its transpose, and
+    computes the max of the absolute values of x, in one pass over x.
+
+    Since Paddle has no fp8 data type, the fp8 results are held by uint8
+    tensors, which are meant to be passed to :ref:`fp8_gemm`.
+
+    Args:
+        x (Tensor): The input tensor of rank at least 2. The data type is float32, float16 or bfloat16.
+        scale (Tensor): The scale of x, a float32 tensor of shape [1].
+        fp8_format (str, optional): The fp8 format, "e4m3" or "e5m2". Default: "e4m3".
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        A tuple of 3 tensors. The first one has the shape of x, the second one is its transpose of shape [x.shape[-1], x.numel() // x.shape[-1]], and the third one is the float32 max of the absolute values of x, of shape [1].
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> paddle.set_device('gpu')
+
+            >>> x = paddle.randn([32, 64], dtype='bfloat16')
+            >>> scale = paddle.ones([1], dtype='float32')
+            >>> out, out_t, amax = F.fp8_cast_transpose(x, scale)
+            >>> print(out.shape, out_t.shape, amax.shape)
+            [32, 64] [64, 32] [1]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.fp8_cast_transpose(x, scale, fp8_format)
+
+    helper = LayerHelper("fp8_cast_transpose", **locals())
+    out = helper.create_variable_for_type_inference(dtype='uint8')
+    out_t = helper.create_variable_for_type_inference(dtype='uint8')
+    amax = helper.create_variable_for_type_inference(dtype='float32')
+    helper.append_op(
+        type="fp8_cast_transpose",
+        inputs={"x": x, "scale": scale},
+        outputs={"out": out, "out_t": out_t, "amax": amax},
+        attrs={"fp8_format": fp8_format},
+    )
+    return out, out_t, amax
+
+
+def fp8_gemm(
+    x,
+    y,
+    x_scale_inv,
+    y_scale_inv,
+    bias=None,
+    x_format="e4m3",
+    y_format="e4m3",
+    out_dtype="bfloat16",
+    name=None,
+):
+    """
+    Computes :math:`(x * x\\_scale\\_inv) (y * y\\_scale\\_inv)^T + bias` with
+    the fp8 tensor cores of GPUs of compute capability 8.9 or higher.
+
+    x and y hold fp8 data produced by :ref:`fp8_cast_transpose`. Both of them
+    are contiguous in the reduced dim K, so a weight of [K, N] should be given
+    by the transposed output of fp8_cast_transpose. At most one of x and y can
+    be in the e5m2 format, and K and N should be multiples of 16.
+
+    Args:
+        x (Tensor): The uint8 tensor of shape [..., K] holding fp8 data.
+        y (Tensor): The uint8 tensor of shape [N, K] holding fp8 data.
+        x_scale_inv (Tensor): The inverse of the scale of x, a float32 tensor of shape [1].
+        y_scale_inv (Tensor): The inverse of the scale of y, a float32 tensor of shape [1].
+        bias (Tensor, optional): The bias of shape [N], whose data type is out_dtype. Default: None.
+        x_format (str, optional): The fp8 format of x, "e4m3" or "e5m2". Default: "e4m3".
+        y_format (str, optional): The fp8 format of y, "e4m3" or "e5m2". Default: "e4m3".
+        out_dtype (str|paddle.dtype, optional): The data type of the output, float16, bfloat16 or float32. Default: "bfloat16".
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        The output tensor of shape [..., N].
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +SKIP('Requires a GPU of compute capability 8.9 or higher')
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> paddle.set_device('gpu')
+
+            >>> x = paddle.randn([32, 64], dtype='bfloat16')
+            >>> w = paddle.randn([64, 128], dtype='bfloat16')
+            >>> scale = paddle.ones([1], dtype='float32')
+            >>> x_fp8, _, _ = F.fp8_cast_transpose(x, scale)
+            >>> _, w_t_fp8, _ = F.fp8_cast_transpose(w, scale)
+            >>> out = F.fp8_gemm(x_fp8, w_t_fp8, scale, scale)
+            >>> print(out.shape)
+            [32, 128]
+    """
+    if not isinstance(out_dtype, (core.VarDesc.VarType, core.DataType)):
+        out_dtype = convert_np_dtype_to_dtype_(out_dtype)
+
+    if in_dynamic_or_pir_mode():
+        return _C_ops.fp8_gemm(
+            x,
+            y,
+            x_scale_inv,
+            y_scale_inv,
+            bias,
+            x_format,
+            y_format,
+            out_dtype,
+        )
+
+    helper = LayerHelper("fp8_gemm", **locals())
+    out = helper.create_variable_for_type_inference(dtype=out_dtype)
+    inputs = {
+        "x": x,
+        "y": y,
+        "x_scale_inv": x_scale_inv,
+        "y_scale_inv": y_scale_inv,
+    }
+    if bias is not None:
+        inputs["bias"] = bias
+    helper.append_op(
+        type="fp8_gemm",
+        inputs=inputs,
+        outputs={"out": out},
+        attrs={
+            "x_format": x_format,
+            "y_format": y_format,
+            "out_dtype": out_dtype,
+        },
+    )
+    return out
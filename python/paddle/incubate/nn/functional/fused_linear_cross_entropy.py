@@ -0,0 +1,181 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import paddle
+from paddle import distributed as dist
+from paddle.autograd import PyLayer
+from paddle.nn import functional as F
+
+
+def _chunk_logits(x, weight, start, end):
+    return paddle.matmul(x, weight[:, start:end]).astype('float32')
+
+
+def _label_in_chunk(label, start, end):
+    local = label - start
+    in_chunk = paddle.logical_and(local >= 0, local < end - start)
+    return in_chunk, paddle.clip(local, 0, end - start - 1)
+
+
+class _FusedLinearCrossEntropy(PyLayer):
+    @staticmethod
+    def forward(ctx, x, weight, label, ignore_index, chunk_size, group):
+        num_tokens = x.shape[0]
+        vocab_size = weight.shape[1]
+        vocab_start = 0 if group is None else group.rank * vocab_size
+
+        # Online logsumexp over the vocab chunks, in float32.
+        row_max = paddle.full([num_tokens], float('-inf'), dtype='float32')
+        sum_exp = paddle.zeros([num_tokens], dtype='float32')
+        label_logit = paddle.zeros([num_tokens], dtype='float32')
+        for start in range(0, vocab_size, chunk_size):
+            end = min(start + chunk_size, vocab_size)
+            logits = _chunk_logits(x, weight, start, end)
+            new_max = paddle.maximum(row_max, logits.max(axis=-1))
+            sum_exp = sum_exp * paddle.exp(row_max - new_max) + paddle.exp(
+                logits - new_max.unsqueeze(-1)
+            ).sum(axis=-1)
+            row_max = new_max
+
+            in_chunk, index = _label_in_chunk(
+                label, vocab_start + start, vocab_start + end
+            )
+            picked = paddle.take_along_axis(
+                logits, index.unsqueeze(-1), axis=-1
+            ).squeeze(-1)
+            label_logit += paddle.where(
+                in_chunk, picked, paddle.zeros_like(picked)
+            )
+
+        if group is not None:
+            # Merge the logsumexp and label logits of the vocab shards.
+            global_max = row_max.clone()
+            dist.all_reduce(global_max, op=dist.ReduceOp.MAX, group=group)
+            sum_exp = sum_exp * paddle.exp(row_max - global_max)
+            row_max = global_max
+            dist.all_reduce(sum_exp, group=group)
+            dist.all_reduce(label_logit, group=group)
+
+        lse = row_max + paddle.log(sum_exp)
+        valid = label != ignore_index
+        loss = paddle.where(valid, lse - label_logit, paddle.zeros_like(lse))
+
+        ctx.ignore_index = ignore_index
+        ctx.chunk_size = chunk_size
+        ctx.group = group
+        ctx.save_for_backward(x, weight, label, lse)
+        return loss
+
+    @staticmethod
+    def backward(ctx, grad_loss):
+        x, weight, label, lse = ctx.saved_tensor()
+        chunk_size = ctx.chunk_size
+        group = ctx.group
+        vocab_size = weight.shape[1]
+        vocab_start = 0 if group is None else group.rank * vocab_size
+
+        valid = (label != ctx.ignore_index).astype('float32')
+        grad_loss = (grad_loss.astype('float32') * valid).unsqueeze(-1)
+        grad_x = paddle.zeros(x.shape, dtype='float32')
+        grad_weight_chunks = []
+        # Recompute every chunk of logits and turn it into its gradient,
+        # softmax minus one-hot of the label.
+        for start in range(0, vocab_size, chunk_size):
+            end = min(start + chunk_size, vocab_size)
+            logits = _chunk_logits(x, weight, start, end)
+            grad_logits = paddle.exp(logits - lse.unsqueeze(-1))
+            in_chunk, index = _label_in_chunk(
+                label, vocab_start + start, vocab_start + end
+            )
+            grad_logits -= F.one_hot(index, end - start) * in_chunk.astype(
+                'float32'
+            ).unsqueeze(-1)
+            grad_logits = (grad_logits * grad_loss).astype(x.dtype)
+
+            grad_x += paddle.matmul(
+                grad_logits, weight[:, start:end], transpose_y=True
+            ).astype('float32')
+            grad_weight_chunks.append(
+                paddle.matmul(x, grad_logits, transpose_x=True)
+            )
+
+        if group is not None:
+            dist.all_reduce(grad_x, group=group)
+        grad_weight = paddle.concat(grad_weight_chunks, axis=1).astype(
+            weight.dtype
+        )
+        return grad_x.astype(x.dtype), grad_weight, None
+
+
+def fused_linear_cross_entropy(
+    x, weight, label, ignore_index=-100, chunk_size=8192, group=None, name=None
+):
+    r"""
+    Computes the softmax cross entropy of the logits :math:`x W` without
+    materializing the logits of the whole vocab.
+
+    The vocab is processed in chunks of ``chunk_size`` columns of the weight.
+    The forward pass keeps only the logsumexp and the logit of the label of
+    every token, and the backward pass recomputes the logits chunk by chunk,
+    so the peak memory holds the logits of one chunk instead of
+    ``[num_tokens, vocab_size]`` logits and their gradient.
+
+    If ``group`` is given, the weight is the shard of the vocab of the
+    current rank in the model parallel group, like the input of
+    :ref:`api_paddle_distributed_fleet_layers_mpu_ParallelCrossEntropy`, and
+    the logsumexp of the shards is merged with collective communication. x
+    should be the same on all the ranks, and its gradient is summed over the
+    group.
+
+    Args:
+        x (Tensor): The hidden states of shape [..., hidden_size]. The data type is float32, float16 or bfloat16.
+        weight (Tensor): The projection to the vocab of shape [hidden_size, vocab_size], with the data type of x.
+        label (Tensor): The int64 labels of shape [...] or [..., 1].
+        ignore_index (int, optional): The label whose loss and gradient are zero. Default: -100.
+        chunk_size (int, optional): The number of vocab columns processed at a time. Default: 8192.
+        group (Group, optional): The model parallel group the vocab is split over. Default: None.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        The float32 loss of every token, of shape [..., 1].
+
+    Examples:
+        .. code-block:: python
+
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+
+            >>> x = paddle.randn([4, 16])
+            >>> weight = paddle.randn([16, 100])
+            >>> label = paddle.randint(0, 100, [4])
+            >>> loss = F.fused_linear_cross_entropy(x, weight, label, chunk_size=32)
+            >>> print(loss.shape)
+            [4, 1]
+    """
+    assert (
+        paddle.in_dynamic_mode()
+    ), "fused_linear_cross_entropy only supports dynamic graph mode."
+    hidden_size = x.shape[-1]
+    token_shape = x.shape[:-1]
+    if len(label.shape) == len(x.shape):
+        label = label.squeeze(-1)
+    loss = _FusedLinearCrossEntropy.apply(
+        x.reshape([-1, hidden_size]),
+        weight,
+        label.reshape([-1]).astype('int64'),
+        ignore_index,
+        chunk_size,
+        group,
+    )
+    return loss.reshape([*token_shape, 1])
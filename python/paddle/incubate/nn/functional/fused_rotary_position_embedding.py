@@ -13,6 +13,7 @@
 # limitations under the License.
 
 
+import paddle
 from paddle import _C_ops
 from paddle.base.layer_helper import LayerHelper
 from paddle.framework import in_dynamic_or_pir_mode
@@ -28,6 +29,7 @@ def fused_rotary_position_embedding(
     use_neox_rotary_style=True,
     time_major=False,
     rotary_emb_base=10000.0,
+    cu_seqlens=None,
 ):
     r"""
     Fused rotary position embedding.
@@ -42,6 +44,7 @@ def fused_rotary_position_embedding(
         use_neox_rotary_style(optional|bool): When the use_neox_rotary_style is True, every two adjacent numbers are calculated. When the use_neox_rotary_style is False, the numbers corresponding to the positions of the front half and back half segments are calculated. Default True.
         time_major(optional|bool): Whether the first dimension of the q, k, v input means the time steps. If time_major is True, the shape of Tensor is [seq_len, batch_size, num_heads, head_dim], otherwise [batch_size, seq_len, num_heads, head_dime]. Defaults to False. `time_steps` means the length of input sequence.
         rotary_emb_base(optional|float): the base of the rotary embedding. Default 10000.
+        cu_seqlens (Tensor, optional): The cumulative sequence lengths of packed sequences, as in `flash_attn_unpadded`. The data type is int32 or int64 and the shape is [batch_size + 1]. If given, q, k and v are packed sequences of shape [total_seq_len, num_heads, head_dim] without padding, sin and cos are required, and the positions of every sequence start from 0. position_ids and time_major must not be given. Default None.
 
     Returns:
         out_q/out_k/out_v Tensor representing the fused rotary position embedding, has same shape and data type as `q` .
@@ -91,6 +94,34 @@ def fused_rotary_position_embedding(
               [[ 0.07116699, -0.90966797],
                [-0.03628540, -0.20202637]]]])
     """
+    if cu_seqlens is not None:
+        assert (
+            position_ids is None
+        ), "position_ids must be None when cu_seqlens is given."
+        assert not time_major, "time_major must be False with cu_seqlens."
+        assert (
+            sin is not None and cos is not None
+        ), "sin and cos are required when cu_seqlens is given."
+        # Pack the sequences as a batch of one sequence whose positions
+        # restart at the beginning of every original sequence.
+        cu_seqlens = cu_seqlens.astype('int64')
+        seqlens = cu_seqlens[1:] - cu_seqlens[:-1]
+        starts = paddle.repeat_interleave(cu_seqlens[:-1], seqlens)
+        token_ids = paddle.arange(q.shape[0], dtype='int64')
+        outs = fused_rotary_position_embedding(
+            q.unsqueeze(0),
+            k.unsqueeze(0) if k is not None else None,
+            v.unsqueeze(0) if v is not None else None,
+            sin=sin,
+            cos=cos,
+            position_ids=(token_ids - starts).unsqueeze(0),
+            use_neox_rotary_style=use_neox_rotary_style,
+            rotary_emb_base=rotary_emb_base,
+        )
+        return tuple(
+            out.squeeze(0) if out is not None else None for out in outs
+        )
+
     if in_dynamic_or_pir_mode():
         return _C_ops.fused_rotary_position_embedding(
             q,
@@ -0,0 +1,80 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from paddle import _C_ops
+
+from ....framework import LayerHelper, in_dynamic_or_pir_mode
+
+
+def moe_grouped_gemm(
+    x, weight, expert_offsets, transpose_weight=False, name=None
+):
+    r"""
+    Multiplies the tokens of every expert by the weight of the expert with one
+    grouped GEMM, on GPUs of compute capability 8.0 or higher.
+
+    The tokens of x are sorted by expert, e.g. by gathering the input with
+    the positions given by ``assign_pos``, and ``expert_offsets`` is the
+    inclusive prefix sum of the token counts of the experts given by
+    ``number_count``. The token counts are only read on the device, so
+    neither the forward nor the backward pass waits for the host, and the
+    threadblocks are balanced over the tiles of all the experts whatever the
+    number of tokens of each of them.
+
+    .. math::
+
+        out[o_{e-1}:o_e] = x[o_{e-1}:o_e] \cdot weight[e]
+
+    The rows of x after the last offset are not computed.
+
+    Args:
+        x (Tensor): The tokens sorted by expert, of shape [tokens, K]. The data type is float16 or bfloat16.
+        weight (Tensor): The weights of the experts of shape [num_experts, K, N], or [num_experts, N, K] if transpose_weight is True, with the data type of x. K and N should be multiples of 8.
+        expert_offsets (Tensor): The int64 end offsets of the tokens of the experts, of shape [num_experts].
+        transpose_weight (bool, optional): Whether to multiply by the transpose of the weight of every expert. Default: False.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        The output tensor of shape [tokens, N].
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +SKIP('Requires a GPU of compute capability 8.0 or higher')
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> paddle.set_device('gpu')
+
+            >>> x = paddle.randn([10, 64], dtype='float16')
+            >>> weight = paddle.randn([4, 64, 128], dtype='float16')
+            >>> token_counts = paddle.to_tensor([3, 0, 5, 2], dtype='int64')
+            >>> expert_offsets = paddle.cumsum(token_counts)
+            >>> out = F.moe_grouped_gemm(x, weight, expert_offsets)
+            >>> print(out.shape)
+            [10, 128]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.moe_grouped_gemm(
+            x, weight, expert_offsets, transpose_weight
+        )
+
+    helper = LayerHelper("moe_grouped_gemm", **locals())
+    out = helper.create_variable_for_type_inference(dtype=x.dtype)
+    helper.append_op(
+        type="moe_grouped_gemm",
+        inputs={"x": x, "weight": weight, "expert_offsets": expert_offsets},
+        outputs={"out": out},
+        attrs={"transpose_weight": transpose_weight},
+    )
+    return out
@@ -0,0 +1,214 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import math
+
+import paddle
+from paddle.autograd import PyLayer
+from paddle.incubate.nn import functional as F
+from paddle.nn import Layer
+from paddle.nn import functional as nn_F
+
+# The largest finite values of the fp8 formats.
+E4M3_MAX = 448.0
+E5M2_MAX = 57344.0
+
+# The indices of the tensors whose scales are tracked by FP8Meta.
+_INPUT, _WEIGHT, _GRAD_OUTPUT = 0, 1, 2
+
+
+class FP8Meta:
+    """
+    The delayed scaling state of the input, weight and output gradient of an
+    FP8Linear. Each of them is cast with a scale computed from the amax
+    history of the previous steps, and its amax in the current step is
+    appended to the history after the cast, so that the cast does not wait
+    for the amax of its own input.
+    """
+
+    def __init__(self, amax_history_len=16, margin=0):
+        self.margin = margin
+        self.fp8_max = [E4M3_MAX, E4M3_MAX, E5M2_MAX]
+        self.amax_history = [
+            paddle.zeros([amax_history_len], dtype='float32')
+            for _ in range(3)
+        ]
+        self.scale = [paddle.ones([1], dtype='float32') for _ in range(3)]
+
+    def scales(self, index):
+        scale = self.scale[index]
+        return scale, 1.0 / scale
+
+    @paddle.no_grad()
+    def record(self, index, amax):
+        history = paddle.concat([amax, self.amax_history[index][:-1]])
+        self.amax_history[index] = history
+        max_amax = history.max(keepdim=True)
+        new_scale = self.fp8_max[index] / max_amax / (2.0**self.margin)
+        self.scale[index] = paddle.where(
+            max_amax > 0, new_scale, self.scale[index]
+        )
+
+
+class _FP8LinearFunction(PyLayer):
+    @staticmethod
+    def forward(ctx, x, weight, bias, meta):
+        in_features, out_features = weight.shape
+        x_2d = x.reshape([-1, in_features])
+        x_scale, x_scale_inv = meta.scales(_INPUT)
+        w_scale, w_scale_inv = meta.scales(_WEIGHT)
+        x_fp8, x_t_fp8, x_amax = F.fp8_cast_transpose(x_2d, x_scale)
+        w_fp8, w_t_fp8, w_amax = F.fp8_cast_transpose(weight, w_scale)
+        meta.record(_INPUT, x_amax)
+        meta.record(_WEIGHT, w_amax)
+
+        out = F.fp8_gemm(
+            x_fp8,
+            w_t_fp8,
+            x_scale_inv,
+            w_scale_inv,
+            bias,
+            out_dtype=x.dtype,
+        )
+        ctx.meta = meta
+        ctx.has_bias = bias is not None
+        ctx.x_shape = x.shape
+        ctx.x_dtype = x.dtype
+        ctx.w_dtype = weight.dtype
+        ctx.save_for_backward(x_t_fp8, w_fp8, x_scale_inv, w_scale_inv)
+        return out.reshape([*x.shape[:-1], out_features])
+
+    @staticmethod
+    def backward(ctx, grad_out):
+        x_t_fp8, w_fp8, x_scale_inv, w_scale_inv = ctx.saved_tensor()
+        meta = ctx.meta
+        out_features = grad_out.shape[-1]
+        grad_2d = grad_out.reshape([-1, out_features])
+        g_scale, g_scale_inv = meta.scales(_GRAD_OUTPUT)
+        g_fp8, g_t_fp8, g_amax = F.fp8_cast_transpose(
+            grad_2d, g_scale, fp8_format="e5m2"
+        )
+        meta.record(_GRAD_OUTPUT, g_amax)
+
+        grad_x = F.fp8_gemm(
+            g_fp8,
+            w_fp8,
+            g_scale_inv,
+            w_scale_inv,
+            x_format="e5m2",
+            out_dtype=ctx.x_dtype,
+        ).reshape(ctx.x_shape)
+        grad_w = F.fp8_gemm(
+            x_t_fp8,
+            g_t_fp8,
+            x_scale_inv,
+            g_scale_inv,
+            y_format="e5m2",
+            out_dtype=ctx.w_dtype,
+        )
+        if not ctx.has_bias:
+            return grad_x, grad_w
+        return grad_x, grad_w, grad_2d.sum(axis=0)
+
+
+class FP8Linear(Layer):
+    r"""
+    A linear layer computing :math:`out = x W + b` with fp8 GEMMs in the
+    forward and backward passes, on GPUs of compute capability 8.9 or higher.
+
+    The input and the weight are cast to fp8 e4m3, and the output gradient to
+    fp8 e5m2, by per-tensor scales with delayed scaling: the scale of every
+    tensor maps the max of its last ``amax_history_len`` amaxes to the largest
+    value of its fp8 format. The weight and the bias are kept in their own
+    data type, and the outputs and gradients are computed in it too.
+
+    The layer falls back to :ref:`api_paddle_nn_functional_linear` if the GPU
+    has no fp8 tensor cores, or if the number of rows of the input, the
+    in_features or the out_features is not a multiple of 16.
+
+    Parameters:
+        in_features (int): The number of input units.
+        out_features (int): The number of output units.
+        weight_attr (ParamAttr, optional): The attribute for the weight of this layer. Default: None.
+        bias_attr (ParamAttr|bool, optional): The attribute for the bias of this layer. If it is False, no bias is added. Default: None.
+        amax_history_len (int, optional): The number of steps of amax history to compute the scales from. Default: 16.
+        margin (int, optional): The scales are divided by 2**margin to leave room for growth. Default: 0.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> from paddle.incubate.nn import FP8Linear
+            >>> paddle.set_device('gpu')
+
+            >>> linear = FP8Linear(64, 128)
+            >>> x = paddle.randn([32, 64])
+            >>> y = linear(x)
+            >>> print(y.shape)
+            [32, 128]
+    """
+
+    def __init__(
+        self,
+        in_features,
+        out_features,
+        weight_attr=None,
+        bias_attr=None,
+        amax_history_len=16,
+        margin=0,
+        name=None,
+    ):
+        super().__init__()
+        dtype = self._helper.get_default_dtype()
+        self.weight = self.create_parameter(
+            shape=[in_features, out_features],
+            attr=weight_attr,
+            dtype=dtype,
+            is_bias=False,
+        )
+        self.bias = self.create_parameter(
+            shape=[out_features], attr=bias_attr, dtype=dtype, is_bias=True
+        )
+        self.fp8_meta = FP8Meta(amax_history_len, margin)
+        self.name = name
+        self._fp8_supported = None
+
+    def _use_fp8(self, x):
+        if self._fp8_supported is None:
+            self._fp8_supported = (
+                paddle.is_compiled_with_cuda()
+                and paddle.device.cuda.get_device_capability() >= (8, 9)
+            )
+        in_features, out_features = self.weight.shape
+        rows = math.prod(x.shape[:-1])
+        return (
+            self._fp8_supported
+            and paddle.in_dynamic_mode()
+            and rows % 16 == 0
+            and in_features % 16 == 0
+            and out_features % 16 == 0
+        )
+
+    def forward(self, x):
+        if not self._use_fp8(x):
+            return nn_F.linear(x, self.weight, self.bias, self.name)
+        return _FP8LinearFunction.apply(
+            x, self.weight, self.bias, self.fp8_meta
+        )
+
+    def extra_repr(self):
+        name_str = f', name={self.name}' if self.name else ''
+        return f'in_features={self.weight.shape[0]}, out_features={self.weight.shape[1]}, dtype={self._dtype}{name_str}'
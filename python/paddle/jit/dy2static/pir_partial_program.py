@@ -466,6 +466,8 @@ class PartialProgramLayer:
         self._backend = kwargs.get('backend', None)
         self._grad_var_names = {}
         self._debug_name = None
+        # the modes (self.training) whose CINN kernels are all compiled
+        self._cinn_compiled_modes = set()
 
     def __call__(self, inputs):
         """
@@ -473,13 +475,14 @@ class PartialProgramLayer:
         """
         in_vars = self._prepare_inputs(inputs)
         out_vars = self._prepare_outputs()
-        attrs = self._prepare_attributes()
+        program, program_id = self._program_to_run()
+        attrs = self._prepare_attributes(program, program_id)
         _legacy_C_ops.pir_run_program(
             self._valid_vars(in_vars),
             self._valid_vars(self._params),
             self._valid_vars(out_vars),
             self._create_scope_vec(
-                program_id=self.program_id, use_scope_cache=True
+                program_id=program_id, use_scope_cache=True
             ),
             self._cuda_graph_vec,
             *attrs,
@@ -492,13 +495,14 @@ class PartialProgramLayer:
         In sot, inputs and outputs of partial program only contain tensors, so we can skip some step to speed up
         """
         out_vars = self._prepare_outputs()
-        attrs = self._prepare_attributes()
+        program, program_id = self._program_to_run()
+        attrs = self._prepare_attributes(program, program_id)
         _legacy_C_ops.pir_run_program(
             self._valid_vars(inputs),
             self._valid_vars(self._params),
             self._valid_vars(out_vars),
             self._create_scope_vec(
-                program_id=self.program_id, use_scope_cache=True
+                program_id=program_id, use_scope_cache=True
             ),
             self._cuda_graph_vec,
             *attrs,
@@ -554,7 +558,7 @@ class PartialProgramLayer:
 
     # whole
     @switch_to_static_graph
-    def _create_program(self, is_infer_mode=False):
+    def _create_program(self, is_infer_mode=False, use_cinn=True):
         if is_infer_mode:
 
             def pass_fn(forward_program, backward_program):
@@ -566,7 +570,7 @@ class PartialProgramLayer:
                 pm.run(forward_program)
 
                 # if-else pass
-                if self._build_strategy.build_cinn_pass:
+                if self._build_strategy.build_cinn_pass and use_cinn:
                     paddle.base.libpaddle.pir.apply_cinn_pass(forward_program)
 
                 return forward_program, backward_program
@@ -586,7 +590,7 @@ class PartialProgramLayer:
             self._set_grad_type(self._params, train_program)
 
             def pass_fn(forward_program, backward_program):
-                if self._build_strategy.build_cinn_pass:
+                if self._build_strategy.build_cinn_pass and use_cinn:
                     paddle.base.libpaddle.pir.apply_cinn_pass(forward_program)
                     paddle.base.libpaddle.pir.apply_cinn_pass(backward_program)
                 return forward_program, backward_program
@@ -634,6 +638,58 @@ class PartialProgramLayer:
     def infer_program(self):
         return self._create_program(is_infer_mode=True)
 
+    @cached_property
+    def _fallback_train_program(self):
+        return self._create_program(use_cinn=False)
+
+    @cached_property
+    def _fallback_infer_program(self):
+        return self._create_program(is_infer_mode=True, use_cinn=False)
+
+    @cached_property
+    def _fallback_train_program_id(self):
+        program_id = paddle.utils._hash_with_id(
+            self._fallback_train_program, self
+        )
+        core._set_cached_executor_build_strategy(
+            program_id, self._build_strategy
+        )
+        return program_id
+
+    @cached_property
+    def _fallback_infer_program_id(self):
+        return paddle.utils._hash_with_id(self._fallback_infer_program, self)
+
+    def _program_to_run(self):
+        """
+        Return the program to run and its id. While the CINN kernels of the
+        program are still compiled in the background, with
+        FLAGS_cinn_async_compile, it is the same program without CINN, so that
+        no run waits for the kernels.
+        """
+        if (
+            self._build_strategy.build_cinn_pass
+            and self.training not in self._cinn_compiled_modes
+        ):
+            program = self.program
+            if paddle.base.libpaddle.pir.is_cinn_compiled(
+                program.forward_program
+            ) and paddle.base.libpaddle.pir.is_cinn_compiled(
+                program.backward_program
+            ):
+                self._cinn_compiled_modes.add(self.training)
+            elif self.training:
+                return (
+                    self._fallback_train_program,
+                    self._fallback_train_program_id,
+                )
+            else:
+                return (
+                    self._fallback_infer_program,
+                    self._fallback_infer_program_id,
+                )
+        return self.program, self.program_id
+
     def _verify_program(self, main_program):
         """
         Verify that the program parameter is initialized, prune some unused params,
@@ -868,18 +924,18 @@ class PartialProgramLayer:
         self._params = required_params
         self._param_values = required_param_values
 
-    def _prepare_attributes(self):
+    def _prepare_attributes(self, program, program_id):
         attrs = [
             'forward_global_block',
-            self.program.forward_program.global_block(),
+            program.forward_program.global_block(),
             'backward_global_block',
-            self.program.backward_program.global_block(),
+            program.backward_program.global_block(),
             'is_test',
             not self.training,
             'program_id',
-            self.program_id,
+            program_id,
         ]
-        for key, val in self.program.program_attr.items():
+        for key, val in program.program_attr.items():
             attrs.append(key)
             attrs.append(val)
 
@@ -289,6 +289,13 @@ class AdamW(Optimizer):
             self._param_groups = self._parameter_list
 
         self._use_multi_tensor = None
+        # Dense GPU parameters are updated in groups by fused_adam, see
+        # _append_fused_optimize_ops
+        self._use_fused_multi_tensor = paddle.get_flags(
+            'FLAGS_optimizer_fused_multi_tensor'
+        )['FLAGS_optimizer_fused_multi_tensor']
+        # parameter name -> (beta1_pow, beta2_pow) the parameter is at
+        self._fused_beta_pows = {}
         self.regularization = None
         self._auxiliary_vars = {}
         self._already_create_accumulator = set()
@@ -559,6 +566,126 @@ class AdamW(Optimizer):
 
             return adamw_op
 
+    def _can_fuse_update(self):
+        return (
+            self._use_fused_multi_tensor
+            and framework.in_dygraph_mode()
+            and core.is_compiled_with_cuda()
+            # subclasses may customize the update of each parameter
+            and type(self)._append_optimize_op is AdamW._append_optimize_op
+            and self._lr_ratio is None
+            and not self._lazy_mode
+            and isinstance(self._weight_decay, float)
+            and not isinstance(self._beta1, (Variable, Value))
+            and not isinstance(self._beta2, (Variable, Value))
+            and not isinstance(self._epsilon, (Variable, Value))
+        )
+
+    def _get_fused_beta_pows(self, param, beta1_pow_acc, beta2_pow_acc):
+        # The beta pows are CPU tensors, they are read once and tracked here
+        # afterwards
+        if param.name not in self._fused_beta_pows:
+            self._fused_beta_pows[param.name] = (
+                float(beta1_pow_acc),
+                float(beta2_pow_acc),
+            )
+        return self._fused_beta_pows[param.name]
+
+    @framework.dygraph_only
+    def _append_fused_optimize_ops(self, target_block, parameters_and_grads):
+        """
+        Updates the dense GPU parameters with fused_adam, one launch for each
+        group of parameters sharing the dtype, the weight decay, the learning
+        rate and the beta pows, instead of one adamw per parameter.
+        """
+        if not self._can_fuse_update():
+            return parameters_and_grads
+
+        groups = defaultdict(list)
+        rest = []
+        for param, grad in parameters_and_grads:
+            if (
+                grad is None
+                or param.stop_gradient
+                or not param._is_initialized()
+                or param.is_dist()
+                or not param.place.is_gpu_place()
+                or grad.is_selected_rows()
+                or grad.dtype != param.dtype
+                or param.dtype
+                not in (paddle.float32, paddle.float16, paddle.bfloat16)
+            ):
+                self._fused_beta_pows.pop(param.name, None)
+                rest.append((param, grad))
+                continue
+            with_decay = self._apply_decay_param_fun is None or bool(
+                self._apply_decay_param_fun(param.name)
+            )
+            find_master = self._multi_precision and self._is_dtype_fp16_or_bf16(
+                param.dtype
+            )
+            beta1_pow_acc = self._get_accumulator_master(
+                self._beta1_pow_acc_str, param
+            )
+            beta2_pow_acc = self._get_accumulator_master(
+                self._beta2_pow_acc_str, param
+            )
+            key = (
+                param.dtype,
+                with_decay,
+                find_master,
+                param.optimize_attr['learning_rate'],
+                self._get_fused_beta_pows(param, beta1_pow_acc, beta2_pow_acc),
+            )
+            groups[key].append((param, grad, beta1_pow_acc, beta2_pow_acc))
+
+        for (_, with_decay, find_master, _, beta_pows), group in groups.items():
+            if len(group) < 2:
+                self._fused_beta_pows.pop(group[0][0].name, None)
+                rest.append(group[0][:2])
+                continue
+            params = [item[0] for item in group]
+            _C_ops.fused_adam_(
+                params,
+                [item[1] for item in group],
+                self._create_param_lr(group[0][:2]),
+                [
+                    self._get_accumulator_master(self._moment1_acc_str, p)
+                    for p in params
+                ],
+                [
+                    self._get_accumulator_master(self._moment2_acc_str, p)
+                    for p in params
+                ],
+                [item[2] for item in group],
+                [item[3] for item in group],
+                [self._master_weights[p.name] for p in params]
+                if find_master
+                else None,
+                None,
+                self._beta1,
+                self._beta2,
+                self._epsilon,
+                65536,
+                self._weight_decay,
+                with_decay,
+                find_master,
+                False,
+            )
+            next_beta_pows = (
+                beta_pows[0] * self._beta1,
+                beta_pows[1] * self._beta2,
+            )
+            for p in params:
+                self._fused_beta_pows[p.name] = next_beta_pows
+        return rest
+
+    @framework.dygraph_only
+    def set_state_dict(self, state_dict):
+        # The beta pows are replaced, they are read again by the next step
+        self._fused_beta_pows = {}
+        super().set_state_dict(state_dict)
+
     def __str__(self):
         return " ".join(["Weight Decay, params:", ",".join(self._params_name)])
 
@@ -1207,7 +1207,9 @@ class Optimizer:
                     if isinstance(found_inf, core.eager.Tensor):
                         self._set_auxiliary_var('found_inf', False)
                     if isinstance(parameters_and_grads, list):
-                        for param_and_grad in parameters_and_grads:
+                        for param_and_grad in self._append_fused_optimize_ops(
+                            target_block, parameters_and_grads
+                        ):
                             # Parameters can be uninitialized in pipeline parallel of semi-auto parallel.
                             # Since gradient clip and parameters update mixed up in one interface, so we
                             # need to filter again here.
@@ -1221,7 +1223,9 @@ class Optimizer:
                                     target_block, param_and_grad
                                 )
                     else:
-                        for param_and_grad in parameters_and_grads['params']:
+                        for param_and_grad in self._append_fused_optimize_ops(
+                            target_block, parameters_and_grads['params']
+                        ):
                             if (
                                 param_and_grad[1] is None
                                 or not param_and_grad[0]._is_initialized()
@@ -1952,6 +1956,19 @@ class Optimizer:
         """
         pass
 
+    @framework.dygraph_only
+    def _append_fused_optimize_ops(self, target_block, parameters_and_grads):
+        """
+        Updates the parameters that can be updated together by fused multi-tensor kernels, and returns the (param, grad) pairs left for _append_optimize_op.
+        The options of the current param group are already applied when it is called.
+        This function will be overridden in the corresponding optimizer file.
+
+        Args:
+            target_block: the block in which the loss tensor is present
+            parameters_and_grads: list of (param, grad) pairs to update
+        """
+        return parameters_and_grads
+
     def _is_dtype_fp16_or_bf16(self, dtype):
         """
         check the dtype is fp16 or the dtype is bf16
@@ -64,6 +64,8 @@ class SummaryView(Enum):
     - **SummaryView.MemoryManipulationView** : The memory manipulation summary view.
 
     - **SummaryView.UDFView** : The user defined summary view.
+
+    - **SummaryView.RooflineView** : The roofline summary view of the operators with known FLOPs or memory bytes.
     """
     DeviceView = 0
     OverView = 1
@@ -74,6 +76,7 @@ class SummaryView(Enum):
     MemoryView = 6
     MemoryManipulationView = 7
     UDFView = 8
+    RooflineView = 9
 
 
 class ProfilerState(Enum):
@@ -853,6 +856,8 @@ class Profiler:
         thread_sep=False,
         time_unit='ms',
         views=None,
+        peak_tflops=None,
+        peak_bandwidth=None,
     ):
         r"""
         Print the Summary table. Currently support overview, model, distributed, operator, memory manipulation and user-defined summary.
@@ -863,6 +868,8 @@ class Profiler:
             thread_sep(bool, optional): print op table each thread, default value is False.
             time_unit(str, optional): time unit for display, can be chosen form ['s', 'ms', 'us', 'ns'], default value is 'ms'.
             views(SummaryView|list[SummaryView], optional): summary tables to print, default to None means all views to be printed.
+            peak_tflops(float, optional): peak TFLOPS of the device, used to compare the achieved performance of the operators with the roofline, default value is None.
+            peak_bandwidth(float, optional): peak memory bandwidth of the device in GB/s, used to compare the achieved performance of the operators with the roofline, default value is None.
 
         Examples:
             .. code-block:: python
@@ -898,6 +905,8 @@ class Profiler:
                     thread_sep=thread_sep,
                     time_unit=time_unit,
                     views=views,
+                    peak_tflops=peak_tflops,
+                    peak_bandwidth=peak_bandwidth,
                 )
             )
 
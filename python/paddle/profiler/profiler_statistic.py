@@ -16,7 +16,7 @@ import re
 from enum import Enum
 
 from paddle.base.core import TracerEventType, TracerMemEventType
-from paddle.utils.flops import flops
+from paddle.utils.flops import flops, memory_bytes
 
 from .statistic_helper import (
     intersection_ranges,
@@ -104,6 +104,7 @@ class HostStatisticNode:
         self.general_gpu_time = 0  # besides kernel, include time of gpu events like memcpy and memset
         self.self_general_gpu_time = 0
         self.flops = 0
+        self.bytes = 0  # memory bytes moved, for the roofline
 
     def cal_flops(self):
         if self.hostnode.type == TracerEventType.Operator:
@@ -114,6 +115,12 @@ class HostStatisticNode:
                     self.hostnode.input_shapes,
                     self.hostnode.attributes,
                 )
+                self.bytes = memory_bytes(
+                    op_name,
+                    self.hostnode.input_shapes,
+                    self.hostnode.attributes,
+                    getattr(self.hostnode, 'dtypes', None),
+                )
 
     def cal_statistic(self):
         self.cpu_time = self.hostnode.end_ns - self.hostnode.start_ns
@@ -126,6 +133,7 @@ class HostStatisticNode:
             self.general_gpu_time += child.general_gpu_time
             self.self_cpu_time -= child.end_ns - child.start_ns
             self.flops += child.flops
+            self.bytes += child.bytes
 
         for rt in self.runtime_node:
             rt.cal_statistic()
@@ -520,11 +528,16 @@ class EventSummary:
             self.min_general_gpu_time = float('inf')
             self.max_general_gpu_time = 0
             self._flops = 0
+            self._bytes = 0
 
         @property
         def flops(self):
             return self._flops
 
+        @property
+        def bytes(self):
+            return self._bytes
+
         @property
         def avg_cpu_time(self):
             return self.cpu_time / self.call
@@ -564,6 +577,9 @@ class EventSummary:
         def add_flops(self, flops):
             self._flops += flops
 
+        def add_bytes(self, nbytes):
+            self._bytes += nbytes
+
         def add_item(self, node):
             raise NotImplementedError
 
@@ -579,6 +595,7 @@ class EventSummary:
             self.add_gpu_time(node.gpu_time)
             self.add_general_gpu_time(node.general_gpu_time)
             self.add_flops(node.flops)
+            self.add_bytes(node.bytes)
             for child in node.children_node:
                 if child.type != TracerEventType.Operator:
                     if child.name not in self.operator_inners:
@@ -601,6 +618,7 @@ class EventSummary:
             self.add_gpu_time(node.gpu_time)
             self.add_general_gpu_time(node.general_gpu_time)
             self.add_flops(node.flops)
+            self.add_bytes(node.bytes)
             for child in node.children_node:
                 if child.type != TracerEventType.Operator:
                     if child.name not in self.operator_inners:
@@ -791,6 +809,19 @@ class MemorySummary:
                 print("No corresponding type.")
             self.increase_size = self.allocation_size - self.free_size
 
+    class PeakBreakdown:
+        r"""
+        Allocations alive when the allocated memory of a place peaks.
+        """
+
+        def __init__(self, place):
+            self.place = place
+            self.peak_size = 0  # live size of the allocations profiled
+            self.untracked_size = 0  # allocated before profiling
+            self.timestamp_ns = 0
+            self.owners = {}  # owner name: [live count, live size]
+            self.allocations = []  # (size, addr, owner), largest first
+
     def __init__(self):
         self.allocated_items = collections.defaultdict(
             dict
@@ -800,6 +831,7 @@ class MemorySummary:
         )  # for memory summary, device type: event
         self.peak_allocation_values = collections.defaultdict(int)
         self.peak_reserved_values = collections.defaultdict(int)
+        self.peak_breakdowns = {}  # for memory peak breakdown, place: peak
 
     def _analyse_node_memory(self, event_name, node):
         for memnode in node.mem_node:  # self mem node
@@ -851,6 +883,76 @@ class MemorySummary:
                         self._analyse_node_memory(host_node.name, child)
                 self._analyse_node_memory(host_node.name, host_node)
 
+        place2events = collections.defaultdict(list)
+        for memnode, owner in self._collect_allocations(nodetrees):
+            place2events[memnode.place].append((memnode, owner))
+        for place, events in place2events.items():
+            self.peak_breakdowns[place] = self._analyse_peak(place, events)
+
+    def _collect_allocations(self, nodetrees):
+        r"""
+        Get the allocated memory events with the innermost operator they are
+        recorded in, or the outermost event if none.
+        """
+        allocations = []
+        for threadid, rootnode in nodetrees.items():
+            stack = [(child, None) for child in rootnode.children_node]
+            while stack:
+                node, owner = stack.pop()
+                if node.type == TracerEventType.Operator or owner is None:
+                    owner = node.name
+                for memnode in node.mem_node:
+                    if (
+                        memnode.type == TracerMemEventType.Allocate
+                        or memnode.type == TracerMemEventType.Free
+                    ):
+                        allocations.append((memnode, owner))
+                for child in node.children_node:
+                    stack.append((child, owner))
+        return allocations
+
+    def _analyse_peak(self, place, events):
+        r"""
+        Replay the allocated memory events of a place in time order to find
+        the allocations alive at the peak.
+        """
+        events.sort(key=lambda x: x[0].timestamp_ns)
+        live_sizes = {}
+        current_size = 0
+        peak_index = -1
+        peak_breakdown = MemorySummary.PeakBreakdown(place)
+        for index, (memnode, owner) in enumerate(events):
+            if memnode.type == TracerMemEventType.Allocate:
+                live_sizes[memnode.addr] = memnode.increase_bytes
+                current_size += memnode.increase_bytes
+            elif memnode.addr in live_sizes:
+                current_size -= live_sizes.pop(memnode.addr)
+            if current_size > peak_breakdown.peak_size:
+                peak_breakdown.peak_size = current_size
+                peak_index = index
+        if peak_index < 0:
+            return peak_breakdown
+
+        live_allocations = {}
+        for memnode, owner in events[: peak_index + 1]:
+            if memnode.type == TracerMemEventType.Allocate:
+                live_allocations[memnode.addr] = (memnode.increase_bytes, owner)
+            else:
+                live_allocations.pop(memnode.addr, None)
+        for addr, (size, owner) in live_allocations.items():
+            if owner not in peak_breakdown.owners:
+                peak_breakdown.owners[owner] = [0, 0]
+            peak_breakdown.owners[owner][0] += 1
+            peak_breakdown.owners[owner][1] += size
+            peak_breakdown.allocations.append((size, addr, owner))
+        peak_breakdown.allocations.sort(key=lambda x: x[0], reverse=True)
+        peak_memnode = events[peak_index][0]
+        peak_breakdown.timestamp_ns = peak_memnode.timestamp_ns
+        peak_breakdown.untracked_size = max(
+            peak_memnode.current_allocated - peak_breakdown.peak_size, 0
+        )
+        return peak_breakdown
+
 
 class StatisticData:
     r"""
@@ -879,6 +981,9 @@ def _build_table(
     row_limit=100,
     max_src_column_width=75,
     views=None,
+    peak_tflops=None,
+    peak_bandwidth=None,
+    roofline_flag_ratio=0.1,
 ):
     from .profiler import SummaryView
 
@@ -1597,6 +1702,136 @@ def _build_table(
             append('')
             append('')
 
+    if views is None or SummaryView.RooflineView in views:
+        # ----- Print Roofline Summary Report ----- #
+        roofline_items = [
+            (name, item)
+            for name, item in statistic_data.event_summary.items.items()
+            if item.flops > 0 or item.bytes > 0
+        ]
+        if roofline_items:
+            all_row_values = []
+            name_column_width = 52
+
+            def roofline_time(item):
+                # device time of the op if it launches any, else host time
+                if item.general_gpu_time > 0:
+                    return item.general_gpu_time
+                return item.cpu_time
+
+            sorted_items = sorted(
+                roofline_items,
+                key=lambda x: roofline_time(x[1]),
+                reverse=True,
+            )
+            for name, item in sorted_items:
+                time = roofline_time(item)
+                if time == 0:
+                    continue
+                achieved_flops = item.flops * 1e9 / time
+                achieved_bandwidth = item.bytes * 1e9 / time
+                if item.bytes > 0:
+                    intensity = '{:.2f}'.format(item.flops / item.bytes)
+                else:
+                    intensity = '-'
+                # the attainable performance at the arithmetic intensity of
+                # the op is min(peak FLOPS, intensity * peak bandwidth)
+                ratio = None
+                bound = '-'
+                if item.flops > 0 and peak_tflops:
+                    attainable = peak_tflops * 1e12
+                    if item.bytes > 0 and peak_bandwidth:
+                        memory_bound = item.flops / item.bytes * (
+                            peak_bandwidth * 1e9
+                        )
+                        bound = 'Compute'
+                        if memory_bound < attainable:
+                            attainable = memory_bound
+                            bound = 'Memory'
+                    ratio = achieved_flops / attainable
+                elif item.bytes > 0 and peak_bandwidth:
+                    ratio = achieved_bandwidth / (peak_bandwidth * 1e9)
+                    bound = 'Memory'
+                if ratio is None:
+                    roofline = '-'
+                elif ratio < roofline_flag_ratio:
+                    roofline = format_ratio(ratio) + ' *'
+                else:
+                    roofline = format_ratio(ratio)
+                if len(name) > name_column_width:
+                    name = name[: name_column_width - 3] + '...'
+                all_row_values.append(
+                    [
+                        name,
+                        item.call,
+                        format_time(time, unit=time_unit),
+                        _format_large_number(item.flops),
+                        _format_large_number(item.bytes),
+                        intensity,
+                        '{:.2f}'.format(achieved_flops / 1e12),
+                        '{:.2f}'.format(achieved_bandwidth / 1e9),
+                        bound,
+                        roofline,
+                    ]
+                )
+
+            headers = [
+                'Name',
+                'Calls',
+                'Time',
+                'FLOPs',
+                'Bytes',
+                'FLOP/Byte',
+                'TFLOPS',
+                'GB/s',
+                'Bound',
+                'Roofline(%)',
+            ]
+            # Calculate the column width
+            column_widths = [name_column_width] + [
+                max(
+                    [len(header)]
+                    + [len(str(row[idx])) for row in all_row_values]
+                )
+                for idx, header in enumerate(headers)
+                if idx > 0
+            ]
+            row_format_list = [""]
+            header_sep_list = [""]
+            line_length_list = [-SPACING_SIZE]
+            for width in column_widths:
+                add_column(width)
+
+            row_format = row_format_list[0]
+            header_sep = header_sep_list[0]
+            line_length = line_length_list[0]
+
+            # construct table string
+            append(add_title(line_length, "Roofline Summary"))
+            append(f'Time unit: {time_unit}')
+            if peak_tflops or peak_bandwidth:
+                append(
+                    'Peak: {} TFLOPS, {} GB/s, * marks the ops below {}% of '
+                    'the roofline'.format(
+                        peak_tflops or '-',
+                        peak_bandwidth or '-',
+                        format_ratio(roofline_flag_ratio),
+                    )
+                )
+            else:
+                append(
+                    'Peak: unknown, set peak_tflops and peak_bandwidth of '
+                    'summary to compare with the roofline'
+                )
+            append(header_sep)
+            append(row_format.format(*headers))
+            append(header_sep)
+            for row_values in all_row_values:
+                append(row_format.format(*row_values))
+            append(header_sep)
+            append('')
+            append('')
+
     if views is None or SummaryView.KernelView in views:
         # ----- Print Kernel Summary Report ----- #
         if statistic_data.event_summary.kernel_items:
@@ -2010,4 +2245,91 @@ def _build_table(
                 append('')
                 append('')
 
+                peak_breakdown = (
+                    statistic_data.memory_summary.peak_breakdowns.get(
+                        device_type
+                    )
+                )
+                if peak_breakdown is None or peak_breakdown.peak_size == 0:
+                    continue
+                # ----- Print Memory Peak Breakdown ----- #
+                total_size = (
+                    peak_breakdown.peak_size + peak_breakdown.untracked_size
+                )
+                all_row_values = []
+                for owner, (count, size) in sorted(
+                    peak_breakdown.owners.items(),
+                    key=lambda x: x[1][1],
+                    reverse=True,
+                ):
+                    all_row_values.append(
+                        [
+                            owner,
+                            count,
+                            size,
+                            format_ratio(float(size) / total_size),
+                        ]
+                    )
+                if peak_breakdown.untracked_size > 0:
+                    all_row_values.append(
+                        [
+                            'Allocated before profiling',
+                            '-',
+                            peak_breakdown.untracked_size,
+                            format_ratio(
+                                float(peak_breakdown.untracked_size)
+                                / total_size
+                            ),
+                        ]
+                    )
+                all_row_values.append("Largest Live Allocations")
+                for size, addr, owner in peak_breakdown.allocations[:10]:
+                    all_row_values.append(
+                        [
+                            owner,
+                            hex(addr),
+                            size,
+                            format_ratio(float(size) / total_size),
+                        ]
+                    )
+
+                headers = ['Name', 'Count / Addr', 'Live Size', 'Ratio(%)']
+                row_format_list = [""]
+                header_sep_list = [""]
+                line_length_list = [-SPACING_SIZE]
+                add_column(name_column_width)
+                add_column(number_column_width)
+                add_column(number_column_width)
+                add_column(number_column_width)
+
+                row_format = row_format_list[0]
+                header_sep = header_sep_list[0]
+                line_length = line_length_list[0]
+
+                # construct table string
+                append(
+                    add_title(
+                        line_length, f"Memory Peak Breakdown - {device_type}"
+                    )
+                )
+                append(
+                    'Allocated Memory at Peak: {}, at {} ns'.format(
+                        total_size, peak_breakdown.timestamp_ns
+                    )
+                )
+                append(header_sep)
+                append(row_format.format(*headers))
+                append(header_sep)
+                for row_values in all_row_values:
+                    if isinstance(row_values, str):
+                        append(add_title(line_length, row_values))
+                    else:
+                        if len(row_values[0]) > name_column_width:
+                            row_values[0] = (
+                                row_values[0][: name_column_width - 3] + '...'
+                            )
+                        append(row_format.format(*row_values))
+                append('')
+                append('')
+
     return ''.join(result)
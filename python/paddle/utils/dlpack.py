@@ -64,10 +64,15 @@ def to_dlpack(x):
 
 def from_dlpack(dlpack):
     """
-    Decodes a DLPack to a tensor.
+    Decodes a DLPack to a tensor without copying, the tensor shares the
+    memory of the producer and keeps its strides.
 
     Args:
-        dlpack (PyCapsule): a PyCapsule object with the dltensor.
+        dlpack (PyCapsule|object): a PyCapsule object with the dltensor, or
+            an object with ``__dlpack__`` and ``__dlpack_device__``, e.g. a
+            tensor of another framework. The current stream of Paddle waits
+            for the work of the producer on GPU without a device
+            synchronization.
 
     Returns:
         out (Tensor), a tensor decoded from DLPack. One thing to be noted, if we get
@@ -89,6 +94,15 @@ def from_dlpack(dlpack):
                     [0.10000000, 0.20000000, 0.60000002, 0.69999999]])
     """
 
+    if hasattr(dlpack, "__dlpack__"):
+        device_type, device_id = dlpack.__dlpack_device__()
+        # kDLGPU
+        if device_type == 2:
+            stream = paddle.device.cuda.current_stream(device_id)
+            dlpack = dlpack.__dlpack__(stream=stream.cuda_stream)
+        else:
+            dlpack = dlpack.__dlpack__()
+
     t = type(dlpack)
     dlpack_flag = t.__module__ == 'builtins' and t.__name__ == 'PyCapsule'
     if not dlpack_flag:
@@ -99,7 +113,8 @@ def from_dlpack(dlpack):
 
     if in_dygraph_mode():
         out = paddle.base.core.from_dlpack(dlpack)
-        out = paddle.to_tensor(out)
+        # shares the memory instead of paddle.to_tensor, which copies
+        out = paddle.base.core.eager.Tensor(value=out, place=out._place())
         return out
 
     out = paddle.base.core.from_dlpack(dlpack)
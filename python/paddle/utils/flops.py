@@ -15,6 +15,25 @@
 import copy
 
 _FLOPS_COMPUTE_FUNC_MAP = {}
+_MEMORY_BYTES_FUNC_MAP = {}
+
+# element size of the dtypes recorded by the profiler, see VarType.Type
+_DTYPE_SIZE = {
+    'BOOL': 1,
+    'INT8': 1,
+    'UINT8': 1,
+    'FP8_E4M3FN': 1,
+    'FP8_E5M2': 1,
+    'INT16': 2,
+    'FP16': 2,
+    'BF16': 2,
+    'INT32': 4,
+    'FP32': 4,
+    'INT64': 8,
+    'FP64': 8,
+    'COMPLEX64': 8,
+    'COMPLEX128': 16,
+}
 
 
 def prod(s):
@@ -61,6 +80,62 @@ def register_flops(op_type):
     return register
 
 
+def memory_bytes(
+    op_type: str, input_shapes: dict, attrs: dict, dtypes: dict = None
+) -> int:
+    """
+    count the bytes read from and written to memory by operation, assuming
+    every input and output is accessed exactly once.
+
+    Args:
+        op_type (str): the type of operation.
+        input_shapes (dict): the shapes of inputs.
+        attrs (dict): the attributes of the operation.
+        dtypes (dict, optional): the dtypes of inputs, float32 is assumed
+            for the inputs without dtype.
+
+    Returns:
+        the total bytes moved by the operation.
+    """
+
+    if op_type not in _MEMORY_BYTES_FUNC_MAP:
+        return 0
+    else:
+        func = _MEMORY_BYTES_FUNC_MAP[op_type]
+        try:
+            nbytes = func(input_shapes, attrs, dtypes or {})
+        except Exception as e:
+            return 0
+        return nbytes
+
+
+def register_memory_bytes(op_type):
+    """
+    register memory bytes computation function for operation.
+    """
+
+    def register(func):
+        global _MEMORY_BYTES_FUNC_MAP
+        _MEMORY_BYTES_FUNC_MAP[op_type] = func
+        return func
+
+    return register
+
+
+def _dtype_size(dtypes, name, idx=0):
+    names = dtypes.get(name, [])
+    if idx < len(names):
+        return _DTYPE_SIZE.get(names[idx].upper(), 4)
+    return 4
+
+
+def _tensor_bytes(input_shapes, dtypes, name):
+    nbytes = 0
+    for idx, shape in enumerate(input_shapes.get(name, [])):
+        nbytes += prod(shape) * _dtype_size(dtypes, name, idx)
+    return nbytes
+
+
 @register_flops("c_embedding")
 def _c_embedding_flops(input_shapes, attrs):
     """FLOPs computation for c_embedding op.
@@ -375,3 +450,94 @@ def _pool_flops(input_shapes, attrs):
     """
     input = input_shapes.get('X')[0]
     return prod(input)
+
+
+def _unary_memory_bytes(input_shapes, attrs, dtypes):
+    """Memory bytes computation for the ops writing an output like the input.
+    For relu/gelu/softmax/dropout/transpose2... (input):
+        equation: bytes = 2 * (numel * sizeof(dtype)) of the input tensor.
+    """
+    return 2 * _tensor_bytes(input_shapes, dtypes, 'X')
+
+
+for _op_type in [
+    'dropout',
+    'elu',
+    'gelu',
+    'leaky_relu',
+    'relu',
+    'relu6',
+    'silu',
+    'softmax',
+    'transpose2',
+]:
+    register_memory_bytes(_op_type)(_unary_memory_bytes)
+
+
+def _elementwise_memory_bytes(input_shapes, attrs, dtypes):
+    """Memory bytes computation for elementwise ops.
+    For elementwise_add/elementwise_mul/elementwise_div(input, other):
+        equation: bytes = bytes(input) + bytes(other) + bytes(output), where
+        the output has the broadcast shape and the dtype of the input.
+    """
+    output = _elementwise_flops_compute(input_shapes, attrs)
+    return (
+        _tensor_bytes(input_shapes, dtypes, 'X')
+        + _tensor_bytes(input_shapes, dtypes, 'Y')
+        + output * _dtype_size(dtypes, 'X')
+    )
+
+
+for _op_type in ['elementwise_add', 'elementwise_mul', 'elementwise_div']:
+    register_memory_bytes(_op_type)(_elementwise_memory_bytes)
+
+
+@register_memory_bytes("layer_norm")
+def _layer_norm_memory_bytes(input_shapes, attrs, dtypes):
+    """Memory bytes computation for layer_norm op.
+    For layer_norm(input, scale, bias):
+        equation: bytes = 2 * bytes(input) + bytes(scale) + bytes(bias)
+    """
+    return (
+        2 * _tensor_bytes(input_shapes, dtypes, 'X')
+        + _tensor_bytes(input_shapes, dtypes, 'Scale')
+        + _tensor_bytes(input_shapes, dtypes, 'Bias')
+    )
+
+
+def _matmul_memory_bytes(input_shapes, dtypes, trans_x, trans_y):
+    """Memory bytes computation for matmul ops.
+    For matmul(input, other):
+        equation: bytes = bytes(input) + bytes(other) + bytes(output), where
+        the output has the dtype of the input.
+    """
+    x_name = 'X' if 'X' in input_shapes else 'x'
+    y_name = 'Y' if 'Y' in input_shapes else 'y'
+    flops = _matmul_v2_flops(
+        {'X': input_shapes[x_name], 'Y': input_shapes[y_name]},
+        {'trans_x': trans_x, 'trans_y': trans_y},
+    )
+    x_shape = input_shapes[x_name][0]
+    k = x_shape[-2] if trans_x else x_shape[-1]
+    return (
+        _tensor_bytes(input_shapes, dtypes, x_name)
+        + _tensor_bytes(input_shapes, dtypes, y_name)
+        + flops // (2 * k) * _dtype_size(dtypes, x_name)
+    )
+
+
+@register_memory_bytes("matmul")
+def _matmul_memory_bytes_v1(input_shapes, attrs, dtypes):
+    return _matmul_memory_bytes(
+        input_shapes,
+        dtypes,
+        attrs.get('transpose_X') or attrs.get('transpose_x'),
+        attrs.get('transpose_Y') or attrs.get('transpose_y'),
+    )
+
+
+@register_memory_bytes("matmul_v2")
+def _matmul_v2_memory_bytes(input_shapes, attrs, dtypes):
+    return _matmul_memory_bytes(
+        input_shapes, dtypes, attrs.get('trans_x'), attrs.get('trans_y')
+    )
@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import os
 import tempfile
 import unittest
 
@@ -157,6 +158,31 @@ class TestDistCheckpointUtils(test_base.CommunicationTestDistBase):
 
         ckpt_dir_tmp.cleanup()
 
+    def test_raw_storage(self):
+        ckpt_dir_tmp = tempfile.TemporaryDirectory()
+        ckpt_dir = ckpt_dir_tmp.name
+        state_dict = {
+            "w1": paddle.arange(32, dtype="float32").reshape([4, 8]),
+            "w2": paddle.to_tensor(3.0),
+            "w3": paddle.arange(5, dtype="int64"),
+        }
+        dist.save_state_dict(state_dict, ckpt_dir, raw_storage=True)
+        metadata = paddle.load(os.path.join(ckpt_dir, "0.metadata"))
+        self.assertTrue(len(metadata.storage_layout) == 3)
+        for byte_offset, _ in metadata.storage_layout.values():
+            self.assertTrue(byte_offset % 64 == 0)
+
+        new_state_dict = {
+            "w1": paddle.zeros([4, 8], dtype="float32").cpu(),
+            "w2": paddle.zeros([], dtype="float32").cpu(),
+            "w3": paddle.zeros([5], dtype="int64").cpu(),
+        }
+        dist.load_state_dict(new_state_dict, ckpt_dir, num_threads=2)
+        for k, v in state_dict.items():
+            np.testing.assert_equal(v.numpy(), new_state_dict[k].numpy())
+
+        ckpt_dir_tmp.cleanup()
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,113 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import contextlib
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestActivationOffload(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.set_device('gpu')
+        np.random.seed(2024)
+        self.x_np = np.random.random([64, 64]).astype('float32')
+        self.w_np = np.random.random([64, 64]).astype('float32')
+
+    def scope(self, offload):
+        # min_bytes 0 offloads every saved activation
+        if offload:
+            return paddle.autograd.offload_activations(min_bytes=0)
+        return contextlib.nullcontext()
+
+    def inputs(self):
+        x = paddle.to_tensor(self.x_np, stop_gradient=False)
+        w = paddle.to_tensor(self.w_np, stop_gradient=False)
+        return x, w
+
+    def forward(self, x, w):
+        y = paddle.nn.functional.relu(paddle.matmul(x, w))
+        z = paddle.tanh(y) * y
+        return paddle.matmul(z, w).mean()
+
+    def run_grads(self, offload):
+        x, w = self.inputs()
+        with self.scope(offload):
+            loss = self.forward(x, w)
+        loss.backward()
+        return loss.numpy(), x.grad.numpy(), w.grad.numpy()
+
+    def test_grads(self):
+        expected = self.run_grads(offload=False)
+        actual = self.run_grads(offload=True)
+        for out, ref in zip(actual, expected):
+            np.testing.assert_allclose(out, ref, rtol=1e-6)
+
+    def run_retain_graph(self, offload):
+        x, w = self.inputs()
+        with self.scope(offload):
+            loss = self.forward(x, w)
+        loss.backward(retain_graph=True)
+        first = x.grad.numpy().copy()
+        x.clear_gradient()
+        w.clear_gradient()
+        loss.backward()
+        return first, x.grad.numpy(), w.grad.numpy()
+
+    def test_retain_graph(self):
+        expected = self.run_retain_graph(offload=False)
+        actual = self.run_retain_graph(offload=True)
+        np.testing.assert_allclose(actual[0], actual[1], rtol=1e-6)
+        for out, ref in zip(actual, expected):
+            np.testing.assert_allclose(out, ref, rtol=1e-6)
+
+    def test_inplace_before_save(self):
+        # an inplace update before the tensor is saved is fine
+        grads = []
+        for offload in [False, True]:
+            x, w = self.inputs()
+            with self.scope(offload):
+                y = paddle.matmul(x, w)
+                y[0:1] = 3.0
+                loss = (y * y).mean()
+            loss.backward()
+            grads.append((x.grad.numpy(), w.grad.numpy()))
+        for out, ref in zip(grads[1], grads[0]):
+            np.testing.assert_allclose(out, ref, rtol=1e-6)
+
+    def test_inplace_after_save(self):
+        # the saved tensor is copied when offloaded, an inplace update after
+        # is still an error as without offload
+        for offload in [False, True]:
+            x, w = self.inputs()
+            with self.scope(offload):
+                y = paddle.matmul(x, w)
+                z = y * y
+                y[0:1] = 3.0
+                loss = z.mean()
+            with self.assertRaisesRegex(
+                RuntimeError, "modified by an inplace operation"
+            ):
+                loss.backward()
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -283,6 +283,62 @@ class TestDistTraining(unittest.TestCase):
 
             np.testing.assert_allclose(loss_a.numpy(), loss_b.numpy())
 
+    def test_sharded_embedding_bag(self):
+        batch_size = 17
+        bag_size = 5
+        vocab_size_per_card = 3
+        vocab_size = vocab_size_per_card * self.model_parallel_size
+        hidden_size = 4
+        seed = 1237
+
+        set_random_seed(seed)
+
+        model_a = fleet.meta_parallel.ShardedEmbeddingBag(
+            vocab_size, hidden_size, pooling="mean"
+        )
+
+        check_group = dist.new_group(list(range(self.model_parallel_size)))
+        integral_w = []
+        partial_w = model_a.weight.clone().detach()
+        paddle.distributed.all_gather(integral_w, partial_w, group=check_group)
+        integral_w = paddle.concat(integral_w, axis=0)
+
+        model_b = SimpleEmbedding(vocab_size, hidden_size, integral_w)
+
+        optimizer_a = paddle.optimizer.SGD(
+            learning_rate=0.001, parameters=model_a.parameters()
+        )
+        # the shards get the grads of the ids of all the ranks, which feed
+        # the same ids here
+        optimizer_b = paddle.optimizer.SGD(
+            learning_rate=0.001 * self.model_parallel_size,
+            parameters=model_b.parameters(),
+        )
+
+        for _ in range(5):
+            np_input_data = np.random.randint(
+                0, vocab_size, (batch_size, bag_size)
+            )
+            input_data = paddle.to_tensor(np_input_data, dtype="int64")
+
+            output_a = model_a(input_data)
+            loss_a = (output_a * output_a).sum()
+
+            output_b = model_b(input_data).mean(axis=1)
+            loss_b = (output_b * output_b).sum()
+
+            loss_a.backward()
+            loss_b.backward()
+
+            optimizer_a.step()
+            optimizer_b.step()
+            optimizer_a.clear_grad()
+            optimizer_b.clear_grad()
+
+            np.testing.assert_allclose(
+                loss_a.numpy(), loss_b.numpy(), rtol=1e-5, atol=1e-6
+            )
+
     def test_parallel_cross_entropy(self):
         batch_size = 8
         seq_length = 16
@@ -579,6 +579,22 @@ class TestDistSPTraining3(TestDistSPTraining):
         return model_a, optimizer_a, model_b, optimizer_b
 
 
+class TestDistSPTrainingCollectiveMatmul(TestDistSPTraining):
+    def setUp(self):
+        strategy = fleet.DistributedStrategy()
+        self.model_parallel_size = 2
+        self.data_parallel_size = 1
+        strategy.hybrid_configs = {
+            "dp_degree": self.data_parallel_size,
+            "mp_degree": self.model_parallel_size,
+            "pp_degree": 1,
+            "mp_configs": {
+                "sp_collective_matmul": True,
+            },
+        }
+        fleet.init(is_collective=True, strategy=strategy)
+
+
 class SimpleSPNetWithoutBias(paddle.nn.Layer):
     def __init__(
         self,
@@ -844,5 +860,23 @@ class TestDistSPTrainingWithoutBias3(TestDistSPTrainingWithoutBias2):
         return model_a, optimizer_a, model_b, optimizer_b
 
 
+class TestDistSPTrainingWithoutBiasCollectiveMatmul(
+    TestDistSPTrainingWithoutBias
+):
+    def setUp(self):
+        strategy = fleet.DistributedStrategy()
+        self.model_parallel_size = 2
+        self.data_parallel_size = 1
+        strategy.hybrid_configs = {
+            "dp_degree": self.data_parallel_size,
+            "mp_degree": self.model_parallel_size,
+            "pp_degree": 1,
+            "mp_configs": {
+                "sp_collective_matmul": True,
+            },
+        }
+        fleet.init(is_collective=True, strategy=strategy)
+
+
 if __name__ == "__main__":
     unittest.main()
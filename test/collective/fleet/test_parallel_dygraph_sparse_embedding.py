@@ -63,6 +63,46 @@ class TestParallelDygraphSparseEmbeddingFP64(TestDistBase):
             )
 
 
+class TestParallelDygraphSparseEmbeddingPartition(TestDistBase):
+    def _setup_config(self):
+        self._sync_mode = False
+        self._nccl2_mode = True
+        self._dygraph = True
+
+    def test_sparse_embedding_partition(self):
+        # each row is merged by the rank owning it, then all-gathered
+        if base.core.is_compiled_with_cuda():
+            self.check_with_place(
+                os.path.abspath(
+                    "../../legacy_test/parallel_dygraph_sparse_embedding.py"
+                ),
+                delta=1e-5,
+                check_error_log=True,
+                need_envs={"FLAGS_eager_reducer_sparse_allreduce": "partition"},
+                log_name=flag_name,
+            )
+
+
+class TestParallelDygraphSparseEmbeddingAsDense(TestDistBase):
+    def _setup_config(self):
+        self._sync_mode = False
+        self._nccl2_mode = True
+        self._dygraph = True
+
+    def test_sparse_embedding_as_dense(self):
+        # the rows of the grads always add up to more than 1% of the height
+        if base.core.is_compiled_with_cuda():
+            self.check_with_place(
+                os.path.abspath(
+                    "../../legacy_test/parallel_dygraph_sparse_embedding.py"
+                ),
+                delta=1e-5,
+                check_error_log=True,
+                need_envs={"FLAGS_eager_reducer_sparse_dense_ratio": "0.01"},
+                log_name=flag_name,
+            )
+
+
 class TestParallelDygraphSparseEmbeddingSpawn(TestDistSpawnRunner):
     def test_sparse_embedding_with_spawn(self):
         if base.core.is_compiled_with_cuda():
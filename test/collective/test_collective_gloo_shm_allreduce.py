@@ -0,0 +1,134 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import multiprocessing
+import socket
+import traceback
+import unittest
+from contextlib import closing
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+# not a multiple of the chunk, so the last chunk is partial
+SHAPE = [7, 37]
+DTYPES = ["float32", "float64", "int32", "int64"]
+REDUCE_OPS = {
+    "sum": (core.ReduceOp.SUM, np.sum),
+    "max": (core.ReduceOp.MAX, np.max),
+    "min": (core.ReduceOp.MIN, np.min),
+    "prod": (core.ReduceOp.PRODUCT, np.prod),
+}
+
+
+def make_input(rank, dtype, op_name):
+    rng = np.random.RandomState(2024 + rank)
+    if op_name == "prod":
+        # keep the product of the ranks small and exact
+        return rng.randint(1, 3, SHAPE).astype(dtype)
+    return (rng.random_sample(SHAPE) * 100).astype(dtype)
+
+
+def run_rank(rank, nranks, port, flags, out_dict):
+    try:
+        paddle.set_flags(flags)
+        paddle.device.set_device("cpu")
+        store = core.TCPStore("127.0.0.1", port, rank == 0, nranks, 30)
+        pg = core.ProcessGroupGloo.create(store, rank, nranks)
+        for dtype in DTYPES:
+            for op_name, (reduce_op, _) in REDUCE_OPS.items():
+                tensor = paddle.to_tensor(make_input(rank, dtype, op_name))
+                pg.allreduce(tensor, reduce_op).wait()
+                out_dict[(rank, dtype, op_name)] = tensor.numpy()
+        out_dict[rank] = ""
+    except Exception:
+        out_dict[rank] = traceback.format_exc()
+
+
+class TestGlooShmAllReduce(unittest.TestCase):
+    def find_free_port(self):
+        with closing(socket.socket(socket.AF_INET, socket.SOCK_STREAM)) as s:
+            s.bind(('', 0))
+            return s.getsockname()[1]
+
+    def check_allreduce(self, flags, nranks=4):
+        manager = multiprocessing.Manager()
+        out_dict = manager.dict()
+        port = self.find_free_port()
+        jobs = []
+        for rank in range(nranks):
+            p = multiprocessing.Process(
+                target=run_rank, args=(rank, nranks, port, flags, out_dict)
+            )
+            jobs.append(p)
+            p.start()
+        for p in jobs:
+            p.join(timeout=240)
+            self.assertEqual(p.exitcode, 0)
+        for rank in range(nranks):
+            self.assertEqual(out_dict[rank], "")
+        for dtype in DTYPES:
+            for op_name, (_, np_reduce) in REDUCE_OPS.items():
+                expected = np_reduce(
+                    np.stack(
+                        [
+                            make_input(rank, dtype, op_name)
+                            for rank in range(nranks)
+                        ]
+                    ),
+                    axis=0,
+                ).astype(dtype)
+                for rank in range(nranks):
+                    np.testing.assert_allclose(
+                        out_dict[(rank, dtype, op_name)],
+                        expected,
+                        rtol=1e-5,
+                        err_msg=f"rank {rank}, {dtype}, {op_name}",
+                    )
+
+    def test_shm_allreduce(self):
+        # small slots to reduce the tensors chunk by chunk
+        self.check_allreduce(
+            {
+                "FLAGS_gloo_shm_allreduce": True,
+                "FLAGS_gloo_shm_buffer_size": 256,
+            }
+        )
+
+    def test_shm_allreduce_two_ranks(self):
+        self.check_allreduce(
+            {
+                "FLAGS_gloo_shm_allreduce": True,
+                "FLAGS_gloo_shm_buffer_size": 256,
+            },
+            nranks=2,
+        )
+
+    def test_fallback_on_setup_failure(self):
+        # the segment cannot be allocated, all the ranks keep gloo
+        self.check_allreduce(
+            {
+                "FLAGS_gloo_shm_allreduce": True,
+                "FLAGS_gloo_shm_buffer_size": 1 << 50,
+            }
+        )
+
+    def test_shm_allreduce_off(self):
+        self.check_allreduce({"FLAGS_gloo_shm_allreduce": False})
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,101 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_planner.h"
+
+#include "gtest/gtest.h"
+
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/distributed/auto_parallel/process_mesh.h"
+
+namespace phi {
+namespace distributed {
+namespace tests {
+
+TensorDistAttr MakeDistAttr(const ProcessMesh& mesh,
+                            const DDim& dims,
+                            const std::vector<int64_t>& dims_mapping) {
+  TensorDistAttr dist_attr(common::vectorize(dims));
+  dist_attr.set_process_mesh(mesh);
+  dist_attr.set_dims_mapping(dims_mapping);
+  return dist_attr;
+}
+
+int64_t CountSteps(const ReshardPlan& plan, ReshardStep::Type type) {
+  int64_t count = 0;
+  for (const auto& step : plan.steps) {
+    count += step.type == type;
+  }
+  return count;
+}
+
+TEST(reshard_planner, swap_shard_dims) {
+  ProcessMesh mesh({2, 2}, {0, 1, 2, 3}, {"x", "y"});
+  DDim dims({1024, 1024});
+  auto in_dist_attr = MakeDistAttr(mesh, dims, {0, 1});
+  auto out_dist_attr = MakeDistAttr(mesh, dims, {1, 0});
+
+  auto plan = ReshardPlanner::Instance().GetPlan(
+      in_dist_attr, out_dist_attr, dims, DataType::FLOAT32);
+  // gathers one dim only, and moves the other with an all to all
+  EXPECT_EQ(plan.steps.size(), 3UL);
+  EXPECT_EQ(CountSteps(plan, ReshardStep::Type::kSToR), 1);
+  EXPECT_EQ(CountSteps(plan, ReshardStep::Type::kSToS), 1);
+  EXPECT_EQ(CountSteps(plan, ReshardStep::Type::kRToS), 1);
+
+  // the all gathers of the fixed decomposition on both axes
+  int64_t local_bytes = 512 * 512 * 4;
+  double gather_cost =
+      ReshardStepCost(mesh, {ReshardStep::Type::kSToR, 1, 1}, local_bytes) +
+      ReshardStepCost(mesh, {ReshardStep::Type::kSToR, 0, 0}, local_bytes * 2);
+  EXPECT_LT(plan.cost, gather_cost);
+
+  auto cached_plan = ReshardPlanner::Instance().GetPlan(
+      in_dist_attr, out_dist_attr, dims, DataType::FLOAT32);
+  EXPECT_EQ(cached_plan.steps.size(), plan.steps.size());
+  EXPECT_EQ(cached_plan.cost, plan.cost);
+}
+
+TEST(reshard_planner, move_shard_dim) {
+  ProcessMesh mesh({2, 4}, {0, 1, 2, 3, 4, 5, 6, 7}, {"x", "y"});
+  DDim dims({64, 64, 64});
+  auto in_dist_attr = MakeDistAttr(mesh, dims, {0, -1, 1});
+  auto out_dist_attr = MakeDistAttr(mesh, dims, {-1, 0, 1});
+
+  auto plan = ReshardPlanner::Instance().GetPlan(
+      in_dist_attr, out_dist_attr, dims, DataType::FLOAT32);
+  ASSERT_EQ(plan.steps.size(), 1UL);
+  EXPECT_EQ(plan.steps[0].type, ReshardStep::Type::kSToS);
+  EXPECT_EQ(plan.steps[0].mesh_axis, 0);
+  EXPECT_EQ(plan.steps[0].in_dim, 0);
+  EXPECT_EQ(plan.steps[0].out_dim, 1);
+}
+
+TEST(reshard_planner, partial_to_shard) {
+  ProcessMesh mesh({2, 2}, {0, 1, 2, 3}, {"x", "y"});
+  DDim dims({16, 16});
+  auto in_dist_attr = MakeDistAttr(mesh, dims, {-1, 1});
+  in_dist_attr.set_partial_status(std::vector<int64_t>{0});
+  auto out_dist_attr = MakeDistAttr(mesh, dims, {0, 1});
+
+  auto plan = ReshardPlanner::Instance().GetPlan(
+      in_dist_attr, out_dist_attr, dims, DataType::FLOAT32);
+  ASSERT_EQ(plan.steps.size(), 1UL);
+  EXPECT_EQ(plan.steps[0].type, ReshardStep::Type::kPToS);
+  EXPECT_EQ(plan.steps[0].out_dim, 0);
+}
+
+}  // namespace tests
+}  // namespace distributed
+}  // namespace phi
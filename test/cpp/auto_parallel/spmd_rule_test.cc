@@ -12,9 +12,12 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/common/scalar.h"
 #include "test/cpp/auto_parallel/spmd_rule_test_util.h"
 
+COMMON_DECLARE_bool(auto_parallel_spmd_rule_cache);
+
 namespace paddle {
 namespace distributed {
 namespace auto_parallel {
@@ -1852,6 +1855,74 @@ TEST(CumSumGradInferSpmd, Ctor) {
             std::vector<int64_t>({-1, -1, -1}));
 }
 
+
+TEST(SpmdRuleCache, Ctor) {
+  std::vector<int64_t> x_shape = {64, 32};
+  std::vector<int64_t> y_shape = {32, 48};
+
+  std::vector<int64_t> mesh_shape = {2, 3};
+  std::vector<int64_t> process_ids = {0, 1, 2, 3, 4, 5};
+  std::vector<std::string> dim_names = {"x", "y"};
+  ProcessMesh process_mesh(mesh_shape, process_ids, dim_names);
+
+  TensorDistAttr x_dist_attr = TensorDistAttr();
+  x_dist_attr.set_process_mesh(process_mesh);
+  x_dist_attr.set_dims_mapping(std::vector<int64_t>({1, -1}));
+  x_dist_attr.set_dynamic_dims(std::vector<bool>({false, false}));
+
+  TensorDistAttr y_dist_attr = TensorDistAttr();
+  y_dist_attr.set_process_mesh(process_mesh);
+  y_dist_attr.set_dims_mapping(std::vector<int64_t>({-1, -1}));
+  y_dist_attr.set_dynamic_dims(std::vector<bool>({false, false}));
+
+  phi::distributed::DistMetaTensor x(phi::make_ddim(x_shape), x_dist_attr);
+  phi::distributed::DistMetaTensor y(phi::make_ddim(y_shape), y_dist_attr);
+
+  int rule_calls = 0;
+  auto infer = [&](const phi::distributed::DistMetaTensor& lhs,
+                   const phi::distributed::DistMetaTensor& rhs,
+                   bool trans_x,
+                   bool trans_y) {
+    return phi::distributed::CachedInferSpmd(
+        "spmd_rule_cache_test",
+        [&]() {
+          ++rule_calls;
+          return phi::distributed::MatmulInferSpmd(lhs, rhs, trans_x, trans_y);
+        },
+        lhs,
+        rhs,
+        trans_x,
+        trans_y);
+  };
+
+  // the second call with equal args hits the cache
+  auto first = infer(x, y, false, false);
+  auto second = infer(x, y, false, false);
+  EXPECT_EQ(rule_calls, 1);
+  EXPECT_EQ(first.first.size(), second.first.size());
+  EXPECT_EQ(first.second.size(), second.second.size());
+  EXPECT_EQ(get_dims_mapping(second.first[0]), std::vector<int64_t>({1, -1}));
+  EXPECT_EQ(get_dims_mapping(second.second[0]),
+            std::vector<int64_t>({1, -1}));
+
+  // an attribute or a dims mapping of other value misses it
+  infer(x, y, true, false);
+  EXPECT_EQ(rule_calls, 2);
+  y_dist_attr.set_dims_mapping({-1, 0});
+  y = phi::distributed::DistMetaTensor(phi::make_ddim(y_shape), y_dist_attr);
+  auto third = infer(x, y, false, false);
+  EXPECT_EQ(rule_calls, 3);
+  EXPECT_EQ(get_dims_mapping(third.second[0]), std::vector<int64_t>({1, 0}));
+
+  // the cache is bypassed when it is disabled
+  FLAGS_auto_parallel_spmd_rule_cache = false;
+  infer(x, y, false, false);
+  EXPECT_EQ(rule_calls, 4);
+  FLAGS_auto_parallel_spmd_rule_cache = true;
+  infer(x, y, false, false);
+  EXPECT_EQ(rule_calls, 4);
+}
+
 }  // namespace auto_parallel
 }  // namespace distributed
 }  // namespace paddle
@@ -160,3 +160,24 @@ TEST(GradNodeInfo, Edge) {
   CHECK_EQ(edge2.GetEdgeRankInfo().first, size_t(4));
   CHECK_EQ(edge2.GetEdgeRankInfo().second, size_t(5));
 }
+
+TEST(GradNodeInfo, GradNodePool) {
+  auto node0 = egr::MakeGradNode<eager_test::GradTestNode>(5, 2, 2);
+  CHECK_EQ(node0->InputMeta().size(), size_t(2));
+  CHECK_EQ(node0->OutputMeta().size(), size_t(2));
+  CHECK_EQ(node0->name(), "GradTestNode");
+  auto* addr = node0.get();
+  node0.reset();
+
+  // The block of a released node is reused by the next node of that size
+  auto node1 = egr::MakeGradNode<eager_test::GradTestNode>(1, 1, 1);
+  CHECK_EQ(node1.get(), addr);
+  std::shared_ptr<egr::GradNodeBase> copied = node1->Copy();
+  CHECK_NE(copied.get(), node1.get());
+  CHECK_EQ(copied->InputMeta().size(), size_t(1));
+
+  // Blocks too large for the pool use the global allocator
+  void* large = egr::GradNodePool::Allocate(1 << 20);
+  CHECK_NOTNULL(large);
+  egr::GradNodePool::Deallocate(large, 1 << 20);
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-op latency of small eager ops, with and without autograd
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/eager/api/all.h"
+#include "paddle/fluid/eager/api/generated/eager_generated/forwards/dygraph_functions.h"
+#include "paddle/fluid/eager/autograd_meta.h"
+#include "paddle/fluid/imperative/tracer.h"
+#include "test/cpp/eager/test_utils.h"
+
+#include "paddle/phi/core/kernel_registry.h"
+
+static size_t num_warmup_runs = 100;
+static size_t num_benchmark_runs = 10000;
+
+namespace egr {
+
+using OpRunner = std::function<paddle::Tensor(const paddle::Tensor&,
+                                              const paddle::Tensor&)>;
+
+static std::vector<std::pair<std::string, OpRunner>> SmallOps() {
+  return {
+      {"add",
+       [](const paddle::Tensor& x, const paddle::Tensor& y) {
+         return add_ad_func(x, y);
+       }},
+      {"subtract",
+       [](const paddle::Tensor& x, const paddle::Tensor& y) {
+         return subtract_ad_func(x, y);
+       }},
+      {"matmul",
+       [](const paddle::Tensor& x, const paddle::Tensor& y) {
+         return matmul_ad_func(x, y, false, false);
+       }},
+      {"relu",
+       [](const paddle::Tensor& x, const paddle::Tensor& y) {
+         return relu_ad_func(x);
+       }},
+      {"scale",
+       [](const paddle::Tensor& x, const paddle::Tensor& y) {
+         return scale_ad_func(x, 2.0, 1.0, true);
+       }},
+      {"reshape",
+       [](const paddle::Tensor& x, const paddle::Tensor& y) {
+         return reshape_ad_func(x, {-1});
+       }},
+      {"sum",
+       [](const paddle::Tensor& x, const paddle::Tensor& y) {
+         return sum_ad_func(x);
+       }},
+  };
+}
+
+// Average latency of one call in microseconds
+static double MeasureOpLatency(const OpRunner& op,
+                               const paddle::Tensor& x,
+                               const paddle::Tensor& y) {
+  for (size_t i = 0; i < num_warmup_runs; ++i) {
+    op(x, y);
+  }
+  auto t_start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < num_benchmark_runs; ++i) {
+    op(x, y);
+  }
+  auto t_end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::micro>(t_end - t_start).count() /
+         num_benchmark_runs;
+}
+
+static paddle::Tensor CreateSmallTensor(bool requires_grad) {
+  return eager_test::CreateTensorWithValue(common::make_ddim({4, 4}),
+                                           paddle::platform::CPUPlace(),
+                                           phi::DataType::FLOAT32,
+                                           phi::DataLayout::NCHW,
+                                           1.0,
+                                           requires_grad);
+}
+
+}  // namespace egr
+
+TEST(Benchmark, EagerOpLatencyCPU) {
+  eager_test::InitEnv(paddle::platform::CPUPlace());
+  auto tracer = std::make_shared<paddle::imperative::Tracer>();
+  paddle::imperative::SetCurrentTracer(tracer);
+
+  paddle::Tensor grad_x = egr::CreateSmallTensor(true);
+  paddle::Tensor grad_y = egr::CreateSmallTensor(true);
+  paddle::Tensor x = egr::CreateSmallTensor(false);
+  paddle::Tensor y = egr::CreateSmallTensor(false);
+
+  std::cout << "op, requires_grad (us), stop_gradient (us), no_grad (us)"
+            << std::endl;
+  for (const auto& op : egr::SmallOps()) {
+    double grad_us = egr::MeasureOpLatency(op.second, grad_x, grad_y);
+    double stop_gradient_us = egr::MeasureOpLatency(op.second, x, y);
+    egr::Controller::Instance().SetHasGrad(false);
+    double no_grad_us = egr::MeasureOpLatency(op.second, grad_x, grad_y);
+    egr::Controller::Instance().SetHasGrad(true);
+
+    std::cout << op.first << ", " << grad_us << ", " << stop_gradient_us
+              << ", " << no_grad_us << std::endl;
+  }
+
+  // Outputs of the fast path get their AutogradMeta lazily and stop gradient
+  paddle::Tensor out = add_ad_func(x, y);
+  EXPECT_EQ(egr::EagerUtils::nullable_autograd_meta(out), nullptr);
+  EXPECT_TRUE(egr::EagerUtils::autograd_meta(&out)->StopGradient());
+  paddle::Tensor grad_out = add_ad_func(grad_x, grad_y);
+  EXPECT_FALSE(egr::EagerUtils::autograd_meta(&grad_out)->StopGradient());
+}
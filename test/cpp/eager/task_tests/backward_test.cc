@@ -18,6 +18,7 @@
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
 #include "paddle/fluid/eager/api/all.h"
 #include "paddle/fluid/eager/api/generated/eager_generated/backwards/scale_node.h"
@@ -31,6 +32,8 @@
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
 
+COMMON_DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
 TEST(Backward, SingleNodeEmptyGrad) {
@@ -342,4 +345,69 @@ TEST(Backward, WithAccumulation) {
   eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 2500.0);
 }
 
+TEST(Backward, ParallelBranches) {
+  eager_test::InitEnv(paddle::platform::CPUPlace());
+  FLAGS_eager_backward_num_threads = 4;
+
+  // Branch i scales the grad of target i by scale i, all branches end up in
+  // the AccumulationNode of the same leaf, twice through a shared node
+  paddle::framework::DDim ddim = common::make_ddim({4, 16, 16, 32});
+  const std::vector<float> scales = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  std::vector<paddle::Tensor> target_tensors;
+  std::vector<paddle::Tensor> grad_tensors;
+  paddle::Tensor leaf_tensor;
+  {
+    AutogradMeta* leaf_meta = EagerUtils::autograd_meta(&leaf_tensor);
+    auto acc_node_ptr = std::make_shared<egr::GradNodeAccumulation>(leaf_meta);
+    leaf_meta->SetGradNode(acc_node_ptr);
+    leaf_meta->SetSingleOutRankWithSlot(0, 0);
+    leaf_meta->SetStopGradient(false);
+
+    auto shared_node_ptr = std::make_shared<GradNodeScale>(1, 1);
+    shared_node_ptr->SetAttributes_scale(10.0 /*scale*/);
+    shared_node_ptr->SetDefaultGradInOutMeta();
+    shared_node_ptr->SetGradOutMeta(leaf_tensor, 0);
+
+    for (size_t i = 0; i < scales.size(); ++i) {
+      target_tensors.emplace_back(
+          eager_test::CreateTensorWithValue(ddim,
+                                            paddle::platform::CPUPlace(),
+                                            phi::DataType::FLOAT32,
+                                            phi::DataLayout::NCHW,
+                                            1.0 /*value*/,
+                                            false /*is_leaf*/));
+      grad_tensors.emplace_back(
+          eager_test::CreateTensorWithValue(ddim,
+                                            paddle::platform::CPUPlace(),
+                                            phi::DataType::FLOAT32,
+                                            phi::DataLayout::NCHW,
+                                            1.0 /*value*/,
+                                            false /*is_leaf*/));
+      auto node_ptr = std::make_shared<GradNodeScale>(1, 1);
+      node_ptr->SetAttributes_scale(scales[i]);
+      node_ptr->SetDefaultGradInOutMeta();
+      AutogradMeta* meta = EagerUtils::autograd_meta(&(target_tensors[i]));
+      meta->SetGradNode(node_ptr);
+      meta->SetSingleOutRankWithSlot(0, 0);
+      meta->SetStopGradient(false);
+      if (i < 2) {
+        auto tmp_tensor = paddle::Tensor();
+        auto* tmp_meta = EagerUtils::autograd_meta(&tmp_tensor);
+        tmp_meta->SetStopGradient(false);
+        tmp_meta->SetSingleOutRankWithSlot(0, 0);
+        tmp_meta->SetGradNode(shared_node_ptr);
+        node_ptr->SetGradOutMeta(tmp_tensor, 0);
+      } else {
+        node_ptr->SetGradOutMeta(leaf_tensor, 0);
+      }
+    }
+  }
+
+  Backward(target_tensors, grad_tensors);
+  FLAGS_eager_backward_num_threads = 0;
+
+  // (1 + 2) * 10 + 3 + 4 + 5 + 6
+  eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 48.0);
+}
+
 }  // namespace egr
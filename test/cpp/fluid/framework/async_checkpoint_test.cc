@@ -0,0 +1,73 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/async_checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include "paddle/fluid/framework/io/tensor_checkpoint.h"
+#include "paddle/phi/common/place.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(AsyncCheckpointSaver, SnapshotBeforeUpdate) {
+  std::string path = "async_checkpoint_test.pdckpt";
+  phi::DenseTensor tensor;
+  tensor.Resize(common::make_ddim({3, 5}));
+  float* data = tensor.mutable_data<float>(phi::CPUPlace());
+  for (int i = 0; i < 15; ++i) {
+    data[i] = static_cast<float>(i);
+  }
+
+  auto& saver = AsyncCheckpointSaver::Instance();
+  int64_t id = saver.Save(path, {"w"}, {&tensor});
+  // the update after Save is not in the checkpoint
+  for (int i = 0; i < 15; ++i) {
+    data[i] = -1.0f;
+  }
+  saver.Wait(id);
+  std::string error;
+  EXPECT_TRUE(saver.IsDone(id, &error));
+  EXPECT_TRUE(error.empty());
+
+  auto tensors = LoadTensorCheckpoint(path);
+  ASSERT_EQ(tensors.size(), 1UL);
+  EXPECT_EQ(tensors[0].first, "w");
+  EXPECT_EQ(tensors[0].second.dims(), tensor.dims());
+  for (int i = 0; i < 15; ++i) {
+    EXPECT_EQ(tensors[0].second.data<float>()[i], static_cast<float>(i));
+  }
+}
+
+TEST(AsyncCheckpointSaver, ReportsErrors) {
+  phi::DenseTensor tensor;
+  tensor.Resize(common::make_ddim({4}));
+  tensor.mutable_data<float>(phi::CPUPlace());
+
+  // a regular file cannot be a directory
+  { std::ofstream file("async_checkpoint_test.file"); }
+  auto& saver = AsyncCheckpointSaver::Instance();
+  int64_t id =
+      saver.Save("async_checkpoint_test.file/nested.pdckpt", {"w"}, {&tensor});
+  EXPECT_THROW(saver.Wait(id), common::enforce::EnforceNotMet);
+  std::string error;
+  EXPECT_TRUE(saver.IsDone(id, &error));
+  EXPECT_FALSE(error.empty());
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,198 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/data_feed_columnar.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+namespace columnar {
+
+constexpr int kUint64SlotNum = 3;
+constexpr int kFloatSlotNum = 1;
+
+// slot 0 holds small sorted ids, which delta encode, slot 1 hashed feasigns,
+// which are kept raw, and slot 2 is mostly empty
+void MakeRecords(std::vector<SlotRecordObject>* recs) {
+  recs->resize(3);
+  for (size_t i = 0; i < recs->size(); ++i) {
+    auto& rec = (*recs)[i];
+    rec.ins_id_ = "ins_" + std::to_string(i);
+    rec.search_id = 0x1234567890abcdefULL + i;
+    rec.cmatch = 222;
+    rec.rank = static_cast<uint32_t>(i);
+
+    std::vector<uint64_t> ids;
+    for (uint64_t j = 0; j <= i + 2; ++j) {
+      ids.push_back(10 + i * 10 + j * 3);
+    }
+    std::vector<uint64_t> hashes = {0x9e3779b97f4a7c15ULL * (i + 1),
+                                    0xc2b2ae3d27d4eb4fULL * (i + 7)};
+    std::vector<uint64_t> sparse;
+    if (i == 1) {
+      sparse.push_back(42);
+    }
+    rec.slot_uint64_feasigns_.add_values(ids.data(), ids.size());
+    rec.slot_uint64_feasigns_.add_values(hashes.data(), hashes.size());
+    rec.slot_uint64_feasigns_.add_values(sparse.data(), sparse.size());
+
+    std::vector<float> floats(i, 0.5f + static_cast<float>(i));
+    rec.slot_float_feasigns_.add_values(floats.data(), floats.size());
+  }
+}
+
+// Encodes the records as one block, returns the payload.
+std::string EncodeBlock(const std::vector<SlotRecordObject>& recs,
+                        uint32_t flags) {
+  BlockEncoder encoder(kUint64SlotNum, kFloatSlotNum, flags);
+  for (const auto& rec : recs) {
+    encoder.Add(rec);
+  }
+  EXPECT_EQ(encoder.InsNum(), recs.size());
+  std::string block;
+  encoder.Flush(&block);
+  EXPECT_EQ(encoder.InsNum(), 0U);
+
+  const char* ptr = block.data();
+  BlockHeader header;
+  EXPECT_TRUE(GetFixed(&ptr, block.data() + block.size(), &header));
+  EXPECT_EQ(header.ins_num, recs.size());
+  EXPECT_EQ(header.payload_size, block.size() - sizeof(BlockHeader));
+  return block.substr(sizeof(BlockHeader));
+}
+
+template <typename T>
+void ExpectSlotsEqual(const SlotValues<T>& expected,
+                      const SlotValues<T>& actual,
+                      int slot_num) {
+  for (int s = 0; s < slot_num; ++s) {
+    size_t expected_num = 0;
+    size_t actual_num = 0;
+    const T* expected_values = expected.get_values(s, &expected_num);
+    const T* actual_values = actual.get_values(s, &actual_num);
+    ASSERT_EQ(actual_num, expected_num) << "slot " << s;
+    for (size_t j = 0; j < expected_num; ++j) {
+      EXPECT_EQ(actual_values[j], expected_values[j]) << "slot " << s;
+    }
+  }
+}
+
+TEST(DataFeedColumnar, Varint) {
+  for (uint64_t v : {0ULL, 1ULL, 127ULL, 128ULL, 300ULL, ~0ULL}) {
+    std::string out;
+    PutVarint(v, &out);
+    EXPECT_EQ(out.size(), VarintSize(v));
+    const char* ptr = out.data();
+    uint64_t decoded = 0;
+    ASSERT_TRUE(GetVarint(&ptr, out.data() + out.size(), &decoded));
+    EXPECT_EQ(decoded, v);
+    EXPECT_EQ(ptr, out.data() + out.size());
+  }
+  for (int64_t delta : {0LL, 1LL, -1LL, 1000LL, -1000LL}) {
+    uint64_t v = static_cast<uint64_t>(delta);
+    EXPECT_EQ(UnZigZag(ZigZag(v)), v);
+  }
+  // small deltas of either sign encode to small values
+  EXPECT_EQ(ZigZag(static_cast<uint64_t>(-1)), 1U);
+  EXPECT_EQ(ZigZag(1), 2U);
+}
+
+TEST(DataFeedColumnar, BlockRoundTrip) {
+  std::vector<SlotRecordObject> recs;
+  MakeRecords(&recs);
+  const uint32_t all_flags = kWithInsId | kWithLogKey;
+  for (uint32_t flags : {0U, kWithInsId, kWithLogKey, all_flags}) {
+    std::string payload = EncodeBlock(recs, flags);
+
+    std::vector<SlotRecordObject> decoded(recs.size());
+    std::vector<SlotRecord> ptrs;
+    for (auto& rec : decoded) {
+      ptrs.push_back(&rec);
+    }
+    ASSERT_TRUE(DecodeBlock(payload.data(),
+                            payload.size(),
+                            kUint64SlotNum,
+                            kFloatSlotNum,
+                            flags,
+                            ptrs.data(),
+                            static_cast<uint32_t>(ptrs.size())));
+    for (size_t i = 0; i < recs.size(); ++i) {
+      if (flags & kWithInsId) {
+        EXPECT_EQ(decoded[i].ins_id_, recs[i].ins_id_);
+      }
+      if (flags & kWithLogKey) {
+        EXPECT_EQ(decoded[i].search_id, recs[i].search_id);
+        EXPECT_EQ(decoded[i].cmatch, recs[i].cmatch);
+        EXPECT_EQ(decoded[i].rank, recs[i].rank);
+      }
+      ExpectSlotsEqual(recs[i].slot_uint64_feasigns_,
+                       decoded[i].slot_uint64_feasigns_,
+                       kUint64SlotNum);
+      ExpectSlotsEqual(recs[i].slot_float_feasigns_,
+                       decoded[i].slot_float_feasigns_,
+                       kFloatSlotNum);
+    }
+  }
+}
+
+TEST(DataFeedColumnar, ColumnEncoding) {
+  std::vector<SlotRecordObject> recs;
+  MakeRecords(&recs);
+  std::string payload = EncodeBlock(recs, 0);
+  // the encoding byte of slot 0 leads the payload
+  EXPECT_EQ(static_cast<uint8_t>(payload[0]), kDeltaEncoding);
+  // then the lengths and the deltas of slot 0, one byte each
+  size_t slot0_size = 1 + recs.size();
+  for (const auto& rec : recs) {
+    size_t num = 0;
+    rec.slot_uint64_feasigns_.get_values(0, &num);
+    slot0_size += num;
+  }
+  EXPECT_EQ(static_cast<uint8_t>(payload[slot0_size]), kRawEncoding);
+}
+
+TEST(DataFeedColumnar, MalformedBlock) {
+  std::vector<SlotRecordObject> recs;
+  MakeRecords(&recs);
+  std::string payload = EncodeBlock(recs, kWithInsId);
+
+  auto decode = [&](size_t size, int float_slot_num) {
+    std::vector<SlotRecordObject> decoded(recs.size());
+    std::vector<SlotRecord> ptrs;
+    for (auto& rec : decoded) {
+      ptrs.push_back(&rec);
+    }
+    return DecodeBlock(payload.data(),
+                       size,
+                       kUint64SlotNum,
+                       float_slot_num,
+                       kWithInsId,
+                       ptrs.data(),
+                       static_cast<uint32_t>(ptrs.size()));
+  };
+  EXPECT_TRUE(decode(payload.size(), kFloatSlotNum));
+  // truncated
+  EXPECT_FALSE(decode(payload.size() - 1, kFloatSlotNum));
+  EXPECT_FALSE(decode(payload.size() / 2, kFloatSlotNum));
+  // a slot layout other than the one encoded
+  EXPECT_FALSE(decode(payload.size(), 0));
+}
+
+}  // namespace columnar
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,147 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/channel.h"
+#include "paddle/fluid/framework/data_feed.h"
+
+COMMON_DECLARE_bool(enable_reader_work_stealing);
+
+namespace paddle {
+namespace framework {
+
+DataFeedDesc MakeDataFeedDesc(int batch_size) {
+  DataFeedDesc desc;
+  desc.set_name("MultiSlotInMemoryDataFeed");
+  desc.set_batch_size(batch_size);
+  auto* slot = desc.mutable_multi_slot_desc()->add_slots();
+  slot->set_name("id");
+  slot->set_type("uint64");
+  slot->set_is_dense(false);
+  slot->set_is_used(true);
+  return desc;
+}
+
+Record MakeRecord(uint64_t id) {
+  Record record;
+  FeatureFeasign sign;
+  sign.uint64_feasign_ = id;
+  record.uint64_feasigns_.emplace_back(sign, 0);
+  return record;
+}
+
+// Readers with skewed output channels read them and steal from each other,
+// every instance must be read once and no reader may block. Reader 0, which
+// holds most of the instances, runs concurrently with the others or after
+// they finish.
+void RunStealingReaders(int reader_num, int batch_size, bool reader0_late) {
+  std::vector<Channel<Record>> input_channels;
+  std::vector<Channel<Record>> output_channels;
+  std::vector<Channel<Record>> consume_channels;
+  std::vector<void*> steal_channels;
+  uint64_t ins_num = 0;
+  for (int i = 0; i < reader_num; ++i) {
+    input_channels.push_back(MakeChannel<Record>());
+    output_channels.push_back(MakeChannel<Record>());
+    consume_channels.push_back(MakeChannel<Record>());
+    steal_channels.push_back(output_channels.back().get());
+    // reader 0 holds most of the instances
+    int num = i == 0 ? batch_size * reader_num * 2 + 1 : i;
+    std::vector<Record> records;
+    for (int j = 0; j < num; ++j) {
+      records.push_back(MakeRecord(ins_num++));
+    }
+    output_channels.back()->Write(std::move(records));
+  }
+
+  std::vector<std::unique_ptr<MultiSlotInMemoryDataFeed>> readers;
+  for (int i = 0; i < reader_num; ++i) {
+    readers.emplace_back(new MultiSlotInMemoryDataFeed());
+    auto& reader = readers.back();
+    reader->Init(MakeDataFeedDesc(batch_size));
+    reader->SetFileList({});
+    reader->SetThreadId(i);
+    reader->SetThreadNum(reader_num);
+    reader->SetInputChannel(input_channels[i].get());
+    reader->SetOutputChannel(output_channels[i].get());
+    reader->SetConsumeChannel(consume_channels[i].get());
+    reader->SetStealChannels(steal_channels);
+    reader->Start();
+  }
+
+  std::vector<int64_t> read_num(reader_num, 0);
+  auto read = [&](int i) {
+    int num = 0;
+    while ((num = readers[i]->Next()) > 0) {
+      EXPECT_LE(num, batch_size);
+      read_num[i] += num;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = reader0_late ? 1 : 0; i < reader_num; ++i) {
+    threads.emplace_back(read, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (reader0_late) {
+    read(0);
+    // the others took all of its instances
+    EXPECT_EQ(read_num[0], 0);
+    int64_t stolen_num = 0;
+    for (int i = 1; i < reader_num; ++i) {
+      stolen_num += readers[i]->GetStolenInsNum();
+    }
+    EXPECT_GE(stolen_num, batch_size * reader_num * 2 + 1);
+  }
+
+  std::vector<int> seen(ins_num, 0);
+  int64_t total_read = 0;
+  for (int i = 0; i < reader_num; ++i) {
+    EXPECT_EQ(output_channels[i]->Size(), 0UL);
+    EXPECT_EQ(consume_channels[i]->Size(), static_cast<size_t>(read_num[i]));
+    total_read += read_num[i];
+    std::vector<Record> consumed;
+    consume_channels[i]->Close();
+    consume_channels[i]->ReadAll(consumed);
+    for (const auto& record : consumed) {
+      ASSERT_EQ(record.uint64_feasigns_.size(), 1UL);
+      uint64_t id = record.uint64_feasigns_[0].sign().uint64_feasign_;
+      ASSERT_LT(id, ins_num);
+      ++seen[id];
+    }
+  }
+  EXPECT_EQ(total_read, static_cast<int64_t>(ins_num));
+  for (uint64_t id = 0; id < ins_num; ++id) {
+    EXPECT_EQ(seen[id], 1) << "instance " << id;
+  }
+}
+
+TEST(InMemoryDataFeed, WorkStealing) {
+  FLAGS_enable_reader_work_stealing = true;
+  RunStealingReaders(4, 3, /*reader0_late=*/true);
+  // small channels drained by the owner and the thieves at once
+  for (int round = 0; round < 50; ++round) {
+    RunStealingReaders(4, 3, /*reader0_late=*/false);
+  }
+  FLAGS_enable_reader_work_stealing = false;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -126,6 +126,34 @@ void TestMainLoop() {
     }
   }
 }
+TEST(dlpack, test_no_copy_strided) {
+  phi::DenseTensor src;
+  src.Resize({2, 3});
+  float *p = src.mutable_data<float>(platform::CPUPlace());
+  for (int i = 0; i < 6; ++i) {
+    p[i] = static_cast<float>(i);
+  }
+  // the transpose of src as a view
+  phi::DenseTensor view;
+  view.ShareDataWith(src);
+  view.set_meta(phi::DenseTensorMeta(
+      phi::DataType::FLOAT32, common::make_ddim({3, 2}), {1, 3}));
+
+  ::DLManagedTensor *dl_managed_tensor = toDLPack(view);
+  CHECK_EQ(p, dl_managed_tensor->dl_tensor.data);
+  CHECK_EQ(1, dl_managed_tensor->dl_tensor.strides[0]);
+  CHECK_EQ(3, dl_managed_tensor->dl_tensor.strides[1]);
+
+  phi::DenseTensor dst;
+  TensorFromDLPackNoCopy(dl_managed_tensor, &dst);
+  CHECK_EQ(p, dst.data<float>());
+  CHECK_EQ(dst.dims(), common::make_ddim({3, 2}));
+  CHECK_EQ(dst.strides(), common::make_ddim({1, 3}));
+  CHECK_EQ(dst.meta().is_contiguous(), false);
+  // the element (2, 1) of the view
+  CHECK_EQ(dst.data<float>()[2 * 1 + 1 * 3], 5.0f);
+}
+
 TEST(dlpack, test_all) {
 #define TestCallback(cpp_type, proto_type) TestMainLoop<cpp_type>()
 
@@ -0,0 +1,98 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/io/tensor_checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include "paddle/phi/common/place.h"
+
+namespace paddle {
+namespace framework {
+
+static void FillTensor(phi::DenseTensor* tensor,
+                       const std::vector<int64_t>& dims,
+                       float start) {
+  tensor->Resize(common::make_ddim(dims));
+  float* data = tensor->mutable_data<float>(phi::CPUPlace());
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = start + static_cast<float>(i);
+  }
+}
+
+TEST(TensorCheckpoint, SaveAndLoad) {
+  std::string path = "tensor_checkpoint_test.pdckpt";
+  phi::DenseTensor small, large, empty;
+  FillTensor(&small, {2, 3}, 1.0f);
+  small.set_lod({{0, 1, 2}});
+  // spans several chunks
+  FillTensor(&large,
+             {static_cast<int64_t>(kTensorCheckpointChunkSize / 4 * 2 + 5)},
+             -3.0f);
+  FillTensor(&empty, {0, 4}, 0.0f);
+  SaveTensorCheckpoint(path,
+                       {"small", "large", "empty"},
+                       {&small, &large, &empty},
+                       /*thread_num=*/4);
+  ASSERT_TRUE(IsTensorCheckpoint(path));
+
+  uint64_t chunk_size = 0;
+  auto entries = LoadTensorCheckpointIndex(path, &chunk_size);
+  ASSERT_EQ(entries.size(), 3UL);
+  EXPECT_EQ(chunk_size, kTensorCheckpointChunkSize);
+  EXPECT_EQ(entries[1].checksums.size(), 3UL);
+  for (auto& entry : entries) {
+    EXPECT_EQ(entry.offset % kTensorCheckpointAlignment, 0UL);
+  }
+
+  auto tensors = LoadTensorCheckpoint(path, /*thread_num=*/3);
+  ASSERT_EQ(tensors.size(), 3UL);
+  EXPECT_EQ(tensors[0].first, "small");
+  EXPECT_EQ(tensors[0].second.dims(), small.dims());
+  EXPECT_EQ(tensors[0].second.lod(), small.lod());
+  EXPECT_EQ(tensors[2].second.numel(), 0);
+  for (int i = 0; i < 2; ++i) {
+    const phi::DenseTensor& src = i == 0 ? small : large;
+    const phi::DenseTensor& dst = tensors[i].second;
+    ASSERT_EQ(dst.numel(), src.numel());
+    for (int64_t j = 0; j < src.numel(); ++j) {
+      ASSERT_EQ(dst.data<float>()[j], src.data<float>()[j]);
+    }
+  }
+
+  // flip a byte of the second chunk of large
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(entries[1].offset + chunk_size));
+    file.put('\x7f');
+  }
+  EXPECT_THROW(LoadTensorCheckpoint(path), common::enforce::EnforceNotMet);
+}
+
+TEST(TensorCheckpoint, NotACheckpoint) {
+  std::string path = "tensor_checkpoint_test.txt";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "not a checkpoint";
+  }
+  EXPECT_FALSE(IsTensorCheckpoint(path));
+  EXPECT_FALSE(IsTensorCheckpoint("tensor_checkpoint_test.missing"));
+  EXPECT_THROW(LoadTensorCheckpointIndex(path),
+               common::enforce::EnforceNotMet);
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -17,6 +17,10 @@
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+
+#include "paddle/fluid/platform/device_context.h"
 #include "paddle/phi/core/lod_utils.h"
 
 namespace paddle {
@@ -306,5 +310,48 @@ TEST(LoD, ConvertToOffsetBasedLoD) {
   EXPECT_EQ(offset_lod, expected);
 }
 
+#ifndef _WIN32
+TEST(LoD, DeserializeFromMappedFile) {
+  platform::CPUPlace place;
+  phi::DenseTensor src;
+  src.Resize({2, 3});
+  float* src_data = src.mutable_data<float>(place);
+  for (int i = 0; i < 6; ++i) {
+    src_data[i] = static_cast<float>(i) * 0.5f;
+  }
+  src.set_lod({{0, 1, 2}});
+
+  std::string path = "lod_tensor_test_mapped.pdiparams";
+  {
+    std::ofstream os(path, std::ios::binary);
+    SerializeToStream(os, src);
+    SerializeToStream(os, src);
+  }
+
+  auto& dev_ctx = *platform::DeviceContextPool::Instance().Get(place);
+  auto file = std::make_shared<memory::allocation::MappedFile>(path);
+  size_t offset = 0;
+  phi::DenseTensor dst1, dst2;
+  DeserializeFromMappedFile(file, &offset, &dst1, dev_ctx);
+  DeserializeFromMappedFile(file, &offset, &dst2, dev_ctx);
+  EXPECT_EQ(offset, file->size());
+
+  // the tensors keep the mapping alive
+  file.reset();
+  std::remove(path.c_str());
+  for (auto* dst : {&dst1, &dst2}) {
+    EXPECT_EQ(dst->dims(), src.dims());
+    EXPECT_EQ(dst->lod(), src.lod());
+    EXPECT_EQ(dst->dtype(), phi::DataType::FLOAT32);
+    for (int i = 0; i < 6; ++i) {
+      EXPECT_EQ(dst->data<float>()[i], src_data[i]);
+    }
+  }
+  // copy-on-write, other tensors sharing the mapping are not affected
+  dst1.data<float>()[0] = 100.f;
+  EXPECT_EQ(dst2.data<float>()[0], 0.f);
+}
+#endif
+
 }  // namespace framework
 }  // namespace paddle
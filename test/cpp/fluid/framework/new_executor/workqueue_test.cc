@@ -15,6 +15,7 @@
 #include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
 
 #include <atomic>
+#include <chrono>
 #include <thread>
 
 #include "glog/logging.h"
@@ -203,3 +204,44 @@ TEST(WorkQueue, TestWorkQueueGroup) {
   queue_group.reset();
   waiter_thread.join();
 }
+
+TEST(WorkQueue, TestAdaptiveSpinningWorkQueueGroup) {
+  using paddle::framework::CreateWorkQueueGroup;
+  using paddle::framework::WorkQueueOptions;
+  using paddle::framework::WorkQueueStats;
+  WorkQueueOptions sq_options(/*name*/ "SingleThreadedWorkQueueForTesting",
+                              /*num_threads*/ 1,
+                              /*allow_spinning*/ true,
+                              /*track_task*/ false);
+  sq_options.adaptive_spinning = true;
+  sq_options.cpu_affinity = {0};
+  WorkQueueOptions mq_options(/*name*/ "MultiThreadedWorkQueueForTesting",
+                              /*num_threads*/ 4,
+                              /*allow_spinning*/ true,
+                              /*track_task*/ false);
+  mq_options.adaptive_spinning = true;
+  auto queue_group = CreateWorkQueueGroup({sq_options, mq_options});
+  // the tasks are far apart, so the threads block and are woken
+  for (int i = 0; i < 10; ++i) {
+    for (size_t queue_idx = 0; queue_idx < 2; ++queue_idx) {
+      auto handle =
+          queue_group->AddAwaitableTask(queue_idx, [i]() { return i; });
+      EXPECT_EQ(handle.get(), i);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  for (size_t queue_idx = 0; queue_idx < 2; ++queue_idx) {
+    WorkQueueStats stats = queue_group->QueueStats(queue_idx);
+    EXPECT_GT(stats.wakeups, 0u);
+    EXPECT_GE(stats.total_wakeup_latency_ns, stats.max_wakeup_latency_ns);
+  }
+  queue_group.reset();
+
+  // adaptive_spinning requires allow_spinning
+  WorkQueueOptions invalid_options(/*name*/ "WorkQueueForTesting",
+                                   /*num_threads*/ 2,
+                                   /*allow_spinning*/ false,
+                                   /*track_task*/ false);
+  invalid_options.adaptive_spinning = true;
+  EXPECT_ANY_THROW(invalid_options.Validate());
+}
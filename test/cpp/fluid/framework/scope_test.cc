@@ -77,3 +77,31 @@ TEST(Scope, GetAllNames) {
 
   EXPECT_STREQ("a", str.c_str());
 }
+
+TEST(Scope, VariableSlotTable) {
+  Scope s;
+  Scope& ss = s.NewScope();
+  Variable* a = s.Var("a");
+  Variable* b = ss.Var("b");
+
+  paddle::framework::VariableSlotTable table;
+  int slot_a = table.Register("a");
+  int slot_b = table.Register("b");
+  int slot_c = table.Register("c");
+  EXPECT_EQ(slot_a, table.Register("a"));
+  EXPECT_EQ(slot_b, table.Find("b"));
+  EXPECT_EQ(-1, table.Find("d"));
+  EXPECT_EQ(3UL, table.size());
+  EXPECT_EQ(nullptr, table.scope());
+
+  table.Bind(ss);
+  EXPECT_EQ(&ss, table.scope());
+  EXPECT_EQ(a, table.Get(slot_a));
+  EXPECT_EQ(b, table.Get(slot_b));
+  EXPECT_EQ(nullptr, table.Get(slot_c));
+  EXPECT_EQ("c", table.Name(slot_c));
+
+  Variable* c = ss.Var("c");
+  table.Bind(ss);
+  EXPECT_EQ(c, table.Get(slot_c));
+}
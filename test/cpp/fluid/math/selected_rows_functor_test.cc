@@ -431,6 +431,53 @@ TEST(selected_rows_functor, cpu_merge_add_multi_noduplicated) {
   }
 }
 
+TEST(selected_rows_functor, cpu_merge_add_multi_large) {
+  paddle::platform::CPUPlace cpu_place;
+  phi::CPUContext ctx(cpu_place);
+  ctx.SetAllocator(paddle::memory::allocation::AllocatorFacade::Instance()
+                       .GetAllocator(cpu_place)
+                       .get());
+
+  // large enough for the merging to be split over the threads
+  int64_t height = 5000;
+  int64_t row_numel = 64;
+  int num_inputs = 4;
+  std::vector<std::unique_ptr<phi::SelectedRows>> selected_rows;
+  std::vector<const phi::SelectedRows*> inputs;
+  std::vector<float> expected(height * row_numel, 0.f);
+  for (int k = 0; k < num_inputs; ++k) {
+    std::vector<int64_t> rows;
+    for (int64_t r = k; r < height; r += k + 1) {
+      rows.push_back(r);
+    }
+    selected_rows.emplace_back(new phi::SelectedRows(rows, height));
+    auto* value = selected_rows.back()->mutable_value()->mutable_data<float>(
+        common::make_ddim({static_cast<int64_t>(rows.size()), row_numel}),
+        cpu_place);
+    for (size_t i = 0; i < rows.size(); ++i) {
+      for (int64_t j = 0; j < row_numel; ++j) {
+        value[i * row_numel + j] = static_cast<float>(k + j);
+        expected[rows[i] * row_numel + j] += static_cast<float>(k + j);
+      }
+    }
+    inputs.push_back(selected_rows.back().get());
+  }
+
+  std::unique_ptr<phi::SelectedRows> output{new phi::SelectedRows()};
+  phi::funcs::scatter::MergeAdd<phi::CPUContext, float> merge_add_functor;
+  merge_add_functor(ctx, inputs, output.get());
+
+  // every row is in the first input
+  EXPECT_EQ(output->value().dims(), common::make_ddim({height, row_numel}));
+  auto* out_data = output->value().data<float>();
+  for (int64_t i = 0; i < height; ++i) {
+    ASSERT_EQ(output->rows()[i], i);
+    for (int64_t j = 0; j < row_numel; ++j) {
+      ASSERT_EQ(out_data[i * row_numel + j], expected[i * row_numel + j]);
+    }
+  }
+}
+
 TEST(selected_rows_functor, cpu_sum_to) {
   paddle::platform::CPUPlace cpu_place;
   phi::CPUContext ctx(cpu_place);
@@ -0,0 +1,102 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/allocation_tracer.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+#include "paddle/fluid/memory/allocation/stat_allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(AllocationTracer, RecordDumpAndReplay) {
+  auto& tracer = AllocationTracer::Instance();
+  tracer.Enable(16);
+  auto allocator =
+      std::make_shared<StatAllocator>(std::make_shared<CPUAllocator>());
+  {
+    AllocationTracer::OpGuard guard("matmul");
+    auto a = allocator->Allocate(1024);
+    auto b = allocator->Allocate(2048);
+    a.reset();
+    auto c = allocator->Allocate(512);
+  }
+  tracer.Disable();
+  // not recorded once disabled
+  allocator->Allocate(256);
+
+  auto events = tracer.Events();
+  ASSERT_EQ(events.size(), 6UL);
+  EXPECT_TRUE(events[0].is_alloc);
+  EXPECT_EQ(events[0].size, 1024UL);
+  EXPECT_FALSE(events[2].is_alloc);
+  EXPECT_EQ(events[2].ptr, events[0].ptr);
+  auto op_names = tracer.OpNames();
+  ASSERT_GE(events[0].op_id, 0);
+  EXPECT_EQ(op_names[events[0].op_id], "matmul");
+
+  std::string path = "allocation_tracer_test.trace";
+  tracer.Dump(path);
+  std::vector<AllocationEvent> loaded;
+  std::vector<std::string> loaded_op_names;
+  LoadAllocationTrace(path, &loaded, &loaded_op_names);
+  std::remove(path.c_str());
+  ASSERT_EQ(loaded.size(), events.size());
+  for (size_t i = 0; i < loaded.size(); ++i) {
+    EXPECT_EQ(loaded[i].ptr, events[i].ptr);
+    EXPECT_EQ(loaded[i].size, events[i].size);
+    EXPECT_EQ(loaded[i].is_alloc, events[i].is_alloc);
+    EXPECT_EQ(loaded[i].op_id, events[i].op_id);
+  }
+  EXPECT_EQ(loaded_op_names, op_names);
+
+  for (auto strategy : {"naive_best_fit", "size_class"}) {
+    auto result = ReplayAllocationTrace(
+        loaded,
+        loaded_op_names,
+        platform::CPUPlace(),
+        CreateReplayAllocator(strategy, platform::CPUPlace()));
+    EXPECT_EQ(result.alloc_num, 3UL);
+    EXPECT_EQ(result.failed_num, 0UL);
+    EXPECT_EQ(result.peak_allocated, 1024 + 2048);
+  }
+}
+
+TEST(AllocationTracer, RingBuffer) {
+  auto& tracer = AllocationTracer::Instance();
+  tracer.Enable(4);
+  auto allocator =
+      std::make_shared<StatAllocator>(std::make_shared<CPUAllocator>());
+  for (size_t i = 1; i <= 5; ++i) {
+    allocator->Allocate(i * 64);
+  }
+  tracer.Disable();
+
+  // the last 4 of the 10 events, oldest first
+  auto events = tracer.Events();
+  ASSERT_EQ(events.size(), 4UL);
+  EXPECT_TRUE(events[0].is_alloc);
+  EXPECT_EQ(events[0].size, 4 * 64UL);
+  EXPECT_EQ(events[3].size, 5 * 64UL);
+  EXPECT_FALSE(events[3].is_alloc);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -171,6 +171,36 @@ TEST(test_auto_growth_allocator, test_free_when_no_cache_hit) {
   TestFreeWhenNoCacheHit(true);
 }
 
+TEST(test_auto_growth_allocator, test_fragmentation_report) {
+  FLAGS_free_idle_chunk = false;
+  FLAGS_free_when_no_cache_hit = false;
+  size_t alignment = 256;
+  size_t chunk_size = 16 * alignment;
+  auto recorded_allocator = std::make_shared<RecordedAllocator>();
+  auto ag_allocator = std::make_shared<AutoGrowthBestFitAllocator>(
+      recorded_allocator, alignment, chunk_size);
+
+  // a chunk of 4 blocks with the 1st and 3rd freed
+  std::vector<AllocationPtr> allocations;
+  for (int i = 0; i < 4; ++i) {
+    allocations.emplace_back(ag_allocator->Allocate(4 * alignment));
+  }
+  allocations[0].reset();
+  allocations[2].reset();
+
+  auto report = ag_allocator->GetFragmentationReport();
+  ASSERT_EQ(report.ReservedSize(), chunk_size);
+  ASSERT_EQ(report.FreeSize(), 8 * alignment);
+  ASSERT_EQ(report.LargestFreeBlock(), 4 * alignment);
+  ASSERT_DOUBLE_EQ(report.Fragmentation(), 0.5);
+  ASSERT_NE(report.ToString().find("fragmentation 50%"), std::string::npos);
+
+  allocations.clear();
+  report = ag_allocator->GetFragmentationReport();
+  ASSERT_EQ(report.LargestFreeBlock(), chunk_size);
+  ASSERT_DOUBLE_EQ(report.Fragmentation(), 0.0);
+}
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
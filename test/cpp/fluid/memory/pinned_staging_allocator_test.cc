@@ -0,0 +1,123 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/pinned_staging_allocator.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/memory/memcpy.h"
+#include "paddle/fluid/platform/device/gpu/gpu_info.h"
+
+COMMON_DECLARE_bool(use_pinned_staging_pool);
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(PinnedStagingAllocator, ReuseAfterCopy) {
+  platform::CUDAPlace place(0);
+  auto allocator = std::make_shared<PinnedStagingAllocator>(place);
+
+  gpuStream_t stream;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamCreate(&stream));
+#endif
+
+  auto staging = allocator->Allocate(1000);
+  EXPECT_EQ(staging->size(), PinnedStagingAllocator::kMinSize);
+  EXPECT_TRUE(platform::is_cuda_pinned_place(staging->place()));
+  void* ptr = staging->ptr();
+  allocator->RecordStream(staging.get(), stream);
+  staging.reset();
+
+  platform::GpuStreamSync(stream);
+  // the copies of the block completed, so it is handed out again
+  EXPECT_EQ(allocator->Allocate(4096)->ptr(), ptr);
+
+  // larger than the size classes, not cached
+  auto large = allocator->Allocate(PinnedStagingAllocator::kMaxSize + 1);
+  EXPECT_EQ(large->size(), PinnedStagingAllocator::kMaxSize + 1);
+  allocator->RecordStream(large.get(), stream);
+  large.reset();
+
+  EXPECT_EQ(allocator->Release(platform::CUDAPinnedPlace()),
+            PinnedStagingAllocator::kMinSize);
+
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(stream));
+#endif
+}
+
+TEST(PinnedStagingAllocator, StagedCopy) {
+  platform::CUDAPlace place(0);
+  FLAGS_use_pinned_staging_pool = true;
+
+  gpuStream_t stream;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamCreate(&stream));
+#endif
+
+  size_t n = 1 << 20;
+  std::vector<float> src(n), dst(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    src[i] = static_cast<float>(i);
+  }
+  void* gpu_ptr = nullptr;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMalloc(&gpu_ptr, n * sizeof(float)));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipMalloc(&gpu_ptr, n * sizeof(float)));
+#endif
+
+  Copy(place,
+       gpu_ptr,
+       platform::CPUPlace(),
+       src.data(),
+       n * sizeof(float),
+       stream);
+  // the source may be reused as soon as Copy returns
+  std::fill(src.begin(), src.end(), -1);
+  Copy(platform::CPUPlace(),
+       dst.data(),
+       place,
+       gpu_ptr,
+       n * sizeof(float),
+       stream);
+  platform::GpuStreamSync(stream);
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(dst[i], static_cast<float>(i));
+  }
+  FLAGS_use_pinned_staging_pool = false;
+
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaFree(gpu_ptr));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipFree(gpu_ptr));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(stream));
+#endif
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,139 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/quota_allocator.h"
+
+#include <future>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(QuotaAllocator, HardQuota) {
+  platform::CPUPlace place;
+  auto domain = std::make_shared<MemoryDomain>(place, 1024, true);
+  QuotaAllocator allocator(std::make_shared<CPUAllocator>(), domain);
+
+  auto first = allocator.Allocate(512);
+  auto second = allocator.Allocate(512);
+  EXPECT_EQ(domain->allocated(), 1024u);
+  EXPECT_THROW(allocator.Allocate(1), BadAlloc);
+  EXPECT_EQ(domain->allocated(), 1024u);
+  EXPECT_EQ(domain->exceeded_count(), 1u);
+
+  first.reset();
+  EXPECT_EQ(domain->allocated(), 512u);
+  auto third = allocator.Allocate(256);
+  EXPECT_EQ(domain->allocated(), 768u);
+  EXPECT_EQ(domain->peak_allocated(), 1024u);
+}
+
+TEST(QuotaAllocator, HardQuotaConcurrentAllocations) {
+  platform::CPUPlace place;
+  constexpr size_t kQuota = 64 * 1024;
+  constexpr size_t kSize = 1024;
+  auto domain = std::make_shared<MemoryDomain>(place, kQuota, true);
+  QuotaAllocator allocator(std::make_shared<CPUAllocator>(), domain);
+
+  // the threads race to allocate twice the quota, only the quota passes
+  constexpr int kThreads = 8;
+  std::promise<void> start;
+  std::shared_future<void> started = start.get_future().share();
+  std::vector<std::vector<AllocationPtr>> allocations(kThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      started.wait();
+      for (size_t j = 0; j < 2 * kQuota / kSize / kThreads; ++j) {
+        try {
+          allocations[i].push_back(allocator.Allocate(kSize));
+        } catch (BadAlloc&) {
+        }
+      }
+    });
+  }
+  start.set_value();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  size_t num_allocations = 0;
+  for (auto& thread_allocations : allocations) {
+    num_allocations += thread_allocations.size();
+  }
+  EXPECT_EQ(num_allocations, kQuota / kSize);
+  EXPECT_EQ(domain->allocated(), kQuota);
+  EXPECT_EQ(domain->peak_allocated(), kQuota);
+  EXPECT_EQ(domain->exceeded_count(), kQuota / kSize);
+}
+
+TEST(QuotaAllocator, SoftQuotaReleasesIdleDomains) {
+  platform::CPUPlace place;
+  auto domain = std::make_shared<MemoryDomain>(place, 1024, false);
+  QuotaAllocator allocator(std::make_shared<CPUAllocator>(), domain);
+
+  auto idle = std::make_shared<MemoryDomain>(place, 0, true);
+  QuotaAllocator idle_allocator(std::make_shared<CPUAllocator>(), idle);
+  auto cached = idle_allocator.Allocate(4096);
+  idle->SetReleaseCallback([&cached]() -> uint64_t {
+    uint64_t size = cached ? cached->size() : 0;
+    cached.reset();
+    return size;
+  });
+
+  auto busy = std::make_shared<MemoryDomain>(place, 0, true);
+  int busy_released = 0;
+  busy->SetReleaseCallback([&busy_released]() -> uint64_t {
+    ++busy_released;
+    return 0;
+  });
+
+  // the busy domain runs in another thread
+  std::promise<void> entered;
+  std::promise<void> finished;
+  std::thread runner([&]() {
+    MemoryDomainGuard guard(busy.get());
+    entered.set_value();
+    finished.get_future().wait();
+  });
+  entered.get_future().wait();
+  {
+    auto within = allocator.Allocate(1024);
+    EXPECT_NE(cached, nullptr);
+    // beyond the soft quota, it goes on after the idle domain releases
+    auto beyond = allocator.Allocate(1024);
+    EXPECT_EQ(domain->allocated(), 2048u);
+    EXPECT_EQ(domain->exceeded_count(), 1u);
+  }
+  finished.set_value();
+  runner.join();
+
+  EXPECT_EQ(cached, nullptr);
+  EXPECT_EQ(idle->allocated(), 0u);
+  EXPECT_EQ(idle->released_bytes(), 4096u);
+  EXPECT_EQ(busy_released, 0);
+  EXPECT_EQ(domain->allocated(), 0u);
+
+  idle->SetReleaseCallback(nullptr);
+  busy->SetReleaseCallback(nullptr);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
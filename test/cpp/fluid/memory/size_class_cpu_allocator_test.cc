@@ -0,0 +1,100 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/memory/allocation/size_class_cpu_allocator.h"
+
+#include <cstring>
+#include <set>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/memory/allocation/cpu_allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+TEST(SizeClassCPUAllocator, SizeClass) {
+  using A = SizeClassCPUAllocator;
+  for (size_t size = 1; size <= A::kMaxSmallSize; ++size) {
+    size_t index = A::SizeClassIndex(size);
+    ASSERT_LT(index, A::kNumSizeClasses);
+    ASSERT_GE(A::SizeClassSize(index), size);
+    ASSERT_EQ(A::SizeClassSize(index) % A::kMinSize, 0UL);
+    if (index > 0) {
+      ASSERT_LT(A::SizeClassSize(index - 1), size);
+    }
+  }
+  EXPECT_EQ(A::SizeClassSize(A::kNumSizeClasses - 1), A::kMaxSmallSize);
+}
+
+TEST(SizeClassCPUAllocator, AllocateAndReuse) {
+  auto allocator =
+      std::make_shared<SizeClassCPUAllocator>(std::make_shared<CPUAllocator>());
+  std::vector<AllocationPtr> allocations;
+  std::set<void*> ptrs;
+  for (size_t size : {1UL, 100UL, 4096UL, 100000UL, 1UL << 20}) {
+    for (int i = 0; i < 100; ++i) {
+      auto allocation = allocator->Allocate(size);
+      ASSERT_GE(allocation->size(), size);
+      ASSERT_TRUE(ptrs.insert(allocation->ptr()).second);
+      memset(allocation->ptr(), i, size);
+      allocations.emplace_back(std::move(allocation));
+    }
+  }
+
+  allocations.clear();
+
+  // the thread cache hands out the block freed last first
+  auto allocation = allocator->Allocate(100);
+  void* ptr = allocation->ptr();
+  allocation.reset();
+  EXPECT_EQ(allocator->Allocate(128)->ptr(), ptr);
+}
+
+TEST(SizeClassCPUAllocator, MultiThread) {
+  auto allocator =
+      std::make_shared<SizeClassCPUAllocator>(std::make_shared<CPUAllocator>());
+  // blocks allocated by one thread are freed by another one
+  std::vector<AllocationPtr> shared(1000);
+  std::thread producer([&]() {
+    for (size_t i = 0; i < shared.size(); ++i) {
+      shared[i] = allocator->Allocate(64 + i);
+    }
+  });
+  producer.join();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&, t]() {
+      if (t == 0) {
+        shared.clear();
+      }
+      for (int i = 0; i < 1000; ++i) {
+        size_t size = 16 + (i * 37 + t * 101) % 8192;
+        auto allocation = allocator->Allocate(size);
+        memset(allocation->ptr(), t, size);
+        EXPECT_EQ(static_cast<char*>(allocation->ptr())[size - 1], t);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -16,7 +16,11 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/memory/allocation/allocator_facade.h"
+#include "paddle/fluid/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/fluid/memory/allocation/cuda_allocator.h"
+#include "paddle/fluid/memory/allocation/stream_safe_cuda_allocator.h"
 #include "paddle/fluid/memory/memory.h"
 #include "paddle/fluid/platform/device/gpu/gpu_info.h"
 #include "paddle/fluid/platform/device_context.h"
@@ -33,6 +37,8 @@
 #include <hip/hip_runtime.h>
 #endif
 
+COMMON_DECLARE_bool(stream_ordered_cuda_free);
+
 namespace paddle {
 namespace memory {
 
@@ -175,6 +181,98 @@ TEST(StreamSafeCUDAAllocInterfaceTest, GetStreamInterfaceTest) {
   CheckMemLeak(place);
 }
 
+TEST(StreamSafeCUDAAllocInterfaceTest, StreamOrderedFreeTest) {
+  platform::CUDAPlace place = platform::CUDAPlace();
+  size_t alloc_size = 1024 * sizeof(int);
+
+  gpuStream_t owning_stream, other_stream;
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamCreate(&other_stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamCreate(&owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamCreate(&other_stream));
+#endif
+
+  FLAGS_stream_ordered_cuda_free = true;
+  auto allocator = std::make_shared<allocation::StreamSafeCUDAAllocator>(
+      std::make_shared<allocation::AutoGrowthBestFitAllocator>(
+          std::make_shared<allocation::CUDAAllocator>(place),
+          platform::GpuMinChunkSize()),
+      place,
+      owning_stream);
+  FLAGS_stream_ordered_cuda_free = false;
+  EXPECT_TRUE(allocator->IsStreamOrdered());
+
+  allocation::AllocationPtr x = allocator->Allocate(alloc_size);
+  allocation::AllocationPtr y = allocator->Allocate(alloc_size);
+  void *address = x->ptr();
+  int *y_data = static_cast<int *>(y->ptr());
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(x->ptr(), 0, alloc_size, owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(y_data, 0, alloc_size, owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(owning_stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipMemsetAsync(x->ptr(), 0, alloc_size, owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipMemsetAsync(y_data, 0, alloc_size, owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamSynchronize(owning_stream));
+#endif
+
+  int n = static_cast<int>(alloc_size / sizeof(int));
+  add_kernel<<<1, 64, 0, other_stream>>>(
+      static_cast<int *>(x->ptr()), y_data, n);
+  static_cast<allocation::StreamSafeCUDAAllocation *>(x.get())->RecordStream(
+      other_stream);
+  x.reset();
+
+  // handed back at the next allocation, without waiting for other_stream
+  allocation::AllocationPtr z = allocator->Allocate(alloc_size);
+  EXPECT_EQ(z->ptr(), address);
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(z->ptr(), 0xff, alloc_size, owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(other_stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipMemsetAsync(z->ptr(), 0xff, alloc_size, owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamSynchronize(owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamSynchronize(other_stream));
+#endif
+
+  // the kernel on other_stream read x before it was overwritten
+  std::vector<int> host(n);
+  Copy(platform::CPUPlace(),
+       host.data(),
+       place,
+       y_data,
+       alloc_size,
+       owning_stream);
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(owning_stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamSynchronize(owning_stream));
+#endif
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(host[i], 1);
+  }
+
+  z.reset();
+  y.reset();
+  allocator->Release(place);
+#ifdef PADDLE_WITH_CUDA
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(other_stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(owning_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(other_stream));
+#endif
+}
+
 TEST(StreamSafeCUDAAllocRetryTest, RetryTest) {
   platform::CUDAPlace place = platform::CUDAPlace();
   gpuStream_t stream1, stream2;
@@ -0,0 +1,109 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+
+COMMON_DECLARE_int32(onednn_primitive_cache_capacity);
+
+namespace phi {
+
+static OneDNNPrimitiveCacheKey MakeKey(int64_t scope, const std::string& name) {
+  OneDNNPrimitiveCacheKey key;
+  key.Append(scope).Append(name).Finalize();
+  return key;
+}
+
+TEST(OneDNNPrimitiveCache, disabled) {
+  FLAGS_onednn_primitive_cache_capacity = 0;
+  auto& cache = OneDNNPrimitiveCache::Instance();
+  cache.Clear();
+  EXPECT_FALSE(cache.Enabled());
+  cache.Set(MakeKey(0, "conv"), std::make_shared<int>(1));
+  EXPECT_EQ(cache.Get(MakeKey(0, "conv")), nullptr);
+  EXPECT_EQ(cache.GetStats().size, 0UL);
+}
+
+TEST(OneDNNPrimitiveCache, hit_and_miss) {
+  FLAGS_onednn_primitive_cache_capacity = 64;
+  auto& cache = OneDNNPrimitiveCache::Instance();
+  cache.Clear();
+  auto before = cache.GetStats();
+
+  auto value = std::make_shared<int>(7);
+  cache.Set(MakeKey(1, "conv"), value);
+  EXPECT_EQ(cache.Get(MakeKey(1, "conv")), value);
+  // Another scope or another name is another entry.
+  EXPECT_EQ(cache.Get(MakeKey(2, "conv")), nullptr);
+  EXPECT_EQ(cache.Get(MakeKey(1, "convx")), nullptr);
+
+  auto after = cache.GetStats();
+  EXPECT_EQ(after.hits - before.hits, 1UL);
+  EXPECT_EQ(after.misses - before.misses, 2UL);
+  EXPECT_EQ(after.size, 1UL);
+}
+
+TEST(OneDNNPrimitiveCache, length_prefixed_strings) {
+  OneDNNPrimitiveCacheKey a, b;
+  a.Append(std::string("ab")).Append(std::string("c")).Finalize();
+  b.Append(std::string("a")).Append(std::string("bc")).Finalize();
+  EXPECT_NE(a.bytes(), b.bytes());
+}
+
+TEST(OneDNNPrimitiveCache, bounded) {
+  FLAGS_onednn_primitive_cache_capacity = 32;
+  auto& cache = OneDNNPrimitiveCache::Instance();
+  cache.Clear();
+  auto before = cache.GetStats();
+  for (int i = 0; i < 1000; ++i) {
+    cache.Set(MakeKey(0, std::to_string(i)), std::make_shared<int>(i));
+  }
+  auto after = cache.GetStats();
+  EXPECT_LE(after.size, after.capacity);
+  EXPECT_EQ(after.evictions - before.evictions, 1000UL - after.size);
+}
+
+TEST(OneDNNPrimitiveCache, shared_by_threads) {
+  FLAGS_onednn_primitive_cache_capacity = 1024;
+  auto& cache = OneDNNPrimitiveCache::Instance();
+  cache.Clear();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&cache]() {
+      for (int i = 0; i < 100; ++i) {
+        auto key = MakeKey(3, std::to_string(i));
+        auto value = std::static_pointer_cast<int>(cache.Get(key));
+        if (value == nullptr) {
+          cache.Set(key, std::make_shared<int>(i));
+        } else {
+          EXPECT_EQ(*value, i);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(cache.GetStats().size, 100UL);
+  FLAGS_onednn_primitive_cache_capacity = 0;
+  cache.Clear();
+}
+
+}  // namespace phi
@@ -72,6 +72,21 @@ void TestDeviceInterface(const paddle::platform::Place& place) {
     phi::DeviceManager::SetDevice(place);
     auto dev_id = phi::DeviceManager::GetDevice(dev_type);
     EXPECT_EQ(dev_id, place.GetDeviceId());
+
+    EXPECT_TRUE(device->IsStreamOrderedAllocatorSupported());
+    phi::stream::Stream stream;
+    stream.Init(place);
+    auto p2 = device->MemoryAllocateAsync(16, &stream);
+    EXPECT_NE(p2, nullptr);
+    device->MemorySet(p2, 0x5A, 16, &stream);
+    stream.Wait();
+    std::array<uint8_t, 16> host;
+    device->MemoryCopyD2H(host.data(), p2, 16);
+    for (auto value : host) {
+      EXPECT_EQ(value, 0x5A);
+    }
+    device->MemoryDeallocateAsync(p2, 16, &stream);
+    stream.Destroy();
   }
 }
 
@@ -0,0 +1,339 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/operators/reader/gpu_image_reader.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/framework/tensor_util.h"
+
+namespace paddle {
+namespace operators {
+namespace reader {
+
+struct Rgb {
+  int r;
+  int g;
+  int b;
+};
+
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<uint8_t>* out) : out_(out) {}
+
+  void Put(uint32_t bits, int length) {
+    for (int i = length - 1; i >= 0; --i) {
+      byte_ = static_cast<uint8_t>((byte_ << 1) | ((bits >> i) & 1));
+      if (++count_ == 8) {
+        out_->push_back(byte_);
+        // byte stuffing
+        if (byte_ == 0xFF) {
+          out_->push_back(0x00);
+        }
+        byte_ = 0;
+        count_ = 0;
+      }
+    }
+  }
+
+  // Pads the last byte with 1 bits.
+  void Finish() {
+    while (count_ != 0) {
+      Put(1, 1);
+    }
+  }
+
+ private:
+  std::vector<uint8_t>* out_;
+  uint8_t byte_{0};
+  int count_{0};
+};
+
+void PutMarker(uint8_t marker, std::vector<uint8_t>* out) {
+  out->push_back(0xFF);
+  out->push_back(marker);
+}
+
+void PutU16(int value, std::vector<uint8_t>* out) {
+  out->push_back(static_cast<uint8_t>(value >> 8));
+  out->push_back(static_cast<uint8_t>(value & 0xFF));
+}
+
+int Category(int value) {
+  int category = 0;
+  for (int a = std::abs(value); a != 0; a >>= 1) {
+    ++category;
+  }
+  return category;
+}
+
+// Encodes a baseline JPEG image of blocks_x x blocks_y blocks of 8x8 pixels,
+// each of one color. With a unit quantization table every block only has a
+// DC coefficient, so the image decodes to the colors up to the rounding of
+// the YCbCr conversion. The Huffman tables are minimal: DC category k has the
+// 4-bit code k, and the AC table only has the end of block.
+std::vector<uint8_t> EncodeBlockJpeg(
+    int blocks_x, int blocks_y, const std::function<Rgb(int, int)>& color) {
+  std::vector<uint8_t> out;
+  PutMarker(0xD8, &out);  // SOI
+
+  PutMarker(0xDB, &out);  // DQT
+  PutU16(67, &out);
+  out.push_back(0x00);
+  out.insert(out.end(), 64, 1);
+
+  PutMarker(0xC0, &out);  // SOF0
+  PutU16(17, &out);
+  out.push_back(8);
+  PutU16(blocks_y * 8, &out);
+  PutU16(blocks_x * 8, &out);
+  out.push_back(3);
+  for (uint8_t id = 1; id <= 3; ++id) {
+    out.insert(out.end(), {id, 0x11, 0x00});
+  }
+
+  PutMarker(0xC4, &out);  // DHT of DC
+  PutU16(31, &out);
+  out.push_back(0x00);
+  for (int length = 1; length <= 16; ++length) {
+    out.push_back(length == 4 ? 12 : 0);
+  }
+  for (uint8_t category = 0; category < 12; ++category) {
+    out.push_back(category);
+  }
+
+  PutMarker(0xC4, &out);  // DHT of AC
+  PutU16(20, &out);
+  out.push_back(0x10);
+  for (int length = 1; length <= 16; ++length) {
+    out.push_back(length == 1 ? 1 : 0);
+  }
+  out.push_back(0x00);
+
+  PutMarker(0xDA, &out);  // SOS
+  PutU16(12, &out);
+  out.push_back(3);
+  for (uint8_t id = 1; id <= 3; ++id) {
+    out.insert(out.end(), {id, 0x00});
+  }
+  out.insert(out.end(), {0, 63, 0});
+
+  BitWriter writer(&out);
+  int predictors[3] = {0, 0, 0};
+  for (int by = 0; by < blocks_y; ++by) {
+    for (int bx = 0; bx < blocks_x; ++bx) {
+      Rgb rgb = color(bx, by);
+      double ycbcr[3] = {
+          0.299 * rgb.r + 0.587 * rgb.g + 0.114 * rgb.b,
+          -0.168736 * rgb.r - 0.331264 * rgb.g + 0.5 * rgb.b + 128,
+          0.5 * rgb.r - 0.418688 * rgb.g - 0.081312 * rgb.b + 128};
+      for (int c = 0; c < 3; ++c) {
+        // the DC coefficient of a block of value v is 8 * (v - 128)
+        int dc = static_cast<int>(std::lround(8 * (ycbcr[c] - 128)));
+        int diff = dc - predictors[c];
+        predictors[c] = dc;
+        int category = Category(diff);
+        writer.Put(category, 4);
+        if (category > 0) {
+          writer.Put(diff < 0 ? diff + (1 << category) - 1 : diff, category);
+        }
+        writer.Put(0, 1);  // end of block
+      }
+    }
+  }
+  writer.Finish();
+
+  PutMarker(0xD9, &out);  // EOI
+  return out;
+}
+
+std::vector<uint8_t> EncodeSolidJpeg(int width, int height, Rgb rgb) {
+  return EncodeBlockJpeg(
+      width / 8, height / 8, [rgb](int, int) { return rgb; });
+}
+
+// Reads the same batch of the file bytes of the images and the labels every
+// time.
+class StubImageBytesReader : public framework::ReaderBase {
+ public:
+  explicit StubImageBytesReader(
+      const std::vector<std::vector<uint8_t>>& images)
+      : framework::ReaderBase(
+            {common::make_ddim({-1, 1}), common::make_ddim({-1, 1})},
+            {framework::proto::VarType::UINT8,
+             framework::proto::VarType::INT64},
+            {false, false}) {
+    size_t total = 0;
+    framework::LoD lod(1, {0});
+    for (const auto& image : images) {
+      total += image.size();
+      lod[0].push_back(total);
+    }
+    bytes_.Resize(common::make_ddim({static_cast<int64_t>(total), 1}));
+    uint8_t* data = bytes_.mutable_data<uint8_t>(platform::CPUPlace());
+    for (const auto& image : images) {
+      data = std::copy(image.begin(), image.end(), data);
+    }
+    bytes_.set_lod(lod);
+
+    labels_.Resize(
+        common::make_ddim({static_cast<int64_t>(images.size()), 1}));
+    int64_t* labels = labels_.mutable_data<int64_t>(platform::CPUPlace());
+    for (size_t i = 0; i < images.size(); ++i) {
+      labels[i] = static_cast<int64_t>(i) * 10;
+    }
+  }
+
+ protected:
+  void ReadNextImpl(framework::LoDTensorArray* out) override {
+    out->resize(2);
+    framework::TensorCopySync(bytes_, platform::CPUPlace(), &(*out)[0]);
+    (*out)[0].set_lod(bytes_.lod());
+    framework::TensorCopySync(labels_, platform::CPUPlace(), &(*out)[1]);
+  }
+
+ private:
+  phi::DenseTensor bytes_;
+  phi::DenseTensor labels_;
+};
+
+// Reads a batch through a GPUImageReader and returns the images on the CPU.
+std::vector<float> ReadImages(const std::vector<std::vector<uint8_t>>& images,
+                              const GPUImageTransform& transform,
+                              phi::DenseTensor* labels = nullptr) {
+  auto root = std::make_shared<StubImageBytesReader>(images);
+  auto reader = framework::MakeDecoratedReader<GPUImageReader>(
+      root, platform::CUDAPlace(0), transform);
+  framework::LoDTensorArray out;
+  reader->ReadNext(&out);
+  EXPECT_EQ(out.size(), 2UL);
+  EXPECT_TRUE(platform::is_gpu_place(out[0].place()));
+  phi::DenseTensor cpu_images;
+  framework::TensorCopySync(out[0], platform::CPUPlace(), &cpu_images);
+  if (labels != nullptr) {
+    *labels = out[1];
+  }
+  const float* data = cpu_images.data<float>();
+  return std::vector<float>(data, data + cpu_images.numel());
+}
+
+// the tolerance of the colors, for the rounding of the YCbCr conversion
+constexpr float kColorTolerance = 3.f;
+
+TEST(GPUImageReader, DecodeAndResize) {
+  const std::vector<Rgb> colors{{200, 30, 90}, {10, 140, 250}};
+  GPUImageTransform transform;
+  transform.height = 8;
+  transform.width = 12;
+  phi::DenseTensor labels;
+  std::vector<float> images =
+      ReadImages({EncodeSolidJpeg(16, 24, colors[0]),
+                  EncodeSolidJpeg(40, 8, colors[1])},
+                 transform,
+                 &labels);
+
+  ASSERT_EQ(images.size(), 2UL * 3 * 8 * 12);
+  const int plane = 8 * 12;
+  for (int n = 0; n < 2; ++n) {
+    const int rgb[3] = {colors[n].r, colors[n].g, colors[n].b};
+    for (int c = 0; c < 3; ++c) {
+      for (int i = 0; i < plane; ++i) {
+        EXPECT_NEAR(images[(n * 3 + c) * plane + i], rgb[c], kColorTolerance);
+      }
+    }
+  }
+
+  // the labels are passed through
+  ASSERT_EQ(labels.numel(), 2);
+  EXPECT_EQ(labels.data<int64_t>()[0], 0);
+  EXPECT_EQ(labels.data<int64_t>()[1], 10);
+}
+
+TEST(GPUImageReader, NormalizeChannelLast) {
+  const Rgb color{120, 60, 240};
+  GPUImageTransform transform;
+  transform.height = 4;
+  transform.width = 4;
+  transform.data_layout = "NHWC";
+  transform.mean = {10.f, 20.f, 30.f};
+  transform.std = {2.f, 4.f, 8.f};
+  std::vector<float> images =
+      ReadImages({EncodeSolidJpeg(8, 8, color)}, transform);
+
+  ASSERT_EQ(images.size(), 4UL * 4 * 3);
+  const int rgb[3] = {color.r, color.g, color.b};
+  for (int i = 0; i < 4 * 4; ++i) {
+    for (int c = 0; c < 3; ++c) {
+      EXPECT_NEAR(images[i * 3 + c],
+                  (rgb[c] - transform.mean[c]) / transform.std[c],
+                  kColorTolerance / transform.std[c]);
+    }
+  }
+}
+
+TEST(GPUImageReader, Flip) {
+  // dark on the left, bright on the right
+  const Rgb left{20, 20, 20};
+  const Rgb right{230, 230, 230};
+  auto image = EncodeBlockJpeg(
+      2, 1, [&](int bx, int) { return bx == 0 ? left : right; });
+  GPUImageTransform transform;
+  transform.height = 8;
+  transform.width = 16;
+  for (float flip_prob : {0.f, 1.f}) {
+    transform.flip_prob = flip_prob;
+    std::vector<float> images = ReadImages({image}, transform);
+    ASSERT_EQ(images.size(), 3UL * 8 * 16);
+    const Rgb& expected_left = flip_prob == 0.f ? left : right;
+    const Rgb& expected_right = flip_prob == 0.f ? right : left;
+    for (int c = 0; c < 3; ++c) {
+      for (int y = 0; y < 8; ++y) {
+        // away from the edge between the blocks
+        EXPECT_NEAR(images[(c * 8 + y) * 16 + 3],
+                    expected_left.r,
+                    kColorTolerance);
+        EXPECT_NEAR(images[(c * 8 + y) * 16 + 12],
+                    expected_right.r,
+                    kColorTolerance);
+      }
+    }
+  }
+}
+
+TEST(GPUImageReader, RandomCropSeed) {
+  auto image = EncodeBlockJpeg(4, 4, [](int bx, int by) {
+    return Rgb{bx * 60, by * 60, 255 - bx * 30 - by * 30};
+  });
+  GPUImageTransform transform;
+  transform.height = 16;
+  transform.width = 16;
+  transform.random_crop = true;
+  transform.min_area = 0.1f;
+  transform.flip_prob = 0.5f;
+  transform.seed = 2024;
+  // the same seed gives the same crops and flips
+  std::vector<float> first = ReadImages({image, image, image}, transform);
+  std::vector<float> second = ReadImages({image, image, image}, transform);
+  ASSERT_EQ(first.size(), 3UL * 3 * 16 * 16);
+  EXPECT_EQ(first, second);
+}
+
+}  // namespace reader
+}  // namespace operators
+}  // namespace paddle
@@ -247,3 +247,41 @@ TEST(BlockingQueue, speed_test_mode) {
   }
   EXPECT_EQ(q2.Size(), queue_size);
 }
+
+TEST(BlockingQueue, BatchTest) {
+  BlockingQueue<size_t> q(3);
+  std::thread sender([&]() {
+    std::vector<size_t> elems{0, 1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(q.SendBatch(&elems), elems.size());
+    q.Close();
+  });
+  std::vector<size_t> received;
+  while (q.ReceiveBatch(2, &received) != 0) {
+    EXPECT_LE(q.Size(), q.Cap());
+  }
+  sender.join();
+  EXPECT_EQ(received, (std::vector<size_t>{0, 1, 2, 3, 4, 5, 6}));
+
+  std::vector<size_t> elems{7, 8};
+  EXPECT_EQ(q.SendBatch(&elems), 0UL);
+}
+
+TEST(BlockingQueue, SpinTest) {
+  BlockingQueue<size_t> q(2, false, 1000, "spin_test");
+  auto* depth = phi::MetricsRegistry::Instance().GetGauge(
+      "paddle_reader_queue_depth", "", "queue=\"spin_test\"");
+  std::thread sender([&]() {
+    for (size_t i = 0; i < 100; ++i) {
+      EXPECT_TRUE(q.Send(i));
+    }
+    q.Close();
+  });
+  size_t elem = 0;
+  size_t count = 0;
+  while (q.Receive(&elem)) {
+    EXPECT_EQ(elem, count++);
+  }
+  sender.join();
+  EXPECT_EQ(count, 100UL);
+  EXPECT_DOUBLE_EQ(depth->Value(), 0);
+}
@@ -181,6 +181,33 @@ TEST(PD_Tensor, uint8) {
   PD_PredictorDestroy(predictor);
 }
 
+TEST(PD_Tensor, share_external_data) {
+  auto model_dir = FLAGS_infer_model;
+  PD_Config* config = PD_ConfigCreate();
+  PD_ConfigSetModel(config,
+                    (model_dir + "/__model__").c_str(),
+                    (model_dir + "/__params__").c_str());
+  PD_Predictor* predictor = PD_PredictorCreate(config);
+  PD_OneDimArrayCstr* input_names = PD_PredictorGetInputNames(predictor);
+  PD_Tensor* tensor =
+      PD_PredictorGetInputHandle(predictor, input_names->data[0]);
+  std::array<int32_t, 4> shapes = {1, 3, 300, 300};
+  std::vector<float> input(1 * 3 * 300 * 300, 0);
+  PD_TensorShareExternalDataFloat(
+      tensor, input.data(), shapes.size(), shapes.data(), PD_PLACE_CPU);
+  int32_t size;
+  PD_PlaceType place;
+  float* data_ptr = PD_TensorDataFloat(tensor, &place, &size);
+  EXPECT_EQ(data_ptr, input.data());
+  EXPECT_EQ(place, PD_PLACE_CPU);
+  EXPECT_EQ(size, 1 * 3 * 300 * 300);
+  EXPECT_TRUE(PD_PredictorRun(predictor));
+
+  PD_TensorDestroy(tensor);
+  PD_OneDimArrayCstrDestroy(input_names);
+  PD_PredictorDestroy(predictor);
+}
+
 std::string read_file(std::string filename) {
   std::ifstream file(filename);
   return std::string((std::istreambuf_iterator<char>(file)),
@@ -0,0 +1,175 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+
+namespace paddle_infer {
+namespace services {
+
+// blocks of 4 tokens, at most 8 blocks for a sequence
+KVCacheManager MakeManager(int num_blocks) {
+  return KVCacheManager(
+      1, num_blocks, 4, 2, 8, DataType::FLOAT32, 8, 8, /*device_id=*/0);
+}
+
+using Ids = std::vector<int64_t>;
+using Lens = std::vector<int>;
+
+TEST(DecodeScheduler, JoinAndLeave) {
+  KVCacheManager manager = MakeManager(8);
+  DecodeScheduler scheduler(&manager, 4, 16);
+  scheduler.AddRequest(1, 5, 3);
+
+  DecodeStep step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1}));
+  EXPECT_EQ(step.seq_lens_encoder, (Lens{5}));
+  EXPECT_EQ(step.seq_lens_decoder, (Lens{0}));
+  EXPECT_EQ(step.seq_lens_this_time, (Lens{5}));
+  EXPECT_EQ(step.num_tokens, 5);
+
+  // joins the running request in the next step
+  scheduler.AddRequest(2, 3, 1);
+  EXPECT_TRUE(scheduler.Update(step, {}).empty());
+  step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1, 2}));
+  EXPECT_EQ(step.seq_lens_encoder, (Lens{0, 3}));
+  EXPECT_EQ(step.seq_lens_decoder, (Lens{5, 0}));
+  EXPECT_EQ(step.seq_lens_this_time, (Lens{1, 3}));
+  EXPECT_EQ(step.num_tokens, 4);
+
+  // 2 finishes at max_new_tokens and leaves
+  EXPECT_EQ(scheduler.Update(step, {}), (Ids{2}));
+  EXPECT_EQ(scheduler.NumRequests(), 1UL);
+  step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1}));
+  EXPECT_EQ(step.seq_lens_decoder, (Lens{6}));
+  EXPECT_EQ(scheduler.Update(step, {}), (Ids{1}));
+
+  EXPECT_EQ(scheduler.NumRequests(), 0UL);
+  EXPECT_EQ(manager.NumFreeBlocks(), 8);
+  EXPECT_TRUE(scheduler.Schedule().empty());
+}
+
+TEST(DecodeScheduler, FinishAtEos) {
+  KVCacheManager manager = MakeManager(8);
+  DecodeScheduler scheduler(&manager, 4, 16);
+  scheduler.AddRequest(1, 4, 100);
+  scheduler.AddRequest(2, 4, 100);
+  DecodeStep step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1, 2}));
+  EXPECT_TRUE(scheduler.Update(step, {}).empty());
+
+  step = scheduler.Schedule();
+  EXPECT_EQ(scheduler.Update(step, {2}), (Ids{2}));
+  step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1}));
+  EXPECT_EQ(scheduler.Update(step, {1}), (Ids{1}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 8);
+  EXPECT_ANY_THROW(manager.GetBlockTable(1));
+}
+
+TEST(DecodeScheduler, TokenBudgetAndBatchSize) {
+  KVCacheManager manager = MakeManager(16);
+  DecodeScheduler scheduler(&manager, 2, 16);
+  scheduler.AddRequest(1, 10, 100);
+  scheduler.AddRequest(2, 10, 100);
+  scheduler.AddRequest(3, 2, 100);
+
+  // 2 waits for the budget, and 3 behind it in order
+  DecodeStep step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1}));
+  EXPECT_EQ(step.num_tokens, 10);
+  scheduler.Update(step, {});
+
+  // the decode of 1 first, then 2 within the budget
+  step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1, 2}));
+  EXPECT_EQ(step.seq_lens_this_time, (Lens{1, 10}));
+  EXPECT_EQ(step.num_tokens, 11);
+  scheduler.Update(step, {});
+
+  // 3 waits for a slot of the batch
+  step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1, 2}));
+  EXPECT_EQ(step.seq_lens_encoder, (Lens{0, 0}));
+  EXPECT_EQ(scheduler.Update(step, {1}), (Ids{1}));
+  step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{2, 3}));
+  EXPECT_EQ(step.seq_lens_encoder, (Lens{0, 2}));
+}
+
+TEST(DecodeScheduler, LongPromptAlone) {
+  KVCacheManager manager = MakeManager(16);
+  DecodeScheduler scheduler(&manager, 4, 16);
+  scheduler.AddRequest(1, 20, 100);
+  scheduler.AddRequest(2, 2, 100);
+  DecodeStep step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1}));
+  EXPECT_EQ(step.num_tokens, 20);
+}
+
+TEST(DecodeScheduler, Preempt) {
+  // a block for each of the prompts
+  KVCacheManager manager = MakeManager(4);
+  DecodeScheduler scheduler(&manager, 4, 16);
+  for (int64_t id = 1; id <= 4; ++id) {
+    scheduler.AddRequest(id, 4, 100);
+  }
+  DecodeStep step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1, 2, 3, 4}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 0);
+  scheduler.Update(step, {});
+
+  // the decodes of 1 and 2 need a new block each, freed by the latest
+  // admitted 4 and 3
+  step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1, 2}));
+  EXPECT_EQ(step.seq_lens_decoder, (Lens{4, 4}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 0);
+  EXPECT_EQ(scheduler.NumRequests(), 4UL);
+  EXPECT_EQ(scheduler.Update(step, {1, 2}), (Ids{1, 2}));
+
+  // prefilled again with the tokens they generated
+  step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{3, 4}));
+  EXPECT_EQ(step.seq_lens_encoder, (Lens{5, 5}));
+  EXPECT_EQ(step.seq_lens_decoder, (Lens{0, 0}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 0);
+}
+
+TEST(DecodeScheduler, CacheFull) {
+  KVCacheManager manager = MakeManager(2);
+  DecodeScheduler scheduler(&manager, 4, 16);
+  scheduler.AddRequest(1, 8, 100);
+  DecodeStep step = scheduler.Schedule();
+  EXPECT_EQ(step.request_ids, (Ids{1}));
+  scheduler.Update(step, {});
+
+  // alone and out of blocks, finished by the next Update
+  step = scheduler.Schedule();
+  EXPECT_TRUE(step.empty());
+  EXPECT_EQ(scheduler.Update(step, {}), (Ids{1}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 2);
+
+  // a prompt the cache can never hold
+  scheduler.AddRequest(2, 12, 100);
+  EXPECT_ANY_THROW(scheduler.Schedule());
+  EXPECT_ANY_THROW(scheduler.AddRequest(2, 4, 100));
+}
+
+}  // namespace services
+}  // namespace paddle_infer
@@ -0,0 +1,132 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+
+namespace paddle_infer {
+namespace services {
+
+// blocks of 4 tokens, at most 4 blocks for a sequence
+KVCacheManager MakeManager(int num_blocks = 8) {
+  return KVCacheManager(
+      2, num_blocks, 4, 2, 8, DataType::FLOAT32, 4, 4, /*device_id=*/0);
+}
+
+TEST(KVCacheManager, AllocateAndAppend) {
+  KVCacheManager manager = MakeManager();
+  EXPECT_EQ(manager.NumFreeBlocks(), 8);
+
+  ASSERT_TRUE(manager.Allocate(1, 6));
+  EXPECT_EQ(manager.GetBlockTable(1), (std::vector<int>{0, 1}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 6);
+
+  // fills the last block
+  ASSERT_TRUE(manager.Append(1, 2));
+  EXPECT_EQ(manager.GetBlockTable(1), (std::vector<int>{0, 1}));
+  ASSERT_TRUE(manager.Append(1));
+  EXPECT_EQ(manager.GetBlockTable(1), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 5);
+
+  ASSERT_TRUE(manager.Allocate(2, 4));
+  EXPECT_EQ(manager.GetBlockTable(2), (std::vector<int>{3}));
+
+  manager.Free(1);
+  EXPECT_EQ(manager.NumFreeBlocks(), 7);
+  EXPECT_ANY_THROW(manager.GetBlockTable(1));
+  manager.Free(2);
+  EXPECT_EQ(manager.NumFreeBlocks(), 8);
+}
+
+TEST(KVCacheManager, FailWithoutChange) {
+  KVCacheManager manager = MakeManager(4);
+  ASSERT_TRUE(manager.Allocate(1, 12));
+  EXPECT_EQ(manager.NumFreeBlocks(), 1);
+
+  // more blocks than max_blocks_per_seq
+  EXPECT_FALSE(manager.Append(1, 5));
+  EXPECT_EQ(manager.GetBlockTable(1).size(), 3UL);
+  EXPECT_FALSE(manager.Allocate(2, 17));
+  // more blocks than are free
+  EXPECT_FALSE(manager.Allocate(2, 8));
+  EXPECT_EQ(manager.NumFreeBlocks(), 1);
+  EXPECT_ANY_THROW(manager.GetBlockTable(2));
+
+  ASSERT_TRUE(manager.Append(1, 4));
+  EXPECT_EQ(manager.GetBlockTable(1).size(), 4UL);
+  EXPECT_EQ(manager.NumFreeBlocks(), 0);
+  EXPECT_FALSE(manager.Allocate(2, 1));
+  // the allocated sequences can not be allocated again
+  EXPECT_ANY_THROW(manager.Allocate(1, 1));
+}
+
+TEST(KVCacheManager, ForkCopyOnWrite) {
+  KVCacheManager manager = MakeManager();
+  // a prompt of 9 tokens, with a partial last block
+  ASSERT_TRUE(manager.Allocate(1, 9));
+  EXPECT_EQ(manager.GetBlockTable(1), (std::vector<int>{0, 1, 2}));
+
+  manager.Fork(1, 2);
+  EXPECT_EQ(manager.GetBlockTable(2), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 5);
+
+  // the shared partial last block is copied for the child
+  ASSERT_TRUE(manager.Append(2));
+  EXPECT_EQ(manager.GetBlockTable(2), (std::vector<int>{0, 1, 3}));
+  EXPECT_EQ(manager.GetBlockTable(1), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 4);
+
+  // and no longer shared with the parent
+  ASSERT_TRUE(manager.Append(1));
+  EXPECT_EQ(manager.GetBlockTable(1), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 4);
+
+  // the shared blocks are freed with their last sequence
+  manager.Free(1);
+  EXPECT_EQ(manager.NumFreeBlocks(), 5);
+  manager.Free(2);
+  EXPECT_EQ(manager.NumFreeBlocks(), 8);
+}
+
+TEST(KVCacheManager, ForkFullLastBlock) {
+  KVCacheManager manager = MakeManager();
+  ASSERT_TRUE(manager.Allocate(1, 8));
+  manager.Fork(1, 2);
+  // the new tokens go to a new block, nothing is copied
+  ASSERT_TRUE(manager.Append(2));
+  EXPECT_EQ(manager.GetBlockTable(2), (std::vector<int>{0, 1, 2}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 5);
+  EXPECT_ANY_THROW(manager.Fork(1, 2));
+}
+
+TEST(KVCacheManager, Rollback) {
+  KVCacheManager manager = MakeManager();
+  ASSERT_TRUE(manager.Allocate(1, 5));
+  // the draft tokens of a speculative step
+  ASSERT_TRUE(manager.Append(1, 6));
+  EXPECT_EQ(manager.GetBlockTable(1).size(), 3UL);
+
+  // keeps the partial block of the accepted tokens
+  manager.Rollback(1, 2);
+  EXPECT_EQ(manager.GetBlockTable(1).size(), 3UL);
+  manager.Rollback(1, 4);
+  EXPECT_EQ(manager.GetBlockTable(1), (std::vector<int>{0, 1}));
+  EXPECT_EQ(manager.NumFreeBlocks(), 6);
+  EXPECT_ANY_THROW(manager.Rollback(1, 6));
+}
+
+}  // namespace services
+}  // namespace paddle_infer
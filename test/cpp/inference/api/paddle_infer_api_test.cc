@@ -15,6 +15,9 @@ limitations under the License. */
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <future>
+#include <random>
+
 #include "paddle/common/flags.h"
 #include "test/cpp/inference/api/tester_helper.h"
 
@@ -93,4 +96,104 @@ TEST(PredictorPool, basic) {
   }
 }
 
+std::vector<float> RunDirectly(Predictor *predictor,
+                               const std::vector<int> &in_shape,
+                               const std::vector<float> &input) {
+  auto input_t = predictor->GetInputHandle(predictor->GetInputNames()[0]);
+  input_t->Reshape(in_shape);
+  input_t->CopyFromCpu(input.data());
+  predictor->Run();
+  auto output_t = predictor->GetOutputHandle(predictor->GetOutputNames()[0]);
+  std::vector<int> output_shape = output_t->shape();
+  int out_num = std::accumulate(
+      output_shape.begin(), output_shape.end(), 1, std::multiplies<int>());
+  std::vector<float> out_data(out_num);
+  output_t->CopyToCpu(out_data.data());
+  return out_data;
+}
+
+TEST(BatchingPredictor, basic) {
+  std::string model_dir = FLAGS_infer_model + "/model";
+  Config config;
+  config.SetModel(model_dir + "/model", model_dir + "/params");
+  config.EnableUseGpu(100, 0);
+  auto predictor = CreatePredictor(config);
+
+  // a long delay, so the requests submitted together are batched
+  services::BatchingPredictor batching_pred(config, 1, 4, 200000);
+
+  const int num_requests = 6;
+  std::vector<int> in_shape = {1, 3, 318, 318};
+  std::vector<int> small_shape = {2, 3, 224, 224};
+  std::mt19937 rng(2024);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  std::vector<std::vector<float>> inputs(num_requests);
+  std::vector<std::vector<int>> shapes(num_requests);
+  std::vector<std::future<std::vector<paddle::PaddleTensor>>> futures;
+  int total_rows = 0;
+  for (int i = 0; i < num_requests; ++i) {
+    // the last request differs in dims other than dim 0
+    shapes[i] = i + 1 == num_requests ? small_shape : in_shape;
+    total_rows += shapes[i][0];
+    int in_num = std::accumulate(
+        shapes[i].begin(), shapes[i].end(), 1, std::multiplies<int>());
+    inputs[i].resize(in_num);
+    for (auto &value : inputs[i]) {
+      value = dist(rng);
+    }
+    paddle::PaddleTensor tensor;
+    tensor.shape = shapes[i];
+    tensor.dtype = paddle::PaddleDType::FLOAT32;
+    tensor.data =
+        paddle::PaddleBuf(inputs[i].data(), inputs[i].size() * sizeof(float));
+    futures.push_back(batching_pred.Submit({tensor}));
+  }
+
+  for (int i = 0; i < num_requests; ++i) {
+    std::vector<paddle::PaddleTensor> outputs = futures[i].get();
+    ASSERT_FALSE(outputs.empty());
+    EXPECT_EQ(outputs[0].shape[0], shapes[i][0]);
+    std::vector<float> expected =
+        RunDirectly(predictor.get(), shapes[i], inputs[i]);
+    ASSERT_EQ(outputs[0].data.length(), expected.size() * sizeof(float));
+    const float *data = static_cast<const float *>(outputs[0].data.data());
+    for (size_t j = 0; j < expected.size(); ++j) {
+      EXPECT_NEAR(data[j], expected[j], 1e-4);
+    }
+  }
+
+  // the blocking Run of a single request
+  std::vector<paddle::PaddleTensor> outputs;
+  paddle::PaddleTensor tensor;
+  tensor.shape = in_shape;
+  tensor.dtype = paddle::PaddleDType::FLOAT32;
+  tensor.data =
+      paddle::PaddleBuf(inputs[0].data(), inputs[0].size() * sizeof(float));
+  ASSERT_TRUE(batching_pred.Run({tensor}, &outputs));
+  total_rows += in_shape[0];
+
+  services::BatchingStats stats = batching_pred.GetStats();
+  EXPECT_EQ(stats.num_requests, num_requests + 1);
+  int64_t num_batches = 0;
+  int64_t num_rows = 0;
+  int64_t max_batch_size = 0;
+  for (size_t i = 1; i < stats.batch_size_histogram.size(); ++i) {
+    num_batches += stats.batch_size_histogram[i];
+    num_rows += stats.batch_size_histogram[i] * static_cast<int64_t>(i);
+    if (stats.batch_size_histogram[i] > 0) {
+      max_batch_size = static_cast<int64_t>(i);
+    }
+  }
+  EXPECT_EQ(num_batches, stats.num_batches);
+  EXPECT_EQ(num_rows, total_rows);
+  EXPECT_LE(max_batch_size, 4);
+  // some of the requests were coalesced
+  EXPECT_GT(max_batch_size, 1);
+  EXPECT_LT(stats.num_batches, stats.num_requests);
+  EXPECT_EQ(std::accumulate(stats.queue_wait_us_histogram.begin(),
+                            stats.queue_wait_us_histogram.end(),
+                            int64_t{0}),
+            stats.num_requests);
+}
+
 }  // namespace paddle_infer
@@ -18,6 +18,7 @@
 
 #include "gtest/gtest.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/variable.h"
 #include "paddle/fluid/platform/timer.h"
@@ -32,6 +33,8 @@
 #include "paddle/fluid/jit/layer.h"
 #include "paddle/fluid/jit/serializer.h"
 
+COMMON_DECLARE_bool(jit_engine_warmup);
+
 USE_OP_ITSELF(elementwise_add);
 USE_OP_ITSELF(matmul_v2);
 USE_OP_ITSELF(relu);
@@ -159,6 +162,23 @@ TEST(CpuLayerTest, Clone) {
   EXPECT_NEAR(out_data[0], pow(1.41562390, 2.0), 1e-6);
 }
 
+TEST(CpuLayerTest, Warmup) {
+  auto place = phi::CPUPlace();
+  std::string path = "./multi_program_load/export";
+  FLAGS_jit_engine_warmup = true;
+  auto layer = jit::Load(path, place);
+  FLAGS_jit_engine_warmup = false;
+
+  auto inputs = PrepareInputs(place);
+  auto outs = layer.forward(inputs);
+  auto out_data = outs[0].data<float>();
+  EXPECT_NEAR(out_data[0], 0.02194316, 1e-6);
+
+  outs = layer.Function("infer")(inputs);
+  out_data = outs[0].data<float>();
+  EXPECT_NEAR(out_data[0], 1.41562390, 1e-6);
+}
+
 #if defined(PADDLE_WITH_CUDA)
 TEST(GpuLayerTest, Construct) {
   auto place = phi::GPUPlace();
@@ -0,0 +1,81 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "paddle/fluid/framework/new_executor/interpreter/data_transfer.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+static void Allocate(phi::DenseTensor* tensor, const phi::DDim& dims) {
+  tensor->Resize(dims);
+  tensor->mutable_data<float>(phi::CPUPlace());
+}
+
+TEST(DataTransferCache, HitWhileUnchanged) {
+  phi::DenseTensor src;
+  Allocate(&src, common::make_ddim({4, 8}));
+  DataTransferStat stat;
+  stat.cacheable = true;
+
+  EXPECT_FALSE(CheckDataTransferCache(&src, &stat));
+  EXPECT_TRUE(CheckDataTransferCache(&src, &stat));
+  EXPECT_TRUE(CheckDataTransferCache(&src, &stat));
+
+  // written in place
+  src.InplaceVersionCounter().Bump();
+  EXPECT_FALSE(CheckDataTransferCache(&src, &stat));
+  EXPECT_TRUE(CheckDataTransferCache(&src, &stat));
+
+  // reshaped on the same allocation
+  src.Resize(common::make_ddim({8, 4}));
+  EXPECT_FALSE(CheckDataTransferCache(&src, &stat));
+  EXPECT_TRUE(CheckDataTransferCache(&src, &stat));
+}
+
+TEST(DataTransferCache, NewAllocation) {
+  phi::DenseTensor src;
+  Allocate(&src, common::make_ddim({4, 8}));
+  DataTransferStat stat;
+  stat.cacheable = true;
+  EXPECT_FALSE(CheckDataTransferCache(&src, &stat));
+  const phi::Allocation* old_holder = src.Holder().get();
+
+  // the cache holds the old allocation, so the new one of the same size
+  // cannot take its address
+  src.clear();
+  Allocate(&src, common::make_ddim({4, 8}));
+  EXPECT_NE(src.Holder().get(), old_holder);
+  EXPECT_FALSE(CheckDataTransferCache(&src, &stat));
+  EXPECT_TRUE(CheckDataTransferCache(&src, &stat));
+}
+
+TEST(DataTransferCache, NotCacheable) {
+  phi::DenseTensor src;
+  Allocate(&src, common::make_ddim({4, 8}));
+  DataTransferStat stat;
+  EXPECT_FALSE(CheckDataTransferCache(&src, &stat));
+  EXPECT_FALSE(CheckDataTransferCache(&src, &stat));
+
+  phi::DenseTensor uninitialized;
+  stat.cacheable = true;
+  EXPECT_FALSE(CheckDataTransferCache(&uninitialized, &stat));
+}
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
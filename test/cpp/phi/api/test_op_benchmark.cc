@@ -0,0 +1,345 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Micro-benchmarks of phi ops over the C++ API, for tracking the kernel
+// performance across upgrades.
+//
+// Every case of the config is run on every place the build supports, and
+// three times are measured per call:
+//   - kernel: the selected phi kernel called on a prepared KernelContext,
+//   - dispatch: the C++ API call returning, without waiting for the device,
+//   - end_to_end: the C++ API call and the device finishing it.
+// The config is read from PADDLE_OP_BENCHMARK_CONFIG if set, one case per
+// line, e.g. `matmul float16 4096x4096 4096x4096`, and the results are
+// written as JSON to PADDLE_OP_BENCHMARK_OUTPUT, or to stdout.
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/api/include/api.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/int_array.h"
+#include "paddle/phi/core/compat/convert_utils.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/kernel_factory.h"
+#include "test/cpp/phi/core/timer.h"
+
+namespace paddle {
+namespace tests {
+
+struct OpBenchmark {
+  size_t num_inputs;
+  std::string kernel_name;
+  std::function<Tensor(const std::vector<Tensor>&)> api;
+  // appends the attributes of the kernel, the ones the api is called with
+  std::function<void(phi::KernelContext*)> emplace_attrs;
+};
+
+struct OpBenchmarkCase {
+  std::string op;
+  phi::DataType dtype;
+  std::vector<std::vector<int64_t>> shapes;
+};
+
+static const std::map<std::string, OpBenchmark>& OpBenchmarks() {
+  static const std::map<std::string, OpBenchmark> benchmarks = {
+      {"add",
+       {2,
+        "add",
+        [](const std::vector<Tensor>& x) {
+          return experimental::add(x[0], x[1]);
+        },
+        nullptr}},
+      {"multiply",
+       {2,
+        "multiply",
+        [](const std::vector<Tensor>& x) {
+          return experimental::multiply(x[0], x[1]);
+        },
+        nullptr}},
+      {"exp",
+       {1,
+        "exp",
+        [](const std::vector<Tensor>& x) { return experimental::exp(x[0]); },
+        nullptr}},
+      {"relu",
+       {1,
+        "relu",
+        [](const std::vector<Tensor>& x) { return experimental::relu(x[0]); },
+        nullptr}},
+      {"matmul",
+       {2,
+        "matmul",
+        [](const std::vector<Tensor>& x) {
+          return experimental::matmul(x[0], x[1], false, false);
+        },
+        [](phi::KernelContext* ctx) {
+          ctx->EmplaceBackAttr(false);
+          ctx->EmplaceBackAttr(false);
+        }}},
+      {"softmax",
+       {1,
+        "softmax",
+        [](const std::vector<Tensor>& x) {
+          return experimental::softmax(x[0], -1);
+        },
+        [](phi::KernelContext* ctx) { ctx->EmplaceBackAttr(-1); }}},
+      {"sum",
+       {1,
+        "sum",
+        [](const std::vector<Tensor>& x) {
+          return experimental::sum(x[0], {}, phi::DataType::UNDEFINED, false);
+        },
+        [](phi::KernelContext* ctx) {
+          ctx->EmplaceBackAttr(phi::IntArray(std::vector<int64_t>{}));
+          ctx->EmplaceBackAttr(phi::DataType::UNDEFINED);
+          ctx->EmplaceBackAttr(false);
+        }}},
+  };
+  return benchmarks;
+}
+
+static std::vector<OpBenchmarkCase> DefaultCases() {
+  return {
+      {"add", phi::DataType::FLOAT32, {{1024, 1024}, {1024, 1024}}},
+      {"multiply", phi::DataType::FLOAT32, {{1024, 1024}, {1024}}},
+      {"exp", phi::DataType::FLOAT32, {{1024, 1024}}},
+      {"relu", phi::DataType::FLOAT32, {{1024, 1024}}},
+      {"matmul", phi::DataType::FLOAT32, {{256, 256}, {256, 256}}},
+      {"softmax", phi::DataType::FLOAT32, {{256, 1024}}},
+      {"sum", phi::DataType::FLOAT32, {{1024, 1024}}},
+  };
+}
+
+// Parses the cases of the lines `op dtype shape...`, the dims of a shape
+// separated by `x`, and `#` starting a comment.
+static std::vector<OpBenchmarkCase> ParseCases(std::istream& is) {
+  std::vector<OpBenchmarkCase> cases;
+  std::string line;
+  while (std::getline(is, line)) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    OpBenchmarkCase op_case;
+    std::string dtype;
+    if (!(fields >> op_case.op >> dtype)) {
+      continue;
+    }
+    op_case.dtype = phi::StringToDataType(dtype);
+    std::string shape;
+    while (fields >> shape) {
+      std::vector<int64_t> dims;
+      std::istringstream dims_stream(shape);
+      std::string dim;
+      while (std::getline(dims_stream, dim, 'x')) {
+        dims.push_back(std::stoll(dim));
+      }
+      op_case.shapes.push_back(dims);
+    }
+    cases.push_back(op_case);
+  }
+  return cases;
+}
+
+static std::vector<phi::Place> BenchmarkPlaces() {
+  std::vector<phi::Place> places = {phi::CPUPlace()};
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  places.emplace_back(phi::GPUPlace(0));
+#endif
+#ifdef PADDLE_WITH_XPU
+  places.emplace_back(phi::XPUPlace(0));
+#endif
+  return places;
+}
+
+static size_t GetEnvSize(const char* name, size_t default_value) {
+  const char* value = std::getenv(name);
+  return value == nullptr ? default_value : std::stoul(value);
+}
+
+class OpBenchmarkRunner {
+ public:
+  OpBenchmarkRunner(const OpBenchmark& benchmark,
+                    const OpBenchmarkCase& op_case,
+                    const phi::Place& place)
+      : benchmark_(benchmark),
+        place_(place),
+        dev_ctx_(phi::DeviceContextPool::Instance().Get(place)) {
+    for (const auto& shape : op_case.shapes) {
+      inputs_.push_back(experimental::full(shape, 0.5, op_case.dtype, place));
+    }
+  }
+
+  // Average time of a call in microseconds
+  double Kernel(size_t warmup_runs, size_t runs) {
+    auto kernel_key = phi::KernelKey(phi::TransToPhiBackend(place_),
+                                     phi::DataLayout::ALL_LAYOUT,
+                                     inputs_[0].dtype());
+    auto kernel_result =
+        phi::KernelFactory::Instance().SelectKernelOrThrowError(
+            benchmark_.kernel_name, kernel_key);
+    // the output is allocated by the first call, like the api output
+    auto out = std::make_shared<phi::DenseTensor>();
+    out->set_meta(std::static_pointer_cast<phi::DenseTensor>(
+                      benchmark_.api(inputs_).impl())
+                      ->meta());
+    phi::KernelContext kernel_context(dev_ctx_);
+    for (const auto& input : inputs_) {
+      kernel_context.EmplaceBackInput(
+          std::static_pointer_cast<phi::DenseTensor>(input.impl()).get());
+    }
+    if (benchmark_.emplace_attrs) {
+      benchmark_.emplace_attrs(&kernel_context);
+    }
+    kernel_context.EmplaceBackOutput(out.get());
+    return Measure(warmup_runs, runs, [&]() {
+      kernel_result.kernel(&kernel_context);
+    });
+  }
+
+  double Dispatch(size_t warmup_runs, size_t runs) {
+    for (size_t i = 0; i < warmup_runs; ++i) {
+      benchmark_.api(inputs_);
+    }
+    dev_ctx_->Wait();
+    phi::tests::Timer timer;
+    timer.tic();
+    for (size_t i = 0; i < runs; ++i) {
+      benchmark_.api(inputs_);
+    }
+    double time_ms = timer.toc();
+    dev_ctx_->Wait();
+    return time_ms * 1000 / runs;
+  }
+
+  double EndToEnd(size_t warmup_runs, size_t runs) {
+    return Measure(warmup_runs, runs, [&]() {
+      benchmark_.api(inputs_);
+      dev_ctx_->Wait();
+    });
+  }
+
+ private:
+  double Measure(size_t warmup_runs,
+                 size_t runs,
+                 const std::function<void()>& call) {
+    for (size_t i = 0; i < warmup_runs; ++i) {
+      call();
+    }
+    dev_ctx_->Wait();
+    phi::tests::Timer timer;
+    timer.tic();
+    for (size_t i = 0; i < runs; ++i) {
+      call();
+    }
+    dev_ctx_->Wait();
+    return timer.toc() * 1000 / runs;
+  }
+
+  const OpBenchmark& benchmark_;
+  phi::Place place_;
+  phi::DeviceContext* dev_ctx_;
+  std::vector<Tensor> inputs_;
+};
+
+static std::string ShapesToString(
+    const std::vector<std::vector<int64_t>>& shapes) {
+  std::ostringstream os;
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    os << (i == 0 ? "" : ", ") << "[";
+    for (size_t j = 0; j < shapes[i].size(); ++j) {
+      os << (j == 0 ? "" : ", ") << shapes[i][j];
+    }
+    os << "]";
+  }
+  return os.str();
+}
+
+TEST(API, op_benchmark) {
+  std::vector<OpBenchmarkCase> cases = DefaultCases();
+  const char* config_path = std::getenv("PADDLE_OP_BENCHMARK_CONFIG");
+  if (config_path != nullptr) {
+    std::ifstream config(config_path);
+    ASSERT_TRUE(config.is_open()) << "Failed to open " << config_path;
+    cases = ParseCases(config);
+  }
+  size_t warmup_runs = GetEnvSize("PADDLE_OP_BENCHMARK_WARMUP_RUNS", 10);
+  size_t runs = GetEnvSize("PADDLE_OP_BENCHMARK_RUNS", 100);
+
+  std::ostringstream json;
+  json << "[";
+  bool first = true;
+  for (const auto& op_case : cases) {
+    auto iter = OpBenchmarks().find(op_case.op);
+    ASSERT_NE(iter, OpBenchmarks().end())
+        << "No benchmark registered for op " << op_case.op;
+    ASSERT_EQ(op_case.shapes.size(), iter->second.num_inputs)
+        << "Op " << op_case.op << " takes " << iter->second.num_inputs
+        << " inputs";
+    for (const auto& place : BenchmarkPlaces()) {
+      OpBenchmarkRunner runner(iter->second, op_case, place);
+      double kernel_us = runner.Kernel(warmup_runs, runs);
+      double dispatch_us = runner.Dispatch(warmup_runs, runs);
+      double end_to_end_us = runner.EndToEnd(warmup_runs, runs);
+      EXPECT_GT(end_to_end_us, 0);
+
+      json << (first ? "" : ",") << "\n  {\"op\": \"" << op_case.op
+           << "\", \"place\": \"" << place.DebugString() << "\", \"dtype\": \""
+           << phi::DataTypeToString(op_case.dtype) << "\", \"shapes\": ["
+           << ShapesToString(op_case.shapes)
+           << "], \"kernel_us\": " << kernel_us
+           << ", \"dispatch_us\": " << dispatch_us
+           << ", \"end_to_end_us\": " << end_to_end_us << "}";
+      first = false;
+    }
+  }
+  json << "\n]\n";
+
+  const char* output_path = std::getenv("PADDLE_OP_BENCHMARK_OUTPUT");
+  if (output_path != nullptr) {
+    std::ofstream output(output_path);
+    ASSERT_TRUE(output.is_open()) << "Failed to open " << output_path;
+    output << json.str();
+  } else {
+    std::cout << json.str();
+  }
+}
+
+TEST(API, op_benchmark_config) {
+  std::istringstream config(
+      "# op dtype shapes\n"
+      "matmul float16 64x128 128x32  # gemm\n"
+      "\n"
+      "relu float32 8\n");
+  auto cases = ParseCases(config);
+  ASSERT_EQ(cases.size(), 2UL);
+  EXPECT_EQ(cases[0].op, "matmul");
+  EXPECT_EQ(cases[0].dtype, phi::DataType::FLOAT16);
+  EXPECT_EQ(cases[0].shapes,
+            (std::vector<std::vector<int64_t>>{{64, 128}, {128, 32}}));
+  EXPECT_EQ(cases[1].op, "relu");
+  EXPECT_EQ(cases[1].shapes, (std::vector<std::vector<int64_t>>{{8}}));
+}
+
+}  // namespace tests
+}  // namespace paddle
@@ -48,6 +48,27 @@ TEST(KernelFactory, SelectedKernelMap) {
   }
 }
 
+TEST(KernelDispatchCache, SameKernelAsFactory) {
+  phi::KernelKey fp32_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  phi::KernelKey fp64_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT64);
+  auto& factory = phi::KernelFactory::Instance();
+  phi::KernelDispatchCache cache;
+  for (int i = 0; i < 3; ++i) {
+    for (const auto& key : {fp32_key, fp64_key}) {
+      auto cached = cache.Select("scale", key);
+      auto selected = factory.SelectKernelOrThrowError("scale", key);
+      EXPECT_EQ(&cached.kernel, &selected.kernel);
+      EXPECT_EQ(cached.has_fallback_cpu, selected.has_fallback_cpu);
+    }
+  }
+  // A registration may move the kernels, so the cache must select again.
+  factory.kernels();
+  EXPECT_EQ(&cache.Select("scale", fp32_key).kernel,
+            &factory.SelectKernelOrThrowError("scale", fp32_key).kernel);
+}
+
 template <typename T, typename Context>
 void TestKernel(const Context& dev_ctx,
                 const DenseTensor& x,
@@ -0,0 +1,79 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/metrics.h"
+
+namespace phi {
+namespace tests {
+
+TEST(METRICS, counter) {
+  auto& registry = MetricsRegistry::Instance();
+  auto* counter =
+      registry.GetCounter("test_counter_total", "A test counter.", "a=\"1\"");
+  EXPECT_EQ(counter,
+            registry.GetCounter(
+                "test_counter_total", "A test counter.", "a=\"1\""));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([counter] {
+      for (int j = 0; j < 1000; ++j) {
+        counter->Increase(2);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(counter->Value(), 16000);
+  EXPECT_NE(registry.ExportText().find("# TYPE test_counter_total counter\n"
+                                       "test_counter_total{a=\"1\"} 16000\n"),
+            std::string::npos);
+}
+
+TEST(METRICS, gauge) {
+  auto* gauge =
+      MetricsRegistry::Instance().GetGauge("test_gauge", "A test gauge.");
+  gauge->Set(3);
+  gauge->Add(-1.5);
+  EXPECT_DOUBLE_EQ(gauge->Value(), 1.5);
+  EXPECT_THROW(MetricsRegistry::Instance().GetCounter("test_gauge", ""),
+               common::enforce::EnforceNotMet);
+}
+
+TEST(METRICS, histogram) {
+  auto* histogram = MetricsRegistry::Instance().GetHistogram(
+      "test_histogram", "A test histogram.", "", {1, 2});
+  histogram->Observe(0.5);
+  histogram->Observe(1);
+  histogram->Observe(1.5);
+  histogram->Observe(10);
+  EXPECT_EQ(histogram->BucketCounts(), (std::vector<int64_t>{2, 1, 1}));
+  EXPECT_DOUBLE_EQ(histogram->Sum(), 13);
+  EXPECT_NE(MetricsRegistry::Instance().ExportText().find(
+                "test_histogram_bucket{le=\"1\"} 2\n"
+                "test_histogram_bucket{le=\"2\"} 3\n"
+                "test_histogram_bucket{le=\"+Inf\"} 4\n"
+                "test_histogram_sum 13\n"
+                "test_histogram_count 4\n"),
+            std::string::npos);
+}
+
+}  // namespace tests
+}  // namespace phi
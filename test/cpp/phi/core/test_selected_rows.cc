@@ -181,5 +181,57 @@ TEST(SelectedRows, MultiThreadAutoIndex) {
   t3.join();
   t4.join();
 }
+
+TEST(SelectedRows, SyncIndex) {
+  phi::CPUPlace cpu;
+  // the last index of a duplicate row wins
+  SelectedRows table({7, 3, 7}, 10);
+  table.mutable_value()->Resize(common::make_ddim({5, 2}));
+  table.mutable_value()->mutable_data<float>(cpu);
+  table.SyncIndex();
+  ASSERT_EQ(table.GetIndexFromId(7), 2);
+  ASSERT_EQ(table.GetIndexFromId(3), 1);
+  ASSERT_EQ(table.GetIndexFromId(5), -1);
+
+  table.set_rows({7, 3});
+  table.SyncIndex();
+  ASSERT_EQ(table.AutoGrownIndex(5, true), 2);
+  ASSERT_EQ(table.AutoGrownIndex(7, false), 0);
+  ASSERT_EQ(table.rows().size(), 3UL);
+}
+
+TEST(SelectedRows, AutoGrownIndexGrowsTheMap) {
+  phi::CPUPlace cpu;
+  // the map starts small and is replaced several times on the way to the
+  // rows of the value
+  int64_t row_numel = 1000;
+  SelectedRows table(std::vector<int64_t>(), row_numel);
+  table.mutable_value()->Resize(common::make_ddim({row_numel, 2}));
+  table.mutable_value()->mutable_data<float>(cpu);
+  table.SyncIndex();
+  for (int64_t i = 0; i < row_numel; ++i) {
+    ASSERT_EQ(table.AutoGrownIndex(i * 7 + 3, true), i);
+  }
+  for (int64_t i = 0; i < row_numel; ++i) {
+    ASSERT_EQ(table.GetIndexFromId(i * 7 + 3), i);
+  }
+  ASSERT_EQ(table.GetIndexFromId(1), -1);
+  ASSERT_THROW(table.AutoGrownIndex(1, true), common::enforce::EnforceNotMet);
+}
+
+TEST(RowIndexMap, FindAndInsert) {
+  RowIndexMap map(100);
+  for (int64_t i = 0; i < 100; ++i) {
+    map.Insert(i * 1024 - 50, i);
+  }
+  ASSERT_EQ(map.size(), 100UL);
+  for (int64_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(map.Find(i * 1024 - 50), i);
+  }
+  ASSERT_EQ(map.Find(1), -1);
+  map.Insert(-50, 7);
+  ASSERT_EQ(map.Find(-50), 7);
+  ASSERT_EQ(map.size(), 100UL);
+}
 }  // namespace tests
 }  // namespace phi
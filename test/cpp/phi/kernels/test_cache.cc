@@ -15,7 +15,10 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <functional>
+#include <string>
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
@@ -66,3 +69,55 @@ TEST(AlgosCache, AlgosCache) {
   EXPECT_EQ(autotune_cache.CacheMisses(), 2);
   EXPECT_LT(std::abs(cache_hit_rate - autotune_cache.CacheHitRate()), 1e-5);
 }
+
+TEST(AlgosCache, SaveAndLoad) {
+  auto& autotune_cache = phi::autotune::AutoTuneCache::Instance();
+  auto& transpose_cache =
+      autotune_cache.Get(phi::autotune::AlgorithmType::kTranspose);
+  auto& matmul_cache = autotune_cache.GetMatmul();
+  auto& conv_cache =
+      autotune_cache.GetConv(phi::autotune::AlgorithmType::kConvBackwardData);
+  autotune_cache.Clean();
+  matmul_cache.Clean();
+
+  phi::DataType dtype = phi::CppTypeToDataType<float>::Type();
+  size_t transpose_key =
+      phi::autotune::TransposeKey({8, 64, 32}, {0, 2, 1}, dtype);
+  phi::autotune::ConvCacheKey conv_key(
+      {4, 3, 32, 32}, {16, 3, 3, 3}, {1, 1}, {2, 2}, {1, 1}, dtype, 1, 0);
+  transpose_cache.Set(transpose_key, 3);
+  matmul_cache.Set(12345, 7);
+  conv_cache.Set(conv_key, phi::autotune::ConvAutoTuneResult(2, 1024, true));
+
+  const std::string path = "autotune_cache_test_file";
+  autotune_cache.Save(path);
+  autotune_cache.Clean();
+  matmul_cache.Clean();
+  EXPECT_FALSE(transpose_cache.Find(transpose_key));
+
+  // the algorithm already cached is kept
+  matmul_cache.Set(12345, 9);
+  ASSERT_TRUE(autotune_cache.Load(path));
+  EXPECT_TRUE(transpose_cache.Find(transpose_key));
+  EXPECT_EQ(transpose_cache.Get(transpose_key), 3);
+  EXPECT_EQ(matmul_cache.Get(12345), 9);
+  ASSERT_TRUE(conv_cache.Find(conv_key));
+  auto result = conv_cache.Get(conv_key);
+  EXPECT_EQ(result.algo, 2);
+  EXPECT_EQ(result.workspace_size, 1024UL);
+  EXPECT_TRUE(result.exhaustive_search);
+
+  // a file saved on another device is skipped
+  {
+    std::ofstream os(path, std::ios::trunc);
+    os << "paddle_autotune_cache 1 another_device\n";
+    os << "matmul 54321 1\n";
+  }
+  EXPECT_FALSE(autotune_cache.Load(path));
+  EXPECT_FALSE(matmul_cache.Find(54321));
+  EXPECT_FALSE(autotune_cache.Load(path + ".missing"));
+
+  std::remove(path.c_str());
+  autotune_cache.Clean();
+  matmul_cache.Clean();
+}
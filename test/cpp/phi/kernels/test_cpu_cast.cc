@@ -0,0 +1,114 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/kernels/funcs/cpu_batch_transpose.h"
+#include "paddle/phi/kernels/funcs/cpu_cast.h"
+
+namespace phi {
+namespace tests {
+
+// an odd size, so the casts have a tail in each block and in the last one
+constexpr int64_t kNumel = 3 * funcs::kCPUCastBlockSize + 1003;
+
+std::vector<float> RandomFloats() {
+  std::mt19937 gen(2024);
+  std::normal_distribution<float> dist(0.f, 100.f);
+  std::vector<float> data(kNumel);
+  for (auto& v : data) {
+    v = dist(gen);
+  }
+  data[5] = INFINITY;
+  data[6] = -INFINITY;
+  return data;
+}
+
+template <typename InT, typename OutT>
+void ExpectSameAsStaticCast(const std::vector<InT>& in) {
+  std::vector<OutT> out(in.size());
+  funcs::CPUCast(in.data(), static_cast<int64_t>(in.size()), out.data());
+  for (size_t i = 0; i < in.size(); ++i) {
+    OutT expected = static_cast<OutT>(in[i]);
+    ASSERT_EQ(0, std::memcmp(&expected, &out[i], sizeof(OutT))) << i;
+  }
+}
+
+TEST(CPUCast, bfloat16) {
+  auto data = RandomFloats();
+  ExpectSameAsStaticCast<float, dtype::bfloat16>(data);
+  std::vector<dtype::bfloat16> half(data.begin(), data.end());
+  ExpectSameAsStaticCast<dtype::bfloat16, float>(half);
+}
+
+TEST(CPUCast, float16) {
+  auto data = RandomFloats();
+  std::vector<dtype::float16> half(data.size());
+  funcs::CPUCast(data.data(), kNumel, half.data());
+  for (int64_t i = 0; i < kNumel; ++i) {
+    // float16 is rounded to the nearest, which the software conversion
+    // does not always do
+    float expected = static_cast<float>(static_cast<dtype::float16>(data[i]));
+    if (std::isinf(expected)) {
+      EXPECT_EQ(expected, static_cast<float>(half[i])) << i;
+      continue;
+    }
+    EXPECT_NEAR(expected,
+                static_cast<float>(half[i]),
+                std::fabs(expected) * 1e-3f + 1e-7f)
+        << i;
+  }
+  ExpectSameAsStaticCast<dtype::float16, float>(half);
+}
+
+TEST(CPUCast, int64_int32) {
+  std::mt19937_64 gen(2024);
+  std::vector<int64_t> data(kNumel);
+  for (auto& v : data) {
+    v = static_cast<int64_t>(gen());
+  }
+  ExpectSameAsStaticCast<int64_t, int32_t>(data);
+  std::vector<int32_t> narrow(kNumel);
+  for (int64_t i = 0; i < kNumel; ++i) {
+    narrow[i] = static_cast<int32_t>(data[i]);
+  }
+  ExpectSameAsStaticCast<int32_t, int64_t>(narrow);
+}
+
+TEST(CPUBatchTranspose, NCHW_NHWC) {
+  const int64_t n = 2, c = 35, hw = 70;
+  std::vector<float> nchw(n * c * hw);
+  for (size_t i = 0; i < nchw.size(); ++i) {
+    nchw[i] = static_cast<float>(i);
+  }
+  std::vector<float> nhwc(nchw.size());
+  funcs::CPUBatchTranspose(nchw.data(), n, c, hw, nhwc.data());
+  for (int64_t b = 0; b < n; ++b) {
+    for (int64_t i = 0; i < c; ++i) {
+      for (int64_t j = 0; j < hw; ++j) {
+        ASSERT_EQ(nchw[(b * c + i) * hw + j], nhwc[(b * hw + j) * c + i]);
+      }
+    }
+  }
+  std::vector<float> back(nchw.size());
+  funcs::CPUBatchTranspose(nhwc.data(), n, hw, c, back.data());
+  EXPECT_EQ(nchw, back);
+}
+
+}  // namespace tests
+}  // namespace phi
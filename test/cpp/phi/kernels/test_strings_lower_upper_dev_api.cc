@@ -132,5 +132,41 @@ TEST(DEV_API, strings_cast_convert_utf8) {
   ASSERT_EQ(dense_upper_out.data()[0].data(), expected_results[1]);
 }
 
+TEST(DEV_API, strings_cast_convert_utf8_ascii) {
+  // 1. create tensor, the lengths cover the words and the tails
+  const int num = 20;
+  const DDim dims({1, num});
+  StringTensorMeta meta(dims);
+  phi::DeviceContextPool& pool = phi::DeviceContextPool::Instance();
+  auto* dev_ctx = pool.Get(phi::CPUPlace());
+
+  const auto string_allocator =
+      std::make_unique<paddle::experimental::DefaultAllocator>(phi::CPUPlace());
+  const auto alloc = string_allocator.get();
+  StringTensor dense_x(alloc, meta);
+
+  std::string ascii_str = "Hello, World! @[`{ AZaz09";
+  pstring* dense_x_data = dev_ctx->template Alloc<pstring>(&dense_x);
+  for (int i = 0; i < num; ++i) {
+    dense_x_data[i] = ascii_str.substr(0, i);
+  }
+
+  // 2. test API, utf8 encoding
+  auto dense_lower_out = phi::strings::StringLower(
+      *(static_cast<phi::CPUContext*>(dev_ctx)), dense_x, true);
+  auto dense_upper_out = phi::strings::StringUpper(
+      *(static_cast<phi::CPUContext*>(dev_ctx)), dense_x, true);
+
+  // 3. check results
+  for (int i = 0; i < num; ++i) {
+    std::string lower = ascii_str.substr(0, i);
+    std::string upper = lower;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    ASSERT_EQ(std::string(dense_lower_out.data()[i]), lower);
+    ASSERT_EQ(std::string(dense_upper_out.data()[i]), upper);
+  }
+}
+
 }  // namespace tests
 }  // namespace phi
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
@@ -217,6 +219,29 @@ struct IntegerDialect : pir::Dialect {
 IR_DECLARE_EXPLICIT_TEST_TYPE_ID(IntegerDialect)
 IR_DEFINE_EXPLICIT_TYPE_ID(IntegerDialect)
 
+TEST(type_test, concurrent_parametric_storage) {
+  // Types built by several threads at the same time are still uniqued.
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  constexpr int kNumThreads = 4;
+  constexpr int kNumTypes = 64;
+  std::vector<std::vector<pir::Type>> types(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([ctx, i, &types]() {
+      for (int j = 0; j < kNumTypes; ++j) {
+        std::vector<pir::Type> elements(j + 1, pir::Float32Type::get(ctx));
+        types[i].push_back(pir::VectorType::get(ctx, elements));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 1; i < kNumThreads; ++i) {
+    EXPECT_EQ(types[i], types[0]);
+  }
+}
+
 TEST(type_test, custom_type_dialect) {
   pir::IrContext *ctx = pir::IrContext::Instance();
   ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
@@ -0,0 +1,149 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/drr/include/drr_pass_group.h"
+#include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
+#include "paddle/fluid/pir/transforms/general/dead_code_elimination_pass.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_manager.h"
+
+// relu(relu(x)) -> relu(x)
+class ReluReluPattern : public paddle::drr::DrrPatternBase {
+ public:
+  std::string name() const override { return "ReluReluPattern"; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &relu_1 = src.Op("pd_op.relu");
+    const auto &relu_2 = src.Op("pd_op.relu");
+    src.Tensor("out") = relu_2(relu_1(src.Tensor("x")));
+
+    paddle::drr::ResultPattern res = src.ResultPattern();
+    res.Tensor("out") = res.Op("pd_op.relu")(res.Tensor("x"));
+  }
+};
+
+// softmax(softmax(x)) -> softmax(x)
+class SoftmaxSoftmaxPattern : public paddle::drr::DrrPatternBase {
+ public:
+  std::string name() const override { return "SoftmaxSoftmaxPattern"; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &softmax_1 =
+        src.Op("pd_op.softmax", {{"axis", src.Attr("axis_1")}});
+    const auto &softmax_2 =
+        src.Op("pd_op.softmax", {{"axis", src.Attr("axis_2")}});
+    src.Tensor("out") = softmax_2(softmax_1(src.Tensor("x")));
+
+    paddle::drr::ResultPattern res = src.ResultPattern();
+    res.Tensor("out") = res.Op("pd_op.softmax", {{"axis", src.Attr("axis_1")}})(
+        res.Tensor("x"));
+  }
+};
+
+// relu(softmax(x)) -> softmax(x), which matches the ops of both above
+class ReluSoftmaxPattern : public paddle::drr::DrrPatternBase {
+ public:
+  std::string name() const override { return "ReluSoftmaxPattern"; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern src = ctx->SourcePattern();
+    const auto &softmax = src.Op("pd_op.softmax", {{"axis", src.Attr("axis")}});
+    const auto &relu = src.Op("pd_op.relu");
+    src.Tensor("out") = relu(softmax(src.Tensor("x")));
+
+    paddle::drr::ResultPattern res = src.ResultPattern();
+    res.Tensor("out") =
+        res.Op("pd_op.softmax", {{"axis", src.Attr("axis")}})(res.Tensor("x"));
+  }
+};
+
+template <typename PatternT>
+class DrrTestPass : public pir::PatternRewritePass {
+ public:
+  explicit DrrTestPass(const std::string &name)
+      : pir::PatternRewritePass(name, 1) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add(paddle::drr::Create<PatternT>(context));
+    return ps;
+  }
+};
+
+std::vector<std::unique_ptr<pir::Pass>> CreateTestPasses() {
+  std::vector<std::unique_ptr<pir::Pass>> passes;
+  passes.push_back(
+      std::make_unique<DrrTestPass<ReluReluPattern>>("relu_relu_pass"));
+  passes.push_back(std::make_unique<DrrTestPass<SoftmaxSoftmaxPattern>>(
+      "softmax_softmax_pass"));
+  passes.push_back(
+      std::make_unique<DrrTestPass<ReluSoftmaxPattern>>("relu_softmax_pass"));
+  passes.push_back(pir::CreateDeadCodeEliminationPass());
+  return passes;
+}
+
+void BuildProgram(pir::Builder &builder) {  // NOLINT
+  paddle::dialect::FullOp full =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{4, 16},
+                                             1.0,
+                                             phi::DataType::FLOAT32,
+                                             phi::CPUPlace());
+  paddle::dialect::ReluOp relu_1 =
+      builder.Build<paddle::dialect::ReluOp>(full.out());
+  paddle::dialect::ReluOp relu_2 =
+      builder.Build<paddle::dialect::ReluOp>(relu_1.out());
+  paddle::dialect::SoftmaxOp softmax_1 =
+      builder.Build<paddle::dialect::SoftmaxOp>(full.out(), -1);
+  paddle::dialect::SoftmaxOp softmax_2 =
+      builder.Build<paddle::dialect::SoftmaxOp>(softmax_1.out(), -1);
+
+  builder.Build<paddle::dialect::FetchOp>(relu_2.out(), "out1", 0);
+  builder.Build<paddle::dialect::FetchOp>(softmax_2.out(), "out2", 1);
+}
+
+TEST(DrrTest, group_drr_passes) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+
+  auto passes = paddle::drr::GroupDrrPasses(CreateTestPasses(), ctx);
+  // relu_relu_pass and softmax_softmax_pass share one traversal, while
+  // relu_softmax_pass matches their ops and the dce pass is not made of DRR
+  // patterns.
+  ASSERT_EQ(passes.size(), 3u);
+  EXPECT_EQ(passes[1]->name(), "relu_softmax_pass");
+  EXPECT_EQ(passes[2]->name(), "dead_code_elimination_pass");
+
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  BuildProgram(builder);
+  EXPECT_EQ(program.block()->size(), 7u);
+
+  pir::PassManager pm(ctx);
+  for (auto &pass : passes) {
+    pm.AddPass(std::move(pass));
+  }
+  CHECK_EQ(pm.Run(&program), true);
+  EXPECT_EQ(program.block()->size(), 5u);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/transforms/gpu/fusion_planner.h"
+#include "paddle/fluid/pir/transforms/passes.h"
+#include "paddle/pir/include/core/builtin_dialect.h"
+
+void BuildProgram(pir::Builder &builder) {  // NOLINT
+  paddle::dialect::FullOp full_input_op =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{512, 64},
+                                             1.5);
+  // linear 1
+  paddle::dialect::FullOp full_weight_op1 =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{64, 128},
+                                             1.5);
+  paddle::dialect::FullOp full_bias_op1 =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{128}, 1.0);
+  paddle::dialect::MatmulOp matmul_op1 =
+      builder.Build<paddle::dialect::MatmulOp>(full_input_op.out(),
+                                               full_weight_op1.out());
+  paddle::dialect::AddOp add_op1 = builder.Build<paddle::dialect::AddOp>(
+      matmul_op1.out(), full_bias_op1.out());
+  paddle::dialect::ReluOp relu_op =
+      builder.Build<paddle::dialect::ReluOp>(add_op1.out());
+  // linear 2
+  paddle::dialect::FullOp full_weight_op2 =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{128, 64},
+                                             1.5);
+  paddle::dialect::FullOp full_bias_op2 =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{64}, 1.0);
+  paddle::dialect::MatmulOp matmul_op2 =
+      builder.Build<paddle::dialect::MatmulOp>(relu_op.out(),
+                                               full_weight_op2.out());
+  paddle::dialect::AddOp add_op2 = builder.Build<paddle::dialect::AddOp>(
+      matmul_op2.out(), full_bias_op2.out());
+  paddle::dialect::GeluOp gelu_op =
+      builder.Build<paddle::dialect::GeluOp>(add_op2.out());
+
+  builder.Build<paddle::dialect::FetchOp>(gelu_op.out(), "out", 0);
+}
+
+TEST(FusionPlanner, PlannedOrder) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  BuildProgram(builder);
+
+  const size_t num_ops = program.block()->size();
+  const double original_cost = pir::EstimateFusionCost(&program);
+  // matmul_scale_fuse_pass matches nothing in the program.
+  const std::vector<std::string> pass_names{
+      "matmul_scale_fuse_pass", "fc_fuse_pass", "fused_gemm_epilogue_pass"};
+  pir::FusionPlanReport report =
+      pir::ApplyPlannedFusionPasses(&program, pass_names, 2);
+
+  EXPECT_DOUBLE_EQ(report.original_cost, original_cost);
+  EXPECT_LT(report.planned_cost, report.original_cost);
+  EXPECT_LE(report.planned_cost, report.fixed_order_cost);
+  EXPECT_DOUBLE_EQ(pir::EstimateFusionCost(&program), report.planned_cost);
+  EXPECT_LT(program.block()->size(), num_ops);
+
+  ASSERT_FALSE(report.steps.empty());
+  std::unordered_set<std::string> applied;
+  double saving = 0;
+  for (const auto &step : report.steps) {
+    EXPECT_NE(step.pass_name, "matmul_scale_fuse_pass");
+    EXPECT_TRUE(applied.insert(step.pass_name).second);
+    EXPECT_GT(step.estimated_saving, 0);
+    EXPECT_GT(step.num_removed_ops, 0);
+    saving += step.estimated_saving;
+  }
+  EXPECT_NEAR(saving, report.original_cost - report.planned_cost, 1e-6);
+}
+
+TEST(FusionPlanner, NothingToFuse) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  BuildProgram(builder);
+
+  const size_t num_ops = program.block()->size();
+  pir::FusionPlanReport report = pir::ApplyPlannedFusionPasses(
+      &program, {"matmul_scale_fuse_pass", "silu_fuse_pass"}, 2);
+
+  EXPECT_TRUE(report.steps.empty());
+  EXPECT_DOUBLE_EQ(report.planned_cost, report.original_cost);
+  EXPECT_DOUBLE_EQ(report.fixed_order_cost, report.original_cost);
+  EXPECT_EQ(program.block()->size(), num_ops);
+}
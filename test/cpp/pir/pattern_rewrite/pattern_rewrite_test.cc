@@ -429,6 +429,46 @@ TEST(pattern_rewrite, Patterns) {
   EXPECT_EQ(program.block()->size(), 17u);
 }
 
+TEST(pattern_rewrite, IncrementalGreedyRewrite) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  auto full_op =
+      builder.Build<paddle::dialect::FullOp>(std::vector<int64_t>{4, 3, 16, 16},
+                                             1.5,
+                                             phi::DataType::FLOAT32,
+                                             phi::CPUPlace());
+  auto transpose1_op = builder.Build<paddle::dialect::TransposeOp>(
+      full_op.out(), std::vector<int>{0, 2, 3, 1});
+  auto transpose2_op = builder.Build<paddle::dialect::TransposeOp>(
+      transpose1_op.out(), std::vector<int>{0, 3, 1, 2});
+  auto transpose3_op = builder.Build<paddle::dialect::TransposeOp>(
+      transpose2_op.out(), std::vector<int>{0, 2, 3, 1});
+  auto fetch_op =
+      builder.Build<paddle::dialect::FetchOp>(transpose3_op.out(), "out", 0);
+
+  pir::RewritePatternSet ps(ctx);
+  ps.Add<RedundantTransposeFusePattern>(ctx);
+  pir::FrozenRewritePatternSet patterns(std::move(ps));
+  pir::GreedyRewriteConfig config;
+  config.use_top_down_traversal = true;
+  config.incremental = true;
+
+  // The transposes built by the rewrites are visited from the worklist, so
+  // the driver converges without scanning the block again.
+  auto [converged, num_rewrites] =
+      pir::ApplyPatternsGreedily(program.module_op(), patterns, config);
+  EXPECT_TRUE(converged);
+  EXPECT_EQ(num_rewrites, 2);
+  auto *last_op = pir::GetDefiningOpForInput(fetch_op, 0);
+  EXPECT_TRUE(last_op->isa<paddle::dialect::TransposeOp>());
+  EXPECT_TRUE(
+      pir::GetDefiningOpForInput(last_op, 0)->isa<paddle::dialect::FullOp>());
+}
+
 void BuildConstantFoldingProgram(pir::Program *program,
                                  pir::IrContext *ctx,
                                  paddle::framework::Scope *scope) {
@@ -179,5 +179,62 @@ class TestToOutputWithCache(Dy2StTestBase):
         self.assertEqual(ret.numpy(), 5050)
 
 
+class TestInterpreterCacheEviction(Dy2StTestBase):
+    def setUp(self):
+        self.flag = 'FLAGS_dy2st_interpreter_cache_capacity'
+        self.capacity = paddle.get_flags(self.flag)[self.flag]
+        paddle.set_flags({self.flag: 1})
+
+    def tearDown(self):
+        paddle.set_flags({self.flag: self.capacity})
+
+    @test_legacy_and_pt_and_pir
+    def test_eviction(self):
+        # each shape retraces a program, which evicts the interpreters of
+        # the other one, and they are rebuilt when it is run again
+        net = paddle.jit.to_static(paddle.nn.Linear(4, 3))
+        for _ in range(3):
+            for batch_size in [2, 5]:
+                x = paddle.rand([batch_size, 4])
+                x.stop_gradient = False
+                out = net(x)
+                out.sum().backward()
+                np.testing.assert_allclose(
+                    out.numpy(),
+                    (x @ net.weight + net.bias).numpy(),
+                    rtol=1e-05,
+                )
+                np.testing.assert_allclose(
+                    x.grad.numpy(),
+                    np.tile(net.weight.numpy().sum(axis=1), (batch_size, 1)),
+                    rtol=1e-05,
+                )
+
+    @test_legacy_and_pt_and_pir
+    def test_eviction_in_use(self):
+        # the interpreters of net1 are evicted by net2 between its forward
+        # and backward, which still run the ones they hold
+        net1 = paddle.jit.to_static(paddle.nn.Linear(4, 3))
+        net2 = paddle.jit.to_static(paddle.nn.Linear(4, 3))
+        for _ in range(3):
+            x1 = paddle.rand([2, 4])
+            x1.stop_gradient = False
+            out1 = net1(x1)
+            x2 = paddle.rand([5, 4])
+            x2.stop_gradient = False
+            net2(x2).sum().backward()
+            out1.sum().backward()
+            np.testing.assert_allclose(
+                out1.numpy(),
+                (x1 @ net1.weight + net1.bias).numpy(),
+                rtol=1e-05,
+            )
+            np.testing.assert_allclose(
+                x1.grad.numpy(),
+                np.tile(net1.weight.numpy().sum(axis=1), (2, 1)),
+                rtol=1e-05,
+            )
+
+
 if __name__ == '__main__':
     unittest.main()
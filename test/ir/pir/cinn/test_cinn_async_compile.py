@@ -0,0 +1,77 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import time
+import unittest
+
+import numpy as np
+
+os.environ['FLAGS_cinn_async_compile'] = '1'
+
+import utils
+
+import paddle
+from paddle import nn
+
+
+class Net(nn.Layer):
+    def forward(self, x):
+        y = paddle.exp(x) * 2.0 + x
+        return y / y.sum(axis=-1, keepdim=True)
+
+
+def get_expected(x):
+    y = np.exp(x) * 2.0 + x
+    return y / y.sum(axis=-1, keepdims=True)
+
+
+class TestCinnAsyncCompile(unittest.TestCase):
+    def setUp(self):
+        self.x = np.random.RandomState(2024).random_sample([16, 128])
+        self.x = self.x.astype("float32")
+
+    def test_fallback_until_compiled(self):
+        net = utils.apply_to_static(Net(), use_cinn=True)
+        net.eval()
+        x = paddle.to_tensor(self.x)
+        # the first runs may go without CINN while the kernels compile, the
+        # results are the same either way
+        out = net(x)
+        np.testing.assert_allclose(
+            out.numpy(), get_expected(self.x), atol=1e-6, rtol=1e-5
+        )
+
+        partial_program = net.forward.program_cache.last()[1][1]
+        program = partial_program.infer_program.forward_program
+        self.assertGreater(
+            utils.get_jit_kernel_number(program.global_block()), 0
+        )
+        deadline = time.time() + 300
+        while not paddle.base.libpaddle.pir.is_cinn_compiled(program):
+            self.assertLess(time.time(), deadline)
+            time.sleep(0.1)
+
+        # once compiled, the CINN program runs from then on
+        out = net(x)
+        np.testing.assert_allclose(
+            out.numpy(), get_expected(self.x), atol=1e-6, rtol=1e-5
+        )
+        _, program_id = partial_program._program_to_run()
+        self.assertEqual(program_id, partial_program.program_id)
+        self.assertIn(False, partial_program._cinn_compiled_modes)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,122 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+import numpy as np
+
+# set in the child processes, which compile and run the net
+OUTPUT_ENV = "CINN_DISK_CACHE_TEST_OUTPUT"
+
+
+def get_input():
+    return np.random.RandomState(2024).random_sample([16, 128]).astype(
+        "float32"
+    )
+
+
+def get_expected(x):
+    y = np.exp(x) * 2.0 + x
+    return y / y.sum(axis=-1, keepdims=True)
+
+
+def run_child(output_path):
+    import utils
+
+    import paddle
+    from paddle import nn
+
+    class Net(nn.Layer):
+        def forward(self, x):
+            y = paddle.exp(x) * 2.0 + x
+            return y / y.sum(axis=-1, keepdim=True)
+
+    net = utils.apply_to_static(Net(), use_cinn=True)
+    net.eval()
+    out = net(paddle.to_tensor(get_input()))
+    np.save(output_path, out.numpy())
+
+
+class TestCompilationDiskCache(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.cache_dir = os.path.join(self.temp_dir.name, "cache")
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def run_process(self):
+        output_path = os.path.join(self.temp_dir.name, "out.npy")
+        env = dict(os.environ)
+        env[OUTPUT_ENV] = output_path
+        env["FLAGS_cinn_compilation_cache_dir"] = self.cache_dir
+        subprocess.run(
+            [sys.executable, os.path.abspath(__file__)],
+            env=env,
+            cwd=os.path.dirname(os.path.abspath(__file__)),
+            check=True,
+        )
+        out = np.load(output_path)
+        os.remove(output_path)
+        np.testing.assert_allclose(
+            out, get_expected(get_input()), atol=1e-6, rtol=1e-5
+        )
+        return out
+
+    def entries(self):
+        # the size and the modification time of every entry
+        entries = {}
+        for name in os.listdir(self.cache_dir):
+            if name.endswith(".bin"):
+                stat = os.stat(os.path.join(self.cache_dir, name))
+                entries[name] = (stat.st_size, stat.st_mtime_ns)
+        return entries
+
+    def test_save_and_load(self):
+        compiled_out = self.run_process()
+        saved = self.entries()
+        self.assertGreater(len(saved), 0)
+
+        # a new process loads the entries instead of compiling and saving
+        # them again
+        loaded_out = self.run_process()
+        self.assertEqual(self.entries(), saved)
+        np.testing.assert_array_equal(loaded_out, compiled_out)
+
+    def test_broken_entry(self):
+        self.run_process()
+        saved = self.entries()
+        for name, (size, _) in saved.items():
+            with open(os.path.join(self.cache_dir, name), "r+b") as f:
+                f.truncate(size // 2)
+
+        # the truncated entries are compiled and saved again in full
+        self.run_process()
+        rewritten = self.entries()
+        self.assertEqual(rewritten.keys(), saved.keys())
+        for name, (size, _) in saved.items():
+            self.assertEqual(rewritten[name][0], size)
+        self.run_process()
+        self.assertEqual(self.entries(), rewritten)
+
+
+if __name__ == "__main__":
+    if os.getenv(OUTPUT_ENV):
+        run_child(os.environ[OUTPUT_ENV])
+    else:
+        unittest.main()
@@ -48,6 +48,28 @@ class TestChecker(unittest.TestCase):
         checker.check_result()
         checker.check_speed()
 
+    def test_check_group_speed(self):
+        orig_program = self.create_program(enable_prim=False)
+        prim_program = self.create_program(enable_prim=True)
+        checker = paddle.base.libpaddle.test.SubGraphChecker(
+            orig_program, prim_program
+        )
+        speeds = checker.check_group_speed()
+        self.assertGreater(len(speeds), 0)
+        for speed in speeds:
+            self.assertEqual(len(speed.fingerprint), 16)
+            self.assertGreater(len(speed.op_names), 0)
+
+        # the groups can never be slower by an infinite tolerance
+        SubGraphChecker = paddle.base.libpaddle.test.SubGraphChecker
+        deny_list = SubGraphChecker.deny_group_list(speeds, float("inf"))
+        self.assertEqual(deny_list, "")
+        # every group is denied by a negative one
+        deny_list = SubGraphChecker.deny_group_list(speeds, -1.0)
+        self.assertEqual(
+            deny_list, ";".join(speed.fingerprint for speed in speeds)
+        )
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,107 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+import numpy as np
+
+# set in the child processes, which compile and run the net
+OUTPUT_ENV = "CINN_TUNED_SCHEDULE_TEST_OUTPUT"
+
+
+def get_input():
+    return np.random.RandomState(2024).random_sample([16, 128]).astype(
+        "float32"
+    )
+
+
+def get_expected(x):
+    y = np.exp(x) * 2.0 + x
+    return y / y.sum(axis=-1, keepdims=True)
+
+
+def run_child(output_path):
+    import utils
+
+    import paddle
+    from paddle import nn
+
+    class Net(nn.Layer):
+        def forward(self, x):
+            y = paddle.exp(x) * 2.0 + x
+            return y / y.sum(axis=-1, keepdim=True)
+
+    net = utils.apply_to_static(Net(), use_cinn=True)
+    net.eval()
+    out = net(paddle.to_tensor(get_input()))
+    np.save(output_path, out.numpy())
+
+
+class TestTunedSchedule(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.record_file = os.path.join(self.temp_dir.name, "records.json")
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def run_process(self, record_schedules):
+        output_path = os.path.join(self.temp_dir.name, "out.npy")
+        env = dict(os.environ)
+        env[OUTPUT_ENV] = output_path
+        env["FLAGS_cinn_tuning_record_file"] = self.record_file
+        env["FLAGS_cinn_tuning_record_schedules"] = (
+            "1" if record_schedules else "0"
+        )
+        subprocess.run(
+            [sys.executable, os.path.abspath(__file__)],
+            env=env,
+            cwd=os.path.dirname(os.path.abspath(__file__)),
+            check=True,
+        )
+        out = np.load(output_path)
+        os.remove(output_path)
+        np.testing.assert_allclose(
+            out, get_expected(get_input()), atol=1e-6, rtol=1e-5
+        )
+        return out
+
+    def records(self):
+        with open(self.record_file) as f:
+            return [line for line in f.read().splitlines() if line]
+
+    def test_record_and_apply(self):
+        scheduled_out = self.run_process(record_schedules=True)
+        recorded = self.records()
+        self.assertGreater(len(recorded), 0)
+
+        # the groups with a record are not recorded again
+        self.run_process(record_schedules=True)
+        self.assertEqual(self.records(), recorded)
+
+        # the recorded schedules replace the group scheduler
+        tuned_out = self.run_process(record_schedules=False)
+        self.assertEqual(self.records(), recorded)
+        np.testing.assert_array_equal(tuned_out, scheduled_out)
+
+
+if __name__ == "__main__":
+    if os.getenv(OUTPUT_ENV):
+        run_child(os.environ[OUTPUT_ENV])
+    else:
+        unittest.main()
@@ -0,0 +1,95 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "auto_layout_pass targets cuDNN convs"
+)
+class TestAutoLayoutPass(PassTest):
+    r"""
+        x
+        |
+     conv2d
+        |
+      relu
+        |
+     conv2d   bias
+        \     /
+          add
+           |
+        pool2d
+
+    The whole chain runs in NHWC, with one transpose on each side.
+    """
+
+    def is_program_valid(self, program=None):
+        return True
+
+    def build_ir_program(self):
+        with paddle.pir_utils.IrGuard():
+            main_prog = paddle.static.Program()
+            start_prog = paddle.static.Program()
+            with paddle.pir.core.program_guard(main_prog, start_prog):
+                x = paddle.static.data(
+                    name='x', shape=[2, 8, 16, 16], dtype='float16'
+                )
+                w1 = paddle.static.create_parameter(
+                    shape=[16, 8, 3, 3], dtype='float16'
+                )
+                w2 = paddle.static.create_parameter(
+                    shape=[16, 16, 3, 3], dtype='float16'
+                )
+                bias = paddle.static.create_parameter(
+                    shape=[1, 16, 1, 1], dtype='float16'
+                )
+                out = paddle.nn.functional.conv2d(x, w1, padding=1)
+                out = paddle.nn.functional.relu(out)
+                out = paddle.nn.functional.conv2d(out, w2, padding=1)
+                out = paddle.add(out, bias)
+                out = paddle.nn.functional.max_pool2d(out, kernel_size=2)
+                out = paddle.assign(out)
+                self.pass_list = ['auto_layout_pass']
+                self.feeds = {
+                    "x": np.random.random((2, 8, 16, 16)).astype("float16")
+                }
+                self.fetch_list = [out]
+                self.valid_op_map = {
+                    "pd_op.conv2d": 2,
+                    "pd_op.transpose": 3,
+                }
+                return [main_prog, start_prog]
+
+    def sample_program(self):
+        pir_program = self.build_ir_program()
+        yield pir_program, False
+
+    def test_check_output(self):
+        self.check_pass_correct(atol=1e-2, rtol=1e-2)
+
+    def setUp(self):
+        self.places.append(paddle.CUDAPlace(0))
+
+
+if __name__ == "__main__":
+    unittest.main()
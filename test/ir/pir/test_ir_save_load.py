@@ -12,6 +12,7 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import os
 import unittest
 
 import paddle
@@ -121,6 +122,77 @@ class TestA(unittest.TestCase):
                     recover_program.global_block().ops[i].name(),
                 )
 
+    def test_binary_save_load(self):
+        with paddle.pir_utils.IrGuard():
+            main_program = paddle.static.Program()
+            with paddle.static.program_guard(main_program):
+                input = paddle.full(
+                    shape=[1, 512, 64], fill_value=0.5, dtype='float32'
+                )
+                weight = paddle.full(
+                    shape=[64, 64], fill_value=0.5, dtype='float32'
+                )
+                input.stop_gradient = False
+                bias = paddle.full(shape=[64], fill_value=1.0, dtype='float32')
+                x = paddle.matmul(input, weight)
+                y = paddle.add(x, bias)
+
+            text_path = "test_save_program3.json"
+            binary_path = "test_save_program3.bin"
+            pir_version = 1
+            base.core.serialize_pir_program(
+                main_program, text_path, pir_version, True, False, True
+            )
+            base.core.serialize_pir_program(
+                main_program,
+                binary_path,
+                pir_version,
+                True,
+                False,
+                True,
+                binary=True,
+            )
+            self.assertLess(
+                os.path.getsize(binary_path), os.path.getsize(text_path)
+            )
+
+            # both files load into the same program
+            recover_programs = []
+            for file_path in [text_path, binary_path]:
+                recover_program = paddle.static.Program()
+                base.core.deserialize_pir_program(
+                    file_path, recover_program, pir_version
+                )
+                recover_programs.append(recover_program)
+            text_program, binary_program = recover_programs
+            self.assertEqual(str(binary_program), str(text_program))
+
+            main_ops = main_program.global_block().ops
+            binary_ops = binary_program.global_block().ops
+            self.assertEqual(len(main_ops), len(binary_ops))
+            for main_op, binary_op in zip(main_ops, binary_ops):
+                self.assertEqual(main_op.name(), binary_op.name())
+                self.assertEqual(main_op.num_results(), binary_op.num_results())
+                for i in range(main_op.num_results()):
+                    self.assertEqual(
+                        main_op.result(i).shape, binary_op.result(i).shape
+                    )
+                    self.assertEqual(
+                        main_op.result(i).dtype, binary_op.result(i).dtype
+                    )
+                    self.assertEqual(
+                        main_op.result(i).stop_gradient,
+                        binary_op.result(i).stop_gradient,
+                    )
+
+    def test_load_missing_file(self):
+        with paddle.pir_utils.IrGuard():
+            recover_program = paddle.static.Program()
+            with self.assertRaises(Exception):
+                base.core.deserialize_pir_program(
+                    "test_save_program_missing.json", recover_program, 1
+                )
+
 
 if __name__ == '__main__':
     unittest.main()
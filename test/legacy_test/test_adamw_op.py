@@ -1017,5 +1017,42 @@ class TestAdamWOpLayerwiseLR(TestAdamWOp):
         paddle.disable_static()
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "fused_adam is only implemented on GPU"
+)
+class TestAdamWOpFusedMultiTensor(unittest.TestCase):
+    def _run(self, use_fused, multi_precision):
+        paddle.disable_static()
+        paddle.set_flags({'FLAGS_optimizer_fused_multi_tensor': use_fused})
+        paddle.seed(10)
+        linears = [paddle.nn.Linear(13, 5) for _ in range(3)]
+        params = [p for linear in linears for p in linear.parameters()]
+        optimizer = paddle.optimizer.AdamW(
+            learning_rate=0.01,
+            parameters=params,
+            weight_decay=0.1,
+            apply_decay_param_fun=lambda name: 'b_' not in name,
+            multi_precision=multi_precision,
+        )
+        x = paddle.rand([2, 13], dtype="float32")
+        for step in range(4):
+            # the last linear has no grad in the odd steps, so its beta pows
+            # fall behind the ones of the other parameters
+            used = linears if step % 2 == 0 else linears[:-1]
+            loss = paddle.add_n([paddle.mean(linear(x)) for linear in used])
+            loss.backward()
+            optimizer.step()
+            optimizer.clear_grad(set_to_zero=False)
+        paddle.set_flags({'FLAGS_optimizer_fused_multi_tensor': True})
+        return [p.numpy() for p in params]
+
+    def test_main(self):
+        for multi_precision in [False, True]:
+            expected = self._run(False, multi_precision)
+            actual = self._run(True, multi_precision)
+            for e, a in zip(expected, actual):
+                np.testing.assert_allclose(a, e, rtol=1e-6, atol=1e-7)
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -512,6 +512,194 @@ class TestBlockMultiHeadAttnEncDec(unittest.TestCase):
         )
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or get_cuda_version() < 11040
+    or not is_sm_supported,
+    "core is not compiled with CUDA and cuda version need larger than or equal to 11.4"
+    "and device's compute capability must be 8.x or 90",
+)
+class TestBlockMultiHeadAttnVerify(unittest.TestCase):
+    # prefill, verify draft_len draft tokens per sequence, accept some of them
+    # by rolling seq_lens_decoder back, and decode one token after them
+    def setUp(self):
+        paddle.disable_static()
+        self.name = "TestBlockMultiHeadAttnVerify"
+        self.place = paddle.CUDAPlace(0)
+        self.batch_size = 2
+        self.num_head = 8
+        self.seq_len = 64
+        self.max_dec_len = 64
+        self.draft_len = 4
+        self.accept_len = 2
+        self.dim_head = 64
+        self.hid_dim = self.num_head * self.dim_head
+        self.blocksize = 64
+        self.block_num_per_seq = (
+            self.seq_len + self.max_dec_len + self.blocksize - 1
+        ) // self.blocksize
+        self.max_block_num = self.block_num_per_seq * self.batch_size
+        free_list = list(range(self.max_block_num - 1, -1, -1))
+        self.dtype = 'float16'
+        self.scale = 1.0 / np.sqrt(self.dim_head)
+        cache_shape = (
+            self.max_block_num,
+            self.num_head,
+            self.blocksize,
+            self.dim_head,
+        )
+        self.cache_k = paddle.zeros(shape=cache_shape, dtype=self.dtype)
+        self.cache_v = paddle.zeros(shape=cache_shape, dtype=self.dtype)
+        self.block_tables = paddle.zeros(
+            shape=(self.batch_size, self.block_num_per_seq), dtype="int32"
+        )
+        for i in range(self.batch_size):
+            for j in range(self.block_num_per_seq):
+                self.block_tables[i, j] = free_list.pop()
+
+    def random_qkv(self, seq_len):
+        shape = (self.batch_size, self.num_head, seq_len, self.dim_head)
+        q, k, v = (
+            paddle.to_tensor(
+                np.random.random(shape), place=self.place, dtype=self.dtype
+            )
+            for _ in range(3)
+        )
+        token_num = self.batch_size * seq_len
+        qkv = paddle.stack(
+            [
+                t.transpose([0, 2, 1, 3]).reshape([token_num, self.hid_dim])
+                for t in [q, k, v]
+            ],
+            axis=1,
+        ).reshape([token_num, -1])
+        return q, k, v, qkv
+
+    def run_step(self, qkv, encoder_lens, decoder_lens, this_time_len):
+        seq_lens_encoder = paddle.to_tensor(encoder_lens, "int32")
+        seq_lens_decoder = paddle.to_tensor(decoder_lens, "int32")
+        seq_lens_this_time = paddle.to_tensor(
+            [this_time_len] * self.batch_size, "int32"
+        )
+        (
+            padding_offset,
+            cum_offset,
+            cu_seqlens_q,
+            cu_seqlens_k,
+        ) = get_padding_offset(
+            self.batch_size, this_time_len, seq_lens_this_time
+        )
+        return block_multihead_attention(
+            qkv,
+            self.cache_k,
+            self.cache_v,
+            seq_lens_encoder,
+            seq_lens_decoder,
+            seq_lens_this_time,
+            padding_offset,
+            cum_offset,
+            cu_seqlens_q,
+            cu_seqlens_k,
+            self.block_tables,
+            None,  # pre_key_cache
+            None,  # pre_value_cache
+            None,  # cache_k_quant_scales
+            None,  # cache_v_quant_scales
+            None,  # cache_k_dequant_scales
+            None,  # cache_v_dequant_scales
+            None,  # qkv_out_scale
+            None,  # qkv_bias
+            None,  # out_shift
+            None,  # out_smooth
+            None,  # rotary_embs
+            None,  # attn_mask
+            None,  # tgt_mask
+            this_time_len,
+            self.blocksize,
+            False,  # use_neox_rotary_style
+        )[0]
+
+    def naive_cache(self, cache_len):
+        return block_cache_to_naive_cache(
+            self.cache_k,
+            self.cache_v,
+            self.batch_size,
+            self.block_tables,
+            cache_len,
+        )
+
+    def check_cache(self, k, v, start):
+        # the k and v of the new tokens are at start onwards
+        end = start + k.shape[2]
+        cache_k, cache_v = self.naive_cache(end)
+        np.testing.assert_allclose(
+            cache_k[:, :, start:end, :].numpy(), k.numpy(), rtol=1e-3
+        )
+        np.testing.assert_allclose(
+            cache_v[:, :, start:end, :].numpy(), v.numpy(), rtol=1e-3
+        )
+
+    def naive_decode(self, q, k, v, cache_len):
+        # the new tokens attend to the cache and causally to each other
+        cache_k, cache_v = self.naive_cache(cache_len)
+        new_len = q.shape[2]
+        mask = paddle.zeros(
+            [self.batch_size, 1, new_len, cache_len + new_len],
+            dtype=self.dtype,
+        )
+        mask[:, :, :, cache_len:] = (
+            paddle.tril(paddle.ones([new_len, new_len], dtype=self.dtype)) - 1
+        ) * 1e4
+        out = naive_attention_impl(
+            q, k, v, cache_k, cache_v, None, None, mask, self.scale
+        )
+        return out.transpose([0, 2, 1, 3]).reshape(
+            [self.batch_size * new_len, -1]
+        )
+
+    def test_all(self):
+        paddle.disable_static()
+        # prefill
+        _, k, v, qkv = self.random_qkv(self.seq_len)
+        self.run_step(
+            qkv,
+            [self.seq_len] * self.batch_size,
+            [0] * self.batch_size,
+            self.seq_len,
+        )
+        self.check_cache(k, v, 0)
+
+        # verify the draft tokens
+        q, k, v, qkv = self.random_qkv(self.draft_len)
+        out_ = self.naive_decode(q, k, v, self.seq_len)
+        out = self.run_step(
+            qkv,
+            [0] * self.batch_size,
+            [self.seq_len] * self.batch_size,
+            self.draft_len,
+        )
+        np.testing.assert_allclose(
+            out.numpy(), out_.numpy(), rtol=5e-02, atol=5e-02
+        )
+        self.check_cache(k, v, self.seq_len)
+
+        # roll back the rejected draft tokens, the next token takes the slot
+        # of the first one and does not attend to any of them
+        cache_len = self.seq_len + self.accept_len
+        q, k, v, qkv = self.random_qkv(1)
+        out_ = self.naive_decode(q, k, v, cache_len)
+        out = self.run_step(
+            qkv,
+            [0] * self.batch_size,
+            [cache_len] * self.batch_size,
+            1,
+        )
+        np.testing.assert_allclose(
+            out.numpy(), out_.numpy(), rtol=5e-02, atol=5e-02
+        )
+        self.check_cache(k, v, cache_len)
+
+
 @unittest.skipIf(
     not core.is_compiled_with_cuda()
     or get_cuda_version() < 11040
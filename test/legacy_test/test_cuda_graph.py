@@ -167,6 +167,28 @@ class TestCUDAGraphInDygraphMode(unittest.TestCase):
         y = paddle.cast(x, dtype='float16')
         graph.capture_end()
 
+    def test_dropout_replay(self):
+        if not can_use_cuda_graph():
+            return
+
+        x = paddle.ones([64, 64], dtype='float32')
+        graph = CUDAGraph()
+        graph.capture_begin()
+        y = paddle.nn.functional.dropout(x, p=0.5, training=True)
+        graph.capture_end()
+
+        # each replay reads a new philox offset, so the masks differ
+        masks = []
+        for _ in range(3):
+            graph.replay()
+            masks.append(y.numpy() != 0)
+        graph.reset()
+        self.assertFalse((masks[0] == masks[1]).all())
+        self.assertFalse((masks[1] == masks[2]).all())
+        # the kernels out of the graph do not reuse the offsets of a replay
+        z = paddle.nn.functional.dropout(x, p=0.5, training=True)
+        self.assertFalse(((z.numpy() != 0) == masks[2]).all())
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -46,6 +46,16 @@ class TestDLPack(unittest.TestCase):
         out = paddle.utils.dlpack.from_dlpack(dlpack)
         np.testing.assert_allclose(numpy_data, out.numpy(), rtol=1e-05)
 
+    def test_dlpack_protocol_no_copy(self):
+        paddle.disable_static()
+        x = paddle.to_tensor(np.arange(6).astype('float32').reshape([2, 3]))
+        self.assertEqual(x.__dlpack_device__(), (1, 0))
+        y = paddle.utils.dlpack.from_dlpack(x)
+        np.testing.assert_array_equal(x.numpy(), y.numpy())
+        # y shares the memory of x
+        x[0, 0] = 10.0
+        self.assertEqual(float(y[0, 0]), 10.0)
+
     def test_dlpack_static(self):
         paddle.enable_static()
         tensor = base.create_lod_tensor(
@@ -224,5 +224,72 @@ class TestEmbeddingDeterministic(unittest.TestCase):
         self.hidden_size = 1024
 
 
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda() or paddle.is_compiled_with_rocm(),
+    "core is not compiled with CUDA",
+)
+class TestSparseEmbeddingDeterministic(unittest.TestCase):
+    def setUp(self):
+        self.ids_shape = [32, 16]
+        self.vocab_size = 128
+        self.hidden_size = 1024
+
+    def sparse_embedding(self, ids, weight, out_grad):
+        # the rows and the value of the SelectedRows gradient
+        weight = clone_weight(weight)
+        with deterministic_guard(1):
+            out = paddle.nn.functional.embedding(ids, weight, sparse=True)
+            out.backward(out_grad.clone())
+        selected_rows = weight.grad.get_selected_rows()
+        return list(selected_rows.rows()), np.array(selected_rows.get_tensor())
+
+    def check_merged(self, ids_dtype, allow_pure_random):
+        ids, weight, out_grad = generate_input_data(
+            ids_shape=self.ids_shape,
+            vocab_size=self.vocab_size,
+            hidden_size=self.hidden_size,
+            weight_dtype=paddle.float32,
+            ids_dtype=ids_dtype,
+            allow_pure_random=allow_pure_random,
+        )
+        rows, value = self.sparse_embedding(ids, weight, out_grad)
+
+        # one row per unique id, in ascending order
+        ids_np = ids.numpy().reshape([-1])
+        out_grad_np = out_grad.numpy().reshape([-1, self.hidden_size])
+        expected_rows = np.unique(ids_np)
+        self.assertEqual(rows, expected_rows.tolist())
+        self.assertEqual(value.shape, (len(rows), self.hidden_size))
+        expected_value = np.stack(
+            [out_grad_np[ids_np == row].sum(axis=0) for row in expected_rows]
+        )
+        if allow_pure_random:
+            np.testing.assert_allclose(value, expected_value, rtol=1e-5)
+        else:
+            np.testing.assert_equal(value, expected_value)
+
+        # the sums do not depend on the scheduling of threads
+        for _ in range(3):
+            rows_again, value_again = self.sparse_embedding(
+                ids, weight, out_grad
+            )
+            self.assertEqual(rows_again, rows)
+            np.testing.assert_equal(value_again, value)
+
+    def test_main(self):
+        for ids_dtype, allow_pure_random in product(
+            [paddle.int64, paddle.int32], [False, True]
+        ):
+            self.check_merged(ids_dtype, allow_pure_random)
+
+    def test_empty_ids(self):
+        ids = paddle.zeros([0], dtype=paddle.int64)
+        weight = paddle.randn([self.vocab_size, self.hidden_size])
+        out_grad = paddle.zeros([0, self.hidden_size])
+        rows, value = self.sparse_embedding(ids, weight, out_grad)
+        self.assertEqual(rows, [])
+        self.assertEqual(value.shape, (0, self.hidden_size))
+
+
 if __name__ == "__main__":
     unittest.main()
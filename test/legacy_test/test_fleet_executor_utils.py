@@ -16,6 +16,8 @@ import unittest
 
 import paddle
 from paddle.distributed.fleet.fleet_executor_utils import FleetExecutorUtils
+from paddle.distributed.fleet.meta_optimizers.common import OP_ROLE_KEY, OpRole
+from paddle.framework import core
 
 paddle.enable_static()
 
@@ -43,6 +45,44 @@ class TestFleetExecutorUtils(unittest.TestCase):
             program_map
         )
 
+    def test_split_backward(self):
+        main_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program):
+            x = paddle.static.data(name='x', shape=[4, 8], dtype='float32')
+            x.stop_gradient = False
+            w = paddle.create_parameter(shape=[8, 8], dtype='float32')
+            loss = paddle.mean(paddle.matmul(x, w))
+            paddle.static.append_backward(loss)
+            # the grad of x is sent to the previous stage
+            main_program.global_block().append_op(
+                type="send_v2",
+                inputs={"X": [x.name + "@GRAD"]},
+                attrs={
+                    "ring_id": 0,
+                    "peer": 0,
+                    "use_calc_stream": True,
+                    OP_ROLE_KEY: int(OpRole.Backward),
+                },
+            )
+        fleet_executor_utils = FleetExecutorUtils(
+            dist_strategy={"pp_degree": 2}, rank=0, nrank=1, split_backward=True
+        )
+        op_list_map = fleet_executor_utils.split_program_to_op_list(
+            main_program
+        )
+        b_descs, w_descs = fleet_executor_utils.split_backward_op_list(
+            main_program, op_list_map["bwd"]
+        )
+        self.assertEqual(b_descs[-1].type(), "send_v2")
+        b_matmul = [d for d in b_descs if d.type() == "matmul_v2_grad"]
+        w_matmul = [d for d in w_descs if d.type() == "matmul_v2_grad"]
+        self.assertEqual(len(b_matmul), 1)
+        self.assertEqual(len(w_matmul), 1)
+        self.assertEqual(b_matmul[0].output("X@GRAD"), [x.name + "@GRAD"])
+        self.assertEqual(b_matmul[0].output("Y@GRAD"), [core.empty_var_name()])
+        self.assertEqual(w_matmul[0].output("X@GRAD"), [core.empty_var_name()])
+        self.assertEqual(w_matmul[0].output("Y@GRAD"), [w.name + "@GRAD"])
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,115 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn import FP8Linear
+from paddle.incubate.nn.functional import fp8_cast_transpose, fp8_gemm
+
+
+def is_fp8_supported():
+    if not core.is_compiled_with_cuda():
+        return False
+    cuda_version = [int(v) for v in paddle.version.cuda().split('.')[:2]]
+    return cuda_version >= [11, 8]
+
+
+def is_fp8_gemm_supported():
+    return (
+        is_fp8_supported()
+        and paddle.device.cuda.get_device_capability() >= (8, 9)
+    )
+
+
+@unittest.skipIf(not is_fp8_supported(), "fp8 requires CUDA 11.8 or higher")
+class TestFp8CastTranspose(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.seed(2024)
+
+    def check(self, shape, dtype, fp8_format):
+        x = paddle.randn(shape, dtype='float32').astype(dtype)
+        scale = paddle.to_tensor([2.0], dtype='float32')
+        out, out_t, amax = fp8_cast_transpose(x, scale, fp8_format)
+
+        cols = shape[-1]
+        self.assertEqual(out.dtype, paddle.uint8)
+        self.assertEqual(out.shape, shape)
+        self.assertEqual(out_t.shape, [cols, x.numel().item() // cols])
+        np.testing.assert_array_equal(
+            out_t.numpy(), out.numpy().reshape([-1, cols]).T
+        )
+        np.testing.assert_allclose(
+            amax.numpy(),
+            [np.abs(x.astype('float32').numpy()).max()],
+            rtol=1e-6,
+        )
+
+    def test_cast_transpose(self):
+        for dtype in ['float32', 'float16', 'bfloat16']:
+            for fp8_format in ['e4m3', 'e5m2']:
+                self.check([2, 37, 70], dtype, fp8_format)
+                self.check([64, 128], dtype, fp8_format)
+
+
+@unittest.skipIf(
+    not is_fp8_gemm_supported(),
+    "fp8 gemm requires CUDA 11.8 and compute capability 8.9 or higher",
+)
+class TestFp8Gemm(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.seed(2024)
+
+    def test_gemm(self):
+        x = paddle.randn([64, 128], dtype='float32')
+        w = paddle.randn([128, 256], dtype='float32')
+        bias = paddle.randn([256], dtype='float32')
+        scale = paddle.ones([1], dtype='float32')
+        x_fp8, _, _ = fp8_cast_transpose(x, scale)
+        _, w_t_fp8, _ = fp8_cast_transpose(w, scale)
+        out = fp8_gemm(x_fp8, w_t_fp8, scale, scale, bias, out_dtype='float32')
+        expected = paddle.matmul(x, w) + bias
+        # e4m3 keeps 3 bits of mantissa, so compare relative to the output.
+        error = (out - expected).abs().max() / expected.abs().max()
+        self.assertLess(error.item(), 0.05)
+
+    def test_linear(self):
+        paddle.set_default_dtype('bfloat16')
+        try:
+            linear = FP8Linear(128, 256)
+        finally:
+            paddle.set_default_dtype('float32')
+        x = paddle.randn([4, 16, 128], dtype='float32').astype('bfloat16')
+        x.stop_gradient = False
+        for _ in range(3):
+            out = linear(x)
+            out.sum().backward()
+        expected = paddle.nn.functional.linear(
+            x.astype('float32'),
+            linear.weight.astype('float32'),
+            linear.bias.astype('float32'),
+        )
+        error = (out.astype('float32') - expected).abs().max()
+        self.assertLess(error.item() / expected.abs().max().item(), 0.05)
+        self.assertEqual(x.grad.shape, x.shape)
+        self.assertEqual(linear.weight.grad.shape, linear.weight.shape)
+
+
+if __name__ == '__main__':
+    unittest.main()
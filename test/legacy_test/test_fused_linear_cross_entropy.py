@@ -0,0 +1,77 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.incubate.nn.functional import fused_linear_cross_entropy
+
+
+class TestFusedLinearCrossEntropy(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        paddle.seed(2024)
+        self.shape = [2, 6, 32]
+        self.vocab_size = 100
+        self.chunk_size = 32
+        self.ignore_index = -100
+
+    def get_inputs(self):
+        x = paddle.randn(self.shape, dtype='float32')
+        weight = paddle.randn([self.shape[-1], self.vocab_size]) * 0.1
+        label = paddle.randint(0, self.vocab_size, self.shape[:-1])
+        label[0, 1] = self.ignore_index
+        x.stop_gradient = False
+        weight.stop_gradient = False
+        return x, weight, label
+
+    def test_forward_backward(self):
+        x, weight, label = self.get_inputs()
+        loss = fused_linear_cross_entropy(
+            x,
+            weight,
+            label,
+            ignore_index=self.ignore_index,
+            chunk_size=self.chunk_size,
+        )
+        loss.sum().backward()
+        fused = [loss.numpy(), x.grad.numpy(), weight.grad.numpy()]
+
+        x.clear_gradient()
+        weight.clear_gradient()
+        ref_loss = paddle.nn.functional.cross_entropy(
+            paddle.matmul(x, weight),
+            label.unsqueeze(-1),
+            ignore_index=self.ignore_index,
+            reduction='none',
+        )
+        ref_loss.sum().backward()
+        ref = [ref_loss.numpy(), x.grad.numpy(), weight.grad.numpy()]
+
+        self.assertEqual(loss.shape, ref_loss.shape)
+        for out, expected in zip(fused, ref):
+            np.testing.assert_allclose(out, expected, rtol=1e-5, atol=1e-5)
+        self.assertEqual(fused[0][0, 1, 0], 0)
+
+
+class TestFusedLinearCrossEntropyOneChunk(TestFusedLinearCrossEntropy):
+    def setUp(self):
+        super().setUp()
+        self.chunk_size = 8192
+
+
+if __name__ == '__main__':
+    unittest.main()
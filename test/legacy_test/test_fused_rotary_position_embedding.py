@@ -384,6 +384,52 @@ class TestFusedRotaryPositionEmbedding(unittest.TestCase):
         self.check_results(p_fw, f_fw_time_major)
         self.check_results(p_bw, f_bw_time_major)
 
+    def test_fused_rope_cu_seqlens(self):
+        paddle.disable_static()
+        tensor_q, tensor_k, tensor_v, tensor_sin, tensor_cos = self.get_inputs(
+            self.seed, True
+        )
+        # Sequences of different lengths packed without padding.
+        batch_size, seq_len = tensor_q.shape[0], tensor_q.shape[1]
+        seqlens = [seq_len - 3 * i for i in range(batch_size)]
+        cu_seqlens = paddle.to_tensor(
+            np.cumsum([0, *seqlens]).astype('int32')
+        )
+
+        def pack(tensor):
+            if tensor is None:
+                return None
+            return paddle.concat(
+                [tensor[i, :n] for i, n in enumerate(seqlens)], axis=0
+            )
+
+        out_packed = fused_rotary_position_embedding(
+            pack(tensor_q),
+            pack(tensor_k),
+            pack(tensor_v),
+            sin=tensor_sin,
+            cos=tensor_cos,
+            cu_seqlens=cu_seqlens,
+        )
+        for i, n in enumerate(seqlens):
+            out_seq = fused_rotary_position_embedding(
+                tensor_q[i : i + 1, :n],
+                tensor_k[i : i + 1, :n] if tensor_k is not None else None,
+                tensor_v[i : i + 1, :n] if tensor_v is not None else None,
+                sin=tensor_sin[:, :n],
+                cos=tensor_cos[:, :n],
+            )
+            start = sum(seqlens[:i])
+            for packed, expected in zip(out_packed, out_seq):
+                if expected is None:
+                    self.assertIsNone(packed)
+                    continue
+                np.testing.assert_allclose(
+                    packed[start : start + n].numpy(),
+                    expected.squeeze(0).numpy(),
+                    rtol=self.rtol,
+                )
+
     @test_with_pir_api
     def test_static(self):
         paddle.disable_static()
@@ -0,0 +1,143 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from op_test import OpTest
+
+
+def embedding_seqpool(table, ids, lod, pooltype, padding_idx):
+    out = np.zeros((len(lod), table.shape[1])).astype(table.dtype)
+    begin = 0
+    for i, seq_len in enumerate(lod):
+        rows = [
+            table[idx]
+            for idx in ids[begin : begin + seq_len, 0]
+            if padding_idx == -1 or idx != padding_idx
+        ]
+        begin += seq_len
+        if not rows:
+            continue
+        out[i] = np.sum(rows, axis=0)
+        if pooltype == "AVERAGE":
+            out[i] /= len(rows)
+        elif pooltype == "SQRT":
+            out[i] /= np.sqrt(len(rows))
+    return out
+
+
+class TestFusionEmbeddingSeqPoolConcatOp(OpTest):
+    def setUp(self):
+        self.w = 11
+        self.table_height = 20
+        self.lods = [[[2, 3, 5]], [[1, 5, 2]]]
+        self.shared_table = True
+        self.padding_idx = -1
+        self.set_conf()
+        self.set_pooltype()
+        self.op_type = 'fusion_embedding_seqpool_concat'
+        bs = len(self.lods[0][0])
+        num_tables = 1 if self.shared_table else len(self.lods)
+        tables = [
+            np.random.uniform(0.1, 1, [self.table_height, self.w]).astype(
+                'float32'
+            )
+            for _ in range(num_tables)
+        ]
+        ids_inputs = []
+        outs = []
+        for i, lod in enumerate(self.lods):
+            assert bs == len(lod[0]), 'All lod size should be equal'
+            ids = np.random.randint(
+                0, self.table_height, [sum(lod[0]), 1]
+            ).astype('int64')
+            table = tables[0] if self.shared_table else tables[i]
+            outs.append(
+                embedding_seqpool(
+                    table, ids, lod[0], self.pooltype, self.padding_idx
+                )
+            )
+            ids_inputs.append((f'ids_{i}', (ids, lod)))
+
+        self.inputs = {
+            'W': [(f'w_{i}', table) for i, table in enumerate(tables)],
+            'Ids': ids_inputs,
+        }
+        self.outputs = {'Out': np.concatenate(outs, axis=1)}
+        self.attrs = {
+            'pooltype': self.pooltype,
+            'padding_idx': self.padding_idx,
+        }
+
+    def set_pooltype(self):
+        self.pooltype = "SUM"
+
+    def set_conf(self):
+        pass
+
+    def test_check_output(self):
+        self.check_output()
+
+
+class TestFusionEmbeddingSeqPoolConcatOpCase1(
+    TestFusionEmbeddingSeqPoolConcatOp
+):
+    def set_conf(self):
+        self.lods = [[[1]], [[1]], [[1]]]
+
+
+class TestFusionEmbeddingSeqPoolConcatOpCase2(
+    TestFusionEmbeddingSeqPoolConcatOp
+):
+    def set_conf(self):
+        self.lods = [[[2, 13, 0, 4]], [[1, 1, 1, 1]], [[5, 3, 1, 9]]]
+        self.w = 16
+        self.shared_table = False
+
+
+class TestFusionEmbeddingSeqPoolConcatOpCase3(
+    TestFusionEmbeddingSeqPoolConcatOp
+):
+    def set_conf(self):
+        self.lods = [[[9, 10, 3]], [[4, 0, 6]]]
+        self.table_height = 4
+        self.padding_idx = 2
+
+
+# test avg pool and sqrt
+def create_test_avg_sqrt_class(parent):
+    class TestSeqPoolAvgCase(parent):
+        def set_pooltype(self):
+            self.pooltype = "AVERAGE"
+
+    class TestSeqPoolSqrtCase(parent):
+        def set_pooltype(self):
+            self.pooltype = "SQRT"
+
+    cls_name_avg = "{}_{}".format(parent.__name__, "avg")
+    cls_name_sqrt = "{}_{}".format(parent.__name__, "sqrt")
+    TestSeqPoolAvgCase.__name__ = cls_name_avg
+    TestSeqPoolSqrtCase.__name__ = cls_name_sqrt
+    globals()[cls_name_avg] = TestSeqPoolAvgCase
+    globals()[cls_name_sqrt] = TestSeqPoolSqrtCase
+
+
+create_test_avg_sqrt_class(TestFusionEmbeddingSeqPoolConcatOp)
+create_test_avg_sqrt_class(TestFusionEmbeddingSeqPoolConcatOpCase1)
+create_test_avg_sqrt_class(TestFusionEmbeddingSeqPoolConcatOpCase2)
+create_test_avg_sqrt_class(TestFusionEmbeddingSeqPoolConcatOpCase3)
+
+if __name__ == '__main__':
+    unittest.main()
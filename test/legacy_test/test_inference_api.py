@@ -250,5 +250,92 @@ class TestInferenceShareExternalDataAPI(unittest.TestCase):
         test_paddle_tensor_bool()
 
 
+def get_bucket_model(shape):
+    place = base.CPUPlace()
+    exe = base.Executor(place)
+
+    main_program = base.Program()
+    startup_program = base.Program()
+    with base.program_guard(main_program, startup_program):
+        data = paddle.static.data(name="data", shape=shape, dtype="float32")
+        out = paddle.scale(data, scale=2.0, bias=1.0)
+        padded_out = paddle.scale(data, scale=3.0)
+    exe.run(startup_program)
+    serialized_program = paddle.static.serialize_program(
+        data, [out, padded_out], program=main_program
+    )
+    serialized_params = paddle.static.serialize_persistables(
+        data, [out, padded_out], executor=exe, program=main_program
+    )
+    return serialized_program, serialized_params
+
+
+class TestInferenceShapeBuckets(unittest.TestCase):
+    def get_config(self, program, params):
+        config = Config()
+        config.set_model_buffer(program, len(program), params, len(params))
+        return config
+
+    def create_predictor(self, shape, axis, boundaries):
+        program, params = get_bucket_model(shape)
+        output_names = create_predictor(
+            self.get_config(program, params)
+        ).get_output_names()
+        config = self.get_config(program, params)
+        config.set_input_shape_buckets("data", axis, boundaries)
+        config.set_output_shape_bucket_axis(output_names[0], "data", axis)
+        self.assertTrue(config.shape_bucketing_enabled())
+        return create_predictor(config)
+
+    def run_predictor(self, predictor, in_data):
+        in_handle = predictor.get_input_handle("data")
+        in_handle.reshape(in_data.shape)
+        in_handle.copy_from_cpu(in_data)
+        predictor.run()
+        output_names = predictor.get_output_names()
+        outs = [
+            predictor.get_output_handle(name).copy_to_cpu()
+            for name in output_names
+        ]
+        # the input is restored after the run
+        np.testing.assert_array_equal(in_handle.copy_to_cpu(), in_data)
+        return outs
+
+    def test_batch_axis(self):
+        predictor = self.create_predictor([-1, 4], 0, [4, 8, 16])
+        for batch, bucket in [(1, 4), (3, 4), (4, 4), (5, 8), (9, 16)]:
+            in_data = np.random.random([batch, 4]).astype("float32")
+            out, padded_out = self.run_predictor(predictor, in_data)
+            np.testing.assert_allclose(out, in_data * 2.0 + 1.0, rtol=1e-6)
+            # the unmapped output keeps the padded rows, zeros in the input
+            self.assertEqual(list(padded_out.shape), [bucket, 4])
+            np.testing.assert_allclose(
+                padded_out[:batch], in_data * 3.0, rtol=1e-6
+            )
+            np.testing.assert_array_equal(padded_out[batch:], 0.0)
+
+    def test_larger_than_buckets(self):
+        predictor = self.create_predictor([-1, 4], 0, [4, 8])
+        in_data = np.random.random([11, 4]).astype("float32")
+        out, padded_out = self.run_predictor(predictor, in_data)
+        np.testing.assert_allclose(out, in_data * 2.0 + 1.0, rtol=1e-6)
+        self.assertEqual(list(padded_out.shape), [11, 4])
+
+    def test_inner_axis(self):
+        predictor = self.create_predictor([2, -1, 3], 1, [4, 8])
+        for size in [1, 3, 6]:
+            in_data = np.random.random([2, size, 3]).astype("float32")
+            out, _ = self.run_predictor(predictor, in_data)
+            np.testing.assert_allclose(out, in_data * 2.0 + 1.0, rtol=1e-6)
+
+    def test_wrong_output(self):
+        program, params = get_bucket_model([-1, 4])
+        config = self.get_config(program, params)
+        config.set_input_shape_buckets("data", 0, [4, 8])
+        config.set_output_shape_bucket_axis("not_an_output", "data", 0)
+        with self.assertRaises(ValueError):
+            create_predictor(config)
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,112 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn.functional import moe_grouped_gemm
+
+
+def is_grouped_gemm_supported():
+    return (
+        core.is_compiled_with_cuda()
+        and paddle.device.cuda.get_device_capability()[0] >= 8
+    )
+
+
+def ref_grouped_gemm(x, weight, counts, transpose_weight):
+    outs = []
+    begin = 0
+    for e, count in enumerate(counts):
+        if count > 0:
+            outs.append(
+                paddle.matmul(
+                    x[begin : begin + count],
+                    weight[e],
+                    transpose_y=transpose_weight,
+                )
+            )
+        begin += count
+    return paddle.concat(outs, axis=0)
+
+
+@unittest.skipIf(
+    not is_grouped_gemm_supported(),
+    "moe_grouped_gemm requires CUDA and compute capability 8.0 or higher",
+)
+class TestMoeGroupedGemm(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        np.random.seed(2024)
+        self.counts = [5, 0, 17, 1, 9]
+        self.k = 32
+        self.n = 48
+
+    def check(self, dtype, transpose_weight):
+        num_experts = len(self.counts)
+        tokens = sum(self.counts)
+        w_shape = (
+            [num_experts, self.n, self.k]
+            if transpose_weight
+            else [num_experts, self.k, self.n]
+        )
+        x_np = np.random.uniform(-1, 1, [tokens, self.k]).astype('float32')
+        w_np = np.random.uniform(-1, 1, w_shape).astype('float32')
+        dout_np = np.random.uniform(-1, 1, [tokens, self.n]).astype('float32')
+
+        x = paddle.to_tensor(x_np).astype(dtype)
+        w = paddle.to_tensor(w_np).astype(dtype)
+        x.stop_gradient = False
+        w.stop_gradient = False
+        expert_offsets = paddle.cumsum(
+            paddle.to_tensor(self.counts, dtype='int64')
+        )
+        out = moe_grouped_gemm(x, w, expert_offsets, transpose_weight)
+        out.backward(paddle.to_tensor(dout_np).astype(dtype))
+
+        x_ref = paddle.to_tensor(x_np)
+        w_ref = paddle.to_tensor(w_np)
+        x_ref.stop_gradient = False
+        w_ref.stop_gradient = False
+        out_ref = ref_grouped_gemm(x_ref, w_ref, self.counts, transpose_weight)
+        out_ref.backward(paddle.to_tensor(dout_np))
+
+        atol = 5e-2 if dtype == 'bfloat16' else 1e-2
+        for actual, expected in [
+            (out, out_ref),
+            (x.grad, x_ref.grad),
+            (w.grad, w_ref.grad),
+        ]:
+            np.testing.assert_allclose(
+                actual.astype('float32').numpy(),
+                expected.numpy(),
+                rtol=atol,
+                atol=atol,
+            )
+        # The expert without tokens gets a zero gradient.
+        np.testing.assert_array_equal(
+            w.grad[1].astype('float32').numpy(), np.zeros(w_shape[1:])
+        )
+
+    def test_grouped_gemm(self):
+        for dtype in ['float16', 'bfloat16']:
+            for transpose_weight in [False, True]:
+                self.check(dtype, transpose_weight)
+
+
+if __name__ == '__main__':
+    unittest.main()
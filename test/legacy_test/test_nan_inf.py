@@ -275,6 +275,94 @@ class TestNanInfCheckResult(TestNanInfBase):
             )
 
 
+@unittest.skipIf(
+    not paddle.base.core.is_compiled_with_cuda(),
+    "the deferred check only applies to the GPU tensors",
+)
+class TestNanInfDeferred(TestNanInfBase):
+    def test_deferred_num_nan_inf(self):
+        paddle.set_flags(
+            {
+                "FLAGS_check_nan_inf": 1,
+                "FLAGS_check_nan_inf_level": 0,
+                "FLAGS_check_nan_inf_deferred": 1,
+            }
+        )
+        paddle.device.set_device("gpu:0")
+        x_np, _ = self.generate_inputs([32, 32])
+        out_np = np.log(x_np)
+        x = paddle.to_tensor(x_np)
+        # the log does not raise, the nan/inf are checked once at the end
+        out = paddle.log(x)
+        with self.assertRaises(Exception) as context:
+            paddle.base.core.check_deferred_nan_inf()
+        err = str(context.exception)
+        self.assertIn("op=log", err)
+        self.assertIn(f"num_nan={np.sum(np.isnan(out_np))}", err)
+        self.assertIn(f"num_inf={np.sum(np.isinf(out_np))}", err)
+        # the counts are reset by the check
+        paddle.base.core.check_deferred_nan_inf()
+        paddle.set_flags(
+            {"FLAGS_check_nan_inf": 0, "FLAGS_check_nan_inf_deferred": 0}
+        )
+
+    def test_deferred_eager_backward(self):
+        paddle.device.set_device("gpu:0")
+        x_np, _ = self.generate_inputs([32, 32])
+        x = paddle.to_tensor(x_np, stop_gradient=False)
+        paddle.set_flags(
+            {
+                "FLAGS_check_nan_inf": 1,
+                "FLAGS_check_nan_inf_level": 0,
+                "FLAGS_check_nan_inf_deferred": 1,
+            }
+        )
+        try:
+            loss = paddle.log(x).sum()
+            # the step is checked at the end of the backward
+            with self.assertRaises(Exception) as context:
+                loss.backward()
+            self.assertIn("op=log", str(context.exception))
+            paddle.base.core.check_deferred_nan_inf()
+        finally:
+            paddle.set_flags(
+                {"FLAGS_check_nan_inf": 0, "FLAGS_check_nan_inf_deferred": 0}
+            )
+
+    def test_deferred_legacy_executor(self):
+        place = paddle.CUDAPlace(0)
+        x_np, _ = self.generate_inputs([32, 32])
+        paddle.enable_static()
+        try:
+            with paddle.pir_utils.OldIrGuard():
+                main_program = paddle.static.Program()
+                with paddle.static.program_guard(main_program):
+                    x = paddle.static.data("x", [32, 32], "float32")
+                    out = paddle.log(x)
+                scope = paddle.base.core.Scope()
+                scope.var(x.name).get_tensor().set(x_np, place)
+                core_place = paddle.base.core.Place()
+                core_place.set_place(place)
+                exe = paddle.base.core.Executor(core_place)
+                paddle.set_flags(
+                    {
+                        "FLAGS_check_nan_inf": 1,
+                        "FLAGS_check_nan_inf_level": 0,
+                        "FLAGS_check_nan_inf_deferred": 1,
+                    }
+                )
+                # the run is checked at its end
+                with self.assertRaises(Exception) as context:
+                    exe.run(main_program.desc, scope, 0, False, True, [])
+                self.assertIn(f"tensor={out.name}", str(context.exception))
+                paddle.base.core.check_deferred_nan_inf()
+        finally:
+            paddle.set_flags(
+                {"FLAGS_check_nan_inf": 0, "FLAGS_check_nan_inf_deferred": 0}
+            )
+            paddle.disable_static()
+
+
 class TestCheckNumericsAPI(TestNanInfBase):
     def test_eager(self):
         shape = [8, 8]
@@ -0,0 +1,68 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+SCRIPT = """
+import paddle
+x = paddle.randn([16, 16])
+for _ in range(100):
+    y = paddle.matmul(x, x)
+    y = paddle.nn.functional.relu(y)
+"""
+
+
+class TestOpStatsSampler(unittest.TestCase):
+    def run_script(self, sample_interval):
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            output_path = os.path.join(tmp_dir, 'op_stats.jsonl')
+            env = dict(os.environ)
+            env['FLAGS_op_stats_sample_interval'] = str(sample_interval)
+            env['FLAGS_op_stats_output_path'] = output_path
+            subprocess.check_call([sys.executable, '-c', SCRIPT], env=env)
+            if not os.path.exists(output_path):
+                return []
+            with open(output_path) as f:
+                return [json.loads(line) for line in f]
+
+    def test_sampled_stats(self):
+        # The statistics are flushed at exit.
+        records = self.run_script(10)
+        self.assertGreater(len(records), 0)
+        ops = {}
+        for record in records:
+            self.assertEqual(record['sample_interval'], 10)
+            for op in record['ops']:
+                ops.setdefault(op['name'], []).append(op)
+
+        # 1 in 10 of the 200 operators is sampled.
+        samples = sum(op['samples'] for stats in ops.values() for op in stats)
+        self.assertGreaterEqual(samples, 20)
+        for stats in ops.values():
+            for op in stats:
+                self.assertEqual(op['estimated_count'], op['samples'] * 10)
+                self.assertLessEqual(op['p50_us'], op['p99_us'])
+                self.assertLessEqual(op['p99_us'], op['max_us'])
+
+    def test_disabled(self):
+        self.assertEqual(self.run_script(0), [])
+
+
+if __name__ == '__main__':
+    unittest.main()
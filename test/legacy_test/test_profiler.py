@@ -15,7 +15,7 @@
 import unittest
 
 import paddle
-from paddle.utils.flops import flops
+from paddle.utils.flops import flops, memory_bytes
 
 
 class TestFLOPSAPI(unittest.TestCase):
@@ -170,6 +170,50 @@ class TestFLOPSAPI(unittest.TestCase):
         )
 
 
+class TestMemoryBytesAPI(unittest.TestCase):
+    def test_memory_bytes(self):
+        self.assertEqual(memory_bytes('relu', {'X': [[12, 12]]}, {}), 144 * 8)
+        self.assertEqual(
+            memory_bytes('relu', {'X': [[12, 12]]}, {}, {'X': ['FP16']}),
+            144 * 4,
+        )
+        self.assertEqual(memory_bytes('unknown', {'X': [[12, 12]]}, {}), 0)
+        self.assertEqual(
+            memory_bytes(
+                'elementwise_add',
+                {'X': [[12, 12, 12]], 'Y': [[12]]},
+                {},
+                {'X': ['BF16'], 'Y': ['BF16']},
+            ),
+            (12 * 12 * 12 * 2 + 12) * 2,
+        )
+        self.assertEqual(
+            memory_bytes(
+                'layer_norm',
+                {'Bias': [[128]], 'Scale': [[128]], 'X': [[32, 128]]},
+                {'epsilon': 0.01},
+            ),
+            (32 * 128 * 2 + 128 * 2) * 4,
+        )
+        self.assertEqual(
+            memory_bytes(
+                'matmul',
+                {'X': [[3, 12, 8]], 'Y': [[16, 8]]},
+                {'transpose_X': False, 'transpose_Y': True},
+            ),
+            (3 * 12 * 8 + 16 * 8 + 3 * 12 * 16) * 4,
+        )
+        self.assertEqual(
+            memory_bytes(
+                'matmul_v2',
+                {'X': [[8, 12]], 'Y': [[8, 16]]},
+                {'trans_x': True, 'trans_y': False},
+                {'X': ['FP16'], 'Y': ['FP16']},
+            ),
+            (8 * 12 + 8 * 16 + 12 * 16) * 2,
+        )
+
+
 if __name__ == '__main__':
     paddle.enable_static()
     unittest.main()
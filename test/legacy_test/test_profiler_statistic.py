@@ -1044,6 +1044,168 @@ class TestProfilerStatistic(unittest.TestCase):
                 )
             )
 
+    def test_statistic_roofline(self):
+        root_node = HostPythonNode(
+            'Root Node',
+            profiler.TracerEventType.UserDefined,
+            0,
+            float('inf'),
+            1000,
+            1001,
+        )
+        profilerstep_node = HostPythonNode(
+            'ProfileStep#1',
+            profiler.TracerEventType.ProfileStep,
+            0,
+            1000,
+            1000,
+            1001,
+        )
+        matmul_node = HostPythonNode(
+            'matmul_v2', profiler.TracerEventType.Operator, 100, 600, 1000, 1001
+        )
+        matmul_node.input_shapes = {'X': [[64, 128]], 'Y': [[128, 256]]}
+        matmul_node.dtypes = {'X': ['FP16'], 'Y': ['FP16']}
+        matmul_node.attributes = {'trans_x': False, 'trans_y': False}
+        matmul_launchkernel = HostPythonNode(
+            'cudalaunchkernel',
+            profiler.TracerEventType.CudaRuntime,
+            200,
+            300,
+            1000,
+            1001,
+        )
+        matmul_kernel = DevicePythonNode(
+            'matmul_kernel', profiler.TracerEventType.Kernel, 300, 800, 0, 0, 0
+        )
+        root_node.children_node.append(profilerstep_node)
+        profilerstep_node.children_node.append(matmul_node)
+        matmul_node.runtime_node.append(matmul_launchkernel)
+        matmul_launchkernel.device_node.append(matmul_kernel)
+        thread_tree = {'thread1001': root_node}
+        extra_info = {
+            'Process Cpu Utilization': '1.02',
+            'System Cpu Utilization': '0.68',
+        }
+        statistic_data = profiler.profiler_statistic.StatisticData(
+            thread_tree, extra_info
+        )
+        matmul_item = statistic_data.event_summary.items['matmul_v2']
+        self.assertEqual(matmul_item.flops, 2 * 64 * 128 * 256)
+        self.assertEqual(
+            matmul_item.bytes, (64 * 128 + 128 * 256 + 64 * 256) * 2
+        )
+        self.assertEqual(matmul_item.general_gpu_time, 500)
+
+        # 8.39 TFLOPS achieved, compute bound at 100 TFLOPS
+        table = profiler.profiler_statistic._build_table(
+            statistic_data,
+            views=[profiler.SummaryView.RooflineView],
+            peak_tflops=100,
+            peak_bandwidth=10000,
+        )
+        self.assertIn('Roofline Summary', table)
+        self.assertIn('Compute', table)
+        self.assertIn('8.39 *', table)
+        # memory bound at 36.57 TFLOPS, not flagged
+        table = profiler.profiler_statistic._build_table(
+            statistic_data,
+            views=[profiler.SummaryView.RooflineView],
+            peak_tflops=100,
+            peak_bandwidth=1000,
+        )
+        self.assertIn('Memory', table)
+        self.assertIn('22.94', table)
+        self.assertNotIn('22.94 *', table)
+
+    def test_statistic_memory_peak(self):
+        root_node = HostPythonNode(
+            'Root Node',
+            profiler.TracerEventType.UserDefined,
+            0,
+            float('inf'),
+            1000,
+            1001,
+        )
+        profilerstep_node = HostPythonNode(
+            'ProfileStep#1',
+            profiler.TracerEventType.ProfileStep,
+            0,
+            100,
+            1000,
+            1001,
+        )
+        matmul_node = HostPythonNode(
+            'matmul', profiler.TracerEventType.Operator, 5, 15, 1000, 1001
+        )
+        relu_node = HostPythonNode(
+            'relu', profiler.TracerEventType.Operator, 15, 25, 1000, 1001
+        )
+        relu_compute = HostPythonNode(
+            'relu::compute',
+            profiler.TracerEventType.OperatorInner,
+            18,
+            22,
+            1000,
+            1001,
+        )
+        add_node = HostPythonNode(
+            'add', profiler.TracerEventType.Operator, 25, 45, 1000, 1001
+        )
+
+        def mem_node(timestamp, addr, type, increase_bytes, current):
+            return MemPythonNode(
+                timestamp,
+                addr,
+                type,
+                1000,
+                1001,
+                increase_bytes,
+                'place(gpu:0)',
+                current,
+                2048,
+                1150,
+                2048,
+            )
+
+        allocate = profiler_statistic.TracerMemEventType.Allocate
+        free = profiler_statistic.TracerMemEventType.Free
+        matmul_node.mem_node.append(mem_node(10, 1, allocate, 100, 1100))
+        relu_compute.mem_node.append(mem_node(20, 2, allocate, 50, 1150))
+        add_node.mem_node.append(mem_node(30, 1, free, -100, 1050))
+        add_node.mem_node.append(mem_node(40, 3, allocate, 30, 1080))
+        root_node.children_node.append(profilerstep_node)
+        profilerstep_node.children_node.extend(
+            [matmul_node, relu_node, add_node]
+        )
+        relu_node.children_node.append(relu_compute)
+        thread_tree = {'thread1001': root_node}
+        extra_info = {
+            'Process Cpu Utilization': '1.02',
+            'System Cpu Utilization': '0.68',
+        }
+        statistic_data = profiler.profiler_statistic.StatisticData(
+            thread_tree, extra_info
+        )
+        peak_breakdown = statistic_data.memory_summary.peak_breakdowns[
+            'place(gpu:0)'
+        ]
+        self.assertEqual(peak_breakdown.peak_size, 150)
+        self.assertEqual(peak_breakdown.untracked_size, 1000)
+        self.assertEqual(peak_breakdown.timestamp_ns, 20)
+        self.assertEqual(
+            peak_breakdown.owners, {'matmul': [1, 100], 'relu': [1, 50]}
+        )
+        self.assertEqual(
+            peak_breakdown.allocations, [(100, 1, 'matmul'), (50, 2, 'relu')]
+        )
+        table = profiler.profiler_statistic._build_table(
+            statistic_data, views=[profiler.SummaryView.MemoryView]
+        )
+        self.assertIn('Memory Peak Breakdown - place(gpu:0)', table)
+        self.assertIn('Allocated Memory at Peak: 1150', table)
+        self.assertIn('Allocated before profiling', table)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,103 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import contextlib
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+@contextlib.contextmanager
+def flags_guard(flags):
+    old_flags = paddle.get_flags(list(flags.keys()))
+    paddle.set_flags(flags)
+    yield
+    paddle.set_flags(old_flags)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestScatterDeterministic(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.num_rows = 8
+        self.num_keys = 4096
+        self.hidden = 33
+        # most of the indices hit a few rows
+        self.index = np.random.zipf(1.5, self.num_keys) % self.num_rows
+        self.x = np.random.random([self.num_rows, self.hidden])
+        self.updates = np.random.random([self.num_keys, self.hidden])
+
+    def run_ops(self, dtype):
+        x = paddle.to_tensor(self.x.astype(dtype))
+        updates = paddle.to_tensor(self.updates.astype(dtype))
+        index = paddle.to_tensor(self.index.astype("int64"))
+        return [
+            paddle.scatter(x, index, updates, overwrite=False).numpy(),
+            paddle.scatter(x, index, updates, overwrite=True).numpy(),
+            paddle.scatter_nd_add(x, index.unsqueeze(-1), updates).numpy(),
+            paddle.index_add(x, index, 0, updates).numpy(),
+            paddle.index_put(x, (index,), updates, accumulate=True).numpy(),
+        ]
+
+    def expected(self):
+        scatter_sum = self.x.copy()
+        scatter_sum[np.unique(self.index)] = 0
+        np.add.at(scatter_sum, self.index, self.updates)
+        # the last update of each row is written
+        scatter_assign = self.x.copy()
+        scatter_assign[self.index] = self.updates
+        accumulated = self.x.copy()
+        np.add.at(accumulated, self.index, self.updates)
+        return [
+            scatter_sum,
+            scatter_assign,
+            accumulated,
+            accumulated,
+            accumulated,
+        ]
+
+    def test_deterministic(self):
+        for flags in [
+            {"FLAGS_cudnn_deterministic": True},
+            {
+                "FLAGS_cudnn_deterministic": False,
+                "FLAGS_deterministic_scatter_min_keys_per_row": 32,
+            },
+        ]:
+            with flags_guard(flags):
+                results = self.run_ops("float32")
+                for result, expected in zip(results, self.expected()):
+                    np.testing.assert_allclose(
+                        result, expected, rtol=1e-5, atol=1e-5
+                    )
+                for _ in range(3):
+                    for result, rerun in zip(
+                        results, self.run_ops("float32")
+                    ):
+                        np.testing.assert_array_equal(result, rerun)
+
+    def test_float64(self):
+        with flags_guard({"FLAGS_cudnn_deterministic": True}):
+            results = self.run_ops("float64")
+        for result, expected in zip(results, self.expected()):
+            np.testing.assert_allclose(result, expected, rtol=1e-10)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -130,6 +130,47 @@ class TestSparseConv(unittest.TestCase):
             sparse_x.indices().numpy(), y.indices().numpy()
         )
 
+    @unittest.skipIf(
+        not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+    )
+    def test_subm_conv3d_implicit_key(self):
+        # convs without a key share the rulebooks cached in the indices dict,
+        # each one has to get the rulebook of its own arguments
+        paddle.seed(2024)
+        indices = [[0, 0, 0, 0], [0, 0, 0, 0], [0, 0, 1, 2], [1, 3, 2, 3]]
+        values = [[1], [2], [3], [4]]
+        indices = paddle.to_tensor(indices, dtype='int32')
+        values = paddle.to_tensor(values, dtype='float32')
+        dense_shape = [1, 1, 3, 4, 1]
+        sparse_x = paddle.sparse.sparse_coo_tensor(
+            indices, values, dense_shape, stop_gradient=True
+        )
+        weight1 = paddle.randn((1, 3, 3, 1, 1), dtype='float32')
+        weight2 = paddle.randn((1, 3, 3, 1, 1), dtype='float32')
+        weight3 = paddle.randn((1, 1, 3, 1, 1), dtype='float32')
+        y1 = paddle.sparse.nn.functional.subm_conv3d(
+            sparse_x, weight1, padding=1
+        )
+        # the dict of y1 holds the rulebook built with padding 1
+        outs = [
+            paddle.sparse.nn.functional.subm_conv3d(y1, weight2, padding=0),
+            paddle.sparse.nn.functional.subm_conv3d(y1, weight3, padding=0),
+        ]
+        for out, weight in zip(outs, [weight2, weight3]):
+            # a fresh tensor has an empty dict
+            fresh_y1 = paddle.sparse.sparse_coo_tensor(
+                y1.indices(), y1.values(), dense_shape, stop_gradient=True
+            )
+            expected = paddle.sparse.nn.functional.subm_conv3d(
+                fresh_y1, weight, padding=0
+            )
+            np.testing.assert_array_equal(
+                expected.indices().numpy(), out.indices().numpy()
+            )
+            np.testing.assert_allclose(
+                expected.values().numpy(), out.values().numpy(), rtol=1e-5
+            )
+
     def test_Conv2D(self):
         # (3, non_zero_num), 3-D:(N, H, W)
         indices = [[0, 0, 0, 0], [0, 0, 1, 2], [1, 3, 2, 3]]
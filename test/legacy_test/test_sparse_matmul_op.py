@@ -305,5 +305,105 @@ class TestMaskedMatmul(unittest.TestCase):
         )
 
 
+class TestMatmulCachedDescriptors(unittest.TestCase):
+    # the descriptors of a sparsity pattern are cached, the values are bound
+    # again at each call
+    def pattern(self, mask):
+        crows = np.concatenate([[0], np.cumsum(mask.sum(axis=1))])
+        cols = np.nonzero(mask)[1]
+        return (
+            paddle.to_tensor(crows.astype('int64')),
+            paddle.to_tensor(cols.astype('int64')),
+        )
+
+    def sparse_csr(self, pattern, mask, values):
+        crows, cols = pattern
+        return paddle.sparse.sparse_csr_tensor(
+            crows, cols, paddle.to_tensor(values[mask]), list(mask.shape)
+        )
+
+    @unittest.skipIf(
+        not paddle.is_compiled_with_cuda() or get_cuda_version() < 11000,
+        "only support cuda>=11.0",
+    )
+    def test_reuse_pattern(self):
+        mask = np.random.rand(16, 12) < 0.3
+        pattern = self.pattern(mask)
+        for _ in range(3):
+            # the same indices with new values of x and y
+            np_x = np.random.rand(16, 12) * mask
+            np_y = np.random.rand(12, 10)
+            out = paddle.sparse.matmul(
+                self.sparse_csr(pattern, mask, np_x), paddle.to_tensor(np_y)
+            )
+            np.testing.assert_allclose(out.numpy(), np_x @ np_y, rtol=1e-05)
+
+        # another pattern of the same shape and nnz
+        other_mask = np.zeros_like(mask)
+        other_mask.flat[: mask.sum()] = True
+        np_x = np.random.rand(16, 12) * other_mask
+        np_y = np.random.rand(12, 10)
+        out = paddle.sparse.matmul(
+            self.sparse_csr(self.pattern(other_mask), other_mask, np_x),
+            paddle.to_tensor(np_y),
+        )
+        np.testing.assert_allclose(out.numpy(), np_x @ np_y, rtol=1e-05)
+
+    @unittest.skipIf(
+        not paddle.is_compiled_with_cuda() or get_cuda_version() < 11030,
+        "only support on cuda>=11.3",
+    )
+    def test_reuse_mask(self):
+        np_mask = np.random.rand(10, 6) < 0.3
+        mask = paddle.to_tensor(np_mask.astype('float64')).to_sparse_csr()
+        for _ in range(3):
+            np_x = np.random.rand(10, 12)
+            np_y = np.random.rand(12, 6)
+            out = paddle.sparse.masked_matmul(
+                paddle.to_tensor(np_x), paddle.to_tensor(np_y), mask
+            )
+            np.testing.assert_allclose(
+                out.to_dense().numpy(), (np_x @ np_y) * np_mask, rtol=1e-05
+            )
+
+    @unittest.skipIf(
+        not paddle.is_compiled_with_cuda()
+        or paddle.is_compiled_with_rocm()
+        or get_cuda_version() < 11000,
+        "only support cuda>=11.0",
+    )
+    def test_cuda_graph(self):
+        from paddle.device.cuda.graphs import CUDAGraph
+
+        mask = np.random.rand(16, 12) < 0.3
+        np_x = np.random.rand(16, 12) * mask
+        x = self.sparse_csr(self.pattern(mask), mask, np_x)
+        y = paddle.to_tensor(np.random.rand(12, 10))
+
+        graph = CUDAGraph()
+        graph.capture_begin()
+        out = paddle.sparse.matmul(x, y)
+        graph.capture_end()
+
+        # a larger call grows the cached workspace, the graph keeps its own
+        big_mask = np.random.rand(512, 512) < 0.5
+        np_big = np.random.rand(512, 512) * big_mask
+        np_big_y = np.random.rand(512, 256)
+        big_out = paddle.sparse.matmul(
+            self.sparse_csr(self.pattern(big_mask), big_mask, np_big),
+            paddle.to_tensor(np_big_y),
+        )
+        np.testing.assert_allclose(
+            big_out.numpy(), np_big @ np_big_y, rtol=1e-05
+        )
+
+        for _ in range(3):
+            np_y = np.random.rand(12, 10)
+            y.copy_(paddle.to_tensor(np_y), False)
+            graph.replay()
+            np.testing.assert_allclose(out.numpy(), np_x @ np_y, rtol=1e-05)
+        graph.reset()
+
+
 if __name__ == "__main__":
     unittest.main()
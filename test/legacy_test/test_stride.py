@@ -595,6 +595,40 @@ class TestStride(unittest.TestCase):
 
         self.assertTrue(np.allclose(out_c.numpy(), np_out))
 
+    def call_matmul(self):
+        x_np = np.random.random(size=[2, 4, 3]).astype('float32')
+        y_np = np.random.random(size=[2, 5, 4]).astype('float32')
+        x = paddle.to_tensor(x_np)
+        y = paddle.to_tensor(y_np)
+
+        x_t = paddle.transpose(x, perm=[0, 2, 1])
+        y_t = paddle.transpose(y, perm=[0, 2, 1])
+        self.assertFalse(x_t.is_contiguous())
+        self.assertFalse(y_t.is_contiguous())
+
+        out = paddle.matmul(x_t, y_t)
+        np_out = np.matmul(x_np.transpose(0, 2, 1), y_np.transpose(0, 2, 1))
+        self.assertTrue(np.allclose(out.numpy(), np_out))
+        self.assertTrue(out.is_contiguous())
+
+        out = paddle.matmul(x_t, y, transpose_y=True)
+        np_out = np.matmul(x_np.transpose(0, 2, 1), y_np.transpose(0, 2, 1))
+        self.assertTrue(np.allclose(out.numpy(), np_out))
+
+        w_np = np.random.random(size=[2, 3, 5]).astype('float32')
+        w_t = paddle.transpose(paddle.to_tensor(w_np), perm=[0, 2, 1])
+        self.assertFalse(w_t.is_contiguous())
+        out = paddle.matmul(x_t, w_t, transpose_x=True, transpose_y=True)
+        np_out = np.matmul(x_np, w_np)
+        self.assertTrue(np.allclose(out.numpy(), np_out))
+
+        # Not a transposed view of a contiguous tensor, so it is copied.
+        x_p = paddle.transpose(x, perm=[1, 0, 2])
+        self.assertFalse(x_p.is_contiguous())
+        out = paddle.matmul(x_p, x_t[0])
+        np_out = np.matmul(x_np.transpose(1, 0, 2), x_np[0].T)
+        self.assertTrue(np.allclose(out.numpy(), np_out))
+
     def call_stride(self):
         self.call_transpose()
         self.call_diagonal()
@@ -620,6 +654,7 @@ class TestStride(unittest.TestCase):
         self.call_view2()
         self.call_view_as()
         self.call_unfold()
+        self.call_matmul()
 
 
 class TestStrideCPU(TestStride):
@@ -72,6 +72,21 @@ class TestTopkOp(OpTest):
         )
 
 
+class TestTopkOpManyShortRows(TestTopkOp):
+    # Enough rows for the warp-per-row kernel on GPU.
+    def init_args(self):
+        self.k = 5
+        self.axis = -1
+        self.largest = True
+        self.input_data = np.random.rand(512, 16)
+
+
+class TestTopkOpManyShortRowsSmallest(TestTopkOpManyShortRows):
+    def init_args(self):
+        super().init_args()
+        self.largest = False
+
+
 class TestTopkOp_ZeroDim(TestTopkOp):
     def init_args(self):
         self.k = 1
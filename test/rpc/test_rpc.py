@@ -104,6 +104,9 @@ class TestSingleProcessRpc(RpcTestBase):
         out = dist.rpc.rpc_async(worker_name(0), paddle_add, args=args).wait()
         np.testing.assert_allclose(out, res, rtol=1e-05)
 
+    def test_nested_rpc(self):
+        check_nested_rpc()
+
     def test_get_worker_info(self):
         info = dist.rpc.get_worker_info(worker_name(0))
         self.assertEqual(info.name, worker_name(0))
@@ -121,6 +124,75 @@ class TestSingleProcessRpc(RpcTestBase):
         self.assertEqual(info.rank, 0)
 
 
+def raise_error(msg):
+    raise ValueError(msg)
+
+
+def nested_paddle_add(a, b, depth):
+    # calls back into the worker running it while its handler waits
+    if depth == 0:
+        return paddle_add(a, b)
+    return dist.rpc.rpc_sync(
+        worker_name(0), nested_paddle_add, args=(a, b, depth - 1)
+    )
+
+
+def check_nested_rpc():
+    a = np.random.random((10, 100))
+    b = np.random.random((10, 100))
+    futs = [
+        dist.rpc.rpc_async(worker_name(0), nested_paddle_add, args=(a, b, d))
+        for d in range(1, 4)
+    ]
+    for fut in futs:
+        np.testing.assert_allclose(fut.wait(), np.add(a, b), rtol=1e-05)
+
+
+class TestBatchedRpc(RpcTestBase):
+    def setUp(self):
+        self._port_set = set()
+        self._old_flags = paddle.get_flags(
+            ["FLAGS_rpc_max_batch_size", "FLAGS_rpc_max_batch_delay_us"]
+        )
+        paddle.set_flags(
+            {
+                "FLAGS_rpc_max_batch_size": 16,
+                "FLAGS_rpc_max_batch_delay_us": 1000,
+            }
+        )
+        master_endpoint = f"127.0.0.1:{self._find_free_port()}"
+        dist.rpc.init_rpc(worker_name(0), 0, 1, master_endpoint)
+
+    def tearDown(self):
+        dist.rpc.shutdown()
+        paddle.set_flags(self._old_flags)
+
+    def test_async_rpc_paddle_add(self):
+        # more rpcs than a batch, the last batch is sent by its deadline
+        inputs = [
+            (np.random.random((10, 100)), np.random.random((10, 100)))
+            for _ in range(37)
+        ]
+        futs = [
+            dist.rpc.rpc_async(worker_name(0), paddle_add, args=args)
+            for args in inputs
+        ]
+        for fut, (a, b) in zip(futs, inputs):
+            np.testing.assert_allclose(fut.wait(), np.add(a, b), rtol=1e-05)
+
+    def test_error_in_batch(self):
+        a = np.random.random((10, 100))
+        b = np.random.random((10, 100))
+        fut1 = dist.rpc.rpc_async(worker_name(0), raise_error, args=("x",))
+        fut2 = dist.rpc.rpc_async(worker_name(0), paddle_add, args=(a, b))
+        with self.assertRaises(Exception):
+            fut1.wait()
+        np.testing.assert_allclose(fut2.wait(), np.add(a, b), rtol=1e-05)
+
+    def test_nested_rpc(self):
+        check_nested_rpc()
+
+
 class RpcLaunchTest(RpcLaunchTestBase):
     def test_sync_rpc_paddle_add1(self):
         nnodes = 2
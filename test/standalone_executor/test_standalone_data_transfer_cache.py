@@ -0,0 +1,69 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestDataTransferCache(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.x = np.random.random([4, 8]).astype("float32")
+
+    def test_set_persistable(self):
+        # w stays on CPU, so it is copied to GPU before each matmul. The
+        # copy must see the values set between the runs, which keep the
+        # allocation, dims and inplace version of w.
+        paddle.set_flags({"FLAGS_new_executor_cache_data_transfer": True})
+        try:
+            with paddle.pir_utils.OldIrGuard():
+                main_program = paddle.static.Program()
+                startup_program = paddle.static.Program()
+                with paddle.static.program_guard(main_program, startup_program):
+                    x = paddle.static.data("x", [4, 8], "float32")
+                    w = paddle.static.create_parameter(
+                        [8, 8], "float32", name="w"
+                    )
+                    out = paddle.matmul(x, w)
+                exe = paddle.static.Executor(paddle.CUDAPlace(0))
+                scope = core.Scope()
+                with paddle.static.scope_guard(scope):
+                    for _ in range(3):
+                        w_np = np.random.random([8, 8]).astype("float32")
+                        scope.var(w.name).get_tensor().set(
+                            w_np, paddle.CPUPlace()
+                        )
+                        (res,) = exe.run(
+                            main_program,
+                            feed={"x": self.x},
+                            fetch_list=[out],
+                        )
+                        np.testing.assert_allclose(
+                            res, self.x @ w_np, rtol=1e-5
+                        )
+        finally:
+            paddle.set_flags({"FLAGS_new_executor_cache_data_transfer": False})
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,107 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+def get_metric(name):
+    for line in core.get_metrics().splitlines():
+        if line.startswith(name + " "):
+            return float(line.split()[1])
+    return 0.0
+
+
+def build_program():
+    main_program = paddle.static.Program()
+    startup_program = paddle.static.Program()
+    with paddle.static.program_guard(main_program, startup_program):
+        x = paddle.static.data("x", [32, 32], "float32")
+        # many temporaries, each freed after its last use
+        y = x
+        for i in range(8):
+            y = paddle.tanh(paddle.matmul(y, x) * 0.1 + float(i))
+        out = paddle.mean(y * y)
+    return main_program, startup_program, [out]
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestGroupedGC(unittest.TestCase):
+    def setUp(self):
+        self.steps = 3
+        np.random.seed(2024)
+        self.x = np.random.random([32, 32]).astype("float32")
+
+    def run_program(self, batch_groups):
+        flags = {
+            # the fast gc takes precedence over the grouped gc
+            "FLAGS_fast_eager_deletion_mode": False,
+            "FLAGS_new_executor_gc_batch_groups": batch_groups,
+        }
+        old_flags = paddle.get_flags(list(flags.keys()))
+        paddle.set_flags(flags)
+        try:
+            with paddle.pir_utils.IrGuard():
+                main_program, startup_program, fetch_list = build_program()
+                exe = paddle.static.Executor(paddle.CUDAPlace(0))
+                scope = core.Scope()
+                with paddle.static.scope_guard(scope):
+                    exe.run(startup_program)
+                    return [
+                        exe.run(
+                            main_program,
+                            feed={"x": self.x},
+                            fetch_list=fetch_list,
+                        )[0]
+                        for _ in range(self.steps)
+                    ]
+        finally:
+            paddle.set_flags(old_flags)
+
+    def test_grouped_gc(self):
+        groups = get_metric("paddle_executor_gc_groups_total")
+        expected = self.run_program(0)
+        # the event gc does not go through the groups
+        self.assertEqual(get_metric("paddle_executor_gc_groups_total"), groups)
+
+        for batch_groups in [1, 3]:
+            groups = get_metric("paddle_executor_gc_groups_total")
+            batches = get_metric("paddle_executor_gc_batches_total")
+            outs = self.run_program(batch_groups)
+            for out, ref in zip(outs, expected):
+                np.testing.assert_allclose(out, ref, rtol=1e-6)
+            freed_groups = get_metric("paddle_executor_gc_groups_total")
+            freed_batches = get_metric("paddle_executor_gc_batches_total")
+            self.assertGreater(freed_groups, groups)
+            self.assertGreater(freed_batches, batches)
+            # the groups and the batches are counted when handed to the gc
+            # thread, a batch holds at most batch_groups groups and each run
+            # flushes the groups left
+            self.assertLessEqual(
+                freed_groups - groups, (freed_batches - batches) * batch_groups
+            )
+            if batch_groups > 1:
+                self.assertLess(freed_batches - batches, freed_groups - groups)
+
+
+if __name__ == "__main__":
+    unittest.main()
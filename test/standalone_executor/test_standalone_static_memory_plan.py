@@ -0,0 +1,91 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+def build_program(num_branches=4):
+    main_program = paddle.static.Program()
+    startup_program = paddle.static.Program()
+    with paddle.static.program_guard(main_program, startup_program):
+        x = paddle.static.data("x", [64, 64], "float32")
+        # independent branches, spread over the compute streams
+        branches = []
+        for i in range(num_branches):
+            y = paddle.matmul(x, x) * float(i + 1)
+            y = paddle.tanh(y + 1.0)
+            y = paddle.matmul(y, x)
+            branches.append(paddle.nn.functional.relu(y))
+        out = paddle.add_n(branches)
+        out = paddle.mean(out * out)
+    return main_program, startup_program, [out]
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestStaticMemoryPlanMultiStream(unittest.TestCase):
+    def setUp(self):
+        self.steps = 5
+        np.random.seed(2024)
+        self.x = np.random.random([64, 64]).astype("float32") * 0.1
+
+    def run_program(self, flags):
+        old_flags = paddle.get_flags(list(flags.keys()))
+        paddle.set_flags(flags)
+        try:
+            with paddle.pir_utils.IrGuard():
+                main_program, startup_program, fetch_list = build_program()
+                exe = paddle.static.Executor(paddle.CUDAPlace(0))
+                scope = core.Scope()
+                with paddle.static.scope_guard(scope):
+                    exe.run(startup_program)
+                    return [
+                        exe.run(
+                            main_program,
+                            feed={"x": self.x},
+                            fetch_list=fetch_list,
+                        )[0]
+                        for _ in range(self.steps)
+                    ]
+        finally:
+            paddle.set_flags(old_flags)
+
+    def test_multi_stream(self):
+        expected = self.run_program(
+            {
+                "FLAGS_new_executor_static_memory_plan": False,
+                "FLAGS_new_executor_auto_stream_num": 0,
+            }
+        )
+        for auto_stream_num in [0, 2, 4]:
+            outs = self.run_program(
+                {
+                    "FLAGS_new_executor_static_memory_plan": True,
+                    "FLAGS_new_executor_auto_stream_num": auto_stream_num,
+                }
+            )
+            for out, ref in zip(outs, expected):
+                np.testing.assert_allclose(out, ref, rtol=1e-5)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,99 @@
+# Copyright (c) 2024 CINN Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Compare the CINN X86 kernels with the phi CPU kernels on a few fused
+# subgraphs, e.g.
+#   FLAGS_cinn_cpu_auto_parallel=1 python cinn_cpu_benchmark.py --repeat 100
+
+import argparse
+import time
+
+import numpy as np
+
+import paddle
+
+
+def bias_gelu(x, bias):
+    return paddle.nn.functional.gelu(x + bias, approximate=True)
+
+
+def rms_norm(x, weight):
+    variance = (x * x).mean(axis=-1, keepdim=True)
+    return x * paddle.rsqrt(variance + 1e-6) * weight
+
+
+def softmax(x, mask):
+    return paddle.nn.functional.softmax(x * 0.125 + mask, axis=-1)
+
+
+def elementwise_chain(x, y):
+    return paddle.exp(paddle.tanh(x * y + 1.0) - y) * 0.5
+
+
+CASES = {
+    "bias_gelu": (bias_gelu, [[64, 128, 1024], [1024]]),
+    "rms_norm": (rms_norm, [[64, 128, 1024], [1024]]),
+    "softmax": (softmax, [[64, 16, 128, 128], [64, 1, 1, 128]]),
+    "elementwise_chain": (elementwise_chain, [[1024, 4096], [1024, 4096]]),
+}
+
+
+def to_static(fn, use_cinn):
+    build_strategy = paddle.static.BuildStrategy()
+    build_strategy.build_cinn_pass = use_cinn
+    return paddle.jit.to_static(
+        fn, build_strategy=build_strategy, full_graph=True
+    )
+
+
+def measure(fn, inputs, warmup, repeat):
+    for _ in range(warmup):
+        out = fn(*inputs)
+    start = time.perf_counter()
+    for _ in range(repeat):
+        out = fn(*inputs)
+    end = time.perf_counter()
+    return (end - start) / repeat * 1000, out.numpy()
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--cases", nargs="+", default=list(CASES.keys()))
+    parser.add_argument("--warmup", type=int, default=10)
+    parser.add_argument("--repeat", type=int, default=50)
+    args = parser.parse_args()
+
+    paddle.set_device("cpu")
+    print(f"{'case':<20}{'phi (ms)':>12}{'cinn (ms)':>12}{'speedup':>10}")
+    for name in args.cases:
+        fn, shapes = CASES[name]
+        inputs = [
+            paddle.to_tensor(np.random.random(shape).astype("float32"))
+            for shape in shapes
+        ]
+        phi_time, phi_out = measure(
+            to_static(fn, False), inputs, args.warmup, args.repeat
+        )
+        cinn_time, cinn_out = measure(
+            to_static(fn, True), inputs, args.warmup, args.repeat
+        )
+        np.testing.assert_allclose(cinn_out, phi_out, rtol=1e-4, atol=1e-5)
+        print(
+            f"{name:<20}{phi_time:>12.3f}{cinn_time:>12.3f}"
+            f"{phi_time / cinn_time:>10.2f}"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Replays an allocation trace against the allocator of each strategy.
+
+Record the trace with FLAGS_allocation_trace_capacity=<events>, or with
+paddle.base.core.enable_allocation_trace(capacity), and write it out with
+paddle.base.core.dump_allocation_trace(path).
+"""
+
+import argparse
+
+from paddle.base import core
+
+parser = argparse.ArgumentParser(description=__doc__)
+parser.add_argument(
+    '--trace_path', type=str, required=True, help='Allocation trace file name.'
+)
+parser.add_argument(
+    '--place',
+    type=str,
+    default='gpu:0',
+    help='The place whose events are replayed, cpu or gpu:<id>.',
+)
+parser.add_argument(
+    '--strategies',
+    type=str,
+    default='',
+    help='Comma separated allocator strategies, all the ones supported by '
+    'the place if empty.',
+)
+args = parser.parse_args()
+
+CPU_STRATEGIES = ['naive_best_fit', 'auto_growth', 'size_class']
+GPU_STRATEGIES = [
+    'naive_best_fit',
+    'auto_growth',
+    'auto_growth_v2',
+    'virtual_memory',
+    'cuda_malloc_async',
+]
+
+
+def _parse_place(place):
+    if place == 'cpu':
+        return core.CPUPlace(), CPU_STRATEGIES
+    if place.startswith('gpu'):
+        device_id = int(place.split(':')[1]) if ':' in place else 0
+        return core.CUDAPlace(device_id), GPU_STRATEGIES
+    raise ValueError(f'Unsupported place {place}, should be cpu or gpu:<id>.')
+
+
+def _to_mb(size):
+    return f'{size / (1 << 20):.2f}'
+
+
+def main():
+    place, strategies = _parse_place(args.place)
+    if args.strategies:
+        strategies = args.strategies.split(',')
+
+    header = [
+        'strategy',
+        'allocs',
+        'failed',
+        'peak_alloc(MB)',
+        'peak_reserved(MB)',
+        'time(ms)',
+        'first_failed_op',
+    ]
+    rows = []
+    for strategy in strategies:
+        try:
+            res = core.replay_allocation_trace(
+                args.trace_path, strategy, place
+            )
+        except Exception as e:
+            print(f'Skip {strategy}: {e}')
+            continue
+        rows.append(
+            [
+                strategy,
+                str(res['alloc_num']),
+                str(res['failed_num']),
+                _to_mb(res['peak_allocated']),
+                _to_mb(res['peak_reserved']),
+                f"{res['elapsed_ms']:.2f}",
+                res['first_failed_op'] or '-',
+            ]
+        )
+
+    widths = [
+        max(len(row[i]) for row in [header, *rows]) for i in range(len(header))
+    ]
+    for row in [header, *rows]:
+        print('  '.join(cell.ljust(w) for cell, w in zip(row, widths)))
+
+
+if __name__ == '__main__':
+    main()
@@ -224,6 +224,7 @@ STATIC_MODE_TESTING_LIST = [
     'test_fused_emb_seq_pool_op',
     'test_fused_embedding_fc_lstm_op',
     'test_fused_token_prune_op',
+    'test_fusion_embedding_seqpool_concat_op',
     'test_fusion_gru_op',
     'test_fusion_lstm_op',
     'test_fusion_repeated_fc_relu_op',